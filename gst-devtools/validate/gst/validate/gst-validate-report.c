@@ -337,6 +337,8 @@ gst_validate_report_load_issues (void)
       _("The execution of an action did not properly happen"), NULL);
   REGISTER_VALIDATE_ISSUE (ISSUE, SCENARIO_ACTION_EXECUTION_ISSUE,
       _("An issue happend during the execution of a scenario"), NULL);
+  REGISTER_VALIDATE_ISSUE (CRITICAL, SCENARIO_PERFORMANCE_BUDGET_EXCEEDED,
+      _("The scenario exceeded one of its performance budgets"), NULL);
   REGISTER_VALIDATE_ISSUE (WARNING, G_LOG_WARNING, _("We got a g_log warning"),
       NULL);
   REGISTER_VALIDATE_ISSUE (CRITICAL, G_LOG_CRITICAL,
@@ -114,6 +114,7 @@ typedef enum {
 #define SCENARIO_ACTION_EXECUTION_ERROR          _QUARK("scenario::execution-error")
 #define SCENARIO_ACTION_TIMEOUT                  _QUARK("scenario::action-timeout")
 #define SCENARIO_ACTION_EXECUTION_ISSUE          _QUARK("scenario::execution-issue")
+#define SCENARIO_PERFORMANCE_BUDGET_EXCEEDED     _QUARK("scenario::performance-budget-exceeded")
 
 #define G_LOG_ISSUE                              _QUARK("g-log::issue")
 #define G_LOG_WARNING                            _QUARK("g-log::warning")
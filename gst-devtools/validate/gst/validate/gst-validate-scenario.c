@@ -43,6 +43,9 @@
 #include <gio/gio.h>
 #include <string.h>
 #include <errno.h>
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
 
 #include "gst-validate-internal.h"
 #include "gst-validate-scenario.h"
@@ -145,6 +148,15 @@ struct _GstValidateScenarioPrivate
   GList *overrides;
 
   gchar *pipeline_name;
+
+  /* Performance budgets from the description, < 0 if unset */
+  gdouble max_cpu_time;
+  gdouble max_memory_peak;
+  gdouble min_processing_speed;
+
+  /* Wall clock and CPU time when the pipeline started prerolling */
+  gint64 perf_start_time;
+  gdouble perf_start_cpu_time;
 };
 
 typedef struct KeyFileGroupName
@@ -2036,6 +2048,80 @@ _check_waiting_for_message (GstValidateScenario * scenario,
   }
 }
 
+/* Returns the CPU time used by the process so far in seconds, and its
+ * resident memory high-water mark in kB if @memory_peak is not %NULL, or
+ * -1 if not available on this platform */
+static gdouble
+_get_process_cpu_time (gdouble * memory_peak)
+{
+#ifdef G_OS_UNIX
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0) {
+    if (memory_peak) {
+#ifdef __APPLE__
+      /* In bytes on OSX */
+      *memory_peak = usage.ru_maxrss / 1024.0;
+#else
+      *memory_peak = usage.ru_maxrss;
+#endif
+    }
+
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) /
+        (gdouble) G_USEC_PER_SEC;
+  }
+#endif
+
+  if (memory_peak)
+    *memory_peak = -1;
+
+  return -1;
+}
+
+static void
+_check_performances (GstValidateScenario * scenario)
+{
+  GstValidateScenarioPrivate *priv = scenario->priv;
+  gdouble wall_time, cpu_time, memory_peak, speed = -1;
+  gint64 position;
+
+  if (!priv->perf_start_time)
+    return;
+
+  wall_time = (g_get_monotonic_time () - priv->perf_start_time) /
+      (gdouble) G_USEC_PER_SEC;
+  cpu_time = _get_process_cpu_time (&memory_peak);
+  if (cpu_time >= 0)
+    cpu_time -= priv->perf_start_cpu_time;
+
+  if (wall_time > 0 && gst_element_query_position (scenario->pipeline,
+          GST_FORMAT_TIME, &position) && GST_CLOCK_TIME_IS_VALID (position))
+    speed = (position / (gdouble) GST_SECOND) / wall_time;
+
+  priv->perf_start_time = 0;
+
+  gst_validate_printf (NULL, "<performance wall-time=%f cpu-time=%f "
+      "memory-peak=%f processing-speed=%f />\n", wall_time, cpu_time,
+      memory_peak, speed);
+
+  if (priv->max_cpu_time >= 0 && cpu_time > priv->max_cpu_time)
+    GST_VALIDATE_REPORT (scenario, SCENARIO_PERFORMANCE_BUDGET_EXCEEDED,
+        "Used %f seconds of CPU time, the budget is %f seconds", cpu_time,
+        priv->max_cpu_time);
+
+  if (priv->max_memory_peak >= 0 && memory_peak > priv->max_memory_peak)
+    GST_VALIDATE_REPORT (scenario, SCENARIO_PERFORMANCE_BUDGET_EXCEEDED,
+        "Memory peaked at %f kB, the budget is %f kB", memory_peak,
+        priv->max_memory_peak);
+
+  if (priv->min_processing_speed >= 0 && speed >= 0 &&
+      speed < priv->min_processing_speed)
+    GST_VALIDATE_REPORT (scenario, SCENARIO_PERFORMANCE_BUDGET_EXCEEDED,
+        "Processed the stream at %f times real time, the budget is %f",
+        speed, priv->min_processing_speed);
+}
+
 static gboolean
 message_cb (GstBus * bus, GstMessage * message, GstValidateScenario * scenario)
 {
@@ -2090,6 +2176,11 @@ message_cb (GstBus * bus, GstMessage * message, GstValidateScenario * scenario)
 
         if (pstate == GST_STATE_READY && nstate == GST_STATE_PAUSED)
           _add_execute_actions_gsource (scenario);
+
+        if (pstate == GST_STATE_NULL && nstate == GST_STATE_READY) {
+          priv->perf_start_time = g_get_monotonic_time ();
+          priv->perf_start_cpu_time = _get_process_cpu_time (NULL);
+        }
       }
       break;
     }
@@ -2104,6 +2195,8 @@ message_cb (GstBus * bus, GstMessage * message, GstValidateScenario * scenario)
       GstStructure *s;
 
       if (!is_error) {
+        _check_performances (scenario);
+
         priv->got_eos = TRUE;
         if (priv->message_type) {
 
@@ -2254,6 +2347,13 @@ _load_scenario_file (GstValidateScenario * scenario,
         priv->pipeline_name = g_strdup (pipeline_name);
       }
 
+      gst_structure_get_double (structure, "max-cpu-time",
+          &priv->max_cpu_time);
+      gst_structure_get_double (structure, "max-memory-peak",
+          &priv->max_memory_peak);
+      gst_structure_get_double (structure, "min-processing-speed",
+          &priv->min_processing_speed);
+
       continue;
     } else if (!(action_type = _find_action_type (type))) {
       if (gst_structure_has_field (structure, "optional-action-type")) {
@@ -2517,6 +2617,9 @@ gst_validate_scenario_init (GstValidateScenario * scenario)
   priv->segment_start = 0;
   priv->segment_stop = GST_CLOCK_TIME_NONE;
   priv->action_execution_interval = 10;
+  priv->max_cpu_time = -1;
+  priv->max_memory_peak = -1;
+  priv->min_processing_speed = -1;
 
   g_mutex_init (&priv->lock);
 }
@@ -3338,6 +3441,33 @@ init_scenarios (void)
         .possible_variables = NULL,
         .def = "infinite (GST_CLOCK_TIME_NONE)"
       },
+      {
+        .name = "max-cpu-time",
+        .description = "The maximum CPU time, in seconds, the process may use from the moment\n"
+                       "the pipeline starts until EOS. Exceeding it is reported as an issue",
+        .mandatory = FALSE,
+        .types = "double",
+        .possible_variables = NULL,
+        .def = "unlimited"
+      },
+      {
+        .name = "max-memory-peak",
+        .description = "The maximum resident memory, in kB, the process may reach before EOS.\n"
+                       "Exceeding it is reported as an issue",
+        .mandatory = FALSE,
+        .types = "double",
+        .possible_variables = NULL,
+        .def = "unlimited"
+      },
+      {
+        .name = "min-processing-speed",
+        .description = "The minimum speed, relative to real time, at which the stream must be\n"
+                       "processed until EOS. Only meaningful without clock synchronization",
+        .mandatory = FALSE,
+        .types = "double",
+        .possible_variables = NULL,
+        .def = "none"
+      },
       {
         .name = "pipeline-name",
         .description = "The name of the GstPipeline on which the scenario should be executed.\n"
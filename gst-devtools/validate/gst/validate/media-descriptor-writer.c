@@ -531,7 +531,10 @@ _run_frame_analysis (GstValidateMediaDescriptorWriter * writer,
       writer);
   gst_bin_add (GST_BIN (writer->priv->pipeline), uridecodebin);
 
-  writer->priv->loop = g_main_loop_new (NULL, FALSE);
+  /* Use the thread default context so that several files can be analyzed
+   * concurrently from different threads */
+  writer->priv->loop =
+      g_main_loop_new (g_main_context_get_thread_default (), FALSE);
   bus = gst_element_get_bus (writer->priv->pipeline);
   gst_bus_add_signal_watch (bus);
   g_signal_connect (bus, "message", (GCallback) bus_callback, writer);
@@ -853,7 +856,10 @@ gst_validate_media_descriptor_writer_add_frame (GstValidateMediaDescriptorWriter
     return FALSE;
   }
 
-  id = g_list_length (streamnode->frames);
+  /* The writer keeps the last frame of the stream in cframe, so that
+   * adding a frame does not need to walk the whole list */
+  id = streamnode->cframe ?
+      ((GstValidateMediaFrameNode *) streamnode->cframe->data)->id + 1 : 0;
   fnode = g_slice_new0 (GstValidateMediaFrameNode);
 
   g_assert (gst_buffer_map (buf, &map, GST_MAP_READ));
@@ -885,7 +891,12 @@ gst_validate_media_descriptor_writer_add_frame (GstValidateMediaDescriptorWriter
 
   fnode->str_close = NULL;
 
-  streamnode->frames = g_list_append (streamnode->frames, fnode);
+  if (streamnode->cframe) {
+    streamnode->cframe = g_list_append (streamnode->cframe, fnode)->next;
+  } else {
+    streamnode->frames = g_list_append (streamnode->frames, fnode);
+    streamnode->cframe = g_list_last (streamnode->frames);
+  }
 
   g_free (checksum);
   GST_VALIDATE_MEDIA_DESCRIPTOR_UNLOCK (writer);
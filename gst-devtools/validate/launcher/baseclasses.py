@@ -22,6 +22,7 @@
 import os
 import sys
 import re
+import json
 import time
 import utils
 import signal
@@ -47,6 +48,61 @@ VALGRIND_ERROR_CODE = 20
 VALIDATE_OVERRIDE_EXTENSION = ".override"
 
 
+class PerformanceBaselines(object):
+
+    """ Reference performance numbers of the tests, stored as JSON """
+
+    # Name of the value in the validate logs, and whether higher is better
+    VALUES = {"cpu-time": False,
+              "memory-peak": False,
+              "processing-speed": True}
+
+    _instances = {}
+    _lock = threading.Lock()
+
+    def __init__(self, path):
+        self.path = path
+        self.baselines = {}
+        if os.path.exists(path):
+            with open(path, 'r') as f:
+                self.baselines = json.load(f)
+
+    @classmethod
+    def get(cls, path):
+        with cls._lock:
+            if path not in cls._instances:
+                cls._instances[path] = PerformanceBaselines(path)
+
+            return cls._instances[path]
+
+    def update(self, testname, values):
+        with self._lock:
+            self.baselines[testname] = values
+            with open(self.path, 'w') as f:
+                json.dump(self.baselines, f, indent=4, sort_keys=True)
+
+    def check(self, testname, values, tolerance):
+        """ Returns the list of regressions of @values, if any """
+        baseline = self.baselines.get(testname)
+        if not baseline:
+            return []
+
+        regressions = []
+        factor = tolerance / 100.0
+        for name, higher_is_better in self.VALUES.items():
+            ref = baseline.get(name, -1)
+            val = values.get(name, -1)
+            if ref < 0 or val < 0:
+                continue
+
+            if higher_is_better and val < ref * (1 - factor):
+                regressions.append("%s %f < %f" % (name, val, ref))
+            elif not higher_is_better and val > ref * (1 + factor):
+                regressions.append("%s %f > %f" % (name, val, ref))
+
+        return regressions
+
+
 class Test(Loggable):
 
     """ A class representing a particular test. """
@@ -430,6 +486,7 @@ class GstValidateTest(Test):
         '.*position.*(\d+):(\d+):(\d+).(\d+).*duration.*(\d+):(\d+):(\d+).(\d+)')
     findlastseek_regex = re.compile(
         'seeking to.*(\d+):(\d+):(\d+).(\d+).*stop.*(\d+):(\d+):(\d+).(\d+).*rate.*(\d+)\.(\d+)')
+    findperformance_regex = re.compile('<performance (.*) />')
 
     HARD_TIMEOUT_FACTOR = 5
 
@@ -619,6 +676,41 @@ class GstValidateTest(Test):
                             % (self.process.returncode, criticals))
         else:
             self.set_result(Result.PASSED)
+            self.check_performances()
+
+    def get_performances(self):
+        values = {}
+        for l in open(self.validatelogs, 'r').readlines():
+            m = self.findperformance_regex.search(l)
+            if not m:
+                continue
+
+            for field in m.group(1).split():
+                name, value = field.split('=', 1)
+                values[name] = float(value)
+
+        return values
+
+    def check_performances(self):
+        if not self.options.perf_baselines:
+            return
+
+        values = self.get_performances()
+        if not values:
+            return
+
+        baselines = PerformanceBaselines.get(self.options.perf_baselines)
+        if self.options.update_perf_baselines:
+            baselines.update(self.classname, values)
+            return
+
+        regressions = baselines.check(self.classname, values,
+                                      self.options.perf_tolerance)
+        if regressions:
+            self.set_result(Result.FAILED,
+                            "Performance regressions: %s"
+                            % ", ".join(regressions),
+                            "performance-regression")
 
     def _parse_position(self, p):
         self.log("Parsing %s" % p)
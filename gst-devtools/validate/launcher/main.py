@@ -200,6 +200,9 @@ class LauncherConfig(Loggable):
         self.logsdir = None
         self.redirect_logs = False
         self.num_jobs = 1
+        self.perf_baselines = None
+        self.update_perf_baselines = False
+        self.perf_tolerance = 10.0
         self.dest = None
         self._using_default_paths = False
         # paths passed with --media-path, and not defined by a testsuite
@@ -439,6 +442,24 @@ Note that all testsuite should be inside python modules, so the directory should
                              " in a virtual framebuffer."
                              " Note that it is currently implemented only"
                              " for the X  server thanks to Xvfb (which is requeried in that case)")
+    perf_group = parser.add_argument_group(
+        "Performance regression checks")
+    perf_group.add_argument("--perf-baselines", dest="perf_baselines",
+                            metavar="FILE",
+                            help="JSON file with the reference performance"
+                            " numbers of the tests. Tests using more CPU time"
+                            " or memory, or processing slower than their"
+                            " baseline (within the tolerance) are failed")
+    perf_group.add_argument("--update-perf-baselines",
+                            dest="update_perf_baselines",
+                            action="store_true",
+                            help="Store the performance numbers of the passing"
+                            " tests in the --perf-baselines file instead of"
+                            " comparing against it")
+    perf_group.add_argument("--perf-tolerance", dest="perf_tolerance",
+                            type=float,
+                            help="Allowed regression in percent compared to"
+                            " the baselines. Default is 10")
     dir_group = parser.add_argument_group(
         "Directories and files to be used by the launcher")
     parser.add_argument('--xunit-file', action='store',
@@ -35,6 +35,98 @@
 #include <gst/validate/media-descriptor.h>
 #include <gst/pbutils/encoding-profile.h>
 #include <locale.h>             /* for LC_ALL */
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+typedef struct
+{
+  gchar *uri;
+  gboolean full;
+  GstValidateRunner *runner;
+  GstValidateMediaDescriptorWriter *writer;
+  gdouble wall_time;
+  gdouble cpu_time;
+} CheckData;
+
+static gdouble
+get_cpu_time (void)
+{
+#ifdef G_OS_UNIX
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0)
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) /
+        (gdouble) G_USEC_PER_SEC;
+#endif
+
+  return -1;
+}
+
+static void
+check_uri (CheckData * data, gpointer unused)
+{
+  GMainContext *context = g_main_context_new ();
+  gint64 start_time = g_get_monotonic_time ();
+  gdouble start_cpu_time = get_cpu_time ();
+
+  g_main_context_push_thread_default (context);
+  data->writer =
+      gst_validate_media_descriptor_writer_new_discover (data->runner,
+      data->uri, data->full, TRUE, NULL);
+  g_main_context_pop_thread_default (context);
+  g_main_context_unref (context);
+
+  data->wall_time =
+      (g_get_monotonic_time () - start_time) / (gdouble) G_USEC_PER_SEC;
+  data->cpu_time = get_cpu_time () - start_cpu_time;
+}
+
+/* Checks all the uris, @jobs of them at a time, and prints how long each
+ * one took. The CPU time is the one of the whole process, so it is only
+ * accurate per file when running one job at a time. */
+static gint
+check_uris (gchar ** uris, gboolean full, gint jobs)
+{
+  gint i, n_uris = g_strv_length (uris), ret = 0;
+  CheckData *datas = g_new0 (CheckData, n_uris);
+  GThreadPool *pool = g_thread_pool_new ((GFunc) check_uri, NULL,
+      MAX (jobs, 1), TRUE, NULL);
+
+  for (i = 0; i < n_uris; i++) {
+    datas[i].uri = uris[i];
+    datas[i].full = full;
+    datas[i].runner = gst_validate_runner_new ();
+    g_thread_pool_push (pool, &datas[i], NULL);
+  }
+
+  /* Waits for all the checks to be done */
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  for (i = 0; i < n_uris; i++) {
+    gint res = 1;
+
+    if (datas[i].writer) {
+      res = gst_validate_runner_exit (datas[i].runner, TRUE);
+      gst_object_unref (datas[i].writer);
+    } else {
+      g_print ("Could not discover file: %s\n", datas[i].uri);
+    }
+    gst_object_unref (datas[i].runner);
+
+    g_print ("%s: %s (wall time: %.3fs, cpu time: %.3fs)\n", datas[i].uri,
+        res == 0 ? "PASSED" : "FAILED", datas[i].wall_time,
+        datas[i].cpu_time);
+
+    if (res)
+      ret = 1;
+  }
+
+  g_free (datas);
+
+  return ret;
+}
 
 int
 main (int argc, gchar ** argv)
@@ -44,6 +136,7 @@ main (int argc, gchar ** argv)
   guint ret = 0;
   GError *err = NULL;
   gboolean full = FALSE;
+  gint jobs = 1;
   gchar *output_file = NULL;
   gchar *expected_file = NULL;
   gchar *output = NULL;
@@ -62,12 +155,16 @@ main (int argc, gchar ** argv)
           &expected_file, "Path to file containing the expected results "
           "(or the last results found) for comparison with new results",
         NULL},
+    {"jobs", 'j', 0, G_OPTION_ARG_INT,
+          &jobs, "When checking several files, the number of files "
+          "to check concurrently",
+        NULL},
     {NULL}
   };
 
   setlocale (LC_ALL, "");
   g_set_prgname ("gst-validate-media-check-" GST_API_VERSION);
-  ctx = g_option_context_new ("[URI]");
+  ctx = g_option_context_new ("[URI...]");
   g_option_context_set_summary (ctx, "Analyzes a media file and writes "
       "the results to stdout or a file. Can also compare the results found "
       "with another results file for identifying regressions. The monitoring"
@@ -86,7 +183,7 @@ main (int argc, gchar ** argv)
   gst_init (&argc, &argv);
   gst_validate_init ();
 
-  if (argc != 2) {
+  if (argc < 2 || (argc > 2 && (output_file || expected_file))) {
     gchar *msg = g_option_context_get_help (ctx, TRUE, NULL);
     g_printerr ("%s\n", msg);
     g_free (msg);
@@ -96,6 +193,11 @@ main (int argc, gchar ** argv)
   }
   g_option_context_free (ctx);
 
+  if (argc > 2) {
+    ret = check_uris (&argv[1], full, jobs);
+    goto out;
+  }
+
   runner = gst_validate_runner_new ();
 
   if (expected_file) {
@@ -36,6 +36,8 @@
 #include "ges-screenshot.h"
 #include "ges-audio-track.h"
 #include "ges-video-track.h"
+#include "ges-audio-uri-source.h"
+#include "ges-video-uri-source.h"
 
 GST_DEBUG_CATEGORY_STATIC (ges_pipeline_debug);
 #undef GST_CAT_DEFAULT
@@ -413,12 +415,52 @@ ges_pipeline_new (void)
   ( (GST_IS_ENCODING_AUDIO_PROFILE (profile) && (tracktype) == GES_TRACK_TYPE_AUDIO) || \
     (GST_IS_ENCODING_VIDEO_PROFILE (profile) && (tracktype) == GES_TRACK_TYPE_VIDEO))
 
+/* Whether the content of @track can be passed through without being decoded:
+ * it only contains uri sources, without effects, transitions or sources
+ * overlapping each other */
+static gboolean
+_track_is_cut_only (GESTrack * track)
+{
+  GList *tmp, *elements;
+  GstClockTime last_end = 0;
+  gboolean ret = TRUE;
+
+  elements = ges_track_get_elements (track);
+  for (tmp = elements; tmp; tmp = tmp->next) {
+    GESTrackElement *element = tmp->data;
+
+    if (!ges_track_element_is_active (element))
+      continue;
+
+    if (!GES_IS_VIDEO_URI_SOURCE (element) &&
+        !GES_IS_AUDIO_URI_SOURCE (element)) {
+      GST_DEBUG_OBJECT (track, "%" GES_TIMELINE_ELEMENT_FORMAT " needs "
+          "decoding", GES_TIMELINE_ELEMENT_ARGS (element));
+      ret = FALSE;
+      break;
+    }
+
+    /* elements are sorted by start */
+    if (_START (element) < last_end) {
+      GST_DEBUG_OBJECT (track, "%" GES_TIMELINE_ELEMENT_FORMAT " overlaps "
+          "with another source", GES_TIMELINE_ELEMENT_ARGS (element));
+      ret = FALSE;
+      break;
+    }
+    last_end = _END (element);
+  }
+  g_list_free_full (elements, gst_object_unref);
+
+  return ret;
+}
+
 static gboolean
 _track_is_compatible_with_profile (GESPipeline * self, GESTrack * track,
     GstEncodingProfile * prof)
 {
   if (TRACK_COMPATIBLE_PROFILE (track->type, prof)) {
-    if (self->priv->mode == GES_PIPELINE_MODE_SMART_RENDER) {
+    if (self->priv->mode & GES_PIPELINE_MODE_SMART_RENDER &&
+        _track_is_cut_only (track)) {
       GstCaps *ocaps, *rcaps;
 
       GST_DEBUG ("Smart Render mode, setting input caps");
@@ -434,7 +476,8 @@ _track_is_compatible_with_profile (GESPipeline * self, GESTrack * track,
     } else {
       GstCaps *caps = NULL;
 
-      /* Raw preview or rendering mode */
+      /* Raw preview or rendering mode, smart rendering falls back to it when
+       * the track content has to be decoded anyway */
       if (track->type == GES_TRACK_TYPE_VIDEO)
         caps = gst_caps_new_empty_simple ("video/x-raw");
       else if (track->type == GES_TRACK_TYPE_AUDIO)
@@ -172,6 +172,10 @@ struct _GESTimelinePrivate
   GHashTable *by_object;        /* {timecode: Source} */
   GHashTable *obj_iters;        /* {Source: TrackObjIters} */
   GSequence *starts_ends;       /* Sorted list of starts/ends */
+  /* Upper bound of the duration of the tracked sources, it never shrinks.
+   * Sources overlapping a timecode all start in the
+   * [timecode - max_source_duration, timecode] range of starts_ends */
+  GstClockTime max_source_duration;
   /* We keep 1 reference to our trackelement here */
   GSequence *tracksources;      /* Source-s sorted by start/priorities */
 
@@ -802,6 +806,8 @@ sort_starts_ends_end (GESTimeline * timeline, TrackObjIters * iters)
   guint64 *end = g_hash_table_lookup (priv->by_end, obj);
 
   *end = _START (obj) + _DURATION (obj);
+  priv->max_source_duration = MAX (priv->max_source_duration,
+      _DURATION (obj));
 
   g_sequence_sort_changed (iters->iter_end, (GCompareDataFunc) compare_uint64,
       NULL);
@@ -904,6 +910,16 @@ _find_transition_from_auto_transitions (GESTimeline * timeline,
   return NULL;
 }
 
+static inline gboolean
+_is_fitting_transition (GESTrackElement * maybe_transition, GESTrack * track,
+    GESTrackElement * next, GstClockTime transition_duration)
+{
+  return GES_IS_TRANSITION (maybe_transition) &&
+      ges_track_element_get_track (maybe_transition) == track &&
+      _START (maybe_transition) == _START (next) &&
+      _DURATION (maybe_transition) == transition_duration;
+}
+
 static GESAutoTransition *
 _create_auto_transition_from_transitions (GESTimeline * timeline,
     GESLayer * layer, GESTrack * track, GESTrackElement * prev,
@@ -911,6 +927,8 @@ _create_auto_transition_from_transitions (GESTimeline * timeline,
 {
   GSequenceIter *tmp_iter;
   GSequence *by_layer_sequence;
+  TrackObjIters *iters;
+  GESTrackElement *maybe_transition = NULL;
 
   GESTimelinePrivate *priv = timeline->priv;
   GESAutoTransition *auto_transition =
@@ -922,9 +940,43 @@ _create_auto_transition_from_transitions (GESTimeline * timeline,
 
 
   /* Try to find a transition that perfectly fits with the one that
-   * should be added at that place
-   * optimize: Use g_sequence_search instead of going over all the
-   * sequence */
+   * should be added at that place. The layer sequence is sorted by start, so
+   * such a transition is a neighbour of @next */
+  iters = g_hash_table_lookup (priv->obj_iters, next);
+  if (iters && iters->layer == layer && iters->iter_by_layer) {
+    for (tmp_iter = iters->iter_by_layer;
+        !g_sequence_iter_is_begin (tmp_iter);) {
+      tmp_iter = g_sequence_iter_prev (tmp_iter);
+      if (_START (g_sequence_get (tmp_iter)) != _START (next))
+        break;
+      if (_is_fitting_transition (g_sequence_get (tmp_iter), track, next,
+              transition_duration)) {
+        maybe_transition = g_sequence_get (tmp_iter);
+        break;
+      }
+    }
+
+    for (tmp_iter = g_sequence_iter_next (iters->iter_by_layer);
+        !maybe_transition && !g_sequence_iter_is_end (tmp_iter);
+        tmp_iter = g_sequence_iter_next (tmp_iter)) {
+      if (_START (g_sequence_get (tmp_iter)) != _START (next))
+        break;
+      if (_is_fitting_transition (g_sequence_get (tmp_iter), track, next,
+              transition_duration))
+        maybe_transition = g_sequence_get (tmp_iter);
+    }
+
+    if (maybe_transition)
+      /* TODO We should make sure that the transition contains only
+       * TrackElement-s in @track and if it is not the case properly unlink the
+       * object to use it */
+      return create_transition (timeline, prev, next,
+          GES_CLIP (GES_TIMELINE_ELEMENT_PARENT (maybe_transition)), layer,
+          _START (next), transition_duration);
+
+    return NULL;
+  }
+
   by_layer_sequence = g_hash_table_lookup (priv->by_layer, layer);
   for (tmp_iter = g_sequence_get_begin_iter (by_layer_sequence);
       tmp_iter && !g_sequence_iter_is_end (tmp_iter);
@@ -974,8 +1026,17 @@ _create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
     return;
 
   layer_prio = ges_layer_get_priority (layer);
-  for (iter = g_sequence_get_begin_iter (priv->starts_ends);
-      iter && !g_sequence_iter_is_end (iter);
+  iter = g_sequence_get_begin_iter (priv->starts_ends);
+  if (initiating_obj && _START (initiating_obj) > priv->max_source_duration) {
+    guint64 from = _START (initiating_obj) - priv->max_source_duration;
+
+    /* Sources starting before @from end before @initiating_obj starts, so
+     * they cannot overlap with it */
+    iter = g_sequence_search (priv->starts_ends, &from,
+        (GCompareDataFunc) compare_uint64, NULL);
+  }
+
+  for (; iter && !g_sequence_iter_is_end (iter);
       iter = g_sequence_iter_next (iter)) {
     GList *tmp;
     guint *start_or_end = g_sequence_get (iter);
@@ -1172,6 +1233,8 @@ start_tracking_track_element (GESTimeline * timeline,
     pend = g_malloc (sizeof (guint64));
     *pstart = _START (trackelement);
     *pend = *pstart + _DURATION (trackelement);
+    priv->max_source_duration = MAX (priv->max_source_duration,
+        _DURATION (trackelement));
 
     iters->iter_start = g_sequence_insert_sorted (priv->starts_ends, pstart,
         (GCompareDataFunc) compare_uint64, NULL);
@@ -1281,11 +1344,16 @@ ges_timeline_snap_position (GESTimeline * timeline,
    * the snap_distance value */
   nxt_iter = iter;
   while (!g_sequence_iter_is_end (nxt_iter)) {
-    next_tc = g_sequence_get (iter);
+    next_tc = g_sequence_get (nxt_iter);
+
+    /* starts_ends is sorted, nothing further can be in range */
+    off = timecode > *next_tc ? timecode - *next_tc : *next_tc - timecode;
+    if (*next_tc > timecode && off > snap_distance)
+      break;
+
     tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, next_tc);
     tmp_container = get_toplevel_container (tmp_trackelement);
 
-    off = timecode > *next_tc ? timecode - *next_tc : *next_tc - timecode;
     if (next_tc != current && off <= snap_distance
         && container != tmp_container) {
 
@@ -1307,10 +1375,14 @@ ges_timeline_snap_position (GESTimeline * timeline,
   prev_iter = g_sequence_iter_prev (iter);
   while (!g_sequence_iter_is_begin (prev_iter)) {
     prev_tc = g_sequence_get (prev_iter);
+
+    off1 = timecode > *prev_tc ? timecode - *prev_tc : *prev_tc - timecode;
+    if (off1 > snap_distance)
+      break;
+
     tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, prev_tc);
     tmp_container = get_toplevel_container (tmp_trackelement);
 
-    off1 = timecode > *prev_tc ? timecode - *prev_tc : *prev_tc - timecode;
     if (prev_tc != current && off1 < off && off1 <= snap_distance &&
         container != tmp_container) {
       ret = prev_tc;
@@ -35,6 +35,19 @@
 
 static GHashTable *parent_newparent_table = NULL;
 
+/* Asynchronous discovery is spread over a small pool of discoverers so that
+ * loading a project with many media files does not discover them one after
+ * the other. klass->discoverer is always the first one of the pool. */
+#define DEFAULT_DISCOVERER_POOL_SIZE 4
+static GstDiscoverer **discoverers = NULL;
+static gint *discoverers_pending = NULL;
+static guint n_discoverers = 0;
+
+/* Discovery results for local files are kept on disk, keyed by the uri, size
+ * and modification time of the file, so reloading a project does not need to
+ * discover all its media again. Set GES_DISCOVERY_NO_CACHE to disable it. */
+static gboolean use_discovery_cache = TRUE;
+
 static void
 initable_iface_init (GInitableIface * initable_iface)
 {
@@ -108,20 +121,157 @@ ges_uri_clip_asset_set_property (GObject * object, guint property_id,
   }
 }
 
+static gchar *
+_get_discovery_cache_filename (const gchar * uri)
+{
+  GFile *file;
+  GFileInfo *finfo;
+  gchar *key, *checksum, *filename = NULL;
+
+  if (!use_discovery_cache || !gst_uri_has_protocol (uri, "file"))
+    return NULL;
+
+  file = g_file_new_for_uri (uri);
+  finfo = g_file_query_info (file, G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+      G_FILE_ATTRIBUTE_TIME_MODIFIED, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  g_object_unref (file);
+
+  if (!finfo)
+    return NULL;
+
+  key = g_strdup_printf ("%s-%" G_GUINT64_FORMAT "-%" G_GUINT64_FORMAT, uri,
+      (guint64) g_file_info_get_size (finfo),
+      g_file_info_get_attribute_uint64 (finfo,
+          G_FILE_ATTRIBUTE_TIME_MODIFIED));
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+  filename = g_build_filename (g_get_user_cache_dir (), "gstreamer-1.0",
+      "ges-discoverer", checksum, NULL);
+
+  g_free (checksum);
+  g_free (key);
+  g_object_unref (finfo);
+
+  return filename;
+}
+
+static GstDiscovererInfo *
+_load_cached_info (const gchar * uri)
+{
+  gsize size;
+  gchar *data, *filename;
+  GVariant *variant;
+  GstDiscovererInfo *info = NULL;
+
+  filename = _get_discovery_cache_filename (uri);
+  if (!filename)
+    return NULL;
+
+  if (!g_file_get_contents (filename, &data, &size, NULL))
+    goto done;
+
+  variant = g_variant_new_from_data (G_VARIANT_TYPE_VARIANT, data, size,
+      FALSE, g_free, data);
+  if (g_variant_is_normal_form (variant))
+    info = gst_discoverer_info_from_variant (variant);
+  g_variant_unref (variant);
+
+  if (info && g_strcmp0 (gst_discoverer_info_get_uri (info), uri)) {
+    gst_discoverer_info_unref (info);
+    info = NULL;
+  }
+
+  GST_DEBUG ("Discovery cache %s for %s", info ? "hit" : "invalid", uri);
+
+done:
+  g_free (filename);
+
+  return info;
+}
+
+static void
+_save_cached_info (GstDiscovererInfo * info)
+{
+  gchar *dirname, *filename;
+  GVariant *variant;
+  GError *err = NULL;
+
+  filename = _get_discovery_cache_filename (gst_discoverer_info_get_uri (info));
+  if (!filename)
+    return;
+
+  variant = gst_discoverer_info_to_variant (info, GST_DISCOVERER_SERIALIZE_ALL);
+  if (!variant)
+    goto done;
+
+  dirname = g_path_get_dirname (filename);
+  g_mkdir_with_parents (dirname, 0750);
+  g_free (dirname);
+
+  if (!g_file_set_contents (filename, g_variant_get_data (variant),
+          g_variant_get_size (variant), &err)) {
+    GST_INFO ("Could not write discovery cache %s: %s", filename,
+        err->message);
+    g_clear_error (&err);
+  }
+  g_variant_unref (variant);
+
+done:
+  g_free (filename);
+}
+
+static gboolean
+_cached_info_discovered_cb (GstDiscovererInfo * info)
+{
+  discoverer_discovered_cb (NULL, info, NULL, NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
+static guint
+_get_discoverer_index (GstDiscoverer * discoverer)
+{
+  guint i;
+
+  for (i = 0; i < n_discoverers; i++) {
+    if (discoverers[i] == discoverer)
+      return i;
+  }
+
+  return n_discoverers;
+}
+
 static GESAssetLoadingReturn
 _start_loading (GESAsset * asset, GError ** error)
 {
-  gboolean ret;
+  guint i, best = 0;
   const gchar *uri;
-  GESUriClipAssetClass *class = GES_URI_CLIP_ASSET_GET_CLASS (asset);
+  GstDiscovererInfo *info;
 
   GST_DEBUG ("Started loading %p", asset);
 
   uri = ges_asset_get_id (asset);
 
-  ret = gst_discoverer_discover_uri_async (class->discoverer, uri);
-  if (ret)
+  info = _load_cached_info (uri);
+  if (info) {
+    /* Keep the loading asynchronous, as if it came from the discoverer */
+    g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+        (GSourceFunc) _cached_info_discovered_cb, info,
+        (GDestroyNotify) gst_discoverer_info_unref);
+
+    return GES_ASSET_LOADING_ASYNC;
+  }
+
+  /* Hand the uri to the least busy discoverer of the pool */
+  for (i = 1; i < n_discoverers; i++) {
+    if (g_atomic_int_get (&discoverers_pending[i]) <
+        g_atomic_int_get (&discoverers_pending[best]))
+      best = i;
+  }
+
+  if (gst_discoverer_discover_uri_async (discoverers[best], uri)) {
+    g_atomic_int_inc (&discoverers_pending[best]);
     return GES_ASSET_LOADING_ASYNC;
+  }
 
   return GES_ASSET_LOADING_ERROR;
 }
@@ -182,8 +332,9 @@ _asset_proxied (GESAsset * self, const gchar * new_uri)
 static void
 ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
 {
+  guint i;
   GstClockTime timeout;
-  const gchar *timeout_str;
+  const gchar *timeout_str, *pool_size_str;
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   g_type_class_add_private (klass, sizeof (GESUriClipAssetPrivate));
 
@@ -216,13 +367,27 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
   if (errno)
     timeout = 60 * GST_SECOND;
 
-  klass->discoverer = gst_discoverer_new (timeout, NULL);
-  klass->sync_discoverer = gst_discoverer_new (timeout, NULL);
-  g_signal_connect (klass->discoverer, "discovered",
-      G_CALLBACK (discoverer_discovered_cb), NULL);
+  pool_size_str = g_getenv ("GES_DISCOVERY_POOL_SIZE");
+  if (pool_size_str)
+    n_discoverers = CLAMP (g_ascii_strtoull (pool_size_str, NULL, 10), 1, 64);
+  else
+    n_discoverers = MIN (g_get_num_processors (), DEFAULT_DISCOVERER_POOL_SIZE);
+
+  use_discovery_cache = g_getenv ("GES_DISCOVERY_NO_CACHE") == NULL;
+
+  discoverers = g_new0 (GstDiscoverer *, n_discoverers);
+  discoverers_pending = g_new0 (gint, n_discoverers);
+  for (i = 0; i < n_discoverers; i++) {
+    discoverers[i] = gst_discoverer_new (timeout, NULL);
+    g_signal_connect (discoverers[i], "discovered",
+        G_CALLBACK (discoverer_discovered_cb), NULL);
 
-  /* We just start the discoverer and let it live */
-  gst_discoverer_start (klass->discoverer);
+    /* We just start the discoverers and let them live */
+    gst_discoverer_start (discoverers[i]);
+  }
+
+  klass->discoverer = discoverers[0];
+  klass->sync_discoverer = gst_discoverer_new (timeout, NULL);
   if (parent_newparent_table == NULL) {
     parent_newparent_table = g_hash_table_new_full (g_file_hash,
         (GEqualFunc) g_file_equal, gst_object_unref, gst_object_unref);
@@ -351,12 +516,23 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
   GESUriClipAsset *mfs =
       GES_URI_CLIP_ASSET (ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uri));
 
+  if (discoverer) {
+    guint i = _get_discoverer_index (discoverer);
+
+    if (i < n_discoverers)
+      g_atomic_int_add (&discoverers_pending[i], -1);
+  }
+
   tags = gst_discoverer_info_get_tags (info);
   if (tags)
     gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, mfs);
 
   if (gst_discoverer_info_get_result (info) == GST_DISCOVERER_OK) {
     ges_uri_clip_asset_set_info (mfs, info);
+
+    /* Results coming from the cache are not written back */
+    if (discoverer)
+      _save_cached_info (info);
   } else {
     if (err) {
       error = g_error_copy (err);
@@ -546,9 +722,12 @@ void
 ges_uri_clip_asset_class_set_timeout (GESUriClipAssetClass * klass,
     GstClockTime timeout)
 {
+  guint i;
+
   g_return_if_fail (GES_IS_URI_CLIP_ASSET_CLASS (klass));
 
-  g_object_set (klass->discoverer, "timeout", timeout, NULL);
+  for (i = 0; i < n_discoverers; i++)
+    g_object_set (discoverers[i], "timeout", timeout, NULL);
   g_object_set (klass->sync_discoverer, "timeout", timeout, NULL);
 }
 
@@ -569,6 +748,205 @@ ges_uri_clip_asset_get_stream_assets (GESUriClipAsset * self)
   return self->priv->asset_trackfilesources;
 }
 
+typedef struct
+{
+  gchar *proxy_uri;
+  GstEncodingProfile *profile;
+} ProxyData;
+
+static void
+_free_proxy_data (ProxyData * data)
+{
+  g_free (data->proxy_uri);
+  gst_encoding_profile_unref (data->profile);
+  g_slice_free (ProxyData, data);
+}
+
+static void
+_proxy_pad_added_cb (GstElement * decodebin, GstPad * pad, GstBin * pipeline)
+{
+  GstCaps *caps;
+  GstPad *sinkpad = NULL;
+  GstElement *encodebin = gst_bin_get_by_name (pipeline, "proxy-encodebin");
+
+  caps = gst_pad_query_caps (pad, NULL);
+  g_signal_emit_by_name (encodebin, "request-pad", caps, &sinkpad);
+  gst_caps_unref (caps);
+  gst_object_unref (encodebin);
+
+  if (sinkpad == NULL) {
+    GstElement *fakesink = gst_element_factory_make ("fakesink", NULL);
+
+    /* The profile has no stream for it, drop it */
+    GST_INFO_OBJECT (decodebin, "Not transcoding %" GST_PTR_FORMAT, pad);
+    g_object_set (fakesink, "async", FALSE, NULL);
+    gst_bin_add (pipeline, fakesink);
+    gst_element_sync_state_with_parent (fakesink);
+    sinkpad = gst_element_get_static_pad (fakesink, "sink");
+  }
+
+  if (gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_WARNING_OBJECT (decodebin, "Could not link %" GST_PTR_FORMAT, pad);
+  gst_object_unref (sinkpad);
+}
+
+static void
+_create_proxy_thread (GTask * task, GESUriClipAsset * self, ProxyData * data,
+    GCancellable * cancellable)
+{
+  GstBus *bus;
+  GstMessage *msg;
+  GESUriClipAsset *proxy;
+  GError *error = NULL;
+  gboolean done = FALSE;
+  GstElement *pipeline, *decodebin, *encodebin, *sink;
+
+  pipeline = gst_pipeline_new ("proxy-pipeline");
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  encodebin = gst_element_factory_make ("encodebin", "proxy-encodebin");
+  sink = gst_element_make_from_uri (GST_URI_SINK, data->proxy_uri, NULL,
+      &error);
+
+  if (!decodebin || !encodebin || !sink) {
+    if (!error)
+      error = g_error_new (GES_ERROR, GES_ERROR_ASSET_LOADING,
+          "Missing elements to create proxy %s", data->proxy_uri);
+    if (decodebin)
+      gst_object_unref (decodebin);
+    if (encodebin)
+      gst_object_unref (encodebin);
+    if (sink)
+      gst_object_unref (sink);
+    gst_object_unref (pipeline);
+    g_task_return_error (task, error);
+    return;
+  }
+
+  g_object_set (decodebin, "uri", ges_asset_get_id (GES_ASSET (self)), NULL);
+  g_object_set (encodebin, "profile", data->profile, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), decodebin, encodebin, sink, NULL);
+  gst_element_link (encodebin, sink);
+  g_signal_connect (decodebin, "pad-added", G_CALLBACK (_proxy_pad_added_cb),
+      pipeline);
+
+  GST_INFO_OBJECT (self, "Creating proxy %s", data->proxy_uri);
+  bus = gst_element_get_bus (pipeline);
+  if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    error = g_error_new (GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Could not start transcoding to %s", data->proxy_uri);
+    done = TRUE;
+  }
+
+  while (!done) {
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+      break;
+
+    msg = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    if (!msg)
+      continue;
+
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+      gst_message_parse_error (msg, &error, NULL);
+    done = TRUE;
+    gst_message_unref (msg);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  if (error) {
+    g_task_return_error (task, error);
+    return;
+  }
+
+  proxy = ges_uri_clip_asset_request_sync (data->proxy_uri, &error);
+  if (!proxy) {
+    g_task_return_error (task, error);
+    return;
+  }
+
+  g_task_return_pointer (task, gst_object_ref (proxy), gst_object_unref);
+}
+
+/**
+ * ges_uri_clip_asset_create_proxy_async:
+ * @self: A #GESUriClipAsset
+ * @proxy_uri: The URI where the proxy file should be written
+ * @profile: The #GstEncodingProfile describing the proxy, usually a low
+ * resolution, intra only, video format
+ * @cancellable: (allow-none): optional %GCancellable object, %NULL to ignore.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the proxy is
+ * ready
+ * @user_data: The user data to pass when @callback is called
+ *
+ * Transcodes @self into @proxy_uri using @profile in a worker thread. When done,
+ * call ges_uri_clip_asset_create_proxy_finish() from @callback to get the
+ * proxy asset, which then is registered as the default proxy of @self (see
+ * ges_asset_set_proxy()).
+ *
+ * Since: 1.10
+ */
+void
+ges_uri_clip_asset_create_proxy_async (GESUriClipAsset * self,
+    const gchar * proxy_uri, GstEncodingProfile * profile,
+    GCancellable * cancellable, GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  GTask *task;
+  ProxyData *data;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+  g_return_if_fail (proxy_uri != NULL);
+  g_return_if_fail (GST_IS_ENCODING_PROFILE (profile));
+
+  data = g_slice_new0 (ProxyData);
+  data->proxy_uri = g_strdup (proxy_uri);
+  data->profile = gst_encoding_profile_ref (profile);
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_task_data (task, data, (GDestroyNotify) _free_proxy_data);
+  g_task_run_in_thread (task, (GTaskThreadFunc) _create_proxy_thread);
+  g_object_unref (task);
+}
+
+/**
+ * ges_uri_clip_asset_create_proxy_finish:
+ * @self: A #GESUriClipAsset
+ * @res: The #GAsyncResult from which to get the proxy
+ * @error: (allow-none): An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes a proxy creation started with
+ * ges_uri_clip_asset_create_proxy_async() and sets the proxy as the default
+ * proxy of @self.
+ *
+ * Returns: (transfer full) (nullable): The proxy #GESAsset or %NULL if an
+ * error happened
+ *
+ * Since: 1.10
+ */
+GESAsset *
+ges_uri_clip_asset_create_proxy_finish (GESUriClipAsset * self,
+    GAsyncResult * res, GError ** error)
+{
+  GESAsset *proxy;
+
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), NULL);
+  g_return_val_if_fail (g_task_is_valid (res, self), NULL);
+
+  proxy = g_task_propagate_pointer (G_TASK (res), error);
+  if (proxy && !ges_asset_set_proxy (GES_ASSET (self), proxy)) {
+    g_set_error (error, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Could not use %s as a proxy", ges_asset_get_id (proxy));
+    gst_object_unref (proxy);
+    proxy = NULL;
+  }
+
+  return proxy;
+}
+
 /*****************************************************************
  *            GESUriSourceAsset implementation             *
  *****************************************************************/
@@ -23,6 +23,7 @@
 
 #include <glib-object.h>
 #include <gio/gio.h>
+#include <gst/pbutils/encoding-profile.h>
 #include <ges/ges-types.h>
 #include <ges/ges-asset.h>
 #include <ges/ges-clip-asset.h>
@@ -78,6 +79,15 @@ GESUriClipAsset* ges_uri_clip_asset_request_sync    (const gchar *uri, GError **
 void ges_uri_clip_asset_class_set_timeout           (GESUriClipAssetClass *klass,
                                                      GstClockTime timeout);
 const GList * ges_uri_clip_asset_get_stream_assets  (GESUriClipAsset *self);
+void ges_uri_clip_asset_create_proxy_async          (GESUriClipAsset *self,
+                                                     const gchar *proxy_uri,
+                                                     GstEncodingProfile *profile,
+                                                     GCancellable *cancellable,
+                                                     GAsyncReadyCallback callback,
+                                                     gpointer user_data);
+GESAsset * ges_uri_clip_asset_create_proxy_finish   (GESUriClipAsset *self,
+                                                     GAsyncResult *res,
+                                                     GError **error);
 
 #define GES_TYPE_URI_SOURCE_ASSET ges_uri_source_asset_get_type()
 #define GES_URI_SOURCE_ASSET(obj) \
@@ -131,6 +131,15 @@ struct _NleCompositionPrivate
   /* current stack, list of NleObject* */
   GNode *current;
 
+  /* stack for the next edit boundary, computed ahead of time while the
+   * current stack is playing. Only valid for next_stack_time in the
+   * next_stack_reverse direction */
+  GNode *next_stack;
+  GstClockTime next_stack_time;
+  GstClockTime next_stack_start;
+  GstClockTime next_stack_stop;
+  gboolean next_stack_reverse;
+
   /* List of NleObject whose start/duration will be the same as the composition */
   GList *expandables;
 
@@ -245,6 +254,9 @@ static void _deactivate_stack (NleComposition * comp,
 static gboolean _set_real_eos_seqnum_from_seek (NleComposition * comp,
     GstEvent * event);
 static void _emit_commited_signal_func (NleComposition * comp, gpointer udata);
+static void _precompute_next_stack_func (NleComposition * comp,
+    gpointer udata);
+static void _clear_next_stack (NleComposition * comp);
 static void _restart_task (NleComposition * comp);
 static void
 _add_action (NleComposition * comp, GCallback func, gpointer data,
@@ -619,6 +631,8 @@ _commit_all_values (NleComposition * comp)
 
   priv->next_base_time = 0;
 
+  /* objects might be removed or moved, the next stack has to be recomputed */
+  _clear_next_stack (comp);
   _process_pending_entries (comp);
 
   if (_commit_values (comp) == FALSE) {
@@ -952,6 +966,7 @@ nle_composition_class_init (NleCompositionClass * klass)
   GST_DEBUG_REGISTER_FUNCPTR (_commit_func);
   GST_DEBUG_REGISTER_FUNCPTR (_emit_commited_signal_func);
   GST_DEBUG_REGISTER_FUNCPTR (_initialize_stack_func);
+  GST_DEBUG_REGISTER_FUNCPTR (_precompute_next_stack_func);
 
   /* Just be useless, so the compiler does not warn us
    * about our uselessness */
@@ -1061,6 +1076,8 @@ nle_composition_finalize (GObject * object)
     priv->current = NULL;
   }
 
+  _clear_next_stack (comp);
+
   g_hash_table_destroy (priv->objects_hash);
 
   gst_segment_free (priv->segment);
@@ -1134,6 +1151,7 @@ nle_composition_reset (NleComposition * comp)
   if (priv->current)
     g_node_destroy (priv->current);
   priv->current = NULL;
+  _clear_next_stack (comp);
 
   nle_composition_reset_target_pad (comp);
 
@@ -1882,6 +1900,7 @@ beach:
  * @start: The biggest start time of the objects in the stack
  * @stop: The smallest stop time of the objects in the stack
  * @highprio: The highest priority in the stack
+ * @dry_run: Do not update the base time of the operations in the stack
  *
  * Not MT-safe, you should take the objects lock before calling it.
  * Returns: A tree of #GNode sorted in priority order, corresponding
@@ -1892,7 +1911,7 @@ beach:
 static GNode *
 get_stack_list (NleComposition * comp, GstClockTime timestamp,
     guint32 priority, gboolean activeonly, GstClockTime * start,
-    GstClockTime * stop, guint * highprio)
+    GstClockTime * stop, guint * highprio, gboolean dry_run)
 {
   GList *tmp;
   GList *stack = NULL;
@@ -1928,7 +1947,7 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
               GST_OBJECT_NAME (object));
           stack = g_list_insert_sorted (stack, object,
               (GCompareFunc) priority_comp);
-          if (NLE_IS_OPERATION (object))
+          if (NLE_IS_OPERATION (object) && !dry_run)
             nle_operation_update_base_time (NLE_OPERATION (object), timestamp);
         }
       } else {
@@ -1955,7 +1974,7 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
               GST_OBJECT_NAME (object));
           stack = g_list_insert_sorted (stack, object,
               (GCompareFunc) priority_comp);
-          if (NLE_IS_OPERATION (object))
+          if (NLE_IS_OPERATION (object) && !dry_run)
             nle_operation_update_base_time (NLE_OPERATION (object), timestamp);
         }
       } else {
@@ -1973,7 +1992,7 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
           GST_OBJECT_NAME (tmp->data));
       stack = g_list_insert_sorted (stack, tmp->data,
           (GCompareFunc) priority_comp);
-      if (NLE_IS_OPERATION (tmp->data))
+      if (NLE_IS_OPERATION (tmp->data) && !dry_run)
         nle_operation_update_base_time (NLE_OPERATION (tmp->data), timestamp);
     }
 
@@ -2008,6 +2027,8 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
  * @timestamp: The #GstClockTime to look at
  * @stop_time: Pointer to a #GstClockTime for min stop time of returned stack
  * @start_time: Pointer to a #GstClockTime for greatest start time of returned stack
+ * @dry_run: Only compute the stack, without touching the operations in it or
+ * posting errors
  *
  * Returns: The new current stack for the given #NleComposition and @timestamp.
  *
@@ -2015,7 +2036,7 @@ get_stack_list (NleComposition * comp, GstClockTime timestamp,
  */
 static GNode *
 get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
-    GstClockTime * start_time, GstClockTime * stop_time)
+    GstClockTime * start_time, GstClockTime * stop_time, gboolean dry_run)
 {
   GNode *stack = NULL;
   GstClockTime start = G_MAXUINT64;
@@ -2028,9 +2049,10 @@ get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
   GST_DEBUG ("start:%" GST_TIME_FORMAT ", stop:%" GST_TIME_FORMAT,
       GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
 
-  stack = get_stack_list (comp, *timestamp, 0, TRUE, &start, &stop, &highprio);
+  stack = get_stack_list (comp, *timestamp, 0, TRUE, &start, &stop, &highprio,
+      dry_run);
 
-  if (!stack &&
+  if (!stack && !dry_run &&
       ((reverse && (*timestamp > COMP_REAL_START (comp))) ||
           (!reverse && (*timestamp < COMP_REAL_STOP (comp))))) {
     GST_ELEMENT_ERROR (comp, STREAM, WRONG_TYPE,
@@ -2077,6 +2099,84 @@ get_clean_toplevel_stack (NleComposition * comp, GstClockTime * timestamp,
   return stack;
 }
 
+static void
+_clear_next_stack (NleComposition * comp)
+{
+  NleCompositionPrivate *priv = comp->priv;
+
+  if (priv->next_stack)
+    g_node_destroy (priv->next_stack);
+  priv->next_stack = NULL;
+  priv->next_stack_time = GST_CLOCK_TIME_NONE;
+}
+
+/* Compute the stack for the end of the current one while it is playing, so
+ * that the switch at the edit boundary only has to relink the objects.
+ *
+ * WITH OBJECTS LOCK TAKEN */
+static void
+_precompute_next_stack_func (NleComposition * comp, gpointer udata)
+{
+  GNode *stack;
+  NleCompositionPrivate *priv = comp->priv;
+  gboolean reverse = (priv->segment->rate < 0.0);
+  GstClockTime start = GST_CLOCK_TIME_NONE;
+  GstClockTime stop = GST_CLOCK_TIME_NONE;
+  GstClockTime timestamp = reverse ? priv->segment_start : priv->segment_stop;
+
+  _clear_next_stack (comp);
+
+  /* update_pipeline() handles the end of the composition itself */
+  if (!priv->current || !GST_CLOCK_TIME_IS_VALID (timestamp) ||
+      timestamp + 1 >= NLE_OBJECT (comp)->duration)
+    return;
+
+  stack = get_clean_toplevel_stack (comp, &timestamp, &start, &stop, TRUE);
+  if (!stack)
+    return;
+
+  GST_DEBUG_OBJECT (comp, "Precomputed next stack at %" GST_TIME_FORMAT
+      " [%" GST_TIME_FORMAT " - %" GST_TIME_FORMAT "]",
+      GST_TIME_ARGS (timestamp), GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
+
+  priv->next_stack = stack;
+  priv->next_stack_time = timestamp;
+  priv->next_stack_start = start;
+  priv->next_stack_stop = stop;
+  priv->next_stack_reverse = reverse;
+}
+
+/* Returns the precomputed stack if it was computed for @timestamp, and
+ * updates the base time of its operations as get_stack_list() would have.
+ *
+ * WITH OBJECTS LOCK TAKEN */
+static GNode *
+_take_next_stack (NleComposition * comp, GstClockTime timestamp,
+    GstClockTime * start_time, GstClockTime * stop_time)
+{
+  GNode *stack = NULL;
+  NleCompositionPrivate *priv = comp->priv;
+  gboolean reverse = (priv->segment->rate < 0.0);
+
+  if (priv->next_stack && priv->next_stack_time == timestamp &&
+      priv->next_stack_reverse == reverse) {
+    GST_DEBUG_OBJECT (comp, "Using precomputed stack at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (timestamp));
+
+    stack = priv->next_stack;
+    priv->next_stack = NULL;
+    *start_time = priv->next_stack_start;
+    *stop_time = priv->next_stack_stop;
+
+    g_node_traverse (stack, G_IN_ORDER, G_TRAVERSE_ALL, -1,
+        (GNodeTraverseFunc) update_base_time, &timestamp);
+  }
+
+  _clear_next_stack (comp);
+
+  return stack;
+}
+
 static GstPadProbeReturn
 _drop_all_cb (GstPad * pad G_GNUC_UNUSED,
     GstPadProbeInfo * info, NleComposition * comp)
@@ -2867,7 +2967,10 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
       gst_element_state_get_name (state));
 
   /* Get new stack and compare it to current one */
-  stack = get_clean_toplevel_stack (comp, &currenttime, &new_start, &new_stop);
+  stack = _take_next_stack (comp, currenttime, &new_start, &new_stop);
+  if (!stack)
+    stack = get_clean_toplevel_stack (comp, &currenttime, &new_start,
+        &new_stop, FALSE);
   samestack = are_same_stacks (priv->current, stack);
 
   /* set new segment_start/stop (the current zone over which the new stack
@@ -2941,6 +3044,11 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
     gst_task_pause (comp->task);
     GST_OBJECT_UNLOCK (comp);
+
+    /* Prepare the following stack once this one runs */
+    _remove_actions_for_type (comp, G_CALLBACK (_precompute_next_stack_func));
+    _add_action (comp, G_CALLBACK (_precompute_next_stack_func), NULL,
+        G_PRIORITY_LOW);
   }
 
   /* Activate stack */
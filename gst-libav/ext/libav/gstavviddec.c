@@ -37,6 +37,13 @@
 #include "gstavutils.h"
 #include "gstavviddec.h"
 
+/* generic hardware device contexts, AVCodecContext.hw_device_ctx and
+ * av_hwdevice_find_type_by_name() are available since FFmpeg 3.4 */
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT (57, 107, 100)
+#define HAVE_LIBAV_HWACCEL 1
+#include <libavutil/hwcontext.h>
+#endif
+
 #define MAX_TS_MASK 0xff
 
 #define DEFAULT_LOWRES			0
@@ -45,6 +52,8 @@
 #define DEFAULT_DEBUG_MV		FALSE
 #define DEFAULT_MAX_THREADS		0
 #define DEFAULT_OUTPUT_CORRUPT		TRUE
+#define DEFAULT_HWACCEL			NULL
+#define DEFAULT_HWACCEL_DEVICE		NULL
 #define REQUIRED_POOL_MAX_BUFFERS       32
 #define DEFAULT_STRIDE_ALIGN            31
 #define DEFAULT_ALLOC_PARAM             { 0, DEFAULT_STRIDE_ALIGN, 0, 0, }
@@ -58,6 +67,8 @@ enum
   PROP_DEBUG_MV,
   PROP_MAX_THREADS,
   PROP_OUTPUT_CORRUPT,
+  PROP_HWACCEL,
+  PROP_HWACCEL_DEVICE,
   PROP_LAST
 };
 
@@ -231,6 +242,19 @@ gst_ffmpegviddec_class_init (GstFFMpegVidDecClass * klass)
       g_param_spec_boolean ("output-corrupt", "Output corrupt buffers",
           "Whether libav should output frames even if corrupted",
           DEFAULT_OUTPUT_CORRUPT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+#ifdef HAVE_LIBAV_HWACCEL
+  g_object_class_install_property (gobject_class, PROP_HWACCEL,
+      g_param_spec_string ("hwaccel", "Hardware acceleration",
+          "Type of hardware device to decode with, e.g. vaapi, vdpau, cuda "
+          "or videotoolbox. Decoded frames are downloaded to system memory. "
+          "NULL for software decoding", DEFAULT_HWACCEL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_HWACCEL_DEVICE,
+      g_param_spec_string ("hwaccel-device", "Hardware acceleration device",
+          "Device to use for hardware acceleration, e.g. a DRM render node "
+          "for vaapi. NULL for the default device", DEFAULT_HWACCEL_DEVICE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+#endif
 
   caps = klass->in_plugin->capabilities;
   if (caps & (CODEC_CAP_FRAME_THREADS | CODEC_CAP_SLICE_THREADS)) {
@@ -268,6 +292,9 @@ gst_ffmpegviddec_init (GstFFMpegVidDec * ffmpegdec)
   ffmpegdec->debug_mv = DEFAULT_DEBUG_MV;
   ffmpegdec->max_threads = DEFAULT_MAX_THREADS;
   ffmpegdec->output_corrupt = DEFAULT_OUTPUT_CORRUPT;
+  ffmpegdec->hwaccel = g_strdup (DEFAULT_HWACCEL);
+  ffmpegdec->hwaccel_device = g_strdup (DEFAULT_HWACCEL_DEVICE);
+  ffmpegdec->hw_pix_fmt = AV_PIX_FMT_NONE;
 
   GST_PAD_SET_ACCEPT_TEMPLATE (GST_VIDEO_DECODER_SINK_PAD (ffmpegdec));
   gst_video_decoder_set_use_default_pad_acceptcaps (GST_VIDEO_DECODER_CAST
@@ -282,6 +309,8 @@ gst_ffmpegviddec_finalize (GObject * object)
   GstFFMpegVidDec *ffmpegdec = (GstFFMpegVidDec *) object;
 
   av_frame_free (&ffmpegdec->picture);
+  g_free (ffmpegdec->hwaccel);
+  g_free (ffmpegdec->hwaccel_device);
 
   if (ffmpegdec->context != NULL) {
     gst_ffmpeg_avcodec_close (ffmpegdec->context);
@@ -320,6 +349,12 @@ gst_ffmpegviddec_close (GstFFMpegVidDec * ffmpegdec, gboolean reset)
   gst_ffmpeg_avcodec_close (ffmpegdec->context);
   ffmpegdec->opened = FALSE;
 
+#ifdef HAVE_LIBAV_HWACCEL
+  av_buffer_unref (&ffmpegdec->context->hw_device_ctx);
+  ffmpegdec->context->get_format = avcodec_default_get_format;
+#endif
+  ffmpegdec->hw_pix_fmt = AV_PIX_FMT_NONE;
+
   for (i = 0; i < G_N_ELEMENTS (ffmpegdec->stride); i++)
     ffmpegdec->stride[i] = -1;
 
@@ -340,6 +375,111 @@ gst_ffmpegviddec_close (GstFFMpegVidDec * ffmpegdec, gboolean reset)
   return TRUE;
 }
 
+#ifdef HAVE_LIBAV_HWACCEL
+static enum AVPixelFormat
+gst_ffmpegviddec_hw_pix_fmt (enum AVHWDeviceType type)
+{
+  switch (type) {
+    case AV_HWDEVICE_TYPE_VAAPI:
+      return AV_PIX_FMT_VAAPI;
+    case AV_HWDEVICE_TYPE_VDPAU:
+      return AV_PIX_FMT_VDPAU;
+    case AV_HWDEVICE_TYPE_CUDA:
+      return AV_PIX_FMT_CUDA;
+    case AV_HWDEVICE_TYPE_VIDEOTOOLBOX:
+      return AV_PIX_FMT_VIDEOTOOLBOX;
+    case AV_HWDEVICE_TYPE_DXVA2:
+      return AV_PIX_FMT_DXVA2_VLD;
+    case AV_HWDEVICE_TYPE_D3D11VA:
+      return AV_PIX_FMT_D3D11;
+    default:
+      return AV_PIX_FMT_NONE;
+  }
+}
+
+/* called by libav to pick the output format, prefer the format of our
+ * hardware device and fall back to software decoding otherwise */
+static enum AVPixelFormat
+gst_ffmpegviddec_get_format (AVCodecContext * context,
+    const enum AVPixelFormat *fmts)
+{
+  GstFFMpegVidDec *ffmpegdec = (GstFFMpegVidDec *) context->opaque;
+  const enum AVPixelFormat *p;
+
+  for (p = fmts; *p != AV_PIX_FMT_NONE; p++) {
+    if (*p == ffmpegdec->hw_pix_fmt)
+      return *p;
+  }
+
+  GST_WARNING_OBJECT (ffmpegdec, "%s decoding not possible for this stream, "
+      "decoding in software", ffmpegdec->hwaccel);
+
+  return avcodec_default_get_format (context, fmts);
+}
+
+/* with LOCK */
+static void
+gst_ffmpegviddec_setup_hwaccel (GstFFMpegVidDec * ffmpegdec)
+{
+  enum AVHWDeviceType type;
+  enum AVPixelFormat pix_fmt;
+
+  if (ffmpegdec->hwaccel == NULL)
+    return;
+
+  type = av_hwdevice_find_type_by_name (ffmpegdec->hwaccel);
+  pix_fmt = gst_ffmpegviddec_hw_pix_fmt (type);
+  if (pix_fmt == AV_PIX_FMT_NONE)
+    goto unknown_type;
+
+  if (av_hwdevice_ctx_create (&ffmpegdec->context->hw_device_ctx, type,
+          ffmpegdec->hwaccel_device, NULL, 0) < 0)
+    goto no_device;
+
+  GST_INFO_OBJECT (ffmpegdec, "decoding with %s", ffmpegdec->hwaccel);
+
+  ffmpegdec->hw_pix_fmt = pix_fmt;
+  ffmpegdec->context->get_format = gst_ffmpegviddec_get_format;
+  return;
+
+  /* ERRORS */
+unknown_type:
+  {
+    GST_ELEMENT_WARNING (ffmpegdec, LIBRARY, SETTINGS, (NULL),
+        ("Unsupported hardware acceleration '%s', decoding in software",
+            ffmpegdec->hwaccel));
+    return;
+  }
+no_device:
+  {
+    GST_ELEMENT_WARNING (ffmpegdec, LIBRARY, INIT, (NULL),
+        ("Failed to open %s device %s, decoding in software",
+            ffmpegdec->hwaccel, GST_STR_NULL (ffmpegdec->hwaccel_device)));
+    return;
+  }
+}
+
+/* replace the hardware frame in ffmpegdec->picture with a copy of it in
+ * system memory */
+static gboolean
+gst_ffmpegviddec_download_picture (GstFFMpegVidDec * ffmpegdec)
+{
+  AVFrame *sw_picture = av_frame_alloc ();
+
+  if (av_hwframe_transfer_data (sw_picture, ffmpegdec->picture, 0) < 0 ||
+      av_frame_copy_props (sw_picture, ffmpegdec->picture) < 0) {
+    av_frame_free (&sw_picture);
+    return FALSE;
+  }
+
+  av_frame_unref (ffmpegdec->picture);
+  av_frame_move_ref (ffmpegdec->picture, sw_picture);
+  av_frame_free (&sw_picture);
+
+  return TRUE;
+}
+#endif
+
 /* with LOCK */
 static gboolean
 gst_ffmpegviddec_open (GstFFMpegVidDec * ffmpegdec)
@@ -349,6 +489,10 @@ gst_ffmpegviddec_open (GstFFMpegVidDec * ffmpegdec)
 
   oclass = (GstFFMpegVidDecClass *) (G_OBJECT_GET_CLASS (ffmpegdec));
 
+#ifdef HAVE_LIBAV_HWACCEL
+  gst_ffmpegviddec_setup_hwaccel (ffmpegdec);
+#endif
+
   if (gst_ffmpeg_avcodec_open (ffmpegdec->context, oclass->in_plugin) < 0)
     goto could_not_open;
 
@@ -662,6 +806,56 @@ gst_ffmpegvideodec_prepare_dr_pool (GstFFMpegVidDec * ffmpegdec,
   gst_buffer_pool_config_set_video_alignment (config, &align);
 }
 
+/* Sets the direct rendering @config on @pool. When the pool does not accept
+ * it as is, retry with the pool's suggested config as long as that still
+ * provides the alignment and padding libav needs */
+static gboolean
+gst_ffmpegviddec_set_dr_config (GstFFMpegVidDec * ffmpegdec,
+    GstBufferPool * pool, GstStructure * config, GstCaps * caps, guint size,
+    guint min, guint max)
+{
+  GstVideoAlignment align, pool_align;
+  gint i;
+
+  gst_buffer_pool_config_get_video_alignment (config, &align);
+
+  if (gst_buffer_pool_set_config (pool, config))
+    return TRUE;
+
+  config = gst_buffer_pool_get_config (pool);
+  if (!gst_buffer_pool_config_validate_params (config, caps, size, min, max))
+    goto invalid_config;
+
+  if (!gst_buffer_pool_config_has_option (config,
+          GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT) ||
+      !gst_buffer_pool_config_get_video_alignment (config, &pool_align))
+    goto invalid_config;
+
+  if (pool_align.padding_top < align.padding_top ||
+      pool_align.padding_left < align.padding_left ||
+      pool_align.padding_right < align.padding_right ||
+      pool_align.padding_bottom < align.padding_bottom)
+    goto invalid_config;
+
+  for (i = 0; i < GST_VIDEO_MAX_PLANES; i++) {
+    if ((pool_align.stride_align[i] & align.stride_align[i]) !=
+        align.stride_align[i])
+      goto invalid_config;
+  }
+
+  GST_DEBUG_OBJECT (ffmpegdec, "using modified pool config");
+
+  return gst_buffer_pool_set_config (pool, config);
+
+  /* ERRORS */
+invalid_config:
+  {
+    GST_DEBUG_OBJECT (ffmpegdec, "pool config not usable for direct rendering");
+    gst_structure_free (config);
+    return FALSE;
+  }
+}
+
 static void
 gst_ffmpegviddec_ensure_internal_pool (GstFFMpegVidDec * ffmpegdec,
     AVFrame * picture)
@@ -773,7 +967,9 @@ gst_ffmpegviddec_get_buffer2 (AVCodecContext * context, AVFrame * picture,
 
   GST_DEBUG_OBJECT (ffmpegdec, "storing opaque %p", dframe);
 
-  if (!gst_ffmpegviddec_can_direct_render (ffmpegdec))
+  /* hardware frames are allocated by libav */
+  if (!gst_ffmpegviddec_can_direct_render (ffmpegdec) ||
+      picture->format == ffmpegdec->hw_pix_fmt)
     goto no_dr;
 
   gst_ffmpegviddec_ensure_internal_pool (ffmpegdec, picture);
@@ -1355,6 +1551,12 @@ gst_ffmpegviddec_video_frame (GstFFMpegVidDec * ffmpegdec,
   gst_buffer_replace (&out_frame->output_buffer, out_dframe->buffer);
   gst_buffer_replace (&out_dframe->buffer, NULL);
 
+#ifdef HAVE_LIBAV_HWACCEL
+  if (ffmpegdec->picture->format == ffmpegdec->hw_pix_fmt &&
+      !gst_ffmpegviddec_download_picture (ffmpegdec))
+    goto download_failed;
+#endif
+
   GST_DEBUG_OBJECT (ffmpegdec,
       "pts %" G_GUINT64_FORMAT " duration %" G_GUINT64_FORMAT,
       out_frame->pts, out_frame->duration);
@@ -1483,6 +1685,18 @@ negotiation_error:
     *ret = GST_FLOW_NOT_NEGOTIATED;
     goto beach;
   }
+#ifdef HAVE_LIBAV_HWACCEL
+download_failed:
+  {
+    GST_ELEMENT_ERROR (ffmpegdec, STREAM, DECODE, (NULL),
+        ("Failed to download decoded frame from %s device",
+            ffmpegdec->hwaccel));
+    av_frame_unref (ffmpegdec->picture);
+    gst_video_decoder_drop_frame (GST_VIDEO_DECODER (ffmpegdec), out_frame);
+    *ret = GST_FLOW_ERROR;
+    goto beach;
+  }
+#endif
 }
 
 
@@ -1825,6 +2039,27 @@ gst_ffmpegviddec_decide_allocation (GstVideoDecoder * decoder, GstQuery * query)
   have_alignment =
       gst_buffer_pool_has_option (pool, GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
 
+  /* Downstream handles any stride and offsets, but its pool can't give us
+   * the padding libav needs. Rather than decoding into the internal pool and
+   * copying every frame, decode into a video pool that allocates from the
+   * downstream allocator (e.g. dmabuf), with the padding we need */
+  if (have_videometa && have_pool && !have_alignment &&
+      gst_ffmpegviddec_can_direct_render (ffmpegdec)) {
+    GST_DEBUG_OBJECT (ffmpegdec, "downstream pool %" GST_PTR_FORMAT
+        " does not support alignment, using a video pool", pool);
+    gst_object_unref (pool);
+    gst_structure_free (config);
+
+    pool = gst_video_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, state->caps, size, min, max);
+    gst_buffer_pool_config_set_allocator (config, allocator, &params);
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_META);
+    have_alignment = TRUE;
+    update_pool = TRUE;
+  }
+
   /* If we have videometa, we never have to copy */
   if (have_videometa && have_pool && have_alignment &&
       gst_ffmpegviddec_can_direct_render (ffmpegdec)) {
@@ -1833,8 +2068,8 @@ gst_ffmpegviddec_decide_allocation (GstVideoDecoder * decoder, GstQuery * query)
     gst_ffmpegvideodec_prepare_dr_pool (ffmpegdec, pool, &state->info,
         config_copy);
 
-    /* FIXME validate and retry */
-    if (gst_buffer_pool_set_config (pool, config_copy)) {
+    if (gst_ffmpegviddec_set_dr_config (ffmpegdec, pool, config_copy,
+            state->caps, size, min, max)) {
       GstFlowReturn ret;
       GstBuffer *tmp;
 
@@ -1957,6 +2192,14 @@ gst_ffmpegviddec_set_property (GObject * object,
     case PROP_OUTPUT_CORRUPT:
       ffmpegdec->output_corrupt = g_value_get_boolean (value);
       break;
+    case PROP_HWACCEL:
+      g_free (ffmpegdec->hwaccel);
+      ffmpegdec->hwaccel = g_value_dup_string (value);
+      break;
+    case PROP_HWACCEL_DEVICE:
+      g_free (ffmpegdec->hwaccel_device);
+      ffmpegdec->hwaccel_device = g_value_dup_string (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1988,6 +2231,12 @@ gst_ffmpegviddec_get_property (GObject * object,
     case PROP_OUTPUT_CORRUPT:
       g_value_set_boolean (value, ffmpegdec->output_corrupt);
       break;
+    case PROP_HWACCEL:
+      g_value_set_string (value, ffmpegdec->hwaccel);
+      break;
+    case PROP_HWACCEL_DEVICE:
+      g_value_set_string (value, ffmpegdec->hwaccel_device);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
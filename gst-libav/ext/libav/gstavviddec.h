@@ -63,6 +63,9 @@ struct _GstFFMpegVidDec
   gboolean debug_mv;
   int max_threads;
   gboolean output_corrupt;
+  gchar *hwaccel;
+  gchar *hwaccel_device;
+  enum AVPixelFormat hw_pix_fmt;
 
   GstCaps *last_caps;
 
@@ -29,6 +29,7 @@
 #include <errno.h>
 
 #include <libavcodec/avcodec.h>
+#include <libavutil/opt.h>
 
 #include <gst/gst.h>
 #include <gst/video/gstvideometa.h>
@@ -41,6 +42,7 @@
 
 #define DEFAULT_VIDEO_BITRATE 300000    /* in bps */
 #define DEFAULT_VIDEO_GOP_SIZE 15
+#define DEFAULT_LATENCY_MODE GST_FFMPEG_LATENCY_AUTO
 
 #define DEFAULT_WIDTH 352
 #define DEFAULT_HEIGHT 288
@@ -64,9 +66,41 @@ enum
   PROP_RTP_PAYLOAD_SIZE,
   PROP_MAX_THREADS,
   PROP_COMPLIANCE,
+  PROP_LATENCY_MODE,
   PROP_CFG_BASE,
 };
 
+enum
+{
+  GST_FFMPEG_LATENCY_AUTO,
+  GST_FFMPEG_LATENCY_NORMAL,
+  GST_FFMPEG_LATENCY_LOW,
+  GST_FFMPEG_LATENCY_ZERO
+};
+
+#define GST_TYPE_FFMPEG_LATENCY_MODE (gst_ffmpegvidenc_latency_mode_get_type())
+static GType
+gst_ffmpegvidenc_latency_mode_get_type (void)
+{
+  static GType ffmpegenc_latency_mode_type = 0;
+  static GEnumValue ffmpegenc_latency_modes[] = {
+    {GST_FFMPEG_LATENCY_AUTO,
+        "Slice threading only if upstream is live", "auto"},
+    {GST_FFMPEG_LATENCY_NORMAL, "Codec defaults", "normal"},
+    {GST_FFMPEG_LATENCY_LOW,
+        "Slice threading, no B-frames, short lookahead", "low"},
+    {GST_FFMPEG_LATENCY_ZERO,
+        "Slice threading, no B-frames, no lookahead", "zero"},
+    {0, NULL, NULL},
+  };
+  if (!ffmpegenc_latency_mode_type) {
+    ffmpegenc_latency_mode_type =
+        g_enum_register_static ("GstLibAVVidEncLatencyMode",
+        ffmpegenc_latency_modes);
+  }
+  return ffmpegenc_latency_mode_type;
+}
+
 #define GST_TYPE_ME_METHOD (gst_ffmpegvidenc_me_method_get_type())
 static GType
 gst_ffmpegvidenc_me_method_get_type (void)
@@ -221,6 +255,13 @@ gst_ffmpegvidenc_class_init (GstFFMpegVidEncClass * klass)
           GST_TYPE_FFMPEG_COMPLIANCE, FFMPEG_DEFAULT_COMPLIANCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_LATENCY_MODE,
+      g_param_spec_enum ("latency-mode", "Latency mode",
+          "Trade encoding efficiency for lower latency. Overrides the "
+          "threading, B-frame and lookahead settings",
+          GST_TYPE_FFMPEG_LATENCY_MODE, DEFAULT_LATENCY_MODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* register additional properties, possibly dependent on the exact CODEC */
   gst_ffmpeg_cfg_install_property (klass, PROP_CFG_BASE);
 
@@ -257,6 +298,7 @@ gst_ffmpegvidenc_init (GstFFMpegVidEnc * ffmpegenc)
   ffmpegenc->rtp_payload_size = 0;
   ffmpegenc->compliance = FFMPEG_DEFAULT_COMPLIANCE;
   ffmpegenc->max_threads = 0;
+  ffmpegenc->latency_mode = DEFAULT_LATENCY_MODE;
 
   ffmpegenc->lmin = 2;
   ffmpegenc->lmax = 31;
@@ -282,6 +324,52 @@ gst_ffmpegvidenc_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+/* configure threading, B-frames and lookahead for the selected latency mode,
+ * overriding whatever the other properties set */
+static void
+gst_ffmpegvidenc_setup_latency_mode (GstFFMpegVidEnc * ffmpegenc)
+{
+  AVCodecContext *ctx = ffmpegenc->context;
+  gint mode = ffmpegenc->latency_mode;
+
+  if (mode == GST_FFMPEG_LATENCY_AUTO) {
+    GstQuery *query;
+    gboolean is_live = FALSE;
+
+    /* Check if upstream is live. If it isn't we can enable frame based
+     * threading, which is adding latency */
+    query = gst_query_new_latency ();
+    if (gst_pad_peer_query (GST_VIDEO_ENCODER_SINK_PAD (ffmpegenc), query))
+      gst_query_parse_latency (query, &is_live, NULL, NULL);
+    gst_query_unref (query);
+
+    if (is_live)
+      ctx->thread_type = FF_THREAD_SLICE;
+    else
+      ctx->thread_type = FF_THREAD_SLICE | FF_THREAD_FRAME;
+
+    GST_DEBUG_OBJECT (ffmpegenc, "upstream is %slive", is_live ? "" : "not ");
+    return;
+  }
+
+  if (mode == GST_FFMPEG_LATENCY_NORMAL)
+    return;
+
+  /* every frame leaves the encoder as soon as it is encoded */
+  ctx->thread_type = FF_THREAD_SLICE;
+  ctx->max_b_frames = 0;
+
+  /* lookahead is a private option of the external encoders, set it on
+   * the ones that have it and ignore the others */
+  av_opt_set_int (ctx, "rc-lookahead",
+      mode == GST_FFMPEG_LATENCY_LOW ? 10 : 0, AV_OPT_SEARCH_CHILDREN);
+  av_opt_set_int (ctx, "lag-in-frames",
+      mode == GST_FFMPEG_LATENCY_LOW ? 10 : 0, AV_OPT_SEARCH_CHILDREN);
+
+  if (mode == GST_FFMPEG_LATENCY_ZERO)
+    ctx->flags |= CODEC_FLAG_LOW_DELAY;
+}
+
 static gboolean
 gst_ffmpegvidenc_set_format (GstVideoEncoder * encoder,
     GstVideoCodecState * state)
@@ -350,6 +438,8 @@ gst_ffmpegvidenc_set_format (GstVideoEncoder * encoder,
   ffmpegenc->context->context_model = 0;
   ffmpegenc->context->scenechange_threshold = 0;
 
+  gst_ffmpegvidenc_setup_latency_mode (ffmpegenc);
+
   /* and last but not least the pass; CBR, 2-pass, etc */
   ffmpegenc->context->flags |= ffmpegenc->pass;
   switch (ffmpegenc->pass) {
@@ -475,6 +565,21 @@ gst_ffmpegvidenc_set_format (GstVideoEncoder * encoder,
   output_format = gst_video_encoder_set_output_state (encoder, icaps, state);
   gst_video_codec_state_unref (output_format);
 
+  /* The encoder is configured, we now know the true latency */
+  if (state->info.fps_n) {
+    GstClockTime latency;
+    gint frames = ffmpegenc->context->delay;
+
+    if (ffmpegenc->context->active_thread_type & FF_THREAD_FRAME)
+      frames += MAX (ffmpegenc->context->thread_count - 1, 0);
+
+    latency = gst_util_uint64_scale_ceil (frames * GST_SECOND,
+        state->info.fps_d, state->info.fps_n);
+    GST_DEBUG_OBJECT (ffmpegenc, "latency %d frames, %" GST_TIME_FORMAT,
+        frames, GST_TIME_ARGS (latency));
+    gst_video_encoder_set_latency (encoder, latency, latency);
+  }
+
   /* Store some tags */
   {
     GstTagList *tags = gst_tag_list_new_empty ();
@@ -814,6 +919,9 @@ gst_ffmpegvidenc_set_property (GObject * object,
     case PROP_MAX_THREADS:
       ffmpegenc->max_threads = g_value_get_int (value);
       break;
+    case PROP_LATENCY_MODE:
+      ffmpegenc->latency_mode = g_value_get_enum (value);
+      break;
     default:
       if (!gst_ffmpeg_cfg_set_property (object, value, pspec))
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -853,6 +961,9 @@ gst_ffmpegvidenc_get_property (GObject * object,
     case PROP_MAX_THREADS:
       g_value_set_int (value, ffmpegenc->max_threads);
       break;
+    case PROP_LATENCY_MODE:
+      g_value_set_enum (value, ffmpegenc->latency_mode);
+      break;
     default:
       if (!gst_ffmpeg_cfg_get_property (object, value, pspec))
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -51,6 +51,7 @@ struct _GstFFMpegVidEnc
   gint rtp_payload_size;
   gint compliance;
   gint max_threads;
+  gint latency_mode;
 
   guint8 *working_buf;
   gsize working_buf_size;
@@ -36,6 +36,14 @@
  *     use-content-length=false
  * ]|
  * </refsect2>
+ *
+ * When #GstCurlBaseSink:max-parallel-uploads is larger than one, the upload
+ * of a new file is started as soon as all data of the previous one was sent,
+ * while the response for the previous file is still pending. The uploads
+ * share one curl multi stack, so connections are reused between files and,
+ * if the server supports it, several uploads are multiplexed over one
+ * connection. This hides the server round trip when publishing segments
+ * over high latency links.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -70,6 +78,7 @@
 #define DEFAULT_URL                    "localhost:5555"
 #define DEFAULT_TIMEOUT                30
 #define DEFAULT_QOS_DSCP               0
+#define DEFAULT_MAX_PARALLEL_UPLOADS   1
 
 #define DSCP_MIN                       0
 #define DSCP_MAX                       63
@@ -91,9 +100,16 @@ enum
   PROP_USER_PASSWD,
   PROP_FILE_NAME,
   PROP_TIMEOUT,
-  PROP_QOS_DSCP
+  PROP_QOS_DSCP,
+  PROP_MAX_PARALLEL_UPLOADS
 };
 
+typedef struct
+{
+  CURL *curl;
+  struct curl_slist *headers;
+} FinishingTransfer;
+
 /* Object class function declarations */
 static void gst_curl_base_sink_finalize (GObject * gobject);
 static void gst_curl_base_sink_set_property (GObject * object, guint prop_id,
@@ -144,6 +160,11 @@ static void gst_curl_base_sink_data_sent_notify (GstCurlBaseSink * sink);
 static void gst_curl_base_sink_wait_for_response (GstCurlBaseSink * sink);
 static void gst_curl_base_sink_got_response_notify (GstCurlBaseSink * sink);
 
+static gboolean gst_curl_base_sink_transfer_retire_unlocked
+    (GstCurlBaseSink * sink);
+static gboolean gst_curl_base_sink_transfer_reap (GstCurlBaseSink * sink);
+static gboolean gst_curl_base_sink_update_poll_fds (GstCurlBaseSink * sink);
+
 static void handle_transfer (GstCurlBaseSink * sink);
 static size_t transfer_data_buffer (void *curl_ptr, TransferBuffer * buf,
     size_t max_bytes_to_send, guint * last_chunk);
@@ -234,6 +255,13 @@ gst_curl_base_sink_class_init (GstCurlBaseSinkClass * klass)
           "Quality of Service, differentiated services code point (0 default)",
           DSCP_MIN, DSCP_MAX, DEFAULT_QOS_DSCP,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_MAX_PARALLEL_UPLOADS,
+      g_param_spec_int ("max-parallel-uploads", "Max parallel uploads",
+          "Maximum number of files being uploaded at the same time. Uploads "
+          "of new files start while the response for the previous file is "
+          "pending (1 = upload one file after the other)",
+          1, G_MAXINT, DEFAULT_MAX_PARALLEL_UPLOADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (element_class, &sinktemplate);
 }
@@ -255,6 +283,8 @@ gst_curl_base_sink_init (GstCurlBaseSink * sink)
   sink->error = NULL;
   sink->flow_ret = GST_FLOW_OK;
   sink->is_live = FALSE;
+  sink->max_parallel_uploads = DEFAULT_MAX_PARALLEL_UPLOADS;
+  sink->poll_fds = g_hash_table_new_full (NULL, NULL, NULL, g_free);
 }
 
 static void
@@ -276,6 +306,7 @@ gst_curl_base_sink_finalize (GObject * gobject)
   g_free (this->user);
   g_free (this->passwd);
   g_free (this->file_name);
+  g_hash_table_destroy (this->poll_fds);
   if (this->fdset != NULL) {
     gst_poll_free (this->fdset);
     this->fdset = NULL;
@@ -464,6 +495,7 @@ gst_curl_base_sink_stop (GstBaseSink * bsink)
   GstCurlBaseSink *sink = GST_CURL_BASE_SINK (bsink);
 
   gst_curl_base_sink_transfer_thread_close (sink);
+  g_hash_table_remove_all (sink->poll_fds);
   if (sink->fdset != NULL) {
     gst_poll_free (sink->fdset);
     sink->fdset = NULL;
@@ -542,6 +574,11 @@ gst_curl_base_sink_set_property (GObject * object, guint prop_id,
         gst_curl_base_sink_setup_dscp_unlocked (sink);
         GST_DEBUG_OBJECT (sink, "dscp set to %d", sink->qos_dscp);
         break;
+      case PROP_MAX_PARALLEL_UPLOADS:
+        sink->max_parallel_uploads = g_value_get_int (value);
+        GST_DEBUG_OBJECT (sink, "max parallel uploads set to %d",
+            sink->max_parallel_uploads);
+        break;
       default:
         GST_DEBUG_OBJECT (sink, "invalid property id %d", prop_id);
         break;
@@ -607,6 +644,9 @@ gst_curl_base_sink_get_property (GObject * object, guint prop_id,
     case PROP_QOS_DSCP:
       g_value_set_int (value, sink->qos_dscp);
       break;
+    case PROP_MAX_PARALLEL_UPLOADS:
+      g_value_set_int (value, sink->max_parallel_uploads);
+      break;
     default:
       GST_DEBUG_OBJECT (sink, "invalid property id");
       break;
@@ -706,6 +746,19 @@ gst_curl_base_sink_transfer_set_common_options_unlocked (GstCurlBaseSink * sink)
     return FALSE;
   }
 
+#ifdef CURLPIPE_MULTIPLEX
+  if (sink->max_parallel_uploads > 1) {
+    /* rather wait for a connection that can multiplex the upload than
+     * opening a new one */
+    res = curl_easy_setopt (sink->curl, CURLOPT_PIPEWAIT, 1L);
+    if (res != CURLE_OK) {
+      sink->error = g_strdup_printf ("failed to set pipe wait: %s",
+          curl_easy_strerror (res));
+      return FALSE;
+    }
+  }
+#endif
+
   GST_LOG ("common options set");
   return TRUE;
 }
@@ -824,6 +877,12 @@ gst_curl_base_sink_transfer_read_cb (void *curl_ptr, size_t size, size_t nmemb,
       return bytes_to_send;
     }
 
+    /* all data of this file is sent, the next file can be uploaded while
+     * waiting for the response */
+    if (sink->max_parallel_uploads > 1 && sink->new_file &&
+        !sink->transfer_thread_close)
+      sink->upload_done = TRUE;
+
     GST_OBJECT_UNLOCK (sink);
     GST_LOG ("returning 0, no more data to send in this file");
 
@@ -854,8 +913,10 @@ gst_curl_base_sink_transfer_write_cb (void G_GNUC_UNUSED * ptr, size_t size,
   sink = (GstCurlBaseSink *) stream;
   klass = GST_CURL_BASE_SINK_GET_CLASS (sink);
 
-  if (klass->transfer_verify_response_code) {
-    if (!klass->transfer_verify_response_code (sink)) {
+  /* with pipelined uploads the response may belong to any of the running
+   * transfers, they are verified once they are done */
+  if (klass->transfer_verify_response_code && sink->max_parallel_uploads <= 1) {
+    if (!klass->transfer_verify_response_code (sink, sink->curl)) {
       GST_DEBUG_OBJECT (sink, "response error");
       GST_OBJECT_LOCK (sink);
       sink->flow_ret = GST_FLOW_ERROR;
@@ -904,11 +965,17 @@ handle_transfer (GstCurlBaseSink * sink)
   gint activated_fds;
   gint running_handles;
   gint timeout;
+  gint max_parallel_uploads;
+  gboolean parallel;
+  gboolean have_fds;
+  GstClockTime wait_time;
   CURLMcode m_code;
   CURLcode e_code;
 
   GST_OBJECT_LOCK (sink);
   timeout = sink->timeout;
+  max_parallel_uploads = sink->max_parallel_uploads;
+  parallel = max_parallel_uploads > 1;
   GST_OBJECT_UNLOCK (sink);
 
   GST_DEBUG_OBJECT (sink, "handling transfers");
@@ -922,11 +989,44 @@ handle_transfer (GstCurlBaseSink * sink)
   GST_DEBUG_OBJECT (sink, "running handles: %d", running_handles);
 
   while (running_handles && (m_code == CURLM_OK)) {
+    wait_time = timeout * GST_SECOND;
+    have_fds = TRUE;
+
+    if (parallel) {
+      gboolean upload_done;
+      gint n_finishing;
+
+      /* the current upload completed while others are still running */
+      if (gst_curl_base_sink_transfer_reap (sink))
+        break;
+
+      /* go on with the next file as long as the limit allows it */
+      GST_OBJECT_LOCK (sink);
+      upload_done = sink->upload_done;
+      n_finishing = g_list_length (sink->finishing_transfers);
+      GST_OBJECT_UNLOCK (sink);
+      if (upload_done && n_finishing + 1 < max_parallel_uploads)
+        break;
+    }
+
     if (klass->transfer_prepare_poll_wait) {
       klass->transfer_prepare_poll_wait (sink);
     }
 
-    activated_fds = gst_poll_wait (sink->fdset, timeout * GST_SECOND);
+    if (parallel)
+      have_fds = gst_curl_base_sink_update_poll_fds (sink);
+
+    if (!have_fds) {
+      glong curl_timeout = -1;
+
+      /* no sockets yet, e.g. while resolving, check back when curl wants */
+      curl_multi_timeout (sink->multi_handle, &curl_timeout);
+      if (curl_timeout < 0 || curl_timeout > 100)
+        curl_timeout = 100;
+      wait_time = curl_timeout * GST_MSECOND;
+    }
+
+    activated_fds = gst_poll_wait (sink->fdset, wait_time);
     if (G_UNLIKELY (activated_fds == -1)) {
       if (errno == EAGAIN || errno == EINTR) {
         GST_DEBUG_OBJECT (sink, "interrupted by signal");
@@ -946,7 +1046,7 @@ handle_transfer (GstCurlBaseSink * sink)
         retval = GST_FLOW_ERROR;
         goto fail;
       }
-    } else if (G_UNLIKELY (activated_fds == 0)) {
+    } else if (G_UNLIKELY (activated_fds == 0) && have_fds) {
       sink->error = g_strdup_printf ("poll timed out after %" GST_TIME_FORMAT,
           GST_TIME_ARGS (timeout * GST_SECOND));
       retval = GST_FLOW_ERROR;
@@ -967,6 +1067,13 @@ handle_transfer (GstCurlBaseSink * sink)
     goto fail;
   }
 
+  if (parallel) {
+    /* errors of the individual transfers are set when reaping them */
+    gst_curl_base_sink_transfer_reap (sink);
+    gst_curl_base_sink_got_response_notify (sink);
+    return;
+  }
+
   /* problems still might have occurred on individual transfers even when
    * curl_multi_perform returns CURLM_OK */
   if ((e_code = gst_curl_base_sink_transfer_check (sink)) != CURLE_OK) {
@@ -1088,7 +1195,10 @@ gst_curl_base_sink_transfer_socket_cb (void *clientp, curl_socket_t curlfd,
   GST_OBJECT_LOCK (sink);
   sink->socket_type = socket_type;
 
-  if (sink->fd.fd != curlfd) {
+  if (sink->max_parallel_uploads > 1) {
+    /* the poll set is updated from curl_multi_fdset() for all transfers */
+    sink->fd.fd = curlfd;
+  } else if (sink->fd.fd != curlfd) {
     if (sink->fd.fd > 0 && sink->socket_type != CURLSOCKTYPE_ACCEPT) {
       ret &= gst_poll_remove_fd (sink->fdset, &sink->fd);
     }
@@ -1180,6 +1290,9 @@ gst_curl_base_sink_transfer_thread_func (gpointer data)
           GST_OBJECT_UNLOCK (sink);
         }
         GST_LOG ("adding handle");
+        GST_OBJECT_LOCK (sink);
+        sink->upload_done = FALSE;
+        GST_OBJECT_UNLOCK (sink);
         curl_multi_add_handle (sink->multi_handle, sink->curl);
       }
 
@@ -1189,8 +1302,21 @@ gst_curl_base_sink_transfer_thread_func (gpointer data)
       /* easy handle will be possibly re-used for next transfer, thus it needs
        * to be removed from the multi stack and re-added again */
       if (!gst_curl_base_sink_is_live (sink)) {
-        GST_LOG ("removing handle");
-        curl_multi_remove_handle (sink->multi_handle, sink->curl);
+        GST_OBJECT_LOCK (sink);
+        if (sink->upload_done) {
+          /* keep the transfer running until the response arrived and
+           * continue with the next file on a new handle */
+          GST_LOG ("upload done, waiting for response in the background");
+          if (!gst_curl_base_sink_transfer_retire_unlocked (sink)) {
+            sink->flow_ret = GST_FLOW_ERROR;
+            goto done;
+          }
+          GST_OBJECT_UNLOCK (sink);
+        } else {
+          GST_OBJECT_UNLOCK (sink);
+          GST_LOG ("removing handle");
+          curl_multi_remove_handle (sink->multi_handle, sink->curl);
+        }
       }
     } else {
       GST_LOG ("have no data yet");
@@ -1200,6 +1326,13 @@ gst_curl_base_sink_transfer_thread_func (gpointer data)
     GST_OBJECT_LOCK (sink);
   }
 
+  /* wait for the responses of the uploads that are still running */
+  if (sink->finishing_transfers && sink->flow_ret == GST_FLOW_OK) {
+    GST_OBJECT_UNLOCK (sink);
+    klass->handle_transfer (sink);
+    GST_OBJECT_LOCK (sink);
+  }
+
   if (sink->is_live) {
     GST_LOG ("removing handle");
     curl_multi_remove_handle (sink->multi_handle, sink->curl);
@@ -1253,15 +1386,181 @@ gst_curl_base_sink_transfer_setup_unlocked (GstCurlBaseSink * sink)
       sink->error = g_strdup ("failed to init curl multi handle");
       return FALSE;
     }
+
+    if (sink->max_parallel_uploads > 1) {
+      curl_multi_setopt (sink->multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS,
+          (long) sink->max_parallel_uploads);
+#ifdef CURLPIPE_MULTIPLEX
+      curl_multi_setopt (sink->multi_handle, CURLMOPT_PIPELINING,
+          CURLPIPE_MULTIPLEX);
+#endif
+    }
   }
 
   GST_LOG ("transfer setup done");
   return TRUE;
 }
 
+static void
+finishing_transfer_free (GstCurlBaseSink * sink, FinishingTransfer * transfer)
+{
+  if (sink->multi_handle != NULL) {
+    curl_multi_remove_handle (sink->multi_handle, transfer->curl);
+  }
+  curl_easy_cleanup (transfer->curl);
+  if (transfer->headers) {
+    curl_slist_free_all (transfer->headers);
+  }
+  g_slice_free (FinishingTransfer, transfer);
+}
+
+/* Moves the current transfer, whose data is completely sent, to the
+ * finishing transfers and sets up a new handle for the next file */
+static gboolean
+gst_curl_base_sink_transfer_retire_unlocked (GstCurlBaseSink * sink)
+{
+  GstCurlBaseSinkClass *klass = GST_CURL_BASE_SINK_GET_CLASS (sink);
+  FinishingTransfer *transfer;
+  CURL *curl;
+
+  /* all options are copied, the headers are set again for the next file */
+  if ((curl = curl_easy_duphandle (sink->curl)) == NULL) {
+    sink->error = g_strdup ("failed to duplicate curl easy handle");
+    return FALSE;
+  }
+
+  transfer = g_slice_new0 (FinishingTransfer);
+  transfer->curl = sink->curl;
+  /* the headers are used by the transfer until it is done */
+  if (klass->steal_transfer_headers_unlocked) {
+    transfer->headers = klass->steal_transfer_headers_unlocked (sink);
+  }
+  sink->finishing_transfers =
+      g_list_append (sink->finishing_transfers, transfer);
+  sink->curl = curl;
+  sink->upload_done = FALSE;
+
+  return TRUE;
+}
+
+/* Checks the results of the transfers that are done and frees the finishing
+ * ones. Returns TRUE when the current transfer is done */
+static gboolean
+gst_curl_base_sink_transfer_reap (GstCurlBaseSink * sink)
+{
+  GstCurlBaseSinkClass *klass = GST_CURL_BASE_SINK_GET_CLASS (sink);
+  gboolean current_done = FALSE;
+  CURLMsg *msg;
+  gint msgs_left;
+
+  while ((msg = curl_multi_info_read (sink->multi_handle, &msgs_left))) {
+    CURL *easy;
+    CURLcode code;
+    gchar *eff_url = NULL;
+    GList *l;
+
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    easy = msg->easy_handle;
+    code = msg->data.result;
+    curl_easy_getinfo (easy, CURLINFO_EFFECTIVE_URL, &eff_url);
+    GST_DEBUG_OBJECT (sink, "transfer done %s (%s-%d)", eff_url,
+        curl_easy_strerror (code), code);
+
+    GST_OBJECT_LOCK (sink);
+    if (sink->flow_ret == GST_FLOW_OK) {
+      if (code != CURLE_OK) {
+        sink->error = g_strdup_printf ("failed to transfer data: %s",
+            curl_easy_strerror (code));
+        sink->flow_ret = GST_FLOW_ERROR;
+      } else if (klass->transfer_verify_response_code &&
+          !klass->transfer_verify_response_code (sink, easy)) {
+        GST_DEBUG_OBJECT (sink, "response error");
+        sink->flow_ret = GST_FLOW_ERROR;
+      }
+    }
+
+    if (easy == sink->curl) {
+      current_done = TRUE;
+    } else {
+      for (l = sink->finishing_transfers; l; l = l->next) {
+        FinishingTransfer *transfer = l->data;
+
+        if (transfer->curl == easy) {
+          sink->finishing_transfers =
+              g_list_delete_link (sink->finishing_transfers, l);
+          finishing_transfer_free (sink, transfer);
+          break;
+        }
+      }
+    }
+    GST_OBJECT_UNLOCK (sink);
+  }
+
+  return current_done;
+}
+
+/* Updates the poll set with the sockets of all running transfers. Returns
+ * FALSE if curl currently waits on no socket */
+static gboolean
+gst_curl_base_sink_update_poll_fds (GstCurlBaseSink * sink)
+{
+  fd_set read_fds, write_fds, exc_fds;
+  GHashTableIter iter;
+  gpointer key, value;
+  gint max_fd = -1;
+  gint fd;
+
+  FD_ZERO (&read_fds);
+  FD_ZERO (&write_fds);
+  FD_ZERO (&exc_fds);
+  if (curl_multi_fdset (sink->multi_handle, &read_fds, &write_fds, &exc_fds,
+          &max_fd) != CURLM_OK)
+    max_fd = -1;
+
+  /* sockets that were closed or are not waited on anymore */
+  g_hash_table_iter_init (&iter, sink->poll_fds);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    fd = GPOINTER_TO_INT (key);
+    if (fd > max_fd || (!FD_ISSET (fd, &read_fds)
+            && !FD_ISSET (fd, &write_fds))) {
+      gst_poll_remove_fd (sink->fdset, (GstPollFD *) value);
+      g_hash_table_iter_remove (&iter);
+    }
+  }
+
+  for (fd = 0; fd <= max_fd; fd++) {
+    GstPollFD *pfd;
+
+    if (!FD_ISSET (fd, &read_fds) && !FD_ISSET (fd, &write_fds))
+      continue;
+
+    pfd = g_hash_table_lookup (sink->poll_fds, GINT_TO_POINTER (fd));
+    if (pfd == NULL) {
+      pfd = g_new (GstPollFD, 1);
+      gst_poll_fd_init (pfd);
+      pfd->fd = fd;
+      gst_poll_add_fd (sink->fdset, pfd);
+      g_hash_table_insert (sink->poll_fds, GINT_TO_POINTER (fd), pfd);
+    }
+    gst_poll_fd_ctl_read (sink->fdset, pfd, FD_ISSET (fd, &read_fds));
+    gst_poll_fd_ctl_write (sink->fdset, pfd, FD_ISSET (fd, &write_fds));
+  }
+
+  return max_fd >= 0;
+}
+
 static void
 gst_curl_base_sink_transfer_cleanup (GstCurlBaseSink * sink)
 {
+  while (sink->finishing_transfers) {
+    finishing_transfer_free (sink, sink->finishing_transfers->data);
+    sink->finishing_transfers =
+        g_list_delete_link (sink->finishing_transfers,
+        sink->finishing_transfers);
+  }
+
   if (sink->curl != NULL) {
     if (sink->multi_handle != NULL) {
       curl_multi_remove_handle (sink->multi_handle, sink->curl);
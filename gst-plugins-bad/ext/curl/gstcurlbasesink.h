@@ -83,6 +83,12 @@ struct _GstCurlBaseSink
   gboolean transfer_thread_close;
   gboolean new_file;
   gboolean is_live;
+  gint max_parallel_uploads;
+  /* uploads whose data is sent and which only wait for the response */
+  GList *finishing_transfers;
+  gboolean upload_done;
+  /* fd -> GstPollFD of the sockets curl waits on, for pipelined uploads */
+  GHashTable *poll_fds;
 };
 
 struct _GstCurlBaseSinkClass
@@ -95,7 +101,8 @@ struct _GstCurlBaseSinkClass
   void (*set_mime_type) (GstCurlBaseSink * sink, GstCaps * caps);
   void (*transfer_prepare_poll_wait) (GstCurlBaseSink * sink);
     glong (*transfer_get_response_code) (GstCurlBaseSink * sink, glong resp);
-    gboolean (*transfer_verify_response_code) (GstCurlBaseSink * sink);
+    gboolean (*transfer_verify_response_code) (GstCurlBaseSink * sink,
+      CURL * curl);
     GstFlowReturn (*prepare_transfer) (GstCurlBaseSink * sink);
   void (*handle_transfer) (GstCurlBaseSink * sink);
     size_t (*transfer_read_cb) (void *curl_ptr, size_t size, size_t nmemb,
@@ -105,6 +112,8 @@ struct _GstCurlBaseSinkClass
     size_t (*flush_data_unlocked) (GstCurlBaseSink * sink, void *curl_ptr,
       size_t block_size, gboolean new_file, gboolean close_transfer);
     gboolean (*has_buffered_data_unlocked) (GstCurlBaseSink * sink);
+  struct curl_slist *(*steal_transfer_headers_unlocked) (GstCurlBaseSink *
+      sink);
 };
 
 GType gst_curl_base_sink_get_type (void);
@@ -104,6 +104,8 @@ static gboolean gst_curl_http_sink_set_options_unlocked
 static void gst_curl_http_sink_set_mime_type
     (GstCurlBaseSink * bcsink, GstCaps * caps);
 static gboolean gst_curl_http_sink_transfer_verify_response_code
+    (GstCurlBaseSink * bcsink, CURL * curl);
+static struct curl_slist *gst_curl_http_sink_steal_transfer_headers_unlocked
     (GstCurlBaseSink * bcsink);
 static void gst_curl_http_sink_transfer_prepare_poll_wait
     (GstCurlBaseSink * bcsink);
@@ -139,6 +141,8 @@ gst_curl_http_sink_class_init (GstCurlHttpSinkClass * klass)
   gstcurlbasesink_class->set_mime_type = gst_curl_http_sink_set_mime_type;
   gstcurlbasesink_class->transfer_verify_response_code =
       gst_curl_http_sink_transfer_verify_response_code;
+  gstcurlbasesink_class->steal_transfer_headers_unlocked =
+      gst_curl_http_sink_steal_transfer_headers_unlocked;
   gstcurlbasesink_class->transfer_prepare_poll_wait =
       gst_curl_http_sink_transfer_prepare_poll_wait;
 
@@ -409,12 +413,13 @@ gst_curl_http_sink_set_options_unlocked (GstCurlBaseSink * bcsink)
 }
 
 static gboolean
-gst_curl_http_sink_transfer_verify_response_code (GstCurlBaseSink * bcsink)
+gst_curl_http_sink_transfer_verify_response_code (GstCurlBaseSink * bcsink,
+    CURL * curl)
 {
   GstCurlHttpSink *sink = GST_CURL_HTTP_SINK (bcsink);
   glong resp;
 
-  curl_easy_getinfo (bcsink->curl, CURLINFO_RESPONSE_CODE, &resp);
+  curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, &resp);
   GST_DEBUG_OBJECT (sink, "response code: %ld", resp);
 
   if (resp < 100 || resp >= 300) {
@@ -426,6 +431,19 @@ gst_curl_http_sink_transfer_verify_response_code (GstCurlBaseSink * bcsink)
   return TRUE;
 }
 
+static struct curl_slist *
+gst_curl_http_sink_steal_transfer_headers_unlocked (GstCurlBaseSink * bcsink)
+{
+  GstCurlHttpSink *sink = GST_CURL_HTTP_SINK (bcsink);
+  struct curl_slist *headers;
+
+  /* the finishing transfer keeps them, new ones are set for the next file */
+  headers = sink->header_list;
+  sink->header_list = NULL;
+
+  return headers;
+}
+
 static void
 gst_curl_http_sink_transfer_prepare_poll_wait (GstCurlBaseSink * bcsink)
 {
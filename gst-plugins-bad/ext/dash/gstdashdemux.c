@@ -976,6 +976,45 @@ gst_dash_demux_get_input_caps (GstDashDemux * demux, GstActiveStream * stream)
   }
 }
 
+/* In key unit trick mode only the subsegments that start with a stream
+ * access point are downloaded, each with its own range request */
+static gboolean
+gst_dash_demux_is_key_unit_trick_mode (GstAdaptiveDemux * demux)
+{
+  return (demux->segment.flags & GST_SEGMENT_FLAG_TRICKMODE_KEY_UNITS) != 0;
+}
+
+static gboolean
+gst_dash_demux_sidx_entry_is_key_unit (GstSidxBoxEntry * entry)
+{
+  /* SAP types 1 to 3 can be decoded starting from the first sample, a
+   * type of 0 means the packager didn't tell */
+  return entry->starts_with_sap && entry->sap_type <= 3;
+}
+
+/* Moves the current sidx entry to the closest key unit subsegment in the
+ * playback direction, returns FALSE if there is none left */
+static gboolean
+gst_dash_demux_stream_sidx_find_key_unit (GstDashDemuxStream * dashstream,
+    gboolean forward)
+{
+  GstSidxBox *sidx = SIDX (dashstream);
+
+  while (sidx->entry_index >= 0 && sidx->entry_index < sidx->entries_count) {
+    if (gst_dash_demux_sidx_entry_is_key_unit (SIDX_CURRENT_ENTRY (dashstream)))
+      return TRUE;
+
+    GST_LOG ("Skipping subsegment %d, it doesn't start with a key unit",
+        sidx->entry_index);
+    if (forward)
+      sidx->entry_index++;
+    else
+      sidx->entry_index--;
+  }
+
+  return FALSE;
+}
+
 static void
 gst_dash_demux_stream_update_headers_info (GstAdaptiveDemuxStream * stream)
 {
@@ -1041,13 +1080,17 @@ gst_dash_demux_stream_update_fragment_info (GstAdaptiveDemuxStream * stream)
         &fragment);
 
     stream->fragment.uri = fragment.uri;
-    if (isombff && dashstream->sidx_index != 0) {
+    if (isombff && (dashstream->sidx_index != 0
+            || (gst_dash_demux_is_key_unit_trick_mode (stream->demux)
+                && dashstream->sidx_parser.status ==
+                GST_ISOFF_SIDX_PARSER_FINISHED))) {
       GstSidxBoxEntry *entry = SIDX_CURRENT_ENTRY (dashstream);
       stream->fragment.range_start =
           dashstream->sidx_base_offset + entry->offset;
       stream->fragment.timestamp = entry->pts;
       stream->fragment.duration = entry->duration;
-      if (stream->demux->segment.rate < 0.0) {
+      if (stream->demux->segment.rate < 0.0
+          || gst_dash_demux_is_key_unit_trick_mode (stream->demux)) {
         stream->fragment.range_end =
             stream->fragment.range_start + entry->size - 1;
       } else {
@@ -1121,6 +1164,18 @@ gst_dash_demux_stream_sidx_seek (GstDashDemuxStream * dashstream,
         idx += 1;
     }
 
+    sidx->entry_index = idx;
+    if (gst_dash_demux_is_key_unit_trick_mode (GST_ADAPTIVE_DEMUX_STREAM_CAST
+            (dashstream)->demux)) {
+      /* start from the key unit before @ts, or after it if there is none */
+      if (!gst_dash_demux_stream_sidx_find_key_unit (dashstream, !forward)) {
+        sidx->entry_index = idx;
+        if (!gst_dash_demux_stream_sidx_find_key_unit (dashstream, forward))
+          sidx->entry_index = idx;
+      }
+      idx = sidx->entry_index;
+    }
+
     dashstream->sidx_current_remaining = sidx->entries[idx].size;
   }
 
@@ -1196,6 +1251,13 @@ gst_dash_demux_stream_advance_subfragment (GstAdaptiveDemuxStream * stream)
         fragment_finished = FALSE;
       }
     }
+
+    if (!fragment_finished
+        && gst_dash_demux_is_key_unit_trick_mode (stream->demux)) {
+      fragment_finished =
+          !gst_dash_demux_stream_sidx_find_key_unit (dashstream,
+          stream->demux->segment.rate > 0.0);
+    }
   }
 
   GST_DEBUG_OBJECT (stream->pad, "New sidx index: %d / %d. "
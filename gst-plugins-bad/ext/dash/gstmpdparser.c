@@ -3810,6 +3810,28 @@ gst_mpdparser_get_segment_end_time (GstMpdClient * client, GPtrArray * segments,
   return end;
 }
 
+/* Segments are kept in (start, duration, repeat) runs ordered by start
+ * time, so the start times act as an index and @ts can be looked up with
+ * a binary search. Returns the index of the last segment starting at or
+ * before @ts, or -1 if @ts is before the first one. */
+static gint
+gst_mpdparser_find_segment_index (GPtrArray * segments, GstClockTime ts)
+{
+  guint lo = 0, hi = segments->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+    const GstMediaSegment *segment = g_ptr_array_index (segments, mid);
+
+    if (segment->start <= ts)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return (gint) lo - 1;
+}
+
 static gboolean
 gst_mpd_client_add_media_segment (GstActiveStream * stream,
     GstSegmentURLNode * url_node, guint number, gint repeat,
@@ -4706,7 +4728,13 @@ gst_mpd_client_stream_seek (GstMpdClient * client, GstActiveStream * stream,
   g_return_val_if_fail (stream != NULL, 0);
 
   if (stream->segments) {
-    for (index = 0; index < stream->segments->len; index++) {
+    gint last;
+
+    /* Only the last segment starting before @ts can contain it, or in
+     * reverse mode also the one before if @ts is right at its end */
+    last = gst_mpdparser_find_segment_index (stream->segments, ts);
+    index = (!forward && last > 0) ? last - 1 : MAX (last, 0);
+    for (; index <= last; index++) {
       GstMediaSegment *segment = g_ptr_array_index (stream->segments, index);
 
       GST_DEBUG ("Looking at fragment sequence chunk %d / %d", index,
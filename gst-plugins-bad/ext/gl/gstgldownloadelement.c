@@ -18,6 +18,20 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/**
+ * SECTION:element-gldownload
+ *
+ * gldownload makes OpenGL textures available in system memory.
+ *
+ * By default the texture data of a frame is read back when the frame is
+ * mapped downstream, which stalls until the GPU has finished rendering and
+ * transferring it. With #GstGLDownloadElement:pipeline-depth set, the
+ * transfer of each frame into its pixel buffer object is started when the
+ * frame arrives and a fence is placed after it. The frame is only pushed
+ * downstream once that many newer frames have been submitted, by which time
+ * its transfer is normally complete and mapping it does not block.
+ */
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -28,12 +42,25 @@
 GST_DEBUG_CATEGORY_STATIC (gst_gl_download_element_debug);
 #define GST_CAT_DEFAULT gst_gl_download_element_debug
 
+#define DEFAULT_PIPELINE_DEPTH 0
+
+enum
+{
+  PROP_0,
+  PROP_PIPELINE_DEPTH
+};
+
 #define gst_gl_download_element_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstGLDownloadElement, gst_gl_download_element,
     GST_TYPE_GL_BASE_FILTER,
     GST_DEBUG_CATEGORY_INIT (gst_gl_download_element_debug, "gldownloadelement",
         0, "download element"););
 
+static void gst_gl_download_element_finalize (GObject * object);
+static void gst_gl_download_element_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_gl_download_element_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
 static gboolean gst_gl_download_element_get_unit_size (GstBaseTransform * trans,
     GstCaps * caps, gsize * size);
 static GstCaps *gst_gl_download_element_transform_caps (GstBaseTransform * bt,
@@ -45,6 +72,14 @@ gst_gl_download_element_prepare_output_buffer (GstBaseTransform * bt,
     GstBuffer * buffer, GstBuffer ** outbuf);
 static GstFlowReturn gst_gl_download_element_transform (GstBaseTransform * bt,
     GstBuffer * buffer, GstBuffer * outbuf);
+static GstFlowReturn
+gst_gl_download_element_generate_output (GstBaseTransform * bt,
+    GstBuffer ** outbuf);
+static gboolean gst_gl_download_element_sink_event (GstBaseTransform * bt,
+    GstEvent * event);
+static gboolean gst_gl_download_element_query (GstBaseTransform * bt,
+    GstPadDirection direction, GstQuery * query);
+static gboolean gst_gl_download_element_stop (GstBaseTransform * bt);
 
 static GstStaticPadTemplate gst_gl_download_element_src_pad_template =
     GST_STATIC_PAD_TEMPLATE ("src",
@@ -61,15 +96,39 @@ static GstStaticPadTemplate gst_gl_download_element_sink_pad_template =
 static void
 gst_gl_download_element_class_init (GstGLDownloadElementClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   GstBaseTransformClass *bt_class = GST_BASE_TRANSFORM_CLASS (klass);
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
 
+  gobject_class->finalize = gst_gl_download_element_finalize;
+  gobject_class->set_property = gst_gl_download_element_set_property;
+  gobject_class->get_property = gst_gl_download_element_get_property;
+
+  /**
+   * GstGLDownloadElement:pipeline-depth:
+   *
+   * The number of frames whose download to system memory is started before
+   * the oldest of them is pushed downstream. 0 downloads each frame when it
+   * is mapped downstream. Every frame adds one frame duration of latency.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PIPELINE_DEPTH,
+      g_param_spec_uint ("pipeline-depth", "Pipeline depth",
+          "Number of frames to keep downloading while pushing older ones "
+          "(0 = download when mapped)", 0, 16, DEFAULT_PIPELINE_DEPTH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   bt_class->transform_caps = gst_gl_download_element_transform_caps;
   bt_class->set_caps = gst_gl_download_element_set_caps;
   bt_class->get_unit_size = gst_gl_download_element_get_unit_size;
   bt_class->prepare_output_buffer =
       gst_gl_download_element_prepare_output_buffer;
   bt_class->transform = gst_gl_download_element_transform;
+  bt_class->generate_output = gst_gl_download_element_generate_output;
+  bt_class->sink_event = gst_gl_download_element_sink_event;
+  bt_class->query = gst_gl_download_element_query;
+  bt_class->stop = gst_gl_download_element_stop;
 
   bt_class->passthrough_on_same_caps = TRUE;
 
@@ -88,17 +147,102 @@ gst_gl_download_element_init (GstGLDownloadElement * download)
 {
   gst_base_transform_set_prefer_passthrough (GST_BASE_TRANSFORM (download),
       TRUE);
+
+  download->pipeline_depth = DEFAULT_PIPELINE_DEPTH;
+  g_queue_init (&download->pending);
+}
+
+static void
+gst_gl_download_element_finalize (GObject * object)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (object);
+
+  g_queue_foreach (&download->pending, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&download->pending);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_gl_download_element_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_PIPELINE_DEPTH:
+      GST_OBJECT_LOCK (download);
+      download->pipeline_depth = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (download);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_gl_download_element_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_PIPELINE_DEPTH:
+      GST_OBJECT_LOCK (download);
+      g_value_set_uint (value, download->pipeline_depth);
+      GST_OBJECT_UNLOCK (download);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* push all frames that are still being downloaded */
+static GstFlowReturn
+_drain_pending (GstGLDownloadElement * download)
+{
+  GstBaseTransform *bt = GST_BASE_TRANSFORM (download);
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buffer;
+
+  while ((buffer = g_queue_pop_head (&download->pending))) {
+    GstGLSyncMeta *sync_meta = gst_buffer_get_gl_sync_meta (buffer);
+
+    if (sync_meta)
+      gst_gl_sync_meta_wait_cpu (sync_meta, sync_meta->context);
+
+    if (ret == GST_FLOW_OK)
+      ret = gst_pad_push (bt->srcpad, buffer);
+    else
+      gst_buffer_unref (buffer);
+  }
+
+  return ret;
+}
+
+static void
+_flush_pending (GstGLDownloadElement * download)
+{
+  g_queue_foreach (&download->pending, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&download->pending);
 }
 
 static gboolean
 gst_gl_download_element_set_caps (GstBaseTransform * bt, GstCaps * in_caps,
     GstCaps * out_caps)
 {
-  GstVideoInfo out_info;
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (bt);
+  GstCapsFeatures *features;
 
-  if (!gst_video_info_from_caps (&out_info, out_caps))
+  if (!gst_video_info_from_caps (&download->out_info, out_caps))
     return FALSE;
 
+  features = gst_caps_get_features (out_caps, 0);
+  download->do_transfers = (!features || gst_caps_features_contains (features,
+          GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY));
+
   return TRUE;
 }
 
@@ -194,3 +338,137 @@ gst_gl_download_element_transform (GstBaseTransform * bt,
 {
   return GST_FLOW_OK;
 }
+
+static GstGLContext *
+_find_gl_context (GstBuffer * buffer)
+{
+  guint i, n;
+
+  n = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
+
+    if (gst_is_gl_memory_pbo (mem))
+      return ((GstGLBaseMemory *) mem)->context;
+  }
+
+  return NULL;
+}
+
+static GstFlowReturn
+gst_gl_download_element_generate_output (GstBaseTransform * bt,
+    GstBuffer ** outbuf)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (bt);
+  GstGLContext *context;
+  GstGLSyncMeta *sync_meta;
+  GstFlowReturn ret;
+  guint depth;
+
+  /* starts the PBO transfer of the input in prepare_output_buffer() */
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (bt, outbuf);
+
+  GST_OBJECT_LOCK (download);
+  depth = download->pipeline_depth;
+  GST_OBJECT_UNLOCK (download);
+
+  if (depth == 0 || !download->do_transfers) {
+    /* keep the order with frames queued before the depth changed */
+    if (ret == GST_FLOW_OK && !g_queue_is_empty (&download->pending))
+      ret = _drain_pending (download);
+    return ret;
+  }
+
+  if (ret != GST_FLOW_OK || *outbuf == NULL)
+    return ret;
+
+  /* place a fence after the transfer so we know when it finished */
+  if ((context = _find_gl_context (*outbuf))) {
+    if (!(sync_meta = gst_buffer_get_gl_sync_meta (*outbuf))) {
+      *outbuf = gst_buffer_make_writable (*outbuf);
+      sync_meta = gst_buffer_add_gl_sync_meta (context, *outbuf);
+    }
+    gst_gl_sync_meta_set_sync_point (sync_meta, context);
+  }
+
+  g_queue_push_tail (&download->pending, *outbuf);
+  *outbuf = NULL;
+
+  if (g_queue_get_length (&download->pending) <= depth)
+    return GST_FLOW_OK;
+
+  /* the oldest frame had @depth frames of time to finish its transfer */
+  *outbuf = g_queue_pop_head (&download->pending);
+  if ((sync_meta = gst_buffer_get_gl_sync_meta (*outbuf)))
+    gst_gl_sync_meta_wait_cpu (sync_meta, sync_meta->context);
+
+  GST_LOG_OBJECT (download, "pushing %" GST_PTR_FORMAT ", %u pending",
+      *outbuf, g_queue_get_length (&download->pending));
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+gst_gl_download_element_sink_event (GstBaseTransform * bt, GstEvent * event)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (bt);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_STOP:
+      _flush_pending (download);
+      break;
+    default:
+      /* frames go out before anything that is serialized after them */
+      if (GST_EVENT_IS_SERIALIZED (event))
+        _drain_pending (download);
+      break;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
+}
+
+static gboolean
+gst_gl_download_element_query (GstBaseTransform * bt,
+    GstPadDirection direction, GstQuery * query)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (bt);
+  gboolean res;
+
+  if (direction == GST_PAD_SINK && GST_QUERY_IS_SERIALIZED (query))
+    _drain_pending (download);
+
+  res = GST_BASE_TRANSFORM_CLASS (parent_class)->query (bt, direction, query);
+
+  if (res && direction == GST_PAD_SRC
+      && GST_QUERY_TYPE (query) == GST_QUERY_LATENCY) {
+    GstClockTime min, max, extra = 0;
+    gboolean live;
+    guint depth;
+
+    GST_OBJECT_LOCK (download);
+    depth = download->pipeline_depth;
+    GST_OBJECT_UNLOCK (download);
+
+    if (depth > 0 && download->out_info.fps_n > 0)
+      extra = gst_util_uint64_scale_int (depth * GST_SECOND,
+          download->out_info.fps_d, download->out_info.fps_n);
+
+    gst_query_parse_latency (query, &live, &min, &max);
+    min += extra;
+    if (GST_CLOCK_TIME_IS_VALID (max))
+      max += extra;
+    gst_query_set_latency (query, live, min, max);
+  }
+
+  return res;
+}
+
+static gboolean
+gst_gl_download_element_stop (GstBaseTransform * bt)
+{
+  GstGLDownloadElement *download = GST_GL_DOWNLOAD_ELEMENT (bt);
+
+  _flush_pending (download);
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->stop (bt);
+}
@@ -43,6 +43,11 @@ struct _GstGLDownloadElement
 {
   /* <private> */
   GstGLBaseFilter  parent;
+
+  guint            pipeline_depth;
+  gboolean         do_transfers;
+  GQueue           pending;
+  GstVideoInfo     out_info;
 };
 
 struct _GstGLDownloadElementClass
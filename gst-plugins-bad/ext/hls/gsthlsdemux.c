@@ -99,6 +99,8 @@ static GstFlowReturn gst_hls_demux_advance_fragment (GstAdaptiveDemuxStream *
     stream);
 static GstFlowReturn gst_hls_demux_update_fragment_info (GstAdaptiveDemuxStream
     * stream);
+static gboolean gst_hls_demux_peek_fragment (GstAdaptiveDemuxStream * stream,
+    guint n, gchar ** uri, gint64 * range_start, gint64 * range_end);
 static gboolean gst_hls_demux_select_bitrate (GstAdaptiveDemuxStream * stream,
     guint64 bitrate);
 static void gst_hls_demux_reset (GstAdaptiveDemux * demux);
@@ -158,6 +160,7 @@ gst_hls_demux_class_init (GstHLSDemuxClass * klass)
   adaptivedemux_class->stream_advance_fragment = gst_hls_demux_advance_fragment;
   adaptivedemux_class->stream_update_fragment_info =
       gst_hls_demux_update_fragment_info;
+  adaptivedemux_class->stream_peek_fragment = gst_hls_demux_peek_fragment;
   adaptivedemux_class->stream_select_bitrate = gst_hls_demux_select_bitrate;
 
   adaptivedemux_class->start_fragment = gst_hls_demux_start_fragment;
@@ -730,6 +733,16 @@ gst_hls_demux_update_fragment_info (GstAdaptiveDemuxStream * stream)
   return GST_FLOW_OK;
 }
 
+static gboolean
+gst_hls_demux_peek_fragment (GstAdaptiveDemuxStream * stream, guint n,
+    gchar ** uri, gint64 * range_start, gint64 * range_end)
+{
+  GstHLSDemux *hlsdemux = GST_HLS_DEMUX_CAST (stream->demux);
+
+  return gst_m3u8_client_peek_fragment (hlsdemux->client, n, uri, range_start,
+      range_end, stream->demux->segment.rate > 0);
+}
+
 static gboolean
 gst_hls_demux_select_bitrate (GstAdaptiveDemuxStream * stream, guint64 bitrate)
 {
@@ -1193,8 +1206,11 @@ decrypt_fragment (GstHLSDemux * demux, gsize length,
 {
   gcry_error_t err = 0;
 
-  err = gcry_cipher_decrypt (demux->aes_ctx, decrypted_data, length,
-      encrypted_data, length);
+  if (encrypted_data == decrypted_data)
+    err = gcry_cipher_decrypt (demux->aes_ctx, decrypted_data, length, NULL, 0);
+  else
+    err = gcry_cipher_decrypt (demux->aes_ctx, decrypted_data, length,
+        encrypted_data, length);
 
   return err == 0;
 }
@@ -1216,6 +1232,25 @@ gst_hls_demux_decrypt_fragment (GstHLSDemux * demux,
   GstBuffer *decrypted_buffer = NULL;
   GstMapInfo encrypted_info, decrypted_info;
 
+  /* The buffers taken from the adapter are usually not shared with anyone,
+   * decrypt those in place instead of copying all the data around. All
+   * backends support CBC decryption with the same input and output. */
+  if (gst_buffer_is_writable (encrypted_buffer)
+      && gst_buffer_map (encrypted_buffer, &encrypted_info,
+          GST_MAP_READWRITE)) {
+    if (!decrypt_fragment (demux, encrypted_info.size,
+            encrypted_info.data, encrypted_info.data)) {
+      gst_buffer_unmap (encrypted_buffer, &encrypted_info);
+      gst_buffer_unref (encrypted_buffer);
+      GST_ERROR_OBJECT (demux, "Failed to decrypt fragment");
+      g_set_error (err, GST_STREAM_ERROR, GST_STREAM_ERROR_DECRYPT,
+          "Failed to decrypt fragment");
+      return NULL;
+    }
+    gst_buffer_unmap (encrypted_buffer, &encrypted_info);
+    return encrypted_buffer;
+  }
+
   decrypted_buffer =
       gst_buffer_new_allocate (NULL, gst_buffer_get_size (encrypted_buffer),
       NULL);
@@ -28,6 +28,17 @@
  * gst-launch-1.0 videotestsrc is-live=true ! x264enc ! mpegtsmux ! hlssink max-files=5
  * ]|
  * </refsect2>
+ *
+ * Setting #GstHlsSink:part-duration enables low-latency HLS: each segment is
+ * also split into partial segments, which are listed in the playlist as
+ * EXT-X-PART entries as soon as they are complete, together with a preload
+ * hint for the next one. Segments, parts and the playlist are kept in memory
+ * and can be served from there with the #GstHlsSink::get-playlist and
+ * #GstHlsSink::get-fragment action signals, while
+ * #GstHlsSink::playlist-updated allows holding back blocking playlist reloads
+ * until the requested part is available. With
+ * #GstHlsSink:persist-segments they are written to disk as well, segments
+ * growing part by part.
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -38,6 +49,7 @@
 #include <gst/video/video.h>
 #include <glib/gstdio.h>
 #include <memory.h>
+#include <string.h>
 
 
 GST_DEBUG_CATEGORY_STATIC (gst_hls_sink_debug);
@@ -49,8 +61,12 @@ GST_DEBUG_CATEGORY_STATIC (gst_hls_sink_debug);
 #define DEFAULT_MAX_FILES 10
 #define DEFAULT_TARGET_DURATION 15
 #define DEFAULT_PLAYLIST_LENGTH 5
+#define DEFAULT_PART_DURATION 0
+#define DEFAULT_PERSIST_SEGMENTS TRUE
 
 #define GST_M3U8_PLAYLIST_VERSION 3
+/* EXT-X-PART and the related tags need a newer playlist version */
+#define GST_M3U8_PLAYLIST_LL_VERSION 6
 
 enum
 {
@@ -60,9 +76,38 @@ enum
   PROP_PLAYLIST_ROOT,
   PROP_MAX_FILES,
   PROP_TARGET_DURATION,
-  PROP_PLAYLIST_LENGTH
+  PROP_PLAYLIST_LENGTH,
+  PROP_PART_DURATION,
+  PROP_PERSIST_SEGMENTS
+};
+
+enum
+{
+  SIGNAL_GET_PLAYLIST,
+  SIGNAL_GET_FRAGMENT,
+  SIGNAL_PLAYLIST_UPDATED,
+  SIGNAL_LAST
 };
 
+static guint signals[SIGNAL_LAST];
+
+/* In-memory store for low-latency mode. A segment consists of its parts,
+ * the complete segment is only handed out once it is closed */
+typedef struct
+{
+  gchar *name;
+  GstBuffer *data;
+} GstHlsSinkPart;
+
+typedef struct
+{
+  gchar *name;
+  gchar *path;
+  guint index;
+  GPtrArray *parts;
+  gboolean complete;
+} GstHlsSinkSegment;
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -86,6 +131,26 @@ gst_hls_sink_change_state (GstElement * element, GstStateChange trans);
 static gboolean schedule_next_key_unit (GstHlsSink * sink);
 static GstFlowReturn gst_hls_sink_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * list);
+static gchar *gst_hls_sink_get_playlist (GstHlsSink * sink);
+static GstBuffer *gst_hls_sink_get_fragment (GstHlsSink * sink,
+    const gchar * name);
+
+static void
+gst_hls_sink_part_free (GstHlsSinkPart * part)
+{
+  g_free (part->name);
+  gst_buffer_unref (part->data);
+  g_free (part);
+}
+
+static void
+gst_hls_sink_segment_free (GstHlsSinkSegment * segment)
+{
+  g_free (segment->name);
+  g_free (segment->path);
+  g_ptr_array_unref (segment->parts);
+  g_free (segment);
+}
 
 static void
 gst_hls_sink_dispose (GObject * object)
@@ -106,6 +171,16 @@ gst_hls_sink_finalize (GObject * object)
   if (sink->playlist)
     gst_m3u8_playlist_free (sink->playlist);
 
+  if (sink->segment_file)
+    fclose (sink->segment_file);
+  g_object_unref (sink->part_adapter);
+  g_queue_foreach (&sink->persisted_files, (GFunc) g_free, NULL);
+  g_queue_clear (&sink->persisted_files);
+  g_queue_foreach (&sink->segments, (GFunc) gst_hls_sink_segment_free, NULL);
+  g_queue_clear (&sink->segments);
+  g_free (sink->playlist_content);
+  g_mutex_clear (&sink->store_lock);
+
   G_OBJECT_CLASS (parent_class)->finalize ((GObject *) sink);
 }
 
@@ -167,6 +242,85 @@ gst_hls_sink_class_init (GstHlsSinkClass * klass)
           "the playlist will be infinite.",
           0, G_MAXUINT, DEFAULT_PLAYLIST_LENGTH,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstHlsSink:part-duration:
+   *
+   * Target duration of the partial segments of a low-latency playlist, in
+   * milliseconds. Only takes effect when the sink goes out of NULL state.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PART_DURATION,
+      g_param_spec_uint ("part-duration", "Part duration",
+          "The target duration in milliseconds of the partial segments of a "
+          "low-latency playlist (0 - disabled)",
+          0, G_MAXUINT, DEFAULT_PART_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstHlsSink:persist-segments:
+   *
+   * In low-latency mode, whether segments and playlist are also written to
+   * disk. Otherwise they can only be retrieved with the action signals.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PERSIST_SEGMENTS,
+      g_param_spec_boolean ("persist-segments", "Persist segments",
+          "Write segments and playlist to disk in low-latency mode",
+          DEFAULT_PERSIST_SEGMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstHlsSink::get-playlist:
+   * @sink: the #GstHlsSink
+   *
+   * Returns the current low-latency playlist.
+   *
+   * Returns: (transfer full): the playlist, or %NULL if none was written yet
+   *
+   * Since: 1.10
+   */
+  signals[SIGNAL_GET_PLAYLIST] =
+      g_signal_new ("get-playlist", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHlsSinkClass, get_playlist), NULL, NULL,
+      g_cclosure_marshal_generic, G_TYPE_STRING, 0);
+  /**
+   * GstHlsSink::get-fragment:
+   * @sink: the #GstHlsSink
+   * @name: the name of a segment or part, as listed in the playlist
+   *
+   * Returns the data of a complete segment or a partial segment from the
+   * in-memory store of low-latency mode.
+   *
+   * Returns: (transfer full): the data, or %NULL if @name is not available
+   *
+   * Since: 1.10
+   */
+  signals[SIGNAL_GET_FRAGMENT] =
+      g_signal_new ("get-fragment", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHlsSinkClass, get_fragment), NULL, NULL,
+      g_cclosure_marshal_generic, GST_TYPE_BUFFER, 1, G_TYPE_STRING);
+  /**
+   * GstHlsSink::playlist-updated:
+   * @sink: the #GstHlsSink
+   * @msn: media sequence number of the last segment in the playlist
+   * @part: index of the last part of that segment
+   *
+   * Emitted from the streaming thread whenever the low-latency playlist
+   * changed, so that blocked playlist reloads waiting for @msn and @part
+   * can be answered.
+   *
+   * Since: 1.10
+   */
+  signals[SIGNAL_PLAYLIST_UPDATED] =
+      g_signal_new ("playlist-updated", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_UINT);
+
+  klass->get_playlist = gst_hls_sink_get_playlist;
+  klass->get_fragment = gst_hls_sink_get_fragment;
 }
 
 static void
@@ -188,6 +342,13 @@ gst_hls_sink_init (GstHlsSink * sink)
   sink->playlist_length = DEFAULT_PLAYLIST_LENGTH;
   sink->max_files = DEFAULT_MAX_FILES;
   sink->target_duration = DEFAULT_TARGET_DURATION;
+  sink->part_duration = DEFAULT_PART_DURATION;
+  sink->persist_segments = DEFAULT_PERSIST_SEGMENTS;
+
+  sink->part_adapter = gst_adapter_new ();
+  g_queue_init (&sink->persisted_files);
+  g_queue_init (&sink->segments);
+  g_mutex_init (&sink->store_lock);
 
   /* haven't added a sink yet, make it is detected as a sink meanwhile */
   GST_OBJECT_FLAG_SET (sink, GST_ELEMENT_FLAG_SINK);
@@ -206,11 +367,37 @@ gst_hls_sink_reset (GstHlsSink * sink)
   gst_event_replace (&sink->force_key_unit_event, NULL);
   gst_segment_init (&sink->segment, GST_FORMAT_UNDEFINED);
 
+  gst_adapter_clear (sink->part_adapter);
+  sink->part_start = GST_CLOCK_TIME_NONE;
+  sink->part_independent = FALSE;
+  sink->last_buffer_time = GST_CLOCK_TIME_NONE;
+  sink->segment_index = 0;
+  if (sink->segment_file) {
+    fclose (sink->segment_file);
+    sink->segment_file = NULL;
+  }
+  g_queue_foreach (&sink->persisted_files, (GFunc) g_free, NULL);
+  g_queue_clear (&sink->persisted_files);
+
+  g_mutex_lock (&sink->store_lock);
+  g_queue_foreach (&sink->segments, (GFunc) gst_hls_sink_segment_free, NULL);
+  g_queue_clear (&sink->segments);
+  g_free (sink->playlist_content);
+  sink->playlist_content = NULL;
+
   if (sink->playlist)
     gst_m3u8_playlist_free (sink->playlist);
-  sink->playlist =
-      gst_m3u8_playlist_new (GST_M3U8_PLAYLIST_VERSION, sink->playlist_length,
-      FALSE);
+  if (sink->part_duration > 0) {
+    sink->playlist =
+        gst_m3u8_playlist_new (GST_M3U8_PLAYLIST_LL_VERSION,
+        sink->playlist_length, FALSE);
+    sink->playlist->part_target = sink->part_duration * GST_MSECOND;
+  } else {
+    sink->playlist =
+        gst_m3u8_playlist_new (GST_M3U8_PLAYLIST_VERSION,
+        sink->playlist_length, FALSE);
+  }
+  g_mutex_unlock (&sink->store_lock);
 }
 
 static gboolean
@@ -223,17 +410,30 @@ gst_hls_sink_create_elements (GstHlsSink * sink)
   if (sink->elements_created)
     return TRUE;
 
-  sink->multifilesink = gst_element_factory_make ("multifilesink", NULL);
-  if (sink->multifilesink == NULL)
-    goto missing_element;
+  if (sink->part_duration > 0) {
+    /* In low-latency mode the segments are stored and written from the
+     * ghost pad probes, the data only needs to end somewhere */
+    sink->fakesink = gst_element_factory_make ("fakesink", NULL);
+    if (sink->fakesink == NULL)
+      goto missing_fakesink;
+
+    g_object_set (sink->fakesink, "sync", FALSE, NULL);
+
+    gst_bin_add (GST_BIN_CAST (sink), sink->fakesink);
+    pad = gst_element_get_static_pad (sink->fakesink, "sink");
+  } else {
+    sink->multifilesink = gst_element_factory_make ("multifilesink", NULL);
+    if (sink->multifilesink == NULL)
+      goto missing_element;
 
-  g_object_set (sink->multifilesink, "location", sink->location,
-      "next-file", 3, "post-messages", TRUE, "max-files", sink->max_files,
-      NULL);
+    g_object_set (sink->multifilesink, "location", sink->location,
+        "next-file", 3, "post-messages", TRUE, "max-files", sink->max_files,
+        NULL);
 
-  gst_bin_add (GST_BIN_CAST (sink), sink->multifilesink);
+    gst_bin_add (GST_BIN_CAST (sink), sink->multifilesink);
+    pad = gst_element_get_static_pad (sink->multifilesink, "sink");
+  }
 
-  pad = gst_element_get_static_pad (sink->multifilesink, "sink");
   gst_ghost_pad_set_target (GST_GHOST_PAD (sink->ghostpad), pad);
   gst_object_unref (pad);
 
@@ -248,15 +448,21 @@ missing_element:
       (("Missing element '%s' - check your GStreamer installation."),
           "multifilesink"), (NULL));
   return FALSE;
+
+missing_fakesink:
+  gst_element_post_message (GST_ELEMENT_CAST (sink),
+      gst_missing_element_message_new (GST_ELEMENT_CAST (sink), "fakesink"));
+  GST_ELEMENT_ERROR (sink, CORE, MISSING_PLUGIN,
+      (("Missing element '%s' - check your GStreamer installation."),
+          "fakesink"), (NULL));
+  return FALSE;
 }
 
 static void
-gst_hls_sink_write_playlist (GstHlsSink * sink)
+gst_hls_sink_save_playlist (GstHlsSink * sink, const gchar * playlist_content)
 {
-  char *playlist_content;
   GError *error = NULL;
 
-  playlist_content = gst_m3u8_playlist_render (sink->playlist);
   if (!g_file_set_contents (sink->playlist_location,
           playlist_content, -1, &error)) {
     GST_ERROR ("Failed to write playlist: %s", error->message);
@@ -265,8 +471,338 @@ gst_hls_sink_write_playlist (GstHlsSink * sink)
     g_error_free (error);
     error = NULL;
   }
+}
+
+static void
+gst_hls_sink_write_playlist (GstHlsSink * sink)
+{
+  char *playlist_content;
+
+  playlist_content = gst_m3u8_playlist_render (sink->playlist);
+  gst_hls_sink_save_playlist (sink, playlist_content);
   g_free (playlist_content);
+}
+
+static gchar *
+gst_hls_sink_entry_location (GstHlsSink * sink, const gchar * filename)
+{
+  gchar *name, *entry_location;
+
+  name = g_path_get_basename (filename);
+  if (sink->playlist_root == NULL)
+    return name;
+
+  entry_location = g_build_filename (sink->playlist_root, name, NULL);
+  g_free (name);
+
+  return entry_location;
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#endif
+static gchar *
+gst_hls_sink_segment_path (GstHlsSink * sink, guint index)
+{
+  return g_strdup_printf (sink->location, index);
+}
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+static gchar *
+gst_hls_sink_part_name (GstHlsSink * sink, guint index, guint part_index)
+{
+  gchar *path, *name, *part_name;
+
+  path = gst_hls_sink_segment_path (sink, index);
+  name = g_path_get_basename (path);
+  part_name = g_strdup_printf ("%s.%u.part", name, part_index);
+  g_free (name);
+  g_free (path);
+
+  return part_name;
+}
+
+/* Renders the low-latency playlist after it was changed, writes it out if
+ * needed and notifies about the new part */
+static void
+gst_hls_sink_publish_playlist (GstHlsSink * sink, guint msn, guint part)
+{
+  gchar *playlist_content = NULL;
+
+  g_mutex_lock (&sink->store_lock);
+  g_free (sink->playlist_content);
+  sink->playlist_content = gst_m3u8_playlist_render (sink->playlist);
+  if (sink->persist_segments)
+    playlist_content = g_strdup (sink->playlist_content);
+  g_mutex_unlock (&sink->store_lock);
+
+  if (playlist_content) {
+    gst_hls_sink_save_playlist (sink, playlist_content);
+    g_free (playlist_content);
+  }
+
+  g_signal_emit (sink, signals[SIGNAL_PLAYLIST_UPDATED], 0, msn, part);
+}
+
+static gboolean
+gst_hls_sink_persist_part (GstHlsSink * sink, GstHlsSinkSegment * segment,
+    GstHlsSinkPart * part)
+{
+  GstMapInfo map;
+  gboolean ret;
+
+  if (sink->segment_file == NULL) {
+    sink->segment_file = g_fopen (segment->path, "wb");
+    if (sink->segment_file == NULL)
+      goto open_failed;
 
+    g_queue_push_tail (&sink->persisted_files, g_strdup (segment->path));
+    while (sink->max_files > 0 &&
+        sink->persisted_files.length > sink->max_files) {
+      gchar *old_file = g_queue_pop_head (&sink->persisted_files);
+
+      g_remove (old_file);
+      g_free (old_file);
+    }
+  }
+
+  /* Segments on disk grow by one part at a time */
+  gst_buffer_map (part->data, &map, GST_MAP_READ);
+  ret = fwrite (map.data, map.size, 1, sink->segment_file) == 1 &&
+      fflush (sink->segment_file) == 0;
+  gst_buffer_unmap (part->data, &map);
+
+  if (!ret)
+    goto write_failed;
+
+  return TRUE;
+
+  /* ERRORS */
+open_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, OPEN_WRITE,
+        (("Failed to open segment '%s'."), segment->path), GST_ERROR_SYSTEM);
+    return FALSE;
+  }
+write_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+        (("Failed to write segment '%s'."), segment->path), GST_ERROR_SYSTEM);
+    return FALSE;
+  }
+}
+
+/* Called from the streaming thread in low-latency mode to turn the data
+ * collected since the last cut into a new part ending at @end_time */
+static void
+gst_hls_sink_close_part (GstHlsSink * sink, GstClockTime end_time)
+{
+  GstHlsSinkSegment *segment;
+  GstHlsSinkPart *part;
+  GstClockTime duration = 0;
+  gchar *location, *next_name;
+  gsize avail;
+  guint part_index;
+
+  avail = gst_adapter_available (sink->part_adapter);
+  if (avail == 0)
+    return;
+
+  if (GST_CLOCK_TIME_IS_VALID (sink->part_start) && end_time > sink->part_start)
+    duration = end_time - sink->part_start;
+
+  part = g_new0 (GstHlsSinkPart, 1);
+  part->data = gst_adapter_take_buffer (sink->part_adapter, avail);
+
+  g_mutex_lock (&sink->store_lock);
+  segment = g_queue_peek_tail (&sink->segments);
+  if (segment == NULL || segment->complete) {
+    segment = g_new0 (GstHlsSinkSegment, 1);
+    segment->index = sink->segment_index;
+    segment->path = gst_hls_sink_segment_path (sink, segment->index);
+    segment->name = g_path_get_basename (segment->path);
+    segment->parts =
+        g_ptr_array_new_with_free_func ((GDestroyNotify)
+        gst_hls_sink_part_free);
+    g_queue_push_tail (&sink->segments, segment);
+  }
+
+  part_index = segment->parts->len;
+  part->name = gst_hls_sink_part_name (sink, segment->index, part_index);
+  g_ptr_array_add (segment->parts, part);
+
+  location = gst_hls_sink_entry_location (sink, part->name);
+  gst_m3u8_playlist_add_part (sink->playlist, location, duration,
+      sink->part_independent);
+  g_free (location);
+
+  next_name = gst_hls_sink_part_name (sink, segment->index, part_index + 1);
+  location = gst_hls_sink_entry_location (sink, next_name);
+  gst_m3u8_playlist_set_preload_hint (sink->playlist, location);
+  g_free (location);
+  g_free (next_name);
+  g_mutex_unlock (&sink->store_lock);
+
+  GST_DEBUG_OBJECT (sink, "Closed part %s of %" G_GSIZE_FORMAT " bytes, "
+      "duration %" GST_TIME_FORMAT, part->name, avail,
+      GST_TIME_ARGS (duration));
+
+  /* The segment and part stay around as only this thread removes them */
+  if (sink->persist_segments)
+    gst_hls_sink_persist_part (sink, segment, part);
+
+  sink->part_start = end_time;
+
+  gst_hls_sink_publish_playlist (sink, segment->index, part_index);
+}
+
+/* Called from the streaming thread in low-latency mode when upstream starts a
+ * new key unit. Returns FALSE if there was no segment to close */
+static gboolean
+gst_hls_sink_close_segment (GstHlsSink * sink, GstClockTime running_time)
+{
+  GstHlsSinkSegment *segment;
+  gchar *location, *next_name;
+  GstClockTime duration = 0;
+  guint msn, part_index;
+
+  gst_hls_sink_close_part (sink, running_time);
+
+  g_mutex_lock (&sink->store_lock);
+  segment = g_queue_peek_tail (&sink->segments);
+  if (segment == NULL || segment->complete) {
+    g_mutex_unlock (&sink->store_lock);
+    return FALSE;
+  }
+
+  if (running_time > sink->last_running_time)
+    duration = running_time - sink->last_running_time;
+  sink->last_running_time = running_time;
+
+  segment->complete = TRUE;
+  location = gst_hls_sink_entry_location (sink, segment->name);
+  gst_m3u8_playlist_add_entry (sink->playlist, location, NULL, duration,
+      segment->index, FALSE);
+  g_free (location);
+
+  msn = segment->index;
+  part_index = segment->parts->len - 1;
+
+  /* Only keep what the playlist still refers to */
+  while (sink->playlist_length > 0 &&
+      sink->segments.length > sink->playlist_length)
+    gst_hls_sink_segment_free (g_queue_pop_head (&sink->segments));
+
+  sink->segment_index++;
+  next_name = gst_hls_sink_part_name (sink, sink->segment_index, 0);
+  location = gst_hls_sink_entry_location (sink, next_name);
+  gst_m3u8_playlist_set_preload_hint (sink->playlist, location);
+  g_free (location);
+  g_free (next_name);
+  g_mutex_unlock (&sink->store_lock);
+
+  GST_INFO_OBJECT (sink, "Closed segment %u, duration %" GST_TIME_FORMAT,
+      msn, GST_TIME_ARGS (duration));
+
+  if (sink->segment_file) {
+    fclose (sink->segment_file);
+    sink->segment_file = NULL;
+  }
+
+  gst_hls_sink_publish_playlist (sink, msn, part_index);
+
+  return TRUE;
+}
+
+/* Collects a buffer into the current part, starting a new part first
+ * once the part duration is reached */
+static void
+gst_hls_sink_store_buffer (GstHlsSink * sink, GstBuffer * buffer)
+{
+  GstClockTime timestamp = GST_BUFFER_TIMESTAMP (buffer);
+
+  if (GST_CLOCK_TIME_IS_VALID (timestamp) &&
+      sink->segment.format == GST_FORMAT_TIME) {
+    GstClockTime running_time = gst_segment_to_running_time (&sink->segment,
+        GST_FORMAT_TIME, timestamp);
+
+    if (GST_CLOCK_TIME_IS_VALID (running_time)) {
+      GstClockTime end = running_time;
+
+      if (!GST_CLOCK_TIME_IS_VALID (sink->part_start))
+        sink->part_start = running_time;
+      else if (running_time >=
+          sink->part_start + sink->part_duration * GST_MSECOND)
+        gst_hls_sink_close_part (sink, running_time);
+
+      if (GST_BUFFER_DURATION_IS_VALID (buffer))
+        end += GST_BUFFER_DURATION (buffer);
+      if (!GST_CLOCK_TIME_IS_VALID (sink->last_buffer_time) ||
+          end > sink->last_buffer_time)
+        sink->last_buffer_time = end;
+    }
+  }
+
+  if (gst_adapter_available (sink->part_adapter) == 0)
+    sink->part_independent =
+        !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  gst_adapter_push (sink->part_adapter, gst_buffer_ref (buffer));
+}
+
+static gchar *
+gst_hls_sink_get_playlist (GstHlsSink * sink)
+{
+  gchar *playlist_content;
+
+  g_mutex_lock (&sink->store_lock);
+  playlist_content = g_strdup (sink->playlist_content);
+  g_mutex_unlock (&sink->store_lock);
+
+  return playlist_content;
+}
+
+static GstBuffer *
+gst_hls_sink_get_fragment (GstHlsSink * sink, const gchar * name)
+{
+  GstBuffer *ret = NULL;
+  GList *l;
+  guint i;
+
+  g_return_val_if_fail (name != NULL, NULL);
+
+  g_mutex_lock (&sink->store_lock);
+  for (l = sink->segments.head; l != NULL && ret == NULL; l = l->next) {
+    GstHlsSinkSegment *segment = l->data;
+
+    if (strcmp (segment->name, name) == 0) {
+      if (!segment->complete)
+        break;
+
+      /* The segment is the concatenation of its parts */
+      ret = gst_buffer_new ();
+      for (i = 0; i < segment->parts->len; i++) {
+        GstHlsSinkPart *part = g_ptr_array_index (segment->parts, i);
+
+        ret = gst_buffer_append (ret, gst_buffer_ref (part->data));
+      }
+      break;
+    }
+
+    for (i = 0; i < segment->parts->len; i++) {
+      GstHlsSinkPart *part = g_ptr_array_index (segment->parts, i);
+
+      if (strcmp (part->name, name) == 0) {
+        ret = gst_buffer_ref (part->data);
+        break;
+      }
+    }
+  }
+  g_mutex_unlock (&sink->store_lock);
+
+  return ret;
 }
 
 static void
@@ -293,13 +829,7 @@ gst_hls_sink_handle_message (GstBin * bin, GstMessage * message)
       sink->last_running_time = running_time;
 
       GST_INFO_OBJECT (sink, "COUNT %d", sink->index);
-      if (sink->playlist_root == NULL)
-        entry_location = g_path_get_basename (filename);
-      else {
-        gchar *name = g_path_get_basename (filename);
-        entry_location = g_build_filename (sink->playlist_root, name, NULL);
-        g_free (name);
-      }
+      entry_location = gst_hls_sink_entry_location (sink, filename);
 
       gst_m3u8_playlist_add_entry (sink->playlist, entry_location,
           NULL, duration, sink->index, discont);
@@ -321,6 +851,26 @@ gst_hls_sink_handle_message (GstBin * bin, GstMessage * message)
       break;
     }
     case GST_MESSAGE_EOS:{
+      if (sink->part_duration > 0) {
+        GstHlsSinkSegment *segment;
+        guint msn = 0, part = 0;
+
+        gst_hls_sink_close_segment (sink, sink->last_buffer_time);
+
+        g_mutex_lock (&sink->store_lock);
+        sink->playlist->end_list = TRUE;
+        gst_m3u8_playlist_set_preload_hint (sink->playlist, NULL);
+        segment = g_queue_peek_tail (&sink->segments);
+        if (segment != NULL && segment->parts->len > 0) {
+          msn = segment->index;
+          part = segment->parts->len - 1;
+        }
+        g_mutex_unlock (&sink->store_lock);
+
+        gst_hls_sink_publish_playlist (sink, msn, part);
+        break;
+      }
+
       sink->playlist->end_list = TRUE;
       gst_hls_sink_write_playlist (sink);
       break;
@@ -405,6 +955,12 @@ gst_hls_sink_set_property (GObject * object, guint prop_id,
       sink->playlist_length = g_value_get_uint (value);
       sink->playlist->window_size = sink->playlist_length;
       break;
+    case PROP_PART_DURATION:
+      sink->part_duration = g_value_get_uint (value);
+      break;
+    case PROP_PERSIST_SEGMENTS:
+      sink->persist_segments = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -436,6 +992,12 @@ gst_hls_sink_get_property (GObject * object, guint prop_id,
     case PROP_PLAYLIST_LENGTH:
       g_value_set_uint (value, sink->playlist_length);
       break;
+    case PROP_PART_DURATION:
+      g_value_set_uint (value, sink->part_duration);
+      break;
+    case PROP_PERSIST_SEGMENTS:
+      g_value_set_boolean (value, sink->persist_segments);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -473,6 +1035,17 @@ gst_hls_sink_ghost_event_probe (GstPad * pad, GstPadProbeInfo * info,
           &timestamp, &stream_time, &running_time, &all_headers, &count);
       GST_INFO_OBJECT (sink, "setting index %d", count);
       sink->index = count;
+
+      /* In low-latency mode segments are cut here instead of in
+       * multifilesink */
+      if (sink->part_duration > 0) {
+        if (!GST_CLOCK_TIME_IS_VALID (running_time))
+          running_time = sink->last_buffer_time;
+        if (gst_hls_sink_close_segment (sink, running_time)) {
+          sink->waiting_fku = FALSE;
+          schedule_next_key_unit (sink);
+        }
+      }
       break;
     }
     default:
@@ -535,6 +1108,9 @@ gst_hls_sink_ghost_buffer_probe (GstPad * pad, GstPadProbeInfo * info,
   GstHlsSink *sink = GST_HLS_SINK_CAST (data);
   GstBuffer *buffer = gst_pad_probe_info_get_buffer (info);
 
+  if (sink->part_duration > 0)
+    gst_hls_sink_store_buffer (sink, buffer);
+
   if (sink->target_duration == 0 || sink->waiting_fku)
     return GST_PAD_PROBE_OK;
 
@@ -550,7 +1126,9 @@ gst_hls_sink_chain_list (GstPad * pad, GstObject * parent, GstBufferList * list)
   GstFlowReturn ret;
   GstHlsSink *sink = GST_HLS_SINK_CAST (parent);
 
-  if (sink->target_duration == 0 || sink->waiting_fku)
+  /* Low-latency mode needs to see every buffer in the buffer probe */
+  if ((sink->target_duration == 0 || sink->waiting_fku) &&
+      sink->part_duration == 0)
     return gst_proxy_pad_chain_list_default (pad, parent, list);
 
   GST_DEBUG_OBJECT (pad, "chaining each group in list as a merged buffer");
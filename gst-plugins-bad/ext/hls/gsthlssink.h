@@ -21,6 +21,8 @@
 
 #include "gstm3u8playlist.h"
 #include <gst/gst.h>
+#include <gst/base/gstadapter.h>
+#include <stdio.h>
 
 G_BEGIN_DECLS
 
@@ -56,11 +58,32 @@ struct _GstHlsSink
   GstSegment segment;
   gboolean waiting_fku;
   GstClockTime last_running_time;
+
+  /* low-latency mode, with partial segments kept in memory */
+  guint part_duration;
+  gboolean persist_segments;
+  GstElement *fakesink;
+  GstAdapter *part_adapter;
+  GstClockTime part_start;
+  gboolean part_independent;
+  GstClockTime last_buffer_time;
+  guint segment_index;
+  FILE *segment_file;
+  GQueue persisted_files;
+
+  /* protects the segment store and playlist content below */
+  GMutex store_lock;
+  GQueue segments;
+  gchar *playlist_content;
 };
 
 struct _GstHlsSinkClass
 {
   GstBinClass bin_class;
+
+  /* actions */
+  gchar *     (*get_playlist) (GstHlsSink * sink);
+  GstBuffer * (*get_fragment) (GstHlsSink * sink, const gchar * name);
 };
 
 GType gst_hls_sink_get_type (void);
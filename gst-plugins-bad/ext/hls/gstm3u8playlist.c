@@ -33,6 +33,7 @@ enum
 };
 
 typedef struct _GstM3U8Entry GstM3U8Entry;
+typedef struct _GstM3U8Part GstM3U8Part;
 
 struct _GstM3U8Entry
 {
@@ -40,8 +41,39 @@ struct _GstM3U8Entry
   gchar *title;
   gchar *url;
   gboolean discontinuous;
+
+  /* partial segments the entry was written as, if any */
+  GList *parts;
+  /* EXTINF and url lines, rendered once when the entry is added */
+  gchar *rendered;
 };
 
+struct _GstM3U8Part
+{
+  gfloat duration;
+  gchar *url;
+  gboolean independent;
+};
+
+static GstM3U8Part *
+gst_m3u8_part_new (const gchar * url, gfloat duration, gboolean independent)
+{
+  GstM3U8Part *part;
+
+  part = g_new0 (GstM3U8Part, 1);
+  part->url = g_strdup (url);
+  part->duration = duration;
+  part->independent = independent;
+  return part;
+}
+
+static void
+gst_m3u8_part_free (GstM3U8Part * part)
+{
+  g_free (part->url);
+  g_free (part);
+}
+
 static GstM3U8Entry *
 gst_m3u8_entry_new (const gchar * url, const gchar * title,
     gfloat duration, gboolean discontinuous)
@@ -65,6 +97,8 @@ gst_m3u8_entry_free (GstM3U8Entry * entry)
 
   g_free (entry->url);
   g_free (entry->title);
+  g_free (entry->rendered);
+  g_list_free_full (entry->parts, (GDestroyNotify) gst_m3u8_part_free);
   g_free (entry);
 }
 
@@ -80,6 +114,7 @@ gst_m3u8_playlist_new (guint version, guint window_size, gboolean allow_cache)
   playlist->type = GST_M3U8_PLAYLIST_TYPE_EVENT;
   playlist->end_list = FALSE;
   playlist->entries = g_queue_new ();
+  playlist->pending_parts = g_queue_new ();
 
   return playlist;
 }
@@ -91,9 +126,37 @@ gst_m3u8_playlist_free (GstM3U8Playlist * playlist)
 
   g_queue_foreach (playlist->entries, (GFunc) gst_m3u8_entry_free, NULL);
   g_queue_free (playlist->entries);
+  g_queue_foreach (playlist->pending_parts, (GFunc) gst_m3u8_part_free, NULL);
+  g_queue_free (playlist->pending_parts);
+  g_free (playlist->preload_hint);
   g_free (playlist);
 }
 
+static gchar *
+gst_m3u8_entry_render (GstM3U8Playlist * playlist, GstM3U8Entry * entry)
+{
+  GString *entry_str;
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  entry_str = g_string_new (NULL);
+
+  if (entry->discontinuous)
+    g_string_append (entry_str, "#EXT-X-DISCONTINUITY\n");
+
+  if (playlist->version < 3) {
+    g_string_append_printf (entry_str, "#EXTINF:%d,%s\n",
+        (gint) ((entry->duration + 500 * GST_MSECOND) / GST_SECOND),
+        entry->title ? entry->title : "");
+  } else {
+    g_string_append_printf (entry_str, "#EXTINF:%s,%s\n",
+        g_ascii_dtostr (buf, sizeof (buf), entry->duration / GST_SECOND),
+        entry->title ? entry->title : "");
+  }
+
+  g_string_append_printf (entry_str, "%s\n", entry->url);
+
+  return g_string_free (entry_str, FALSE);
+}
 
 gboolean
 gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
@@ -109,6 +172,11 @@ gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
     return FALSE;
 
   entry = gst_m3u8_entry_new (url, title, duration, discontinuous);
+  entry->rendered = gst_m3u8_entry_render (playlist, entry);
+
+  /* The parts written so far make up this segment */
+  entry->parts = playlist->pending_parts->head;
+  g_queue_init (playlist->pending_parts);
 
   if (playlist->window_size > 0) {
     /* Delete old entries from the playlist */
@@ -126,6 +194,50 @@ gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
   return TRUE;
 }
 
+/* Adds a partial segment to the segment that is currently being written. It
+ * becomes part of the next entry added with gst_m3u8_playlist_add_entry() */
+gboolean
+gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist, const gchar * url,
+    gfloat duration, gboolean independent)
+{
+  g_return_val_if_fail (playlist != NULL, FALSE);
+  g_return_val_if_fail (url != NULL, FALSE);
+
+  if (playlist->type == GST_M3U8_PLAYLIST_TYPE_VOD)
+    return FALSE;
+
+  g_queue_push_tail (playlist->pending_parts,
+      gst_m3u8_part_new (url, duration, independent));
+
+  return TRUE;
+}
+
+void
+gst_m3u8_playlist_set_preload_hint (GstM3U8Playlist * playlist,
+    const gchar * url)
+{
+  g_return_if_fail (playlist != NULL);
+
+  g_free (playlist->preload_hint);
+  playlist->preload_hint = g_strdup (url);
+}
+
+static void
+gst_m3u8_playlist_render_parts (GString * playlist_str, GList * parts)
+{
+  GList *l;
+
+  for (l = parts; l != NULL; l = l->next) {
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+    GstM3U8Part *part = l->data;
+
+    g_string_append_printf (playlist_str,
+        "#EXT-X-PART:DURATION=%s,URI=\"%s\"%s\n",
+        g_ascii_dtostr (buf, sizeof (buf), part->duration / GST_SECOND),
+        part->url, part->independent ? ",INDEPENDENT=YES" : "");
+  }
+}
+
 static guint
 gst_m3u8_playlist_target_duration (GstM3U8Playlist * playlist)
 {
@@ -146,7 +258,9 @@ gchar *
 gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
 {
   GString *playlist_str;
-  GList *l;
+  GList *l, *parts_start = NULL;
+  guint target_duration;
+  gboolean render_parts = FALSE;
 
   g_return_val_if_fail (playlist != NULL, NULL);
 
@@ -161,29 +275,56 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
   g_string_append_printf (playlist_str, "#EXT-X-MEDIA-SEQUENCE:%d\n",
       playlist->sequence_number - playlist->entries->length);
 
+  target_duration = gst_m3u8_playlist_target_duration (playlist);
   g_string_append_printf (playlist_str, "#EXT-X-TARGETDURATION:%u\n",
-      gst_m3u8_playlist_target_duration (playlist));
+      target_duration);
+
+  if (playlist->part_target > 0) {
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+    gfloat parts_duration = 0;
+
+    /* Clients have to stay at least 3 part durations behind the live edge */
+    g_string_append_printf (playlist_str,
+        "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=%s\n",
+        g_ascii_dtostr (buf, sizeof (buf),
+            3 * playlist->part_target / GST_SECOND));
+    g_string_append_printf (playlist_str, "#EXT-X-PART-INF:PART-TARGET=%s\n",
+        g_ascii_dtostr (buf, sizeof (buf), playlist->part_target / GST_SECOND));
+
+    /* Parts are only listed for the segments in the last 3 target
+     * durations of the playlist */
+    parts_start = playlist->entries->tail;
+    while (parts_start != NULL) {
+      GstM3U8Entry *entry = parts_start->data;
+
+      parts_duration += entry->duration;
+      if (parts_duration > 3 * target_duration * GST_SECOND)
+        break;
+      parts_start = parts_start->prev;
+    }
+    parts_start = parts_start ? parts_start->next : playlist->entries->head;
+  }
   g_string_append (playlist_str, "\n");
 
   /* Entries */
   for (l = playlist->entries->head; l != NULL; l = l->next) {
-    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
     GstM3U8Entry *entry = l->data;
 
-    if (entry->discontinuous)
-      g_string_append (playlist_str, "#EXT-X-DISCONTINUITY\n");
-
-    if (playlist->version < 3) {
-      g_string_append_printf (playlist_str, "#EXTINF:%d,%s\n",
-          (gint) ((entry->duration + 500 * GST_MSECOND) / GST_SECOND),
-          entry->title ? entry->title : "");
-    } else {
-      g_string_append_printf (playlist_str, "#EXTINF:%s,%s\n",
-          g_ascii_dtostr (buf, sizeof (buf), entry->duration / GST_SECOND),
-          entry->title ? entry->title : "");
-    }
+    if (l == parts_start)
+      render_parts = TRUE;
+    if (render_parts)
+      gst_m3u8_playlist_render_parts (playlist_str, entry->parts);
+
+    g_string_append (playlist_str, entry->rendered);
+  }
 
-    g_string_append_printf (playlist_str, "%s\n", entry->url);
+  if (playlist->part_target > 0 && !playlist->end_list) {
+    gst_m3u8_playlist_render_parts (playlist_str,
+        playlist->pending_parts->head);
+    if (playlist->preload_hint)
+      g_string_append_printf (playlist_str,
+          "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"%s\"\n",
+          playlist->preload_hint);
   }
 
   if (playlist->end_list)
@@ -36,9 +36,14 @@ struct _GstM3U8Playlist
   gint type;
   gboolean end_list;
   guint sequence_number;
+  /* target duration of partial segments (low-latency HLS), 0 = disabled */
+  gfloat part_target;
 
   /*< Private >*/
   GQueue *entries;
+  /* parts of the segment that is still being written */
+  GQueue *pending_parts;
+  gchar *preload_hint;
 };
 
 
@@ -55,6 +60,14 @@ gboolean          gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
                                                guint             index,
                                                gboolean          discontinuous);
 
+gboolean          gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist,
+                                              const gchar     * url,
+                                              gfloat            duration,
+                                              gboolean          independent);
+
+void              gst_m3u8_playlist_set_preload_hint (GstM3U8Playlist * playlist,
+                                                      const gchar     * url);
+
 gchar *           gst_m3u8_playlist_render (GstM3U8Playlist * playlist);
 
 G_END_DECLS
@@ -271,6 +271,189 @@ gst_m3u8_compare_playlist_by_bitrate (gconstpointer a, gconstpointer b)
   return ((GstM3U8 *) (a))->bandwidth - ((GstM3U8 *) (b))->bandwidth;
 }
 
+/* Compares a media file with a raw, possibly relative, URI line of the
+ * playlist without joining it with the base URI */
+static gboolean
+_media_file_matches_line (GstM3U8MediaFile * file, const gchar * line,
+    gsize len)
+{
+  gsize uri_len = strlen (file->uri);
+
+  if (len == 0 || uri_len < len)
+    return FALSE;
+
+  return memcmp (file->uri + uri_len - len, line, len) == 0;
+}
+
+/*
+ * Live media playlists mostly change by appending new entries at the end
+ * and expiring old ones from the head. Instead of rebuilding the complete
+ * list of media files on every reload, skip over the entries we already
+ * know about (checking that they are the same by sequence number and URI),
+ * parse only the appended ones and drop the expired ones in place.
+ *
+ * Anything this doesn't understand makes it bail out without touching
+ * @self, in which case the caller does a full parse. @data is not
+ * modified.
+ */
+static gboolean
+gst_m3u8_update_incremental (GstM3U8 * self, const gchar * data)
+{
+  GList *walk, *new_files = NULL;
+  GstM3U8MediaFile *file;
+  GstClockTime duration = 0, targetduration = self->targetduration;
+  gchar *title = NULL;
+  gboolean discontinuity = FALSE, endlist = FALSE;
+  gboolean allowcache = TRUE;
+  gint version = self->version;
+  gint val;
+  gint64 mediasequence = 0, first_sequence = -1;
+  gint64 old_first, old_last;
+  guint n_expired = 0, n_new = 0;
+  const gchar *end;
+
+  if (!self->files || self->lists || self->iframe_lists || self->endlist)
+    return FALSE;
+
+  old_first = GST_M3U8_MEDIA_FILE (self->files->data)->sequence;
+  old_last = GST_M3U8_MEDIA_FILE (g_list_last (self->files)->data)->sequence;
+  walk = NULL;
+
+  data += 7;
+  while (TRUE) {
+    gsize len;
+
+    end = strchr (data, '\n');
+    len = end ? end - data : strlen (data);
+    if (len > 0 && data[len - 1] == '\r')
+      len--;
+
+    if (data[0] != '#' && len > 0) {
+      if (first_sequence == -1) {
+        first_sequence = mediasequence;
+
+        /* the sliding window must not move backwards or jump over the end
+         * of the entries we know about */
+        if (first_sequence < old_first || first_sequence > old_last + 1)
+          goto full_parse;
+
+        n_expired = first_sequence - old_first;
+        walk = g_list_nth (self->files, n_expired);
+      }
+
+      if (walk) {
+        file = walk->data;
+        if (file->sequence != mediasequence || file->key
+            || file->size != -1 || file->discont != discontinuity
+            || !_media_file_matches_line (file, data, len)) {
+          GST_DEBUG ("Entry %" G_GINT64_FORMAT " changed", mediasequence);
+          goto full_parse;
+        }
+        walk = walk->next;
+        mediasequence++;
+      } else if (duration > 0) {
+        gchar *name, *uri;
+
+        name = g_strndup (data, len);
+        uri = uri_join (self->base_uri ? self->base_uri : self->uri, name);
+        g_free (name);
+        if (uri == NULL)
+          goto next_line;
+
+        file = gst_m3u8_media_file_new (uri, title, duration, mediasequence++);
+        file->size = -1;
+        file->offset = 0;
+        file->discont = discontinuity;
+        new_files = g_list_prepend (new_files, file);
+        title = NULL;
+        n_new++;
+      } else {
+        GST_LOG ("got line without EXTINF, dropping");
+        goto next_line;
+      }
+
+      duration = 0;
+      g_free (title);
+      title = NULL;
+      discontinuity = FALSE;
+    } else if (g_str_has_prefix (data, "#EXTINF:")) {
+      gdouble fval;
+      gchar *p;
+
+      if (!double_from_string ((gchar *) data + 8, &p, &fval))
+        goto next_line;
+      duration = fval * (gdouble) GST_SECOND;
+      g_free (title);
+      title = NULL;
+      if (*p == ',' && p + 1 < data + len)
+        title = g_strndup (p + 1, data + len - (p + 1));
+    } else if (g_str_has_prefix (data, "#EXT-X-")) {
+      const gchar *data_ext_x = data + 7;
+
+      if (g_str_has_prefix (data_ext_x, "ENDLIST")) {
+        endlist = TRUE;
+      } else if (g_str_has_prefix (data_ext_x, "VERSION:")) {
+        if (int_from_string ((gchar *) data + 15, NULL, &val))
+          version = val;
+      } else if (g_str_has_prefix (data_ext_x, "TARGETDURATION:")) {
+        if (int_from_string ((gchar *) data + 22, NULL, &val))
+          targetduration = val * GST_SECOND;
+      } else if (g_str_has_prefix (data_ext_x, "MEDIA-SEQUENCE:")) {
+        if (first_sequence != -1)
+          goto full_parse;
+        if (int_from_string ((gchar *) data + 22, NULL, &val))
+          mediasequence = val;
+      } else if (g_str_has_prefix (data_ext_x, "DISCONTINUITY")) {
+        discontinuity = TRUE;
+      } else if (g_str_has_prefix (data_ext_x, "PROGRAM-DATE-TIME:")) {
+        /* ignored by the full parser as well */
+      } else if (g_str_has_prefix (data_ext_x, "ALLOW-CACHE:")) {
+        allowcache = len == 22
+            && g_ascii_strncasecmp (data + 19, "YES", 3) == 0;
+      } else if (g_str_has_prefix (data_ext_x, "KEY:")
+          || g_str_has_prefix (data_ext_x, "BYTERANGE:")
+          || g_str_has_prefix (data_ext_x, "STREAM-INF:")
+          || g_str_has_prefix (data_ext_x, "I-FRAME-STREAM-INF:")) {
+        goto full_parse;
+      }
+    }
+
+  next_line:
+    if (!end)
+      break;
+    data = end + 1;
+  }
+
+  /* entries vanished from the middle of the window, or nothing is left */
+  if (first_sequence == -1 || walk != NULL
+      || (n_new == 0 && n_expired > old_last - old_first))
+    goto full_parse;
+
+  g_free (title);
+
+  GST_DEBUG ("Incremental update: %u expired, %u new entries", n_expired,
+      n_new);
+
+  while (n_expired--) {
+    gst_m3u8_media_file_free (self->files->data);
+    self->files = g_list_delete_link (self->files, self->files);
+  }
+  self->files = g_list_concat (self->files, g_list_reverse (new_files));
+
+  self->targetduration = targetduration;
+  self->version = version;
+  self->allowcache = allowcache;
+  self->endlist = endlist;
+
+  return TRUE;
+
+full_parse:
+  GST_DEBUG ("Can't update playlist incrementally, doing a full parse");
+  g_free (title);
+  g_list_free_full (new_files, (GDestroyNotify) gst_m3u8_media_file_free);
+  return FALSE;
+}
+
 /*
  * @data: a m3u8 playlist text data, taking ownership
  */
@@ -316,6 +499,11 @@ gst_m3u8_update (GstM3U8Client * client, GstM3U8 * self, gchar * data,
   self->last_data = data;
 
   client->current_file = NULL;
+  if (gst_m3u8_update_incremental (self, data)) {
+    client->duration = GST_CLOCK_TIME_NONE;
+    goto update_times;
+  }
+
   if (self->files) {
     g_list_foreach (self->files, (GFunc) gst_m3u8_media_file_free, NULL);
     g_list_free (self->files);
@@ -609,6 +797,8 @@ gst_m3u8_update (GstM3U8Client * client, GstM3U8 * self, gchar * data,
       self->current_variant = g_list_find_custom (self->lists, top_variant_uri,
           (GCompareFunc) _m3u8_compare_uri);
   }
+
+update_times:
   /* calculate the start and end times of this media playlist. */
   if (self->files) {
     GList *walk;
@@ -933,6 +1123,40 @@ gst_m3u8_client_get_next_fragment (GstM3U8Client * client,
   return TRUE;
 }
 
+gboolean
+gst_m3u8_client_peek_fragment (GstM3U8Client * client, guint n, gchar ** uri,
+    gint64 * range_start, gint64 * range_end, gboolean forward)
+{
+  GstM3U8MediaFile *file;
+  GList *l;
+
+  g_return_val_if_fail (client != NULL, FALSE);
+  g_return_val_if_fail (client->current != NULL, FALSE);
+
+  GST_M3U8_CLIENT_LOCK (client);
+  l = client->current_file;
+  while (l && n > 0) {
+    l = forward ? l->next : l->prev;
+    n--;
+  }
+
+  if (!l) {
+    GST_M3U8_CLIENT_UNLOCK (client);
+    return FALSE;
+  }
+
+  file = GST_M3U8_MEDIA_FILE (l->data);
+  if (uri)
+    *uri = g_strdup (file->uri);
+  if (range_start)
+    *range_start = file->offset;
+  if (range_end)
+    *range_end = file->size != -1 ? file->offset + file->size - 1 : -1;
+
+  GST_M3U8_CLIENT_UNLOCK (client);
+  return TRUE;
+}
+
 gboolean
 gst_m3u8_client_has_next_fragment (GstM3U8Client * client, gboolean forward)
 {
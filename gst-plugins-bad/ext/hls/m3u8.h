@@ -126,6 +126,13 @@ gboolean        gst_m3u8_client_get_next_fragment   (GstM3U8Client * client,
                                                      guint8       ** iv,
                                                      gboolean        forward);
 
+gboolean        gst_m3u8_client_peek_fragment       (GstM3U8Client * client,
+                                                     guint           n,
+                                                     gchar        ** uri,
+                                                     gint64        * range_start,
+                                                     gint64        * range_end,
+                                                     gboolean        forward);
+
 gboolean        gst_m3u8_client_has_next_fragment   (GstM3U8Client * client,
                                                      gboolean        forward);
 
@@ -155,6 +155,8 @@ static GstFlowReturn gst_openh264enc_handle_frame (GstVideoEncoder * encoder,
 static GstFlowReturn gst_openh264enc_finish (GstVideoEncoder * encoder);
 static gboolean gst_openh264enc_propose_allocation (GstVideoEncoder * encoder,
     GstQuery * query);
+static gboolean gst_openh264enc_sink_event (GstVideoEncoder * encoder,
+    GstEvent * event);
 static void gst_openh264enc_set_usage_type (GstOpenh264Enc * openh264enc,
     gint usage_type);
 static void gst_openh264enc_set_rate_control (GstOpenh264Enc * openh264enc,
@@ -178,6 +180,14 @@ static void gst_openh264enc_set_rate_control (GstOpenh264Enc * openh264enc,
 #define DEFAULT_SLICE_MODE      SM_FIXEDSLCNUM_SLICE
 #define DEFAULT_NUM_SLICES      1
 #define DEFAULT_COMPLEXITY      MEDIUM_COMPLEXITY
+#define DEFAULT_SPATIAL_LAYERS  1
+
+/* Simulcast of independent AVC spatial layers needs openh264 1.6 */
+#if OPENH264_MINOR >= 6
+#define MAX_SPATIAL_LAYERS      MAX_SPATIAL_LAYER_NUM
+#else
+#define MAX_SPATIAL_LAYERS      1
+#endif
 
 enum
 {
@@ -197,6 +207,7 @@ enum
   PROP_SLICE_MODE,
   PROP_NUM_SLICES,
   PROP_COMPLEXITY,
+  PROP_SPATIAL_LAYERS,
   N_PROPERTIES
 };
 
@@ -217,6 +228,14 @@ GST_STATIC_PAD_TEMPLATE ("src",
     ("video/x-h264, stream-format=(string)\"avc\", alignment=(string)\"au\", profile=(string)\"baseline\"")
     );
 
+static GstStaticPadTemplate gst_openh264enc_layer_template =
+GST_STATIC_PAD_TEMPLATE ("layer_%u",
+    GST_PAD_SRC,
+    GST_PAD_SOMETIMES,
+    GST_STATIC_CAPS
+    ("video/x-h264, stream-format=(string)\"byte-stream\", alignment=(string)\"au\", profile=(string)\"baseline\"")
+    );
+
 /* class initialization */
 
 G_DEFINE_TYPE_WITH_CODE (GstOpenh264Enc, gst_openh264enc,
@@ -237,6 +256,8 @@ gst_openh264enc_class_init (GstOpenh264EncClass * klass)
       &gst_openh264enc_src_template);
   gst_element_class_add_static_pad_template (GST_ELEMENT_CLASS (klass),
       &gst_openh264enc_sink_template);
+  gst_element_class_add_static_pad_template (GST_ELEMENT_CLASS (klass),
+      &gst_openh264enc_layer_template);
 
   gst_element_class_set_static_metadata (GST_ELEMENT_CLASS (klass),
       "OpenH264 video encoder", "Encoder/Video", "OpenH264 video encoder",
@@ -254,6 +275,8 @@ gst_openh264enc_class_init (GstOpenh264EncClass * klass)
   video_encoder_class->propose_allocation =
       GST_DEBUG_FUNCPTR (gst_openh264enc_propose_allocation);
   video_encoder_class->finish = GST_DEBUG_FUNCPTR (gst_openh264enc_finish);
+  video_encoder_class->sink_event =
+      GST_DEBUG_FUNCPTR (gst_openh264enc_sink_event);
 
   /* define properties */
   g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_USAGE_TYPE,
@@ -339,6 +362,26 @@ gst_openh264enc_class_init (GstOpenh264EncClass * klass)
       g_param_spec_enum ("complexity", "Complexity / quality / speed tradeoff",
           "Complexity", GST_TYPE_OPENH264ENC_COMPLEXITY, DEFAULT_COMPLEXITY,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+  /**
+   * GstOpenh264Enc:spatial-layers:
+   *
+   * Number of spatial layers encoded in simulcast. The full resolution is
+   * output on the src pad, each further layer halves the width and height
+   * of the previous one and is output as byte-stream on a layer_%u pad,
+   * layer_0 being the smallest. The bitrate of the lower layers is scaled
+   * down from the bitrate property by their area.
+   *
+   * All layers are encoded by the same encoder instance, sharing the
+   * downscaling and the threads of the multi-thread property.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SPATIAL_LAYERS,
+      g_param_spec_uint ("spatial-layers", "Spatial layers",
+          "Number of spatial layers to encode in simulcast",
+          1, MAX_SPATIAL_LAYERS, DEFAULT_SPATIAL_LAYERS,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 }
 
 static void
@@ -366,6 +409,10 @@ gst_openh264enc_init (GstOpenh264Enc * openh264enc)
   openh264enc->num_slices = DEFAULT_NUM_SLICES;
   openh264enc->encoder = NULL;
   openh264enc->complexity = DEFAULT_COMPLEXITY;
+  openh264enc->spatial_layers = DEFAULT_SPATIAL_LAYERS;
+  openh264enc->n_layer_pads = 0;
+  gst_segment_init (&openh264enc->layer_segment, GST_FORMAT_TIME);
+  openh264enc->layer_segment_pending = FALSE;
   gst_openh264enc_set_usage_type (openh264enc, CAMERA_VIDEO_REAL_TIME);
   gst_openh264enc_set_rate_control (openh264enc, RC_QUALITY_MODE);
 }
@@ -477,6 +524,10 @@ gst_openh264enc_set_property (GObject * object, guint property_id,
           (ECOMPLEXITY_MODE) g_value_get_enum (value);
       break;
 
+    case PROP_SPATIAL_LAYERS:
+      openh264enc->spatial_layers = g_value_get_uint (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -552,6 +603,10 @@ gst_openh264enc_get_property (GObject * object, guint property_id,
       g_value_set_enum (value, openh264enc->complexity);
       break;
 
+    case PROP_SPATIAL_LAYERS:
+      g_value_set_uint (value, openh264enc->spatial_layers);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -609,6 +664,165 @@ gst_openh264enc_stop (GstVideoEncoder * encoder)
 }
 
 
+/* Copies all NAL units of spatial layer @spatial_id to @data, and returns
+ * the number of bytes written, or needed if @data is %NULL. For avc the
+ * start codes are replaced by the 16 bit sizes announced in the codec_data,
+ * otherwise the byte-stream is copied as is. */
+static gsize
+gst_openh264enc_write_layer (SFrameBSInfo * info, gint spatial_id,
+    gboolean avc, guchar * data)
+{
+  gsize size = 0;
+  gint i, j;
+
+  for (i = 0; i < info->iLayerNum; i++) {
+    SLayerBSInfo *layer = &info->sLayerInfo[i];
+    guchar *nal = layer->pBsBuf;
+
+    for (j = 0; j < layer->iNalCount; j++) {
+      gint nal_size = layer->pNalLengthInByte[j];
+
+      if (layer->uiSpatialId == spatial_id) {
+        if (avc) {
+          if (data) {
+            GST_WRITE_UINT16_BE (data + size, nal_size - 4);
+            memcpy (data + size + 2, nal + 4, nal_size - 4);
+          }
+          size += nal_size - 2;
+        } else {
+          if (data)
+            memcpy (data + size, nal, nal_size);
+          size += nal_size;
+        }
+      }
+      nal += nal_size;
+    }
+  }
+
+  return size;
+}
+
+/* Finds the first NAL unit of @nal_type in spatial layer @spatial_id, without
+ * its start code */
+static gboolean
+gst_openh264enc_find_nal (SFrameBSInfo * info, gint spatial_id, gint nal_type,
+    guchar ** data, gint * size)
+{
+  gint i, j;
+
+  for (i = 0; i < info->iLayerNum; i++) {
+    SLayerBSInfo *layer = &info->sLayerInfo[i];
+    guchar *nal = layer->pBsBuf;
+
+    for (j = 0; j < layer->iNalCount; j++) {
+      if (layer->uiSpatialId == spatial_id && (nal[4] & 0x1f) == nal_type) {
+        *data = nal + 4;
+        *size = layer->pNalLengthInByte[j] - 4;
+        return TRUE;
+      }
+      nal += layer->pNalLengthInByte[j];
+    }
+  }
+
+  return FALSE;
+}
+
+/* The full resolution goes out on the src pad, all lower spatial layers
+ * get a layer_%u pad of their own */
+static void
+gst_openh264enc_update_layer_pads (GstOpenh264Enc * openh264enc,
+    SEncParamExt * params)
+{
+  GstElement *element = GST_ELEMENT (openh264enc);
+  GstVideoInfo *info = &openh264enc->input_state->info;
+  guint i, n_pads = params->iSpatialLayerNum - 1;
+
+  while (openh264enc->n_layer_pads > n_pads) {
+    GstPad *pad = openh264enc->layer_pads[--openh264enc->n_layer_pads];
+
+    gst_pad_set_active (pad, FALSE);
+    gst_element_remove_pad (element, pad);
+  }
+
+  while (openh264enc->n_layer_pads < n_pads) {
+    GstPad *pad;
+    gchar *name, *stream_id;
+
+    name = g_strdup_printf ("layer_%u", openh264enc->n_layer_pads);
+    pad = gst_pad_new_from_static_template (&gst_openh264enc_layer_template,
+        name);
+    g_free (name);
+
+    gst_pad_use_fixed_caps (pad);
+    gst_pad_set_active (pad, TRUE);
+    stream_id = gst_pad_create_stream_id (pad, element, GST_PAD_NAME (pad));
+    gst_pad_push_event (pad, gst_event_new_stream_start (stream_id));
+    g_free (stream_id);
+
+    gst_element_add_pad (element, pad);
+    openh264enc->layer_pads[openh264enc->n_layer_pads++] = pad;
+  }
+
+  for (i = 0; i < n_pads; i++) {
+    GstCaps *caps;
+
+    caps = gst_caps_new_simple ("video/x-h264",
+        "stream-format", G_TYPE_STRING, "byte-stream",
+        "alignment", G_TYPE_STRING, "au",
+        "profile", G_TYPE_STRING, "baseline",
+        "width", G_TYPE_INT, params->sSpatialLayers[i].iVideoWidth,
+        "height", G_TYPE_INT, params->sSpatialLayers[i].iVideoHeight,
+        "framerate", GST_TYPE_FRACTION, GST_VIDEO_INFO_FPS_N (info),
+        GST_VIDEO_INFO_FPS_D (info), NULL);
+    gst_pad_push_event (openh264enc->layer_pads[i], gst_event_new_caps (caps));
+    gst_caps_unref (caps);
+  }
+
+  openh264enc->layer_segment_pending = TRUE;
+}
+
+static GstFlowReturn
+gst_openh264enc_push_layers (GstOpenh264Enc * openh264enc,
+    SFrameBSInfo * frame_info, GstVideoCodecFrame * frame)
+{
+  GstFlowReturn ret = GST_FLOW_OK, layer_ret;
+  GstBuffer *buf;
+  GstMapInfo map;
+  gsize size;
+  guint i;
+
+  if (openh264enc->layer_segment_pending) {
+    for (i = 0; i < openh264enc->n_layer_pads; i++)
+      gst_pad_push_event (openh264enc->layer_pads[i],
+          gst_event_new_segment (&openh264enc->layer_segment));
+    openh264enc->layer_segment_pending = FALSE;
+  }
+
+  for (i = 0; i < openh264enc->n_layer_pads; i++) {
+    size = gst_openh264enc_write_layer (frame_info, i, FALSE, NULL);
+    if (size == 0)
+      continue;
+
+    buf = gst_buffer_new_allocate (NULL, size, NULL);
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    gst_openh264enc_write_layer (frame_info, i, FALSE, map.data);
+    gst_buffer_unmap (buf, &map);
+
+    GST_BUFFER_PTS (buf) = frame->pts;
+    GST_BUFFER_DTS (buf) = frame->pts;
+    GST_BUFFER_DURATION (buf) = frame->duration;
+    if (frame_info->eFrameType != videoFrameTypeIDR)
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+
+    /* a layer nobody is interested in doesn't stop the others */
+    layer_ret = gst_pad_push (openh264enc->layer_pads[i], buf);
+    if (layer_ret < GST_FLOW_EOS)
+      ret = layer_ret;
+  }
+
+  return ret;
+}
+
 static gboolean
 gst_openh264enc_set_format (GstVideoEncoder * encoder,
     GstVideoCodecState * state)
@@ -628,6 +842,7 @@ gst_openh264enc_set_format (GstVideoEncoder * encoder,
   GstBuffer *codec_data;
   GstCaps *outcaps;
   GstVideoCodecState *output_state;
+  guint i, n_layers;
   openh264enc->frame_count = 0;
   int video_format = videoFormatI420;
 
@@ -665,7 +880,11 @@ gst_openh264enc_set_format (GstVideoEncoder * encoder,
   enc_params.iTargetBitrate = openh264enc->bitrate;
   enc_params.iRCMode = RC_QUALITY_MODE;
   enc_params.iTemporalLayerNum = 1;
-  enc_params.iSpatialLayerNum = 1;
+  n_layers = openh264enc->spatial_layers;
+  enc_params.iSpatialLayerNum = n_layers;
+#if OPENH264_MINOR >= 6
+  enc_params.bSimulcastAVC = n_layers > 1;
+#endif
   enc_params.iLtrMarkPeriod = 30;
   enc_params.iMultipleThreadIdc = openh264enc->multi_thread;
   enc_params.bEnableDenoise = openh264enc->enable_denoise;
@@ -686,15 +905,28 @@ gst_openh264enc_set_format (GstVideoEncoder * encoder,
   enc_params.bPrefixNalAddingCtrl = 0;
   enc_params.fMaxFrameRate = fps_n * 1.0 / fps_d;
   enc_params.iLoopFilterDisableIdc = openh264enc->deblocking_mode;
-  enc_params.sSpatialLayers[0].uiProfileIdc = PRO_BASELINE;
-  enc_params.sSpatialLayers[0].iVideoWidth = width;
-  enc_params.sSpatialLayers[0].iVideoHeight = height;
-  enc_params.sSpatialLayers[0].fFrameRate = fps_n * 1.0 / fps_d;
-  enc_params.sSpatialLayers[0].iSpatialBitrate = openh264enc->bitrate;
-  enc_params.sSpatialLayers[0].sSliceCfg.uiSliceMode =
-      openh264enc->slice_mode;
-  enc_params.sSpatialLayers[0].sSliceCfg.sSliceArgument.uiSliceNum =
-      openh264enc->num_slices;
+
+  /* the last spatial layer is the full resolution, each one below halves
+   * the width and height and gets a quarter of the bitrate */
+  enc_params.iTargetBitrate = 0;
+  for (i = 0; i < n_layers; i++) {
+    SSpatialLayerConfig *layer = &enc_params.sSpatialLayers[i];
+    guint shift = n_layers - 1 - i;
+
+    layer->uiProfileIdc = PRO_BASELINE;
+    layer->iVideoWidth = MAX ((width >> shift) & ~1, 16);
+    layer->iVideoHeight = MAX ((height >> shift) & ~1, 16);
+    layer->fFrameRate = fps_n * 1.0 / fps_d;
+    layer->iSpatialBitrate = openh264enc->bitrate >> (2 * shift);
+#if OPENH264_MINOR >= 6
+    layer->sSliceArgument.uiSliceMode = openh264enc->slice_mode;
+    layer->sSliceArgument.uiSliceNum = openh264enc->num_slices;
+#else
+    layer->sSliceCfg.uiSliceMode = openh264enc->slice_mode;
+    layer->sSliceCfg.sSliceArgument.uiSliceNum = openh264enc->num_slices;
+#endif
+    enc_params.iTargetBitrate += layer->iSpatialBitrate;
+  }
 
   openh264enc->framerate = (1 + fps_n / fps_d);
 
@@ -711,13 +943,11 @@ gst_openh264enc_set_format (GstVideoEncoder * encoder,
 
   ret = openh264enc->encoder->EncodeParameterSets (&bsInfo);
 
-  nal_sps_data = bsInfo.sLayerInfo[0].pBsBuf + 4;
-  nal_sps_length = bsInfo.sLayerInfo[0].pNalLengthInByte[0] - 4;
-
-  nal_pps_data = bsInfo.sLayerInfo[0].pBsBuf + nal_sps_length + 8;
-  nal_pps_length = bsInfo.sLayerInfo[0].pNalLengthInByte[1] - 4;
-
-  if (ret != cmResultSuccess) {
+  if (ret != cmResultSuccess
+      || !gst_openh264enc_find_nal (&bsInfo, n_layers - 1, 7, &nal_sps_data,
+          &nal_sps_length)
+      || !gst_openh264enc_find_nal (&bsInfo, n_layers - 1, 8, &nal_pps_data,
+          &nal_pps_length)) {
     GST_ELEMENT_ERROR (openh264enc, STREAM, ENCODE,
         ("Could not create headers"), ("Could not create SPS"));
     return FALSE;
@@ -761,7 +991,12 @@ gst_openh264enc_set_format (GstVideoEncoder * encoder,
   output_state = gst_video_encoder_set_output_state (encoder, outcaps, state);
   gst_video_codec_state_unref (output_state);
 
-  return gst_video_encoder_negotiate (encoder);
+  if (!gst_video_encoder_negotiate (encoder))
+    return FALSE;
+
+  gst_openh264enc_update_layer_pads (openh264enc, &enc_params);
+
+  return TRUE;
 }
 
 static gboolean
@@ -786,6 +1021,10 @@ gst_openh264enc_handle_frame (GstVideoEncoder * encoder,
   SFrameBSInfo frame_info;
   gfloat fps;
   GstVideoEncoder *base_encoder = GST_VIDEO_ENCODER (openh264enc);
+  GstFlowReturn flow_ret, layer_ret;
+  GstMapInfo map;
+  gint spatial_id;
+  gsize size;
 
   if (frame) {
     src_pic = new SSourcePicture;
@@ -891,63 +1130,65 @@ gst_openh264enc_handle_frame (GstVideoEncoder * encoder,
     return GST_FLOW_ERROR;
   }
 
-  SLayerBSInfo *bs_info = &frame_info.sLayerInfo[0];
-  gint nal_size = bs_info->pNalLengthInByte[0] - 4;
-  guchar *nal_sps_data, *nal_pps_data;
-  gint nal_sps_length, nal_pps_length, idr_length, tmp_buf_length;
-
-  if (videoFrameTypeIDR == frame_info.eFrameType) {
-    GstMapInfo map;
-
-    /* sps */
-    nal_sps_data = frame_info.sLayerInfo[0].pBsBuf + 4;
-    nal_sps_length = frame_info.sLayerInfo[0].pNalLengthInByte[0] - 4;
-    /* pps */
-    nal_pps_data = nal_sps_data + frame_info.sLayerInfo[0].pNalLengthInByte[0];
-    nal_pps_length = frame_info.sLayerInfo[0].pNalLengthInByte[1] - 4;
-    /* idr */
-    bs_info = &frame_info.sLayerInfo[1];
-    idr_length = bs_info->pNalLengthInByte[0] - 4;
-
-    tmp_buf_length = nal_sps_length + 2 + nal_pps_length + 2 + idr_length + 2;
-    frame->output_buffer =
-        gst_video_encoder_allocate_output_buffer (encoder, tmp_buf_length);
-    gst_buffer_map (frame->output_buffer, &map, GST_MAP_WRITE);
-
-    GST_WRITE_UINT16_BE (map.data, nal_sps_length);
-    memcpy (map.data + 2, nal_sps_data, nal_sps_length);
+  if (videoFrameTypeIDR == frame_info.eFrameType)
+    GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
+  else
+    GST_VIDEO_CODEC_FRAME_UNSET_SYNC_POINT (frame);
 
-    GST_WRITE_UINT16_BE (map.data + nal_sps_length + 2, nal_pps_length);
-    memcpy (map.data + nal_sps_length + 2 + 2, nal_pps_data, nal_pps_length);
+  layer_ret = gst_openh264enc_push_layers (openh264enc, &frame_info, frame);
 
-    GST_WRITE_UINT16_BE (map.data + nal_sps_length + 2 + nal_pps_length + 2,
-        idr_length);
-    memcpy (map.data + nal_sps_length + 2 + nal_pps_length + 2 + 2,
-        bs_info->pBsBuf + 4, idr_length);
+  /* the full resolution layer, including the SPS and PPS for IDR frames */
+  spatial_id = openh264enc->n_layer_pads;
+  size = gst_openh264enc_write_layer (&frame_info, spatial_id, TRUE, NULL);
+  frame->output_buffer =
+      gst_video_encoder_allocate_output_buffer (encoder, size);
+  gst_buffer_map (frame->output_buffer, &map, GST_MAP_WRITE);
+  gst_openh264enc_write_layer (&frame_info, spatial_id, TRUE, map.data);
+  gst_buffer_unmap (frame->output_buffer, &map);
 
-    gst_buffer_unmap (frame->output_buffer, &map);
+  GST_LOG_OBJECT (openh264enc, "openh264 picture %scoded OK!",
+      (ret != cmResultSuccess) ? "NOT " : "");
 
-    GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
-  } else {
-    GstMapInfo map;
+  flow_ret = gst_video_encoder_finish_frame (encoder, frame);
+  if (flow_ret == GST_FLOW_OK)
+    flow_ret = layer_ret;
 
-    tmp_buf_length = nal_size + 2;
-    frame->output_buffer =
-        gst_video_encoder_allocate_output_buffer (encoder, tmp_buf_length);
-    gst_buffer_map (frame->output_buffer, &map, GST_MAP_WRITE);
+  return flow_ret;
+}
 
-    GST_WRITE_UINT16_BE (map.data, nal_size);
-    memcpy (map.data + 2, bs_info->pBsBuf + 4, nal_size);
+static gboolean
+gst_openh264enc_sink_event (GstVideoEncoder * encoder, GstEvent * event)
+{
+  GstOpenh264Enc *openh264enc = GST_OPENH264ENC (encoder);
+  GstEventType type = GST_EVENT_TYPE (event);
+  gboolean ret;
+  guint i;
+
+  switch (type) {
+    case GST_EVENT_SEGMENT:
+      gst_event_copy_segment (event, &openh264enc->layer_segment);
+      openh264enc->layer_segment_pending = TRUE;
+      break;
+    case GST_EVENT_FLUSH_START:
+    case GST_EVENT_FLUSH_STOP:
+      for (i = 0; i < openh264enc->n_layer_pads; i++)
+        gst_pad_push_event (openh264enc->layer_pads[i], gst_event_ref (event));
+      break;
+    default:
+      break;
+  }
 
-    gst_buffer_unmap (frame->output_buffer, &map);
+  ret =
+      GST_VIDEO_ENCODER_CLASS (gst_openh264enc_parent_class)->sink_event
+      (encoder, event);
 
-    GST_VIDEO_CODEC_FRAME_UNSET_SYNC_POINT (frame);
+  /* the base class drained the encoder by now */
+  if (type == GST_EVENT_EOS) {
+    for (i = 0; i < openh264enc->n_layer_pads; i++)
+      gst_pad_push_event (openh264enc->layer_pads[i], gst_event_new_eos ());
   }
 
-  GST_LOG_OBJECT (openh264enc, "openh264 picture %scoded OK!",
-      (ret != cmResultSuccess) ? "NOT " : "");
-
-  return gst_video_encoder_finish_frame (encoder, frame);
+  return ret;
 }
 
 static GstFlowReturn
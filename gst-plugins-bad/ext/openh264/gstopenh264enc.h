@@ -83,6 +83,13 @@ struct _GstOpenh264Enc
   SliceModeEnum slice_mode;
   guint num_slices;
   ECOMPLEXITY_MODE complexity;
+  guint spatial_layers;
+
+  /* pads for the spatial layers below the full resolution */
+  GstPad *layer_pads[MAX_SPATIAL_LAYER_NUM];
+  guint n_layer_pads;
+  GstSegment layer_segment;
+  gboolean layer_segment_pending;
 };
 
 struct _GstOpenh264EncClass
@@ -31,12 +31,33 @@
 GST_DEBUG_CATEGORY_STATIC (gst_openjpeg_dec_debug);
 #define GST_CAT_DEFAULT gst_openjpeg_dec_debug
 
+enum
+{
+  PROP_0,
+  PROP_MAX_THREADS
+};
+
+#define DEFAULT_MAX_THREADS 1
+
+/* the codestream is corrupt, as opposed to OpenJPEG failing to set up */
+#define GST_OPENJPEG_DEC_FLOW_DECODE_ERROR GST_FLOW_CUSTOM_ERROR
+
+typedef void (*GstOpenJPEGDecFillFrameFunc) (GstVideoFrame * frame,
+    opj_image_t * image);
+
+static void gst_openjpeg_dec_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_openjpeg_dec_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
 static gboolean gst_openjpeg_dec_start (GstVideoDecoder * decoder);
 static gboolean gst_openjpeg_dec_stop (GstVideoDecoder * decoder);
 static gboolean gst_openjpeg_dec_set_format (GstVideoDecoder * decoder,
     GstVideoCodecState * state);
 static GstFlowReturn gst_openjpeg_dec_handle_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame);
+static GstFlowReturn gst_openjpeg_dec_decode_parallel (GstVideoDecoder *
+    decoder, GstVideoCodecFrame * frame);
 static gboolean gst_openjpeg_dec_decide_allocation (GstVideoDecoder * decoder,
     GstQuery * query);
 
@@ -73,12 +94,31 @@ G_DEFINE_TYPE (GstOpenJPEGDec, gst_openjpeg_dec, GST_TYPE_VIDEO_DECODER);
 static void
 gst_openjpeg_dec_class_init (GstOpenJPEGDecClass * klass)
 {
+  GObjectClass *gobject_class;
   GstElementClass *element_class;
   GstVideoDecoderClass *video_decoder_class;
 
+  gobject_class = (GObjectClass *) klass;
   element_class = (GstElementClass *) klass;
   video_decoder_class = (GstVideoDecoderClass *) klass;
 
+  gobject_class->set_property = gst_openjpeg_dec_set_property;
+  gobject_class->get_property = gst_openjpeg_dec_get_property;
+
+  /**
+   * GstOpenJPEGDec:max-threads:
+   *
+   * Maximum number of frames decoded in parallel, each with its own
+   * OpenJPEG decoder. This adds up to one frame of latency per thread.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_int ("max-threads", "Maximum threads",
+          "Maximum number of frames decoded in parallel "
+          "(0 = one per processor)", 0, G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_openjpeg_dec_src_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -96,6 +136,8 @@ gst_openjpeg_dec_class_init (GstOpenJPEGDecClass * klass)
       GST_DEBUG_FUNCPTR (gst_openjpeg_dec_set_format);
   video_decoder_class->handle_frame =
       GST_DEBUG_FUNCPTR (gst_openjpeg_dec_handle_frame);
+  video_decoder_class->decode_parallel =
+      GST_DEBUG_FUNCPTR (gst_openjpeg_dec_decode_parallel);
   video_decoder_class->decide_allocation = gst_openjpeg_dec_decide_allocation;
 
   GST_DEBUG_CATEGORY_INIT (gst_openjpeg_dec_debug, "openjpegdec", 0,
@@ -116,6 +158,41 @@ gst_openjpeg_dec_init (GstOpenJPEGDec * self)
 #ifdef HAVE_OPENJPEG_1
   self->params.cp_limit_decoding = NO_LIMITATION;
 #endif
+  self->max_threads = DEFAULT_MAX_THREADS;
+}
+
+static void
+gst_openjpeg_dec_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstOpenJPEGDec *self = GST_OPENJPEG_DEC (object);
+
+  switch (prop_id) {
+    case PROP_MAX_THREADS:
+      self->max_threads = g_value_get_int (value);
+      gst_video_decoder_set_decode_threads (GST_VIDEO_DECODER (self),
+          self->max_threads);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_openjpeg_dec_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstOpenJPEGDec *self = GST_OPENJPEG_DEC (object);
+
+  switch (prop_id) {
+    case PROP_MAX_THREADS:
+      g_value_set_int (value, self->max_threads);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
 }
 
 static gboolean
@@ -653,12 +730,12 @@ get_highest_prec (opj_image_t * image)
   return ret;
 }
 
+/* Picks the output format for @image and the function to copy it into
+ * a frame of that format */
 static GstFlowReturn
-gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
+gst_openjpeg_dec_get_format (GstOpenJPEGDec * self, opj_image_t * image,
+    GstVideoFormat * format, GstOpenJPEGDecFillFrameFunc * fill_frame)
 {
-  GstVideoFormat format;
-  gint width, height;
-
   if (image->color_space == OPJ_CLRSPC_UNKNOWN || image->color_space == 0)
     image->color_space = self->color_space;
 
@@ -674,11 +751,11 @@ gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
         }
 
         if (get_highest_prec (image) == 8) {
-          self->fill_frame = fill_frame_packed8_4;
-          format = GST_VIDEO_FORMAT_ARGB;
+          *fill_frame = fill_frame_packed8_4;
+          *format = GST_VIDEO_FORMAT_ARGB;
         } else if (get_highest_prec (image) <= 16) {
-          self->fill_frame = fill_frame_packed16_4;
-          format = GST_VIDEO_FORMAT_ARGB64;
+          *fill_frame = fill_frame_packed16_4;
+          *format = GST_VIDEO_FORMAT_ARGB64;
         } else {
           GST_ERROR_OBJECT (self, "Unsupported depth %d", image->comps[3].prec);
           return GST_FLOW_NOT_NEGOTIATED;
@@ -692,11 +769,11 @@ gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
         }
 
         if (get_highest_prec (image) == 8) {
-          self->fill_frame = fill_frame_packed8_3;
-          format = GST_VIDEO_FORMAT_ARGB;
+          *fill_frame = fill_frame_packed8_3;
+          *format = GST_VIDEO_FORMAT_ARGB;
         } else if (get_highest_prec (image) <= 16) {
-          self->fill_frame = fill_frame_packed16_3;
-          format = GST_VIDEO_FORMAT_ARGB64;
+          *fill_frame = fill_frame_packed16_3;
+          *format = GST_VIDEO_FORMAT_ARGB64;
         } else {
           GST_ERROR_OBJECT (self, "Unsupported depth %d",
               get_highest_prec (image));
@@ -716,14 +793,14 @@ gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
         }
 
         if (get_highest_prec (image) == 8) {
-          self->fill_frame = fill_frame_planar8_1;
-          format = GST_VIDEO_FORMAT_GRAY8;
+          *fill_frame = fill_frame_planar8_1;
+          *format = GST_VIDEO_FORMAT_GRAY8;
         } else if (get_highest_prec (image) <= 16) {
-          self->fill_frame = fill_frame_planar16_1;
+          *fill_frame = fill_frame_planar16_1;
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-          format = GST_VIDEO_FORMAT_GRAY16_LE;
+          *format = GST_VIDEO_FORMAT_GRAY16_LE;
 #else
-          format = GST_VIDEO_FORMAT_GRAY16_BE;
+          *format = GST_VIDEO_FORMAT_GRAY16_BE;
 #endif
         } else {
           GST_ERROR_OBJECT (self, "Unsupported depth %d",
@@ -762,11 +839,11 @@ gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
         }
 
         if (get_highest_prec (image) == 8) {
-          self->fill_frame = fill_frame_planar8_4_generic;
-          format = GST_VIDEO_FORMAT_AYUV;
+          *fill_frame = fill_frame_planar8_4_generic;
+          *format = GST_VIDEO_FORMAT_AYUV;
         } else if (image->comps[3].prec <= 16) {
-          self->fill_frame = fill_frame_planar16_4_generic;
-          format = GST_VIDEO_FORMAT_AYUV64;
+          *fill_frame = fill_frame_planar16_4_generic;
+          *format = GST_VIDEO_FORMAT_AYUV64;
         } else {
           GST_ERROR_OBJECT (self, "Unsupported depth %d", image->comps[0].prec);
           return GST_FLOW_NOT_NEGOTIATED;
@@ -774,55 +851,55 @@ gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
       } else if (image->numcomps == 3) {
         if (get_highest_prec (image) == 8) {
           if (image->comps[1].dx == 1 && image->comps[1].dy == 1) {
-            self->fill_frame = fill_frame_planar8_3;
-            format = GST_VIDEO_FORMAT_Y444;
+            *fill_frame = fill_frame_planar8_3;
+            *format = GST_VIDEO_FORMAT_Y444;
           } else if (image->comps[1].dx == 2 && image->comps[1].dy == 1) {
-            self->fill_frame = fill_frame_planar8_3;
-            format = GST_VIDEO_FORMAT_Y42B;
+            *fill_frame = fill_frame_planar8_3;
+            *format = GST_VIDEO_FORMAT_Y42B;
           } else if (image->comps[1].dx == 2 && image->comps[1].dy == 2) {
-            self->fill_frame = fill_frame_planar8_3;
-            format = GST_VIDEO_FORMAT_I420;
+            *fill_frame = fill_frame_planar8_3;
+            *format = GST_VIDEO_FORMAT_I420;
           } else if (image->comps[1].dx == 4 && image->comps[1].dy == 1) {
-            self->fill_frame = fill_frame_planar8_3;
-            format = GST_VIDEO_FORMAT_Y41B;
+            *fill_frame = fill_frame_planar8_3;
+            *format = GST_VIDEO_FORMAT_Y41B;
           } else if (image->comps[1].dx == 4 && image->comps[1].dy == 4) {
-            self->fill_frame = fill_frame_planar8_3;
-            format = GST_VIDEO_FORMAT_YUV9;
+            *fill_frame = fill_frame_planar8_3;
+            *format = GST_VIDEO_FORMAT_YUV9;
           } else {
-            self->fill_frame = fill_frame_planar8_3_generic;
-            format = GST_VIDEO_FORMAT_AYUV;
+            *fill_frame = fill_frame_planar8_3_generic;
+            *format = GST_VIDEO_FORMAT_AYUV;
           }
         } else if (get_highest_prec (image) <= 16) {
           if (image->comps[0].prec == 10 &&
               image->comps[1].prec == 10 && image->comps[2].prec == 10) {
             if (image->comps[1].dx == 1 && image->comps[1].dy == 1) {
-              self->fill_frame = fill_frame_planar16_3;
+              *fill_frame = fill_frame_planar16_3;
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-              format = GST_VIDEO_FORMAT_Y444_10LE;
+              *format = GST_VIDEO_FORMAT_Y444_10LE;
 #else
-              format = GST_VIDEO_FORMAT_Y444_10BE;
+              *format = GST_VIDEO_FORMAT_Y444_10BE;
 #endif
             } else if (image->comps[1].dx == 2 && image->comps[1].dy == 1) {
-              self->fill_frame = fill_frame_planar16_3;
+              *fill_frame = fill_frame_planar16_3;
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-              format = GST_VIDEO_FORMAT_I422_10LE;
+              *format = GST_VIDEO_FORMAT_I422_10LE;
 #else
-              format = GST_VIDEO_FORMAT_I422_10BE;
+              *format = GST_VIDEO_FORMAT_I422_10BE;
 #endif
             } else if (image->comps[1].dx == 2 && image->comps[1].dy == 2) {
-              self->fill_frame = fill_frame_planar16_3;
+              *fill_frame = fill_frame_planar16_3;
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-              format = GST_VIDEO_FORMAT_I420_10LE;
+              *format = GST_VIDEO_FORMAT_I420_10LE;
 #else
-              format = GST_VIDEO_FORMAT_I420_10BE;
+              *format = GST_VIDEO_FORMAT_I420_10BE;
 #endif
             } else {
-              self->fill_frame = fill_frame_planar16_3_generic;
-              format = GST_VIDEO_FORMAT_AYUV64;
+              *fill_frame = fill_frame_planar16_3_generic;
+              *format = GST_VIDEO_FORMAT_AYUV64;
             }
           } else {
-            self->fill_frame = fill_frame_planar16_3_generic;
-            format = GST_VIDEO_FORMAT_AYUV64;
+            *fill_frame = fill_frame_planar16_3_generic;
+            *format = GST_VIDEO_FORMAT_AYUV64;
           }
         } else {
           GST_ERROR_OBJECT (self, "Unsupported depth %d",
@@ -840,6 +917,20 @@ gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
       return GST_FLOW_NOT_NEGOTIATED;
   }
 
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_openjpeg_dec_negotiate (GstOpenJPEGDec * self, opj_image_t * image)
+{
+  GstVideoFormat format;
+  gint width, height;
+  GstFlowReturn ret;
+
+  ret = gst_openjpeg_dec_get_format (self, image, &format, &self->fill_frame);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
   width = image->x1 - image->x0;
   height = image->y1 - image->y0;
 
@@ -950,13 +1041,14 @@ seek_fn (OPJ_OFF_T p_nb_bytes, void *p_user_data)
 }
 #endif
 
+/* Decodes the input buffer of @frame into a new image. Posts an error message
+ * if OpenJPEG can't be set up, and returns GST_OPENJPEG_DEC_FLOW_DECODE_ERROR
+ * without one if the data is corrupt. May be called from the decoding
+ * threads */
 static GstFlowReturn
-gst_openjpeg_dec_handle_frame (GstVideoDecoder * decoder,
-    GstVideoCodecFrame * frame)
+gst_openjpeg_dec_decode_image (GstOpenJPEGDec * self,
+    GstVideoCodecFrame * frame, opj_image_t ** image_out)
 {
-  GstOpenJPEGDec *self = GST_OPENJPEG_DEC (decoder);
-  GstFlowReturn ret = GST_FLOW_OK;
-  gint64 deadline;
   GstMapInfo map;
 #ifdef HAVE_OPENJPEG_1
   opj_dinfo_t *dec;
@@ -967,19 +1059,8 @@ gst_openjpeg_dec_handle_frame (GstVideoDecoder * decoder,
   MemStream mstream;
 #endif
   opj_image_t *image;
-  GstVideoFrame vframe;
   opj_dparameters_t params;
 
-  GST_DEBUG_OBJECT (self, "Handling frame");
-
-  deadline = gst_video_decoder_get_max_decode_time (decoder, frame);
-  if (deadline < 0) {
-    GST_LOG_OBJECT (self, "Dropping too late frame: deadline %" G_GINT64_FORMAT,
-        deadline);
-    ret = gst_video_decoder_drop_frame (decoder, frame);
-    return ret;
-  }
-
   dec = opj_create_decompress (self->codec_format);
   if (!dec)
     goto initialization_error;
@@ -1063,42 +1144,22 @@ gst_openjpeg_dec_handle_frame (GstVideoDecoder * decoder,
     }
   }
 
-  gst_buffer_unmap (frame->input_buffer, &map);
-
-  ret = gst_openjpeg_dec_negotiate (self, image);
-  if (ret != GST_FLOW_OK)
-    goto negotiate_error;
-
-  ret = gst_video_decoder_allocate_output_frame (decoder, frame);
-  if (ret != GST_FLOW_OK)
-    goto allocate_error;
-
-  if (!gst_video_frame_map (&vframe, &self->output_state->info,
-          frame->output_buffer, GST_MAP_WRITE))
-    goto map_write_error;
-
-  self->fill_frame (&vframe, image);
-
-  gst_video_frame_unmap (&vframe);
-
 #ifdef HAVE_OPENJPEG_1
   opj_cio_close (io);
-  opj_image_destroy (image);
   opj_destroy_decompress (dec);
 #else
   opj_end_decompress (dec, stream);
   opj_stream_destroy (stream);
-  opj_image_destroy (image);
   opj_destroy_codec (dec);
 #endif
+  gst_buffer_unmap (frame->input_buffer, &map);
 
-  ret = gst_video_decoder_finish_frame (decoder, frame);
+  *image_out = image;
 
-  return ret;
+  return GST_FLOW_OK;
 
 initialization_error:
   {
-    gst_video_codec_frame_unref (frame);
     GST_ELEMENT_ERROR (self, LIBRARY, INIT,
         ("Failed to initialize OpenJPEG decoder"), (NULL));
     return GST_FLOW_ERROR;
@@ -1110,7 +1171,6 @@ map_read_error:
 #else
     opj_destroy_codec (dec);
 #endif
-    gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, CORE, FAILED,
         ("Failed to map input buffer"), (NULL));
@@ -1124,7 +1184,6 @@ open_error:
     opj_destroy_codec (dec);
 #endif
     gst_buffer_unmap (frame->input_buffer, &map);
-    gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, LIBRARY, INIT,
         ("Failed to open OpenJPEG stream"), (NULL));
@@ -1142,6 +1201,63 @@ decode_error:
     opj_destroy_codec (dec);
 #endif
     gst_buffer_unmap (frame->input_buffer, &map);
+
+    return GST_OPENJPEG_DEC_FLOW_DECODE_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_openjpeg_dec_handle_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstOpenJPEGDec *self = GST_OPENJPEG_DEC (decoder);
+  GstFlowReturn ret = GST_FLOW_OK;
+  gint64 deadline;
+  opj_image_t *image;
+  GstVideoFrame vframe;
+
+  GST_DEBUG_OBJECT (self, "Handling frame");
+
+  deadline = gst_video_decoder_get_max_decode_time (decoder, frame);
+  if (deadline < 0) {
+    GST_LOG_OBJECT (self, "Dropping too late frame: deadline %" G_GINT64_FORMAT,
+        deadline);
+    ret = gst_video_decoder_drop_frame (decoder, frame);
+    return ret;
+  }
+
+  ret = gst_openjpeg_dec_decode_image (self, frame, &image);
+  if (ret == GST_OPENJPEG_DEC_FLOW_DECODE_ERROR)
+    goto decode_error;
+  else if (ret != GST_FLOW_OK) {
+    gst_video_codec_frame_unref (frame);
+    return ret;
+  }
+
+  ret = gst_openjpeg_dec_negotiate (self, image);
+  if (ret != GST_FLOW_OK)
+    goto negotiate_error;
+
+  ret = gst_video_decoder_allocate_output_frame (decoder, frame);
+  if (ret != GST_FLOW_OK)
+    goto allocate_error;
+
+  if (!gst_video_frame_map (&vframe, &self->output_state->info,
+          frame->output_buffer, GST_MAP_WRITE))
+    goto map_write_error;
+
+  self->fill_frame (&vframe, image);
+
+  gst_video_frame_unmap (&vframe);
+
+  opj_image_destroy (image);
+
+  ret = gst_video_decoder_finish_frame (decoder, frame);
+
+  return ret;
+
+decode_error:
+  {
     gst_video_codec_frame_unref (frame);
 
     GST_VIDEO_DECODER_ERROR (self, 1, STREAM, DECODE,
@@ -1151,13 +1267,6 @@ decode_error:
 negotiate_error:
   {
     opj_image_destroy (image);
-#ifdef HAVE_OPENJPEG_1
-    opj_cio_close (io);
-    opj_destroy_decompress (dec);
-#else
-    opj_stream_destroy (stream);
-    opj_destroy_codec (dec);
-#endif
     gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, CORE, NEGOTIATION,
@@ -1167,13 +1276,6 @@ negotiate_error:
 allocate_error:
   {
     opj_image_destroy (image);
-#ifdef HAVE_OPENJPEG_1
-    opj_cio_close (io);
-    opj_destroy_decompress (dec);
-#else
-    opj_stream_destroy (stream);
-    opj_destroy_codec (dec);
-#endif
     gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, CORE, FAILED,
@@ -1183,13 +1285,6 @@ allocate_error:
 map_write_error:
   {
     opj_image_destroy (image);
-#ifdef HAVE_OPENJPEG_1
-    opj_cio_close (io);
-    opj_destroy_decompress (dec);
-#else
-    opj_stream_destroy (stream);
-    opj_destroy_codec (dec);
-#endif
     gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, CORE, FAILED,
@@ -1198,6 +1293,55 @@ map_write_error:
   }
 }
 
+/* Called from the base class' decoding threads with an output buffer of the
+ * current output state already allocated. Images that need another format,
+ * and corrupt data, are handed to handle_frame() from the streaming thread,
+ * which renegotiates or reports the error */
+static GstFlowReturn
+gst_openjpeg_dec_decode_parallel (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstOpenJPEGDec *self = GST_OPENJPEG_DEC (decoder);
+  GstOpenJPEGDecFillFrameFunc fill_frame;
+  GstVideoCodecState *state;
+  GstVideoFormat format;
+  GstVideoFrame vframe;
+  opj_image_t *image;
+  GstFlowReturn ret;
+
+  ret = gst_openjpeg_dec_decode_image (self, frame, &image);
+  if (ret == GST_OPENJPEG_DEC_FLOW_DECODE_ERROR)
+    return GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+  else if (ret != GST_FLOW_OK)
+    return ret;
+
+  state = gst_video_decoder_get_output_state (decoder);
+  if (state == NULL ||
+      gst_openjpeg_dec_get_format (self, image, &format,
+          &fill_frame) != GST_FLOW_OK ||
+      format != GST_VIDEO_INFO_FORMAT (&state->info) ||
+      image->x1 - image->x0 != GST_VIDEO_INFO_WIDTH (&state->info) ||
+      image->y1 - image->y0 != GST_VIDEO_INFO_HEIGHT (&state->info) ||
+      !gst_video_frame_map (&vframe, &state->info, frame->output_buffer,
+          GST_MAP_WRITE)) {
+    GST_DEBUG_OBJECT (self, "can't decode frame %d in parallel",
+        frame->system_frame_number);
+    ret = GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+    goto done;
+  }
+
+  fill_frame (&vframe, image);
+
+  gst_video_frame_unmap (&vframe);
+
+done:
+  opj_image_destroy (image);
+  if (state)
+    gst_video_codec_state_unref (state);
+
+  return ret;
+}
+
 static gboolean
 gst_openjpeg_dec_decide_allocation (GstVideoDecoder * decoder, GstQuery * query)
 {
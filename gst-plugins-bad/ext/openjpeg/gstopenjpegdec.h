@@ -59,6 +59,7 @@ struct _GstOpenJPEGDec
   void (*fill_frame) (GstVideoFrame *frame, opj_image_t * image);
 
   opj_dparameters_t params;
+  gint max_threads;
 };
 
 struct _GstOpenJPEGDecClass
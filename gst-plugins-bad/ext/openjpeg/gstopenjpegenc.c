@@ -65,7 +65,9 @@ enum
   PROP_TILE_OFFSET_X,
   PROP_TILE_OFFSET_Y,
   PROP_TILE_WIDTH,
-  PROP_TILE_HEIGHT
+  PROP_TILE_HEIGHT,
+  PROP_NUM_STRIPES,
+  PROP_MAX_THREADS
 };
 
 #define DEFAULT_NUM_LAYERS 1
@@ -75,7 +77,18 @@ enum
 #define DEFAULT_TILE_OFFSET_Y 0
 #define DEFAULT_TILE_WIDTH 0
 #define DEFAULT_TILE_HEIGHT 0
+#define DEFAULT_NUM_STRIPES 1
+#define DEFAULT_MAX_THREADS 1
 
+typedef struct
+{
+  GstVideoCodecFrame *frame;
+  opj_cparameters_t params;
+  GstFlowReturn ret;
+  gboolean done;
+} GstOpenJPEGEncJob;
+
+static void gst_openjpeg_enc_finalize (GObject * object);
 static void gst_openjpeg_enc_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_openjpeg_enc_get_property (GObject * object, guint prop_id,
@@ -87,6 +100,10 @@ static gboolean gst_openjpeg_enc_set_format (GstVideoEncoder * encoder,
     GstVideoCodecState * state);
 static GstFlowReturn gst_openjpeg_enc_handle_frame (GstVideoEncoder * encoder,
     GstVideoCodecFrame * frame);
+static GstFlowReturn gst_openjpeg_enc_finish (GstVideoEncoder * encoder);
+static gboolean gst_openjpeg_enc_flush (GstVideoEncoder * encoder);
+static GstFlowReturn gst_openjpeg_enc_finish_jobs (GstOpenJPEGEnc * self,
+    guint max_pending, gboolean discard);
 static gboolean gst_openjpeg_enc_propose_allocation (GstVideoEncoder * encoder,
     GstQuery * query);
 
@@ -138,6 +155,7 @@ gst_openjpeg_enc_class_init (GstOpenJPEGEncClass * klass)
   element_class = (GstElementClass *) klass;
   video_encoder_class = (GstVideoEncoderClass *) klass;
 
+  gobject_class->finalize = gst_openjpeg_enc_finalize;
   gobject_class->set_property = gst_openjpeg_enc_set_property;
   gobject_class->get_property = gst_openjpeg_enc_get_property;
 
@@ -177,6 +195,35 @@ gst_openjpeg_enc_class_init (GstOpenJPEGEncClass * klass)
           "Tile Height", 0, G_MAXINT, DEFAULT_TILE_HEIGHT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstOpenJPEGEnc:num-stripes:
+   *
+   * Split the picture into this many full width tiles when no tile size
+   * is set, so that decoders can start outputting the top of the picture
+   * before the whole codestream is decoded.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_NUM_STRIPES,
+      g_param_spec_int ("num-stripes", "Number of stripes",
+          "Number of horizontal stripe tiles if no tile size is set",
+          1, G_MAXINT, DEFAULT_NUM_STRIPES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstOpenJPEGEnc:max-threads:
+   *
+   * Maximum number of frames encoded in parallel, each with its own
+   * OpenJPEG encoder. The frames are still output in order.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_int ("max-threads", "Maximum threads",
+          "Maximum number of frames encoded in parallel "
+          "(0 = one per processor)", 0, G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_openjpeg_enc_src_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -194,6 +241,8 @@ gst_openjpeg_enc_class_init (GstOpenJPEGEncClass * klass)
       GST_DEBUG_FUNCPTR (gst_openjpeg_enc_set_format);
   video_encoder_class->handle_frame =
       GST_DEBUG_FUNCPTR (gst_openjpeg_enc_handle_frame);
+  video_encoder_class->finish = GST_DEBUG_FUNCPTR (gst_openjpeg_enc_finish);
+  video_encoder_class->flush = GST_DEBUG_FUNCPTR (gst_openjpeg_enc_flush);
   video_encoder_class->propose_allocation = gst_openjpeg_enc_propose_allocation;
 
   GST_DEBUG_CATEGORY_INIT (gst_openjpeg_enc_debug, "openjpegenc", 0,
@@ -232,6 +281,24 @@ gst_openjpeg_enc_init (GstOpenJPEGEnc * self)
   self->params.cp_tdy = DEFAULT_TILE_HEIGHT;
   self->params.tile_size_on = (self->params.cp_tdx != 0
       && self->params.cp_tdy != 0);
+
+  self->num_stripes = DEFAULT_NUM_STRIPES;
+  self->max_threads = DEFAULT_MAX_THREADS;
+
+  g_queue_init (&self->encode_jobs);
+  g_mutex_init (&self->encode_lock);
+  g_cond_init (&self->encode_cond);
+}
+
+static void
+gst_openjpeg_enc_finalize (GObject * object)
+{
+  GstOpenJPEGEnc *self = GST_OPENJPEG_ENC (object);
+
+  g_mutex_clear (&self->encode_lock);
+  g_cond_clear (&self->encode_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 static void
@@ -266,6 +333,12 @@ gst_openjpeg_enc_set_property (GObject * object, guint prop_id,
       self->params.tile_size_on = (self->params.cp_tdx != 0
           && self->params.cp_tdy != 0);
       break;
+    case PROP_NUM_STRIPES:
+      self->num_stripes = g_value_get_int (value);
+      break;
+    case PROP_MAX_THREADS:
+      g_atomic_int_set (&self->max_threads, g_value_get_int (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -300,6 +373,12 @@ gst_openjpeg_enc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_TILE_HEIGHT:
       g_value_set_int (value, self->params.cp_tdy);
       break;
+    case PROP_NUM_STRIPES:
+      g_value_set_int (value, self->num_stripes);
+      break;
+    case PROP_MAX_THREADS:
+      g_value_set_int (value, g_atomic_int_get (&self->max_threads));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -323,6 +402,12 @@ gst_openjpeg_enc_stop (GstVideoEncoder * video_encoder)
 
   GST_DEBUG_OBJECT (self, "Stopping");
 
+  gst_openjpeg_enc_finish_jobs (self, 0, TRUE);
+  if (self->encode_pool) {
+    g_thread_pool_free (self->encode_pool, FALSE, TRUE);
+    self->encode_pool = NULL;
+  }
+
   if (self->output_state) {
     gst_video_codec_state_unref (self->output_state);
     self->output_state = NULL;
@@ -562,6 +647,9 @@ gst_openjpeg_enc_set_format (GstVideoEncoder * encoder,
 
   GST_DEBUG_OBJECT (self, "Setting format: %" GST_PTR_FORMAT, state->caps);
 
+  /* the pending frames are encoded with the previous format */
+  gst_openjpeg_enc_finish_jobs (self, 0, FALSE);
+
   if (self->input_state)
     gst_video_codec_state_unref (self->input_state);
   self->input_state = gst_video_codec_state_ref (state);
@@ -797,12 +885,12 @@ seek_fn (OPJ_OFF_T p_nb_bytes, void *p_user_data)
 }
 #endif
 
+/* Encodes @frame into its output buffer with @params. Called from the
+ * encoding threads, so must not take the stream lock */
 static GstFlowReturn
-gst_openjpeg_enc_handle_frame (GstVideoEncoder * encoder,
-    GstVideoCodecFrame * frame)
+gst_openjpeg_enc_encode_frame (GstOpenJPEGEnc * self,
+    GstVideoCodecFrame * frame, opj_cparameters_t * params)
 {
-  GstOpenJPEGEnc *self = GST_OPENJPEG_ENC (encoder);
-  GstFlowReturn ret = GST_FLOW_OK;
 #ifdef HAVE_OPENJPEG_1
   opj_cinfo_t *enc;
   GstMapInfo map;
@@ -816,7 +904,7 @@ gst_openjpeg_enc_handle_frame (GstVideoEncoder * encoder,
   opj_image_t *image;
   GstVideoFrame vframe;
 
-  GST_DEBUG_OBJECT (self, "Handling frame");
+  GST_DEBUG_OBJECT (self, "Encoding frame %d", frame->system_frame_number);
 
   enc = opj_create_compress (self->codec_format);
   if (!enc)
@@ -856,7 +944,7 @@ gst_openjpeg_enc_handle_frame (GstVideoEncoder * encoder,
     goto fill_image_error;
   gst_video_frame_unmap (&vframe);
 
-  opj_setup_encoder (enc, &self->params, image);
+  opj_setup_encoder (enc, params, image);
 
 #ifdef HAVE_OPENJPEG_1
   io = opj_cio_open ((opj_common_ptr) enc, NULL, 0);
@@ -870,11 +958,9 @@ gst_openjpeg_enc_handle_frame (GstVideoEncoder * encoder,
 
   length = cio_tell (io);
 
-  ret =
-      gst_video_encoder_allocate_output_frame (encoder, frame,
-      length + (self->is_jp2c ? 8 : 0));
-  if (ret != GST_FLOW_OK)
-    goto allocate_error;
+  /* not allocated from the base class, which would take the stream lock */
+  frame->output_buffer =
+      gst_buffer_new_allocate (NULL, length + (self->is_jp2c ? 8 : 0), NULL);
 
   gst_buffer_fill (frame->output_buffer, self->is_jp2c ? 8 : 0, io->buffer,
       length);
@@ -940,14 +1026,10 @@ gst_openjpeg_enc_handle_frame (GstVideoEncoder * encoder,
           mstream.size, NULL, (GDestroyNotify) g_free));
 #endif
 
-  GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
-  ret = gst_video_encoder_finish_frame (encoder, frame);
-
-  return ret;
+  return GST_FLOW_OK;
 
 initialization_error:
   {
-    gst_video_codec_frame_unref (frame);
     GST_ELEMENT_ERROR (self, LIBRARY, INIT,
         ("Failed to initialize OpenJPEG encoder"), (NULL));
     return GST_FLOW_ERROR;
@@ -959,7 +1041,6 @@ map_read_error:
 #else
     opj_destroy_codec (enc);
 #endif
-    gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, CORE, FAILED,
         ("Failed to map input buffer"), (NULL));
@@ -973,7 +1054,6 @@ fill_image_error:
     opj_destroy_codec (enc);
 #endif
     gst_video_frame_unmap (&vframe);
-    gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, LIBRARY, INIT,
         ("Failed to fill OpenJPEG image"), (NULL));
@@ -987,7 +1067,6 @@ open_error:
 #else
     opj_destroy_codec (enc);
 #endif
-    gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, LIBRARY, INIT,
         ("Failed to open OpenJPEG data"), (NULL));
@@ -1005,24 +1084,171 @@ encode_error:
     opj_image_destroy (image);
     opj_destroy_codec (enc);
 #endif
-    gst_video_codec_frame_unref (frame);
 
     GST_ELEMENT_ERROR (self, STREAM, ENCODE,
         ("Failed to encode OpenJPEG stream"), (NULL));
     return GST_FLOW_ERROR;
   }
-#ifdef HAVE_OPENJPEG_1
-allocate_error:
-  {
-    opj_cio_close (io);
-    opj_destroy_compress (enc);
-    gst_video_codec_frame_unref (frame);
+}
 
-    GST_ELEMENT_ERROR (self, CORE, FAILED,
-        ("Failed to allocate output buffer"), (NULL));
-    return ret;
+static void
+gst_openjpeg_enc_init_job (GstOpenJPEGEnc * self, GstOpenJPEGEncJob * job,
+    GstVideoCodecFrame * frame)
+{
+  job->frame = frame;
+  job->params = self->params;
+  job->ret = GST_FLOW_OK;
+  job->done = FALSE;
+
+  if (self->num_stripes > 1 && !job->params.tile_size_on) {
+    GstVideoInfo *info = &self->input_state->info;
+
+    job->params.tile_size_on = TRUE;
+    job->params.cp_tx0 = 0;
+    job->params.cp_ty0 = 0;
+    job->params.cp_tdx = GST_VIDEO_INFO_WIDTH (info);
+    job->params.cp_tdy = (GST_VIDEO_INFO_HEIGHT (info) + self->num_stripes -
+        1) / self->num_stripes;
   }
-#endif
+}
+
+static void
+gst_openjpeg_enc_encode_job (GstOpenJPEGEncJob * job, GstOpenJPEGEnc * self)
+{
+  GstFlowReturn ret;
+
+  ret = gst_openjpeg_enc_encode_frame (self, job->frame, &job->params);
+
+  g_mutex_lock (&self->encode_lock);
+  job->ret = ret;
+  job->done = TRUE;
+  g_cond_broadcast (&self->encode_cond);
+  g_mutex_unlock (&self->encode_lock);
+}
+
+/* Consumes the frame of a finished @job */
+static GstFlowReturn
+gst_openjpeg_enc_finish_job (GstOpenJPEGEnc * self, GstOpenJPEGEncJob * job,
+    gboolean discard)
+{
+  if (discard || job->ret != GST_FLOW_OK) {
+    gst_video_codec_frame_unref (job->frame);
+    return discard ? GST_FLOW_OK : job->ret;
+  }
+
+  GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (job->frame);
+  return gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (self), job->frame);
+}
+
+/* Finishes the frames encoded by the thread pool in input order, waiting
+ * until at most @max_pending frames are still being encoded. With @discard
+ * the frames are dropped instead of being pushed */
+static GstFlowReturn
+gst_openjpeg_enc_finish_jobs (GstOpenJPEGEnc * self, guint max_pending,
+    gboolean discard)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&self->encode_lock);
+  while (self->encode_jobs.length > 0) {
+    GstOpenJPEGEncJob *job = g_queue_peek_head (&self->encode_jobs);
+    GstFlowReturn res;
+
+    if (!job->done) {
+      if (self->encode_jobs.length <= max_pending)
+        break;
+      g_cond_wait (&self->encode_cond, &self->encode_lock);
+      continue;
+    }
+    g_queue_pop_head (&self->encode_jobs);
+    g_mutex_unlock (&self->encode_lock);
+
+    res = gst_openjpeg_enc_finish_job (self, job, discard);
+    g_slice_free (GstOpenJPEGEncJob, job);
+
+    if (ret == GST_FLOW_OK)
+      ret = res;
+
+    g_mutex_lock (&self->encode_lock);
+  }
+  g_mutex_unlock (&self->encode_lock);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_openjpeg_enc_handle_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstOpenJPEGEnc *self = GST_OPENJPEG_ENC (encoder);
+  GstOpenJPEGEncJob *job;
+  GstFlowReturn ret;
+  gint n_threads;
+
+  GST_DEBUG_OBJECT (self, "Handling frame");
+
+  n_threads = g_atomic_int_get (&self->max_threads);
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  if (n_threads == 1) {
+    GstOpenJPEGEncJob sync_job;
+
+    /* frames before this one might still be encoding in parallel */
+    ret = gst_openjpeg_enc_finish_jobs (self, 0, FALSE);
+    if (ret != GST_FLOW_OK) {
+      gst_video_codec_frame_unref (frame);
+      return ret;
+    }
+
+    gst_openjpeg_enc_init_job (self, &sync_job, frame);
+    sync_job.ret = gst_openjpeg_enc_encode_frame (self, frame,
+        &sync_job.params);
+
+    return gst_openjpeg_enc_finish_job (self, &sync_job, FALSE);
+  }
+
+  if (self->encode_pool == NULL) {
+    self->encode_pool =
+        g_thread_pool_new ((GFunc) gst_openjpeg_enc_encode_job, self,
+        n_threads, FALSE, NULL);
+  } else if (g_thread_pool_get_max_threads (self->encode_pool) != n_threads) {
+    g_thread_pool_set_max_threads (self->encode_pool, n_threads, NULL);
+  }
+
+  job = g_slice_new (GstOpenJPEGEncJob);
+  gst_openjpeg_enc_init_job (self, job, frame);
+
+  g_mutex_lock (&self->encode_lock);
+  g_queue_push_tail (&self->encode_jobs, job);
+  g_mutex_unlock (&self->encode_lock);
+
+  g_thread_pool_push (self->encode_pool, job, NULL);
+
+  /* push out what is done and keep at most one frame per thread queued */
+  return gst_openjpeg_enc_finish_jobs (self, n_threads, FALSE);
+}
+
+static GstFlowReturn
+gst_openjpeg_enc_finish (GstVideoEncoder * encoder)
+{
+  GstOpenJPEGEnc *self = GST_OPENJPEG_ENC (encoder);
+
+  GST_DEBUG_OBJECT (self, "Draining");
+
+  return gst_openjpeg_enc_finish_jobs (self, 0, FALSE);
+}
+
+static gboolean
+gst_openjpeg_enc_flush (GstVideoEncoder * encoder)
+{
+  GstOpenJPEGEnc *self = GST_OPENJPEG_ENC (encoder);
+
+  GST_DEBUG_OBJECT (self, "Flushing");
+
+  gst_openjpeg_enc_finish_jobs (self, 0, TRUE);
+
+  return TRUE;
 }
 
 static gboolean
@@ -57,6 +57,14 @@ struct _GstOpenJPEGEnc
   void (*fill_image) (opj_image_t * image, GstVideoFrame *frame);
 
   opj_cparameters_t params;
+  gint num_stripes;
+  gint max_threads;
+
+  /* frames being encoded by the thread pool, in input order */
+  GThreadPool *encode_pool;
+  GQueue encode_jobs;
+  GMutex encode_lock;
+  GCond encode_cond;
 };
 
 struct _GstOpenJPEGEncClass
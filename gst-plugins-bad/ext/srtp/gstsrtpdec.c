@@ -209,6 +209,10 @@ static GstFlowReturn gst_srtp_dec_chain_rtp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
 static GstFlowReturn gst_srtp_dec_chain_rtcp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
+static GstFlowReturn gst_srtp_dec_chain_list_rtp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
+static GstFlowReturn gst_srtp_dec_chain_list_rtcp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
 
 static GstStateChangeReturn gst_srtp_dec_change_state (GstElement * element,
     GstStateChange transition);
@@ -369,6 +373,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtp));
   gst_pad_set_chain_function (filter->rtp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtp));
+  gst_pad_set_chain_list_function (filter->rtp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtp));
 
   filter->rtp_srcpad =
       gst_pad_new_from_static_template (&rtp_src_template, "rtp_src");
@@ -392,6 +398,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtcp));
   gst_pad_set_chain_function (filter->rtcp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtcp));
+  gst_pad_set_chain_list_function (filter->rtcp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtcp));
 
   filter->rtcp_srcpad =
       gst_pad_new_from_static_template (&rtcp_src_template, "rtcp_src");
@@ -1088,22 +1096,24 @@ gst_srtp_dec_push_early_events (GstSrtpDec * filter, GstPad * pad,
 }
 
 /*
- * This function should be called while holding the filter lock
+ * This function should be called while holding the filter lock, *buf is
+ * replaced if it was not writable
  */
 static gboolean
-gst_srtp_dec_decode_buffer (GstSrtpDec * filter, GstPad * pad, GstBuffer * buf,
-    gboolean is_rtcp, guint32 ssrc)
+gst_srtp_dec_decode_buffer (GstSrtpDec * filter, GstPad * pad,
+    GstBuffer ** bufp, gboolean is_rtcp, guint32 ssrc)
 {
+  GstBuffer *buf;
   GstMapInfo map;
   err_status_t err;
   gint size;
 
   GST_LOG_OBJECT (pad, "Received %s buffer of size %" G_GSIZE_FORMAT
-      " with SSRC = %u", is_rtcp ? "RTCP" : "RTP", gst_buffer_get_size (buf),
+      " with SSRC = %u", is_rtcp ? "RTCP" : "RTP", gst_buffer_get_size (*bufp),
       ssrc);
 
-  /* Change buffer to remove protection */
-  buf = gst_buffer_make_writable (buf);
+  /* Change buffer to remove protection, this is done in place */
+  buf = *bufp = gst_buffer_make_writable (*bufp);
 
   gst_buffer_map (buf, &map, GST_MAP_READWRITE);
   size = map.size;
@@ -1142,9 +1152,9 @@ unprotect:
     err = srtp_unprotect (filter->session, map.data, &size);
   }
 
-  GST_OBJECT_UNLOCK (filter);
-
   if (err != err_status_ok) {
+    GST_OBJECT_UNLOCK (filter);
+
     GST_WARNING_OBJECT (pad,
         "Unable to unprotect buffer (unprotect failed code %d)", err);
 
@@ -1189,10 +1199,26 @@ unprotect:
 
   gst_buffer_set_size (buf, size);
 
-  GST_OBJECT_LOCK (filter);
   return TRUE;
 }
 
+/* the source pad for @is_rtcp packets, with the early events sent */
+static GstPad *
+gst_srtp_dec_get_src_pad (GstSrtpDec * filter, gboolean is_rtcp)
+{
+  if (is_rtcp) {
+    if (!filter->rtcp_has_segment)
+      gst_srtp_dec_push_early_events (filter, filter->rtcp_srcpad,
+          filter->rtp_srcpad, TRUE);
+    return filter->rtcp_srcpad;
+  } else {
+    if (!filter->rtp_has_segment)
+      gst_srtp_dec_push_early_events (filter, filter->rtp_srcpad,
+          filter->rtcp_srcpad, FALSE);
+    return filter->rtp_srcpad;
+  }
+}
+
 static GstFlowReturn
 gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
     gboolean is_rtcp)
@@ -1218,7 +1244,7 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
     goto push_out;
   }
 
-  if (!gst_srtp_dec_decode_buffer (filter, pad, buf, is_rtcp, ssrc)) {
+  if (!gst_srtp_dec_decode_buffer (filter, pad, &buf, is_rtcp, ssrc)) {
     GST_OBJECT_UNLOCK (filter);
     goto drop_buffer;
   }
@@ -1231,17 +1257,7 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
 
 push_out:
   /* Push buffer to source pad */
-  if (is_rtcp) {
-    otherpad = filter->rtcp_srcpad;
-    if (!filter->rtcp_has_segment)
-      gst_srtp_dec_push_early_events (filter, filter->rtcp_srcpad,
-          filter->rtp_srcpad, TRUE);
-  } else {
-    otherpad = filter->rtp_srcpad;
-    if (!filter->rtp_has_segment)
-      gst_srtp_dec_push_early_events (filter, filter->rtp_srcpad,
-          filter->rtcp_srcpad, FALSE);
-  }
+  otherpad = gst_srtp_dec_get_src_pad (filter, is_rtcp);
   ret = gst_pad_push (otherpad, buf);
 
   return ret;
@@ -1254,6 +1270,117 @@ drop_buffer:
   return ret;
 }
 
+typedef struct
+{
+  GstSrtpDec *filter;
+  GstPad *pad;
+  gboolean is_rtcp;
+  /* packets of the other kind, e.g. muxed RTCP on the RTP pad */
+  GstBufferList *other_list;
+  /* SSRCs that reached the soft key limit */
+  GArray *soft_limit_ssrcs;
+} DecodeBufferItData;
+
+/* called with the filter lock */
+static gboolean
+decode_buffer_it (GstBuffer ** buffer, guint index, gpointer user_data)
+{
+  DecodeBufferItData *data = user_data;
+  GstSrtpDec *filter = data->filter;
+  GstSrtpDecSsrcStream *stream;
+  gboolean is_rtcp = data->is_rtcp;
+  guint32 ssrc = 0;
+
+  if (!(stream = validate_buffer (filter, *buffer, &ssrc, &is_rtcp))) {
+    GST_WARNING_OBJECT (filter, "Invalid buffer, dropping");
+    goto drop;
+  }
+
+  if (STREAM_HAS_CRYPTO (stream)) {
+    gst_srtp_init_event_reporter ();
+
+    if (!gst_srtp_dec_decode_buffer (filter, data->pad, buffer, is_rtcp, ssrc))
+      goto drop;
+
+    if (gst_srtp_get_soft_limit_reached ())
+      g_array_append_val (data->soft_limit_ssrcs, ssrc);
+  }
+
+  if (is_rtcp != data->is_rtcp) {
+    if (data->other_list == NULL)
+      data->other_list = gst_buffer_list_new ();
+    gst_buffer_list_add (data->other_list, *buffer);
+    *buffer = NULL;
+  }
+
+  return TRUE;
+
+drop:
+  gst_buffer_unref (*buffer);
+  *buffer = NULL;
+  return TRUE;
+}
+
+/* decodes the whole list in place, with one lock unless keys need to be
+ * changed */
+static GstFlowReturn
+gst_srtp_dec_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list, gboolean is_rtcp)
+{
+  GstSrtpDec *filter = GST_SRTP_DEC (parent);
+  DecodeBufferItData data;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i;
+
+  buf_list = gst_buffer_list_make_writable (buf_list);
+
+  data.filter = filter;
+  data.pad = pad;
+  data.is_rtcp = is_rtcp;
+  data.other_list = NULL;
+  data.soft_limit_ssrcs = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+  GST_OBJECT_LOCK (filter);
+  gst_buffer_list_foreach (buf_list, decode_buffer_it, &data);
+  GST_OBJECT_UNLOCK (filter);
+
+  for (i = 0; i < data.soft_limit_ssrcs->len; i++)
+    request_key_with_signal (filter,
+        g_array_index (data.soft_limit_ssrcs, guint32, i), SIGNAL_SOFT_LIMIT);
+  g_array_free (data.soft_limit_ssrcs, TRUE);
+
+  if (data.other_list)
+    ret = gst_pad_push_list (gst_srtp_dec_get_src_pad (filter, !is_rtcp),
+        data.other_list);
+
+  if (gst_buffer_list_length (buf_list) > 0) {
+    GstFlowReturn push_ret;
+
+    push_ret = gst_pad_push_list (gst_srtp_dec_get_src_pad (filter, is_rtcp),
+        buf_list);
+    if (ret == GST_FLOW_OK)
+      ret = push_ret;
+  } else {
+    gst_buffer_list_unref (buf_list);
+  }
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, FALSE);
+}
+
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtcp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, TRUE);
+}
+
 static GstFlowReturn
 gst_srtp_dec_chain_rtp (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
@@ -162,12 +162,15 @@ enum
   PROP_ALLOW_REPEAT_TX
 };
 
+/* room needed after the packet for the SRTP trailer */
+#define SRTP_TRAILER_ROOM (SRTP_MAX_TRAILER_LEN + 10)
+
 typedef struct ProcessBufferItData
 {
   GstSrtpEnc *filter;
   GstPad *pad;
-  GstBufferList *out_list;
   gboolean is_rtcp;
+  err_status_t err;
 } ProcessBufferItData;
 
 /* the capabilities of the inputs and outputs.
@@ -884,6 +887,32 @@ gst_srtp_enc_sink_query (GstPad * pad, GstObject * parent, GstQuery * query,
 
       return TRUE;
     }
+    case GST_QUERY_ALLOCATION:
+    {
+      GstAllocationParams params;
+      GstAllocator *allocator;
+      guint i, n;
+
+      gst_pad_peer_query (get_rtp_other_pad (pad), query);
+
+      /* ask for room behind the packets, so that they can be protected
+       * without copying */
+      n = gst_query_get_n_allocation_params (query);
+      for (i = 0; i < n; i++) {
+        gst_query_parse_nth_allocation_param (query, i, &allocator, &params);
+        params.padding += SRTP_TRAILER_ROOM;
+        gst_query_set_nth_allocation_param (query, i, allocator, &params);
+        if (allocator)
+          gst_object_unref (allocator);
+      }
+      if (n == 0) {
+        gst_allocation_params_init (&params);
+        params.padding = SRTP_TRAILER_ROOM;
+        gst_query_add_allocation_param (query, NULL, &params);
+      }
+
+      return TRUE;
+    }
     default:
       return gst_pad_query_default (pad, parent, query);
   }
@@ -1006,64 +1035,103 @@ gst_srtp_enc_check_set_caps (GstSrtpEnc * filter, GstPad * pad,
   return GST_FLOW_OK;
 }
 
+/* TRUE if @buf can be protected without copying, i.e. it is one writable
+ * memory with enough room for the trailer behind the data */
+static gboolean
+gst_srtp_enc_can_protect_in_place (GstBuffer * buf)
+{
+  GstMemory *mem;
+  gsize size, offset, maxsize;
+
+  if (!gst_buffer_is_writable (buf) || gst_buffer_n_memory (buf) != 1)
+    return FALSE;
+
+  mem = gst_buffer_peek_memory (buf, 0);
+  if (!gst_memory_is_writable (mem))
+    return FALSE;
+
+  size = gst_memory_get_sizes (mem, &offset, &maxsize);
+
+  return maxsize - offset - size >= SRTP_TRAILER_ROOM;
+}
+
+/*
+ * Takes ownership of @buf and returns the protected buffer, or NULL with
+ * @err set if protecting failed.
+ * This function should be called while holding the filter lock
+ */
 static GstBuffer *
 gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
-    GstBuffer * buf, gboolean is_rtcp)
+    GstBuffer * buf, gboolean is_rtcp, err_status_t * err)
 {
-  gint size_max, size;
-  GstBuffer *bufout = NULL;
+  gint size;
+  GstBuffer *bufout;
   GstMapInfo mapout;
-  err_status_t err;
 
-  /* Create a bigger buffer to add protection */
   size = gst_buffer_get_size (buf);
-  size_max = size + SRTP_MAX_TRAILER_LEN + 10;
-  bufout = gst_buffer_new_allocate (NULL, size_max, NULL);
-
-  gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
-
-  gst_buffer_extract (buf, 0, mapout.data, size);
 
-  GST_OBJECT_LOCK (filter);
-
-  gst_srtp_init_event_reporter ();
+  if (gst_srtp_enc_can_protect_in_place (buf)) {
+    /* grow into the padding behind the data */
+    bufout = buf;
+    gst_buffer_set_size (bufout, size + SRTP_TRAILER_ROOM);
+    gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
+  } else {
+    /* Create a bigger buffer to add protection */
+    bufout = gst_buffer_new_allocate (NULL, size + SRTP_TRAILER_ROOM, NULL);
+    gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
+    gst_buffer_extract (buf, 0, mapout.data, size);
+    gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+    gst_buffer_unref (buf);
+  }
 
   if (is_rtcp)
-    err = srtp_protect_rtcp (filter->session, mapout.data, &size);
+    *err = srtp_protect_rtcp (filter->session, mapout.data, &size);
   else
-    err = srtp_protect (filter->session, mapout.data, &size);
-
-  GST_OBJECT_UNLOCK (filter);
+    *err = srtp_protect (filter->session, mapout.data, &size);
 
   gst_buffer_unmap (bufout, &mapout);
 
-  if (err == err_status_ok) {
-    /* Buffer protected */
-    gst_buffer_set_size (bufout, size);
-    gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+  if (*err != err_status_ok) {
+    gst_buffer_unref (bufout);
+    return NULL;
+  }
 
-    GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d",
-        is_rtcp ? "RTCP" : "RTP", size);
+  /* Buffer protected */
+  gst_buffer_set_size (bufout, size);
 
-  } else if (err == err_status_key_expired) {
+  GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d",
+      is_rtcp ? "RTCP" : "RTP", size);
 
+  return bufout;
+}
+
+static void
+gst_srtp_enc_post_protect_error (GstSrtpEnc * filter, err_status_t err)
+{
+  if (err == err_status_key_expired) {
     GST_ELEMENT_ERROR (GST_ELEMENT_CAST (filter), STREAM, ENCODE,
         ("Key usage limit has been reached"),
         ("Unable to protect buffer (hard key usage limit reached)"));
-    goto fail;
-
   } else {
     /* srtp_protect failed */
     GST_ELEMENT_ERROR (filter, LIBRARY, FAILED, (NULL),
         ("Unable to protect buffer (protect failed) code %d", err));
-    goto fail;
   }
+}
 
-  return bufout;
+/* called with the filter lock, which is released */
+static void
+gst_srtp_enc_check_soft_limit (GstSrtpEnc * filter)
+{
+  if (gst_srtp_get_soft_limit_reached ()) {
+    GST_OBJECT_UNLOCK (filter);
+    g_signal_emit (filter, gst_srtp_enc_signals[SIGNAL_SOFT_LIMIT], 0);
+    GST_OBJECT_LOCK (filter);
+    if (filter->random_key && !filter->key_changed)
+      gst_srtp_enc_replace_random_key (filter);
+  }
 
-fail:
-  gst_buffer_unref (bufout);
-  return NULL;
+  GST_OBJECT_UNLOCK (filter);
 }
 
 static GstFlowReturn
@@ -1074,71 +1142,55 @@ gst_srtp_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
   GstFlowReturn ret = GST_FLOW_OK;
   GstPad *otherpad;
   GstBuffer *bufout = NULL;
+  err_status_t err;
 
   if ((ret = gst_srtp_enc_check_set_caps (filter, pad, is_rtcp)) != GST_FLOW_OK) {
-    goto out;
+    gst_buffer_unref (buf);
+    return ret;
   }
 
+  otherpad = get_rtp_other_pad (pad);
+
   GST_OBJECT_LOCK (filter);
 
   if (!HAS_CRYPTO (filter)) {
     GST_OBJECT_UNLOCK (filter);
-    otherpad = get_rtp_other_pad (pad);
     return gst_pad_push (otherpad, buf);
   }
 
-  GST_OBJECT_UNLOCK (filter);
+  gst_srtp_init_event_reporter ();
+  bufout = gst_srtp_enc_process_buffer (filter, pad, buf, is_rtcp, &err);
 
-  if ((bufout = gst_srtp_enc_process_buffer (filter, pad, buf, is_rtcp))) {
-    /* Push buffer to source pad */
-    otherpad = get_rtp_other_pad (pad);
-    ret = gst_pad_push (otherpad, bufout);
-    bufout = NULL;
+  GST_OBJECT_UNLOCK (filter);
 
-    if (ret != GST_FLOW_OK)
-      goto out;
-  } else {
+  if (bufout == NULL)
     goto fail;
-  }
 
-  GST_OBJECT_LOCK (filter);
-
-  if (gst_srtp_get_soft_limit_reached ()) {
-    GST_OBJECT_UNLOCK (filter);
-    g_signal_emit (filter, gst_srtp_enc_signals[SIGNAL_SOFT_LIMIT], 0);
-    GST_OBJECT_LOCK (filter);
-    if (filter->random_key && !filter->key_changed)
-      gst_srtp_enc_replace_random_key (filter);
-  }
-
-  GST_OBJECT_UNLOCK (filter);
-
-out:
+  /* Push buffer to source pad */
+  ret = gst_pad_push (otherpad, bufout);
+  if (ret != GST_FLOW_OK)
+    return ret;
 
-  gst_buffer_unref (buf);
+  GST_OBJECT_LOCK (filter);
+  gst_srtp_enc_check_soft_limit (filter);
 
   return ret;
 
 fail:
-  ret = GST_FLOW_ERROR;
-  goto out;
+  gst_srtp_enc_post_protect_error (filter, err);
+  return GST_FLOW_ERROR;
 }
 
 static gboolean
 process_buffer_it (GstBuffer ** buffer, guint index, gpointer user_data)
 {
   ProcessBufferItData *data = user_data;
-  GstBuffer *bufout;
 
-  if ((bufout =
-          gst_srtp_enc_process_buffer (data->filter, data->pad, *buffer,
-              data->is_rtcp))) {
-    gst_buffer_list_add (data->out_list, bufout);
-  } else {
-    GST_WARNING_OBJECT (data->filter, "Error encoding buffer, dropping");
-  }
+  *buffer = gst_srtp_enc_process_buffer (data->filter, data->pad, *buffer,
+      data->is_rtcp, &data->err);
 
-  return TRUE;
+  /* never let unprotected packets through after an error */
+  return *buffer != NULL;
 }
 
 static GstFlowReturn
@@ -1148,7 +1200,6 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
   GstSrtpEnc *filter = GST_SRTP_ENC (parent);
   GstFlowReturn ret = GST_FLOW_OK;
   GstPad *otherpad;
-  GstBufferList *out_list = NULL;
   ProcessBufferItData process_data;
 
   GST_LOG_OBJECT (pad, "Buffer chain with list of %d",
@@ -1160,52 +1211,47 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
   if ((ret = gst_srtp_enc_check_set_caps (filter, pad, is_rtcp)) != GST_FLOW_OK)
     goto out;
 
+  otherpad = get_rtp_other_pad (pad);
+
   GST_OBJECT_LOCK (filter);
 
   if (!HAS_CRYPTO (filter)) {
     GST_OBJECT_UNLOCK (filter);
-    otherpad = get_rtp_other_pad (pad);
     return gst_pad_push_list (otherpad, buf_list);
   }
 
-  GST_OBJECT_UNLOCK (filter);
-
-  out_list = gst_buffer_list_new ();
+  /* the buffers are protected in place where possible, and the whole list
+   * is done with one lock */
+  buf_list = gst_buffer_list_make_writable (buf_list);
 
   process_data.filter = filter;
   process_data.pad = pad;
   process_data.is_rtcp = is_rtcp;
-  process_data.out_list = out_list;
+  process_data.err = err_status_ok;
 
+  gst_srtp_init_event_reporter ();
   gst_buffer_list_foreach (buf_list, process_buffer_it, &process_data);
 
-  if (!gst_buffer_list_length (out_list)) {
-    gst_buffer_list_unref (out_list);
-    ret = GST_FLOW_OK;
+  GST_OBJECT_UNLOCK (filter);
+
+  if (process_data.err != err_status_ok) {
+    gst_srtp_enc_post_protect_error (filter, process_data.err);
+    ret = GST_FLOW_ERROR;
     goto out;
   }
 
   /* Push buffer to source pad */
-  otherpad = get_rtp_other_pad (pad);
   GST_LOG_OBJECT (pad, "Pushing buffer chain of %d",
       gst_buffer_list_length (buf_list));
-  ret = gst_pad_push_list (otherpad, out_list);
+  ret = gst_pad_push_list (otherpad, buf_list);
 
-  if (ret != GST_FLOW_OK) {
-    goto out;
-  }
+  if (ret != GST_FLOW_OK)
+    return ret;
 
   GST_OBJECT_LOCK (filter);
+  gst_srtp_enc_check_soft_limit (filter);
 
-  if (gst_srtp_get_soft_limit_reached ()) {
-    GST_OBJECT_UNLOCK (filter);
-    g_signal_emit (filter, gst_srtp_enc_signals[SIGNAL_SOFT_LIMIT], 0);
-    GST_OBJECT_LOCK (filter);
-    if (filter->random_key && !filter->key_changed)
-      gst_srtp_enc_replace_random_key (filter);
-  }
-
-  GST_OBJECT_UNLOCK (filter);
+  return ret;
 
 out:
 
@@ -35,9 +35,12 @@ enum
   PROP_0,
   PROP_BYPASS_FILTERING,
   PROP_NO_FANCY_UPSAMPLING,
-  PROP_USE_THREADS
+  PROP_USE_THREADS,
+  PROP_MAX_THREADS
 };
 
+#define DEFAULT_MAX_THREADS 1
+
 static GstStaticPadTemplate gst_webp_dec_sink_pad_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -70,6 +73,8 @@ static GstFlowReturn gst_webp_dec_parse (GstVideoDecoder * bdec,
     GstVideoCodecFrame * frame, GstAdapter * adapter, gboolean at_eos);
 static GstFlowReturn gst_webp_dec_handle_frame (GstVideoDecoder * bdec,
     GstVideoCodecFrame * frame);
+static GstFlowReturn gst_webp_dec_decode_parallel (GstVideoDecoder * bdec,
+    GstVideoCodecFrame * frame);
 static gboolean gst_webp_dec_decide_allocation (GstVideoDecoder * bdec,
     GstQuery * query);
 
@@ -117,11 +122,27 @@ gst_webp_dec_class_init (GstWebPDecClass * klass)
           "When enabled, use multi-threaded decoding", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstWebPDec:max-threads:
+   *
+   * Maximum number of frames to decode in parallel on a pool of threads,
+   * at the cost of one frame of latency per thread. 0 uses one thread per
+   * processor.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_int ("max-threads", "Maximum Threads",
+          "Maximum number of frames decoded in parallel "
+          "(0 = one per processor)", 0, G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   vdec_class->start = gst_webp_dec_start;
   vdec_class->stop = gst_webp_dec_stop;
   vdec_class->parse = gst_webp_dec_parse;
   vdec_class->set_format = gst_webp_dec_set_format;
   vdec_class->handle_frame = gst_webp_dec_handle_frame;
+  vdec_class->decode_parallel = gst_webp_dec_decode_parallel;
   vdec_class->decide_allocation = gst_webp_dec_decide_allocation;
 
   GST_DEBUG_CATEGORY_INIT (webp_dec_debug, "webpdec", 0, "WebP decoder");
@@ -138,6 +159,7 @@ gst_webp_dec_init (GstWebPDec * dec)
   dec->bypass_filtering = FALSE;
   dec->no_fancy_upsampling = FALSE;
   dec->use_threads = FALSE;
+  dec->max_threads = DEFAULT_MAX_THREADS;
   gst_video_decoder_set_use_default_pad_acceptcaps (GST_VIDEO_DECODER_CAST
       (dec), TRUE);
   GST_PAD_SET_ACCEPT_TEMPLATE (GST_VIDEO_DECODER_SINK_PAD (dec));
@@ -176,6 +198,11 @@ gst_webp_dec_set_property (GObject * object, guint prop_id,
     case PROP_USE_THREADS:
       dec->use_threads = g_value_get_boolean (value);
       break;
+    case PROP_MAX_THREADS:
+      dec->max_threads = g_value_get_int (value);
+      gst_video_decoder_set_decode_threads (GST_VIDEO_DECODER (dec),
+          dec->max_threads);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -201,6 +228,9 @@ gst_webp_dec_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_USE_THREADS:
       g_value_set_boolean (value, dec->use_threads);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_int (value, dec->max_threads);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -351,6 +381,44 @@ error:
   return GST_FLOW_ERROR;
 }
 
+/* TODO: Add support for other formats */
+static GstVideoFormat
+gst_webp_dec_get_format (WebPBitstreamFeatures * features,
+    WEBP_CSP_MODE * colorspace)
+{
+  if (features->has_alpha) {
+    *colorspace = MODE_ARGB;
+    return GST_VIDEO_FORMAT_ARGB;
+  } else {
+    *colorspace = MODE_RGB;
+    return GST_VIDEO_FORMAT_RGB;
+  }
+}
+
+/* Decodes @map_info into @vframe. Uses a decoder configuration of its own,
+ * so that frames can be decoded from several threads at once */
+static gboolean
+gst_webp_dec_decode (GstWebPDec * dec, GstMapInfo * map_info,
+    GstVideoFrame * vframe, WEBP_CSP_MODE colorspace)
+{
+  WebPDecoderConfig config;
+
+  if (!WebPInitDecoderConfig (&config))
+    return FALSE;
+
+  /* configure output buffer parameteres */
+  config.options.bypass_filtering = dec->bypass_filtering;
+  config.options.no_fancy_upsampling = dec->no_fancy_upsampling;
+  config.options.use_threads = dec->use_threads;
+  config.output.colorspace = colorspace;
+  config.output.u.RGBA.rgba = (uint8_t *) vframe->map[0].data;
+  config.output.u.RGBA.stride = GST_VIDEO_FRAME_COMP_STRIDE (vframe, 0);
+  config.output.u.RGBA.size = GST_VIDEO_FRAME_SIZE (vframe);
+  config.output.is_external_memory = 1;
+
+  return WebPDecode (map_info->data, map_info->size, &config) == VP8_STATUS_OK;
+}
+
 static GstFlowReturn
 gst_webp_dec_update_src_caps (GstWebPDec * dec, GstMapInfo * map_info)
 {
@@ -369,14 +437,7 @@ gst_webp_dec_update_src_caps (GstWebPDec * dec, GstMapInfo * map_info)
     return GST_FLOW_ERROR;
   }
 
-  /* TODO: Add support for other formats */
-  if (features.has_alpha) {
-    format = GST_VIDEO_FORMAT_ARGB;
-    dec->colorspace = MODE_ARGB;
-  } else {
-    format = GST_VIDEO_FORMAT_RGB;
-    dec->colorspace = MODE_RGB;
-  }
+  format = gst_webp_dec_get_format (&features, &dec->colorspace);
 
   /* Check if output state changed */
   if (dec->output_state) {
@@ -439,19 +500,8 @@ gst_webp_dec_handle_frame (GstVideoDecoder * decoder,
     goto done;
   }
 
-  /* configure output buffer parameteres */
-  webpdec->config.options.bypass_filtering = webpdec->bypass_filtering;
-  webpdec->config.options.no_fancy_upsampling = webpdec->no_fancy_upsampling;
-  webpdec->config.options.use_threads = webpdec->use_threads;
-  webpdec->config.output.colorspace = webpdec->colorspace;
-  webpdec->config.output.u.RGBA.rgba = (uint8_t *) vframe.map[0].data;
-  webpdec->config.output.u.RGBA.stride =
-      GST_VIDEO_FRAME_COMP_STRIDE (&vframe, 0);
-  webpdec->config.output.u.RGBA.size = GST_VIDEO_FRAME_SIZE (&vframe);
-  webpdec->config.output.is_external_memory = 1;
-
-  if (WebPDecode (map_info.data, map_info.size,
-          &webpdec->config) != VP8_STATUS_OK) {
+  if (!gst_webp_dec_decode (webpdec, &map_info, &vframe,
+          webpdec->colorspace)) {
     GST_ERROR_OBJECT (decoder, "Failed to decode the webp frame");
     ret = GST_FLOW_ERROR;
     gst_video_frame_unmap (&vframe);
@@ -475,6 +525,59 @@ done:
   return ret;
 }
 
+/* Called from the base class' decoding threads. Frames that don't match the
+ * current output state or fail to decode are handed back to handle_frame(),
+ * so that renegotiation and error reporting only happen from the streaming
+ * thread */
+static GstFlowReturn
+gst_webp_dec_decode_parallel (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstWebPDec *webpdec = (GstWebPDec *) decoder;
+  GstFlowReturn ret = GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+  WebPBitstreamFeatures features;
+  GstVideoCodecState *state;
+  WEBP_CSP_MODE colorspace;
+  GstVideoFrame vframe;
+  GstVideoInfo *info;
+  GstMapInfo map_info;
+
+  state = gst_video_decoder_get_output_state (decoder);
+  if (G_UNLIKELY (state == NULL))
+    return GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+  info = &state->info;
+
+  if (!gst_buffer_map (frame->input_buffer, &map_info, GST_MAP_READ)) {
+    gst_video_codec_state_unref (state);
+    return GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+  }
+
+  if (WebPGetFeatures (map_info.data, map_info.size,
+          &features) != VP8_STATUS_OK)
+    goto done;
+
+  if (features.width != GST_VIDEO_INFO_WIDTH (info) ||
+      features.height != GST_VIDEO_INFO_HEIGHT (info) ||
+      gst_webp_dec_get_format (&features, &colorspace) !=
+      GST_VIDEO_INFO_FORMAT (info))
+    goto done;
+
+  if (!gst_video_frame_map (&vframe, info, frame->output_buffer,
+          GST_MAP_READWRITE))
+    goto done;
+
+  if (gst_webp_dec_decode (webpdec, &map_info, &vframe, colorspace))
+    ret = GST_FLOW_OK;
+
+  gst_video_frame_unmap (&vframe);
+
+done:
+  gst_buffer_unmap (frame->input_buffer, &map_info);
+  gst_video_codec_state_unref (state);
+
+  return ret;
+}
+
 gboolean
 gst_webp_dec_register (GstPlugin * plugin)
 {
@@ -59,6 +59,7 @@ struct _GstWebPDec {
   gboolean bypass_filtering;
   gboolean no_fancy_upsampling;
   gboolean use_threads;
+  gint max_threads;
 
   WEBP_CSP_MODE colorspace;
   WebPDecoderConfig config;
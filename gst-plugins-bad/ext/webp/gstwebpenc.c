@@ -37,13 +37,28 @@ enum
   PROP_LOSSLESS,
   PROP_QUALITY,
   PROP_SPEED,
-  PROP_PRESET
+  PROP_PRESET,
+  PROP_MAX_THREADS,
+  PROP_ANIMATED,
+  PROP_ANIMATION_LOOPS
 };
 
 #define DEFAULT_LOSSLESS FALSE
 #define DEFAULT_QUALITY 90
 #define DEFAULT_SPEED 4
 #define DEFAULT_PRESET WEBP_PRESET_PHOTO
+#define DEFAULT_MAX_THREADS 1
+#define DEFAULT_ANIMATED FALSE
+#define DEFAULT_ANIMATION_LOOPS 0
+
+typedef struct
+{
+  GstVideoCodecFrame *frame;
+  GstFlowReturn ret;
+  gboolean done;
+} GstWebpEncJob;
+
+static void gst_webp_enc_finalize (GObject * object);
 
 static void gst_webp_enc_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -55,6 +70,13 @@ static gboolean gst_webp_enc_set_format (GstVideoEncoder * encoder,
     GstVideoCodecState * state);
 static GstFlowReturn gst_webp_enc_handle_frame (GstVideoEncoder * encoder,
     GstVideoCodecFrame * frame);
+static GstFlowReturn gst_webp_enc_finish (GstVideoEncoder * encoder);
+static gboolean gst_webp_enc_flush (GstVideoEncoder * encoder);
+static GstFlowReturn gst_webp_enc_finish_jobs (GstWebpEnc * enc,
+    guint max_pending, gboolean discard);
+#ifdef HAVE_WEBPMUX
+static GstFlowReturn gst_webp_enc_finish_animation (GstWebpEnc * enc);
+#endif
 static gboolean gst_webp_enc_propose_allocation (GstVideoEncoder * encoder,
     GstQuery * query);
 
@@ -121,6 +143,7 @@ gst_webp_enc_class_init (GstWebpEncClass * klass)
 
   parent_class = g_type_class_peek_parent (klass);
 
+  gobject_class->finalize = gst_webp_enc_finalize;
   gobject_class->set_property = gst_webp_enc_set_property;
   gobject_class->get_property = gst_webp_enc_get_property;
   gst_element_class_add_static_pad_template (element_class,
@@ -135,6 +158,8 @@ gst_webp_enc_class_init (GstWebpEncClass * klass)
   venc_class->stop = gst_webp_enc_stop;
   venc_class->set_format = gst_webp_enc_set_format;
   venc_class->handle_frame = gst_webp_enc_handle_frame;
+  venc_class->finish = gst_webp_enc_finish;
+  venc_class->flush = gst_webp_enc_flush;
   venc_class->propose_allocation = gst_webp_enc_propose_allocation;
 
   g_object_class_install_property (gobject_class, PROP_LOSSLESS,
@@ -155,6 +180,49 @@ gst_webp_enc_class_init (GstWebpEncClass * klass)
           GST_WEBP_ENC_PRESET_TYPE, DEFAULT_PRESET,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstWebpEnc:max-threads:
+   *
+   * Maximum number of frames encoded in parallel. The frames are still
+   * output in order.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_int ("max-threads", "Maximum threads",
+          "Maximum number of frames encoded in parallel "
+          "(0 = one per processor)", 0, G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+#ifdef HAVE_WEBPMUX
+  /**
+   * GstWebpEnc:animated:
+   *
+   * Encode all frames until EOS into a single animated WebP image instead
+   * of one image per frame. Each frame is added to the animation when it
+   * arrives, and the animation is output when draining.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_ANIMATED,
+      g_param_spec_boolean ("animated", "Animated",
+          "Encode all frames into one animated image",
+          DEFAULT_ANIMATED, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstWebpEnc:animation-loops:
+   *
+   * Number of times an animated image is played.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_ANIMATION_LOOPS,
+      g_param_spec_uint ("animation-loops", "Animation Loops",
+          "Number of times the animation is played (0 = forever)",
+          0, 65535, DEFAULT_ANIMATION_LOOPS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+#endif
+
   GST_DEBUG_CATEGORY_INIT (webpenc_debug, "webpenc", 0,
       "WEBP encoding element");
 }
@@ -168,9 +236,27 @@ gst_webp_enc_init (GstWebpEnc * webpenc)
   webpenc->quality = DEFAULT_QUALITY;
   webpenc->speed = DEFAULT_SPEED;
   webpenc->preset = DEFAULT_PRESET;
+  webpenc->max_threads = DEFAULT_MAX_THREADS;
+  webpenc->animated = DEFAULT_ANIMATED;
+  webpenc->animation_loops = DEFAULT_ANIMATION_LOOPS;
 
   webpenc->use_argb = FALSE;
   webpenc->rgb_format = GST_VIDEO_FORMAT_UNKNOWN;
+
+  g_queue_init (&webpenc->encode_jobs);
+  g_mutex_init (&webpenc->encode_lock);
+  g_cond_init (&webpenc->encode_cond);
+}
+
+static void
+gst_webp_enc_finalize (GObject * object)
+{
+  GstWebpEnc *webpenc = GST_WEBP_ENC (object);
+
+  g_mutex_clear (&webpenc->encode_lock);
+  g_cond_clear (&webpenc->encode_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 static gboolean
@@ -184,6 +270,12 @@ gst_webp_enc_set_format (GstVideoEncoder * encoder, GstVideoCodecState * state)
   info = &state->info;
   format = GST_VIDEO_INFO_FORMAT (info);
 
+  /* the pending frames are encoded with the previous format */
+  gst_webp_enc_finish_jobs (enc, 0, FALSE);
+#ifdef HAVE_WEBPMUX
+  gst_webp_enc_finish_animation (enc);
+#endif
+
   if (GST_VIDEO_INFO_IS_YUV (info)) {
     switch (format) {
       case GST_VIDEO_FORMAT_I420:
@@ -212,99 +304,380 @@ gst_webp_enc_set_format (GstVideoEncoder * encoder, GstVideoCodecState * state)
   return TRUE;
 }
 
+/* Sets up @picture for the mapped @vframe, the picture needs to be freed
+ * with WebPPictureFree() afterwards */
 static gboolean
-gst_webp_set_picture_params (GstWebpEnc * enc)
+gst_webp_enc_import_picture (GstWebpEnc * enc, GstVideoFrame * vframe,
+    WebPPicture * picture)
 {
-  GstVideoInfo *info;
-  gboolean ret = TRUE;
+  GstVideoInfo *info = &enc->input_state->info;
 
-  info = &enc->input_state->info;
-
-  if (!WebPPictureInit (&enc->webp_picture)) {
-    ret = FALSE;
-    goto failed_pic_init;
+  if (!WebPPictureInit (picture)) {
+    GST_ERROR_OBJECT (enc, "Failed to Initialize WebPPicture !");
+    return FALSE;
   }
 
-  enc->webp_picture.use_argb = enc->use_argb;
+  picture->use_argb = enc->use_argb;
   if (!enc->use_argb)
-    enc->webp_picture.colorspace = enc->webp_color_space;
-
-  enc->webp_picture.width = GST_VIDEO_INFO_WIDTH (info);
-  enc->webp_picture.height = GST_VIDEO_INFO_HEIGHT (info);
+    picture->colorspace = enc->webp_color_space;
 
-  WebPMemoryWriterInit (&enc->webp_writer);
-  enc->webp_picture.writer = WebPMemoryWrite;
-  enc->webp_picture.custom_ptr = &enc->webp_writer;
+  picture->width = GST_VIDEO_INFO_WIDTH (info);
+  picture->height = GST_VIDEO_INFO_HEIGHT (info);
 
-  return ret;
+  if (!enc->use_argb) {
+    picture->y = GST_VIDEO_FRAME_COMP_DATA (vframe, 0);
+    picture->u = GST_VIDEO_FRAME_COMP_DATA (vframe, 1);
+    picture->v = GST_VIDEO_FRAME_COMP_DATA (vframe, 2);
 
-failed_pic_init:
-  {
-    GST_ERROR_OBJECT (enc, "Failed to Initialize WebPPicture !");
-    return ret;
+    picture->y_stride = GST_VIDEO_FRAME_COMP_STRIDE (vframe, 0);
+    picture->uv_stride = GST_VIDEO_FRAME_COMP_STRIDE (vframe, 1);
+  } else {
+    switch (enc->rgb_format) {
+      case GST_VIDEO_FORMAT_RGB:
+        WebPPictureImportRGB (picture,
+            GST_VIDEO_FRAME_COMP_DATA (vframe, 0),
+            GST_VIDEO_FRAME_COMP_STRIDE (vframe, 0));
+        break;
+      case GST_VIDEO_FORMAT_RGBA:
+        WebPPictureImportRGBA (picture,
+            GST_VIDEO_FRAME_COMP_DATA (vframe, 0),
+            GST_VIDEO_FRAME_COMP_STRIDE (vframe, 0));
+        break;
+      default:
+        break;
+    }
   }
+
+  return TRUE;
 }
 
+/* Encodes @frame into its output buffer. Called from the encoding threads,
+ * so must not take the stream lock */
 static GstFlowReturn
-gst_webp_enc_handle_frame (GstVideoEncoder * encoder,
-    GstVideoCodecFrame * frame)
+gst_webp_enc_encode_frame (GstWebpEnc * enc, GstVideoCodecFrame * frame)
 {
-  GstWebpEnc *enc = GST_WEBP_ENC (encoder);
-  GstBuffer *out_buffer = NULL;
   GstVideoFrame vframe;
+  WebPPicture picture;
+  WebPMemoryWriter writer;
 
-  GST_LOG_OBJECT (enc, "got new frame");
-
-  gst_webp_set_picture_params (enc);
+  GST_LOG_OBJECT (enc, "encoding frame %d", frame->system_frame_number);
 
   if (!gst_video_frame_map (&vframe, &enc->input_state->info,
-          frame->input_buffer, GST_MAP_READ))
+          frame->input_buffer, GST_MAP_READ)) {
+    GST_ERROR_OBJECT (enc, "Failed to map input frame");
     return GST_FLOW_ERROR;
+  }
 
-  if (!enc->use_argb) {
-    enc->webp_picture.y = GST_VIDEO_FRAME_COMP_DATA (&vframe, 0);
-    enc->webp_picture.u = GST_VIDEO_FRAME_COMP_DATA (&vframe, 1);
-    enc->webp_picture.v = GST_VIDEO_FRAME_COMP_DATA (&vframe, 2);
+  if (!gst_webp_enc_import_picture (enc, &vframe, &picture)) {
+    gst_video_frame_unmap (&vframe);
+    return GST_FLOW_ERROR;
+  }
 
-    enc->webp_picture.y_stride = GST_VIDEO_FRAME_COMP_STRIDE (&vframe, 0);
-    enc->webp_picture.uv_stride = GST_VIDEO_FRAME_COMP_STRIDE (&vframe, 1);
+  WebPMemoryWriterInit (&writer);
+  picture.writer = WebPMemoryWrite;
+  picture.custom_ptr = &writer;
 
-  } else {
-    switch (enc->rgb_format) {
-      case GST_VIDEO_FORMAT_RGB:
-        WebPPictureImportRGB (&enc->webp_picture,
-            GST_VIDEO_FRAME_COMP_DATA (&vframe, 0),
-            GST_VIDEO_FRAME_COMP_STRIDE (&vframe, 0));
-        break;
-      case GST_VIDEO_FORMAT_RGBA:
-        WebPPictureImportRGBA (&enc->webp_picture,
-            GST_VIDEO_FRAME_COMP_DATA (&vframe, 0),
-            GST_VIDEO_FRAME_COMP_STRIDE (&vframe, 0));
-        break;
-      default:
+  if (!WebPEncode (&enc->webp_config, &picture)) {
+    GST_ERROR_OBJECT (enc, "Failed to encode WebPPicture");
+    WebPPictureFree (&picture);
+    free (writer.mem);
+    gst_video_frame_unmap (&vframe);
+    return GST_FLOW_ERROR;
+  }
+
+  WebPPictureFree (&picture);
+  gst_video_frame_unmap (&vframe);
+
+  frame->output_buffer = gst_buffer_new_wrapped_full (0, writer.mem,
+      writer.size, 0, writer.size, writer.mem, free);
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_webp_enc_encode_job (GstWebpEncJob * job, GstWebpEnc * enc)
+{
+  GstFlowReturn ret;
+
+  ret = gst_webp_enc_encode_frame (enc, job->frame);
+
+  g_mutex_lock (&enc->encode_lock);
+  job->ret = ret;
+  job->done = TRUE;
+  g_cond_broadcast (&enc->encode_cond);
+  g_mutex_unlock (&enc->encode_lock);
+}
+
+/* Finishes the frames encoded by the thread pool in input order, waiting
+ * until at most @max_pending frames are still being encoded. With @discard
+ * the frames are dropped instead of being pushed */
+static GstFlowReturn
+gst_webp_enc_finish_jobs (GstWebpEnc * enc, guint max_pending,
+    gboolean discard)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&enc->encode_lock);
+  while (enc->encode_jobs.length > 0) {
+    GstWebpEncJob *job = g_queue_peek_head (&enc->encode_jobs);
+    GstFlowReturn res;
+
+    if (!job->done) {
+      if (enc->encode_jobs.length <= max_pending)
         break;
+      g_cond_wait (&enc->encode_cond, &enc->encode_lock);
+      continue;
+    }
+    g_queue_pop_head (&enc->encode_jobs);
+    g_mutex_unlock (&enc->encode_lock);
+
+    if (discard || job->ret != GST_FLOW_OK) {
+      gst_video_codec_frame_unref (job->frame);
+      res = discard ? GST_FLOW_OK : job->ret;
+    } else {
+      res = gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (enc),
+          job->frame);
     }
+    g_slice_free (GstWebpEncJob, job);
+
+    if (ret == GST_FLOW_OK)
+      ret = res;
+
+    g_mutex_lock (&enc->encode_lock);
   }
+  g_mutex_unlock (&enc->encode_lock);
 
-  if (WebPEncode (&enc->webp_config, &enc->webp_picture)) {
-    WebPPictureFree (&enc->webp_picture);
+  return ret;
+}
 
-    out_buffer = gst_buffer_new_allocate (NULL, enc->webp_writer.size, NULL);
-    if (!out_buffer) {
-      GST_ERROR_OBJECT (enc, "Failed to create output buffer");
-      return GST_FLOW_ERROR;
-    }
-    gst_buffer_fill (out_buffer, 0, enc->webp_writer.mem,
-        enc->webp_writer.size);
-    free (enc->webp_writer.mem);
-  } else {
-    GST_ERROR_OBJECT (enc, "Failed to encode WebPPicture");
+#ifdef HAVE_WEBPMUX
+static void
+gst_webp_enc_reset_animation (GstWebpEnc * enc)
+{
+  if (enc->anim_enc) {
+    WebPAnimEncoderDelete (enc->anim_enc);
+    enc->anim_enc = NULL;
+  }
+  if (enc->anim_frame) {
+    gst_video_codec_frame_unref (enc->anim_frame);
+    enc->anim_frame = NULL;
+  }
+}
+
+/* Adds @frame to the animation right away, so that only the encoder state
+ * and not the raw frames are kept until the animation is assembled */
+static GstFlowReturn
+gst_webp_enc_add_animation_frame (GstWebpEnc * enc, GstVideoCodecFrame * frame)
+{
+  GstVideoInfo *info = &enc->input_state->info;
+  GstVideoFrame vframe;
+  WebPPicture picture;
+  GstBuffer *metadata;
+  gint timestamp, duration;
+  gboolean ok;
+
+  if (enc->anim_enc == NULL) {
+    WebPAnimEncoderOptions options;
+
+    if (!WebPAnimEncoderOptionsInit (&options))
+      goto init_failed;
+    options.anim_params.loop_count = enc->animation_loops;
+
+    enc->anim_enc = WebPAnimEncoderNew (GST_VIDEO_INFO_WIDTH (info),
+        GST_VIDEO_INFO_HEIGHT (info), &options);
+    if (enc->anim_enc == NULL)
+      goto init_failed;
+
+    enc->anim_first_pts = frame->pts;
+    enc->anim_timestamp = 0;
+    enc->anim_end = 0;
+  }
+
+  /* in milliseconds since the first frame, frames without timestamp follow
+   * right after the previous one */
+  timestamp = enc->anim_end;
+  if (GST_CLOCK_TIME_IS_VALID (frame->pts)
+      && GST_CLOCK_TIME_IS_VALID (enc->anim_first_pts)
+      && frame->pts >= enc->anim_first_pts)
+    timestamp = (frame->pts - enc->anim_first_pts) / GST_MSECOND;
+  timestamp = MAX (timestamp, enc->anim_timestamp);
+
+  if (GST_CLOCK_TIME_IS_VALID (frame->duration))
+    duration = frame->duration / GST_MSECOND;
+  else if (GST_VIDEO_INFO_FPS_N (info) > 0)
+    duration = gst_util_uint64_scale_int (1000, GST_VIDEO_INFO_FPS_D (info),
+        GST_VIDEO_INFO_FPS_N (info));
+  else
+    duration = 100;
+
+  if (!gst_video_frame_map (&vframe, info, frame->input_buffer,
+          GST_MAP_READ)) {
+    GST_ERROR_OBJECT (enc, "Failed to map input frame");
+    gst_video_codec_frame_unref (frame);
     return GST_FLOW_ERROR;
   }
 
+  ok = gst_webp_enc_import_picture (enc, &vframe, &picture);
+  if (ok) {
+    ok = WebPAnimEncoderAdd (enc->anim_enc, &picture, timestamp,
+        &enc->webp_config);
+    if (!ok)
+      GST_ERROR_OBJECT (enc, "Failed to add frame to the animation: %s",
+          WebPAnimEncoderGetError (enc->anim_enc));
+    WebPPictureFree (&picture);
+  }
   gst_video_frame_unmap (&vframe);
-  frame->output_buffer = out_buffer;
-  return gst_video_encoder_finish_frame (encoder, frame);
+
+  if (!ok) {
+    gst_video_codec_frame_unref (frame);
+    return GST_FLOW_ERROR;
+  }
+
+  enc->anim_timestamp = timestamp;
+  enc->anim_end = MAX (enc->anim_end, timestamp + duration);
+
+  /* the encoder has its own copy of the picture now */
+  metadata = gst_buffer_new ();
+  gst_buffer_copy_into (metadata, frame->input_buffer,
+      GST_BUFFER_COPY_METADATA, 0, -1);
+  gst_buffer_unref (frame->input_buffer);
+  frame->input_buffer = metadata;
+
+  if (enc->anim_frame == NULL) {
+    enc->anim_frame = frame;
+    return GST_FLOW_OK;
+  }
+
+  /* all other frames are dropped */
+  return gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (enc), frame);
+
+init_failed:
+  {
+    GST_ERROR_OBJECT (enc, "Failed to create WebP animation encoder");
+    gst_video_codec_frame_unref (frame);
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_webp_enc_finish_animation (GstWebpEnc * enc)
+{
+  GstVideoCodecFrame *frame;
+  WebPData data;
+
+  if (enc->anim_frame == NULL)
+    return GST_FLOW_OK;
+
+  WebPDataInit (&data);
+  if (!WebPAnimEncoderAdd (enc->anim_enc, NULL, enc->anim_end, NULL)
+      || !WebPAnimEncoderAssemble (enc->anim_enc, &data)) {
+    GST_ERROR_OBJECT (enc, "Failed to assemble the animation: %s",
+        WebPAnimEncoderGetError (enc->anim_enc));
+    gst_webp_enc_reset_animation (enc);
+    return GST_FLOW_ERROR;
+  }
+
+  frame = enc->anim_frame;
+  enc->anim_frame = NULL;
+
+  frame->duration = enc->anim_end * GST_MSECOND;
+  frame->output_buffer = gst_buffer_new_wrapped_full (0,
+      (gpointer) data.bytes, data.size, 0, data.size, (gpointer) data.bytes,
+      free);
+  GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
+
+  gst_webp_enc_reset_animation (enc);
+
+  return gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (enc), frame);
+}
+#endif
+
+static GstFlowReturn
+gst_webp_enc_handle_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstWebpEnc *enc = GST_WEBP_ENC (encoder);
+  GstWebpEncJob *job;
+  GstFlowReturn ret;
+  gint n_threads;
+
+  GST_LOG_OBJECT (enc, "got new frame");
+
+#ifdef HAVE_WEBPMUX
+  if (enc->animated)
+    return gst_webp_enc_add_animation_frame (enc, frame);
+#endif
+
+  n_threads = g_atomic_int_get (&enc->max_threads);
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  if (n_threads == 1) {
+    /* frames before this one might still be encoding in parallel */
+    ret = gst_webp_enc_finish_jobs (enc, 0, FALSE);
+    if (ret == GST_FLOW_OK)
+      ret = gst_webp_enc_encode_frame (enc, frame);
+    if (ret != GST_FLOW_OK) {
+      gst_video_codec_frame_unref (frame);
+      return ret;
+    }
+
+    return gst_video_encoder_finish_frame (encoder, frame);
+  }
+
+  if (enc->encode_pool == NULL) {
+    enc->encode_pool =
+        g_thread_pool_new ((GFunc) gst_webp_enc_encode_job, enc,
+        n_threads, FALSE, NULL);
+  } else if (g_thread_pool_get_max_threads (enc->encode_pool) != n_threads) {
+    g_thread_pool_set_max_threads (enc->encode_pool, n_threads, NULL);
+  }
+
+  job = g_slice_new (GstWebpEncJob);
+  job->frame = frame;
+  job->ret = GST_FLOW_OK;
+  job->done = FALSE;
+
+  g_mutex_lock (&enc->encode_lock);
+  g_queue_push_tail (&enc->encode_jobs, job);
+  g_mutex_unlock (&enc->encode_lock);
+
+  g_thread_pool_push (enc->encode_pool, job, NULL);
+
+  /* push out what is done and keep at most one frame per thread queued */
+  return gst_webp_enc_finish_jobs (enc, n_threads, FALSE);
+}
+
+static GstFlowReturn
+gst_webp_enc_finish (GstVideoEncoder * encoder)
+{
+  GstWebpEnc *enc = GST_WEBP_ENC (encoder);
+  GstFlowReturn ret;
+
+  GST_DEBUG_OBJECT (enc, "Draining");
+
+  ret = gst_webp_enc_finish_jobs (enc, 0, FALSE);
+#ifdef HAVE_WEBPMUX
+  if (ret == GST_FLOW_OK)
+    ret = gst_webp_enc_finish_animation (enc);
+#endif
+
+  return ret;
+}
+
+static gboolean
+gst_webp_enc_flush (GstVideoEncoder * encoder)
+{
+  GstWebpEnc *enc = GST_WEBP_ENC (encoder);
+
+  GST_DEBUG_OBJECT (enc, "Flushing");
+
+  gst_webp_enc_finish_jobs (enc, 0, TRUE);
+#ifdef HAVE_WEBPMUX
+  gst_webp_enc_reset_animation (enc);
+#endif
+
+  return TRUE;
 }
 
 static gboolean
@@ -335,6 +708,15 @@ gst_webp_enc_set_property (GObject * object, guint prop_id,
     case PROP_PRESET:
       webpenc->preset = g_value_get_enum (value);
       break;
+    case PROP_MAX_THREADS:
+      g_atomic_int_set (&webpenc->max_threads, g_value_get_int (value));
+      break;
+    case PROP_ANIMATED:
+      webpenc->animated = g_value_get_boolean (value);
+      break;
+    case PROP_ANIMATION_LOOPS:
+      webpenc->animation_loops = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -361,6 +743,15 @@ gst_webp_enc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_PRESET:
       g_value_set_enum (value, webpenc->preset);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_int (value, g_atomic_int_get (&webpenc->max_threads));
+      break;
+    case PROP_ANIMATED:
+      g_value_set_boolean (value, webpenc->animated);
+      break;
+    case PROP_ANIMATION_LOOPS:
+      g_value_set_uint (value, webpenc->animation_loops);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -390,8 +781,20 @@ static gboolean
 gst_webp_enc_stop (GstVideoEncoder * benc)
 {
   GstWebpEnc *enc = GST_WEBP_ENC (benc);
-  if (enc->input_state)
+
+  gst_webp_enc_finish_jobs (enc, 0, TRUE);
+  if (enc->encode_pool) {
+    g_thread_pool_free (enc->encode_pool, FALSE, TRUE);
+    enc->encode_pool = NULL;
+  }
+#ifdef HAVE_WEBPMUX
+  gst_webp_enc_reset_animation (enc);
+#endif
+
+  if (enc->input_state) {
     gst_video_codec_state_unref (enc->input_state);
+    enc->input_state = NULL;
+  }
   return TRUE;
 }
 
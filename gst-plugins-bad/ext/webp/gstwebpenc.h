@@ -22,6 +22,9 @@
 #include <gst/gst.h>
 #include <gst/video/video.h>
 #include <webp/encode.h>
+#ifdef HAVE_WEBPMUX
+#include <webp/mux.h>
+#endif
 
 G_BEGIN_DECLS
 
@@ -54,14 +57,31 @@ struct _GstWebpEnc
   gfloat quality;
   guint speed;
   gint preset;
+  gint max_threads;
+  gboolean animated;
+  guint animation_loops;
 
   gboolean use_argb;
   GstVideoFormat rgb_format;
 
   WebPEncCSP webp_color_space;
   struct WebPConfig webp_config;
-  struct WebPPicture webp_picture;
-  WebPMemoryWriter webp_writer;
+
+  /* frames being encoded by the thread pool, in input order */
+  GThreadPool *encode_pool;
+  GQueue encode_jobs;
+  GMutex encode_lock;
+  GCond encode_cond;
+
+#ifdef HAVE_WEBPMUX
+  /* all frames are added to the animation as they come in, and the
+   * assembled animation is output with the first frame when draining */
+  WebPAnimEncoder *anim_enc;
+  GstVideoCodecFrame *anim_frame;
+  GstClockTime anim_first_pts;
+  gint anim_timestamp;
+  gint anim_end;
+#endif
 };
 
 struct _GstWebpEncClass
@@ -122,6 +122,7 @@ that the demux object and its streams are not changed by anybody else.
 #include "gstadaptivedemux.h"
 #include "gst/gst-i18n-plugin.h"
 #include <gst/base/gstadapter.h>
+#include <math.h>
 
 GST_DEBUG_CATEGORY (adaptivedemux_debug);
 #define GST_CAT_DEFAULT adaptivedemux_debug
@@ -134,8 +135,24 @@ GST_DEBUG_CATEGORY (adaptivedemux_debug);
 #define DEFAULT_FAILED_COUNT 3
 #define DEFAULT_CONNECTION_SPEED 0
 #define DEFAULT_BITRATE_LIMIT 0.8
+#define DEFAULT_PREFETCH_FRAGMENTS 0
+#define DEFAULT_PREFETCH_MAX_BYTES (8 * 1024 * 1024)
 #define SRC_QUEUE_MAX_BYTES 20 * 1024 * 1024    /* For safety. Large enough to hold a segment. */
 #define NUM_LOOKBACK_FRAGMENTS 3
+#define DEFAULT_ABR_POLICY GST_ADAPTIVE_DEMUX_ABR_POLICY_MOVING_AVERAGE
+
+/* Downloads smaller than this are mostly round trip and TCP slow-start,
+ * they don't tell much about the available bandwidth */
+#define ABR_MIN_SAMPLE_BYTES (16 * 1024)
+/* Half-lives of the fast and slow throughput averages, in seconds of
+ * download time */
+#define ABR_EWMA_FAST_HALF_LIFE 2.0
+#define ABR_EWMA_SLOW_HALF_LIFE 5.0
+/* Between these buffer levels the buffer based policy uses the throughput
+ * estimate as is */
+#define ABR_BUFFER_LOW (10 * GST_SECOND)
+#define ABR_BUFFER_HIGH (30 * GST_SECOND)
+#define ABR_BUFFER_MAX_FACTOR 1.5
 
 #define GST_MANIFEST_GET_LOCK(d) (&(GST_ADAPTIVE_DEMUX_CAST(d)->priv->manifest_lock))
 #define GST_MANIFEST_LOCK(d) g_rec_mutex_lock (GST_MANIFEST_GET_LOCK (d));
@@ -154,6 +171,9 @@ enum
   PROP_0,
   PROP_CONNECTION_SPEED,
   PROP_BITRATE_LIMIT,
+  PROP_PREFETCH_FRAGMENTS,
+  PROP_PREFETCH_MAX_BYTES,
+  PROP_ABR_POLICY,
   PROP_LAST
 };
 
@@ -199,8 +219,31 @@ struct _GstAdaptiveDemuxPrivate
    * without needing to stop tasks when they just want to
    * update the segment boundaries */
   GMutex segment_lock;
+
+  /* Runs the fragment prefetches of all streams */
+  GThreadPool *prefetch_pool;   /* MT safe */
+  guint prefetch_fragments;     /* protected by manifest_lock */
+  guint prefetch_max_bytes;     /* protected by manifest_lock */
+
+  GstAdaptiveDemuxAbrPolicy abr_policy; /* protected by manifest_lock */
 };
 
+typedef struct _GstAdaptiveDemuxPrefetch
+{
+  GstAdaptiveDemuxStream *stream;
+  gchar *uri;
+  gint64 range_start;
+  gint64 range_end;
+
+  /* protected by stream->prefetch_lock */
+  GstUriDownloader *downloader;
+  gboolean done;
+  gboolean discard;
+  gboolean taken;               /* owned by the download task, which waits */
+  GstBuffer *buffer;            /* NULL if the download failed */
+  gint64 download_time;         /* in microseconds */
+} GstAdaptiveDemuxPrefetch;
+
 typedef struct _GstAdaptiveDemuxTimer
 {
   volatile gint ref_count;
@@ -285,6 +328,34 @@ gst_adaptive_demux_wait_until (GstClock * clock, GCond * cond, GMutex * mutex,
     GstClockTime end_time);
 static gboolean gst_adaptive_demux_clock_callback (GstClock * clock,
     GstClockTime time, GstClockID id, gpointer user_data);
+static void gst_adaptive_demux_prefetch_func (GstAdaptiveDemuxPrefetch *
+    prefetch, GstAdaptiveDemux * demux);
+static void gst_adaptive_demux_stream_cancel_prefetch (GstAdaptiveDemuxStream *
+    stream);
+
+GType
+gst_adaptive_demux_abr_policy_get_type (void)
+{
+  static volatile gsize type = 0;
+  static const GEnumValue values[] = {
+    {GST_ADAPTIVE_DEMUX_ABR_POLICY_MOVING_AVERAGE,
+        "Average of the last fragments", "moving-average"},
+    {GST_ADAPTIVE_DEMUX_ABR_POLICY_EWMA,
+        "Exponentially weighted moving average", "ewma"},
+    {GST_ADAPTIVE_DEMUX_ABR_POLICY_HARMONIC_MEAN,
+        "Harmonic mean of the last fragments", "harmonic-mean"},
+    {GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER_BASED,
+        "Throughput and buffer level", "buffer-based"},
+    {0, NULL, NULL}
+  };
+
+  if (g_once_init_enter (&type)) {
+    GType _type =
+        g_enum_register_static ("GstAdaptiveDemuxAbrPolicy", values);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
 
 /* we can't use G_DEFINE_ABSTRACT_TYPE because we need the klass in the _init
  * method to get to the padtemplates */
@@ -332,6 +403,15 @@ gst_adaptive_demux_set_property (GObject * object, guint prop_id,
     case PROP_BITRATE_LIMIT:
       demux->bitrate_limit = g_value_get_float (value);
       break;
+    case PROP_PREFETCH_FRAGMENTS:
+      demux->priv->prefetch_fragments = g_value_get_uint (value);
+      break;
+    case PROP_PREFETCH_MAX_BYTES:
+      demux->priv->prefetch_max_bytes = g_value_get_uint (value);
+      break;
+    case PROP_ABR_POLICY:
+      demux->priv->abr_policy = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -356,6 +436,15 @@ gst_adaptive_demux_get_property (GObject * object, guint prop_id,
     case PROP_BITRATE_LIMIT:
       g_value_set_float (value, demux->bitrate_limit);
       break;
+    case PROP_PREFETCH_FRAGMENTS:
+      g_value_set_uint (value, demux->priv->prefetch_fragments);
+      break;
+    case PROP_PREFETCH_MAX_BYTES:
+      g_value_set_uint (value, demux->priv->prefetch_max_bytes);
+      break;
+    case PROP_ABR_POLICY:
+      g_value_set_enum (value, demux->priv->abr_policy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -399,6 +488,25 @@ gst_adaptive_demux_class_init (GstAdaptiveDemuxClass * klass)
           0, 1, DEFAULT_BITRATE_LIMIT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_PREFETCH_FRAGMENTS,
+      g_param_spec_uint ("prefetch-fragments", "Prefetch fragments",
+          "Number of fragments to download in parallel ahead of the current "
+          "one for each stream (0 = disabled)", 0, G_MAXUINT,
+          DEFAULT_PREFETCH_FRAGMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_PREFETCH_MAX_BYTES,
+      g_param_spec_uint ("prefetch-max-bytes", "Prefetch max bytes",
+          "Maximum amount of prefetched data to keep for each stream",
+          0, G_MAXUINT, DEFAULT_PREFETCH_MAX_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_ABR_POLICY,
+      g_param_spec_enum ("abr-policy", "ABR policy",
+          "How to estimate the bitrate to switch to from the downloads",
+          GST_TYPE_ADAPTIVE_DEMUX_ABR_POLICY, DEFAULT_ABR_POLICY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state = gst_adaptive_demux_change_state;
 
   gstbin_class->handle_message = gst_adaptive_demux_handle_message;
@@ -468,6 +576,10 @@ gst_adaptive_demux_init (GstAdaptiveDemux * demux,
   g_mutex_init (&demux->priv->api_lock);
   g_mutex_init (&demux->priv->segment_lock);
 
+  demux->priv->prefetch_pool =
+      g_thread_pool_new ((GFunc) gst_adaptive_demux_prefetch_func, demux, -1,
+      FALSE, NULL);
+
   pad_template =
       gst_element_class_get_pad_template (GST_ELEMENT_CLASS (klass), "sink");
   g_return_if_fail (pad_template != NULL);
@@ -481,6 +593,9 @@ gst_adaptive_demux_init (GstAdaptiveDemux * demux,
   /* Properties */
   demux->bitrate_limit = DEFAULT_BITRATE_LIMIT;
   demux->connection_speed = DEFAULT_CONNECTION_SPEED;
+  demux->priv->prefetch_fragments = DEFAULT_PREFETCH_FRAGMENTS;
+  demux->priv->prefetch_max_bytes = DEFAULT_PREFETCH_MAX_BYTES;
+  demux->priv->abr_policy = DEFAULT_ABR_POLICY;
 
   gst_element_add_pad (GST_ELEMENT (demux), demux->sinkpad);
 }
@@ -496,6 +611,9 @@ gst_adaptive_demux_finalize (GObject * object)
   g_object_unref (priv->input_adapter);
   g_object_unref (demux->downloader);
 
+  /* all streams are gone, so no prefetch can be running anymore */
+  g_thread_pool_free (priv->prefetch_pool, FALSE, TRUE);
+
   g_mutex_clear (&priv->updates_timed_lock);
   g_cond_clear (&priv->updates_timed_cond);
   g_mutex_clear (&demux->priv->manifest_update_lock);
@@ -1076,6 +1194,7 @@ gst_adaptive_demux_expose_streams (GstAdaptiveDemux * demux,
       stream->cancelled = TRUE;
       g_cond_signal (&stream->fragment_download_cond);
       g_mutex_unlock (&stream->fragment_download_lock);
+      gst_adaptive_demux_stream_cancel_prefetch (stream);
     }
     gst_event_unref (eos);
 
@@ -1117,6 +1236,9 @@ gst_adaptive_demux_stream_new (GstAdaptiveDemux * demux, GstPad * pad)
   gst_segment_init (&stream->segment, GST_FORMAT_TIME);
   g_cond_init (&stream->fragment_download_cond);
   g_mutex_init (&stream->fragment_download_lock);
+  g_cond_init (&stream->prefetch_cond);
+  g_mutex_init (&stream->prefetch_lock);
+  g_queue_init (&stream->prefetch_queue);
   stream->adapter = gst_adapter_new ();
 
   demux->next_streams = g_list_append (demux->next_streams, stream);
@@ -1181,6 +1303,13 @@ gst_adaptive_demux_stream_free (GstAdaptiveDemuxStream * stream)
     stream->download_task = NULL;
   }
 
+  /* wait for the prefetches still running, they will free themselves */
+  gst_adaptive_demux_stream_cancel_prefetch (stream);
+  g_mutex_lock (&stream->prefetch_lock);
+  while (stream->prefetch_pending > 0)
+    g_cond_wait (&stream->prefetch_cond, &stream->prefetch_lock);
+  g_mutex_unlock (&stream->prefetch_lock);
+
   gst_adaptive_demux_stream_fragment_clear (&stream->fragment);
 
   if (stream->pending_segment) {
@@ -1210,6 +1339,8 @@ gst_adaptive_demux_stream_free (GstAdaptiveDemuxStream * stream)
 
   g_cond_clear (&stream->fragment_download_cond);
   g_mutex_clear (&stream->fragment_download_lock);
+  g_cond_clear (&stream->prefetch_cond);
+  g_mutex_clear (&stream->prefetch_lock);
   g_free (stream->fragment_bitrates);
 
   if (stream->pad) {
@@ -1672,6 +1803,9 @@ gst_adaptive_demux_stop_tasks (GstAdaptiveDemux * demux)
     gst_task_stop (stream->download_task);
     g_cond_signal (&stream->fragment_download_cond);
     g_mutex_unlock (&stream->fragment_download_lock);
+
+    /* prefetched data is not valid anymore after a flush */
+    gst_adaptive_demux_stream_cancel_prefetch (stream);
   }
 
   g_mutex_lock (&demux->priv->manifest_update_lock);
@@ -1785,6 +1919,126 @@ _update_average_bitrate (GstAdaptiveDemux * demux,
   return stream->moving_bitrate / stream->moving_index;
 }
 
+/* must be called with manifest_lock taken */
+static void
+_update_ewma (GstAdaptiveDemuxStream * stream, gdouble bitrate, gdouble weight)
+{
+  gdouble alpha;
+
+  alpha = pow (0.5, weight / ABR_EWMA_FAST_HALF_LIFE);
+  stream->ewma_fast = alpha * stream->ewma_fast + (1.0 - alpha) * bitrate;
+  alpha = pow (0.5, weight / ABR_EWMA_SLOW_HALF_LIFE);
+  stream->ewma_slow = alpha * stream->ewma_slow + (1.0 - alpha) * bitrate;
+  stream->ewma_total_weight += weight;
+}
+
+/* must be called with manifest_lock taken */
+static guint64
+_get_ewma_estimate (GstAdaptiveDemuxStream * stream)
+{
+  gdouble fast, slow;
+
+  if (stream->ewma_total_weight <= 0.0)
+    return 0;
+
+  /* both averages start at 0, correct for that until enough samples were
+   * seen */
+  fast = stream->ewma_fast / (1.0 - pow (0.5,
+          stream->ewma_total_weight / ABR_EWMA_FAST_HALF_LIFE));
+  slow = stream->ewma_slow / (1.0 - pow (0.5,
+          stream->ewma_total_weight / ABR_EWMA_SLOW_HALF_LIFE));
+
+  /* drops show up quickly in the fast average, while the slow one keeps
+   * short bursts from causing an upgrade */
+  return (guint64) MIN (fast, slow);
+}
+
+/* must be called with manifest_lock taken */
+static guint64
+_update_harmonic_mean (GstAdaptiveDemuxStream * stream, guint64 new_bitrate)
+{
+  gdouble sum = 0.0;
+  guint i, n;
+
+  if (new_bitrate > 0) {
+    stream->harmonic_samples[stream->harmonic_index %
+        GST_ADAPTIVE_DEMUX_ABR_HARMONIC_SAMPLES] = new_bitrate;
+    stream->harmonic_index++;
+  }
+
+  n = MIN (stream->harmonic_index, GST_ADAPTIVE_DEMUX_ABR_HARMONIC_SAMPLES);
+  if (n == 0)
+    return 0;
+
+  /* a single fast fragment barely moves the harmonic mean, a slow one
+   * does */
+  for (i = 0; i < n; i++)
+    sum += 1.0 / stream->harmonic_samples[i];
+
+  return (guint64) (n / sum);
+}
+
+/* Returns how much data of @stream is waiting downstream to be played, or
+ * GST_CLOCK_TIME_NONE if it can't be known (e.g. not playing yet)
+ *
+ * must be called with manifest_lock taken */
+static GstClockTime
+gst_adaptive_demux_stream_get_buffer_level (GstAdaptiveDemux * demux,
+    GstAdaptiveDemuxStream * stream)
+{
+  GstClock *clock;
+  GstClockTime now, position;
+
+  if (GST_STATE (demux) != GST_STATE_PLAYING)
+    return GST_CLOCK_TIME_NONE;
+
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (demux));
+  if (clock == NULL)
+    return GST_CLOCK_TIME_NONE;
+
+  now = gst_clock_get_time (clock);
+  gst_object_unref (clock);
+  now -= MIN (now, gst_element_get_base_time (GST_ELEMENT_CAST (demux)));
+
+  GST_ADAPTIVE_DEMUX_SEGMENT_LOCK (demux);
+  position = gst_segment_to_running_time (&stream->segment, GST_FORMAT_TIME,
+      stream->segment.position);
+  GST_ADAPTIVE_DEMUX_SEGMENT_UNLOCK (demux);
+
+  if (!GST_CLOCK_TIME_IS_VALID (position))
+    return GST_CLOCK_TIME_NONE;
+
+  return position > now ? position - now : 0;
+}
+
+/* must be called with manifest_lock taken */
+static guint64
+_apply_buffer_level (GstAdaptiveDemux * demux,
+    GstAdaptiveDemuxStream * stream, guint64 bitrate)
+{
+  GstClockTime level;
+  gdouble factor;
+
+  level = gst_adaptive_demux_stream_get_buffer_level (demux, stream);
+  if (!GST_CLOCK_TIME_IS_VALID (level))
+    return bitrate;
+
+  /* Like BOLA, trade throughput for buffer: go down quickly when the
+   * buffer runs low and only go above the measured throughput when
+   * enough is buffered to absorb a slower download */
+  if (level < ABR_BUFFER_LOW)
+    factor = (gdouble) level / ABR_BUFFER_LOW;
+  else if (level > ABR_BUFFER_HIGH)
+    factor = MIN ((gdouble) level / ABR_BUFFER_HIGH, ABR_BUFFER_MAX_FACTOR);
+  else
+    factor = 1.0;
+
+  GST_DEBUG_OBJECT (stream->pad, "Buffer level %" GST_TIME_FORMAT
+      ", scaling bitrate by %.2f", GST_TIME_ARGS (level), factor);
+
+  return bitrate * factor;
+}
+
 /* must be called with manifest_lock taken */
 static guint64
 gst_adaptive_demux_stream_update_current_bitrate (GstAdaptiveDemux * demux,
@@ -1792,6 +2046,9 @@ gst_adaptive_demux_stream_update_current_bitrate (GstAdaptiveDemux * demux,
 {
   guint64 average_bitrate;
   guint64 fragment_bitrate;
+  guint64 sample_bitrate = 0;
+  gdouble sample_weight = 0.0;
+  gint64 bytes, elapsed;
 
   if (demux->connection_speed) {
     GST_LOG_OBJECT (demux, "Connection-speed is set to %u kbps, using it",
@@ -1799,8 +2056,30 @@ gst_adaptive_demux_stream_update_current_bitrate (GstAdaptiveDemux * demux,
     return demux->connection_speed;
   }
 
-  g_object_get (stream->queue, "avg-in-rate", &fragment_bitrate, NULL);
-  fragment_bitrate *= 8;
+  /* what was received since the last estimation, timed per chunk so that
+   * waiting between fragments doesn't count */
+  bytes = stream->download_total_bytes - stream->abr_sample_bytes;
+  elapsed = stream->download_total_time - stream->abr_sample_time;
+  stream->abr_sample_bytes = stream->download_total_bytes;
+  stream->abr_sample_time = stream->download_total_time;
+
+  if (stream->prefetch_bitrate) {
+    /* the fragment was fetched ahead of time, use the rate its own
+     * transfer achieved while running in parallel with the others */
+    fragment_bitrate = stream->prefetch_bitrate;
+    stream->prefetch_bitrate = 0;
+    sample_bitrate = fragment_bitrate;
+    sample_weight = GST_CLOCK_TIME_IS_VALID (stream->fragment.duration) ?
+        gst_guint64_to_gdouble (stream->fragment.duration) / GST_SECOND : 1.0;
+  } else {
+    g_object_get (stream->queue, "avg-in-rate", &fragment_bitrate, NULL);
+    fragment_bitrate *= 8;
+    if (bytes >= ABR_MIN_SAMPLE_BYTES && elapsed > 0) {
+      sample_bitrate =
+          gst_util_uint64_scale (bytes, 8 * G_USEC_PER_SEC, elapsed);
+      sample_weight = (gdouble) elapsed / G_USEC_PER_SEC;
+    }
+  }
   GST_DEBUG_OBJECT (demux, "Download bitrate is : %" G_GUINT64_FORMAT " bps",
       fragment_bitrate);
 
@@ -1812,8 +2091,38 @@ gst_adaptive_demux_stream_update_current_bitrate (GstAdaptiveDemux * demux,
       "Last %u fragments average bitrate is %" G_GUINT64_FORMAT,
       NUM_LOOKBACK_FRAGMENTS, average_bitrate);
 
-  /* Conservative approach, make sure we don't upgrade too fast */
-  stream->current_download_rate = MIN (average_bitrate, fragment_bitrate);
+  if (sample_bitrate > 0)
+    _update_ewma (stream, sample_bitrate, sample_weight);
+  else
+    GST_LOG_OBJECT (stream->pad, "Sample of %" G_GINT64_FORMAT " bytes too "
+        "small to estimate the throughput", bytes);
+
+  switch (demux->priv->abr_policy) {
+    case GST_ADAPTIVE_DEMUX_ABR_POLICY_EWMA:
+    case GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER_BASED:
+      stream->current_download_rate = _get_ewma_estimate (stream);
+      break;
+    case GST_ADAPTIVE_DEMUX_ABR_POLICY_HARMONIC_MEAN:
+      stream->current_download_rate =
+          _update_harmonic_mean (stream, sample_bitrate);
+      break;
+    case GST_ADAPTIVE_DEMUX_ABR_POLICY_MOVING_AVERAGE:
+    default:
+      /* Conservative approach, make sure we don't upgrade too fast */
+      stream->current_download_rate = MIN (average_bitrate, fragment_bitrate);
+      break;
+  }
+
+  /* no usable sample yet, fall back to the last fragment */
+  if (stream->current_download_rate == 0)
+    stream->current_download_rate = fragment_bitrate;
+
+  if (demux->priv->abr_policy == GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER_BASED)
+    stream->current_download_rate = _apply_buffer_level (demux, stream,
+        stream->current_download_rate);
+
+  GST_INFO_OBJECT (stream, "Estimated bitrate is %" G_GUINT64_FORMAT,
+      stream->current_download_rate);
 
   stream->current_download_rate *= demux->bitrate_limit;
   GST_DEBUG_OBJECT (demux, "Bitrate after bitrate limit (%0.2f): %"
@@ -2376,6 +2685,8 @@ gst_adaptive_demux_stream_update_source (GstAdaptiveDemuxStream * stream,
       g_object_set (uri_handler, "compress", FALSE, NULL);
     if (g_object_class_find_property (gobject_class, "keep-alive"))
       g_object_set (uri_handler, "keep-alive", TRUE, NULL);
+    if (g_object_class_find_property (gobject_class, "shared-session"))
+      g_object_set (uri_handler, "shared-session", TRUE, NULL);
     if (g_object_class_find_property (gobject_class, "extra-headers")) {
       if (referer || refresh || !allow_cache) {
         GstStructure *extra_headers = gst_structure_new_empty ("headers");
@@ -2468,6 +2779,305 @@ gst_adaptive_demux_stream_update_source (GstAdaptiveDemuxStream * stream,
   return TRUE;
 }
 
+static void
+gst_adaptive_demux_prefetch_free (GstAdaptiveDemuxPrefetch * prefetch)
+{
+  if (prefetch->downloader)
+    g_object_unref (prefetch->downloader);
+  if (prefetch->buffer)
+    gst_buffer_unref (prefetch->buffer);
+  g_free (prefetch->uri);
+  g_slice_free (GstAdaptiveDemuxPrefetch, prefetch);
+}
+
+/* runs from the prefetch_pool */
+static void
+gst_adaptive_demux_prefetch_func (GstAdaptiveDemuxPrefetch * prefetch,
+    GstAdaptiveDemux * demux)
+{
+  GstAdaptiveDemuxStream *stream = prefetch->stream;
+  GstUriDownloader *downloader;
+  GstFragment *download;
+  GstBuffer *buffer = NULL;
+  GError *err = NULL;
+  gint64 range_end = prefetch->range_end;
+  gint64 start_time, download_time = 0;
+
+  g_mutex_lock (&stream->prefetch_lock);
+  downloader = prefetch->discard ? NULL : prefetch->downloader;
+  g_mutex_unlock (&stream->prefetch_lock);
+
+  if (downloader) {
+    GST_DEBUG_OBJECT (stream->pad, "Prefetching uri: %s, range:%"
+        G_GINT64_FORMAT " - %" G_GINT64_FORMAT, prefetch->uri,
+        prefetch->range_start, prefetch->range_end);
+
+    /* HTTP ranges are inclusive, GStreamer segments are exclusive for the
+     * stop position */
+    if (range_end != -1)
+      range_end += 1;
+
+    start_time =
+        GST_TIME_AS_USECONDS (gst_adaptive_demux_get_monotonic_time (demux));
+    download = gst_uri_downloader_fetch_uri_with_range (downloader,
+        prefetch->uri, NULL, FALSE, FALSE, TRUE, prefetch->range_start,
+        range_end, &err);
+    download_time =
+        GST_TIME_AS_USECONDS (gst_adaptive_demux_get_monotonic_time (demux)) -
+        start_time;
+
+    if (download) {
+      buffer = gst_fragment_get_buffer (download);
+      g_object_unref (download);
+    } else {
+      GST_DEBUG_OBJECT (stream->pad, "Failed to prefetch %s: %s",
+          prefetch->uri, err ? err->message : "unknown error");
+      g_clear_error (&err);
+    }
+  }
+
+  g_mutex_lock (&stream->prefetch_lock);
+  stream->prefetch_pending--;
+  if (prefetch->discard && !prefetch->taken) {
+    g_queue_remove (&stream->prefetch_queue, prefetch);
+    gst_adaptive_demux_prefetch_free (prefetch);
+    if (buffer)
+      gst_buffer_unref (buffer);
+    downloader = NULL;
+  } else {
+    prefetch->done = TRUE;
+    prefetch->buffer = buffer;
+    prefetch->download_time = download_time;
+    if (buffer)
+      stream->prefetch_bytes += gst_buffer_get_size (buffer);
+    downloader = prefetch->downloader;
+    prefetch->downloader = NULL;
+  }
+  g_cond_broadcast (&stream->prefetch_cond);
+  g_mutex_unlock (&stream->prefetch_lock);
+
+  if (downloader)
+    g_object_unref (downloader);
+}
+
+/* must be called with prefetch_lock taken */
+static void
+gst_adaptive_demux_stream_discard_prefetch (GstAdaptiveDemuxStream * stream,
+    GstAdaptiveDemuxPrefetch * prefetch)
+{
+  if (prefetch->done && !prefetch->taken) {
+    g_queue_remove (&stream->prefetch_queue, prefetch);
+    if (prefetch->buffer)
+      stream->prefetch_bytes -= gst_buffer_get_size (prefetch->buffer);
+    gst_adaptive_demux_prefetch_free (prefetch);
+  } else if (!prefetch->discard) {
+    /* freed by the prefetch itself when it returns or by the download task
+     * waiting for it */
+    prefetch->discard = TRUE;
+    if (!prefetch->done)
+      gst_uri_downloader_cancel (prefetch->downloader);
+  }
+}
+
+/* MT safe. Drops all prefetched fragments of @stream and cancels the
+ * ones still downloading */
+static void
+gst_adaptive_demux_stream_cancel_prefetch (GstAdaptiveDemuxStream * stream)
+{
+  GList *iter, *next;
+
+  g_mutex_lock (&stream->prefetch_lock);
+  for (iter = stream->prefetch_queue.head; iter; iter = next) {
+    next = iter->next;
+    gst_adaptive_demux_stream_discard_prefetch (stream, iter->data);
+  }
+  g_cond_broadcast (&stream->prefetch_cond);
+  g_mutex_unlock (&stream->prefetch_lock);
+}
+
+/* must be called with prefetch_lock taken */
+static GList *
+gst_adaptive_demux_stream_find_prefetch (GstAdaptiveDemuxStream * stream,
+    const gchar * uri, gint64 range_start, gint64 range_end)
+{
+  GList *iter;
+
+  for (iter = stream->prefetch_queue.head; iter; iter = iter->next) {
+    GstAdaptiveDemuxPrefetch *prefetch = iter->data;
+
+    if (!prefetch->discard && prefetch->range_start == range_start
+        && prefetch->range_end == range_end
+        && g_strcmp0 (prefetch->uri, uri) == 0)
+      return iter;
+  }
+  return NULL;
+}
+
+/* must be called with manifest_lock taken.
+ * Starts downloading the fragments following the current one, up to the
+ * configured number of fragments and byte budget */
+static void
+gst_adaptive_demux_stream_schedule_prefetch (GstAdaptiveDemux * demux,
+    GstAdaptiveDemuxStream * stream)
+{
+  GstAdaptiveDemuxClass *klass = GST_ADAPTIVE_DEMUX_GET_CLASS (demux);
+  guint n;
+
+  if (demux->priv->prefetch_fragments == 0 || !klass->stream_peek_fragment)
+    return;
+
+  g_mutex_lock (&stream->prefetch_lock);
+  for (n = 1; n <= demux->priv->prefetch_fragments; n++) {
+    GstAdaptiveDemuxPrefetch *prefetch;
+    gchar *uri = NULL;
+    gint64 range_start = 0, range_end = -1;
+
+    if (stream->prefetch_bytes >= demux->priv->prefetch_max_bytes)
+      break;
+
+    if (!klass->stream_peek_fragment (stream, n, &uri, &range_start,
+            &range_end))
+      break;
+
+    if (gst_adaptive_demux_stream_find_prefetch (stream, uri, range_start,
+            range_end)) {
+      g_free (uri);
+      continue;
+    }
+
+    GST_LOG_OBJECT (stream->pad, "Scheduling prefetch of fragment %u: %s", n,
+        uri);
+
+    prefetch = g_slice_new0 (GstAdaptiveDemuxPrefetch);
+    prefetch->stream = stream;
+    prefetch->uri = uri;
+    prefetch->range_start = range_start;
+    prefetch->range_end = range_end;
+    prefetch->downloader = gst_uri_downloader_new ();
+
+    g_queue_push_tail (&stream->prefetch_queue, prefetch);
+    stream->prefetch_pending++;
+    g_thread_pool_push (demux->priv->prefetch_pool, prefetch, NULL);
+  }
+  g_mutex_unlock (&stream->prefetch_lock);
+}
+
+/* must be called with manifest_lock taken.
+ * Can temporarily release manifest_lock.
+ * Returns the prefetch of the given fragment once it completed, dropping the
+ * fragments queued before it, which will not be used anymore. Returns NULL if
+ * the fragment was not prefetched or its download failed.
+ */
+static GstAdaptiveDemuxPrefetch *
+gst_adaptive_demux_stream_take_prefetch (GstAdaptiveDemux * demux,
+    GstAdaptiveDemuxStream * stream, const gchar * uri, gint64 range_start,
+    gint64 range_end)
+{
+  GstAdaptiveDemuxPrefetch *prefetch = NULL;
+  GList *match, *iter, *next;
+
+  g_mutex_lock (&stream->prefetch_lock);
+  if (g_queue_is_empty (&stream->prefetch_queue))
+    goto done;
+
+  match =
+      gst_adaptive_demux_stream_find_prefetch (stream, uri, range_start,
+      range_end);
+  for (iter = stream->prefetch_queue.head; iter != match; iter = next) {
+    next = iter->next;
+    gst_adaptive_demux_stream_discard_prefetch (stream, iter->data);
+  }
+  if (!match)
+    goto done;
+
+  prefetch = match->data;
+  prefetch->taken = TRUE;
+  if (!prefetch->done) {
+    GST_DEBUG_OBJECT (stream->pad, "Waiting for prefetch of %s", uri);
+
+    /* if we get cancelled meanwhile, the download is cancelled too */
+    GST_MANIFEST_UNLOCK (demux);
+    while (!prefetch->done)
+      g_cond_wait (&stream->prefetch_cond, &stream->prefetch_lock);
+    g_mutex_unlock (&stream->prefetch_lock);
+    GST_MANIFEST_LOCK (demux);
+    g_mutex_lock (&stream->prefetch_lock);
+  }
+
+  g_queue_remove (&stream->prefetch_queue, prefetch);
+  if (prefetch->buffer)
+    stream->prefetch_bytes -= gst_buffer_get_size (prefetch->buffer);
+  if (prefetch->discard || !prefetch->buffer) {
+    gst_adaptive_demux_prefetch_free (prefetch);
+    prefetch = NULL;
+  }
+
+done:
+  g_mutex_unlock (&stream->prefetch_lock);
+  return prefetch;
+}
+
+/* must be called with manifest_lock taken.
+ * Can temporarily release manifest_lock.
+ * Feeds a prefetched fragment through the same path as a downloaded one.
+ */
+static GstFlowReturn
+gst_adaptive_demux_stream_push_prefetch (GstAdaptiveDemux * demux,
+    GstAdaptiveDemuxStream * stream, GstAdaptiveDemuxPrefetch * prefetch)
+{
+  GstBuffer *buffer = prefetch->buffer;
+  gsize size = gst_buffer_get_size (buffer);
+  gint64 download_time = prefetch->download_time;
+  GstFlowReturn ret;
+
+  GST_DEBUG_OBJECT (stream->pad, "Using prefetched uri: %s (%" G_GSIZE_FORMAT
+      " bytes in %" G_GINT64_FORMAT " us)", prefetch->uri, size,
+      download_time);
+
+  prefetch->buffer = NULL;
+  gst_adaptive_demux_prefetch_free (prefetch);
+
+  if (download_time > 0)
+    stream->prefetch_bitrate = gst_util_uint64_scale (size, 8 * G_USEC_PER_SEC,
+        download_time);
+
+  /* the uri_handler doesn't know about this fragment, so compute the
+   * nominal bitrate here instead of querying it */
+  if (stream->fragment.bitrate == 0 && stream->fragment.duration != 0 &&
+      GST_CLOCK_TIME_IS_VALID (stream->fragment.duration))
+    stream->fragment.bitrate = MIN (G_MAXUINT, gst_util_uint64_scale (size,
+            8 * GST_SECOND, stream->fragment.duration));
+
+  /* account for the time the transfer took as if it just happened */
+  stream->download_start_time =
+      GST_TIME_AS_USECONDS (gst_adaptive_demux_get_monotonic_time (demux)) -
+      download_time;
+  stream->download_chunk_start_time = stream->download_start_time;
+
+  g_mutex_lock (&stream->fragment_download_lock);
+  stream->download_finished = FALSE;
+  stream->downloading_first_buffer = TRUE;
+  g_mutex_unlock (&stream->fragment_download_lock);
+
+  GST_MANIFEST_UNLOCK (demux);
+
+  ret = _src_chain (stream->internal_pad, GST_OBJECT_CAST (demux), buffer);
+  if (ret == GST_FLOW_OK)
+    _src_event (stream->internal_pad, GST_OBJECT_CAST (demux),
+        gst_event_new_eos ());
+
+  GST_MANIFEST_LOCK (demux);
+  g_mutex_lock (&stream->fragment_download_lock);
+  if (G_UNLIKELY (stream->cancelled)) {
+    ret = stream->last_ret = GST_FLOW_FLUSHING;
+    g_mutex_unlock (&stream->fragment_download_lock);
+    return ret;
+  }
+  g_mutex_unlock (&stream->fragment_download_lock);
+
+  return stream->last_ret;
+}
+
 /* must be called with manifest_lock taken.
  * Can temporarily release manifest_lock
  */
@@ -2644,6 +3254,7 @@ gst_adaptive_demux_stream_download_fragment (GstAdaptiveDemuxStream * stream)
   stream->starting_fragment = TRUE;
   stream->last_ret = GST_FLOW_OK;
   stream->first_fragment_buffer = TRUE;
+  stream->prefetch_bitrate = 0;
 
   if (stream->fragment.uri == NULL && stream->fragment.header_uri == NULL &&
       stream->fragment.index_uri == NULL)
@@ -2660,9 +3271,19 @@ gst_adaptive_demux_stream_download_fragment (GstAdaptiveDemuxStream * stream)
   url = stream->fragment.uri;
   GST_DEBUG_OBJECT (stream->pad, "Got url '%s' for stream %p", url, stream);
   if (url) {
-    ret =
-        gst_adaptive_demux_stream_download_uri (demux, stream, url,
-        stream->fragment.range_start, stream->fragment.range_end);
+    GstAdaptiveDemuxPrefetch *prefetch = NULL;
+
+    /* the internal pad is only there once a fragment was downloaded */
+    if (stream->internal_pad)
+      prefetch = gst_adaptive_demux_stream_take_prefetch (demux, stream, url,
+          stream->fragment.range_start, stream->fragment.range_end);
+
+    if (prefetch)
+      ret = gst_adaptive_demux_stream_push_prefetch (demux, stream, prefetch);
+    else
+      ret =
+          gst_adaptive_demux_stream_download_uri (demux, stream, url,
+          stream->fragment.range_start, stream->fragment.range_end);
     GST_DEBUG_OBJECT (stream->pad, "Fragment download result: %d %s",
         stream->last_ret, gst_flow_get_name (stream->last_ret));
     if (ret != GST_FLOW_OK) {
@@ -2892,6 +3513,8 @@ gst_adaptive_demux_stream_download_loop (GstAdaptiveDemuxStream * stream)
 
     stream->last_ret = GST_FLOW_OK;
 
+    gst_adaptive_demux_stream_schedule_prefetch (demux, stream);
+
     next_download = gst_adaptive_demux_get_monotonic_time (demux);
     ret = gst_adaptive_demux_stream_download_fragment (stream);
 
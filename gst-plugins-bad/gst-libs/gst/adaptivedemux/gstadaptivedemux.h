@@ -81,6 +81,35 @@ G_BEGIN_DECLS
   g_clear_error (&err); \
 } G_STMT_END
 
+#define GST_TYPE_ADAPTIVE_DEMUX_ABR_POLICY \
+  (gst_adaptive_demux_abr_policy_get_type())
+
+/**
+ * GstAdaptiveDemuxAbrPolicy:
+ * @GST_ADAPTIVE_DEMUX_ABR_POLICY_MOVING_AVERAGE: minimum of the last fragment
+ *   download rate and the average over the last fragments
+ * @GST_ADAPTIVE_DEMUX_ABR_POLICY_EWMA: minimum of a fast and a slow
+ *   exponentially weighted moving average of the throughput, weighted by
+ *   the download time of each fragment
+ * @GST_ADAPTIVE_DEMUX_ABR_POLICY_HARMONIC_MEAN: harmonic mean of the
+ *   throughput of the last fragments
+ * @GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER_BASED: the EWMA estimate, scaled
+ *   down when little data is buffered ahead of the playback position and
+ *   up when a lot is
+ *
+ * How the bitrate passed to #GstAdaptiveDemuxClass.stream_select_bitrate()
+ * is estimated from the fragment downloads.
+ */
+typedef enum
+{
+  GST_ADAPTIVE_DEMUX_ABR_POLICY_MOVING_AVERAGE,
+  GST_ADAPTIVE_DEMUX_ABR_POLICY_EWMA,
+  GST_ADAPTIVE_DEMUX_ABR_POLICY_HARMONIC_MEAN,
+  GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER_BASED
+} GstAdaptiveDemuxAbrPolicy;
+
+#define GST_ADAPTIVE_DEMUX_ABR_HARMONIC_SAMPLES 5
+
 typedef struct _GstAdaptiveDemuxStreamFragment GstAdaptiveDemuxStreamFragment;
 typedef struct _GstAdaptiveDemuxStream GstAdaptiveDemuxStream;
 typedef struct _GstAdaptiveDemux GstAdaptiveDemux;
@@ -160,11 +189,29 @@ struct _GstAdaptiveDemuxStream
   gint64 download_total_bytes;
   guint64 current_download_rate;
 
+  /* fragments fetched ahead of the current one */
+  GMutex prefetch_lock;
+  GCond prefetch_cond;
+  GQueue prefetch_queue;        /* protected by prefetch_lock */
+  guint64 prefetch_bytes;       /* protected by prefetch_lock */
+  guint prefetch_pending;       /* protected by prefetch_lock */
+  guint64 prefetch_bitrate;
+
   /* Average for the last fragments */
   guint64 moving_bitrate;
   guint moving_index;
   guint64 *fragment_bitrates;
 
+  /* Throughput estimators of the other ABR policies, fed with the bytes
+   * received and the time spent receiving them since the last sample */
+  gint64 abr_sample_bytes;
+  gint64 abr_sample_time;
+  gdouble ewma_fast;
+  gdouble ewma_slow;
+  gdouble ewma_total_weight;
+  guint64 harmonic_samples[GST_ADAPTIVE_DEMUX_ABR_HARMONIC_SAMPLES];
+  guint harmonic_index;
+
   GstAdaptiveDemuxStreamFragment fragment;
 
   guint download_error_count;
@@ -429,9 +476,26 @@ struct _GstAdaptiveDemuxClass
    * selected period.
    */
   GstClockTime (*get_period_start_time) (GstAdaptiveDemux *demux);
+
+  /**
+   * stream_peek_fragment:
+   * @stream: #GstAdaptiveDemuxStream
+   * @n: position of the fragment after the current one, starting at 1
+   * @uri: (out): location for the uri of the fragment
+   * @range_start: (out): location for the first byte of the fragment
+   * @range_end: (out): location for the last byte of the fragment, or -1
+   *
+   * Optional. Gets the location of a fragment that will be downloaded after
+   * the current one, without changing the state of @stream. Used to fetch
+   * fragments ahead of time when prefetching is enabled.
+   *
+   * Returns: %TRUE if the fragment is known
+   */
+  gboolean (*stream_peek_fragment) (GstAdaptiveDemuxStream * stream, guint n, gchar ** uri, gint64 * range_start, gint64 * range_end);
 };
 
 GType    gst_adaptive_demux_get_type (void);
+GType    gst_adaptive_demux_abr_policy_get_type (void);
 
 void     gst_adaptive_demux_set_stream_struct_size (GstAdaptiveDemux * demux,
                                                     gsize struct_size);
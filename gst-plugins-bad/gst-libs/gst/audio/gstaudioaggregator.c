@@ -144,6 +144,11 @@ struct _GstAudioAggregatorPrivate
   /* Buffer starting at offset containing block_size frames */
   GstBuffer *current_buffer;
 
+  /* Read-only silence shared by all output buffers until something is mixed
+   * into them, protected by the aagg lock */
+  GstMemory *silence;
+  GstAudioFormat silence_format;
+
   /* counters to keep track of timestamps */
   /* Readable with object lock, writable with both aag lock and object lock */
 
@@ -689,6 +694,10 @@ gst_audio_aggregator_reset (GstAudioAggregator * aagg)
   gst_audio_info_init (&aagg->info);
   gst_caps_replace (&aagg->current_caps, NULL);
   gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+  if (aagg->priv->silence) {
+    gst_memory_unref (aagg->priv->silence);
+    aagg->priv->silence = NULL;
+  }
   GST_OBJECT_UNLOCK (aagg);
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
 }
@@ -1006,17 +1015,37 @@ gst_audio_aggregator_mix_buffer (GstAudioAggregator * aagg,
   return TRUE;
 }
 
+/* Called with the aagg lock held.
+ *
+ * The output buffer wraps a read-only silence memory that is only filled
+ * once. Mapping it for writing to mix something in makes a private copy, so
+ * buffers that stay silence, e.g. because all inputs were GAP, muted or at
+ * volume 0, are pushed without allocating or filling any memory */
 static GstBuffer *
 gst_audio_aggregator_create_output_buffer (GstAudioAggregator * aagg,
     guint num_frames)
 {
-  GstBuffer *outbuf = gst_buffer_new_allocate (NULL, num_frames *
-      GST_AUDIO_INFO_BPF (&aagg->info), NULL);
-  GstMapInfo outmap;
+  GstAudioAggregatorPrivate *priv = aagg->priv;
+  gsize size = num_frames * GST_AUDIO_INFO_BPF (&aagg->info);
+  GstBuffer *outbuf;
+
+  if (priv->silence == NULL || priv->silence->size != size ||
+      priv->silence_format != GST_AUDIO_INFO_FORMAT (&aagg->info)) {
+    GstMapInfo map;
+
+    if (priv->silence)
+      gst_memory_unref (priv->silence);
+
+    priv->silence = gst_allocator_alloc (NULL, size, NULL);
+    gst_memory_map (priv->silence, &map, GST_MAP_WRITE);
+    gst_audio_format_fill_silence (aagg->info.finfo, map.data, map.size);
+    gst_memory_unmap (priv->silence, &map);
+    GST_MINI_OBJECT_FLAG_SET (priv->silence, GST_MEMORY_FLAG_READONLY);
+    priv->silence_format = GST_AUDIO_INFO_FORMAT (&aagg->info);
+  }
 
-  gst_buffer_map (outbuf, &outmap, GST_MAP_WRITE);
-  gst_audio_format_fill_silence (aagg->info.finfo, outmap.data, outmap.size);
-  gst_buffer_unmap (outbuf, &outmap);
+  outbuf = gst_buffer_new ();
+  gst_buffer_append_memory (outbuf, gst_memory_ref (priv->silence));
 
   return outbuf;
 }
@@ -146,16 +146,22 @@ GST_DEBUG_CATEGORY_STATIC (aggregator_debug);
 #define PAD_WAIT_EVENT(pad)   G_STMT_START {                            \
   GST_LOG_OBJECT (pad, "Waiting for buffer to be consumed thread %p",   \
         g_thread_self());                                               \
+  ((GstAggregatorPad*)pad)->priv->n_waiters++;                          \
   g_cond_wait(&(((GstAggregatorPad* )pad)->priv->event_cond),           \
       (&((GstAggregatorPad*)pad)->priv->lock));                         \
+  ((GstAggregatorPad*)pad)->priv->n_waiters--;                          \
   GST_LOG_OBJECT (pad, "DONE Waiting for buffer to be consumed on thread %p", \
         g_thread_self());                                               \
   } G_STMT_END
 
+/* Only signal if the streaming thread of the pad is actually waiting,
+ * which is not the case for most consumed buffers */
 #define PAD_BROADCAST_EVENT(pad) G_STMT_START {                        \
-  GST_LOG_OBJECT (pad, "Signaling buffer consumed from thread %p",     \
-        g_thread_self());                                              \
-  g_cond_broadcast(&(((GstAggregatorPad* )pad)->priv->event_cond));    \
+  if (((GstAggregatorPad* )pad)->priv->n_waiters > 0) {                \
+    GST_LOG_OBJECT (pad, "Signaling buffer consumed from thread %p",   \
+          g_thread_self());                                            \
+    g_cond_broadcast(&(((GstAggregatorPad* )pad)->priv->event_cond));  \
+  }                                                                    \
   } G_STMT_END
 
 
@@ -227,6 +233,9 @@ struct _GstAggregatorPadPrivate
 
   gboolean eos;
 
+  /* number of threads blocked in PAD_WAIT_EVENT */
+  guint n_waiters;
+
   GMutex lock;
   GCond event_cond;
   /* This lock prevents a flush start processing happening while
@@ -2168,6 +2177,8 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
     PAD_LOCK (aggpad);
     if (gst_aggregator_pad_has_space (self, aggpad)
         && aggpad->priv->flow_return == GST_FLOW_OK) {
+      gboolean was_empty = gst_aggregator_pad_queue_is_empty (aggpad);
+
       if (head)
         g_queue_push_head (&aggpad->priv->buffers, actual_buf);
       else
@@ -2175,7 +2186,13 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
       apply_buffer (aggpad, actual_buf, head);
       aggpad->priv->num_buffers++;
       actual_buf = buffer = NULL;
-      SRC_BROADCAST (self);
+
+      /* The aggregate thread only ever waits while at least one pad has
+       * an empty queue, so only wake it up (and unschedule the live
+       * deadline) when this pad just got data. Queueing more buffers
+       * behind already queued data can't make the pads ready. */
+      if (was_empty)
+        SRC_BROADCAST (self);
       break;
     }
 
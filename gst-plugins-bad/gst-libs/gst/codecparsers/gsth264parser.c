@@ -1215,6 +1215,53 @@ error:
 
 /******** API *************/
 
+typedef struct
+{
+  NalParamSetCacheEntry sps[GST_H264_MAX_SPS_COUNT];
+  NalParamSetCacheEntry pps[GST_H264_MAX_PPS_COUNT];
+} GstH264ParamSetCache;
+
+/* If @nalu is an exact repeat of the NAL unit a stored SPS was parsed from,
+ * fills @sps from the stored one instead of parsing it again */
+static gboolean
+gst_h264_parser_lookup_sps (GstH264NalParser * nalparser,
+    GstH264NalUnit * nalu, GstH264SPS * sps, gboolean parse_vui_params,
+    guint32 * checksum)
+{
+  GstH264ParamSetCache *cache = nalparser->param_set_cache;
+  const guint8 *data = nalu->data + nalu->offset;
+  gint id;
+
+  *checksum = nal_param_set_checksum (data, nalu->size);
+  id = nal_param_set_cache_lookup (cache->sps, GST_H264_MAX_SPS_COUNT, data,
+      nalu->size, *checksum);
+  if (id < 0 || !nalparser->sps[id].valid ||
+      (parse_vui_params && !cache->sps[id].full))
+    return FALSE;
+
+  memset (sps, 0, sizeof (*sps));
+  if (!gst_h264_sps_copy (sps, &nalparser->sps[id]))
+    return FALSE;
+
+  GST_DEBUG ("sequence parameter set with id: %d unchanged", id);
+  nalparser->last_sps = &nalparser->sps[id];
+
+  return TRUE;
+}
+
+static void
+gst_h264_parser_cache_sps (GstH264NalParser * nalparser,
+    GstH264NalUnit * nalu, gint id, guint32 checksum, gboolean parse_vui_params)
+{
+  GstH264ParamSetCache *cache = nalparser->param_set_cache;
+
+  nal_param_set_cache_store (&cache->sps[id], nalu->data + nalu->offset,
+      nalu->size, checksum, parse_vui_params);
+
+  /* PPS parsed against the previous SPS with this id are outdated now */
+  nal_param_set_cache_clear (cache->pps, GST_H264_MAX_PPS_COUNT);
+}
+
 /**
  * gst_h264_nal_parser_new:
  *
@@ -1229,6 +1276,7 @@ gst_h264_nal_parser_new (void)
   GstH264NalParser *nalparser;
 
   nalparser = g_slice_new0 (GstH264NalParser);
+  nalparser->param_set_cache = g_new0 (GstH264ParamSetCache, 1);
   INITIALIZE_DEBUG_CATEGORY;
 
   return nalparser;
@@ -1243,12 +1291,17 @@ gst_h264_nal_parser_new (void)
 void
 gst_h264_nal_parser_free (GstH264NalParser * nalparser)
 {
+  GstH264ParamSetCache *cache;
   guint i;
 
   for (i = 0; i < GST_H264_MAX_SPS_COUNT; i++)
     gst_h264_sps_clear (&nalparser->sps[i]);
   for (i = 0; i < GST_H264_MAX_PPS_COUNT; i++)
     gst_h264_pps_clear (&nalparser->pps[i]);
+  cache = nalparser->param_set_cache;
+  nal_param_set_cache_clear (cache->sps, GST_H264_MAX_SPS_COUNT);
+  nal_param_set_cache_clear (cache->pps, GST_H264_MAX_PPS_COUNT);
+  g_free (cache);
   g_slice_free (GstH264NalParser, nalparser);
 
   nalparser = NULL;
@@ -1472,13 +1525,23 @@ gst_h264_parser_parse_nal (GstH264NalParser * nalparser, GstH264NalUnit * nalu)
  *
  * Parses @data, and fills the @sps structure.
  *
+ * If @nalu is identical to the NAL unit a stored SPS was parsed from, @sps
+ * is filled from the stored SPS without parsing @nalu again.
+ *
  * Returns: a #GstH264ParserResult
  */
 GstH264ParserResult
 gst_h264_parser_parse_sps (GstH264NalParser * nalparser, GstH264NalUnit * nalu,
     GstH264SPS * sps, gboolean parse_vui_params)
 {
-  GstH264ParserResult res = gst_h264_parse_sps (nalu, sps, parse_vui_params);
+  GstH264ParserResult res;
+  guint32 checksum;
+
+  if (gst_h264_parser_lookup_sps (nalparser, nalu, sps, parse_vui_params,
+          &checksum))
+    return GST_H264_PARSER_OK;
+
+  res = gst_h264_parse_sps (nalu, sps, parse_vui_params);
 
   if (res == GST_H264_PARSER_OK) {
     GST_DEBUG ("adding sequence parameter set with id: %d to array", sps->id);
@@ -1486,6 +1549,8 @@ gst_h264_parser_parse_sps (GstH264NalParser * nalparser, GstH264NalUnit * nalu,
     if (!gst_h264_sps_copy (&nalparser->sps[sps->id], sps))
       return GST_H264_PARSER_ERROR;
     nalparser->last_sps = &nalparser->sps[sps->id];
+    gst_h264_parser_cache_sps (nalparser, nalu, sps->id, checksum,
+        parse_vui_params);
   }
   return res;
 }
@@ -1818,6 +1883,11 @@ gst_h264_parser_parse_subset_sps (GstH264NalParser * nalparser,
     GstH264NalUnit * nalu, GstH264SPS * sps, gboolean parse_vui_params)
 {
   GstH264ParserResult res;
+  guint32 checksum;
+
+  if (gst_h264_parser_lookup_sps (nalparser, nalu, sps, parse_vui_params,
+          &checksum))
+    return GST_H264_PARSER_OK;
 
   res = gst_h264_parse_subset_sps (nalu, sps, parse_vui_params);
   if (res == GST_H264_PARSER_OK) {
@@ -1828,6 +1898,8 @@ gst_h264_parser_parse_subset_sps (GstH264NalParser * nalparser,
       return GST_H264_PARSER_ERROR;
     }
     nalparser->last_sps = &nalparser->sps[sps->id];
+    gst_h264_parser_cache_sps (nalparser, nalu, sps->id, checksum,
+        parse_vui_params);
   }
   return res;
 }
@@ -2033,13 +2105,35 @@ error:
  * gst_h264_pps_clear() function when it is no longer needed, or prior
  * to parsing a new PPS NAL unit.
  *
+ * If @nalu is identical to the NAL unit a stored PPS was parsed from, and
+ * its SPS did not change since, @pps is filled from the stored PPS without
+ * parsing @nalu again.
+ *
  * Returns: a #GstH264ParserResult
  */
 GstH264ParserResult
 gst_h264_parser_parse_pps (GstH264NalParser * nalparser,
     GstH264NalUnit * nalu, GstH264PPS * pps)
 {
-  GstH264ParserResult res = gst_h264_parse_pps (nalparser, nalu, pps);
+  GstH264ParamSetCache *cache = nalparser->param_set_cache;
+  const guint8 *data = nalu->data + nalu->offset;
+  GstH264ParserResult res;
+  guint32 checksum;
+  gint id;
+
+  checksum = nal_param_set_checksum (data, nalu->size);
+  id = nal_param_set_cache_lookup (cache->pps, GST_H264_MAX_PPS_COUNT, data,
+      nalu->size, checksum);
+  if (id >= 0 && nalparser->pps[id].valid) {
+    memset (pps, 0, sizeof (*pps));
+    if (gst_h264_pps_copy (pps, &nalparser->pps[id])) {
+      GST_DEBUG ("picture parameter set with id: %d unchanged", id);
+      nalparser->last_pps = &nalparser->pps[id];
+      return GST_H264_PARSER_OK;
+    }
+  }
+
+  res = gst_h264_parse_pps (nalparser, nalu, pps);
 
   if (res == GST_H264_PARSER_OK) {
     GST_DEBUG ("adding picture parameter set with id: %d to array", pps->id);
@@ -2047,6 +2141,8 @@ gst_h264_parser_parse_pps (GstH264NalParser * nalparser,
     if (!gst_h264_pps_copy (&nalparser->pps[pps->id], pps))
       return GST_H264_PARSER_ERROR;
     nalparser->last_pps = &nalparser->pps[pps->id];
+    nal_param_set_cache_store (&cache->pps[pps->id], data, nalu->size,
+        checksum, TRUE);
   }
 
   return res;
@@ -2069,22 +2165,11 @@ gst_h264_pps_clear (GstH264PPS * pps)
   pps->slice_group_id = NULL;
 }
 
-/**
- * gst_h264_parser_parse_slice_hdr:
- * @nalparser: a #GstH264NalParser
- * @nalu: The #GST_H264_NAL_SLICE #GstH264NalUnit to parse
- * @slice: The #GstH264SliceHdr to fill.
- * @parse_pred_weight_table: Whether to parse the pred_weight_table or not
- * @parse_dec_ref_pic_marking: Whether to parse the dec_ref_pic_marking or not
- *
- * Parses @data, and fills the @slice structure.
- *
- * Returns: a #GstH264ParserResult
- */
-GstH264ParserResult
-gst_h264_parser_parse_slice_hdr (GstH264NalParser * nalparser,
-    GstH264NalUnit * nalu, GstH264SliceHdr * slice,
-    gboolean parse_pred_weight_table, gboolean parse_dec_ref_pic_marking)
+/* With @minimal, stops after the syntax elements needed to detect the first
+ * slice of a new picture (7.4.1.2.4) */
+static GstH264ParserResult
+gst_h264_parse_slice_hdr (GstH264NalParser * nalparser,
+    GstH264NalUnit * nalu, GstH264SliceHdr * slice, gboolean minimal)
 {
   NalReader nr;
   gint pps_id;
@@ -2172,6 +2257,9 @@ gst_h264_parser_parse_slice_hdr (GstH264NalParser * nalparser,
   if (pps->redundant_pic_cnt_present_flag)
     READ_UE_MAX (&nr, slice->redundant_pic_cnt, G_MAXINT8);
 
+  if (minimal)
+    return GST_H264_PARSER_OK;
+
   if (GST_H264_IS_B_SLICE (slice))
     READ_UINT8 (&nr, slice->direct_spatial_mv_pred_flag, 1);
 
@@ -2248,6 +2336,51 @@ error:
   return GST_H264_PARSER_ERROR;
 }
 
+/**
+ * gst_h264_parser_parse_slice_hdr:
+ * @nalparser: a #GstH264NalParser
+ * @nalu: The #GST_H264_NAL_SLICE #GstH264NalUnit to parse
+ * @slice: The #GstH264SliceHdr to fill.
+ * @parse_pred_weight_table: Whether to parse the pred_weight_table or not
+ * @parse_dec_ref_pic_marking: Whether to parse the dec_ref_pic_marking or not
+ *
+ * Parses @data, and fills the @slice structure.
+ *
+ * Returns: a #GstH264ParserResult
+ */
+GstH264ParserResult
+gst_h264_parser_parse_slice_hdr (GstH264NalParser * nalparser,
+    GstH264NalUnit * nalu, GstH264SliceHdr * slice,
+    gboolean parse_pred_weight_table, gboolean parse_dec_ref_pic_marking)
+{
+  return gst_h264_parse_slice_hdr (nalparser, nalu, slice, FALSE);
+}
+
+/**
+ * gst_h264_parser_parse_slice_hdr_minimal:
+ * @nalparser: a #GstH264NalParser
+ * @nalu: The #GST_H264_NAL_SLICE #GstH264NalUnit to parse
+ * @slice: The #GstH264SliceHdr to fill.
+ *
+ * Parses the beginning of the slice header in @nalu, up to and including
+ * redundant_pic_cnt, and fills those fields of @slice. That covers the slice
+ * type, frame_num, the field flags, idr_pic_id and the picture order count
+ * fields, which is all that is needed to find picture boundaries. It skips
+ * the reference list modifications, the prediction weight table and the
+ * reference picture marking. All other fields of @slice, including
+ * header_size, are left at 0.
+ *
+ * Returns: a #GstH264ParserResult
+ *
+ * Since: 1.10
+ */
+GstH264ParserResult
+gst_h264_parser_parse_slice_hdr_minimal (GstH264NalParser * nalparser,
+    GstH264NalUnit * nalu, GstH264SliceHdr * slice)
+{
+  return gst_h264_parse_slice_hdr (nalparser, nalu, slice, TRUE);
+}
+
 /* Free MVC-specific data from subset SPS header */
 static void
 gst_h264_sps_mvc_clear (GstH264SPS * sps)
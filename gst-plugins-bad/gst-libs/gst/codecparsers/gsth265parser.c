@@ -1102,6 +1102,13 @@ error:
 
 /******** API *************/
 
+typedef struct
+{
+  NalParamSetCacheEntry vps[GST_H265_MAX_VPS_COUNT];
+  NalParamSetCacheEntry sps[GST_H265_MAX_SPS_COUNT];
+  NalParamSetCacheEntry pps[GST_H265_MAX_PPS_COUNT];
+} GstH265ParamSetCache;
+
 /**
  * gst_h265_parser_new:
  *
@@ -1116,6 +1123,7 @@ gst_h265_parser_new (void)
   GstH265Parser *parser;
 
   parser = g_slice_new0 (GstH265Parser);
+  parser->param_set_cache = g_new0 (GstH265ParamSetCache, 1);
   INITIALIZE_DEBUG_CATEGORY;
 
   return parser;
@@ -1130,6 +1138,12 @@ gst_h265_parser_new (void)
 void
 gst_h265_parser_free (GstH265Parser * parser)
 {
+  GstH265ParamSetCache *cache = parser->param_set_cache;
+
+  nal_param_set_cache_clear (cache->vps, GST_H265_MAX_VPS_COUNT);
+  nal_param_set_cache_clear (cache->sps, GST_H265_MAX_SPS_COUNT);
+  nal_param_set_cache_clear (cache->pps, GST_H265_MAX_PPS_COUNT);
+  g_free (cache);
   g_slice_free (GstH265Parser, parser);
   parser = NULL;
 }
@@ -1353,19 +1367,44 @@ gst_h265_parser_parse_nal (GstH265Parser * parser, GstH265NalUnit * nalu)
  *
  * Parses @data, and fills the @vps structure.
  *
+ * If @nalu is identical to the NAL unit a stored VPS was parsed from, @vps
+ * is filled from the stored VPS without parsing @nalu again.
+ *
  * Returns: a #GstH265ParserResult
  */
 GstH265ParserResult
 gst_h265_parser_parse_vps (GstH265Parser * parser, GstH265NalUnit * nalu,
     GstH265VPS * vps)
 {
-  GstH265ParserResult res = gst_h265_parse_vps (nalu, vps);
+  GstH265ParamSetCache *cache = parser->param_set_cache;
+  const guint8 *data = nalu->data + nalu->offset;
+  GstH265ParserResult res;
+  guint32 checksum;
+  gint id;
+
+  checksum = nal_param_set_checksum (data, nalu->size);
+  id = nal_param_set_cache_lookup (cache->vps, GST_H265_MAX_VPS_COUNT, data,
+      nalu->size, checksum);
+  if (id >= 0 && parser->vps[id].valid) {
+    GST_DEBUG ("video parameter set with id: %d unchanged", id);
+    *vps = parser->vps[id];
+    parser->last_vps = &parser->vps[id];
+    return GST_H265_PARSER_OK;
+  }
+
+  res = gst_h265_parse_vps (nalu, vps);
 
   if (res == GST_H265_PARSER_OK) {
     GST_DEBUG ("adding video parameter set with id: %d to array", vps->id);
 
     parser->vps[vps->id] = *vps;
     parser->last_vps = &parser->vps[vps->id];
+    nal_param_set_cache_store (&cache->vps[vps->id], data, nalu->size,
+        checksum, TRUE);
+
+    /* SPS and PPS parsed against the previous VPS are outdated now */
+    nal_param_set_cache_clear (cache->sps, GST_H265_MAX_SPS_COUNT);
+    nal_param_set_cache_clear (cache->pps, GST_H265_MAX_PPS_COUNT);
   }
 
   return res;
@@ -1488,20 +1527,45 @@ error:
  *
  * Parses @data, and fills the @sps structure.
  *
+ * If @nalu is identical to the NAL unit a stored SPS was parsed from, and
+ * its VPS did not change since, @sps is filled from the stored SPS without
+ * parsing @nalu again.
+ *
  * Returns: a #GstH265ParserResult
  */
 GstH265ParserResult
 gst_h265_parser_parse_sps (GstH265Parser * parser, GstH265NalUnit * nalu,
     GstH265SPS * sps, gboolean parse_vui_params)
 {
-  GstH265ParserResult res =
-      gst_h265_parse_sps (parser, nalu, sps, parse_vui_params);
+  GstH265ParamSetCache *cache = parser->param_set_cache;
+  const guint8 *data = nalu->data + nalu->offset;
+  GstH265ParserResult res;
+  guint32 checksum;
+  gint id;
+
+  checksum = nal_param_set_checksum (data, nalu->size);
+  id = nal_param_set_cache_lookup (cache->sps, GST_H265_MAX_SPS_COUNT, data,
+      nalu->size, checksum);
+  if (id >= 0 && parser->sps[id].valid &&
+      (cache->sps[id].full || !parse_vui_params)) {
+    GST_DEBUG ("sequence parameter set with id: %d unchanged", id);
+    *sps = parser->sps[id];
+    parser->last_sps = &parser->sps[id];
+    return GST_H265_PARSER_OK;
+  }
+
+  res = gst_h265_parse_sps (parser, nalu, sps, parse_vui_params);
 
   if (res == GST_H265_PARSER_OK) {
     GST_DEBUG ("adding sequence parameter set with id: %d to array", sps->id);
 
     parser->sps[sps->id] = *sps;
     parser->last_sps = &parser->sps[sps->id];
+    nal_param_set_cache_store (&cache->sps[sps->id], data, nalu->size,
+        checksum, parse_vui_params);
+
+    /* PPS parsed against the previous SPS with this id are outdated now */
+    nal_param_set_cache_clear (cache->pps, GST_H265_MAX_PPS_COUNT);
   }
 
   return res;
@@ -1872,38 +1936,50 @@ error:
  *
  * Parses @data, and fills the @pps structure.
  *
+ * If @nalu is identical to the NAL unit a stored PPS was parsed from, and
+ * its SPS did not change since, @pps is filled from the stored PPS without
+ * parsing @nalu again.
+ *
  * Returns: a #GstH265ParserResult
  */
 GstH265ParserResult
 gst_h265_parser_parse_pps (GstH265Parser * parser,
     GstH265NalUnit * nalu, GstH265PPS * pps)
 {
-  GstH265ParserResult res = gst_h265_parse_pps (parser, nalu, pps);
+  GstH265ParamSetCache *cache = parser->param_set_cache;
+  const guint8 *data = nalu->data + nalu->offset;
+  GstH265ParserResult res;
+  guint32 checksum;
+  gint id;
+
+  checksum = nal_param_set_checksum (data, nalu->size);
+  id = nal_param_set_cache_lookup (cache->pps, GST_H265_MAX_PPS_COUNT, data,
+      nalu->size, checksum);
+  if (id >= 0 && parser->pps[id].valid) {
+    GST_DEBUG ("picture parameter set with id: %d unchanged", id);
+    *pps = parser->pps[id];
+    parser->last_pps = &parser->pps[id];
+    return GST_H265_PARSER_OK;
+  }
+
+  res = gst_h265_parse_pps (parser, nalu, pps);
   if (res == GST_H265_PARSER_OK) {
     GST_DEBUG ("adding picture parameter set with id: %d to array", pps->id);
 
     parser->pps[pps->id] = *pps;
     parser->last_pps = &parser->pps[pps->id];
+    nal_param_set_cache_store (&cache->pps[pps->id], data, nalu->size,
+        checksum, TRUE);
   }
 
   return res;
 }
 
-/**
- * gst_h265_parser_parse_slice_hdr:
- * @parser: a #GstH265Parser
- * @nalu: The #GST_H265_NAL_SLICE #GstH265NalUnit to parse
- * @slice: The #GstH265SliceHdr to fill.
- *
- * Parses @data, and fills the @slice structure.
- * The resulting @slice_hdr structure shall be deallocated with
- * gst_h265_slice_hdr_free() when it is no longer needed
- *
- * Returns: a #GstH265ParserResult
- */
-GstH265ParserResult
-gst_h265_parser_parse_slice_hdr (GstH265Parser * parser,
-    GstH265NalUnit * nalu, GstH265SliceHdr * slice)
+/* With @minimal, stops after the slice type and the syntax elements right
+ * after it, before anything that would need to be allocated */
+static GstH265ParserResult
+gst_h265_parse_slice_hdr (GstH265Parser * parser,
+    GstH265NalUnit * nalu, GstH265SliceHdr * slice, gboolean minimal)
 {
   NalReader nr;
   gint pps_id;
@@ -1980,7 +2056,12 @@ gst_h265_parser_parse_slice_hdr (GstH265Parser * parser,
       READ_UINT8 (&nr, slice->pic_output_flag, 1);
     if (sps->separate_colour_plane_flag == 1)
       READ_UINT8 (&nr, slice->colour_plane_id, 2);
+  }
+
+  if (minimal)
+    return GST_H265_PARSER_OK;
 
+  if (!slice->dependent_slice_segment_flag) {
     if ((nalu->type != GST_H265_NAL_SLICE_IDR_W_RADL)
         && (nalu->type != GST_H265_NAL_SLICE_IDR_N_LP)) {
       READ_UINT16 (&nr, slice->pic_order_cnt_lsb,
@@ -2188,6 +2269,49 @@ error:
   return GST_H265_PARSER_ERROR;
 }
 
+/**
+ * gst_h265_parser_parse_slice_hdr:
+ * @parser: a #GstH265Parser
+ * @nalu: The #GST_H265_NAL_SLICE #GstH265NalUnit to parse
+ * @slice: The #GstH265SliceHdr to fill.
+ *
+ * Parses @data, and fills the @slice structure.
+ * The resulting @slice_hdr structure shall be deallocated with
+ * gst_h265_slice_hdr_free() when it is no longer needed
+ *
+ * Returns: a #GstH265ParserResult
+ */
+GstH265ParserResult
+gst_h265_parser_parse_slice_hdr (GstH265Parser * parser,
+    GstH265NalUnit * nalu, GstH265SliceHdr * slice)
+{
+  return gst_h265_parse_slice_hdr (parser, nalu, slice, FALSE);
+}
+
+/**
+ * gst_h265_parser_parse_slice_hdr_minimal:
+ * @parser: a #GstH265Parser
+ * @nalu: The #GST_H265_NAL_SLICE #GstH265NalUnit to parse
+ * @slice: The #GstH265SliceHdr to fill.
+ *
+ * Parses the beginning of the slice segment header in @nalu, up to and
+ * including colour_plane_id, and fills those fields of @slice. That covers
+ * first_slice_segment_in_pic_flag, the segment address and the slice type,
+ * which is all that is needed to find picture boundaries and key frames.
+ * All other fields of @slice, including header_size, are left at 0, and
+ * nothing is allocated, so @slice does not need to be freed.
+ *
+ * Returns: a #GstH265ParserResult
+ *
+ * Since: 1.10
+ */
+GstH265ParserResult
+gst_h265_parser_parse_slice_hdr_minimal (GstH265Parser * parser,
+    GstH265NalUnit * nalu, GstH265SliceHdr * slice)
+{
+  return gst_h265_parse_slice_hdr (parser, nalu, slice, TRUE);
+}
+
 static gboolean
 nal_reader_has_more_data_in_payload (NalReader * nr,
     guint32 payload_start_pos_bit, guint32 payloadSize)
@@ -995,6 +995,9 @@ struct _GstH265Parser
   GstH265VPS *last_vps;
   GstH265SPS *last_sps;
   GstH265PPS *last_pps;
+
+  /* NAL units the stored parameter sets were parsed from */
+  gpointer param_set_cache;
 };
 
 GstH265Parser *     gst_h265_parser_new               (void);
@@ -1025,6 +1028,10 @@ GstH265ParserResult gst_h265_parser_parse_slice_hdr (GstH265Parser   * parser,
                                                      GstH265NalUnit  * nalu,
                                                      GstH265SliceHdr * slice);
 
+GstH265ParserResult gst_h265_parser_parse_slice_hdr_minimal (GstH265Parser   * parser,
+                                                     GstH265NalUnit  * nalu,
+                                                     GstH265SliceHdr * slice);
+
 GstH265ParserResult gst_h265_parser_parse_vps       (GstH265Parser   * parser,
                                                      GstH265NalUnit  * nalu,
                                                      GstH265VPS      * vps);
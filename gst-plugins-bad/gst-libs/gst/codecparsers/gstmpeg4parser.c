@@ -38,6 +38,7 @@
 
 #include "gstmpeg4parser.h"
 #include "parserutils.h"
+#include "nalutils.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 
@@ -350,6 +351,21 @@ compute_resync_marker_size (const GstMpeg4VideoObjectPlane * vop,
   return off + 1;               /* Take the following 1 into account */
 }
 
+/* Returns the offset in @data of the first 0x000001 start code found in the
+ * @size bytes from @offset that is followed by a start code value, or -1 */
+static inline gint
+scan_for_packet_start (const guint8 * data, guint offset, guint size)
+{
+  gint off;
+
+  if (size < 4)
+    return -1;
+
+  off = scan_for_start_codes (data + offset, size - 1);
+
+  return off < 0 ? -1 : offset + off;
+}
+
 /**
  * gst_mpeg4_next_resync:
  * @packet: The #GstMpeg4Packet to fill
@@ -429,12 +445,9 @@ gst_mpeg4_parse (GstMpeg4Packet * packet, gboolean skip_user_data,
     gsize size)
 {
   gint off1, off2;
-  GstByteReader br;
   GstMpeg4ParseResult resync_res;
   static guint first_resync_marker = TRUE;
 
-  gst_byte_reader_init (&br, data, size);
-
   g_return_val_if_fail (packet != NULL, GST_MPEG4_PARSER_ERROR);
 
   if (size - offset <= 4) {
@@ -462,8 +475,7 @@ gst_mpeg4_parse (GstMpeg4Packet * packet, gboolean skip_user_data,
     first_resync_marker = TRUE;
   }
 
-  off1 = gst_byte_reader_masked_scan_uint32 (&br, 0xffffff00, 0x00000100,
-      offset, size - offset);
+  off1 = scan_for_packet_start (data, offset, size - offset);
 
   if (off1 == -1) {
     GST_DEBUG ("No start code prefix in this buffer");
@@ -482,8 +494,7 @@ gst_mpeg4_parse (GstMpeg4Packet * packet, gboolean skip_user_data,
 
 find_end:
   if (off1 < size - 4)
-    off2 = gst_byte_reader_masked_scan_uint32 (&br, 0xffffff00, 0x00000100,
-        off1 + 4, size - off1 - 4);
+    off2 = scan_for_packet_start (data, off1 + 4, size - off1 - 4);
   else
     off2 = -1;
 
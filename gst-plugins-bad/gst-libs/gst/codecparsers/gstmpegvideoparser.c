@@ -41,6 +41,7 @@
 
 #include "gstmpegvideoparser.h"
 #include "parserutils.h"
+#include "nalutils.h"
 
 #include <string.h>
 #include <gst/base/gstbitreader.h>
@@ -180,10 +181,9 @@ set_fps_from_code (GstMpegVideoSequenceHdr * seqhdr, guint8 fps_code)
 
 /* @size and @offset are wrt current reader position */
 static inline gint
-scan_for_start_codes (const GstByteReader * reader, guint offset, guint size)
+scan_for_packet_start (const GstByteReader * reader, guint offset, guint size)
 {
-  const guint8 *data;
-  guint i = 0;
+  gint off;
 
   g_assert ((guint64) offset + size <= reader->size - reader->byte);
 
@@ -191,22 +191,11 @@ scan_for_start_codes (const GstByteReader * reader, guint offset, guint size)
   if (G_UNLIKELY (size < 4))
     return -1;
 
-  data = reader->data + reader->byte + offset;
-
-  while (i <= (size - 4)) {
-    if (data[i + 2] > 1) {
-      i += 3;
-    } else if (data[i + 1]) {
-      i += 2;
-    } else if (data[i] || data[i + 2] != 1) {
-      i++;
-    } else {
-      break;
-    }
-  }
+  /* leave out the last byte, a start code needs the packet type after it */
+  off = scan_for_start_codes (reader->data + reader->byte + offset, size - 1);
 
-  if (i <= (size - 4))
-    return offset + i;
+  if (off >= 0)
+    return offset + off;
 
   /* nothing found */
   return -1;
@@ -245,7 +234,7 @@ gst_mpeg_video_parse (GstMpegVideoPacket * packet,
   size -= offset;
   gst_byte_reader_init (&br, &data[offset], size);
 
-  off = scan_for_start_codes (&br, 0, size);
+  off = scan_for_packet_start (&br, 0, size);
 
   if (off < 0) {
     GST_DEBUG ("No start code prefix in this buffer");
@@ -264,7 +253,7 @@ gst_mpeg_video_parse (GstMpegVideoPacket * packet,
 
   /* try to find end of packet */
   size -= off + 4;
-  off = scan_for_start_codes (&br, 0, size);
+  off = scan_for_packet_start (&br, 0, size);
 
   if (off > 0)
     packet->size = off;
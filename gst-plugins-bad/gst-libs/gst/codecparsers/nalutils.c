@@ -206,20 +206,29 @@ NAL_READER_PEEK_BITS (8);
 gboolean
 nal_reader_get_ue (NalReader * nr, guint32 * val)
 {
-  guint i = 0;
-  guint8 bit;
+  guint i = 0, nbits;
+  guint8 bits;
   guint32 value;
 
-  if (G_UNLIKELY (!nal_reader_get_bits_uint8 (nr, &bit, 1)))
-    return FALSE;
+  /* count the leading zero bits a byte at a time instead of bit by bit */
+  while (TRUE) {
+    nbits = MIN (nal_reader_get_remaining (nr), 8);
+    if (G_UNLIKELY (nbits == 0 || !nal_reader_peek_bits_uint8 (nr, &bits,
+                nbits)))
+      return FALSE;
 
-  while (bit == 0) {
-    i++;
-    if (G_UNLIKELY (!nal_reader_get_bits_uint8 (nr, &bit, 1)))
+    if (bits != 0)
+      break;
+
+    i += nbits;
+    if (G_UNLIKELY (i > 32 || !nal_reader_skip (nr, nbits)))
       return FALSE;
   }
 
-  if (G_UNLIKELY (i > 32))
+  nbits = nbits - 1 - g_bit_nth_msf (bits, -1);
+  i += nbits;
+
+  if (G_UNLIKELY (i > 32 || !nal_reader_skip (nr, nbits + 1)))
     return FALSE;
 
   if (G_UNLIKELY (!nal_reader_get_bits_uint32 (nr, &value, i)))
@@ -297,13 +306,98 @@ nal_reader_has_more_data (NalReader * nr)
 
 /***********  end of nal parser ***************/
 
+/* TRUE if any of the bytes in @v is 0 */
+#define HAS_ZERO_BYTE(v) \
+  (((v) - G_GUINT64_CONSTANT (0x0101010101010101)) & ~(v) & \
+      G_GUINT64_CONSTANT (0x8080808080808080))
+
+/* Returns the offset of the first 0x000001 start code in @data, or -1 */
 inline gint
 scan_for_start_codes (const guint8 * data, guint size)
 {
-  GstByteReader br;
-  gst_byte_reader_init (&br, data, size);
+  guint i = 0;
 
   /* NALU not empty, so we can at least expect 1 (even 2) bytes following sc */
-  return gst_byte_reader_masked_scan_uint32 (&br, 0xffffff00, 0x00000100,
-      0, size);
+  while (i + 3 <= size) {
+    /* a start code begins with a 0 byte, so skip over 8 bytes at a time
+     * as long as none of them is 0 */
+    if (i + 8 <= size) {
+      guint64 v;
+
+      memcpy (&v, data + i, sizeof (v));
+      if (!HAS_ZERO_BYTE (v)) {
+        i += 8;
+        continue;
+      }
+    }
+
+    if (data[i + 2] > 1)
+      i += 3;
+    else if (data[i + 1])
+      i += 2;
+    else if (data[i] || data[i + 2] != 1)
+      i++;
+    else
+      return i;
+  }
+  return -1;
+}
+
+/* FNV-1a */
+guint32
+nal_param_set_checksum (const guint8 * data, guint size)
+{
+  guint32 hash = 2166136261u;
+  guint i;
+
+  for (i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+/* Returns the index of the entry holding exactly @data, or -1 */
+gint
+nal_param_set_cache_lookup (const NalParamSetCacheEntry * entries,
+    guint n_entries, const guint8 * data, guint size, guint32 checksum)
+{
+  guint i;
+
+  for (i = 0; i < n_entries; i++) {
+    const NalParamSetCacheEntry *entry = &entries[i];
+
+    if (entry->data && entry->checksum == checksum && entry->size == size
+        && memcmp (entry->data, data, size) == 0)
+      return i;
+  }
+
+  return -1;
+}
+
+void
+nal_param_set_cache_store (NalParamSetCacheEntry * entry,
+    const guint8 * data, guint size, guint32 checksum, gboolean full)
+{
+  if (entry->size != size) {
+    g_free (entry->data);
+    entry->data = g_malloc (size);
+  }
+  memcpy (entry->data, data, size);
+  entry->size = size;
+  entry->checksum = checksum;
+  entry->full = full;
+}
+
+void
+nal_param_set_cache_clear (NalParamSetCacheEntry * entries, guint n_entries)
+{
+  guint i;
+
+  for (i = 0; i < n_entries; i++) {
+    g_free (entries[i].data);
+    entries[i].data = NULL;
+    entries[i].size = 0;
+  }
 }
@@ -181,3 +181,28 @@ gboolean nal_reader_get_se (NalReader * nr, gint32 * val);
 
 G_GNUC_INTERNAL
 gint scan_for_start_codes (const guint8 * data, guint size);
+
+/* Copy of the NAL unit a stored parameter set was parsed from, so identical
+ * repeats of it (e.g. in front of every IDR) don't need to be parsed again */
+typedef struct
+{
+  guint32 checksum;
+  guint size;
+  guint8 *data;
+  gboolean full;                /* parsed including the optional VUI */
+} NalParamSetCacheEntry;
+
+G_GNUC_INTERNAL
+guint32 nal_param_set_checksum (const guint8 * data, guint size);
+
+G_GNUC_INTERNAL
+gint nal_param_set_cache_lookup (const NalParamSetCacheEntry * entries,
+    guint n_entries, const guint8 * data, guint size, guint32 checksum);
+
+G_GNUC_INTERNAL
+void nal_param_set_cache_store (NalParamSetCacheEntry * entry,
+    const guint8 * data, guint size, guint32 checksum, gboolean full);
+
+G_GNUC_INTERNAL
+void nal_param_set_cache_clear (NalParamSetCacheEntry * entries,
+    guint n_entries);
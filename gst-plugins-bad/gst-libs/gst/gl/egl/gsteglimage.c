@@ -65,6 +65,14 @@
 #define EGL_DMA_BUF_PLANE0_PITCH_EXT 0x3274
 #endif
 
+#ifndef EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT
+#define EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT 0x3443
+#endif
+
+#ifndef EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT
+#define EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT 0x3444
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_EGL_IMAGE);
 #define GST_CAT_DEFAULT GST_CAT_EGL_IMAGE
 
@@ -234,11 +242,39 @@ _destroy_egl_image (GstEGLImage * image, gpointer user_data)
 GstEGLImage *
 gst_egl_image_from_dmabuf (GstGLContext * context,
     gint dmabuf, GstVideoInfo * in_info, gint plane, gsize offset)
+{
+  return gst_egl_image_from_dmabuf_with_modifier (context, dmabuf, in_info,
+      plane, offset, GST_DMABUF_DRM_MODIFIER_INVALID);
+}
+
+/**
+ * gst_egl_image_from_dmabuf_with_modifier:
+ * @context: a #GstGLContext (must be an EGL context)
+ * @dmabuf: the DMA-Buf file descriptor
+ * @in_info: the #GstVideoInfo in @dmabuf
+ * @plane: the plane in @in_info to create and #GstEGLImage for
+ * @offset: the byte-offset in the data
+ * @modifier: the DRM format modifier of @dmabuf, or
+ *     %GST_DMABUF_DRM_MODIFIER_INVALID to let the driver assume the layout
+ *
+ * Creates an EGL image that imports @dmabuf. An explicit @modifier requires
+ * the EGL_EXT_image_dma_buf_import_modifiers extension, except for linear
+ * buffers.
+ *
+ * Returns: a #GstEGLImage wrapping @dmabuf or %NULL on failure
+ *
+ * Since: 1.10
+ */
+GstEGLImage *
+gst_egl_image_from_dmabuf_with_modifier (GstGLContext * context,
+    gint dmabuf, GstVideoInfo * in_info, gint plane, gsize offset,
+    guint64 modifier)
 {
   GstGLContextEGL *ctx_egl = GST_GL_CONTEXT_EGL (context);
+  gboolean with_modifier = FALSE;
   gint fourcc;
   gint atti = 0;
-  EGLint attribs[13];
+  EGLint attribs[17];
   EGLImageKHR img = EGL_NO_IMAGE_KHR;
   GstVideoGLTextureType type;
 
@@ -268,12 +304,32 @@ gst_egl_image_from_dmabuf (GstGLContext * context,
   attribs[atti++] = EGL_DMA_BUF_PLANE0_PITCH_EXT;
   attribs[atti++] = GST_VIDEO_INFO_PLANE_STRIDE (in_info, plane);
 
+  if (modifier != GST_DMABUF_DRM_MODIFIER_INVALID) {
+    with_modifier = gst_gl_context_check_feature (context,
+        "EGL_EXT_image_dma_buf_import_modifiers");
+
+    /* a tiled or compressed buffer would be imported as garbage */
+    if (!with_modifier && modifier != GST_DMABUF_DRM_MODIFIER_LINEAR) {
+      GST_WARNING ("cannot import DMABuf with modifier 0x%016"
+          G_GINT64_MODIFIER "x without "
+          "EGL_EXT_image_dma_buf_import_modifiers", modifier);
+      return NULL;
+    }
+  }
+
+  if (with_modifier) {
+    attribs[atti++] = EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT;
+    attribs[atti++] = modifier & 0xffffffff;
+    attribs[atti++] = EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT;
+    attribs[atti++] = modifier >> 32;
+  }
+
   attribs[atti] = EGL_NONE;
 
   for (int i = 0; i < atti; i++)
     GST_LOG ("attr %i: %08X", i, attribs[i]);
 
-  g_assert (atti == 12);
+  g_assert (atti <= 16);
 
   img = ctx_egl->eglCreateImage (ctx_egl->egl_display, EGL_NO_CONTEXT,
       EGL_LINUX_DMA_BUF_EXT, NULL, attribs);
@@ -72,6 +72,12 @@ GstEGLImage *           gst_egl_image_from_dmabuf               (GstGLContext *
                                                                  GstVideoInfo * in_info,
                                                                  gint plane,
                                                                  gsize offset);
+GstEGLImage *           gst_egl_image_from_dmabuf_with_modifier (GstGLContext * context,
+                                                                 gint dmabuf,
+                                                                 GstVideoInfo * in_info,
+                                                                 gint plane,
+                                                                 gsize offset,
+                                                                 guint64 modifier);
 #endif
 
 /**
@@ -39,6 +39,11 @@
  *   'egl', 'glx', 'wgl' or 'cgl'.
  * - GST_GL_API influences the OpenGL API requested by the OpenGL platform.
  *   Common values are 'opengl' and 'gles2'.
+ * - GST_GL_CONTEXT_POOL_SIZE sets the initial value of
+ *   gst_gl_display_set_context_pool_size().
+ * - GST_GL_SHARED_DISPLAY, when set to a value other than '0', makes elements
+ *   that don't receive a display through #GstContext use
+ *   gst_gl_display_get_shared() instead of creating their own.
  *
  * <note>Certain window systems require a special function to be called to
  * initialize threading support.  As this GStreamer GL library does not preclude
@@ -96,11 +101,19 @@ static guint gst_gl_display_signals[LAST_SIGNAL] = { 0 };
 
 static void gst_gl_display_finalize (GObject * object);
 static guintptr gst_gl_display_default_get_handle (GstGLDisplay * display);
+static GstGLContext *_get_any_gl_context_unlocked (GstGLDisplay * display);
+
+/* process-wide display handed out by gst_gl_display_get_shared() */
+static GWeakRef shared_display;
+G_LOCK_DEFINE_STATIC (shared_display);
 
 struct _GstGLDisplayPrivate
 {
   GstGLAPI gl_api;
 
+  guint context_pool_size;
+  guint context_pool_next;
+
   GList *contexts;
 };
 
@@ -137,6 +150,17 @@ gst_gl_display_init (GstGLDisplay * display)
 
   display->type = GST_GL_DISPLAY_TYPE_ANY;
   display->priv->gl_api = GST_GL_API_ANY;
+  display->priv->context_pool_size = 1;
+
+  {
+    const gchar *pool_size = g_getenv ("GST_GL_CONTEXT_POOL_SIZE");
+
+    if (pool_size && *pool_size) {
+      guint64 size = g_ascii_strtoull (pool_size, NULL, 10);
+
+      display->priv->context_pool_size = CLAMP (size, 1, G_MAXUINT);
+    }
+  }
 
   GST_TRACE ("init %p", display);
 
@@ -222,6 +246,37 @@ gst_gl_display_new (void)
   return display;
 }
 
+/**
+ * gst_gl_display_get_shared:
+ *
+ * Retrieves the process-wide #GstGLDisplay, creating it with
+ * gst_gl_display_new() if no other user currently holds it.  Independent
+ * pipelines using this display share the window system connection and, through
+ * gst_gl_display_create_context(), a GL share group so that GL memory can be
+ * passed between them.  The display is freed once the last reference is
+ * dropped.
+ *
+ * Returns: (transfer full): the shared #GstGLDisplay
+ *
+ * Since: 1.10
+ */
+GstGLDisplay *
+gst_gl_display_get_shared (void)
+{
+  GstGLDisplay *display;
+
+  G_LOCK (shared_display);
+  display = g_weak_ref_get (&shared_display);
+  if (!display) {
+    display = gst_gl_display_new ();
+    g_weak_ref_set (&shared_display, display);
+    GST_INFO ("created shared display %" GST_PTR_FORMAT, display);
+  }
+  G_UNLOCK (shared_display);
+
+  return display;
+}
+
 guintptr
 gst_gl_display_get_handle (GstGLDisplay * display)
 {
@@ -296,6 +351,62 @@ gst_gl_display_get_gl_api (GstGLDisplay * display)
   return ret;
 }
 
+/**
+ * gst_gl_display_set_context_pool_size:
+ * @display: a #GstGLDisplay
+ * @size: the maximum number of contexts handed out to unrelated elements
+ *
+ * Elements that cannot find a #GstGLContext through their peers ask @display
+ * for any existing context with gst_gl_display_get_gl_context_for_thread()
+ * and a %NULL thread.  By default every such element receives the same
+ * context so all of their GL work is serialized on a single GL thread.
+ *
+ * With a @size larger than 1, up to @size contexts are created instead, each
+ * with its own GL thread, and handed out in turn to independent branches.
+ * Contexts created by gst_gl_display_create_context() without an
+ * @other_context then share resources with the existing contexts of
+ * @display so that buffers can still be exchanged between branches, with
+ * #GstGLSyncMeta ordering the GL commands across contexts.
+ *
+ * The initial value can be set with the GST_GL_CONTEXT_POOL_SIZE environment
+ * variable.
+ *
+ * Since: 1.10
+ */
+void
+gst_gl_display_set_context_pool_size (GstGLDisplay * display, guint size)
+{
+  g_return_if_fail (GST_IS_GL_DISPLAY (display));
+  g_return_if_fail (size > 0);
+
+  GST_OBJECT_LOCK (display);
+  display->priv->context_pool_size = size;
+  GST_OBJECT_UNLOCK (display);
+}
+
+/**
+ * gst_gl_display_get_context_pool_size:
+ * @display: a #GstGLDisplay
+ *
+ * Returns: the number of contexts @display hands out to elements that do
+ * not care which context they use.
+ *
+ * Since: 1.10
+ */
+guint
+gst_gl_display_get_context_pool_size (GstGLDisplay * display)
+{
+  guint ret;
+
+  g_return_val_if_fail (GST_IS_GL_DISPLAY (display), 1);
+
+  GST_OBJECT_LOCK (display);
+  ret = display->priv->context_pool_size;
+  GST_OBJECT_UNLOCK (display);
+
+  return ret;
+}
+
 /**
  * gst_gl_display_get_handle_type:
  * @display: a #GstGLDisplay
@@ -383,7 +494,7 @@ gboolean
 gst_gl_display_create_context (GstGLDisplay * display,
     GstGLContext * other_context, GstGLContext ** p_context, GError ** error)
 {
-  GstGLContext *context = NULL;
+  GstGLContext *context = NULL, *pool_context = NULL;
   gboolean ret = FALSE;
 
   g_return_val_if_fail (display != NULL, FALSE);
@@ -406,46 +517,105 @@ gst_gl_display_create_context (GstGLDisplay * display,
     return FALSE;
   }
 
+  /* keep pooled contexts in a single share group */
+  if (!other_context && display->priv->context_pool_size > 1)
+    pool_context = _get_any_gl_context_unlocked (display);
+  if (pool_context)
+    other_context = pool_context;
+
   GST_DEBUG_OBJECT (display,
       "creating context %" GST_PTR_FORMAT " from other context %"
       GST_PTR_FORMAT, context, other_context);
 
   ret = gst_gl_context_create (context, other_context, error);
 
+  if (pool_context)
+    gst_object_unref (pool_context);
+
   if (ret)
     *p_context = context;
 
   return ret;
 }
 
+static void
+_prune_dead_contexts_unlocked (GstGLDisplay * display)
+{
+  GList *l = display->priv->contexts;
+
+  while (l) {
+    GList *next = l->next;
+    GstGLContext *context = g_weak_ref_get (l->data);
+
+    if (context) {
+      gst_object_unref (context);
+    } else {
+      g_weak_ref_clear (l->data);
+      g_free (l->data);
+      display->priv->contexts = g_list_delete_link (display->priv->contexts, l);
+    }
+    l = next;
+  }
+}
+
+static GstGLContext *
+_get_any_gl_context_unlocked (GstGLDisplay * display)
+{
+  GList *l;
+
+  for (l = display->priv->contexts; l; l = l->next) {
+    GstGLContext *context = g_weak_ref_get (l->data);
+
+    if (context)
+      return context;
+  }
+
+  return NULL;
+}
+
+/* hands out the contexts of the pool in turn, or NULL while the pool
+ * still has room for a new context */
+static GstGLContext *
+_get_pooled_gl_context_unlocked (GstGLDisplay * display)
+{
+  GstGLContext *context;
+  guint n_contexts;
+
+  _prune_dead_contexts_unlocked (display);
+
+  n_contexts = g_list_length (display->priv->contexts);
+  if (n_contexts < display->priv->context_pool_size)
+    return NULL;
+
+  context = g_weak_ref_get (g_list_nth_data (display->priv->contexts,
+          display->priv->context_pool_next++ % n_contexts));
+
+  return context;
+}
+
 static GstGLContext *
 _get_gl_context_for_thread_unlocked (GstGLDisplay * display, GThread * thread)
 {
   GstGLContext *context = NULL;
-  GList *prev = NULL, *l = display->priv->contexts;
+  GList *l;
 
-  while (l) {
-    GWeakRef *ref = l->data;
+  _prune_dead_contexts_unlocked (display);
+
+  for (l = display->priv->contexts; l; l = l->next) {
     GThread *context_thread;
 
-    context = g_weak_ref_get (ref);
-    if (!context) {
-      /* remove dead contexts */
-      g_weak_ref_clear (l->data);
-      display->priv->contexts = g_list_delete_link (display->priv->contexts, l);
-      l = prev ? prev->next : display->priv->contexts;
+    context = g_weak_ref_get (l->data);
+    if (!context)
       continue;
-    }
 
     if (thread == NULL)
       return context;
 
     context_thread = gst_gl_context_get_thread (context);
     if (thread != context_thread) {
-      g_thread_unref (context_thread);
+      if (context_thread)
+        g_thread_unref (context_thread);
       gst_object_unref (context);
-      prev = l;
-      l = l->next;
       continue;
     }
 
@@ -464,6 +634,9 @@ _get_gl_context_for_thread_unlocked (GstGLDisplay * display, GThread * thread)
  *
  * Returns: (transfer full): the #GstGLContext current on @thread or %NULL
  *
+ * If @thread is %NULL, any context of @display may be returned.  See
+ * gst_gl_display_set_context_pool_size() for how the context is chosen.
+ *
  * Must be called with the object lock held.
  *
  * Since: 1.6
@@ -476,7 +649,10 @@ gst_gl_display_get_gl_context_for_thread (GstGLDisplay * display,
 
   g_return_val_if_fail (GST_IS_GL_DISPLAY (display), NULL);
 
-  context = _get_gl_context_for_thread_unlocked (display, thread);
+  if (thread == NULL && display->priv->context_pool_size > 1)
+    context = _get_pooled_gl_context_unlocked (display);
+  else
+    context = _get_gl_context_for_thread_unlocked (display, thread);
   GST_DEBUG_OBJECT (display, "returning context %" GST_PTR_FORMAT " for thread "
       "%p", context, thread);
 
@@ -88,6 +88,7 @@ struct _GstGLDisplayClass
 };
 
 GstGLDisplay *gst_gl_display_new (void);
+GstGLDisplay *gst_gl_display_get_shared (void);
 
 #define gst_gl_display_lock(display)        GST_OBJECT_LOCK (display)
 #define gst_gl_display_unlock(display)      GST_OBJECT_UNLOCK (display)
@@ -98,6 +99,9 @@ void             gst_gl_display_filter_gl_api          (GstGLDisplay * display,
                                                         GstGLAPI gl_api);
 GstGLAPI         gst_gl_display_get_gl_api             (GstGLDisplay * display);
 GstGLAPI         gst_gl_display_get_gl_api_unlocked    (GstGLDisplay * display);
+void             gst_gl_display_set_context_pool_size  (GstGLDisplay * display,
+                                                        guint size);
+guint            gst_gl_display_get_context_pool_size  (GstGLDisplay * display);
 
 #define GST_GL_DISPLAY_CONTEXT_TYPE "gst.gl.GLDisplay"
 void     gst_context_set_gl_display (GstContext * context, GstGLDisplay * display);
@@ -62,23 +62,34 @@ const gchar *fragment_shader =
   "}";
 /* *INDENT-ON* */
 
+/* Overlays up to this size are packed into one shared atlas texture that is
+ * drawn with a single draw call, bigger ones get a texture of their own */
+#define ATLAS_SIZE 1024
+#define ATLAS_PADDING 1
+
+/* 6 indices per quad with GLushort indices */
+#define MAX_QUADS (G_MAXUINT16 / 4)
+
+/* x, y, z, w, s, t */
+#define VERTEX_SIZE 6
+
 struct _GstGLCompositionOverlay
 {
   GstObject parent;
   GstGLContext *context;
 
-  GLuint vao;
-  GLuint index_buffer;
-  GLuint position_buffer;
-  GLuint texcoord_buffer;
-  GLint position_attrib;
-  GLint texcoord_attrib;
+  GstVideoOverlayRectangle *rectangle;
+  guint seqnum;
+  guint width, height;
 
-  GLfloat positions[16];
+  /* position in the atlas texture */
+  gboolean in_atlas;
+  gboolean needs_atlas_upload;
+  guint atlas_x, atlas_y;
 
+  /* texture of its own if not in the atlas */
   GLuint texture_id;
   GstGLMemory *gl_memory;
-  GstVideoOverlayRectangle *rectangle;
 };
 
 struct _GstGLCompositionOverlayClass
@@ -89,113 +100,6 @@ struct _GstGLCompositionOverlayClass
 G_DEFINE_TYPE (GstGLCompositionOverlay, gst_gl_composition_overlay,
     GST_TYPE_OBJECT);
 
-static void
-gst_gl_composition_overlay_init_vertex_buffer (GstGLContext * context,
-    gpointer overlay_pointer)
-{
-  const GstGLFuncs *gl = context->gl_vtable;
-  GstGLCompositionOverlay *overlay =
-      (GstGLCompositionOverlay *) overlay_pointer;
-
-  /* *INDENT-OFF* */
-  static const GLfloat texcoords[] = {
-      1.0f, 0.0f,
-      0.0f, 0.0f,
-      0.0f, 1.0f,
-      1.0f, 1.0f
-  };
-
-  static const GLushort indices[] = {
-    0, 1, 2, 0, 2, 3
-  };
-  /* *INDENT-ON* */
-
-  if (gl->GenVertexArrays) {
-    gl->GenVertexArrays (1, &overlay->vao);
-    gl->BindVertexArray (overlay->vao);
-  }
-
-  gl->GenBuffers (1, &overlay->position_buffer);
-  gl->BindBuffer (GL_ARRAY_BUFFER, overlay->position_buffer);
-  gl->BufferData (GL_ARRAY_BUFFER, 4 * 4 * sizeof (GLfloat), overlay->positions,
-      GL_STATIC_DRAW);
-
-  /* Load the vertex position */
-  gl->VertexAttribPointer (overlay->position_attrib, 4, GL_FLOAT, GL_FALSE,
-      4 * sizeof (GLfloat), NULL);
-
-  gl->GenBuffers (1, &overlay->texcoord_buffer);
-  gl->BindBuffer (GL_ARRAY_BUFFER, overlay->texcoord_buffer);
-  gl->BufferData (GL_ARRAY_BUFFER, 4 * 2 * sizeof (GLfloat), texcoords,
-      GL_STATIC_DRAW);
-
-  /* Load the texture coordinate */
-  gl->VertexAttribPointer (overlay->texcoord_attrib, 2, GL_FLOAT, GL_FALSE,
-      2 * sizeof (GLfloat), NULL);
-
-  gl->GenBuffers (1, &overlay->index_buffer);
-  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, overlay->index_buffer);
-  gl->BufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof (indices), indices,
-      GL_STATIC_DRAW);
-
-  gl->EnableVertexAttribArray (overlay->position_attrib);
-  gl->EnableVertexAttribArray (overlay->texcoord_attrib);
-
-  if (gl->GenVertexArrays) {
-    gl->BindVertexArray (0);
-  }
-
-  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
-  gl->BindBuffer (GL_ARRAY_BUFFER, 0);
-}
-
-static void
-gst_gl_composition_overlay_free_vertex_buffer (GstGLContext * context,
-    gpointer overlay_pointer)
-{
-  const GstGLFuncs *gl = context->gl_vtable;
-  GstGLCompositionOverlay *overlay =
-      (GstGLCompositionOverlay *) overlay_pointer;
-  if (overlay->vao) {
-    gl->DeleteVertexArrays (1, &overlay->vao);
-    overlay->vao = 0;
-  }
-
-  if (overlay->position_buffer) {
-    gl->DeleteBuffers (1, &overlay->position_buffer);
-    overlay->position_buffer = 0;
-  }
-
-  if (overlay->texcoord_buffer) {
-    gl->DeleteBuffers (1, &overlay->position_buffer);
-    overlay->position_buffer = 0;
-  }
-
-  if (overlay->index_buffer) {
-    gl->DeleteBuffers (1, &overlay->index_buffer);
-    overlay->index_buffer = 0;
-  }
-}
-
-static void
-gst_gl_composition_overlay_bind_vertex_buffer (GstGLCompositionOverlay *
-    overlay)
-{
-  const GstGLFuncs *gl = overlay->context->gl_vtable;
-  gl->BindBuffer (GL_ARRAY_BUFFER, overlay->position_buffer);
-  gl->VertexAttribPointer (overlay->position_attrib, 4, GL_FLOAT, GL_FALSE,
-      4 * sizeof (GLfloat), NULL);
-
-  gl->BindBuffer (GL_ARRAY_BUFFER, overlay->texcoord_buffer);
-  gl->VertexAttribPointer (overlay->texcoord_attrib, 2, GL_FLOAT, GL_FALSE,
-      2 * sizeof (GLfloat), NULL);
-
-  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, overlay->index_buffer);
-
-  gl->EnableVertexAttribArray (overlay->position_attrib);
-  gl->EnableVertexAttribArray (overlay->texcoord_attrib);
-}
-
 static void
 gst_gl_composition_overlay_finalize (GObject * object)
 {
@@ -206,11 +110,11 @@ gst_gl_composition_overlay_finalize (GObject * object)
   if (overlay->gl_memory)
     gst_memory_unref ((GstMemory *) overlay->gl_memory);
 
-  if (overlay->context) {
-    gst_gl_context_thread_add (overlay->context,
-        gst_gl_composition_overlay_free_vertex_buffer, overlay);
+  if (overlay->rectangle)
+    gst_video_overlay_rectangle_unref (overlay->rectangle);
+
+  if (overlay->context)
     gst_object_unref (overlay->context);
-  }
 
   G_OBJECT_CLASS (gst_gl_composition_overlay_parent_class)->finalize (object);
 }
@@ -227,86 +131,32 @@ gst_gl_composition_overlay_init (GstGLCompositionOverlay * overlay)
 {
 }
 
-static void
-gst_gl_composition_overlay_add_transformation (GstGLCompositionOverlay *
-    overlay, GstBuffer * video_buffer)
-{
-  gint comp_x, comp_y;
-  guint comp_width, comp_height;
-  GstVideoMeta *meta;
-  guint width, height;
-
-  float rel_x, rel_y, rel_w, rel_h;
-
-  meta = gst_buffer_get_video_meta (video_buffer);
-
-  gst_video_overlay_rectangle_get_render_rectangle (overlay->rectangle,
-      &comp_x, &comp_y, &comp_width, &comp_height);
-
-  width = meta->width;
-  height = meta->height;
-
-  /* calculate relative position */
-  rel_x = (float) comp_x / (float) width;
-  rel_y = (float) comp_y / (float) height;
-
-  rel_w = (float) comp_width / (float) width;
-  rel_h = (float) comp_height / (float) height;
-
-  /* transform from [0,1] to [-1,1], invert y axis */
-  rel_x = rel_x * 2.0 - 1.0;
-  rel_y = (1.0 - rel_y) * 2.0 - 1.0;
-  rel_w = rel_w * 2.0;
-  rel_h = rel_h * 2.0;
-
-  /* initialize position array */
-  overlay->positions[0] = rel_x + rel_w;
-  overlay->positions[1] = rel_y;
-  overlay->positions[2] = 0.0;
-  overlay->positions[3] = 1.0;
-  overlay->positions[4] = rel_x;
-  overlay->positions[5] = rel_y;
-  overlay->positions[6] = 0.0;
-  overlay->positions[7] = 1.0;
-  overlay->positions[8] = rel_x;
-  overlay->positions[9] = rel_y - rel_h;
-  overlay->positions[10] = 0.0;
-  overlay->positions[11] = 1.0;
-  overlay->positions[12] = rel_x + rel_w;
-  overlay->positions[13] = rel_y - rel_h;
-  overlay->positions[14] = 0.0;
-  overlay->positions[15] = 1.0;
-
-  gst_gl_context_thread_add (overlay->context,
-      gst_gl_composition_overlay_free_vertex_buffer, overlay);
-
-  gst_gl_context_thread_add (overlay->context,
-      gst_gl_composition_overlay_init_vertex_buffer, overlay);
-
-  GST_DEBUG
-      ("overlay position: (%d,%d) size: %dx%d video size: %dx%d",
-      comp_x, comp_y, comp_width, comp_height, meta->width, meta->height);
-}
-
 /* helper object API functions */
 
 static GstGLCompositionOverlay *
 gst_gl_composition_overlay_new (GstGLContext * context,
-    GstVideoOverlayRectangle * rectangle,
-    GLint position_attrib, GLint texcoord_attrib)
+    GstVideoOverlayRectangle * rectangle)
 {
   GstGLCompositionOverlay *overlay =
       g_object_new (GST_TYPE_GL_COMPOSITION_OVERLAY, NULL);
+  GstBuffer *comp_buffer;
+  GstVideoMeta *vmeta;
 
   overlay->gl_memory = NULL;
-  overlay->texture_id = -1;
-  overlay->rectangle = rectangle;
+  overlay->texture_id = 0;
+  overlay->rectangle = gst_video_overlay_rectangle_ref (rectangle);
+  overlay->seqnum = gst_video_overlay_rectangle_get_seqnum (rectangle);
   overlay->context = gst_object_ref (context);
-  overlay->vao = 0;
-  overlay->position_attrib = position_attrib;
-  overlay->texcoord_attrib = texcoord_attrib;
 
-  GST_DEBUG_OBJECT (overlay, "Created new GstGLCompositionOverlay");
+  comp_buffer =
+      gst_video_overlay_rectangle_get_pixels_unscaled_argb (rectangle,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
+  vmeta = gst_buffer_get_video_meta (comp_buffer);
+  overlay->width = vmeta->width;
+  overlay->height = vmeta->height;
+
+  GST_DEBUG_OBJECT (overlay, "Created new GstGLCompositionOverlay for "
+      "rectangle %u", overlay->seqnum);
 
   return overlay;
 }
@@ -321,8 +171,7 @@ _video_frame_unmap_and_free (gpointer user_data)
 }
 
 static void
-gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
-    GstBuffer * buf)
+gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay)
 {
   GstGLMemory *comp_gl_memory = NULL;
   GstBuffer *comp_buffer = NULL;
@@ -332,6 +181,9 @@ gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
   GstVideoFrame *comp_frame;
   GstVideoFrame gl_frame;
 
+  if (overlay->gl_memory)
+    return;
+
   comp_buffer =
       gst_video_overlay_rectangle_get_pixels_unscaled_argb (overlay->rectangle,
       GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
@@ -352,8 +204,6 @@ gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
         GST_ALLOCATOR (gst_gl_memory_allocator_get_default (overlay->context));
     mem_allocator = GST_GL_BASE_MEMORY_ALLOCATOR (allocator);
 
-    gst_gl_composition_overlay_add_transformation (overlay, buf);
-
     params = gst_gl_video_allocation_params_new_wrapped_data (overlay->context,
         NULL, &comp_frame->info, 0, NULL, GST_GL_TEXTURE_TARGET_2D,
         comp_frame->data[0], comp_frame, _video_frame_unmap_and_free);
@@ -389,19 +239,102 @@ gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
   }
 }
 
+/* Must be called from the GL thread */
 static void
-gst_gl_composition_overlay_draw (GstGLCompositionOverlay * overlay,
-    GstGLShader * shader)
+gst_gl_composition_overlay_upload_to_atlas (GstGLCompositionOverlay * overlay,
+    GLuint atlas_texture)
 {
   const GstGLFuncs *gl = overlay->context->gl_vtable;
-  if (gl->GenVertexArrays)
-    gl->BindVertexArray (overlay->vao);
-  else
-    gst_gl_composition_overlay_bind_vertex_buffer (overlay);
-
-  if (overlay->texture_id != -1)
-    gl->BindTexture (GL_TEXTURE_2D, overlay->texture_id);
-  gl->DrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
+  GstBuffer *comp_buffer;
+  GstVideoMeta *vmeta;
+  GstMapInfo map;
+  gpointer data;
+  gint stride;
+  guint i;
+
+  comp_buffer =
+      gst_video_overlay_rectangle_get_pixels_unscaled_argb (overlay->rectangle,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
+  vmeta = gst_buffer_get_video_meta (comp_buffer);
+
+  if (!gst_video_meta_map (vmeta, 0, &map, &data, &stride, GST_MAP_READ)) {
+    GST_WARNING_OBJECT (overlay, "Cannot map overlay pixels");
+    return;
+  }
+
+  /* The ARGB pixels are uploaded as RGBA bytes and swizzled in the fragment
+   * shader, like for the GstGLMemory of the overlays with their own
+   * texture. GLES2 has no GL_UNPACK_ROW_LENGTH, so padded rows have to be
+   * uploaded one by one */
+  gl->BindTexture (GL_TEXTURE_2D, atlas_texture);
+  if (stride == (gint) overlay->width * 4) {
+    gl->TexSubImage2D (GL_TEXTURE_2D, 0, overlay->atlas_x, overlay->atlas_y,
+        overlay->width, overlay->height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+  } else {
+    for (i = 0; i < overlay->height; i++)
+      gl->TexSubImage2D (GL_TEXTURE_2D, 0, overlay->atlas_x,
+          overlay->atlas_y + i, overlay->width, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+          (guint8 *) data + i * stride);
+  }
+
+  gst_video_meta_unmap (vmeta, 0, &map);
+
+  GST_DEBUG_OBJECT (overlay, "uploaded %ux%u overlay to atlas at %u,%u",
+      overlay->width, overlay->height, overlay->atlas_x, overlay->atlas_y);
+}
+
+static void
+gst_gl_composition_overlay_add_vertices (GstGLCompositionOverlay * overlay,
+    GArray * vertices, guint video_width, guint video_height,
+    guint atlas_size)
+{
+  gint comp_x, comp_y;
+  guint comp_width, comp_height;
+  gfloat rel_x, rel_y, rel_w, rel_h;
+  gfloat s0, t0, s1, t1;
+
+  gst_video_overlay_rectangle_get_render_rectangle (overlay->rectangle,
+      &comp_x, &comp_y, &comp_width, &comp_height);
+
+  /* calculate relative position */
+  rel_x = (float) comp_x / (float) video_width;
+  rel_y = (float) comp_y / (float) video_height;
+
+  rel_w = (float) comp_width / (float) video_width;
+  rel_h = (float) comp_height / (float) video_height;
+
+  /* transform from [0,1] to [-1,1], invert y axis */
+  rel_x = rel_x * 2.0 - 1.0;
+  rel_y = (1.0 - rel_y) * 2.0 - 1.0;
+  rel_w = rel_w * 2.0;
+  rel_h = rel_h * 2.0;
+
+  if (overlay->in_atlas) {
+    s0 = (gfloat) overlay->atlas_x / atlas_size;
+    t0 = (gfloat) overlay->atlas_y / atlas_size;
+    s1 = (gfloat) (overlay->atlas_x + overlay->width) / atlas_size;
+    t1 = (gfloat) (overlay->atlas_y + overlay->height) / atlas_size;
+  } else {
+    s0 = t0 = 0.0f;
+    s1 = t1 = 1.0f;
+  }
+
+  {
+    /* *INDENT-OFF* */
+    GLfloat quad[4 * VERTEX_SIZE] = {
+      rel_x + rel_w, rel_y,         0.0, 1.0, s1, t0,
+      rel_x,         rel_y,         0.0, 1.0, s0, t0,
+      rel_x,         rel_y - rel_h, 0.0, 1.0, s0, t1,
+      rel_x + rel_w, rel_y - rel_h, 0.0, 1.0, s1, t1,
+    };
+    /* *INDENT-ON* */
+
+    g_array_append_vals (vertices, quad, 4 * VERTEX_SIZE);
+  }
+
+  GST_DEBUG
+      ("overlay position: (%d,%d) size: %dx%d video size: %dx%d",
+      comp_x, comp_y, comp_width, comp_height, video_width, video_height);
 }
 
 
@@ -410,6 +343,33 @@ gst_gl_composition_overlay_draw (GstGLCompositionOverlay * overlay,
  * GstVideoCompositionOverlayMeta
  ********************************************************************/
 
+struct _GstGLOverlayCompositorPrivate
+{
+  /* overlays whose rectangles left the composition, kept alive until their
+   * textures are not referenced for drawing anymore */
+  GList *removed_overlays;
+  gboolean dirty;
+  guint video_width, video_height;
+
+  /* shelf packing state of the atlas */
+  guint atlas_size;
+  guint shelf_x, shelf_y, shelf_height;
+  gboolean atlas_clear;
+
+  /* GL thread only */
+  GLuint atlas_texture;
+  GLuint vao;
+  GLuint vertex_buffer;
+  GLuint index_buffer;
+  guint n_atlas_quads;
+  /* textures of the quads after the atlas ones */
+  GArray *textures;
+};
+
+#define GST_GL_OVERLAY_COMPOSITOR_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_GL_OVERLAY_COMPOSITOR, \
+      GstGLOverlayCompositorPrivate))
+
 #define DEBUG_INIT \
   GST_DEBUG_CATEGORY_INIT (gst_gl_overlay_compositor_debug, \
       "gloverlaycompositor", 0, "overlaycompositor");
@@ -418,20 +378,26 @@ G_DEFINE_TYPE_WITH_CODE (GstGLOverlayCompositor, gst_gl_overlay_compositor,
     GST_TYPE_OBJECT, DEBUG_INIT);
 
 static void gst_gl_overlay_compositor_finalize (GObject * object);
-static gboolean _is_rectangle_in_overlays (GList * overlays,
-    GstVideoOverlayRectangle * rectangle);
+static GstGLCompositionOverlay *_find_overlay (GList * overlays,
+    guint seqnum);
 static gboolean _is_overlay_in_rectangles (GstVideoOverlayComposition *
     composition, GstGLCompositionOverlay * overlay);
 
 static void
 gst_gl_overlay_compositor_class_init (GstGLOverlayCompositorClass * klass)
 {
+  g_type_class_add_private (klass, sizeof (GstGLOverlayCompositorPrivate));
+
   G_OBJECT_CLASS (klass)->finalize = gst_gl_overlay_compositor_finalize;
 }
 
 static void
 gst_gl_overlay_compositor_init (GstGLOverlayCompositor * compositor)
 {
+  compositor->priv = GST_GL_OVERLAY_COMPOSITOR_GET_PRIVATE (compositor);
+
+  compositor->priv->atlas_size = ATLAS_SIZE;
+  compositor->priv->textures = g_array_new (FALSE, FALSE, sizeof (GLuint));
 }
 
 static void
@@ -440,7 +406,9 @@ gst_gl_overlay_compositor_init_gl (GstGLContext * context,
 {
   GstGLOverlayCompositor *compositor =
       (GstGLOverlayCompositor *) compositor_pointer;
+  const GstGLFuncs *gl = context->gl_vtable;
   GError *error = NULL;
+  GLint max_texture_size = 0;
 
   if (!(compositor->shader =
           gst_gl_shader_new_link_with_stages (context, &error,
@@ -458,6 +426,11 @@ gst_gl_overlay_compositor_init_gl (GstGLContext * context,
       gst_gl_shader_get_attribute_location (compositor->shader, "a_position");
   compositor->texcoord_attrib =
       gst_gl_shader_get_attribute_location (compositor->shader, "a_texcoord");
+
+  gl->GetIntegerv (GL_MAX_TEXTURE_SIZE, &max_texture_size);
+  if (max_texture_size > 0)
+    compositor->priv->atlas_size =
+        MIN (compositor->priv->atlas_size, max_texture_size);
 }
 
 GstGLOverlayCompositor *
@@ -476,6 +449,36 @@ gst_gl_overlay_compositor_new (GstGLContext * context)
   return compositor;
 }
 
+static void
+gst_gl_overlay_compositor_free_gl (GstGLContext * context,
+    gpointer compositor_pointer)
+{
+  GstGLOverlayCompositor *compositor =
+      (GstGLOverlayCompositor *) compositor_pointer;
+  GstGLOverlayCompositorPrivate *priv = compositor->priv;
+  const GstGLFuncs *gl = context->gl_vtable;
+
+  if (priv->vao) {
+    gl->DeleteVertexArrays (1, &priv->vao);
+    priv->vao = 0;
+  }
+
+  if (priv->vertex_buffer) {
+    gl->DeleteBuffers (1, &priv->vertex_buffer);
+    priv->vertex_buffer = 0;
+  }
+
+  if (priv->index_buffer) {
+    gl->DeleteBuffers (1, &priv->index_buffer);
+    priv->index_buffer = 0;
+  }
+
+  if (priv->atlas_texture) {
+    gl->DeleteTextures (1, &priv->atlas_texture);
+    priv->atlas_texture = 0;
+  }
+}
+
 static void
 gst_gl_overlay_compositor_finalize (GObject * object)
 {
@@ -485,29 +488,33 @@ gst_gl_overlay_compositor_finalize (GObject * object)
 
   gst_gl_overlay_compositor_free_overlays (compositor);
 
-  if (compositor->context)
+  if (compositor->context) {
+    gst_gl_context_thread_add (compositor->context,
+        gst_gl_overlay_compositor_free_gl, compositor);
     gst_object_unref (compositor->context);
+  }
 
   if (compositor->shader) {
     gst_object_unref (compositor->shader);
     compositor->shader = NULL;
   }
 
+  g_array_free (compositor->priv->textures, TRUE);
+
   G_OBJECT_CLASS (gst_gl_overlay_compositor_parent_class)->finalize (object);
 }
 
-static gboolean
-_is_rectangle_in_overlays (GList * overlays,
-    GstVideoOverlayRectangle * rectangle)
+static GstGLCompositionOverlay *
+_find_overlay (GList * overlays, guint seqnum)
 {
   GList *l;
 
   for (l = overlays; l != NULL; l = l->next) {
     GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-    if (overlay->rectangle == rectangle)
-      return TRUE;
+    if (overlay->seqnum == seqnum)
+      return overlay;
   }
-  return FALSE;
+  return NULL;
 }
 
 static gboolean
@@ -519,37 +526,249 @@ _is_overlay_in_rectangles (GstVideoOverlayComposition * composition,
   for (i = 0; i < gst_video_overlay_composition_n_rectangles (composition); i++) {
     GstVideoOverlayRectangle *rectangle =
         gst_video_overlay_composition_get_rectangle (composition, i);
-    if (overlay->rectangle == rectangle)
+    if (overlay->seqnum == gst_video_overlay_rectangle_get_seqnum (rectangle))
       return TRUE;
   }
   return FALSE;
 }
 
+static gboolean
+_is_atlas_candidate (GstGLOverlayCompositor * compositor,
+    GstGLCompositionOverlay * overlay)
+{
+  guint max_size = compositor->priv->atlas_size / 4;
+
+  return overlay->width <= max_size && overlay->height <= max_size;
+}
+
+/* Simple shelf packing: overlays are placed left to right on shelves as high
+ * as the highest overlay on them. Space of removed overlays is only reclaimed
+ * when everything is repacked once the atlas is full */
+static gboolean
+_atlas_allocate (GstGLOverlayCompositor * compositor,
+    GstGLCompositionOverlay * overlay)
+{
+  GstGLOverlayCompositorPrivate *priv = compositor->priv;
+  guint width = overlay->width + ATLAS_PADDING;
+  guint height = overlay->height + ATLAS_PADDING;
+
+  if (priv->shelf_x + width > priv->atlas_size) {
+    priv->shelf_y += priv->shelf_height;
+    priv->shelf_x = 0;
+    priv->shelf_height = 0;
+  }
+
+  if (width > priv->atlas_size || priv->shelf_y + height > priv->atlas_size)
+    return FALSE;
+
+  overlay->atlas_x = priv->shelf_x;
+  overlay->atlas_y = priv->shelf_y;
+  overlay->in_atlas = TRUE;
+  overlay->needs_atlas_upload = TRUE;
+
+  priv->shelf_x += width;
+  priv->shelf_height = MAX (priv->shelf_height, height);
+
+  return TRUE;
+}
+
+static gint
+_compare_overlay_height (gconstpointer a, gconstpointer b)
+{
+  const GstGLCompositionOverlay *overlay_a = a;
+  const GstGLCompositionOverlay *overlay_b = b;
+
+  return (gint) overlay_b->height - (gint) overlay_a->height;
+}
+
+static void
+_atlas_repack (GstGLOverlayCompositor * compositor)
+{
+  GstGLOverlayCompositorPrivate *priv = compositor->priv;
+  GList *sorted, *l;
+
+  GST_DEBUG_OBJECT (compositor, "atlas full, repacking");
+
+  priv->shelf_x = priv->shelf_y = priv->shelf_height = 0;
+  priv->atlas_clear = TRUE;
+
+  /* placing the highest overlays first wastes less space on the shelves */
+  sorted = g_list_sort (g_list_copy (compositor->overlays),
+      _compare_overlay_height);
+  for (l = sorted; l; l = l->next) {
+    GstGLCompositionOverlay *overlay = l->data;
+
+    overlay->in_atlas = FALSE;
+    if (!_is_atlas_candidate (compositor, overlay)
+        || !_atlas_allocate (compositor, overlay))
+      gst_gl_composition_overlay_upload (overlay);
+  }
+  g_list_free (sorted);
+}
+
+static void
+gst_gl_overlay_compositor_update_gl (GstGLContext * context,
+    gpointer compositor_pointer)
+{
+  GstGLOverlayCompositor *compositor =
+      (GstGLOverlayCompositor *) compositor_pointer;
+  GstGLOverlayCompositorPrivate *priv = compositor->priv;
+  const GstGLFuncs *gl = context->gl_vtable;
+  GArray *vertices;
+  GArray *indices;
+  guint n_quads, i;
+  GList *l;
+
+  if (!priv->atlas_texture || priv->atlas_clear) {
+    /* start with a transparent atlas so that the padding between the
+     * overlays does not bleed into them when sampling */
+    gpointer zeros = g_malloc0 (priv->atlas_size * priv->atlas_size * 4);
+
+    if (!priv->atlas_texture) {
+      gl->GenTextures (1, &priv->atlas_texture);
+      gl->BindTexture (GL_TEXTURE_2D, priv->atlas_texture);
+      gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      gl->TexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    gl->BindTexture (GL_TEXTURE_2D, priv->atlas_texture);
+    gl->TexImage2D (GL_TEXTURE_2D, 0, GL_RGBA, priv->atlas_size,
+        priv->atlas_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, zeros);
+    g_free (zeros);
+    priv->atlas_clear = FALSE;
+  }
+
+  for (l = compositor->overlays; l; l = l->next) {
+    GstGLCompositionOverlay *overlay = l->data;
+
+    if (overlay->in_atlas && overlay->needs_atlas_upload) {
+      gst_gl_composition_overlay_upload_to_atlas (overlay,
+          priv->atlas_texture);
+      overlay->needs_atlas_upload = FALSE;
+    }
+  }
+  gl->BindTexture (GL_TEXTURE_2D, 0);
+
+  /* one quad per overlay, the atlas ones first so that they are drawn with
+   * a single call */
+  vertices = g_array_new (FALSE, FALSE, sizeof (GLfloat));
+  g_array_set_size (priv->textures, 0);
+  priv->n_atlas_quads = 0;
+
+  for (l = compositor->overlays; l; l = l->next) {
+    GstGLCompositionOverlay *overlay = l->data;
+
+    if (overlay->in_atlas && priv->n_atlas_quads < MAX_QUADS) {
+      gst_gl_composition_overlay_add_vertices (overlay, vertices,
+          priv->video_width, priv->video_height, priv->atlas_size);
+      priv->n_atlas_quads++;
+    }
+  }
+  for (l = compositor->overlays; l; l = l->next) {
+    GstGLCompositionOverlay *overlay = l->data;
+
+    if (!overlay->in_atlas && overlay->texture_id
+        && priv->n_atlas_quads + priv->textures->len < MAX_QUADS) {
+      gst_gl_composition_overlay_add_vertices (overlay, vertices,
+          priv->video_width, priv->video_height, priv->atlas_size);
+      g_array_append_val (priv->textures, overlay->texture_id);
+    }
+  }
+
+  n_quads = priv->n_atlas_quads + priv->textures->len;
+  indices = g_array_sized_new (FALSE, FALSE, sizeof (GLushort), n_quads * 6);
+  for (i = 0; i < n_quads; i++) {
+    GLushort quad[6] = { 4 * i, 4 * i + 1, 4 * i + 2, 4 * i, 4 * i + 2,
+      4 * i + 3
+    };
+
+    g_array_append_vals (indices, quad, 6);
+  }
+
+  if (!priv->vertex_buffer) {
+    if (gl->GenVertexArrays) {
+      gl->GenVertexArrays (1, &priv->vao);
+      gl->BindVertexArray (priv->vao);
+    }
+
+    gl->GenBuffers (1, &priv->vertex_buffer);
+    gl->GenBuffers (1, &priv->index_buffer);
+
+    if (gl->GenVertexArrays) {
+      gl->BindBuffer (GL_ARRAY_BUFFER, priv->vertex_buffer);
+      gl->VertexAttribPointer (compositor->position_attrib, 4, GL_FLOAT,
+          GL_FALSE, VERTEX_SIZE * sizeof (GLfloat), NULL);
+      gl->VertexAttribPointer (compositor->texcoord_attrib, 2, GL_FLOAT,
+          GL_FALSE, VERTEX_SIZE * sizeof (GLfloat),
+          (gpointer) (4 * sizeof (GLfloat)));
+      gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, priv->index_buffer);
+      gl->EnableVertexAttribArray (compositor->position_attrib);
+      gl->EnableVertexAttribArray (compositor->texcoord_attrib);
+      gl->BindVertexArray (0);
+    }
+  }
+
+  gl->BindBuffer (GL_ARRAY_BUFFER, priv->vertex_buffer);
+  gl->BufferData (GL_ARRAY_BUFFER, vertices->len * sizeof (GLfloat),
+      vertices->data, GL_STATIC_DRAW);
+  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, priv->index_buffer);
+  gl->BufferData (GL_ELEMENT_ARRAY_BUFFER, indices->len * sizeof (GLushort),
+      indices->data, GL_STATIC_DRAW);
+  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
+  gl->BindBuffer (GL_ARRAY_BUFFER, 0);
+
+  g_array_free (vertices, TRUE);
+  g_array_free (indices, TRUE);
+
+  GST_DEBUG_OBJECT (compositor, "%u overlays in atlas, %u with own texture",
+      priv->n_atlas_quads, priv->textures->len);
+}
+
+static void
+gst_gl_overlay_compositor_clear_gl (GstGLContext * context,
+    gpointer compositor_pointer)
+{
+  GstGLOverlayCompositor *compositor =
+      (GstGLOverlayCompositor *) compositor_pointer;
+
+  compositor->priv->n_atlas_quads = 0;
+  g_array_set_size (compositor->priv->textures, 0);
+}
 
 void
 gst_gl_overlay_compositor_free_overlays (GstGLOverlayCompositor * compositor)
 {
-  GList *l = compositor->overlays;
-  while (l != NULL) {
-    GList *next = l->next;
-    GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-    compositor->overlays = g_list_delete_link (compositor->overlays, l);
-    gst_object_unref (overlay);
-    l = next;
-  }
-  g_list_free (compositor->overlays);
+  GstGLOverlayCompositorPrivate *priv = compositor->priv;
+
+  /* nothing may be drawn with the textures of the overlays anymore */
+  if (compositor->context)
+    gst_gl_context_thread_add (compositor->context,
+        gst_gl_overlay_compositor_clear_gl, compositor);
+
+  g_list_free_full (compositor->overlays, gst_object_unref);
   compositor->overlays = NULL;
+  g_list_free_full (priv->removed_overlays, gst_object_unref);
+  priv->removed_overlays = NULL;
+
+  priv->shelf_x = priv->shelf_y = priv->shelf_height = 0;
+  priv->atlas_clear = TRUE;
+  priv->dirty = FALSE;
 }
 
 void
 gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
     GstBuffer * buf)
 {
+  GstGLOverlayCompositorPrivate *priv = compositor->priv;
   GstVideoOverlayCompositionMeta *composition_meta;
 
   composition_meta = gst_buffer_get_video_overlay_composition_meta (buf);
   if (composition_meta) {
     GstVideoOverlayComposition *composition = NULL;
+    GstVideoMeta *meta;
+    gboolean repack = FALSE;
     guint num_overlays, i;
     GList *l = compositor->overlays;
 
@@ -558,32 +777,60 @@ gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
     composition = composition_meta->overlay;
     num_overlays = gst_video_overlay_composition_n_rectangles (composition);
 
-    /* add new overlays to list */
-    for (i = 0; i < num_overlays; i++) {
-      GstVideoOverlayRectangle *rectangle =
-          gst_video_overlay_composition_get_rectangle (composition, i);
-
-      if (!_is_rectangle_in_overlays (compositor->overlays, rectangle)) {
-        GstGLCompositionOverlay *overlay =
-            gst_gl_composition_overlay_new (compositor->context, rectangle,
-            compositor->position_attrib, compositor->texcoord_attrib);
-
-        gst_gl_composition_overlay_upload (overlay, buf);
-
-        compositor->overlays = g_list_append (compositor->overlays, overlay);
-      }
+    meta = gst_buffer_get_video_meta (buf);
+    if (meta->width != priv->video_width
+        || meta->height != priv->video_height) {
+      priv->video_width = meta->width;
+      priv->video_height = meta->height;
+      priv->dirty = TRUE;
     }
 
-    /* remove old overlays from list */
+    /* remove old overlays from list, they're freed once the draw state does
+     * not reference their textures anymore */
     while (l != NULL) {
       GList *next = l->next;
       GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
       if (!_is_overlay_in_rectangles (composition, overlay)) {
         compositor->overlays = g_list_delete_link (compositor->overlays, l);
-        gst_object_unref (overlay);
+        priv->removed_overlays =
+            g_list_prepend (priv->removed_overlays, overlay);
+        priv->dirty = TRUE;
       }
       l = next;
     }
+
+    /* add new overlays to list, rectangles are identified by their sequence
+     * number so that unchanged ones keep their texture */
+    for (i = 0; i < num_overlays; i++) {
+      GstVideoOverlayRectangle *rectangle =
+          gst_video_overlay_composition_get_rectangle (composition, i);
+      GstGLCompositionOverlay *overlay;
+
+      if (_find_overlay (compositor->overlays,
+              gst_video_overlay_rectangle_get_seqnum (rectangle)))
+        continue;
+
+      overlay = gst_gl_composition_overlay_new (compositor->context, rectangle);
+      compositor->overlays = g_list_append (compositor->overlays, overlay);
+      priv->dirty = TRUE;
+
+      if (!_is_atlas_candidate (compositor, overlay))
+        gst_gl_composition_overlay_upload (overlay);
+      else if (!repack && !_atlas_allocate (compositor, overlay))
+        repack = TRUE;
+    }
+
+    if (repack)
+      _atlas_repack (compositor);
+
+    if (priv->dirty) {
+      gst_gl_context_thread_add (compositor->context,
+          gst_gl_overlay_compositor_update_gl, compositor);
+      priv->dirty = FALSE;
+
+      g_list_free_full (priv->removed_overlays, gst_object_unref);
+      priv->removed_overlays = NULL;
+    }
   } else {
     gst_gl_overlay_compositor_free_overlays (compositor);
   }
@@ -592,25 +839,58 @@ gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
 void
 gst_gl_overlay_compositor_draw_overlays (GstGLOverlayCompositor * compositor)
 {
+  GstGLOverlayCompositorPrivate *priv = compositor->priv;
   const GstGLFuncs *gl = compositor->context->gl_vtable;
-  if (compositor->overlays != NULL) {
-    GList *l;
+  guint i;
 
-    gl->Enable (GL_BLEND);
-    gl->BlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  if (priv->n_atlas_quads == 0 && priv->textures->len == 0)
+    return;
 
-    gst_gl_shader_use (compositor->shader);
-    gl->ActiveTexture (GL_TEXTURE0);
-    gst_gl_shader_set_uniform_1i (compositor->shader, "tex", 0);
+  gl->Enable (GL_BLEND);
+  gl->BlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    for (l = compositor->overlays; l != NULL; l = l->next) {
-      GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-      gst_gl_composition_overlay_draw (overlay, compositor->shader);
-    }
+  gst_gl_shader_use (compositor->shader);
+  gl->ActiveTexture (GL_TEXTURE0);
+  gst_gl_shader_set_uniform_1i (compositor->shader, "tex", 0);
+
+  if (gl->GenVertexArrays) {
+    gl->BindVertexArray (priv->vao);
+  } else {
+    gl->BindBuffer (GL_ARRAY_BUFFER, priv->vertex_buffer);
+    gl->VertexAttribPointer (compositor->position_attrib, 4, GL_FLOAT,
+        GL_FALSE, VERTEX_SIZE * sizeof (GLfloat), NULL);
+    gl->VertexAttribPointer (compositor->texcoord_attrib, 2, GL_FLOAT,
+        GL_FALSE, VERTEX_SIZE * sizeof (GLfloat),
+        (gpointer) (4 * sizeof (GLfloat)));
+    gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, priv->index_buffer);
+    gl->EnableVertexAttribArray (compositor->position_attrib);
+    gl->EnableVertexAttribArray (compositor->texcoord_attrib);
+  }
 
-    gl->BindTexture (GL_TEXTURE_2D, 0);
-    gl->Disable (GL_BLEND);
+  /* all overlays in the atlas at once */
+  if (priv->n_atlas_quads > 0) {
+    gl->BindTexture (GL_TEXTURE_2D, priv->atlas_texture);
+    gl->DrawElements (GL_TRIANGLES, 6 * priv->n_atlas_quads,
+        GL_UNSIGNED_SHORT, 0);
   }
+
+  for (i = 0; i < priv->textures->len; i++) {
+    gl->BindTexture (GL_TEXTURE_2D, g_array_index (priv->textures, GLuint, i));
+    gl->DrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_SHORT,
+        (gpointer) ((priv->n_atlas_quads + i) * 6 * sizeof (GLushort)));
+  }
+
+  if (gl->GenVertexArrays) {
+    gl->BindVertexArray (0);
+  } else {
+    gl->DisableVertexAttribArray (compositor->position_attrib);
+    gl->DisableVertexAttribArray (compositor->texcoord_attrib);
+    gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
+    gl->BindBuffer (GL_ARRAY_BUFFER, 0);
+  }
+
+  gl->BindTexture (GL_TEXTURE_2D, 0);
+  gl->Disable (GL_BLEND);
 }
 
 GstCaps *
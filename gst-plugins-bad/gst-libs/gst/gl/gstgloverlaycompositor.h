@@ -35,6 +35,8 @@ G_BEGIN_DECLS
 
 GType gst_gl_overlay_compositor_get_type (void);
 
+typedef struct _GstGLOverlayCompositorPrivate GstGLOverlayCompositorPrivate;
+
 /**
  * GstGLOverlayCompositor
  *
@@ -52,6 +54,9 @@ struct _GstGLOverlayCompositor
   GstGLShader *shader;
   GLint  position_attrib;
   GLint  texcoord_attrib;
+
+  /* <private> */
+  GstGLOverlayCompositorPrivate *priv;
 };
 
 /**
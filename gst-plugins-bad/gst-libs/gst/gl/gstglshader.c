@@ -23,6 +23,9 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+#include <glib/gstdio.h>
+
 #include "gl.h"
 #include "gstglshader.h"
 #include "gstglsl_private.h"
@@ -31,6 +34,15 @@
  * SECTION:gstglshader
  * @short_description: object representing an OpenGL shader program
  * @see_also: #GstGLSLStage
+ *
+ * When the GL implementation supports retrieving program binaries
+ * (OpenGL 4.1, OpenGL ES 3.0, GL_ARB_get_program_binary or
+ * GL_OES_get_program_binary), successfully linked programs are kept in a
+ * process wide cache keyed by the stage sources and the GL driver.  Linking
+ * an identical program again, in the same or in another #GstGLContext, then
+ * loads the cached binary instead of compiling the stages.  If the
+ * GST_GL_SHADER_CACHE_DIR environment variable names a directory, the
+ * binaries are also stored there and reused across process restarts.
  */
 
 #ifndef GLhandleARB
@@ -80,6 +92,8 @@ struct _GstGLShaderPrivate
 
   gboolean linked;
   GHashTable *uniform_locations;
+  /* attribute and frag data bindings, part of the program cache key */
+  GString *bindings;
 
   GstGLSLFuncs vtable;
 };
@@ -130,6 +144,7 @@ gst_gl_shader_finalize (GObject * object)
 
   priv->program_handle = 0;
   g_hash_table_destroy (priv->uniform_locations);
+  g_string_free (priv->bindings, TRUE);
 
   if (shader->context) {
     gst_object_unref (shader->context);
@@ -199,6 +214,7 @@ gst_gl_shader_init (GstGLShader * self)
   priv->linked = FALSE;
   priv->uniform_locations =
       g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->bindings = g_string_new (NULL);
 }
 
 static int
@@ -613,6 +629,255 @@ gst_gl_shader_compile_attach_stage (GstGLShader * shader, GstGLSLStage * stage,
   return TRUE;
 }
 
+typedef struct
+{
+  GLenum format;
+  GBytes *data;
+} ProgramBinary;
+
+/* checksum of the program sources and GL driver -> ProgramBinary */
+static GHashTable *program_cache;
+static GMutex program_cache_lock;
+
+static void
+_program_binary_free (ProgramBinary * binary)
+{
+  g_bytes_unref (binary->data);
+  g_slice_free (ProgramBinary, binary);
+}
+
+static void
+_checksum_update_string (GChecksum * checksum, const gchar * str)
+{
+  if (str)
+    g_checksum_update (checksum, (const guchar *) str, strlen (str));
+  /* include the terminator so that concatenated strings cannot collide */
+  g_checksum_update (checksum, (const guchar *) "", 1);
+}
+
+/* must be called with the object lock and in the GL thread */
+static gchar *
+_get_program_cache_key (GstGLShader * shader)
+{
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GChecksum *checksum;
+  gchar *key, *tmp;
+  GList *elem;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA1);
+
+  /* binaries are only valid for the driver that produced them */
+  _checksum_update_string (checksum, (const gchar *) gl->GetString (GL_VENDOR));
+  _checksum_update_string (checksum,
+      (const gchar *) gl->GetString (GL_RENDERER));
+  _checksum_update_string (checksum,
+      (const gchar *) gl->GetString (GL_VERSION));
+  tmp = g_strdup_printf ("%u", gst_gl_context_get_gl_api (shader->context));
+  _checksum_update_string (checksum, tmp);
+  g_free (tmp);
+
+  for (elem = shader->priv->stages; elem; elem = elem->next) {
+    GstGLSLStage *stage = elem->data;
+    const gchar *const *strings;
+    gint i, n_strings = 0;
+
+    tmp = g_strdup_printf ("%u:%u:%u", gst_glsl_stage_get_shader_type (stage),
+        gst_glsl_stage_get_version (stage), gst_glsl_stage_get_profile (stage));
+    _checksum_update_string (checksum, tmp);
+    g_free (tmp);
+
+    strings = _gst_glsl_stage_get_strings (stage, &n_strings);
+    for (i = 0; i < n_strings; i++)
+      _checksum_update_string (checksum, strings[i]);
+  }
+
+  _checksum_update_string (checksum, shader->priv->bindings->str);
+
+  key = g_strdup (g_checksum_get_string (checksum));
+  g_checksum_free (checksum);
+
+  return key;
+}
+
+static gchar *
+_get_program_cache_filename (const gchar * key)
+{
+  const gchar *dir = g_getenv ("GST_GL_SHADER_CACHE_DIR");
+  gchar *basename, *ret;
+
+  if (!dir || !*dir)
+    return NULL;
+
+  basename = g_strdup_printf ("%s.bin", key);
+  ret = g_build_filename (dir, basename, NULL);
+  g_free (basename);
+
+  return ret;
+}
+
+/* returns a new reference to the cached binary for @key or %NULL */
+static GBytes *
+_program_cache_lookup (const gchar * key, GLenum * format)
+{
+  ProgramBinary *binary;
+  GBytes *ret = NULL;
+  gchar *filename;
+
+  g_mutex_lock (&program_cache_lock);
+  if (program_cache
+      && (binary = g_hash_table_lookup (program_cache, key))) {
+    *format = binary->format;
+    ret = g_bytes_ref (binary->data);
+  }
+  g_mutex_unlock (&program_cache_lock);
+
+  if (ret)
+    return ret;
+
+  if ((filename = _get_program_cache_filename (key))) {
+    gchar *contents;
+    gsize len;
+
+    /* a 32-bit binary format followed by the binary itself */
+    if (g_file_get_contents (filename, &contents, &len, NULL)) {
+      if (len > sizeof (guint32)) {
+        GBytes *file = g_bytes_new_take (contents, len);
+        guint32 file_format;
+
+        memcpy (&file_format, contents, sizeof (guint32));
+
+        binary = g_slice_new (ProgramBinary);
+        binary->format = file_format;
+        binary->data = g_bytes_new_from_bytes (file, sizeof (guint32),
+            len - sizeof (guint32));
+        g_bytes_unref (file);
+
+        *format = binary->format;
+        ret = g_bytes_ref (binary->data);
+
+        g_mutex_lock (&program_cache_lock);
+        if (!program_cache)
+          program_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+              g_free, (GDestroyNotify) _program_binary_free);
+        g_hash_table_replace (program_cache, g_strdup (key), binary);
+        g_mutex_unlock (&program_cache_lock);
+      } else {
+        g_free (contents);
+      }
+    }
+    g_free (filename);
+  }
+
+  return ret;
+}
+
+static void
+_program_cache_remove (const gchar * key)
+{
+  gchar *filename;
+
+  g_mutex_lock (&program_cache_lock);
+  if (program_cache)
+    g_hash_table_remove (program_cache, key);
+  g_mutex_unlock (&program_cache_lock);
+
+  if ((filename = _get_program_cache_filename (key))) {
+    g_unlink (filename);
+    g_free (filename);
+  }
+}
+
+/* must be called with the object lock and in the GL thread */
+static gboolean
+_program_cache_load (GstGLShader * shader, const gchar * key)
+{
+  GstGLShaderPrivate *priv = shader->priv;
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GLint status = GL_FALSE;
+  GLenum format = 0;
+  GBytes *data;
+  gsize size;
+
+  if (!(data = _program_cache_lookup (key, &format)))
+    return FALSE;
+
+  gl->ProgramBinary (priv->program_handle, format,
+      g_bytes_get_data (data, &size), size);
+  g_bytes_unref (data);
+
+  priv->vtable.GetProgramiv (priv->program_handle, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    /* driver update or otherwise stale binary, recompile and replace it */
+    GST_INFO_OBJECT (shader, "cached binary for program %u was rejected",
+        priv->program_handle);
+    _program_cache_remove (key);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (shader, "program %u loaded from the binary cache",
+      priv->program_handle);
+
+  return TRUE;
+}
+
+/* must be called with the object lock and in the GL thread */
+static void
+_program_cache_store (GstGLShader * shader, const gchar * key)
+{
+  GstGLShaderPrivate *priv = shader->priv;
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  ProgramBinary *binary;
+  GLint len = 0;
+  GLsizei written = 0;
+  GLenum format = 0;
+  gchar *filename;
+  guint8 *data;
+
+  priv->vtable.GetProgramiv (priv->program_handle, GL_PROGRAM_BINARY_LENGTH,
+      &len);
+  if (len <= 0)
+    return;
+
+  /* leave room for the format when writing to disk */
+  data = g_malloc (sizeof (guint32) + len);
+  gl->GetProgramBinary (priv->program_handle, len, &written, &format,
+      data + sizeof (guint32));
+  if (written <= 0) {
+    g_free (data);
+    return;
+  }
+
+  binary = g_slice_new (ProgramBinary);
+  binary->format = format;
+  binary->data = g_bytes_new (data + sizeof (guint32), written);
+
+  g_mutex_lock (&program_cache_lock);
+  if (!program_cache)
+    program_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) _program_binary_free);
+  g_hash_table_replace (program_cache, g_strdup (key), binary);
+  g_mutex_unlock (&program_cache_lock);
+
+  GST_DEBUG_OBJECT (shader, "stored %i byte binary of program %u", written,
+      priv->program_handle);
+
+  if ((filename = _get_program_cache_filename (key))) {
+    guint32 file_format = format;
+    GError *error = NULL;
+
+    memcpy (data, &file_format, sizeof (guint32));
+    if (!g_file_set_contents (filename, (const gchar *) data,
+            sizeof (guint32) + written, &error)) {
+      GST_WARNING_OBJECT (shader, "Failed to write program binary: %s",
+          error->message);
+      g_clear_error (&error);
+    }
+    g_free (filename);
+  }
+
+  g_free (data);
+}
+
 /**
  * gst_gl_shader_link:
  * @shader: a #GstGLShader
@@ -636,6 +901,7 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
   gint len = 0;
   gboolean ret;
   GList *elem;
+  gchar *cache_key = NULL;
 
   g_return_val_if_fail (GST_IS_GL_SHADER (shader), FALSE);
 
@@ -665,10 +931,25 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
 
   GST_TRACE ("shader created %u", shader->priv->program_handle);
 
+  if (gl->GetProgramBinary && gl->ProgramBinary) {
+    cache_key = _get_program_cache_key (shader);
+
+    if (_program_cache_load (shader, cache_key)) {
+      g_free (cache_key);
+      ret = priv->linked = TRUE;
+      GST_OBJECT_UNLOCK (shader);
+
+      g_object_notify (G_OBJECT (shader), "linked");
+
+      return ret;
+    }
+  }
+
   for (elem = shader->priv->stages; elem; elem = elem->next) {
     GstGLSLStage *stage = elem->data;
 
     if (!gst_glsl_stage_compile (stage, error)) {
+      g_free (cache_key);
       GST_OBJECT_UNLOCK (shader);
       return FALSE;
     }
@@ -677,11 +958,16 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
       g_set_error (error, GST_GLSL_ERROR, GST_GLSL_ERROR_COMPILE,
           "Failed to attach shader %" GST_PTR_FORMAT "to program %"
           GST_PTR_FORMAT, stage, shader);
+      g_free (cache_key);
       GST_OBJECT_UNLOCK (shader);
       return FALSE;
     }
   }
 
+  if (cache_key && gl->ProgramParameteri)
+    gl->ProgramParameteri (priv->program_handle,
+        GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
   /* if nothing failed link shaders */
   gl->LinkProgram (priv->program_handle);
   status = GL_FALSE;
@@ -697,12 +983,18 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
     g_set_error (error, GST_GLSL_ERROR, GST_GLSL_ERROR_LINK,
         "Shader Linking failed:\n%s", info_buffer);
     ret = priv->linked = FALSE;
+    g_free (cache_key);
     GST_OBJECT_UNLOCK (shader);
     return ret;
   } else if (len > 1) {
     GST_FIXME ("shader link log:\n%s\n", info_buffer);
   }
 
+  if (cache_key) {
+    _program_cache_store (shader, cache_key);
+    g_free (cache_key);
+  }
+
   ret = priv->linked = TRUE;
   GST_OBJECT_UNLOCK (shader);
 
@@ -735,7 +1027,9 @@ gst_gl_shader_release_unlocked (GstGLShader * shader)
     GstGLSLStage *stage = elem->data;
     GList *next = elem->next;
 
-    gst_gl_shader_detach_unlocked (shader, stage);
+    /* stages of programs loaded from the binary cache are never compiled */
+    if (gst_glsl_stage_get_handle (stage))
+      gst_gl_shader_detach_unlocked (shader, stage);
     elem = next;
   }
 
@@ -1304,6 +1598,8 @@ gst_gl_shader_bind_attribute_location (GstGLShader * shader, GLuint index,
   GST_TRACE_OBJECT (shader, "binding program %i attribute \'%s\' location %i",
       (int) priv->program_handle, name, index);
 
+  g_string_append_printf (priv->bindings, "a%u=%s;", index, name);
+
   gl->BindAttribLocation (priv->program_handle, index, name);
 }
 
@@ -1324,5 +1620,7 @@ gst_gl_shader_bind_frag_data_location (GstGLShader * shader,
   GST_TRACE_OBJECT (shader, "binding program %i frag data \'%s\' location %i",
       (int) priv->program_handle, name, index);
 
+  g_string_append_printf (priv->bindings, "f%u=%s;", index, name);
+
   gl->BindFragDataLocation (priv->program_handle, index, name);
 }
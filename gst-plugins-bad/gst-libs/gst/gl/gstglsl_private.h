@@ -31,6 +31,12 @@ G_BEGIN_DECLS
 #ifndef GLhandleARB
 #define GLhandleARB GLuint
 #endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH      0x8741
+#endif
 
 typedef struct _GstGLSLFuncs
 {
@@ -57,6 +63,7 @@ typedef struct _GstGLSLFuncs
 
 G_GNUC_INTERNAL gboolean _gst_glsl_funcs_fill (GstGLSLFuncs * vtable, GstGLContext * context);
 G_GNUC_INTERNAL const gchar * _gst_glsl_shader_string_find_version (const gchar * str);
+G_GNUC_INTERNAL const gchar * const * _gst_glsl_stage_get_strings (GstGLSLStage * stage, gint * n_strings);
 
 G_GNUC_INTERNAL gchar *
 _gst_glsl_mangle_shader (const gchar * str, guint shader_type, GstGLTextureTarget from,
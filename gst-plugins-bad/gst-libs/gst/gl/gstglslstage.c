@@ -396,6 +396,18 @@ gst_glsl_stage_get_profile (GstGLSLStage * stage)
   return stage->priv->profile;
 }
 
+/* internal: the unmangled source strings, used as program cache keys */
+const gchar *const *
+_gst_glsl_stage_get_strings (GstGLSLStage * stage, gint * n_strings)
+{
+  g_return_val_if_fail (GST_IS_GLSL_STAGE (stage), NULL);
+
+  if (n_strings)
+    *n_strings = stage->priv->n_strings;
+
+  return (const gchar * const *) stage->priv->strings;
+}
+
 static void
 _maybe_prepend_version (GstGLSLStage * stage, gchar ** shader_str,
     gint * n_vertex_sources, const gchar *** vertex_sources)
@@ -102,6 +102,8 @@ struct _GstGLUploadPrivate
   const UploadMethod *method;
   gpointer method_impl;
   int method_i;
+
+  gboolean dmabuf_fallback_warned;
 };
 
 static GstCaps *
@@ -455,7 +457,9 @@ struct DmabufUpload
 };
 
 static GstStaticCaps _dma_buf_upload_caps =
-GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_GL_MEMORY_VIDEO_FORMATS_STR));
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
+    (GST_CAPS_FEATURE_MEMORY_DMABUF, GST_GL_MEMORY_VIDEO_FORMATS_STR) ";"
+    GST_VIDEO_CAPS_MAKE (GST_GL_MEMORY_VIDEO_FORMATS_STR));
 
 static gpointer
 _dma_buf_upload_new (GstGLUpload * upload)
@@ -487,9 +491,12 @@ _dma_buf_upload_transform_caps (GstGLContext * context,
   } else {
     gint i, n;
 
+    /* prefer announcing dmabuf explicitly, so that upstream can export it */
     ret =
         _set_caps_features_with_passthrough (caps,
-        GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY, passthrough);
+        GST_CAPS_FEATURE_MEMORY_DMABUF, passthrough);
+    ret = gst_caps_merge (ret, _set_caps_features_with_passthrough (caps,
+            GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY, passthrough));
 
     n = gst_caps_get_size (ret);
     for (i = 0; i < n; i++) {
@@ -504,6 +511,22 @@ _dma_buf_upload_transform_caps (GstGLContext * context,
   return ret;
 }
 
+/* warn once when a dmabuf could not be imported and will be copied by
+ * another upload method instead */
+static gboolean
+_dma_buf_upload_fallback (struct DmabufUpload *dmabuf, const gchar * reason)
+{
+  GstGLUploadPrivate *priv = dmabuf->upload->priv;
+
+  if (!priv->dmabuf_fallback_warned) {
+    GST_WARNING_OBJECT (dmabuf->upload, "cannot import DMABuf (%s), falling "
+        "back to a copy", reason);
+    priv->dmabuf_fallback_warned = TRUE;
+  }
+
+  return FALSE;
+}
+
 static GQuark
 _eglimage_quark (gint plane)
 {
@@ -552,21 +575,21 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
   n_mem = gst_buffer_n_memory (buffer);
   meta = gst_buffer_get_video_meta (buffer);
 
+  /* This will eliminate most non-dmabuf out there */
+  if (!gst_is_dmabuf_memory (gst_buffer_peek_memory (buffer, 0)))
+    return FALSE;
+
   /* dmabuf upload is only supported with EGL contexts. */
   if (!GST_IS_GL_CONTEXT_EGL (dmabuf->upload->context))
-    return FALSE;
+    return _dma_buf_upload_fallback (dmabuf, "not an EGL context");
 
   if (!gst_gl_context_check_feature (dmabuf->upload->context,
           "EGL_KHR_image_base"))
-    return FALSE;
-
-  /* This will eliminate most non-dmabuf out there */
-  if (!gst_is_dmabuf_memory (gst_buffer_peek_memory (buffer, 0)))
-    return FALSE;
+    return _dma_buf_upload_fallback (dmabuf, "no EGL_KHR_image_base");
 
   /* We cannot have multiple dmabuf per plane */
   if (n_mem > n_planes)
-    return FALSE;
+    return _dma_buf_upload_fallback (dmabuf, "more memories than planes");
 
   /* Update video info based on video meta */
   if (meta) {
@@ -596,17 +619,17 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
 
     if (!gst_buffer_find_memory (buffer, in_info->offset[i], plane_size,
             &mems_idx[i], &length, &mems_skip[i]))
-      return FALSE;
+      return _dma_buf_upload_fallback (dmabuf, "plane not found");
 
     /* We can't have more then one dmabuf per plane */
     if (length != 1)
-      return FALSE;
+      return _dma_buf_upload_fallback (dmabuf, "plane spans memories");
 
     mems[i] = gst_buffer_peek_memory (buffer, mems_idx[i]);
 
     /* And all memory found must be dmabuf */
     if (!gst_is_dmabuf_memory (mems[i]))
-      return FALSE;
+      return _dma_buf_upload_fallback (dmabuf, "not all planes are DMABuf");
   }
 
   /* Now create an EGLImage for each dmabufs */
@@ -618,11 +641,12 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
 
     /* otherwise create one and cache it */
     dmabuf->eglimage[i] =
-        gst_egl_image_from_dmabuf (dmabuf->upload->context,
-        gst_dmabuf_memory_get_fd (mems[i]), in_info, i, mems_skip[i]);
+        gst_egl_image_from_dmabuf_with_modifier (dmabuf->upload->context,
+        gst_dmabuf_memory_get_fd (mems[i]), in_info, i, mems_skip[i],
+        gst_dmabuf_memory_get_drm_modifier (mems[i]));
 
     if (!dmabuf->eglimage[i])
-      return FALSE;
+      return _dma_buf_upload_fallback (dmabuf, "EGLImage creation failed");
 
     _set_cached_eglimage (mems[i], dmabuf->eglimage[i], i);
   }
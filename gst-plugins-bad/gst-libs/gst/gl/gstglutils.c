@@ -655,6 +655,14 @@ gst_gl_display_context_propagate (GstElement * element, GstGLDisplay * display)
   gst_element_post_message (GST_ELEMENT_CAST (element), msg);
 }
 
+static gboolean
+_use_shared_display (void)
+{
+  const gchar *shared = g_getenv ("GST_GL_SHARED_DISPLAY");
+
+  return shared && *shared && g_strcmp0 (shared, "0") != 0;
+}
+
 gboolean
 gst_gl_ensure_element_data (gpointer element, GstGLDisplay ** display_ptr,
     GstGLContext ** context_ptr)
@@ -679,7 +687,10 @@ gst_gl_ensure_element_data (gpointer element, GstGLDisplay ** display_ptr,
     goto get_gl_context;
 
   /* If no neighboor, or application not interested, use system default */
-  display = gst_gl_display_new ();
+  if (_use_shared_display ())
+    display = gst_gl_display_get_shared ();
+  else
+    display = gst_gl_display_new ();
 
   *display_ptr = display;
 
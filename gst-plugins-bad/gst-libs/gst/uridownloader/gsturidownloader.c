@@ -46,8 +46,17 @@ struct _GstUriDownloaderPrivate
 
   GCond cond;
   gboolean cancelled;
+
+  /* when set, buffers are handed to this function as they arrive
+   * instead of being accumulated in the fragment */
+  GstUriDownloaderChunkReceivedFunc chunk_func;
+  gpointer chunk_user_data;
 };
 
+/* protects the shared fetch cache below */
+static GMutex cache_lock;
+static GCond cache_cond;
+
 static void gst_uri_downloader_finalize (GObject * object);
 static void gst_uri_downloader_dispose (GObject * object);
 
@@ -283,6 +292,40 @@ gst_uri_downloader_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GST_LOG_OBJECT (downloader, "The uri fetcher received a new buffer "
       "of size %" G_GSIZE_FORMAT, gst_buffer_get_size (buf));
   downloader->priv->got_buffer = TRUE;
+
+  if (downloader->priv->chunk_func) {
+    GstUriDownloaderChunkReceivedFunc chunk_func = downloader->priv->chunk_func;
+    gpointer user_data = downloader->priv->chunk_user_data;
+    gboolean more;
+
+    if (downloader->priv->download->completed) {
+      /* finished early by the chunk function */
+      gst_buffer_unref (buf);
+      GST_OBJECT_UNLOCK (downloader);
+      return GST_FLOW_EOS;
+    }
+
+    /* don't call out with the lock held, the function might want to
+     * cancel the download */
+    GST_OBJECT_UNLOCK (downloader);
+    more = chunk_func (downloader, buf, user_data);
+    gst_buffer_unref (buf);
+
+    if (!more) {
+      GST_DEBUG_OBJECT (downloader, "No more data wanted, finishing download");
+      GST_OBJECT_LOCK (downloader);
+      if (downloader->priv->download != NULL) {
+        downloader->priv->download->completed = TRUE;
+        downloader->priv->download->download_stop_time =
+            gst_util_get_timestamp ();
+        g_cond_signal (&downloader->priv->cond);
+      }
+      GST_OBJECT_UNLOCK (downloader);
+      return GST_FLOW_EOS;
+    }
+    goto done;
+  }
+
   if (!gst_fragment_add_buffer (downloader->priv->download, buf)) {
     GST_WARNING_OBJECT (downloader, "Could not add buffer to fragment");
     gst_buffer_unref (buf);
@@ -326,6 +369,11 @@ gst_uri_downloader_cancel (GstUriDownloader * downloader)
           "Trying to cancel a download that was alredy cancelled");
   }
   GST_OBJECT_UNLOCK (downloader);
+
+  /* wake up the downloader if it's waiting for a shared fetch */
+  g_mutex_lock (&cache_lock);
+  g_cond_broadcast (&cache_cond);
+  g_mutex_unlock (&cache_lock);
 }
 
 static gboolean
@@ -425,6 +473,8 @@ gst_uri_downloader_set_uri (GstUriDownloader * downloader, const gchar * uri,
     g_object_set (downloader->priv->urisrc, "compress", compress, NULL);
   if (g_object_class_find_property (gobject_class, "keep-alive"))
     g_object_set (downloader->priv->urisrc, "keep-alive", TRUE, NULL);
+  if (g_object_class_find_property (gobject_class, "shared-session"))
+    g_object_set (downloader->priv->urisrc, "shared-session", TRUE, NULL);
   if (g_object_class_find_property (gobject_class, "extra-headers")) {
     if (referer || refresh || !allow_cache) {
       GstStructure *extra_headers = gst_structure_new_empty ("headers");
@@ -480,6 +530,233 @@ gst_uri_downloader_set_method (GstUriDownloader * downloader,
   return FALSE;
 }
 
+/* Process-wide cache of completed downloads, shared by all downloaders in
+ * the process so that several players fetching the same playlists, keys or
+ * byte ranges only go to the network once. Entries are keyed by URI and
+ * byte range, kept in LRU order and evicted once their total size exceeds
+ * the configured maximum. While a fetch is in flight, other fetches of the
+ * same key wait for it instead of starting a transfer of their own.
+ *
+ * The cache is disabled unless a maximum size is given, either with
+ * gst_uri_downloader_set_cache_size() or with the
+ * GST_URI_DOWNLOADER_CACHE_SIZE environment variable (in bytes). */
+
+/* lifetime of responses that don't carry a Cache-Control max-age */
+#define DEFAULT_CACHE_LIFETIME (10 * G_TIME_SPAN_SECOND)
+
+typedef struct
+{
+  gint refcount;
+  gchar *key;
+
+  gboolean done;                /* the transfer has finished */
+  GstFragment *fragment;        /* result, NULL if the transfer failed */
+  gsize size;
+  gint64 expires;               /* monotonic time */
+  GList *link;                  /* position in cache_lru if stored */
+} GstUriDownloaderCacheEntry;
+
+static gboolean cache_initialized;
+static GHashTable *cache_entries;       /* key -> entry, stored or in flight */
+static GQueue cache_lru = G_QUEUE_INIT; /* stored entries, most recent first */
+static guint64 cache_size;
+static guint64 cache_max_size;
+
+static void
+gst_uri_downloader_cache_init_unlocked (void)
+{
+  const gchar *env;
+
+  if (cache_initialized)
+    return;
+
+  cache_initialized = TRUE;
+  cache_entries = g_hash_table_new (g_str_hash, g_str_equal);
+
+  env = g_getenv ("GST_URI_DOWNLOADER_CACHE_SIZE");
+  if (env)
+    cache_max_size = g_ascii_strtoull (env, NULL, 10);
+}
+
+static void
+gst_uri_downloader_cache_entry_unref (GstUriDownloaderCacheEntry * entry)
+{
+  if (--entry->refcount > 0)
+    return;
+
+  if (entry->fragment)
+    g_object_unref (entry->fragment);
+  g_free (entry->key);
+  g_slice_free (GstUriDownloaderCacheEntry, entry);
+}
+
+static void
+gst_uri_downloader_cache_remove_unlocked (GstUriDownloaderCacheEntry * entry)
+{
+  if (g_hash_table_lookup (cache_entries, entry->key) != entry)
+    return;
+
+  g_hash_table_remove (cache_entries, entry->key);
+  if (entry->link) {
+    g_queue_delete_link (&cache_lru, entry->link);
+    entry->link = NULL;
+    cache_size -= entry->size;
+  }
+  gst_uri_downloader_cache_entry_unref (entry);
+}
+
+static void
+gst_uri_downloader_cache_evict_unlocked (void)
+{
+  while (cache_size > cache_max_size && cache_lru.tail) {
+    GstUriDownloaderCacheEntry *entry = cache_lru.tail->data;
+
+    GST_LOG ("Evicting %s (%" G_GSIZE_FORMAT " bytes) from the cache",
+        entry->key, entry->size);
+    gst_uri_downloader_cache_remove_unlocked (entry);
+  }
+}
+
+/* Returns the lifetime for @value, a Cache-Control header, given the
+ * lifetime derived from the headers seen before. -1 means not cacheable */
+static gint64
+gst_uri_downloader_parse_cache_control (const gchar * value, gint64 lifetime)
+{
+  gchar **directives;
+  guint i;
+
+  if (lifetime < 0)
+    return lifetime;
+
+  directives = g_strsplit (value, ",", -1);
+  for (i = 0; directives[i]; i++) {
+    gchar *directive = g_strstrip (directives[i]);
+
+    if (!g_ascii_strcasecmp (directive, "no-store") ||
+        !g_ascii_strcasecmp (directive, "no-cache")) {
+      lifetime = -1;
+      break;
+    } else if (!g_ascii_strncasecmp (directive, "max-age=", 8)) {
+      gint64 max_age = g_ascii_strtoll (directive + 8, NULL, 10);
+
+      lifetime = MAX (max_age, 0) * G_TIME_SPAN_SECOND;
+    }
+  }
+  g_strfreev (directives);
+
+  return lifetime;
+}
+
+static gboolean
+gst_uri_downloader_parse_header (GQuark field_id, const GValue * value,
+    gpointer user_data)
+{
+  gint64 *lifetime = user_data;
+
+  if (g_ascii_strcasecmp (g_quark_to_string (field_id), "Cache-Control"))
+    return TRUE;
+
+  if (G_VALUE_HOLDS_STRING (value)) {
+    *lifetime =
+        gst_uri_downloader_parse_cache_control (g_value_get_string (value),
+        *lifetime);
+  } else if (GST_VALUE_HOLDS_ARRAY (value)) {
+    guint i;
+
+    for (i = 0; i < gst_value_array_get_size (value); i++) {
+      const GValue *v = gst_value_array_get_value (value, i);
+
+      if (G_VALUE_HOLDS_STRING (v))
+        *lifetime =
+            gst_uri_downloader_parse_cache_control (g_value_get_string (v),
+            *lifetime);
+    }
+  }
+
+  return TRUE;
+}
+
+/* How long @download may be served from the cache, honouring the
+ * Cache-Control response header when the source element provided one */
+static gint64
+gst_uri_downloader_cache_lifetime (GstFragment * download)
+{
+  gint64 lifetime = DEFAULT_CACHE_LIFETIME;
+  const GValue *value = NULL;
+
+  if (download->headers)
+    value = gst_structure_get_value (download->headers, "response-headers");
+
+  if (value && GST_VALUE_HOLDS_STRUCTURE (value))
+    gst_structure_foreach (gst_value_get_structure (value),
+        gst_uri_downloader_parse_header, &lifetime);
+
+  return lifetime;
+}
+
+static GstFragment *
+gst_uri_downloader_copy_fragment (GstFragment * fragment)
+{
+  GstFragment *copy;
+  GstBuffer *buffer;
+
+  copy = gst_fragment_new ();
+  copy->uri = g_strdup (fragment->uri);
+  copy->redirect_uri = g_strdup (fragment->redirect_uri);
+  copy->redirect_permanent = fragment->redirect_permanent;
+  copy->range_start = fragment->range_start;
+  copy->range_end = fragment->range_end;
+  copy->download_start_time = fragment->download_start_time;
+  copy->download_stop_time = fragment->download_stop_time;
+  if (fragment->headers)
+    copy->headers = gst_structure_copy (fragment->headers);
+
+  /* share the memory but not the buffer metadata, the users of the
+   * fragments might be in different threads */
+  buffer = gst_fragment_get_buffer (fragment);
+  if (buffer) {
+    gst_fragment_add_buffer (copy, gst_buffer_copy (buffer));
+    gst_buffer_unref (buffer);
+  }
+  copy->completed = TRUE;
+
+  return copy;
+}
+
+static gboolean
+gst_uri_downloader_is_cancelled (GstUriDownloader * downloader)
+{
+  gboolean cancelled;
+
+  GST_OBJECT_LOCK (downloader);
+  cancelled = downloader->priv->cancelled;
+  GST_OBJECT_UNLOCK (downloader);
+
+  return cancelled;
+}
+
+/**
+ * gst_uri_downloader_set_cache_size:
+ * @max_size: maximum size in bytes of the cached data, 0 disables the cache
+ *
+ * Sets the size of the cache shared by all #GstUriDownloader in the process.
+ * Successful fetches are kept in the cache for as long as their Cache-Control
+ * response header allows, and concurrent fetches of the same URI and range
+ * share a single transfer. Fetches that ask for @refresh or disallow the
+ * cache are never served from stored data.
+ *
+ * Since: 1.10
+ */
+void
+gst_uri_downloader_set_cache_size (guint64 max_size)
+{
+  g_mutex_lock (&cache_lock);
+  gst_uri_downloader_cache_init_unlocked ();
+  cache_max_size = max_size;
+  gst_uri_downloader_cache_evict_unlocked ();
+  g_mutex_unlock (&cache_lock);
+}
+
 GstFragment *
 gst_uri_downloader_fetch_uri (GstUriDownloader * downloader,
     const gchar * uri, const gchar * referer, gboolean compress,
@@ -489,20 +766,12 @@ gst_uri_downloader_fetch_uri (GstUriDownloader * downloader,
       referer, compress, refresh, allow_cache, 0, -1, err);
 }
 
-/**
- * gst_uri_downloader_fetch_uri_with_range:
- * @downloader: the #GstUriDownloader
- * @uri: the uri
- * @range_start: the starting byte index
- * @range_end: the final byte index, use -1 for unspecified
- *
- * Returns the downloaded #GstFragment
- */
-GstFragment *
-gst_uri_downloader_fetch_uri_with_range (GstUriDownloader *
-    downloader, const gchar * uri, const gchar * referer, gboolean compress,
-    gboolean refresh, gboolean allow_cache,
-    gint64 range_start, gint64 range_end, GError ** err)
+static GstFragment *
+gst_uri_downloader_do_fetch (GstUriDownloader * downloader, const gchar * uri,
+    const gchar * referer, gboolean compress, gboolean refresh,
+    gboolean allow_cache, gint64 range_start, gint64 range_end,
+    GstUriDownloaderChunkReceivedFunc chunk_func, gpointer user_data,
+    GError ** err)
 {
   GstStateChangeReturn ret;
   GstFragment *download = NULL;
@@ -514,6 +783,8 @@ gst_uri_downloader_fetch_uri_with_range (GstUriDownloader *
   downloader->priv->got_buffer = FALSE;
 
   GST_OBJECT_LOCK (downloader);
+  downloader->priv->chunk_func = chunk_func;
+  downloader->priv->chunk_user_data = user_data;
   if (downloader->priv->cancelled) {
     GST_DEBUG_OBJECT (downloader, "Cancelled, aborting fetch");
     goto quit;
@@ -649,6 +920,8 @@ quit:
         gst_object_unref (pad);
       }
     }
+    downloader->priv->chunk_func = NULL;
+    downloader->priv->chunk_user_data = NULL;
     GST_OBJECT_UNLOCK (downloader);
 
     if (download == NULL) {
@@ -667,3 +940,164 @@ quit:
     return download;
   }
 }
+
+/**
+ * gst_uri_downloader_fetch_uri_with_range:
+ * @downloader: the #GstUriDownloader
+ * @uri: the uri
+ * @range_start: the starting byte index
+ * @range_end: the final byte index, use -1 for unspecified
+ *
+ * Returns the downloaded #GstFragment
+ */
+GstFragment *
+gst_uri_downloader_fetch_uri_with_range (GstUriDownloader *
+    downloader, const gchar * uri, const gchar * referer, gboolean compress,
+    gboolean refresh, gboolean allow_cache,
+    gint64 range_start, gint64 range_end, GError ** err)
+{
+  GstUriDownloaderCacheEntry *entry;
+  GstFragment *download = NULL;
+  gchar *key;
+  gint64 now, lifetime;
+
+  /* HEAD requests are not worth caching */
+  if (range_start < 0 && range_end < 0)
+    goto fetch;
+
+  g_mutex_lock (&cache_lock);
+  gst_uri_downloader_cache_init_unlocked ();
+  if (cache_max_size == 0) {
+    g_mutex_unlock (&cache_lock);
+    goto fetch;
+  }
+
+  key = g_strdup_printf ("%s|%" G_GINT64_FORMAT "|%" G_GINT64_FORMAT, uri,
+      range_start, range_end);
+  now = g_get_monotonic_time ();
+
+  entry = g_hash_table_lookup (cache_entries, key);
+  if (entry && entry->done) {
+    if (entry->fragment && now < entry->expires && !refresh && allow_cache) {
+      GST_DEBUG_OBJECT (downloader, "Using cached copy of URI %s", uri);
+      g_queue_unlink (&cache_lru, entry->link);
+      g_queue_push_head_link (&cache_lru, entry->link);
+      download = gst_uri_downloader_copy_fragment (entry->fragment);
+      g_mutex_unlock (&cache_lock);
+      g_free (key);
+
+      if (gst_uri_downloader_is_cancelled (downloader)) {
+        /* behave like a cancelled transfer */
+        g_object_unref (download);
+        goto fetch;
+      }
+      return download;
+    }
+
+    /* expired, or the caller wants a fresh copy */
+    gst_uri_downloader_cache_remove_unlocked (entry);
+    entry = NULL;
+  }
+
+  if (entry) {
+    /* Someone else is fetching the same data. Its response can't be older
+     * than this request, so it's fine to share even with @refresh */
+    GST_DEBUG_OBJECT (downloader, "Waiting for pending fetch of URI %s", uri);
+    entry->refcount++;
+    while (!entry->done && !gst_uri_downloader_is_cancelled (downloader))
+      g_cond_wait (&cache_cond, &cache_lock);
+
+    if (entry->done && entry->fragment)
+      download = gst_uri_downloader_copy_fragment (entry->fragment);
+    gst_uri_downloader_cache_entry_unref (entry);
+    g_mutex_unlock (&cache_lock);
+    g_free (key);
+
+    if (download)
+      return download;
+
+    /* the other fetch failed or we got cancelled, retry on our own so
+     * that the error is reported for this downloader */
+    goto fetch;
+  }
+
+  entry = g_slice_new0 (GstUriDownloaderCacheEntry);
+  entry->refcount = 2;
+  entry->key = key;
+  g_hash_table_insert (cache_entries, entry->key, entry);
+  g_mutex_unlock (&cache_lock);
+
+  download = gst_uri_downloader_do_fetch (downloader, uri, referer, compress,
+      refresh, allow_cache, range_start, range_end, NULL, NULL, err);
+
+  lifetime = download ? gst_uri_downloader_cache_lifetime (download) : -1;
+
+  g_mutex_lock (&cache_lock);
+  entry->done = TRUE;
+  if (download)
+    entry->fragment = gst_uri_downloader_copy_fragment (download);
+
+  if (entry->fragment && lifetime > 0 && cache_max_size > 0) {
+    GstBuffer *buffer = gst_fragment_get_buffer (entry->fragment);
+
+    if (buffer) {
+      entry->size = gst_buffer_get_size (buffer);
+      gst_buffer_unref (buffer);
+    }
+    entry->expires = g_get_monotonic_time () + lifetime;
+    g_queue_push_head (&cache_lru, entry);
+    entry->link = cache_lru.head;
+    cache_size += entry->size;
+    gst_uri_downloader_cache_evict_unlocked ();
+  } else {
+    gst_uri_downloader_cache_remove_unlocked (entry);
+  }
+  g_cond_broadcast (&cache_cond);
+  gst_uri_downloader_cache_entry_unref (entry);
+  g_mutex_unlock (&cache_lock);
+
+  return download;
+
+fetch:
+  return gst_uri_downloader_do_fetch (downloader, uri, referer, compress,
+      refresh, allow_cache, range_start, range_end, NULL, NULL, err);
+}
+
+/**
+ * gst_uri_downloader_fetch_uri_with_range_chunked:
+ * @downloader: the #GstUriDownloader
+ * @uri: the uri
+ * @range_start: the starting byte index
+ * @range_end: the final byte index, use -1 for unspecified
+ * @chunk_func: (scope call): function called for each chunk of data
+ * @user_data: user data passed to @chunk_func
+ *
+ * Like gst_uri_downloader_fetch_uri_with_range() but hands the data to
+ * @chunk_func as it arrives from the network instead of collecting it in
+ * the returned fragment, so that callers can start parsing before the
+ * transfer is finished and don't need to keep the whole resource in
+ * memory. @chunk_func is called from the streaming thread of the source
+ * element and can stop the transfer early by returning %FALSE, in which
+ * case the fetch still succeeds.
+ *
+ * These fetches bypass the shared cache.
+ *
+ * Returns: a #GstFragment without data, holding the final URI and the
+ * HTTP headers, or %NULL on error
+ *
+ * Since: 1.10
+ */
+GstFragment *
+gst_uri_downloader_fetch_uri_with_range_chunked (GstUriDownloader *
+    downloader, const gchar * uri, const gchar * referer, gboolean compress,
+    gboolean refresh, gboolean allow_cache,
+    gint64 range_start, gint64 range_end,
+    GstUriDownloaderChunkReceivedFunc chunk_func, gpointer user_data,
+    GError ** err)
+{
+  g_return_val_if_fail (chunk_func != NULL, NULL);
+
+  return gst_uri_downloader_do_fetch (downloader, uri, referer, compress,
+      refresh, allow_cache, range_start, range_end, chunk_func, user_data,
+      err);
+}
@@ -43,6 +43,21 @@ typedef struct _GstUriDownloader GstUriDownloader;
 typedef struct _GstUriDownloaderPrivate GstUriDownloaderPrivate;
 typedef struct _GstUriDownloaderClass GstUriDownloaderClass;
 
+/**
+ * GstUriDownloaderChunkReceivedFunc:
+ * @downloader: the #GstUriDownloader
+ * @chunk: (transfer none): the data received
+ * @user_data: user data
+ *
+ * Called for every chunk of data received by
+ * gst_uri_downloader_fetch_uri_with_range_chunked().
+ *
+ * Returns: %TRUE to continue the transfer, %FALSE to finish it early
+ *
+ * Since: 1.10
+ */
+typedef gboolean (*GstUriDownloaderChunkReceivedFunc) (GstUriDownloader * downloader, GstBuffer * chunk, gpointer user_data);
+
 struct _GstUriDownloader
 {
   GstObject parent;
@@ -63,9 +78,11 @@ GType gst_uri_downloader_get_type (void);
 GstUriDownloader * gst_uri_downloader_new (void);
 GstFragment * gst_uri_downloader_fetch_uri (GstUriDownloader * downloader, const gchar * uri, const gchar * referer, gboolean compress, gboolean refresh, gboolean allow_cache, GError ** err);
 GstFragment * gst_uri_downloader_fetch_uri_with_range (GstUriDownloader * downloader, const gchar * uri, const gchar * referer, gboolean compress, gboolean refresh, gboolean allow_cache, gint64 range_start, gint64 range_end, GError ** err);
+GstFragment * gst_uri_downloader_fetch_uri_with_range_chunked (GstUriDownloader * downloader, const gchar * uri, const gchar * referer, gboolean compress, gboolean refresh, gboolean allow_cache, gint64 range_start, gint64 range_end, GstUriDownloaderChunkReceivedFunc chunk_func, gpointer user_data, GError ** err);
 void gst_uri_downloader_reset (GstUriDownloader *downloader);
 void gst_uri_downloader_cancel (GstUriDownloader *downloader);
 void gst_uri_downloader_free (GstUriDownloader *downloader);
+void gst_uri_downloader_set_cache_size (guint64 max_size);
 
 G_END_DECLS
 #endif /* __GSTURIDOWNLOADER_H__ */
@@ -32,6 +32,12 @@
  * Zorder for each input stream can be configured on the
  * #GstVideoAggregatorPad.
  *
+ * With the #GstVideoAggregator:n-threads property, the input frames of all
+ * pads are prepared, which includes mapping and converting them, in parallel
+ * before they are aggregated. Subclasses that implement
+ * #GstVideoAggregatorPadClass.prepare_frame must allow it to be called for
+ * different pads at the same time for that.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -415,6 +421,13 @@ struct _GstVideoAggregatorPrivate
   /* Lock to prevent the state to change while aggregating */
   GMutex lock;
 
+  /* parallel frame preparation, n_threads is protected by the object lock */
+  guint n_threads;
+  GThreadPool *prepare_pool;
+  GMutex prepare_lock;
+  GCond prepare_cond;
+  guint prepare_pending;
+
   /* Current downstream segment */
   GstClockTime ts_offset;
   guint64 nframes;
@@ -430,6 +443,14 @@ struct _GstVideoAggregatorPrivate
   gboolean live;
 };
 
+#define DEFAULT_N_THREADS 1
+
+enum
+{
+  PROP_0,
+  PROP_N_THREADS
+};
+
 /* Can't use the G_DEFINE_TYPE macros because we need the
  * videoaggregator class in the _init to be able to set
  * the sink pad non-alpha caps. Using the G_DEFINE_TYPE there
@@ -1330,6 +1351,91 @@ clean_pad (GstVideoAggregator * vagg, GstVideoAggregatorPad * pad)
   return TRUE;
 }
 
+static void
+prepare_frames_func (GstVideoAggregatorPad * pad, GstVideoAggregator * vagg)
+{
+  prepare_frames (vagg, pad);
+  gst_object_unref (pad);
+
+  g_mutex_lock (&vagg->priv->prepare_lock);
+  if (--vagg->priv->prepare_pending == 0)
+    g_cond_signal (&vagg->priv->prepare_cond);
+  g_mutex_unlock (&vagg->priv->prepare_lock);
+}
+
+/* prepares the frames of all pads, in parallel when configured. Returns
+ * FALSE when the frames need to be prepared serially */
+static gboolean
+prepare_frames_parallel (GstVideoAggregator * vagg)
+{
+  GstVideoAggregatorPrivate *priv = vagg->priv;
+  GList *l, *pads = NULL;
+  guint n_threads, n_pads = 0;
+  GError *err = NULL;
+
+  GST_OBJECT_LOCK (vagg);
+  n_threads = priv->n_threads;
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  if (n_threads > 1) {
+    for (l = GST_ELEMENT_CAST (vagg)->sinkpads; l; l = l->next) {
+      GstVideoAggregatorPad *pad = l->data;
+
+      if (pad->buffer == NULL)
+        continue;
+      pads = g_list_prepend (pads, gst_object_ref (pad));
+      n_pads++;
+    }
+  }
+  GST_OBJECT_UNLOCK (vagg);
+
+  if (n_pads < 2)
+    goto serial;
+
+  /* this thread prepares one of the frames itself */
+  if (priv->prepare_pool == NULL) {
+    priv->prepare_pool = g_thread_pool_new ((GFunc) prepare_frames_func, vagg,
+        n_threads - 1, FALSE, &err);
+    if (priv->prepare_pool == NULL)
+      goto no_pool;
+  } else if (g_thread_pool_get_max_threads (priv->prepare_pool) !=
+      n_threads - 1) {
+    g_thread_pool_set_max_threads (priv->prepare_pool, n_threads - 1, NULL);
+  }
+
+  GST_LOG_OBJECT (vagg, "preparing %u frames with %u threads", n_pads,
+      n_threads);
+
+  priv->prepare_pending = n_pads - 1;
+  for (l = pads->next; l; l = l->next)
+    g_thread_pool_push (priv->prepare_pool, l->data, NULL);
+  prepare_frames (vagg, pads->data);
+
+  g_mutex_lock (&priv->prepare_lock);
+  while (priv->prepare_pending > 0)
+    g_cond_wait (&priv->prepare_cond, &priv->prepare_lock);
+  g_mutex_unlock (&priv->prepare_lock);
+
+  gst_object_unref (pads->data);
+  g_list_free (pads);
+
+  return TRUE;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_WARNING_OBJECT (vagg, "could not create worker threads: %s",
+        err->message);
+    g_clear_error (&err);
+    goto serial;
+  }
+serial:
+  {
+    g_list_free_full (pads, gst_object_unref);
+    return FALSE;
+  }
+}
+
 static GstFlowReturn
 gst_videoaggregator_do_aggregate (GstVideoAggregator * vagg,
     GstClockTime output_start_time, GstClockTime output_end_time,
@@ -1362,8 +1468,9 @@ gst_videoaggregator_do_aggregate (GstVideoAggregator * vagg,
       (GstAggregatorPadForeachFunc) sync_pad_values, NULL);
 
   /* Convert all the frames the subclass has before aggregating */
-  gst_aggregator_iterate_sinkpads (GST_AGGREGATOR (vagg),
-      (GstAggregatorPadForeachFunc) prepare_frames, NULL);
+  if (!prepare_frames_parallel (vagg))
+    gst_aggregator_iterate_sinkpads (GST_AGGREGATOR (vagg),
+        (GstAggregatorPadForeachFunc) prepare_frames, NULL);
 
   ret = vagg_klass->aggregate_frames (vagg, *outbuf);
 
@@ -1874,6 +1981,11 @@ gst_videoaggregator_stop (GstAggregator * agg)
 
   gst_videoaggregator_reset (vagg);
 
+  if (vagg->priv->prepare_pool) {
+    g_thread_pool_free (vagg->priv->prepare_pool, FALSE, TRUE);
+    vagg->priv->prepare_pool = NULL;
+  }
+
   return TRUE;
 }
 
@@ -2056,6 +2168,8 @@ gst_videoaggregator_finalize (GObject * o)
   GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (o);
 
   g_mutex_clear (&vagg->priv->lock);
+  g_mutex_clear (&vagg->priv->prepare_lock);
+  g_cond_clear (&vagg->priv->prepare_cond);
 
   G_OBJECT_CLASS (gst_videoaggregator_parent_class)->finalize (o);
 }
@@ -2074,7 +2188,14 @@ static void
 gst_videoaggregator_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
 {
+  GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (object);
+
   switch (prop_id) {
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vagg);
+      g_value_set_uint (value, vagg->priv->n_threads);
+      GST_OBJECT_UNLOCK (vagg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2085,7 +2206,14 @@ static void
 gst_videoaggregator_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec)
 {
+  GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (object);
+
   switch (prop_id) {
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vagg);
+      vagg->priv->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (vagg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2113,6 +2241,20 @@ gst_videoaggregator_class_init (GstVideoAggregatorClass * klass)
   gobject_class->get_property = gst_videoaggregator_get_property;
   gobject_class->set_property = gst_videoaggregator_set_property;
 
+  /**
+   * GstVideoAggregator:n-threads:
+   *
+   * Maximum number of threads used to prepare the input frames of the pads
+   * before they are aggregated, 0 uses one thread per core.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to prepare input frames with "
+          "(0 = number of cores)", 0, G_MAXUINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_videoaggregator_request_new_pad);
   gstelement_class->release_pad =
@@ -2220,8 +2362,11 @@ gst_videoaggregator_init (GstVideoAggregator * vagg,
       GstVideoAggregatorPrivate);
 
   vagg->priv->current_caps = NULL;
+  vagg->priv->n_threads = DEFAULT_N_THREADS;
 
   g_mutex_init (&vagg->priv->lock);
+  g_mutex_init (&vagg->priv->prepare_lock);
+  g_cond_init (&vagg->priv->prepare_cond);
 
   /* initialize variables */
   g_mutex_lock (&sink_caps_mutex);
@@ -29,6 +29,9 @@
  * biggest incoming video stream and the framerate of the fastest incoming one.
  *
  * Compositor will do colorspace conversion.
+ *
+ * With the #GstVideoAggregator:n-threads property, the output frame is split
+ * into horizontal stripes that are filled and blended in parallel.
  * 
  * Individual parameters for each input stream can be configured on the
  * #GstCompositorPad:
@@ -976,24 +979,37 @@ _negotiated_caps (GstVideoAggregator * vagg, GstCaps * caps)
   return TRUE;
 }
 
-static GstFlowReturn
-gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
+/* stripes start at multiples of this many lines so that the rounding of
+ * subsampled positions and the checker pattern are the same in every stripe */
+#define STRIPE_ALIGN 16
+
+typedef struct
 {
-  GList *l;
-  GstCompositor *self = GST_COMPOSITOR (vagg);
+  GstVideoFrame *frame;
+  gint xpos, ypos;
+  gdouble alpha;
+} CompositorInput;
+
+typedef struct
+{
+  GstCompositor *self;
+  CompositorInput *inputs;
+  guint n_inputs;
   BlendFunction composite;
-  GstVideoFrame out_frame, *outframe;
+  gboolean draw_background;
+} CompositorBlendJob;
 
-  if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
-    GST_WARNING_OBJECT (vagg, "Could not map output buffer");
-    return GST_FLOW_ERROR;
-  }
+typedef struct
+{
+  CompositorBlendJob *job;
+  /* view on lines [y, y + height) of the output frame */
+  GstVideoFrame frame;
+  gint y;
+} CompositorStripe;
 
-  outframe = &out_frame;
-  /* default to blending */
-  composite = self->blend;
-  /* TODO: If the frames to be composited completely obscure the background,
-   * don't bother drawing the background at all. */
+static void
+gst_compositor_fill_background (GstCompositor * self, GstVideoFrame * outframe)
+{
   switch (self->background) {
     case COMPOSITOR_BACKGROUND_CHECKER:
       self->fill_checker (outframe);
@@ -1023,25 +1039,204 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
           pdata += plane_stride;
         }
       }
-
-      /* use overlay to keep background transparent */
-      composite = self->overlay;
       break;
     }
   }
+}
+
+static void
+gst_compositor_draw_stripe (CompositorStripe * stripe)
+{
+  CompositorBlendJob *job = stripe->job;
+  guint i;
+
+  if (job->draw_background)
+    gst_compositor_fill_background (job->self, &stripe->frame);
+
+  for (i = 0; i < job->n_inputs; i++) {
+    CompositorInput *input = &job->inputs[i];
+
+    job->composite (input->frame, input->xpos, input->ypos - stripe->y,
+        input->alpha, &stripe->frame);
+  }
+}
+
+static void
+gst_compositor_draw_stripe_func (CompositorStripe * stripe,
+    GstCompositor * self)
+{
+  gst_compositor_draw_stripe (stripe);
+
+  g_mutex_lock (&self->blend_lock);
+  if (--self->blend_pending == 0)
+    g_cond_signal (&self->blend_cond);
+  g_mutex_unlock (&self->blend_lock);
+}
+
+/* makes @stripe a view on @height lines of @outframe, starting at line @y */
+static void
+gst_compositor_init_stripe (CompositorStripe * stripe,
+    GstVideoFrame * outframe, gint y, gint height)
+{
+  const GstVideoFormatInfo *finfo = outframe->info.finfo;
+  guint plane, comp;
+
+  stripe->frame = *outframe;
+  stripe->y = y;
+  GST_VIDEO_INFO_HEIGHT (&stripe->frame.info) = height;
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (outframe); plane++) {
+    for (comp = 0; comp < GST_VIDEO_FRAME_N_COMPONENTS (outframe); comp++) {
+      if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, comp) == plane)
+        break;
+    }
+    stripe->frame.data[plane] = (guint8 *) outframe->data[plane] +
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comp, y) *
+        GST_VIDEO_FRAME_PLANE_STRIDE (outframe, plane);
+  }
+}
+
+/* draws the stripes, on the thread pool when there is more than one.
+ * The first stripe is always drawn by this thread */
+static void
+gst_compositor_draw_stripes (GstCompositor * self, CompositorStripe * stripes,
+    guint n_stripes, guint n_threads)
+{
+  GError *err = NULL;
+  guint i;
+
+  if (n_stripes > 1) {
+    if (self->blend_pool == NULL) {
+      self->blend_pool =
+          g_thread_pool_new ((GFunc) gst_compositor_draw_stripe_func, self,
+          n_threads - 1, FALSE, &err);
+      if (self->blend_pool == NULL)
+        goto no_pool;
+    } else if (g_thread_pool_get_max_threads (self->blend_pool) !=
+        n_threads - 1) {
+      g_thread_pool_set_max_threads (self->blend_pool, n_threads - 1, NULL);
+    }
+
+    self->blend_pending = n_stripes - 1;
+    for (i = 1; i < n_stripes; i++)
+      g_thread_pool_push (self->blend_pool, &stripes[i], NULL);
+  }
+
+  gst_compositor_draw_stripe (&stripes[0]);
+
+  if (n_stripes > 1) {
+    g_mutex_lock (&self->blend_lock);
+    while (self->blend_pending > 0)
+      g_cond_wait (&self->blend_cond, &self->blend_lock);
+    g_mutex_unlock (&self->blend_lock);
+  }
+  return;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_WARNING_OBJECT (self, "could not create worker threads: %s",
+        err->message);
+    g_clear_error (&err);
+    for (i = 0; i < n_stripes; i++)
+      gst_compositor_draw_stripe (&stripes[i]);
+    return;
+  }
+}
+
+static GstFlowReturn
+gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
+{
+  GList *l;
+  GstCompositor *self = GST_COMPOSITOR (vagg);
+  GstVideoFrame out_frame, *outframe;
+  GstVideoRectangle out_rect;
+  CompositorBlendJob job;
+  CompositorStripe *stripes;
+  guint i, n_threads, n_stripes;
+  gint height, stripe_height;
+
+  if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
+    GST_WARNING_OBJECT (vagg, "Could not map output buffer");
+    return GST_FLOW_ERROR;
+  }
+
+  outframe = &out_frame;
+  height = GST_VIDEO_FRAME_HEIGHT (outframe);
+  out_rect.x = out_rect.y = 0;
+  out_rect.w = GST_VIDEO_FRAME_WIDTH (outframe);
+  out_rect.h = height;
+
+  job.self = self;
+  job.n_inputs = 0;
+  job.draw_background = TRUE;
+  /* use overlay to keep a transparent background transparent, blend
+   * otherwise */
+  if (self->background == COMPOSITOR_BACKGROUND_TRANSPARENT)
+    job.composite = self->overlay;
+  else
+    job.composite = self->blend;
 
   GST_OBJECT_LOCK (vagg);
+  job.inputs = g_new (CompositorInput, GST_ELEMENT (vagg)->numsinkpads);
   for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
     GstVideoAggregatorPad *pad = l->data;
     GstCompositorPad *compo_pad = GST_COMPOSITOR_PAD (pad);
+    CompositorInput *input;
+    GstVideoRectangle frame_rect;
+
+    if (pad->aggregated_frame == NULL)
+      continue;
 
-    if (pad->aggregated_frame != NULL) {
-      composite (pad->aggregated_frame, compo_pad->xpos, compo_pad->ypos,
-          compo_pad->alpha, outframe);
+    input = &job.inputs[job.n_inputs++];
+    input->frame = pad->aggregated_frame;
+    input->xpos = compo_pad->xpos;
+    input->ypos = compo_pad->ypos;
+    input->alpha = compo_pad->alpha;
+
+    /* no need to draw a background that an opaque frame completely covers.
+     * Positions are only ever rounded up, so this still holds after the
+     * blend functions rounded them for subsampled formats */
+    frame_rect.x = input->xpos;
+    frame_rect.y = input->ypos;
+    frame_rect.w = GST_VIDEO_FRAME_WIDTH (input->frame);
+    frame_rect.h = GST_VIDEO_FRAME_HEIGHT (input->frame);
+    if (self->background != COMPOSITOR_BACKGROUND_TRANSPARENT &&
+        input->alpha == 1.0 && !GST_VIDEO_INFO_HAS_ALPHA (&pad->info) &&
+        is_rectangle_contained (out_rect, frame_rect)) {
+      GST_LOG_OBJECT (pad, "covers the whole output, not drawing background");
+      job.draw_background = FALSE;
     }
   }
   GST_OBJECT_UNLOCK (vagg);
 
+  g_object_get (vagg, "n-threads", &n_threads, NULL);
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_threads = MAX (n_threads, 1);
+
+  stripe_height = (height + n_threads - 1) / n_threads;
+  stripe_height = GST_ROUND_UP_N (MAX (stripe_height, 1), STRIPE_ALIGN);
+  n_stripes = (height + stripe_height - 1) / stripe_height;
+  n_stripes = MAX (n_stripes, 1);
+
+  stripes = g_new (CompositorStripe, n_stripes);
+  for (i = 0; i < n_stripes; i++) {
+    gint y = i * stripe_height;
+
+    stripes[i].job = &job;
+    gst_compositor_init_stripe (&stripes[i], outframe, y,
+        MIN (stripe_height, height - y));
+  }
+
+  GST_LOG_OBJECT (vagg, "drawing %u inputs in %u stripes", job.n_inputs,
+      n_stripes);
+
+  gst_compositor_draw_stripes (self, stripes, n_stripes, n_threads);
+
+  g_free (stripes);
+  g_free (job.inputs);
+
   gst_video_frame_unmap (outframe);
 
   return GST_FLOW_OK;
@@ -1089,7 +1284,31 @@ _sink_query (GstAggregator * agg, GstAggregatorPad * bpad, GstQuery * query)
   }
 }
 
+static gboolean
+_stop (GstAggregator * agg)
+{
+  GstCompositor *self = GST_COMPOSITOR (agg);
+
+  if (self->blend_pool) {
+    g_thread_pool_free (self->blend_pool, FALSE, TRUE);
+    self->blend_pool = NULL;
+  }
+
+  return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
+}
+
 /* GObject boilerplate */
+static void
+gst_compositor_finalize (GObject * object)
+{
+  GstCompositor *self = GST_COMPOSITOR (object);
+
+  g_mutex_clear (&self->blend_lock);
+  g_cond_clear (&self->blend_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_compositor_class_init (GstCompositorClass * klass)
 {
@@ -1101,9 +1320,11 @@ gst_compositor_class_init (GstCompositorClass * klass)
 
   gobject_class->get_property = gst_compositor_get_property;
   gobject_class->set_property = gst_compositor_set_property;
+  gobject_class->finalize = gst_compositor_finalize;
 
   agg_class->sinkpads_type = GST_TYPE_COMPOSITOR_PAD;
   agg_class->sink_query = _sink_query;
+  agg_class->stop = _stop;
   videoaggregator_class->fixate_caps = _fixate_caps;
   videoaggregator_class->negotiated_caps = _negotiated_caps;
   videoaggregator_class->aggregate_frames = gst_compositor_aggregate_frames;
@@ -1127,6 +1348,8 @@ gst_compositor_init (GstCompositor * self)
 {
   self->background = DEFAULT_BACKGROUND;
   /* initialize variables */
+  g_mutex_init (&self->blend_lock);
+  g_cond_init (&self->blend_cond);
 }
 
 /* Element registration */
@@ -57,6 +57,14 @@
  * the event as the payload.  In addition, GDP streams can now start with
  * events as well, as required by the new data stream model in GStreamer 0.10.
  *
+ * Version 2.0 keeps the first ten bytes of the 1.0 header, but uses the
+ * padding byte as a mask of the optional fields that follow: only the
+ * timestamps, offsets, flags and CRCs that are actually set are written,
+ * which makes the header of a typical buffer less than half the size of a
+ * 1.0 header.  Buffer packets can also carry serialized metas in front of
+ * the buffer data; metas that have no serializer are dropped as before.
+ * Use gst_dp_header_length() to find out the header size of a packet.
+ *
  * Converting buffers, caps and events to GDP buffers is done using the
  * appropriate functions.
  *
@@ -81,13 +89,6 @@ GST_DEBUG_CATEGORY_STATIC (data_protocol_debug);
 #define GST_CAT_DEFAULT data_protocol_debug
 #endif
 
-/* The version of the GDP protocol being used */
-typedef enum
-{
-  GST_DP_VERSION_0_2 = 1,
-  GST_DP_VERSION_1_0,
-} GstDPVersion;
-
 /* helper macros */
 
 /* write first 6 bytes of header */
@@ -97,6 +98,7 @@ G_STMT_START {							\
   switch (version) {						\
     case GST_DP_VERSION_0_2: maj = 0; min = 2; break;		\
     case GST_DP_VERSION_1_0: maj = 1; min = 0; break;		\
+    case GST_DP_VERSION_2_0: maj = 2; min = 0; break;		\
   }								\
   h[0] = (guint8) maj;						\
   h[1] = (guint8) min;						\
@@ -131,20 +133,291 @@ G_STMT_START {							\
 #define POLY       0x1021
 #define CRC_INIT   0xFFFF
 
+/* we copy everything but the read-only flags */
+#define GST_DP_BUFFER_FLAGS_MASK (GST_BUFFER_FLAG_LIVE | \
+    GST_BUFFER_FLAG_DISCONT | GST_BUFFER_FLAG_HEADER | GST_BUFFER_FLAG_GAP | \
+    GST_BUFFER_FLAG_DELTA_UNIT)
+
+/* a version 2.0 header, parsed */
+typedef struct
+{
+  GstClockTime pts, dts, duration;
+  guint64 offset, offset_end;
+  guint16 buffer_flags;
+  guint32 meta_length;
+  guint crc_length;             /* the number of bytes covered by the CRC */
+  guint16 crc_header, crc_payload;
+} GstDPHeaderV2;
+
+/* serializers for the metas that can be carried in version 2.0 buffer
+ * packets. The meta section is a sequence of entries with a 16 bit API name
+ * length, the API name, a 32 bit data length and the serialized data, so
+ * that a receiver can skip metas it does not know. */
+typedef struct
+{
+  GType (*get_api) (void);
+  gchar *(*serialize) (const GstMeta * meta);
+  gboolean (*deserialize) (GstBuffer * buffer, const gchar * data);
+} GstDPMetaSerializer;
+
+static gchar *
+gst_dp_protection_meta_serialize (const GstMeta * meta)
+{
+  return gst_structure_to_string (((const GstProtectionMeta *) meta)->info);
+}
+
+static gboolean
+gst_dp_protection_meta_deserialize (GstBuffer * buffer, const gchar * data)
+{
+  GstStructure *info;
+
+  info = gst_structure_from_string (data, NULL);
+  if (info == NULL)
+    return FALSE;
+
+  gst_buffer_add_protection_meta (buffer, info);
+  return TRUE;
+}
+
+static const GstDPMetaSerializer gst_dp_meta_serializers[] = {
+  {gst_protection_meta_api_get_type, gst_dp_protection_meta_serialize,
+      gst_dp_protection_meta_deserialize},
+};
+
 static guint16 gst_dp_crc (const guint8 * buffer, guint length);
-static guint16 gst_dp_crc_from_memory_maps (const GstMapInfo * maps,
-    guint n_maps);
+static guint16 gst_dp_crc_update (guint16 crc_register,
+    const guint8 * buffer, gsize length);
+static guint16 gst_dp_crc_from_buffer (const guint8 * prefix,
+    gsize prefix_length, GstBuffer * buffer);
 
 /* payloading functions */
 
-GstBuffer *
-gst_dp_payload_buffer (GstBuffer * buffer, GstDPHeaderFlag flags)
+static gboolean
+gst_dp_serialize_meta (GstBuffer * buffer, GstMeta ** meta, gpointer user_data)
+{
+  GByteArray **metas = user_data;
+  GType api = (*meta)->info->api;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (gst_dp_meta_serializers); i++) {
+    const GstDPMetaSerializer *serializer = &gst_dp_meta_serializers[i];
+    const gchar *name;
+    gchar *data;
+    guint8 length[4];
+    gsize name_length, data_length;
+
+    if (serializer->get_api () != api)
+      continue;
+
+    data = serializer->serialize (*meta);
+    if (data == NULL)
+      break;
+
+    name = g_type_name (api);
+    name_length = strlen (name);
+    data_length = strlen (data);
+
+    if (*metas == NULL)
+      *metas = g_byte_array_new ();
+
+    GST_WRITE_UINT16_BE (length, name_length);
+    g_byte_array_append (*metas, length, 2);
+    g_byte_array_append (*metas, (const guint8 *) name, name_length);
+    GST_WRITE_UINT32_BE (length, data_length);
+    g_byte_array_append (*metas, length, 4);
+    g_byte_array_append (*metas, (const guint8 *) data, data_length);
+
+    GST_LOG ("serialized %s: %s", name, data);
+    g_free (data);
+    break;
+  }
+
+  return TRUE;
+}
+
+/* creates a version 2.0 header, only writing the fields that are not NONE */
+static GstMemory *
+gst_dp_header_v2_new (GstDPHeaderFlag flags, guint16 type,
+    guint32 payload_length, const guint64 values[GST_DP_V2_N_TIME_FIELDS],
+    guint16 buffer_flags, guint32 meta_length, guint16 payload_crc)
+{
+  guint8 h[GST_DP_HEADER_LENGTH];
+  guint8 *p, fields = 0;
+  gpointer data;
+  gsize length;
+  guint i;
+
+  GST_DP_INIT_HEADER (h, GST_DP_VERSION_2_0, flags, type);
+  GST_WRITE_UINT32_BE (h + 6, payload_length);
+
+  p = h + GST_DP_HEADER_MIN_LENGTH;
+  for (i = 0; i < GST_DP_V2_N_TIME_FIELDS; i++) {
+    if (values[i] == G_MAXUINT64)
+      continue;
+    fields |= 1 << i;
+    GST_WRITE_UINT64_BE (p, values[i]);
+    p += 8;
+  }
+  if (buffer_flags) {
+    fields |= GST_DP_V2_FIELD_BUFFER_FLAGS;
+    GST_WRITE_UINT16_BE (p, buffer_flags);
+    p += 2;
+  }
+  if (meta_length) {
+    fields |= GST_DP_V2_FIELD_METAS;
+    GST_WRITE_UINT32_BE (p, meta_length);
+    p += 4;
+  }
+  h[3] = fields;
+
+  if ((flags & GST_DP_HEADER_FLAG_CRC_HEADER)) {
+    guint16 header_crc = gst_dp_crc (h, p - h);
+
+    GST_WRITE_UINT16_BE (p, header_crc);
+    p += 2;
+  }
+  if ((flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD)) {
+    GST_WRITE_UINT16_BE (p, payload_crc);
+    p += 2;
+  }
+
+  length = p - h;
+  GST_MEMDUMP ("version 2.0 payload header", h, length);
+
+  data = g_memdup (h, length);
+  return gst_memory_new_wrapped (0, data, length, 0, length, data, g_free);
+}
+
+static void
+gst_dp_header_v2_parse (const guint8 * header, GstDPHeaderV2 * h)
+{
+  guint64 values[GST_DP_V2_N_TIME_FIELDS];
+  guint8 fields = GST_DP_HEADER_V2_FIELDS (header);
+  const guint8 *p = header + GST_DP_HEADER_MIN_LENGTH;
+  guint i;
+
+  for (i = 0; i < GST_DP_V2_N_TIME_FIELDS; i++) {
+    values[i] = G_MAXUINT64;
+    if ((fields & (1 << i))) {
+      values[i] = GST_READ_UINT64_BE (p);
+      p += 8;
+    }
+  }
+  h->pts = values[0];
+  h->dts = values[1];
+  h->duration = values[2];
+  h->offset = values[3];
+  h->offset_end = values[4];
+
+  h->buffer_flags = 0;
+  if ((fields & GST_DP_V2_FIELD_BUFFER_FLAGS)) {
+    h->buffer_flags = GST_READ_UINT16_BE (p);
+    p += 2;
+  }
+  h->meta_length = 0;
+  if ((fields & GST_DP_V2_FIELD_METAS)) {
+    h->meta_length = GST_READ_UINT32_BE (p);
+    p += 4;
+  }
+
+  h->crc_length = p - header;
+  h->crc_header = h->crc_payload = 0;
+  if ((GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_HEADER)) {
+    h->crc_header = GST_READ_UINT16_BE (p);
+    p += 2;
+  }
+  if ((GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+    h->crc_payload = GST_READ_UINT16_BE (p);
+}
+
+#define GST_DP_HEADER_IS_V2(h) (GST_DP_HEADER_MAJOR_VERSION (h) == 2)
+
+#define GST_DP_HEADER_LENGTH_IS_VALID(length, h) \
+    ((length) >= GST_DP_HEADER_MIN_LENGTH && \
+     (length) >= gst_dp_header_length (h))
+
+/* wraps @string, which is freed, with a version 2.0 header */
+static GstBuffer *
+gst_dp_payload_string_2_0 (GstDPHeaderFlag flags, guint16 type,
+    GstClockTime timestamp, guchar * string, guint32 length)
+{
+  GstBuffer *buf;
+  guint64 values[GST_DP_V2_N_TIME_FIELDS] = { timestamp, G_MAXUINT64,
+    G_MAXUINT64, G_MAXUINT64, G_MAXUINT64
+  };
+  guint16 crc = 0;
+
+  if (length && (flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+    crc = gst_dp_crc (string, length);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf,
+      gst_dp_header_v2_new (flags, type, length, values, 0, 0, crc));
+
+  if (length > 0) {
+    gst_buffer_append_memory (buf,
+        gst_memory_new_wrapped (0, string, length, 0, length, string, g_free));
+  } else {
+    g_free (string);
+  }
+
+  return buf;
+}
+
+static GstBuffer *
+gst_dp_payload_buffer_2_0 (GstBuffer * buffer, GstDPHeaderFlag flags,
+    gboolean serialize_metas)
+{
+  GstBuffer *ret_buf;
+  GByteArray *metas = NULL;
+  guint64 values[GST_DP_V2_N_TIME_FIELDS];
+  guint32 meta_length = 0;
+  guint16 crc = 0;
+
+  if (serialize_metas)
+    gst_buffer_foreach_meta (buffer, gst_dp_serialize_meta, &metas);
+  if (metas)
+    meta_length = metas->len;
+
+  if ((flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+    crc = gst_dp_crc_from_buffer (metas ? metas->data : NULL, meta_length,
+        buffer);
+
+  values[0] = GST_BUFFER_PTS (buffer);
+  values[1] = GST_BUFFER_DTS (buffer);
+  values[2] = GST_BUFFER_DURATION (buffer);
+  values[3] = GST_BUFFER_OFFSET (buffer);
+  values[4] = GST_BUFFER_OFFSET_END (buffer);
+
+  ret_buf = gst_buffer_new ();
+
+  /* header */
+  gst_buffer_append_memory (ret_buf,
+      gst_dp_header_v2_new (flags, GST_DP_PAYLOAD_BUFFER,
+          meta_length + gst_buffer_get_size (buffer), values,
+          GST_BUFFER_FLAGS (buffer) & GST_DP_BUFFER_FLAGS_MASK, meta_length,
+          crc));
+
+  /* metas */
+  if (metas) {
+    guint8 *data = g_byte_array_free (metas, FALSE);
+
+    gst_buffer_append_memory (ret_buf,
+        gst_memory_new_wrapped (0, data, meta_length, 0, meta_length, data,
+            g_free));
+  }
+
+  /* buffer data */
+  return gst_buffer_append (ret_buf, gst_buffer_ref (buffer));
+}
+
+static GstBuffer *
+gst_dp_payload_buffer_1_0 (GstBuffer * buffer, GstDPHeaderFlag flags)
 {
   GstBuffer *ret_buf;
   GstMapInfo map;
   GstMemory *mem;
   guint8 *h;
-  guint16 flags_mask;
   guint16 header_crc = 0, crc = 0;
   gsize buffer_size;
 
@@ -155,32 +428,9 @@ gst_dp_payload_buffer (GstBuffer * buffer, GstDPHeaderFlag flags)
   /* version, flags, type */
   GST_DP_INIT_HEADER (h, GST_DP_VERSION_1_0, flags, GST_DP_PAYLOAD_BUFFER);
 
-  if ((flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD)) {
-    GstMapInfo *maps;
-    guint n_maps, i;
-
-    buffer_size = 0;
-
-    n_maps = gst_buffer_n_memory (buffer);
-    if (n_maps > 0) {
-      maps = g_newa (GstMapInfo, n_maps);
-
-      for (i = 0; i < n_maps; ++i) {
-        GstMemory *mem;
-
-        mem = gst_buffer_peek_memory (buffer, i);
-        gst_memory_map (mem, &maps[i], GST_MAP_READ);
-        buffer_size += maps[i].size;
-      }
-
-      crc = gst_dp_crc_from_memory_maps (maps, n_maps);
-
-      for (i = 0; i < n_maps; ++i)
-        gst_memory_unmap (maps[i].memory, &maps[i]);
-    }
-  } else {
-    buffer_size = gst_buffer_get_size (buffer);
-  }
+  buffer_size = gst_buffer_get_size (buffer);
+  if ((flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+    crc = gst_dp_crc_from_buffer (NULL, 0, buffer);
 
   /* buffer properties */
   GST_WRITE_UINT32_BE (h + 6, buffer_size);
@@ -190,11 +440,8 @@ gst_dp_payload_buffer (GstBuffer * buffer, GstDPHeaderFlag flags)
   GST_WRITE_UINT64_BE (h + 34, GST_BUFFER_OFFSET_END (buffer));
 
   /* data flags; eats two bytes from the ABI area */
-  /* we copy everything but the read-only flags */
-  flags_mask = GST_BUFFER_FLAG_LIVE | GST_BUFFER_FLAG_DISCONT |
-      GST_BUFFER_FLAG_HEADER | GST_BUFFER_FLAG_GAP | GST_BUFFER_FLAG_DELTA_UNIT;
-
-  GST_WRITE_UINT16_BE (h + 42, GST_BUFFER_FLAGS (buffer) & flags_mask);
+  GST_WRITE_UINT16_BE (h + 42,
+      GST_BUFFER_FLAGS (buffer) & GST_DP_BUFFER_FLAGS_MASK);
 
   /* from gstreamer 1.x, buffers also have the DTS */
   GST_WRITE_UINT64_BE (h + 44, GST_BUFFER_DTS (buffer));
@@ -223,8 +470,52 @@ gst_dp_payload_buffer (GstBuffer * buffer, GstDPHeaderFlag flags)
   return gst_buffer_append (ret_buf, gst_buffer_ref (buffer));
 }
 
+/**
+ * gst_dp_payload_buffer_full:
+ * @buffer: the #GstBuffer to payload
+ * @flags: the #GstDPHeaderFlag to use
+ * @version: the protocol version to write, %GST_DP_VERSION_1_0 or
+ *     %GST_DP_VERSION_2_0
+ * @serialize_metas: whether to serialize the metas of @buffer that have a
+ *     serializer, only used with %GST_DP_VERSION_2_0
+ *
+ * Creates a GDP packet for @buffer, consisting of the header memory, the
+ * serialized metas if any, followed by the memories of @buffer.
+ *
+ * Returns: a new #GstBuffer containing the GDP packet.
+ */
 GstBuffer *
-gst_dp_payload_caps (const GstCaps * caps, GstDPHeaderFlag flags)
+gst_dp_payload_buffer_full (GstBuffer * buffer, GstDPHeaderFlag flags,
+    GstDPVersion version, gboolean serialize_metas)
+{
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), NULL);
+
+  if (version == GST_DP_VERSION_2_0)
+    return gst_dp_payload_buffer_2_0 (buffer, flags, serialize_metas);
+
+  return gst_dp_payload_buffer_1_0 (buffer, flags);
+}
+
+GstBuffer *
+gst_dp_payload_buffer (GstBuffer * buffer, GstDPHeaderFlag flags)
+{
+  return gst_dp_payload_buffer_full (buffer, flags, GST_DP_VERSION_1_0, FALSE);
+}
+
+/**
+ * gst_dp_payload_caps_full:
+ * @caps: the #GstCaps to payload
+ * @flags: the #GstDPHeaderFlag to use
+ * @version: the protocol version to write, %GST_DP_VERSION_1_0 or
+ *     %GST_DP_VERSION_2_0
+ *
+ * Creates a GDP packet for @caps.
+ *
+ * Returns: a new #GstBuffer containing the GDP packet.
+ */
+GstBuffer *
+gst_dp_payload_caps_full (const GstCaps * caps, GstDPHeaderFlag flags,
+    GstDPVersion version)
 {
   GstBuffer *buf;
   GstMapInfo map;
@@ -235,15 +526,19 @@ gst_dp_payload_caps (const GstCaps * caps, GstDPHeaderFlag flags)
 
   g_assert (GST_IS_CAPS (caps));
 
+  string = (guchar *) gst_caps_to_string (caps);
+  payload_length = strlen ((gchar *) string) + 1;       /* include trailing 0 */
+
+  if (version == GST_DP_VERSION_2_0)
+    return gst_dp_payload_string_2_0 (flags, GST_DP_PAYLOAD_CAPS,
+        GST_CLOCK_TIME_NONE, string, payload_length);
+
   buf = gst_buffer_new ();
 
   mem = gst_allocator_alloc (NULL, GST_DP_HEADER_LENGTH, NULL);
   gst_memory_map (mem, &map, GST_MAP_READWRITE);
   h = memset (map.data, 0, map.size);
 
-  string = (guchar *) gst_caps_to_string (caps);
-  payload_length = strlen ((gchar *) string) + 1;       /* include trailing 0 */
-
   /* version, flags, type */
   GST_DP_INIT_HEADER (h, GST_DP_VERSION_1_0, flags, GST_DP_PAYLOAD_CAPS);
 
@@ -271,7 +566,25 @@ gst_dp_payload_caps (const GstCaps * caps, GstDPHeaderFlag flags)
 }
 
 GstBuffer *
-gst_dp_payload_event (const GstEvent * event, GstDPHeaderFlag flags)
+gst_dp_payload_caps (const GstCaps * caps, GstDPHeaderFlag flags)
+{
+  return gst_dp_payload_caps_full (caps, flags, GST_DP_VERSION_1_0);
+}
+
+/**
+ * gst_dp_payload_event_full:
+ * @event: the #GstEvent to payload
+ * @flags: the #GstDPHeaderFlag to use
+ * @version: the protocol version to write, %GST_DP_VERSION_1_0 or
+ *     %GST_DP_VERSION_2_0
+ *
+ * Creates a GDP packet for @event.
+ *
+ * Returns: a new #GstBuffer containing the GDP packet.
+ */
+GstBuffer *
+gst_dp_payload_event_full (const GstEvent * event, GstDPHeaderFlag flags,
+    GstDPVersion version)
 {
   GstBuffer *buf;
   GstMapInfo map;
@@ -283,12 +596,6 @@ gst_dp_payload_event (const GstEvent * event, GstDPHeaderFlag flags)
 
   g_assert (GST_IS_EVENT (event));
 
-  buf = gst_buffer_new ();
-
-  mem = gst_allocator_alloc (NULL, GST_DP_HEADER_LENGTH, NULL);
-  gst_memory_map (mem, &map, GST_MAP_READWRITE);
-  h = memset (map.data, 0, map.size);
-
   structure = gst_event_get_structure ((GstEvent *) event);
   if (structure) {
     string = (guchar *) gst_structure_to_string (structure);
@@ -299,6 +606,17 @@ gst_dp_payload_event (const GstEvent * event, GstDPHeaderFlag flags)
     pl_length = 0;
   }
 
+  if (version == GST_DP_VERSION_2_0)
+    return gst_dp_payload_string_2_0 (flags,
+        GST_DP_PAYLOAD_EVENT_NONE + GST_EVENT_TYPE (event),
+        GST_EVENT_TIMESTAMP (event), string, pl_length);
+
+  buf = gst_buffer_new ();
+
+  mem = gst_allocator_alloc (NULL, GST_DP_HEADER_LENGTH, NULL);
+  gst_memory_map (mem, &map, GST_MAP_READWRITE);
+  h = memset (map.data, 0, map.size);
+
   /* version, flags, type */
   GST_DP_INIT_HEADER (h, GST_DP_VERSION_1_0, flags,
       GST_DP_PAYLOAD_EVENT_NONE + GST_EVENT_TYPE (event));
@@ -326,6 +644,12 @@ gst_dp_payload_event (const GstEvent * event, GstDPHeaderFlag flags)
   return buf;
 }
 
+GstBuffer *
+gst_dp_payload_event (const GstEvent * event, GstDPHeaderFlag flags)
+{
+  return gst_dp_payload_event_full (event, flags, GST_DP_VERSION_1_0);
+}
+
 /*** PUBLIC FUNCTIONS ***/
 
 static const guint16 gst_dp_crc_table[256] = {
@@ -377,45 +701,46 @@ static const guint16 gst_dp_crc_table[256] = {
 static guint16
 gst_dp_crc (const guint8 * buffer, guint length)
 {
-  guint16 crc_register = CRC_INIT;
-
   if (length == 0)
     return 0;
 
   g_assert (buffer != NULL);
 
+  return (0xffff ^ gst_dp_crc_update (CRC_INIT, buffer, length));
+}
+
+static guint16
+gst_dp_crc_update (guint16 crc_register, const guint8 * buffer, gsize length)
+{
   /* calc CRC */
-  for (; length--;) {
+  while (length-- > 0) {
     crc_register = (guint16) ((crc_register << 8) ^
         gst_dp_crc_table[((crc_register >> 8) & 0x00ff) ^ *buffer++]);
   }
-  return (0xffff ^ crc_register);
+  return crc_register;
 }
 
+/* CRC over @prefix_length bytes of @prefix followed by the data of @buffer */
 static guint16
-gst_dp_crc_from_memory_maps (const GstMapInfo * maps, guint n_maps)
+gst_dp_crc_from_buffer (const guint8 * prefix, gsize prefix_length,
+    GstBuffer * buffer)
 {
-  guint16 crc_register = CRC_INIT;
-  gsize total_length = 0;
-
-  if (n_maps == 0)
-    return 0;
-
-  g_assert (maps != NULL);
-
-  /* calc CRC */
-  while (n_maps > 0) {
-    guint8 *buffer = maps->data;
-    gsize length = maps->size;
-
-    total_length += length;
-
-    while (length-- > 0) {
-      crc_register = (guint16) ((crc_register << 8) ^
-          gst_dp_crc_table[((crc_register >> 8) & 0x00ff) ^ *buffer++]);
-    }
-    --n_maps;
-    ++maps;
+  guint16 crc_register;
+  gsize total_length = prefix_length;
+  guint n_mems, i;
+
+  crc_register = gst_dp_crc_update (CRC_INIT, prefix, prefix_length);
+
+  n_mems = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n_mems; ++i) {
+    GstMemory *mem;
+    GstMapInfo map;
+
+    mem = gst_buffer_peek_memory (buffer, i);
+    gst_memory_map (mem, &map, GST_MAP_READ);
+    crc_register = gst_dp_crc_update (crc_register, map.data, map.size);
+    total_length += map.size;
+    gst_memory_unmap (mem, &map);
   }
 
   if (G_UNLIKELY (total_length == 0))
@@ -439,6 +764,73 @@ gst_dp_init (void)
       "GStreamer Data Protocol");
 }
 
+/**
+ * gst_dp_header_length:
+ * @header: the first %GST_DP_HEADER_MIN_LENGTH bytes of a packet
+ *
+ * Get the length of the header starting with @header. Version 2.0 headers
+ * are of variable size, all earlier versions use %GST_DP_HEADER_LENGTH.
+ *
+ * Returns: the length of the header in bytes.
+ */
+guint
+gst_dp_header_length (const guint8 * header)
+{
+  guint8 fields, flags;
+  guint length, i;
+
+  g_return_val_if_fail (header != NULL, 0);
+
+  if (!GST_DP_HEADER_IS_V2 (header))
+    return GST_DP_HEADER_LENGTH;
+
+  fields = GST_DP_HEADER_V2_FIELDS (header);
+  flags = GST_DP_HEADER_FLAGS (header);
+
+  length = GST_DP_HEADER_MIN_LENGTH;
+  for (i = 0; i < GST_DP_V2_N_TIME_FIELDS; i++) {
+    if ((fields & (1 << i)))
+      length += 8;
+  }
+  if ((fields & GST_DP_V2_FIELD_BUFFER_FLAGS))
+    length += 2;
+  if ((fields & GST_DP_V2_FIELD_METAS))
+    length += 4;
+  if ((flags & GST_DP_HEADER_FLAG_CRC_HEADER))
+    length += 2;
+  if ((flags & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
+    length += 2;
+
+  return length;
+}
+
+/**
+ * gst_dp_header_meta_length:
+ * @header_length: the length of the packet header
+ * @header: the byte header of the packet array
+ *
+ * Get the length of the serialized metas at the start of the payload
+ * described by @header. Only version 2.0 buffer packets carry metas.
+ *
+ * Returns: the length of the serialized metas, part of the payload length.
+ */
+guint32
+gst_dp_header_meta_length (guint header_length, const guint8 * header)
+{
+  GstDPHeaderV2 h;
+
+  g_return_val_if_fail (header != NULL, 0);
+  g_return_val_if_fail (GST_DP_HEADER_LENGTH_IS_VALID (header_length, header),
+      0);
+
+  if (!GST_DP_HEADER_IS_V2 (header))
+    return 0;
+
+  gst_dp_header_v2_parse (header, &h);
+
+  return MIN (h.meta_length, GST_DP_HEADER_PAYLOAD_LENGTH (header));
+}
+
 /**
  * gst_dp_header_payload_length:
  * @header: the byte header of the packet array
@@ -498,10 +890,33 @@ gst_dp_buffer_from_header (guint header_length, const guint8 * header,
   GstBuffer *buffer;
 
   g_return_val_if_fail (header != NULL, NULL);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
+  g_return_val_if_fail (GST_DP_HEADER_LENGTH_IS_VALID (header_length, header),
+      NULL);
   g_return_val_if_fail (GST_DP_HEADER_PAYLOAD_TYPE (header) ==
       GST_DP_PAYLOAD_BUFFER, NULL);
 
+  if (GST_DP_HEADER_IS_V2 (header)) {
+    GstDPHeaderV2 h;
+
+    gst_dp_header_v2_parse (header, &h);
+    if (h.meta_length > GST_DP_HEADER_PAYLOAD_LENGTH (header))
+      return NULL;
+
+    /* the serialized metas are not part of the buffer data */
+    buffer = gst_buffer_new_allocate (allocator,
+        GST_DP_HEADER_PAYLOAD_LENGTH (header) - h.meta_length,
+        allocation_params);
+
+    GST_BUFFER_PTS (buffer) = h.pts;
+    GST_BUFFER_DTS (buffer) = h.dts;
+    GST_BUFFER_DURATION (buffer) = h.duration;
+    GST_BUFFER_OFFSET (buffer) = h.offset;
+    GST_BUFFER_OFFSET_END (buffer) = h.offset_end;
+    GST_BUFFER_FLAGS (buffer) = h.buffer_flags;
+
+    return buffer;
+  }
+
   buffer =
       gst_buffer_new_allocate (allocator,
       (guint) GST_DP_HEADER_PAYLOAD_LENGTH (header), allocation_params);
@@ -516,6 +931,79 @@ gst_dp_buffer_from_header (guint header_length, const guint8 * header,
   return buffer;
 }
 
+/**
+ * gst_dp_buffer_add_metas:
+ * @buffer: a writable #GstBuffer
+ * @metas: the serialized metas from a version 2.0 buffer packet
+ * @metas_length: the length of @metas, see gst_dp_header_meta_length()
+ *
+ * Adds the metas serialized in @metas to @buffer. Metas that this side
+ * has no serializer for are skipped.
+ *
+ * Returns: %TRUE if @metas could be parsed.
+ */
+gboolean
+gst_dp_buffer_add_metas (GstBuffer * buffer, const guint8 * metas,
+    guint32 metas_length)
+{
+  const guint8 *end;
+
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (metas != NULL || metas_length == 0, FALSE);
+
+  end = metas + metas_length;
+  while (metas < end) {
+    guint16 name_length;
+    guint32 data_length;
+    gchar *name, *data;
+    guint i;
+
+    if (end - metas < 2)
+      goto short_metas;
+    name_length = GST_READ_UINT16_BE (metas);
+    metas += 2;
+
+    if ((gsize) (end - metas) < (gsize) name_length + 4)
+      goto short_metas;
+    name = g_strndup ((const gchar *) metas, name_length);
+    metas += name_length;
+    data_length = GST_READ_UINT32_BE (metas);
+    metas += 4;
+
+    if ((gsize) (end - metas) < data_length) {
+      g_free (name);
+      goto short_metas;
+    }
+    data = g_strndup ((const gchar *) metas, data_length);
+    metas += data_length;
+
+    for (i = 0; i < G_N_ELEMENTS (gst_dp_meta_serializers); i++) {
+      const GstDPMetaSerializer *serializer = &gst_dp_meta_serializers[i];
+
+      if (strcmp (g_type_name (serializer->get_api ()), name) != 0)
+        continue;
+
+      if (!serializer->deserialize (buffer, data))
+        GST_WARNING ("could not deserialize %s: %s", name, data);
+      break;
+    }
+    if (i == G_N_ELEMENTS (gst_dp_meta_serializers))
+      GST_DEBUG ("skipping unknown meta %s", name);
+
+    g_free (name);
+    g_free (data);
+  }
+
+  return TRUE;
+
+  /* ERRORS */
+short_metas:
+  {
+    GST_WARNING ("serialized metas are truncated");
+    return FALSE;
+  }
+}
+
 /**
  * gst_dp_caps_from_packet:
  * @header_length: the length of the packet header
@@ -539,7 +1027,8 @@ gst_dp_caps_from_packet (guint header_length, const guint8 * header,
   gchar *string;
 
   g_return_val_if_fail (header, NULL);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
+  g_return_val_if_fail (GST_DP_HEADER_LENGTH_IS_VALID (header_length, header),
+      NULL);
   g_return_val_if_fail (GST_DP_HEADER_PAYLOAD_TYPE (header) ==
       GST_DP_PAYLOAD_CAPS, NULL);
   g_return_val_if_fail (payload, NULL);
@@ -659,7 +1148,8 @@ gst_dp_event_from_packet (guint header_length, const guint8 * header,
   guint8 major, minor;
 
   g_return_val_if_fail (header, NULL);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, NULL);
+  g_return_val_if_fail (GST_DP_HEADER_LENGTH_IS_VALID (header_length, header),
+      NULL);
 
   major = GST_DP_HEADER_MAJOR_VERSION (header);
   minor = GST_DP_HEADER_MINOR_VERSION (header);
@@ -668,7 +1158,18 @@ gst_dp_event_from_packet (guint header_length, const guint8 * header,
     return gst_dp_event_from_packet_0_2 (header_length, header, payload);
   else if (major == 1 && minor == 0)
     return gst_dp_event_from_packet_1_0 (header_length, header, payload);
-  else {
+  else if (major == 2 && minor == 0) {
+    GstDPHeaderV2 h;
+    GstEvent *event;
+
+    /* same payload as 1.0, but the header can carry the event timestamp */
+    event = gst_dp_event_from_packet_1_0 (header_length, header, payload);
+    if (event) {
+      gst_dp_header_v2_parse (header, &h);
+      GST_EVENT_TIMESTAMP (event) = h.pts;
+    }
+    return event;
+  } else {
     GST_ERROR ("Unknown GDP version %d.%d", major, minor);
     return NULL;
   }
@@ -689,11 +1190,25 @@ gst_dp_validate_header (guint header_length, const guint8 * header)
   guint16 crc_read, crc_calculated;
 
   g_return_val_if_fail (header != NULL, FALSE);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, FALSE);
+  g_return_val_if_fail (GST_DP_HEADER_LENGTH_IS_VALID (header_length, header),
+      FALSE);
 
   if (!(GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_HEADER))
     return TRUE;
 
+  if (GST_DP_HEADER_IS_V2 (header)) {
+    GstDPHeaderV2 h;
+
+    gst_dp_header_v2_parse (header, &h);
+    crc_read = h.crc_header;
+    crc_calculated = gst_dp_crc (header, h.crc_length);
+    if (crc_read != crc_calculated)
+      goto crc_error;
+
+    GST_LOG ("header crc validation: %02x", crc_read);
+    return TRUE;
+  }
+
   crc_read = GST_DP_HEADER_CRC_HEADER (header);
 
   /* don't include the last two crc fields for the crc check */
@@ -731,12 +1246,20 @@ gst_dp_validate_payload (guint header_length, const guint8 * header,
   guint16 crc_read, crc_calculated;
 
   g_return_val_if_fail (header != NULL, FALSE);
-  g_return_val_if_fail (header_length >= GST_DP_HEADER_LENGTH, FALSE);
+  g_return_val_if_fail (GST_DP_HEADER_LENGTH_IS_VALID (header_length, header),
+      FALSE);
 
   if (!(GST_DP_HEADER_FLAGS (header) & GST_DP_HEADER_FLAG_CRC_PAYLOAD))
     return TRUE;
 
-  crc_read = GST_DP_HEADER_CRC_PAYLOAD (header);
+  if (GST_DP_HEADER_IS_V2 (header)) {
+    GstDPHeaderV2 h;
+
+    gst_dp_header_v2_parse (header, &h);
+    crc_read = h.crc_payload;
+  } else {
+    crc_read = GST_DP_HEADER_CRC_PAYLOAD (header);
+  }
   crc_calculated = gst_dp_crc (payload, GST_DP_HEADER_PAYLOAD_LENGTH (header));
   if (crc_read != crc_calculated)
     goto crc_error;
@@ -36,6 +36,29 @@ G_BEGIN_DECLS
  */
 #define GST_DP_HEADER_LENGTH 62
 
+/**
+ * GST_DP_HEADER_MIN_LENGTH:
+ *
+ * The number of bytes needed to find out the length of a header with
+ * gst_dp_header_length().
+ */
+#define GST_DP_HEADER_MIN_LENGTH 10
+
+/**
+ * GstDPVersion:
+ * @GST_DP_VERSION_0_2: protocol version 0.2
+ * @GST_DP_VERSION_1_0: protocol version 1.0, fixed size headers
+ * @GST_DP_VERSION_2_0: protocol version 2.0, compact variable size headers
+ *     that only carry the fields that are set, and optional serialized metas
+ *
+ * The version of the GDP protocol being used.
+ */
+typedef enum {
+  GST_DP_VERSION_0_2 = 1,
+  GST_DP_VERSION_1_0,
+  GST_DP_VERSION_2_0,
+} GstDPVersion;
+
 /**
  * GstDPHeaderFlag:
  * @GST_DP_HEADER_FLAG_NONE: No flag present.
@@ -72,9 +95,12 @@ typedef enum {
 void            gst_dp_init                     (void);
 
 /* payload information from header */
+guint           gst_dp_header_length            (const guint8 * header);
 guint32         gst_dp_header_payload_length    (const guint8 * header);
 GstDPPayloadType
                 gst_dp_header_payload_type      (const guint8 * header);
+guint32         gst_dp_header_meta_length       (guint header_length,
+                                                const guint8 * header);
 
 /* converting to GstBuffer/GstEvent/GstCaps */
 GstBuffer *     gst_dp_buffer_from_header       (guint header_length,
@@ -87,6 +113,9 @@ GstCaps *       gst_dp_caps_from_packet         (guint header_length,
 GstEvent *      gst_dp_event_from_packet        (guint header_length,
                                                 const guint8 * header,
                                                 const guint8 * payload);
+gboolean        gst_dp_buffer_add_metas         (GstBuffer * buffer,
+                                                const guint8 * metas,
+                                                guint32 metas_length);
 
 /* payloading GstBuffer/GstEvent/GstCaps */
 GstBuffer *     gst_dp_payload_buffer           (GstBuffer      * buffer,
@@ -98,6 +127,19 @@ GstBuffer *     gst_dp_payload_caps             (const GstCaps  * caps,
 GstBuffer *     gst_dp_payload_event            (const GstEvent * event,
                                                  GstDPHeaderFlag  flags);
 
+GstBuffer *     gst_dp_payload_buffer_full      (GstBuffer      * buffer,
+                                                 GstDPHeaderFlag  flags,
+                                                 GstDPVersion     version,
+                                                 gboolean         serialize_metas);
+
+GstBuffer *     gst_dp_payload_caps_full        (const GstCaps  * caps,
+                                                 GstDPHeaderFlag  flags,
+                                                 GstDPVersion     version);
+
+GstBuffer *     gst_dp_payload_event_full       (const GstEvent * event,
+                                                 GstDPHeaderFlag  flags,
+                                                 GstDPVersion     version);
+
 /* validation */
 gboolean        gst_dp_validate_header          (guint header_length,
                                                 const guint8 * header);
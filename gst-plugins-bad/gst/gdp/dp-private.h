@@ -47,6 +47,21 @@ G_BEGIN_DECLS
 #define GST_DP_HEADER_CRC_HEADER(x)     GST_READ_UINT16_BE (x + 58)
 #define GST_DP_HEADER_CRC_PAYLOAD(x)    GST_READ_UINT16_BE (x + 60)
 
+/* version 2.0 headers share the first 10 bytes with version 1.0, with the
+ * padding byte turned into a mask of the optional fields that follow, in
+ * this order. Fields that are not present have their NONE value. */
+#define GST_DP_HEADER_V2_FIELDS(x)      ((x)[3])
+
+#define GST_DP_V2_FIELD_PTS             (1 << 0)        /* 8 bytes */
+#define GST_DP_V2_FIELD_DTS             (1 << 1)        /* 8 bytes */
+#define GST_DP_V2_FIELD_DURATION        (1 << 2)        /* 8 bytes */
+#define GST_DP_V2_FIELD_OFFSET          (1 << 3)        /* 8 bytes */
+#define GST_DP_V2_FIELD_OFFSET_END      (1 << 4)        /* 8 bytes */
+#define GST_DP_V2_FIELD_BUFFER_FLAGS    (1 << 5)        /* 2 bytes */
+#define GST_DP_V2_FIELD_METAS           (1 << 6)        /* 4 bytes */
+
+#define GST_DP_V2_N_TIME_FIELDS         5
+
 void gst_dp_dump_byte_array (guint8 *array, guint length);
 
 G_END_DECLS
@@ -30,6 +30,9 @@
  * ]| This pipeline plays back a serialized video stream as created in the
  * example for gdppay.
  * </refsect2>
+ *
+ * Both version 1.0 and version 2.0 streams are read. The buffers contained in
+ * one input buffer are pushed downstream as a single buffer list.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -87,6 +90,7 @@ static void gst_gdp_depay_set_property (GObject * object, guint prop_id,
 static void gst_gdp_depay_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
 static void gst_gdp_depay_decide_allocation (GstGDPDepay * depay);
+static GstFlowReturn gst_gdp_depay_push_pending (GstGDPDepay * this);
 
 static void
 gst_gdp_depay_class_init (GstGDPDepayClass * klass)
@@ -157,6 +161,8 @@ gst_gdp_depay_finalize (GObject * gobject)
   g_free (this->header);
   gst_adapter_clear (this->adapter);
   g_object_unref (this->adapter);
+  if (this->pending)
+    gst_buffer_list_unref (this->pending);
   if (this->allocator)
     gst_object_unref (this->allocator);
 
@@ -289,16 +295,25 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       case GST_GDP_DEPAY_STATE_HEADER:
       {
         guint8 *header;
+        guint header_length;
 
         /* collect a complete header, validate and store the header. Figure out
-         * the payload length and switch to the PAYLOAD state */
+         * the payload length and switch to the PAYLOAD state. The size of
+         * the header depends on the version found in its first bytes */
         available = gst_adapter_available (this->adapter);
-        if (available < GST_DP_HEADER_LENGTH)
+        if (available < GST_DP_HEADER_MIN_LENGTH)
+          goto done;
+
+        header_length = gst_dp_header_length (gst_adapter_map (this->adapter,
+                GST_DP_HEADER_MIN_LENGTH));
+        gst_adapter_unmap (this->adapter);
+        if (available < header_length)
           goto done;
 
-        GST_LOG_OBJECT (this, "reading GDP header from adapter");
-        header = gst_adapter_take (this->adapter, GST_DP_HEADER_LENGTH);
-        if (!gst_dp_validate_header (GST_DP_HEADER_LENGTH, header)) {
+        GST_LOG_OBJECT (this, "reading GDP header of %u bytes from adapter",
+            header_length);
+        header = gst_adapter_take (this->adapter, header_length);
+        if (!gst_dp_validate_header (header_length, header)) {
           g_free (header);
           goto header_validate_error;
         }
@@ -310,6 +325,7 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
         /* free previous header and store new one. */
         g_free (this->header);
         this->header = header;
+        this->header_length = header_length;
 
         GST_LOG_OBJECT (this,
             "read GDP header, payload size %d, payload type %d, switching to state PAYLOAD",
@@ -345,7 +361,7 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
           gboolean res;
 
           data = gst_adapter_map (this->adapter, this->payload_length);
-          res = gst_dp_validate_payload (GST_DP_HEADER_LENGTH, this->header,
+          res = gst_dp_validate_payload (this->header_length, this->header,
               data);
           gst_adapter_unmap (this->adapter);
 
@@ -357,26 +373,43 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       }
       case GST_GDP_DEPAY_STATE_BUFFER:
       {
+        guint32 meta_length, size;
+
         /* if we receive a buffer without caps first, we error out */
         if (!this->caps)
           goto no_caps;
 
         GST_LOG_OBJECT (this, "reading GDP buffer from adapter");
         buf =
-            gst_dp_buffer_from_header (GST_DP_HEADER_LENGTH, this->header,
+            gst_dp_buffer_from_header (this->header_length, this->header,
             this->allocator, &this->allocation_params);
         if (!buf)
           goto buffer_failed;
 
+        /* serialized metas come in front of the buffer data */
+        meta_length =
+            gst_dp_header_meta_length (this->header_length, this->header);
+        if (meta_length > 0) {
+          gboolean res;
+
+          res = gst_dp_buffer_add_metas (buf,
+              gst_adapter_map (this->adapter, meta_length), meta_length);
+          gst_adapter_unmap (this->adapter);
+          gst_adapter_flush (this->adapter, meta_length);
+          if (!res)
+            GST_WARNING_OBJECT (this, "could not read all serialized metas");
+        }
+
         /* now take the payload if there is any */
-        if (this->payload_length > 0) {
+        size = this->payload_length - meta_length;
+        if (size > 0) {
           GstMapInfo map;
 
           gst_buffer_map (buf, &map, GST_MAP_WRITE);
-          gst_adapter_copy (this->adapter, map.data, 0, this->payload_length);
+          gst_adapter_copy (this->adapter, map.data, 0, size);
           gst_buffer_unmap (buf, &map);
 
-          gst_adapter_flush (this->adapter, this->payload_length);
+          gst_adapter_flush (this->adapter, size);
         }
 
         if (GST_BUFFER_TIMESTAMP (buf) > -this->ts_offset)
@@ -389,8 +422,9 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
         else
           GST_BUFFER_DTS (buf) = 0;
 
-        /* set caps and push */
-        GST_LOG_OBJECT (this, "deserialized buffer %p, pushing, timestamp %"
+        /* collect, the buffers are pushed as a list once we run out of data
+         * or before the next caps or event */
+        GST_LOG_OBJECT (this, "deserialized buffer %p, queueing, timestamp %"
             GST_TIME_FORMAT ", duration %" GST_TIME_FORMAT
             ", offset %" G_GINT64_FORMAT ", offset_end %" G_GINT64_FORMAT
             ", size %" G_GSIZE_FORMAT ", flags 0x%x",
@@ -399,9 +433,9 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
             GST_TIME_ARGS (GST_BUFFER_DURATION (buf)),
             GST_BUFFER_OFFSET (buf), GST_BUFFER_OFFSET_END (buf),
             gst_buffer_get_size (buf), GST_BUFFER_FLAGS (buf));
-        ret = gst_pad_push (this->srcpad, buf);
-        if (ret != GST_FLOW_OK)
-          goto push_error;
+        if (!this->pending)
+          this->pending = gst_buffer_list_new ();
+        gst_buffer_list_add (this->pending, buf);
 
         GST_LOG_OBJECT (this, "switching to state HEADER");
         this->state = GST_GDP_DEPAY_STATE_HEADER;
@@ -414,12 +448,19 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
         /* take the payload of the caps */
         GST_LOG_OBJECT (this, "reading GDP caps from adapter");
         payload = gst_adapter_take (this->adapter, this->payload_length);
-        caps = gst_dp_caps_from_packet (GST_DP_HEADER_LENGTH, this->header,
+        caps = gst_dp_caps_from_packet (this->header_length, this->header,
             payload);
         g_free (payload);
         if (!caps)
           goto caps_failed;
 
+        /* buffers before the caps change go out with the old caps */
+        ret = gst_gdp_depay_push_pending (this);
+        if (ret != GST_FLOW_OK) {
+          gst_caps_unref (caps);
+          goto push_error;
+        }
+
         GST_DEBUG_OBJECT (this, "deserialized caps %" GST_PTR_FORMAT, caps);
         gst_caps_replace (&(this->caps), caps);
         gst_pad_set_caps (this->srcpad, caps);
@@ -442,12 +483,18 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
           payload = gst_adapter_take (this->adapter, this->payload_length);
         else
           payload = NULL;
-        event = gst_dp_event_from_packet (GST_DP_HEADER_LENGTH, this->header,
+        event = gst_dp_event_from_packet (this->header_length, this->header,
             payload);
         g_free (payload);
         if (!event)
           goto event_failed;
 
+        ret = gst_gdp_depay_push_pending (this);
+        if (ret != GST_FLOW_OK) {
+          gst_event_unref (event);
+          goto push_error;
+        }
+
         GST_DEBUG_OBJECT (this, "deserialized event %p of type %s, pushing",
             event, gst_event_type_get_name (event->type));
         gst_pad_push_event (this->srcpad, event);
@@ -460,6 +507,14 @@ gst_gdp_depay_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   }
 
 done:
+  if (ret == GST_FLOW_OK) {
+    ret = gst_gdp_depay_push_pending (this);
+    if (ret != GST_FLOW_OK)
+      GST_WARNING_OBJECT (this, "pushing depayloaded buffers returned %d", ret);
+  } else if (this->pending) {
+    gst_buffer_list_unref (this->pending);
+    this->pending = NULL;
+  }
   return ret;
 
   /* ERRORS */
@@ -500,7 +555,7 @@ buffer_failed:
   }
 push_error:
   {
-    GST_WARNING_OBJECT (this, "pushing depayloaded buffer returned %d", ret);
+    GST_WARNING_OBJECT (this, "pushing depayloaded buffers returned %d", ret);
     goto done;
   }
 caps_failed:
@@ -545,6 +600,21 @@ gst_gdp_depay_change_state (GstElement * element, GstStateChange transition)
   return ret;
 }
 
+static GstFlowReturn
+gst_gdp_depay_push_pending (GstGDPDepay * this)
+{
+  GstBufferList *list = this->pending;
+
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  this->pending = NULL;
+  GST_LOG_OBJECT (this, "pushing list of %u buffers",
+      gst_buffer_list_length (list));
+
+  return gst_pad_push_list (this->srcpad, list);
+}
+
 static void
 gst_gdp_depay_decide_allocation (GstGDPDepay * gdpdepay)
 {
@@ -64,11 +64,15 @@ struct _GstGDPDepay
   GstCaps *caps;
 
   guint8 *header;
+  guint header_length;
   guint32 payload_length;
   GstDPPayloadType payload_type;
 
   gint64 ts_offset;
 
+  /* buffers depayloaded from one input buffer, pushed as one list */
+  GstBufferList *pending;
+
   GstAllocator *allocator;
   GstAllocationParams allocation_params;
 };
@@ -31,6 +31,12 @@
  * ]| This pipeline creates a serialized video stream that can be played back
  * with the example shown in gdpdepay.
  * </refsect2>
+ *
+ * With #GstGDPPay:version set to 2.0 the element writes compact headers that
+ * only carry the fields that are set on each buffer, and with
+ * #GstGDPPay:serialize-metas the metas that have a serializer are sent along
+ * with the buffers. Buffer lists are payloaded and pushed as one list.
+ * gdpdepay reads both versions.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -58,14 +64,36 @@ GST_DEBUG_CATEGORY_STATIC (gst_gdp_pay_debug);
 
 #define DEFAULT_CRC_HEADER TRUE
 #define DEFAULT_CRC_PAYLOAD FALSE
+#define DEFAULT_VERSION GST_DP_VERSION_1_0
+#define DEFAULT_SERIALIZE_METAS FALSE
 
 enum
 {
   PROP_0,
   PROP_CRC_HEADER,
-  PROP_CRC_PAYLOAD
+  PROP_CRC_PAYLOAD,
+  PROP_VERSION,
+  PROP_SERIALIZE_METAS
 };
 
+#define GST_TYPE_GDP_PAY_VERSION (gst_gdp_pay_version_get_type ())
+static GType
+gst_gdp_pay_version_get_type (void)
+{
+  static GType gdp_pay_version_type = 0;
+  static const GEnumValue gdp_pay_version[] = {
+    {GST_DP_VERSION_1_0, "GDP 1.0 with fixed size headers", "1.0"},
+    {GST_DP_VERSION_2_0, "GDP 2.0 with compact headers", "2.0"},
+    {0, NULL, NULL},
+  };
+
+  if (!gdp_pay_version_type) {
+    gdp_pay_version_type =
+        g_enum_register_static ("GstGDPPayVersion", gdp_pay_version);
+  }
+  return gdp_pay_version_type;
+}
+
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_gdp_pay_debug, "gdppay", 0, \
     "GDP payloader");
@@ -76,6 +104,8 @@ static void gst_gdp_pay_reset (GstGDPPay * this);
 
 static GstFlowReturn gst_gdp_pay_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer);
+static GstFlowReturn gst_gdp_pay_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list);
 static gboolean gst_gdp_pay_src_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
 static gboolean gst_gdp_pay_sink_event (GstPad * pad, GstObject * parent,
@@ -112,6 +142,30 @@ gst_gdp_pay_class_init (GstGDPPayClass * klass)
       g_param_spec_boolean ("crc-payload", "CRC Payload",
           "Calculate and store a CRC checksum on the payload",
           DEFAULT_CRC_PAYLOAD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstGDPPay:version:
+   *
+   * The protocol version to write. Version 2.0 streams can only be read by
+   * gdpdepay elements that know about it.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_VERSION,
+      g_param_spec_enum ("version", "Version",
+          "The GDP protocol version to write", GST_TYPE_GDP_PAY_VERSION,
+          DEFAULT_VERSION, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstGDPPay:serialize-metas:
+   *
+   * Serialize the metas of the buffers that have a serializer. Only used
+   * with protocol version 2.0, other metas are dropped.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SERIALIZE_METAS,
+      g_param_spec_boolean ("serialize-metas", "Serialize Metas",
+          "Serialize buffer metas that have a serializer (version 2.0 only)",
+          DEFAULT_SERIALIZE_METAS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   gst_element_class_set_static_metadata (gstelement_class,
       "GDP Payloader", "GDP/Payloader",
       "Payloads GStreamer Data Protocol buffers",
@@ -132,6 +186,8 @@ gst_gdp_pay_init (GstGDPPay * gdppay)
       gst_pad_new_from_static_template (&gdp_pay_sink_template, "sink");
   gst_pad_set_chain_function (gdppay->sinkpad,
       GST_DEBUG_FUNCPTR (gst_gdp_pay_chain));
+  gst_pad_set_chain_list_function (gdppay->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_gdp_pay_chain_list));
   gst_pad_set_event_function (gdppay->sinkpad,
       GST_DEBUG_FUNCPTR (gst_gdp_pay_sink_event));
   gst_element_add_pad (GST_ELEMENT (gdppay), gdppay->sinkpad);
@@ -145,6 +201,8 @@ gst_gdp_pay_init (GstGDPPay * gdppay)
   gdppay->crc_header = DEFAULT_CRC_HEADER;
   gdppay->crc_payload = DEFAULT_CRC_PAYLOAD;
   gdppay->header_flag = gdppay->crc_header | gdppay->crc_payload;
+  gdppay->version = DEFAULT_VERSION;
+  gdppay->serialize_metas = DEFAULT_SERIALIZE_METAS;
   gdppay->offset = 0;
 }
 
@@ -197,19 +255,20 @@ gst_gdp_stamp_buffer (GstGDPPay * this, GstBuffer * buffer)
 static GstBuffer *
 gst_gdp_buffer_from_caps (GstGDPPay * this, GstCaps * caps)
 {
-  return gst_dp_payload_caps (caps, this->header_flag);
+  return gst_dp_payload_caps_full (caps, this->header_flag, this->version);
 }
 
 static GstBuffer *
 gst_gdp_pay_buffer_from_buffer (GstGDPPay * this, GstBuffer * buffer)
 {
-  return gst_dp_payload_buffer (buffer, this->header_flag);
+  return gst_dp_payload_buffer_full (buffer, this->header_flag, this->version,
+      this->serialize_metas);
 }
 
 static GstBuffer *
 gst_gdp_buffer_from_event (GstGDPPay * this, GstEvent * event)
 {
-  return gst_dp_payload_event (event, this->header_flag);
+  return gst_dp_payload_event_full (event, this->header_flag, this->version);
 }
 
 static void
@@ -507,6 +566,68 @@ no_buffer:
   }
 }
 
+/* payloads all buffers of @list into a single output list that is pushed
+ * in one go, instead of pushing one GDP buffer per input buffer */
+static GstFlowReturn
+gst_gdp_pay_chain_list (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  GstGDPPay *this;
+  GstBufferList *outlist;
+  GstFlowReturn ret;
+  guint i, len;
+
+  this = GST_GDP_PAY (parent);
+
+  /* everything that needs to be sent or queued before the buffers goes
+   * through the regular chain function */
+  if (!this->have_segment || !this->caps || !this->sent_streamheader
+      || this->reset_streamheader) {
+    len = gst_buffer_list_length (list);
+    ret = GST_FLOW_OK;
+    for (i = 0; i < len && ret == GST_FLOW_OK; i++) {
+      ret = gst_gdp_pay_chain (pad, parent,
+          gst_buffer_ref (gst_buffer_list_get (list, i)));
+    }
+    gst_buffer_list_unref (list);
+    return ret;
+  }
+
+  len = gst_buffer_list_length (list);
+  outlist = gst_buffer_list_new_sized (len);
+
+  for (i = 0; i < len; i++) {
+    GstBuffer *buffer, *outbuffer;
+
+    buffer = gst_buffer_list_get (list, i);
+    outbuffer = gst_gdp_pay_buffer_from_buffer (this, buffer);
+    if (!outbuffer)
+      goto no_buffer;
+
+    if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_HEADER))
+      GST_BUFFER_FLAG_SET (outbuffer, GST_BUFFER_FLAG_HEADER);
+
+    gst_gdp_stamp_buffer (this, outbuffer);
+    GST_BUFFER_TIMESTAMP (outbuffer) = GST_BUFFER_TIMESTAMP (buffer);
+    GST_BUFFER_DURATION (outbuffer) = GST_BUFFER_DURATION (buffer);
+
+    gst_buffer_list_add (outlist, outbuffer);
+  }
+  gst_buffer_list_unref (list);
+
+  GST_LOG_OBJECT (this, "Pushing list of %u GDP buffers", len);
+  return gst_pad_push_list (this->srcpad, outlist);
+
+  /* ERRORS */
+no_buffer:
+  {
+    GST_ELEMENT_ERROR (this, STREAM, ENCODE, (NULL),
+        ("Could not create GDP buffer from buffer"));
+    gst_buffer_list_unref (outlist);
+    gst_buffer_list_unref (list);
+    return GST_FLOW_ERROR;
+  }
+}
+
 static gboolean
 gst_gdp_pay_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -655,6 +776,12 @@ gst_gdp_pay_set_property (GObject * object, guint prop_id,
           g_value_get_boolean (value) ? GST_DP_HEADER_FLAG_CRC_PAYLOAD : 0;
       this->header_flag = this->crc_header | this->crc_payload;
       break;
+    case PROP_VERSION:
+      this->version = g_value_get_enum (value);
+      break;
+    case PROP_SERIALIZE_METAS:
+      this->serialize_metas = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -677,6 +804,12 @@ gst_gdp_pay_get_property (GObject * object, guint prop_id,
     case PROP_CRC_PAYLOAD:
       g_value_set_boolean (value, this->crc_payload);
       break;
+    case PROP_VERSION:
+      g_value_set_enum (value, this->version);
+      break;
+    case PROP_SERIALIZE_METAS:
+      g_value_set_boolean (value, this->serialize_metas);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
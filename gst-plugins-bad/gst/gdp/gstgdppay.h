@@ -65,6 +65,8 @@ struct _GstGDPPay
   gboolean crc_header;
   gboolean crc_payload;
   GstDPHeaderFlag header_flag;
+  GstDPVersion version;
+  gboolean serialize_metas;
 };
 
 struct _GstGDPPayClass
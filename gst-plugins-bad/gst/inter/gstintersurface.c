@@ -28,6 +28,9 @@
 static GList *list;
 static GMutex mutex;
 
+#define GST_INTER_SURFACE_NEW_FRAME (1 << 2)
+#define GST_INTER_SURFACE_SLOT_MASK (3)
+
 GstInterSurface *
 gst_inter_surface_get (const char *name)
 {
@@ -52,6 +55,9 @@ gst_inter_surface_get (const char *name)
   surface->audio_buffer_time = DEFAULT_AUDIO_BUFFER_TIME;
   surface->audio_latency_time = DEFAULT_AUDIO_LATENCY_TIME;
   surface->audio_period_time = DEFAULT_AUDIO_PERIOD_TIME;
+  surface->video_back = 0;
+  surface->video_front = 1;
+  surface->video_latest = 2;
 
   list = g_list_append (list, surface);
   g_mutex_unlock (&mutex);
@@ -78,7 +84,9 @@ gst_inter_surface_unref (GstInterSurface * surface)
     }
 
     g_mutex_clear (&surface->mutex);
-    gst_buffer_replace (&surface->video_buffer, NULL);
+    gst_buffer_replace (&surface->video_slots[0], NULL);
+    gst_buffer_replace (&surface->video_slots[1], NULL);
+    gst_buffer_replace (&surface->video_slots[2], NULL);
     gst_buffer_replace (&surface->sub_buffer, NULL);
     gst_object_unref (surface->audio_adapter);
     g_free (surface->name);
@@ -86,3 +94,44 @@ gst_inter_surface_unref (GstInterSurface * surface)
   }
   g_mutex_unlock (&mutex);
 }
+
+/* Called from the sink only. Makes @buffer, which can be %NULL, the latest
+ * frame of @surface and takes ownership of it. */
+void
+gst_inter_surface_publish_video (GstInterSurface * surface, GstBuffer * buffer)
+{
+  gint latest;
+
+  gst_buffer_replace (&surface->video_slots[surface->video_back], NULL);
+  surface->video_slots[surface->video_back] = buffer;
+
+  /* swap the back slot with the latest one */
+  do {
+    latest = g_atomic_int_get (&surface->video_latest);
+  } while (!g_atomic_int_compare_and_exchange (&surface->video_latest, latest,
+          surface->video_back | GST_INTER_SURFACE_NEW_FRAME));
+
+  surface->video_back = latest & GST_INTER_SURFACE_SLOT_MASK;
+}
+
+/* Called from the src only. Returns %TRUE and the new frame in @buffer, which
+ * can be %NULL when the sink stopped, if a frame was published since the last
+ * call. */
+gboolean
+gst_inter_surface_take_video (GstInterSurface * surface, GstBuffer ** buffer)
+{
+  gint latest;
+
+  do {
+    latest = g_atomic_int_get (&surface->video_latest);
+    if (!(latest & GST_INTER_SURFACE_NEW_FRAME))
+      return FALSE;
+  } while (!g_atomic_int_compare_and_exchange (&surface->video_latest, latest,
+          surface->video_front));
+
+  surface->video_front = latest & GST_INTER_SURFACE_SLOT_MASK;
+  *buffer = surface->video_slots[surface->video_front];
+  surface->video_slots[surface->video_front] = NULL;
+
+  return TRUE;
+}
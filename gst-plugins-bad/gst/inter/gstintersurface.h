@@ -37,7 +37,17 @@ struct _GstInterSurface
 
   /* video */
   GstVideoInfo video_info;
-  int video_buffer_count;
+  /* incremented when video_info changes, to avoid taking the lock for every
+   * frame */
+  volatile gint video_info_cookie;
+
+  /* video frames are exchanged through a triple buffer without taking the
+   * lock: the sink owns the back slot, the src the front slot and the third
+   * slot holds the latest frame. This only supports one src per channel. */
+  GstBuffer *video_slots[3];
+  volatile gint video_latest;   /* slot index | GST_INTER_SURFACE_NEW_FRAME */
+  gint video_back;
+  gint video_front;
 
   /* audio */
   GstAudioInfo audio_info;
@@ -45,7 +55,6 @@ struct _GstInterSurface
   guint64 audio_latency_time;
   guint64 audio_period_time;
 
-  GstBuffer *video_buffer;
   GstBuffer *sub_buffer;
   GstAdapter *audio_adapter;
 };
@@ -58,6 +67,9 @@ struct _GstInterSurface
 GstInterSurface * gst_inter_surface_get (const char *name);
 void gst_inter_surface_unref (GstInterSurface *surface);
 
+void gst_inter_surface_publish_video (GstInterSurface *surface, GstBuffer *buffer);
+gboolean gst_inter_surface_take_video (GstInterSurface *surface, GstBuffer **buffer);
+
 
 G_END_DECLS
 
@@ -199,6 +199,7 @@ gst_inter_video_sink_start (GstBaseSink * sink)
   intervideosink->surface = gst_inter_surface_get (intervideosink->channel);
   g_mutex_lock (&intervideosink->surface->mutex);
   memset (&intervideosink->surface->video_info, 0, sizeof (GstVideoInfo));
+  g_atomic_int_inc (&intervideosink->surface->video_info_cookie);
   g_mutex_unlock (&intervideosink->surface->mutex);
 
   return TRUE;
@@ -209,12 +210,10 @@ gst_inter_video_sink_stop (GstBaseSink * sink)
 {
   GstInterVideoSink *intervideosink = GST_INTER_VIDEO_SINK (sink);
 
+  gst_inter_surface_publish_video (intervideosink->surface, NULL);
   g_mutex_lock (&intervideosink->surface->mutex);
-  if (intervideosink->surface->video_buffer) {
-    gst_buffer_unref (intervideosink->surface->video_buffer);
-  }
-  intervideosink->surface->video_buffer = NULL;
   memset (&intervideosink->surface->video_info, 0, sizeof (GstVideoInfo));
+  g_atomic_int_inc (&intervideosink->surface->video_info_cookie);
   g_mutex_unlock (&intervideosink->surface->mutex);
 
   gst_inter_surface_unref (intervideosink->surface);
@@ -237,6 +236,7 @@ gst_inter_video_sink_set_caps (GstBaseSink * sink, GstCaps * caps)
   g_mutex_lock (&intervideosink->surface->mutex);
   intervideosink->surface->video_info = info;
   intervideosink->info = info;
+  g_atomic_int_inc (&intervideosink->surface->video_info_cookie);
   g_mutex_unlock (&intervideosink->surface->mutex);
 
   return TRUE;
@@ -250,13 +250,8 @@ gst_inter_video_sink_show_frame (GstVideoSink * sink, GstBuffer * buffer)
   GST_DEBUG_OBJECT (intervideosink, "render ts %" GST_TIME_FORMAT,
       GST_TIME_ARGS (GST_BUFFER_PTS (buffer)));
 
-  g_mutex_lock (&intervideosink->surface->mutex);
-  if (intervideosink->surface->video_buffer) {
-    gst_buffer_unref (intervideosink->surface->video_buffer);
-  }
-  intervideosink->surface->video_buffer = gst_buffer_ref (buffer);
-  intervideosink->surface->video_buffer_count = 0;
-  g_mutex_unlock (&intervideosink->surface->mutex);
+  gst_inter_surface_publish_video (intervideosink->surface,
+      gst_buffer_ref (buffer));
 
   return GST_FLOW_OK;
 }
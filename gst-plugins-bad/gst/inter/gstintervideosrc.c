@@ -244,6 +244,9 @@ gst_inter_video_src_set_caps (GstBaseSrc * base, GstCaps * caps)
     return FALSE;
   }
 
+  /* compare with the surface video info again on the next frame */
+  intervideosrc->video_info_cookie = -1;
+
   /* Create a black frame */
   gst_buffer_replace (&intervideosrc->black_frame, NULL);
   gst_video_info_set_format (&black_info, GST_VIDEO_FORMAT_ARGB,
@@ -276,6 +279,8 @@ gst_inter_video_src_start (GstBaseSrc * src)
   intervideosrc->surface = gst_inter_surface_get (intervideosrc->channel);
   intervideosrc->timestamp_offset = 0;
   intervideosrc->n_frames = 0;
+  intervideosrc->video_buffer_count = 0;
+  intervideosrc->video_info_cookie = -1;
 
   return TRUE;
 }
@@ -290,6 +295,7 @@ gst_inter_video_src_stop (GstBaseSrc * src)
   gst_inter_surface_unref (intervideosrc->surface);
   intervideosrc->surface = NULL;
   gst_buffer_replace (&intervideosrc->black_frame, NULL);
+  gst_buffer_replace (&intervideosrc->video_buffer, NULL);
 
   return TRUE;
 }
@@ -319,26 +325,13 @@ gst_inter_video_src_get_times (GstBaseSrc * src, GstBuffer * buffer,
   }
 }
 
-static GstFlowReturn
-gst_inter_video_src_create (GstBaseSrc * src, guint64 offset, guint size,
-    GstBuffer ** buf)
+/* Called with the surface lock. Returns the caps to negotiate if the video
+ * info of the surface changed */
+static GstCaps *
+gst_inter_video_src_check_info_unlocked (GstInterVideoSrc * intervideosrc)
 {
-  GstInterVideoSrc *intervideosrc = GST_INTER_VIDEO_SRC (src);
-  GstCaps *caps;
-  GstBuffer *buffer;
-  guint64 frames;
-  gboolean is_gap = FALSE;
+  GstCaps *caps = NULL;
 
-  GST_DEBUG_OBJECT (intervideosrc, "create");
-
-  caps = NULL;
-  buffer = NULL;
-
-  frames = gst_util_uint64_scale_ceil (intervideosrc->timeout,
-      GST_VIDEO_INFO_FPS_N (&intervideosrc->info),
-      GST_VIDEO_INFO_FPS_D (&intervideosrc->info) * GST_SECOND);
-
-  g_mutex_lock (&intervideosrc->surface->mutex);
   if (intervideosrc->surface->video_info.finfo) {
     GstVideoInfo tmp_info = intervideosrc->surface->video_info;
 
@@ -360,25 +353,62 @@ gst_inter_video_src_create (GstBaseSrc * src, guint64 offset, guint size,
     }
   }
 
-  if (intervideosrc->surface->video_buffer) {
+  return caps;
+}
+
+static GstFlowReturn
+gst_inter_video_src_create (GstBaseSrc * src, guint64 offset, guint size,
+    GstBuffer ** buf)
+{
+  GstInterVideoSrc *intervideosrc = GST_INTER_VIDEO_SRC (src);
+  GstCaps *caps;
+  GstBuffer *buffer, *new_buffer;
+  guint64 frames;
+  gboolean is_gap = FALSE;
+  gint cookie;
+
+  GST_DEBUG_OBJECT (intervideosrc, "create");
+
+  caps = NULL;
+  buffer = NULL;
+
+  frames = gst_util_uint64_scale_ceil (intervideosrc->timeout,
+      GST_VIDEO_INFO_FPS_N (&intervideosrc->info),
+      GST_VIDEO_INFO_FPS_D (&intervideosrc->info) * GST_SECOND);
+
+  /* only look at the video info when the sink changed it */
+  cookie = g_atomic_int_get (&intervideosrc->surface->video_info_cookie);
+  if (cookie != intervideosrc->video_info_cookie) {
+    g_mutex_lock (&intervideosrc->surface->mutex);
+    caps = gst_inter_video_src_check_info_unlocked (intervideosrc);
+    g_mutex_unlock (&intervideosrc->surface->mutex);
+    intervideosrc->video_info_cookie = cookie;
+  }
+
+  if (gst_inter_surface_take_video (intervideosrc->surface, &new_buffer)) {
+    gst_buffer_replace (&intervideosrc->video_buffer, NULL);
+    intervideosrc->video_buffer = new_buffer;
+    intervideosrc->video_buffer_count = 0;
+  }
+
+  if (intervideosrc->video_buffer) {
     /* We have a buffer to push */
-    buffer = gst_buffer_ref (intervideosrc->surface->video_buffer);
+    buffer = gst_buffer_ref (intervideosrc->video_buffer);
 
     /* Can only be true if timeout > 0 */
-    if (intervideosrc->surface->video_buffer_count == frames) {
-      gst_buffer_unref (intervideosrc->surface->video_buffer);
-      intervideosrc->surface->video_buffer = NULL;
+    if (intervideosrc->video_buffer_count == frames) {
+      gst_buffer_unref (intervideosrc->video_buffer);
+      intervideosrc->video_buffer = NULL;
     }
   }
 
-  if (intervideosrc->surface->video_buffer_count != 0 &&
-      intervideosrc->surface->video_buffer_count != (frames + 1)) {
+  if (intervideosrc->video_buffer_count != 0 &&
+      intervideosrc->video_buffer_count != (frames + 1)) {
     /* This is a repeat of the stored buffer or of a black frame */
     is_gap = TRUE;
   }
 
-  intervideosrc->surface->video_buffer_count++;
-  g_mutex_unlock (&intervideosrc->surface->mutex);
+  intervideosrc->video_buffer_count++;
 
   if (caps) {
     gboolean ret;
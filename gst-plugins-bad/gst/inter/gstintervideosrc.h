@@ -46,6 +46,9 @@ struct _GstInterVideoSrc
 
   GstVideoInfo info;
   GstBuffer *black_frame;
+  GstBuffer *video_buffer;
+  guint64 video_buffer_count;
+  gint video_info_cookie;
   int n_frames;
   GstClockTime timestamp_offset;
 };
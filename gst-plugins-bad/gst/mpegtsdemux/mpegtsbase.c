@@ -63,6 +63,7 @@ enum
 {
   PROP_0,
   PROP_PARSE_PRIVATE_SECTIONS,
+  PROP_SKIP_EPG,
   /* FILL ME */
 };
 
@@ -138,6 +139,18 @@ mpegts_base_class_init (MpegTSBaseClass * klass)
           "Parse private sections", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * MpegTSBase:skip-epg:
+   *
+   * Drop the EPG tables (DVB EIT, ATSC EIT and ETT) without parsing them.
+   * No section messages or tags are produced for them.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SKIP_EPG,
+      g_param_spec_boolean ("skip-epg", "Skip EPG",
+          "Skip Electronic Program Guide sections (EIT/ETT)", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -150,6 +163,10 @@ mpegts_base_set_property (GObject * object, guint prop_id,
     case PROP_PARSE_PRIVATE_SECTIONS:
       base->parse_private_sections = g_value_get_boolean (value);
       break;
+    case PROP_SKIP_EPG:
+      mpegts_packetizer_set_skip_epg (base->packetizer,
+          g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -165,6 +182,9 @@ mpegts_base_get_property (GObject * object, guint prop_id,
     case PROP_PARSE_PRIVATE_SECTIONS:
       g_value_set_boolean (value, base->parse_private_sections);
       break;
+    case PROP_SKIP_EPG:
+      g_value_set_boolean (value, base->packetizer->skip_epg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -210,6 +230,14 @@ mpegts_base_reset (MpegTSBase * base)
   g_hash_table_foreach_remove (base->programs, (GHRFunc) remove_each_program,
       base);
 
+  /* subclasses that inspect every packet need all of them, others only care
+   * about the PIDs we know */
+  if (klass->inspect_packet)
+    mpegts_packetizer_set_pid_filter (base->packetizer, NULL, NULL);
+  else
+    mpegts_packetizer_set_pid_filter (base->packetizer, base->is_pes,
+        base->known_psi);
+
   if (klass->reset)
     klass->reset (base);
 }
@@ -975,6 +1003,10 @@ mpegts_base_parse_atsc_mgt (MpegTSBase * base, GstMpegtsSection * section)
   if (G_UNLIKELY (mgt == NULL))
     return FALSE;
 
+  /* the MGT only tells us where the EIT/ETT are */
+  if (base->packetizer->skip_epg)
+    return TRUE;
+
   for (i = 0; i < mgt->tables->len; ++i) {
     GstMpegtsAtscMGTTable *table = g_ptr_array_index (mgt->tables, i);
 
@@ -134,21 +134,23 @@ mpegts_packetizer_get_current_time (MpegTSPacketizer2 * packetizer,
       pcr_pid);
 }
 
-static inline MpegTSPacketizerStreamSubtable *
-find_subtable (GSList * subtables, guint8 table_id, guint16 subtable_extension)
-{
-  GSList *tmp;
+#define SUBTABLE_KEY(table_id, subtable_extension) \
+  GUINT_TO_POINTER (((guint) (table_id) << 16) | (subtable_extension))
 
-  /* FIXME: Make this an array ! */
-  for (tmp = subtables; tmp; tmp = tmp->next) {
-    MpegTSPacketizerStreamSubtable *sub =
-        (MpegTSPacketizerStreamSubtable *) tmp->data;
-    if (sub->table_id == table_id
-        && sub->subtable_extension == subtable_extension)
-      return sub;
-  }
+/* EIT and ETT, the tables making up the EPG */
+#define IS_EPG_TABLE_ID(table_id) \
+  (((table_id) >= GST_MTS_TABLE_ID_EVENT_INFORMATION_ACTUAL_TS_PRESENT && \
+    (table_id) <= GST_MTS_TABLE_ID_EVENT_INFORMATION_OTHER_TS_SCHEDULE_N) || \
+   (table_id) == GST_MTS_TABLE_ID_ATSC_EVENT_INFORMATION || \
+   (table_id) == GST_MTS_TABLE_ID_ATSC_CHANNEL_OR_EVENT_EXTENDED_TEXT)
 
-  return NULL;
+static inline MpegTSPacketizerStreamSubtable *
+find_subtable (GHashTable * subtables, guint8 table_id,
+    guint16 subtable_extension)
+{
+  /* DVB EIT schedules alone can have thousands of subtables per PID */
+  return g_hash_table_lookup (subtables,
+      SUBTABLE_KEY (table_id, subtable_extension));
 }
 
 static gboolean
@@ -192,6 +194,13 @@ mpegts_packetizer_stream_subtable_new (guint8 table_id,
   return subtable;
 }
 
+static void
+mpegts_packetizer_stream_subtable_free (MpegTSPacketizerStreamSubtable *
+    subtable)
+{
+  g_free (subtable);
+}
+
 static MpegTSPacketizerStream *
 mpegts_packetizer_stream_new (guint16 pid)
 {
@@ -199,7 +208,8 @@ mpegts_packetizer_stream_new (guint16 pid)
 
   stream = (MpegTSPacketizerStream *) g_new0 (MpegTSPacketizerStream, 1);
   stream->continuity_counter = CONTINUITY_UNSET;
-  stream->subtables = NULL;
+  stream->subtables = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      NULL, (GDestroyNotify) mpegts_packetizer_stream_subtable_free);
   stream->table_id = TABLE_ID_UNSET;
   stream->pid = pid;
   return stream;
@@ -216,20 +226,11 @@ mpegts_packetizer_clear_section (MpegTSPacketizerStream * stream)
   stream->section_data = NULL;
 }
 
-static void
-mpegts_packetizer_stream_subtable_free (MpegTSPacketizerStreamSubtable *
-    subtable)
-{
-  g_free (subtable);
-}
-
 static void
 mpegts_packetizer_stream_free (MpegTSPacketizerStream * stream)
 {
   mpegts_packetizer_clear_section (stream);
-  g_slist_foreach (stream->subtables,
-      (GFunc) mpegts_packetizer_stream_subtable_free, NULL);
-  g_slist_free (stream->subtables);
+  g_hash_table_unref (stream->subtables);
   g_free (stream);
 }
 
@@ -516,7 +517,8 @@ mpegts_packetizer_parse_section_header (MpegTSPacketizer2 * packetizer,
         stream->subtable_extension, stream->last_section_number);
     subtable->version_number = stream->version_number;
 
-    stream->subtables = g_slist_prepend (stream->subtables, subtable);
+    g_hash_table_insert (stream->subtables,
+        SUBTABLE_KEY (stream->table_id, stream->subtable_extension), subtable);
   }
 
   GST_MEMDUMP ("Full section data", stream->section_data,
@@ -803,6 +805,26 @@ mpegts_packetizer_sync (MpegTSPacketizer2 * packetizer)
   return found;
 }
 
+/* Check if a packet can be skipped without parsing it because the caller
+ * isn't interested in its PID. Packets carrying a PCR are always kept since
+ * all of them feed the skew and offset calculations. */
+static inline gboolean
+mpegts_packetizer_packet_is_filtered (MpegTSPacketizer2 * packetizer,
+    const guint8 * data)
+{
+  guint16 pid = GST_READ_UINT16_BE (data + 1) & 0x1FFF;
+
+  if (MPEGTS_BIT_IS_SET (packetizer->filter_pes, pid) ||
+      MPEGTS_BIT_IS_SET (packetizer->filter_psi, pid))
+    return FALSE;
+
+  if (FLAGS_HAS_AFC (data[3]) && data[4] > 0 &&
+      (data[5] & MPEGTS_AFC_PCR_FLAG))
+    return FALSE;
+
+  return TRUE;
+}
+
 MpegTSPacketizerPacketReturn
 mpegts_packetizer_next_packet (MpegTSPacketizer2 * packetizer,
     MpegTSPacketizerPacket * packet)
@@ -836,6 +858,25 @@ mpegts_packetizer_next_packet (MpegTSPacketizer2 * packetizer,
 
     packet_data = &packetizer->map_data[packetizer->map_offset + sync_offset];
 
+    /* skip over all unwanted packets in the mapped data at once, they don't
+     * need to be handed out and parsed one by one */
+    if (packetizer->filter_pes) {
+      gsize avail = packetizer->map_size - packetizer->map_offset;
+      gsize skipped = 0;
+
+      while (avail - skipped >= packet_size &&
+          G_LIKELY (packet_data[skipped] == PACKET_SYNC_BYTE) &&
+          mpegts_packetizer_packet_is_filtered (packetizer,
+              packet_data + skipped))
+        skipped += packet_size;
+
+      if (skipped > 0) {
+        packetizer->map_offset += skipped;
+        packetizer->offset += skipped;
+        continue;
+      }
+    }
+
     /* Check sync byte */
     if (G_UNLIKELY (*packet_data != PACKET_SYNC_BYTE)) {
       GST_DEBUG ("lost sync");
@@ -1105,6 +1146,12 @@ section_start:
   section_length = (GST_READ_UINT16_BE (data) & 0x0FFF) + 3;
   data += 2;
 
+  if (G_UNLIKELY (packetizer->skip_epg) && IS_EPG_TABLE_ID (table_id)) {
+    GST_LOG ("PID 0x%04x skipping EPG table_id 0x%02x", packet->pid,
+        table_id);
+    goto skip_section;
+  }
+
   if (long_packet) {
     /* subtable_extension (always present, we are in a long section) */
     /* subtable extension              : 16 bit */
@@ -1138,8 +1185,6 @@ section_start:
       packet->pid, section_length, table_id, subtable_extension, version_number,
       section_number, last_section_number);
 
-  to_read = MIN (section_length, packet->data_end - data_start);
-
   /* Check as early as possible whether we already saw this section
    * i.e. that we saw a subtable with:
    * * same subtable_extension (might be zero)
@@ -1153,11 +1198,7 @@ section_start:
         ("PID 0x%04x Already processed table_id:0x%02x subtable_extension:0x%04x, version_number:%d, section_number:%d",
         packet->pid, table_id, subtable_extension, version_number,
         section_number);
-    /* skip data and see if we have more sections after */
-    data = data_start + to_read;
-    if (data == packet->data_end || *data == 0xff)
-      goto out;
-    goto section_start;
+    goto skip_section;
   }
   if (G_UNLIKELY (section_number > last_section_number)) {
     GST_WARNING
@@ -1183,6 +1224,17 @@ section_start:
   /* Finally, accumulate and check if we parsed enough */
   goto accumulate_data;
 
+skip_section:
+  /* skip data and see if we have more sections after */
+  to_read = MIN (section_length, packet->data_end - data_start);
+  data = data_start + to_read;
+  /* the rest of a section continuing in the next packets is dropped too */
+  if (to_read < section_length)
+    mpegts_packetizer_clear_section (stream);
+  if (data == packet->data_end || *data == 0xff)
+    goto out;
+  goto section_start;
+
 out:
   packet->data = data;
   *remaining = others;
@@ -2442,6 +2494,28 @@ mpegts_packetizer_set_pcr_discont_threshold (MpegTSPacketizer2 * packetizer,
   PACKETIZER_GROUP_UNLOCK (packetizer);
 }
 
+/* Only packets with a PID set in @pes or @psi (or carrying a PCR) will be
+ * returned by mpegts_packetizer_next_packet(), the bitmaps are not copied
+ * and the caller can update them at any time. Pass NULL to get all packets. */
+void
+mpegts_packetizer_set_pid_filter (MpegTSPacketizer2 * packetizer,
+    const guint8 * pes, const guint8 * psi)
+{
+  g_return_if_fail ((pes == NULL) == (psi == NULL));
+
+  packetizer->filter_pes = pes;
+  packetizer->filter_psi = psi;
+}
+
+/* If @skip_epg is set, EIT and ETT sections are dropped as soon as their
+ * table_id is known, without being copied or parsed */
+void
+mpegts_packetizer_set_skip_epg (MpegTSPacketizer2 * packetizer,
+    gboolean skip_epg)
+{
+  packetizer->skip_epg = skip_epg;
+}
+
 void
 mpegts_packetizer_set_current_pcr_offset (MpegTSPacketizer2 * packetizer,
     GstClockTime offset, guint16 pcr_pid)
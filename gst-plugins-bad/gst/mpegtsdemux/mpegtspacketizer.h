@@ -85,7 +85,8 @@ typedef struct
   guint8  section_number;
   guint8  last_section_number;
 
-  GSList *subtables;
+  /* MpegTSPacketizerStreamSubtable hashed by SUBTABLE_KEY() */
+  GHashTable *subtables;
 
   /* Upstream offset of the data contained in the section */
   guint64 offset;
@@ -283,6 +284,13 @@ struct _MpegTSPacketizer2 {
   MpegTSPCR *observations[MAX_PCR_OBS_CHANNELS];
   guint8 lastobsid;
   GstClockTime pcr_discont_threshold;
+
+  /* PID bitmaps of the packets the caller wants, or NULL for all packets */
+  const guint8 *filter_pes;
+  const guint8 *filter_psi;
+
+  /* Drop EIT/ETT sections before they are accumulated */
+  gboolean skip_epg;
 };
 
 struct _MpegTSPacketizer2Class {
@@ -378,6 +386,12 @@ mpegts_packetizer_set_reference_offset (MpegTSPacketizer2 * packetizer,
 G_GNUC_INTERNAL void
 mpegts_packetizer_set_pcr_discont_threshold (MpegTSPacketizer2 * packetizer,
 					GstClockTime threshold);
+G_GNUC_INTERNAL void
+mpegts_packetizer_set_pid_filter (MpegTSPacketizer2 * packetizer,
+				  const guint8 * pes, const guint8 * psi);
+G_GNUC_INTERNAL void
+mpegts_packetizer_set_skip_epg (MpegTSPacketizer2 * packetizer,
+				gboolean skip_epg);
 G_END_DECLS
 
 #endif /* GST_MPEGTS_PACKETIZER_H */
@@ -145,6 +145,9 @@ struct _TSDemuxStream
   /* Whether this is a sparse stream (subtitles or metadata) */
   gboolean sparse;
 
+  /* Whether this is a video stream */
+  gboolean is_video;
+
   /* TRUE if we are waiting for a valid timestamp */
   gboolean pending_ts;
 
@@ -202,6 +205,15 @@ struct _TSDemuxStream
   TSDemuxH264ParsingInfos h264infos;
 };
 
+/* Entry of the keyframe index */
+typedef struct
+{
+  GstClockTime ts;              /* PTS of the keyframe */
+  guint64 offset;               /* offset of the first TS packet of its PES */
+  gboolean follows;             /* TRUE if no keyframe is missing between the
+                                 * previous entry and this one */
+} TSDemuxKeyframe;
+
 #define VIDEO_CAPS \
   GST_STATIC_CAPS (\
     "video/mpeg, " \
@@ -335,6 +347,10 @@ gst_ts_demux_dispose (GObject * object)
   GstTSDemux *demux = GST_TS_DEMUX_CAST (object);
 
   gst_flow_combiner_free (demux->flowcombiner);
+  if (demux->keyframe_index) {
+    g_array_free (demux->keyframe_index, TRUE);
+    demux->keyframe_index = NULL;
+  }
 
   GST_CALL_PARENT (G_OBJECT_CLASS, dispose, (object));
 }
@@ -418,6 +434,12 @@ gst_ts_demux_reset (MpegTSBase * base)
   demux->group_id = G_MAXUINT;
 
   demux->last_seek_offset = -1;
+
+  /* reset is also called while the base class is initialized */
+  if (demux->keyframe_index)
+    g_array_set_size (demux->keyframe_index, 0);
+  demux->keyframe_index_pid = -1;
+  demux->last_keyframe = -1;
 }
 
 static void
@@ -431,6 +453,7 @@ gst_ts_demux_init (GstTSDemux * demux)
   base->push_section = FALSE;
 
   demux->flowcombiner = gst_flow_combiner_new ();
+  demux->keyframe_index = g_array_new (FALSE, FALSE, sizeof (TSDemuxKeyframe));
   demux->requested_program_number = -1;
   demux->program_number = -1;
   gst_ts_demux_reset (base);
@@ -783,6 +806,79 @@ typedef struct
   gint merged_offset;           /* offset of merged data in buffer */
 } OffsetInfo;
 
+/* Returns the position of the first keyframe index entry with a timestamp
+ * of @ts or later */
+static guint
+gst_ts_demux_keyframe_index_search (GstTSDemux * demux, GstClockTime ts)
+{
+  GArray *index = demux->keyframe_index;
+  guint lo = 0, hi = index->len, mid;
+
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (g_array_index (index, TSDemuxKeyframe, mid).ts < ts)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/* Records a random access point of the indexed stream, starting in the TS
+ * packet at @offset */
+static void
+gst_ts_demux_record_keyframe (GstTSDemux * demux, GstClockTime ts,
+    guint64 offset)
+{
+  GArray *index = demux->keyframe_index;
+  TSDemuxKeyframe *entry;
+  guint pos;
+
+  pos = gst_ts_demux_keyframe_index_search (demux, ts);
+  if (pos == index->len || g_array_index (index, TSDemuxKeyframe,
+          pos).ts != ts) {
+    TSDemuxKeyframe new_entry;
+
+    GST_LOG_OBJECT (demux, "keyframe %" GST_TIME_FORMAT " at offset %"
+        G_GUINT64_FORMAT, GST_TIME_ARGS (ts), offset);
+    new_entry.ts = ts;
+    new_entry.offset = offset;
+    new_entry.follows = FALSE;
+    g_array_insert_val (index, pos, new_entry);
+    if (demux->last_keyframe >= (gint) pos)
+      demux->last_keyframe++;
+  }
+  entry = &g_array_index (index, TSDemuxKeyframe, pos);
+
+  /* we went from the previous entry straight to this one */
+  if (demux->last_keyframe != -1 && (guint) demux->last_keyframe + 1 == pos)
+    entry->follows = TRUE;
+  demux->last_keyframe = pos;
+}
+
+/* Looks up the offset of the last keyframe at or before @ts. This only
+ * succeeds if the keyframe that follows it is known to be the next one of
+ * the stream and comes after @ts */
+static gboolean
+gst_ts_demux_keyframe_index_lookup (GstTSDemux * demux, GstClockTime ts,
+    guint64 * offset)
+{
+  GArray *index = demux->keyframe_index;
+  TSDemuxKeyframe *next;
+  guint pos;
+
+  pos = gst_ts_demux_keyframe_index_search (demux, ts + 1);
+  if (pos == 0 || pos == index->len)
+    return FALSE;
+
+  next = &g_array_index (index, TSDemuxKeyframe, pos);
+  if (!next->follows)
+    return FALSE;
+
+  *offset = g_array_index (index, TSDemuxKeyframe, pos - 1).offset;
+  return TRUE;
+}
+
 static gboolean
 gst_ts_demux_adjust_seek_offset_for_keyframe (TSDemuxStream * stream,
     guint8 * data, guint64 size)
@@ -836,13 +932,19 @@ gst_ts_demux_do_seek (MpegTSBase * base, GstEvent * event)
   GST_DEBUG_OBJECT (demux, "configuring seek");
 
   if (start_type != GST_SEEK_TYPE_NONE) {
-    start_offset =
-        mpegts_packetizer_ts_to_offset (base->packetizer, MAX (0,
-            start - SEEK_TIMESTAMP_OFFSET), demux->program->pcr_pid);
+    if (gst_ts_demux_keyframe_index_lookup (demux, start, &start_offset)) {
+      /* we know where the keyframe is, go there directly */
+      GST_DEBUG_OBJECT (demux, "indexed keyframe at offset %" G_GUINT64_FORMAT,
+          start_offset);
+    } else {
+      start_offset =
+          mpegts_packetizer_ts_to_offset (base->packetizer, MAX (0,
+              start - SEEK_TIMESTAMP_OFFSET), demux->program->pcr_pid);
 
-    if (G_UNLIKELY (start_offset == -1)) {
-      GST_WARNING ("Couldn't convert start position to an offset");
-      goto done;
+      if (G_UNLIKELY (start_offset == -1)) {
+        GST_WARNING ("Couldn't convert start position to an offset");
+        goto done;
+      }
     }
   } else {
     for (tmp = demux->program->stream_list; tmp; tmp = tmp->next) {
@@ -863,6 +965,7 @@ gst_ts_demux_do_seek (MpegTSBase * base, GstEvent * event)
   /* record offset and rate */
   base->seek_offset = start_offset;
   demux->last_seek_offset = base->seek_offset;
+  demux->last_keyframe = -1;
   demux->rate = rate;
   res = GST_FLOW_OK;
 
@@ -1578,6 +1681,7 @@ done:
     if (sparse)
       gst_event_set_stream_flags (event, GST_STREAM_FLAG_SPARSE);
     stream->sparse = sparse;
+    stream->is_video = is_video;
 
     gst_pad_push_event (pad, event);
     g_free (stream_id);
@@ -1799,6 +1903,11 @@ gst_ts_demux_program_started (MpegTSBase * base, MpegTSBaseProgram * program)
     demux->program_number = program->program_number;
     demux->program = program;
 
+    /* the keyframe index is for the previous program */
+    g_array_set_size (demux->keyframe_index, 0);
+    demux->keyframe_index_pid = -1;
+    demux->last_keyframe = -1;
+
     /* If this is not the initial program, we need to calculate
      * a new segment */
     if (demux->segment_event) {
@@ -2179,6 +2288,16 @@ gst_ts_demux_queue_data (GstTSDemux * demux, TSDemuxStream * stream,
 
       /* parse the header */
       gst_ts_demux_parse_pes_header (demux, stream, data, size, packet->offset);
+
+      /* index the random access points of the first video stream */
+      if (G_UNLIKELY (demux->keyframe_index_pid == -1) && stream->is_video &&
+          ((MpegTSBase *) demux)->mode != BASE_MODE_PUSHING)
+        demux->keyframe_index_pid = stream->stream.pid;
+      if ((packet->afc_flags & MPEGTS_AFC_RANDOM_ACCES_FLAGS) &&
+          stream->stream.pid == demux->keyframe_index_pid &&
+          stream->state == PENDING_PACKET_BUFFER &&
+          GST_CLOCK_TIME_IS_VALID (stream->pts))
+        gst_ts_demux_record_keyframe (demux, stream->pts, packet->offset);
       break;
     }
     case PENDING_PACKET_BUFFER:
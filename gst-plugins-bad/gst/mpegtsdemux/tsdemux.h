@@ -86,6 +86,13 @@ struct _GstTSDemux
 
   /* Used when seeking for a keyframe to go backward in the stream */
   guint64 last_seek_offset;
+
+  /* Keyframes seen while playing (pull mode), sorted TSDemuxKeyframe */
+  GArray *keyframe_index;
+  /* pid of the video stream the index is built from, -1 if none yet */
+  gint keyframe_index_pid;
+  /* position of the last recorded keyframe in the index, -1 after seeks */
+  gint last_keyframe;
 };
 
 struct _GstTSDemuxClass
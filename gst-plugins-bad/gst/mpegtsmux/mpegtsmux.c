@@ -114,6 +114,66 @@ enum
 };
 
 #define MPEGTSMUX_DEFAULT_ALIGNMENT    -1
+
+/* packets per pooled output buffer if no alignment is requested,
+ * the same as alignment=7 so a buffer fits an ethernet MTU */
+#define MPEGTSMUX_DEFAULT_CHUNK_PACKETS 7
+
+/* Pool for the output buffers. Those can be pushed with only part of their
+ * packets written, so their full size is restored when they come back,
+ * otherwise the base class would discard them. */
+typedef struct
+{
+  GstBufferPool parent;
+
+  guint size;
+} MpegTsMuxPool;
+
+typedef struct
+{
+  GstBufferPoolClass parent_class;
+} MpegTsMuxPoolClass;
+
+static GType mpegtsmux_pool_get_type (void);
+G_DEFINE_TYPE (MpegTsMuxPool, mpegtsmux_pool, GST_TYPE_BUFFER_POOL);
+
+static gboolean
+mpegtsmux_pool_set_config (GstBufferPool * pool, GstStructure * config)
+{
+  MpegTsMuxPool *mpool = (MpegTsMuxPool *) pool;
+
+  if (!gst_buffer_pool_config_get_params (config, NULL, &mpool->size, NULL,
+          NULL))
+    return FALSE;
+
+  return GST_BUFFER_POOL_CLASS (mpegtsmux_pool_parent_class)->set_config (pool,
+      config);
+}
+
+static void
+mpegtsmux_pool_reset_buffer (GstBufferPool * pool, GstBuffer * buffer)
+{
+  MpegTsMuxPool *mpool = (MpegTsMuxPool *) pool;
+
+  gst_buffer_resize (buffer, 0, mpool->size);
+
+  GST_BUFFER_POOL_CLASS (mpegtsmux_pool_parent_class)->reset_buffer (pool,
+      buffer);
+}
+
+static void
+mpegtsmux_pool_class_init (MpegTsMuxPoolClass * klass)
+{
+  GstBufferPoolClass *pool_class = GST_BUFFER_POOL_CLASS (klass);
+
+  pool_class->set_config = mpegtsmux_pool_set_config;
+  pool_class->reset_buffer = mpegtsmux_pool_reset_buffer;
+}
+
+static void
+mpegtsmux_pool_init (MpegTsMuxPool * pool)
+{
+}
 #define MPEGTSMUX_DEFAULT_M2TS         FALSE
 
 static GstStaticPadTemplate mpegtsmux_sink_factory =
@@ -173,6 +233,7 @@ static void release_buffer_cb (guint8 * data, void *user_data);
 static GstFlowReturn mpegtsmux_collect_packet (MpegTsMux * mux,
     GstBuffer * buf);
 static GstFlowReturn mpegtsmux_push_packets (MpegTsMux * mux, gboolean force);
+static void mpegtsmux_finish_chunk (MpegTsMux * mux);
 static gboolean new_packet_m2ts (MpegTsMux * mux, GstBuffer * buf,
     gint64 new_pcr);
 
@@ -409,6 +470,13 @@ mpegtsmux_reset (MpegTsMux * mux, gboolean alloc)
 
   gst_event_replace (&mux->force_key_unit_event, NULL);
   gst_buffer_replace (&mux->out_buffer, NULL);
+  mux->out_packets = NULL;
+  mux->out_n_packets = 0;
+  if (mux->out_pool) {
+    gst_buffer_pool_set_active (mux->out_pool, FALSE);
+    gst_object_unref (mux->out_pool);
+    mux->out_pool = NULL;
+  }
 
   if (mux->collect) {
     GST_COLLECT_PADS_STREAM_LOCK (mux->collect);
@@ -1439,6 +1507,22 @@ mpegtsmux_release_pad (GstElement * element, GstPad * pad)
   gst_element_remove_pad (element, pad);
 }
 
+static void
+new_packet_set_flags (MpegTsMux * mux, GstBuffer * buf)
+{
+  if (mux->is_header) {
+    GST_LOG_OBJECT (mux, "marking as header buffer");
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_HEADER);
+  }
+  if (mux->is_delta) {
+    GST_LOG_OBJECT (mux, "marking as delta unit");
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+  } else {
+    GST_DEBUG_OBJECT (mux, "marking as non-delta unit");
+    mux->is_delta = TRUE;
+  }
+}
+
 static void
 new_packet_common_init (MpegTsMux * mux, GstBuffer * buf, guint8 * data,
     guint len)
@@ -1468,37 +1552,35 @@ new_packet_common_init (MpegTsMux * mux, GstBuffer * buf, guint8 * data,
     }
   }
 
-  if (buf) {
-    if (mux->is_header) {
-      GST_LOG_OBJECT (mux, "marking as header buffer");
-      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_HEADER);
-    }
-    if (mux->is_delta) {
-      GST_LOG_OBJECT (mux, "marking as delta unit");
-      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
-    } else {
-      GST_DEBUG_OBJECT (mux, "marking as non-delta unit");
-      mux->is_delta = TRUE;
-    }
-  }
+  if (buf)
+    new_packet_set_flags (mux, buf);
+}
+
+/* number of packets per output buffer, 0 for any */
+static gint
+mpegtsmux_get_alignment (MpegTsMux * mux)
+{
+  if (mux->alignment >= 0)
+    return mux->alignment;
+
+  return mux->m2ts_mode ? 32 : 0;
 }
 
 static GstFlowReturn
 mpegtsmux_push_packets (MpegTsMux * mux, gboolean force)
 {
   GstBufferList *buffer_list;
-  gint align = mux->alignment;
+  gint align = mpegtsmux_get_alignment (mux);
   gint av, packet_size;
 
-  if (mux->m2ts_mode) {
+  if (mux->m2ts_mode)
     packet_size = M2TS_PACKET_LENGTH;
-    if (align < 0)
-      align = 32;
-  } else {
+  else
     packet_size = NORMAL_TS_PACKET_LENGTH;
-    if (align < 0)
-      align = 0;
-  }
+
+  /* without alignment, everything written so far goes out now */
+  if (mux->out_buffer && (force || align == 0))
+    mpegtsmux_finish_chunk (mux);
 
   av = gst_adapter_available (mux->out_adapter);
   GST_LOG_OBJECT (mux, "align %d, av %d", align, av);
@@ -1697,13 +1779,177 @@ exit:
   return TRUE;
 }
 
+static GQuark
+mpegtsmux_packets_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("GstMpegTsMuxPackets");
+
+  return quark;
+}
+
+/* Creates a buffer for each packet slot of a pooled output buffer, wrapping
+ * the output buffer's data. These are kept on the output buffer, which the
+ * pool recycles, so tsmux can write packets in place without anything being
+ * allocated per packet. The pool memory is plain system memory whose data
+ * pointer is stable for the lifetime of the buffer. */
+static GPtrArray *
+mpegtsmux_get_packet_views (MpegTsMux * mux, GstBuffer * buf)
+{
+  GPtrArray *packets;
+  GstMapInfo map;
+  guint i;
+
+  packets = gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (buf),
+      mpegtsmux_packets_quark ());
+  if (packets)
+    return packets;
+
+  if (!gst_buffer_map (buf, &map, GST_MAP_WRITE))
+    return NULL;
+
+  packets = g_ptr_array_new_full (mux->out_chunk_packets,
+      (GDestroyNotify) gst_buffer_unref);
+  for (i = 0; i < mux->out_chunk_packets; i++) {
+    g_ptr_array_add (packets, gst_buffer_new_wrapped_full (0,
+            map.data + i * NORMAL_TS_PACKET_LENGTH, NORMAL_TS_PACKET_LENGTH, 0,
+            NORMAL_TS_PACKET_LENGTH, NULL, NULL));
+  }
+  gst_buffer_unmap (buf, &map);
+
+  gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (buf),
+      mpegtsmux_packets_quark (), packets,
+      (GDestroyNotify) g_ptr_array_unref);
+
+  return packets;
+}
+
+/* makes sure there is an output buffer with room for the next packet */
+static gboolean
+mpegtsmux_prepare_chunk (MpegTsMux * mux)
+{
+  /* without alignment, a keyframe starts a new output buffer so that buffer
+   * flags keep marking where decoding can start */
+  if (mux->out_buffer && !mux->is_delta && mux->out_n_packets > 0 &&
+      mpegtsmux_get_alignment (mux) == 0)
+    mpegtsmux_finish_chunk (mux);
+
+  if (mux->out_buffer)
+    return TRUE;
+
+  if (!mux->out_pool) {
+    GstStructure *config;
+    gint align = mpegtsmux_get_alignment (mux);
+
+    mux->out_chunk_packets =
+        align > 0 ? align : MPEGTSMUX_DEFAULT_CHUNK_PACKETS;
+
+    mux->out_pool = g_object_new (mpegtsmux_pool_get_type (), NULL);
+    config = gst_buffer_pool_get_config (mux->out_pool);
+    gst_buffer_pool_config_set_params (config, NULL,
+        mux->out_chunk_packets * NORMAL_TS_PACKET_LENGTH, 0, 0);
+    if (!gst_buffer_pool_set_config (mux->out_pool, config) ||
+        !gst_buffer_pool_set_active (mux->out_pool, TRUE)) {
+      GST_ERROR_OBJECT (mux, "failed to set up output buffer pool");
+      gst_object_unref (mux->out_pool);
+      mux->out_pool = NULL;
+      return FALSE;
+    }
+    GST_DEBUG_OBJECT (mux, "writing %u packets per output buffer",
+        mux->out_chunk_packets);
+  }
+
+  if (gst_buffer_pool_acquire_buffer (mux->out_pool, &mux->out_buffer,
+          NULL) != GST_FLOW_OK)
+    return FALSE;
+
+  mux->out_packets = mpegtsmux_get_packet_views (mux, mux->out_buffer);
+  if (!mux->out_packets) {
+    gst_buffer_replace (&mux->out_buffer, NULL);
+    return FALSE;
+  }
+  mux->out_n_packets = 0;
+
+  return TRUE;
+}
+
+/* hands the current output buffer, with the packets written so far,
+ * over for pushing */
+static void
+mpegtsmux_finish_chunk (MpegTsMux * mux)
+{
+  GstBuffer *buf = mux->out_buffer;
+
+  if (!buf)
+    return;
+
+  mux->out_buffer = NULL;
+  mux->out_packets = NULL;
+
+  if (mux->out_n_packets == 0) {
+    gst_buffer_unref (buf);
+    return;
+  }
+
+  gst_buffer_resize (buf, 0, mux->out_n_packets * NORMAL_TS_PACKET_LENGTH);
+  mux->out_n_packets = 0;
+
+  mpegtsmux_collect_packet (mux, buf);
+}
+
+/* adds a plain TS packet to the current output buffer */
+static gboolean
+new_packet_chunked (MpegTsMux * mux, GstBuffer * buf)
+{
+  GstBuffer *slot;
+  GstMapInfo map;
+
+  /* packets from alloc_packet_cb were written in place,
+   * anything else (sections) is copied into the next slot */
+  if (!mux->out_buffer ||
+      buf != g_ptr_array_index (mux->out_packets, mux->out_n_packets)) {
+    if (!mpegtsmux_prepare_chunk (mux)) {
+      gst_buffer_unref (buf);
+      return FALSE;
+    }
+    slot = g_ptr_array_index (mux->out_packets, mux->out_n_packets);
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    gst_buffer_fill (slot, 0, map.data, NORMAL_TS_PACKET_LENGTH);
+    gst_buffer_unmap (buf, &map);
+  } else {
+    slot = buf;
+  }
+
+  if (mux->out_n_packets == 0) {
+    GST_BUFFER_PTS (mux->out_buffer) = mux->last_ts;
+    new_packet_set_flags (mux, mux->out_buffer);
+  } else if (!mux->is_delta) {
+    /* keyframe starts inside an aligned output buffer */
+    mux->is_delta = TRUE;
+  }
+
+  /* collect streamheaders */
+  gst_buffer_map (slot, &map, GST_MAP_READ);
+  new_packet_common_init (mux, NULL, map.data, map.size);
+  gst_buffer_unmap (slot, &map);
+
+  gst_buffer_unref (buf);
+
+  if (++mux->out_n_packets == mux->out_chunk_packets)
+    mpegtsmux_finish_chunk (mux);
+
+  return TRUE;
+}
+
 /* Called when the TsMux has prepared a packet for output. Return FALSE
  * on error */
 static gboolean
 new_packet_cb (GstBuffer * buf, void *user_data, gint64 new_pcr)
 {
   MpegTsMux *mux = (MpegTsMux *) user_data;
-  gint offset = 0;
+  gint offset = 4;
   GstMapInfo map;
 
 #if 0
@@ -1711,17 +1957,15 @@ new_packet_cb (GstBuffer * buf, void *user_data, gint64 new_pcr)
   mux->spn_count++;
 #endif
 
-  if (mux->m2ts_mode) {
-    offset = 4;
-    gst_buffer_set_size (buf, NORMAL_TS_PACKET_LENGTH + offset);
-  }
+  if (!mux->m2ts_mode)
+    return new_packet_chunked (mux, buf);
+
+  gst_buffer_set_size (buf, NORMAL_TS_PACKET_LENGTH + offset);
 
   gst_buffer_map (buf, &map, GST_MAP_READWRITE);
 
-  if (offset) {
-    /* there should be a better way to do this */
-    memmove (map.data + offset, map.data, map.size - offset);
-  }
+  /* there should be a better way to do this */
+  memmove (map.data + offset, map.data, map.size - offset);
 
   GST_BUFFER_PTS (buf) = mux->last_ts;
   /* do common init (flags and streamheaders) */
@@ -1730,12 +1974,7 @@ new_packet_cb (GstBuffer * buf, void *user_data, gint64 new_pcr)
   gst_buffer_unmap (buf, &map);
 
   /* all is meant for downstream, including any prefix */
-  if (offset)
-    return new_packet_m2ts (mux, buf, new_pcr);
-  else
-    mpegtsmux_collect_packet (mux, buf);
-
-  return TRUE;
+  return new_packet_m2ts (mux, buf, new_pcr);
 }
 
 /* called when TsMux needs new packet to write into */
@@ -1744,10 +1983,18 @@ alloc_packet_cb (GstBuffer ** _buf, void *user_data)
 {
   MpegTsMux *mux = (MpegTsMux *) user_data;
   GstBuffer *buf;
-  gint offset = 0;
+  gint offset = 4;
 
-  if (mux->m2ts_mode == TRUE)
-    offset = 4;
+  if (!mux->m2ts_mode) {
+    /* hand out the next packet slot of the output buffer */
+    if (!mpegtsmux_prepare_chunk (mux)) {
+      *_buf = NULL;
+      return;
+    }
+    *_buf = gst_buffer_ref (g_ptr_array_index (mux->out_packets,
+            mux->out_n_packets));
+    return;
+  }
 
   buf = gst_buffer_new_and_alloc (NORMAL_TS_PACKET_LENGTH + offset);
   gst_buffer_set_size (buf, NORMAL_TS_PACKET_LENGTH);
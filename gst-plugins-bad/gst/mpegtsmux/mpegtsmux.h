@@ -164,6 +164,13 @@ struct MpegTsMux {
   GstAdapter *out_adapter;
   GstBuffer *out_buffer;
 
+  /* plain TS packets are written in place into pooled output buffers
+   * of out_chunk_packets packets each */
+  GstBufferPool *out_pool;
+  GPtrArray *out_packets;     /* per-packet views of out_buffer */
+  guint out_n_packets;
+  guint out_chunk_packets;
+
 #if 0
   /* SPN/PTS index handling */
   GstIndex *element_index;
@@ -79,6 +79,7 @@ gst_mxf_demux_handle_index_table_segment (GstMXFDemux * demux,
     const MXFUL * key, GstBuffer * buffer, guint64 offset);
 
 static void collect_index_table_segments (GstMXFDemux * demux);
+static void gst_mxf_demux_update_index_tables (GstMXFDemux * demux);
 
 GType gst_mxf_demux_pad_get_type (void);
 G_DEFINE_TYPE (GstMXFDemuxPad, gst_mxf_demux_pad, GST_TYPE_PAD);
@@ -1607,6 +1608,58 @@ gst_mxf_demux_pad_set_component (GstMXFDemux * demux, GstMXFDemuxPad * pad,
   return ret;
 }
 
+static GstMXFDemuxIndexTable *
+gst_mxf_demux_find_index_table (GstMXFDemux * demux,
+    GstMXFDemuxEssenceTrack * etrack)
+{
+  GList *l;
+
+  for (l = demux->index_tables; l; l = l->next) {
+    GstMXFDemuxIndexTable *tmp = l->data;
+
+    if (tmp->body_sid == etrack->body_sid
+        && tmp->index_sid == etrack->index_sid)
+      return tmp;
+  }
+
+  return NULL;
+}
+
+/* Offsets of the known edit units are increasing, so the edit unit at
+ * @offset can be found by bisecting over the known entries */
+static gint64
+find_edit_unit_for_offset (GArray * offsets, guint64 offset)
+{
+  gint64 low, high;
+
+  if (!offsets || offsets->len == 0)
+    return -1;
+
+  low = 0;
+  high = offsets->len - 1;
+  while (low <= high) {
+    gint64 mid = low + (high - low) / 2;
+    gint64 probe = mid;
+    GstMXFDemuxIndex *idx;
+
+    /* skip over unknown entries */
+    idx = &g_array_index (offsets, GstMXFDemuxIndex, probe);
+    while (idx->offset == 0 && probe < high) {
+      probe++;
+      idx = &g_array_index (offsets, GstMXFDemuxIndex, probe);
+    }
+
+    if (idx->offset == offset)
+      return probe;
+    else if (idx->offset != 0 && idx->offset < offset)
+      low = probe + 1;
+    else
+      high = mid - 1;
+  }
+
+  return -1;
+}
+
 static GstFlowReturn
 gst_mxf_demux_handle_generic_container_essence_element (GstMXFDemux * demux,
     const MXFUL * key, GstBuffer * buffer, gboolean peek)
@@ -1669,19 +1722,17 @@ gst_mxf_demux_handle_generic_container_essence_element (GstMXFDemux * demux,
   }
 
   if (etrack->position == -1) {
+    GstMXFDemuxIndexTable *index_table;
+
     GST_DEBUG_OBJECT (demux,
         "Unknown essence track position, looking into index");
-    if (etrack->offsets) {
-      for (i = 0; i < etrack->offsets->len; i++) {
-        GstMXFDemuxIndex *idx =
-            &g_array_index (etrack->offsets, GstMXFDemuxIndex, i);
+    etrack->position = find_edit_unit_for_offset (etrack->offsets,
+        demux->offset - demux->run_in);
 
-        if (idx->offset != 0 && idx->offset == demux->offset - demux->run_in) {
-          etrack->position = i;
-          break;
-        }
-      }
-    }
+    if (etrack->position == -1
+        && (index_table = gst_mxf_demux_find_index_table (demux, etrack)))
+      etrack->position = find_edit_unit_for_offset (index_table->offsets,
+          demux->offset - demux->run_in);
 
     if (etrack->position == -1) {
       GST_WARNING_OBJECT (demux, "Essence track position not in index");
@@ -1730,18 +1781,8 @@ gst_mxf_demux_handle_generic_container_essence_element (GstMXFDemux * demux,
 
   /* Prefer keyframe information from index tables over everything else */
   if (demux->index_tables && outbuf) {
-    GList *l;
-    GstMXFDemuxIndexTable *index_table = NULL;
-
-    for (l = demux->index_tables; l; l = l->next) {
-      GstMXFDemuxIndexTable *tmp = l->data;
-
-      if (tmp->body_sid == etrack->body_sid
-          && tmp->index_sid == etrack->index_sid) {
-        index_table = tmp;
-        break;
-      }
-    }
+    GstMXFDemuxIndexTable *index_table =
+        gst_mxf_demux_find_index_table (demux, etrack);
 
     if (index_table && index_table->offsets->len > etrack->position) {
       GstMXFDemuxIndex *index =
@@ -2673,19 +2714,9 @@ gst_mxf_demux_find_essence_element (GstMXFDemux * demux,
       " of track %u with body_sid %u (keyframe %d)", *position,
       etrack->track_number, etrack->body_sid, keyframe);
 
-  if (demux->index_tables) {
-    GList *l;
-
-    for (l = demux->index_tables; l; l = l->next) {
-      GstMXFDemuxIndexTable *tmp = l->data;
-
-      if (tmp->body_sid == etrack->body_sid
-          && tmp->index_sid == etrack->index_sid) {
-        index_table = tmp;
-        break;
-      }
-    }
-  }
+  /* index table segments found since the last lookup extend the index */
+  gst_mxf_demux_update_index_tables (demux);
+  index_table = gst_mxf_demux_find_index_table (demux, etrack);
 
 from_index:
 
@@ -2815,6 +2846,37 @@ from_index:
       } else if (G_UNLIKELY (ret == GST_FLOW_OK)) {
         ret = gst_mxf_demux_handle_klv_packet (demux, &key, buffer, TRUE);
         gst_buffer_unref (buffer);
+
+        /* A growing file or one without random index pack has its index
+         * table segments in the body partitions. Continue from the indexed
+         * edit unit instead of going through all essence up to it */
+        if (ret == GST_FLOW_OK && mxf_is_index_table_segment (&key)) {
+          gint64 tmp_position = *position;
+
+          gst_mxf_demux_update_index_tables (demux);
+          if (!index_table)
+            index_table = gst_mxf_demux_find_index_table (demux, etrack);
+
+          offset = index_table ? find_closest_offset (index_table->offsets,
+              &tmp_position, TRUE) : -1;
+          if (offset != -1 && offset + demux->run_in > demux->offset
+              && tmp_position > etrack->position) {
+            GST_DEBUG_OBJECT (demux,
+                "Continuing with edit unit %" G_GINT64_FORMAT
+                " from index at offset %" G_GUINT64_FORMAT, tmp_position,
+                offset);
+            demux->offset = offset + demux->run_in;
+            gst_mxf_demux_set_partition_for_offset (demux, demux->offset);
+            for (i = 0; i < demux->essence_tracks->len; i++) {
+              GstMXFDemuxEssenceTrack *t =
+                  &g_array_index (demux->essence_tracks,
+                  GstMXFDemuxEssenceTrack, i);
+
+              t->position = (t == etrack) ? tmp_position : -1;
+            }
+            continue;
+          }
+        }
       }
 
       /* If we found the position read it from the index again */
@@ -3508,21 +3570,20 @@ no_new_offset:
 static void
 collect_index_table_segments (GstMXFDemux * demux)
 {
-  GList *l;
   guint i;
   guint64 old_offset = demux->offset;
   GstMXFDemuxPartition *old_partition = demux->current_partition;
 
-  if (!demux->random_index_pack)
-    return;
-
-  for (i = 0; i < demux->random_index_pack->len; i++) {
+  /* Without random index pack only the segments seen so far are used,
+   * further ones are added while going through the file */
+  for (i = 0; demux->random_index_pack && i < demux->random_index_pack->len;
+      i++) {
     MXFRandomIndexPackEntry *e =
         &g_array_index (demux->random_index_pack, MXFRandomIndexPackEntry, i);
 
     if (e->offset < demux->run_in) {
       GST_ERROR_OBJECT (demux, "Invalid random index pack entry");
-      return;
+      break;
     }
 
     demux->offset = e->offset;
@@ -3532,6 +3593,19 @@ collect_index_table_segments (GstMXFDemux * demux)
   demux->offset = old_offset;
   demux->current_partition = old_partition;
 
+  gst_mxf_demux_update_index_tables (demux);
+}
+
+/* Adds the pending index table segments to the index tables */
+static void
+gst_mxf_demux_update_index_tables (GstMXFDemux * demux)
+{
+  GList *l;
+  guint i;
+
+  if (!demux->pending_index_table_segments)
+    return;
+
   for (l = demux->pending_index_table_segments; l; l = l->next) {
     MXFIndexTableSegment *segment = l->data;
     GstMXFDemuxIndexTable *t = NULL;
@@ -56,10 +56,12 @@ typedef struct
   guint64 essence_container_offset;
 } GstMXFDemuxPartition;
 
+/* One entry per edit unit, an offset of 0 means unknown. Kept at 8 bytes
+ * as there is one for every frame of long files */
 typedef struct
 {
-  guint64 offset;
-  gboolean keyframe;
+  guint64 offset:63;
+  guint64 keyframe:1;
 } GstMXFDemuxIndex;
 
 typedef struct
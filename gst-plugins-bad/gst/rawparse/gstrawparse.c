@@ -333,7 +333,11 @@ gst_raw_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   }
 
   while (buffersize > 0 && gst_adapter_available (rp->adapter) >= buffersize) {
-    buffer = gst_adapter_take_buffer (rp->adapter, buffersize);
+    /* frames that span several input buffers are output as a buffer with
+     * several memories instead of merging them; for video the plane offsets
+     * are described by the video meta so downstream only has to map the
+     * memories of each plane */
+    buffer = gst_adapter_take_buffer_fast (rp->adapter, buffersize);
 
     ret = gst_raw_parse_push_buffer (rp, buffer);
     if (ret != GST_FLOW_OK)
@@ -537,6 +537,21 @@ gst_video_parse_copy_frame (GstVideoParse * vp, GstBuffer * dest,
   return ret;
 }
 
+static GstVideoMeta *
+gst_video_parse_add_video_meta (GstVideoParse * vp, GstBuffer * buffer)
+{
+  GstVideoInfo *info = &vp->info;
+  GstVideoFrameFlags flags = GST_VIDEO_FRAME_FLAG_NONE;
+
+  if (vp->interlaced && vp->top_field_first)
+    flags = GST_VIDEO_FRAME_FLAG_TFF;
+
+  return gst_buffer_add_video_meta_full (buffer, flags,
+      GST_VIDEO_INFO_FORMAT (info), GST_VIDEO_INFO_WIDTH (info),
+      GST_VIDEO_INFO_HEIGHT (info), GST_VIDEO_INFO_N_PLANES (info),
+      info->offset, info->stride);
+}
+
 static void
 gst_video_parse_pre_push_buffer (GstRawParse * rp, GstBuffer * buffer)
 {
@@ -545,6 +560,7 @@ gst_video_parse_pre_push_buffer (GstRawParse * rp, GstBuffer * buffer)
   if (vp->do_copy) {
     GstVideoInfo info;
     GstBuffer *outbuf;
+    GstVideoMeta *meta;
 
     gst_video_info_init (&info);
     gst_video_info_set_format (&info, vp->format, vp->width, vp->height);
@@ -553,21 +569,19 @@ gst_video_parse_pre_push_buffer (GstRawParse * rp, GstBuffer * buffer)
 
     outbuf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
 
+    /* the frame can be made of several memories when it spanned input
+     * buffers, with a meta only the memories of each plane are mapped
+     * instead of merging the whole frame first */
+    meta = gst_video_parse_add_video_meta (vp, buffer);
+
     if (!gst_video_parse_copy_frame (vp, outbuf, &info, buffer, &vp->info))
       GST_WARNING_OBJECT (vp, "failed to copy frame");
 
+    gst_buffer_remove_meta (buffer, (GstMeta *) meta);
     gst_buffer_replace_all_memory (buffer, gst_buffer_get_all_memory (outbuf));
     gst_buffer_unref (outbuf);
   } else {
-    GstVideoInfo *info = &vp->info;
-    GstVideoFrameFlags flags = GST_VIDEO_FRAME_FLAG_NONE;
-
-    if (vp->interlaced && vp->top_field_first)
-      flags = GST_VIDEO_FRAME_FLAG_TFF;
-
-    gst_buffer_add_video_meta_full (buffer, flags, GST_VIDEO_INFO_FORMAT (info),
-        GST_VIDEO_INFO_WIDTH (info), GST_VIDEO_INFO_HEIGHT (info),
-        GST_VIDEO_INFO_N_PLANES (info), info->offset, info->stride);
+    gst_video_parse_add_video_meta (vp, buffer);
   }
 
   if (vp->interlaced) {
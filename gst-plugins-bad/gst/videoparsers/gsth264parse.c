@@ -439,6 +439,34 @@ gst_h264_parse_wrap_nal (GstH264Parse * h264parse, guint format, guint8 * data,
   return buf;
 }
 
+/* like gst_h264_parse_wrap_nal(), but only the prefix is written into new
+ * memory, the NAL itself references the memory of @src */
+static GstBuffer *
+gst_h264_parse_wrap_nal_ref (GstH264Parse * h264parse, guint format,
+    GstBuffer * src, guint offset, guint size)
+{
+  GstBuffer *buf;
+  guint nl = h264parse->nal_length_size;
+  guint32 tmp;
+
+  GST_DEBUG_OBJECT (h264parse, "nal length %d", size);
+
+  if (format == GST_H264_PARSE_FORMAT_AVC
+      || format == GST_H264_PARSE_FORMAT_AVC3) {
+    tmp = GUINT32_TO_BE (size << (32 - 8 * nl));
+  } else {
+    /* same HACK as in gst_h264_parse_wrap_nal() */
+    nl = 4;
+    tmp = GUINT32_TO_BE (1);
+  }
+
+  buf = gst_buffer_new_allocate (NULL, nl, NULL);
+  gst_buffer_fill (buf, 0, &tmp, nl);
+
+  return gst_buffer_append (buf,
+      gst_buffer_copy_region (src, GST_BUFFER_COPY_MEMORY, offset, size));
+}
+
 static void
 gst_h264_parser_store_nal (GstH264Parse * h264parse, guint id,
     GstH264NalUnitType naltype, GstH264NalUnit * nalu)
@@ -826,8 +854,8 @@ gst_h264_parse_process_nal (GstH264Parse * h264parse, GstH264NalUnit * nalu)
       {
         GstH264SliceHdr slice;
 
-        pres = gst_h264_parser_parse_slice_hdr (nalparser, nalu, &slice,
-            FALSE, FALSE);
+        pres = gst_h264_parser_parse_slice_hdr_minimal (nalparser, nalu,
+            &slice);
         GST_DEBUG_OBJECT (h264parse,
             "parse result %d, first MB: %u, slice type: %u",
             pres, slice.first_mb_in_slice, slice.type);
@@ -885,8 +913,12 @@ gst_h264_parse_process_nal (GstH264Parse * h264parse, GstH264NalUnit * nalu)
     GstBuffer *buf;
 
     GST_LOG_OBJECT (h264parse, "collecting NAL in AVC frame");
-    buf = gst_h264_parse_wrap_nal (h264parse, h264parse->format,
-        nalu->data + nalu->offset, nalu->size);
+    if (h264parse->frame_in && nalu->data == h264parse->frame_in_data)
+      buf = gst_h264_parse_wrap_nal_ref (h264parse, h264parse->format,
+          h264parse->frame_in, nalu->offset, nalu->size);
+    else
+      buf = gst_h264_parse_wrap_nal (h264parse, h264parse->format,
+          nalu->data + nalu->offset, nalu->size);
     gst_adapter_push (h264parse->frame_out, buf);
   }
   return TRUE;
@@ -966,6 +998,8 @@ gst_h264_parse_handle_frame_packetized (GstBaseParse * parse,
     buffer = gst_buffer_copy (frame->buffer);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  h264parse->frame_in = buffer;
+  h264parse->frame_in_data = map.data;
 
   left = map.size;
 
@@ -1006,6 +1040,7 @@ gst_h264_parse_handle_frame_packetized (GstBaseParse * parse,
   }
 
   gst_buffer_unmap (buffer, &map);
+  h264parse->frame_in = NULL;
 
   if (!h264parse->split_packetized) {
     gst_h264_parse_parse_frame (parse, frame);
@@ -1063,12 +1098,15 @@ gst_h264_parse_handle_frame (GstBaseParse * parse,
     return gst_h264_parse_handle_frame_packetized (parse, frame);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  h264parse->frame_in = buffer;
+  h264parse->frame_in_data = map.data;
   data = map.data;
   size = map.size;
 
   /* expect at least 3 bytes startcode == sc, and 2 bytes NALU payload */
   if (G_UNLIKELY (size < 5)) {
     gst_buffer_unmap (buffer, &map);
+    h264parse->frame_in = NULL;
     *skipsize = 1;
     return GST_FLOW_OK;
   }
@@ -1220,6 +1258,7 @@ end:
   framesize = nalu.offset + nalu.size;
 
   gst_buffer_unmap (buffer, &map);
+  h264parse->frame_in = NULL;
 
   gst_h264_parse_parse_frame (parse, frame);
 
@@ -1235,6 +1274,7 @@ more:
   /* Fall-through. */
 out:
   gst_buffer_unmap (buffer, &map);
+  h264parse->frame_in = NULL;
   return GST_FLOW_OK;
 
 skip:
@@ -1250,6 +1290,7 @@ skip:
 
 invalid_stream:
   gst_buffer_unmap (buffer, &map);
+  h264parse->frame_in = NULL;
   return GST_FLOW_ERROR;
 }
 
@@ -2076,7 +2117,7 @@ gst_h264_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (av) {
     GstBuffer *buf;
 
-    buf = gst_adapter_take_buffer (h264parse->frame_out, av);
+    buf = gst_adapter_take_buffer_fast (h264parse->frame_out, av);
     gst_buffer_copy_into (buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     gst_buffer_replace (&frame->out_buffer, buf);
     gst_buffer_unref (buf);
@@ -389,6 +389,34 @@ gst_h265_parse_wrap_nal (GstH265Parse * h265parse, guint format, guint8 * data,
   return buf;
 }
 
+/* like gst_h265_parse_wrap_nal(), but only the prefix is written into new
+ * memory, the NAL itself references the memory of @src */
+static GstBuffer *
+gst_h265_parse_wrap_nal_ref (GstH265Parse * h265parse, guint format,
+    GstBuffer * src, guint offset, guint size)
+{
+  GstBuffer *buf;
+  guint nl = h265parse->nal_length_size;
+  guint32 tmp;
+
+  GST_DEBUG_OBJECT (h265parse, "nal length %d", size);
+
+  if (format == GST_H265_PARSE_FORMAT_HVC1
+      || format == GST_H265_PARSE_FORMAT_HEV1) {
+    tmp = GUINT32_TO_BE (size << (32 - 8 * nl));
+  } else {
+    /* same HACK as in gst_h265_parse_wrap_nal() */
+    nl = 4;
+    tmp = GUINT32_TO_BE (1);
+  }
+
+  buf = gst_buffer_new_allocate (NULL, nl, NULL);
+  gst_buffer_fill (buf, 0, &tmp, nl);
+
+  return gst_buffer_append (buf,
+      gst_buffer_copy_region (src, GST_BUFFER_COPY_MEMORY, offset, size));
+}
+
 static void
 gst_h265_parser_store_nal (GstH265Parse * h265parse, guint id,
     GstH265NalUnitType naltype, GstH265NalUnit * nalu)
@@ -612,7 +640,7 @@ gst_h265_parse_process_nal (GstH265Parse * h265parse, GstH265NalUnit * nalu)
     {
       GstH265SliceHdr slice;
 
-      pres = gst_h265_parser_parse_slice_hdr (nalparser, nalu, &slice);
+      pres = gst_h265_parser_parse_slice_hdr_minimal (nalparser, nalu, &slice);
 
       if (pres == GST_H265_PARSER_OK) {
         if (GST_H265_IS_I_SLICE (&slice))
@@ -664,8 +692,12 @@ gst_h265_parse_process_nal (GstH265Parse * h265parse, GstH265NalUnit * nalu)
     GstBuffer *buf;
 
     GST_LOG_OBJECT (h265parse, "collecting NAL in HEVC frame");
-    buf = gst_h265_parse_wrap_nal (h265parse, h265parse->format,
-        nalu->data + nalu->offset, nalu->size);
+    if (h265parse->frame_in && nalu->data == h265parse->frame_in_data)
+      buf = gst_h265_parse_wrap_nal_ref (h265parse, h265parse->format,
+          h265parse->frame_in, nalu->offset, nalu->size);
+    else
+      buf = gst_h265_parse_wrap_nal (h265parse, h265parse->format,
+          nalu->data + nalu->offset, nalu->size);
     gst_adapter_push (h265parse->frame_out, buf);
   }
 }
@@ -743,6 +775,8 @@ gst_h265_parse_handle_frame_packetized (GstBaseParse * parse,
     buffer = gst_buffer_copy (frame->buffer);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  h265parse->frame_in = buffer;
+  h265parse->frame_in_data = map.data;
 
   left = map.size;
 
@@ -783,6 +817,7 @@ gst_h265_parse_handle_frame_packetized (GstBaseParse * parse,
   }
 
   gst_buffer_unmap (buffer, &map);
+  h265parse->frame_in = NULL;
 
   if (!h265parse->split_packetized) {
     gst_h265_parse_parse_frame (parse, frame);
@@ -836,12 +871,15 @@ gst_h265_parse_handle_frame (GstBaseParse * parse,
     return gst_h265_parse_handle_frame_packetized (parse, frame);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  h265parse->frame_in = buffer;
+  h265parse->frame_in_data = map.data;
   data = map.data;
   size = map.size;
 
   /* expect at least 3 bytes startcode == sc, and 3 bytes NALU payload */
   if (G_UNLIKELY (size < 6)) {
     gst_buffer_unmap (buffer, &map);
+    h265parse->frame_in = NULL;
     *skipsize = 1;
     return GST_FLOW_OK;
   }
@@ -996,6 +1034,7 @@ end:
   framesize = nalu.offset + nalu.size;
 
   gst_buffer_unmap (buffer, &map);
+  h265parse->frame_in = NULL;
 
   gst_h265_parse_parse_frame (parse, frame);
 
@@ -1011,6 +1050,7 @@ more:
   /* Fall-through. */
 out:
   gst_buffer_unmap (buffer, &map);
+  h265parse->frame_in = NULL;
   return GST_FLOW_OK;
 
 skip:
@@ -1020,6 +1060,7 @@ skip:
 
 invalid_stream:
   gst_buffer_unmap (buffer, &map);
+  h265parse->frame_in = NULL;
   return GST_FLOW_ERROR;
 }
 
@@ -1651,7 +1692,7 @@ gst_h265_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (av) {
     GstBuffer *buf;
 
-    buf = gst_adapter_take_buffer (h265parse->frame_out, av);
+    buf = gst_adapter_take_buffer_fast (h265parse->frame_out, av);
     gst_buffer_copy_into (buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     gst_buffer_replace (&frame->out_buffer, buf);
     gst_buffer_unref (buf);
@@ -82,6 +82,10 @@ struct _GstH265Parse
   gint idr_pos, sei_pos;
   gboolean update_caps;
   GstAdapter *frame_out;
+  /* input buffer and its mapped data while handling a frame, so that NALs
+   * collected in frame_out can reference its memory */
+  GstBuffer *frame_in;
+  const guint8 *frame_in_data;
   gboolean keyframe;
   gboolean header;
   /* AU state */
@@ -212,6 +212,7 @@ gst_mpeg4vparse_reset (GstMpeg4VParse * mp4vparse)
   mp4vparse->discont = FALSE;
 
   gst_buffer_replace (&mp4vparse->config, NULL);
+  gst_buffer_replace (&mp4vparse->last_config, NULL);
   memset (&mp4vparse->vol, 0, sizeof (mp4vparse->vol));
 }
 
@@ -248,10 +249,11 @@ gst_mpeg4vparse_process_config (GstMpeg4VParse * mp4vparse,
   GstMpeg4VisualObject *vo;
   GstMpeg4VideoObjectLayer vol = { 0 };
 
-  /* only do stuff if something new */
-  if (mp4vparse->config
-      && gst_buffer_get_size (mp4vparse->config) == size
-      && !gst_buffer_memcmp (mp4vparse->config, offset, data, size))
+  /* only do stuff if something new; streams usually repeat the very same
+   * config in front of every GOP */
+  if (mp4vparse->last_config
+      && gst_buffer_get_size (mp4vparse->last_config) == size
+      && !gst_buffer_memcmp (mp4vparse->last_config, 0, data, size))
     return TRUE;
 
   if (mp4vparse->vol_offset < 0) {
@@ -260,6 +262,11 @@ gst_mpeg4vparse_process_config (GstMpeg4VParse * mp4vparse,
     return FALSE;
   }
 
+  if (mp4vparse->last_config != NULL)
+    gst_buffer_unref (mp4vparse->last_config);
+
+  mp4vparse->last_config = gst_buffer_new_wrapped (g_memdup (data, size), size);
+
   vo = mp4vparse->vo_found ? &mp4vparse->vo : NULL;
 
   /* If the parsing fail, we accept the config only if we don't have
@@ -295,10 +302,7 @@ gst_mpeg4vparse_process_config (GstMpeg4VParse * mp4vparse,
   GST_LOG_OBJECT (mp4vparse, "accepting parsed config size %" G_GSIZE_FORMAT,
       size);
 
-  if (mp4vparse->config != NULL)
-    gst_buffer_unref (mp4vparse->config);
-
-  mp4vparse->config = gst_buffer_new_wrapped (g_memdup (data, size), size);
+  gst_buffer_replace (&mp4vparse->config, mp4vparse->last_config);
 
   /* trigger src caps update */
   mp4vparse->update_caps = TRUE;
@@ -62,6 +62,8 @@ struct _GstMpeg4VParse {
   gboolean discont;
 
   GstBuffer *config;
+  /* last config data seen in the stream, whether accepted or not */
+  GstBuffer *last_config;
   GstMpeg4VideoObjectLayer vol;
   gboolean vol_offset;
   const gchar *profile;
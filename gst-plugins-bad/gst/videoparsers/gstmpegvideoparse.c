@@ -262,12 +262,51 @@ gst_mpegv_parse_stop (GstBaseParse * parse)
   return TRUE;
 }
 
+/* TRUE if anything the src caps are built from differs from the given
+ * previous sequence header and extensions */
+static gboolean
+gst_mpegv_parse_caps_fields_changed (GstMpegvParse * mpvparse,
+    const GstMpegVideoSequenceHdr * hdr, const GstMpegVideoSequenceExt * ext,
+    const GstMpegVideoSequenceDisplayExt * dispext, guint flags)
+{
+  const GstMpegVideoSequenceHdr *new_hdr = &mpvparse->sequencehdr;
+
+  if (flags != mpvparse->config_flags)
+    return TRUE;
+
+  if (hdr->width != new_hdr->width || hdr->height != new_hdr->height ||
+      hdr->par_w != new_hdr->par_w || hdr->par_h != new_hdr->par_h ||
+      hdr->fps_n != new_hdr->fps_n || hdr->fps_d != new_hdr->fps_d)
+    return TRUE;
+
+  if ((flags & FLAG_SEQUENCE_EXT) &&
+      (ext->profile_level_escape_bit !=
+          mpvparse->sequenceext.profile_level_escape_bit ||
+          ext->profile != mpvparse->sequenceext.profile ||
+          ext->level != mpvparse->sequenceext.level ||
+          ext->progressive != mpvparse->sequenceext.progressive))
+    return TRUE;
+
+  if ((flags & FLAG_SEQUENCE_DISPLAY_EXT) &&
+      (dispext->display_horizontal_size !=
+          mpvparse->sequencedispext.display_horizontal_size ||
+          dispext->display_vertical_size !=
+          mpvparse->sequencedispext.display_vertical_size))
+    return TRUE;
+
+  return FALSE;
+}
+
 static gboolean
 gst_mpegv_parse_process_config (GstMpegvParse * mpvparse, GstMapInfo * info,
     guint size)
 {
   GstMpegVideoPacket packet;
   guint8 *data_with_prefix;
+  GstMpegVideoSequenceHdr prev_hdr;
+  GstMpegVideoSequenceExt prev_ext;
+  GstMpegVideoSequenceDisplayExt prev_dispext;
+  guint prev_flags;
   gint i;
 
   if (mpvparse->seq_offset < 4) {
@@ -284,15 +323,18 @@ gst_mpegv_parse_process_config (GstMpegvParse * mpvparse, GstMapInfo * info,
      used for codec private data */
   data_with_prefix = (guint8 *) packet.data + packet.offset - 4;
 
-  /* only do stuff if something new; only compare first 8 bytes, changes in
-     quantiser matrix or bitrate don't matter here. Also changing the
-     matrices in codec_data seems to cause problem with decoders */
-  if (mpvparse->config &&
-      gst_buffer_memcmp (mpvparse->config, 0, data_with_prefix, MIN (size,
-              8)) == 0) {
+  /* only do stuff if something new; streams usually repeat the very same
+     sequence header and extensions in front of every GOP */
+  if (mpvparse->config && gst_buffer_get_size (mpvparse->config) == size &&
+      gst_buffer_memcmp (mpvparse->config, 0, data_with_prefix, size) == 0) {
     return TRUE;
   }
 
+  prev_hdr = mpvparse->sequencehdr;
+  prev_ext = mpvparse->sequenceext;
+  prev_dispext = mpvparse->sequencedispext;
+  prev_flags = mpvparse->config_flags;
+
   if (!gst_mpeg_video_packet_parse_sequence_header (&packet,
           &mpvparse->sequencehdr)) {
     GST_DEBUG_OBJECT (mpvparse,
@@ -359,6 +401,17 @@ gst_mpegv_parse_process_config (GstMpegvParse * mpvparse, GstMapInfo * info,
     mpvparse->fps_den = mpvparse->sequencehdr.fps_d;
   }
 
+  /* changes in quantiser matrix or bitrate don't matter here. Also changing
+     the matrices in codec_data seems to cause problem with decoders */
+  if (mpvparse->config == NULL ||
+      gst_mpegv_parse_caps_fields_changed (mpvparse, &prev_hdr, &prev_ext,
+          &prev_dispext, prev_flags)) {
+    /* trigger src caps update */
+    mpvparse->update_caps = TRUE;
+  } else {
+    GST_LOG_OBJECT (mpvparse, "config changed, caps unaffected");
+  }
+
   /* parsing ok, so accept it as new config */
   if (mpvparse->config != NULL)
     gst_buffer_unref (mpvparse->config);
@@ -366,9 +419,6 @@ gst_mpegv_parse_process_config (GstMpegvParse * mpvparse, GstMapInfo * info,
   mpvparse->config = gst_buffer_new_and_alloc (size);
   gst_buffer_fill (mpvparse->config, 0, data_with_prefix, size);
 
-  /* trigger src caps update */
-  mpvparse->update_caps = TRUE;
-
   return TRUE;
 }
 
@@ -72,10 +72,24 @@ static GstFlowReturn gst_yadif_transform (GstBaseTransform * trans,
 enum
 {
   PROP_0,
-  PROP_MODE
+  PROP_MODE,
+  PROP_N_THREADS
 };
 
 #define DEFAULT_MODE GST_DEINTERLACE_MODE_AUTO
+#define DEFAULT_N_THREADS 1
+
+/* bands start on a multiple of this many lines so that they contain the
+ * same fields in all planes, also with vertically subsampled chroma */
+#define BAND_ALIGN 4
+
+typedef struct
+{
+  int parity;
+  int tff;
+  int y_start;
+  int y_end;
+} YadifBand;
 
 /* pad templates */
 
@@ -83,7 +97,7 @@ static GstStaticPadTemplate gst_yadif_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{Y42B,I420,Y444}")
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{Y42B,I420,Y444,NV12,NV21}")
         ",interlace-mode=(string){interleaved,mixed,progressive}")
     );
 
@@ -91,7 +105,7 @@ static GstStaticPadTemplate gst_yadif_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{Y42B,I420,Y444}")
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{Y42B,I420,Y444,NV12,NV21}")
         ",interlace-mode=(string)progressive")
     );
 
@@ -160,11 +174,27 @@ gst_yadif_class_init (GstYadifClass * klass)
           DEFAULT_MODE,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstYadif:n-threads:
+   *
+   * Number of threads used to filter each frame, each thread filtering a
+   * band of lines. 0 uses one thread per processor.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of threads",
+          "Number of threads used to filter a frame (0 = number of processors)",
+          0, G_MAXINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
 gst_yadif_init (GstYadif * yadif)
 {
+  yadif->n_threads = DEFAULT_N_THREADS;
+  g_mutex_init (&yadif->band_lock);
+  g_cond_init (&yadif->band_cond);
 }
 
 void
@@ -177,6 +207,11 @@ gst_yadif_set_property (GObject * object, guint property_id,
     case PROP_MODE:
       yadif->mode = g_value_get_enum (value);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (yadif);
+      yadif->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (yadif);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -193,6 +228,11 @@ gst_yadif_get_property (GObject * object, guint property_id,
     case PROP_MODE:
       g_value_set_enum (value, yadif->mode);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (yadif);
+      g_value_set_uint (value, yadif->n_threads);
+      GST_OBJECT_UNLOCK (yadif);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -212,9 +252,10 @@ gst_yadif_dispose (GObject * object)
 void
 gst_yadif_finalize (GObject * object)
 {
-  /* GstYadif *yadif = GST_YADIF (object); */
+  GstYadif *yadif = GST_YADIF (object);
 
-  /* clean up object here */
+  g_mutex_clear (&yadif->band_lock);
+  g_cond_clear (&yadif->band_cond);
 
   G_OBJECT_CLASS (gst_yadif_parent_class)->finalize (object);
 }
@@ -287,11 +328,93 @@ gst_yadif_start (GstBaseTransform * trans)
 static gboolean
 gst_yadif_stop (GstBaseTransform * trans)
 {
+  GstYadif *yadif = GST_YADIF (trans);
+
+  if (yadif->band_pool) {
+    g_thread_pool_free (yadif->band_pool, FALSE, TRUE);
+    yadif->band_pool = NULL;
+  }
 
   return TRUE;
 }
 
-void yadif_filter (GstYadif * yadif, int parity, int tff);
+static void
+gst_yadif_filter_band_func (YadifBand * band, GstYadif * yadif)
+{
+  yadif_filter (yadif, band->parity, band->tff, band->y_start, band->y_end);
+
+  g_mutex_lock (&yadif->band_lock);
+  if (--yadif->bands_pending == 0)
+    g_cond_signal (&yadif->band_cond);
+  g_mutex_unlock (&yadif->band_lock);
+}
+
+/* filters the frame in bands of lines on the thread pool, the first band is
+ * always filtered by this thread */
+static void
+gst_yadif_filter_frame (GstYadif * yadif, int parity, int tff)
+{
+  YadifBand *bands;
+  GError *err = NULL;
+  guint n_threads, n_bands, i;
+  gint height = GST_VIDEO_INFO_HEIGHT (&yadif->video_info), band_height;
+
+  GST_OBJECT_LOCK (yadif);
+  n_threads = yadif->n_threads;
+  GST_OBJECT_UNLOCK (yadif);
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_threads = MIN (n_threads, height / BAND_ALIGN);
+
+  if (n_threads <= 1) {
+    yadif_filter (yadif, parity, tff, 0, height);
+    return;
+  }
+
+  band_height = GST_ROUND_UP_N ((height + n_threads - 1) / n_threads,
+      BAND_ALIGN);
+  n_bands = (height + band_height - 1) / band_height;
+
+  if (yadif->band_pool == NULL) {
+    yadif->band_pool =
+        g_thread_pool_new ((GFunc) gst_yadif_filter_band_func, yadif,
+        n_bands - 1, FALSE, &err);
+    if (yadif->band_pool == NULL)
+      goto no_pool;
+  } else if (g_thread_pool_get_max_threads (yadif->band_pool) != n_bands - 1) {
+    g_thread_pool_set_max_threads (yadif->band_pool, n_bands - 1, NULL);
+  }
+
+  bands = g_newa (YadifBand, n_bands);
+  for (i = 0; i < n_bands; i++) {
+    bands[i].parity = parity;
+    bands[i].tff = tff;
+    bands[i].y_start = i * band_height;
+    bands[i].y_end = MIN (bands[i].y_start + band_height, height);
+  }
+
+  yadif->bands_pending = n_bands - 1;
+  for (i = 1; i < n_bands; i++)
+    g_thread_pool_push (yadif->band_pool, &bands[i], NULL);
+
+  yadif_filter (yadif, parity, tff, bands[0].y_start, bands[0].y_end);
+
+  g_mutex_lock (&yadif->band_lock);
+  while (yadif->bands_pending > 0)
+    g_cond_wait (&yadif->band_cond, &yadif->band_lock);
+  g_mutex_unlock (&yadif->band_lock);
+  return;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_WARNING_OBJECT (yadif, "could not create worker threads: %s",
+        err->message);
+    g_clear_error (&err);
+    yadif_filter (yadif, parity, tff, 0, height);
+    return;
+  }
+}
 
 static GstFlowReturn
 gst_yadif_transform (GstBaseTransform * trans, GstBuffer * inbuf,
@@ -315,7 +438,7 @@ gst_yadif_transform (GstBaseTransform * trans, GstBuffer * inbuf,
   yadif->next_frame = yadif->cur_frame;
   yadif->prev_frame = yadif->cur_frame;
 
-  yadif_filter (yadif, parity, tff);
+  gst_yadif_filter_frame (yadif, parity, tff);
 
   gst_video_frame_unmap (&yadif->dest_frame);
   gst_video_frame_unmap (&yadif->cur_frame);
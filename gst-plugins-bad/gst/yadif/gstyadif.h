@@ -53,6 +53,13 @@ struct _GstYadif
   GstVideoFrame cur_frame;
   GstVideoFrame next_frame;
   GstVideoFrame dest_frame;
+
+  /* filtering of the frame in bands of lines */
+  guint n_threads;
+  GThreadPool *band_pool;
+  GMutex band_lock;
+  GCond band_cond;
+  guint bands_pending;
 };
 
 struct _GstYadifClass
@@ -62,6 +69,9 @@ struct _GstYadifClass
 
 GType gst_yadif_get_type (void);
 
+void yadif_filter (GstYadif * yadif, int parity, int tff, int y_start,
+    int y_end);
+
 G_END_DECLS
 
 #endif
@@ -38,13 +38,15 @@
 
 #define PERM_RWP AV_PERM_WRITE | AV_PERM_PRESERVE | AV_PERM_REUSE
 
+/* step is the distance between two samples of the same component, 2 for
+ * the interleaved chroma planes of NV12 and NV21 */
 #define CHECK(j)\
-    {   int score = FFABS(cur[mrefs-1+(j)] - cur[prefs-1-(j)])\
-                  + FFABS(cur[mrefs  +(j)] - cur[prefs  -(j)])\
-                  + FFABS(cur[mrefs+1+(j)] - cur[prefs+1-(j)]);\
+    {   int score = FFABS(cur[mrefs-step+(j)*step] - cur[prefs-step-(j)*step])\
+                  + FFABS(cur[mrefs     +(j)*step] - cur[prefs     -(j)*step])\
+                  + FFABS(cur[mrefs+step+(j)*step] - cur[prefs+step-(j)*step]);\
         if (score < spatial_score) {\
             spatial_score= score;\
-            spatial_pred= (cur[mrefs  +(j)] + cur[prefs  -(j)])>>1;\
+            spatial_pred= (cur[mrefs  +(j)*step] + cur[prefs  -(j)*step])>>1;\
 
 #define FILTER \
     for (x = 0;  x < w; x++) { \
@@ -59,8 +61,8 @@
         int spatial_score = -1; \
  \
         if (mrefs > 0 && prefs > 0) { \
-            spatial_score = FFABS(cur[mrefs - 1] - cur[prefs - 1]) + FFABS(c-e) \
-                            + FFABS(cur[mrefs + 1] - cur[prefs + 1]) - 1; \
+            spatial_score = FFABS(cur[mrefs - step] - cur[prefs - step]) + FFABS(c-e) \
+                            + FFABS(cur[mrefs + step] - cur[prefs + step]) - 1; \
  \
             CHECK(-1) CHECK(-2) }} }} \
             CHECK( 1) CHECK( 2) }} }} \
@@ -95,6 +97,19 @@ filter_line_c (guint8 * dst,
     int w, int prefs, int mrefs, int parity, int mode)
 {
   int x;
+  const int step = 1;
+  guint8 *prev2 = parity ? prev : cur;
+  guint8 *next2 = parity ? cur : next;
+
+FILTER}
+
+static void
+filter_line_c_interleaved (guint8 * dst,
+    guint8 * prev, guint8 * cur, guint8 * next,
+    int w, int prefs, int mrefs, int parity, int mode)
+{
+  int x;
+  const int step = 2;
   guint8 *prev2 = parity ? prev : cur;
   guint8 *next2 = parity ? cur : next;
 
@@ -107,6 +122,7 @@ filter_line_c_16bit (guint16 * dst,
     int w, int prefs, int mrefs, int parity, int mode)
 {
   int x;
+  const int step = 1;
   guint16 *prev2 = parity ? prev : cur;
   guint16 *next2 = parity ? cur : next;
   mrefs /= 2;
@@ -115,54 +131,75 @@ filter_line_c_16bit (guint16 * dst,
 FILTER}
 #endif
 
-void yadif_filter (GstYadif * yadif, int parity, int tff);
 #ifdef HAVE_CPU_X86_64
 void filter_line_x86_64 (guint8 * dst,
     guint8 * prev, guint8 * cur, guint8 * next,
     int w, int prefs, int mrefs, int parity, int mode);
 #endif
 
+/* filters the lines from @y_start to @y_end of the luma plane and the
+ * matching lines of the other planes. @y_start and @y_end need to be even in
+ * all planes so that the field parity of the lines doesn't change. */
 void
-yadif_filter (GstYadif * yadif, int parity, int tff)
+yadif_filter (GstYadif * yadif, int parity, int tff, int y_start, int y_end)
 {
-  int y, i;
+  int y, i, comp;
   const GstVideoInfo *vi = &yadif->video_info;
   const GstVideoFormatInfo *vfi = vi->finfo;
 
-  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (vfi); i++) {
-    int w = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (vfi, i, vi->width);
-    int h = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (vfi, i, vi->height);
-    int refs = GST_VIDEO_INFO_COMP_STRIDE (vi, i);
-    int df = GST_VIDEO_INFO_COMP_PSTRIDE (vi, i);
-    guint8 *prev_data = GST_VIDEO_FRAME_COMP_DATA (&yadif->prev_frame, i);
-    guint8 *cur_data = GST_VIDEO_FRAME_COMP_DATA (&yadif->cur_frame, i);
-    guint8 *next_data = GST_VIDEO_FRAME_COMP_DATA (&yadif->next_frame, i);
-    guint8 *dest_data = GST_VIDEO_FRAME_COMP_DATA (&yadif->dest_frame, i);
-
-    for (y = 0; y < h; y++) {
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (vi); i++) {
+    int w, h, start, end, refs, step;
+    guint8 *prev_data, *cur_data, *next_data, *dest_data;
+
+    /* the first component in the plane */
+    for (comp = 0; comp < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (vfi); comp++) {
+      if (GST_VIDEO_FORMAT_INFO_PLANE (vfi, comp) == i)
+        break;
+    }
+
+    /* interleaved planes are filtered as one line of bytes, comparing the
+     * samples of the same component */
+    step = GST_VIDEO_INFO_COMP_PSTRIDE (vi, comp);
+    w = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (vfi, comp, vi->width) * step;
+    h = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (vfi, comp, vi->height);
+    start = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (vfi, comp, y_start);
+    end = y_end >= vi->height ? h :
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (vfi, comp, y_end);
+    refs = GST_VIDEO_INFO_PLANE_STRIDE (vi, i);
+    prev_data = GST_VIDEO_FRAME_PLANE_DATA (&yadif->prev_frame, i);
+    cur_data = GST_VIDEO_FRAME_PLANE_DATA (&yadif->cur_frame, i);
+    next_data = GST_VIDEO_FRAME_PLANE_DATA (&yadif->next_frame, i);
+    dest_data = GST_VIDEO_FRAME_PLANE_DATA (&yadif->dest_frame, i);
+
+    for (y = start; y < end; y++) {
       if ((y ^ parity) & 1) {
         guint8 *prev = prev_data + y * refs;
         guint8 *cur = cur_data + y * refs;
         guint8 *next = next_data + y * refs;
         guint8 *dst = dest_data + y * refs;
         int mode = ((y == 1) || (y + 2 == h)) ? 2 : yadif->mode;
+
+        if (step > 1) {
+          filter_line_c_interleaved (dst, prev, cur, next, w,
+              y + 1 < h ? refs : -refs, y ? -refs : refs, parity ^ tff, mode);
 #if HAVE_CPU_X86_64
-        if (0) {
+        } else if (0) {
           filter_line_c (dst, prev, cur, next, w,
               y + 1 < h ? refs : -refs, y ? -refs : refs, parity ^ tff, mode);
         } else {
           filter_line_x86_64 (dst, prev, cur, next, w,
               y + 1 < h ? refs : -refs, y ? -refs : refs, parity ^ tff, mode);
-        }
 #else
-        filter_line_c (dst, prev, cur, next, w,
-            y + 1 < h ? refs : -refs, y ? -refs : refs, parity ^ tff, mode);
+        } else {
+          filter_line_c (dst, prev, cur, next, w,
+              y + 1 < h ? refs : -refs, y ? -refs : refs, parity ^ tff, mode);
 #endif
+        }
       } else {
         guint8 *dst = dest_data + y * refs;
         guint8 *cur = cur_data + y * refs;
 
-        memcpy (dst, cur, w * df);
+        memcpy (dst, cur, w);
       }
     }
   }
@@ -729,6 +729,166 @@ public:
   }
 };
 
+/* Frame memory for the SDK, taken from a GstBufferPool. Captured frames can
+ * be kept downstream without exhausting the frames of the driver, and the
+ * memory of both captured and output frames is recycled */
+class GStreamerDecklinkMemoryAllocator:public IDeckLinkMemoryAllocator
+{
+private:
+  GMutex m_mutex;
+  gint m_refcount;
+  GstBufferPool *m_pool;
+  guint m_size;
+  /* frame data -> PoolMemory */
+  GHashTable *m_buffers;
+
+  typedef struct
+  {
+    GstBuffer *buffer;
+    GstMapInfo map;
+  } PoolMemory;
+
+  void clear_pool (void)
+  {
+    if (m_pool) {
+      /* buffers that are still in use keep the old pool alive */
+      gst_buffer_pool_set_active (m_pool, FALSE);
+      gst_object_unref (m_pool);
+      m_pool = NULL;
+    }
+  }
+
+public:
+    GStreamerDecklinkMemoryAllocator ()
+  : IDeckLinkMemoryAllocator (), m_refcount (1), m_pool (NULL), m_size (0)
+  {
+    g_mutex_init (&m_mutex);
+    m_buffers = g_hash_table_new (NULL, NULL);
+  }
+
+  virtual ~ GStreamerDecklinkMemoryAllocator ()
+  {
+    clear_pool ();
+    g_hash_table_destroy (m_buffers);
+    g_mutex_clear (&m_mutex);
+  }
+
+  virtual HRESULT STDMETHODCALLTYPE QueryInterface (REFIID, LPVOID *)
+  {
+    return E_NOINTERFACE;
+  }
+
+  virtual ULONG STDMETHODCALLTYPE AddRef (void)
+  {
+    ULONG ret;
+
+    g_mutex_lock (&m_mutex);
+    m_refcount++;
+    ret = m_refcount;
+    g_mutex_unlock (&m_mutex);
+
+    return ret;
+  }
+
+  virtual ULONG STDMETHODCALLTYPE Release (void)
+  {
+    ULONG ret;
+
+    g_mutex_lock (&m_mutex);
+    m_refcount--;
+    ret = m_refcount;
+    g_mutex_unlock (&m_mutex);
+
+
+    if (ret == 0) {
+      delete this;
+    }
+
+    return ret;
+  }
+
+  virtual HRESULT STDMETHODCALLTYPE AllocateBuffer (uint32_t bufferSize,
+      void **allocatedBuffer)
+  {
+    PoolMemory *mem;
+    GstBuffer *buffer;
+
+    g_mutex_lock (&m_mutex);
+
+    if (m_pool == NULL || bufferSize != m_size) {
+      GstStructure *config;
+      GstAllocationParams params = { (GstMemoryFlags) 0, 15, 0, 0 };
+
+      clear_pool ();
+
+      GST_DEBUG ("Creating pool for frames of %u bytes", bufferSize);
+      m_pool = gst_buffer_pool_new ();
+      config = gst_buffer_pool_get_config (m_pool);
+      gst_buffer_pool_config_set_params (config, NULL, bufferSize, 0, 0);
+      gst_buffer_pool_config_set_allocator (config, NULL, &params);
+      if (!gst_buffer_pool_set_config (m_pool, config) ||
+          !gst_buffer_pool_set_active (m_pool, TRUE)) {
+        GST_ERROR ("Failed to configure frame pool");
+        gst_object_unref (m_pool);
+        m_pool = NULL;
+        g_mutex_unlock (&m_mutex);
+        return E_OUTOFMEMORY;
+      }
+      m_size = bufferSize;
+    }
+
+    if (gst_buffer_pool_acquire_buffer (m_pool, &buffer, NULL) != GST_FLOW_OK) {
+      g_mutex_unlock (&m_mutex);
+      return E_OUTOFMEMORY;
+    }
+
+    mem = g_slice_new (PoolMemory);
+    mem->buffer = buffer;
+    gst_buffer_map (buffer, &mem->map, GST_MAP_READWRITE);
+    g_hash_table_insert (m_buffers, mem->map.data, mem);
+    *allocatedBuffer = mem->map.data;
+
+    g_mutex_unlock (&m_mutex);
+
+    return S_OK;
+  }
+
+  virtual HRESULT STDMETHODCALLTYPE ReleaseBuffer (void *buffer)
+  {
+    PoolMemory *mem;
+
+    g_mutex_lock (&m_mutex);
+    mem = (PoolMemory *) g_hash_table_lookup (m_buffers, buffer);
+    if (mem)
+      g_hash_table_remove (m_buffers, buffer);
+    g_mutex_unlock (&m_mutex);
+
+    if (!mem)
+      return E_INVALIDARG;
+
+    /* returns the buffer to its pool */
+    gst_buffer_unmap (mem->buffer, &mem->map);
+    gst_buffer_unref (mem->buffer);
+    g_slice_free (PoolMemory, mem);
+
+    return S_OK;
+  }
+
+  virtual HRESULT STDMETHODCALLTYPE Commit (void)
+  {
+    return S_OK;
+  }
+
+  virtual HRESULT STDMETHODCALLTYPE Decommit (void)
+  {
+    g_mutex_lock (&m_mutex);
+    clear_pool ();
+    g_mutex_unlock (&m_mutex);
+
+    return S_OK;
+  }
+};
+
 #ifdef _MSC_VER
 /* FIXME: We currently never deinit this */
 
@@ -826,6 +986,8 @@ init_devices (gpointer data)
       devices[i].input.
           input->SetCallback (new GStreamerDecklinkInputCallback (&devices[i].
               input));
+      devices[i].input.input->SetVideoInputFrameMemoryAllocator (new
+          GStreamerDecklinkMemoryAllocator ());
     }
 
     ret = decklink->QueryInterface (IID_IDeckLinkOutput,
@@ -838,6 +1000,8 @@ init_devices (gpointer data)
           gst_decklink_clock_new ("GstDecklinkOutputClock");
       GST_DECKLINK_CLOCK_CAST (devices[i].output.clock)->output =
           &devices[i].output;
+      devices[i].output.output->SetVideoOutputFrameMemoryAllocator (new
+          GStreamerDecklinkMemoryAllocator ());
     }
 
     ret = decklink->QueryInterface (IID_IDeckLinkConfiguration,
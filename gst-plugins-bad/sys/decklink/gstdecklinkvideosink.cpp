@@ -114,6 +114,111 @@ private:
   gint m_refcount;
 };
 
+/* Video frame for the SDK that points to the memory of a mapped GstBuffer,
+ * the buffer is unmapped and released when the SDK is done with the frame */
+class GstDecklinkVideoFrame:public IDeckLinkVideoFrame
+{
+public:
+  GstDecklinkVideoFrame (GstVideoFrame * frame, BMDPixelFormat format)
+  :IDeckLinkVideoFrame (), m_format (format), m_refcount (1)
+  {
+    m_frame = *frame;
+    g_mutex_init (&m_mutex);
+  }
+
+  virtual HRESULT QueryInterface (REFIID, LPVOID *)
+  {
+    return E_NOINTERFACE;
+  }
+
+  virtual ULONG AddRef (void)
+  {
+    ULONG ret;
+
+    g_mutex_lock (&m_mutex);
+    m_refcount++;
+    ret = m_refcount;
+    g_mutex_unlock (&m_mutex);
+
+    return ret;
+  }
+
+  virtual ULONG Release (void)
+  {
+    ULONG ret;
+
+    g_mutex_lock (&m_mutex);
+    m_refcount--;
+    ret = m_refcount;
+    g_mutex_unlock (&m_mutex);
+
+    if (ret == 0) {
+      delete this;
+    }
+
+    return ret;
+  }
+
+  virtual long GetWidth (void)
+  {
+    return GST_VIDEO_FRAME_WIDTH (&m_frame);
+  }
+
+  virtual long GetHeight (void)
+  {
+    return GST_VIDEO_FRAME_HEIGHT (&m_frame);
+  }
+
+  virtual long GetRowBytes (void)
+  {
+    return GST_VIDEO_FRAME_PLANE_STRIDE (&m_frame, 0);
+  }
+
+  virtual BMDPixelFormat GetPixelFormat (void)
+  {
+    return m_format;
+  }
+
+  virtual BMDFrameFlags GetFlags (void)
+  {
+    return bmdFrameFlagDefault;
+  }
+
+  virtual HRESULT GetBytes (void **buffer)
+  {
+    *buffer = GST_VIDEO_FRAME_PLANE_DATA (&m_frame, 0);
+
+    return S_OK;
+  }
+
+  virtual HRESULT GetTimecode (BMDTimecodeFormat format,
+      IDeckLinkTimecode ** timecode)
+  {
+    *timecode = NULL;
+
+    return S_FALSE;
+  }
+
+  virtual HRESULT GetAncillaryData (IDeckLinkVideoFrameAncillary ** ancillary)
+  {
+    *ancillary = NULL;
+
+    return S_FALSE;
+  }
+
+protected:
+  virtual ~ GstDecklinkVideoFrame () {
+    gst_video_frame_unmap (&m_frame);
+    g_mutex_clear (&m_mutex);
+  }
+
+private:
+  GstVideoFrame m_frame;
+  BMDPixelFormat m_format;
+  GMutex m_mutex;
+  gint m_refcount;
+};
+
 enum
 {
   PROP_0,
@@ -491,7 +596,8 @@ gst_decklink_video_sink_prepare (GstBaseSink * bsink, GstBuffer * buffer)
 {
   GstDecklinkVideoSink *self = GST_DECKLINK_VIDEO_SINK_CAST (bsink);
   GstVideoFrame vframe;
-  IDeckLinkMutableVideoFrame *frame;
+  IDeckLinkVideoFrame *frame;
+  IDeckLinkMutableVideoFrame *mframe;
   guint8 *outdata, *indata;
   GstFlowReturn flow_ret;
   HRESULT ret;
@@ -551,29 +657,38 @@ gst_decklink_video_sink_prepare (GstBaseSink * bsink, GstBuffer * buffer)
   else
     running_time = 0;
 
-  ret = self->output->output->CreateVideoFrame (self->info.width,
-      self->info.height, self->info.stride[0], format, bmdFrameFlagDefault,
-      &frame);
-  if (ret != S_OK) {
-    GST_ELEMENT_ERROR (self, STREAM, FAILED,
-        (NULL), ("Failed to create video frame: 0x%08x", ret));
-    return GST_FLOW_ERROR;
-  }
-
   if (!gst_video_frame_map (&vframe, &self->info, buffer, GST_MAP_READ)) {
     GST_ERROR_OBJECT (self, "Failed to map video frame");
-    flow_ret = GST_FLOW_ERROR;
-    goto out;
+    return GST_FLOW_ERROR;
   }
 
-  frame->GetBytes ((void **) &outdata);
   indata = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&vframe, 0);
-  for (i = 0; i < self->info.height; i++) {
-    memcpy (outdata, indata, GST_VIDEO_FRAME_WIDTH (&vframe) * bpp);
-    indata += GST_VIDEO_FRAME_PLANE_STRIDE (&vframe, 0);
-    outdata += frame->GetRowBytes ();
+  if (GST_VIDEO_FRAME_PLANE_STRIDE (&vframe, 0) == self->info.stride[0] &&
+      ((guintptr) indata & 15) == 0) {
+    /* the layout is what the SDK expects, schedule the buffer itself. It
+     * stays mapped until the SDK releases the frame */
+    GST_LOG_OBJECT (self, "Wrapping buffer %p", buffer);
+    frame = new GstDecklinkVideoFrame (&vframe, format);
+  } else {
+    ret = self->output->output->CreateVideoFrame (self->info.width,
+        self->info.height, self->info.stride[0], format, bmdFrameFlagDefault,
+        &mframe);
+    if (ret != S_OK) {
+      gst_video_frame_unmap (&vframe);
+      GST_ELEMENT_ERROR (self, STREAM, FAILED,
+          (NULL), ("Failed to create video frame: 0x%08x", ret));
+      return GST_FLOW_ERROR;
+    }
+
+    mframe->GetBytes ((void **) &outdata);
+    for (i = 0; i < self->info.height; i++) {
+      memcpy (outdata, indata, GST_VIDEO_FRAME_WIDTH (&vframe) * bpp);
+      indata += GST_VIDEO_FRAME_PLANE_STRIDE (&vframe, 0);
+      outdata += mframe->GetRowBytes ();
+    }
+    gst_video_frame_unmap (&vframe);
+    frame = mframe;
   }
-  gst_video_frame_unmap (&vframe);
 
   convert_to_internal_clock (self, &running_time, &running_time_duration);
 
@@ -496,6 +496,7 @@ gst_decklink_video_src_got_frame (GstElement * element,
     GstClockTime capture_time, GstClockTime capture_duration)
 {
   GstDecklinkVideoSrc *self = GST_DECKLINK_VIDEO_SRC_CAST (element);
+  GstMessage *qos_msg = NULL;
 
   GST_LOG_OBJECT (self, "Got video frame at %" GST_TIME_FORMAT,
       GST_TIME_ARGS (capture_time));
@@ -509,12 +510,24 @@ gst_decklink_video_src_got_frame (GstElement * element,
   g_mutex_lock (&self->lock);
   if (!self->flushing) {
     CaptureFrame *f;
+    guint64 dropped = 0;
 
+    self->processed++;
     while (g_queue_get_length (&self->current_frames) >= self->buffer_size) {
       f = (CaptureFrame *) g_queue_pop_head (&self->current_frames);
       GST_WARNING_OBJECT (self, "Dropping old frame at %" GST_TIME_FORMAT,
           GST_TIME_ARGS (f->capture_time));
       capture_frame_free (f);
+      dropped++;
+    }
+
+    if (dropped > 0) {
+      self->dropped += dropped;
+      qos_msg = gst_message_new_qos (GST_OBJECT (self), TRUE,
+          GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE, capture_time,
+          capture_duration);
+      gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS,
+          self->processed, self->dropped);
     }
 
     f = (CaptureFrame *) g_malloc0 (sizeof (CaptureFrame));
@@ -528,6 +541,9 @@ gst_decklink_video_src_got_frame (GstElement * element,
     g_cond_signal (&self->cond);
   }
   g_mutex_unlock (&self->lock);
+
+  if (qos_msg)
+    gst_element_post_message (GST_ELEMENT_CAST (self), qos_msg);
 }
 
 static GstFlowReturn
@@ -753,6 +769,8 @@ gst_decklink_video_src_stop (GstDecklinkVideoSrc * self)
   g_queue_foreach (&self->current_frames, (GFunc) capture_frame_free, NULL);
   g_queue_clear (&self->current_frames);
   self->caps_mode = GST_DECKLINK_MODE_AUTO;
+  self->processed = 0;
+  self->dropped = 0;
 
   if (self->input && self->input->video_enabled) {
     g_mutex_lock (&self->input->lock);
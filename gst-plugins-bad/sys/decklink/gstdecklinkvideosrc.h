@@ -67,6 +67,10 @@ struct _GstDecklinkVideoSrc
   GQueue current_frames;
 
   guint buffer_size;
+  /* frames received from the device and frames dropped because the
+   * queue was full, for QoS messages */
+  guint64 processed;
+  guint64 dropped;
 
   GstClockTime internal_base_time;
   GstClockTime external_base_time;
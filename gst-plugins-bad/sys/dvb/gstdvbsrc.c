@@ -194,7 +194,8 @@ enum
   ARG_DVBSRC_LNB_SLOF,
   ARG_DVBSRC_LNB_LOF1,
   ARG_DVBSRC_LNB_LOF2,
-  ARG_DVBSRC_INTERLEAVING
+  ARG_DVBSRC_INTERLEAVING,
+  ARG_DVBSRC_PACKETS_PER_BUFFER
 };
 
 #define DEFAULT_ADAPTER 0
@@ -217,7 +218,9 @@ enum
 #define DEFAULT_TIMEOUT 1000000 /* 1 second */
 #define DEFAULT_TUNING_TIMEOUT 10 * GST_SECOND  /* 10 seconds */
 #define DEFAULT_DVB_BUFFER_SIZE (10*188*1024)   /* kernel default is 8192 */
-#define DEFAULT_BUFFER_SIZE 8192        /* not a property */
+#define TS_PACKET_SIZE 188
+#define DEFAULT_BUFFER_SIZE (44*TS_PACKET_SIZE) /* initial blocksize */
+#define DEFAULT_PACKETS_PER_BUFFER 0
 #define DEFAULT_DELSYS SYS_UNDEFINED
 #define DEFAULT_PILOT PILOT_AUTO
 #define DEFAULT_ROLLOFF ROLLOFF_AUTO
@@ -958,6 +961,25 @@ gst_dvbsrc_class_init (GstDvbSrcClass * klass)
           GST_TYPE_INTERLEAVING, DEFAULT_INTERLEAVING,
           GST_PARAM_MUTABLE_PLAYING | G_PARAM_READWRITE));
 
+  /**
+   * GstDvbSrc:packets-per-buffer:
+   *
+   * Split the data of each read from the DVR device into buffers of this
+   * many TS packets and push them downstream as one buffer list. The
+   * buffers share the memory of the read. The amount of data read at once
+   * is set with the #GstBaseSrc:blocksize property, rounded down to whole
+   * TS packets. 0 pushes one buffer per read.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class,
+      ARG_DVBSRC_PACKETS_PER_BUFFER,
+      g_param_spec_uint ("packets-per-buffer", "Packets per buffer",
+          "Number of TS packets per buffer when pushing buffer lists "
+          "(0 = one buffer per read)", 0, G_MAXUINT / TS_PACKET_SIZE,
+          DEFAULT_PACKETS_PER_BUFFER,
+          GST_PARAM_MUTABLE_PLAYING | G_PARAM_READWRITE));
+
   /**
    * GstDvbSrc::tuning-start:
    * @gstdvbsrc: the element on which the signal is emitted
@@ -1022,6 +1044,7 @@ gst_dvbsrc_init (GstDvbSrc * object)
   /* And we wanted timestamped output */
   gst_base_src_set_do_timestamp (GST_BASE_SRC (object), TRUE);
   gst_base_src_set_format (GST_BASE_SRC (object), GST_FORMAT_TIME);
+  gst_base_src_set_blocksize (GST_BASE_SRC (object), DEFAULT_BUFFER_SIZE);
 
   object->fd_frontend = -1;
   object->fd_dvr = -1;
@@ -1034,6 +1057,7 @@ gst_dvbsrc_init (GstDvbSrc * object)
   /* PID 8192 on DVB gets the whole transport stream */
   object->pids[0] = 8192;
   object->dvb_buffer_size = DEFAULT_DVB_BUFFER_SIZE;
+  object->packets_per_buffer = DEFAULT_PACKETS_PER_BUFFER;
   object->adapter_number = DEFAULT_ADAPTER;
   object->frontend_number = DEFAULT_FRONTEND;
   object->diseqc_src = DEFAULT_DISEQC_SRC;
@@ -1337,6 +1361,9 @@ gst_dvbsrc_set_property (GObject * _object, guint prop_id,
     case ARG_DVBSRC_INTERLEAVING:
       object->interleaving = g_value_get_enum (value);
       break;
+    case ARG_DVBSRC_PACKETS_PER_BUFFER:
+      object->packets_per_buffer = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -1509,6 +1536,9 @@ gst_dvbsrc_get_property (GObject * _object, guint prop_id,
     case ARG_DVBSRC_INTERLEAVING:
       g_value_set_enum (value, object->interleaving);
       break;
+    case ARG_DVBSRC_PACKETS_PER_BUFFER:
+      g_value_set_uint (value, object->packets_per_buffer);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -1764,6 +1794,7 @@ static gboolean
 gst_dvbsrc_open_dvr (GstDvbSrc * object)
 {
   gchar *dvr_dev;
+  guint buffer_size;
   gint err;
 
   dvr_dev = g_strdup_printf ("/dev/dvb/adapter%d/dvr%d",
@@ -1788,10 +1819,15 @@ gst_dvbsrc_open_dvr (GstDvbSrc * object)
   }
   g_free (dvr_dev);
 
-  GST_INFO_OBJECT (object, "Setting DVB kernel buffer size to %d ",
-      object->dvb_buffer_size);
+  /* keep room for a few reads in the kernel buffer, so that large reads
+   * don't make the demuxer drop data while we are pushing downstream */
+  buffer_size = MAX (object->dvb_buffer_size,
+      4 * gst_base_src_get_blocksize (GST_BASE_SRC (object)));
+
+  GST_INFO_OBJECT (object, "Setting DVB kernel buffer size to %u ",
+      buffer_size);
   LOOP_WHILE_EINTR (err, ioctl (object->fd_dvr, DMX_SET_BUFFER_SIZE,
-          object->dvb_buffer_size));
+          buffer_size));
   if (err) {
     GST_INFO_OBJECT (object, "ioctl DMX_SET_BUFFER_SIZE failed (%d)", errno);
     return FALSE;
@@ -1910,17 +1946,45 @@ select_error:
   }
 }
 
+/* split @buf into buffers of @packets TS packets sharing its memory */
+static GstBufferList *
+gst_dvbsrc_split_packets (GstDvbSrc * object, GstBuffer * buf, guint packets)
+{
+  GstBufferList *list;
+  gsize size, chunk, offset;
+
+  size = gst_buffer_get_size (buf);
+  chunk = packets * TS_PACKET_SIZE;
+
+  list = gst_buffer_list_new_sized ((size + chunk - 1) / chunk);
+  for (offset = 0; offset < size; offset += chunk) {
+    gst_buffer_list_add (list, gst_buffer_copy_region (buf,
+            GST_BUFFER_COPY_MEMORY, offset, MIN (chunk, size - offset)));
+  }
+  gst_buffer_unref (buf);
+
+  GST_LOG_OBJECT (object, "pushing list of %u buffers",
+      gst_buffer_list_length (list));
+
+  return list;
+}
+
 static GstFlowReturn
 gst_dvbsrc_create (GstPushSrc * element, GstBuffer ** buf)
 {
   gint buffer_size;
+  guint packets;
   GstFlowReturn retval = GST_FLOW_ERROR;
   GstDvbSrc *object;
 
   object = GST_DVBSRC (element);
   GST_LOG ("fd_dvr: %d", object->fd_dvr);
 
-  buffer_size = DEFAULT_BUFFER_SIZE;
+  /* only read whole TS packets */
+  buffer_size = gst_base_src_get_blocksize (GST_BASE_SRC (element));
+  buffer_size = MAX (buffer_size - buffer_size % TS_PACKET_SIZE,
+      TS_PACKET_SIZE);
+  packets = object->packets_per_buffer;
 
   /* device can not be tuned during read */
   g_mutex_lock (&object->tune_mutex);
@@ -1931,6 +1995,14 @@ gst_dvbsrc_create (GstPushSrc * element, GstBuffer ** buf)
     GST_DEBUG_OBJECT (object, "Reading from DVR device");
     retval = gst_dvbsrc_read_device (object, buffer_size, buf);
 
+    if (retval == GST_FLOW_OK && packets > 0 &&
+        gst_buffer_get_size (*buf) > packets * TS_PACKET_SIZE) {
+      /* the base class timestamps the first buffer of the list */
+      gst_base_src_submit_buffer_list (GST_BASE_SRC (element),
+          gst_dvbsrc_split_packets (object, *buf, packets));
+      *buf = NULL;
+    }
+
     if (object->stats_interval &&
         ++object->stats_counter == object->stats_interval) {
       gst_dvbsrc_output_frontend_stats (object);
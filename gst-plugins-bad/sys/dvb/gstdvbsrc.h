@@ -103,6 +103,7 @@ struct _GstDvbSrc
   gboolean need_unlock;
 
   guint dvb_buffer_size;
+  guint packets_per_buffer;
 
   unsigned int isdbt_layer_enabled;
   int isdbt_partial_reception;
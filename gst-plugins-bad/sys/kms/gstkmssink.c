@@ -95,9 +95,24 @@ kms_open (gchar ** driver)
   return fd;
 }
 
+static gboolean
+plane_supports_format (drmModePlane * plane, guint32 fmt)
+{
+  int i;
+
+  for (i = 0; i < plane->count_formats; i++) {
+    if (plane->formats[i] == fmt)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* returns the first plane usable with @crtc_id that can scan out @fmt, or
+ * any plane usable with @crtc_id if @fmt is 0 */
 static drmModePlane *
 find_plane_for_crtc (int fd, drmModeRes * res, drmModePlaneRes * pres,
-    int crtc_id)
+    int crtc_id, guint32 fmt)
 {
   drmModePlane *plane;
   int i, pipe;
@@ -116,7 +131,10 @@ find_plane_for_crtc (int fd, drmModeRes * res, drmModePlaneRes * pres,
 
   for (i = 0; i < pres->count_planes; i++) {
     plane = drmModeGetPlane (fd, pres->planes[i]);
-    if (plane->possible_crtcs & (1 << pipe))
+    if (!plane)
+      continue;
+    if ((plane->possible_crtcs & (1 << pipe))
+        && (fmt == 0 || plane_supports_format (plane, fmt)))
       return plane;
     drmModeFreePlane (plane);
   }
@@ -297,11 +315,16 @@ get_drm_caps (GstKMSSink * self)
   return TRUE;
 }
 
+/* the allowed caps are the formats of every plane usable with the crtc, the
+ * plane is then picked in set_caps() so that the negotiated format can be
+ * scanned out directly instead of being copied */
 static gboolean
-ensure_allowed_caps (GstKMSSink * self, drmModePlane * plane, drmModeRes * res)
+ensure_allowed_caps (GstKMSSink * self, drmModeRes * res,
+    drmModePlaneRes * pres)
 {
   GstCaps *out_caps, *caps;
-  int i;
+  drmModePlane *plane;
+  int i, j;
   GstVideoFormat fmt;
   const gchar *format;
 
@@ -312,23 +335,35 @@ ensure_allowed_caps (GstKMSSink * self, drmModePlane * plane, drmModeRes * res)
   if (!out_caps)
     return FALSE;
 
-  for (i = 0; i < plane->count_formats; i++) {
-    fmt = gst_video_format_from_drm (plane->formats[i]);
-    if (fmt == GST_VIDEO_FORMAT_UNKNOWN) {
-      GST_INFO_OBJECT (self, "ignoring format %" GST_FOURCC_FORMAT,
-          GST_FOURCC_ARGS (plane->formats[i]));
+  for (j = 0; j < pres->count_planes; j++) {
+    plane = drmModeGetPlane (self->fd, pres->planes[j]);
+    if (!plane)
+      continue;
+    if (!(plane->possible_crtcs & (1 << self->pipe))) {
+      drmModeFreePlane (plane);
       continue;
     }
 
-    format = gst_video_format_to_string (fmt);
-    caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, format,
-        "width", GST_TYPE_INT_RANGE, res->min_width, res->max_width,
-        "height", GST_TYPE_INT_RANGE, res->min_height, res->max_height,
-        "framerate", GST_TYPE_FRACTION_RANGE, 0, 1, G_MAXINT, 1, NULL);
-    if (!caps)
-      continue;
+    for (i = 0; i < plane->count_formats; i++) {
+      fmt = gst_video_format_from_drm (plane->formats[i]);
+      if (fmt == GST_VIDEO_FORMAT_UNKNOWN) {
+        GST_INFO_OBJECT (self, "ignoring format %" GST_FOURCC_FORMAT,
+            GST_FOURCC_ARGS (plane->formats[i]));
+        continue;
+      }
+
+      format = gst_video_format_to_string (fmt);
+      caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING,
+          format, "width", GST_TYPE_INT_RANGE, res->min_width, res->max_width,
+          "height", GST_TYPE_INT_RANGE, res->min_height, res->max_height,
+          "framerate", GST_TYPE_FRACTION_RANGE, 0, 1, G_MAXINT, 1, NULL);
+      if (!caps)
+        continue;
+
+      out_caps = gst_caps_merge (out_caps, caps);
+    }
 
-    out_caps = gst_caps_merge (out_caps, caps);
+    drmModeFreePlane (plane);
   }
 
   self->allowed_caps = gst_caps_simplify (out_caps);
@@ -388,12 +423,12 @@ gst_kms_sink_start (GstBaseSink * bsink)
   if (!pres)
     goto plane_resources_failed;
 
-  plane = find_plane_for_crtc (self->fd, res, pres, crtc->crtc_id);
+  plane = find_plane_for_crtc (self->fd, res, pres, crtc->crtc_id, 0);
   if (!plane)
     goto plane_failed;
 
-  /* let's get the available color formats in plane */
-  if (!ensure_allowed_caps (self, plane, res))
+  /* let's get the available color formats in the planes */
+  if (!ensure_allowed_caps (self, res, pres))
     goto bail;
 
   self->conn_id = conn->connector_id;
@@ -626,6 +661,60 @@ gst_kms_sink_calculate_display_ratio (GstKMSSink * self, GstVideoInfo * vinfo)
   return TRUE;
 }
 
+/* switches to a plane of our crtc that can scan out the format of @vinfo
+ * if the current one can't */
+static gboolean
+ensure_plane_for_format (GstKMSSink * self, GstVideoInfo * vinfo)
+{
+  drmModeRes *res;
+  drmModePlaneRes *pres;
+  drmModePlane *plane;
+  guint32 fmt;
+  gboolean ret = FALSE;
+
+  fmt = gst_drm_format_from_video (GST_VIDEO_INFO_FORMAT (vinfo));
+  if (fmt == 0)
+    return FALSE;
+
+  plane = drmModeGetPlane (self->fd, self->plane_id);
+  if (plane) {
+    ret = plane_supports_format (plane, fmt);
+    drmModeFreePlane (plane);
+    if (ret)
+      return TRUE;
+  }
+
+  res = drmModeGetResources (self->fd);
+  if (!res)
+    return FALSE;
+  pres = drmModeGetPlaneResources (self->fd);
+  if (!pres) {
+    drmModeFreeResources (res);
+    return FALSE;
+  }
+
+  plane = find_plane_for_crtc (self->fd, res, pres, self->crtc_id, fmt);
+  if (plane) {
+    GST_INFO_OBJECT (self, "switching from plane %d to plane %d for format %"
+        GST_FOURCC_FORMAT, self->plane_id, plane->plane_id,
+        GST_FOURCC_ARGS (fmt));
+
+    /* disable the previous plane so it doesn't keep showing the last frame */
+    drmModeSetPlane (self->fd, self->plane_id, self->crtc_id, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0);
+    gst_buffer_replace (&self->last_buffer, NULL);
+
+    self->plane_id = plane->plane_id;
+    drmModeFreePlane (plane);
+    ret = TRUE;
+  }
+
+  drmModeFreePlaneResources (pres);
+  drmModeFreeResources (res);
+
+  return ret;
+}
+
 static gboolean
 gst_kms_sink_set_caps (GstBaseSink * bsink, GstCaps * caps)
 {
@@ -644,6 +733,9 @@ gst_kms_sink_set_caps (GstBaseSink * bsink, GstCaps * caps)
   if (GST_VIDEO_SINK_WIDTH (self) <= 0 || GST_VIDEO_SINK_HEIGHT (self) <= 0)
     goto invalid_size;
 
+  if (!ensure_plane_for_format (self, &vinfo))
+    goto no_plane;
+
   /* create a new pool for the new configuration */
   newpool = gst_kms_sink_create_pool (self, caps, GST_VIDEO_INFO_SIZE (&vinfo),
       2);
@@ -685,6 +777,13 @@ no_disp_ratio:
         ("Error calculating the output display ratio of the video."));
     return FALSE;
   }
+no_plane:
+  {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("No plane of the crtc can display format %s.",
+            gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&vinfo))));
+    return FALSE;
+  }
 no_pool:
   {
     /* Already warned in create_pool */
@@ -883,6 +982,7 @@ gst_kms_sink_import_dmabuf (GstKMSSink * self, GstBuffer * inbuf,
     GstBuffer ** outbuf)
 {
   gint prime_fds[GST_VIDEO_MAX_PLANES] = { 0, };
+  GstVideoInfo vinfo;
   GstVideoMeta *meta;
   guint i, n_mem, n_planes;
   GstKMSMemory *kmsmem;
@@ -897,7 +997,10 @@ gst_kms_sink_import_dmabuf (GstKMSSink * self, GstBuffer * inbuf,
   if (!gst_is_dmabuf_memory (gst_buffer_peek_memory (inbuf, 0)))
     return FALSE;
 
-  n_planes = GST_VIDEO_INFO_N_PLANES (&self->vinfo);
+  /* The layout of the input buffer doesn't have to match the negotiated
+   * one, so work on a copy of the video info */
+  vinfo = self->vinfo;
+  n_planes = GST_VIDEO_INFO_N_PLANES (&vinfo);
   n_mem = gst_buffer_n_memory (inbuf);
   meta = gst_buffer_get_video_meta (inbuf);
 
@@ -907,12 +1010,12 @@ gst_kms_sink_import_dmabuf (GstKMSSink * self, GstBuffer * inbuf,
 
   /* Update video info based on video meta */
   if (meta) {
-    GST_VIDEO_INFO_WIDTH (&self->vinfo) = meta->width;
-    GST_VIDEO_INFO_HEIGHT (&self->vinfo) = meta->height;
+    GST_VIDEO_INFO_WIDTH (&vinfo) = meta->width;
+    GST_VIDEO_INFO_HEIGHT (&vinfo) = meta->height;
 
     for (i = 0; i < meta->n_planes; i++) {
-      GST_VIDEO_INFO_PLANE_OFFSET (&self->vinfo, i) = meta->offset[i];
-      GST_VIDEO_INFO_PLANE_STRIDE (&self->vinfo, i) = meta->stride[i];
+      GST_VIDEO_INFO_PLANE_OFFSET (&vinfo, i) = meta->offset[i];
+      GST_VIDEO_INFO_PLANE_STRIDE (&vinfo, i) = meta->stride[i];
     }
   }
 
@@ -921,9 +1024,9 @@ gst_kms_sink_import_dmabuf (GstKMSSink * self, GstBuffer * inbuf,
     guint plane_size;
     guint length;
 
-    plane_size = get_plane_data_size (&self->vinfo, i);
+    plane_size = get_plane_data_size (&vinfo, i);
     if (!gst_buffer_find_memory (inbuf,
-            GST_VIDEO_INFO_PLANE_OFFSET (&self->vinfo, i), plane_size,
+            GST_VIDEO_INFO_PLANE_OFFSET (&vinfo, i), plane_size,
             &mems_idx[i], &length, &mems_skip[i]))
       return FALSE;
 
@@ -938,6 +1041,12 @@ gst_kms_sink_import_dmabuf (GstKMSSink * self, GstBuffer * inbuf,
       return FALSE;
   }
 
+  /* The framebuffer wants the offset of each plane inside its dmabuf, not
+   * inside the buffer, so that decoders exporting one dmabuf per plane can
+   * be scanned out directly as well */
+  for (i = 0; i < n_planes; i++)
+    GST_VIDEO_INFO_PLANE_OFFSET (&vinfo, i) = mems[i]->offset + mems_skip[i];
+
   kmsmem = (GstKMSMemory *) get_cached_kmsmem (mems[0]);
   if (kmsmem) {
     GST_LOG_OBJECT (self, "found KMS mem %p in DMABuf mem %p with fb id = %d",
@@ -952,7 +1061,7 @@ gst_kms_sink_import_dmabuf (GstKMSSink * self, GstBuffer * inbuf,
       prime_fds[1], prime_fds[2], prime_fds[3]);
 
   kmsmem = gst_kms_allocator_dmabuf_import (self->allocator, prime_fds,
-      n_planes, &self->vinfo);
+      n_planes, &vinfo);
   if (!kmsmem)
     return FALSE;
 
@@ -166,6 +166,7 @@ enum
   PROP_QP_MIN,
   PROP_QP_MAX,
   PROP_QP_CONST,
+  PROP_ASYNC_DEPTH,
 };
 
 #define DEFAULT_PRESET GST_NV_PRESET_DEFAULT
@@ -174,6 +175,7 @@ enum
 #define DEFAULT_QP_MIN -1
 #define DEFAULT_QP_MAX -1
 #define DEFAULT_QP_CONST -1
+#define DEFAULT_ASYNC_DEPTH 0
 
 /* This lock is needed to prevent the situation where multiple encoders are
  * initialised at the same time which appears to cause excessive CPU usage over
@@ -184,7 +186,6 @@ G_LOCK_DEFINE_STATIC (initialization_lock);
 struct gl_input_resource
 {
   GstGLMemory *gl_mem[GST_VIDEO_MAX_PLANES];
-  struct cudaGraphicsResource *cuda_texture;
   gpointer cuda_plane_pointers[GST_VIDEO_MAX_PLANES];
   gpointer cuda_pointer;
   gsize cuda_stride;
@@ -192,6 +193,33 @@ struct gl_input_resource
   NV_ENC_REGISTER_RESOURCE nv_resource;
   NV_ENC_MAP_INPUT_RESOURCE nv_mapped_resource;
 };
+
+/* CUDA registration of the PBO backing a GL memory. Registering a buffer
+ * with CUDA is expensive, so it is done once per memory and cached on the
+ * memory as qdata for as long as the memory lives, which with upstream
+ * buffer pools means the registration is reused for every frame.
+ * The encoder keeps a list of its registrations so it can unregister them
+ * before its CUDA context goes away; the qdata then only holds a dead entry
+ * that's replaced on next use (by a new encoder) or freed with the memory. */
+struct gl_registration
+{
+  GstNvBaseEnc *nvenc;          /* registration_lock */
+  struct cudaGraphicsResource *cuda_resource;
+  guint gl_buffer_id;
+};
+
+G_LOCK_DEFINE_STATIC (registration_lock);
+
+static GQuark
+_gl_registration_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("GstNvBaseEncGLRegistration");
+
+  return quark;
+}
 #endif
 
 struct frame_state
@@ -279,6 +307,12 @@ gst_nv_base_enc_class_init (GstNvBaseEncClass * klass)
           "Constant quantizer (-1 = from NVENC preset)",
           -1, 51, DEFAULT_QP_CONST,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_ASYNC_DEPTH,
+      g_param_spec_uint ("async-depth", "Async Depth",
+          "Number of frames that can be in flight in the encoder at the same "
+          "time, only applied when the encoder is first configured "
+          "(0 = automatic, based on the frame size)", 0, 64,
+          DEFAULT_ASYNC_DEPTH, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_BITRATE,
       g_param_spec_uint ("bitrate", "Bitrate",
           "Bitrate in kbit/sec (0 = from NVENC preset)", 0, 2000 * 1024,
@@ -653,6 +687,7 @@ gst_nv_base_enc_init (GstNvBaseEnc * nvenc)
   nvenc->qp_max = DEFAULT_QP_MAX;
   nvenc->qp_const = DEFAULT_QP_CONST;
   nvenc->bitrate = DEFAULT_BITRATE;
+  nvenc->async_depth = DEFAULT_ASYNC_DEPTH;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
@@ -924,8 +959,8 @@ gst_nv_base_enc_reset_queues (GstNvBaseEnc * nvenc, gboolean refill)
   if (refill) {
     GST_INFO_OBJECT (nvenc, "refilling buffer pools");
     for (i = 0; i < nvenc->n_bufs; ++i) {
-      g_async_queue_push (nvenc->bitstream_pool, nvenc->input_bufs[i]);
-      g_async_queue_push (nvenc->in_bufs_pool, nvenc->output_bufs[i]);
+      g_async_queue_push (nvenc->in_bufs_pool, nvenc->input_bufs[i]);
+      g_async_queue_push (nvenc->bitstream_pool, nvenc->output_bufs[i]);
     }
   }
 }
@@ -941,6 +976,10 @@ gst_nv_base_enc_free_buffers (GstNvBaseEnc * nvenc)
 
   gst_nv_base_enc_reset_queues (nvenc, FALSE);
 
+#if HAVE_NVENC_GST_GL
+  _unregister_gl_resources (nvenc);
+#endif
+
   for (i = 0; i < nvenc->n_bufs; ++i) {
     NV_ENC_OUTPUT_PTR out_buf = nvenc->output_bufs[i];
 
@@ -1225,9 +1264,14 @@ gst_nv_base_enc_set_format (GstVideoEncoder * enc, GstVideoCodecState * state)
     input_width = GST_VIDEO_INFO_WIDTH (info);
     input_height = GST_VIDEO_INFO_HEIGHT (info);
 
-    num_macroblocks = (GST_ROUND_UP_16 (input_width) >> 4)
-        * (GST_ROUND_UP_16 (input_height) >> 4);
-    nvenc->n_bufs = (num_macroblocks >= 8160) ? 32 : 48;
+    if (nvenc->async_depth > 0) {
+      nvenc->n_bufs = nvenc->async_depth;
+    } else {
+      num_macroblocks = (GST_ROUND_UP_16 (input_width) >> 4)
+          * (GST_ROUND_UP_16 (input_height) >> 4);
+      nvenc->n_bufs = (num_macroblocks >= 8160) ? 32 : 48;
+    }
+    GST_INFO_OBJECT (nvenc, "allowing %u frames in flight", nvenc->n_bufs);
 
     /* input buffers */
     nvenc->input_bufs = g_new0 (gpointer, nvenc->n_bufs);
@@ -1436,62 +1480,151 @@ struct map_gl_input
   struct gl_input_resource *in_gl_resource;
 };
 
+/* call with registration_lock held */
+static void
+_gl_registration_unregister_unlocked (struct gl_registration *reg)
+{
+  GstNvBaseEnc *nvenc = reg->nvenc;
+  cudaError_t cuda_ret;
+
+  if (nvenc == NULL)
+    return;
+
+  nvenc->gl_registrations = g_list_remove (nvenc->gl_registrations, reg);
+
+  cuCtxPushCurrent (nvenc->cuda_ctx);
+  cuda_ret = cudaGraphicsUnregisterResource (reg->cuda_resource);
+  cuCtxPopCurrent (NULL);
+  if (cuda_ret != cudaSuccess) {
+    GST_WARNING_OBJECT (nvenc, "failed to unregister GL buffer %u from cuda "
+        "ret :%d", reg->gl_buffer_id, cuda_ret);
+  }
+
+  reg->nvenc = NULL;
+  reg->cuda_resource = NULL;
+}
+
+static void
+_gl_registration_free (struct gl_registration *reg)
+{
+  G_LOCK (registration_lock);
+  _gl_registration_unregister_unlocked (reg);
+  G_UNLOCK (registration_lock);
+
+  g_free (reg);
+}
+
+static void
+_unregister_gl_resources (GstNvBaseEnc * nvenc)
+{
+  G_LOCK (registration_lock);
+  while (nvenc->gl_registrations)
+    _gl_registration_unregister_unlocked (nvenc->gl_registrations->data);
+  G_UNLOCK (registration_lock);
+}
+
+/* call with the CUDA context pushed */
+static struct cudaGraphicsResource *
+_get_gl_registration (GstNvBaseEnc * nvenc, GstGLMemoryPBO * gl_mem)
+{
+  GstMiniObject *obj = GST_MINI_OBJECT_CAST (gl_mem);
+  GstGLBuffer *gl_buf_obj = (GstGLBuffer *) gl_mem->pbo;
+  struct gl_registration *reg;
+  cudaError_t cuda_ret;
+  gboolean valid;
+
+  reg = gst_mini_object_get_qdata (obj, _gl_registration_quark ());
+
+  G_LOCK (registration_lock);
+  valid = reg && reg->nvenc == nvenc && reg->gl_buffer_id == gl_buf_obj->id;
+  G_UNLOCK (registration_lock);
+
+  if (valid)
+    return reg->cuda_resource;
+
+  reg = g_new0 (struct gl_registration, 1);
+  reg->gl_buffer_id = gl_buf_obj->id;
+
+  cuda_ret = cudaGraphicsGLRegisterBuffer (&reg->cuda_resource,
+      gl_buf_obj->id, cudaGraphicsRegisterFlagsReadOnly);
+  if (cuda_ret != cudaSuccess) {
+    GST_ERROR_OBJECT (nvenc, "failed to register GL texture %u to cuda "
+        "ret :%d", gl_mem->mem.tex_id, cuda_ret);
+    g_free (reg);
+    return NULL;
+  }
+
+  GST_LOG_OBJECT (nvenc, "registered GL buffer %u with cuda",
+      reg->gl_buffer_id);
+
+  G_LOCK (registration_lock);
+  reg->nvenc = nvenc;
+  nvenc->gl_registrations = g_list_prepend (nvenc->gl_registrations, reg);
+  G_UNLOCK (registration_lock);
+
+  /* frees any stale registration left from a previous encoder */
+  gst_mini_object_set_qdata (obj, _gl_registration_quark (), reg,
+      (GDestroyNotify) _gl_registration_free);
+
+  return reg->cuda_resource;
+}
+
 static void
 _map_gl_input_buffer (GstGLContext * context, struct map_gl_input *data)
 {
+  struct cudaGraphicsResource *resources[GST_VIDEO_MAX_PLANES];
+  GstGLMemoryPBO *gl_mems[GST_VIDEO_MAX_PLANES];
+  guint n_planes = GST_VIDEO_INFO_N_PLANES (data->info);
   cudaError_t cuda_ret;
   guint8 *data_pointer;
   guint i;
 
   cuCtxPushCurrent (data->nvenc->cuda_ctx);
-  data_pointer = data->in_gl_resource->cuda_pointer;
-  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (data->info); i++) {
-    guint plane_n_components;
-    GstGLBuffer *gl_buf_obj;
+  for (i = 0; i < n_planes; i++) {
     GstGLMemoryPBO *gl_mem;
-    guint src_stride, dest_stride;
 
     gl_mem =
         (GstGLMemoryPBO *) gst_buffer_peek_memory (data->frame->input_buffer,
         i);
     g_return_if_fail (gst_is_gl_memory_pbo ((GstMemory *) gl_mem));
+    g_return_if_fail (gl_mem->pbo != NULL);
     data->in_gl_resource->gl_mem[i] = GST_GL_MEMORY_CAST (gl_mem);
-    plane_n_components = _plane_get_n_components (data->info, i);
-
-    gl_buf_obj = (GstGLBuffer *) gl_mem->pbo;
-    g_return_if_fail (gl_buf_obj != NULL);
+    gl_mems[i] = gl_mem;
 
     /* get the texture into the PBO */
     gst_gl_memory_pbo_upload_transfer (gl_mem);
     gst_gl_memory_pbo_download_transfer (gl_mem);
 
-    GST_LOG_OBJECT (data->nvenc, "attempting to copy texture %u into cuda",
-        gl_mem->mem.tex_id);
-
-    cuda_ret =
-        cudaGraphicsGLRegisterBuffer (&data->in_gl_resource->cuda_texture,
-        gl_buf_obj->id, cudaGraphicsRegisterFlagsReadOnly);
-    if (cuda_ret != cudaSuccess) {
-      GST_ERROR_OBJECT (data->nvenc, "failed to register GL texture %u to cuda "
-          "ret :%d", gl_mem->mem.tex_id, cuda_ret);
+    resources[i] = _get_gl_registration (data->nvenc, gl_mem);
+    if (resources[i] == NULL)
       g_assert_not_reached ();
-    }
+  }
 
-    cuda_ret =
-        cudaGraphicsMapResources (1, &data->in_gl_resource->cuda_texture, 0);
-    if (cuda_ret != cudaSuccess) {
-      GST_ERROR_OBJECT (data->nvenc, "failed to map GL texture %u into cuda "
-          "ret :%d", gl_mem->mem.tex_id, cuda_ret);
-      g_assert_not_reached ();
-    }
+  /* map all planes in one go, this only synchronises once with GL */
+  cuda_ret = cudaGraphicsMapResources (n_planes, resources, 0);
+  if (cuda_ret != cudaSuccess) {
+    GST_ERROR_OBJECT (data->nvenc, "failed to map GL textures into cuda "
+        "ret :%d", cuda_ret);
+    g_assert_not_reached ();
+  }
+
+  data_pointer = data->in_gl_resource->cuda_pointer;
+  for (i = 0; i < n_planes; i++) {
+    guint plane_n_components;
+    guint src_stride, dest_stride;
+
+    plane_n_components = _plane_get_n_components (data->info, i);
+
+    GST_LOG_OBJECT (data->nvenc, "attempting to copy texture %u into cuda",
+        gl_mems[i]->mem.tex_id);
 
     cuda_ret =
         cudaGraphicsResourceGetMappedPointer (&data->in_gl_resource->
         cuda_plane_pointers[i], &data->in_gl_resource->cuda_num_bytes,
-        data->in_gl_resource->cuda_texture);
+        resources[i]);
     if (cuda_ret != cudaSuccess) {
       GST_ERROR_OBJECT (data->nvenc, "failed to get mapped pointer of map GL "
-          "texture %u in cuda ret :%d", gl_mem->mem.tex_id, cuda_ret);
+          "texture %u in cuda ret :%d", gl_mems[i]->mem.tex_id, cuda_ret);
       g_assert_not_reached ();
     }
 
@@ -1506,23 +1639,7 @@ _map_gl_input_buffer (GstGLContext * context, struct map_gl_input *data)
         _get_plane_height (data->info, i), cudaMemcpyDeviceToDevice);
     if (cuda_ret != cudaSuccess) {
       GST_ERROR_OBJECT (data->nvenc, "failed to copy GL texture %u into cuda "
-          "ret :%d", gl_mem->mem.tex_id, cuda_ret);
-      g_assert_not_reached ();
-    }
-
-    cuda_ret =
-        cudaGraphicsUnmapResources (1, &data->in_gl_resource->cuda_texture, 0);
-    if (cuda_ret != cudaSuccess) {
-      GST_ERROR_OBJECT (data->nvenc, "failed to unmap GL texture %u from cuda "
-          "ret :%d", gl_mem->mem.tex_id, cuda_ret);
-      g_assert_not_reached ();
-    }
-
-    cuda_ret =
-        cudaGraphicsUnregisterResource (data->in_gl_resource->cuda_texture);
-    if (cuda_ret != cudaSuccess) {
-      GST_ERROR_OBJECT (data->nvenc, "failed to unregister GL texture %u from "
-          "cuda ret :%d", gl_mem->mem.tex_id, cuda_ret);
+          "ret :%d", gl_mems[i]->mem.tex_id, cuda_ret);
       g_assert_not_reached ();
     }
 
@@ -1531,6 +1648,13 @@ _map_gl_input_buffer (GstGLContext * context, struct map_gl_input *data)
         data->in_gl_resource->cuda_stride *
         _get_plane_height (&data->nvenc->input_info, i);
   }
+
+  cuda_ret = cudaGraphicsUnmapResources (n_planes, resources, 0);
+  if (cuda_ret != cudaSuccess) {
+    GST_ERROR_OBJECT (data->nvenc, "failed to unmap GL textures from cuda "
+        "ret :%d", cuda_ret);
+    g_assert_not_reached ();
+  }
   cuCtxPopCurrent (NULL);
 }
 #endif
@@ -1744,10 +1868,14 @@ gst_nv_base_enc_handle_frame (GstVideoEncoder * enc, GstVideoCodecFrame * frame)
     src_stride = GST_VIDEO_FRAME_PLANE_STRIDE (&vframe, 0);
     dest = in_buf_lock.bufferDataPtr;
     dest_stride = in_buf_lock.pitch;
-    for (y = 0; y < height; ++y) {
-      memcpy (dest, src, width);
-      dest += dest_stride;
-      src += src_stride;
+    if (src_stride == dest_stride) {
+      memcpy (dest, src, dest_stride * height);
+    } else {
+      for (y = 0; y < height; ++y) {
+        memcpy (dest, src, width);
+        dest += dest_stride;
+        src += src_stride;
+      }
     }
 
     /* copy UV plane */
@@ -1758,10 +1886,14 @@ gst_nv_base_enc_handle_frame (GstVideoEncoder * enc, GstVideoCodecFrame * frame)
         GST_ROUND_UP_32 (GST_VIDEO_INFO_HEIGHT (&nvenc->input_info)) *
         in_buf_lock.pitch;
     dest_stride = in_buf_lock.pitch;
-    for (y = 0; y < GST_ROUND_UP_2 (height) / 2; ++y) {
-      memcpy (dest, src, width);
-      dest += dest_stride;
-      src += src_stride;
+    if (src_stride == dest_stride) {
+      memcpy (dest, src, dest_stride * (GST_ROUND_UP_2 (height) / 2));
+    } else {
+      for (y = 0; y < GST_ROUND_UP_2 (height) / 2; ++y) {
+        memcpy (dest, src, width);
+        dest += dest_stride;
+        src += src_stride;
+      }
     }
 
     nv_ret = NvEncUnlockInputBuffer (nvenc->encoder, in_buf);
@@ -1886,6 +2018,9 @@ gst_nv_base_enc_set_property (GObject * object, guint prop_id,
     case PROP_BITRATE:
       nvenc->bitrate = g_value_get_uint (value);
       break;
+    case PROP_ASYNC_DEPTH:
+      nvenc->async_depth = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1920,6 +2055,9 @@ gst_nv_base_enc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BITRATE:
       g_value_set_uint (value, nvenc->bitrate);
       break;
+    case PROP_ASYNC_DEPTH:
+      g_value_set_uint (value, nvenc->async_depth);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
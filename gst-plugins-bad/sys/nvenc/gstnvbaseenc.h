@@ -69,6 +69,7 @@ typedef struct {
   gint            qp_max;
   gint            qp_const;
   guint           bitrate;
+  guint           async_depth;
 
   CUcontext       cuda_ctx;
   void          * encoder;
@@ -103,6 +104,9 @@ typedef struct {
   void           *display;            /* GstGLDisplay */
   void           *other_context;      /* GstGLContext */
 
+  /* struct gl_registration of GL memories registered with CUDA */
+  GList          *gl_registrations;   /* registration_lock */
+
   /* the maximum buffer size the encoder is configured for */
   guint               max_encode_width;
   guint               max_encode_height;
@@ -28,6 +28,9 @@
  * |[
  * gst-launch-1.0 -v videotestsrc !  shmsink socket-path=/tmp/blah shm-size=1000000
  * ]| Send video to shm buffers.
+ * |[
+ * gst-launch-1.0 -v v4l2src io-mode=dmabuf ! shmsink socket-path=/tmp/blah pass-fds=true
+ * ]| Send the dmabufs of the capture device to the source without copying.
  * </refsect2>
  */
 #ifdef HAVE_CONFIG_H
@@ -37,6 +40,8 @@
 #include "gstshmsink.h"
 
 #include <gst/gst.h>
+#include <gst/allocators/allocators.h>
+#include <gst/video/video.h>
 
 #include <string.h>
 
@@ -56,7 +61,8 @@ enum
   PROP_PERMS,
   PROP_SHM_SIZE,
   PROP_WAIT_FOR_CONNECTION,
-  PROP_BUFFER_TIME
+  PROP_BUFFER_TIME,
+  PROP_PASS_FDS
 };
 
 struct GstShmClient
@@ -67,6 +73,7 @@ struct GstShmClient
 
 #define DEFAULT_SIZE ( 64 * 1024 * 1024 )
 #define DEFAULT_WAIT_FOR_CONNECTION (TRUE)
+#define DEFAULT_PASS_FDS (FALSE)
 /* Default is user read/write, group read */
 #define DEFAULT_PERMS ( S_IRUSR | S_IWUSR | S_IRGRP )
 
@@ -349,6 +356,7 @@ gst_shm_sink_init (GstShmSink * self)
   self->size = DEFAULT_SIZE;
   self->wait_for_connection = DEFAULT_WAIT_FOR_CONNECTION;
   self->perms = DEFAULT_PERMS;
+  self->pass_fds = DEFAULT_PASS_FDS;
 
   gst_allocation_params_init (&self->params);
 }
@@ -411,6 +419,21 @@ gst_shm_sink_class_init (GstShmSinkClass * klass)
           -1, G_MAXINT64, -1,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstShmSink:pass-fds:
+   *
+   * Send buffers backed by a single file descriptor (e.g. dmabuf) to the
+   * source over the control socket instead of copying them into the shared
+   * memory area. The source must be recent enough to understand this.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PASS_FDS,
+      g_param_spec_boolean ("pass-fds",
+          "Pass file descriptors",
+          "Pass fd-backed buffers as file descriptors instead of copying them",
+          DEFAULT_PASS_FDS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   signals[SIGNAL_CLIENT_CONNECTED] = g_signal_new ("client-connected",
       GST_TYPE_SHM_SINK, G_SIGNAL_RUN_LAST, 0, NULL, NULL,
       g_cclosure_marshal_VOID__INT, G_TYPE_NONE, 1, G_TYPE_INT);
@@ -499,6 +522,11 @@ gst_shm_sink_set_property (GObject * object, guint prop_id,
       GST_OBJECT_UNLOCK (object);
       g_cond_broadcast (&self->cond);
       break;
+    case PROP_PASS_FDS:
+      GST_OBJECT_LOCK (object);
+      self->pass_fds = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       break;
   }
@@ -528,6 +556,9 @@ gst_shm_sink_get_property (GObject * object, guint prop_id,
     case PROP_BUFFER_TIME:
       g_value_set_int64 (value, self->buffer_time);
       break;
+    case PROP_PASS_FDS:
+      g_value_set_boolean (value, self->pass_fds);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -652,6 +683,53 @@ gst_shm_sink_can_render (GstShmSink * self, GstClockTime time)
   return TRUE;
 }
 
+static void
+gst_shm_sink_fill_buffer_info (GstBuffer * buf, ShmBufferInfo * info)
+{
+  GstVideoMeta *vmeta;
+  guint i;
+
+  memset (info, 0, sizeof (ShmBufferInfo));
+  info->pts = GST_BUFFER_PTS (buf);
+  info->dts = GST_BUFFER_DTS (buf);
+  info->duration = GST_BUFFER_DURATION (buf);
+  info->flags = GST_BUFFER_FLAGS (buf);
+
+  vmeta = gst_buffer_get_video_meta (buf);
+  if (vmeta && vmeta->n_planes <= SP_MAX_PLANES) {
+    info->format = vmeta->format;
+    info->width = vmeta->width;
+    info->height = vmeta->height;
+    info->n_planes = vmeta->n_planes;
+    for (i = 0; i < vmeta->n_planes; i++) {
+      info->offset[i] = vmeta->offset[i];
+      info->stride[i] = vmeta->stride[i];
+    }
+  }
+}
+
+/* called with the object lock */
+static GstFlowReturn
+gst_shm_sink_render_fd (GstShmSink * self, GstBuffer * buf, GstMemory * mem)
+{
+  ShmBufferInfo info;
+  int rv;
+
+  gst_shm_sink_fill_buffer_info (buf, &info);
+
+  rv = sp_writer_send_fd (self->pipe, gst_fd_memory_get_fd (mem), mem->offset,
+      mem->size, &info, gst_buffer_ref (buf));
+
+  GST_OBJECT_UNLOCK (self);
+
+  if (rv == 0) {
+    GST_DEBUG_OBJECT (self, "No clients connected, unreffing buffer");
+    gst_buffer_unref (buf);
+  }
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 {
@@ -676,6 +754,15 @@ gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf)
       goto flushing;
   }
 
+  if (self->pass_fds && gst_buffer_n_memory (buf) == 1) {
+    memory = gst_buffer_peek_memory (buf, 0);
+
+    if (memory->allocator != GST_ALLOCATOR (self->allocator) &&
+        gst_is_fd_memory (memory)) {
+      GST_LOG_OBJECT (self, "Passing fd of buffer %p", buf);
+      return gst_shm_sink_render_fd (self, buf, memory);
+    }
+  }
 
   if (gst_buffer_n_memory (buf) > 1) {
     GST_LOG_OBJECT (self, "Buffer %p has %d GstMemory, we only support a single"
@@ -40,6 +40,8 @@
 #include "gstshmsrc.h"
 
 #include <gst/gst.h>
+#include <gst/allocators/allocators.h>
+#include <gst/video/video.h>
 
 #include <string.h>
 
@@ -64,6 +66,14 @@ struct GstShmBuffer
   GstShmPipe *pipe;
 };
 
+struct GstShmFdBuffer
+{
+  unsigned long id;
+  GstShmPipe *pipe;
+};
+
+static GQuark fd_buffer_quark;
+
 
 GST_DEBUG_CATEGORY_STATIC (shmsrc_debug);
 #define GST_CAT_DEFAULT shmsrc_debug
@@ -147,6 +157,8 @@ gst_shm_src_class_init (GstShmSrcClass * klass)
       "Olivier Crete <olivier.crete@collabora.co.uk>");
 
   GST_DEBUG_CATEGORY_INIT (shmsrc_debug, "shmsrc", 0, "Shared Memory Source");
+
+  fd_buffer_quark = g_quark_from_static_string ("GstShmFdBuffer");
 }
 
 static void
@@ -154,6 +166,7 @@ gst_shm_src_init (GstShmSrc * self)
 {
   self->poll = gst_poll_new (TRUE);
   gst_poll_fd_init (&self->pollfd);
+  self->fd_allocator = gst_fd_allocator_new ();
 }
 
 static void
@@ -163,6 +176,7 @@ gst_shm_src_finalize (GObject * object)
 
   gst_poll_free (self->poll);
   g_free (self->socket_path);
+  gst_object_unref (self->fd_allocator);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -317,6 +331,74 @@ free_buffer (gpointer data)
   g_slice_free (struct GstShmBuffer, gsb);
 }
 
+static void
+free_fd_buffer (gpointer data)
+{
+  struct GstShmFdBuffer *gsfb = data;
+  g_return_if_fail (gsfb->pipe != NULL);
+  g_return_if_fail (gsfb->pipe->src != NULL);
+
+  GST_LOG ("Freeing fd buffer %lu", gsfb->id);
+
+  GST_OBJECT_LOCK (gsfb->pipe->src);
+  sp_client_recv_fd_finish (gsfb->pipe->pipe, gsfb->id);
+  GST_OBJECT_UNLOCK (gsfb->pipe->src);
+
+  gst_shm_pipe_dec (gsfb->pipe);
+
+  g_slice_free (struct GstShmFdBuffer, gsfb);
+}
+
+static GstBuffer *
+gst_shm_src_wrap_fd_buffer (GstShmSrc * self, ShmFdBuffer * fdbuf)
+{
+  struct GstShmFdBuffer *gsfb;
+  GstBuffer *buffer;
+  GstMemory *mem;
+
+  GST_LOG_OBJECT (self, "Got fd buffer %lu (fd %d) of size %" G_GSIZE_FORMAT,
+      fdbuf->id, fdbuf->fd, fdbuf->size);
+
+  /* the memory owns the fd from now on */
+  mem = gst_fd_allocator_alloc (self->fd_allocator, fdbuf->fd,
+      fdbuf->offset + fdbuf->size, GST_FD_MEMORY_FLAG_NONE);
+  gst_memory_resize (mem, fdbuf->offset, fdbuf->size);
+  GST_MINI_OBJECT_FLAG_SET (mem, GST_MEMORY_FLAG_READONLY);
+
+  /* ack the buffer once the memory is gone, it may outlive the buffer */
+  gsfb = g_slice_new0 (struct GstShmFdBuffer);
+  gsfb->id = fdbuf->id;
+  gsfb->pipe = self->pipe;
+  gst_shm_pipe_inc (self->pipe);
+  gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (mem), fd_buffer_quark,
+      gsfb, free_fd_buffer);
+
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, mem);
+
+  GST_BUFFER_PTS (buffer) = fdbuf->info.pts;
+  GST_BUFFER_DTS (buffer) = fdbuf->info.dts;
+  GST_BUFFER_DURATION (buffer) = fdbuf->info.duration;
+  GST_MINI_OBJECT_FLAGS (buffer) = fdbuf->info.flags;
+
+  if (fdbuf->info.n_planes > 0 && fdbuf->info.n_planes <= SP_MAX_PLANES) {
+    gsize offset[GST_VIDEO_MAX_PLANES] = { 0, };
+    gint stride[GST_VIDEO_MAX_PLANES] = { 0, };
+    guint i;
+
+    for (i = 0; i < fdbuf->info.n_planes; i++) {
+      offset[i] = fdbuf->info.offset[i];
+      stride[i] = fdbuf->info.stride[i];
+    }
+
+    gst_buffer_add_video_meta_full (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+        fdbuf->info.format, fdbuf->info.width, fdbuf->info.height,
+        fdbuf->info.n_planes, offset, stride);
+  }
+
+  return buffer;
+}
+
 static GstFlowReturn
 gst_shm_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
 {
@@ -324,6 +406,9 @@ gst_shm_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   gchar *buf = NULL;
   int rv = 0;
   struct GstShmBuffer *gsb;
+  ShmFdBuffer fdbuf;
+
+  fdbuf.fd = -1;
 
   do {
     if (gst_poll_wait (self->poll, GST_CLOCK_TIME_NONE) < 0) {
@@ -353,7 +438,7 @@ gst_shm_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
       buf = NULL;
       GST_LOG_OBJECT (self, "Reading from pipe");
       GST_OBJECT_LOCK (self);
-      rv = sp_client_recv (self->pipe->pipe, &buf);
+      rv = sp_client_recv_full (self->pipe->pipe, &buf, &fdbuf);
       GST_OBJECT_UNLOCK (self);
       if (rv < 0) {
         GST_ELEMENT_ERROR (self, RESOURCE, READ, ("Failed to read from shmsrc"),
@@ -361,7 +446,12 @@ gst_shm_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
         return GST_FLOW_ERROR;
       }
     }
-  } while (buf == NULL);
+  } while (buf == NULL && fdbuf.fd < 0);
+
+  if (fdbuf.fd >= 0) {
+    *outbuf = gst_shm_src_wrap_fd_buffer (self, &fdbuf);
+    return GST_FLOW_OK;
+  }
 
   GST_LOG_OBJECT (self, "Got buffer %p of size %d", buf, rv);
 
@@ -67,7 +67,16 @@
  * type 4: ack buffer
  * offset
  *
- * Type 4 goes from the client to the server
+ * type 5: fd buffer
+ * id
+ * offset
+ * bufsize
+ * (followed by a ShmBufferInfo, the fd is passed with SCM_RIGHTS)
+ *
+ * type 6: ack fd buffer
+ * id
+ *
+ * Type 4 and 6 go from the client to the server
  * The rest are from the server to the client
  * The client should never write in the SHM
  */
@@ -80,7 +89,9 @@ enum
   COMMAND_NEW_SHM_AREA = 1,
   COMMAND_CLOSE_SHM_AREA = 2,
   COMMAND_NEW_BUFFER = 3,
-  COMMAND_ACK_BUFFER = 4
+  COMMAND_ACK_BUFFER = 4,
+  COMMAND_NEW_FD_BUFFER = 5,
+  COMMAND_ACK_FD_BUFFER = 6
 };
 
 typedef struct _ShmArea ShmArea;
@@ -108,6 +119,7 @@ struct _ShmBuffer
 {
   int use_count;
 
+  /* NULL for buffers passed as a fd, offset is then the id */
   ShmArea *shm_area;
   unsigned long offset;
   size_t size;
@@ -136,6 +148,7 @@ struct _ShmPipe
   int next_area_id;
 
   ShmBuffer *buffers;
+  unsigned long next_fd_buffer_id;
 
   int num_clients;
   ShmClient *clients;
@@ -179,6 +192,12 @@ struct CommandBuffer
     {
       unsigned long offset;
     } ack_buffer;
+    struct
+    {
+      unsigned long id;
+      unsigned long offset;
+      unsigned long size;
+    } fd_buffer;
   } payload;
 };
 
@@ -485,6 +504,41 @@ send_command (int fd, struct CommandBuffer *cb, unsigned short int type,
   return 1;
 }
 
+static int
+send_command_with_fd (int fd, struct CommandBuffer *cb,
+    unsigned short int type, int passed_fd)
+{
+  struct msghdr msg = { 0 };
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  union
+  {
+    char buf[CMSG_SPACE (sizeof (int))];
+    struct cmsghdr align;
+  } control;
+
+  cb->type = type;
+  cb->area_id = 0;
+
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+  cmsg = CMSG_FIRSTHDR (&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN (sizeof (int));
+  memcpy (CMSG_DATA (cmsg), &passed_fd, sizeof (int));
+
+  if (sendmsg (fd, &msg, MSG_NOSIGNAL) != sizeof (struct CommandBuffer))
+    return 0;
+
+  return 1;
+}
+
 int
 sp_writer_resize (ShmPipe * self, size_t size)
 {
@@ -639,6 +693,59 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void *tag)
   return c;
 }
 
+/* Returns the number of clients this has successfully been sent to, the
+ * fd is not closed and must stay valid until the buffer is acked by all */
+
+int
+sp_writer_send_fd (ShmPipe * self, int fd, size_t offset, size_t size,
+    const ShmBufferInfo * info, void *tag)
+{
+  ShmBuffer *sb;
+  ShmClient *client = NULL;
+  unsigned long id;
+  int i = 0;
+  int c = 0;
+
+  if (self->num_clients == 0)
+    return 0;
+
+  id = ++self->next_fd_buffer_id;
+
+  sb = spalloc_alloc (sizeof (ShmBuffer) + sizeof (int) * self->num_clients);
+  memset (sb, 0, sizeof (ShmBuffer));
+  memset (sb->clients, -1, sizeof (int) * self->num_clients);
+  sb->offset = id;
+  sb->size = size;
+  sb->num_clients = self->num_clients;
+  sb->tag = tag;
+
+  for (client = self->clients; client; client = client->next) {
+    struct CommandBuffer cb = { 0 };
+    cb.payload.fd_buffer.id = id;
+    cb.payload.fd_buffer.offset = offset;
+    cb.payload.fd_buffer.size = size;
+    if (!send_command_with_fd (client->fd, &cb, COMMAND_NEW_FD_BUFFER, fd))
+      continue;
+    if (send (client->fd, info, sizeof (ShmBufferInfo), MSG_NOSIGNAL) !=
+        sizeof (ShmBufferInfo))
+      continue;
+    sb->clients[i++] = client->fd;
+    c++;
+  }
+
+  if (c == 0) {
+    spalloc_free1 (sizeof (ShmBuffer) + sizeof (int) * sb->num_clients, sb);
+    return 0;
+  }
+
+  sb->use_count = c;
+
+  sb->next = self->buffers;
+  self->buffers = sb;
+
+  return c;
+}
+
 static int
 recv_command (int fd, struct CommandBuffer *cb)
 {
@@ -652,18 +759,81 @@ recv_command (int fd, struct CommandBuffer *cb)
   }
 }
 
+/* like recv_command() but also returns a fd passed along with the command,
+ * or -1 */
+static int
+recv_command_with_fd (int fd, struct CommandBuffer *cb, int *passed_fd)
+{
+  struct msghdr msg = { 0 };
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  union
+  {
+    char buf[CMSG_SPACE (sizeof (int))];
+    struct cmsghdr align;
+  } control;
+  int flags = MSG_DONTWAIT;
+  int retval;
+
+#ifdef MSG_CMSG_CLOEXEC
+  flags |= MSG_CMSG_CLOEXEC;
+#endif
+
+  *passed_fd = -1;
+
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+  retval = recvmsg (fd, &msg, flags);
+  if (retval < 0)
+    return 0;
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len >= CMSG_LEN (sizeof (int)))
+      memcpy (passed_fd, CMSG_DATA (cmsg), sizeof (int));
+  }
+
+  if (retval == sizeof (struct CommandBuffer))
+    return 1;
+
+  if (*passed_fd >= 0) {
+    close (*passed_fd);
+    *passed_fd = -1;
+  }
+  return 0;
+}
+
 long int
 sp_client_recv (ShmPipe * self, char **buf)
+{
+  return sp_client_recv_full (self, buf, NULL);
+}
+
+/* Like sp_client_recv(), but buffers passed as a fd are returned in @fdbuf,
+ * *buf is left to NULL for those. When @fdbuf is NULL they are dropped. */
+long int
+sp_client_recv_full (ShmPipe * self, char **buf, ShmFdBuffer * fdbuf)
 {
   char *area_name = NULL;
   ShmArea *newarea;
   ShmArea *area;
   struct CommandBuffer cb;
+  int passed_fd;
   int retval;
 
-  if (!recv_command (self->main_socket, &cb))
+  if (!recv_command_with_fd (self->main_socket, &cb, &passed_fd))
     return -1;
 
+  if (passed_fd >= 0 && cb.type != COMMAND_NEW_FD_BUFFER) {
+    close (passed_fd);
+    passed_fd = -1;
+  }
+
   switch (cb.type) {
     case COMMAND_NEW_SHM_AREA:
       assert (cb.payload.new_shm_area.path_size > 0);
@@ -709,6 +879,33 @@ sp_client_recv (ShmPipe * self, char **buf)
       }
       return -23;
 
+    case COMMAND_NEW_FD_BUFFER:
+    {
+      ShmBufferInfo info;
+
+      if (passed_fd < 0)
+        return -24;
+
+      retval = recv (self->main_socket, &info, sizeof (ShmBufferInfo), 0);
+      if (retval != sizeof (ShmBufferInfo)) {
+        close (passed_fd);
+        return -25;
+      }
+
+      if (!fdbuf) {
+        close (passed_fd);
+        sp_client_recv_fd_finish (self, cb.payload.fd_buffer.id);
+        return 0;
+      }
+
+      fdbuf->fd = passed_fd;
+      fdbuf->id = cb.payload.fd_buffer.id;
+      fdbuf->offset = cb.payload.fd_buffer.offset;
+      fdbuf->size = cb.payload.fd_buffer.size;
+      fdbuf->info = info;
+      return cb.payload.fd_buffer.size;
+    }
+
     default:
       return -99;
   }
@@ -729,13 +926,23 @@ sp_writer_recv (ShmPipe * self, ShmClient * client, void **tag)
     case COMMAND_ACK_BUFFER:
 
       for (buf = self->buffers; buf; buf = buf->next) {
-        if (buf->shm_area->id == cb.area_id &&
+        if (buf->shm_area && buf->shm_area->id == cb.area_id &&
             buf->offset == cb.payload.ack_buffer.offset) {
           return sp_shmbuf_dec (self, buf, prev_buf, client, tag);
         }
         prev_buf = buf;
       }
 
+      return -2;
+    case COMMAND_ACK_FD_BUFFER:
+
+      for (buf = self->buffers; buf; buf = buf->next) {
+        if (!buf->shm_area && buf->offset == cb.payload.ack_buffer.offset) {
+          return sp_shmbuf_dec (self, buf, prev_buf, client, tag);
+        }
+        prev_buf = buf;
+      }
+
       return -2;
     default:
       return -99;
@@ -768,6 +975,15 @@ sp_client_recv_finish (ShmPipe * self, char *buf)
       self->shm_area->id);
 }
 
+int
+sp_client_recv_fd_finish (ShmPipe * self, unsigned long id)
+{
+  struct CommandBuffer cb = { 0 };
+
+  cb.payload.ack_buffer.offset = id;
+  return send_command (self->main_socket, &cb, COMMAND_ACK_FD_BUFFER, 0);
+}
+
 ShmPipe *
 sp_client_open (const char *path)
 {
@@ -883,8 +1099,10 @@ sp_shmbuf_dec (ShmPipe * self, ShmBuffer * buf, ShmBuffer * prev_buf,
 
     if (tag)
       *tag = buf->tag;
-    shm_alloc_space_block_dec (buf->ablock);
-    sp_shm_area_dec (self, buf->shm_area);
+    if (buf->shm_area) {
+      shm_alloc_space_block_dec (buf->ablock);
+      sp_shm_area_dec (self, buf->shm_area);
+    }
     spalloc_free1 (sizeof (ShmBuffer) + sizeof (int) * buf->num_clients, buf);
     return 0;
   }
@@ -80,6 +80,35 @@ typedef struct _ShmBuffer ShmBuffer;
 
 typedef void (*sp_buffer_free_callback) (void * tag, void * user_data);
 
+#define SP_MAX_PLANES 4
+
+/* Description of a buffer passed as a file descriptor */
+typedef struct
+{
+  uint64_t pts;
+  uint64_t dts;
+  uint64_t duration;
+  uint32_t flags;
+
+  /* video layout, n_planes is 0 if there is none */
+  uint32_t format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t n_planes;
+  uint64_t offset[SP_MAX_PLANES];
+  int32_t stride[SP_MAX_PLANES];
+} ShmBufferInfo;
+
+/* A buffer received as a file descriptor, the fd is owned by the receiver */
+typedef struct
+{
+  int fd;
+  unsigned long id;
+  size_t offset;
+  size_t size;
+  ShmBufferInfo info;
+} ShmFdBuffer;
+
 ShmPipe *sp_writer_create (const char *path, size_t size, mode_t perms);
 const char *sp_writer_get_path (ShmPipe *pipe);
 void sp_writer_close (ShmPipe * self, sp_buffer_free_callback callback,
@@ -97,6 +126,8 @@ int sp_writer_get_client_fd (ShmClient * client);
 ShmBlock *sp_writer_alloc_block (ShmPipe * self, size_t size);
 void sp_writer_free_block (ShmBlock *block);
 int sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void * tag);
+int sp_writer_send_fd (ShmPipe * self, int fd, size_t offset, size_t size,
+    const ShmBufferInfo * info, void * tag);
 char *sp_writer_block_get_buf (ShmBlock *block);
 ShmPipe *sp_writer_block_get_pipe (ShmBlock *block);
 size_t sp_writer_get_max_buf_size (ShmPipe * self);
@@ -114,7 +145,9 @@ void *sp_writer_buf_get_tag (ShmBuffer * buffer);
 
 ShmPipe *sp_client_open (const char *path);
 long int sp_client_recv (ShmPipe * self, char **buf);
+long int sp_client_recv_full (ShmPipe * self, char **buf, ShmFdBuffer * fdbuf);
 int sp_client_recv_finish (ShmPipe * self, char *buf);
+int sp_client_recv_fd_finish (ShmPipe * self, unsigned long id);
 void sp_client_close (ShmPipe * self);
 
 #ifdef __cplusplus
@@ -1550,6 +1550,86 @@ GST_START_TEST (test_sync)
 
 GST_END_TEST;
 
+static void
+send_buffers_sync_gap (GstPad * pad1, GstPad * pad2)
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  GstFlowReturn ret;
+
+  buffer = gst_buffer_new_and_alloc (2000);
+  gst_buffer_memset (buffer, 0, 0, 2000);
+  GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_GAP);
+  GST_BUFFER_TIMESTAMP (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) = 1 * GST_SECOND;
+  GST_DEBUG ("pushing buffer %p", buffer);
+  ret = gst_pad_chain (pad1, buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+
+  gst_pad_send_event (pad1, gst_event_new_eos ());
+
+  buffer = gst_buffer_new_and_alloc (2000);
+  gst_buffer_memset (buffer, 0, 0, 2000);
+  GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_GAP);
+  GST_BUFFER_TIMESTAMP (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) = 1 * GST_SECOND;
+  GST_DEBUG ("pushing buffer %p", buffer);
+  ret = gst_pad_chain (pad2, buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+
+  buffer = gst_buffer_new_and_alloc (2000);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  memset (map.data, 2, map.size);
+  gst_buffer_unmap (buffer, &map);
+  GST_BUFFER_TIMESTAMP (buffer) = 1 * GST_SECOND;
+  GST_BUFFER_DURATION (buffer) = 1 * GST_SECOND;
+  GST_DEBUG ("pushing buffer %p", buffer);
+  ret = gst_pad_chain (pad2, buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+
+  gst_pad_send_event (pad2, gst_event_new_eos ());
+}
+
+static void
+check_buffers_sync_gap (GList * received_buffers)
+{
+  GstBuffer *buffer;
+  GList *l;
+  gint i;
+  GstMapInfo map;
+
+  /* Should have 4 * 0.5s buffers, the first two only made of GAP input */
+  fail_unless_equals_int (g_list_length (received_buffers), 4);
+  for (i = 0, l = received_buffers; l; l = l->next, i++) {
+    buffer = l->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+
+    if (i < 2) {
+      fail_unless (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP));
+      fail_unless (map.data[0] == 0);
+      fail_unless (map.data[map.size - 1] == 0);
+    } else {
+      fail_if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP));
+      fail_unless (map.data[0] == 2);
+      fail_unless (map.data[map.size - 1] == 2);
+    }
+
+    gst_buffer_unmap (buffer, &map);
+  }
+
+  /* silent output buffers share their memory */
+  fail_unless (gst_buffer_peek_memory (received_buffers->data, 0) ==
+      gst_buffer_peek_memory (received_buffers->next->data, 0));
+}
+
+GST_START_TEST (test_sync_gap)
+{
+  run_sync_test (send_buffers_sync_gap, check_buffers_sync_gap);
+}
+
+GST_END_TEST;
+
 static void
 send_buffers_sync_discont (GstPad * pad1, GstPad * pad2)
 {
@@ -1932,6 +2012,7 @@ audiomixer_suite (void)
   tcase_add_test (tc_chain, test_flush_start_flush_stop);
   tcase_add_test (tc_chain, test_sync);
   tcase_add_test (tc_chain, test_sync_discont);
+  tcase_add_test (tc_chain, test_sync_gap);
   tcase_add_test (tc_chain, test_sync_unaligned);
   tcase_add_test (tc_chain, test_segment_base_handling);
   tcase_add_test (tc_chain, test_sinkpad_property_controller);
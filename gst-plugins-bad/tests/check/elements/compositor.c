@@ -2068,6 +2068,80 @@ GST_START_TEST (test_start_time_first_live_drop_3_unlinked_1)
 
 GST_END_TEST;
 
+static GstBuffer *
+run_n_threads_pipeline (const gchar * format, guint n_threads)
+{
+  GstElement *pipeline, *sink;
+  GstBuffer *buffer;
+  GstMessage *msg;
+  GstBus *bus;
+  gchar *desc;
+
+  desc = g_strdup_printf ("videotestsrc num-buffers=1 pattern=ball ! "
+      "video/x-raw,format=%s,width=320,height=239 ! c.sink_0 "
+      "videotestsrc num-buffers=1 pattern=smpte ! "
+      "video/x-raw,format=%s,width=100,height=75 ! c.sink_1 "
+      "compositor name=c n-threads=%u sink_1::xpos=-13 sink_1::ypos=37 "
+      "sink_1::alpha=0.5 ! fakesink name=sink signal-handoffs=true",
+      format, format, n_threads);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_object_unref (sink);
+
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  fail_unless (handoff_buffer != NULL);
+  buffer = handoff_buffer;
+  handoff_buffer = NULL;
+
+  return buffer;
+}
+
+GST_START_TEST (test_n_threads)
+{
+  const gchar *formats[] = { "I420", "AYUV", "YUY2", "NV12" };
+  guint i;
+
+  main_loop = NULL;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstBuffer *serial, *parallel;
+    GstMapInfo map;
+
+    GST_INFO ("testing format %s", formats[i]);
+
+    serial = run_n_threads_pipeline (formats[i], 1);
+    parallel = run_n_threads_pipeline (formats[i], 3);
+
+    /* the stripes must put together the same picture */
+    fail_unless_equals_int (gst_buffer_get_size (serial),
+        gst_buffer_get_size (parallel));
+    fail_unless (gst_buffer_map (serial, &map, GST_MAP_READ));
+    fail_unless (gst_buffer_memcmp (parallel, 0, map.data, map.size) == 0);
+    gst_buffer_unmap (serial, &map);
+
+    gst_buffer_unref (serial);
+    gst_buffer_unref (parallel);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 compositor_suite (void)
 {
@@ -2101,6 +2175,7 @@ compositor_suite (void)
   tcase_add_test (tc_chain, test_start_time_first_live_drop_0);
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3);
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3_unlinked_1);
+  tcase_add_test (tc_chain, test_n_threads);
 
   return s;
 }
@@ -49,6 +49,7 @@ GST_START_TEST (test_properties)
   gchar *res_proxy_passwd;
   gchar *res_content_type;
   gboolean res_use_content_length;
+  gint res_max_parallel_uploads;
 
   sink = setup_curlhttpsink ();
 
@@ -61,7 +62,8 @@ GST_START_TEST (test_properties)
       "proxy-port", 7777,
       "proxy-user", "proxy_user",
       "proxy-passwd", "proxy_passwd",
-      "content-type", "image/jpeg", "use-content-length", TRUE, NULL);
+      "content-type", "image/jpeg", "use-content-length", TRUE,
+      "max-parallel-uploads", 4, NULL);
 
   g_object_get (sink,
       "location", &res_location,
@@ -73,7 +75,8 @@ GST_START_TEST (test_properties)
       "proxy-user", &res_proxy_user,
       "proxy-passwd", &res_proxy_passwd,
       "content-type", &res_content_type,
-      "use-content-length", &res_use_content_length, NULL);
+      "use-content-length", &res_use_content_length,
+      "max-parallel-uploads", &res_max_parallel_uploads, NULL);
 
   fail_unless (strncmp (res_location, "mylocation", strlen ("mylocation"))
       == 0);
@@ -90,6 +93,7 @@ GST_START_TEST (test_properties)
   fail_unless (strncmp (res_content_type, "image/jpeg", strlen ("image/jpeg"))
       == 0);
   fail_unless (res_use_content_length == TRUE);
+  fail_unless (res_max_parallel_uploads == 4);
 
   g_free (res_location);
   g_free (res_file_name);
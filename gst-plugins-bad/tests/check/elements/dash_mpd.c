@@ -4688,6 +4688,100 @@ GST_START_TEST (dash_mpdparser_segment_timeline)
 
 GST_END_TEST;
 
+/*
+ * Test seeking in a SegmentTimeline with several S runs, including a gap
+ *
+ */
+GST_START_TEST (dash_mpdparser_segment_timeline_seek)
+{
+  GList *adaptationSets;
+  GstAdaptationSetNode *adapt_set;
+  GstActiveStream *activeStream;
+  GstClockTime final_ts;
+
+  const gchar *xml =
+      "<?xml version=\"1.0\"?>"
+      "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\""
+      "     profiles=\"urn:mpeg:dash:profile:isoff-main:2011\""
+      "     mediaPresentationDuration=\"P0Y0M0DT0H0M30S\">"
+      "  <Period start=\"P0Y0M0DT0H0M0S\">"
+      "    <AdaptationSet mimeType=\"video/mp4\">"
+      "      <Representation id=\"1\" bandwidth=\"250000\">"
+      "        <SegmentTemplate media=\"$Number$.mp4\" timescale=\"1\">"
+      "          <SegmentTimeline>"
+      "            <S t=\"0\"  d=\"2\" r=\"2\"></S>"
+      "            <S d=\"3\" r=\"1\"></S>"
+      "            <S t=\"20\" d=\"4\"></S>"
+      "          </SegmentTimeline>"
+      "        </SegmentTemplate>"
+      "      </Representation></AdaptationSet></Period></MPD>";
+
+  gboolean ret;
+  GstMpdClient *mpdclient = gst_mpd_client_new ();
+
+  ret = gst_mpd_parse (mpdclient, xml, (gint) strlen (xml));
+  assert_equals_int (ret, TRUE);
+
+  /* process the xml data */
+  ret =
+      gst_mpd_client_setup_media_presentation (mpdclient, GST_CLOCK_TIME_NONE,
+      -1, NULL);
+  assert_equals_int (ret, TRUE);
+
+  adaptationSets = gst_mpd_client_get_adaptation_sets (mpdclient);
+  fail_if (adaptationSets == NULL);
+  adapt_set = (GstAdaptationSetNode *) g_list_nth_data (adaptationSets, 0);
+  fail_if (adapt_set == NULL);
+  ret = gst_mpd_client_setup_streaming (mpdclient, adapt_set);
+  assert_equals_int (ret, TRUE);
+
+  activeStream = gst_mpdparser_get_active_stream_by_index (mpdclient, 0);
+  fail_if (activeStream == NULL);
+  assert_equals_int (activeStream->segments->len, 3);
+
+  /* first repeat of the second run */
+  ret = gst_mpd_client_stream_seek (mpdclient, activeStream, TRUE, 0,
+      7 * GST_SECOND, &final_ts);
+  assert_equals_int (ret, TRUE);
+  assert_equals_int (activeStream->segment_index, 1);
+  assert_equals_int (activeStream->segment_repeat_index, 0);
+  assert_equals_uint64 (final_ts, 6 * GST_SECOND);
+
+  /* second repeat of the second run */
+  ret = gst_mpd_client_stream_seek (mpdclient, activeStream, TRUE, 0,
+      9 * GST_SECOND, &final_ts);
+  assert_equals_int (ret, TRUE);
+  assert_equals_int (activeStream->segment_index, 1);
+  assert_equals_int (activeStream->segment_repeat_index, 1);
+  assert_equals_uint64 (final_ts, 9 * GST_SECOND);
+
+  /* in reverse mode, the end of the first run still belongs to it */
+  ret = gst_mpd_client_stream_seek (mpdclient, activeStream, FALSE, 0,
+      6 * GST_SECOND, &final_ts);
+  assert_equals_int (ret, TRUE);
+  assert_equals_int (activeStream->segment_index, 0);
+  assert_equals_int (activeStream->segment_repeat_index, 2);
+  assert_equals_uint64 (final_ts, 4 * GST_SECOND);
+
+  /* last run, after the gap */
+  ret = gst_mpd_client_stream_seek (mpdclient, activeStream, TRUE, 0,
+      21 * GST_SECOND, &final_ts);
+  assert_equals_int (ret, TRUE);
+  assert_equals_int (activeStream->segment_index, 2);
+  assert_equals_int (activeStream->segment_repeat_index, 0);
+  assert_equals_uint64 (final_ts, 20 * GST_SECOND);
+
+  /* inside the gap */
+  ret = gst_mpd_client_stream_seek (mpdclient, activeStream, TRUE, 0,
+      15 * GST_SECOND, &final_ts);
+  assert_equals_int (ret, FALSE);
+  assert_equals_int (activeStream->segment_index, 3);
+
+  gst_mpd_client_free (mpdclient);
+}
+
+GST_END_TEST;
+
 /*
  * Test SegmentList with multiple inherited segmentURLs
  *
@@ -5601,6 +5695,7 @@ dash_suite (void)
   tcase_add_test (tc_complexMPD, dash_mpdparser_segment_list);
   tcase_add_test (tc_complexMPD, dash_mpdparser_segment_template);
   tcase_add_test (tc_complexMPD, dash_mpdparser_segment_timeline);
+  tcase_add_test (tc_complexMPD, dash_mpdparser_segment_timeline_seek);
   tcase_add_test (tc_complexMPD, dash_mpdparser_multiple_inherited_segmentURL);
 
   /* tests checking the parsing of missing/incomplete attributes of xml */
@@ -278,6 +278,98 @@ GST_START_TEST (test_audio_in_one_buffer)
 
 GST_END_TEST;
 
+/* version 2.0 packets with compact headers and a serialized meta, two
+ * buffers in one input buffer come out as a list */
+GST_START_TEST (test_audio_version_2_0)
+{
+  GstCaps *caps;
+  GstElement *gdpdepay;
+  GstBuffer *buffer, *inbuffer, *outbuffer;
+  GstEvent *event;
+  GstSegment segment;
+  GstProtectionMeta *meta;
+  GstMapInfo map;
+  const GstDPHeaderFlag flags = GST_DP_HEADER_FLAG_CRC;
+  const GstDPVersion version = GST_DP_VERSION_2_0;
+
+  gdpdepay = setup_gdpdepay ();
+
+  fail_unless (gst_element_set_state (gdpdepay,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_new_empty_simple ("application/x-gdp");
+  gst_check_setup_events (mysrcpad, gdpdepay, caps, GST_FORMAT_BYTES);
+  gst_caps_unref (caps);
+
+  event = gst_event_new_stream_start ("s-s-id-1234");
+  inbuffer = gst_dp_payload_event_full (event, flags, version);
+  gst_event_unref (event);
+
+  caps = gst_caps_from_string (AUDIO_CAPS_STRING);
+  inbuffer = gst_buffer_append (inbuffer,
+      gst_dp_payload_caps_full (caps, flags, version));
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  event = gst_event_new_segment (&segment);
+  inbuffer = gst_buffer_append (inbuffer,
+      gst_dp_payload_event_full (event, flags, version));
+  gst_event_unref (event);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_buffer_fill (buffer, 0, "f00d", 4);
+  GST_BUFFER_TIMESTAMP (buffer) = GST_SECOND;
+  gst_buffer_add_protection_meta (buffer,
+      gst_structure_new ("application/x-cenc", "iv_size", G_TYPE_UINT, 8,
+          NULL));
+  outbuffer = gst_dp_payload_buffer_full (buffer, flags, version, TRUE);
+  gst_buffer_unref (buffer);
+  /* 10 bytes, a timestamp and the meta length, two CRCs */
+  fail_unless_equals_int (gst_buffer_peek_memory (outbuffer, 0)->size, 26);
+  inbuffer = gst_buffer_append (inbuffer, outbuffer);
+
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_buffer_fill (buffer, 0, "beef", 4);
+  GST_BUFFER_DURATION (buffer) = GST_SECOND / 10;
+  inbuffer = gst_buffer_append (inbuffer,
+      gst_dp_payload_buffer_full (buffer, flags, version, TRUE));
+  gst_buffer_unref (buffer);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, inbuffer), GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+
+  outbuffer = (GstBuffer *) buffers->data;
+  fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (outbuffer), GST_SECOND);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuffer),
+      GST_CLOCK_TIME_NONE);
+  fail_unless_equals_int (gst_buffer_get_size (outbuffer), 4);
+  meta = gst_buffer_get_protection_meta (outbuffer);
+  fail_unless (meta != NULL);
+  fail_unless (gst_structure_has_name (meta->info, "application/x-cenc"));
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  fail_unless (memcmp (map.data, "f00d", 4) == 0);
+  gst_buffer_unmap (outbuffer, &map);
+
+  outbuffer = (GstBuffer *) buffers->next->data;
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuffer), GST_SECOND / 10);
+  fail_unless (gst_buffer_get_protection_meta (outbuffer) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  fail_unless (memcmp (map.data, "beef", 4) == 0);
+  gst_buffer_unmap (outbuffer, &map);
+
+  fail_unless (gst_element_set_state (gdpdepay,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+  ASSERT_OBJECT_REFCOUNT (gdpdepay, "gdpdepay", 1);
+  cleanup_gdpdepay (gdpdepay);
+}
+
+GST_END_TEST;
+
 static GstStaticPadTemplate shsinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -410,6 +502,7 @@ gdpdepay_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_audio_per_byte);
   tcase_add_test (tc_chain, test_audio_in_one_buffer);
+  tcase_add_test (tc_chain, test_audio_version_2_0);
   tcase_add_test (tc_chain, test_streamheader);
 
   return s;
@@ -573,6 +573,64 @@ GST_START_TEST (test_live_playlist_rotated)
 
 GST_END_TEST;
 
+GST_START_TEST (test_live_playlist_incremental_update)
+{
+  GstM3U8Client *client;
+  GstM3U8 *pl;
+  GstM3U8MediaFile *file;
+  GList *second;
+  gchar *live_pl;
+  gboolean ret;
+
+  client = load_playlist (LIVE_PLAYLIST);
+  pl = client->current;
+  assert_equals_int (g_list_length (pl->files), 4);
+  second = g_list_nth (pl->files, 1);
+
+  /* Slide the window by one entry: the first one expires and a new one
+   * with a relative URI and a discontinuity gets appended */
+  live_pl = g_strdup ("#EXTM3U\n\
+#EXT-X-TARGETDURATION:8\n\
+#EXT-X-MEDIA-SEQUENCE:2681\n\
+\n\
+#EXTINF:8,\n\
+https://priv.example.com/fileSequence2681.ts\n\
+#EXTINF:8,\n\
+https://priv.example.com/fileSequence2682.ts\n\
+#EXTINF:8,\n\
+https://priv.example.com/fileSequence2683.ts\n\
+#EXT-X-DISCONTINUITY\n\
+#EXTINF:8,Next\n\
+fileSequence2684.ts");
+  ret = gst_m3u8_client_update (client, live_pl);
+  assert_equals_int (ret, TRUE);
+  assert_equals_int (g_list_length (pl->files), 4);
+  /* The entries that are still in the window have been kept */
+  fail_unless (pl->files == second);
+  file = GST_M3U8_MEDIA_FILE (g_list_first (pl->files)->data);
+  assert_equals_int (file->sequence, 2681);
+  fail_if (file->discont);
+  file = GST_M3U8_MEDIA_FILE (g_list_last (pl->files)->data);
+  assert_equals_int (file->sequence, 2684);
+  assert_equals_string (file->uri,
+      "http://localhost/fileSequence2684.ts");
+  assert_equals_string (file->title, "Next");
+  assert_equals_uint64 (file->duration, 8 * GST_SECOND);
+  fail_unless (file->discont);
+  assert_equals_uint64 (client->duration, 32 * GST_SECOND);
+
+  /* A window moving backwards falls back to a full parse */
+  ret = gst_m3u8_client_update (client, g_strdup (LIVE_PLAYLIST));
+  assert_equals_int (ret, TRUE);
+  assert_equals_int (g_list_length (pl->files), 4);
+  file = GST_M3U8_MEDIA_FILE (g_list_first (pl->files)->data);
+  assert_equals_int (file->sequence, 2680);
+
+  gst_m3u8_client_free (client);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_playlist_with_doubles_duration)
 {
   GstM3U8Client *client;
@@ -1398,6 +1456,7 @@ hlsdemux_suite (void)
   tcase_add_test (tc_m3u8, test_empty_lines_playlist);
   tcase_add_test (tc_m3u8, test_live_playlist);
   tcase_add_test (tc_m3u8, test_live_playlist_rotated);
+  tcase_add_test (tc_m3u8, test_live_playlist_incremental_update);
   tcase_add_test (tc_m3u8, test_update_invalid_playlist);
   tcase_add_test (tc_m3u8, test_update_playlist);
   tcase_add_test (tc_m3u8, test_playlist_media_files);
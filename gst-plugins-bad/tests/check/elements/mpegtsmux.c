@@ -774,6 +774,36 @@ GST_START_TEST (test_align)
 
 GST_END_TEST;
 
+static void
+test_chunked_output_check_output (GList * bufs)
+{
+  gboolean have_multi_packet = FALSE;
+
+  GST_LOG ("%u buffers", g_list_length (bufs));
+  while (bufs != NULL) {
+    GstBuffer *buf = bufs->data;
+    gsize size;
+
+    size = gst_buffer_get_size (buf);
+    GST_LOG ("buffer, size = %5u", (guint) size);
+    fail_unless (size > 0 && size <= 7 * 188);
+    fail_unless (size % 188 == 0);
+    if (size > 188)
+      have_multi_packet = TRUE;
+    bufs = bufs->next;
+  }
+  fail_unless (have_multi_packet);
+}
+
+GST_START_TEST (test_chunked_output)
+{
+  /* without alignment, packets are still written several per buffer */
+  check_tsmux_pad (&video_src_template, VIDEO_CAPS_STRING, 0xE0, 0x1b,
+      "sink_%d", test_chunked_output_check_output, 817, -1, 0);
+}
+
+GST_END_TEST;
+
 static void
 test_keyframe_propagation_check_output (GList * bufs)
 {
@@ -818,6 +848,7 @@ mpegtsmux_suite (void)
   tcase_add_test (tc_chain, test_propagate_flow_status);
   tcase_add_test (tc_chain, test_multiple_state_change);
   tcase_add_test (tc_chain, test_align);
+  tcase_add_test (tc_chain, test_chunked_output);
   tcase_add_test (tc_chain, test_keyframe_flag_propagation);
 
   return s;
@@ -608,6 +608,71 @@ GST_START_TEST (test_display_list)
 
 GST_END_TEST;
 
+GST_START_TEST (test_display_context_pool)
+{
+  GstGLContext *c1 = NULL, *c2 = NULL, *tmp;
+  GError *error = NULL;
+
+  gst_gl_display_set_context_pool_size (display, 2);
+  fail_unless_equals_int (gst_gl_display_get_context_pool_size (display), 2);
+
+  GST_OBJECT_LOCK (display);
+  fail_unless (gst_gl_display_create_context (display, NULL, &c1, &error));
+  fail_if (error != NULL, "Error creating context %s\n",
+      error ? error->message : "Unknown Error");
+  fail_unless (gst_gl_display_add_context (display, c1));
+
+  /* the pool has room for another context */
+  tmp = gst_gl_display_get_gl_context_for_thread (display, NULL);
+  fail_unless (tmp == NULL);
+
+  /* which is created in the same share group */
+  fail_unless (gst_gl_display_create_context (display, NULL, &c2, &error));
+  fail_if (error != NULL, "Error creating context %s\n",
+      error ? error->message : "Unknown Error");
+  fail_unless (gst_gl_display_add_context (display, c2));
+  fail_unless (gst_gl_context_can_share (c1, c2));
+
+  /* both contexts are handed out in turn */
+  tmp = gst_gl_display_get_gl_context_for_thread (display, NULL);
+  fail_unless (tmp == c1 || tmp == c2);
+  {
+    GstGLContext *next =
+        gst_gl_display_get_gl_context_for_thread (display, NULL);
+    fail_unless (next != NULL && next != tmp);
+    gst_object_unref (next);
+  }
+  gst_object_unref (tmp);
+  GST_OBJECT_UNLOCK (display);
+
+  gst_object_unref (c1);
+  gst_object_unref (c2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_display_shared)
+{
+  GstGLDisplay *d1, *d2;
+  gpointer old;
+
+  d1 = gst_gl_display_get_shared ();
+  d2 = gst_gl_display_get_shared ();
+  fail_unless (d1 != NULL);
+  fail_unless (d1 == d2);
+  gst_object_unref (d2);
+
+  /* a new display is created once every user is gone */
+  old = d1;
+  gst_object_unref (d1);
+  d1 = gst_gl_display_get_shared ();
+  fail_unless (d1 != NULL);
+  GST_DEBUG ("previous shared display %p, now %p", old, d1);
+  gst_object_unref (d1);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_gl_context_suite (void)
 {
@@ -622,6 +687,8 @@ gst_gl_context_suite (void)
   tcase_add_test (tc_chain, test_context_can_share);
   tcase_add_test (tc_chain, test_is_shared);
   tcase_add_test (tc_chain, test_display_list);
+  tcase_add_test (tc_chain, test_display_context_pool);
+  tcase_add_test (tc_chain, test_display_shared);
 
   return s;
 }
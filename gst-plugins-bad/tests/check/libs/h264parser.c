@@ -211,6 +211,82 @@ GST_START_TEST (test_h264_parse_slice_eoseq_slice)
 
 GST_END_TEST;
 
+static guint8 h264_sps_pps_idr[] = {
+  0x00, 0x00, 0x00, 0x01, 0x67, 0x4d, 0x40, 0x15,
+  0xec, 0xa4, 0xbf, 0x2e, 0x02, 0x20, 0x00, 0x00,
+  0x03, 0x00, 0x2e, 0xe6, 0xb2, 0x80, 0x01, 0xe2,
+  0xc5, 0xb2, 0xc0,
+  0x00, 0x00, 0x00, 0x01, 0x68, 0xeb, 0xec, 0xb2,
+  0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00,
+  0x10, 0xff, 0xfe, 0xf6, 0xf0, 0xfe, 0x05, 0x36,
+  0x56, 0x04, 0x50, 0x96, 0x7b, 0x3f, 0x53, 0xe1
+};
+
+GST_START_TEST (test_h264_parse_repeated_sps_minimal_slice)
+{
+  GstH264ParserResult res;
+  GstH264NalUnit sps_nalu, pps_nalu, nalu;
+  GstH264SPS sps, sps2;
+  GstH264PPS pps;
+  GstH264SliceHdr slice, slice_min;
+  GstH264NalParser *const parser = gst_h264_nal_parser_new ();
+  const guint8 *buf = h264_sps_pps_idr;
+  guint buf_size = sizeof (h264_sps_pps_idr);
+
+  res = gst_h264_parser_identify_nalu (parser, buf, 0, buf_size, &sps_nalu);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  assert_equals_int (sps_nalu.type, GST_H264_NAL_SPS);
+  res = gst_h264_parser_parse_sps (parser, &sps_nalu, &sps, TRUE);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+
+  res = gst_h264_parser_identify_nalu (parser, buf,
+      sps_nalu.offset + sps_nalu.size, buf_size, &pps_nalu);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  assert_equals_int (pps_nalu.type, GST_H264_NAL_PPS);
+  res = gst_h264_parser_parse_pps (parser, &pps_nalu, &pps);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  gst_h264_pps_clear (&pps);
+
+  /* an identical SPS is taken from the stored one */
+  res = gst_h264_parser_parse_sps (parser, &sps_nalu, &sps2, TRUE);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  assert_equals_int (sps2.id, sps.id);
+  assert_equals_int (sps2.profile_idc, sps.profile_idc);
+  assert_equals_int (sps2.level_idc, sps.level_idc);
+  assert_equals_int (sps2.width, sps.width);
+  assert_equals_int (sps2.height, sps.height);
+  assert_equals_int (sps2.vui_parameters_present_flag,
+      sps.vui_parameters_present_flag);
+  gst_h264_sps_clear (&sps2);
+  gst_h264_sps_clear (&sps);
+
+  /* ... and so is the PPS that was parsed against it */
+  res = gst_h264_parser_parse_pps (parser, &pps_nalu, &pps);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  gst_h264_pps_clear (&pps);
+
+  res = gst_h264_parser_identify_nalu_unchecked (parser, buf,
+      pps_nalu.offset + pps_nalu.size, buf_size, &nalu);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  assert_equals_int (nalu.type, GST_H264_NAL_SLICE_IDR);
+
+  res = gst_h264_parser_parse_slice_hdr (parser, &nalu, &slice, TRUE, TRUE);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  res = gst_h264_parser_parse_slice_hdr_minimal (parser, &nalu, &slice_min);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+
+  assert_equals_int (slice_min.first_mb_in_slice, 0);
+  assert_equals_int (slice_min.first_mb_in_slice, slice.first_mb_in_slice);
+  assert_equals_int (slice_min.type, slice.type);
+  fail_unless (GST_H264_IS_I_SLICE (&slice_min));
+  assert_equals_int (slice_min.frame_num, slice.frame_num);
+  assert_equals_int (slice_min.idr_pic_id, slice.idr_pic_id);
+
+  gst_h264_nal_parser_free (parser);
+}
+
+GST_END_TEST;
+
 static Suite *
 h264parser_suite (void)
 {
@@ -221,6 +297,7 @@ h264parser_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_h264_parse_slice_dpa);
   tcase_add_test (tc_chain, test_h264_parse_slice_eoseq_slice);
+  tcase_add_test (tc_chain, test_h264_parse_repeated_sps_minimal_slice);
 
   return s;
 }
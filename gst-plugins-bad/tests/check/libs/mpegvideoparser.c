@@ -22,6 +22,8 @@
 #include <gst/check/gstcheck.h>
 #include <gst/codecparsers/gstmpegvideoparser.h>
 
+#include <string.h>
+
 /* actually seq + gop */
 static const guint8 mpeg2_seq[] = {
   0x00, 0x00, 0x01, 0xb3, 0x02, 0x00, 0x18, 0x15, 0xff, 0xff, 0xe0, 0x28,
@@ -89,6 +91,37 @@ GST_START_TEST (test_mpeg_parse)
 
 GST_END_TEST;
 
+GST_START_TEST (test_mpeg_parse_start_code_offsets)
+{
+  guint8 data[64];
+  guint i, sc;
+  GstMpegVideoPacket packet;
+
+  /* start codes at every alignment, behind runs of non-zero bytes */
+  for (sc = 0; sc + 5 <= sizeof (data); sc++) {
+    memset (data, 0xff, sizeof (data));
+    data[sc] = 0x00;
+    data[sc + 1] = 0x00;
+    data[sc + 2] = 0x01;
+    data[sc + 3] = GST_MPEG_VIDEO_PACKET_GOP;
+
+    fail_unless (gst_mpeg_video_parse (&packet, data, sizeof (data), 0));
+    assert_equals_int (packet.offset, sc + 4);
+    assert_equals_int (packet.type, GST_MPEG_VIDEO_PACKET_GOP);
+    fail_unless (packet.size < 0);
+  }
+
+  /* a start code without the packet type byte after it is not a packet */
+  memset (data, 0xff, sizeof (data));
+  i = sizeof (data) - 3;
+  data[i] = 0x00;
+  data[i + 1] = 0x00;
+  data[i + 2] = 0x01;
+  fail_if (gst_mpeg_video_parse (&packet, data, sizeof (data), 0));
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_mpeg_parse_sequence_header)
 {
   GstMpegVideoSequenceHdr seqhdr;
@@ -172,6 +205,7 @@ mpegvideoparsers_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_mpeg_parse);
+  tcase_add_test (tc_chain, test_mpeg_parse_start_code_offsets);
   tcase_add_test (tc_chain, test_mpeg_parse_sequence_header);
   tcase_add_test (tc_chain, test_mpeg_parse_sequence_extension);
   tcase_add_test (tc_chain, test_mis_identified_datas);
@@ -59,6 +59,7 @@
 #define DEFAULT_DEVICE		"default"
 #define DEFAULT_DEVICE_NAME	""
 #define DEFAULT_CARD_NAME	""
+#define DEFAULT_USE_MMAP	FALSE
 #define SPDIF_PERIOD_SIZE 1536
 #define SPDIF_BUFFER_SIZE 15360
 
@@ -68,6 +69,7 @@ enum
   PROP_DEVICE,
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
+  PROP_USE_MMAP,
   PROP_LAST
 };
 
@@ -196,6 +198,22 @@ gst_alsasink_class_init (GstAlsaSinkClass * klass)
       g_param_spec_string ("card-name", "Card name",
           "Human-readable name of the sound card", DEFAULT_CARD_NAME,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSink:use-mmap
+   *
+   * Write the samples directly into the memory mapped hardware buffer
+   * instead of going through snd_pcm_writei(), which saves a copy per
+   * segment. Falls back to normal writes if the device doesn't support
+   * mmap access. Useful together with a small #GstAudioBaseSink:latency-time
+   * for low latency output.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Write directly into the memory mapped hardware buffer",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -215,6 +233,9 @@ gst_alsasink_set_property (GObject * object, guint prop_id,
         sink->device = g_strdup (DEFAULT_DEVICE);
       }
       break;
+    case PROP_USE_MMAP:
+      sink->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -243,6 +264,9 @@ gst_alsasink_get_property (GObject * object, guint prop_id,
           gst_alsa_find_card_name (GST_OBJECT_CAST (sink),
               sink->device, SND_PCM_STREAM_PLAYBACK));
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, sink->use_mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -257,6 +281,7 @@ gst_alsasink_init (GstAlsaSink * alsasink)
   alsasink->device = g_strdup (DEFAULT_DEVICE);
   alsasink->handle = NULL;
   alsasink->cached_caps = NULL;
+  alsasink->use_mmap = DEFAULT_USE_MMAP;
   g_mutex_init (&alsasink->alsa_lock);
   g_mutex_init (&alsasink->delay_lock);
 
@@ -442,6 +467,11 @@ retry:
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
   /* set the interleaved read/write format */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access) < 0) {
+    GST_INFO_OBJECT (alsa, "mmap access not supported, using normal writes");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
   /* set the sample format */
@@ -464,6 +494,11 @@ retry:
   rrate = alsa->rate;
   CHECK (snd_pcm_hw_params_set_rate_near (alsa->handle, params, &rrate, NULL),
       no_rate);
+  /* make the buffer a whole number of periods so that the ringbuffer
+   * segments line up exactly with the hardware periods */
+  if ((err = snd_pcm_hw_params_set_periods_integer (alsa->handle, params)) < 0)
+    GST_DEBUG_OBJECT (alsa, "can't restrict to integer periods: %s",
+        snd_strerror (err));
 
 #ifndef GST_DISABLE_GST_DEBUG
   /* get and dump some limits */
@@ -817,7 +852,8 @@ alsasink_parse_spec (GstAlsaSink * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  alsa->access = alsa->use_mmap && !alsa->iec958 ?
+      SND_PCM_ACCESS_MMAP_INTERLEAVED : SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SINK
@@ -975,12 +1011,35 @@ gst_alsasink_close (GstAudioSink * asink)
 /*
  *   Underrun and suspend recovery
  */
+static void
+log_underrun (GstAlsaSink * alsa, snd_pcm_t * handle)
+{
+  snd_pcm_status_t *status;
+  snd_timestamp_t now, trigger;
+  gint64 diff;
+
+  snd_pcm_status_alloca (&status);
+  if (snd_pcm_status (handle, status) < 0 ||
+      snd_pcm_status_get_state (status) != SND_PCM_STATE_XRUN)
+    return;
+
+  /* the trigger timestamp is the moment the underrun happened */
+  snd_pcm_status_get_tstamp (status, &now);
+  snd_pcm_status_get_trigger_tstamp (status, &trigger);
+  diff = ((gint64) now.tv_sec - trigger.tv_sec) * G_USEC_PER_SEC +
+      (now.tv_usec - trigger.tv_usec);
+
+  GST_WARNING_OBJECT (alsa, "underrun of at least %" G_GINT64_FORMAT " us",
+      diff);
+}
+
 static gint
 xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
 {
   GST_WARNING_OBJECT (alsa, "xrun recovery %d: %s", err, g_strerror (-err));
 
   if (err == -EPIPE) {          /* under-run */
+    log_underrun (alsa, handle);
     err = snd_pcm_prepare (handle);
     if (err < 0)
       GST_WARNING_OBJECT (alsa,
@@ -1006,6 +1065,60 @@ xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
   return err;
 }
 
+/* Copies up to @frames frames straight into the memory mapped hardware
+ * buffer. Behaves like snd_pcm_writei() on a non-blocking device: returns
+ * the number of frames written, which can be 0, or a negative error code. */
+static snd_pcm_sframes_t
+mmap_writei (GstAlsaSink * alsa, const guint8 * ptr, snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset, size;
+  snd_pcm_sframes_t avail, written = 0, res;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+
+  frames = MIN (frames, (snd_pcm_uframes_t) avail);
+
+  while (frames > 0) {
+    size = frames;
+    if ((res = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &size)) < 0)
+      goto error;
+
+    /* interleaved, all channels are in the first area */
+    memcpy ((guint8 *) areas[0].addr +
+        (areas[0].first + offset * areas[0].step) / 8, ptr,
+        snd_pcm_frames_to_bytes (alsa->handle, size));
+
+    if ((res = snd_pcm_mmap_commit (alsa->handle, offset, size)) < 0)
+      goto error;
+
+    ptr += snd_pcm_frames_to_bytes (alsa->handle, res);
+    frames -= res;
+    written += res;
+
+    if ((snd_pcm_uframes_t) res != size)
+      break;
+  }
+
+  /* with mmap access the device is not started automatically when the
+   * start threshold is reached, which is when the buffer is full */
+  if (written == avail &&
+      snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED) {
+    GST_DEBUG_OBJECT (alsa, "buffer filled, starting");
+    if ((res = snd_pcm_start (alsa->handle)) < 0)
+      return res;
+  }
+
+  return written;
+
+error:
+  {
+    return written > 0 ? written : res;
+  }
+}
+
 static gint
 gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
 {
@@ -1039,7 +1152,10 @@ gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
       GST_DEBUG_OBJECT (asink, "wait error, %d", err);
     } else {
       GST_DELAY_SINK_LOCK (asink);
-      err = snd_pcm_writei (alsa->handle, ptr, cptr);
+      if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        err = mmap_writei (alsa, ptr, cptr);
+      else
+        err = snd_pcm_writei (alsa->handle, ptr, cptr);
       GST_DELAY_SINK_UNLOCK (asink);
     }
 
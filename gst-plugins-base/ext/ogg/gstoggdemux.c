@@ -62,6 +62,9 @@
 
 #define SEEK_GIVE_UP_THRESHOLD (3*GST_SECOND)
 
+/* minimum distance between two entries of the seek index */
+#define SEEK_INDEX_INTERVAL (GST_SECOND)
+
 #define GST_CHAIN_LOCK(ogg)     g_mutex_lock(&(ogg)->chain_lock)
 #define GST_CHAIN_UNLOCK(ogg)   g_mutex_unlock(&(ogg)->chain_lock)
 
@@ -2061,6 +2064,7 @@ gst_ogg_chain_new (GstOggDemux * ogg)
   chain->bytes = -1;
   chain->have_bos = FALSE;
   chain->streams = g_array_new (FALSE, TRUE, sizeof (GstOggPad *));
+  chain->seek_index = g_array_new (FALSE, FALSE, sizeof (GstOggSeekEntry));
   chain->begin_time = GST_CLOCK_TIME_NONE;
   chain->segment_start = GST_CLOCK_TIME_NONE;
   chain->segment_stop = GST_CLOCK_TIME_NONE;
@@ -2080,6 +2084,7 @@ gst_ogg_chain_free (GstOggChain * chain)
     gst_object_unref (pad);
   }
   g_array_free (chain->streams, TRUE);
+  g_array_free (chain->seek_index, TRUE);
   g_slice_free (GstOggChain, chain);
 }
 
@@ -3010,6 +3015,93 @@ gst_ogg_demux_activate_chain (GstOggDemux * ogg, GstOggChain * chain,
   return TRUE;
 }
 
+/* returns the index of the first seek index entry at or after @time */
+static guint
+gst_ogg_chain_find_seek_entry (GstOggChain * chain, gint64 time)
+{
+  guint lo = 0, hi = chain->seek_index->len;
+
+  while (lo < hi) {
+    guint mid = (lo + hi) / 2;
+
+    if (g_array_index (chain->seek_index, GstOggSeekEntry, mid).time < time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/* Remember where a page with a known time ended, so that later seeks can
+ * start bisecting from a small range instead of the whole chain. Times are
+ * in the chain time domain used by do_binary_search() in pull mode and raw
+ * stream time in push mode. */
+static void
+gst_ogg_demux_record_seek_entry (GstOggDemux * ogg, GstOggPad * pad,
+    gint64 granulepos, gint64 offset)
+{
+  GstOggChain *chain = pad->chain;
+  GstOggSeekEntry entry;
+  GstClockTime time;
+  guint i;
+
+  if (chain == NULL || pad->map.is_skeleton || pad->map.is_sparse)
+    return;
+  if (granulepos <= 0 || offset <= 0)
+    return;
+
+  time = gst_ogg_stream_get_end_time_for_granulepos (&pad->map, granulepos);
+  if (!GST_CLOCK_TIME_IS_VALID (time))
+    return;
+
+  if (ogg->pullmode) {
+    if (!GST_CLOCK_TIME_IS_VALID (pad->start_time) ||
+        !GST_CLOCK_TIME_IS_VALID (chain->begin_time) || time < pad->start_time)
+      return;
+    time = time - pad->start_time + chain->begin_time;
+  }
+
+  /* keep the index sparse */
+  i = gst_ogg_chain_find_seek_entry (chain, time);
+  if (i > 0 && time - g_array_index (chain->seek_index, GstOggSeekEntry,
+          i - 1).time < SEEK_INDEX_INTERVAL)
+    return;
+  if (i < chain->seek_index->len && g_array_index (chain->seek_index,
+          GstOggSeekEntry, i).time - time < SEEK_INDEX_INTERVAL)
+    return;
+
+  GST_LOG_OBJECT (ogg, "index entry %" GST_TIME_FORMAT " at %" G_GINT64_FORMAT,
+      GST_TIME_ARGS (time), offset);
+  entry.offset = offset;
+  entry.time = time;
+  g_array_insert_val (chain->seek_index, i, entry);
+}
+
+/* narrow the given byte and time range down to the closest index entries
+ * around @target */
+static void
+gst_ogg_chain_narrow_seek_range (GstOggChain * chain, gint64 target,
+    gint64 * begin, gint64 * end, gint64 * begintime, gint64 * endtime)
+{
+  guint i = gst_ogg_chain_find_seek_entry (chain, target);
+  GstOggSeekEntry *entry;
+
+  if (i > 0) {
+    entry = &g_array_index (chain->seek_index, GstOggSeekEntry, i - 1);
+    if (entry->offset > *begin && entry->offset < *end) {
+      *begin = entry->offset;
+      *begintime = entry->time;
+    }
+  }
+  if (i < chain->seek_index->len) {
+    entry = &g_array_index (chain->seek_index, GstOggSeekEntry, i);
+    if (entry->offset > *begin && entry->offset < *end) {
+      *end = entry->offset;
+      *endtime = entry->time;
+    }
+  }
+}
+
 static gboolean
 do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
     gint64 end, gint64 begintime, gint64 endtime, gint64 target,
@@ -3019,6 +3111,9 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
   GstFlowReturn ret;
   gint64 result = 0;
 
+  gst_ogg_chain_narrow_seek_range (chain, target, &begin, &end, &begintime,
+      &endtime);
+
   best = begin;
 
   GST_DEBUG_OBJECT (ogg,
@@ -3107,6 +3202,8 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
         GST_LOG_OBJECT (ogg, "granulepos %" G_GINT64_FORMAT " maps to time %"
             GST_TIME_FORMAT, granulepos, GST_TIME_ARGS (granuletime));
 
+        gst_ogg_demux_record_seek_entry (ogg, pad, granulepos, ogg->offset);
+
         granuletime -= pad->start_time;
         granuletime += chain->begin_time;
 
@@ -3236,6 +3333,20 @@ gst_ogg_demux_do_seek (GstOggDemux * ogg, GstSegment * segment,
   endtime = begintime + chain->total_time;
   target = position - total + begintime;
 
+  /* a Skeleton index gives us a keypoint before the target to start from */
+  {
+    gint64 index_offset, index_time;
+
+    if (do_index_search (ogg, chain, begin, end, begintime, endtime, target,
+            &index_offset, &index_time) && index_offset > begin
+        && index_offset < end) {
+      GST_DEBUG_OBJECT (ogg, "Skeleton index keypoint %" GST_TIME_FORMAT
+          " at %" G_GINT64_FORMAT, GST_TIME_ARGS (index_time), index_offset);
+      begin = index_offset;
+      begintime = index_time + chain->begin_time;
+    }
+  }
+
   if (!do_binary_search (ogg, chain, begin, end, begintime, endtime, target,
           &best, FALSE, 0))
     goto seek_error;
@@ -3847,6 +3958,17 @@ gst_ogg_demux_perform_seek_push (GstOggDemux * ogg, GstEvent * event)
   ogg->push_offset1 = ogg->push_byte_length - 1;
   ogg->push_time0 = ogg->push_start_time;
   ogg->push_time1 = ogg->push_time_length;
+
+  /* pages we already went through bracket the target more tightly */
+  if (ogg->push_offset1 > 0) {
+    gint64 time0 = ogg->push_time0, time1 = ogg->push_time1;
+
+    gst_ogg_chain_narrow_seek_range (chain, start, &ogg->push_offset0,
+        &ogg->push_offset1, &time0, &time1);
+    ogg->push_time0 = time0;
+    ogg->push_time1 = time1;
+    best = CLAMP (best, ogg->push_offset0, ogg->push_offset1);
+  }
   ogg->seqnum = gst_event_get_seqnum (event);
   ogg->push_seek_time_target = start;
   ogg->push_prev_seek_time = GST_CLOCK_TIME_NONE;
@@ -4585,6 +4707,17 @@ gst_ogg_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       /* discontinuity in the pages */
       GST_DEBUG_OBJECT (ogg, "discont in page found, continuing");
     } else {
+      GstOggPad *pad = gst_ogg_demux_find_pad (ogg, ogg_page_serialno (&page));
+
+      /* the page ends where the unparsed data in the sync buffer starts */
+      if (pad) {
+        gint64 offset = ogg->pullmode ? ogg->offset : ogg->push_byte_offset;
+
+        gst_ogg_demux_record_seek_entry (ogg, pad,
+            ogg_page_granulepos (&page),
+            offset - (ogg->sync.fill - ogg->sync.returned));
+      }
+
       result = gst_ogg_demux_handle_page (ogg, &page);
       if (result < 0) {
         GST_DEBUG_OBJECT (ogg, "gst_ogg_demux_handle_page returned %d", result);
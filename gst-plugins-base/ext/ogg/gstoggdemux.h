@@ -52,6 +52,13 @@ typedef struct _GstOggDemux GstOggDemux;
 typedef struct _GstOggDemuxClass GstOggDemuxClass;
 typedef struct _GstOggChain GstOggChain;
 
+/* sparse (offset, time) entry of the seek index built while reading */
+typedef struct
+{
+  gint64 offset;                /* offset right after a page */
+  gint64 time;                  /* end time of that page */
+} GstOggSeekEntry;
+
 /* all information needed for one ogg chain (relevant for chained bitstreams) */
 struct _GstOggChain
 {
@@ -73,6 +80,8 @@ struct _GstOggChain
                                    the start times of all streams. */
   GstClockTime segment_stop;    /* the timestamp of the last page, this is the MAX of the
                                    streams. */
+
+  GArray *seek_index;           /* GstOggSeekEntry, sorted by time */
 };
 
 /* all information needed for one ogg stream */
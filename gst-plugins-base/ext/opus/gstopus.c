@@ -23,6 +23,7 @@
 
 #include "gstopusdec.h"
 #include "gstopusenc.h"
+#include "gstopusrepacketizer.h"
 
 #include <gst/tag/tag.h>
 
@@ -38,6 +39,10 @@ plugin_init (GstPlugin * plugin)
           GST_TYPE_OPUS_DEC))
     return FALSE;
 
+  if (!gst_element_register (plugin, "opusrepacketizer", GST_RANK_NONE,
+          GST_TYPE_OPUS_REPACKETIZER))
+    return FALSE;
+
   gst_tag_register_musicbrainz_tags ();
 
   return TRUE;
@@ -515,9 +515,16 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
         GST_TIME_ARGS (aligned_missing_duration), samples,
         GST_TIME_ARGS (dec->leftover_plc_duration));
   } else {
-    /* use maximum size (120 ms) as the number of returned samples is
-       not constant over the stream. */
-    samples = 120 * dec->sample_rate / 1000;
+    /* single stream packets tell their duration, which saves allocating
+       and clearing the maximum size for every packet */
+    samples = 0;
+    if (dec->n_streams == 1)
+      samples = opus_packet_get_nb_samples (data, size, dec->sample_rate);
+
+    /* otherwise use maximum size (120 ms) as the number of returned samples
+       is not constant over the stream. */
+    if (samples <= 0)
+      samples = 120 * dec->sample_rate / 1000;
   }
 
   packet_size = samples * dec->n_channels * 2;
@@ -196,6 +196,10 @@ static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
 #define DEFAULT_DTX             FALSE
 #define DEFAULT_PACKET_LOSS_PERCENT 0
 #define DEFAULT_MAX_PAYLOAD_SIZE 4000
+#define DEFAULT_BATCH_FRAMES    1
+
+/* one second worth of 20 ms frames */
+#define MAX_BATCH_FRAMES        50
 
 enum
 {
@@ -209,9 +213,17 @@ enum
   PROP_INBAND_FEC,
   PROP_DTX,
   PROP_PACKET_LOSS_PERCENT,
-  PROP_MAX_PAYLOAD_SIZE
+  PROP_MAX_PAYLOAD_SIZE,
+  PROP_BATCH_FRAMES
 };
 
+typedef struct
+{
+  gint input_samples, output_samples;
+  guint64 trim_start, trim_end;
+  gint size;
+} GstOpusEncPacket;
+
 static void gst_opus_enc_finalize (GObject * object);
 
 static gboolean gst_opus_enc_sink_event (GstAudioEncoder * benc,
@@ -337,6 +349,21 @@ gst_opus_enc_class_init (GstOpusEncClass * klass)
           DEFAULT_MAX_PAYLOAD_SIZE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_PLAYING));
+  /**
+   * GstOpusEnc:batch-frames:
+   *
+   * Maximum number of frames encoded per call when enough input is queued.
+   * Each frame is still pushed as its own packet, but the packets of a
+   * batch share a single output memory.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      PROP_BATCH_FRAMES, g_param_spec_uint ("batch-frames",
+          "Batch frames", "Maximum number of frames to encode at once", 1,
+          MAX_BATCH_FRAMES, DEFAULT_BATCH_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
 
   gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_opus_enc_finalize);
 
@@ -377,6 +404,7 @@ gst_opus_enc_init (GstOpusEnc * enc)
   enc->dtx = DEFAULT_DTX;
   enc->packet_loss_percentage = DEFAULT_PACKET_LOSS_PERCENT;
   enc->max_payload_size = DEFAULT_MAX_PAYLOAD_SIZE;
+  enc->batch_frames = DEFAULT_BATCH_FRAMES;
   enc->audio_type = DEFAULT_AUDIO_TYPE;
 }
 
@@ -423,7 +451,7 @@ gst_opus_enc_setup_base_class (GstOpusEnc * enc, GstAudioEncoder * benc)
       gst_opus_enc_get_latency (enc), gst_opus_enc_get_latency (enc));
   gst_audio_encoder_set_frame_samples_min (benc, enc->frame_samples);
   gst_audio_encoder_set_frame_samples_max (benc, enc->frame_samples);
-  gst_audio_encoder_set_frame_max (benc, 1);
+  gst_audio_encoder_set_frame_max (benc, enc->batch_frames);
 }
 
 static gint
@@ -900,13 +928,13 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
   gint ret = GST_FLOW_OK;
   GstMapInfo map;
   GstMapInfo omap;
-  gint outsize;
-  GstBuffer *outbuf;
+  GstBuffer *outbuf, *packet;
   GstSegment *segment;
   GstClockTime duration;
-  guint64 trim_start = 0, trim_end = 0;
+  GstOpusEncPacket packets[MAX_BATCH_FRAMES];
+  gint n_frames = 1, i;
 
-  guint max_payload_size;
+  guint max_payload_size, slot_size;
   gint frame_samples, input_samples, output_samples;
 
   g_mutex_lock (&enc->property_lock);
@@ -917,6 +945,8 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
 
   g_mutex_unlock (&enc->property_lock);
 
+  memset (packets, 0, sizeof (packets));
+
   if (G_LIKELY (buf)) {
     gst_buffer_map (buf, &map, GST_MAP_READ);
     bdata = map.data;
@@ -956,13 +986,15 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
             "%" G_GINT64_FORMAT " extra samples of padding in this frame",
             diff);
         output_samples = frame_samples - diff;
-        trim_end = diff * 48000 / enc->sample_rate;
+        packets[0].trim_end = diff * 48000 / enc->sample_rate;
       } else {
         GST_DEBUG_OBJECT (enc,
             "Need to add %" G_GINT64_FORMAT " extra samples in the next frame",
             -diff);
         output_samples = frame_samples;
       }
+      packets[0].input_samples = input_samples;
+      packets[0].output_samples = output_samples;
 
       size = ((bsize / bytes) + 1) * bytes;
       mdata = g_malloc0 (size);
@@ -976,22 +1008,32 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
       data = bdata;
       size = bsize;
 
-      /* Adjust for lookahead here */
-      if (enc->pending_lookahead) {
-        guint scaled_lookahead =
-            enc->pending_lookahead * enc->sample_rate / 48000;
-
-        if (input_samples > scaled_lookahead) {
-          output_samples = input_samples - scaled_lookahead;
-          trim_start = enc->pending_lookahead;
-          enc->pending_lookahead = 0;
+      /* The base class hands over up to batch-frames complete frames at
+       * once, each of them becomes its own packet */
+      n_frames = size / bytes;
+      g_assert (n_frames <= MAX_BATCH_FRAMES);
+
+      for (i = 0; i < n_frames; i++) {
+        packets[i].input_samples = input_samples;
+
+        /* Adjust for lookahead here */
+        if (enc->pending_lookahead) {
+          guint scaled_lookahead =
+              enc->pending_lookahead * enc->sample_rate / 48000;
+
+          if (input_samples > scaled_lookahead) {
+            packets[i].output_samples = input_samples - scaled_lookahead;
+            packets[i].trim_start = enc->pending_lookahead;
+            enc->pending_lookahead = 0;
+          } else {
+            packets[i].trim_start =
+                ((guint64) input_samples) * 48000 / enc->sample_rate;
+            enc->pending_lookahead -= packets[i].trim_start;
+            packets[i].output_samples = 0;
+          }
         } else {
-          trim_start = ((guint64) input_samples) * 48000 / enc->sample_rate;
-          enc->pending_lookahead -= trim_start;
-          output_samples = 0;
+          packets[i].output_samples = input_samples;
         }
-      } else {
-        output_samples = input_samples;
       }
     }
   } else {
@@ -1003,9 +1045,10 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
       data = mdata = g_malloc0 (bytes);
       size = bytes;
       output_samples = enc->consumed_samples - enc->encoded_samples;
-      input_samples = 0;
       GST_DEBUG_OBJECT (enc, "draining %d samples", output_samples);
-      trim_end =
+      packets[0].input_samples = 0;
+      packets[0].output_samples = output_samples;
+      packets[0].trim_end =
           ((guint64) frame_samples - output_samples) * 48000 / enc->sample_rate;
     } else if (enc->encoded_samples == enc->consumed_samples) {
       GST_DEBUG_OBJECT (enc, "nothing to drain");
@@ -1016,54 +1059,80 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
     }
   }
 
-  g_assert (size == bytes);
+  g_assert (size == bytes * n_frames);
 
+  /* All packets of a batch are encoded into a single memory and pushed as
+   * sub-buffers of it, instead of allocating one buffer per packet */
+  slot_size = max_payload_size * enc->n_channels;
   outbuf =
       gst_audio_encoder_allocate_output_buffer (GST_AUDIO_ENCODER (enc),
-      max_payload_size * enc->n_channels);
+      slot_size * n_frames);
   if (!outbuf)
     goto done;
 
-  GST_DEBUG_OBJECT (enc, "encoding %d samples (%d bytes)",
-      frame_samples, (int) bytes);
-
-  if (trim_start || trim_end) {
-    GST_DEBUG_OBJECT (enc,
-        "Adding trim-start %" G_GUINT64_FORMAT " trim-end %" G_GUINT64_FORMAT,
-        trim_start, trim_end);
-    gst_buffer_add_audio_clipping_meta (outbuf, GST_FORMAT_DEFAULT, trim_start,
-        trim_end);
-  }
+  GST_DEBUG_OBJECT (enc, "encoding %d frames of %d samples (%d bytes)",
+      n_frames, frame_samples, (int) bytes);
 
   gst_buffer_map (outbuf, &omap, GST_MAP_WRITE);
 
-  outsize =
-      opus_multistream_encode (enc->state, (const gint16 *) data,
-      frame_samples, omap.data, max_payload_size * enc->n_channels);
+  for (i = 0; i < n_frames; i++) {
+    gint outsize;
+
+    outsize =
+        opus_multistream_encode (enc->state,
+        (const gint16 *) (data + i * bytes), frame_samples,
+        omap.data + i * slot_size, slot_size);
+
+    if (outsize < 0) {
+      GST_ERROR_OBJECT (enc, "Encoding failed: %d", outsize);
+      ret = GST_FLOW_ERROR;
+      break;
+    } else if (outsize > max_payload_size) {
+      GST_WARNING_OBJECT (enc,
+          "Encoded size %d is higher than max payload size (%d bytes)",
+          outsize, max_payload_size);
+      ret = GST_FLOW_ERROR;
+      break;
+    }
+
+    GST_DEBUG_OBJECT (enc, "Output packet is %u bytes", outsize);
+    packets[i].size = outsize;
+  }
 
   gst_buffer_unmap (outbuf, &omap);
 
-  if (outsize < 0) {
-    GST_ERROR_OBJECT (enc, "Encoding failed: %d", outsize);
-    ret = GST_FLOW_ERROR;
-    goto done;
-  } else if (outsize > max_payload_size) {
-    GST_WARNING_OBJECT (enc,
-        "Encoded size %d is higher than max payload size (%d bytes)",
-        outsize, max_payload_size);
-    ret = GST_FLOW_ERROR;
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_unref (outbuf);
     goto done;
   }
 
-  GST_DEBUG_OBJECT (enc, "Output packet is %u bytes", outsize);
-  gst_buffer_set_size (outbuf, outsize);
+  for (i = 0; i < n_frames && ret == GST_FLOW_OK; i++) {
+    if (n_frames == 1) {
+      packet = outbuf;
+      gst_buffer_set_size (packet, packets[i].size);
+      outbuf = NULL;
+    } else {
+      packet = gst_buffer_copy_region (outbuf, GST_BUFFER_COPY_MEMORY,
+          i * slot_size, packets[i].size);
+    }
 
+    if (packets[i].trim_start || packets[i].trim_end) {
+      GST_DEBUG_OBJECT (enc,
+          "Adding trim-start %" G_GUINT64_FORMAT " trim-end %" G_GUINT64_FORMAT,
+          packets[i].trim_start, packets[i].trim_end);
+      gst_buffer_add_audio_clipping_meta (packet, GST_FORMAT_DEFAULT,
+          packets[i].trim_start, packets[i].trim_end);
+    }
 
-  ret =
-      gst_audio_encoder_finish_frame (GST_AUDIO_ENCODER (enc), outbuf,
-      output_samples);
-  enc->encoded_samples += output_samples;
-  enc->consumed_samples += input_samples;
+    ret =
+        gst_audio_encoder_finish_frame (GST_AUDIO_ENCODER (enc), packet,
+        packets[i].output_samples);
+    enc->encoded_samples += packets[i].output_samples;
+    enc->consumed_samples += packets[i].input_samples;
+  }
+
+  if (outbuf)
+    gst_buffer_unref (outbuf);
 
 done:
 
@@ -1132,6 +1201,9 @@ gst_opus_enc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_PAYLOAD_SIZE:
       g_value_set_uint (value, enc->max_payload_size);
       break;
+    case PROP_BATCH_FRAMES:
+      g_value_set_uint (value, enc->batch_frames);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1204,6 +1276,12 @@ gst_opus_enc_set_property (GObject * object, guint prop_id,
       enc->max_payload_size = g_value_get_uint (value);
       g_mutex_unlock (&enc->property_lock);
       break;
+    case PROP_BATCH_FRAMES:
+      g_mutex_lock (&enc->property_lock);
+      enc->batch_frames = g_value_get_uint (value);
+      gst_opus_enc_setup_base_class (enc, GST_AUDIO_ENCODER (enc));
+      g_mutex_unlock (&enc->property_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -74,6 +74,7 @@ struct _GstOpusEnc {
   gboolean              dtx;
   gint                  packet_loss_percentage;
   guint                 max_payload_size;
+  guint                 batch_frames;
 
   gint                  frame_samples;
   gint                  n_channels;
@@ -0,0 +1,391 @@
+/* GStreamer Opus Repacketizer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-opusrepacketizer
+ * @see_also: opusenc, rtpopuspay, rtpopusdepay
+ *
+ * This element merges consecutive Opus packets into longer packets without
+ * decoding them, for example to lower the packet rate of an RTP stream.
+ *
+ * Packets are never merged across a discontinuity, so a lost packet only
+ * affects the output packet it would have been part of and the in-band FEC
+ * data of the following packet stays usable by the decoder.
+ *
+ * <refsect2>
+ * <title>Example pipelines</title>
+ * |[
+ * gst-launch-1.0 -v udpsrc caps=application/x-rtp,media=audio,encoding-name=OPUS,payload=96,clock-rate=48000 ! rtpopusdepay ! opusrepacketizer max-duration=60 ! rtpopuspay ! udpsink host=127.0.0.1 port=5004
+ * ]| Forward an Opus RTP stream with 60 ms instead of 20 ms packets.
+ * </refsect2>
+ *
+ * Since: 1.10
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstopusrepacketizer.h"
+
+GST_DEBUG_CATEGORY_STATIC (opusrepacketizer_debug);
+#define GST_CAT_DEFAULT opusrepacketizer_debug
+
+#define OPUS_CAPS "audio/x-opus, channel-mapping-family = (int) 0"
+
+static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (OPUS_CAPS));
+
+static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (OPUS_CAPS));
+
+/* Opus packets can't be longer than 120 ms */
+#define MAX_DURATION 120
+#define DEFAULT_MAX_DURATION 60
+
+enum
+{
+  PROP_0,
+  PROP_MAX_DURATION
+};
+
+typedef struct
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+} GstOpusRepacketizerPacket;
+
+static void gst_opus_repacketizer_finalize (GObject * object);
+static void gst_opus_repacketizer_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_opus_repacketizer_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
+
+static GstStateChangeReturn gst_opus_repacketizer_change_state (GstElement *
+    element, GstStateChange transition);
+
+static GstFlowReturn gst_opus_repacketizer_chain (GstPad * pad,
+    GstObject * parent, GstBuffer * buf);
+static gboolean gst_opus_repacketizer_sink_event (GstPad * pad,
+    GstObject * parent, GstEvent * event);
+
+#define gst_opus_repacketizer_parent_class parent_class
+G_DEFINE_TYPE (GstOpusRepacketizer, gst_opus_repacketizer, GST_TYPE_ELEMENT);
+
+static void
+gst_opus_repacketizer_class_init (GstOpusRepacketizerClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstElementClass *gstelement_class;
+
+  gobject_class = (GObjectClass *) klass;
+  gstelement_class = (GstElementClass *) klass;
+
+  gobject_class->set_property = gst_opus_repacketizer_set_property;
+  gobject_class->get_property = gst_opus_repacketizer_get_property;
+  gobject_class->finalize = gst_opus_repacketizer_finalize;
+
+  gstelement_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_opus_repacketizer_change_state);
+
+  gst_element_class_add_static_pad_template (gstelement_class, &src_factory);
+  gst_element_class_add_static_pad_template (gstelement_class, &sink_factory);
+  gst_element_class_set_static_metadata (gstelement_class,
+      "Opus repacketizer", "Codec/Parser/Audio",
+      "Merges Opus packets into longer packets without decoding them",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  g_object_class_install_property (gobject_class, PROP_MAX_DURATION,
+      g_param_spec_uint ("max-duration", "Maximum duration",
+          "Maximum duration of the output packets, in ms", 1, MAX_DURATION,
+          DEFAULT_MAX_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
+  GST_DEBUG_CATEGORY_INIT (opusrepacketizer_debug, "opusrepacketizer", 0,
+      "Opus repacketizer");
+}
+
+static void
+gst_opus_repacketizer_init (GstOpusRepacketizer * self)
+{
+  self->sinkpad = gst_pad_new_from_static_template (&sink_factory, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_opus_repacketizer_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_opus_repacketizer_sink_event));
+  GST_PAD_SET_PROXY_CAPS (self->sinkpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkpad);
+
+  self->srcpad = gst_pad_new_from_static_template (&src_factory, "src");
+  GST_PAD_SET_PROXY_CAPS (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->rp = opus_repacketizer_create ();
+  self->pending = g_array_new (FALSE, FALSE,
+      sizeof (GstOpusRepacketizerPacket));
+  self->pending_size = 0;
+  self->pending_samples = 0;
+
+  self->max_duration = DEFAULT_MAX_DURATION;
+}
+
+static void
+gst_opus_repacketizer_reset (GstOpusRepacketizer * self)
+{
+  guint i;
+
+  for (i = 0; i < self->pending->len; i++) {
+    GstOpusRepacketizerPacket *packet =
+        &g_array_index (self->pending, GstOpusRepacketizerPacket, i);
+
+    gst_buffer_unmap (packet->buffer, &packet->map);
+    gst_buffer_unref (packet->buffer);
+  }
+  g_array_set_size (self->pending, 0);
+  self->pending_size = 0;
+  self->pending_samples = 0;
+
+  opus_repacketizer_init (self->rp);
+}
+
+static void
+gst_opus_repacketizer_finalize (GObject * object)
+{
+  GstOpusRepacketizer *self = GST_OPUS_REPACKETIZER (object);
+
+  gst_opus_repacketizer_reset (self);
+  g_array_free (self->pending, TRUE);
+  opus_repacketizer_destroy (self->rp);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static GstFlowReturn
+gst_opus_repacketizer_push_pending (GstOpusRepacketizer * self)
+{
+  GstOpusRepacketizerPacket *first;
+  GstBuffer *outbuf;
+  GstMapInfo omap;
+  opus_int32 size;
+  gint n_frames;
+
+  if (self->pending->len == 0)
+    return GST_FLOW_OK;
+
+  first = &g_array_index (self->pending, GstOpusRepacketizerPacket, 0);
+
+  if (self->pending->len == 1) {
+    /* nothing was merged, push the input as is */
+    outbuf = gst_buffer_ref (first->buffer);
+  } else {
+    /* the frames are copied as they are, only the TOC byte, the frame count
+     * and up to two bytes of length per frame are added */
+    n_frames = opus_repacketizer_get_nb_frames (self->rp);
+    outbuf = gst_buffer_new_allocate (NULL,
+        self->pending_size + 2 * n_frames + 2, NULL);
+
+    gst_buffer_map (outbuf, &omap, GST_MAP_WRITE);
+    size = opus_repacketizer_out (self->rp, omap.data, omap.size);
+    gst_buffer_unmap (outbuf, &omap);
+
+    if (size < 0) {
+      GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+          ("Failed to merge %u packets: %d", self->pending->len, size));
+      gst_buffer_unref (outbuf);
+      gst_opus_repacketizer_reset (self);
+      return GST_FLOW_ERROR;
+    }
+
+    gst_buffer_set_size (outbuf, size);
+    gst_buffer_copy_into (outbuf, first->buffer,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+    GST_BUFFER_DURATION (outbuf) =
+        gst_util_uint64_scale (self->pending_samples, GST_SECOND, 48000);
+    GST_BUFFER_OFFSET_END (outbuf) = GST_BUFFER_OFFSET_NONE;
+
+    GST_LOG_OBJECT (self, "merged %u packets with %d frames into %d bytes",
+        self->pending->len, n_frames, size);
+  }
+
+  gst_opus_repacketizer_reset (self);
+
+  return gst_pad_push (self->srcpad, outbuf);
+}
+
+static GstFlowReturn
+gst_opus_repacketizer_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  GstOpusRepacketizer *self = GST_OPUS_REPACKETIZER (parent);
+  GstOpusRepacketizerPacket packet;
+  GstFlowReturn ret;
+  gint samples, max_samples;
+
+  GST_OBJECT_LOCK (self);
+  max_samples = self->max_duration * 48;
+  GST_OBJECT_UNLOCK (self);
+
+  if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_HEADER))
+    goto passthrough;
+
+  if (!gst_buffer_map (buf, &packet.map, GST_MAP_READ))
+    goto passthrough;
+  packet.buffer = buf;
+
+  samples = opus_packet_get_nb_samples (packet.map.data, packet.map.size,
+      48000);
+  if (samples <= 0) {
+    GST_DEBUG_OBJECT (self, "can't parse packet, passing through");
+    gst_buffer_unmap (buf, &packet.map);
+    goto passthrough;
+  }
+
+  /* Don't merge packets around a loss, the decoder needs to see the gap to
+   * conceal it or to recover it from the FEC data of the next packet */
+  if (GST_BUFFER_IS_DISCONT (buf)
+      || self->pending_samples + samples > max_samples) {
+    ret = gst_opus_repacketizer_push_pending (self);
+    if (ret != GST_FLOW_OK)
+      goto not_pushed;
+  }
+
+  if (opus_repacketizer_cat (self->rp, packet.map.data,
+          packet.map.size) != OPUS_OK) {
+    /* mode, bandwidth or channel count changed, start a new packet */
+    ret = gst_opus_repacketizer_push_pending (self);
+    if (ret != GST_FLOW_OK)
+      goto not_pushed;
+
+    if (opus_repacketizer_cat (self->rp, packet.map.data,
+            packet.map.size) != OPUS_OK) {
+      GST_DEBUG_OBJECT (self, "invalid packet, passing through");
+      opus_repacketizer_init (self->rp);
+      gst_buffer_unmap (buf, &packet.map);
+      goto passthrough;
+    }
+  }
+
+  g_array_append_val (self->pending, packet);
+  self->pending_size += packet.map.size;
+  self->pending_samples += samples;
+
+  if (self->pending_samples >= max_samples)
+    return gst_opus_repacketizer_push_pending (self);
+
+  return GST_FLOW_OK;
+
+passthrough:
+  {
+    ret = gst_opus_repacketizer_push_pending (self);
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (buf);
+      return ret;
+    }
+    return gst_pad_push (self->srcpad, buf);
+  }
+not_pushed:
+  {
+    gst_buffer_unmap (buf, &packet.map);
+    gst_buffer_unref (buf);
+    return ret;
+  }
+}
+
+static gboolean
+gst_opus_repacketizer_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstOpusRepacketizer *self = GST_OPUS_REPACKETIZER (parent);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_STOP:
+      gst_opus_repacketizer_reset (self);
+      break;
+    case GST_EVENT_CAPS:
+    case GST_EVENT_SEGMENT:
+    case GST_EVENT_GAP:
+    case GST_EVENT_EOS:
+      /* keep the pending packets in order with the event */
+      gst_opus_repacketizer_push_pending (self);
+      break;
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static GstStateChangeReturn
+gst_opus_repacketizer_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstOpusRepacketizer *self = GST_OPUS_REPACKETIZER (element);
+  GstStateChangeReturn ret;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_opus_repacketizer_reset (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+static void
+gst_opus_repacketizer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstOpusRepacketizer *self = GST_OPUS_REPACKETIZER (object);
+
+  switch (prop_id) {
+    case PROP_MAX_DURATION:
+      GST_OBJECT_LOCK (self);
+      self->max_duration = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_opus_repacketizer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstOpusRepacketizer *self = GST_OPUS_REPACKETIZER (object);
+
+  switch (prop_id) {
+    case PROP_MAX_DURATION:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->max_duration);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
@@ -0,0 +1,68 @@
+/* GStreamer Opus Repacketizer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_OPUS_REPACKETIZER_H__
+#define __GST_OPUS_REPACKETIZER_H__
+
+#include <gst/gst.h>
+
+#include <opus.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_OPUS_REPACKETIZER \
+  (gst_opus_repacketizer_get_type())
+#define GST_OPUS_REPACKETIZER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_OPUS_REPACKETIZER,GstOpusRepacketizer))
+#define GST_OPUS_REPACKETIZER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_OPUS_REPACKETIZER,GstOpusRepacketizerClass))
+#define GST_IS_OPUS_REPACKETIZER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_OPUS_REPACKETIZER))
+#define GST_IS_OPUS_REPACKETIZER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_OPUS_REPACKETIZER))
+
+typedef struct _GstOpusRepacketizer GstOpusRepacketizer;
+typedef struct _GstOpusRepacketizerClass GstOpusRepacketizerClass;
+
+struct _GstOpusRepacketizer {
+  GstElement            element;
+
+  GstPad               *sinkpad;
+  GstPad               *srcpad;
+
+  OpusRepacketizer     *rp;
+
+  /* input buffers whose packets are merged into the next output packet,
+   * they stay mapped as the repacketizer only points into their data */
+  GArray               *pending;
+  gsize                 pending_size;
+  gint                  pending_samples;
+
+  /* properties */
+  guint                 max_duration;
+};
+
+struct _GstOpusRepacketizerClass {
+  GstElementClass parent_class;
+};
+
+GType gst_opus_repacketizer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_OPUS_REPACKETIZER_H__ */
@@ -76,6 +76,9 @@ GST_DEBUG_CATEGORY (pango_debug);
 #define MINIMUM_OUTLINE_OFFSET 1.0
 #define DEFAULT_SCALE_BASIS    640
 
+/* number of rendered glyphs kept before the cache is started anew */
+#define GLYPH_CACHE_MAX_SIZE   512
+
 enum
 {
   PROP_0,
@@ -624,6 +627,11 @@ gst_base_text_overlay_finalize (GObject * object)
     overlay->layout = NULL;
   }
 
+  if (overlay->glyph_cache) {
+    g_hash_table_destroy (overlay->glyph_cache);
+    overlay->glyph_cache = NULL;
+  }
+
   if (overlay->text_buffer) {
     gst_buffer_unref (overlay->text_buffer);
     overlay->text_buffer = NULL;
@@ -1661,6 +1669,255 @@ gst_text_overlay_filter_foreground_attr (PangoAttribute * attr, gpointer data)
   }
 }
 
+typedef struct
+{
+  PangoFont *font;
+  PangoGlyph glyph;
+} GlyphCacheKey;
+
+typedef struct
+{
+  /* alpha masks of the glyph and of its outline, their top left corner is
+   * at (x, y) relative to the glyph origin */
+  cairo_surface_t *fill;
+  cairo_surface_t *outline;
+  gint x, y;
+} GlyphCacheEntry;
+
+typedef struct
+{
+  GlyphCacheEntry *entry;
+  gint x, y;
+} GlyphPosition;
+
+static guint
+glyph_cache_key_hash (gconstpointer v)
+{
+  const GlyphCacheKey *key = v;
+
+  return g_direct_hash (key->font) ^ key->glyph;
+}
+
+static gboolean
+glyph_cache_key_equal (gconstpointer v1, gconstpointer v2)
+{
+  const GlyphCacheKey *key1 = v1;
+  const GlyphCacheKey *key2 = v2;
+
+  return key1->font == key2->font && key1->glyph == key2->glyph;
+}
+
+static void
+glyph_cache_key_free (GlyphCacheKey * key)
+{
+  g_object_unref (key->font);
+  g_slice_free (GlyphCacheKey, key);
+}
+
+static void
+glyph_cache_entry_free (GlyphCacheEntry * entry)
+{
+  if (entry->fill)
+    cairo_surface_destroy (entry->fill);
+  if (entry->outline)
+    cairo_surface_destroy (entry->outline);
+  g_slice_free (GlyphCacheEntry, entry);
+}
+
+static GlyphCacheEntry *
+gst_base_text_overlay_get_glyph (GstBaseTextOverlay * overlay,
+    PangoFont * font, PangoGlyph glyph, gdouble scalef)
+{
+  GlyphCacheKey lookup = { font, glyph };
+  GlyphCacheKey *key;
+  GlyphCacheEntry *entry;
+  PangoGlyphString *glyphs;
+  PangoRectangle ink;
+  gint pad, width, height;
+  cairo_t *cr;
+
+  entry = g_hash_table_lookup (overlay->glyph_cache, &lookup);
+  if (entry)
+    return entry;
+
+  if (g_hash_table_size (overlay->glyph_cache) >= GLYPH_CACHE_MAX_SIZE)
+    g_hash_table_remove_all (overlay->glyph_cache);
+
+  entry = g_slice_new0 (GlyphCacheEntry);
+  key = g_slice_new (GlyphCacheKey);
+  key->font = g_object_ref (font);
+  key->glyph = glyph;
+  g_hash_table_insert (overlay->glyph_cache, key, entry);
+
+  pango_font_get_glyph_extents (font, glyph, &ink, NULL);
+  if (ink.width <= 0 || ink.height <= 0)
+    return entry;
+
+  /* room for the outline and for antialiasing */
+  pad = 1;
+  if (overlay->draw_outline)
+    pad += ceil (overlay->outline_offset * scalef / 2.0);
+
+  entry->x = floor ((gdouble) ink.x / PANGO_SCALE * scalef) - pad;
+  entry->y = floor ((gdouble) ink.y / PANGO_SCALE * scalef) - pad;
+  width = ceil ((gdouble) (ink.x + ink.width) / PANGO_SCALE * scalef) + pad -
+      entry->x;
+  height = ceil ((gdouble) (ink.y + ink.height) / PANGO_SCALE * scalef) +
+      pad - entry->y;
+
+  glyphs = pango_glyph_string_new ();
+  pango_glyph_string_set_size (glyphs, 1);
+  glyphs->glyphs[0].glyph = glyph;
+  glyphs->glyphs[0].geometry.width = 0;
+  glyphs->glyphs[0].geometry.x_offset = 0;
+  glyphs->glyphs[0].geometry.y_offset = 0;
+  glyphs->glyphs[0].attr.is_cluster_start = 1;
+  glyphs->log_clusters[0] = 0;
+
+  entry->fill = cairo_image_surface_create (CAIRO_FORMAT_A8, width, height);
+  cr = cairo_create (entry->fill);
+  cairo_translate (cr, -entry->x, -entry->y);
+  cairo_scale (cr, scalef, scalef);
+  cairo_move_to (cr, 0, 0);
+  pango_cairo_show_glyph_string (cr, font, glyphs);
+  cairo_destroy (cr);
+
+  if (overlay->draw_outline) {
+    entry->outline =
+        cairo_image_surface_create (CAIRO_FORMAT_A8, width, height);
+    cr = cairo_create (entry->outline);
+    cairo_translate (cr, -entry->x, -entry->y);
+    cairo_scale (cr, scalef, scalef);
+    cairo_move_to (cr, 0, 0);
+    pango_cairo_glyph_string_path (cr, font, glyphs);
+    cairo_set_line_width (cr, overlay->outline_offset);
+    cairo_stroke (cr);
+    cairo_destroy (cr);
+  }
+
+  pango_glyph_string_free (glyphs);
+
+  return entry;
+}
+
+/* Assembles the text from cached glyph masks instead of rendering the layout,
+ * the text is placed at (xoff, yoff) in layout pixels and scaled by @scalef.
+ * Returns FALSE if the layout contains glyphs that can't be drawn this way */
+static gboolean
+gst_base_text_overlay_draw_cached_glyphs (GstBaseTextOverlay * overlay,
+    cairo_t * cr, gdouble scalef, gdouble xoff, gdouble yoff)
+{
+  PangoLayoutIter *iter;
+  GArray *positions;
+  gboolean ret = TRUE;
+  gdouble a, r, g, b;
+  gint shadow_x, shadow_y;
+  guint i;
+
+  if (overlay->glyph_cache == NULL) {
+    overlay->glyph_cache = g_hash_table_new_full (glyph_cache_key_hash,
+        glyph_cache_key_equal, (GDestroyNotify) glyph_cache_key_free,
+        (GDestroyNotify) glyph_cache_entry_free);
+  }
+
+  if (overlay->glyph_cache_scale != scalef ||
+      overlay->glyph_cache_outline !=
+      (overlay->draw_outline ? overlay->outline_offset : 0.0)) {
+    g_hash_table_remove_all (overlay->glyph_cache);
+    overlay->glyph_cache_scale = scalef;
+    overlay->glyph_cache_outline =
+        overlay->draw_outline ? overlay->outline_offset : 0.0;
+  }
+
+  positions = g_array_new (FALSE, FALSE, sizeof (GlyphPosition));
+
+  iter = pango_layout_get_iter (overlay->layout);
+  do {
+    PangoLayoutRun *run = pango_layout_iter_get_run_readonly (iter);
+    PangoRectangle logical;
+    gint baseline, x, j;
+
+    /* end of a line */
+    if (run == NULL)
+      continue;
+
+    baseline = pango_layout_iter_get_baseline (iter);
+    pango_layout_iter_get_run_extents (iter, NULL, &logical);
+    x = logical.x;
+
+    for (j = 0; j < run->glyphs->num_glyphs; j++) {
+      PangoGlyphInfo *info = &run->glyphs->glyphs[j];
+      GlyphPosition pos;
+
+      if (info->glyph & PANGO_GLYPH_UNKNOWN_FLAG) {
+        ret = FALSE;
+        goto done;
+      }
+
+      if (info->glyph != PANGO_GLYPH_EMPTY) {
+        pos.entry = gst_base_text_overlay_get_glyph (overlay,
+            run->item->analysis.font, info->glyph, scalef);
+        pos.x = floor (((gdouble) (x + info->geometry.x_offset) / PANGO_SCALE
+                + xoff) * scalef + 0.5);
+        pos.y = floor (((gdouble) (baseline + info->geometry.y_offset) /
+                PANGO_SCALE + yoff) * scalef + 0.5);
+        if (pos.entry->fill)
+          g_array_append_val (positions, pos);
+      }
+      x += info->geometry.width;
+    }
+  } while (pango_layout_iter_next_run (iter));
+
+  /* same layering as when rendering the layout: shadows, outlines and the
+   * text on top */
+  if (overlay->draw_shadow) {
+    shadow_x = floor (overlay->shadow_offset * scalef + 0.5);
+    shadow_y = shadow_x;
+
+    cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.5);
+    for (i = 0; i < positions->len; i++) {
+      GlyphPosition *pos = &g_array_index (positions, GlyphPosition, i);
+
+      cairo_mask_surface (cr, pos->entry->fill,
+          pos->x + pos->entry->x + shadow_x, pos->y + pos->entry->y + shadow_y);
+    }
+  }
+
+  if (overlay->draw_outline) {
+    a = (overlay->outline_color >> 24) & 0xff;
+    r = (overlay->outline_color >> 16) & 0xff;
+    g = (overlay->outline_color >> 8) & 0xff;
+    b = (overlay->outline_color >> 0) & 0xff;
+
+    cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
+    for (i = 0; i < positions->len; i++) {
+      GlyphPosition *pos = &g_array_index (positions, GlyphPosition, i);
+
+      cairo_mask_surface (cr, pos->entry->outline,
+          pos->x + pos->entry->x, pos->y + pos->entry->y);
+    }
+  }
+
+  a = (overlay->color >> 24) & 0xff;
+  r = (overlay->color >> 16) & 0xff;
+  g = (overlay->color >> 8) & 0xff;
+  b = (overlay->color >> 0) & 0xff;
+
+  cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
+  for (i = 0; i < positions->len; i++) {
+    GlyphPosition *pos = &g_array_index (positions, GlyphPosition, i);
+
+    cairo_mask_surface (cr, pos->entry->fill,
+        pos->x + pos->entry->x, pos->y + pos->entry->y);
+  }
+
+done:
+  pango_layout_iter_free (iter);
+  g_array_free (positions, TRUE);
+
+  return ret;
+}
+
 static void
 gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
     const gchar * string, gint textlen)
@@ -1856,6 +2113,15 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
 
   cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
 
+  /* Text without markup is assembled from cached glyphs, this avoids
+   * rendering and stroking the whole layout when only a few characters
+   * change, like with timeoverlay and clockoverlay */
+  if (!overlay->use_vertical_render && memchr (string, '<', textlen) == NULL
+      && gst_base_text_overlay_draw_cached_glyphs (overlay, cr, scalef,
+          ceil (outline_offset / 2.0l) - ink_rect.x,
+          ceil (outline_offset / 2.0l) - ink_rect.y))
+    goto done;
+
   /* apply transformations */
   cairo_set_matrix (cr, &cairo_matrix);
 
@@ -1923,6 +2189,7 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
   pango_cairo_show_layout (cr, overlay->layout);
   cairo_restore (cr);
 
+done:
   cairo_destroy (cr);
   cairo_surface_destroy (surface);
   gst_buffer_unmap (buffer, &map);
@@ -204,6 +204,12 @@ struct _GstBaseTextOverlay {
     PangoRectangle           ink_rect;
     PangoRectangle           logical_rect;
 
+    /* rendered glyphs, valid for the scale and outline they were rendered
+     * with */
+    GHashTable              *glyph_cache;
+    gdouble                  glyph_cache_scale;
+    gdouble                  glyph_cache_outline;
+
     gboolean                    attach_compo_to_buffer;
     GstVideoOverlayComposition *composition;
     GstVideoOverlayComposition *upstream_composition;
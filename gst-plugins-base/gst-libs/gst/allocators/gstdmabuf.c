@@ -146,3 +146,63 @@ gst_is_dmabuf_memory (GstMemory * mem)
 {
   return gst_memory_is_type (mem, GST_ALLOCATOR_DMABUF);
 }
+
+static GQuark
+gst_dmabuf_modifier_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("GstDmaBufDrmModifier");
+
+  return quark;
+}
+
+/**
+ * gst_dmabuf_memory_set_drm_modifier:
+ * @mem: a dmabuf #GstMemory
+ * @modifier: the DRM format modifier describing the layout of @mem
+ *
+ * Attach the DRM format modifier (tiling and compression layout) of the
+ * dmabuf to @mem, so that importers can pass it on to the driver instead
+ * of assuming a layout.
+ *
+ * Since: 1.10
+ */
+void
+gst_dmabuf_memory_set_drm_modifier (GstMemory * mem, guint64 modifier)
+{
+  guint64 *data;
+
+  g_return_if_fail (gst_is_dmabuf_memory (mem));
+
+  data = g_new (guint64, 1);
+  *data = modifier;
+  gst_mini_object_set_qdata (GST_MINI_OBJECT (mem),
+      gst_dmabuf_modifier_quark (), data, g_free);
+}
+
+/**
+ * gst_dmabuf_memory_get_drm_modifier:
+ * @mem: a dmabuf #GstMemory
+ *
+ * Get the DRM format modifier set with gst_dmabuf_memory_set_drm_modifier().
+ *
+ * Returns: the DRM format modifier of @mem, or
+ *     %GST_DMABUF_DRM_MODIFIER_INVALID if the layout is not known
+ *
+ * Since: 1.10
+ */
+guint64
+gst_dmabuf_memory_get_drm_modifier (GstMemory * mem)
+{
+  guint64 *data;
+
+  g_return_val_if_fail (gst_is_dmabuf_memory (mem),
+      GST_DMABUF_DRM_MODIFIER_INVALID);
+
+  data = gst_mini_object_get_qdata (GST_MINI_OBJECT (mem),
+      gst_dmabuf_modifier_quark ());
+
+  return data ? *data : GST_DMABUF_DRM_MODIFIER_INVALID;
+}
@@ -27,6 +27,34 @@ G_BEGIN_DECLS
 
 #define GST_ALLOCATOR_DMABUF "dmabuf"
 
+/**
+ * GST_CAPS_FEATURE_MEMORY_DMABUF:
+ *
+ * Name of the caps feature for buffers backed by dmabuf memory.
+ *
+ * Since: 1.10
+ */
+#define GST_CAPS_FEATURE_MEMORY_DMABUF "memory:DMABuf"
+
+/**
+ * GST_DMABUF_DRM_MODIFIER_LINEAR:
+ *
+ * DRM format modifier of a dmabuf with a linear layout.
+ *
+ * Since: 1.10
+ */
+#define GST_DMABUF_DRM_MODIFIER_LINEAR G_GUINT64_CONSTANT (0)
+
+/**
+ * GST_DMABUF_DRM_MODIFIER_INVALID:
+ *
+ * DRM format modifier value meaning that the layout of a dmabuf is not
+ * known and is implied by the driver that allocated it.
+ *
+ * Since: 1.10
+ */
+#define GST_DMABUF_DRM_MODIFIER_INVALID G_GUINT64_CONSTANT (0x00ffffffffffffff)
+
 GstAllocator * gst_dmabuf_allocator_new (void);
 
 GstMemory    * gst_dmabuf_allocator_alloc (GstAllocator * allocator, gint fd, gsize size);
@@ -35,5 +63,9 @@ gint           gst_dmabuf_memory_get_fd (GstMemory * mem);
 
 gboolean       gst_is_dmabuf_memory (GstMemory * mem);
 
+void           gst_dmabuf_memory_set_drm_modifier (GstMemory * mem, guint64 modifier);
+
+guint64        gst_dmabuf_memory_get_drm_modifier (GstMemory * mem);
+
 G_END_DECLS
 #endif /* __GST_DMABUF_H__ */
@@ -65,6 +65,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/base/gstqueuearray.h>
 #include <gst/gstbuffer.h>
 
 #include <string.h>
@@ -72,6 +73,13 @@
 #include "gstapp-marshal.h"
 #include "gstappsink.h"
 
+typedef enum
+{
+  NOONE_WAITING = 0,
+  STREAM_WAITING = 1 << 0,      /* streaming thread is waiting for free space */
+  APP_WAITING = 1 << 1,         /* application thread is waiting for a buffer */
+} GstAppSinkWaitStatus;
+
 struct _GstAppSinkPrivate
 {
   GstCaps *caps;
@@ -83,7 +91,10 @@ struct _GstAppSinkPrivate
 
   GCond cond;
   GMutex mutex;
-  GQueue *queue;
+  GstQueueArray *queue;
+  GstAppSinkWaitStatus wait_status;
+  GstPoll *poll;
+  gboolean poll_ready;
   GstBuffer *preroll;
   GstCaps *preroll_caps;
   GstCaps *last_caps;
@@ -373,7 +384,8 @@ gst_app_sink_init (GstAppSink * appsink)
 
   g_mutex_init (&priv->mutex);
   g_cond_init (&priv->cond);
-  priv->queue = g_queue_new ();
+  priv->queue = gst_queue_array_new (16);
+  priv->poll = gst_poll_new_timer ();
 
   priv->emit_signals = DEFAULT_PROP_EMIT_SIGNALS;
   priv->max_buffers = DEFAULT_PROP_MAX_BUFFERS;
@@ -402,7 +414,7 @@ gst_app_sink_dispose (GObject * obj)
   GST_OBJECT_UNLOCK (appsink);
 
   g_mutex_lock (&priv->mutex);
-  while ((queue_obj = g_queue_pop_head (priv->queue)))
+  while ((queue_obj = gst_queue_array_pop_head (priv->queue)))
     gst_mini_object_unref (queue_obj);
   gst_buffer_replace (&priv->preroll, NULL);
   gst_caps_replace (&priv->preroll_caps, NULL);
@@ -420,7 +432,8 @@ gst_app_sink_finalize (GObject * obj)
 
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
-  g_queue_free (priv->queue);
+  gst_queue_array_free (priv->queue);
+  gst_poll_free (priv->poll);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -521,6 +534,23 @@ gst_app_sink_unlock_stop (GstBaseSink * bsink)
   return TRUE;
 }
 
+/* make the poll fd readable as long as there is something for the
+ * application to pull, called with the mutex */
+static void
+gst_app_sink_update_poll_unlocked (GstAppSink * appsink)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  gboolean ready = priv->num_buffers > 0 || priv->is_eos;
+
+  if (ready && !priv->poll_ready) {
+    gst_poll_write_control (priv->poll);
+    priv->poll_ready = TRUE;
+  } else if (!ready && priv->poll_ready) {
+    gst_poll_read_control (priv->poll);
+    priv->poll_ready = FALSE;
+  }
+}
+
 static void
 gst_app_sink_flush_unlocked (GstAppSink * appsink)
 {
@@ -530,9 +560,10 @@ gst_app_sink_flush_unlocked (GstAppSink * appsink)
   GST_DEBUG_OBJECT (appsink, "flush stop appsink");
   priv->is_eos = FALSE;
   gst_buffer_replace (&priv->preroll, NULL);
-  while ((obj = g_queue_pop_head (priv->queue)))
+  while ((obj = gst_queue_array_pop_head (priv->queue)))
     gst_mini_object_unref (obj);
   priv->num_buffers = 0;
+  gst_app_sink_update_poll_unlocked (appsink);
   g_cond_signal (&priv->cond);
 }
 
@@ -582,7 +613,7 @@ gst_app_sink_setcaps (GstBaseSink * sink, GstCaps * caps)
 
   g_mutex_lock (&priv->mutex);
   GST_DEBUG_OBJECT (appsink, "receiving CAPS");
-  g_queue_push_tail (priv->queue, gst_event_new_caps (caps));
+  gst_queue_array_push_tail (priv->queue, gst_event_new_caps (caps));
   if (!priv->preroll)
     gst_caps_replace (&priv->preroll_caps, caps);
   g_mutex_unlock (&priv->mutex);
@@ -600,7 +631,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
     case GST_EVENT_SEGMENT:
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "receiving SEGMENT");
-      g_queue_push_tail (priv->queue, gst_event_ref (event));
+      gst_queue_array_push_tail (priv->queue, gst_event_ref (event));
       if (!priv->preroll)
         gst_event_copy_segment (event, &priv->preroll_segment);
       g_mutex_unlock (&priv->mutex);
@@ -611,6 +642,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "receiving EOS");
       priv->is_eos = TRUE;
+      gst_app_sink_update_poll_unlocked (appsink);
       g_cond_signal (&priv->cond);
       g_mutex_unlock (&priv->mutex);
 
@@ -619,8 +651,11 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
        * Otherwise we might signal EOS before all buffers are
        * consumed, which is a bit confusing for the application
        */
-      while (priv->num_buffers > 0 && !priv->flushing && priv->wait_on_eos)
+      while (priv->num_buffers > 0 && !priv->flushing && priv->wait_on_eos) {
+        priv->wait_status |= STREAM_WAITING;
         g_cond_wait (&priv->cond, &priv->mutex);
+        priv->wait_status &= ~STREAM_WAITING;
+      }
       if (priv->flushing)
         emit = FALSE;
       g_mutex_unlock (&priv->mutex);
@@ -699,7 +734,7 @@ dequeue_buffer (GstAppSink * appsink)
   do {
     GstMiniObject *obj;
 
-    obj = g_queue_pop_head (priv->queue);
+    obj = gst_queue_array_pop_head (priv->queue);
 
     if (GST_IS_BUFFER (obj)) {
       buffer = GST_BUFFER_CAST (obj);
@@ -731,6 +766,8 @@ dequeue_buffer (GstAppSink * appsink)
     }
   } while (TRUE);
 
+  gst_app_sink_update_poll_unlocked (appsink);
+
   return buffer;
 }
 
@@ -783,15 +820,20 @@ restart:
       }
 
       /* wait for a buffer to be removed or flush */
+      priv->wait_status |= STREAM_WAITING;
       g_cond_wait (&priv->cond, &priv->mutex);
+      priv->wait_status &= ~STREAM_WAITING;
       if (priv->flushing)
         goto flushing;
     }
   }
   /* we need to ref the buffer when pushing it in the queue */
-  g_queue_push_tail (priv->queue, gst_buffer_ref (buffer));
+  gst_queue_array_push_tail (priv->queue, gst_buffer_ref (buffer));
   priv->num_buffers++;
-  g_cond_signal (&priv->cond);
+  gst_app_sink_update_poll_unlocked (appsink);
+  /* only wake up the application when it is actually waiting */
+  if (priv->wait_status & APP_WAITING)
+    g_cond_signal (&priv->cond);
   emit = priv->emit_signals;
   g_mutex_unlock (&priv->mutex);
 
@@ -1295,14 +1337,120 @@ gst_app_sink_pull_sample (GstAppSink * appsink)
 
     /* nothing to return, wait */
     GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    priv->wait_status |= APP_WAITING;
     g_cond_wait (&priv->cond, &priv->mutex);
+    priv->wait_status &= ~APP_WAITING;
   }
   buffer = dequeue_buffer (appsink);
   GST_DEBUG_OBJECT (appsink, "we have a buffer %p", buffer);
   sample = gst_sample_new (buffer, priv->last_caps, &priv->last_segment, NULL);
   gst_buffer_unref (buffer);
 
-  g_cond_signal (&priv->cond);
+  if (priv->wait_status & STREAM_WAITING)
+    g_cond_signal (&priv->cond);
+  g_mutex_unlock (&priv->mutex);
+
+  return sample;
+
+  /* special conditions */
+eos:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+not_started:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+}
+
+/**
+ * gst_app_sink_pull_buffer_list:
+ * @appsink: a #GstAppSink
+ * @max_buffers: the maximum number of buffers to pull, 0 for all
+ *
+ * Like gst_app_sink_pull_sample() but takes up to @max_buffers queued buffers
+ * at once and returns them as the #GstBufferList of a single #GstSample. The
+ * returned sample has no buffer, use gst_sample_get_buffer_list() to access
+ * the buffers.
+ *
+ * All the buffers in the list share the caps and segment of the sample, the
+ * list is ended early when the caps or the segment change. This avoids
+ * taking the lock and allocating a sample for every buffer when the
+ * application deals with many small buffers.
+ *
+ * This function blocks until at least one buffer or EOS becomes available or
+ * the appsink element is set to the READY/NULL state.
+ *
+ * If an EOS event was received before any buffers, this function returns
+ * %NULL. Use gst_app_sink_is_eos () to check for the EOS condition.
+ *
+ * Returns: (transfer full): a #GstSample or NULL when the appsink is stopped or EOS.
+ *          Call gst_sample_unref() after usage.
+ *
+ * Since: 1.10
+ */
+GstSample *
+gst_app_sink_pull_buffer_list (GstAppSink * appsink, guint max_buffers)
+{
+  GstSample *sample = NULL;
+  GstBufferList *list;
+  GstAppSinkPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab buffers");
+    if (!priv->started)
+      goto not_started;
+
+    if (priv->num_buffers > 0)
+      break;
+
+    if (priv->is_eos)
+      goto eos;
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    priv->wait_status |= APP_WAITING;
+    g_cond_wait (&priv->cond, &priv->mutex);
+    priv->wait_status &= ~APP_WAITING;
+  }
+
+  if (max_buffers == 0 || max_buffers > priv->num_buffers)
+    max_buffers = priv->num_buffers;
+  list = gst_buffer_list_new_sized (max_buffers);
+
+  /* the first buffer activates the pending caps and segment, stop at the
+   * next caps or segment change */
+  gst_buffer_list_add (list, dequeue_buffer (appsink));
+  while (gst_buffer_list_length (list) < max_buffers) {
+    GstMiniObject *obj = gst_queue_array_peek_head (priv->queue);
+
+    if (!GST_IS_BUFFER (obj))
+      break;
+
+    gst_queue_array_pop_head (priv->queue);
+    priv->num_buffers--;
+    gst_buffer_list_add (list, GST_BUFFER_CAST (obj));
+  }
+  gst_app_sink_update_poll_unlocked (appsink);
+  GST_DEBUG_OBJECT (appsink, "we have %u buffers",
+      gst_buffer_list_length (list));
+
+  sample = gst_sample_new (NULL, priv->last_caps, &priv->last_segment, NULL);
+  gst_sample_set_buffer_list (sample, list);
+  gst_buffer_list_unref (list);
+
+  if (priv->wait_status & STREAM_WAITING)
+    g_cond_signal (&priv->cond);
   g_mutex_unlock (&priv->mutex);
 
   return sample;
@@ -1322,6 +1470,30 @@ not_started:
   }
 }
 
+/**
+ * gst_app_sink_get_pollfd:
+ * @appsink: a #GstAppSink
+ * @fd: (out caller-allocates): a #GPollFD
+ *
+ * Get a file descriptor that is readable as long as samples are queued in
+ * @appsink or EOS was reached. This makes it possible to integrate @appsink
+ * in an external event loop, poll() or epoll set, instead of blocking in
+ * gst_app_sink_pull_sample() or using the callbacks from the streaming thread.
+ *
+ * The file descriptor is owned by @appsink and must only be polled for
+ * reading, it must not be read from or closed.
+ *
+ * Since: 1.10
+ */
+void
+gst_app_sink_get_pollfd (GstAppSink * appsink, GPollFD * fd)
+{
+  g_return_if_fail (GST_IS_APP_SINK (appsink));
+  g_return_if_fail (fd != NULL);
+
+  gst_poll_get_read_gpollfd (appsink->priv->poll, fd);
+}
+
 /**
  * gst_app_sink_set_callbacks: (skip)
  * @appsink: a #GstAppSink
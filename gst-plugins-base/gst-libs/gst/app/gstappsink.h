@@ -120,6 +120,9 @@ gboolean        gst_app_sink_get_wait_on_eos  (GstAppSink *appsink);
 
 GstSample *     gst_app_sink_pull_preroll     (GstAppSink *appsink);
 GstSample *     gst_app_sink_pull_sample      (GstAppSink *appsink);
+GstSample *     gst_app_sink_pull_buffer_list (GstAppSink *appsink, guint max_buffers);
+
+void            gst_app_sink_get_pollfd       (GstAppSink *appsink, GPollFD *fd);
 
 void            gst_app_sink_set_callbacks    (GstAppSink * appsink,
                                                GstAppSinkCallbacks *callbacks,
@@ -101,11 +101,19 @@
 #include "gstapp-marshal.h"
 #include "gstappsrc.h"
 
+typedef enum
+{
+  NOONE_WAITING = 0,
+  STREAM_WAITING = 1 << 0,      /* streaming thread is waiting for data */
+  APP_WAITING = 1 << 1,         /* application thread is waiting for space */
+} GstAppSrcWaitStatus;
+
 struct _GstAppSrcPrivate
 {
   GCond cond;
   GMutex mutex;
   GQueue *queue;
+  GstAppSrcWaitStatus wait_status;
 
   GstCaps *last_caps;
   GstCaps *current_caps;
@@ -149,6 +157,7 @@ enum
   SIGNAL_PUSH_BUFFER,
   SIGNAL_END_OF_STREAM,
   SIGNAL_PUSH_SAMPLE,
+  SIGNAL_PUSH_BUFFER_LIST,
 
   LAST_SIGNAL
 };
@@ -242,6 +251,8 @@ static gboolean gst_app_src_do_get_size (GstBaseSrc * src, guint64 * size);
 static gboolean gst_app_src_query (GstBaseSrc * src, GstQuery * query);
 static gboolean gst_app_src_event (GstBaseSrc * src, GstEvent * event);
 
+static GstFlowReturn gst_app_src_push_buffer_list_action (GstAppSrc * appsrc,
+    GstBufferList * buffer_list);
 static GstFlowReturn gst_app_src_push_buffer_action (GstAppSrc * appsrc,
     GstBuffer * buffer);
 static GstFlowReturn gst_app_src_push_sample_action (GstAppSrc * appsrc,
@@ -512,6 +523,27 @@ gst_app_src_class_init (GstAppSrcClass * klass)
           push_sample), NULL, NULL, __gst_app_marshal_ENUM__BOXED,
       GST_TYPE_FLOW_RETURN, 1, GST_TYPE_SAMPLE);
 
+  /**
+    * GstAppSrc::push-buffer-list:
+    * @appsrc: the appsrc
+    * @buffer_list: a buffer list to push
+    *
+    * Adds a buffer list to the queue of buffers and buffer lists that the
+    * appsrc element will push to its source pad. This function does not take
+    * ownership of the buffer list so the buffer list needs to be unreffed
+    * after calling this function.
+    *
+    * When the block property is TRUE, this function can block until free space
+    * becomes available in the queue.
+    *
+    * Since: 1.10
+    */
+  gst_app_src_signals[SIGNAL_PUSH_BUFFER_LIST] =
+      g_signal_new ("push-buffer-list", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstAppSrcClass,
+          push_buffer_list), NULL, NULL, __gst_app_marshal_ENUM__BOXED,
+      GST_TYPE_FLOW_RETURN, 1, GST_TYPE_BUFFER_LIST);
+
 
    /**
     * GstAppSrc::end-of-stream:
@@ -549,6 +581,7 @@ gst_app_src_class_init (GstAppSrcClass * klass)
 
   klass->push_buffer = gst_app_src_push_buffer_action;
   klass->push_sample = gst_app_src_push_sample_action;
+  klass->push_buffer_list = gst_app_src_push_buffer_list_action;
   klass->end_of_stream = gst_app_src_end_of_stream;
 
   g_type_class_add_private (klass, sizeof (GstAppSrcPrivate));
@@ -1107,6 +1140,77 @@ gst_app_src_negotiate (GstBaseSrc * basesrc)
   return result;
 }
 
+/* Must be called with priv->mutex. Takes the data of @obj, a buffer or a
+ * buffer list popped from the queue, and returns its size. With @use_list all
+ * the data queued up to the next caps is submitted as one buffer list to the
+ * base class and *buf is set to %NULL. */
+static gsize
+gst_app_src_take_data_unlocked (GstAppSrc * appsrc, GstMiniObject * obj,
+    gboolean use_list, GstBuffer ** buf)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  GstBufferList *list, *next;
+  gsize size = 0;
+  guint i, len;
+
+  if (!use_list) {
+    if (GST_IS_BUFFER (obj)) {
+      *buf = GST_BUFFER_CAST (obj);
+      return gst_buffer_get_size (*buf);
+    }
+
+    /* take the first buffer and put the rest of the list back */
+    list = gst_buffer_list_make_writable (GST_BUFFER_LIST_CAST (obj));
+    *buf = gst_buffer_ref (gst_buffer_list_get (list, 0));
+    gst_buffer_list_remove (list, 0, 1);
+    if (gst_buffer_list_length (list) > 0)
+      g_queue_push_head (priv->queue, list);
+    else
+      gst_buffer_list_unref (list);
+
+    return gst_buffer_get_size (*buf);
+  }
+
+  if (GST_IS_BUFFER_LIST (obj)) {
+    list = gst_buffer_list_make_writable (GST_BUFFER_LIST_CAST (obj));
+  } else {
+    list = gst_buffer_list_new ();
+    gst_buffer_list_add (list, GST_BUFFER_CAST (obj));
+  }
+
+  /* a NULL or caps item ends the list */
+  while ((obj = g_queue_peek_head (priv->queue))) {
+    if (GST_IS_BUFFER (obj)) {
+      gst_buffer_list_add (list, g_queue_pop_head (priv->queue));
+    } else if (GST_IS_BUFFER_LIST (obj)) {
+      next = g_queue_pop_head (priv->queue);
+      len = gst_buffer_list_length (next);
+      for (i = 0; i < len; i++)
+        gst_buffer_list_add (list, gst_buffer_ref (gst_buffer_list_get (next,
+                    i)));
+      gst_buffer_list_unref (next);
+    } else {
+      break;
+    }
+  }
+
+  len = gst_buffer_list_length (list);
+  if (len == 1) {
+    *buf = gst_buffer_ref (gst_buffer_list_get (list, 0));
+    gst_buffer_list_unref (list);
+    return gst_buffer_get_size (*buf);
+  }
+
+  for (i = 0; i < len; i++)
+    size += gst_buffer_get_size (gst_buffer_list_get (list, i));
+
+  GST_DEBUG_OBJECT (appsrc, "submitting %u buffers in a list", len);
+  gst_base_src_submit_buffer_list (GST_BASE_SRC_CAST (appsrc), list);
+  *buf = NULL;
+
+  return size;
+}
+
 static GstFlowReturn
 gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
     GstBuffer ** buf)
@@ -1114,6 +1218,12 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
   GstAppSrc *appsrc = GST_APP_SRC_CAST (bsrc);
   GstAppSrcPrivate *priv = appsrc->priv;
   GstFlowReturn ret;
+  gboolean use_list;
+
+  /* buffer lists can only be pushed in push mode and do-timestamp needs to
+   * see every buffer */
+  use_list = GST_PAD_MODE (GST_BASE_SRC_PAD (bsrc)) == GST_PAD_MODE_PUSH &&
+      !gst_base_src_get_do_timestamp (bsrc);
 
   GST_OBJECT_LOCK (appsrc);
   if (G_UNLIKELY (priv->size != bsrc->segment.duration &&
@@ -1166,10 +1276,10 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
   while (TRUE) {
     /* return data as long as we have some */
     if (!g_queue_is_empty (priv->queue)) {
-      guint buf_size;
+      gsize buf_size;
       GstMiniObject *obj = g_queue_pop_head (priv->queue);
 
-      if (!GST_IS_BUFFER (obj)) {
+      if (!GST_IS_BUFFER (obj) && !GST_IS_BUFFER_LIST (obj)) {
         GstCaps *next_caps = GST_CAPS (obj);
         gboolean caps_changed = TRUE;
 
@@ -1198,10 +1308,11 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
         continue;
       }
 
-      *buf = GST_BUFFER (obj);
-      buf_size = gst_buffer_get_size (*buf);
+      buf_size = gst_app_src_take_data_unlocked (appsrc, obj, use_list,
+          buf);
 
-      GST_DEBUG_OBJECT (appsrc, "we have buffer %p of size %u", *buf, buf_size);
+      GST_DEBUG_OBJECT (appsrc, "we have buffer %p of size %" G_GSIZE_FORMAT,
+          *buf, buf_size);
 
       priv->queued_bytes -= buf_size;
 
@@ -1210,7 +1321,10 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
         priv->offset += buf_size;
 
       /* signal that we removed an item */
-      g_cond_broadcast (&priv->cond);
+      if (priv->wait_status & APP_WAITING) {
+        priv->wait_status &= ~APP_WAITING;
+        g_cond_broadcast (&priv->cond);
+      }
 
       /* see if we go lower than the empty-percent */
       if (priv->min_percent && priv->max_bytes) {
@@ -1244,6 +1358,7 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
       goto eos;
 
     /* nothing to return, wait a while for new data or flushing. */
+    priv->wait_status |= STREAM_WAITING;
     g_cond_wait (&priv->cond, &priv->mutex);
   }
   g_mutex_unlock (&priv->mutex);
@@ -1698,17 +1813,31 @@ gst_app_src_get_emit_signals (GstAppSrc * appsrc)
 }
 
 static GstFlowReturn
-gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
-    gboolean steal_ref)
+gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
+    GstBufferList * buflist, gboolean steal_ref)
 {
   gboolean first = TRUE;
   GstAppSrcPrivate *priv;
+  gsize size = 0;
+  guint i, len;
 
   g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
-  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
 
   priv = appsrc->priv;
 
+  if (buflist != NULL) {
+    len = gst_buffer_list_length (buflist);
+    if (len == 0) {
+      if (steal_ref)
+        gst_buffer_list_unref (buflist);
+      return GST_FLOW_OK;
+    }
+    for (i = 0; i < len; i++)
+      size += gst_buffer_get_size (gst_buffer_list_get (buflist, i));
+  } else {
+    size = gst_buffer_get_size (buffer);
+  }
+
   g_mutex_lock (&priv->mutex);
 
   while (TRUE) {
@@ -1746,6 +1875,7 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
         GST_DEBUG_OBJECT (appsrc, "waiting for free space");
         /* we are filled, wait until a buffer gets popped or when we
          * flush. */
+        priv->wait_status |= APP_WAITING;
         g_cond_wait (&priv->cond, &priv->mutex);
       } else {
         /* no need to wait for free space, we just pump more data into the
@@ -1757,12 +1887,23 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
       break;
   }
 
-  GST_DEBUG_OBJECT (appsrc, "queueing buffer %p", buffer);
-  if (!steal_ref)
-    gst_buffer_ref (buffer);
-  g_queue_push_tail (priv->queue, buffer);
-  priv->queued_bytes += gst_buffer_get_size (buffer);
-  g_cond_broadcast (&priv->cond);
+  if (buflist != NULL) {
+    GST_DEBUG_OBJECT (appsrc, "queueing buffer list %p", buflist);
+    if (!steal_ref)
+      gst_buffer_list_ref (buflist);
+    g_queue_push_tail (priv->queue, buflist);
+  } else {
+    GST_DEBUG_OBJECT (appsrc, "queueing buffer %p", buffer);
+    if (!steal_ref)
+      gst_buffer_ref (buffer);
+    g_queue_push_tail (priv->queue, buffer);
+  }
+  priv->queued_bytes += size;
+  /* only wake up the streaming thread when it is waiting for data */
+  if (priv->wait_status & STREAM_WAITING) {
+    priv->wait_status &= ~STREAM_WAITING;
+    g_cond_broadcast (&priv->cond);
+  }
   g_mutex_unlock (&priv->mutex);
 
   return GST_FLOW_OK;
@@ -1771,21 +1912,38 @@ gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
 flushing:
   {
     GST_DEBUG_OBJECT (appsrc, "refuse buffer %p, we are flushing", buffer);
-    if (steal_ref)
-      gst_buffer_unref (buffer);
+    if (steal_ref) {
+      if (buflist)
+        gst_buffer_list_unref (buflist);
+      else
+        gst_buffer_unref (buffer);
+    }
     g_mutex_unlock (&priv->mutex);
     return GST_FLOW_FLUSHING;
   }
 eos:
   {
     GST_DEBUG_OBJECT (appsrc, "refuse buffer %p, we are EOS", buffer);
-    if (steal_ref)
-      gst_buffer_unref (buffer);
+    if (steal_ref) {
+      if (buflist)
+        gst_buffer_list_unref (buflist);
+      else
+        gst_buffer_unref (buffer);
+    }
     g_mutex_unlock (&priv->mutex);
     return GST_FLOW_EOS;
   }
 }
 
+static GstFlowReturn
+gst_app_src_push_buffer_full (GstAppSrc * appsrc, GstBuffer * buffer,
+    gboolean steal_ref)
+{
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
+
+  return gst_app_src_push_internal (appsrc, buffer, NULL, steal_ref);
+}
+
 static GstFlowReturn
 gst_app_src_push_sample_internal (GstAppSrc * appsrc, GstSample * sample)
 {
@@ -1831,6 +1989,37 @@ gst_app_src_push_buffer (GstAppSrc * appsrc, GstBuffer * buffer)
   return gst_app_src_push_buffer_full (appsrc, buffer, TRUE);
 }
 
+/**
+ * gst_app_src_push_buffer_list:
+ * @appsrc: a #GstAppSrc
+ * @buffer_list: (transfer full): a #GstBufferList to push
+ *
+ * Adds a buffer list to the queue of buffers and buffer lists that the
+ * appsrc element will push to its source pad. This function takes ownership
+ * of @buffer_list.
+ *
+ * The whole list is queued with a single lock operation, which is cheaper
+ * than pushing many small buffers one by one. In push mode the streaming
+ * thread pushes all the data queued up to the next caps change downstream in
+ * one buffer list.
+ *
+ * When the block property is TRUE, this function can block until free
+ * space becomes available in the queue.
+ *
+ * Returns: #GST_FLOW_OK when the buffer list was successfuly queued.
+ * #GST_FLOW_FLUSHING when @appsrc is not PAUSED or PLAYING.
+ * #GST_FLOW_EOS when EOS occured.
+ *
+ * Since: 1.10
+ */
+GstFlowReturn
+gst_app_src_push_buffer_list (GstAppSrc * appsrc, GstBufferList * buffer_list)
+{
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (buffer_list), GST_FLOW_ERROR);
+
+  return gst_app_src_push_internal (appsrc, NULL, buffer_list, TRUE);
+}
+
 /**
  * gst_app_src_push_sample:
  * @appsrc: a #GstAppSrc
@@ -1866,6 +2055,17 @@ gst_app_src_push_buffer_action (GstAppSrc * appsrc, GstBuffer * buffer)
   return gst_app_src_push_buffer_full (appsrc, buffer, FALSE);
 }
 
+/* push a buffer list without stealing the ref of the buffer list. This is
+ * used for the action signal. */
+static GstFlowReturn
+gst_app_src_push_buffer_list_action (GstAppSrc * appsrc,
+    GstBufferList * buffer_list)
+{
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (buffer_list), GST_FLOW_ERROR);
+
+  return gst_app_src_push_internal (appsrc, NULL, buffer_list, FALSE);
+}
+
 /* push a sample without stealing the ref. This is used for the
  * action signal. */
 static GstFlowReturn
@@ -144,6 +144,9 @@ struct _GstAudioConverter
   AudioChain *pack_chain;
 
   AudioConvertSamplesFunc convert;
+  gsize block_frames;
+  gpointer *in_block;
+  gpointer *out_block;
 };
 
 typedef gboolean (*AudioChainFunc) (AudioChain * chain, gpointer user_data);
@@ -884,6 +887,79 @@ converter_generic (GstAudioConverter * convert,
   return TRUE;
 }
 
+/* number of samples of the widest intermediate format we process at a time
+ * when there is no resampler, so that all temporary buffers of the chain stay
+ * resident in the cache while a block travels through it */
+#define CONVERTER_BLOCK_SAMPLES 2048
+
+static gboolean
+converter_blocked (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  gpointer *in_block = convert->in_block, *out_block = convert->out_block;
+  gint i, in_blocks, out_blocks, in_stride, out_stride;
+  gsize block_frames, done;
+
+  block_frames = convert->block_frames;
+  if (in_frames <= block_frames)
+    return converter_generic (convert, flags, in, in_frames, out, out_frames);
+
+  if (convert->in.layout == GST_AUDIO_LAYOUT_INTERLEAVED) {
+    in_blocks = 1;
+    in_stride = convert->in.bpf;
+  } else {
+    in_blocks = convert->in.channels;
+    in_stride = convert->in.bpf / convert->in.channels;
+  }
+  if (convert->out.layout == GST_AUDIO_LAYOUT_INTERLEAVED) {
+    out_blocks = 1;
+    out_stride = convert->out.bpf;
+  } else {
+    out_blocks = convert->out.channels;
+    out_stride = convert->out.bpf / convert->out.channels;
+  }
+
+  for (done = 0; done < in_frames; done += block_frames) {
+    gsize frames = MIN (block_frames, in_frames - done);
+
+    if (in) {
+      for (i = 0; i < in_blocks; i++)
+        in_block[i] = (guint8 *) in[i] + done * in_stride;
+    }
+    for (i = 0; i < out_blocks; i++)
+      out_block[i] = (guint8 *) out[i] + done * out_stride;
+
+    converter_generic (convert, flags, in ? in_block : NULL, frames,
+        out_block, frames);
+  }
+  return TRUE;
+}
+
+/* direct S16 -> F32 for when nothing but the format changes. The generic
+ * chain unpacks to S32 with truncation, converts to F64 and packs to F32,
+ * which is exactly a division by 32768 for every input sample. */
+static gboolean
+converter_s16_to_f32 (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  gsize i, samples;
+  gfloat *d = out[0];
+
+  samples = in_frames * convert->out.channels;
+
+  if (in) {
+    const gint16 *s = in[0];
+
+    for (i = 0; i < samples; i++)
+      d[i] = s[i] * (1.0f / 32768.0f);
+  } else {
+    memset (d, 0, samples * sizeof (gfloat));
+  }
+  return TRUE;
+}
+
 static gboolean
 converter_resample (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
@@ -970,6 +1046,23 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
         convert->convert = converter_resample;
       }
     }
+  } else if (convert->resampler == NULL) {
+    if (in_info->finfo->format == GST_AUDIO_FORMAT_S16
+        && out_info->finfo->format == GST_AUDIO_FORMAT_F32
+        && in_info->layout == GST_AUDIO_LAYOUT_INTERLEAVED
+        && convert->mix_passthrough) {
+      GST_INFO ("S16 to F32 and passthrough mixing -> direct conversion");
+      convert->convert = converter_s16_to_f32;
+    } else {
+      gint channels = MAX (in_info->channels, out_info->channels);
+
+      convert->block_frames = MAX (CONVERTER_BLOCK_SAMPLES / channels, 1);
+      convert->in_block = g_new (gpointer, in_info->channels);
+      convert->out_block = g_new (gpointer, out_info->channels);
+      GST_INFO ("no resampler -> convert in blocks of %" G_GSIZE_FORMAT
+          " frames", convert->block_frames);
+      convert->convert = converter_blocked;
+    }
   }
 
   setup_allocators (convert);
@@ -1013,6 +1106,8 @@ gst_audio_converter_free (GstAudioConverter * convert)
     gst_audio_channel_mixer_free (convert->mix);
   if (convert->resampler)
     gst_audio_resampler_free (convert->resampler);
+  g_free (convert->in_block);
+  g_free (convert->out_block);
   gst_audio_info_init (&convert->in);
   gst_audio_info_init (&convert->out);
 
@@ -637,6 +637,258 @@ MAKE_RESAMPLE_FUNC (gint32, linear, 1, sse41);
 MAKE_RESAMPLE_FUNC (gint32, cubic, 1, sse41);
 #endif
 
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX__)
+#include <immintrin.h>
+
+/* the taps are only 16 byte aligned, use unaligned loads everywhere */
+static inline void
+inner_product_gfloat_full_1_avx (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum = _mm256_setzero_ps ();
+  __m128 s;
+
+  for (; i < len; i += 8) {
+    sum =
+        _mm256_add_ps (sum, _mm256_mul_ps (_mm256_loadu_ps (a + i),
+            _mm256_loadu_ps (b + i)));
+  }
+  s = _mm_add_ps (_mm256_castps256_ps128 (sum), _mm256_extractf128_ps (sum, 1));
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_shuffle_ps (s, s, 0x55));
+  _mm_store_ss (o, s);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2], t;
+  __m128 s;
+  const gfloat *c[2] = {(gfloat*)((gint8*)b + 0*bstride),
+                        (gfloat*)((gint8*)b + 1*bstride)};
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_add_ps (sum[0], _mm256_mul_ps (t, _mm256_loadu_ps (c[0] + i)));
+    sum[1] = _mm256_add_ps (sum[1], _mm256_mul_ps (t, _mm256_loadu_ps (c[1] + i)));
+  }
+  sum[0] = _mm256_mul_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_broadcast_ss (icoeff));
+  sum[0] = _mm256_add_ps (sum[0], sum[1]);
+  s = _mm_add_ps (_mm256_castps256_ps128 (sum[0]),
+      _mm256_extractf128_ps (sum[0], 1));
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_shuffle_ps (s, s, 0x55));
+  _mm_store_ss (o, s);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[4], t;
+  __m128 s;
+  const gfloat *c[4] = {(gfloat*)((gint8*)b + 0*bstride),
+                        (gfloat*)((gint8*)b + 1*bstride),
+                        (gfloat*)((gint8*)b + 2*bstride),
+                        (gfloat*)((gint8*)b + 3*bstride)};
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_add_ps (sum[0], _mm256_mul_ps (t, _mm256_loadu_ps (c[0] + i)));
+    sum[1] = _mm256_add_ps (sum[1], _mm256_mul_ps (t, _mm256_loadu_ps (c[1] + i)));
+    sum[2] = _mm256_add_ps (sum[2], _mm256_mul_ps (t, _mm256_loadu_ps (c[2] + i)));
+    sum[3] = _mm256_add_ps (sum[3], _mm256_mul_ps (t, _mm256_loadu_ps (c[3] + i)));
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_broadcast_ss (icoeff + 0));
+  sum[1] = _mm256_mul_ps (sum[1], _mm256_broadcast_ss (icoeff + 1));
+  sum[2] = _mm256_mul_ps (sum[2], _mm256_broadcast_ss (icoeff + 2));
+  sum[3] = _mm256_mul_ps (sum[3], _mm256_broadcast_ss (icoeff + 3));
+  sum[0] = _mm256_add_ps (sum[0], sum[1]);
+  sum[2] = _mm256_add_ps (sum[2], sum[3]);
+  sum[0] = _mm256_add_ps (sum[0], sum[2]);
+  s = _mm_add_ps (_mm256_castps256_ps128 (sum[0]),
+      _mm256_extractf128_ps (sum[0], 1));
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_shuffle_ps (s, s, 0x55));
+  _mm_store_ss (o, s);
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx);
+
+static void
+interpolate_gfloat_linear_avx (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2], t1, t2;
+  const gfloat *c[2] = {(gfloat*)((gint8*)a + 0*astride),
+                        (gfloat*)((gint8*)a + 1*astride)};
+
+  f[0] = _mm256_broadcast_ss (ic+0);
+  f[1] = _mm256_broadcast_ss (ic+1);
+
+  for (i = 0; i < len; i += 8) {
+    t1 = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t2 = _mm256_mul_ps (_mm256_loadu_ps (c[1] + i), f[1]);
+    _mm256_storeu_ps (o + i, _mm256_add_ps (t1, t2));
+  }
+}
+
+static void
+interpolate_gfloat_cubic_avx (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t[4];
+  const gfloat *c[4] = {(gfloat*)((gint8*)a + 0*astride),
+                        (gfloat*)((gint8*)a + 1*astride),
+                        (gfloat*)((gint8*)a + 2*astride),
+                        (gfloat*)((gint8*)a + 3*astride)};
+
+  f[0] = _mm256_broadcast_ss (ic+0);
+  f[1] = _mm256_broadcast_ss (ic+1);
+  f[2] = _mm256_broadcast_ss (ic+2);
+  f[3] = _mm256_broadcast_ss (ic+3);
+
+  for (i = 0; i < len; i += 8) {
+    t[0] = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t[1] = _mm256_mul_ps (_mm256_loadu_ps (c[1] + i), f[1]);
+    t[2] = _mm256_mul_ps (_mm256_loadu_ps (c[2] + i), f[2]);
+    t[3] = _mm256_mul_ps (_mm256_loadu_ps (c[3] + i), f[3]);
+    t[0] = _mm256_add_ps (t[0], t[1]);
+    t[2] = _mm256_add_ps (t[2], t[3]);
+    _mm256_storeu_ps (o + i, _mm256_add_ps (t[0], t[2]));
+  }
+}
+
+static inline void
+inner_product_gdouble_full_1_avx (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum = _mm256_setzero_pd ();
+  __m128d s;
+
+  for (; i < len; i += 8) {
+    sum =
+        _mm256_add_pd (sum, _mm256_mul_pd (_mm256_loadu_pd (a + i + 0),
+            _mm256_loadu_pd (b + i + 0)));
+    sum =
+        _mm256_add_pd (sum, _mm256_mul_pd (_mm256_loadu_pd (a + i + 4),
+            _mm256_loadu_pd (b + i + 4)));
+  }
+  s = _mm_add_pd (_mm256_castpd256_pd128 (sum), _mm256_extractf128_pd (sum, 1));
+  s = _mm_add_sd (s, _mm_unpackhi_pd (s, s));
+  _mm_store_sd (o, s);
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2], t;
+  __m128d s;
+  const gdouble *c[2] = {(gdouble*)((gint8*)b + 0*bstride),
+                         (gdouble*)((gint8*)b + 1*bstride)};
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_add_pd (sum[0], _mm256_mul_pd (t, _mm256_loadu_pd (c[0] + i)));
+    sum[1] = _mm256_add_pd (sum[1], _mm256_mul_pd (t, _mm256_loadu_pd (c[1] + i)));
+  }
+  sum[0] = _mm256_mul_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_broadcast_sd (icoeff));
+  sum[0] = _mm256_add_pd (sum[0], sum[1]);
+  s = _mm_add_pd (_mm256_castpd256_pd128 (sum[0]),
+      _mm256_extractf128_pd (sum[0], 1));
+  s = _mm_add_sd (s, _mm_unpackhi_pd (s, s));
+  _mm_store_sd (o, s);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[4], t;
+  __m128d s;
+  const gdouble *c[4] = {(gdouble*)((gint8*)b + 0*bstride),
+                         (gdouble*)((gint8*)b + 1*bstride),
+                         (gdouble*)((gint8*)b + 2*bstride),
+                         (gdouble*)((gint8*)b + 3*bstride)};
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_add_pd (sum[0], _mm256_mul_pd (t, _mm256_loadu_pd (c[0] + i)));
+    sum[1] = _mm256_add_pd (sum[1], _mm256_mul_pd (t, _mm256_loadu_pd (c[1] + i)));
+    sum[2] = _mm256_add_pd (sum[2], _mm256_mul_pd (t, _mm256_loadu_pd (c[2] + i)));
+    sum[3] = _mm256_add_pd (sum[3], _mm256_mul_pd (t, _mm256_loadu_pd (c[3] + i)));
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_broadcast_sd (icoeff + 0));
+  sum[1] = _mm256_mul_pd (sum[1], _mm256_broadcast_sd (icoeff + 1));
+  sum[2] = _mm256_mul_pd (sum[2], _mm256_broadcast_sd (icoeff + 2));
+  sum[3] = _mm256_mul_pd (sum[3], _mm256_broadcast_sd (icoeff + 3));
+  sum[0] = _mm256_add_pd (sum[0], sum[1]);
+  sum[2] = _mm256_add_pd (sum[2], sum[3]);
+  sum[0] = _mm256_add_pd (sum[0], sum[2]);
+  s = _mm_add_pd (_mm256_castpd256_pd128 (sum[0]),
+      _mm256_extractf128_pd (sum[0], 1));
+  s = _mm_add_sd (s, _mm_unpackhi_pd (s, s));
+  _mm_store_sd (o, s);
+}
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx);
+
+#endif
+
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX2__)
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum = _mm256_setzero_si256 ();
+  __m128i s;
+
+  for (i = 0; i < len; i += 16) {
+    sum = _mm256_add_epi32 (sum,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+  }
+  s = _mm_add_epi32 (_mm256_castsi256_si128 (sum),
+      _mm256_extracti128_si256 (sum, 1));
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (2, 3, 2, 3)));
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  s = _mm_add_epi32 (s, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  s = _mm_srai_epi32 (s, PRECISION_S16);
+  s = _mm_packs_epi32 (s, s);
+  *o = _mm_extract_epi16 (s, 0);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+#endif
+
 static void
 audio_resampler_check_x86 (const gchar *option)
 {
@@ -679,6 +931,25 @@ audio_resampler_check_x86 (const gchar *option)
     resample_gint32_cubic_1 = resample_gint32_cubic_1_sse41;
 #else
     GST_DEBUG ("SSE41 optimisations not enabled");
+#endif
+    /* orc has no flags for AVX, these paths are only built when the compiler
+     * targets CPUs that have it, all of which also have SSE4.1 */
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX__)
+    GST_DEBUG ("enable AVX optimisations");
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx;
+
+    interpolate_gfloat_linear = interpolate_gfloat_linear_avx;
+    interpolate_gfloat_cubic = interpolate_gfloat_cubic_avx;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx;
+#endif
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX2__)
+    GST_DEBUG ("enable AVX2 optimisations");
+    resample_gint16_full_1 = resample_gint16_full_1_avx2;
 #endif
   }
 }
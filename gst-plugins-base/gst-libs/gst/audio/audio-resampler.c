@@ -62,6 +62,32 @@ typedef void (*DeinterleaveFunc) (GstAudioResampler * resampler,
 #define ALIGN 16
 #define TAPS_OVERREAD 16
 
+/* everything the contents of a filter table depend on */
+typedef struct
+{
+  gboolean full;
+  GstAudioResamplerMethod method;
+  gint format_index;
+  gint n_taps;
+  gdouble cutoff;
+  gdouble kaiser_beta;
+  gdouble b, c;
+  gint oversample;
+  GstAudioResamplerFilterInterpolation filter_interpolation;
+  gint n_phases;
+} TapsTableKey;
+
+/* a filter table shared between all resamplers with the same key */
+typedef struct
+{
+  TapsTableKey key;
+  gint refcount;
+  gpointer mem;
+  gpointer taps;
+  gpointer *phases;
+  gsize stride;
+} TapsTable;
+
 struct _GstAudioResampler
 {
   GstAudioResamplerMethod method;
@@ -92,16 +118,15 @@ struct _GstAudioResampler
   gint oversample;
   gint n_taps;
   gpointer taps;
-  gpointer taps_mem;
+  TapsTable *taps_table;
   gsize taps_stride;
   gint n_phases;
-  gint alloc_taps;
-  gint alloc_phases;
 
-  /* cached taps */
+  /* cached taps, either private or all computed and shared */
   gpointer *cached_phases;
   gpointer cached_taps;
   gpointer cached_taps_mem;
+  TapsTable *cached_table;
   gsize cached_taps_stride;
 
   ConvertTapsFunc convert_taps;
@@ -191,6 +216,9 @@ static const BlackmanQualityMap blackman_qualities[] = {
 #define DEFAULT_OPT_FILTER_OVERSAMPLE 8
 #define DEFAULT_OPT_MAX_PHASE_ERROR 0.1
 
+/* maximum size of a filter cache that is computed upfront and shared */
+#define SHARED_CACHE_THRESHOLD 1048576
+
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
 {
@@ -1085,12 +1113,11 @@ calculate_kaiser_params (GstAudioResampler * resampler)
       resampler->n_taps, resampler->cutoff);
 }
 
-static void
+static gpointer
 alloc_taps_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
     gint n_phases)
 {
-  if (resampler->alloc_taps >= n_taps && resampler->alloc_phases >= n_phases)
-    return;
+  gpointer taps_mem;
 
   GST_DEBUG ("allocate bps %d n_taps %d n_phases %d", bps, n_taps, n_phases);
 
@@ -1099,12 +1126,10 @@ alloc_taps_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
 
   resampler->taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
 
-  g_free (resampler->taps_mem);
-  resampler->taps_mem =
-      g_malloc0 (n_phases * resampler->taps_stride + ALIGN - 1);
-  resampler->taps = MEM_ALIGN ((gint8 *) resampler->taps_mem, ALIGN);
-  resampler->alloc_taps = n_taps;
-  resampler->alloc_phases = n_phases;
+  taps_mem = g_malloc0 (n_phases * resampler->taps_stride + ALIGN - 1);
+  resampler->taps = MEM_ALIGN ((gint8 *) taps_mem, ALIGN);
+
+  return taps_mem;
 }
 
 static void
@@ -1130,6 +1155,163 @@ alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
   resampler->cached_phases = resampler->cached_taps_mem;
 }
 
+static GMutex taps_tables_lock;
+static GList *taps_tables;
+
+static void
+taps_table_key_init (GstAudioResampler * resampler, TapsTableKey * key,
+    gboolean full, gint n_phases)
+{
+  /* clear the padding too, keys are compared with memcmp */
+  memset (key, 0, sizeof (TapsTableKey));
+  key->full = full;
+  key->method = resampler->method;
+  key->format_index = resampler->format_index;
+  key->n_taps = resampler->n_taps;
+  key->cutoff = resampler->cutoff;
+  key->kaiser_beta = resampler->kaiser_beta;
+  key->b = resampler->b;
+  key->c = resampler->c;
+  key->oversample = resampler->oversample;
+  key->filter_interpolation = resampler->filter_interpolation;
+  key->n_phases = n_phases;
+}
+
+/* with taps_tables_lock */
+static TapsTable *
+taps_table_find (const TapsTableKey * key)
+{
+  GList *l;
+
+  for (l = taps_tables; l; l = l->next) {
+    TapsTable *table = l->data;
+
+    if (memcmp (&table->key, key, sizeof (TapsTableKey)) == 0) {
+      table->refcount++;
+      return table;
+    }
+  }
+  return NULL;
+}
+
+static TapsTable *
+taps_table_acquire (const TapsTableKey * key)
+{
+  TapsTable *table;
+
+  g_mutex_lock (&taps_tables_lock);
+  table = taps_table_find (key);
+  g_mutex_unlock (&taps_tables_lock);
+
+  return table;
+}
+
+/* takes ownership of @mem, returns the table that was already added for
+ * @key by another resampler in the meantime when there is one */
+static TapsTable *
+taps_table_add (const TapsTableKey * key, gpointer mem, gpointer taps,
+    gpointer * phases, gsize stride)
+{
+  TapsTable *table;
+
+  g_mutex_lock (&taps_tables_lock);
+  table = taps_table_find (key);
+  if (table == NULL) {
+    table = g_slice_new (TapsTable);
+    table->key = *key;
+    table->refcount = 1;
+    table->mem = mem;
+    table->taps = taps;
+    table->phases = phases;
+    table->stride = stride;
+    taps_tables = g_list_prepend (taps_tables, table);
+  } else {
+    g_free (mem);
+  }
+  g_mutex_unlock (&taps_tables_lock);
+
+  return table;
+}
+
+static void
+taps_table_unref (TapsTable * table)
+{
+  g_mutex_lock (&taps_tables_lock);
+  if (--table->refcount == 0) {
+    taps_tables = g_list_remove (taps_tables, table);
+    g_free (table->mem);
+    g_slice_free (TapsTable, table);
+  }
+  g_mutex_unlock (&taps_tables_lock);
+}
+
+#define FILL_CACHE(type)                                        \
+G_STMT_START {                                                  \
+  type icoeff[4];                                               \
+  gint samp_index = 0, samp_phase = i;                          \
+                                                                \
+  get_taps_##type##_full (resampler, &samp_index, &samp_phase,  \
+      icoeff);                                                  \
+} G_STMT_END
+
+static void
+setup_cache (GstAudioResampler * resampler)
+{
+  gint i, bps = resampler->bps;
+  gint n_taps = resampler->n_taps;
+  gint n_phases = resampler->n_phases;
+  TapsTableKey key;
+
+  if (resampler->cached_table) {
+    taps_table_unref (resampler->cached_table);
+    resampler->cached_table = NULL;
+  }
+
+  /* with a variable rate the phases change too often, fill the cache when
+   * the phases are used */
+  if ((resampler->flags & GST_AUDIO_RESAMPLER_FLAG_VARIABLE_RATE) ||
+      (gsize) bps * n_taps * n_phases > SHARED_CACHE_THRESHOLD) {
+    alloc_cache_mem (resampler, bps, n_taps, n_phases);
+    return;
+  }
+
+  /* a fixed rate uses all phases, compute them once for all resamplers with
+   * the same filter */
+  g_free (resampler->cached_taps_mem);
+  resampler->cached_taps_mem = NULL;
+
+  taps_table_key_init (resampler, &key, TRUE, n_phases);
+  resampler->cached_table = taps_table_acquire (&key);
+  if (resampler->cached_table == NULL) {
+    GST_DEBUG ("computing shared filter cache of %d phases", n_phases);
+
+    alloc_cache_mem (resampler, bps, n_taps, n_phases);
+    for (i = 0; i < n_phases; i++) {
+      switch (resampler->format_index) {
+        case 0:
+          FILL_CACHE (gint16);
+          break;
+        case 1:
+          FILL_CACHE (gint32);
+          break;
+        case 2:
+          FILL_CACHE (gfloat);
+          break;
+        case 3:
+          FILL_CACHE (gdouble);
+          break;
+      }
+    }
+    resampler->cached_table = taps_table_add (&key,
+        resampler->cached_taps_mem, resampler->cached_taps,
+        resampler->cached_phases, resampler->cached_taps_stride);
+    resampler->cached_taps_mem = NULL;
+  }
+  resampler->cached_taps = resampler->cached_table->taps;
+  resampler->cached_phases = resampler->cached_table->phases;
+  resampler->cached_taps_stride = resampler->cached_table->stride;
+}
+
 static void
 setup_functions (GstAudioResampler * resampler)
 {
@@ -1293,18 +1475,17 @@ resampler_calculate_taps (GstAudioResampler * resampler)
 
   resampler->filter_interpolation = filter_interpolation;
 
-  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
-      resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST) {
-    GST_DEBUG ("setting up filter cache");
-    resampler->n_phases = out_rate;
-    alloc_cache_mem (resampler, bps, n_taps, out_rate);
+  if (resampler->taps_table) {
+    taps_table_unref (resampler->taps_table);
+    resampler->taps_table = NULL;
   }
 
   if (resampler->filter_interpolation !=
       GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE) {
     gint i, isize;
     gdouble x;
-    gpointer taps;
+    gpointer taps, taps_mem;
+    TapsTableKey key;
 
     switch (resampler->filter_interpolation) {
       default:
@@ -1318,13 +1499,23 @@ resampler_calculate_taps (GstAudioResampler * resampler)
         break;
     }
 
-    alloc_taps_mem (resampler, bps, n_taps, oversample + isize);
-
-    for (i = 0; i < oversample + isize; i++) {
-      x = -(n_taps / 2) + i / (gdouble) oversample;
-      taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
-      make_taps (resampler, taps, x, n_taps);
+    /* the oversampled filter only depends on the filter parameters, share
+     * it with all other resamplers that use the same */
+    taps_table_key_init (resampler, &key, FALSE, oversample + isize);
+    resampler->taps_table = taps_table_acquire (&key);
+    if (resampler->taps_table == NULL) {
+      taps_mem = alloc_taps_mem (resampler, bps, n_taps, oversample + isize);
+
+      for (i = 0; i < oversample + isize; i++) {
+        x = -(n_taps / 2) + i / (gdouble) oversample;
+        taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
+        make_taps (resampler, taps, x, n_taps);
+      }
+      resampler->taps_table = taps_table_add (&key, taps_mem, resampler->taps,
+          NULL, resampler->taps_stride);
     }
+    resampler->taps = resampler->taps_table->taps;
+    resampler->taps_stride = resampler->taps_table->stride;
   }
 }
 
@@ -1719,13 +1910,16 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
 
       resampler->samples_avail += diff;
     }
-  } else if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL) {
+  }
+  setup_functions (resampler);
+
+  /* after setting up the functions, a shared cache is filled with them */
+  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
+      resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST) {
     GST_DEBUG ("setting up filter cache");
     resampler->n_phases = resampler->out_rate;
-    alloc_cache_mem (resampler, resampler->bps, resampler->n_taps,
-        resampler->n_phases);
+    setup_cache (resampler);
   }
-  setup_functions (resampler);
 
   return TRUE;
 }
@@ -1743,8 +1937,11 @@ gst_audio_resampler_free (GstAudioResampler * resampler)
 {
   g_return_if_fail (resampler != NULL);
 
+  if (resampler->cached_table)
+    taps_table_unref (resampler->cached_table);
+  if (resampler->taps_table)
+    taps_table_unref (resampler->taps_table);
   g_free (resampler->cached_taps_mem);
-  g_free (resampler->taps_mem);
   g_free (resampler->tmp_taps);
   g_free (resampler->samples);
   g_free (resampler->sbuf);
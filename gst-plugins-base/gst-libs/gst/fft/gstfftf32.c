@@ -28,6 +28,7 @@
 #include "kiss_fftr_f32.h"
 #include "gstfft.h"
 #include "gstfftf32.h"
+#include "gstfftf32pow2.h"
 
 /**
  * SECTION:gstfftf32
@@ -43,7 +44,10 @@
  *
  * For the best performance use gst_fft_next_fast_length() to get a
  * number that is entirely a product of 2, 3 and 5 and use this as the
- * @len parameter for gst_fft_f32_new().
+ * @len parameter for gst_fft_f32_new(). Powers of two of at least 16 are
+ * handled by a vectorized implementation and are usually the fastest, the
+ * twiddle factors for them are shared between all instances of the same
+ * length.
  *
  * The @len parameter specifies the number of samples in the time domain that
  * will be processed or generated. The number of samples in the frequency domain
@@ -66,6 +70,11 @@ struct _GstFFTF32
   void *cfg;
   gboolean inverse;
   gint len;
+
+  /* shared plan and scratch memory for power of two lengths,
+   * cfg is not used in that case */
+  GstFFTF32Pow2Plan *pow2;
+  GstFFTF32Complex *scratch;
 };
 
 /**
@@ -86,11 +95,27 @@ GstFFTF32 *
 gst_fft_f32_new (gint len, gboolean inverse)
 {
   GstFFTF32 *self;
+  GstFFTF32Pow2Plan *pow2;
   gsize subsize = 0, memneeded;
 
   g_return_val_if_fail (len > 0, NULL);
   g_return_val_if_fail (len % 2 == 0, NULL);
 
+  pow2 = _gst_fft_f32_pow2_plan_get (len, inverse);
+  if (pow2) {
+    memneeded = ALIGN_STRUCT (sizeof (GstFFTF32)) +
+        _gst_fft_f32_pow2_scratch_size (pow2) * sizeof (GstFFTF32Complex);
+
+    self = (GstFFTF32 *) g_malloc0 (memneeded);
+    self->pow2 = pow2;
+    self->scratch = (GstFFTF32Complex *) (((guint8 *) self) +
+        ALIGN_STRUCT (sizeof (GstFFTF32)));
+    self->inverse = inverse;
+    self->len = len;
+
+    return self;
+  }
+
   kiss_fftr_f32_alloc (len, (inverse) ? 1 : 0, NULL, &subsize);
   memneeded = ALIGN_STRUCT (sizeof (GstFFTF32)) + subsize;
 
@@ -130,7 +155,10 @@ gst_fft_f32_fft (GstFFTF32 * self, const gfloat * timedata,
   g_return_if_fail (timedata);
   g_return_if_fail (freqdata);
 
-  kiss_fftr_f32 (self->cfg, timedata, (kiss_fft_f32_cpx *) freqdata);
+  if (self->pow2)
+    _gst_fft_f32_pow2_fft (self->pow2, timedata, freqdata, self->scratch);
+  else
+    kiss_fftr_f32 (self->cfg, timedata, (kiss_fft_f32_cpx *) freqdata);
 }
 
 /**
@@ -156,7 +184,11 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
   g_return_if_fail (timedata);
   g_return_if_fail (freqdata);
 
-  kiss_fftri_f32 (self->cfg, (kiss_fft_f32_cpx *) freqdata, timedata);
+  if (self->pow2)
+    _gst_fft_f32_pow2_inverse_fft (self->pow2, freqdata, timedata,
+        self->scratch);
+  else
+    kiss_fftri_f32 (self->cfg, (kiss_fft_f32_cpx *) freqdata, timedata);
 }
 
 /**
@@ -169,6 +201,8 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
 void
 gst_fft_f32_free (GstFFTF32 * self)
 {
+  if (self->pow2)
+    _gst_fft_f32_pow2_plan_unref (self->pow2);
   g_free (self);
 }
 
@@ -0,0 +1,350 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Real FFT for power of two lengths.
+ *
+ * The real input of length len is handled as a complex sequence of length
+ * n = len / 2, transformed with a radix-2 Stockham FFT and then split into
+ * the spectrum of the real sequence, the same way kiss_fftr does it. The
+ * Stockham formulation is self-sorting and keeps the inner loops contiguous,
+ * which makes the butterflies easy to vectorize.
+ *
+ * Plans only contain the (read-only) twiddle factors and are shared between
+ * all instances of the same length and direction. The butterfly stage
+ * implementation is selected at runtime depending on the CPU features.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#include "gstfftf32pow2.h"
+
+#if defined (HAVE_XMMINTRIN_H) && defined (__GNUC__) && \
+    (defined (__i386__) || defined (__x86_64__))
+#define HAVE_FFT_SSE
+#include <xmmintrin.h>
+#endif
+
+/* Smaller sizes are not worth it and are left to kiss_fft */
+#define MIN_LEN 16
+
+struct _GstFFTF32Pow2Plan
+{
+  gint refcount;
+  gint len;
+  gboolean inverse;
+
+  /* complex FFT length, len / 2 */
+  gint n;
+  /* exp(-+2 pi i k / n) for k < n / 2 */
+  GstFFTF32Complex *twiddles;
+  /* twiddles for splitting the complex FFT into the real FFT */
+  GstFFTF32Complex *super_twiddles;
+};
+
+typedef void (*FFTStageFunc) (const GstFFTF32Complex * x,
+    GstFFTF32Complex * y, gint m, gint s, const GstFFTF32Complex * tw);
+
+static FFTStageFunc fft_stage;
+
+static GMutex plans_lock;
+static GHashTable *plans;
+
+/* One radix-2 stage of a Stockham FFT of length n = 2 * m with stride s.
+ * Element q + s * p of the m sequences of the previous stage is combined
+ * with element q + s * (p + m) */
+static void
+fft_stage_c (const GstFFTF32Complex * x, GstFFTF32Complex * y, gint m,
+    gint s, const GstFFTF32Complex * tw)
+{
+  gint p, q;
+
+  for (p = 0; p < m; p++) {
+    const GstFFTF32Complex *x0 = x + s * p;
+    const GstFFTF32Complex *x1 = x + s * (p + m);
+    GstFFTF32Complex *y0 = y + s * 2 * p;
+    GstFFTF32Complex *y1 = y + s * (2 * p + 1);
+    gfloat wr = tw[p * s].r, wi = tw[p * s].i;
+
+    for (q = 0; q < s; q++) {
+      gfloat dr = x0[q].r - x1[q].r;
+      gfloat di = x0[q].i - x1[q].i;
+
+      y0[q].r = x0[q].r + x1[q].r;
+      y0[q].i = x0[q].i + x1[q].i;
+      y1[q].r = dr * wr - di * wi;
+      y1[q].i = dr * wi + di * wr;
+    }
+  }
+}
+
+#ifdef HAVE_FFT_SSE
+/* multiply two pairs of complex numbers */
+__attribute__ ((target ("sse")))
+static inline __m128
+cmul_sse (__m128 d, __m128 w)
+{
+  const __m128 sign = _mm_set_ps (0.0f, -0.0f, 0.0f, -0.0f);
+  __m128 wr, wi, ds;
+
+  wr = _mm_shuffle_ps (w, w, _MM_SHUFFLE (2, 2, 0, 0));
+  wi = _mm_shuffle_ps (w, w, _MM_SHUFFLE (3, 3, 1, 1));
+  ds = _mm_shuffle_ps (d, d, _MM_SHUFFLE (2, 3, 0, 1));
+
+  return _mm_add_ps (_mm_mul_ps (d, wr),
+      _mm_xor_ps (_mm_mul_ps (ds, wi), sign));
+}
+
+__attribute__ ((target ("sse")))
+static void
+fft_stage_sse (const GstFFTF32Complex * x, GstFFTF32Complex * y, gint m,
+    gint s, const GstFFTF32Complex * tw)
+{
+  gint p, q;
+
+  if (s == 1) {
+    /* first stage, vectorize over p. m is a multiple of 2 here */
+    for (p = 0; p < m; p += 2) {
+      __m128 a = _mm_loadu_ps ((const gfloat *) (x + p));
+      __m128 b = _mm_loadu_ps ((const gfloat *) (x + p + m));
+      __m128 w = _mm_loadu_ps ((const gfloat *) (tw + p));
+      __m128 sum = _mm_add_ps (a, b);
+      __m128 dw = cmul_sse (_mm_sub_ps (a, b), w);
+
+      _mm_storeu_ps ((gfloat *) (y + 2 * p), _mm_movelh_ps (sum, dw));
+      _mm_storeu_ps ((gfloat *) (y + 2 * p + 2), _mm_movehl_ps (dw, sum));
+    }
+    return;
+  }
+
+  /* vectorize over q, s is a multiple of 2 here */
+  for (p = 0; p < m; p++) {
+    const GstFFTF32Complex *x0 = x + s * p;
+    const GstFFTF32Complex *x1 = x + s * (p + m);
+    GstFFTF32Complex *y0 = y + s * 2 * p;
+    GstFFTF32Complex *y1 = y + s * (2 * p + 1);
+    __m128 w;
+
+    w = _mm_loadl_pi (_mm_setzero_ps (), (const __m64 *) (tw + p * s));
+    w = _mm_movelh_ps (w, w);
+
+    for (q = 0; q < s; q += 2) {
+      __m128 a = _mm_loadu_ps ((const gfloat *) (x0 + q));
+      __m128 b = _mm_loadu_ps ((const gfloat *) (x1 + q));
+
+      _mm_storeu_ps ((gfloat *) (y0 + q), _mm_add_ps (a, b));
+      _mm_storeu_ps ((gfloat *) (y1 + q), cmul_sse (_mm_sub_ps (a, b), w));
+    }
+  }
+}
+#endif
+
+static void
+fft_init (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+    fft_stage = fft_stage_c;
+#ifdef HAVE_FFT_SSE
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("sse"))
+      fft_stage = fft_stage_sse;
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
+static GstFFTF32Pow2Plan *
+plan_new (gint len, gboolean inverse)
+{
+  GstFFTF32Pow2Plan *plan;
+  gdouble sign = inverse ? 1.0 : -1.0;
+  gint i, n = len / 2;
+
+  plan = g_new0 (GstFFTF32Pow2Plan, 1);
+  plan->refcount = 1;
+  plan->len = len;
+  plan->inverse = inverse;
+  plan->n = n;
+  plan->twiddles = g_new (GstFFTF32Complex, n / 2);
+  plan->super_twiddles = g_new (GstFFTF32Complex, n / 2);
+
+  for (i = 0; i < n / 2; i++) {
+    gdouble phase = sign * 2.0 * G_PI * i / n;
+
+    plan->twiddles[i].r = cos (phase);
+    plan->twiddles[i].i = sin (phase);
+
+    phase = sign * G_PI * ((gdouble) (i + 1) / n + 0.5);
+    plan->super_twiddles[i].r = cos (phase);
+    plan->super_twiddles[i].i = sin (phase);
+  }
+
+  return plan;
+}
+
+/* Returns a shared plan for @len, or %NULL if @len is not handled here */
+GstFFTF32Pow2Plan *
+_gst_fft_f32_pow2_plan_get (gint len, gboolean inverse)
+{
+  GstFFTF32Pow2Plan *plan;
+  gpointer key;
+
+  if (len < MIN_LEN || (len & (len - 1)) != 0)
+    return NULL;
+
+  fft_init ();
+
+  key = GINT_TO_POINTER ((len << 1) | (inverse ? 1 : 0));
+
+  g_mutex_lock (&plans_lock);
+  if (!plans)
+    plans = g_hash_table_new (NULL, NULL);
+
+  plan = g_hash_table_lookup (plans, key);
+  if (plan) {
+    plan->refcount++;
+  } else {
+    plan = plan_new (len, inverse);
+    g_hash_table_insert (plans, key, plan);
+  }
+  g_mutex_unlock (&plans_lock);
+
+  return plan;
+}
+
+void
+_gst_fft_f32_pow2_plan_unref (GstFFTF32Pow2Plan * plan)
+{
+  gpointer key = GINT_TO_POINTER ((plan->len << 1) | (plan->inverse ? 1 : 0));
+
+  g_mutex_lock (&plans_lock);
+  if (--plan->refcount > 0) {
+    g_mutex_unlock (&plans_lock);
+    return;
+  }
+  g_hash_table_remove (plans, key);
+  g_mutex_unlock (&plans_lock);
+
+  g_free (plan->twiddles);
+  g_free (plan->super_twiddles);
+  g_free (plan);
+}
+
+/* Number of complex values needed as scratch memory per instance */
+gsize
+_gst_fft_f32_pow2_scratch_size (GstFFTF32Pow2Plan * plan)
+{
+  return 2 * plan->n;
+}
+
+/* Complex FFT of length n from @in to @out, ping-ponging between the two
+ * halves of @scratch. @in and @out must not overlap with @scratch */
+static void
+fft_complex (GstFFTF32Pow2Plan * plan, const GstFFTF32Complex * in,
+    GstFFTF32Complex * out, GstFFTF32Complex * scratch)
+{
+  const GstFFTF32Complex *src = in;
+  GstFFTF32Complex *dst, *buf0 = scratch, *buf1 = scratch + plan->n;
+  gint m, s = 1;
+
+  for (m = plan->n / 2; m >= 1; m /= 2) {
+    if (m == 1)
+      dst = out;
+    else
+      dst = (src == buf0) ? buf1 : buf0;
+
+    fft_stage (src, dst, m, s, plan->twiddles);
+
+    src = dst;
+    s *= 2;
+  }
+}
+
+void
+_gst_fft_f32_pow2_fft (GstFFTF32Pow2Plan * plan, const gfloat * timedata,
+    GstFFTF32Complex * freqdata, GstFFTF32Complex * scratch)
+{
+  GstFFTF32Complex tdc;
+  gint k, n = plan->n;
+
+  /* parallel FFT of the even and odd samples, packed as real and imaginary
+   * part, straight into the output. The split below works in place */
+  fft_complex (plan, (const GstFFTF32Complex *) timedata, freqdata, scratch);
+
+  tdc = freqdata[0];
+  freqdata[0].r = tdc.r + tdc.i;
+  freqdata[n].r = tdc.r - tdc.i;
+  freqdata[0].i = freqdata[n].i = 0.0f;
+
+  for (k = 1; k <= n / 2; k++) {
+    GstFFTF32Complex fpk = freqdata[k], fpnk = freqdata[n - k];
+    const GstFFTF32Complex *stw = &plan->super_twiddles[k - 1];
+    gfloat f1r, f1i, f2r, f2i, twr, twi;
+
+    f1r = fpk.r + fpnk.r;
+    f1i = fpk.i - fpnk.i;
+    f2r = fpk.r - fpnk.r;
+    f2i = fpk.i + fpnk.i;
+
+    twr = f2r * stw->r - f2i * stw->i;
+    twi = f2r * stw->i + f2i * stw->r;
+
+    freqdata[k].r = 0.5f * (f1r + twr);
+    freqdata[k].i = 0.5f * (f1i + twi);
+    freqdata[n - k].r = 0.5f * (f1r - twr);
+    freqdata[n - k].i = 0.5f * (twi - f1i);
+  }
+}
+
+void
+_gst_fft_f32_pow2_inverse_fft (GstFFTF32Pow2Plan * plan,
+    const GstFFTF32Complex * freqdata, gfloat * timedata,
+    GstFFTF32Complex * scratch)
+{
+  GstFFTF32Complex *tmp = scratch;
+  gint k, n = plan->n;
+
+  tmp[0].r = freqdata[0].r + freqdata[n].r;
+  tmp[0].i = freqdata[0].r - freqdata[n].r;
+
+  for (k = 1; k <= n / 2; k++) {
+    GstFFTF32Complex fk = freqdata[k], fnk = freqdata[n - k];
+    const GstFFTF32Complex *stw = &plan->super_twiddles[k - 1];
+    gfloat fer, fei, tr, ti, for_, foi;
+
+    fer = fk.r + fnk.r;
+    fei = fk.i - fnk.i;
+    tr = fk.r - fnk.r;
+    ti = fk.i + fnk.i;
+
+    for_ = tr * stw->r - ti * stw->i;
+    foi = tr * stw->i + ti * stw->r;
+
+    tmp[k].r = fer + for_;
+    tmp[k].i = fei + foi;
+    tmp[n - k].r = fer - for_;
+    tmp[n - k].i = -(fei - foi);
+  }
+
+  fft_complex (plan, tmp, (GstFFTF32Complex *) timedata, scratch);
+}
@@ -0,0 +1,51 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FFT_F32_POW2_H__
+#define __GST_FFT_F32_POW2_H__
+
+#include <glib.h>
+
+#include "gstfftf32.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GstFFTF32Pow2Plan GstFFTF32Pow2Plan;
+
+G_GNUC_INTERNAL
+GstFFTF32Pow2Plan * _gst_fft_f32_pow2_plan_get     (gint len, gboolean inverse);
+G_GNUC_INTERNAL
+void                _gst_fft_f32_pow2_plan_unref   (GstFFTF32Pow2Plan *plan);
+
+G_GNUC_INTERNAL
+gsize               _gst_fft_f32_pow2_scratch_size (GstFFTF32Pow2Plan *plan);
+
+G_GNUC_INTERNAL
+void                _gst_fft_f32_pow2_fft          (GstFFTF32Pow2Plan *plan,
+                                                    const gfloat *timedata,
+                                                    GstFFTF32Complex *freqdata,
+                                                    GstFFTF32Complex *scratch);
+G_GNUC_INTERNAL
+void                _gst_fft_f32_pow2_inverse_fft  (GstFFTF32Pow2Plan *plan,
+                                                    const GstFFTF32Complex *freqdata,
+                                                    gfloat *timedata,
+                                                    GstFFTF32Complex *scratch);
+
+G_END_DECLS
+
+#endif /* __GST_FFT_F32_POW2_H__ */
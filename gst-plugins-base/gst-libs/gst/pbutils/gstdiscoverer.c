@@ -80,6 +80,16 @@ struct _GstDiscovererPrivate
   /* allowed time to discover each uri in nanoseconds */
   GstClockTime timeout;
 
+  /* Number of uris discovered in parallel in async mode, and the extra
+   * discoverers used to do so. Workers have no pending uris of their own but
+   * pop them from the pending uris of their owner. */
+  guint max_concurrent;
+  GPtrArray *workers;
+  GstDiscoverer *owner;
+
+  /* Consider the discovery done once the stream topology is known */
+  gboolean headers_only;
+
   /* list of pending URI to process (current excluded) */
   GList *pending_uris;
 
@@ -158,11 +168,15 @@ enum
 };
 
 #define DEFAULT_PROP_TIMEOUT 15 * GST_SECOND
+#define DEFAULT_PROP_MAX_CONCURRENT 1
+#define DEFAULT_PROP_HEADERS_ONLY FALSE
 
 enum
 {
   PROP_0,
-  PROP_TIMEOUT
+  PROP_TIMEOUT,
+  PROP_MAX_CONCURRENT,
+  PROP_HEADERS_ONLY
 };
 
 static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
@@ -170,6 +184,7 @@ static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
 static void gst_discoverer_set_timeout (GstDiscoverer * dc,
     GstClockTime timeout);
 static gboolean async_timeout_cb (GstDiscoverer * dc);
+static GstDiscovererResult start_discovering (GstDiscoverer * dc);
 
 static void discoverer_bus_cb (GstBus * bus, GstMessage * msg,
     GstDiscoverer * dc);
@@ -215,6 +230,37 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
           GST_SECOND, 3600 * GST_SECOND, DEFAULT_PROP_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDiscoverer:max-concurrent:
+   *
+   * The maximum number of URIs discovered in parallel in asynchronous mode.
+   * Each one of them uses its own pipeline. Changes only take effect the
+   * next time gst_discoverer_start() is called.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_CONCURRENT,
+      g_param_spec_uint ("max-concurrent", "Max concurrent",
+          "Maximum number of URIs discovered in parallel in async mode", 1, 64,
+          DEFAULT_PROP_MAX_CONCURRENT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:headers-only:
+   *
+   * If %TRUE, the discovery of a URI is considered done as soon as the
+   * stream topology is known, without waiting for all the streams to
+   * preroll. This is faster, but the resulting #GstDiscovererInfo might miss
+   * tags or stream information that is only available later.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_HEADERS_ONLY,
+      g_param_spec_boolean ("headers-only", "Headers only",
+          "Stop the discovery as soon as the stream topology is known",
+          DEFAULT_PROP_HEADERS_ONLY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDiscoverer::finished:
@@ -301,6 +347,8 @@ gst_discoverer_init (GstDiscoverer * dc)
       GstDiscovererPrivate);
 
   dc->priv->timeout = DEFAULT_PROP_TIMEOUT;
+  dc->priv->max_concurrent = DEFAULT_PROP_MAX_CONCURRENT;
+  dc->priv->headers_only = DEFAULT_PROP_HEADERS_ONLY;
   dc->priv->async = FALSE;
   dc->priv->async_done = FALSE;
 
@@ -430,6 +478,16 @@ gst_discoverer_set_property (GObject * object, guint prop_id,
     case PROP_TIMEOUT:
       gst_discoverer_set_timeout (dc, g_value_get_uint64 (value));
       break;
+    case PROP_MAX_CONCURRENT:
+      DISCO_LOCK (dc);
+      dc->priv->max_concurrent = g_value_get_uint (value);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_HEADERS_ONLY:
+      DISCO_LOCK (dc);
+      dc->priv->headers_only = g_value_get_boolean (value);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -448,6 +506,16 @@ gst_discoverer_get_property (GObject * object, guint prop_id,
       g_value_set_uint64 (value, dc->priv->timeout);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_MAX_CONCURRENT:
+      DISCO_LOCK (dc);
+      g_value_set_uint (value, dc->priv->max_concurrent);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_HEADERS_ONLY:
+      DISCO_LOCK (dc);
+      g_value_set_boolean (value, dc->priv->headers_only);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -462,6 +530,13 @@ gst_discoverer_set_timeout (GstDiscoverer * dc, GstClockTime timeout)
   /* FIXME : update current pending timeout if we're running */
   DISCO_LOCK (dc);
   dc->priv->timeout = timeout;
+  if (dc->priv->workers) {
+    guint i;
+
+    for (i = 0; i < dc->priv->workers->len; i++)
+      g_object_set (g_ptr_array_index (dc->priv->workers, i), "timeout",
+          timeout, NULL);
+  }
   DISCO_UNLOCK (dc);
 }
 
@@ -1394,6 +1469,14 @@ handle_message (GstDiscoverer * dc, GstMessage * msg)
         if (dc->priv->current_topology)
           gst_structure_free (dc->priv->current_topology);
         dc->priv->current_topology = gst_structure_copy (structure);
+
+        /* All the streams are exposed with their caps, that's all we need */
+        DISCO_LOCK (dc);
+        if (dc->priv->headers_only) {
+          GST_DEBUG ("Got the stream topology in headers-only mode, done");
+          done = TRUE;
+        }
+        DISCO_UNLOCK (dc);
       }
     }
       break;
@@ -1515,6 +1598,93 @@ _setup_locked (GstDiscoverer * dc)
       gst_element_state_change_return_get_name (ret));
 }
 
+/* Called with the lock of @dc held. Workers take the next uri from the
+ * pending uris of their owner.
+ *
+ * Returns TRUE if @dc has a pending uri to process */
+static gboolean
+_pull_pending_uri_locked (GstDiscoverer * dc)
+{
+  GstDiscoverer *owner = dc->priv->owner;
+
+  if (dc->priv->pending_uris != NULL)
+    return TRUE;
+
+  if (owner == NULL)
+    return FALSE;
+
+  DISCO_LOCK (owner);
+  if (owner->priv->running && owner->priv->pending_uris) {
+    GList *first = owner->priv->pending_uris;
+
+    owner->priv->pending_uris = g_list_remove_link (first, first);
+    dc->priv->pending_uris = first;
+  }
+  DISCO_UNLOCK (owner);
+
+  return dc->priv->pending_uris != NULL;
+}
+
+/* Returns TRUE if neither @owner nor any of its workers is processing or
+ * waiting to process a uri */
+static gboolean
+_is_idle (GstDiscoverer * owner)
+{
+  gboolean idle;
+  guint i;
+
+  DISCO_LOCK (owner);
+  idle = owner->priv->current_info == NULL && owner->priv->pending_uris == NULL;
+  DISCO_UNLOCK (owner);
+
+  for (i = 0; idle && owner->priv->workers && i < owner->priv->workers->len;
+      i++) {
+    GstDiscoverer *worker = g_ptr_array_index (owner->priv->workers, i);
+
+    DISCO_LOCK (worker);
+    idle = worker->priv->current_info == NULL;
+    DISCO_UNLOCK (worker);
+  }
+
+  return idle;
+}
+
+/* Hands the pending uris of @dc over to its idle workers */
+static void
+_dispatch_to_workers (GstDiscoverer * dc)
+{
+  guint i;
+
+  for (i = 0; dc->priv->workers && i < dc->priv->workers->len; i++) {
+    GstDiscoverer *worker = g_ptr_array_index (dc->priv->workers, i);
+    gboolean start;
+
+    DISCO_LOCK (worker);
+    start = worker->priv->current_info == NULL &&
+        _pull_pending_uri_locked (worker);
+    DISCO_UNLOCK (worker);
+
+    if (start)
+      start_discovering (worker);
+  }
+}
+
+static void
+worker_discovered_cb (GstDiscoverer * worker, GstDiscovererInfo * info,
+    GError * err, GstDiscoverer * owner)
+{
+  g_signal_emit (owner, gst_discoverer_signals[SIGNAL_DISCOVERED], 0, info,
+      err);
+}
+
+static void
+worker_source_setup_cb (GstDiscoverer * worker, GstElement * source,
+    GstDiscoverer * owner)
+{
+  g_signal_emit (owner, gst_discoverer_signals[SIGNAL_SOURCE_SETUP], 0,
+      source);
+}
+
 static void
 discoverer_cleanup (GstDiscoverer * dc)
 {
@@ -1548,15 +1718,18 @@ discoverer_cleanup (GstDiscoverer * dc)
 
   /* Try popping the next uri */
   if (dc->priv->async) {
-    if (dc->priv->pending_uris != NULL) {
+    if (_pull_pending_uri_locked (dc)) {
       _setup_locked (dc);
       DISCO_UNLOCK (dc);
       /* Start timeout */
       handle_current_async (dc);
     } else {
-      /* We're done ! */
+      GstDiscoverer *owner = dc->priv->owner ? dc->priv->owner : dc;
+
       DISCO_UNLOCK (dc);
-      g_signal_emit (dc, gst_discoverer_signals[SIGNAL_FINISHED], 0);
+      /* We're done once the other pipelines are idle too ! */
+      if (_is_idle (owner))
+        g_signal_emit (owner, gst_discoverer_signals[SIGNAL_FINISHED], 0);
     }
   } else
     DISCO_UNLOCK (dc);
@@ -1987,7 +2160,34 @@ gst_discoverer_start (GstDiscoverer * discoverer)
   g_source_unref (source);
   discoverer->priv->ctx = g_main_context_ref (ctx);
 
+  /* Extra pipelines to discover uris in parallel, they share our main
+   * context since they are started from the same thread */
+  if (discoverer->priv->max_concurrent > 1 && discoverer->priv->owner == NULL) {
+    guint i;
+
+    discoverer->priv->workers = g_ptr_array_new_with_free_func (g_object_unref);
+    for (i = 1; i < discoverer->priv->max_concurrent; i++) {
+      GstDiscoverer *worker = g_object_new (GST_TYPE_DISCOVERER, "timeout",
+          discoverer->priv->timeout, "headers-only",
+          discoverer->priv->headers_only, NULL);
+
+      if (worker->priv->uridecodebin == NULL) {
+        g_object_unref (worker);
+        break;
+      }
+
+      worker->priv->owner = discoverer;
+      g_signal_connect (worker, "discovered",
+          G_CALLBACK (worker_discovered_cb), discoverer);
+      g_signal_connect (worker, "source-setup",
+          G_CALLBACK (worker_source_setup_cb), discoverer);
+      gst_discoverer_start (worker);
+      g_ptr_array_add (discoverer->priv->workers, worker);
+    }
+  }
+
   start_discovering (discoverer);
+  _dispatch_to_workers (discoverer);
   GST_DEBUG_OBJECT (discoverer, "Started");
 }
 
@@ -2025,6 +2225,19 @@ gst_discoverer_stop (GstDiscoverer * discoverer)
   discoverer->priv->running = FALSE;
   DISCO_UNLOCK (discoverer);
 
+  if (discoverer->priv->workers) {
+    guint i;
+
+    for (i = 0; i < discoverer->priv->workers->len; i++) {
+      GstDiscoverer *worker = g_ptr_array_index (discoverer->priv->workers, i);
+
+      g_signal_handlers_disconnect_by_data (worker, discoverer);
+      gst_discoverer_stop (worker);
+    }
+    g_ptr_array_unref (discoverer->priv->workers);
+    discoverer->priv->workers = NULL;
+  }
+
   /* Remove timeout handler */
   if (discoverer->priv->timeoutid) {
     g_source_remove (discoverer->priv->timeoutid);
@@ -2081,6 +2294,9 @@ gst_discoverer_discover_uri_async (GstDiscoverer * discoverer,
   if (can_run)
     start_discovering (discoverer);
 
+  if (discoverer->priv->async)
+    _dispatch_to_workers (discoverer);
+
   return TRUE;
 }
 
@@ -1210,6 +1210,122 @@ error:
   }
 }
 
+/* returns the socket that @conn writes to if there is no other layer, like
+ * TLS, between the output stream and the socket */
+static GSocket *
+get_plain_write_socket (GstRTSPConnection * conn)
+{
+  GIOStream *stream = NULL;
+
+  if (conn->stream1 &&
+      g_io_stream_get_output_stream (conn->stream1) == conn->output_stream)
+    stream = conn->stream1;
+  else if (conn->stream0 &&
+      g_io_stream_get_output_stream (conn->stream0) == conn->output_stream)
+    stream = conn->stream0;
+
+  if (stream == NULL || !G_IS_SOCKET_CONNECTION (stream))
+    return NULL;
+
+  return g_socket_connection_get_socket (G_SOCKET_CONNECTION (stream));
+}
+
+/* Write the 4 bytes interleaved data @header followed by @buffer without
+ * blocking, skipping the first *idx bytes that were already written. On
+ * plain sockets everything goes out with one vectored write, otherwise the
+ * memories of @buffer are written one after the other. Returns
+ * #GST_RTSP_EINTR when the socket is full. */
+static GstRTSPResult
+write_buffer (GstRTSPConnection * conn, const guint8 * header,
+    GstBuffer * buffer, guint * idx)
+{
+  GstRTSPResult res = GST_RTSP_OK;
+  guint i, n_mem, offset;
+#ifdef MSG_DONTWAIT
+  GSocket *socket;
+
+  socket = get_plain_write_socket (conn);
+  if (socket && gst_buffer_n_memory (buffer) <= 16) {
+    GOutputVector vec[17];
+    GstMapInfo maps[16];
+    GError *err = NULL;
+    guint n_vec;
+    gssize r;
+
+    n_mem = gst_buffer_n_memory (buffer);
+    for (i = 0; i < n_mem; i++)
+      gst_memory_map (gst_buffer_peek_memory (buffer, i), &maps[i],
+          GST_MAP_READ);
+
+    while (res == GST_RTSP_OK && *idx < 4 + gst_buffer_get_size (buffer)) {
+      /* don't let a blocking socket wait for space */
+      if (!(g_socket_condition_check (socket, G_IO_OUT) & G_IO_OUT)) {
+        res = GST_RTSP_EINTR;
+        break;
+      }
+
+      n_vec = 0;
+      if (*idx < 4) {
+        vec[n_vec].buffer = header + *idx;
+        vec[n_vec++].size = 4 - *idx;
+      }
+      for (i = 0, offset = 4; i < n_mem; offset += maps[i].size, i++) {
+        if (*idx >= offset + maps[i].size)
+          continue;
+        vec[n_vec].buffer = maps[i].data + MAX (*idx, offset) - offset;
+        vec[n_vec++].size = offset + maps[i].size - MAX (*idx, offset);
+      }
+
+      r = g_socket_send_message (socket, NULL, vec, n_vec, NULL, 0,
+          MSG_DONTWAIT, conn->cancellable, &err);
+      if (r > 0) {
+        *idx += r;
+      } else if (r == 0) {
+        res = GST_RTSP_EEOF;
+      } else {
+        GST_DEBUG ("%s", err->message);
+        if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK) ||
+            g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+          res = GST_RTSP_EINTR;
+        else
+          res = GST_RTSP_ESYS;
+        g_clear_error (&err);
+      }
+    }
+
+    for (i = 0; i < n_mem; i++)
+      gst_memory_unmap (maps[i].memory, &maps[i]);
+
+    return res;
+  }
+#endif
+
+  if (*idx < 4) {
+    res = write_bytes (conn->output_stream, header, idx, 4, FALSE,
+        conn->cancellable);
+    if (res != GST_RTSP_OK)
+      return res;
+  }
+
+  n_mem = gst_buffer_n_memory (buffer);
+  for (i = 0, offset = 4; i < n_mem && res == GST_RTSP_OK; i++) {
+    GstMapInfo map;
+    guint off;
+
+    gst_memory_map (gst_buffer_peek_memory (buffer, i), &map, GST_MAP_READ);
+    if (*idx < offset + map.size) {
+      off = *idx - offset;
+      res = write_bytes (conn->output_stream, map.data, &off, map.size, FALSE,
+          conn->cancellable);
+      *idx = offset + off;
+    }
+    offset += map.size;
+    gst_memory_unmap (map.memory, &map);
+  }
+
+  return res;
+}
+
 static gint
 fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
     gboolean block, GError ** err)
@@ -3135,6 +3251,12 @@ typedef struct
   guint8 *data;
   guint size;
   guint id;
+
+  /* interleaved data queued by reference, @size includes the header and
+   * @off is the amount of bytes that was already written */
+  GstBuffer *buffer;
+  guint8 header[4];
+  guint off;
 } GstRTSPRec;
 
 /* async functions */
@@ -3159,6 +3281,8 @@ struct _GstRTSPWatch
   GQueue *messages;
   gsize messages_bytes;
   guint8 *write_data;
+  GstBuffer *write_buffer;
+  guint8 write_header[4];
   guint write_off;
   guint write_size;
   guint write_id;
@@ -3425,7 +3549,7 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
 
   g_mutex_lock (&watch->mutex);
   do {
-    if (watch->write_data == NULL) {
+    if (watch->write_data == NULL && watch->write_buffer == NULL) {
       GstRTSPRec *rec;
 
       /* get a new message from the queue */
@@ -3457,18 +3581,24 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
         break;
       }
 
-      watch->messages_bytes -= rec->size;
+      watch->messages_bytes -= rec->size - rec->off;
 
-      watch->write_off = 0;
+      watch->write_off = rec->off;
       watch->write_data = rec->data;
+      watch->write_buffer = rec->buffer;
+      memcpy (watch->write_header, rec->header, 4);
       watch->write_size = rec->size;
       watch->write_id = rec->id;
 
       g_slice_free (GstRTSPRec, rec);
     }
 
-    res = write_bytes (conn->output_stream, watch->write_data,
-        &watch->write_off, watch->write_size, FALSE, conn->cancellable);
+    if (watch->write_buffer)
+      res = write_buffer (conn, watch->write_header, watch->write_buffer,
+          &watch->write_off);
+    else
+      res = write_bytes (conn->output_stream, watch->write_data,
+          &watch->write_off, watch->write_size, FALSE, conn->cancellable);
 
     if (!IS_BACKLOG_FULL (watch))
       g_cond_signal (&watch->queue_not_full);
@@ -3486,6 +3616,7 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
 
     g_free (watch->write_data);
     watch->write_data = NULL;
+    gst_buffer_replace (&watch->write_buffer, NULL);
   } while (TRUE);
   g_mutex_unlock (&watch->mutex);
 
@@ -3515,6 +3646,8 @@ gst_rtsp_rec_free (gpointer data)
   GstRTSPRec *rec = data;
 
   g_free (rec->data);
+  if (rec->buffer)
+    gst_buffer_unref (rec->buffer);
   g_slice_free (GstRTSPRec, rec);
 }
 
@@ -3535,6 +3668,7 @@ gst_rtsp_source_finalize (GSource * source)
   watch->messages_bytes = 0;
 
   g_free (watch->write_data);
+  gst_buffer_replace (&watch->write_buffer, NULL);
   g_cond_clear (&watch->queue_not_full);
 
   if (watch->readsrc)
@@ -3750,55 +3884,36 @@ gst_rtsp_watch_get_send_backlog (GstRTSPWatch * watch,
   g_mutex_unlock (&watch->mutex);
 }
 
-/**
- * gst_rtsp_watch_write_data:
- * @watch: a #GstRTSPWatch
- * @data: (array length=size) (transfer full): the data to queue
- * @size: the size of @data
- * @id: (out) (allow-none): location for a message ID or %NULL
- *
- * Write @data using the connection of the @watch. If it cannot be sent
- * immediately, it will be queued for transmission in @watch. The contents of
- * @message will then be serialized and transmitted when the connection of the
- * @watch becomes writable. In case the @message is queued, the ID returned in
- * @id will be non-zero and used as the ID argument in the message_sent
- * callback.
- *
- * This function will take ownership of @data and g_free() it after use.
- *
- * If the amount of queued data exceeds the limits set with
- * gst_rtsp_watch_set_send_backlog(), this function will return
- * #GST_RTSP_ENOMEM.
- *
- * Returns: #GST_RTSP_OK on success. #GST_RTSP_ENOMEM when the backlog limits
- * are reached. #GST_RTSP_EINTR when @watch was flushing.
- */
-GstRTSPResult
-gst_rtsp_watch_write_data (GstRTSPWatch * watch, const guint8 * data,
-    guint size, guint * id)
+/* queues @data or, when @buffer is not %NULL, the interleaved data @header
+ * followed by @buffer. Takes ownership of @data and @buffer */
+static GstRTSPResult
+gst_rtsp_watch_write_internal (GstRTSPWatch * watch, const guint8 * data,
+    guint size, GstBuffer * buffer, const guint8 * header, guint * id)
 {
   GstRTSPResult res;
   GstRTSPRec *rec;
   guint off = 0;
   GMainContext *context = NULL;
 
-  g_return_val_if_fail (watch != NULL, GST_RTSP_EINVAL);
-  g_return_val_if_fail (data != NULL, GST_RTSP_EINVAL);
-  g_return_val_if_fail (size != 0, GST_RTSP_EINVAL);
-
   g_mutex_lock (&watch->mutex);
   if (watch->flushing)
     goto flushing;
 
   /* try to send the message synchronously first */
-  if (watch->messages->length == 0 && watch->write_data == NULL) {
-    res =
-        write_bytes (watch->conn->output_stream, data, &off, size,
-        FALSE, watch->conn->cancellable);
+  if (watch->messages->length == 0 && watch->write_data == NULL &&
+      watch->write_buffer == NULL) {
+    if (buffer)
+      res = write_buffer (watch->conn, header, buffer, &off);
+    else
+      res =
+          write_bytes (watch->conn->output_stream, data, &off, size,
+          FALSE, watch->conn->cancellable);
     if (res != GST_RTSP_EINTR) {
       if (id != NULL)
         *id = 0;
       g_free ((gpointer) data);
+      if (buffer)
+        gst_buffer_unref (buffer);
       goto done;
     }
   }
@@ -3808,8 +3923,15 @@ gst_rtsp_watch_write_data (GstRTSPWatch * watch, const guint8 * data,
     goto too_much_backlog;
 
   /* make a record with the data and id for sending async */
-  rec = g_slice_new (GstRTSPRec);
-  if (off == 0) {
+  rec = g_slice_new0 (GstRTSPRec);
+  if (buffer) {
+    /* keep a reference, the part that was already written is skipped when
+     * the record is sent */
+    rec->buffer = buffer;
+    memcpy (rec->header, header, 4);
+    rec->size = size;
+    rec->off = off;
+  } else if (off == 0) {
     rec->data = (guint8 *) data;
     rec->size = size;
   } else {
@@ -3825,7 +3947,7 @@ gst_rtsp_watch_write_data (GstRTSPWatch * watch, const guint8 * data,
 
   /* add the record to a queue. */
   g_queue_push_head (watch->messages, rec);
-  watch->messages_bytes += rec->size;
+  watch->messages_bytes += rec->size - rec->off;
 
   /* make sure the main context will now also check for writability on the
    * socket */
@@ -3865,6 +3987,8 @@ flushing:
     GST_DEBUG ("we are flushing");
     g_mutex_unlock (&watch->mutex);
     g_free ((gpointer) data);
+    if (buffer)
+      gst_buffer_unref (buffer);
     return GST_RTSP_EINTR;
   }
 too_much_backlog:
@@ -3874,10 +3998,92 @@ too_much_backlog:
         watch->messages_bytes, watch->max_messages, watch->messages->length);
     g_mutex_unlock (&watch->mutex);
     g_free ((gpointer) data);
+    if (buffer)
+      gst_buffer_unref (buffer);
     return GST_RTSP_ENOMEM;
   }
 }
 
+/**
+ * gst_rtsp_watch_write_data:
+ * @watch: a #GstRTSPWatch
+ * @data: (array length=size) (transfer full): the data to queue
+ * @size: the size of @data
+ * @id: (out) (allow-none): location for a message ID or %NULL
+ *
+ * Write @data using the connection of the @watch. If it cannot be sent
+ * immediately, it will be queued for transmission in @watch. The contents of
+ * @message will then be serialized and transmitted when the connection of the
+ * @watch becomes writable. In case the @message is queued, the ID returned in
+ * @id will be non-zero and used as the ID argument in the message_sent
+ * callback.
+ *
+ * This function will take ownership of @data and g_free() it after use.
+ *
+ * If the amount of queued data exceeds the limits set with
+ * gst_rtsp_watch_set_send_backlog(), this function will return
+ * #GST_RTSP_ENOMEM.
+ *
+ * Returns: #GST_RTSP_OK on success. #GST_RTSP_ENOMEM when the backlog limits
+ * are reached. #GST_RTSP_EINTR when @watch was flushing.
+ */
+GstRTSPResult
+gst_rtsp_watch_write_data (GstRTSPWatch * watch, const guint8 * data,
+    guint size, guint * id)
+{
+  g_return_val_if_fail (watch != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (data != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (size != 0, GST_RTSP_EINVAL);
+
+  return gst_rtsp_watch_write_internal (watch, data, size, NULL, NULL, id);
+}
+
+/**
+ * gst_rtsp_watch_write_buffer:
+ * @watch: a #GstRTSPWatch
+ * @channel: the interleaved channel
+ * @buffer: (transfer none): the data to send
+ * @id: (out) (allow-none): location for a message ID or %NULL
+ *
+ * Send @buffer as interleaved data on @channel using the connection of the
+ * @watch, like a #GST_RTSP_MESSAGE_DATA message passed to
+ * gst_rtsp_watch_send_message() but without copying the data. When it can't
+ * be sent immediately, @watch keeps a reference to @buffer until it is
+ * written. On plain sockets, the framing header and the memories of @buffer
+ * are written with a single vectored write.
+ *
+ * If the amount of queued data exceeds the limits set with
+ * gst_rtsp_watch_set_send_backlog(), this function will return
+ * #GST_RTSP_ENOMEM.
+ *
+ * Returns: #GST_RTSP_OK on success. #GST_RTSP_ENOMEM when the backlog limits
+ * are reached. #GST_RTSP_EINTR when @watch was flushing. #GST_RTSP_EINVAL when
+ * @buffer is too big for interleaved data.
+ *
+ * Since: 1.10
+ */
+GstRTSPResult
+gst_rtsp_watch_write_buffer (GstRTSPWatch * watch, guint8 channel,
+    GstBuffer * buffer, guint * id)
+{
+  guint8 header[4];
+  gsize size;
+
+  g_return_val_if_fail (watch != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_RTSP_EINVAL);
+
+  size = gst_buffer_get_size (buffer);
+  if (size == 0 || size > G_MAXUINT16)
+    return GST_RTSP_EINVAL;
+
+  header[0] = '$';
+  header[1] = channel;
+  GST_WRITE_UINT16_BE (header + 2, size);
+
+  return gst_rtsp_watch_write_internal (watch, NULL, 4 + size,
+      gst_buffer_ref (buffer), header, id);
+}
+
 /**
  * gst_rtsp_watch_send_message:
  * @watch: a #GstRTSPWatch
@@ -215,6 +215,10 @@ void               gst_rtsp_watch_get_send_backlog  (GstRTSPWatch *watch,
 GstRTSPResult      gst_rtsp_watch_write_data         (GstRTSPWatch *watch,
                                                       const guint8 *data,
                                                       guint size, guint *id);
+GstRTSPResult      gst_rtsp_watch_write_buffer       (GstRTSPWatch *watch,
+                                                      guint8 channel,
+                                                      GstBuffer *buffer,
+                                                      guint *id);
 GstRTSPResult      gst_rtsp_watch_send_message       (GstRTSPWatch *watch,
                                                       GstRTSPMessage *message,
                                                       guint *id);
@@ -142,6 +142,13 @@
  * keyframes, unless it knows the upstream elements will do so properly for
  * incoming data.
  *
+ * Subclasses for formats where every frame can be decoded on its own, such
+ * as intra-only codecs, can additionally implement @decode_parallel and
+ * enable it with @gst_video_decoder_set_decode_threads. Once an output state
+ * is set, the base class then allocates an output buffer for each frame,
+ * decodes several frames at once on worker threads and pushes them
+ * downstream in their original order.
+ *
  * The bare minimum that a functional subclass needs to implement is:
  * <itemizedlist>
  *   <listitem><para>Provide pad templates</para></listitem>
@@ -398,7 +405,8 @@ struct _GstVideoDecoderPrivate
   guint32 system_frame_number;
   guint32 decode_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  GHashTable *frames_index;     /* system_frame_number -> link in frames */
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;     /* OBJECT_LOCK and STREAM_LOCK */
   gboolean output_state_changed;
@@ -430,8 +438,22 @@ struct _GstVideoDecoderPrivate
 
   /* flags */
   gboolean use_default_pad_acceptcaps;
+
+  /* parallel decoding, frames in decode order */
+  guint decode_threads;
+  GThreadPool *decode_pool;
+  GMutex decode_lock;
+  GCond decode_cond;
+  GQueue decode_jobs;
 };
 
+typedef struct
+{
+  GstVideoCodecFrame *frame;
+  GstFlowReturn ret;
+  gboolean done;
+} GstVideoDecoderJob;
+
 static GstElementClass *parent_class = NULL;
 static void gst_video_decoder_class_init (GstVideoDecoderClass * klass);
 static void gst_video_decoder_init (GstVideoDecoder * dec,
@@ -471,6 +493,8 @@ static GstFlowReturn gst_video_decoder_flush_parse (GstVideoDecoder * dec,
     gboolean at_eos);
 
 static void gst_video_decoder_clear_queues (GstVideoDecoder * dec);
+static GstFlowReturn gst_video_decoder_finish_parallel (GstVideoDecoder *
+    decoder, guint max_pending, gboolean discard);
 
 static gboolean gst_video_decoder_sink_event_default (GstVideoDecoder * decoder,
     GstEvent * event);
@@ -493,6 +517,57 @@ static gboolean gst_video_decoder_src_query_default (GstVideoDecoder * decoder,
 static gboolean gst_video_decoder_transform_meta_default (GstVideoDecoder *
     decoder, GstVideoCodecFrame * frame, GstMeta * meta);
 
+/* pending frames are kept in order in priv->frames and indexed by their
+ * system_frame_number in priv->frames_index, which maps to the queue link */
+static void
+gst_video_decoder_push_frame (GstVideoDecoderPrivate * priv,
+    GstVideoCodecFrame * frame)
+{
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_index,
+      GINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
+}
+
+static gboolean
+gst_video_decoder_remove_frame (GstVideoDecoderPrivate * priv,
+    GstVideoCodecFrame * frame)
+{
+  gpointer key = GINT_TO_POINTER (frame->system_frame_number);
+  GList *link;
+
+  link = g_hash_table_lookup (priv->frames_index, key);
+  if (link && link->data == frame) {
+    g_hash_table_remove (priv->frames_index, key);
+  } else {
+    /* only when frame numbers wrapped around */
+    link = g_queue_find (&priv->frames, frame);
+    if (link == NULL)
+      return FALSE;
+  }
+  g_queue_delete_link (&priv->frames, link);
+
+  return TRUE;
+}
+
+static GstVideoCodecFrame *
+gst_video_decoder_lookup_frame (GstVideoDecoderPrivate * priv, int frame_number)
+{
+  GList *link;
+
+  link = g_hash_table_lookup (priv->frames_index,
+      GINT_TO_POINTER (frame_number));
+
+  return link ? link->data : NULL;
+}
+
+static void
+gst_video_decoder_clear_frames (GstVideoDecoderPrivate * priv)
+{
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
+  g_hash_table_remove_all (priv->frames_index);
+}
+
 /* we can't use G_DEFINE_ABSTRACT_TYPE because we need the klass in the _init
  * method to get to the padtemplates */
 GType
@@ -591,6 +666,14 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
 
   g_rec_mutex_init (&decoder->stream_lock);
 
+  g_queue_init (&decoder->priv->frames);
+  decoder->priv->frames_index = g_hash_table_new (NULL, NULL);
+
+  decoder->priv->decode_threads = 1;
+  g_mutex_init (&decoder->priv->decode_lock);
+  g_cond_init (&decoder->priv->decode_cond);
+  g_queue_init (&decoder->priv->decode_jobs);
+
   decoder->priv->input_adapter = gst_adapter_new ();
   decoder->priv->output_adapter = gst_adapter_new ();
   decoder->priv->packetized = TRUE;
@@ -821,6 +904,9 @@ gst_video_decoder_setcaps (GstVideoDecoder * decoder, GstCaps * caps)
   if (G_UNLIKELY (state == NULL))
     goto parse_fail;
 
+  /* frames still decoded in parallel belong to the previous caps */
+  gst_video_decoder_finish_parallel (decoder, 0, FALSE);
+
   if (decoder_class->set_format)
     ret = decoder_class->set_format (decoder, state);
 
@@ -870,6 +956,14 @@ gst_video_decoder_finalize (GObject * object)
 
   g_rec_mutex_clear (&decoder->stream_lock);
 
+  if (decoder->priv->decode_pool)
+    g_thread_pool_free (decoder->priv->decode_pool, FALSE, TRUE);
+  g_mutex_clear (&decoder->priv->decode_lock);
+  g_cond_clear (&decoder->priv->decode_cond);
+
+  gst_video_decoder_clear_frames (decoder->priv);
+  g_hash_table_unref (decoder->priv->frames_index);
+
   if (decoder->priv->input_adapter) {
     g_object_unref (decoder->priv->input_adapter);
     decoder->priv->input_adapter = NULL;
@@ -906,6 +1000,10 @@ gst_video_decoder_flush (GstVideoDecoder * dec, gboolean hard)
 
   GST_LOG_OBJECT (dec, "flush hard %d", hard);
 
+  /* frames decoded in parallel are pushed out on a discont like any
+   * other decoded frame, but discarded when flushing */
+  ret = gst_video_decoder_finish_parallel (dec, 0, hard);
+
   /* Inform subclass */
   if (klass->reset) {
     GST_FIXME_OBJECT (dec, "GstVideoDecoder::reset() is deprecated");
@@ -1040,6 +1138,11 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
 
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
 
+  /* wait for all frames that are still decoded in parallel */
+  ret = gst_video_decoder_finish_parallel (dec, 0, FALSE);
+  if (ret != GST_FLOW_OK)
+    goto done;
+
   if (dec->input_segment.rate > 0.0) {
     /* Forward mode, if unpacketized, give the child class
      * a final chance to flush out packets */
@@ -1062,6 +1165,7 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
     ret = gst_video_decoder_flush_parse (dec, TRUE);
   }
 
+done:
   GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
 
   return ret;
@@ -1399,7 +1503,7 @@ gst_video_decoder_sink_event_default (GstVideoDecoder * decoder,
       GList *l;
 
       GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-      for (l = priv->frames; l; l = l->next) {
+      for (l = priv->frames.head; l; l = l->next) {
         GstVideoCodecFrame *frame = l->data;
 
         frame->events = _flush_events (decoder->srcpad, frame->events);
@@ -2062,8 +2166,7 @@ gst_video_decoder_clear_queues (GstVideoDecoder * dec)
   g_list_free_full (priv->parse_gather,
       (GDestroyNotify) gst_video_codec_frame_unref);
   priv->parse_gather = NULL;
-  g_list_free_full (priv->frames, (GDestroyNotify) gst_video_codec_frame_unref);
-  priv->frames = NULL;
+  gst_video_decoder_clear_frames (priv);
 }
 
 static void
@@ -2077,6 +2180,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
 
   if (full || flush_hard) {
+    gst_video_decoder_finish_parallel (decoder, 0, TRUE);
     gst_segment_init (&decoder->input_segment, GST_FORMAT_UNDEFINED);
     gst_segment_init (&decoder->output_segment, GST_FORMAT_UNDEFINED);
     gst_video_decoder_clear_queues (decoder);
@@ -2658,7 +2762,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
 
 #ifndef GST_DISABLE_GST_DEBUG
   GST_LOG_OBJECT (decoder, "n %d in %" G_GSIZE_FORMAT " out %" G_GSIZE_FORMAT,
-      g_list_length (priv->frames),
+      priv->frames.length,
       gst_adapter_available (priv->input_adapter),
       gst_adapter_available (priv->output_adapter));
 #endif
@@ -2672,7 +2776,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
       sync, GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (frame->dts));
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2732,7 +2836,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2766,7 +2870,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     /* some more maintenance, ts2 holds PTS */
     min_ts = GST_CLOCK_TIME_NONE;
     seen_none = FALSE;
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts2)) {
@@ -2858,15 +2962,10 @@ void
 gst_video_decoder_release_frame (GstVideoDecoder * dec,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
-
   /* unref once from the list */
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
-  link = g_list_find (dec->priv->frames, frame);
-  if (link) {
+  if (gst_video_decoder_remove_frame (dec->priv, frame))
     gst_video_codec_frame_unref (frame);
-    dec->priv->frames = g_list_delete_link (dec->priv->frames, link);
-  }
   if (frame->events) {
     dec->priv->pending_events =
         g_list_concat (dec->priv->pending_events, frame->events);
@@ -3356,6 +3455,122 @@ gst_video_decoder_have_frame (GstVideoDecoder * decoder)
   return ret;
 }
 
+static void
+gst_video_decoder_decode_job (GstVideoDecoderJob * job,
+    GstVideoDecoder * decoder)
+{
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+
+  ret = decoder_class->decode_parallel (decoder, job->frame);
+
+  g_mutex_lock (&priv->decode_lock);
+  job->ret = ret;
+  job->done = TRUE;
+  g_cond_broadcast (&priv->decode_cond);
+  g_mutex_unlock (&priv->decode_lock);
+}
+
+/* Finish the frames decoded in parallel in decode order, waiting until at
+ * most @max_pending frames are still in progress. With @discard, the frames
+ * are released without being pushed. Must be called with the STREAM_LOCK */
+static GstFlowReturn
+gst_video_decoder_finish_parallel (GstVideoDecoder * decoder,
+    guint max_pending, gboolean discard)
+{
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&priv->decode_lock);
+  while (priv->decode_jobs.length > 0) {
+    GstVideoDecoderJob *job = g_queue_peek_head (&priv->decode_jobs);
+    GstVideoCodecFrame *frame = job->frame;
+    GstFlowReturn res;
+
+    if (!job->done) {
+      if (priv->decode_jobs.length <= max_pending)
+        break;
+      g_cond_wait (&priv->decode_cond, &priv->decode_lock);
+      continue;
+    }
+    g_queue_pop_head (&priv->decode_jobs);
+    g_mutex_unlock (&priv->decode_lock);
+
+    res = job->ret;
+    if (discard) {
+      gst_video_decoder_release_frame (decoder, frame);
+    } else if (res == GST_FLOW_OK) {
+      res = gst_video_decoder_finish_frame (decoder, frame);
+    } else if (res == GST_VIDEO_DECODER_FLOW_DECODE_SERIAL) {
+      GST_LOG_OBJECT (decoder, "decoding frame %d serially",
+          frame->system_frame_number);
+      gst_buffer_replace (&frame->output_buffer, NULL);
+      res = decoder_class->handle_frame (decoder, frame);
+    } else {
+      GST_DEBUG_OBJECT (decoder, "parallel decoding of frame %d failed: %s",
+          frame->system_frame_number, gst_flow_get_name (res));
+      gst_video_decoder_release_frame (decoder, frame);
+    }
+    g_slice_free (GstVideoDecoderJob, job);
+
+    if (ret == GST_FLOW_OK)
+      ret = res;
+
+    g_mutex_lock (&priv->decode_lock);
+  }
+  g_mutex_unlock (&priv->decode_lock);
+
+  return ret;
+}
+
+/* Hand @frame to a decoding thread and push out the frames before it that
+ * were completed meanwhile. Must be called with the STREAM_LOCK */
+static GstFlowReturn
+gst_video_decoder_decode_parallel (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstVideoDecoderJob *job;
+  GstFlowReturn ret;
+
+  ret = gst_video_decoder_allocate_output_frame (decoder, frame);
+  if (ret != GST_FLOW_OK) {
+    gst_video_decoder_release_frame (decoder, frame);
+    goto done;
+  }
+
+  if (priv->decode_pool == NULL) {
+    priv->decode_pool =
+        g_thread_pool_new ((GFunc) gst_video_decoder_decode_job, decoder,
+        priv->decode_threads, FALSE, NULL);
+  } else if (g_thread_pool_get_max_threads (priv->decode_pool) !=
+      (gint) priv->decode_threads) {
+    g_thread_pool_set_max_threads (priv->decode_pool, priv->decode_threads,
+        NULL);
+  }
+
+  job = g_slice_new0 (GstVideoDecoderJob);
+  job->frame = frame;
+
+  g_mutex_lock (&priv->decode_lock);
+  g_queue_push_tail (&priv->decode_jobs, job);
+  g_mutex_unlock (&priv->decode_lock);
+
+  g_thread_pool_push (priv->decode_pool, job, NULL);
+
+  /* keep decode_threads frames in progress */
+  ret = gst_video_decoder_finish_parallel (decoder, priv->decode_threads,
+      FALSE);
+
+done:
+  if (ret != GST_FLOW_OK)
+    GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
+
+  return ret;
+}
+
 /* Pass the frame in priv->current_frame through the
  * handle_frame() callback for decoding and passing to gvd_finish_frame(), 
  * or dropping by passing to gvd_drop_frame() */
@@ -3402,17 +3617,28 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
   GST_LOG_OBJECT (decoder, "dist %d", frame->distance_from_sync);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  gst_video_decoder_push_frame (priv, frame);
 
-  if (g_list_length (priv->frames) > 10) {
+  if (priv->frames.length > 10) {
     GST_DEBUG_OBJECT (decoder, "decoder frame list getting long: %d frames,"
-        "possible internal leaking?", g_list_length (priv->frames));
+        "possible internal leaking?", priv->frames.length);
   }
 
   frame->deadline =
       gst_segment_to_running_time (&decoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
+  if (decoder_class->decode_parallel && priv->decode_threads > 1
+      && priv->output_state && !GST_VIDEO_CODEC_FRAME_IS_DECODE_ONLY (frame))
+    return gst_video_decoder_decode_parallel (decoder, frame);
+
+  /* frames before this one might still be decoding in parallel */
+  ret = gst_video_decoder_finish_parallel (decoder, 0, FALSE);
+  if (ret != GST_FLOW_OK) {
+    gst_video_decoder_release_frame (decoder, frame);
+    return ret;
+  }
+
   /* do something with frame */
   ret = decoder_class->handle_frame (decoder, frame);
   if (ret != GST_FLOW_OK)
@@ -3522,8 +3748,8 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  if (decoder->priv->frames)
-    frame = gst_video_codec_frame_ref (decoder->priv->frames->data);
+  if (decoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (decoder->priv->frames.head->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -3541,20 +3767,14 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
 GstVideoCodecFrame *
 gst_video_decoder_get_frame (GstVideoDecoder * decoder, int frame_number)
 {
-  GList *g;
-  GstVideoCodecFrame *frame = NULL;
+  GstVideoCodecFrame *frame;
 
   GST_DEBUG_OBJECT (decoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  for (g = decoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  frame = gst_video_decoder_lookup_frame (decoder->priv, frame_number);
+  if (frame)
+    gst_video_codec_frame_ref (frame);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return frame;
@@ -3574,7 +3794,7 @@ gst_video_decoder_get_frames (GstVideoDecoder * decoder)
   GList *frames;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  frames = g_list_copy (decoder->priv->frames);
+  frames = g_list_copy (decoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
@@ -3804,7 +4024,7 @@ gst_video_decoder_negotiate_default (GstVideoDecoder * decoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = decoder->priv->frames ? decoder->priv->frames->data : NULL;
+  frame = g_queue_peek_head (&decoder->priv->frames);
   if (frame || decoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -4141,6 +4361,55 @@ gst_video_decoder_get_max_errors (GstVideoDecoder * dec)
   return dec->priv->max_errors;
 }
 
+/**
+ * gst_video_decoder_set_decode_threads:
+ * @dec: a #GstVideoDecoder
+ * @n_threads: number of threads, or 0 to use one thread per processor
+ *
+ * Sets the number of frames that are decoded in parallel by subclasses
+ * implementing #GstVideoDecoderClass.decode_parallel(). With more than one
+ * thread, frames are decoded by a pool of worker threads once an output
+ * state is set and are then pushed downstream in decode order. The default
+ * is 1, where all frames are passed to #GstVideoDecoderClass.handle_frame()
+ * from the streaming thread.
+ *
+ * This is only useful for formats where all frames can be decoded
+ * independently of each other, such as intra-only codecs.
+ *
+ * MT safe.
+ *
+ * Since: 1.10
+ */
+void
+gst_video_decoder_set_decode_threads (GstVideoDecoder * dec, guint n_threads)
+{
+  g_return_if_fail (GST_IS_VIDEO_DECODER (dec));
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  GST_VIDEO_DECODER_STREAM_LOCK (dec);
+  dec->priv->decode_threads = n_threads;
+  GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+}
+
+/**
+ * gst_video_decoder_get_decode_threads:
+ * @dec: a #GstVideoDecoder
+ *
+ * Returns: the number of frames decoded in parallel, see
+ * gst_video_decoder_set_decode_threads().
+ *
+ * Since: 1.10
+ */
+guint
+gst_video_decoder_get_decode_threads (GstVideoDecoder * dec)
+{
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (dec), 1);
+
+  return dec->priv->decode_threads;
+}
+
 /**
  * gst_video_decoder_set_needs_format:
  * @dec: a #GstVideoDecoder
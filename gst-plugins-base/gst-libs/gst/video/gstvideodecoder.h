@@ -79,6 +79,17 @@ G_BEGIN_DECLS
  **/
 #define GST_VIDEO_DECODER_FLOW_NEED_DATA GST_FLOW_CUSTOM_SUCCESS
 
+/**
+ * GST_VIDEO_DECODER_FLOW_DECODE_SERIAL:
+ *
+ * Returned from #GstVideoDecoderClass.decode_parallel() to indicate that
+ * the frame could not be decoded in parallel and should be passed to
+ * #GstVideoDecoderClass.handle_frame() from the streaming thread instead.
+ *
+ * Since: 1.10
+ **/
+#define GST_VIDEO_DECODER_FLOW_DECODE_SERIAL GST_FLOW_CUSTOM_SUCCESS_1
+
 /**
  * GST_VIDEO_DECODER_INPUT_SEGMENT:
  * @obj: base decoder instance
@@ -270,6 +281,17 @@ struct _GstVideoDecoder
  *                  tags and meta with only the "video" tag. subclasses can
  *                  implement this method and return %TRUE if the metadata is to be
  *                  copied. Since 1.6
+ * @decode_parallel: Optional.
+ *                  Decode a self-contained frame from a worker thread, see
+ *                  gst_video_decoder_set_decode_threads(). Called without the
+ *                  stream lock and with an output buffer already allocated in
+ *                  @frame. The subclass must only decode the input buffer of
+ *                  @frame into its output buffer and must not finish, drop or
+ *                  release @frame itself, nor call any #GstVideoDecoder
+ *                  method that takes the stream lock. Return
+ *                  #GST_VIDEO_DECODER_FLOW_DECODE_SERIAL to have the frame
+ *                  passed to @handle_frame instead, for example when its
+ *                  format differs from the current output state. Since 1.10
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum @handle_frame needs to be overridden, and @set_format
@@ -335,8 +357,11 @@ struct _GstVideoDecoderClass
                                    GstVideoCodecFrame *frame,
                                    GstMeta * meta);
 
+  GstFlowReturn (*decode_parallel) (GstVideoDecoder *decoder,
+                                    GstVideoCodecFrame *frame);
+
   /*< private >*/
-  void         *padding[GST_PADDING_LARGE-6];
+  void         *padding[GST_PADDING_LARGE-7];
 };
 
 GType    gst_video_decoder_get_type (void);
@@ -357,6 +382,11 @@ void     gst_video_decoder_set_max_errors (GstVideoDecoder * dec,
 
 gint     gst_video_decoder_get_max_errors (GstVideoDecoder * dec);
 
+void     gst_video_decoder_set_decode_threads (GstVideoDecoder * dec,
+                                               guint n_threads);
+
+guint    gst_video_decoder_get_decode_threads (GstVideoDecoder * dec);
+
 void     gst_video_decoder_set_needs_format (GstVideoDecoder * dec,
                                              gboolean enabled);
 
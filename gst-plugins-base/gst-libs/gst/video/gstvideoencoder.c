@@ -151,7 +151,8 @@ struct _GstVideoEncoderPrivate
 
   guint32 system_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  GHashTable *frames_index;     /* system_frame_number -> link in frames */
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;
   gboolean output_state_changed;
@@ -253,6 +254,57 @@ static gboolean gst_video_encoder_src_query_default (GstVideoEncoder * encoder,
 static gboolean gst_video_encoder_transform_meta_default (GstVideoEncoder *
     encoder, GstVideoCodecFrame * frame, GstMeta * meta);
 
+/* pending frames are kept in order in priv->frames and indexed by their
+ * system_frame_number in priv->frames_index, which maps to the queue link */
+static void
+gst_video_encoder_push_frame (GstVideoEncoderPrivate * priv,
+    GstVideoCodecFrame * frame)
+{
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_index,
+      GINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
+}
+
+static gboolean
+gst_video_encoder_remove_frame (GstVideoEncoderPrivate * priv,
+    GstVideoCodecFrame * frame)
+{
+  gpointer key = GINT_TO_POINTER (frame->system_frame_number);
+  GList *link;
+
+  link = g_hash_table_lookup (priv->frames_index, key);
+  if (link && link->data == frame) {
+    g_hash_table_remove (priv->frames_index, key);
+  } else {
+    /* only when frame numbers wrapped around */
+    link = g_queue_find (&priv->frames, frame);
+    if (link == NULL)
+      return FALSE;
+  }
+  g_queue_delete_link (&priv->frames, link);
+
+  return TRUE;
+}
+
+static GstVideoCodecFrame *
+gst_video_encoder_lookup_frame (GstVideoEncoderPrivate * priv, int frame_number)
+{
+  GList *link;
+
+  link = g_hash_table_lookup (priv->frames_index,
+      GINT_TO_POINTER (frame_number));
+
+  return link ? link->data : NULL;
+}
+
+static void
+gst_video_encoder_clear_frames (GstVideoEncoderPrivate * priv)
+{
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
+  g_hash_table_remove_all (priv->frames_index);
+}
+
 /* we can't use G_DEFINE_ABSTRACT_TYPE because we need the klass in the _init
  * method to get to the padtemplates */
 GType
@@ -398,7 +450,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
   } else {
     GList *l;
 
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *frame = l->data;
 
       frame->events = _flush_events (encoder->srcpad, frame->events);
@@ -407,9 +459,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
         encoder->priv->current_frame_events);
   }
 
-  g_list_foreach (priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
-  g_list_free (priv->frames);
-  priv->frames = NULL;
+  gst_video_encoder_clear_frames (priv);
 
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -472,6 +522,9 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
 
   g_rec_mutex_init (&encoder->stream_lock);
 
+  g_queue_init (&priv->frames);
+  priv->frames_index = g_hash_table_new (NULL, NULL);
+
   priv->headers = NULL;
   priv->new_headers = FALSE;
 
@@ -881,6 +934,9 @@ gst_video_encoder_finalize (GObject * object)
   encoder = GST_VIDEO_ENCODER (object);
   g_rec_mutex_clear (&encoder->stream_lock);
 
+  gst_video_encoder_clear_frames (encoder->priv);
+  g_hash_table_unref (encoder->priv->frames_index);
+
   if (encoder->priv->allocator) {
     gst_object_unref (encoder->priv->allocator);
     encoder->priv->allocator = NULL;
@@ -1469,7 +1525,7 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GST_OBJECT_UNLOCK (encoder);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  gst_video_encoder_push_frame (priv, frame);
 
   /* new data, more finish needed */
   priv->drained = FALSE;
@@ -1635,7 +1691,7 @@ gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = encoder->priv->frames ? encoder->priv->frames->data : NULL;
+  frame = g_queue_peek_head (&encoder->priv->frames);
   if (frame || encoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -1857,14 +1913,9 @@ static void
 gst_video_encoder_release_frame (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
-
   /* unref once from the list */
-  link = g_list_find (enc->priv->frames, frame);
-  if (link) {
+  if (gst_video_encoder_remove_frame (enc->priv, frame))
     gst_video_codec_frame_unref (frame);
-    enc->priv->frames = g_list_delete_link (enc->priv->frames, link);
-  }
   /* unref because this function takes ownership */
   gst_video_codec_frame_unref (frame);
 }
@@ -1983,7 +2034,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     goto no_output_state;
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2091,7 +2142,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2348,8 +2399,8 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  if (encoder->priv->frames)
-    frame = gst_video_codec_frame_ref (encoder->priv->frames->data);
+  if (encoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (encoder->priv->frames.head->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -2367,20 +2418,14 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
 GstVideoCodecFrame *
 gst_video_encoder_get_frame (GstVideoEncoder * encoder, int frame_number)
 {
-  GList *g;
-  GstVideoCodecFrame *frame = NULL;
+  GstVideoCodecFrame *frame;
 
   GST_DEBUG_OBJECT (encoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  for (g = encoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  frame = gst_video_encoder_lookup_frame (encoder->priv, frame_number);
+  if (frame)
+    gst_video_codec_frame_ref (frame);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return frame;
@@ -2400,7 +2445,7 @@ gst_video_encoder_get_frames (GstVideoEncoder * encoder)
   GList *frames;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  frames = g_list_copy (encoder->priv->frames);
+  frames = g_list_copy (encoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
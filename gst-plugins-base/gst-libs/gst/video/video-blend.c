@@ -272,6 +272,119 @@ G_STMT_START { \
   cb = MIN(c, 255); \
 } G_STMT_END
 
+/* Blends the unpacked AYUV/ARGB @tmpsrcline into 4 byte pixels starting at
+ * @dline, with the alpha and the 3 color components at the byte offsets
+ * given in @doff. This is used on the unpacked destination line as well as
+ * directly on packed 8 bit destinations. */
+#define BLENDLOOP(op, alpha_val)                                                    \
+  G_STMT_START {                                                                    \
+    for (j = 0; j < src_width; j++) {                                               \
+      const guint8 *s = tmpsrcline + j * 4;                                         \
+      guint8 *d = dline + j * 4;                                                    \
+      guint8 asrc, adst;                                                            \
+      gint final_alpha;                                                             \
+                                                                                    \
+      asrc = s[0] * alpha_val / 255;                                                \
+      if (!asrc)                                                                    \
+        continue;                                                                   \
+                                                                                    \
+      adst = d[doff[0]];                                                            \
+      final_alpha = asrc + adst * (255 - asrc) / 255;                               \
+      d[doff[0]] = final_alpha;                                                     \
+      if (final_alpha == 0)                                                         \
+        final_alpha = 1;                                                            \
+                                                                                    \
+      BLENDC (op, alpha_val, asrc, s[1], adst, d[doff[1]], final_alpha);            \
+      BLENDC (op, alpha_val, asrc, s[2], adst, d[doff[2]], final_alpha);            \
+      BLENDC (op, alpha_val, asrc, s[3], adst, d[doff[3]], final_alpha);            \
+    }                                                                               \
+  } G_STMT_END
+
+/* Blends the unpacked AYUV @tmpsrcline directly into the planes of an opaque
+ * 4:2:0 destination line. Like the pack functions, chroma is only written
+ * on even lines and taken from even pixels. As the destination is opaque,
+ * so is the result. */
+#define BLENDLOOP_420(op, alpha_val)                                                \
+  G_STMT_START {                                                                    \
+    for (j = 0; j < src_width; j++) {                                               \
+      const guint8 *s = tmpsrcline + j * 4;                                         \
+      guint8 asrc;                                                                  \
+                                                                                    \
+      asrc = s[0] * alpha_val / 255;                                                \
+      if (!asrc)                                                                    \
+        continue;                                                                   \
+                                                                                    \
+      BLENDC (op, alpha_val, asrc, s[1], 255, dy[j], 255);                          \
+      if (du && !((x + j) & 1)) {                                                   \
+        gint k = (x + j) >> 1;                                                      \
+                                                                                    \
+        BLENDC (op, alpha_val, asrc, s[2], 255, du[k * upstride], 255);             \
+        BLENDC (op, alpha_val, asrc, s[3], 255, dv[k * vpstride], 255);             \
+      }                                                                             \
+    }                                                                               \
+  } G_STMT_END
+
+#define BLENDLINE(loop)                                                             \
+  G_STMT_START {                                                                    \
+    if (G_LIKELY (global_alpha == 1.0)) {                                           \
+      if (src_premultiplied_alpha && dest_premultiplied_alpha) {                    \
+        loop (OVER11, 255);                                                         \
+      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {            \
+        loop (OVER01, 255);                                                         \
+      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {            \
+        loop (OVER10, 255);                                                         \
+      } else {                                                                      \
+        loop (OVER00, 255);                                                         \
+      }                                                                             \
+    } else {                                                                        \
+      if (src_premultiplied_alpha && dest_premultiplied_alpha) {                    \
+        loop (OVER11, global_alpha_val);                                            \
+      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {            \
+        loop (OVER01, global_alpha_val);                                            \
+      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {            \
+        loop (OVER10, global_alpha_val);                                            \
+      } else {                                                                      \
+        loop (OVER00, global_alpha_val);                                            \
+      }                                                                             \
+    }                                                                               \
+  } G_STMT_END
+
+typedef enum
+{
+  BLEND_UNPACK,
+  BLEND_DIRECT_PACKED,
+  BLEND_DIRECT_420
+} BlendMethod;
+
+/* Common 8 bit destination formats are blended in place, without unpacking
+ * and repacking the whole destination line */
+static BlendMethod
+get_blend_method (GstVideoFrame * dest, gboolean dest_premultiplied_alpha)
+{
+  switch (GST_VIDEO_FRAME_FORMAT (dest)) {
+    case GST_VIDEO_FORMAT_AYUV:
+    case GST_VIDEO_FORMAT_ARGB:
+    case GST_VIDEO_FORMAT_BGRA:
+    case GST_VIDEO_FORMAT_ABGR:
+    case GST_VIDEO_FORMAT_RGBA:
+    case GST_VIDEO_FORMAT_xRGB:
+    case GST_VIDEO_FORMAT_BGRx:
+    case GST_VIDEO_FORMAT_xBGR:
+    case GST_VIDEO_FORMAT_RGBx:
+      return BLEND_DIRECT_PACKED;
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12:
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+      /* the unpacked destination is opaque */
+      if (!dest_premultiplied_alpha)
+        return BLEND_DIRECT_420;
+      return BLEND_UNPACK;
+    default:
+      return BLEND_UNPACK;
+  }
+}
+
 
 /**
  * gst_video_blend:
@@ -291,6 +404,9 @@ gst_video_blend (GstVideoFrame * dest,
   gint i, j, global_alpha_val, src_width, src_height, dest_width, dest_height;
   gint src_xoff = 0, src_yoff = 0;
   guint8 *tmpdestline = NULL, *tmpsrcline = NULL;
+  guint8 *dline = NULL, *dy = NULL, *du = NULL, *dv = NULL;
+  gint doff[4], upstride = 0, vpstride = 0;
+  BlendMethod method;
   gboolean src_premultiplied_alpha, dest_premultiplied_alpha;
   void (*matrix) (guint8 * tmpline, guint width);
   const GstVideoFormatInfo *sinfo, *dinfo, *dunpackinfo, *sunpackinfo;
@@ -339,7 +455,6 @@ gst_video_blend (GstVideoFrame * dest,
   if (GST_VIDEO_FORMAT_INFO_BITS (dunpackinfo) != 8)
     goto unpack_format_not_supported;
 
-  tmpdestline = g_malloc (sizeof (guint8) * (dest_width + 8) * 4);
   tmpsrcline = g_malloc (sizeof (guint8) * (src_width + 8) * 4);
 
   matrix = matrix_identity;
@@ -380,78 +495,80 @@ gst_video_blend (GstVideoFrame * dest,
   if (y + src_height > dest_height)
     src_height = dest_height - y;
 
+  method = get_blend_method (dest, dest_premultiplied_alpha);
+
+  if (method == BLEND_DIRECT_PACKED) {
+    /* byte offsets of the alpha and color components, for the formats
+     * without alpha the padding byte takes the alpha, like when packing */
+    doff[1] = GST_VIDEO_FRAME_COMP_POFFSET (dest, 0);
+    doff[2] = GST_VIDEO_FRAME_COMP_POFFSET (dest, 1);
+    doff[3] = GST_VIDEO_FRAME_COMP_POFFSET (dest, 2);
+    if (GST_VIDEO_INFO_HAS_ALPHA (&dest->info))
+      doff[0] = GST_VIDEO_FRAME_COMP_POFFSET (dest, 3);
+    else
+      doff[0] = 6 - doff[1] - doff[2] - doff[3];
+  } else if (method == BLEND_DIRECT_420) {
+    upstride = GST_VIDEO_FRAME_COMP_PSTRIDE (dest, 1);
+    vpstride = GST_VIDEO_FRAME_COMP_PSTRIDE (dest, 2);
+  } else {
+    tmpdestline = g_malloc (sizeof (guint8) * (dest_width + 8) * 4);
+    doff[0] = 0;
+    doff[1] = 1;
+    doff[2] = 2;
+    doff[3] = 3;
+  }
+
   /* Mainloop doing the needed conversions, and blending */
   for (i = y; i < y + src_height; i++, src_yoff++) {
 
-    dinfo->unpack_func (dinfo, 0, tmpdestline, dest->data, dest->info.stride,
-        0, i, dest_width);
     sinfo->unpack_func (sinfo, 0, tmpsrcline, src->data, src->info.stride,
         src_xoff, src_yoff, src_width);
 
-    /* FIXME: use the x parameter of the unpack func once implemented */
-    tmpdestline += 4 * x;
-
     matrix (tmpsrcline, src_width);
 
-#define BLENDLOOP(op, alpha_val)                                                              \
-  G_STMT_START {                                                                              \
-    for (j = 0; j < src_width * 4; j += 4) {                                                  \
-      guint8 asrc, adst;                                                                      \
-      gint final_alpha;                                                                       \
-                                                                                              \
-      asrc = tmpsrcline[j] * alpha_val / 255;                                                 \
-      if (!asrc)                                                                              \
-        continue;                                                                             \
-                                                                                              \
-      adst = tmpdestline[j];                                                                  \
-      final_alpha = asrc + adst * (255 - asrc) / 255;                                         \
-      tmpdestline[j] = final_alpha;                                                           \
-      if (final_alpha == 0)                                                                   \
-        final_alpha = 1;                                                                      \
-                                                                                              \
-      BLENDC (op, alpha_val, asrc, tmpsrcline[j + 1], adst, tmpdestline[j + 1], final_alpha); \
-      BLENDC (op, alpha_val, asrc, tmpsrcline[j + 2], adst, tmpdestline[j + 2], final_alpha); \
-      BLENDC (op, alpha_val, asrc, tmpsrcline[j + 3], adst, tmpdestline[j + 3], final_alpha); \
-    }                                                                                         \
-  } G_STMT_END
-
-    if (G_LIKELY (global_alpha == 1.0)) {
-      if (src_premultiplied_alpha && dest_premultiplied_alpha) {
-        BLENDLOOP (OVER11, 255);
-      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
-        BLENDLOOP (OVER01, 255);
-      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
-        BLENDLOOP (OVER10, 255);
-      } else {
-        BLENDLOOP (OVER00, 255);
-      }
-    } else {
-      if (src_premultiplied_alpha && dest_premultiplied_alpha) {
-        BLENDLOOP (OVER11, global_alpha_val);
-      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
-        BLENDLOOP (OVER01, global_alpha_val);
-      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
-        BLENDLOOP (OVER10, global_alpha_val);
-      } else {
-        BLENDLOOP (OVER00, global_alpha_val);
-      }
+    switch (method) {
+      case BLEND_DIRECT_PACKED:
+        dline = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (dest, 0) +
+            i * GST_VIDEO_FRAME_PLANE_STRIDE (dest, 0) + 4 * x;
+
+        BLENDLINE (BLENDLOOP);
+        break;
+      case BLEND_DIRECT_420:
+        dy = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 0) +
+            i * GST_VIDEO_FRAME_COMP_STRIDE (dest, 0) + x;
+        if (!(i & 1)) {
+          du = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 1) +
+              (i >> 1) * GST_VIDEO_FRAME_COMP_STRIDE (dest, 1);
+          dv = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 2) +
+              (i >> 1) * GST_VIDEO_FRAME_COMP_STRIDE (dest, 2);
+        } else {
+          du = dv = NULL;
+        }
+
+        BLENDLINE (BLENDLOOP_420);
+        break;
+      case BLEND_UNPACK:
+        dinfo->unpack_func (dinfo, 0, tmpdestline, dest->data,
+            dest->info.stride, 0, i, dest_width);
+
+        /* FIXME: use the x parameter of the unpack func once implemented */
+        dline = tmpdestline + 4 * x;
+
+        BLENDLINE (BLENDLOOP);
+
+        /* FIXME
+         * #if G_BYTE_ORDER == LITTLE_ENDIAN
+         * video_orc_blend_little (tmpdestline, tmpsrcline, dest->width);
+         * #else
+         * video_orc_blend_big (tmpdestline, tmpsrcline, src->width);
+         * #endif
+         */
+
+        dinfo->pack_func (dinfo, 0, tmpdestline, dest_width,
+            dest->data, dest->info.stride, dest->info.chroma_site, i,
+            dest_width);
+        break;
     }
-
-#undef BLENDLOOP
-
-    /* undo previous pointer adjustments to pass right pointer to g_free */
-    tmpdestline -= 4 * x;
-
-    /* FIXME
-     * #if G_BYTE_ORDER == LITTLE_ENDIAN
-     * video_orc_blend_little (tmpdestline, tmpsrcline, dest->width);
-     * #else
-     * video_orc_blend_big (tmpdestline, tmpsrcline, src->width);
-     * #endif
-     */
-
-    dinfo->pack_func (dinfo, 0, tmpdestline, dest_width,
-        dest->data, dest->info.stride, dest->info.chroma_site, i, dest_width);
   }
 
   g_free (tmpdestline);
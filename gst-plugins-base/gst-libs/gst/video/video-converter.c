@@ -171,6 +171,15 @@ typedef struct
 typedef void (*FastConvertFunc) (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest, gint plane);
 
+/* a horizontal band of output lines, converted by its own converter so that
+ * it has private line caches, scalers, chroma resamplers and dither state */
+typedef struct
+{
+  GstVideoConverter *convert;
+  gint start;
+  gint end;
+} ConverterBand;
+
 struct _GstVideoConverter
 {
   gint flags;
@@ -299,6 +308,14 @@ struct _GstVideoConverter
   GstVideoScaler *fh_scaler[4];
   GstVideoScaler *fv_scaler[4];
   FastConvertFunc fconvert[4];
+
+  /* threading */
+  guint n_bands;
+  ConverterBand *bands;
+  GThreadPool *band_pool;
+  GMutex band_lock;
+  GCond band_cond;
+  guint bands_pending;
 };
 
 typedef gpointer (*GstLineCacheAllocLineFunc) (GstLineCache * cache, gint idx,
@@ -448,6 +465,15 @@ gst_line_cache_alloc_line (GstLineCache * cache, gint idx)
 
 static void video_converter_generic (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest);
+static void video_converter_generic_lines (GstVideoConverter * convert,
+    gint start, gint end);
+static void free_bands (GstVideoConverter * convert);
+static void convert_scale_planes (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest);
+static void convert_scale_planes_lines (GstVideoConverter * convert,
+    gint start, gint end);
+static void video_converter_run_bands (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest);
 static gboolean video_converter_lookup_fastpath (GstVideoConverter * convert);
 static void video_converter_compute_matrix (GstVideoConverter * convert);
 static void video_converter_compute_resample (GstVideoConverter * convert);
@@ -607,6 +633,7 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define DEFAULT_OPT_RESAMPLER_TAPS 0
 #define DEFAULT_OPT_DITHER_METHOD GST_VIDEO_DITHER_BAYER
 #define DEFAULT_OPT_DITHER_QUANTIZATION 1
+#define DEFAULT_OPT_THREADS 1
 
 #define GET_OPT_FILL_BORDER(c) get_opt_bool(c, \
     GST_VIDEO_CONVERTER_OPT_FILL_BORDER, DEFAULT_OPT_FILL_BORDER)
@@ -637,6 +664,8 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
     DEFAULT_OPT_DITHER_METHOD)
 #define GET_OPT_DITHER_QUANTIZATION(c) get_opt_uint(c, \
     GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, DEFAULT_OPT_DITHER_QUANTIZATION)
+#define GET_OPT_THREADS(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_THREADS, DEFAULT_OPT_THREADS)
 
 #define CHECK_ALPHA_COPY(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_COPY)
 #define CHECK_ALPHA_SET(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_SET)
@@ -2034,6 +2063,107 @@ convert_get_alpha_mode (GstVideoConverter * convert)
   return ALPHA_MODE_SET;
 }
 
+/* output bands start on a multiple of this many lines so that vertical
+ * chroma subsampling and interlaced fields never straddle two bands */
+#define BAND_ALIGN 4
+
+/* called with user_data == NULL for the band done by the calling thread */
+static void
+converter_band_func (gpointer data, gpointer user_data)
+{
+  ConverterBand *band = data;
+  GstVideoConverter *convert = user_data;
+
+  if (band->convert->convert == video_converter_generic)
+    video_converter_generic_lines (band->convert, band->start, band->end);
+  else
+    convert_scale_planes_lines (band->convert, band->start, band->end);
+
+  if (convert == NULL)
+    return;
+
+  g_mutex_lock (&convert->band_lock);
+  if (--convert->bands_pending == 0)
+    g_cond_signal (&convert->band_cond);
+  g_mutex_unlock (&convert->band_lock);
+}
+
+static void
+setup_bands (GstVideoConverter * convert, GstVideoInfo * in_info,
+    GstVideoInfo * out_info)
+{
+  GstVideoDitherMethod method;
+  guint n_threads, n_bands, i;
+  gint band_height;
+  GError *err = NULL;
+
+  n_threads = GET_OPT_THREADS (convert);
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  /* error diffusion carries state from one line to the next, splitting the
+   * frame would give a different result than the serial path */
+  method = GET_OPT_DITHER_METHOD (convert);
+  if (convert->dither && (method == GST_VIDEO_DITHER_FLOYD_STEINBERG ||
+          method == GST_VIDEO_DITHER_SIERRA_LITE)) {
+    GST_DEBUG ("dither method %d needs serial processing", method);
+    n_threads = 1;
+  }
+
+  n_threads = MIN (n_threads, convert->out_height / BAND_ALIGN);
+  if (n_threads <= 1)
+    return;
+
+  band_height = (convert->out_height + n_threads - 1) / n_threads;
+  band_height = GST_ROUND_UP_N (band_height, BAND_ALIGN);
+  n_bands = (convert->out_height + band_height - 1) / band_height;
+  if (n_bands <= 1)
+    return;
+
+  convert->band_pool = g_thread_pool_new (converter_band_func, convert,
+      n_bands - 1, TRUE, &err);
+  if (convert->band_pool == NULL) {
+    GST_WARNING ("could not create worker threads: %s", err->message);
+    g_clear_error (&err);
+    return;
+  }
+  g_mutex_init (&convert->band_lock);
+  g_cond_init (&convert->band_cond);
+
+  convert->bands = g_new0 (ConverterBand, n_bands);
+  convert->n_bands = n_bands;
+
+  for (i = 0; i < n_bands; i++) {
+    ConverterBand *band = &convert->bands[i];
+
+    band->start = i * band_height;
+    band->end = MIN (band->start + band_height, convert->out_height);
+
+    if (i == 0) {
+      band->convert = convert;
+    } else {
+      GstStructure *config;
+
+      config = gst_structure_copy (convert->config);
+      gst_structure_set (config, GST_VIDEO_CONVERTER_OPT_THREADS,
+          G_TYPE_UINT, 1, NULL);
+      band->convert = gst_video_converter_new (in_info, out_info, config);
+      if (band->convert == NULL || band->convert->convert != convert->convert)
+        goto band_failed;
+    }
+    GST_DEBUG ("band %u: lines %d-%d", i, band->start, band->end);
+  }
+  return;
+
+  /* ERRORS */
+band_failed:
+  {
+    GST_WARNING ("could not create converter for band %u", i);
+    free_bands (convert);
+    return;
+  }
+}
+
 /**
  * gst_video_converter_new: (skip)
  * @in_info: a #GstVideoInfo
@@ -2194,6 +2324,11 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   setup_allocators (convert);
 
 done:
+  /* split the frame over worker threads when the conversion is line based */
+  if (convert->convert == video_converter_generic ||
+      convert->convert == convert_scale_planes)
+    setup_bands (convert, in_info, out_info);
+
   return convert;
 
   /* ERRORS */
@@ -2213,6 +2348,30 @@ no_pack_func:
   }
 }
 
+static void
+free_bands (GstVideoConverter * convert)
+{
+  guint i;
+
+  if (convert->band_pool == NULL)
+    return;
+
+  /* wait for the workers to finish before freeing what they use */
+  g_thread_pool_free (convert->band_pool, FALSE, TRUE);
+  convert->band_pool = NULL;
+
+  for (i = 1; i < convert->n_bands; i++) {
+    if (convert->bands[i].convert)
+      gst_video_converter_free (convert->bands[i].convert);
+  }
+  g_free (convert->bands);
+  convert->bands = NULL;
+  convert->n_bands = 0;
+
+  g_mutex_clear (&convert->band_lock);
+  g_cond_clear (&convert->band_cond);
+}
+
 static void
 clear_matrix_data (MatrixData * data)
 {
@@ -2236,6 +2395,8 @@ gst_video_converter_free (GstVideoConverter * convert)
 
   g_return_if_fail (convert != NULL);
 
+  free_bands (convert);
+
   if (convert->upsample_p)
     gst_video_chroma_resample_free (convert->upsample_p);
   if (convert->upsample_i)
@@ -2777,22 +2938,9 @@ do_dither_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static void
-video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+video_converter_generic_setup (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
 {
-  gint i;
-  gint out_maxwidth, out_maxheight;
-  gint out_x, out_y, out_height;
-  gint pack_lines, pstride;
-  gint lb_width;
-
-  out_height = convert->out_height;
-  out_maxwidth = convert->out_maxwidth;
-  out_maxheight = convert->out_maxheight;
-
-  out_x = convert->out_x;
-  out_y = convert->out_y;
-
   convert->src = src;
   convert->dest = dest;
 
@@ -2821,19 +2969,25 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
     convert->down_n_lines = 1;
     convert->down_offset = 0;
   }
+}
 
-  pack_lines = convert->pack_nlines;    /* only 1 for now */
-  pstride = convert->pack_pstride;
+/* pack output lines [start, end) of the active area */
+static void
+video_converter_generic_lines (GstVideoConverter * convert, gint start,
+    gint end)
+{
+  gint i;
+  gint out_maxwidth, out_y;
+  gint pack_lines, lb_width;
+  GstVideoFrame *dest = convert->dest;
 
-  lb_width = out_x * pstride;
+  out_maxwidth = convert->out_maxwidth;
+  out_y = convert->out_y;
 
-  if (convert->borderline) {
-    /* FIXME we should try to avoid PACK_FRAME */
-    for (i = 0; i < out_y; i++)
-      PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
-  }
+  pack_lines = convert->pack_nlines;    /* only 1 for now */
+  lb_width = convert->out_x * convert->pack_pstride;
 
-  for (i = 0; i < out_height; i += pack_lines) {
+  for (i = start; i < end; i += pack_lines) {
     gpointer *lines;
 
     /* load the lines needed to pack */
@@ -2848,6 +3002,65 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       PACK_FRAME (dest, l, i + out_y, out_maxwidth);
     }
   }
+}
+
+static void
+video_converter_run_bands (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  guint i;
+
+  g_mutex_lock (&convert->band_lock);
+  convert->bands_pending = convert->n_bands - 1;
+  g_mutex_unlock (&convert->band_lock);
+
+  for (i = 1; i < convert->n_bands; i++) {
+    ConverterBand *band = &convert->bands[i];
+
+    if (convert->convert == video_converter_generic) {
+      video_converter_generic_setup (band->convert, src, dest);
+    } else {
+      band->convert->src = src;
+      band->convert->dest = dest;
+    }
+    g_thread_pool_push (convert->band_pool, band, NULL);
+  }
+  /* the first band is done in the calling thread */
+  convert->src = src;
+  convert->dest = dest;
+  converter_band_func (&convert->bands[0], NULL);
+
+  g_mutex_lock (&convert->band_lock);
+  while (convert->bands_pending > 0)
+    g_cond_wait (&convert->band_cond, &convert->band_lock);
+  g_mutex_unlock (&convert->band_lock);
+}
+
+static void
+video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  gint i;
+  gint out_maxwidth, out_maxheight;
+  gint out_y, out_height;
+
+  out_height = convert->out_height;
+  out_maxwidth = convert->out_maxwidth;
+  out_maxheight = convert->out_maxheight;
+  out_y = convert->out_y;
+
+  video_converter_generic_setup (convert, src, dest);
+
+  if (convert->borderline) {
+    /* FIXME we should try to avoid PACK_FRAME */
+    for (i = 0; i < out_y; i++)
+      PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
+  }
+
+  if (convert->n_bands > 1)
+    video_converter_run_bands (convert, src, dest);
+  else
+    video_converter_generic_lines (convert, 0, out_height);
 
   if (convert->borderline) {
     for (i = out_y + out_height; i < out_maxheight; i++)
@@ -3971,10 +4184,11 @@ convert_plane_hv_halve (GstVideoConverter * convert,
 }
 
 static void
-convert_plane_hv (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+convert_plane_hv_lines (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint y,
+    gint height)
 {
-  gint in_x, in_y, out_x, out_y, out_width, out_height;
+  gint in_x, in_y, out_x, out_y, out_width;
   GstVideoFormat format;
   GstVideoScaler *h_scaler, *v_scaler;
   gint splane = convert->fsplane[plane];
@@ -3985,7 +4199,6 @@ convert_plane_hv (GstVideoConverter * convert,
   out_x = convert->fout_x[plane];
   out_y = convert->fout_y[plane];
   out_width = convert->fout_width[plane];
-  out_height = convert->fout_height[plane];
   format = convert->fformat[plane];
 
   h_scaler = convert->fh_scaler[plane];
@@ -3998,7 +4211,41 @@ convert_plane_hv (GstVideoConverter * convert,
 
   gst_video_scaler_2d (h_scaler, v_scaler, format,
       s, FRAME_GET_PLANE_STRIDE (src, splane),
-      d, FRAME_GET_PLANE_STRIDE (dest, plane), 0, 0, out_width, out_height);
+      d, FRAME_GET_PLANE_STRIDE (dest, plane), 0, y, out_width, height);
+}
+
+static void
+convert_plane_hv (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+{
+  convert_plane_hv_lines (convert, src, dest, plane, 0,
+      convert->fout_height[plane]);
+}
+
+/* scale output lines [start, end) of the active area in all planes that
+ * use the generic plane scaler */
+static void
+convert_scale_planes_lines (GstVideoConverter * convert, gint start, gint end)
+{
+  gint i, n_planes;
+
+  n_planes = GST_VIDEO_FRAME_N_PLANES (convert->dest);
+  for (i = 0; i < n_planes; i++) {
+    gint pstart, pend;
+
+    if (convert->fconvert[i] != convert_plane_hv)
+      continue;
+
+    /* bands are aligned so that this is exact for subsampled planes */
+    pstart = start * convert->fout_height[i] / convert->out_height;
+    if (end == convert->out_height)
+      pend = convert->fout_height[i];
+    else
+      pend = end * convert->fout_height[i] / convert->out_height;
+
+    convert_plane_hv_lines (convert, convert->src, convert->dest, i, pstart,
+        pend - pstart);
+  }
 }
 
 static void
@@ -4008,9 +4255,18 @@ convert_scale_planes (GstVideoConverter * convert,
   int i, n_planes;
 
   n_planes = GST_VIDEO_FRAME_N_PLANES (dest);
-  for (i = 0; i < n_planes; i++) {
-    if (convert->fconvert[i])
-      convert->fconvert[i] (convert, src, dest, i);
+  if (convert->n_bands > 1) {
+    /* the cheap plane operations are not worth splitting up */
+    for (i = 0; i < n_planes; i++) {
+      if (convert->fconvert[i] && convert->fconvert[i] != convert_plane_hv)
+        convert->fconvert[i] (convert, src, dest, i);
+    }
+    video_converter_run_bands (convert, src, dest);
+  } else {
+    for (i = 0; i < n_planes; i++) {
+      if (convert->fconvert[i])
+        convert->fconvert[i] (convert, src, dest, i);
+    }
   }
   convert_fill_border (convert, dest);
 }
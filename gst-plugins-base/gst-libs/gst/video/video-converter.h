@@ -265,6 +265,19 @@ typedef enum {
  */
 #define GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE   "GstVideoConverter.primaries-mode"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_THREADS:
+ *
+ * #G_TYPE_UINT, maximum number of threads to use. The frame is split in
+ * horizontal bands of lines that are converted in parallel, the result is
+ * identical to the serial conversion. When error diffusion dithering is
+ * required the conversion is always done serially.
+ * Default 1, 0 for the number of cores.
+ *
+ * Since: 1.10
+ */
+#define GST_VIDEO_CONVERTER_OPT_THREADS   "GstVideoConverter.threads"
+
 typedef struct _GstVideoConverter GstVideoConverter;
 
 GstVideoConverter *  gst_video_converter_new            (GstVideoInfo *in_info,
@@ -163,10 +163,6 @@ struct _GstDecodeBin
   GstDecodeChain *decode_chain; /* Top level decode chain */
   guint nbpads;                 /* unique identifier for source pads */
 
-  GMutex factories_lock;
-  guint32 factories_cookie;     /* Cookie from last time when factories was updated */
-  GList *factories;             /* factories we can use for selecting elements */
-
   GMutex subtitle_lock;         /* Protects changes to subtitles and encoding */
   GList *subtitles;             /* List of elements with subtitle-encoding,
                                  * protected by above mutex! */
@@ -1050,31 +1046,91 @@ _decode_bin_compare_factories_func (gconstpointer p1, gconstpointer p2)
   return gst_plugin_feature_rank_compare_func (p1, p2);
 }
 
-/* Must be called with factories lock! */
+/* The factories we can use for selecting elements and the results of
+ * filtering them against caps are the same for all decodebins, so they are
+ * cached for the whole process and dropped when the registry feature list
+ * changes. The filtered lists are keyed by the serialized caps. */
+#define FACTORY_CACHE_MAX_CAPS 128
+
+G_LOCK_DEFINE_STATIC (factory_cache);
+static GList *factory_cache_list = NULL;        /* sorted factories */
+static guint32 factory_cache_cookie = 0;
+static GHashTable *factory_cache_filtered = NULL;       /* caps -> GList */
+
+/* Must be called with the factory_cache lock! */
 static void
-gst_decode_bin_update_factories_list (GstDecodeBin * dbin)
+gst_decode_bin_update_factories_list (void)
 {
   guint cookie;
 
   cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
-  if (!dbin->factories || dbin->factories_cookie != cookie) {
-    if (dbin->factories)
-      gst_plugin_feature_list_free (dbin->factories);
-    dbin->factories =
+  if (!factory_cache_list || factory_cache_cookie != cookie) {
+    if (factory_cache_list)
+      gst_plugin_feature_list_free (factory_cache_list);
+    factory_cache_list =
         gst_element_factory_list_get_elements
         (GST_ELEMENT_FACTORY_TYPE_DECODABLE, GST_RANK_MARGINAL);
-    dbin->factories =
-        g_list_sort (dbin->factories, _decode_bin_compare_factories_func);
-    dbin->factories_cookie = cookie;
+    factory_cache_list =
+        g_list_sort (factory_cache_list, _decode_bin_compare_factories_func);
+    factory_cache_cookie = cookie;
+
+    if (factory_cache_filtered)
+      g_hash_table_remove_all (factory_cache_filtered);
+  }
+
+  if (!factory_cache_filtered)
+    factory_cache_filtered = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) gst_plugin_feature_list_free);
+}
+
+/* Returns the factories that can handle @caps, free with
+ * gst_plugin_feature_list_free() */
+static GList *
+gst_decode_bin_find_factories (GstCaps * caps)
+{
+  GList *factories, *list;
+  gchar *key;
+  guint32 cookie;
+
+  key = gst_caps_to_string (caps);
+
+  G_LOCK (factory_cache);
+  gst_decode_bin_update_factories_list ();
+  if (g_hash_table_lookup_extended (factory_cache_filtered, key, NULL,
+          (gpointer *) & list)) {
+    list = gst_plugin_feature_list_copy (list);
+    G_UNLOCK (factory_cache);
+    g_free (key);
+    return list;
+  }
+  factories = gst_plugin_feature_list_copy (factory_cache_list);
+  cookie = factory_cache_cookie;
+  G_UNLOCK (factory_cache);
+
+  /* don't block the other decodebins while intersecting the caps */
+  list =
+      gst_element_factory_list_filter (factories, caps, GST_PAD_SINK,
+      gst_caps_is_fixed (caps));
+  gst_plugin_feature_list_free (factories);
+
+  G_LOCK (factory_cache);
+  if (cookie == factory_cache_cookie) {
+    /* caps differ in many details between streams, keep the cache bounded */
+    if (g_hash_table_size (factory_cache_filtered) >= FACTORY_CACHE_MAX_CAPS)
+      g_hash_table_remove_all (factory_cache_filtered);
+    g_hash_table_replace (factory_cache_filtered, key,
+        gst_plugin_feature_list_copy (list));
+    key = NULL;
   }
+  G_UNLOCK (factory_cache);
+  g_free (key);
+
+  return list;
 }
 
 static void
 gst_decode_bin_init (GstDecodeBin * decode_bin)
 {
-  /* first filter out the interesting element factories */
-  g_mutex_init (&decode_bin->factories_lock);
-
   /* we create the typefind element only once */
   decode_bin->typefind = gst_element_factory_make ("typefind", "typefind");
   if (!decode_bin->typefind) {
@@ -1138,10 +1194,6 @@ gst_decode_bin_dispose (GObject * object)
 
   decode_bin = GST_DECODE_BIN (object);
 
-  if (decode_bin->factories)
-    gst_plugin_feature_list_free (decode_bin->factories);
-  decode_bin->factories = NULL;
-
   if (decode_bin->decode_chain)
     gst_decode_chain_free (decode_bin->decode_chain);
   decode_bin->decode_chain = NULL;
@@ -1171,7 +1223,6 @@ gst_decode_bin_finalize (GObject * object)
   g_mutex_clear (&decode_bin->subtitle_lock);
   g_mutex_clear (&decode_bin->buffering_lock);
   g_mutex_clear (&decode_bin->buffering_post_lock);
-  g_mutex_clear (&decode_bin->factories_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1394,17 +1445,11 @@ gst_decode_bin_autoplug_factories (GstElement * element, GstPad * pad,
 {
   GList *list, *tmp;
   GValueArray *result;
-  GstDecodeBin *dbin = GST_DECODE_BIN_CAST (element);
 
   GST_DEBUG_OBJECT (element, "finding factories");
 
   /* return all compatible factories for caps */
-  g_mutex_lock (&dbin->factories_lock);
-  gst_decode_bin_update_factories_list (dbin);
-  list =
-      gst_element_factory_list_filter (dbin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
-  g_mutex_unlock (&dbin->factories_lock);
+  list = gst_decode_bin_find_factories (caps);
 
   result = g_value_array_new (g_list_length (list));
   for (tmp = list; tmp; tmp = tmp->next) {
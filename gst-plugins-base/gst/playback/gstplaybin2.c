@@ -348,6 +348,11 @@ struct _GstSourceGroup
   gboolean have_group_id;
   guint group_id;
 
+  /* early about-to-finish, see the about-to-finish-threshold property */
+  gint about_to_finish_emitted;
+  GstClockTime duration;
+  gboolean duration_queried;
+
   gulong pad_added_id;
   gulong pad_removed_id;
   gulong no_more_pads_id;
@@ -484,6 +489,8 @@ struct _GstPlayBin
 
   guint64 ring_buffer_max_size; /* 0 means disabled */
 
+  guint64 about_to_finish_threshold;    /* 0 means emit on drain only */
+
   GList *contexts;
 };
 
@@ -545,6 +552,7 @@ struct _GstPlayBinClass
 #define DEFAULT_BUFFER_DURATION   -1
 #define DEFAULT_BUFFER_SIZE       -1
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
+#define DEFAULT_ABOUT_TO_FINISH_THRESHOLD 0
 
 enum
 {
@@ -582,7 +590,8 @@ enum
   PROP_AUDIO_FILTER,
   PROP_VIDEO_FILTER,
   PROP_MULTIVIEW_MODE,
-  PROP_MULTIVIEW_FLAGS
+  PROP_MULTIVIEW_FLAGS,
+  PROP_ABOUT_TO_FINISH_THRESHOLD
 };
 
 /* signals */
@@ -1034,6 +1043,27 @@ gst_play_bin_class_init (GstPlayBinClass * klass)
           GST_TYPE_VIDEO_MULTIVIEW_FLAGS, GST_VIDEO_MULTIVIEW_FLAGS_NONE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPlayBin:about-to-finish-threshold:
+   *
+   * When not 0, the #GstPlayBin::about-to-finish signal is emitted as soon
+   * as the decoded position of the current uri gets within this many
+   * nanoseconds of its duration, instead of only when the uri has been
+   * completely decoded. This gives the application more time to queue the
+   * next uri for gapless playback. The signal is still emitted at most once
+   * per uri, and on drain if the duration of the current uri is unknown.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_klass,
+      PROP_ABOUT_TO_FINISH_THRESHOLD,
+      g_param_spec_uint64 ("about-to-finish-threshold",
+          "About to finish threshold (ns)",
+          "Emit about-to-finish this long before the end of the current uri "
+          "(0 = only when the uri is drained)",
+          0, G_MAXUINT64, DEFAULT_ABOUT_TO_FINISH_THRESHOLD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstPlayBin::about-to-finish
    * @playbin: a #GstPlayBin
@@ -1558,6 +1588,7 @@ gst_play_bin_init (GstPlayBin * playbin)
   playbin->buffer_duration = DEFAULT_BUFFER_DURATION;
   playbin->buffer_size = DEFAULT_BUFFER_SIZE;
   playbin->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
+  playbin->about_to_finish_threshold = DEFAULT_ABOUT_TO_FINISH_THRESHOLD;
 
   playbin->force_aspect_ratio = TRUE;
 
@@ -2488,6 +2519,11 @@ gst_play_bin_set_property (GObject * object, guint prop_id,
       playbin->multiview_flags = g_value_get_flags (value);
       GST_PLAY_BIN_UNLOCK (playbin);
       break;
+    case PROP_ABOUT_TO_FINISH_THRESHOLD:
+      GST_OBJECT_LOCK (playbin);
+      playbin->about_to_finish_threshold = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2741,6 +2777,11 @@ gst_play_bin_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_flags (value, playbin->multiview_flags);
       GST_OBJECT_UNLOCK (playbin);
       break;
+    case PROP_ABOUT_TO_FINISH_THRESHOLD:
+      GST_OBJECT_LOCK (playbin);
+      g_value_set_uint64 (value, playbin->about_to_finish_threshold);
+      GST_OBJECT_UNLOCK (playbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3131,6 +3172,86 @@ update_video_multiview_caps (GstPlayBin * playbin, GstCaps * caps)
   return out_caps;
 }
 
+/* emit about-to-finish for @group, at most once per activation. Returns
+ * FALSE if it was already emitted */
+static gboolean
+emit_about_to_finish (GstPlayBin * playbin, GstSourceGroup * group)
+{
+  if (!g_atomic_int_compare_and_exchange (&group->about_to_finish_emitted, 0,
+          1))
+    return FALSE;
+
+  g_signal_emit (G_OBJECT (playbin),
+      gst_play_bin_signals[SIGNAL_ABOUT_TO_FINISH], 0, NULL);
+
+  return TRUE;
+}
+
+static GstPadProbeReturn
+_uridecodebin_buffer_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer udata)
+{
+  GstSourceGroup *group = udata;
+  GstPlayBin *playbin = group->playbin;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  const GstSegment *segment;
+  GstEvent *event;
+  GstClockTime threshold, position, duration;
+
+  if (g_atomic_int_get (&group->about_to_finish_emitted))
+    return GST_PAD_PROBE_OK;
+
+  if (!GST_BUFFER_PTS_IS_VALID (buffer))
+    return GST_PAD_PROBE_OK;
+
+  GST_OBJECT_LOCK (playbin);
+  threshold = playbin->about_to_finish_threshold;
+  GST_OBJECT_UNLOCK (playbin);
+  if (threshold == 0)
+    return GST_PAD_PROBE_OK;
+
+  event = gst_pad_get_sticky_event (pad, GST_EVENT_SEGMENT, 0);
+  if (!event)
+    return GST_PAD_PROBE_OK;
+
+  gst_event_parse_segment (event, &segment);
+  if (segment->format != GST_FORMAT_TIME || segment->rate < 0.0) {
+    gst_event_unref (event);
+    return GST_PAD_PROBE_OK;
+  }
+  position = gst_segment_to_stream_time (segment, GST_FORMAT_TIME,
+      GST_BUFFER_PTS (buffer));
+  gst_event_unref (event);
+
+  if (!GST_CLOCK_TIME_IS_VALID (position))
+    return GST_PAD_PROBE_OK;
+
+  /* only ask upstream once per group, live and unseekable streams will
+   * usually not know their duration and then we wait for the drain */
+  GST_SOURCE_GROUP_LOCK (group);
+  if (!group->duration_queried) {
+    gint64 dur;
+
+    group->duration_queried = TRUE;
+    if (gst_pad_query_duration (pad, GST_FORMAT_TIME, &dur) && dur > 0)
+      group->duration = dur;
+  }
+  duration = group->duration;
+  GST_SOURCE_GROUP_UNLOCK (group);
+
+  if (!GST_CLOCK_TIME_IS_VALID (duration) || position + threshold < duration)
+    return GST_PAD_PROBE_OK;
+
+  GST_DEBUG_OBJECT (playbin, "position %" GST_TIME_FORMAT " within %"
+      GST_TIME_FORMAT " of duration %" GST_TIME_FORMAT
+      ", about to finish in group %p", GST_TIME_ARGS (position),
+      GST_TIME_ARGS (threshold), GST_TIME_ARGS (duration), group);
+
+  emit_about_to_finish (playbin, group);
+
+  return GST_PAD_PROBE_OK;
+}
+
 static GstPadProbeReturn
 _uridecodebin_event_probe (GstPad * pad, GstPadProbeInfo * info, gpointer udata)
 {
@@ -3292,6 +3413,7 @@ pad_added_cb (GstElement * decodebin, GstPad * pad, GstSourceGroup * group)
   gboolean changed = FALSE;
   GstElement *custom_combiner = NULL;
   gulong group_id_probe_handler;
+  gulong buffer_probe_handler;
 
   playbin = group->playbin;
 
@@ -3480,6 +3602,15 @@ pad_added_cb (GstElement * decodebin, GstPad * pad, GstSourceGroup * group)
   g_object_set_data (G_OBJECT (pad), "playbin.event_probe_id",
       ULONG_TO_POINTER (group_id_probe_handler));
 
+  /* track the position of the main uri for an early about-to-finish */
+  if (decodebin == group->uridecodebin) {
+    buffer_probe_handler =
+        gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+        _uridecodebin_buffer_probe, group, NULL);
+    g_object_set_data (G_OBJECT (pad), "playbin.buffer_probe_id",
+        ULONG_TO_POINTER (buffer_probe_handler));
+  }
+
   if (changed) {
     int signal;
 
@@ -3557,6 +3688,7 @@ pad_removed_cb (GstElement * decodebin, GstPad * pad, GstSourceGroup * group)
   GstSourceCombine *combine;
   int signal = -1;
   gulong group_id_probe_handler;
+  gulong buffer_probe_handler;
 
   playbin = group->playbin;
 
@@ -3572,6 +3704,13 @@ pad_removed_cb (GstElement * decodebin, GstPad * pad, GstSourceGroup * group)
     g_object_set_data (G_OBJECT (pad), "playbin.event_probe_id", NULL);
   }
 
+  if ((buffer_probe_handler =
+          POINTER_TO_ULONG (g_object_get_data (G_OBJECT (pad),
+                  "playbin.buffer_probe_id")))) {
+    gst_pad_remove_probe (pad, buffer_probe_handler);
+    g_object_set_data (G_OBJECT (pad), "playbin.buffer_probe_id", NULL);
+  }
+
   if ((combine = g_object_get_data (G_OBJECT (pad), "playbin.combine"))) {
     g_assert (combine->combiner == NULL);
     g_assert (combine->srcpad == pad);
@@ -3830,9 +3969,11 @@ drained_cb (GstElement * decodebin, GstSourceGroup * group)
 
   GST_DEBUG_OBJECT (playbin, "about to finish in group %p", group);
 
-  /* after this call, we should have a next group to activate or we EOS */
-  g_signal_emit (G_OBJECT (playbin),
-      gst_play_bin_signals[SIGNAL_ABOUT_TO_FINISH], 0, NULL);
+  /* after this call, we should have a next group to activate or we EOS. When
+   * the signal was already emitted before the end because of the
+   * about-to-finish-threshold, the application already had its chance */
+  if (!emit_about_to_finish (playbin, group))
+    GST_DEBUG_OBJECT (playbin, "about-to-finish was already emitted");
 
   /* now activate the next group. If the app did not set a uri, this will
    * fail and we can do EOS */
@@ -5176,6 +5317,10 @@ activate_group (GstPlayBin * playbin, GstSourceGroup * group, GstState target)
 
   GST_SOURCE_GROUP_LOCK (group);
 
+  g_atomic_int_set (&group->about_to_finish_emitted, 0);
+  group->duration = GST_CLOCK_TIME_NONE;
+  group->duration_queried = FALSE;
+
   /* First set up the custom sources */
   if (playbin->audio_sink)
     group->audio_sink = gst_object_ref (playbin->audio_sink);
@@ -183,6 +183,8 @@ enum
 #define DEFAULT_USE_BUFFERING       FALSE
 #define DEFAULT_EXPOSE_ALL_STREAMS  TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
+/* hard limit for stream buffering when buffering by time, 2s of 64Mbit/s */
+#define DEFAULT_STREAM_MAX_BYTES    (16 * 1024 * 1024)
 
 enum
 {
@@ -1969,6 +1971,11 @@ type_found (GstElement * typefind, guint probability,
           decoder->ring_buffer_max_size, NULL);
       /* Disable max-size-buffers */
       g_object_set (queue, "max-size-buffers", 0, NULL);
+      /* Buffer the same amount of time for low and high bitrate streams,
+       * the byte size then only acts as a hard limit unless configured */
+      g_object_set (queue, "use-bitrate-estimate", TRUE, NULL);
+      if (decoder->buffer_size == -1)
+        g_object_set (queue, "max-size-bytes", DEFAULT_STREAM_MAX_BYTES, NULL);
     }
 
     /* If buffer size or duration are set, set them on the element */
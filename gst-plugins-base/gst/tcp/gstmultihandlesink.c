@@ -1706,14 +1706,14 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
   /* then loop over the clients and update the positions */
   max_buffer_usage = 0;
 
+  g_get_current_time (&nowtv);
+  now = GST_TIMEVAL_TO_TIME (nowtv);
+
 restart:
   cookie = mhsink->clients_cookie;
   for (clients = mhsink->clients; clients; clients = next) {
     GstMultiHandleClient *mhclient = clients->data;
 
-    g_get_current_time (&nowtv);
-    now = GST_TIMEVAL_TO_TIME (nowtv);
-
     if (cookie != mhsink->clients_cookie) {
       GST_DEBUG_OBJECT (sink, "Clients cookie outdated, restarting");
       goto restart;
@@ -104,8 +104,10 @@
 
 #include <gst/gst-i18n-plugin.h>
 #include <gst/net/gstnetcontrolmessagemeta.h>
+#include <gst/allocators/gstfdmemory.h>
 
 #include <string.h>
+#include <errno.h>
 
 #include "gstmultisocketsink.h"
 
@@ -113,6 +115,10 @@
 #include <netinet/in.h>
 #endif
 
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+
 #define NOT_IMPLEMENTED 0
 
 GST_DEBUG_CATEGORY_STATIC (multisocketsink_debug);
@@ -773,6 +779,60 @@ gst_buffer_get_cmsg_list (GstBuffer * buf, GSocketControlMessage ** msgs,
 
 #define CMSG_MAX 255
 
+#ifdef HAVE_SYS_SENDFILE_H
+/* Send the memory of @buffer at @bufoffset with sendfile() when it is backed
+ * by a file descriptor, this avoids mapping it and copying the data through
+ * userspace. Returns FALSE when the memory can't be sent like this and the
+ * regular path should be used. Only the one memory is sent, the caller will
+ * treat this as a partial write when there is more. */
+static gboolean
+gst_multi_socket_sink_write_fd (GstMultiSocketSink * sink,
+    GSocket * sock, GstBuffer * buffer, gsize bufoffset, gssize * wrote,
+    GError ** err)
+{
+  GstMemory *mem;
+  guint idx, len;
+  gsize skip;
+  off_t offset;
+  ssize_t res;
+
+  if (!gst_buffer_find_memory (buffer, bufoffset, 1, &idx, &len, &skip))
+    return FALSE;
+
+  mem = gst_buffer_peek_memory (buffer, idx);
+  if (!gst_is_fd_memory (mem))
+    return FALSE;
+
+  offset = mem->offset + skip;
+  do {
+    res = sendfile (g_socket_get_fd (sock), gst_fd_memory_get_fd (mem),
+        &offset, mem->size - skip);
+  } while (res < 0 && errno == EINTR);
+
+  if (res < 0) {
+    gint errsv = errno;
+
+    /* not all kinds of fds can be sent from (dmabuf for example), use the
+     * mapped memory for those */
+    if (errsv == EINVAL || errsv == ENOSYS) {
+      GST_LOG_OBJECT (sink, "can't sendfile from fd %d: %s",
+          gst_fd_memory_get_fd (mem), g_strerror (errsv));
+      return FALSE;
+    }
+    g_set_error (err, G_IO_ERROR, g_io_error_from_errno (errsv),
+        "Error sending data: %s", g_strerror (errsv));
+    *wrote = -1;
+    return TRUE;
+  }
+
+  GST_LOG_OBJECT (sink, "sent %" G_GSSIZE_FORMAT " bytes from fd %d", res,
+      gst_fd_memory_get_fd (mem));
+  *wrote = res;
+
+  return TRUE;
+}
+#endif
+
 static gssize
 gst_multi_socket_sink_write (GstMultiSocketSink * sink,
     GSocket * sock, GstBuffer * buffer, gsize bufoffset,
@@ -785,10 +845,18 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
   GSocketControlMessage *cmsgs[CMSG_MAX];
   gsize msg_count;
 
-  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
-
   msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
 
+#ifdef HAVE_SYS_SENDFILE_H
+  /* control messages need sendmsg(), only try without */
+  if (msg_count == 0 &&
+      gst_multi_socket_sink_write_fd (sink, sock, buffer, bufoffset, &wrote,
+          err))
+    return wrote;
+#endif
+
+  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
+
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
       cancellable, err);
@@ -796,6 +864,114 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
   return wrote;
 }
 
+/* maximum number of vectors and buffers written with one sendmsg() */
+#define BATCH_MAX_VECTORS 64
+#define BATCH_MAX_BUFFERS 16
+
+/* buffers with control messages need their own sendmsg(), and file backed
+ * ones are sent with sendfile() */
+static gboolean
+gst_multi_socket_sink_can_batch (GstBuffer * buf)
+{
+  if (gst_buffer_get_meta (buf, GST_NET_CONTROL_MESSAGE_META_API_TYPE))
+    return FALSE;
+#ifdef HAVE_SYS_SENDFILE_H
+  if (gst_buffer_n_memory (buf) > 0 &&
+      gst_is_fd_memory (gst_buffer_peek_memory (buf, 0)))
+    return FALSE;
+#endif
+  return TRUE;
+}
+
+/* Write the pending buffers in @sending, the first one starting at
+ * @bufoffset, with one sendmsg() call. This is only done for stream sockets,
+ * where the buffer boundaries are not preserved anyway. @n_buffers is set to
+ * the number of buffers that were part of the write. */
+static gssize
+gst_multi_socket_sink_write_batch (GstMultiSocketSink * sink,
+    GSocket * sock, GSList * sending, gsize bufoffset, guint * n_buffers,
+    GCancellable * cancellable, GError ** err)
+{
+  GstMapInfo maps[BATCH_MAX_VECTORS];
+  GOutputVector vec[BATCH_MAX_VECTORS];
+  guint n_vec = 0, n_bufs = 0;
+  gssize wrote;
+  GSList *walk;
+
+  if (sending->next == NULL ||
+      g_socket_get_socket_type (sock) != G_SOCKET_TYPE_STREAM ||
+      !gst_multi_socket_sink_can_batch (sending->data)) {
+    *n_buffers = 1;
+    return gst_multi_socket_sink_write (sink, sock, sending->data, bufoffset,
+        cancellable, err);
+  }
+
+  for (walk = sending; walk && n_bufs < BATCH_MAX_BUFFERS; walk = walk->next) {
+    GstBuffer *buf = walk->data;
+    gsize offset = n_bufs == 0 ? bufoffset : 0;
+    gsize size = gst_buffer_get_size (buf);
+
+    if (!gst_multi_socket_sink_can_batch (buf))
+      break;
+
+    if (offset < size) {
+      /* only add buffers that fit completely, except for the first one */
+      if (n_bufs > 0 &&
+          n_vec + gst_buffer_n_memory (buf) > BATCH_MAX_VECTORS)
+        break;
+      n_vec += map_n_memory_output_vector (buf, offset, vec + n_vec,
+          maps + n_vec, BATCH_MAX_VECTORS - n_vec);
+    }
+    n_bufs++;
+  }
+
+  GST_LOG_OBJECT (sink, "writing %u buffers in %u vectors", n_bufs, n_vec);
+
+  *n_buffers = n_bufs;
+  if (n_vec == 0)
+    return 0;
+
+  wrote = g_socket_send_message (sock, NULL, vec, n_vec, NULL, 0, 0,
+      cancellable, err);
+  unmap_n_memorys (maps, n_vec);
+
+  return wrote;
+}
+
+/* take the next buffer for @mhclient from the global queue and queue it for
+ * sending */
+static void
+gst_multi_socket_sink_client_take_buffer (GstMultiSocketSink * sink,
+    GstMultiHandleClient * mhclient)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  GstBuffer *buf;
+  GstClockTime timestamp;
+
+  /* grab buffer */
+  buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
+  mhclient->bufpos--;
+
+  /* update stats */
+  timestamp = GST_BUFFER_TIMESTAMP (buf);
+  if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
+    mhclient->first_buffer_ts = timestamp;
+  if (timestamp != -1)
+    mhclient->last_buffer_ts = timestamp;
+
+  /* decrease flushcount */
+  if (mhclient->flushcount != -1)
+    mhclient->flushcount--;
+
+  GST_LOG_OBJECT (sink, "%s client %p at position %d",
+      mhclient->debug, mhclient, mhclient->bufpos);
+
+  /* queueing a buffer will ref it */
+  mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+}
+
 /* Handle a write on a client,
  * which indicates a read request from a client.
  *
@@ -813,6 +989,10 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
  * sent. When the buffer is completely sent, it is removed from the
  * mhclient->sending queue and we try to pick a new buffer for sending.
  *
+ * For stream sockets, the buffers that are already available in the global
+ * queue are moved to the mhclient->sending queue as well, so that they can be
+ * written together with one sendmsg() call.
+ *
  * When the sending returns a partial buffer we stop sending more data as
  * the next send operation could block.
  *
@@ -827,16 +1007,16 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   GstClockTime now;
   GTimeVal nowtv;
   GError *err = NULL;
+  gboolean batch;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
-
 
   g_get_current_time (&nowtv);
   now = GST_TIMEVAL_TO_TIME (nowtv);
 
   flushing = mhclient->status == GST_CLIENT_STATUS_FLUSHING;
+  batch = g_socket_get_socket_type (mhclient->handle.socket) ==
+      G_SOCKET_TYPE_STREAM;
 
   more = TRUE;
   do {
@@ -854,8 +1034,6 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         return TRUE;
       } else {
         /* client can pick a buffer from the global queue */
-        GstBuffer *buf;
-        GstClockTime timestamp;
 
         /* for new connections, we need to find a good spot in the
          * bufqueue to start streaming from */
@@ -878,42 +1056,33 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         if (mhclient->flushcount == 0)
           goto flushed;
 
-        /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
-
-        /* update stats */
-        timestamp = GST_BUFFER_TIMESTAMP (buf);
-        if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
-          mhclient->first_buffer_ts = timestamp;
-        if (timestamp != -1)
-          mhclient->last_buffer_ts = timestamp;
-
-        /* decrease flushcount */
-        if (mhclient->flushcount != -1)
-          mhclient->flushcount--;
-
-        GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
-
-        /* queueing a buffer will ref it */
-        mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+        gst_multi_socket_sink_client_take_buffer (sink, mhclient);
 
         /* need to start from the first byte for this new buffer */
         mhclient->bufoffset = 0;
       }
     }
 
+    /* queue the other available buffers so they can be written at once */
+    if (batch && mhclient->sending && !mhclient->new_connection) {
+      guint queued = g_slist_length (mhclient->sending);
+
+      while (queued < BATCH_MAX_BUFFERS && mhclient->bufpos >= 0 &&
+          mhclient->flushcount != 0) {
+        gst_multi_socket_sink_client_take_buffer (sink, mhclient);
+        queued++;
+      }
+    }
+
     /* see if we need to send something */
     if (mhclient->sending) {
       gssize wrote;
       GstBuffer *head;
+      guint n_buffers;
 
-      /* pick first buffer from list */
-      head = GST_BUFFER (mhclient->sending->data);
-
-      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
-          mhclient->bufoffset, sink->cancellable, &err);
+      wrote = gst_multi_socket_sink_write_batch (sink,
+          mhclient->handle.socket, mhclient->sending, mhclient->bufoffset,
+          &n_buffers, sink->cancellable, &err);
 
       if (wrote < 0) {
         /* hmm error.. */
@@ -929,13 +1098,26 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           goto write_error;
         }
       } else {
-        if (wrote < (gst_buffer_get_size (head) - mhclient->bufoffset)) {
-          /* partial write, try again now */
-          GST_LOG_OBJECT (sink,
-              "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
-              mhclient->handle.socket, wrote);
-          mhclient->bufoffset += wrote;
-        } else {
+        gsize left = wrote;
+
+        /* remove the buffers that were written completely */
+        while (n_buffers--) {
+          gsize size;
+
+          /* pick first buffer from list */
+          head = GST_BUFFER (mhclient->sending->data);
+          size = gst_buffer_get_size (head) - mhclient->bufoffset;
+
+          if (left < size) {
+            /* partial write, try again now */
+            GST_LOG_OBJECT (sink,
+                "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
+                mhclient->handle.socket, wrote);
+            mhclient->bufoffset += left;
+            break;
+          }
+          left -= size;
+
           if (sink->send_dispatched) {
             gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
                 gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
@@ -57,6 +57,8 @@ GST_DEBUG_CATEGORY_STATIC (socketsrc_debug);
 #define GST_CAT_DEFAULT socketsrc_debug
 
 #define MAX_READ_SIZE                   4 * 1024
+/* upper bound of chunks read per wakeup in chunked mode */
+#define MAX_READ_CHUNKS                 64
 
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
@@ -66,13 +68,15 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
 
 
 #define DEFAULT_SEND_MESSAGES FALSE
+#define DEFAULT_CHUNK_SIZE 0
 
 enum
 {
   PROP_0,
   PROP_SOCKET,
   PROP_CAPS,
-  PROP_SEND_MESSAGES
+  PROP_SEND_MESSAGES,
+  PROP_CHUNK_SIZE
 };
 
 enum
@@ -91,8 +95,11 @@ static void gst_socket_src_finalize (GObject * gobject);
 
 static GstCaps *gst_socketsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_socketsrc_event (GstBaseSrc * src, GstEvent * event);
+static GstFlowReturn gst_socket_src_create (GstPushSrc * psrc,
+    GstBuffer ** outbuf);
 static GstFlowReturn gst_socket_src_fill (GstPushSrc * psrc,
     GstBuffer * outbuf);
+static gboolean gst_socket_src_stop (GstBaseSrc * bsrc);
 static gboolean gst_socket_src_unlock (GstBaseSrc * bsrc);
 static gboolean gst_socket_src_unlock_stop (GstBaseSrc * bsrc);
 
@@ -148,6 +155,22 @@ gst_socket_src_class_init (GstSocketSrcClass * klass)
           "If GstNetworkMessage events should be handled",
           DEFAULT_SEND_MESSAGES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSocketSrc:chunk-size:
+   *
+   * When non-zero, data is read into recycled buffers of this size from an
+   * internal buffer pool. All data that is available on the socket when it
+   * becomes readable is read at once and pushed downstream as a buffer list.
+   * 0 reads one buffer of #GstBaseSrc:blocksize per push.
+   *
+   * Since: 1.10
+   **/
+  g_object_class_install_property (gobject_class, PROP_CHUNK_SIZE,
+      g_param_spec_uint ("chunk-size", "Chunk Size",
+          "Size of the pooled buffers to read available data into and push "
+          "as a buffer list (0 = one buffer per read)", 0, G_MAXINT,
+          DEFAULT_CHUNK_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_socket_src_signals[CONNECTION_CLOSED_BY_PEER] =
       g_signal_new ("connection-closed-by-peer", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_FIRST, G_STRUCT_OFFSET (GstSocketSrcClass,
@@ -165,7 +188,9 @@ gst_socket_src_class_init (GstSocketSrcClass * klass)
   gstbasesrc_class->get_caps = gst_socketsrc_getcaps;
   gstbasesrc_class->unlock = gst_socket_src_unlock;
   gstbasesrc_class->unlock_stop = gst_socket_src_unlock_stop;
+  gstbasesrc_class->stop = gst_socket_src_stop;
 
+  gstpush_src_class->create = gst_socket_src_create;
   gstpush_src_class->fill = gst_socket_src_fill;
 
   GST_DEBUG_CATEGORY_INIT (socketsrc_debug, "socketsrc", 0, "Socket Source");
@@ -177,6 +202,7 @@ gst_socket_src_init (GstSocketSrc * this)
   this->socket = NULL;
   this->cancellable = g_cancellable_new ();
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->chunk_size = DEFAULT_CHUNK_SIZE;
 }
 
 static void
@@ -382,6 +408,149 @@ no_socket:
   }
 }
 
+static GstBufferPool *
+gst_socket_src_create_pool (GstSocketSrc * src, guint size)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocator *allocator;
+  GstAllocationParams params;
+
+  gst_base_src_get_allocator (GST_BASE_SRC (src), &allocator, &params);
+
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+  gst_buffer_pool_config_set_allocator (config, allocator, &params);
+  if (allocator)
+    gst_object_unref (allocator);
+
+  if (!gst_buffer_pool_set_config (pool, config) ||
+      !gst_buffer_pool_set_active (pool, TRUE)) {
+    gst_object_unref (pool);
+    return NULL;
+  }
+
+  GST_DEBUG_OBJECT (src, "created pool of %u byte buffers", size);
+
+  return pool;
+}
+
+static void
+gst_socket_src_free_pool (GstSocketSrc * src)
+{
+  if (src->pool) {
+    gst_buffer_pool_set_active (src->pool, FALSE);
+    gst_object_unref (src->pool);
+    src->pool = NULL;
+  }
+}
+
+static GstFlowReturn
+gst_socket_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
+{
+  GstSocketSrc *src;
+  GstBaseSrc *bsrc;
+  GstFlowReturn ret;
+  GstBufferList *list;
+  GstBuffer *buf;
+  GSocket *socket;
+  guint chunk_size;
+  gssize avail;
+
+  src = GST_SOCKET_SRC (psrc);
+  bsrc = GST_BASE_SRC (psrc);
+
+  chunk_size = src->chunk_size;
+
+  if (chunk_size == 0) {
+    /* what the base class does when there is no create function */
+    ret = GST_BASE_SRC_GET_CLASS (bsrc)->alloc (bsrc, -1,
+        gst_base_src_get_blocksize (bsrc), outbuf);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      return ret;
+
+    ret = gst_socket_src_fill (psrc, *outbuf);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      gst_buffer_replace (outbuf, NULL);
+
+    return ret;
+  }
+
+  if (src->pool && src->pool_size != chunk_size)
+    gst_socket_src_free_pool (src);
+  if (src->pool == NULL) {
+    if (!(src->pool = gst_socket_src_create_pool (src, chunk_size)))
+      goto no_pool;
+    src->pool_size = chunk_size;
+  }
+
+  /* block for the first chunk, this also takes care of EOS and errors */
+  ret = gst_buffer_pool_acquire_buffer (src->pool, &buf, NULL);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    return ret;
+
+  ret = gst_socket_src_fill (psrc, buf);
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    gst_buffer_unref (buf);
+    return ret;
+  }
+
+  GST_OBJECT_LOCK (src);
+  socket = src->socket ? g_object_ref (src->socket) : NULL;
+  GST_OBJECT_UNLOCK (src);
+
+  /* then drain whatever else is available without blocking */
+  list = NULL;
+  while (socket && (avail = g_socket_get_available_bytes (socket)) > 0) {
+    if (list == NULL) {
+      list = gst_buffer_list_new_sized (MIN (MAX_READ_CHUNKS,
+              1 + (avail + chunk_size - 1) / chunk_size));
+      gst_buffer_list_add (list, buf);
+    } else if (gst_buffer_list_length (list) >= MAX_READ_CHUNKS) {
+      break;
+    }
+
+    ret = gst_buffer_pool_acquire_buffer (src->pool, &buf, NULL);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      break;
+
+    ret = gst_socket_src_fill (psrc, buf);
+    if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+      gst_buffer_unref (buf);
+      break;
+    }
+    gst_buffer_list_add (list, buf);
+  }
+  g_clear_object (&socket);
+
+  if (list == NULL) {
+    *outbuf = buf;
+    return ret;
+  }
+
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    gst_buffer_list_unref (list);
+    return ret;
+  }
+
+  GST_LOG_OBJECT (src, "pushing list of %u buffers",
+      gst_buffer_list_length (list));
+
+  /* the base class timestamps the first buffer of the list */
+  gst_base_src_submit_buffer_list (bsrc, list);
+  *outbuf = NULL;
+
+  return GST_FLOW_OK;
+
+no_pool:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, NO_SPACE_LEFT, (NULL),
+        ("Failed to create a pool of %u byte buffers", chunk_size));
+    return GST_FLOW_ERROR;
+  }
+}
+
 static void
 gst_socket_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -423,6 +592,9 @@ gst_socket_src_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       socketsrc->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_CHUNK_SIZE:
+      socketsrc->chunk_size = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -447,12 +619,25 @@ gst_socket_src_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, socketsrc->send_messages);
       break;
+    case PROP_CHUNK_SIZE:
+      g_value_set_uint (value, socketsrc->chunk_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+static gboolean
+gst_socket_src_stop (GstBaseSrc * bsrc)
+{
+  GstSocketSrc *src = GST_SOCKET_SRC (bsrc);
+
+  gst_socket_src_free_pool (src);
+
+  return TRUE;
+}
+
 static gboolean
 gst_socket_src_unlock (GstBaseSrc * bsrc)
 {
@@ -52,6 +52,10 @@ struct _GstSocketSrc {
   GSocket *socket;
   gboolean send_messages;
   GCancellable *cancellable;
+
+  guint chunk_size;
+  GstBufferPool *pool;
+  guint pool_size;
 };
 
 struct _GstSocketSrcClass {
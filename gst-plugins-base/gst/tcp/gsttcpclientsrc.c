@@ -47,6 +47,10 @@ GST_DEBUG_CATEGORY_STATIC (tcpclientsrc_debug);
 #define GST_CAT_DEFAULT tcpclientsrc_debug
 
 #define MAX_READ_SIZE                   4 * 1024
+/* upper bound of chunks read per wakeup in chunked mode */
+#define MAX_READ_CHUNKS                 64
+
+#define DEFAULT_CHUNK_SIZE              0
 
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
@@ -59,7 +63,8 @@ enum
 {
   PROP_0,
   PROP_HOST,
-  PROP_PORT
+  PROP_PORT,
+  PROP_CHUNK_SIZE
 };
 
 #define gst_tcp_client_src_parent_class parent_class
@@ -109,6 +114,22 @@ gst_tcp_client_src_class_init (GstTCPClientSrcClass * klass)
           TCP_HIGHEST_PORT, TCP_DEFAULT_PORT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTCPClientSrc:chunk-size:
+   *
+   * When non-zero, data is read into recycled buffers of this size from an
+   * internal buffer pool. All data that is available on the socket when it
+   * becomes readable is read at once and pushed downstream as a buffer list.
+   * 0 reads at most 4096 bytes into a new buffer per push.
+   *
+   * Since: 1.10
+   **/
+  g_object_class_install_property (gobject_class, PROP_CHUNK_SIZE,
+      g_param_spec_uint ("chunk-size", "Chunk Size",
+          "Size of the pooled buffers to read available data into and push "
+          "as a buffer list (0 = one buffer per read)", 0, G_MAXINT,
+          DEFAULT_CHUNK_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -133,6 +154,7 @@ gst_tcp_client_src_init (GstTCPClientSrc * this)
 {
   this->port = TCP_DEFAULT_PORT;
   this->host = g_strdup (TCP_DEFAULT_HOST);
+  this->chunk_size = DEFAULT_CHUNK_SIZE;
   this->socket = NULL;
   this->cancellable = g_cancellable_new ();
 
@@ -171,6 +193,135 @@ gst_tcp_client_src_getcaps (GstBaseSrc * bsrc, GstCaps * filter)
   return caps;
 }
 
+static GstBufferPool *
+gst_tcp_client_src_create_pool (GstTCPClientSrc * src, guint size)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocator *allocator;
+  GstAllocationParams params;
+
+  gst_base_src_get_allocator (GST_BASE_SRC (src), &allocator, &params);
+
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+  gst_buffer_pool_config_set_allocator (config, allocator, &params);
+  if (allocator)
+    gst_object_unref (allocator);
+
+  if (!gst_buffer_pool_set_config (pool, config) ||
+      !gst_buffer_pool_set_active (pool, TRUE)) {
+    gst_object_unref (pool);
+    return NULL;
+  }
+
+  GST_DEBUG_OBJECT (src, "created pool of %u byte buffers", size);
+
+  return pool;
+}
+
+static void
+gst_tcp_client_src_free_pool (GstTCPClientSrc * src)
+{
+  if (src->pool) {
+    gst_buffer_pool_set_active (src->pool, FALSE);
+    gst_object_unref (src->pool);
+    src->pool = NULL;
+  }
+}
+
+/* reads @avail bytes, and whatever arrives meanwhile, into pooled buffers of
+ * @chunk_size and returns them as a single buffer or submits them as a list */
+static GstFlowReturn
+gst_tcp_client_src_read_chunks (GstTCPClientSrc * src, guint chunk_size,
+    gssize avail, GstBuffer ** outbuf)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBufferList *list;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GError *err = NULL;
+  gssize rret;
+
+  if (src->pool && src->pool_size != chunk_size)
+    gst_tcp_client_src_free_pool (src);
+  if (src->pool == NULL) {
+    if (!(src->pool = gst_tcp_client_src_create_pool (src, chunk_size)))
+      goto no_pool;
+    src->pool_size = chunk_size;
+  }
+
+  list = gst_buffer_list_new_sized (MIN (MAX_READ_CHUNKS,
+          (avail + chunk_size - 1) / chunk_size));
+
+  while (avail > 0 && gst_buffer_list_length (list) < MAX_READ_CHUNKS) {
+    ret = gst_buffer_pool_acquire_buffer (src->pool, &buf, NULL);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      break;
+
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    rret = g_socket_receive (src->socket, (gchar *) map.data,
+        MIN (avail, map.size), src->cancellable, &err);
+    gst_buffer_unmap (buf, &map);
+
+    if (rret == 0) {
+      GST_DEBUG_OBJECT (src, "Connection closed");
+      gst_buffer_unref (buf);
+      ret = GST_FLOW_EOS;
+      break;
+    } else if (rret < 0) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        ret = GST_FLOW_FLUSHING;
+        GST_DEBUG_OBJECT (src, "Cancelled reading from socket");
+      } else {
+        ret = GST_FLOW_ERROR;
+        GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+            ("Failed to read from socket: %s", err->message));
+      }
+      g_clear_error (&err);
+      gst_buffer_unref (buf);
+      break;
+    }
+
+    gst_buffer_resize (buf, 0, rret);
+    gst_buffer_list_add (list, buf);
+
+    avail -= rret;
+    if (avail <= 0)
+      avail = g_socket_get_available_bytes (src->socket);
+  }
+
+  /* data read before the connection was closed is still pushed, the next
+   * read will notice the EOS again */
+  if (gst_buffer_list_length (list) > 0 && ret == GST_FLOW_EOS)
+    ret = GST_FLOW_OK;
+
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_list_unref (list);
+    *outbuf = NULL;
+  } else if (gst_buffer_list_length (list) == 1) {
+    *outbuf = gst_buffer_ref (gst_buffer_list_get (list, 0));
+    gst_buffer_list_unref (list);
+  } else {
+    GST_LOG_OBJECT (src, "pushing list of %u buffers",
+        gst_buffer_list_length (list));
+
+    /* the base class timestamps the first buffer of the list */
+    gst_base_src_submit_buffer_list (GST_BASE_SRC (src), list);
+    *outbuf = NULL;
+  }
+
+  return ret;
+
+no_pool:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, NO_SPACE_LEFT, (NULL),
+        ("Failed to create a pool of %u byte buffers", chunk_size));
+    return GST_FLOW_ERROR;
+  }
+}
+
 static GstFlowReturn
 gst_tcp_client_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
 {
@@ -220,7 +371,10 @@ gst_tcp_client_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
       goto get_available_error;
   }
 
-  if (avail > 0) {
+  if (avail > 0 && src->chunk_size > 0) {
+    return gst_tcp_client_src_read_chunks (src, src->chunk_size, avail,
+        outbuf);
+  } else if (avail > 0) {
     read = MIN (avail, MAX_READ_SIZE);
     *outbuf = gst_buffer_new_and_alloc (read);
     gst_buffer_map (*outbuf, &map, GST_MAP_READWRITE);
@@ -317,6 +471,9 @@ gst_tcp_client_src_set_property (GObject * object, guint prop_id,
     case PROP_PORT:
       tcpclientsrc->port = g_value_get_int (value);
       break;
+    case PROP_CHUNK_SIZE:
+      tcpclientsrc->chunk_size = g_value_get_uint (value);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -337,6 +494,9 @@ gst_tcp_client_src_get_property (GObject * object, guint prop_id,
     case PROP_PORT:
       g_value_set_int (value, tcpclientsrc->port);
       break;
+    case PROP_CHUNK_SIZE:
+      g_value_set_uint (value, tcpclientsrc->chunk_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -460,6 +620,8 @@ gst_tcp_client_src_stop (GstBaseSrc * bsrc)
     src->socket = NULL;
   }
 
+  gst_tcp_client_src_free_pool (src);
+
   GST_OBJECT_FLAG_UNSET (src, GST_TCP_CLIENT_SRC_OPEN);
 
   return TRUE;
@@ -59,6 +59,10 @@ struct _GstTCPClientSrc {
   /* socket */
   GSocket *socket;
   GCancellable *cancellable;
+
+  guint chunk_size;
+  GstBufferPool *pool;
+  guint pool_size;
 };
 
 struct _GstTCPClientSrcClass {
@@ -91,6 +91,7 @@ enum
 #define DEFAULT_DROP_ONLY       FALSE
 #define DEFAULT_AVERAGE_PERIOD  0
 #define DEFAULT_MAX_RATE        G_MAXINT
+#define DEFAULT_GAP_DUPLICATES  FALSE
 
 enum
 {
@@ -104,7 +105,8 @@ enum
   PROP_SKIP_TO_FIRST,
   PROP_DROP_ONLY,
   PROP_AVERAGE_PERIOD,
-  PROP_MAX_RATE
+  PROP_MAX_RATE,
+  PROP_GAP_DUPLICATES
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -250,6 +252,21 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           1, G_MAXINT, DEFAULT_MAX_RATE,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:gap-duplicates:
+   *
+   * Instead of pushing a duplicate of the previous frame, push a GAP event
+   * covering the duplicated frame. Downstream elements that handle GAP events
+   * by repeating the previous frame, like constant rate encoders or muxers,
+   * then don't have to process the same frame again.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (object_class, PROP_GAP_DUPLICATES,
+      g_param_spec_boolean ("gap-duplicates", "GAP duplicates",
+          "Push GAP events instead of duplicated frames",
+          DEFAULT_GAP_DUPLICATES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -588,6 +605,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->average_period = DEFAULT_AVERAGE_PERIOD;
   videorate->average_period_set = DEFAULT_AVERAGE_PERIOD;
   videorate->max_rate = DEFAULT_MAX_RATE;
+  videorate->gap_duplicates = DEFAULT_GAP_DUPLICATES;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -603,31 +621,38 @@ gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate)
 {
   GstFlowReturn res;
   GstBuffer *outbuf;
-  GstClockTime push_ts;
+  GstClockTime push_ts, duration;
 
   if (!videorate->prevbuf)
     goto eos_before_buffers;
 
-  outbuf = gst_buffer_ref (videorate->prevbuf);
-  if (videorate->drop_only)
-    gst_buffer_replace (&videorate->prevbuf, NULL);
+  duration = GST_BUFFER_DURATION (videorate->prevbuf);
 
-  /* make sure we can write to the metadata */
-  outbuf = gst_buffer_make_writable (outbuf);
+  if (duplicate && videorate->gap_duplicates) {
+    outbuf = NULL;
+  } else {
+    outbuf = gst_buffer_ref (videorate->prevbuf);
+    if (videorate->drop_only)
+      gst_buffer_replace (&videorate->prevbuf, NULL);
 
-  GST_BUFFER_OFFSET (outbuf) = videorate->out;
-  GST_BUFFER_OFFSET_END (outbuf) = videorate->out + 1;
+    /* make sure we can write to the metadata, this only copies the buffer
+     * metadata, the memory of the frame is shared */
+    outbuf = gst_buffer_make_writable (outbuf);
 
-  if (videorate->discont) {
-    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
-    videorate->discont = FALSE;
-  } else
-    GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_DISCONT);
+    GST_BUFFER_OFFSET (outbuf) = videorate->out;
+    GST_BUFFER_OFFSET_END (outbuf) = videorate->out + 1;
 
-  if (duplicate)
-    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
-  else
-    GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+    if (videorate->discont) {
+      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
+      videorate->discont = FALSE;
+    } else
+      GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_DISCONT);
+
+    if (duplicate)
+      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
+    else
+      GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+  }
 
   /* this is the timestamp we put on the buffer */
   push_ts = videorate->next_ts;
@@ -641,9 +666,23 @@ gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate)
         videorate->base_ts + gst_util_uint64_scale (videorate->out_frame_count,
         videorate->to_rate_denominator * GST_SECOND,
         videorate->to_rate_numerator);
-    GST_BUFFER_DURATION (outbuf) = videorate->next_ts - push_ts;
-  } else if (GST_CLOCK_TIME_IS_VALID (GST_BUFFER_DURATION (outbuf))) {
-    videorate->next_ts = GST_BUFFER_PTS (outbuf) + GST_BUFFER_DURATION (outbuf);
+    duration = videorate->next_ts - push_ts;
+    if (outbuf)
+      GST_BUFFER_DURATION (outbuf) = duration;
+  } else if (GST_CLOCK_TIME_IS_VALID (duration)) {
+    videorate->next_ts =
+        GST_BUFFER_PTS (outbuf ? outbuf : videorate->prevbuf) + duration;
+  }
+
+  if (!outbuf) {
+    GST_LOG_OBJECT (videorate,
+        "old is best, dup, pushing gap outgoing ts %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (push_ts));
+
+    gst_pad_push_event (GST_BASE_TRANSFORM_SRC_PAD (videorate),
+        gst_event_new_gap (push_ts - videorate->segment.base, duration));
+
+    return GST_FLOW_OK;
   }
 
   /* We do not need to update time in VFR (variable frame rate) mode */
@@ -1328,6 +1367,9 @@ gst_video_rate_set_property (GObject * object,
     case PROP_MAX_RATE:
       g_atomic_int_set (&videorate->max_rate, g_value_get_int (value));
       goto reconfigure;
+    case PROP_GAP_DUPLICATES:
+      videorate->gap_duplicates = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1383,6 +1425,9 @@ gst_video_rate_get_property (GObject * object,
     case PROP_MAX_RATE:
       g_value_set_int (value, g_atomic_int_get (&videorate->max_rate));
       break;
+    case PROP_GAP_DUPLICATES:
+      g_value_set_boolean (value, videorate->gap_duplicates);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -78,6 +78,7 @@ struct _GstVideoRate
   gboolean skip_to_first;
   gboolean drop_only;
   guint64 average_period_set;
+  gboolean gap_duplicates;
 
   volatile int max_rate;
 };
@@ -53,6 +53,7 @@ GST_DEBUG_CATEGORY_STATIC (video_test_src_debug);
 #define DEFAULT_FOREGROUND_COLOR   0xffffffff
 #define DEFAULT_BACKGROUND_COLOR   0xff000000
 #define DEFAULT_HORIZONTAL_SPEED   0
+#define DEFAULT_CACHE_PATTERN      FALSE
 
 enum
 {
@@ -74,7 +75,8 @@ enum
   PROP_YOFFSET,
   PROP_FOREGROUND_COLOR,
   PROP_BACKGROUND_COLOR,
-  PROP_HORIZONTAL_SPEED
+  PROP_HORIZONTAL_SPEED,
+  PROP_CACHE_PATTERN
 };
 
 
@@ -115,6 +117,8 @@ static void gst_video_test_src_get_times (GstBaseSrc * basesrc,
     GstBuffer * buffer, GstClockTime * start, GstClockTime * end);
 static gboolean gst_video_test_src_decide_allocation (GstBaseSrc * bsrc,
     GstQuery * query);
+static GstFlowReturn gst_video_test_src_create (GstPushSrc * psrc,
+    GstBuffer ** buffer);
 static GstFlowReturn gst_video_test_src_fill (GstPushSrc * psrc,
     GstBuffer * buffer);
 static gboolean gst_video_test_src_start (GstBaseSrc * basesrc);
@@ -274,6 +278,21 @@ gst_video_test_src_class_init (GstVideoTestSrcClass * klass)
           "Scroll image number of pixels per frame (positive is scroll to the left)",
           G_MININT32, G_MAXINT32, DEFAULT_HORIZONTAL_SPEED,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstVideoTestSrc:cache-pattern
+   *
+   * Render patterns that don't change over time only once per caps and
+   * push references to that frame, only stamping new timestamps. This
+   * makes videotestsrc cheap enough to be used for load generation.
+   * Animated patterns are rendered for every frame as before. Note that
+   * the noise area of the SMPTE patterns is frozen when this is enabled.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_PATTERN,
+      g_param_spec_boolean ("cache-pattern", "Cache Pattern",
+          "Render static patterns only once and reuse the frame",
+          DEFAULT_CACHE_PATTERN, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_set_static_metadata (gstelement_class,
       "Video test source", "Source/Video",
@@ -292,6 +311,7 @@ gst_video_test_src_class_init (GstVideoTestSrcClass * klass)
   gstbasesrc_class->stop = gst_video_test_src_stop;
   gstbasesrc_class->decide_allocation = gst_video_test_src_decide_allocation;
 
+  gstpushsrc_class->create = gst_video_test_src_create;
   gstpushsrc_class->fill = gst_video_test_src_fill;
 }
 
@@ -304,6 +324,7 @@ gst_video_test_src_init (GstVideoTestSrc * src)
   src->foreground_color = DEFAULT_FOREGROUND_COLOR;
   src->background_color = DEFAULT_BACKGROUND_COLOR;
   src->horizontal_speed = DEFAULT_HORIZONTAL_SPEED;
+  src->cache_pattern = DEFAULT_CACHE_PATTERN;
 
   /* we operate in time */
   gst_base_src_set_format (GST_BASE_SRC (src), GST_FORMAT_TIME);
@@ -503,6 +524,41 @@ gst_video_test_src_set_pattern (GstVideoTestSrc * videotestsrc,
   }
 }
 
+static void
+gst_video_test_src_clear_cache (GstVideoTestSrc * src)
+{
+  GST_OBJECT_LOCK (src);
+  gst_buffer_replace (&src->cached_frame, NULL);
+  GST_OBJECT_UNLOCK (src);
+}
+
+/* whether the current pattern renders the same image for every frame */
+static gboolean
+gst_video_test_src_pattern_is_static (GstVideoTestSrc * src)
+{
+  if (src->horizontal_speed != 0)
+    return FALSE;
+
+  /* controlled properties change the image between frames */
+  if (gst_object_has_active_control_bindings (GST_OBJECT (src)))
+    return FALSE;
+
+  switch (src->pattern_type) {
+    case GST_VIDEO_TEST_SRC_SNOW:
+    case GST_VIDEO_TEST_SRC_BLINK:
+    case GST_VIDEO_TEST_SRC_BALL:
+      return FALSE;
+    case GST_VIDEO_TEST_SRC_ZONE_PLATE:
+    case GST_VIDEO_TEST_SRC_CHROMA_ZONE_PLATE:
+      return src->kt == 0 && src->kxt == 0 && src->kyt == 0 && src->kt2 == 0;
+    case GST_VIDEO_TEST_SRC_PINWHEEL:
+    case GST_VIDEO_TEST_SRC_SPOKES:
+      return src->kt == 0;
+    default:
+      return TRUE;
+  }
+}
+
 static void
 gst_video_test_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -564,9 +620,15 @@ gst_video_test_src_set_property (GObject * object, guint prop_id,
     case PROP_HORIZONTAL_SPEED:
       src->horizontal_speed = g_value_get_int (value);
       break;
+    case PROP_CACHE_PATTERN:
+      src->cache_pattern = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
+
+  /* any property can change the rendered image */
+  gst_video_test_src_clear_cache (src);
 }
 
 static void
@@ -630,6 +692,9 @@ gst_video_test_src_get_property (GObject * object, guint prop_id,
     case PROP_HORIZONTAL_SPEED:
       g_value_set_int (value, src->horizontal_speed);
       break;
+    case PROP_CACHE_PATTERN:
+      g_value_set_boolean (value, src->cache_pattern);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -788,6 +853,8 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
     goto unsupported_caps;
   }
 
+  gst_video_test_src_clear_cache (videotestsrc);
+
   /* create chroma subsampler */
   if (videotestsrc->subsample)
     gst_video_chroma_resample_free (videotestsrc->subsample);
@@ -983,17 +1050,17 @@ gst_video_test_src_is_seekable (GstBaseSrc * psrc)
   return TRUE;
 }
 
+/* renders the next frame into @buffer if @render is TRUE, and stamps the
+ * timestamps and offsets of the next frame on it in any case */
 static GstFlowReturn
-gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
+gst_video_test_src_produce (GstVideoTestSrc * src, GstBuffer * buffer,
+    gboolean render)
 {
-  GstVideoTestSrc *src;
   GstClockTime next_time;
   GstVideoFrame frame;
   gconstpointer pal;
   gsize palsize;
 
-  src = GST_VIDEO_TEST_SRC (psrc);
-
   if (G_UNLIKELY (GST_VIDEO_INFO_FORMAT (&src->info) ==
           GST_VIDEO_FORMAT_UNKNOWN))
     goto not_negotiated;
@@ -1007,26 +1074,30 @@ gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
     goto eos;
   }
 
-  GST_LOG_OBJECT (src,
-      "creating buffer from pool for frame %d", (gint) src->n_frames);
-
-  if (!gst_video_frame_map (&frame, &src->info, buffer, GST_MAP_WRITE))
-    goto invalid_frame;
-
   GST_BUFFER_PTS (buffer) =
       src->accum_rtime + src->timestamp_offset + src->running_time;
   GST_BUFFER_DTS (buffer) = GST_CLOCK_TIME_NONE;
 
-  gst_object_sync_values (GST_OBJECT (psrc), GST_BUFFER_PTS (buffer));
+  if (render) {
+    GST_LOG_OBJECT (src, "rendering frame %d", (gint) src->n_frames);
 
-  src->make_image (src, &frame);
+    if (!gst_video_frame_map (&frame, &src->info, buffer, GST_MAP_WRITE))
+      goto invalid_frame;
 
-  if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
-              &palsize))) {
-    memcpy (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1), pal, palsize);
-  }
+    gst_object_sync_values (GST_OBJECT (src), GST_BUFFER_PTS (buffer));
 
-  gst_video_frame_unmap (&frame);
+    src->make_image (src, &frame);
+
+    if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
+                &palsize))) {
+      memcpy (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1), pal, palsize);
+    }
+
+    gst_video_frame_unmap (&frame);
+  } else {
+    GST_LOG_OBJECT (src, "reusing cached frame for frame %d",
+        (gint) src->n_frames);
+  }
 
   GST_DEBUG_OBJECT (src, "Timestamp: %" GST_TIME_FORMAT " = accumulated %"
       GST_TIME_FORMAT " + offset: %"
@@ -1075,6 +1146,69 @@ invalid_frame:
   }
 }
 
+static GstFlowReturn
+gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
+{
+  return gst_video_test_src_produce (GST_VIDEO_TEST_SRC (psrc), buffer, TRUE);
+}
+
+static GstFlowReturn
+gst_video_test_src_create (GstPushSrc * psrc, GstBuffer ** buffer)
+{
+  GstVideoTestSrc *src = GST_VIDEO_TEST_SRC (psrc);
+  GstBaseSrc *bsrc = GST_BASE_SRC (psrc);
+  GstBuffer *buf = NULL;
+  GstFlowReturn ret;
+
+  if (!src->cache_pattern || !gst_video_test_src_pattern_is_static (src)) {
+    ret = GST_BASE_SRC_GET_CLASS (bsrc)->alloc (bsrc, -1,
+        gst_base_src_get_blocksize (bsrc), &buf);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      return ret;
+
+    ret = gst_video_test_src_produce (src, buf, TRUE);
+    goto done;
+  }
+
+  GST_OBJECT_LOCK (src);
+  if (src->cached_frame)
+    buf = gst_buffer_copy (src->cached_frame);
+  GST_OBJECT_UNLOCK (src);
+
+  if (buf) {
+    /* the copy shares the memory of the cached frame, only the metadata
+     * is new */
+    ret = gst_video_test_src_produce (src, buf, FALSE);
+    goto done;
+  }
+
+  /* the cached frame is not allocated from the pool as it is kept around
+   * until the caps or properties change, downstream only ever gets copies
+   * that share its memory */
+  buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&src->info), NULL);
+  ret = gst_video_test_src_produce (src, buf, TRUE);
+  if (ret == GST_FLOW_OK) {
+    GstBuffer *cached = buf;
+
+    GST_DEBUG_OBJECT (src, "caching frame of pattern %d", src->pattern_type);
+    GST_OBJECT_LOCK (src);
+    gst_buffer_replace (&src->cached_frame, cached);
+    GST_OBJECT_UNLOCK (src);
+
+    buf = gst_buffer_copy (cached);
+    gst_buffer_unref (cached);
+  }
+
+done:
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    gst_buffer_unref (buf);
+    return ret;
+  }
+
+  *buffer = buf;
+  return GST_FLOW_OK;
+}
+
 static gboolean
 gst_video_test_src_start (GstBaseSrc * basesrc)
 {
@@ -1108,6 +1242,8 @@ gst_video_test_src_stop (GstBaseSrc * basesrc)
     gst_video_chroma_resample_free (src->subsample);
   src->subsample = NULL;
 
+  gst_video_test_src_clear_cache (src);
+
   for (i = 0; i < src->n_lines; i++)
     g_free (src->lines[i]);
   g_free (src->lines);
@@ -185,6 +185,10 @@ struct _GstVideoTestSrc {
   guint n_lines;
   gint offset;
   gpointer *lines;
+
+  /* pre-rendered frame for static patterns, protected by the object lock */
+  gboolean cache_pattern;
+  GstBuffer *cached_frame;
 };
 
 struct _GstVideoTestSrcClass {
@@ -348,6 +348,63 @@ GST_START_TEST (test_segment)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_buffer_list)
+{
+  GstElement *sink;
+  GstSegment segment;
+  GstSample *sample;
+  GstBufferList *list;
+  GPollFD pfd;
+  gint i;
+
+  sink = setup_appsink ();
+
+  gst_app_sink_get_pollfd (GST_APP_SINK (sink), &pfd);
+  pfd.events = G_IO_IN;
+  fail_unless_equals_int (g_poll (&pfd, 1, 0), 0);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 3; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (4)) == GST_FLOW_OK);
+
+  /* a segment change ends the list */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  segment.start = 2 * GST_SECOND;
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+  fail_unless (gst_pad_push (mysrcpad,
+          gst_buffer_new_and_alloc (4)) == GST_FLOW_OK);
+
+  fail_unless_equals_int (g_poll (&pfd, 1, 0), 1);
+
+  sample = gst_app_sink_pull_buffer_list (GST_APP_SINK (sink), 2);
+  fail_unless (gst_sample_get_buffer (sample) == NULL);
+  list = gst_sample_get_buffer_list (sample);
+  fail_unless_equals_int (gst_buffer_list_length (list), 2);
+  gst_sample_unref (sample);
+
+  sample = gst_app_sink_pull_buffer_list (GST_APP_SINK (sink), 0);
+  list = gst_sample_get_buffer_list (sample);
+  fail_unless_equals_int (gst_buffer_list_length (list), 1);
+  gst_sample_unref (sample);
+
+  sample = gst_app_sink_pull_buffer_list (GST_APP_SINK (sink), 0);
+  list = gst_sample_get_buffer_list (sample);
+  fail_unless_equals_int (gst_buffer_list_length (list), 1);
+  fail_unless (gst_segment_is_equal (&segment,
+          gst_sample_get_segment (sample)));
+  gst_sample_unref (sample);
+
+  /* queue drained, the fd is not readable anymore */
+  fail_unless_equals_int (g_poll (&pfd, 1, 0), 0);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsink_suite (void)
 {
@@ -362,6 +419,7 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_buffer_list_fallback);
   tcase_add_test (tc_chain, test_buffer_list_fallback_signal);
   tcase_add_test (tc_chain, test_segment);
+  tcase_add_test (tc_chain, test_pull_buffer_list);
 
   return s;
 }
@@ -122,6 +122,47 @@ GST_START_TEST (test_appsrc_non_null_caps)
 
 GST_END_TEST;
 
+GST_START_TEST (test_appsrc_push_buffer_list)
+{
+  GstElement *src;
+  GstBufferList *list;
+  GstCaps *caps;
+  gint i;
+
+  src = setup_appsrc ();
+
+  caps = gst_caps_from_string (SAMPLE_CAPS);
+  g_object_set (src, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  ASSERT_SET_STATE (src, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 3; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (4));
+  fail_unless (gst_app_src_push_buffer_list (GST_APP_SRC (src),
+          list) == GST_FLOW_OK);
+  fail_unless (gst_app_src_push_buffer (GST_APP_SRC (src),
+          gst_buffer_new_and_alloc (4)) == GST_FLOW_OK);
+
+  /* empty lists are accepted and ignored */
+  fail_unless (gst_app_src_push_buffer_list (GST_APP_SRC (src),
+          gst_buffer_list_new ()) == GST_FLOW_OK);
+
+  fail_unless (gst_app_src_end_of_stream (GST_APP_SRC (src)) == GST_FLOW_OK);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 4)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  ASSERT_SET_STATE (src, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  fail_unless_equals_int (g_list_length (buffers), 4);
+  cleanup_appsrc (src);
+}
+
+GST_END_TEST;
+
 static GstAppSinkCallbacks app_callbacks;
 
 typedef struct
@@ -428,6 +469,7 @@ appsrc_suite (void)
   tcase_add_test (tc_chain, test_appsrc_non_null_caps);
   tcase_add_test (tc_chain, test_appsrc_set_caps_twice);
   tcase_add_test (tc_chain, test_appsrc_caps_in_push_modes);
+  tcase_add_test (tc_chain, test_appsrc_push_buffer_list);
 
   if (RUNNING_ON_VALGRIND)
     tcase_add_loop_test (tc_chain, test_appsrc_block_deadlock, 0, 5);
@@ -21,6 +21,7 @@
  */
 
 #include <unistd.h>
+#include <string.h>
 
 #include <gst/check/gstcheck.h>
 
@@ -221,6 +222,144 @@ GST_START_TEST (test_opus_encode_samples)
 
 GST_END_TEST;
 
+GST_START_TEST (test_opus_encode_batch)
+{
+  const unsigned int nsamples = 960 * 10;
+  GstElement *opusenc;
+  GstBuffer *inbuffer, *outbuffer;
+  GstClockTime pts = 0;
+  GstCaps *caps;
+  GList *l;
+
+  opusenc = setup_opusenc ();
+  g_object_set (opusenc, "batch-frames", 4, NULL);
+
+  fail_unless (gst_element_set_state (opusenc,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (nsamples * 2);
+  gst_buffer_memset (inbuffer, 0, 0, nsamples * 2);
+  GST_BUFFER_TIMESTAMP (inbuffer) = GST_BUFFER_OFFSET (inbuffer) = 0;
+  GST_BUFFER_DURATION (inbuffer) = GST_CLOCK_TIME_NONE;
+
+  caps = gst_caps_from_string (AUDIO_CAPS_STRING);
+  fail_unless (caps != NULL);
+  gst_check_setup_events (myencsrcpad, opusenc, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  fail_unless (gst_pad_push (myencsrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless (gst_pad_push_event (myencsrcpad, gst_event_new_eos ()) == TRUE);
+
+  /* every frame still is a packet of its own, with consecutive timestamps */
+  fail_unless (g_list_length (buffers) >= nsamples / 960);
+  for (l = buffers; l; l = l->next) {
+    outbuffer = GST_BUFFER (l->data);
+
+    fail_if (gst_buffer_get_size (outbuffer) == 0);
+    fail_unless (gst_buffer_get_size (outbuffer) <= 4000);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuffer), pts);
+    pts += GST_BUFFER_DURATION (outbuffer);
+  }
+
+  fail_unless (gst_element_set_state (opusenc,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  check_buffers (nsamples / 960);
+
+  /* cleanup */
+  cleanup_opusenc (opusenc);
+  g_list_free (buffers);
+}
+
+GST_END_TEST;
+
+/* A 20 ms CELT fullband packet with a single frame */
+static GstBuffer *
+make_opus_packet (GstClockTime pts, gboolean discont)
+{
+  GstBuffer *buffer;
+  guint8 data[11];
+
+  memset (data, 0x55, sizeof (data));
+  data[0] = 31 << 3;
+
+  buffer = gst_buffer_new_allocate (NULL, sizeof (data), NULL);
+  gst_buffer_fill (buffer, 0, data, sizeof (data));
+  GST_BUFFER_PTS (buffer) = pts;
+  GST_BUFFER_DURATION (buffer) = 20 * GST_MSECOND;
+  if (discont)
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+
+  return buffer;
+}
+
+GST_START_TEST (test_opus_repacketize)
+{
+  GstElement *repacketizer;
+  GstBuffer *outbuffer;
+  GstCaps *caps;
+  guint i;
+
+  repacketizer = gst_check_setup_element ("opusrepacketizer");
+  myencsrcpad = gst_check_setup_src_pad (repacketizer, &srctemplate);
+  myencsinkpad = gst_check_setup_sink_pad (repacketizer, &sinktemplate);
+  gst_pad_set_active (myencsrcpad, TRUE);
+  gst_pad_set_active (myencsinkpad, TRUE);
+
+  g_object_set (repacketizer, "max-duration", 60, NULL);
+
+  fail_unless (gst_element_set_state (repacketizer,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string ("audio/x-opus, channel-mapping-family=0");
+  gst_check_setup_events (myencsrcpad, repacketizer, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* three packets are merged into one of 60 ms */
+  for (i = 0; i < 3; i++)
+    fail_unless (gst_pad_push (myencsrcpad,
+            make_opus_packet (i * 20 * GST_MSECOND, FALSE)) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+
+  outbuffer = GST_BUFFER (buffers->data);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuffer), 0);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuffer),
+      60 * GST_MSECOND);
+  /* code 3 TOC byte, frame count and the three frames */
+  fail_unless_equals_int (gst_buffer_get_size (outbuffer), 2 + 3 * 10);
+
+  /* a discontinuity flushes the pending packet */
+  fail_unless (gst_pad_push (myencsrcpad,
+          make_opus_packet (60 * GST_MSECOND, FALSE)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (myencsrcpad,
+          make_opus_packet (100 * GST_MSECOND, TRUE)) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+  outbuffer = GST_BUFFER (g_list_nth_data (buffers, 1));
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuffer), 60 * GST_MSECOND);
+  fail_unless_equals_int (gst_buffer_get_size (outbuffer), 11);
+
+  /* and EOS pushes out the rest */
+  fail_unless (gst_pad_push_event (myencsrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  outbuffer = GST_BUFFER (g_list_nth_data (buffers, 2));
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuffer), 100 * GST_MSECOND);
+  fail_unless (GST_BUFFER_IS_DISCONT (outbuffer));
+
+  gst_check_drop_buffers ();
+
+  gst_element_set_state (repacketizer, GST_STATE_NULL);
+  gst_pad_set_active (myencsrcpad, FALSE);
+  gst_pad_set_active (myencsinkpad, FALSE);
+  gst_check_teardown_src_pad (repacketizer);
+  gst_check_teardown_sink_pad (repacketizer);
+  gst_check_teardown_element (repacketizer);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_opus_encode_properties)
 {
   const unsigned int nsamples = 4096;
@@ -432,6 +571,8 @@ opus_suite (void)
   tcase_add_test (tc_chain, test_opus_decode_nothing);
   tcase_add_test (tc_chain, test_opus_encode_samples);
   tcase_add_test (tc_chain, test_opus_encode_properties);
+  tcase_add_test (tc_chain, test_opus_encode_batch);
+  tcase_add_test (tc_chain, test_opus_repacketize);
   tcase_add_test (tc_chain, test_opusdec_getcaps);
 
   return s;
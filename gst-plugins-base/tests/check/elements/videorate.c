@@ -1163,6 +1163,61 @@ GST_START_TEST (test_variable_framerate_renegotiation)
 GST_END_TEST;
 
 
+static GstPadProbeReturn
+gap_event_probe (GstPad * pad, GstPadProbeInfo * info, GList ** gaps)
+{
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_GAP)
+    *gaps = g_list_append (*gaps, gst_event_ref (event));
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_gap_duplicates)
+{
+  GstElement *videorate;
+  GstBuffer *first, *second;
+  GstClockTime ts, duration;
+  GList *gaps = NULL;
+  GstCaps *caps;
+
+  videorate = setup_videorate ();
+  g_object_set (videorate, "gap-duplicates", TRUE, NULL);
+  gst_pad_add_probe (mysinkpad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      (GstPadProbeCallback) gap_event_probe, &gaps, NULL);
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (VIDEO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  first = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (first) = 0;
+  fail_unless (gst_pad_push (mysrcpad, first) == GST_FLOW_OK);
+
+  /* three frames later, the first frame is output once and its duplicate
+   * is signalled with a GAP event instead of another buffer */
+  second = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (second) = GST_SECOND * 3 / 25;
+  fail_unless (gst_pad_push (mysrcpad, second) == GST_FLOW_OK);
+
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buffers->data), 0);
+  fail_unless_equals_int (g_list_length (gaps), 1);
+  gst_event_parse_gap (gaps->data, &ts, &duration);
+  fail_unless_equals_uint64 (ts, GST_SECOND / 25);
+  fail_unless_equals_uint64 (duration, GST_SECOND / 25);
+  assert_videorate_stats (videorate, "gap", 2, 2, 0, 1);
+
+  g_list_free_full (gaps, (GDestroyNotify) gst_event_unref);
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -1183,6 +1238,7 @@ videorate_suite (void)
       0, G_N_ELEMENTS (caps_negotiation_tests));
   tcase_add_test (tc_chain, test_fixed_framerate);
   tcase_add_test (tc_chain, test_variable_framerate_renegotiation);
+  tcase_add_test (tc_chain, test_gap_duplicates);
 
   return s;
 }
@@ -522,6 +522,68 @@ GST_START_TEST (test_duration_query)
 
 GST_END_TEST;
 
+GST_START_TEST (test_cache_pattern)
+{
+  GstElement *videotestsrc;
+  GstBuffer *first, *buf;
+  GstMemory *mem;
+  GList *l;
+
+  videotestsrc = setup_videotestsrc ();
+  gst_util_set_object_arg (G_OBJECT (videotestsrc), "pattern", "smpte75");
+  g_object_set (videotestsrc, "cache-pattern", TRUE, NULL);
+
+  fail_unless (gst_element_set_state (videotestsrc,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 10) {
+    GST_DEBUG_OBJECT (videotestsrc, "Waiting for more buffers");
+    g_cond_wait (&check_cond, &check_mutex);
+  }
+  g_mutex_unlock (&check_mutex);
+
+  gst_element_set_state (videotestsrc, GST_STATE_READY);
+
+  /* all buffers share the memory of the single rendered frame but carry
+   * their own timestamps */
+  first = GST_BUFFER (buffers->data);
+  mem = gst_buffer_peek_memory (first, 0);
+  for (l = buffers->next; l; l = l->next) {
+    buf = GST_BUFFER (l->data);
+
+    fail_unless (gst_buffer_peek_memory (buf, 0) == mem);
+    fail_unless (GST_BUFFER_PTS (buf) > GST_BUFFER_PTS (first));
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buf),
+        GST_BUFFER_OFFSET (GST_BUFFER (l->prev->data)) + 1);
+  }
+
+  /* animated patterns are still rendered for every frame */
+  gst_check_drop_buffers ();
+  gst_util_set_object_arg (G_OBJECT (videotestsrc), "pattern", "ball");
+
+  fail_unless (gst_element_set_state (videotestsrc,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 2) {
+    GST_DEBUG_OBJECT (videotestsrc, "Waiting for more buffers");
+    g_cond_wait (&check_cond, &check_mutex);
+  }
+  g_mutex_unlock (&check_mutex);
+
+  gst_element_set_state (videotestsrc, GST_STATE_READY);
+
+  fail_unless (gst_buffer_peek_memory (GST_BUFFER (buffers->data), 0) !=
+      gst_buffer_peek_memory (GST_BUFFER (buffers->next->data), 0));
+
+  /* cleanup */
+  cleanup_videotestsrc (videotestsrc);
+}
+
+GST_END_TEST;
 
 /* FIXME: add tests for YUV formats */
 
@@ -544,6 +606,7 @@ videotestsrc_suite (void)
   tcase_add_test (tc_chain, test_rgb_formats);
   tcase_add_test (tc_chain, test_backward_playback);
   tcase_add_test (tc_chain, test_duration_query);
+  tcase_add_test (tc_chain, test_cache_pattern);
 
   return s;
 }
@@ -401,6 +401,60 @@ GST_START_TEST (test_f32_22050hz)
 
 GST_END_TEST;
 
+GST_START_TEST (test_f32_pow2)
+{
+  gint i, len;
+  gfloat *in, *res;
+  gdouble *in64;
+  GstFFTF32Complex *out;
+  GstFFTF64Complex *out64;
+  GstFFTF32 *ctx, *ctx2, *ictx;
+  GstFFTF64 *ctx64;
+
+  /* compare the power of two implementation against the f64 one and
+   * check that the inverse gives back the input */
+  for (len = 16; len <= 4096; len *= 2) {
+    in = g_new (gfloat, len);
+    res = g_new (gfloat, len);
+    in64 = g_new (gdouble, len);
+    out = g_new (GstFFTF32Complex, len / 2 + 1);
+    out64 = g_new (GstFFTF64Complex, len / 2 + 1);
+    ctx = gst_fft_f32_new (len, FALSE);
+    ctx2 = gst_fft_f32_new (len, FALSE);
+    ictx = gst_fft_f32_new (len, TRUE);
+    ctx64 = gst_fft_f64_new (len, FALSE);
+
+    for (i = 0; i < len; i++)
+      in64[i] = in[i] = sin (i * 0.37) + 0.3 * cos (i * 1.7) + (i % 7) * 0.1;
+
+    gst_fft_f32_fft (ctx2, in, out);
+    gst_fft_f32_fft (ctx, in, out);
+    gst_fft_f64_fft (ctx64, in64, out64);
+
+    for (i = 0; i < len / 2 + 1; i++) {
+      fail_unless (fabs (out[i].r - out64[i].r) / len < 1e-5);
+      fail_unless (fabs (out[i].i - out64[i].i) / len < 1e-5);
+    }
+
+    gst_fft_f32_inverse_fft (ictx, out, res);
+
+    for (i = 0; i < len; i++)
+      fail_unless (fabs (res[i] / len - in[i]) < 1e-4);
+
+    gst_fft_f32_free (ctx);
+    gst_fft_f32_free (ctx2);
+    gst_fft_f32_free (ictx);
+    gst_fft_f64_free (ctx64);
+    g_free (in);
+    g_free (res);
+    g_free (in64);
+    g_free (out);
+    g_free (out64);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_f64_0hz)
 {
   gint i;
@@ -538,6 +592,7 @@ fft_suite (void)
   tcase_add_test (tc_chain, test_f32_0hz);
   tcase_add_test (tc_chain, test_f32_11025hz);
   tcase_add_test (tc_chain, test_f32_22050hz);
+  tcase_add_test (tc_chain, test_f32_pow2);
   tcase_add_test (tc_chain, test_f64_0hz);
   tcase_add_test (tc_chain, test_f64_11025hz);
   tcase_add_test (tc_chain, test_f64_22050hz);
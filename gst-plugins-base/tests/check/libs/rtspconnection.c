@@ -842,6 +842,56 @@ GST_START_TEST (test_rtspconnection_backlog)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtspconnection_write_buffer)
+{
+  GSocketConnection *conn1 = NULL;
+  GSocketConnection *conn2 = NULL;
+  GSocket *sock;
+  GstRTSPConnection *rtsp_conn = NULL;
+  GstRTSPWatch *watch;
+  GInputStream *istream;
+  GstBuffer *buffer;
+  guint8 recv[4 + 8];
+  gsize count;
+
+  create_connection (&conn1, &conn2);
+  sock = g_socket_connection_get_socket (conn1);
+  fail_unless (sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (sock, "127.0.0.1",
+          4444, NULL, &rtsp_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_conn != NULL);
+
+  watch = gst_rtsp_watch_new (rtsp_conn, &watch_funcs, NULL, NULL);
+  fail_unless (watch != NULL);
+  fail_unless (gst_rtsp_watch_attach (watch, NULL) > 0);
+  g_source_unref ((GSource *) watch);
+
+  /* a buffer made of two memories is framed and written as one packet */
+  buffer = gst_buffer_new_wrapped (g_memdup ("abcd", 4), 4);
+  gst_buffer_append_memory (buffer,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, (gpointer) "efgh", 4,
+          0, 4, NULL, NULL));
+  fail_unless (gst_rtsp_watch_write_buffer (watch, 3, buffer,
+          NULL) == GST_RTSP_OK);
+  gst_buffer_unref (buffer);
+
+  istream = g_io_stream_get_input_stream (G_IO_STREAM (conn2));
+  fail_unless (istream != NULL);
+  fail_unless (g_input_stream_read_all (istream, recv, sizeof (recv), &count,
+          NULL, NULL));
+  fail_unless_equals_int (count, sizeof (recv));
+  fail_unless (memcmp (recv, "$\003\000\010abcdefgh", sizeof (recv)) == 0);
+
+  g_source_destroy ((GSource *) watch);
+  fail_unless (gst_rtsp_connection_close (rtsp_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_conn) == GST_RTSP_OK);
+  g_object_unref (conn1);
+  g_object_unref (conn2);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtspconnection_ip)
 {
   GstRTSPConnection *conn = NULL;
@@ -876,6 +926,7 @@ rtspconnection_suite (void)
   tcase_add_test (tc_chain, test_rtspconnection_connect);
   tcase_add_test (tc_chain, test_rtspconnection_poll);
   tcase_add_test (tc_chain, test_rtspconnection_backlog);
+  tcase_add_test (tc_chain, test_rtspconnection_write_buffer);
   tcase_add_test (tc_chain, test_rtspconnection_ip);
 
   return s;
@@ -2387,6 +2387,78 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+static void
+convert_and_compare (GstVideoFormat infmt, GstVideoFormat outfmt,
+    gint in_w, gint in_h, gint out_w, gint out_h)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  guint8 *data;
+  gsize i;
+  guint threads;
+
+  gst_video_info_set_format (&ininfo, infmt, in_w, in_h);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  data = map.data;
+  for (i = 0; i < map.size; i++)
+    data[i] = (i * 7 + (i >> 10)) & 0xff;
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  gst_video_info_set_format (&outinfo, outfmt, out_w, out_h);
+  refbuffer = NULL;
+
+  for (threads = 1; threads <= 4; threads++) {
+    outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+    gst_buffer_memset (outbuffer, 0, 0, -1);
+    gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads, NULL));
+    fail_unless (convert != NULL);
+    /* twice, to check that the band state is reset between frames */
+    gst_video_converter_frame (convert, &inframe, &outframe);
+    gst_video_converter_frame (convert, &inframe, &outframe);
+    gst_video_converter_free (convert);
+
+    gst_video_frame_unmap (&outframe);
+
+    if (refbuffer == NULL) {
+      refbuffer = outbuffer;
+    } else {
+      gst_buffer_map (refbuffer, &map, GST_MAP_READ);
+      fail_unless (gst_buffer_memcmp (outbuffer, 0, map.data, map.size) == 0);
+      gst_buffer_unmap (refbuffer, &map);
+      gst_buffer_unref (outbuffer);
+    }
+  }
+
+  gst_buffer_unref (refbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_START_TEST (test_video_convert_multithreading)
+{
+  /* generic line based path */
+  convert_and_compare (GST_VIDEO_FORMAT_ARGB, GST_VIDEO_FORMAT_I420,
+      320, 240, 400, 300);
+  convert_and_compare (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_BGRx,
+      320, 242, 320, 242);
+  /* plane scaling fast path */
+  convert_and_compare (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420,
+      640, 480, 320, 182);
+  convert_and_compare (GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_YUY2,
+      320, 240, 640, 480);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -2635,6 +2707,95 @@ GST_START_TEST (test_overlay_blend)
 
 GST_END_TEST;
 
+GST_START_TEST (test_overlay_blend_420)
+{
+  const GstVideoFormat formats[] = { GST_VIDEO_FORMAT_I420,
+    GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV21
+  };
+  guint f;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    GstVideoOverlayComposition *comp1;
+    GstVideoOverlayRectangle *rect1;
+    GstVideoFrame video_frame;
+    GstVideoInfo vinfo;
+    GstBuffer *buf, *pix1;
+    GstMapInfo map;
+    guint8 *y_data, *u_data, *v_data;
+    gint r, c, y_stride, u_stride, v_stride, u_pstride, v_pstride;
+
+    GST_DEBUG ("blending onto %s", gst_video_format_to_string (formats[f]));
+
+    gst_video_info_init (&vinfo);
+    gst_video_info_set_format (&vinfo, formats[f], 32, 16);
+    buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&vinfo));
+    gst_video_frame_map (&video_frame, &vinfo, buf, GST_MAP_READWRITE);
+    gst_buffer_unref (buf);
+
+    y_data = GST_VIDEO_FRAME_COMP_DATA (&video_frame, 0);
+    u_data = GST_VIDEO_FRAME_COMP_DATA (&video_frame, 1);
+    v_data = GST_VIDEO_FRAME_COMP_DATA (&video_frame, 2);
+    y_stride = GST_VIDEO_FRAME_COMP_STRIDE (&video_frame, 0);
+    u_stride = GST_VIDEO_FRAME_COMP_STRIDE (&video_frame, 1);
+    v_stride = GST_VIDEO_FRAME_COMP_STRIDE (&video_frame, 2);
+    u_pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&video_frame, 1);
+    v_pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&video_frame, 2);
+
+    for (r = 0; r < 16; r++)
+      memset (y_data + r * y_stride, 0x10, 32);
+    for (r = 0; r < 8; r++) {
+      for (c = 0; c < 16; c++) {
+        u_data[r * u_stride + c * u_pstride] = 0x80;
+        v_data[r * v_stride + c * v_pstride] = 0x80;
+      }
+    }
+
+    /* half transparent AYUV overlay at an odd position */
+    pix1 = gst_buffer_new_and_alloc (8 * 8 * 4);
+    gst_buffer_map (pix1, &map, GST_MAP_WRITE);
+    for (c = 0; c < 8 * 8; c++) {
+      map.data[c * 4 + 0] = 0x80;
+      map.data[c * 4 + 1] = 0x20;
+      map.data[c * 4 + 2] = 0xf0;
+      map.data[c * 4 + 3] = 0x70;
+    }
+    gst_buffer_unmap (pix1, &map);
+    gst_buffer_add_video_meta (pix1, GST_VIDEO_FRAME_FLAG_NONE,
+        GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_YUV, 8, 8);
+    rect1 = gst_video_overlay_rectangle_new_raw (pix1, 3, 2, 8, 8,
+        GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+    gst_buffer_unref (pix1);
+
+    comp1 = gst_video_overlay_composition_new (rect1);
+    fail_unless (gst_video_overlay_composition_blend (comp1, &video_frame));
+    gst_video_overlay_composition_unref (comp1);
+    gst_video_overlay_rectangle_unref (rect1);
+
+    for (r = 0; r < 16; r++) {
+      for (c = 0; c < 32; c++) {
+        gboolean inside = (r >= 2 && r < 10 && c >= 3 && c < 11);
+
+        fail_unless_equals_int (y_data[r * y_stride + c], inside ? 24 : 0x10);
+      }
+    }
+    /* chroma is taken from the even lines and pixels inside the overlay */
+    for (r = 0; r < 8; r++) {
+      for (c = 0; c < 16; c++) {
+        gboolean inside = (r >= 1 && r <= 4 && c >= 2 && c <= 5);
+
+        fail_unless_equals_int (u_data[r * u_stride + c * u_pstride],
+            inside ? 184 : 0x80);
+        fail_unless_equals_int (v_data[r * v_stride + c * v_pstride],
+            inside ? 119 : 0x80);
+      }
+    }
+
+    gst_video_frame_unmap (&video_frame);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_overlay_composition_over_transparency)
 {
   GstVideoOverlayComposition *comp1;
@@ -2719,8 +2880,10 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_color_convert);
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
+  tcase_add_test (tc_chain, test_video_convert_multithreading);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
+  tcase_add_test (tc_chain, test_overlay_blend_420);
   tcase_add_test (tc_chain, test_video_center_rect);
   tcase_add_test (tc_chain, test_overlay_composition_over_transparency);
 
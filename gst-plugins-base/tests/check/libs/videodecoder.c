@@ -171,6 +171,28 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+gst_video_decoder_tester_decode_parallel (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
+{
+  GstMapInfo in_map, out_map;
+  guint64 input_num;
+
+  gst_buffer_map (frame->input_buffer, &in_map, GST_MAP_READ);
+  input_num = *((guint64 *) in_map.data);
+  gst_buffer_unmap (frame->input_buffer, &in_map);
+
+  /* make frames complete out of order */
+  g_usleep ((input_num % 4) * 500);
+
+  gst_buffer_map (frame->output_buffer, &out_map, GST_MAP_WRITE);
+  memset (out_map.data, 0, out_map.size);
+  memcpy (out_map.data, &input_num, sizeof (guint64));
+  gst_buffer_unmap (frame->output_buffer, &out_map);
+
+  return GST_FLOW_OK;
+}
+
 static void
 gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
 {
@@ -195,6 +217,7 @@ gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
   audiosink_class->stop = gst_video_decoder_tester_stop;
   audiosink_class->flush = gst_video_decoder_tester_flush;
   audiosink_class->handle_frame = gst_video_decoder_tester_handle_frame;
+  audiosink_class->decode_parallel = gst_video_decoder_tester_decode_parallel;
   audiosink_class->set_format = gst_video_decoder_tester_set_format;
 }
 
@@ -1073,6 +1096,61 @@ GST_START_TEST (videodecoder_query_caps_with_custom_getcaps)
 
 GST_END_TEST;
 
+GST_START_TEST (videodecoder_parallel_playback)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  gst_video_decoder_set_decode_threads (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_decode_threads
+      (GST_VIDEO_DECODER (dec)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* all frames are pushed in their original order */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    num = *(guint64 *) map.data;
+    fail_unless (i == num);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
 
 static Suite *
 gst_videodecoder_suite (void)
@@ -1091,6 +1169,7 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_playback_first_frames_not_decoded);
   tcase_add_test (tc, videodecoder_buffer_after_segment);
   tcase_add_test (tc, videodecoder_first_data_is_gap);
+  tcase_add_test (tc, videodecoder_parallel_playback);
 
   tcase_add_test (tc, videodecoder_backwards_playback);
   tcase_add_test (tc, videodecoder_backwards_buffer_after_segment);
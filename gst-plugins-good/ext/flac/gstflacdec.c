@@ -553,6 +553,51 @@ gst_flac_dec_read_stream (const FLAC__StreamDecoder * decoder,
   return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
 }
 
+/* Number of samples per channel interleaved at once for more than two
+ * channels, so that the input and output stay in the cache */
+#define INTERLEAVE_BLOCK 256
+
+/* Interleaves the per channel samples from libFLAC into the output and
+ * shifts them up to the output depth. The inner loops are kept trivial so
+ * the compiler can vectorize them. */
+#define DEFINE_INTERLEAVE(width)                                        \
+static void                                                             \
+gst_flac_dec_interleave_##width (gint##width * dest,                    \
+    const FLAC__int32 * const src[], guint channels, guint samples,     \
+    guint shift)                                                        \
+{                                                                       \
+  guint i, j, k, block;                                                 \
+                                                                        \
+  if (channels == 1) {                                                  \
+    const FLAC__int32 *s0 = src[0];                                     \
+                                                                        \
+    for (i = 0; i < samples; i++)                                       \
+      dest[i] = (gint##width) (s0[i] << shift);                         \
+  } else if (channels == 2) {                                           \
+    const FLAC__int32 *s0 = src[0], *s1 = src[1];                       \
+                                                                        \
+    for (i = 0; i < samples; i++) {                                     \
+      dest[2 * i] = (gint##width) (s0[i] << shift);                     \
+      dest[2 * i + 1] = (gint##width) (s1[i] << shift);                 \
+    }                                                                   \
+  } else {                                                              \
+    for (i = 0; i < samples; i += INTERLEAVE_BLOCK) {                   \
+      block = MIN (samples - i, INTERLEAVE_BLOCK);                      \
+      for (j = 0; j < channels; j++) {                                  \
+        const FLAC__int32 *s = src[j] + i;                              \
+        gint##width *d = dest + i * channels + j;                       \
+                                                                        \
+        for (k = 0; k < block; k++)                                     \
+          d[k * channels] = (gint##width) (s[k] << shift);              \
+      }                                                                 \
+    }                                                                   \
+  }                                                                     \
+}
+
+DEFINE_INTERLEAVE (8)
+DEFINE_INTERLEAVE (16)
+DEFINE_INTERLEAVE (32)
+
 static FLAC__StreamDecoderWriteStatus
 gst_flac_dec_write (GstFlacDec * flacdec, const FLAC__Frame * frame,
     const FLAC__int32 * const buffer[])
@@ -564,7 +609,8 @@ gst_flac_dec_write (GstFlacDec * flacdec, const FLAC__Frame * frame,
   guint sample_rate = frame->header.sample_rate;
   guint channels = frame->header.channels;
   guint samples = frame->header.blocksize;
-  guint j, i;
+  guint j, shift;
+  const FLAC__int32 *src[8];
   GstMapInfo map;
   gboolean caps_changed;
   GstAudioChannelPosition chanpos[8];
@@ -646,53 +692,20 @@ gst_flac_dec_write (GstFlacDec * flacdec, const FLAC__Frame * frame,
   outbuf =
       gst_buffer_new_allocate (NULL, samples * channels * (width / 8), NULL);
 
+  for (j = 0; j < channels; j++)
+    src[j] = buffer[flacdec->channel_reorder_map[j]];
+  shift = gdepth - depth;
+
   gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
   if (width == 8) {
-    gint8 *outbuffer = (gint8 *) map.data;
-    gint *reorder_map = flacdec->channel_reorder_map;
-
     g_assert (gdepth == 8 && depth == 8);
-    for (i = 0; i < samples; i++) {
-      for (j = 0; j < channels; j++) {
-        *outbuffer++ = (gint8) buffer[reorder_map[j]][i];
-      }
-    }
+    gst_flac_dec_interleave_8 ((gint8 *) map.data, src, channels, samples, 0);
   } else if (width == 16) {
-    gint16 *outbuffer = (gint16 *) map.data;
-    gint *reorder_map = flacdec->channel_reorder_map;
-
-    if (gdepth != depth) {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ =
-              (gint16) (buffer[reorder_map[j]][i] << (gdepth - depth));
-        }
-      }
-    } else {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ = (gint16) buffer[reorder_map[j]][i];
-        }
-      }
-    }
+    gst_flac_dec_interleave_16 ((gint16 *) map.data, src, channels, samples,
+        shift);
   } else if (width == 32) {
-    gint32 *outbuffer = (gint32 *) map.data;
-    gint *reorder_map = flacdec->channel_reorder_map;
-
-    if (gdepth != depth) {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ =
-              (gint32) (buffer[reorder_map[j]][i] << (gdepth - depth));
-        }
-      }
-    } else {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ = (gint32) buffer[reorder_map[j]][i];
-        }
-      }
-    }
+    gst_flac_dec_interleave_32 ((gint32 *) map.data, src, channels, samples,
+        shift);
   } else {
     g_assert_not_reached ();
   }
@@ -56,12 +56,14 @@
 
 #define JPEG_DEFAULT_IDCT_METHOD	JDCT_FASTEST
 #define JPEG_DEFAULT_MAX_ERRORS 	0
+#define JPEG_DEFAULT_MAX_THREADS	1
 
 enum
 {
   PROP_0,
   PROP_IDCT_METHOD,
-  PROP_MAX_ERRORS
+  PROP_MAX_ERRORS,
+  PROP_MAX_THREADS
 };
 
 /* *INDENT-OFF* */
@@ -102,18 +104,28 @@ static GstFlowReturn gst_jpeg_dec_parse (GstVideoDecoder * bdec,
     GstVideoCodecFrame * frame, GstAdapter * adapter, gboolean at_eos);
 static GstFlowReturn gst_jpeg_dec_handle_frame (GstVideoDecoder * bdec,
     GstVideoCodecFrame * frame);
+static GstFlowReturn gst_jpeg_dec_decode_parallel (GstVideoDecoder * bdec,
+    GstVideoCodecFrame * frame);
 static gboolean gst_jpeg_dec_decide_allocation (GstVideoDecoder * bdec,
     GstQuery * query);
 
 #define gst_jpeg_dec_parent_class parent_class
 G_DEFINE_TYPE (GstJpegDec, gst_jpeg_dec, GST_TYPE_VIDEO_DECODER);
 
+static void gst_jpeg_dec_context_init (GstJpegDec * dec,
+    GstJpegDecContext * ctx);
+static void gst_jpeg_dec_context_clear (GstJpegDecContext * ctx);
+static void gst_jpeg_dec_context_free (GstJpegDecContext * ctx);
+
 static void
 gst_jpeg_dec_finalize (GObject * object)
 {
   GstJpegDec *dec = GST_JPEG_DEC (object);
 
-  jpeg_destroy_decompress (&dec->cinfo);
+  gst_jpeg_dec_context_clear (&dec->ctx);
+  g_slist_free_full (dec->free_contexts,
+      (GDestroyNotify) gst_jpeg_dec_context_free);
+  g_mutex_clear (&dec->contexts_lock);
   if (dec->input_state)
     gst_video_codec_state_unref (dec->input_state);
 
@@ -160,6 +172,21 @@ gst_jpeg_dec_class_init (GstJpegDecClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_DEPRECATED));
 #endif
 
+  /**
+   * GstJpegDec:max-threads:
+   *
+   * Maximum number of frames to decode in parallel on a pool of threads,
+   * which increases the throughput of high resolution MJPEG streams at the
+   * cost of one frame of latency per thread. 0 uses one thread per processor.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_int ("max-threads", "Maximum Threads",
+          "Maximum number of frames decoded in parallel "
+          "(0 = one per processor)", 0, G_MAXINT, JPEG_DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_jpeg_dec_src_pad_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -174,6 +201,7 @@ gst_jpeg_dec_class_init (GstJpegDecClass * klass)
   vdec_class->parse = gst_jpeg_dec_parse;
   vdec_class->set_format = gst_jpeg_dec_set_format;
   vdec_class->handle_frame = gst_jpeg_dec_handle_frame;
+  vdec_class->decode_parallel = gst_jpeg_dec_decode_parallel;
   vdec_class->decide_allocation = gst_jpeg_dec_decide_allocation;
 
   GST_DEBUG_CATEGORY_INIT (jpeg_dec_debug, "jpegdec", 0, "JPEG decoder");
@@ -244,32 +272,39 @@ METHODDEF (void)
   longjmp (err_mgr->setjmp_buffer, 1);
 }
 
+static void
+gst_jpeg_dec_context_init (GstJpegDec * dec, GstJpegDecContext * ctx)
+{
+  /* setup jpeglib */
+  memset (ctx, 0, sizeof (GstJpegDecContext));
+  ctx->cinfo.err = jpeg_std_error (&ctx->jerr.pub);
+  ctx->jerr.pub.output_message = gst_jpeg_dec_my_output_message;
+  ctx->jerr.pub.emit_message = gst_jpeg_dec_my_emit_message;
+  ctx->jerr.pub.error_exit = gst_jpeg_dec_my_error_exit;
+
+  jpeg_create_decompress (&ctx->cinfo);
+
+  ctx->cinfo.src = (struct jpeg_source_mgr *) &ctx->jsrc;
+  ctx->cinfo.src->init_source = gst_jpeg_dec_init_source;
+  ctx->cinfo.src->fill_input_buffer = gst_jpeg_dec_fill_input_buffer;
+  ctx->cinfo.src->skip_input_data = gst_jpeg_dec_skip_input_data;
+  ctx->cinfo.src->resync_to_restart = gst_jpeg_dec_resync_to_restart;
+  ctx->cinfo.src->term_source = gst_jpeg_dec_term_source;
+  ctx->jsrc.dec = dec;
+}
+
 static void
 gst_jpeg_dec_init (GstJpegDec * dec)
 {
   GST_DEBUG ("initializing");
 
-  /* setup jpeglib */
-  memset (&dec->cinfo, 0, sizeof (dec->cinfo));
-  memset (&dec->jerr, 0, sizeof (dec->jerr));
-  dec->cinfo.err = jpeg_std_error (&dec->jerr.pub);
-  dec->jerr.pub.output_message = gst_jpeg_dec_my_output_message;
-  dec->jerr.pub.emit_message = gst_jpeg_dec_my_emit_message;
-  dec->jerr.pub.error_exit = gst_jpeg_dec_my_error_exit;
-
-  jpeg_create_decompress (&dec->cinfo);
-
-  dec->cinfo.src = (struct jpeg_source_mgr *) &dec->jsrc;
-  dec->cinfo.src->init_source = gst_jpeg_dec_init_source;
-  dec->cinfo.src->fill_input_buffer = gst_jpeg_dec_fill_input_buffer;
-  dec->cinfo.src->skip_input_data = gst_jpeg_dec_skip_input_data;
-  dec->cinfo.src->resync_to_restart = gst_jpeg_dec_resync_to_restart;
-  dec->cinfo.src->term_source = gst_jpeg_dec_term_source;
-  dec->jsrc.dec = dec;
+  gst_jpeg_dec_context_init (dec, &dec->ctx);
+  g_mutex_init (&dec->contexts_lock);
 
   /* init properties */
   dec->idct_method = JPEG_DEFAULT_IDCT_METHOD;
   dec->max_errors = JPEG_DEFAULT_MAX_ERRORS;
+  dec->max_threads = JPEG_DEFAULT_MAX_THREADS;
 
   gst_video_decoder_set_use_default_pad_acceptcaps (GST_VIDEO_DECODER_CAST
       (dec), TRUE);
@@ -621,49 +656,97 @@ hresamplecpy1 (guint8 * dest, const guint8 * src, guint len)
 }
 
 static void
-gst_jpeg_dec_free_buffers (GstJpegDec * dec)
+gst_jpeg_dec_free_buffers (GstJpegDecContext * ctx)
 {
   gint i;
 
   for (i = 0; i < 16; i++) {
-    g_free (dec->idr_y[i]);
-    g_free (dec->idr_u[i]);
-    g_free (dec->idr_v[i]);
-    dec->idr_y[i] = NULL;
-    dec->idr_u[i] = NULL;
-    dec->idr_v[i] = NULL;
+    g_free (ctx->idr_y[i]);
+    g_free (ctx->idr_u[i]);
+    g_free (ctx->idr_v[i]);
+    ctx->idr_y[i] = NULL;
+    ctx->idr_u[i] = NULL;
+    ctx->idr_v[i] = NULL;
+  }
+
+  ctx->idr_width_allocated = 0;
+}
+
+static void
+gst_jpeg_dec_context_clear (GstJpegDecContext * ctx)
+{
+  jpeg_destroy_decompress (&ctx->cinfo);
+  gst_jpeg_dec_free_buffers (ctx);
+}
+
+static void
+gst_jpeg_dec_context_free (GstJpegDecContext * ctx)
+{
+  gst_jpeg_dec_context_clear (ctx);
+  g_free (ctx);
+}
+
+/* Takes a context for decoding from a worker thread, creating one when all
+ * existing contexts are in use */
+static GstJpegDecContext *
+gst_jpeg_dec_acquire_context (GstJpegDec * dec)
+{
+  GstJpegDecContext *ctx = NULL;
+
+  g_mutex_lock (&dec->contexts_lock);
+  if (dec->free_contexts) {
+    ctx = dec->free_contexts->data;
+    dec->free_contexts =
+        g_slist_delete_link (dec->free_contexts, dec->free_contexts);
+  }
+  g_mutex_unlock (&dec->contexts_lock);
+
+  if (ctx == NULL) {
+    GST_DEBUG_OBJECT (dec, "creating new decoding context");
+    ctx = g_new (GstJpegDecContext, 1);
+    gst_jpeg_dec_context_init (dec, ctx);
   }
 
-  dec->idr_width_allocated = 0;
+  return ctx;
+}
+
+static void
+gst_jpeg_dec_release_context (GstJpegDec * dec, GstJpegDecContext * ctx)
+{
+  g_mutex_lock (&dec->contexts_lock);
+  dec->free_contexts = g_slist_prepend (dec->free_contexts, ctx);
+  g_mutex_unlock (&dec->contexts_lock);
 }
 
 static inline gboolean
-gst_jpeg_dec_ensure_buffers (GstJpegDec * dec, guint maxrowbytes)
+gst_jpeg_dec_ensure_buffers (GstJpegDec * dec, GstJpegDecContext * ctx,
+    guint maxrowbytes)
 {
   gint i;
 
-  if (G_LIKELY (dec->idr_width_allocated == maxrowbytes))
+  if (G_LIKELY (ctx->idr_width_allocated == maxrowbytes))
     return TRUE;
 
   /* FIXME: maybe just alloc one or three blocks altogether? */
   for (i = 0; i < 16; i++) {
-    dec->idr_y[i] = g_try_realloc (dec->idr_y[i], maxrowbytes);
-    dec->idr_u[i] = g_try_realloc (dec->idr_u[i], maxrowbytes);
-    dec->idr_v[i] = g_try_realloc (dec->idr_v[i], maxrowbytes);
+    ctx->idr_y[i] = g_try_realloc (ctx->idr_y[i], maxrowbytes);
+    ctx->idr_u[i] = g_try_realloc (ctx->idr_u[i], maxrowbytes);
+    ctx->idr_v[i] = g_try_realloc (ctx->idr_v[i], maxrowbytes);
 
-    if (G_UNLIKELY (!dec->idr_y[i] || !dec->idr_u[i] || !dec->idr_v[i])) {
+    if (G_UNLIKELY (!ctx->idr_y[i] || !ctx->idr_u[i] || !ctx->idr_v[i])) {
       GST_WARNING_OBJECT (dec, "out of memory, i=%d, bytes=%u", i, maxrowbytes);
       return FALSE;
     }
   }
 
-  dec->idr_width_allocated = maxrowbytes;
+  ctx->idr_width_allocated = maxrowbytes;
   GST_LOG_OBJECT (dec, "allocated temp memory, %u bytes/row", maxrowbytes);
   return TRUE;
 }
 
 static void
-gst_jpeg_dec_decode_grayscale (GstJpegDec * dec, GstVideoFrame * frame)
+gst_jpeg_dec_decode_grayscale (GstJpegDec * dec, GstJpegDecContext * ctx,
+    GstVideoFrame * frame)
 {
   guchar *rows[16];
   guchar **scanarray[1] = { rows };
@@ -678,18 +761,19 @@ gst_jpeg_dec_decode_grayscale (GstJpegDec * dec, GstVideoFrame * frame)
   width = GST_VIDEO_FRAME_WIDTH (frame);
   height = GST_VIDEO_FRAME_HEIGHT (frame);
 
-  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec, GST_ROUND_UP_32 (width))))
+  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec, ctx,
+              GST_ROUND_UP_32 (width))))
     return;
 
   base[0] = GST_VIDEO_FRAME_COMP_DATA (frame, 0);
   pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
   rstride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0);
 
-  memcpy (rows, dec->idr_y, 16 * sizeof (gpointer));
+  memcpy (rows, ctx->idr_y, 16 * sizeof (gpointer));
 
   i = 0;
   while (i < height) {
-    lines = jpeg_read_raw_data (&dec->cinfo, scanarray, DCTSIZE);
+    lines = jpeg_read_raw_data (&ctx->cinfo, scanarray, DCTSIZE);
     if (G_LIKELY (lines > 0)) {
       for (j = 0; (j < DCTSIZE) && (i < height); j++, i++) {
         gint p;
@@ -708,7 +792,8 @@ gst_jpeg_dec_decode_grayscale (GstJpegDec * dec, GstVideoFrame * frame)
 }
 
 static void
-gst_jpeg_dec_decode_rgb (GstJpegDec * dec, GstVideoFrame * frame)
+gst_jpeg_dec_decode_rgb (GstJpegDec * dec, GstJpegDecContext * ctx,
+    GstVideoFrame * frame)
 {
   guchar *r_rows[16], *g_rows[16], *b_rows[16];
   guchar **scanarray[3] = { r_rows, g_rows, b_rows };
@@ -723,7 +808,8 @@ gst_jpeg_dec_decode_rgb (GstJpegDec * dec, GstVideoFrame * frame)
   width = GST_VIDEO_FRAME_WIDTH (frame);
   height = GST_VIDEO_FRAME_HEIGHT (frame);
 
-  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec, GST_ROUND_UP_32 (width))))
+  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec, ctx,
+              GST_ROUND_UP_32 (width))))
     return;
 
   for (i = 0; i < 3; i++)
@@ -732,13 +818,13 @@ gst_jpeg_dec_decode_rgb (GstJpegDec * dec, GstVideoFrame * frame)
   pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
   rstride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0);
 
-  memcpy (r_rows, dec->idr_y, 16 * sizeof (gpointer));
-  memcpy (g_rows, dec->idr_u, 16 * sizeof (gpointer));
-  memcpy (b_rows, dec->idr_v, 16 * sizeof (gpointer));
+  memcpy (r_rows, ctx->idr_y, 16 * sizeof (gpointer));
+  memcpy (g_rows, ctx->idr_u, 16 * sizeof (gpointer));
+  memcpy (b_rows, ctx->idr_v, 16 * sizeof (gpointer));
 
   i = 0;
   while (i < height) {
-    lines = jpeg_read_raw_data (&dec->cinfo, scanarray, DCTSIZE);
+    lines = jpeg_read_raw_data (&ctx->cinfo, scanarray, DCTSIZE);
     if (G_LIKELY (lines > 0)) {
       for (j = 0; (j < DCTSIZE) && (i < height); j++, i++) {
         gint p;
@@ -761,8 +847,8 @@ gst_jpeg_dec_decode_rgb (GstJpegDec * dec, GstVideoFrame * frame)
 }
 
 static void
-gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstVideoFrame * frame, gint r_v,
-    gint r_h, gint comp)
+gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstJpegDecContext * ctx,
+    GstVideoFrame * frame, gint r_v, gint r_h, gint comp)
 {
   guchar *y_rows[16], *u_rows[16], *v_rows[16];
   guchar **scanarray[3] = { y_rows, u_rows, v_rows };
@@ -778,7 +864,8 @@ gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstVideoFrame * frame, gint r_v,
   width = GST_VIDEO_FRAME_WIDTH (frame);
   height = GST_VIDEO_FRAME_HEIGHT (frame);
 
-  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec, GST_ROUND_UP_32 (width))))
+  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec, ctx,
+              GST_ROUND_UP_32 (width))))
     return;
 
   for (i = 0; i < 3; i++) {
@@ -790,9 +877,9 @@ gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstVideoFrame * frame, gint r_v,
         (GST_VIDEO_FRAME_COMP_HEIGHT (frame, i) - 1));
   }
 
-  memcpy (y_rows, dec->idr_y, 16 * sizeof (gpointer));
-  memcpy (u_rows, dec->idr_u, 16 * sizeof (gpointer));
-  memcpy (v_rows, dec->idr_v, 16 * sizeof (gpointer));
+  memcpy (y_rows, ctx->idr_y, 16 * sizeof (gpointer));
+  memcpy (u_rows, ctx->idr_u, 16 * sizeof (gpointer));
+  memcpy (v_rows, ctx->idr_v, 16 * sizeof (gpointer));
 
   /* fill chroma components for grayscale */
   if (comp == 1) {
@@ -804,7 +891,7 @@ gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstVideoFrame * frame, gint r_v,
   }
 
   for (i = 0; i < height; i += r_v * DCTSIZE) {
-    lines = jpeg_read_raw_data (&dec->cinfo, scanarray, r_v * DCTSIZE);
+    lines = jpeg_read_raw_data (&ctx->cinfo, scanarray, r_v * DCTSIZE);
     if (G_LIKELY (lines > 0)) {
       for (j = 0, k = 0; j < (r_v * DCTSIZE); j += r_v, k++) {
         if (G_LIKELY (base[0] <= last[0])) {
@@ -841,7 +928,8 @@ gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstVideoFrame * frame, gint r_v,
 }
 
 static GstFlowReturn
-gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame)
+gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstJpegDecContext * ctx,
+    GstVideoFrame * frame)
 {
   guchar **line[3];             /* the jpeg line buffer         */
   guchar *y[4 * DCTSIZE] = { NULL, };   /* alloc enough for the lines   */
@@ -857,9 +945,9 @@ gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame)
   line[1] = u;
   line[2] = v;
 
-  v_samp[0] = dec->cinfo.comp_info[0].v_samp_factor;
-  v_samp[1] = dec->cinfo.comp_info[1].v_samp_factor;
-  v_samp[2] = dec->cinfo.comp_info[2].v_samp_factor;
+  v_samp[0] = ctx->cinfo.comp_info[0].v_samp_factor;
+  v_samp[1] = ctx->cinfo.comp_info[1].v_samp_factor;
+  v_samp[2] = ctx->cinfo.comp_info[2].v_samp_factor;
 
   if (G_UNLIKELY (v_samp[0] > 2 || v_samp[1] > 2 || v_samp[2] > 2))
     goto format_not_supported;
@@ -902,7 +990,7 @@ gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame)
         line[2][j] = last[2];
     }
 
-    lines = jpeg_read_raw_data (&dec->cinfo, line, v_samp[0] * DCTSIZE);
+    lines = jpeg_read_raw_data (&ctx->cinfo, line, v_samp[0] * DCTSIZE);
     if (G_UNLIKELY (!lines)) {
       GST_INFO_OBJECT (dec, "jpeg_read_raw_data() returned 0");
     }
@@ -922,24 +1010,65 @@ format_not_supported:
   }
 }
 
-static void
-gst_jpeg_dec_negotiate (GstJpegDec * dec, gint width, gint height, gint clrspc)
+/* Decodes the image once decompression has started, either directly into
+ * @frame or through the context's temporary rows */
+static GstFlowReturn
+gst_jpeg_dec_decode (GstJpegDec * dec, GstJpegDecContext * ctx,
+    GstVideoFrame * frame)
 {
-  GstVideoCodecState *outstate;
-  GstVideoInfo *info;
-  GstVideoFormat format;
+  gint width = GST_VIDEO_FRAME_WIDTH (frame);
+
+  if (ctx->cinfo.jpeg_color_space == JCS_RGB) {
+    gst_jpeg_dec_decode_rgb (dec, ctx, frame);
+  } else if (ctx->cinfo.jpeg_color_space == JCS_GRAYSCALE) {
+    gst_jpeg_dec_decode_grayscale (dec, ctx, frame);
+  } else {
+    GST_LOG_OBJECT (dec, "decompressing (reqired scanline buffer height = %u)",
+        ctx->cinfo.rec_outbuf_height);
 
+    /* For some widths jpeglib requires more horizontal padding than I420 
+     * provides. In those cases we need to decode into separate buffers and then
+     * copy over the data into our final picture buffer, otherwise jpeglib might
+     * write over the end of a line into the beginning of the next line,
+     * resulting in blocky artifacts on the left side of the picture. */
+    if (G_UNLIKELY (width % (ctx->cinfo.max_h_samp_factor * DCTSIZE) != 0
+            || ctx->cinfo.comp_info[0].h_samp_factor != 2
+            || ctx->cinfo.comp_info[1].h_samp_factor != 1
+            || ctx->cinfo.comp_info[2].h_samp_factor != 1)) {
+      GST_CAT_LOG_OBJECT (GST_CAT_PERFORMANCE, dec,
+          "indirect decoding using extra buffer copy");
+      gst_jpeg_dec_decode_indirect (dec, ctx, frame,
+          ctx->cinfo.comp_info[0].v_samp_factor,
+          ctx->cinfo.comp_info[0].h_samp_factor, ctx->cinfo.num_components);
+    } else {
+      return gst_jpeg_dec_decode_direct (dec, ctx, frame);
+    }
+  }
+
+  return GST_FLOW_OK;
+}
+
+static GstVideoFormat
+gst_jpeg_dec_get_format (gint clrspc)
+{
   switch (clrspc) {
     case JCS_RGB:
-      format = GST_VIDEO_FORMAT_RGB;
-      break;
+      return GST_VIDEO_FORMAT_RGB;
     case JCS_GRAYSCALE:
-      format = GST_VIDEO_FORMAT_GRAY8;
-      break;
+      return GST_VIDEO_FORMAT_GRAY8;
     default:
-      format = GST_VIDEO_FORMAT_I420;
-      break;
+      return GST_VIDEO_FORMAT_I420;
   }
+}
+
+static void
+gst_jpeg_dec_negotiate (GstJpegDec * dec, gint width, gint height, gint clrspc)
+{
+  GstVideoCodecState *outstate;
+  GstVideoInfo *info;
+  GstVideoFormat format;
+
+  format = gst_jpeg_dec_get_format (clrspc);
 
   /* Compare to currently configured output state */
   outstate = gst_video_decoder_get_output_state (GST_VIDEO_DECODER (dec));
@@ -975,8 +1104,10 @@ gst_jpeg_dec_negotiate (GstJpegDec * dec, gint width, gint height, gint clrspc)
 
   gst_video_decoder_negotiate (GST_VIDEO_DECODER (dec));
 
-  GST_DEBUG_OBJECT (dec, "max_v_samp_factor=%d", dec->cinfo.max_v_samp_factor);
-  GST_DEBUG_OBJECT (dec, "max_h_samp_factor=%d", dec->cinfo.max_h_samp_factor);
+  GST_DEBUG_OBJECT (dec, "max_v_samp_factor=%d",
+      dec->ctx.cinfo.max_v_samp_factor);
+  GST_DEBUG_OBJECT (dec, "max_h_samp_factor=%d",
+      dec->ctx.cinfo.max_h_samp_factor);
 }
 
 static GstFlowReturn
@@ -991,15 +1122,16 @@ gst_jpeg_dec_handle_frame (GstVideoDecoder * bdec, GstVideoCodecFrame * frame)
   gboolean need_unmap = TRUE;
   GstVideoCodecState *state = NULL;
   gboolean release_frame = TRUE;
+  GstJpegDecContext *ctx = &dec->ctx;
 
   dec->current_frame = frame;
   gst_buffer_map (frame->input_buffer, &dec->current_frame_map, GST_MAP_READ);
 
-  dec->cinfo.src->next_input_byte = dec->current_frame_map.data;
-  dec->cinfo.src->bytes_in_buffer = dec->current_frame_map.size;
+  ctx->cinfo.src->next_input_byte = dec->current_frame_map.data;
+  ctx->cinfo.src->bytes_in_buffer = dec->current_frame_map.size;
 
-  if (setjmp (dec->jerr.setjmp_buffer)) {
-    code = dec->jerr.pub.msg_code;
+  if (setjmp (ctx->jerr.setjmp_buffer)) {
+    code = ctx->jerr.pub.msg_code;
 
     if (code == JERR_INPUT_EOF) {
       GST_DEBUG ("jpeg input EOF error, we probably need more data");
@@ -1009,74 +1141,74 @@ gst_jpeg_dec_handle_frame (GstVideoDecoder * bdec, GstVideoCodecFrame * frame)
   }
 
   /* read header */
-  hdr_ok = jpeg_read_header (&dec->cinfo, TRUE);
+  hdr_ok = jpeg_read_header (&ctx->cinfo, TRUE);
   if (G_UNLIKELY (hdr_ok != JPEG_HEADER_OK)) {
     GST_WARNING_OBJECT (dec, "reading the header failed, %d", hdr_ok);
   }
 
-  GST_LOG_OBJECT (dec, "num_components=%d", dec->cinfo.num_components);
-  GST_LOG_OBJECT (dec, "jpeg_color_space=%d", dec->cinfo.jpeg_color_space);
+  GST_LOG_OBJECT (dec, "num_components=%d", ctx->cinfo.num_components);
+  GST_LOG_OBJECT (dec, "jpeg_color_space=%d", ctx->cinfo.jpeg_color_space);
 
-  if (!dec->cinfo.num_components || !dec->cinfo.comp_info)
+  if (!ctx->cinfo.num_components || !ctx->cinfo.comp_info)
     goto components_not_supported;
 
-  r_h = dec->cinfo.comp_info[0].h_samp_factor;
-  r_v = dec->cinfo.comp_info[0].v_samp_factor;
+  r_h = ctx->cinfo.comp_info[0].h_samp_factor;
+  r_v = ctx->cinfo.comp_info[0].v_samp_factor;
 
   GST_LOG_OBJECT (dec, "r_h = %d, r_v = %d", r_h, r_v);
 
-  if (dec->cinfo.num_components > 3)
+  if (ctx->cinfo.num_components > 3)
     goto components_not_supported;
 
   /* verify color space expectation to avoid going *boom* or bogus output */
-  if (dec->cinfo.jpeg_color_space != JCS_YCbCr &&
-      dec->cinfo.jpeg_color_space != JCS_GRAYSCALE &&
-      dec->cinfo.jpeg_color_space != JCS_RGB)
+  if (ctx->cinfo.jpeg_color_space != JCS_YCbCr &&
+      ctx->cinfo.jpeg_color_space != JCS_GRAYSCALE &&
+      ctx->cinfo.jpeg_color_space != JCS_RGB)
     goto unsupported_colorspace;
 
 #ifndef GST_DISABLE_GST_DEBUG
   {
     gint i;
 
-    for (i = 0; i < dec->cinfo.num_components; ++i) {
+    for (i = 0; i < ctx->cinfo.num_components; ++i) {
       GST_LOG_OBJECT (dec, "[%d] h_samp_factor=%d, v_samp_factor=%d, cid=%d",
-          i, dec->cinfo.comp_info[i].h_samp_factor,
-          dec->cinfo.comp_info[i].v_samp_factor,
-          dec->cinfo.comp_info[i].component_id);
+          i, ctx->cinfo.comp_info[i].h_samp_factor,
+          ctx->cinfo.comp_info[i].v_samp_factor,
+          ctx->cinfo.comp_info[i].component_id);
     }
   }
 #endif
 
   /* prepare for raw output */
-  dec->cinfo.do_fancy_upsampling = FALSE;
-  dec->cinfo.do_block_smoothing = FALSE;
-  dec->cinfo.out_color_space = dec->cinfo.jpeg_color_space;
-  dec->cinfo.dct_method = dec->idct_method;
-  dec->cinfo.raw_data_out = TRUE;
+  ctx->cinfo.do_fancy_upsampling = FALSE;
+  ctx->cinfo.do_block_smoothing = FALSE;
+  ctx->cinfo.out_color_space = ctx->cinfo.jpeg_color_space;
+  ctx->cinfo.dct_method = dec->idct_method;
+  ctx->cinfo.raw_data_out = TRUE;
 
   GST_LOG_OBJECT (dec, "starting decompress");
-  guarantee_huff_tables (&dec->cinfo);
-  if (!jpeg_start_decompress (&dec->cinfo)) {
+  guarantee_huff_tables (&ctx->cinfo);
+  if (!jpeg_start_decompress (&ctx->cinfo)) {
     GST_WARNING_OBJECT (dec, "failed to start decompression cycle");
   }
 
   /* sanity checks to get safe and reasonable output */
-  switch (dec->cinfo.jpeg_color_space) {
+  switch (ctx->cinfo.jpeg_color_space) {
     case JCS_GRAYSCALE:
-      if (dec->cinfo.num_components != 1)
+      if (ctx->cinfo.num_components != 1)
         goto invalid_yuvrgbgrayscale;
       break;
     case JCS_RGB:
-      if (dec->cinfo.num_components != 3 || dec->cinfo.max_v_samp_factor > 1 ||
-          dec->cinfo.max_h_samp_factor > 1)
+      if (ctx->cinfo.num_components != 3 || ctx->cinfo.max_v_samp_factor > 1 ||
+          ctx->cinfo.max_h_samp_factor > 1)
         goto invalid_yuvrgbgrayscale;
       break;
     case JCS_YCbCr:
-      if (dec->cinfo.num_components != 3 ||
-          r_v > 2 || r_v < dec->cinfo.comp_info[0].v_samp_factor ||
-          r_v < dec->cinfo.comp_info[1].v_samp_factor ||
-          r_h < dec->cinfo.comp_info[0].h_samp_factor ||
-          r_h < dec->cinfo.comp_info[1].h_samp_factor)
+      if (ctx->cinfo.num_components != 3 ||
+          r_v > 2 || r_v < ctx->cinfo.comp_info[0].v_samp_factor ||
+          r_v < ctx->cinfo.comp_info[1].v_samp_factor ||
+          r_h < ctx->cinfo.comp_info[0].h_samp_factor ||
+          r_h < ctx->cinfo.comp_info[1].h_samp_factor)
         goto invalid_yuvrgbgrayscale;
       break;
     default:
@@ -1084,14 +1216,14 @@ gst_jpeg_dec_handle_frame (GstVideoDecoder * bdec, GstVideoCodecFrame * frame)
       break;
   }
 
-  width = dec->cinfo.output_width;
-  height = dec->cinfo.output_height;
+  width = ctx->cinfo.output_width;
+  height = ctx->cinfo.output_height;
 
   if (G_UNLIKELY (width < MIN_WIDTH || width > MAX_WIDTH ||
           height < MIN_HEIGHT || height > MAX_HEIGHT))
     goto wrong_size;
 
-  gst_jpeg_dec_negotiate (dec, width, height, dec->cinfo.jpeg_color_space);
+  gst_jpeg_dec_negotiate (dec, width, height, ctx->cinfo.jpeg_color_space);
 
   state = gst_video_decoder_get_output_state (bdec);
   ret = gst_video_decoder_allocate_output_frame (bdec, frame);
@@ -1102,52 +1234,29 @@ gst_jpeg_dec_handle_frame (GstVideoDecoder * bdec, GstVideoCodecFrame * frame)
           GST_MAP_READWRITE))
     goto alloc_failed;
 
-  if (setjmp (dec->jerr.setjmp_buffer)) {
-    code = dec->jerr.pub.msg_code;
+  if (setjmp (ctx->jerr.setjmp_buffer)) {
+    code = ctx->jerr.pub.msg_code;
     gst_video_frame_unmap (&vframe);
     goto decode_error;
   }
 
   GST_LOG_OBJECT (dec, "width %d, height %d", width, height);
 
-  if (dec->cinfo.jpeg_color_space == JCS_RGB) {
-    gst_jpeg_dec_decode_rgb (dec, &vframe);
-  } else if (dec->cinfo.jpeg_color_space == JCS_GRAYSCALE) {
-    gst_jpeg_dec_decode_grayscale (dec, &vframe);
-  } else {
-    GST_LOG_OBJECT (dec, "decompressing (reqired scanline buffer height = %u)",
-        dec->cinfo.rec_outbuf_height);
-
-    /* For some widths jpeglib requires more horizontal padding than I420 
-     * provides. In those cases we need to decode into separate buffers and then
-     * copy over the data into our final picture buffer, otherwise jpeglib might
-     * write over the end of a line into the beginning of the next line,
-     * resulting in blocky artifacts on the left side of the picture. */
-    if (G_UNLIKELY (width % (dec->cinfo.max_h_samp_factor * DCTSIZE) != 0
-            || dec->cinfo.comp_info[0].h_samp_factor != 2
-            || dec->cinfo.comp_info[1].h_samp_factor != 1
-            || dec->cinfo.comp_info[2].h_samp_factor != 1)) {
-      GST_CAT_LOG_OBJECT (GST_CAT_PERFORMANCE, dec,
-          "indirect decoding using extra buffer copy");
-      gst_jpeg_dec_decode_indirect (dec, &vframe, r_v, r_h,
-          dec->cinfo.num_components);
-    } else {
-      ret = gst_jpeg_dec_decode_direct (dec, &vframe);
-
-      if (G_UNLIKELY (ret != GST_FLOW_OK))
-        goto decode_direct_failed;
-    }
+  ret = gst_jpeg_dec_decode (dec, ctx, &vframe);
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    gst_video_frame_unmap (&vframe);
+    goto decode_direct_failed;
   }
 
   gst_video_frame_unmap (&vframe);
 
-  if (setjmp (dec->jerr.setjmp_buffer)) {
-    code = dec->jerr.pub.msg_code;
+  if (setjmp (ctx->jerr.setjmp_buffer)) {
+    code = ctx->jerr.pub.msg_code;
     goto decode_error;
   }
 
   GST_LOG_OBJECT (dec, "decompressing finished");
-  jpeg_finish_decompress (&dec->cinfo);
+  jpeg_finish_decompress (&ctx->cinfo);
 
   gst_buffer_unmap (frame->input_buffer, &dec->current_frame_map);
   ret = gst_video_decoder_finish_frame (bdec, frame);
@@ -1189,7 +1298,7 @@ decode_error:
   {
     gchar err_msg[JMSG_LENGTH_MAX];
 
-    dec->jerr.pub.format_message ((j_common_ptr) (&dec->cinfo), err_msg);
+    ctx->jerr.pub.format_message ((j_common_ptr) (&ctx->cinfo), err_msg);
 
     GST_VIDEO_DECODER_ERROR (dec, 1, STREAM, DECODE,
         (_("Failed to decode JPEG image")), ("Decode error #%u: %s", code,
@@ -1199,14 +1308,14 @@ decode_error:
     gst_video_decoder_drop_frame (bdec, frame);
     release_frame = FALSE;
     need_unmap = FALSE;
-    jpeg_abort_decompress (&dec->cinfo);
+    jpeg_abort_decompress (&ctx->cinfo);
 
     goto done;
   }
 decode_direct_failed:
   {
     /* already posted an error message */
-    jpeg_abort_decompress (&dec->cinfo);
+    jpeg_abort_decompress (&ctx->cinfo);
     goto done;
   }
 alloc_failed:
@@ -1217,13 +1326,13 @@ alloc_failed:
 
     GST_DEBUG_OBJECT (dec, "failed to alloc buffer, reason %s", reason);
     /* Reset for next time */
-    jpeg_abort_decompress (&dec->cinfo);
+    jpeg_abort_decompress (&ctx->cinfo);
     if (ret != GST_FLOW_EOS && ret != GST_FLOW_FLUSHING &&
         ret != GST_FLOW_NOT_LINKED) {
       GST_VIDEO_DECODER_ERROR (dec, 1, STREAM, DECODE,
           (_("Failed to decode JPEG image")),
           ("Buffer allocation failed, reason: %s", reason), ret);
-      jpeg_abort_decompress (&dec->cinfo);
+      jpeg_abort_decompress (&ctx->cinfo);
     }
     goto exit;
   }
@@ -1232,8 +1341,8 @@ components_not_supported:
     GST_VIDEO_DECODER_ERROR (dec, 1, STREAM, DECODE,
         (_("Failed to decode JPEG image")),
         ("number of components not supported: %d (max 3)",
-            dec->cinfo.num_components), ret);
-    jpeg_abort_decompress (&dec->cinfo);
+            ctx->cinfo.num_components), ret);
+    jpeg_abort_decompress (&ctx->cinfo);
     goto done;
   }
 unsupported_colorspace:
@@ -1241,7 +1350,7 @@ unsupported_colorspace:
     GST_VIDEO_DECODER_ERROR (dec, 1, STREAM, DECODE,
         (_("Failed to decode JPEG image")),
         ("Picture has unknown or unsupported colourspace"), ret);
-    jpeg_abort_decompress (&dec->cinfo);
+    jpeg_abort_decompress (&ctx->cinfo);
     goto done;
   }
 invalid_yuvrgbgrayscale:
@@ -1249,7 +1358,127 @@ invalid_yuvrgbgrayscale:
     GST_VIDEO_DECODER_ERROR (dec, 1, STREAM, DECODE,
         (_("Failed to decode JPEG image")),
         ("Picture is corrupt or unhandled YUV/RGB/grayscale layout"), ret);
-    jpeg_abort_decompress (&dec->cinfo);
+    jpeg_abort_decompress (&ctx->cinfo);
+    goto done;
+  }
+}
+
+/* Same checks as in handle_frame(), which posts the errors for the frames
+ * that don't pass them */
+static gboolean
+gst_jpeg_dec_context_is_supported (GstJpegDecContext * ctx)
+{
+  jpeg_component_info *comp = ctx->cinfo.comp_info;
+  gint r_h, r_v;
+
+  if (!ctx->cinfo.num_components || !comp || ctx->cinfo.num_components > 3)
+    return FALSE;
+
+  r_h = comp[0].h_samp_factor;
+  r_v = comp[0].v_samp_factor;
+
+  switch (ctx->cinfo.jpeg_color_space) {
+    case JCS_GRAYSCALE:
+      return ctx->cinfo.num_components == 1;
+    case JCS_RGB:
+      return ctx->cinfo.num_components == 3 &&
+          ctx->cinfo.max_v_samp_factor <= 1 &&
+          ctx->cinfo.max_h_samp_factor <= 1;
+    case JCS_YCbCr:
+      return ctx->cinfo.num_components == 3 && r_v <= 2 &&
+          r_v >= comp[1].v_samp_factor && comp[2].v_samp_factor <= 2 &&
+          r_h >= comp[1].h_samp_factor;
+    default:
+      return FALSE;
+  }
+}
+
+/* Called from the base class' decoding threads. Every frame that can't be
+ * decoded into the current output state, or fails to decode, is handed back
+ * to handle_frame() so that renegotiation and error reporting only happen
+ * from the streaming thread */
+static GstFlowReturn
+gst_jpeg_dec_decode_parallel (GstVideoDecoder * bdec,
+    GstVideoCodecFrame * frame)
+{
+  GstJpegDec *dec = (GstJpegDec *) bdec;
+  GstJpegDecContext *ctx;
+  GstVideoCodecState *state;
+  GstVideoInfo *info;
+  GstVideoFrame vframe;
+  GstMapInfo map;
+  GstFlowReturn ret = GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+  volatile gboolean frame_mapped = FALSE;
+
+  state = gst_video_decoder_get_output_state (bdec);
+  if (G_UNLIKELY (state == NULL))
+    return GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+  info = &state->info;
+
+  if (!gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ)) {
+    gst_video_codec_state_unref (state);
+    return GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
+  }
+
+  ctx = gst_jpeg_dec_acquire_context (dec);
+  ctx->cinfo.src->next_input_byte = map.data;
+  ctx->cinfo.src->bytes_in_buffer = map.size;
+
+  if (setjmp (ctx->jerr.setjmp_buffer)) {
+    if (frame_mapped)
+      gst_video_frame_unmap (&vframe);
+    goto serial;
+  }
+
+  jpeg_read_header (&ctx->cinfo, TRUE);
+  if (!gst_jpeg_dec_context_is_supported (ctx))
+    goto serial;
+
+  /* prepare for raw output */
+  ctx->cinfo.do_fancy_upsampling = FALSE;
+  ctx->cinfo.do_block_smoothing = FALSE;
+  ctx->cinfo.out_color_space = ctx->cinfo.jpeg_color_space;
+  ctx->cinfo.dct_method = dec->idct_method;
+  ctx->cinfo.raw_data_out = TRUE;
+
+  guarantee_huff_tables (&ctx->cinfo);
+  if (!jpeg_start_decompress (&ctx->cinfo))
+    goto serial;
+
+  if (ctx->cinfo.output_width != GST_VIDEO_INFO_WIDTH (info) ||
+      ctx->cinfo.output_height != GST_VIDEO_INFO_HEIGHT (info) ||
+      gst_jpeg_dec_get_format (ctx->cinfo.jpeg_color_space) !=
+      GST_VIDEO_INFO_FORMAT (info))
+    goto serial;
+
+  if (!gst_video_frame_map (&vframe, info, frame->output_buffer,
+          GST_MAP_READWRITE))
+    goto serial;
+  frame_mapped = TRUE;
+
+  ret = gst_jpeg_dec_decode (dec, ctx, &vframe);
+
+  frame_mapped = FALSE;
+  gst_video_frame_unmap (&vframe);
+
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto serial;
+
+  jpeg_finish_decompress (&ctx->cinfo);
+
+done:
+  gst_jpeg_dec_release_context (dec, ctx);
+  gst_buffer_unmap (frame->input_buffer, &map);
+  gst_video_codec_state_unref (state);
+
+  return ret;
+
+serial:
+  {
+    GST_DEBUG_OBJECT (dec, "can't decode frame %d in parallel",
+        frame->system_frame_number);
+    jpeg_abort_decompress (&ctx->cinfo);
+    ret = GST_VIDEO_DECODER_FLOW_DECODE_SERIAL;
     goto done;
   }
 }
@@ -1299,7 +1528,7 @@ gst_jpeg_dec_flush (GstVideoDecoder * bdec)
 {
   GstJpegDec *dec = (GstJpegDec *) bdec;
 
-  jpeg_abort_decompress (&dec->cinfo);
+  jpeg_abort_decompress (&dec->ctx.cinfo);
   dec->parse_entropy_len = 0;
   dec->parse_resync = FALSE;
   dec->saw_header = FALSE;
@@ -1324,6 +1553,11 @@ gst_jpeg_dec_set_property (GObject * object, guint prop_id,
       g_atomic_int_set (&dec->max_errors, g_value_get_int (value));
       break;
 #endif
+    case PROP_MAX_THREADS:
+      dec->max_threads = g_value_get_int (value);
+      gst_video_decoder_set_decode_threads (GST_VIDEO_DECODER (dec),
+          dec->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1347,6 +1581,9 @@ gst_jpeg_dec_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_int (value, g_atomic_int_get (&dec->max_errors));
       break;
 #endif
+    case PROP_MAX_THREADS:
+      g_value_set_int (value, dec->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1358,7 +1595,7 @@ gst_jpeg_dec_stop (GstVideoDecoder * bdec)
 {
   GstJpegDec *dec = (GstJpegDec *) bdec;
 
-  gst_jpeg_dec_free_buffers (dec);
+  gst_jpeg_dec_free_buffers (&dec->ctx);
 
   return TRUE;
 }
@@ -63,6 +63,18 @@ struct GstJpegDecSourceMgr {
   GstJpegDec              *dec;
 };
 
+/* libjpeg state for decoding one frame at a time, the element has one for
+ * the streaming thread and keeps a pool of them for parallel decoding */
+typedef struct {
+  struct jpeg_decompress_struct cinfo;
+  struct GstJpegDecErrorMgr     jerr;
+  struct GstJpegDecSourceMgr    jsrc;
+
+  /* arrays for indirect decoding */
+  gboolean idr_width_allocated;
+  guchar *idr_y[16],*idr_u[16],*idr_v[16];
+} GstJpegDecContext;
+
 /* Can't use GstBaseTransform, because GstBaseTransform
  * doesn't handle the N buffers in, 1 buffer out case,
  * but only the 1-in 1-out case */
@@ -82,14 +94,14 @@ struct _GstJpegDec {
   /* properties */
   gint     idct_method;
   gint     max_errors;  /* ATOMIC */
+  gint     max_threads;
 
-  struct jpeg_decompress_struct cinfo;
-  struct GstJpegDecErrorMgr     jerr;
-  struct GstJpegDecSourceMgr    jsrc;
+  GstJpegDecContext ctx;
+
+  /* contexts not in use by a decoding thread */
+  GMutex   contexts_lock;
+  GSList  *free_contexts;
 
-  /* arrays for indirect decoding */
-  gboolean idr_width_allocated;
-  guchar *idr_y[16],*idr_u[16],*idr_v[16];
   /* current (parsed) image size */
   guint    rem_img_len;
 };
@@ -47,14 +47,103 @@ enum
 
 #define DEFAULT_SNAPSHOT                FALSE
 #define DEFAULT_COMPRESSION_LEVEL       6
+#define DEFAULT_COMPRESSION_STRATEGY    Z_DEFAULT_STRATEGY
+#define DEFAULT_FILTER                  PNG_FILTER_VALUE_NONE
+#define DEFAULT_NUM_STRIPES             1
+#define DEFAULT_MAX_THREADS             1
 
 enum
 {
   ARG_0,
   ARG_SNAPSHOT,
-  ARG_COMPRESSION_LEVEL
+  ARG_COMPRESSION_LEVEL,
+  ARG_COMPRESSION_STRATEGY,
+  ARG_FILTER,
+  ARG_NUM_STRIPES,
+  ARG_MAX_THREADS
 };
 
+#define GST_TYPE_PNGENC_COMPRESSION_STRATEGY \
+    (gst_pngenc_compression_strategy_get_type ())
+static GType
+gst_pngenc_compression_strategy_get_type (void)
+{
+  static GType strategy_type = 0;
+  static const GEnumValue strategies[] = {
+    {Z_DEFAULT_STRATEGY, "Default", "default"},
+    {Z_FILTERED, "Filtered data", "filtered"},
+    {Z_HUFFMAN_ONLY, "Huffman coding only", "huffman-only"},
+    {Z_RLE, "Run-length encoding", "rle"},
+    {Z_FIXED, "Fixed Huffman codes", "fixed"},
+    {0, NULL, NULL}
+  };
+
+  if (!strategy_type) {
+    strategy_type =
+        g_enum_register_static ("GstPngEncCompressionStrategy", strategies);
+  }
+  return strategy_type;
+}
+
+#define GST_TYPE_PNGENC_FILTER (gst_pngenc_filter_get_type ())
+static GType
+gst_pngenc_filter_get_type (void)
+{
+  static GType filter_type = 0;
+  static const GEnumValue filters[] = {
+    {PNG_FILTER_VALUE_NONE, "No filtering", "none"},
+    {PNG_FILTER_VALUE_SUB, "Difference to the left pixel", "sub"},
+    {PNG_FILTER_VALUE_UP, "Difference to the pixel above", "up"},
+    {PNG_FILTER_VALUE_AVG, "Difference to the average of left and above",
+        "average"},
+    {PNG_FILTER_VALUE_PAETH, "Paeth predictor", "paeth"},
+    {0, NULL, NULL}
+  };
+
+  if (!filter_type) {
+    filter_type = g_enum_register_static ("GstPngEncFilter", filters);
+  }
+  return filter_type;
+}
+
+/* encoding settings of one frame, taken when it is queued */
+typedef struct
+{
+  GstPngEnc *pngenc;
+  GstVideoCodecFrame *frame;
+  GstBuffer *buffer_out;
+
+  guint compression_level;
+  gint compression_strategy;
+  gint filter;
+  guint num_stripes;
+
+  GstFlowReturn ret;
+  gboolean done;
+} GstPngEncJob;
+
+/* a range of rows that is filtered and deflated on its own */
+typedef struct
+{
+  GstPngEncJob *job;
+  GstVideoFrame *vframe;
+  guint first_row;
+  guint n_rows;
+  guint row_bytes;
+  guint bpp;
+
+  /* room for the zlib header before, and the checksum after the data */
+  gsize head;
+  gsize tail;
+
+  guint8 *data;
+  gsize size;
+  guint32 adler;
+  gboolean last;
+  gboolean ok;
+  gboolean done;
+} GstPngEncStripe;
+
 static GstStaticPadTemplate pngenc_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -85,6 +174,11 @@ static gboolean gst_pngenc_set_format (GstVideoEncoder * encoder,
     GstVideoCodecState * state);
 static gboolean gst_pngenc_propose_allocation (GstVideoEncoder * encoder,
     GstQuery * query);
+static gboolean gst_pngenc_stop (GstVideoEncoder * encoder);
+static GstFlowReturn gst_pngenc_finish (GstVideoEncoder * encoder);
+static gboolean gst_pngenc_flush (GstVideoEncoder * encoder);
+static GstFlowReturn gst_pngenc_finish_jobs (GstPngEnc * pngenc,
+    guint max_pending, gboolean discard);
 
 static void gst_pngenc_finalize (GObject * object);
 
@@ -128,6 +222,61 @@ gst_pngenc_class_init (GstPngEncClass * klass)
           DEFAULT_COMPRESSION_LEVEL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPngEnc:compression-strategy:
+   *
+   * The zlib strategy used for compressing the image data. Run-length
+   * encoding together with no filtering is a lot faster than the defaults
+   * and compresses screen content about as well.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, ARG_COMPRESSION_STRATEGY,
+      g_param_spec_enum ("compression-strategy", "Compression strategy",
+          "zlib compression strategy", GST_TYPE_PNGENC_COMPRESSION_STRATEGY,
+          DEFAULT_COMPRESSION_STRATEGY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPngEnc:filter:
+   *
+   * The filter applied to every row before compression.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, ARG_FILTER,
+      g_param_spec_enum ("filter", "Filter",
+          "Row filter applied before compression", GST_TYPE_PNGENC_FILTER,
+          DEFAULT_FILTER, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPngEnc:num-stripes:
+   *
+   * Split the rows of each image into this many stripes that are
+   * compressed in parallel. The stripes don't share compression history,
+   * so the output gets slightly bigger.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, ARG_NUM_STRIPES,
+      g_param_spec_uint ("num-stripes", "Number of stripes",
+          "Number of stripes of rows compressed in parallel", 1, 256,
+          DEFAULT_NUM_STRIPES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPngEnc:max-threads:
+   *
+   * Maximum number of frames encoded in parallel. The frames are still
+   * output in order.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, ARG_MAX_THREADS,
+      g_param_spec_int ("max-threads", "Maximum threads",
+          "Maximum number of frames encoded in parallel "
+          "(0 = one per processor)", 0, G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template
       (element_class, &pngenc_sink_template);
   gst_element_class_add_static_pad_template
@@ -140,6 +289,9 @@ gst_pngenc_class_init (GstPngEncClass * klass)
   venc_class->set_format = gst_pngenc_set_format;
   venc_class->handle_frame = gst_pngenc_handle_frame;
   venc_class->propose_allocation = gst_pngenc_propose_allocation;
+  venc_class->stop = gst_pngenc_stop;
+  venc_class->finish = gst_pngenc_finish;
+  venc_class->flush = gst_pngenc_flush;
   gobject_class->finalize = gst_pngenc_finalize;
 
   GST_DEBUG_CATEGORY_INIT (pngenc_debug, "pngenc", 0, "PNG image encoder");
@@ -157,6 +309,9 @@ gst_pngenc_set_format (GstVideoEncoder * encoder, GstVideoCodecState * state)
   pngenc = GST_PNGENC (encoder);
   info = &state->info;
 
+  /* the pending frames are encoded with the previous format */
+  gst_pngenc_finish_jobs (pngenc, 0, FALSE);
+
   switch (GST_VIDEO_INFO_FORMAT (info)) {
     case GST_VIDEO_FORMAT_RGBA:
       pngenc->png_color_type = PNG_COLOR_TYPE_RGBA;
@@ -202,11 +357,16 @@ gst_pngenc_init (GstPngEnc * pngenc)
   GST_PAD_SET_ACCEPT_TEMPLATE (GST_VIDEO_ENCODER_SINK_PAD (pngenc));
 
   /* init settings */
-  pngenc->png_struct_ptr = NULL;
-  pngenc->png_info_ptr = NULL;
-
   pngenc->snapshot = DEFAULT_SNAPSHOT;
   pngenc->compression_level = DEFAULT_COMPRESSION_LEVEL;
+  pngenc->compression_strategy = DEFAULT_COMPRESSION_STRATEGY;
+  pngenc->filter = DEFAULT_FILTER;
+  pngenc->num_stripes = DEFAULT_NUM_STRIPES;
+  pngenc->max_threads = DEFAULT_MAX_THREADS;
+
+  g_queue_init (&pngenc->encode_jobs);
+  g_mutex_init (&pngenc->encode_lock);
+  g_cond_init (&pngenc->encode_cond);
 }
 
 static void
@@ -217,9 +377,30 @@ gst_pngenc_finalize (GObject * object)
   if (pngenc->input_state)
     gst_video_codec_state_unref (pngenc->input_state);
 
+  g_mutex_clear (&pngenc->encode_lock);
+  g_cond_clear (&pngenc->encode_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static gboolean
+gst_pngenc_stop (GstVideoEncoder * encoder)
+{
+  GstPngEnc *pngenc = GST_PNGENC (encoder);
+
+  gst_pngenc_finish_jobs (pngenc, 0, TRUE);
+  if (pngenc->encode_pool) {
+    g_thread_pool_free (pngenc->encode_pool, FALSE, TRUE);
+    pngenc->encode_pool = NULL;
+  }
+  if (pngenc->stripe_pool) {
+    g_thread_pool_free (pngenc->stripe_pool, FALSE, TRUE);
+    pngenc->stripe_pool = NULL;
+  }
+
+  return TRUE;
+}
+
 static void
 user_flush_data (png_structp png_ptr G_GNUC_UNUSED)
 {
@@ -228,11 +409,13 @@ user_flush_data (png_structp png_ptr G_GNUC_UNUSED)
 static void
 user_write_data (png_structp png_ptr, png_bytep data, png_uint_32 length)
 {
+  GstPngEncJob *job;
   GstPngEnc *pngenc;
   GstMemory *mem;
   GstMapInfo minfo;
 
-  pngenc = (GstPngEnc *) png_get_io_ptr (png_ptr);
+  job = (GstPngEncJob *) png_get_io_ptr (png_ptr);
+  pngenc = job->pngenc;
 
   mem = gst_allocator_alloc (NULL, length, NULL);
   if (!mem) {
@@ -256,44 +439,252 @@ user_write_data (png_structp png_ptr, png_bytep data, png_uint_32 length)
   memcpy (minfo.data, data, length);
   gst_memory_unmap (mem, &minfo);
 
-  gst_buffer_append_memory (pngenc->buffer_out, mem);
+  gst_buffer_append_memory (job->buffer_out, mem);
+}
+
+/* Writes the filter type and the filtered @row to @out, @prev is the
+ * unfiltered row above or %NULL for the first row of the image */
+static void
+gst_pngenc_filter_row (gint filter, const guint8 * row, const guint8 * prev,
+    guint row_bytes, guint bpp, guint8 * out)
+{
+  guint i;
+
+  *out++ = filter;
+
+  switch (filter) {
+    case PNG_FILTER_VALUE_SUB:
+      for (i = 0; i < row_bytes; i++)
+        out[i] = row[i] - (i >= bpp ? row[i - bpp] : 0);
+      break;
+    case PNG_FILTER_VALUE_UP:
+      for (i = 0; i < row_bytes; i++)
+        out[i] = row[i] - (prev ? prev[i] : 0);
+      break;
+    case PNG_FILTER_VALUE_AVG:
+      for (i = 0; i < row_bytes; i++) {
+        guint a = i >= bpp ? row[i - bpp] : 0;
+        guint b = prev ? prev[i] : 0;
+
+        out[i] = row[i] - ((a + b) >> 1);
+      }
+      break;
+    case PNG_FILTER_VALUE_PAETH:
+      for (i = 0; i < row_bytes; i++) {
+        gint a = i >= bpp ? row[i - bpp] : 0;
+        gint b = prev ? prev[i] : 0;
+        gint c = (prev && i >= bpp) ? prev[i - bpp] : 0;
+        gint pa = ABS (b - c), pb = ABS (a - c), pc = ABS (a + b - 2 * c);
+
+        out[i] = row[i] - ((pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c);
+      }
+      break;
+    default:
+      memcpy (out, row, row_bytes);
+      break;
+  }
+}
+
+/* Filters and deflates the rows of @stripe into a raw deflate stream that
+ * ends on a byte boundary, so that it can be followed by the next one */
+static void
+gst_pngenc_deflate_stripe (GstPngEncStripe * stripe)
+{
+  GstPngEncJob *job = stripe->job;
+  GstVideoFrame *vframe = stripe->vframe;
+  guint8 *pixels = GST_VIDEO_FRAME_COMP_DATA (vframe, 0);
+  gint stride = GST_VIDEO_FRAME_COMP_STRIDE (vframe, 0);
+  guint8 *row_out;
+  z_stream zs;
+  gsize bound;
+  guint i;
+  gint res = Z_OK;
+
+  stripe->ok = FALSE;
+  stripe->adler = adler32 (0L, Z_NULL, 0);
+
+  memset (&zs, 0, sizeof (zs));
+  if (deflateInit2 (&zs, job->compression_level, Z_DEFLATED, -MAX_WBITS, 8,
+          job->compression_strategy) != Z_OK)
+    return;
+
+  /* the bound is for a finished stream, a sync flush adds an empty stored
+   * block of 5 bytes at most */
+  bound = deflateBound (&zs, stripe->n_rows * (stripe->row_bytes + 1)) + 8;
+  stripe->data = g_malloc (stripe->head + bound + stripe->tail);
+  row_out = g_malloc (stripe->row_bytes + 1);
+
+  zs.next_out = stripe->data + stripe->head;
+  zs.avail_out = bound;
+
+  for (i = 0; i < stripe->n_rows; i++) {
+    guint row = stripe->first_row + i;
+    gint flush = Z_NO_FLUSH;
+
+    gst_pngenc_filter_row (job->filter, pixels + row * stride,
+        row > 0 ? pixels + (row - 1) * stride : NULL, stripe->row_bytes,
+        stripe->bpp, row_out);
+    stripe->adler = adler32 (stripe->adler, row_out, stripe->row_bytes + 1);
+
+    if (i == stripe->n_rows - 1)
+      flush = stripe->last ? Z_FINISH : Z_SYNC_FLUSH;
+
+    zs.next_in = row_out;
+    zs.avail_in = stripe->row_bytes + 1;
+    res = deflate (&zs, flush);
+    if ((res != Z_OK && res != Z_STREAM_END) || zs.avail_in != 0)
+      break;
+  }
+
+  stripe->ok = i == stripe->n_rows && zs.avail_out > 0
+      && (!stripe->last || res == Z_STREAM_END);
+  stripe->size = stripe->head + bound - zs.avail_out + stripe->tail;
+
+  g_free (row_out);
+  deflateEnd (&zs);
+}
+
+static void
+gst_pngenc_stripe_func (GstPngEncStripe * stripe, GstPngEnc * pngenc)
+{
+  gst_pngenc_deflate_stripe (stripe);
+
+  g_mutex_lock (&pngenc->encode_lock);
+  stripe->done = TRUE;
+  g_cond_broadcast (&pngenc->encode_cond);
+  g_mutex_unlock (&pngenc->encode_lock);
+}
+
+/* Writes the image data as one IDAT chunk per stripe. The raw deflate
+ * streams of the stripes together with a zlib header and the combined
+ * checksum make up the zlib stream PNG expects */
+static gboolean
+gst_pngenc_write_stripes (GstPngEncJob * job, png_structp png_ptr,
+    GstVideoFrame * vframe)
+{
+  GstPngEnc *pngenc = job->pngenc;
+  guint height = GST_VIDEO_FRAME_HEIGHT (vframe);
+  guint rows, n_stripes, i;
+  GstPngEncStripe *stripes, *last;
+  gboolean ok = TRUE;
+  guint16 header;
+  guint32 adler;
+  gint level_flags;
+
+  rows = (height + job->num_stripes - 1) / job->num_stripes;
+  n_stripes = (height + rows - 1) / rows;
+
+  stripes = g_new0 (GstPngEncStripe, n_stripes);
+  for (i = 0; i < n_stripes; i++) {
+    stripes[i].job = job;
+    stripes[i].vframe = vframe;
+    stripes[i].first_row = i * rows;
+    stripes[i].n_rows = MIN (rows, height - i * rows);
+    stripes[i].bpp = GST_VIDEO_FRAME_COMP_PSTRIDE (vframe, 0);
+    stripes[i].row_bytes = GST_VIDEO_FRAME_WIDTH (vframe) * stripes[i].bpp;
+    stripes[i].head = (i == 0) ? 2 : 0;
+    stripes[i].last = (i == n_stripes - 1);
+    stripes[i].tail = stripes[i].last ? 4 : 0;
+  }
+  last = &stripes[n_stripes - 1];
+
+  /* the first stripe is done by this thread */
+  for (i = 1; i < n_stripes; i++)
+    g_thread_pool_push (pngenc->stripe_pool, &stripes[i], NULL);
+  gst_pngenc_deflate_stripe (&stripes[0]);
+
+  g_mutex_lock (&pngenc->encode_lock);
+  for (i = 1; i < n_stripes; i++) {
+    while (!stripes[i].done)
+      g_cond_wait (&pngenc->encode_cond, &pngenc->encode_lock);
+  }
+  g_mutex_unlock (&pngenc->encode_lock);
+
+  for (i = 0; i < n_stripes; i++)
+    ok &= stripes[i].ok;
+  if (!ok)
+    goto done;
+
+  /* same header as zlib would write for a 32k window */
+  if (job->compression_strategy >= Z_HUFFMAN_ONLY
+      || job->compression_level < 2)
+    level_flags = 0;
+  else if (job->compression_level < 6)
+    level_flags = 1;
+  else if (job->compression_level == 6)
+    level_flags = 2;
+  else
+    level_flags = 3;
+  header = (0x78 << 8) | (level_flags << 6);
+  header += 31 - (header % 31);
+  GST_WRITE_UINT16_BE (stripes[0].data, header);
+
+  adler = stripes[0].adler;
+  for (i = 1; i < n_stripes; i++)
+    adler = adler32_combine (adler, stripes[i].adler,
+        stripes[i].n_rows * (stripes[i].row_bytes + 1));
+  GST_WRITE_UINT32_BE (last->data + last->size - 4, adler);
+
+  for (i = 0; i < n_stripes; i++)
+    png_write_chunk (png_ptr, (png_bytep) "IDAT", stripes[i].data,
+        stripes[i].size);
+
+done:
+  for (i = 0; i < n_stripes; i++)
+    g_free (stripes[i].data);
+  g_free (stripes);
+
+  return ok;
 }
 
+/* Encodes the frame of @job into its output buffer. Called from the
+ * encoding threads, so must not take the stream lock */
 static GstFlowReturn
-gst_pngenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
+gst_pngenc_encode_frame (GstPngEnc * pngenc, GstPngEncJob * job)
 {
-  GstPngEnc *pngenc;
-  gint row_index;
+  GstVideoInfo *info = &pngenc->input_state->info;
+  png_structp png_struct_ptr;
+  png_infop png_info_ptr;
   png_byte **row_pointers;
-  GstFlowReturn ret = GST_FLOW_OK;
-  GstVideoInfo *info;
   GstVideoFrame vframe;
+  gint row_index;
 
-  pngenc = GST_PNGENC (encoder);
-  info = &pngenc->input_state->info;
-
-  GST_DEBUG_OBJECT (pngenc, "BEGINNING");
+  GST_DEBUG_OBJECT (pngenc, "Encoding frame %d",
+      job->frame->system_frame_number);
 
   /* initialize png struct stuff */
-  pngenc->png_struct_ptr = png_create_write_struct (PNG_LIBPNG_VER_STRING,
+  png_struct_ptr = png_create_write_struct (PNG_LIBPNG_VER_STRING,
       (png_voidp) NULL, user_error_fn, user_warning_fn);
-  if (pngenc->png_struct_ptr == NULL)
+  if (png_struct_ptr == NULL)
     goto struct_init_fail;
 
-  pngenc->png_info_ptr = png_create_info_struct (pngenc->png_struct_ptr);
-  if (!pngenc->png_info_ptr)
+  png_info_ptr = png_create_info_struct (png_struct_ptr);
+  if (!png_info_ptr)
     goto png_info_fail;
 
+  if (!gst_video_frame_map (&vframe, info, job->frame->input_buffer,
+          GST_MAP_READ))
+    goto map_fail;
+
+  row_pointers = g_new (png_byte *, GST_VIDEO_INFO_HEIGHT (info));
+  for (row_index = 0; row_index < GST_VIDEO_INFO_HEIGHT (info); row_index++) {
+    row_pointers[row_index] = GST_VIDEO_FRAME_COMP_DATA (&vframe, 0) +
+        (row_index * GST_VIDEO_FRAME_COMP_STRIDE (&vframe, 0));
+  }
+
+  /* allocate the output buffer */
+  job->buffer_out = gst_buffer_new ();
+
   /* non-0 return is from a longjmp inside of libpng */
-  if (setjmp (png_jmpbuf (pngenc->png_struct_ptr)) != 0)
+  if (setjmp (png_jmpbuf (png_struct_ptr)) != 0)
     goto longjmp_fail;
 
-  png_set_filter (pngenc->png_struct_ptr, 0,
-      PNG_FILTER_NONE | PNG_FILTER_VALUE_NONE);
-  png_set_compression_level (pngenc->png_struct_ptr, pngenc->compression_level);
+  png_set_filter (png_struct_ptr, 0, PNG_FILTER_NONE << job->filter);
+  png_set_compression_level (png_struct_ptr, job->compression_level);
+  png_set_compression_strategy (png_struct_ptr, job->compression_strategy);
 
-  png_set_IHDR (pngenc->png_struct_ptr,
-      pngenc->png_info_ptr,
+  png_set_IHDR (png_struct_ptr,
+      png_info_ptr,
       GST_VIDEO_INFO_WIDTH (info),
       GST_VIDEO_INFO_HEIGHT (info),
       pngenc->depth,
@@ -301,51 +692,29 @@ gst_pngenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
       PNG_INTERLACE_NONE,
       PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
 
-  png_set_write_fn (pngenc->png_struct_ptr, pngenc,
+  png_set_write_fn (png_struct_ptr, job,
       (png_rw_ptr) user_write_data, user_flush_data);
 
-  row_pointers = g_new (png_byte *, GST_VIDEO_INFO_HEIGHT (info));
-  if (!gst_video_frame_map (&vframe, &pngenc->input_state->info,
-          frame->input_buffer, GST_MAP_READ)) {
-    GST_ELEMENT_ERROR (pngenc, STREAM, FORMAT, (NULL),
-        ("Failed to map video frame, caps problem?"));
-    ret = GST_FLOW_ERROR;
-    goto done;
+  png_write_info (png_struct_ptr, png_info_ptr);
+  if (job->num_stripes > 1) {
+    if (!gst_pngenc_write_stripes (job, png_struct_ptr, &vframe))
+      png_error (png_struct_ptr, "Failed to compress image stripes");
+    png_write_chunk (png_struct_ptr, (png_bytep) "IEND", NULL, 0);
+  } else {
+    png_write_image (png_struct_ptr, row_pointers);
+    png_write_end (png_struct_ptr, NULL);
   }
 
-  for (row_index = 0; row_index < GST_VIDEO_INFO_HEIGHT (info); row_index++) {
-    row_pointers[row_index] = GST_VIDEO_FRAME_COMP_DATA (&vframe, 0) +
-        (row_index * GST_VIDEO_FRAME_COMP_STRIDE (&vframe, 0));
-  }
-
-  /* allocate the output buffer */
-  pngenc->buffer_out = gst_buffer_new ();
-
-  png_write_info (pngenc->png_struct_ptr, pngenc->png_info_ptr);
-  png_write_image (pngenc->png_struct_ptr, row_pointers);
-  png_write_end (pngenc->png_struct_ptr, NULL);
-
   g_free (row_pointers);
   gst_video_frame_unmap (&vframe);
 
-  png_destroy_info_struct (pngenc->png_struct_ptr, &pngenc->png_info_ptr);
-  png_destroy_write_struct (&pngenc->png_struct_ptr, (png_infopp) NULL);
+  png_destroy_write_struct (&png_struct_ptr, &png_info_ptr);
 
   /* Set final size and store */
-  frame->output_buffer = pngenc->buffer_out;
-
-  pngenc->buffer_out = NULL;
-
-  if ((ret = gst_video_encoder_finish_frame (encoder, frame)) != GST_FLOW_OK)
-    goto done;
+  job->frame->output_buffer = job->buffer_out;
+  job->buffer_out = NULL;
 
-  if (pngenc->snapshot)
-    ret = GST_FLOW_EOS;
-
-done:
-  GST_DEBUG_OBJECT (pngenc, "END, ret:%d", ret);
-
-  return ret;
+  return GST_FLOW_OK;
 
   /* ERRORS */
 struct_init_fail:
@@ -357,21 +726,206 @@ struct_init_fail:
 
 png_info_fail:
   {
-    png_destroy_write_struct (&(pngenc->png_struct_ptr), (png_infopp) NULL);
+    png_destroy_write_struct (&png_struct_ptr, (png_infopp) NULL);
     GST_ELEMENT_ERROR (pngenc, LIBRARY, INIT, (NULL),
         ("Failed to initialize the png info structure"));
     return GST_FLOW_ERROR;
   }
 
+map_fail:
+  {
+    png_destroy_write_struct (&png_struct_ptr, &png_info_ptr);
+    GST_ELEMENT_ERROR (pngenc, STREAM, FORMAT, (NULL),
+        ("Failed to map video frame, caps problem?"));
+    return GST_FLOW_ERROR;
+  }
+
 longjmp_fail:
   {
-    png_destroy_write_struct (&pngenc->png_struct_ptr, &pngenc->png_info_ptr);
+    g_free (row_pointers);
+    gst_video_frame_unmap (&vframe);
+    gst_buffer_unref (job->buffer_out);
+    job->buffer_out = NULL;
+    png_destroy_write_struct (&png_struct_ptr, &png_info_ptr);
     GST_ELEMENT_ERROR (pngenc, LIBRARY, FAILED, (NULL),
         ("returning from longjmp"));
     return GST_FLOW_ERROR;
   }
 }
 
+static void
+gst_pngenc_init_job (GstPngEnc * pngenc, GstPngEncJob * job,
+    GstVideoCodecFrame * frame)
+{
+  job->pngenc = pngenc;
+  job->frame = frame;
+  job->buffer_out = NULL;
+  job->compression_level = pngenc->compression_level;
+  job->compression_strategy = pngenc->compression_strategy;
+  job->filter = pngenc->filter;
+  job->num_stripes = pngenc->num_stripes;
+  job->ret = GST_FLOW_OK;
+  job->done = FALSE;
+
+  if (job->num_stripes > 1 && pngenc->stripe_pool == NULL) {
+    pngenc->stripe_pool =
+        g_thread_pool_new ((GFunc) gst_pngenc_stripe_func, pngenc,
+        g_get_num_processors (), FALSE, NULL);
+  }
+}
+
+static void
+gst_pngenc_encode_job (GstPngEncJob * job, GstPngEnc * pngenc)
+{
+  GstFlowReturn ret;
+
+  ret = gst_pngenc_encode_frame (pngenc, job);
+
+  g_mutex_lock (&pngenc->encode_lock);
+  job->ret = ret;
+  job->done = TRUE;
+  g_cond_broadcast (&pngenc->encode_cond);
+  g_mutex_unlock (&pngenc->encode_lock);
+}
+
+/* Consumes the frame of a finished @job */
+static GstFlowReturn
+gst_pngenc_finish_job (GstPngEnc * pngenc, GstPngEncJob * job,
+    gboolean discard)
+{
+  GstFlowReturn ret;
+
+  if (discard || job->ret != GST_FLOW_OK) {
+    gst_video_codec_frame_unref (job->frame);
+    return discard ? GST_FLOW_OK : job->ret;
+  }
+
+  ret = gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (pngenc),
+      job->frame);
+  if (ret == GST_FLOW_OK && pngenc->snapshot)
+    ret = GST_FLOW_EOS;
+
+  return ret;
+}
+
+/* Finishes the frames encoded by the thread pool in input order, waiting
+ * until at most @max_pending frames are still being encoded. With @discard
+ * the frames are dropped instead of being pushed */
+static GstFlowReturn
+gst_pngenc_finish_jobs (GstPngEnc * pngenc, guint max_pending,
+    gboolean discard)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&pngenc->encode_lock);
+  while (pngenc->encode_jobs.length > 0) {
+    GstPngEncJob *job = g_queue_peek_head (&pngenc->encode_jobs);
+    GstFlowReturn res;
+
+    if (!job->done) {
+      if (pngenc->encode_jobs.length <= max_pending)
+        break;
+      g_cond_wait (&pngenc->encode_cond, &pngenc->encode_lock);
+      continue;
+    }
+    g_queue_pop_head (&pngenc->encode_jobs);
+    g_mutex_unlock (&pngenc->encode_lock);
+
+    res = gst_pngenc_finish_job (pngenc, job, discard);
+    g_slice_free (GstPngEncJob, job);
+
+    if (ret == GST_FLOW_OK)
+      ret = res;
+
+    g_mutex_lock (&pngenc->encode_lock);
+  }
+  g_mutex_unlock (&pngenc->encode_lock);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_pngenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
+{
+  GstPngEnc *pngenc;
+  GstPngEncJob *job;
+  GstFlowReturn ret;
+  gint n_threads;
+
+  pngenc = GST_PNGENC (encoder);
+
+  GST_DEBUG_OBJECT (pngenc, "BEGINNING");
+
+  n_threads = g_atomic_int_get (&pngenc->max_threads);
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  /* a snapshot is only ever a single frame */
+  if (n_threads == 1 || pngenc->snapshot) {
+    GstPngEncJob sync_job;
+
+    /* frames before this one might still be encoding in parallel */
+    ret = gst_pngenc_finish_jobs (pngenc, 0, FALSE);
+    if (ret != GST_FLOW_OK) {
+      gst_video_codec_frame_unref (frame);
+      goto done;
+    }
+
+    gst_pngenc_init_job (pngenc, &sync_job, frame);
+    sync_job.ret = gst_pngenc_encode_frame (pngenc, &sync_job);
+
+    ret = gst_pngenc_finish_job (pngenc, &sync_job, FALSE);
+    goto done;
+  }
+
+  if (pngenc->encode_pool == NULL) {
+    pngenc->encode_pool =
+        g_thread_pool_new ((GFunc) gst_pngenc_encode_job, pngenc,
+        n_threads, FALSE, NULL);
+  } else if (g_thread_pool_get_max_threads (pngenc->encode_pool) != n_threads) {
+    g_thread_pool_set_max_threads (pngenc->encode_pool, n_threads, NULL);
+  }
+
+  job = g_slice_new (GstPngEncJob);
+  gst_pngenc_init_job (pngenc, job, frame);
+
+  g_mutex_lock (&pngenc->encode_lock);
+  g_queue_push_tail (&pngenc->encode_jobs, job);
+  g_mutex_unlock (&pngenc->encode_lock);
+
+  g_thread_pool_push (pngenc->encode_pool, job, NULL);
+
+  /* push out what is done and keep at most one frame per thread queued */
+  ret = gst_pngenc_finish_jobs (pngenc, n_threads, FALSE);
+
+done:
+  GST_DEBUG_OBJECT (pngenc, "END, ret:%d", ret);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_pngenc_finish (GstVideoEncoder * encoder)
+{
+  GstPngEnc *pngenc = GST_PNGENC (encoder);
+
+  GST_DEBUG_OBJECT (pngenc, "Draining");
+
+  return gst_pngenc_finish_jobs (pngenc, 0, FALSE);
+}
+
+static gboolean
+gst_pngenc_flush (GstVideoEncoder * encoder)
+{
+  GstPngEnc *pngenc = GST_PNGENC (encoder);
+
+  GST_DEBUG_OBJECT (pngenc, "Flushing");
+
+  gst_pngenc_finish_jobs (pngenc, 0, TRUE);
+
+  return TRUE;
+}
+
 static gboolean
 gst_pngenc_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
 {
@@ -396,6 +950,18 @@ gst_pngenc_get_property (GObject * object,
     case ARG_COMPRESSION_LEVEL:
       g_value_set_uint (value, pngenc->compression_level);
       break;
+    case ARG_COMPRESSION_STRATEGY:
+      g_value_set_enum (value, pngenc->compression_strategy);
+      break;
+    case ARG_FILTER:
+      g_value_set_enum (value, pngenc->filter);
+      break;
+    case ARG_NUM_STRIPES:
+      g_value_set_uint (value, pngenc->num_stripes);
+      break;
+    case ARG_MAX_THREADS:
+      g_value_set_int (value, g_atomic_int_get (&pngenc->max_threads));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -418,6 +984,18 @@ gst_pngenc_set_property (GObject * object,
     case ARG_COMPRESSION_LEVEL:
       pngenc->compression_level = g_value_get_uint (value);
       break;
+    case ARG_COMPRESSION_STRATEGY:
+      pngenc->compression_strategy = g_value_get_enum (value);
+      break;
+    case ARG_FILTER:
+      pngenc->filter = g_value_get_enum (value);
+      break;
+    case ARG_NUM_STRIPES:
+      pngenc->num_stripes = g_value_get_uint (value);
+      break;
+    case ARG_MAX_THREADS:
+      g_atomic_int_set (&pngenc->max_threads, g_value_get_int (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -46,17 +46,26 @@ struct _GstPngEnc
   GstVideoEncoder parent;
 
   GstVideoCodecState *input_state;
-  GstBuffer *buffer_out;
-
-  png_structp png_struct_ptr;
-  png_infop png_info_ptr;
 
   gint png_color_type;
   gint depth;
   guint compression_level;
+  gint compression_strategy;
+  gint filter;
+  guint num_stripes;
+  gint max_threads;
 
   gboolean snapshot;
   gboolean newmedia;
+
+  /* frames being encoded by the thread pool, in input order */
+  GThreadPool *encode_pool;
+  GQueue encode_jobs;
+  GMutex encode_lock;
+  GCond encode_cond;
+
+  /* stripes of a frame being deflated in parallel */
+  GThreadPool *stripe_pool;
 };
 
 struct _GstPngEncClass
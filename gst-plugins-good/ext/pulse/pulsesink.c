@@ -71,8 +71,15 @@ GST_DEBUG_CATEGORY_EXTERN (pulse_debug);
 #define DEFAULT_DEVICE_NAME     NULL
 #define DEFAULT_VOLUME          1.0
 #define DEFAULT_MUTE            FALSE
+#define DEFAULT_ADAPTIVE_LATENCY FALSE
 #define MAX_VOLUME              10.0
 
+/* adaptive latency: never grow the server side buffer beyond this many
+ * times the configured buffer-time, and give back one segment after this
+ * long without underflows */
+#define ADAPTIVE_MAX_TLENGTH_FACTOR 4
+#define ADAPTIVE_SHRINK_INTERVAL    (10 * G_USEC_PER_SEC)
+
 enum
 {
   PROP_0,
@@ -84,6 +91,7 @@ enum
   PROP_MUTE,
   PROP_CLIENT_NAME,
   PROP_STREAM_PROPERTIES,
+  PROP_ADAPTIVE_LATENCY,
   PROP_LAST
 };
 
@@ -177,6 +185,10 @@ struct _GstPulseRingBuffer
   gint64 m_offset;
   gint64 m_lastoffset;
 
+  /* adaptive latency, protected by the mainloop lock */
+  guint32 base_tlength;
+  gint64 last_adjust;
+
   gboolean corked:1;
   gboolean in_commit:1;
   gboolean paused:1;
@@ -264,6 +276,9 @@ gst_pulseringbuffer_init (GstPulseRingBuffer * pbuf)
   pbuf->m_offset = 0;
   pbuf->m_lastoffset = 0;
 
+  pbuf->base_tlength = 0;
+  pbuf->last_adjust = 0;
+
   pbuf->corked = TRUE;
   pbuf->in_commit = FALSE;
   pbuf->paused = FALSE;
@@ -690,6 +705,67 @@ gst_pulsering_stream_request_cb (pa_stream * s, size_t length, void *userdata)
   }
 }
 
+static void
+gst_pulsering_buffer_attr_cb (pa_stream * s, int success, void *userdata)
+{
+  GstPulseSink *psink;
+  GstPulseRingBuffer *pbuf;
+  GstAudioRingBuffer *buf;
+  const pa_buffer_attr *actual;
+
+  pbuf = GST_PULSERING_BUFFER_CAST (userdata);
+  psink = GST_PULSESINK_CAST (GST_OBJECT_PARENT (pbuf));
+  buf = GST_AUDIO_RING_BUFFER_CAST (pbuf);
+
+  if (!success || !(actual = pa_stream_get_buffer_attr (s))) {
+    GST_WARNING_OBJECT (psink, "failed to change the target length");
+    return;
+  }
+
+  GST_INFO_OBJECT (psink, "tlength now %u bytes", actual->tlength);
+
+  /* let the pipeline pick up the new latency */
+  buf->spec.seglatency = MAX (actual->tlength / buf->spec.segsize, 1);
+  gst_element_post_message (GST_ELEMENT_CAST (psink),
+      gst_message_new_latency (GST_OBJECT_CAST (psink)));
+}
+
+/* grow or shrink the server side buffer by the given number of segments,
+ * between the configured buffer-time and ADAPTIVE_MAX_TLENGTH_FACTOR times
+ * that. Must be called with the mainloop lock */
+static void
+gst_pulsering_adjust_tlength (GstPulseRingBuffer * pbuf, gint segments)
+{
+  GstAudioRingBuffer *buf = GST_AUDIO_RING_BUFFER_CAST (pbuf);
+  const pa_buffer_attr *actual;
+  pa_buffer_attr attr;
+  pa_operation *o;
+  gint64 tlength;
+
+  pbuf->last_adjust = g_get_monotonic_time ();
+
+  if (!pbuf->stream || pbuf->base_tlength == 0 ||
+      !(actual = pa_stream_get_buffer_attr (pbuf->stream)))
+    return;
+
+  tlength = (gint64) actual->tlength + segments * buf->spec.segsize;
+  tlength = CLAMP (tlength, pbuf->base_tlength,
+      (gint64) pbuf->base_tlength * ADAPTIVE_MAX_TLENGTH_FACTOR);
+  if (tlength == actual->tlength)
+    return;
+
+  GST_DEBUG_OBJECT (buf, "changing tlength from %u to %u bytes",
+      actual->tlength, (guint32) tlength);
+
+  attr = *actual;
+  attr.tlength = tlength;
+  attr.prebuf = 0;
+
+  if ((o = pa_stream_set_buffer_attr (pbuf->stream, &attr,
+              gst_pulsering_buffer_attr_cb, pbuf)))
+    pa_operation_unref (o);
+}
+
 static void
 gst_pulsering_stream_underflow_cb (pa_stream * s, void *userdata)
 {
@@ -700,6 +776,10 @@ gst_pulsering_stream_underflow_cb (pa_stream * s, void *userdata)
   psink = GST_PULSESINK_CAST (GST_OBJECT_PARENT (pbuf));
 
   GST_WARNING_OBJECT (psink, "Got underflow");
+
+  /* we can't keep up with the current target length, buffer more */
+  if (psink->adaptive_latency && !pbuf->paused)
+    gst_pulsering_adjust_tlength (pbuf, 1);
 }
 
 static void
@@ -1040,6 +1120,9 @@ gst_pulseringbuffer_acquire (GstAudioRingBuffer * buf,
   spec->segsize = actual->minreq;
   spec->segtotal = actual->tlength / spec->segsize;
 
+  pbuf->base_tlength = actual->tlength;
+  pbuf->last_adjust = g_get_monotonic_time ();
+
   pa_threaded_mainloop_unlock (mainloop);
 
   return TRUE;
@@ -1487,6 +1570,11 @@ gst_pulseringbuffer_commit (GstAudioRingBuffer * buf, guint64 * sample,
   GST_DEBUG_OBJECT (psink, "entering commit");
   pbuf->in_commit = TRUE;
 
+  /* give back latency we added when there were no underflows for a while */
+  if (psink->adaptive_latency && G_UNLIKELY (g_get_monotonic_time () -
+          pbuf->last_adjust > ADAPTIVE_SHRINK_INTERVAL))
+    gst_pulsering_adjust_tlength (pbuf, -1);
+
   bpf = GST_AUDIO_INFO_BPF (&buf->spec.info);
   bufsize = buf->spec.segsize * buf->spec.segtotal;
 
@@ -1980,6 +2068,25 @@ gst_pulsesink_class_init (GstPulseSinkClass * klass)
           "list of pulseaudio stream properties",
           GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPulseSink:adaptive-latency:
+   *
+   * Grow the amount of audio buffered in the server by one segment whenever
+   * an underflow happens, up to four times #GstAudioBaseSink:buffer-time,
+   * and shrink it again by one segment every 10 seconds without underflows.
+   * A latency message is posted on every change. This allows starting with
+   * a low buffer-time on systems where the achievable latency is not known
+   * in advance.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_ADAPTIVE_LATENCY,
+      g_param_spec_boolean ("adaptive-latency", "Adaptive latency",
+          "Increase the latency on underflows and decrease it again when "
+          "playback is stable", DEFAULT_ADAPTIVE_LATENCY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "PulseAudio Audio Sink",
       "Sink/Audio", "Plays audio to a PulseAudio server", "Lennart Poettering");
@@ -2375,6 +2482,8 @@ gst_pulsesink_init (GstPulseSink * pulsesink)
   pulsesink->properties = NULL;
   pulsesink->proplist = NULL;
 
+  pulsesink->adaptive_latency = DEFAULT_ADAPTIVE_LATENCY;
+
   /* override with a custom clock */
   if (GST_AUDIO_BASE_SINK (pulsesink)->provided_clock)
     gst_object_unref (GST_AUDIO_BASE_SINK (pulsesink)->provided_clock);
@@ -2892,6 +3001,9 @@ gst_pulsesink_set_property (GObject * object,
         pa_proplist_free (pulsesink->proplist);
       pulsesink->proplist = gst_pulse_make_proplist (pulsesink->properties);
       break;
+    case PROP_ADAPTIVE_LATENCY:
+      pulsesink->adaptive_latency = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2946,6 +3058,9 @@ gst_pulsesink_get_property (GObject * object,
     case PROP_STREAM_PROPERTIES:
       gst_value_set_structure (value, pulsesink->properties);
       break;
+    case PROP_ADAPTIVE_LATENCY:
+      g_value_set_boolean (value, pulsesink->adaptive_latency);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -85,6 +85,8 @@ struct _GstPulseSink
 
   volatile gint format_lost;
   GstClockTime format_lost_time;
+
+  gboolean adaptive_latency;
 };
 
 struct _GstPulseSinkClass
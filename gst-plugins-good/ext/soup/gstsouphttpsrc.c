@@ -118,6 +118,7 @@ enum
   PROP_RETRIES,
   PROP_METHOD,
   PROP_TLS_INTERACTION,
+  PROP_SHARED_SESSION,
 };
 
 #define DEFAULT_USER_AGENT           "GStreamer souphttpsrc "
@@ -125,6 +126,7 @@ enum
 #define DEFAULT_SOUP_LOG_LEVEL       SOUP_LOGGER_LOG_HEADERS
 #define DEFAULT_COMPRESS             FALSE
 #define DEFAULT_KEEP_ALIVE           FALSE
+#define DEFAULT_SHARED_SESSION       FALSE
 #define DEFAULT_SSL_STRICT           TRUE
 #define DEFAULT_SSL_CA_FILE          NULL
 #define DEFAULT_SSL_USE_SYSTEM_CA_FILE TRUE
@@ -301,6 +303,26 @@ gst_soup_http_src_class_init (GstSoupHTTPSrcClass * klass)
           "Use HTTP persistent connections", DEFAULT_KEEP_ALIVE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+ /**
+   * GstSoupHTTPSrc::shared-session:
+   *
+   * If set to %TRUE, souphttpsrc will use a session shared by all the
+   * souphttpsrc instances of the process with the same session settings
+   * (user agent, proxy, timeout, compression and TLS settings). The
+   * connections of the session are kept open after the element stops, so
+   * that the next request to the same server does not need a new TCP
+   * connection or TLS handshake.
+   *
+   * The HTTP session logger is not attached to shared sessions.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARED_SESSION,
+      g_param_spec_boolean ("shared-session", "Shared session",
+          "Use a process-wide HTTP session and connection pool",
+          DEFAULT_SHARED_SESSION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
  /**
    * GstSoupHTTPSrc::ssl-strict:
    *
@@ -472,6 +494,7 @@ gst_soup_http_src_init (GstSoupHTTPSrc * src)
   src->cookies = NULL;
   src->iradio_mode = DEFAULT_IRADIO_MODE;
   src->session = NULL;
+  src->shared_session = DEFAULT_SHARED_SESSION;
   src->msg = NULL;
   src->timeout = DEFAULT_TIMEOUT;
   src->log_level = DEFAULT_SOUP_LOG_LEVEL;
@@ -633,6 +656,9 @@ gst_soup_http_src_set_property (GObject * object, guint prop_id,
     case PROP_KEEP_ALIVE:
       src->keep_alive = g_value_get_boolean (value);
       break;
+    case PROP_SHARED_SESSION:
+      src->shared_session = g_value_get_boolean (value);
+      break;
     case PROP_SSL_STRICT:
       src->ssl_strict = g_value_get_boolean (value);
       break;
@@ -728,6 +754,9 @@ gst_soup_http_src_get_property (GObject * object, guint prop_id,
     case PROP_KEEP_ALIVE:
       g_value_set_boolean (value, src->keep_alive);
       break;
+    case PROP_SHARED_SESSION:
+      g_value_set_boolean (value, src->shared_session);
+      break;
     case PROP_SSL_STRICT:
       g_value_set_boolean (value, src->ssl_strict);
       break;
@@ -889,6 +918,119 @@ gst_soup_http_src_add_extra_headers (GstSoupHTTPSrc * src)
   return gst_structure_foreach (src->extra_headers, _append_extra_headers, src);
 }
 
+/* Maximum number of connections the shared sessions keep per server, so
+ * that parallel fragment downloads do not wait for each other */
+#define SHARED_SESSION_MAX_CONNS_PER_HOST 8
+#define SHARED_SESSION_MAX_CONNS 32
+
+G_LOCK_DEFINE_STATIC (shared_sessions);
+static GHashTable *shared_sessions = NULL;
+
+static GQuark
+gst_soup_http_src_msg_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("gst-soup-http-src");
+  return quark;
+}
+
+static SoupSession *
+gst_soup_http_src_new_session (GstSoupHTTPSrc * src)
+{
+  SoupSession *session;
+
+  if (src->proxy == NULL) {
+    session =
+        soup_session_new_with_options (SOUP_SESSION_USER_AGENT,
+        src->user_agent, SOUP_SESSION_TIMEOUT, src->timeout,
+        SOUP_SESSION_SSL_STRICT, src->ssl_strict,
+        SOUP_SESSION_TLS_INTERACTION, src->tls_interaction, NULL);
+  } else {
+    session =
+        soup_session_new_with_options (SOUP_SESSION_PROXY_URI, src->proxy,
+        SOUP_SESSION_TIMEOUT, src->timeout,
+        SOUP_SESSION_SSL_STRICT, src->ssl_strict,
+        SOUP_SESSION_USER_AGENT, src->user_agent,
+        SOUP_SESSION_TLS_INTERACTION, src->tls_interaction, NULL);
+  }
+
+  if (!session)
+    return NULL;
+
+  if (src->tls_database)
+    g_object_set (session, "tls-database", src->tls_database, NULL);
+  else if (src->ssl_ca_file)
+    g_object_set (session, "ssl-ca-file", src->ssl_ca_file, NULL);
+  else
+    g_object_set (session, "ssl-use-system-ca-file",
+        src->ssl_use_system_ca_file, NULL);
+
+  return session;
+}
+
+static void
+gst_soup_http_src_shared_authenticate_cb (SoupSession * session,
+    SoupMessage * msg, SoupAuth * auth, gboolean retrying, gpointer user_data)
+{
+  GstSoupHTTPSrc *src;
+
+  /* the session is used by many elements, find the one sending @msg */
+  src = g_object_get_qdata (G_OBJECT (msg), gst_soup_http_src_msg_quark ());
+  if (src)
+    gst_soup_http_src_authenticate_cb (session, msg, auth, retrying, src);
+}
+
+/* Returns a new reference to the shared session matching the settings of
+ * @src. Shared sessions are kept for the lifetime of the process, libsoup
+ * closes their idle connections after a while. */
+static SoupSession *
+gst_soup_http_src_get_shared_session (GstSoupHTTPSrc * src)
+{
+  SoupSession *session;
+  gchar *proxy, *key;
+
+  proxy = src->proxy ? soup_uri_to_string (src->proxy, FALSE) : NULL;
+  key = g_strdup_printf ("%s|%s|%u|%d|%d|%p|%s|%d|%p",
+      GST_STR_NULL (src->user_agent), GST_STR_NULL (proxy), src->timeout,
+      src->compress, src->ssl_strict, src->tls_database,
+      GST_STR_NULL (src->ssl_ca_file), src->ssl_use_system_ca_file,
+      src->tls_interaction);
+  g_free (proxy);
+
+  G_LOCK (shared_sessions);
+  if (!shared_sessions)
+    shared_sessions = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        g_object_unref);
+
+  session = g_hash_table_lookup (shared_sessions, key);
+  if (!session) {
+    GST_DEBUG_OBJECT (src, "Creating shared session %s", key);
+    session = gst_soup_http_src_new_session (src);
+    if (session) {
+      g_object_set (session, SOUP_SESSION_MAX_CONNS, SHARED_SESSION_MAX_CONNS,
+          SOUP_SESSION_MAX_CONNS_PER_HOST, SHARED_SESSION_MAX_CONNS_PER_HOST,
+          NULL);
+      g_signal_connect (session, "authenticate",
+          G_CALLBACK (gst_soup_http_src_shared_authenticate_cb), NULL);
+      if (src->compress)
+        soup_session_add_feature_by_type (session, SOUP_TYPE_CONTENT_DECODER);
+      g_hash_table_insert (shared_sessions, key, session);
+      key = NULL;
+    }
+  } else {
+    GST_DEBUG_OBJECT (src, "Using shared session %s", key);
+  }
+  if (session)
+    g_object_ref (session);
+  G_UNLOCK (shared_sessions);
+
+  g_free (key);
+
+  return session;
+}
+
 static gboolean
 gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
 {
@@ -903,51 +1045,40 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
     return FALSE;
   }
 
-  if (!src->session) {
+  if (src->shared_session) {
+    src->session = gst_soup_http_src_get_shared_session (src);
+    src->session_is_shared = TRUE;
+  } else {
     GST_DEBUG_OBJECT (src, "Creating session");
-    if (src->proxy == NULL) {
-      src->session =
-          soup_session_new_with_options (SOUP_SESSION_USER_AGENT,
-          src->user_agent, SOUP_SESSION_TIMEOUT, src->timeout,
-          SOUP_SESSION_SSL_STRICT, src->ssl_strict,
-          SOUP_SESSION_TLS_INTERACTION, src->tls_interaction, NULL);
-    } else {
-      src->session =
-          soup_session_new_with_options (SOUP_SESSION_PROXY_URI, src->proxy,
-          SOUP_SESSION_TIMEOUT, src->timeout,
-          SOUP_SESSION_SSL_STRICT, src->ssl_strict,
-          SOUP_SESSION_USER_AGENT, src->user_agent,
-          SOUP_SESSION_TLS_INTERACTION, src->tls_interaction, NULL);
-    }
+    src->session = gst_soup_http_src_new_session (src);
+    src->session_is_shared = FALSE;
 
-    if (!src->session) {
-      GST_ELEMENT_ERROR (src, LIBRARY, INIT,
-          (NULL), ("Failed to create async session"));
-      return FALSE;
+    if (src->session) {
+      g_signal_connect (src->session, "authenticate",
+          G_CALLBACK (gst_soup_http_src_authenticate_cb), src);
+
+      /* Set up logging */
+      gst_soup_util_log_setup (src->session, src->log_level,
+          GST_ELEMENT (src));
     }
+  }
 
-    g_signal_connect (src->session, "authenticate",
-        G_CALLBACK (gst_soup_http_src_authenticate_cb), src);
+  if (!src->session) {
+    GST_ELEMENT_ERROR (src, LIBRARY, INIT,
+        (NULL), ("Failed to create async session"));
+    return FALSE;
+  }
 
-    /* Set up logging */
-    gst_soup_util_log_setup (src->session, src->log_level, GST_ELEMENT (src));
-    if (src->tls_database)
-      g_object_set (src->session, "tls-database", src->tls_database, NULL);
-    else if (src->ssl_ca_file)
-      g_object_set (src->session, "ssl-ca-file", src->ssl_ca_file, NULL);
+  /* shared sessions are looked up with the compression setting */
+  if (!src->session_is_shared) {
+    if (src->compress)
+      soup_session_add_feature_by_type (src->session,
+          SOUP_TYPE_CONTENT_DECODER);
     else
-      g_object_set (src->session, "ssl-use-system-ca-file",
-          src->ssl_use_system_ca_file, NULL);
-  } else {
-    GST_DEBUG_OBJECT (src, "Re-using session");
+      soup_session_remove_feature_by_type (src->session,
+          SOUP_TYPE_CONTENT_DECODER);
   }
 
-  if (src->compress)
-    soup_session_add_feature_by_type (src->session, SOUP_TYPE_CONTENT_DECODER);
-  else
-    soup_session_remove_feature_by_type (src->session,
-        SOUP_TYPE_CONTENT_DECODER);
-
   return TRUE;
 }
 
@@ -958,7 +1089,14 @@ gst_soup_http_src_session_close (GstSoupHTTPSrc * src)
 
   g_mutex_lock (&src->mutex);
   if (src->session) {
-    soup_session_abort (src->session);  /* This unrefs the message. */
+    if (src->session_is_shared) {
+      /* other elements are using the session and its connections, only
+       * drop our message */
+      if (src->msg)
+        g_object_unref (src->msg);
+    } else {
+      soup_session_abort (src->session);        /* This unrefs the message. */
+    }
     g_object_unref (src->session);
     src->session = NULL;
     src->msg = NULL;
@@ -1343,10 +1481,13 @@ gst_soup_http_src_build_message (GstSoupHTTPSrc * src, const gchar * method)
         ("Error parsing URL."), ("URL: %s", src->location));
     return FALSE;
   }
-  if (!src->keep_alive) {
+  /* the connections of shared sessions are always kept for later use */
+  if (!src->keep_alive && !src->session_is_shared) {
     soup_message_headers_append (src->msg->request_headers, "Connection",
         "close");
   }
+  g_object_set_qdata (G_OBJECT (src->msg), gst_soup_http_src_msg_quark (),
+      src);
   if (src->iradio_mode) {
     soup_message_headers_append (src->msg->request_headers, "icy-metadata",
         "1");
@@ -81,6 +81,8 @@ struct _GstSoupHTTPSrc {
                                 * handled as an error or EOS when the content
                                 * size is unknown */
   gboolean keep_alive;         /* Use keep-alive sessions */
+  gboolean shared_session;     /* Use the process-wide sessions */
+  gboolean session_is_shared;  /* session comes from the shared pool */
   gboolean ssl_strict;
   gchar *ssl_ca_file;
   gboolean ssl_use_system_ca_file;
@@ -86,9 +86,28 @@ GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS ("video/x-vp9, " "profile = (string) {0, 1, 2, 3}")
     );
 
+#define DEFAULT_TILE_COLUMNS -1
+#define DEFAULT_ROW_MT FALSE
+
+/* VP9 tiles are at least 256 and at most 4096 pixels wide */
+#define MIN_TILE_WIDTH 256
+#define MAX_LOG2_TILE_COLUMNS 6
+
+enum
+{
+  PROP_0,
+  PROP_TILE_COLUMNS,
+  PROP_ROW_MT
+};
+
 #define parent_class gst_vp9_enc_parent_class
 G_DEFINE_TYPE (GstVP9Enc, gst_vp9_enc, GST_TYPE_VPX_ENC);
 
+static void gst_vp9_enc_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_vp9_enc_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
 static vpx_codec_iface_t *gst_vp9_enc_get_algo (GstVPXEnc * enc);
 static gboolean gst_vp9_enc_enable_scaling (GstVPXEnc * enc);
 static void gst_vp9_enc_set_image_format (GstVPXEnc * enc, vpx_image_t * image);
@@ -101,16 +120,52 @@ static GstFlowReturn gst_vp9_enc_handle_invisible_frame_buffer (GstVPXEnc * enc,
     void *user_data, GstBuffer * buffer);
 static void gst_vp9_enc_set_frame_user_data (GstVPXEnc * enc,
     GstVideoCodecFrame * frame, vpx_image_t * image);
+static gboolean gst_vp9_enc_configure_encoder (GstVPXEnc * encoder,
+    GstVideoCodecState * state);
 
 static void
 gst_vp9_enc_class_init (GstVP9EncClass * klass)
 {
+  GObjectClass *gobject_class;
   GstElementClass *element_class;
   GstVPXEncClass *vpx_encoder_class;
 
+  gobject_class = G_OBJECT_CLASS (klass);
   element_class = GST_ELEMENT_CLASS (klass);
   vpx_encoder_class = GST_VPX_ENC_CLASS (klass);
 
+  gobject_class->set_property = gst_vp9_enc_set_property;
+  gobject_class->get_property = gst_vp9_enc_get_property;
+
+  /**
+   * GstVP9Enc:tile-columns:
+   *
+   * Base 2 logarithm of the number of tile columns. Tiles are encoded and
+   * decoded in parallel by multiple threads. With -1 the number of tile
+   * columns is chosen from the width of the video and the number of threads.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_TILE_COLUMNS,
+      g_param_spec_int ("tile-columns", "Tile Columns",
+          "Number of tile columns, log2 (-1 = automatic)",
+          -1, MAX_LOG2_TILE_COLUMNS, DEFAULT_TILE_COLUMNS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVP9Enc:row-mt:
+   *
+   * Encode the rows of superblocks of each tile in parallel, which allows
+   * using more threads than there are tile columns. This requires libvpx 1.7
+   * or newer.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_ROW_MT,
+      g_param_spec_boolean ("row-mt", "Row Multithreading",
+          "Use row based multithreading", DEFAULT_ROW_MT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_vp9_enc_src_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -132,6 +187,8 @@ gst_vp9_enc_class_init (GstVP9EncClass * klass)
   vpx_encoder_class->handle_invisible_frame_buffer =
       gst_vp9_enc_handle_invisible_frame_buffer;
   vpx_encoder_class->set_frame_user_data = gst_vp9_enc_set_frame_user_data;
+  vpx_encoder_class->configure_encoder = gst_vp9_enc_configure_encoder;
+  vpx_encoder_class->max_cpu_used = 8;
 
   GST_DEBUG_CATEGORY_INIT (gst_vp9enc_debug, "vp9enc", 0, "VP9 Encoder");
 }
@@ -142,6 +199,8 @@ gst_vp9_enc_init (GstVP9Enc * gst_vp9_enc)
   vpx_codec_err_t status;
   GstVPXEnc *gst_vpx_enc = GST_VPX_ENC (gst_vp9_enc);
   GST_DEBUG_OBJECT (gst_vp9_enc, "gst_vp9_enc_init");
+  gst_vp9_enc->tile_columns = DEFAULT_TILE_COLUMNS;
+  gst_vp9_enc->row_mt = DEFAULT_ROW_MT;
   status =
       vpx_codec_enc_config_default (gst_vp9_enc_get_algo (gst_vpx_enc),
       &gst_vpx_enc->cfg, 0);
@@ -155,6 +214,117 @@ gst_vp9_enc_init (GstVP9Enc * gst_vp9_enc)
   }
 }
 
+/* Must be called with the encoder lock */
+static void
+gst_vp9_enc_set_tile_columns (GstVP9Enc * vp9enc)
+{
+  GstVPXEnc *encoder = GST_VPX_ENC (vp9enc);
+  vpx_codec_err_t status;
+  gint tile_columns = vp9enc->tile_columns;
+
+  if (tile_columns < 0) {
+    gint width = GST_VIDEO_INFO_WIDTH (&encoder->input_state->info);
+
+    /* as many tile columns as the width allows, but no more than there are
+     * threads to encode them if the number of threads was set */
+    tile_columns = 0;
+    while (tile_columns < MAX_LOG2_TILE_COLUMNS &&
+        (width >> (tile_columns + 1)) >= MIN_TILE_WIDTH &&
+        (encoder->cfg.g_threads == 0 ||
+            (1 << tile_columns) < encoder->cfg.g_threads))
+      tile_columns++;
+  }
+
+  GST_DEBUG_OBJECT (vp9enc, "Using %d tile columns", 1 << tile_columns);
+
+  status = vpx_codec_control (&encoder->encoder, VP9E_SET_TILE_COLUMNS,
+      tile_columns);
+  if (status != VPX_CODEC_OK) {
+    GST_WARNING_OBJECT (vp9enc, "Failed to set VP9E_SET_TILE_COLUMNS: %s",
+        gst_vpx_error_name (status));
+  }
+}
+
+/* Must be called with the encoder lock */
+static void
+gst_vp9_enc_set_row_mt (GstVP9Enc * vp9enc)
+{
+#ifdef VPX_CTRL_VP9E_SET_ROW_MT
+  GstVPXEnc *encoder = GST_VPX_ENC (vp9enc);
+  vpx_codec_err_t status;
+
+  status = vpx_codec_control (&encoder->encoder, VP9E_SET_ROW_MT,
+      vp9enc->row_mt ? 1 : 0);
+  if (status != VPX_CODEC_OK) {
+    GST_WARNING_OBJECT (vp9enc, "Failed to set VP9E_SET_ROW_MT: %s",
+        gst_vpx_error_name (status));
+  }
+#else
+  if (vp9enc->row_mt)
+    GST_WARNING_OBJECT (vp9enc, "Row based multithreading not supported by "
+        "this version of libvpx");
+#endif
+}
+
+static gboolean
+gst_vp9_enc_configure_encoder (GstVPXEnc * encoder, GstVideoCodecState * state)
+{
+  GstVP9Enc *vp9enc = GST_VP9_ENC (encoder);
+
+  gst_vp9_enc_set_tile_columns (vp9enc);
+  gst_vp9_enc_set_row_mt (vp9enc);
+
+  return TRUE;
+}
+
+static void
+gst_vp9_enc_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVP9Enc *vp9enc = GST_VP9_ENC (object);
+  GstVPXEnc *encoder = GST_VPX_ENC (object);
+
+  g_mutex_lock (&encoder->encoder_lock);
+  switch (prop_id) {
+    case PROP_TILE_COLUMNS:
+      vp9enc->tile_columns = g_value_get_int (value);
+      if (encoder->inited)
+        gst_vp9_enc_set_tile_columns (vp9enc);
+      break;
+    case PROP_ROW_MT:
+      vp9enc->row_mt = g_value_get_boolean (value);
+      if (encoder->inited)
+        gst_vp9_enc_set_row_mt (vp9enc);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  g_mutex_unlock (&encoder->encoder_lock);
+}
+
+static void
+gst_vp9_enc_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstVP9Enc *vp9enc = GST_VP9_ENC (object);
+  GstVPXEnc *encoder = GST_VPX_ENC (object);
+
+  g_mutex_lock (&encoder->encoder_lock);
+  switch (prop_id) {
+    case PROP_TILE_COLUMNS:
+      g_value_set_int (value, vp9enc->tile_columns);
+      break;
+    case PROP_ROW_MT:
+      g_value_set_boolean (value, vp9enc->row_mt);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  g_mutex_unlock (&encoder->encoder_lock);
+}
+
 static vpx_codec_iface_t *
 gst_vp9_enc_get_algo (GstVPXEnc * enc)
 {
@@ -55,6 +55,9 @@ typedef struct _GstVP9EncClass GstVP9EncClass;
 struct _GstVP9Enc
 {
 	GstVPXEnc base_vpx_encoder;
+
+	gint tile_columns;
+	gboolean row_mt;
 };
 
 struct _GstVP9EncClass
@@ -616,8 +616,18 @@ gst_vpx_dec_open_codec (GstVPXDec * dec, GstVideoCodecFrame * frame)
     }
   }
 #ifdef HAVE_VPX_1_4
-  vpx_codec_set_frame_buffer_functions (&dec->decoder,
-      gst_vpx_dec_get_buffer_cb, gst_vpx_dec_release_buffer_cb, dec);
+  /* Let the decoder allocate its frames from our pool, so that decoded frames
+   * can be pushed downstream without copying them */
+  if (caps & VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER) {
+    status = vpx_codec_set_frame_buffer_functions (&dec->decoder,
+        gst_vpx_dec_get_buffer_cb, gst_vpx_dec_release_buffer_cb, dec);
+    if (status != VPX_CODEC_OK) {
+      GST_WARNING_OBJECT (dec, "Couldn't set frame buffer functions: %s",
+          gst_vpx_error_name (status));
+    }
+  } else {
+    GST_DEBUG_OBJECT (dec, "Decoder does not support external frame buffers");
+  }
 #endif
 
   dec->decoder_inited = TRUE;
@@ -706,6 +716,7 @@ gst_vpx_dec_handle_frame (GstVideoDecoder * decoder, GstVideoCodecFrame * frame)
       } else
 #endif
       {
+        GST_LOG_OBJECT (dec, "Copying decoded frame into output buffer");
         ret = gst_video_decoder_allocate_output_frame (decoder, frame);
 
         if (ret == GST_FLOW_OK) {
@@ -746,11 +757,14 @@ gst_vpx_dec_decide_allocation (GstVideoDecoder * bdec, GstQuery * query)
   gst_query_parse_nth_allocation_pool (query, 0, &pool, NULL, NULL, NULL);
   g_assert (pool != NULL);
 
+  /* Without video meta downstream can't handle the strides and plane offsets
+   * of the frames allocated by the decoder, so they are copied */
   config = gst_buffer_pool_get_config (pool);
-  if (gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL)) {
+  dec->have_video_meta =
+      gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+  if (dec->have_video_meta) {
     gst_buffer_pool_config_add_option (config,
         GST_BUFFER_POOL_OPTION_VIDEO_META);
-    dec->have_video_meta = TRUE;
   }
   gst_buffer_pool_set_config (pool, config);
   gst_object_unref (pool);
@@ -98,6 +98,10 @@ GST_DEBUG_CATEGORY_STATIC (gst_vpxenc_debug);
 #define DEFAULT_MAX_INTRA_BITRATE_PCT 0
 #define DEFAULT_TIMEBASE_N 0
 #define DEFAULT_TIMEBASE_D 1
+#define DEFAULT_QOS FALSE
+
+/* QoS events change the speed of the encoder at most this often */
+#define QOS_UPDATE_INTERVAL GST_SECOND
 
 enum
 {
@@ -145,7 +149,8 @@ enum
   PROP_TUNING,
   PROP_CQ_LEVEL,
   PROP_MAX_INTRA_BITRATE_PCT,
-  PROP_TIMEBASE
+  PROP_TIMEBASE,
+  PROP_QOS
 };
 
 
@@ -327,6 +332,8 @@ static GstFlowReturn gst_vpx_enc_handle_frame (GstVideoEncoder *
     video_encoder, GstVideoCodecFrame * frame);
 static gboolean gst_vpx_enc_sink_event (GstVideoEncoder *
     video_encoder, GstEvent * event);
+static gboolean gst_vpx_enc_src_event (GstVideoEncoder *
+    video_encoder, GstEvent * event);
 static gboolean gst_vpx_enc_propose_allocation (GstVideoEncoder * encoder,
     GstQuery * query);
 
@@ -355,6 +362,7 @@ gst_vpx_enc_class_init (GstVPXEncClass * klass)
   video_encoder_class->flush = gst_vpx_enc_flush;
   video_encoder_class->finish = gst_vpx_enc_finish;
   video_encoder_class->sink_event = gst_vpx_enc_sink_event;
+  video_encoder_class->src_event = gst_vpx_enc_src_event;
   video_encoder_class->propose_allocation = gst_vpx_enc_propose_allocation;
 
   g_object_class_install_property (gobject_class, PROP_RC_END_USAGE,
@@ -635,6 +643,21 @@ gst_vpx_enc_class_init (GstVPXEncClass * klass)
           0, 1, G_MAXINT, 1, DEFAULT_TIMEBASE_N, DEFAULT_TIMEBASE_D,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVPXEnc:qos:
+   *
+   * Adapt the speed of the encoder to QoS events from downstream. When frames
+   * arrive late the encoder switches to faster settings than the ones given
+   * by #GstVPXEnc:cpu-used, and goes back towards them once it is fast
+   * enough again.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_QOS,
+      g_param_spec_boolean ("qos", "QoS",
+          "Raise cpu-used while frames are late and lower it again afterwards",
+          DEFAULT_QOS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_DEBUG_CATEGORY_INIT (gst_vpxenc_debug, "vpxenc", 0, "VPX Encoder");
 }
 
@@ -681,6 +704,9 @@ gst_vpx_enc_init (GstVPXEnc * gst_vpx_enc)
   gst_vpx_enc->h_scaling_mode = DEFAULT_H_SCALING_MODE;
   gst_vpx_enc->v_scaling_mode = DEFAULT_V_SCALING_MODE;
   gst_vpx_enc->cpu_used = DEFAULT_CPU_USED;
+  gst_vpx_enc->qos = DEFAULT_QOS;
+  gst_vpx_enc->qos_cpu_used = DEFAULT_CPU_USED;
+  gst_vpx_enc->qos_last_update = GST_CLOCK_TIME_NONE;
   gst_vpx_enc->enable_auto_alt_ref = DEFAULT_ENABLE_AUTO_ALT_REF;
   gst_vpx_enc->noise_sensitivity = DEFAULT_NOISE_SENSITIVITY;
   gst_vpx_enc->sharpness = DEFAULT_SHARPNESS;
@@ -941,6 +967,7 @@ gst_vpx_enc_set_property (GObject * object, guint prop_id,
       break;
     case PROP_CPU_USED:
       gst_vpx_enc->cpu_used = g_value_get_int (value);
+      gst_vpx_enc->qos_cpu_used = gst_vpx_enc->cpu_used;
       if (gst_vpx_enc->inited) {
         status =
             vpx_codec_control (&gst_vpx_enc->encoder, VP8E_SET_CPUUSED,
@@ -1086,6 +1113,9 @@ gst_vpx_enc_set_property (GObject * object, guint prop_id,
       gst_vpx_enc->timebase_n = gst_value_get_fraction_numerator (value);
       gst_vpx_enc->timebase_d = gst_value_get_fraction_denominator (value);
       break;
+    case PROP_QOS:
+      gst_vpx_enc->qos = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
@@ -1307,6 +1337,9 @@ gst_vpx_enc_get_property (GObject * object, guint prop_id, GValue * value,
       gst_value_set_fraction (value, gst_vpx_enc->timebase_n,
           gst_vpx_enc->timebase_d);
       break;
+    case PROP_QOS:
+      g_value_set_boolean (value, gst_vpx_enc->qos);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1535,6 +1568,8 @@ gst_vpx_enc_set_format (GstVideoEncoder * video_encoder,
     }
   }
 
+  encoder->qos_cpu_used = encoder->cpu_used;
+  encoder->qos_last_update = GST_CLOCK_TIME_NONE;
   status =
       vpx_codec_control (&encoder->encoder, VP8E_SET_CPUUSED,
       encoder->cpu_used);
@@ -1623,6 +1658,7 @@ gst_vpx_enc_set_format (GstVideoEncoder * video_encoder,
         GST_VIDEO_INFO_FPS_D (info) * GST_SECOND, GST_VIDEO_INFO_FPS_N (info));
   }
   gst_video_encoder_set_latency (video_encoder, latency, latency);
+
   encoder->inited = TRUE;
 
   /* Store input state */
@@ -1630,6 +1666,11 @@ gst_vpx_enc_set_format (GstVideoEncoder * video_encoder,
     gst_video_codec_state_unref (encoder->input_state);
   encoder->input_state = gst_video_codec_state_ref (state);
 
+  if (vpx_enc_class->configure_encoder &&
+      !vpx_enc_class->configure_encoder (encoder, state)) {
+    GST_WARNING_OBJECT (encoder, "Failed to configure encoder");
+  }
+
   /* prepare cached image buffer setup */
   image = &encoder->image;
   memset (image, 0, sizeof (*image));
@@ -1941,6 +1982,72 @@ gst_vpx_enc_sink_event (GstVideoEncoder * benc, GstEvent * event)
   return GST_VIDEO_ENCODER_CLASS (parent_class)->sink_event (benc, event);
 }
 
+/* Moves the speed of the encoder one step away from the configured cpu-used
+ * if frames are late, or back towards it otherwise. Must be called with the
+ * encoder lock. */
+static void
+gst_vpx_enc_qos_update_speed (GstVPXEnc * enc, gboolean late)
+{
+  GstVPXEncClass *vpx_enc_class = GST_VPX_ENC_GET_CLASS (enc);
+  gint sign = enc->cpu_used < 0 ? -1 : 1;
+  gint speed = ABS (enc->qos_cpu_used);
+  vpx_codec_err_t status;
+
+  if (late)
+    speed = MIN (speed + 1, MAX (vpx_enc_class->max_cpu_used,
+            ABS (enc->cpu_used)));
+  else
+    speed = MAX (speed - 1, ABS (enc->cpu_used));
+
+  if (sign * speed == enc->qos_cpu_used)
+    return;
+
+  GST_DEBUG_OBJECT (enc, "%s, changing cpu-used from %d to %d",
+      late ? "frames are late" : "frames are in time", enc->qos_cpu_used,
+      sign * speed);
+
+  enc->qos_cpu_used = sign * speed;
+  status = vpx_codec_control (&enc->encoder, VP8E_SET_CPUUSED,
+      enc->qos_cpu_used);
+  if (status != VPX_CODEC_OK) {
+    GST_WARNING_OBJECT (enc, "Failed to set VP8E_SET_CPUUSED: %s",
+        gst_vpx_error_name (status));
+  }
+}
+
+static gboolean
+gst_vpx_enc_src_event (GstVideoEncoder * benc, GstEvent * event)
+{
+  GstVPXEnc *enc = GST_VPX_ENC (benc);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_QOS) {
+    GstClockTimeDiff diff;
+    GstClockTime timestamp;
+    gdouble proportion;
+
+    gst_event_parse_qos (event, NULL, &proportion, &diff, &timestamp);
+
+    g_mutex_lock (&enc->encoder_lock);
+    if (enc->qos && enc->inited && GST_CLOCK_TIME_IS_VALID (timestamp) &&
+        (!GST_CLOCK_TIME_IS_VALID (enc->qos_last_update) ||
+            timestamp < enc->qos_last_update ||
+            timestamp - enc->qos_last_update >= QOS_UPDATE_INTERVAL)) {
+      /* Late frames make the encoder faster. It only gets slower again once
+       * downstream gets the frames clearly faster than they are needed */
+      if (diff > 0) {
+        gst_vpx_enc_qos_update_speed (enc, TRUE);
+        enc->qos_last_update = timestamp;
+      } else if (proportion < 0.8) {
+        gst_vpx_enc_qos_update_speed (enc, FALSE);
+        enc->qos_last_update = timestamp;
+      }
+    }
+    g_mutex_unlock (&enc->encoder_lock);
+  }
+
+  return GST_VIDEO_ENCODER_CLASS (parent_class)->src_event (benc, event);
+}
+
 static gboolean
 gst_vpx_enc_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
 {
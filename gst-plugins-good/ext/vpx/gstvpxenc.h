@@ -99,6 +99,7 @@ struct _GstVPXEnc
   /* Timebase - a value of 0 will use the framerate */
   unsigned int timebase_n;
   unsigned int timebase_d;
+  gboolean qos;
 
   /* state */
   gboolean inited;
@@ -107,6 +108,10 @@ struct _GstVPXEnc
 
   GstClockTime last_pts;
 
+  /* cpu-used as currently adapted to QoS events */
+  int qos_cpu_used;
+  GstClockTime qos_last_update;
+
   GstVideoCodecState *input_state;
 };
 
@@ -129,6 +134,11 @@ struct _GstVPXEncClass
   void (*set_frame_user_data) (GstVPXEnc *enc, GstVideoCodecFrame* frame, vpx_image_t *image);
   /*Handle invisible frame*/
   GstFlowReturn (*handle_invisible_frame_buffer) (GstVPXEnc *enc, void* user_data, GstBuffer* buffer);
+  /*set codec specific controls after the encoder was initialized*/
+  gboolean (*configure_encoder) (GstVPXEnc *enc, GstVideoCodecState *state);
+
+  /*fastest cpu-used value supported by the codec*/
+  gint max_cpu_used;
 };
 
 GType gst_vpx_enc_get_type (void);
@@ -59,6 +59,12 @@
 #define ENTRY_IS_KEYFRAME(e) ((e)->flags == GST_AVI_KEYFRAME)
 #define ENTRY_SET_KEYFRAME(e) ((e)->flags = GST_AVI_KEYFRAME)
 #define ENTRY_UNSET_KEYFRAME(e) ((e)->flags = 0)
+#define ENTRY_TOTAL(e) ((((guint64) (e)->total_hi) << 32) | (e)->total_lo)
+#define ENTRY_SET_TOTAL(e,t) G_STMT_START { \
+  guint64 _t = (t);                               \
+  (e)->total_hi = _t >> 32;                       \
+  (e)->total_lo = _t & G_MAXUINT32;               \
+} G_STMT_END
 
 
 GST_DEBUG_CATEGORY_STATIC (avidemux_debug);
@@ -270,6 +276,7 @@ gst_avi_demux_reset (GstAviDemux * avi)
   avi->building_index = FALSE;
 
   avi->index_offset = 0;
+  avi->subindexes_pending = FALSE;
   g_free (avi->avih);
   avi->avih = NULL;
 
@@ -723,7 +730,7 @@ gst_avi_demux_seek_streams_index (GstAviDemux * avi, guint64 offset,
     GST_DEBUG_OBJECT (avi, "stream %d, next entry at %" G_GUINT64_FORMAT, i,
         val);
 
-    stream->current_total = stream->index[index].total;
+    stream->current_total = ENTRY_TOTAL (&stream->index[index]);
     stream->current_entry = index;
   }
 
@@ -1346,9 +1353,9 @@ gst_avi_demux_add_index (GstAviDemux * avi, GstAviStream * stream,
     gint blockalign;
 
     if (stream->is_vbr) {
-      entry->total = stream->total_blocks;
+      ENTRY_SET_TOTAL (entry, stream->total_blocks);
     } else {
-      entry->total = stream->total_bytes;
+      ENTRY_SET_TOTAL (entry, stream->total_bytes);
     }
     blockalign = stream->strf.auds->blockalign;
     if (blockalign > 0)
@@ -1357,9 +1364,9 @@ gst_avi_demux_add_index (GstAviDemux * avi, GstAviStream * stream,
       stream->total_blocks++;
   } else {
     if (stream->is_vbr) {
-      entry->total = stream->idx_n;
+      ENTRY_SET_TOTAL (entry, stream->idx_n);
     } else {
-      entry->total = stream->total_bytes;
+      ENTRY_SET_TOTAL (entry, stream->total_bytes);
     }
   }
   stream->total_bytes += entry->size;
@@ -1370,8 +1377,8 @@ gst_avi_demux_add_index (GstAviDemux * avi, GstAviStream * stream,
   GST_LOG_OBJECT (avi,
       "Adding stream %u, index entry %d, kf %d, size %u "
       ", offset %" G_GUINT64_FORMAT ", total %" G_GUINT64_FORMAT, stream->num,
-      stream->idx_n, ENTRY_IS_KEYFRAME (entry), entry->size, entry->offset,
-      entry->total);
+      stream->idx_n, ENTRY_IS_KEYFRAME (entry), (guint) entry->size,
+      (guint64) entry->offset, ENTRY_TOTAL (entry));
   stream->index[stream->idx_n++] = *entry;
 
   return TRUE;
@@ -1392,14 +1399,15 @@ gst_avi_demux_get_buffer_info (GstAviDemux * avi, GstAviStream * stream,
     /* VBR stream next timestamp */
     if (stream->strh->type == GST_RIFF_FCC_auds) {
       if (timestamp)
-        *timestamp =
-            avi_stream_convert_frames_to_time_unchecked (stream, entry->total);
+        *timestamp = avi_stream_convert_frames_to_time_unchecked (stream,
+            ENTRY_TOTAL (entry));
       if (ts_end) {
         gint size = 1;
         if (G_LIKELY (entry_n + 1 < stream->idx_n))
-          size = stream->index[entry_n + 1].total - entry->total;
+          size =
+              ENTRY_TOTAL (&stream->index[entry_n + 1]) - ENTRY_TOTAL (entry);
         *ts_end = avi_stream_convert_frames_to_time_unchecked (stream,
-            entry->total + size);
+            ENTRY_TOTAL (entry) + size);
       }
     } else {
       if (timestamp)
@@ -1412,11 +1420,11 @@ gst_avi_demux_get_buffer_info (GstAviDemux * avi, GstAviStream * stream,
   } else if (stream->strh->type == GST_RIFF_FCC_auds) {
     /* constant rate stream */
     if (timestamp)
-      *timestamp =
-          avi_stream_convert_bytes_to_time_unchecked (stream, entry->total);
+      *timestamp = avi_stream_convert_bytes_to_time_unchecked (stream,
+          ENTRY_TOTAL (entry));
     if (ts_end)
       *ts_end = avi_stream_convert_bytes_to_time_unchecked (stream,
-          entry->total + entry->size);
+          ENTRY_TOTAL (entry) + entry->size);
   }
   if (stream->strh->type == GST_RIFF_FCC_vids) {
     /* video offsets are the frame number */
@@ -1698,49 +1706,147 @@ gst_avi_demux_read_subindexes_push (GstAviDemux * avi)
   return perform_seek_to_offset (avi, avi->odml_subidxs[avi->odml_subidx]);
 }
 
+/* called when all subindexes were read, the index stats and durations
+ * can be finalized now */
+static void
+gst_avi_demux_subindexes_done (GstAviDemux * avi)
+{
+  GstClockTime duration = avi->segment.duration;
+
+  GST_DEBUG_OBJECT (avi, "all subindexes read");
+  avi->subindexes_pending = FALSE;
+  avi->have_index = gst_avi_demux_do_index_stats (avi);
+  gst_avi_demux_calculate_durations_from_index (avi);
+
+  if (avi->segment.duration != duration)
+    gst_element_post_message (GST_ELEMENT_CAST (avi),
+        gst_message_new_duration_changed (GST_OBJECT_CAST (avi)));
+}
+
 /*
- * Read AVI index
+ * Read the next subindex of @stream that was not read yet.
+ *
+ * Returns: FALSE if there were no more subindexes for @stream.
  */
-static void
-gst_avi_demux_read_subindexes_pull (GstAviDemux * avi)
+static gboolean
+gst_avi_demux_read_subindex_pull (GstAviDemux * avi, GstAviStream * stream)
 {
   guint32 tag;
   GstBuffer *buf;
-  gint i, n;
+  guint64 offset;
+  guint idx_n;
+  gint i;
 
-  GST_DEBUG_OBJECT (avi, "read subindexes for %d streams", avi->num_streams);
+  if (stream->indexes == NULL)
+    return FALSE;
+
+  offset = stream->indexes[stream->next_subindex];
+  if (offset == GST_BUFFER_OFFSET_NONE) {
+    g_free (stream->indexes);
+    stream->indexes = NULL;
+
+    if (avi->subindexes_pending) {
+      for (i = 0; i < avi->num_streams; i++) {
+        if (avi->stream[i].indexes)
+          return FALSE;
+      }
+      gst_avi_demux_subindexes_done (avi);
+    }
+    return FALSE;
+  }
+  stream->next_subindex++;
+
+  if (gst_riff_read_chunk (GST_ELEMENT_CAST (avi), avi->sinkpad,
+          &offset, &tag, &buf) != GST_FLOW_OK)
+    return TRUE;
+
+  if ((tag != GST_MAKE_FOURCC ('i', 'x', '0' + stream->num / 10,
+              '0' + stream->num % 10)) &&
+      (tag != GST_MAKE_FOURCC ('0' + stream->num / 10,
+              '0' + stream->num % 10, 'i', 'x'))) {
+    /* Some ODML files (created by god knows what muxer) have a ##ix format
+     * instead of the 'official' ix##. They are still valid though. */
+    GST_WARNING_OBJECT (avi, "Not an ix## chunk (%" GST_FOURCC_FORMAT ")",
+        GST_FOURCC_ARGS (tag));
+    gst_buffer_unref (buf);
+    return TRUE;
+  }
+
+  idx_n = stream->idx_n;
+  gst_avi_demux_parse_subindex (avi, stream, buf);
+
+  /* extend the playback range if it ended at the previous end of the index */
+  if (stream->stop_entry == idx_n && avi->segment.rate > 0.0)
+    stream->stop_entry = stream->idx_n;
+
+  return TRUE;
+}
+
+/* read the remaining subindexes of all streams */
+static void
+gst_avi_demux_read_all_subindexes_pull (GstAviDemux * avi)
+{
+  gint n;
 
   for (n = 0; n < avi->num_streams; n++) {
-    GstAviStream *stream = &avi->stream[n];
+    while (gst_avi_demux_read_subindex_pull (avi, &avi->stream[n]));
+  }
+}
 
-    if (stream->indexes == NULL)
-      continue;
+/* read one more subindex, for the stream that will run out of index
+ * entries first */
+static void
+gst_avi_demux_read_next_subindex_pull (GstAviDemux * avi)
+{
+  GstAviStream *stream = NULL;
+  guint left, min_left = G_MAXUINT;
+  gint n;
 
-    for (i = 0; stream->indexes[i] != GST_BUFFER_OFFSET_NONE; i++) {
-      if (gst_riff_read_chunk (GST_ELEMENT_CAST (avi), avi->sinkpad,
-              &stream->indexes[i], &tag, &buf) != GST_FLOW_OK)
-        continue;
-      else if ((tag != GST_MAKE_FOURCC ('i', 'x', '0' + stream->num / 10,
-                  '0' + stream->num % 10)) &&
-          (tag != GST_MAKE_FOURCC ('0' + stream->num / 10,
-                  '0' + stream->num % 10, 'i', 'x'))) {
-        /* Some ODML files (created by god knows what muxer) have a ##ix format
-         * instead of the 'official' ix##. They are still valid though. */
-        GST_WARNING_OBJECT (avi, "Not an ix## chunk (%" GST_FOURCC_FORMAT ")",
-            GST_FOURCC_ARGS (tag));
-        gst_buffer_unref (buf);
-        continue;
-      }
+  for (n = 0; n < avi->num_streams; n++) {
+    GstAviStream *s = &avi->stream[n];
 
-      if (!gst_avi_demux_parse_subindex (avi, stream, buf))
-        continue;
+    if (s->indexes == NULL)
+      continue;
+    left = s->idx_n > s->current_entry ? s->idx_n - s->current_entry : 0;
+    if (left < min_left) {
+      min_left = left;
+      stream = s;
     }
+  }
+  if (stream)
+    gst_avi_demux_read_subindex_pull (avi, stream);
+}
 
-    g_free (stream->indexes);
-    stream->indexes = NULL;
+/*
+ * Read AVI index. Only the first subindex of each stream is read here, so
+ * playback can start right away; the others follow while playing.
+ */
+static void
+gst_avi_demux_read_subindexes_pull (GstAviDemux * avi)
+{
+  gint n;
+
+  GST_DEBUG_OBJECT (avi, "read subindexes for %d streams", avi->num_streams);
+
+  for (n = 0; n < avi->num_streams; n++) {
+    GstAviStream *stream = &avi->stream[n];
+
+    while (stream->idx_n == 0 && gst_avi_demux_read_subindex_pull (avi,
+            stream));
+    if (stream->indexes)
+      avi->subindexes_pending = TRUE;
   }
   /* get stream stats now */
   avi->have_index = gst_avi_demux_do_index_stats (avi);
+
+  /* the index durations are only known once everything was read, the
+   * header durations are used until then */
+  if (avi->subindexes_pending) {
+    for (n = 0; n < avi->num_streams; n++) {
+      if (avi->stream[n].indexes)
+        avi->stream[n].idx_duration = GST_CLOCK_TIME_NONE;
+    }
+  }
 }
 
 /*
@@ -2591,9 +2697,9 @@ gst_avi_demux_index_next (GstAviDemux * avi, GstAviStream * stream,
 static guint
 gst_avi_demux_index_entry_search (GstAviIndexEntry * entry, guint64 * total)
 {
-  if (entry->total < *total)
+  if (ENTRY_TOTAL (entry) < *total)
     return -1;
-  else if (entry->total > *total)
+  else if (ENTRY_TOTAL (entry) > *total)
     return 1;
   return 0;
 }
@@ -4423,7 +4529,7 @@ gst_avi_demux_move_stream (GstAviDemux * avi, GstAviStream * stream,
       stream->current_offset_end);
 
   GST_DEBUG_OBJECT (avi, "Seeking to offset %" G_GUINT64_FORMAT,
-      stream->index[index].offset);
+      (guint64) stream->index[index].offset);
 }
 
 /*
@@ -4446,6 +4552,11 @@ gst_avi_demux_do_seek (GstAviDemux * avi, GstSegment * segment)
       " keyframe seeking:%d, %s", GST_TIME_ARGS (seek_time), keyframe,
       snap_types[before ? 1 : 0][after ? 1 : 0]);
 
+  /* seeking needs the complete index */
+  if (G_UNLIKELY (avi->subindexes_pending) && (seek_time > 0 ||
+          segment->rate < 0.0))
+    gst_avi_demux_read_all_subindexes_pull (avi);
+
   /* FIXME, this code assumes the main stream with keyframes is stream 0,
    * which is mostly correct... */
   stream = &avi->stream[avi->main_stream];
@@ -5030,6 +5141,11 @@ gst_avi_demux_advance (GstAviDemux * avi, GstAviStream * stream,
   /* move forwards */
   new_entry = old_entry + 1;
 
+  /* the rest of the index may not have been read yet */
+  while (G_UNLIKELY (new_entry >= stream->stop_entry && stream->indexes &&
+          avi->segment.rate > 0.0))
+    gst_avi_demux_read_subindex_pull (avi, stream);
+
   /* see if we reached the end */
   if (new_entry >= stream->stop_entry) {
     if (avi->segment.rate < 0.0) {
@@ -5058,7 +5174,7 @@ gst_avi_demux_advance (GstAviDemux * avi, GstAviStream * stream,
 
   if (new_entry != old_entry) {
     stream->current_entry = new_entry;
-    stream->current_total = stream->index[new_entry].total;
+    stream->current_total = ENTRY_TOTAL (&stream->index[new_entry]);
 
     if (new_entry == old_entry + 1) {
       GST_DEBUG_OBJECT (avi, "moved forwards from %u to %u",
@@ -5631,6 +5747,9 @@ gst_avi_demux_loop (GstPad * pad)
       if (G_UNLIKELY (avi->got_tags)) {
         push_tag_lists (avi);
       }
+      /* read the rest of the index a bit at a time while playing */
+      if (G_UNLIKELY (avi->subindexes_pending))
+        gst_avi_demux_read_next_subindex_pull (avi);
       /* process each index entry in turn */
       res = gst_avi_demux_loop_data (avi);
 
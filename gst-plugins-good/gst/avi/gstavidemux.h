@@ -49,12 +49,14 @@ G_BEGIN_DECLS
    (((chunkid) >> 8) & 0xff) - '0')
 
 
-/* new index entries 24 bytes */
+/* new index entries 16 bytes, the total is split up over total_hi and
+ * total_lo and accessed with ENTRY_TOTAL() and ENTRY_SET_TOTAL() */
 typedef struct {
-  guint32        flags;
-  guint32        size;    /* bytes of the data */
-  guint64        offset;  /* data offset in file */
-  guint64        total;   /* total bytes before */
+  guint64        offset:48;   /* data offset in file */
+  guint64        flags:1;
+  guint64        total_hi:15; /* total bytes before */
+  guint32        total_lo;
+  guint32        size;        /* bytes of the data */
 } GstAviIndexEntry;
 
 typedef struct {
@@ -110,6 +112,7 @@ typedef struct {
   /* openDML support (for files >4GB) */
   gboolean       superindex;
   guint64       *indexes;
+  guint          next_subindex;  /* first entry of indexes not read yet */
 
   /* new indexes */
   GstAviIndexEntry *index;     /* array with index entries */
@@ -154,6 +157,8 @@ typedef struct _GstAviDemux {
   gboolean       have_index;
   /* index offset in the file */
   guint64        index_offset;
+  /* openDML subindexes still to be read while playing (pull mode) */
+  gboolean       subindexes_pending;
 
   /* streams */
   GstAviStream   stream[GST_AVI_DEMUX_MAX_STREAMS];
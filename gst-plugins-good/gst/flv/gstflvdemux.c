@@ -47,13 +47,6 @@
 #include <gst/video/video.h>
 #include <gst/tag/tag.h>
 
-/* FIXME: don't rely on own GstIndex */
-#include "gstindex.c"
-#include "gstmemindex.c"
-#define GST_ASSOCIATION_FLAG_NONE GST_INDEX_ASSOCIATION_FLAG_NONE
-#define GST_ASSOCIATION_FLAG_KEY_UNIT GST_INDEX_ASSOCIATION_FLAG_KEY_UNIT
-#define GST_ASSOCIATION_FLAG_DELTA_UNIT GST_INDEX_ASSOCIATION_FLAG_DELTA_UNIT
-
 static GstStaticPadTemplate flv_sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -112,15 +105,53 @@ static gboolean gst_flv_demux_query (GstPad * pad, GstObject * parent,
 static gboolean gst_flv_demux_src_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
 
-static GstIndex *gst_flv_demux_get_index (GstElement * element);
+/* Returns the index of the first entry with a position >= @pos, must be
+ * called with the object lock held */
+static guint
+gst_flv_demux_index_search_pos (GstFlvDemux * demux, guint64 pos)
+{
+  GstFlvDemuxIndexEntry *entries = (GstFlvDemuxIndexEntry *) demux->index->data;
+  guint lo = 0, hi = demux->index->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].pos < pos)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/* Returns the index of the first entry with a time >= @time, must be
+ * called with the object lock held. FLV timestamps are increasing, so the
+ * index sorted by position is sorted by time as well. */
+static guint
+gst_flv_demux_index_search_time (GstFlvDemux * demux, GstClockTime time)
+{
+  GstFlvDemuxIndexEntry *entries = (GstFlvDemuxIndexEntry *) demux->index->data;
+  guint lo = 0, hi = demux->index->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].time < time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
 
 static void
 gst_flv_demux_parse_and_add_index_entry (GstFlvDemux * demux, GstClockTime ts,
     guint64 pos, gboolean keyframe)
 {
-  GstIndexAssociation associations[2];
-  GstIndex *index;
-  GstIndexEntry *entry;
+  GstFlvDemuxIndexEntry entry;
+  guint i;
 
   GST_LOG_OBJECT (demux,
       "adding key=%d association %" GST_TIME_FORMAT "-> %" G_GUINT64_FORMAT,
@@ -130,48 +161,36 @@ gst_flv_demux_parse_and_add_index_entry (GstFlvDemux * demux, GstClockTime ts,
   if (!demux->upstream_seekable)
     return;
 
-  index = gst_flv_demux_get_index (GST_ELEMENT (demux));
+  if (pos > demux->index_max_pos)
+    demux->index_max_pos = pos;
+  if (ts > demux->index_max_time)
+    demux->index_max_time = ts;
 
-  if (!index)
+  /* only keyframes are seek targets, don't waste memory on the rest */
+  if (!keyframe)
     return;
 
-  /* entry may already have been added before, avoid adding indefinitely */
-  entry = gst_index_get_assoc_entry (index, demux->index_id,
-      GST_INDEX_LOOKUP_EXACT, GST_ASSOCIATION_FLAG_NONE, GST_FORMAT_BYTES, pos);
+  GST_OBJECT_LOCK (demux);
+  /* entries are mostly added in increasing order while playing or scanning,
+   * check the tail before doing a binary search */
+  i = demux->index->len;
+  if (i > 0 && g_array_index (demux->index, GstFlvDemuxIndexEntry,
+          i - 1).pos >= pos)
+    i = gst_flv_demux_index_search_pos (demux, pos);
 
-  if (entry) {
-#ifndef GST_DISABLE_GST_DEBUG
-    gint64 time = 0;
-    gboolean key;
-
-    gst_index_entry_assoc_map (entry, GST_FORMAT_TIME, &time);
-    key = ! !(GST_INDEX_ASSOC_FLAGS (entry) & GST_ASSOCIATION_FLAG_KEY_UNIT);
-    GST_LOG_OBJECT (demux, "position already mapped to time %" GST_TIME_FORMAT
-        ", keyframe %d", GST_TIME_ARGS (time), key);
-    /* there is not really a way to delete the existing one */
-    if (time != ts || key != ! !keyframe)
+  /* entry may already have been added before, avoid adding indefinitely */
+  if (i < demux->index->len &&
+      g_array_index (demux->index, GstFlvDemuxIndexEntry, i).pos == pos) {
+    if (g_array_index (demux->index, GstFlvDemuxIndexEntry, i).time != ts)
       GST_DEBUG_OBJECT (demux, "metadata mismatch");
-#endif
-    gst_object_unref (index);
+    GST_OBJECT_UNLOCK (demux);
     return;
   }
 
-  associations[0].format = GST_FORMAT_TIME;
-  associations[0].value = ts;
-  associations[1].format = GST_FORMAT_BYTES;
-  associations[1].value = pos;
-
-  gst_index_add_associationv (index, demux->index_id,
-      (keyframe) ? GST_ASSOCIATION_FLAG_KEY_UNIT :
-      GST_ASSOCIATION_FLAG_DELTA_UNIT, 2,
-      (const GstIndexAssociation *) &associations);
-
-  if (pos > demux->index_max_pos)
-    demux->index_max_pos = pos;
-  if (ts > demux->index_max_time)
-    demux->index_max_time = ts;
-
-  gst_object_unref (index);
+  entry.time = ts;
+  entry.pos = pos;
+  g_array_insert_val (demux->index, i, entry);
+  GST_OBJECT_UNLOCK (demux);
 }
 
 static gchar *
@@ -2390,8 +2409,7 @@ static GstFlowReturn
 gst_flv_demux_seek_to_prev_keyframe (GstFlvDemux * demux)
 {
   GstFlowReturn ret = GST_FLOW_EOS;
-  GstIndex *index;
-  GstIndexEntry *entry = NULL;
+  guint i;
 
   GST_DEBUG_OBJECT (demux,
       "terminated section started at offset %" G_GINT64_FORMAT,
@@ -2409,31 +2427,25 @@ gst_flv_demux_seek_to_prev_keyframe (GstFlvDemux * demux)
 
   GST_DEBUG_OBJECT (demux, "locating previous position");
 
-  index = gst_flv_demux_get_index (GST_ELEMENT (demux));
-
   /* locate index entry before previous start position */
-  if (index) {
-    entry = gst_index_get_assoc_entry (index, demux->index_id,
-        GST_INDEX_LOOKUP_BEFORE, GST_ASSOCIATION_FLAG_KEY_UNIT,
-        GST_FORMAT_BYTES, demux->from_offset - 1);
-
-    if (entry) {
-      gint64 bytes = 0, time = 0;
-
-      gst_index_entry_assoc_map (entry, GST_FORMAT_BYTES, &bytes);
-      gst_index_entry_assoc_map (entry, GST_FORMAT_TIME, &time);
+  GST_OBJECT_LOCK (demux);
+  i = gst_flv_demux_index_search_pos (demux, demux->from_offset);
+  if (i > 0) {
+    GstFlvDemuxIndexEntry entry =
+        g_array_index (demux->index, GstFlvDemuxIndexEntry, i - 1);
 
-      GST_DEBUG_OBJECT (demux, "found index entry for %" G_GINT64_FORMAT
-          " at %" GST_TIME_FORMAT ", seeking to %" G_GINT64_FORMAT,
-          demux->offset - 1, GST_TIME_ARGS (time), bytes);
+    GST_OBJECT_UNLOCK (demux);
 
-      /* setup for next section */
-      demux->to_offset = demux->from_offset;
-      gst_flv_demux_move_to_offset (demux, bytes, FALSE);
-      ret = GST_FLOW_OK;
-    }
+    GST_DEBUG_OBJECT (demux, "found index entry for %" G_GINT64_FORMAT
+        " at %" GST_TIME_FORMAT ", seeking to %" G_GUINT64_FORMAT,
+        demux->offset - 1, GST_TIME_ARGS (entry.time), entry.pos);
 
-    gst_object_unref (index);
+    /* setup for next section */
+    demux->to_offset = demux->from_offset;
+    gst_flv_demux_move_to_offset (demux, entry.pos, FALSE);
+    ret = GST_FLOW_OK;
+  } else {
+    GST_OBJECT_UNLOCK (demux);
   }
 
 done:
@@ -2698,44 +2710,52 @@ static guint64
 gst_flv_demux_find_offset (GstFlvDemux * demux, GstSegment * segment,
     GstSeekFlags seek_flags)
 {
+  GstFlvDemuxIndexEntry entry;
   gint64 bytes = 0;
   gint64 time = 0;
-  GstIndex *index;
-  GstIndexEntry *entry;
+  gboolean found = FALSE;
+  guint i;
 
   g_return_val_if_fail (segment != NULL, 0);
 
   time = segment->position;
 
-  index = gst_flv_demux_get_index (GST_ELEMENT (demux));
-
-  if (index) {
-    /* Let's check if we have an index entry for that seek time */
-    entry = gst_index_get_assoc_entry (index, demux->index_id,
-        seek_flags & GST_SEEK_FLAG_SNAP_AFTER ?
-        GST_INDEX_LOOKUP_AFTER : GST_INDEX_LOOKUP_BEFORE,
-        GST_ASSOCIATION_FLAG_KEY_UNIT, GST_FORMAT_TIME, time);
+  /* Let's check if we have an index entry for that seek time */
+  GST_OBJECT_LOCK (demux);
+  i = gst_flv_demux_index_search_time (demux, time);
+  if (seek_flags & GST_SEEK_FLAG_SNAP_AFTER) {
+    found = (i < demux->index->len);
+  } else {
+    /* the last keyframe at or before the seek time */
+    if (i < demux->index->len &&
+        g_array_index (demux->index, GstFlvDemuxIndexEntry, i).time == time) {
+      found = TRUE;
+    } else if (i > 0) {
+      found = TRUE;
+      i--;
+    }
+  }
+  if (found)
+    entry = g_array_index (demux->index, GstFlvDemuxIndexEntry, i);
+  GST_OBJECT_UNLOCK (demux);
 
-    if (entry) {
-      gst_index_entry_assoc_map (entry, GST_FORMAT_BYTES, &bytes);
-      gst_index_entry_assoc_map (entry, GST_FORMAT_TIME, &time);
+  if (found) {
+    bytes = entry.pos;
+    time = entry.time;
 
-      GST_DEBUG_OBJECT (demux, "found index entry for %" GST_TIME_FORMAT
-          " at %" GST_TIME_FORMAT ", seeking to %" G_GINT64_FORMAT,
-          GST_TIME_ARGS (segment->position), GST_TIME_ARGS (time), bytes);
+    GST_DEBUG_OBJECT (demux, "found index entry for %" GST_TIME_FORMAT
+        " at %" GST_TIME_FORMAT ", seeking to %" G_GINT64_FORMAT,
+        GST_TIME_ARGS (segment->position), GST_TIME_ARGS (time), bytes);
 
-      /* Key frame seeking */
-      if (seek_flags & GST_SEEK_FLAG_KEY_UNIT) {
-        /* Adjust the segment so that the keyframe fits in */
-        segment->start = segment->time = time;
-        segment->position = time;
-      }
-    } else {
-      GST_DEBUG_OBJECT (demux, "no index entry found for %" GST_TIME_FORMAT,
-          GST_TIME_ARGS (segment->start));
+    /* Key frame seeking */
+    if (seek_flags & GST_SEEK_FLAG_KEY_UNIT) {
+      /* Adjust the segment so that the keyframe fits in */
+      segment->start = segment->time = time;
+      segment->position = time;
     }
-
-    gst_object_unref (index);
+  } else {
+    GST_DEBUG_OBJECT (demux, "no index entry found for %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (segment->start));
   }
 
   return bytes;
@@ -3136,18 +3156,8 @@ gst_flv_demux_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       break;
     case GST_EVENT_EOS:
     {
-      GstIndex *index;
-
       GST_DEBUG_OBJECT (demux, "received EOS");
 
-      index = gst_flv_demux_get_index (GST_ELEMENT (demux));
-
-      if (index) {
-        GST_DEBUG_OBJECT (demux, "committing index");
-        gst_index_commit (index, demux->index_id);
-        gst_object_unref (index);
-      }
-
       if (!demux->audio_pad && !demux->video_pad) {
         GST_ELEMENT_ERROR (demux, STREAM, FAILED,
             ("Internal data stream error."), ("Got EOS before any data"));
@@ -3309,8 +3319,7 @@ gst_flv_demux_query (GstPad * pad, GstObject * parent, GstQuery * query)
         }
       }
       res = TRUE;
-      /* FIXME, check index this way is not thread safe */
-      if (fmt != GST_FORMAT_TIME || !demux->index) {
+      if (fmt != GST_FORMAT_TIME) {
         gst_query_set_seeking (query, fmt, FALSE, -1, -1);
       } else if (demux->random_access) {
         gst_query_set_seeking (query, GST_FORMAT_TIME, TRUE, 0,
@@ -3371,24 +3380,10 @@ gst_flv_demux_change_state (GstElement * element, GstStateChange transition)
 
   switch (transition) {
     case GST_STATE_CHANGE_READY_TO_PAUSED:
-      /* If this is our own index destroy it as the
-       * old entries might be wrong for the new stream */
-      if (demux->own_index) {
-        gst_object_unref (demux->index);
-        demux->index = NULL;
-        demux->own_index = FALSE;
-      }
-
-      /* If no index was created, generate one */
-      if (G_UNLIKELY (!demux->index)) {
-        GST_DEBUG_OBJECT (demux, "no index provided creating our own");
-
-        demux->index = g_object_new (gst_mem_index_get_type (), NULL);
-
-        gst_index_get_writer_id (demux->index, GST_OBJECT (demux),
-            &demux->index_id);
-        demux->own_index = TRUE;
-      }
+      /* the old entries might be wrong for the new stream */
+      GST_OBJECT_LOCK (demux);
+      g_array_set_size (demux->index, 0);
+      GST_OBJECT_UNLOCK (demux);
       gst_flv_demux_cleanup (demux);
       break;
     default:
@@ -3410,55 +3405,6 @@ gst_flv_demux_change_state (GstElement * element, GstStateChange transition)
   return ret;
 }
 
-#if 0
-static void
-gst_flv_demux_set_index (GstElement * element, GstIndex * index)
-{
-  GstFlvDemux *demux = GST_FLV_DEMUX (element);
-  GstIndex *old_index;
-
-  GST_OBJECT_LOCK (demux);
-
-  old_index = demux->index;
-
-  if (index) {
-    demux->index = gst_object_ref (index);
-    demux->own_index = FALSE;
-  } else
-    demux->index = NULL;
-
-  if (old_index)
-    gst_object_unref (demux->index);
-
-  gst_object_ref (index);
-
-  GST_OBJECT_UNLOCK (demux);
-
-  /* object lock might be taken again */
-  if (index)
-    gst_index_get_writer_id (index, GST_OBJECT (element), &demux->index_id);
-
-  GST_DEBUG_OBJECT (demux, "Set index %" GST_PTR_FORMAT, demux->index);
-
-  gst_object_unref (index);
-}
-#endif
-
-static GstIndex *
-gst_flv_demux_get_index (GstElement * element)
-{
-  GstIndex *result = NULL;
-
-  GstFlvDemux *demux = GST_FLV_DEMUX (element);
-
-  GST_OBJECT_LOCK (demux);
-  if (demux->index)
-    result = gst_object_ref (demux->index);
-  GST_OBJECT_UNLOCK (demux);
-
-  return result;
-}
-
 static void
 gst_flv_demux_dispose (GObject * object)
 {
@@ -3508,7 +3454,7 @@ gst_flv_demux_dispose (GObject * object)
   }
 
   if (demux->index) {
-    gst_object_unref (demux->index);
+    g_array_free (demux->index, TRUE);
     demux->index = NULL;
   }
 
@@ -3536,11 +3482,6 @@ gst_flv_demux_class_init (GstFlvDemuxClass * klass)
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_flv_demux_change_state);
 
-#if 0
-  gstelement_class->set_index = GST_DEBUG_FUNCPTR (gst_flv_demux_set_index);
-  gstelement_class->get_index = GST_DEBUG_FUNCPTR (gst_flv_demux_get_index);
-#endif
-
   gst_element_class_add_static_pad_template (gstelement_class,
       &flv_sink_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -3574,9 +3515,7 @@ gst_flv_demux_init (GstFlvDemux * demux)
   demux->flowcombiner = gst_flow_combiner_new ();
   gst_segment_init (&demux->segment, GST_FORMAT_TIME);
 
-  demux->own_index = FALSE;
-
-  GST_OBJECT_FLAG_SET (demux, GST_ELEMENT_FLAG_INDEXABLE);
+  demux->index = g_array_new (FALSE, FALSE, sizeof (GstFlvDemuxIndexEntry));
 
   gst_flv_demux_cleanup (demux);
 }
@@ -23,7 +23,6 @@
 #include <gst/gst.h>
 #include <gst/base/gstadapter.h>
 #include <gst/base/gstflowcombiner.h>
-#include "gstindex.h"
 
 G_BEGIN_DECLS
 #define GST_TYPE_FLV_DEMUX \
@@ -39,6 +38,12 @@ G_BEGIN_DECLS
 typedef struct _GstFlvDemux GstFlvDemux;
 typedef struct _GstFlvDemuxClass GstFlvDemuxClass;
 
+typedef struct
+{
+  GstClockTime time;
+  guint64 pos;
+} GstFlvDemuxIndexEntry;
+
 typedef enum
 {
   FLV_STATE_HEADER,
@@ -66,9 +71,8 @@ struct _GstFlvDemux
 
   /* <private> */
   
-  GstIndex *index;
-  gint index_id;
-  gboolean own_index;
+  /* keyframe seek index, sorted by position, protected by object lock */
+  GArray *index;
   
   GArray * times;
   GArray * filepositions;
@@ -85,15 +85,53 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
         "rate = (int) [ 1, MAX ], "
         "channels = (int) [ 1, MAX ], layout = (string) interleaved"));
 
+/* Number of frames that are deinterleaved at once. Every block of the input
+ * is read for all channels before moving on to the next one, so for e.g. 64
+ * channels of 32 bit samples only 16kB of input are touched at a time
+ * instead of the complete buffer for every channel. */
+#define BLOCK_FRAMES 64
+
+/* out[c] is the output for input channel c, or NULL if the channel is not
+ * needed. Whenever four neighbouring channels are needed they are
+ * deinterleaved as one 4xN tile, which reads four adjacent input samples
+ * and writes four output streams per frame */
 #define MAKE_FUNC(type) \
-static void deinterleave_##type (guint##type *out, guint##type *in, \
-    guint stride, guint nframes) \
+static void deinterleave_##type (guint##type **out, guint##type *in, \
+    guint channels, guint nframes) \
 { \
-  gint i; \
+  guint i, c, b, n; \
   \
-  for (i = 0; i < nframes; i++) { \
-    out[i] = *in; \
-    in += stride; \
+  for (b = 0; b < nframes; b += BLOCK_FRAMES) { \
+    n = MIN (nframes - b, BLOCK_FRAMES); \
+    \
+    for (c = 0; c < channels;) { \
+      const guint##type *p = in + b * channels + c; \
+      \
+      if (c + 4 <= channels && out[c] && out[c + 1] && out[c + 2] \
+          && out[c + 3]) { \
+        guint##type *o0 = out[c] + b, *o1 = out[c + 1] + b; \
+        guint##type *o2 = out[c + 2] + b, *o3 = out[c + 3] + b; \
+        \
+        for (i = 0; i < n; i++) { \
+          o0[i] = p[0]; \
+          o1[i] = p[1]; \
+          o2[i] = p[2]; \
+          o3[i] = p[3]; \
+          p += channels; \
+        } \
+        c += 4; \
+      } else { \
+        if (out[c]) { \
+          guint##type *o0 = out[c] + b; \
+          \
+          for (i = 0; i < n; i++) { \
+            o0[i] = *p; \
+            p += channels; \
+          } \
+        } \
+        c++; \
+      } \
+    } \
   } \
 }
 
@@ -103,14 +141,27 @@ MAKE_FUNC (32);
 MAKE_FUNC (64);
 
 static void
-deinterleave_24 (guint8 * out, guint8 * in, guint stride, guint nframes)
+deinterleave_24 (guint8 ** out, guint8 * in, guint channels, guint nframes)
 {
-  gint i;
+  guint i, c, b, n;
+
+  for (b = 0; b < nframes; b += BLOCK_FRAMES) {
+    n = MIN (nframes - b, BLOCK_FRAMES);
+
+    for (c = 0; c < channels; c++) {
+      const guint8 *p = in + (b * channels + c) * 3;
+      guint8 *o0;
+
+      if (!out[c])
+        continue;
 
-  for (i = 0; i < nframes; i++) {
-    memcpy (out, in, 3);
-    out += 3;
-    in += stride * 3;
+      o0 = out[c] + b * 3;
+      for (i = 0; i < n; i++) {
+        memcpy (o0, p, 3);
+        o0 += 3;
+        p += channels * 3;
+      }
+    }
   }
 }
 
@@ -828,7 +879,8 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
   guint i;
   GList *srcs;
   GstBuffer **buffers_out = g_new0 (GstBuffer *, channels);
-  guint8 *in, *out;
+  GstMapInfo *write_info;
+  gpointer *out;
   GstMapInfo read_info;
   GList *pending_events, *l;
 
@@ -880,19 +932,29 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
     goto done;
   }
 
-  /* deinterleave */
+  /* deinterleave all channels at once */
+  write_info = g_newa (GstMapInfo, channels);
+  out = g_newa (gpointer, channels);
+  for (i = 0; i < channels; i++) {
+    if (buffers_out[i]) {
+      gst_buffer_map (buffers_out[i], &write_info[i], GST_MAP_WRITE);
+      out[i] = write_info[i].data;
+    } else {
+      out[i] = NULL;
+    }
+  }
+
+  self->func (out, read_info.data, channels, nframes);
+
+  for (i = 0; i < channels; i++) {
+    if (buffers_out[i])
+      gst_buffer_unmap (buffers_out[i], &write_info[i]);
+  }
+
   for (srcs = self->srcpads, i = 0; srcs; srcs = srcs->next, i++) {
     GstPad *pad = (GstPad *) srcs->data;
-    GstMapInfo write_info;
 
-    in = (guint8 *) read_info.data;
-    in += i * (GST_AUDIO_INFO_WIDTH (&self->audio_info) / 8);
     if (buffers_out[i]) {
-      gst_buffer_map (buffers_out[i], &write_info, GST_MAP_WRITE);
-      out = (guint8 *) write_info.data;
-      self->func (out, in, channels, nframes);
-      gst_buffer_unmap (buffers_out[i], &write_info);
-
       ret = gst_pad_push (pad, buffers_out[i]);
       buffers_out[i] = NULL;
       if (ret == GST_FLOW_OK)
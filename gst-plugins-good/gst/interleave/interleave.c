@@ -95,18 +95,56 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
         "rate = (int) [ 1, MAX ], "
         "channels = (int) [ 1, MAX ], "
         "format = (string) " GST_AUDIO_FORMATS_ALL ", "
-        "layout = (string) interleaved")
+        "layout = (string) {interleaved, non-interleaved}")
     );
 
+/* Number of frames that are interleaved at once. All channels are written
+ * into the same block of the output before moving on to the next one, so
+ * for e.g. 64 channels of 32 bit samples only 16kB of output are touched
+ * at a time instead of the complete buffer for every channel. */
+#define BLOCK_FRAMES 64
+
+/* in[c] is the input for output channel c, or NULL if the channel is silent
+ * and was already set to zero. Whenever four neighbouring channels have
+ * data they are interleaved as one 4xN tile, which reads four input streams
+ * and writes four adjacent output samples per frame */
 #define MAKE_FUNC(type) \
-static void interleave_##type (guint##type *out, guint##type *in, \
-    guint stride, guint nframes) \
+static void interleave_##type (guint##type *out, guint##type **in, \
+    guint channels, guint nframes) \
 { \
-  gint i; \
+  guint i, c, b, n; \
   \
-  for (i = 0; i < nframes; i++) { \
-    *out = in[i]; \
-    out += stride; \
+  for (b = 0; b < nframes; b += BLOCK_FRAMES) { \
+    n = MIN (nframes - b, BLOCK_FRAMES); \
+    \
+    for (c = 0; c < channels;) { \
+      guint##type *o = out + b * channels + c; \
+      \
+      if (c + 4 <= channels && in[c] && in[c + 1] && in[c + 2] \
+          && in[c + 3]) { \
+        const guint##type *i0 = in[c] + b, *i1 = in[c + 1] + b; \
+        const guint##type *i2 = in[c + 2] + b, *i3 = in[c + 3] + b; \
+        \
+        for (i = 0; i < n; i++) { \
+          o[0] = i0[i]; \
+          o[1] = i1[i]; \
+          o[2] = i2[i]; \
+          o[3] = i3[i]; \
+          o += channels; \
+        } \
+        c += 4; \
+      } else { \
+        if (in[c]) { \
+          const guint##type *i0 = in[c] + b; \
+          \
+          for (i = 0; i < n; i++) { \
+            *o = i0[i]; \
+            o += channels; \
+          } \
+        } \
+        c++; \
+      } \
+    } \
   } \
 }
 
@@ -116,14 +154,27 @@ MAKE_FUNC (32);
 MAKE_FUNC (64);
 
 static void
-interleave_24 (guint8 * out, guint8 * in, guint stride, guint nframes)
+interleave_24 (guint8 * out, guint8 ** in, guint channels, guint nframes)
 {
-  gint i;
+  guint i, c, b, n;
+
+  for (b = 0; b < nframes; b += BLOCK_FRAMES) {
+    n = MIN (nframes - b, BLOCK_FRAMES);
+
+    for (c = 0; c < channels; c++) {
+      guint8 *o = out + (b * channels + c) * 3;
+      const guint8 *i0;
+
+      if (!in[c])
+        continue;
 
-  for (i = 0; i < nframes; i++) {
-    memcpy (out, in, 3);
-    out += stride * 3;
-    in += 3;
+      i0 = in[c] + b * 3;
+      for (i = 0; i < n; i++) {
+        memcpy (o, i0, 3);
+        o += channels * 3;
+        i0 += 3;
+      }
+    }
   }
 }
 
@@ -197,7 +248,8 @@ enum
 {
   PROP_0,
   PROP_CHANNEL_POSITIONS,
-  PROP_CHANNEL_POSITIONS_FROM_INPUT
+  PROP_CHANNEL_POSITIONS_FROM_INPUT,
+  PROP_NON_INTERLEAVED
 };
 
 static void gst_interleave_set_property (GObject * object,
@@ -411,6 +463,23 @@ gst_interleave_class_init (GstInterleaveClass * klass)
           "Take channel positions from the input", TRUE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstInterleave:non-interleaved
+   *
+   * Output non-interleaved audio with one plane per channel instead of
+   * interleaved samples. The input buffers are then placed into the output
+   * buffer as they are without copying the samples, as long as the number
+   * of memories fits into one buffer.
+   *
+   * This has to be set before the caps are negotiated.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_NON_INTERLEAVED,
+      g_param_spec_boolean ("non-interleaved", "Non-interleaved",
+          "Output one plane per channel instead of interleaved samples",
+          FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_interleave_request_new_pad);
   gstelement_class->release_pad =
@@ -465,6 +534,9 @@ gst_interleave_set_property (GObject * object, guint prop_id,
         self->channel_positions = self->input_channel_positions;
       }
       break;
+    case PROP_NON_INTERLEAVED:
+      self->non_interleaved = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -484,6 +556,9 @@ gst_interleave_get_property (GObject * object, guint prop_id,
     case PROP_CHANNEL_POSITIONS_FROM_INPUT:
       g_value_set_boolean (value, self->channel_positions_from_input);
       break;
+    case PROP_NON_INTERLEAVED:
+      g_value_set_boolean (value, self->non_interleaved);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -616,7 +691,9 @@ gst_interleave_release_pad (GstElement * element, GstPad * pad)
       srccaps = gst_caps_copy (self->sinkcaps);
       s = gst_caps_get_structure (srccaps, 0);
 
-      gst_structure_set (s, "channels", G_TYPE_INT, self->channels, NULL);
+      gst_structure_set (s, "channels", G_TYPE_INT, self->channels, "layout",
+          G_TYPE_STRING, self->non_interleaved ? "non-interleaved" :
+          "interleaved", NULL);
       gst_interleave_set_channel_positions (self, s);
 
       gst_interleave_send_stream_start (self);
@@ -815,7 +892,8 @@ gst_interleave_sink_setcaps (GstInterleave * self, GstPad * pad,
     gst_structure_remove_field (s, "channel-mask");
 
     gst_structure_set (s, "channels", G_TYPE_INT, self->channels, "layout",
-        G_TYPE_STRING, "interleaved", NULL);
+        G_TYPE_STRING, self->non_interleaved ? "non-interleaved" :
+        "interleaved", NULL);
     gst_interleave_set_channel_positions (self, s);
 
     gst_interleave_send_stream_start (self);
@@ -1163,19 +1241,116 @@ gst_interleave_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
   return result;
 }
 
+/* Places the planes of all channels after each other. The memory of the
+ * input buffers is shared when it fits into a single buffer, which is
+ * usually the case for a few channels. Otherwise every plane is copied with
+ * one memcpy, which is still a lot cheaper than interleaving */
+static GstBuffer *
+gst_interleave_make_non_interleaved (GstInterleave * self,
+    GstBuffer ** inbufs, guint size)
+{
+  GstBuffer *outbuf;
+  GstMapInfo info;
+  guint n_memory = 0;
+  gint i;
+
+  for (i = 0; i < self->channels; i++)
+    n_memory += inbufs[i] ? gst_buffer_n_memory (inbufs[i]) : 1;
+
+  if (n_memory <= gst_buffer_get_max_memory ()) {
+    outbuf = gst_buffer_new ();
+
+    for (i = 0; i < self->channels; i++) {
+      if (inbufs[i]) {
+        gst_buffer_copy_into (outbuf, inbufs[i], GST_BUFFER_COPY_MEMORY, 0,
+            size);
+      } else {
+        GstMemory *mem = gst_allocator_alloc (NULL, size, NULL);
+
+        gst_memory_map (mem, &info, GST_MAP_WRITE);
+        memset (info.data, 0, size);
+        gst_memory_unmap (mem, &info);
+        gst_buffer_append_memory (outbuf, mem);
+      }
+    }
+  } else {
+    outbuf = gst_buffer_new_allocate (NULL, size * self->channels, NULL);
+    gst_buffer_map (outbuf, &info, GST_MAP_WRITE);
+
+    for (i = 0; i < self->channels; i++) {
+      if (inbufs[i])
+        gst_buffer_extract (inbufs[i], 0, info.data + i * size, size);
+      else
+        memset (info.data + i * size, 0, size);
+    }
+    gst_buffer_unmap (outbuf, &info);
+  }
+
+  return outbuf;
+}
+
+static GstBuffer *
+gst_interleave_make_interleaved (GstInterleave * self, GstBuffer ** inbufs,
+    guint size, guint nsamples)
+{
+  GstBuffer *outbuf;
+  GstMapInfo write_info;
+  GstMapInfo *in_info;
+  gpointer *in_data;
+  gboolean silent_channels = FALSE;
+  gint i;
+
+  outbuf = gst_buffer_new_allocate (NULL, size * self->channels, NULL);
+
+  if (outbuf == NULL || gst_buffer_get_size (outbuf) < size * self->channels) {
+    if (outbuf)
+      gst_buffer_unref (outbuf);
+    return NULL;
+  }
+
+  in_info = g_newa (GstMapInfo, self->channels);
+  in_data = g_newa (gpointer, self->channels);
+
+  for (i = 0; i < self->channels; i++) {
+    if (inbufs[i]) {
+      gst_buffer_map (inbufs[i], &in_info[i], GST_MAP_READ);
+      in_data[i] = in_info[i].data;
+    } else {
+      in_data[i] = NULL;
+      silent_channels = TRUE;
+    }
+  }
+
+  gst_buffer_map (outbuf, &write_info, GST_MAP_WRITE);
+  if (silent_channels)
+    memset (write_info.data, 0, size * self->channels);
+
+  self->func (write_info.data, in_data, self->channels, nsamples);
+
+  gst_buffer_unmap (outbuf, &write_info);
+
+  for (i = 0; i < self->channels; i++) {
+    if (inbufs[i])
+      gst_buffer_unmap (inbufs[i], &in_info[i]);
+  }
+
+  return outbuf;
+}
+
 static GstFlowReturn
 gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
 {
   guint size;
   GstBuffer *outbuf = NULL;
+  GstBuffer **inbufs;
   GstFlowReturn ret = GST_FLOW_OK;
   GSList *collected;
   guint nsamples;
   guint ncollected = 0;
   gboolean empty = TRUE;
   gint width = self->width / 8;
-  GstMapInfo write_info;
   GstClockTime timestamp = -1;
+  gint i;
 
   size = gst_collect_pads_available (pads);
   if (size == 0)
@@ -1193,21 +1368,13 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
 
   nsamples = size / width;
 
-  outbuf = gst_buffer_new_allocate (NULL, size * self->channels, NULL);
-
-  if (outbuf == NULL || gst_buffer_get_size (outbuf) < size * self->channels) {
-    gst_buffer_unref (outbuf);
-    return GST_FLOW_NOT_NEGOTIATED;
-  }
-
-  gst_buffer_map (outbuf, &write_info, GST_MAP_WRITE);
-  memset (write_info.data, 0, size * self->channels);
+  /* the input buffers, indexed by their channel in the output */
+  inbufs = g_newa (GstBuffer *, self->channels);
+  memset (inbufs, 0, sizeof (GstBuffer *) * self->channels);
 
   for (collected = pads->data; collected != NULL; collected = collected->next) {
     GstCollectData *cdata;
     GstBuffer *inbuf;
-    guint8 *outdata;
-    GstMapInfo input_info;
     gint channel;
 
     cdata = (GstCollectData *) collected->data;
@@ -1215,35 +1382,41 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
     inbuf = gst_collect_pads_take_buffer (pads, cdata, size);
     if (inbuf == NULL) {
       GST_DEBUG_OBJECT (cdata->pad, "No buffer available");
-      goto next;
+      continue;
     }
     ncollected++;
-    gst_buffer_map (inbuf, &input_info, GST_MAP_READ);
 
     if (timestamp == -1)
       timestamp = GST_BUFFER_TIMESTAMP (inbuf);
 
-    if (GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP))
-      goto next;
+    if (GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP)) {
+      gst_buffer_unref (inbuf);
+      continue;
+    }
 
     empty = FALSE;
     channel = GST_INTERLEAVE_PAD_CAST (cdata->pad)->channel;
-    outdata =
-        write_info.data + width * self->default_channels_ordering_map[channel];
-
-    self->func (outdata, input_info.data, self->channels, nsamples);
-    gst_buffer_unmap (inbuf, &input_info);
-
-  next:
-    if (inbuf)
-      gst_buffer_unref (inbuf);
+    channel = self->default_channels_ordering_map[channel];
+    gst_buffer_replace (&inbufs[channel], NULL);
+    inbufs[channel] = inbuf;
   }
 
-  if (ncollected == 0) {
-    gst_buffer_unmap (outbuf, &write_info);
+  if (ncollected == 0)
     goto eos;
+
+  if (self->non_interleaved)
+    outbuf = gst_interleave_make_non_interleaved (self, inbufs, size);
+  else
+    outbuf = gst_interleave_make_interleaved (self, inbufs, size, nsamples);
+
+  for (i = 0; i < self->channels; i++) {
+    if (inbufs[i])
+      gst_buffer_unref (inbufs[i]);
   }
 
+  if (outbuf == NULL)
+    return GST_FLOW_NOT_NEGOTIATED;
+
   GST_OBJECT_LOCK (self);
   if (self->pending_segment) {
     GstEvent *event;
@@ -1314,8 +1487,6 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
   if (empty)
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
 
-  gst_buffer_unmap (outbuf, &write_info);
-
   GST_LOG_OBJECT (self, "pushing outbuf, timestamp %" GST_TIME_FORMAT,
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (outbuf)));
   ret = gst_pad_push (self->src, outbuf);
@@ -42,7 +42,7 @@ G_BEGIN_DECLS
 typedef struct _GstInterleave GstInterleave;
 typedef struct _GstInterleaveClass GstInterleaveClass;
 
-typedef void (*GstInterleaveFunc) (gpointer out, gpointer in, guint stride, guint nframes);
+typedef void (*GstInterleaveFunc) (gpointer out, gpointer * in, guint channels, guint nframes);
 
 struct _GstInterleave
 {
@@ -59,6 +59,7 @@ struct _GstInterleave
   GValueArray *channel_positions;
   GValueArray *input_channel_positions;
   gboolean channel_positions_from_input;
+  gboolean non_interleaved;
 
   gint default_channels_ordering_map[64];
 
@@ -3629,6 +3629,12 @@ atom_traf_free (AtomTRAF * traf)
   g_list_free (traf->sdtps);
   traf->sdtps = NULL;
 
+  if (traf->tfdt) {
+    atom_full_clear (&traf->tfdt->header);
+    g_free (traf->tfdt);
+    traf->tfdt = NULL;
+  }
+
   g_free (traf);
 }
 
@@ -3694,6 +3700,23 @@ atom_tfhd_copy_data (AtomTFHD * tfhd, guint8 ** buffer, guint64 * size,
   return *offset - original_offset;
 }
 
+static guint64
+atom_tfdt_copy_data (AtomTFDT * tfdt, guint8 ** buffer, guint64 * size,
+    guint64 * offset)
+{
+  guint64 original_offset = *offset;
+
+  if (!atom_full_copy_data (&tfdt->header, buffer, size, offset)) {
+    return 0;
+  }
+
+  /* version 1, 64-bit */
+  prop_copy_uint64 (tfdt->base_media_decode_time, buffer, size, offset);
+
+  atom_write_size (buffer, size, offset, original_offset);
+  return *offset - original_offset;
+}
+
 static guint64
 atom_trun_copy_data (AtomTRUN * trun, guint8 ** buffer, guint64 * size,
     guint64 * offset, guint32 * data_offset)
@@ -3775,6 +3798,9 @@ atom_traf_copy_data (AtomTRAF * traf, guint8 ** buffer, guint64 * size,
   if (!atom_tfhd_copy_data (&traf->tfhd, buffer, size, offset)) {
     return 0;
   }
+  if (traf->tfdt && !atom_tfdt_copy_data (traf->tfdt, buffer, size, offset)) {
+    return 0;
+  }
 
   walker = g_list_first (traf->truns);
   while (walker != NULL) {
@@ -3937,6 +3963,23 @@ atom_traf_new (AtomsContext * context, guint32 track_ID)
   return traf;
 }
 
+/* adds a tfdt with the decode time of the first sample in this fragment,
+ * and makes tfhd signal that data offsets are relative to the moof,
+ * as required for CMAF chunks */
+void
+atom_traf_set_base_decode_time (AtomTRAF * traf, guint64 base_decode_time)
+{
+  guint8 flags[3] = { 0, 0, 0 };
+
+  if (!traf->tfdt) {
+    traf->tfdt = g_new0 (AtomTFDT, 1);
+    atom_full_init (&traf->tfdt->header, FOURCC_tfdt, 0, 0, 1, flags);
+  }
+  traf->tfdt->base_media_decode_time = base_decode_time;
+
+  traf->tfhd.header.flags[0] |= (TF_DEFAULT_BASE_IS_MOOF >> 16);
+}
+
 static void
 atom_traf_add_trun (AtomTRAF * traf, AtomTRUN * trun)
 {
@@ -680,6 +680,13 @@ typedef struct _AtomTFHD
   guint32 default_sample_flags;
 } AtomTFHD;
 
+typedef struct _AtomTFDT
+{
+  AtomFull header;
+
+  guint64 base_media_decode_time;
+} AtomTFDT;
+
 typedef struct _TRUNSampleEntry
 {
   guint32 sample_duration;
@@ -716,6 +723,8 @@ typedef struct _AtomTRAF
   Atom header;
 
   AtomTFHD tfhd;
+  /* optional, only written if set */
+  AtomTFDT *tfdt;
 
   /* list of AtomTRUN */
   GList *truns;
@@ -871,6 +880,8 @@ void       atom_traf_add_samples       (AtomTRAF * traf, guint32 delta,
                                         guint32 size, gboolean sync, gint64 pts_offset,
                                         gboolean sdtp_sync);
 guint32    atom_traf_get_sample_num    (AtomTRAF * traf);
+void       atom_traf_set_base_decode_time (AtomTRAF * traf,
+                                        guint64 base_decode_time);
 void       atom_moof_add_traf          (AtomMOOF *moof, AtomTRAF *traf);
 
 AtomMFRA*  atom_mfra_new               (AtomsContext *context);
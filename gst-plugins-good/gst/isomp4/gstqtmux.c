@@ -259,6 +259,7 @@ enum
   PROP_FAST_START_TEMP_FILE,
   PROP_MOOV_RECOV_FILE,
   PROP_FRAGMENT_DURATION,
+  PROP_CHUNK_FRAMES,
   PROP_STREAMABLE,
   PROP_RESERVED_MAX_DURATION,
   PROP_RESERVED_DURATION_REMAINING,
@@ -268,6 +269,7 @@ enum
   PROP_DTS_METHOD,
 #endif
   PROP_DO_CTTS,
+  PROP_WAIT_FOR_SPARSE_STREAMS,
 };
 
 /* some spare for header size as well */
@@ -280,6 +282,7 @@ enum
 #define DEFAULT_FAST_START_TEMP_FILE    NULL
 #define DEFAULT_MOOV_RECOV_FILE         NULL
 #define DEFAULT_FRAGMENT_DURATION       0
+#define DEFAULT_CHUNK_FRAMES            0
 #define DEFAULT_STREAMABLE              TRUE
 #ifndef GST_REMOVE_DEPRECATED
 #define DEFAULT_DTS_METHOD              DTS_METHOD_REORDER
@@ -287,6 +290,7 @@ enum
 #define DEFAULT_RESERVED_MAX_DURATION   GST_CLOCK_TIME_NONE
 #define DEFAULT_RESERVED_MOOV_UPDATE_PERIOD   GST_CLOCK_TIME_NONE
 #define DEFAULT_RESERVED_BYTES_PER_SEC_PER_TRAK 550
+#define DEFAULT_WAIT_FOR_SPARSE_STREAMS TRUE
 
 static void gst_qt_mux_finalize (GObject * object);
 
@@ -448,6 +452,25 @@ gst_qt_mux_class_init (GstQTMuxClass * klass)
           0, G_MAXUINT32, klass->format == GST_QT_MUX_FORMAT_ISML ?
           2000 : DEFAULT_FRAGMENT_DURATION,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstQTMux:chunk-frames:
+   *
+   * In fragmented mode, write each fragment as a series of moof/mdat
+   * chunks of this many samples (CMAF chunks), so that data leaves the
+   * muxer as soon as a chunk is complete instead of once the whole fragment
+   * is. Every traf then carries a tfdt with its base decode time. The moof
+   * of the first chunk of a fragment is pushed as a non-delta buffer while
+   * the following chunks are marked %GST_BUFFER_FLAG_DELTA_UNIT, so
+   * downstream can find the fragment (segment) boundaries.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_CHUNK_FRAMES,
+      g_param_spec_uint ("chunk-frames", "Chunk frames",
+          "Number of samples per moof/mdat chunk in fragmented mode "
+          "(0 = one chunk per fragment)",
+          0, G_MAXUINT32, DEFAULT_CHUNK_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_STREAMABLE,
       g_param_spec_boolean ("streamable", "Streamable", streamable_desc,
           streamable, streamable_flags | G_PARAM_STATIC_STRINGS));
@@ -479,6 +502,24 @@ gst_qt_mux_class_init (GstQTMuxClass * klass)
           "Multiplier for converting reserved-max-duration into bytes of header to reserve, per second, per track",
           0, 10000, DEFAULT_RESERVED_BYTES_PER_SEC_PER_TRAK,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstQTMux:wait-for-sparse-streams:
+   *
+   * Whether to wait for data on sparse streams (subtitles) before muxing
+   * the other streams. Sparse streams that don't send GAP events stall all
+   * other streams in live pipelines; when this is %FALSE they are muxed
+   * whenever they happen to have data and never hold back the others.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_WAIT_FOR_SPARSE_STREAMS,
+      g_param_spec_boolean ("wait-for-sparse-streams",
+          "Wait for sparse streams",
+          "Wait for data on sparse (subtitle) streams before muxing the "
+          "other streams", DEFAULT_WAIT_FOR_SPARSE_STREAMS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
 
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_qt_mux_request_new_pad);
@@ -523,6 +564,8 @@ gst_qt_mux_pad_reset (GstQTPad * qtpad)
     qtpad->traf = NULL;
   }
   atom_array_clear (&qtpad->fragment_buffers);
+  qtpad->fragment_chunk = FALSE;
+  qtpad->decode_time = 0;
 
   /* reference owned elsewhere */
   qtpad->tfra = NULL;
@@ -632,6 +675,7 @@ gst_qt_mux_init (GstQTMux * qtmux, GstQTMuxClass * qtmux_klass)
   qtmux->reserved_moov_update_period = DEFAULT_RESERVED_MOOV_UPDATE_PERIOD;
   qtmux->reserved_bytes_per_sec_per_trak =
       DEFAULT_RESERVED_BYTES_PER_SEC_PER_TRAK;
+  qtmux->wait_for_sparse_streams = DEFAULT_WAIT_FOR_SPARSE_STREAMS;
 
   /* always need this */
   qtmux->context =
@@ -2677,6 +2721,7 @@ gst_qt_mux_pad_fragment_add_buffer (GstQTMux * qtmux, GstQTPad * pad,
     guint32 delta, guint32 size, gboolean sync, gint64 pts_offset)
 {
   GstFlowReturn ret = GST_FLOW_OK;
+  gboolean new_fragment = TRUE;
 
   /* setup if needed */
   if (G_UNLIKELY (!pad->traf || force))
@@ -2685,8 +2730,13 @@ gst_qt_mux_pad_fragment_add_buffer (GstQTMux * qtmux, GstQTPad * pad,
 flush:
   /* flush pad fragment if threshold reached,
    * or at new keyframe if we should be minding those in the first place */
-  if (G_UNLIKELY (force || (sync && pad->sync) ||
-          pad->fragment_duration < (gint64) delta)) {
+  new_fragment = force || (sync && pad->sync) ||
+      pad->fragment_duration < (gint64) delta;
+
+  /* in chunked mode, also flush once the current chunk is full; the
+   * fragment itself then continues in the next chunk */
+  if (G_UNLIKELY (new_fragment || (qtmux->chunk_frames > 0 &&
+              atom_traf_get_sample_num (pad->traf) >= qtmux->chunk_frames))) {
     AtomMOOF *moof;
     guint64 size = 0, offset = 0;
     guint8 *data = NULL;
@@ -2703,6 +2753,9 @@ flush:
     pad->traf = NULL;
     atom_moof_copy_data (moof, &data, &size, &offset);
     buffer = _gst_buffer_new_take_data (data, offset);
+    /* only the first chunk of a fragment is a point to start from */
+    if (pad->fragment_chunk)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
     GST_LOG_OBJECT (qtmux, "writing moof size %" G_GSIZE_FORMAT,
         gst_buffer_get_size (buffer));
     ret = gst_qt_mux_send_buffer (qtmux, buffer, &qtmux->header_size, FALSE);
@@ -2731,16 +2784,26 @@ flush:
     atom_array_clear (&pad->fragment_buffers);
     atom_moof_free (moof);
     qtmux->fragment_sequence++;
-    force = FALSE;
+
+    /* the buffer was already added before a forced flush */
+    if (force)
+      return ret;
   }
 
 init:
   if (G_UNLIKELY (!pad->traf)) {
-    GST_LOG_OBJECT (qtmux, "setting up new fragment");
+    GST_LOG_OBJECT (qtmux, "setting up new %s",
+        new_fragment ? "fragment" : "chunk");
     pad->traf = atom_traf_new (qtmux->context, atom_trak_get_id (pad->trak));
     atom_array_init (&pad->fragment_buffers, 512);
-    pad->fragment_duration = gst_util_uint64_scale (qtmux->fragment_duration,
-        atom_trak_get_timescale (pad->trak), 1000);
+    if (new_fragment) {
+      pad->fragment_duration = gst_util_uint64_scale (qtmux->fragment_duration,
+          atom_trak_get_timescale (pad->trak), 1000);
+    }
+    pad->fragment_chunk = !new_fragment;
+
+    if (qtmux->chunk_frames > 0)
+      atom_traf_set_base_decode_time (pad->traf, pad->decode_time);
 
     if (G_UNLIKELY (qtmux->mfra && !pad->tfra)) {
       pad->tfra = atom_tfra_new (qtmux->context, atom_trak_get_id (pad->trak));
@@ -2753,6 +2816,7 @@ init:
       pad->sync && sync);
   atom_array_append (&pad->fragment_buffers, buf, 256);
   pad->fragment_duration -= delta;
+  pad->decode_time += delta;
 
   if (pad->tfra) {
     guint32 sn = atom_traf_get_sample_num (pad->traf);
@@ -4298,6 +4362,37 @@ gst_qt_mux_sink_event (GstCollectPads * pads, GstCollectData * data,
   return ret;
 }
 
+/* Subtitle pads are added unlocked so collectpads can take them out of the
+ * waiting set on GAP events. Without those they still hold back all other
+ * streams, so unless we were asked to wait for them, mark them permanently
+ * non-waiting. */
+static void
+gst_qt_mux_update_sparse_waiting (GstQTMux * qtmux, GstQTPad * qtpad)
+{
+  GstElementClass *klass = GST_ELEMENT_GET_CLASS (qtmux);
+  GstCollectData *cdata = (GstCollectData *) qtpad;
+  gboolean wait;
+
+  if (GST_PAD_PAD_TEMPLATE (cdata->pad) !=
+      gst_element_class_get_pad_template (klass, "subtitle_%u"))
+    return;
+
+  GST_OBJECT_LOCK (qtmux);
+  wait = qtmux->wait_for_sparse_streams;
+  GST_OBJECT_UNLOCK (qtmux);
+
+  GST_DEBUG_OBJECT (qtmux, "pad %s:%s waits for data: %d",
+      GST_DEBUG_PAD_NAME (cdata->pad), wait);
+
+  GST_COLLECT_PADS_STREAM_LOCK (qtmux->collect);
+  GST_COLLECT_PADS_STATE_UNSET (cdata, GST_COLLECT_PADS_STATE_LOCKED);
+  if (!wait) {
+    gst_collect_pads_set_waiting (qtmux->collect, cdata, FALSE);
+    GST_COLLECT_PADS_STATE_SET (cdata, GST_COLLECT_PADS_STATE_LOCKED);
+  }
+  GST_COLLECT_PADS_STREAM_UNLOCK (qtmux->collect);
+}
+
 static void
 gst_qt_mux_release_pad (GstElement * element, GstPad * pad)
 {
@@ -4382,6 +4477,9 @@ gst_qt_mux_request_new_pad (GstElement * element,
   /* set up pad functions */
   collect_pad->set_caps = setcaps_func;
 
+  if (!lock)
+    gst_qt_mux_update_sparse_waiting (qtmux, collect_pad);
+
   gst_pad_set_active (newpad, TRUE);
   gst_element_add_pad (element, newpad);
 
@@ -4439,6 +4537,9 @@ gst_qt_mux_get_property (GObject * object,
     case PROP_FRAGMENT_DURATION:
       g_value_set_uint (value, qtmux->fragment_duration);
       break;
+    case PROP_CHUNK_FRAMES:
+      g_value_set_uint (value, qtmux->chunk_frames);
+      break;
     case PROP_STREAMABLE:
       g_value_set_boolean (value, qtmux->streamable);
       break;
@@ -4470,6 +4571,9 @@ gst_qt_mux_get_property (GObject * object,
     case PROP_RESERVED_BYTES_PER_SEC:
       g_value_set_uint (value, qtmux->reserved_bytes_per_sec_per_trak);
       break;
+    case PROP_WAIT_FOR_SPARSE_STREAMS:
+      g_value_set_boolean (value, qtmux->wait_for_sparse_streams);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4530,6 +4634,9 @@ gst_qt_mux_set_property (GObject * object,
     case PROP_FRAGMENT_DURATION:
       qtmux->fragment_duration = g_value_get_uint (value);
       break;
+    case PROP_CHUNK_FRAMES:
+      qtmux->chunk_frames = g_value_get_uint (value);
+      break;
     case PROP_STREAMABLE:{
       GstQTMuxClass *qtmux_klass =
           (GstQTMuxClass *) (G_OBJECT_GET_CLASS (qtmux));
@@ -4547,6 +4654,9 @@ gst_qt_mux_set_property (GObject * object,
     case PROP_RESERVED_BYTES_PER_SEC:
       qtmux->reserved_bytes_per_sec_per_trak = g_value_get_uint (value);
       break;
+    case PROP_WAIT_FOR_SPARSE_STREAMS:
+      qtmux->wait_for_sparse_streams = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4563,10 +4673,15 @@ gst_qt_mux_change_state (GstElement * element, GstStateChange transition)
   switch (transition) {
     case GST_STATE_CHANGE_NULL_TO_READY:
       break;
-    case GST_STATE_CHANGE_READY_TO_PAUSED:
+    case GST_STATE_CHANGE_READY_TO_PAUSED:{
+      GSList *walk;
+
+      for (walk = qtmux->sinkpads; walk; walk = g_slist_next (walk))
+        gst_qt_mux_update_sparse_waiting (qtmux, (GstQTPad *) walk->data);
       gst_collect_pads_start (qtmux->collect);
       qtmux->state = GST_QT_MUX_STATE_STARTED;
       break;
+    }
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
@@ -131,6 +131,10 @@ struct _GstQTPad
   ATOM_ARRAY (GstBuffer *) fragment_buffers;
   /* running fragment duration */
   gint64 fragment_duration;
+  /* TRUE if the current traf continues a fragment as a chunk */
+  gboolean fragment_chunk;
+  /* decode time of the next sample, for tfdt in chunked mode */
+  guint64 decode_time;
   /* optional fragment index book-keeping */
   AtomTFRA *tfra;
 
@@ -230,6 +234,8 @@ struct _GstQTMux
   gchar *fast_start_file_path;
   gchar *moov_recov_file_path;
   guint32 fragment_duration;
+  /* number of samples per moof/mdat chunk of a fragment, 0 = disabled */
+  guint32 chunk_frames;
   /* Whether or not to work in 'streamable' mode and not
    * seek to rewrite headers - only valid for fragmented
    * mode. */
@@ -242,6 +248,9 @@ struct _GstQTMux
   /* Multiplier for conversion from reserved_max_duration to bytes */
   guint reserved_bytes_per_sec_per_trak;
 
+  /* Whether sparse (subtitle) streams hold back the other streams */
+  gboolean wait_for_sparse_streams;
+
   /* Reserved minimum MOOV size in bytes
    * This is converted from reserved_max_duration
    * using the bytes/trak/sec estimate */
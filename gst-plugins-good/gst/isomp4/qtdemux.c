@@ -87,6 +87,11 @@
 /* if the sample index is larger than this, something is likely wrong */
 #define QTDEMUX_MAX_SAMPLE_INDEX_SIZE (50*1024*1024)
 
+/* samples a stream keeps before its current position when playing a
+ * fragmented file with a random access index, see
+ * qtdemux_drop_played_samples() */
+#define QTDEMUX_MAX_PLAYED_SAMPLES 4096
+
 /* For converting qt creation times to unix epoch times */
 #define QTDEMUX_SECONDS_PER_DAY (60 * 60 * 24)
 #define QTDEMUX_LEAP_YEARS_FROM_1904_TO_1970 17
@@ -5323,13 +5328,20 @@ gst_qtdemux_stream_seek_fragment (GstQTDemux * qtdemux, QtDemuxStream * stream,
 {
   QtDemuxRandomAccessEntry *entries = stream->ra_entries;
   guint n_entries = stream->n_ra_entries;
-  guint i;
+  guint i, lo, hi;
 
-  /* we assume the table is sorted */
-  for (i = 0; i < n_entries; ++i) {
-    if (entries[i].ts > pos)
-      break;
+  /* we assume the table is sorted, find the first entry after pos */
+  lo = 0;
+  hi = n_entries;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (entries[mid].ts > pos)
+      hi = mid;
+    else
+      lo = mid + 1;
   }
+  i = lo;
 
   /* FIXME: maybe save first moof_offset somewhere instead, but for now it's
    * probably okay to assume that the index lists the very first fragment */
@@ -7654,6 +7666,51 @@ locate_failed:
   }
 }
 
+/* Forget the samples of fragments that were played so that the sample tables
+ * of long fragmented recordings don't keep growing. Only done when playing
+ * forward and when there is a random access index (mfra), a seek rebuilds the
+ * tables from the index anyway.
+ * call with OBJECT lock */
+static void
+qtdemux_drop_played_samples (GstQTDemux * qtdemux)
+{
+  gint i;
+
+  if (qtdemux->segment.rate < 0)
+    return;
+
+  for (i = 0; i < qtdemux->n_streams; i++) {
+    QtDemuxStream *stream = qtdemux->streams[i];
+    guint32 n_drop;
+
+    if (stream->ra_entries == NULL || stream->n_samples == 0)
+      continue;
+
+    if (stream->sample_index == -1 ||
+        stream->sample_index < QTDEMUX_MAX_PLAYED_SAMPLES)
+      continue;
+
+    /* keep the last sample, the next fragment may continue its timestamps */
+    n_drop = MIN (stream->sample_index, stream->n_samples - 1);
+    if (n_drop == 0)
+      continue;
+
+    memmove (stream->samples, stream->samples + n_drop,
+        (stream->n_samples - n_drop) * sizeof (QtDemuxSample));
+    stream->n_samples -= n_drop;
+    stream->sample_index -= n_drop;
+    stream->stbl_index = MAX (stream->stbl_index - n_drop, -1);
+    stream->from_sample =
+        stream->from_sample > n_drop ? stream->from_sample - n_drop : 0;
+    if (stream->to_sample != G_MAXUINT32)
+      stream->to_sample =
+          stream->to_sample > n_drop ? stream->to_sample - n_drop : 0;
+
+    GST_DEBUG_OBJECT (stream->pad, "dropped %u played samples, %u left",
+        n_drop, stream->n_samples);
+  }
+}
+
 /* should only do something in pull mode */
 /* call with OBJECT lock */
 static GstFlowReturn
@@ -7673,6 +7730,8 @@ qtdemux_add_fragmented_samples (GstQTDemux * qtdemux)
     return GST_FLOW_EOS;
   }
 
+  qtdemux_drop_played_samples (qtdemux);
+
   /* best not do pull etc with lock held */
   GST_OBJECT_UNLOCK (qtdemux);
 
@@ -346,12 +346,13 @@ gst_level_get_property (GObject * object, guint prop_id,
 }
 
 
-/* process one (interleaved) channel of incoming samples
+/* process all (interleaved) channels of incoming samples in one pass
  * calculate square sum of samples
  * normalize and average over number of samples
- * returns a normalized cumulative square value, which can be averaged
- * to return the average power as a double between 0 and 1
+ * adds a normalized cumulative square value per channel to NCS, which can be
+ * averaged to return the average power as a double between 0 and 1
  * also returns the normalized peak power (square of the highest amplitude)
+ * per channel in NPS
  *
  * caller must assure num is a multiple of channels
  * samples for multiple channels are interleaved
@@ -360,76 +361,80 @@ gst_level_get_property (GObject * object, guint prop_id,
  *
  * for integers, this code considers the non-existant positive max value to be
  * full-scale; so max-1 will not map to 1.0
+ *
+ * Channels are handled in groups of LEVEL_CHANNEL_GROUP with one accumulator
+ * per channel, so that the inner loop over the channels of a frame has no
+ * dependencies and can be vectorized by the compiler. For 8 and 16 bit
+ * samples the squares are summed up exactly in 64 bit integers, which also
+ * allows vectorizing the reduction of a single channel.
+ *
+ * ORC is not used here as it only has 16/32 bit integer accumulators and no
+ * float or max accumulators, which overflow or can't express the peak.
  */
 
-#define DEFINE_INT_LEVEL_CALCULATOR(TYPE, RESOLUTION)                         \
+#define LEVEL_CHANNEL_GROUP 64
+
+#define DEFINE_LEVEL_CALCULATOR(TYPE, SQUARE_TYPE, ACC_TYPE, NORMALIZER)      \
 static void inline                                                            \
 gst_level_calculate_##TYPE (gpointer data, guint num, guint channels,         \
                             gdouble *NCS, gdouble *NPS)                       \
 {                                                                             \
   TYPE * in = (TYPE *)data;                                                   \
-  register guint j;                                                           \
-  gdouble squaresum = 0.0;           /* square sum of the input samples */    \
-  register gdouble square = 0.0;     /* Square */                             \
-  register gdouble peaksquare = 0.0; /* Peak Square Sample */                 \
-  gdouble normalizer;                /* divisor to get a [-1.0, 1.0] range */ \
+  guint c, c0, n, j;                                                          \
+  SQUARE_TYPE square;                                                         \
+  ACC_TYPE squaresum[LEVEL_CHANNEL_GROUP];  /* square sum of the samples */   \
+  SQUARE_TYPE peaksquare[LEVEL_CHANNEL_GROUP];   /* Peak Square Sample */     \
+  const gdouble normalizer = (NORMALIZER); /* to get a [-1.0, 1.0] range */   \
                                                                               \
-  /* *NCS = 0.0; Normalized Cumulative Square */                              \
-  /* *NPS = 0.0; Normalized Peak Square */                                    \
+  if (channels == 1) {                                                        \
+    ACC_TYPE sum = 0;                                                         \
+    SQUARE_TYPE peak = 0;                                                     \
                                                                               \
-  for (j = 0; j < num; j += channels) {                                       \
-    square = ((gdouble) in[j]) * in[j];                                       \
-    if (square > peaksquare) peaksquare = square;                             \
-    squaresum += square;                                                      \
+    for (j = 0; j < num; j++) {                                               \
+      square = (SQUARE_TYPE) in[j] * in[j];                                   \
+      peak = MAX (peak, square);                                              \
+      sum += square;                                                          \
+    }                                                                         \
+    NCS[0] += sum / normalizer;                                               \
+    NPS[0] = peak / normalizer;                                               \
+    return;                                                                   \
   }                                                                           \
                                                                               \
-  normalizer = (gdouble) (G_GINT64_CONSTANT(1) << (RESOLUTION * 2));          \
-  *NCS = squaresum / normalizer;                                              \
-  *NPS = peaksquare / normalizer;                                             \
-}
-
-DEFINE_INT_LEVEL_CALCULATOR (gint32, 31);
-DEFINE_INT_LEVEL_CALCULATOR (gint16, 15);
-DEFINE_INT_LEVEL_CALCULATOR (gint8, 7);
-
-/* FIXME: use orc to calculate squaresums? */
-#define DEFINE_FLOAT_LEVEL_CALCULATOR(TYPE)                                   \
-static void inline                                                            \
-gst_level_calculate_##TYPE (gpointer data, guint num, guint channels,         \
-                            gdouble *NCS, gdouble *NPS)                       \
-{                                                                             \
-  TYPE * in = (TYPE *)data;                                                   \
-  register guint j;                                                           \
-  gdouble squaresum = 0.0;           /* square sum of the input samples */    \
-  register gdouble square = 0.0;     /* Square */                             \
-  register gdouble peaksquare = 0.0; /* Peak Square Sample */                 \
+  for (c0 = 0; c0 < channels; c0 += LEVEL_CHANNEL_GROUP) {                    \
+    n = MIN (channels - c0, LEVEL_CHANNEL_GROUP);                             \
                                                                               \
-  /* *NCS = 0.0; Normalized Cumulative Square */                              \
-  /* *NPS = 0.0; Normalized Peak Square */                                    \
+    for (c = 0; c < n; c++) {                                                 \
+      squaresum[c] = 0;                                                       \
+      peaksquare[c] = 0;                                                      \
+    }                                                                         \
                                                                               \
-  /* orc_level_squaresum_f64(&squaresum,in,num); */                           \
-  for (j = 0; j < num; j += channels) {                                       \
-    square = ((gdouble) in[j]) * in[j];                                       \
-    if (square > peaksquare) peaksquare = square;                             \
-    squaresum += square;                                                      \
-  }                                                                           \
+    for (j = c0; j < num; j += channels) {                                    \
+      const TYPE *frame = in + j;                                             \
                                                                               \
-  *NCS = squaresum;                                                           \
-  *NPS = peaksquare;                                                          \
+      for (c = 0; c < n; c++) {                                               \
+        square = (SQUARE_TYPE) frame[c] * frame[c];                           \
+        peaksquare[c] = MAX (peaksquare[c], square);                          \
+        squaresum[c] += square;                                               \
+      }                                                                       \
+    }                                                                         \
+                                                                              \
+    for (c = 0; c < n; c++) {                                                 \
+      NCS[c0 + c] += squaresum[c] / normalizer;                               \
+      NPS[c0 + c] = peaksquare[c] / normalizer;                               \
+    }                                                                         \
+  }                                                                           \
 }
 
-DEFINE_FLOAT_LEVEL_CALCULATOR (gfloat);
-DEFINE_FLOAT_LEVEL_CALCULATOR (gdouble);
+DEFINE_LEVEL_CALCULATOR (gint32, gdouble, gdouble,
+    (gdouble) (G_GINT64_CONSTANT (1) << 62));
+/* the squares of 8 and 16 bit samples fit into 32 bit, so sum them exactly */
+DEFINE_LEVEL_CALCULATOR (gint16, gint32, guint64,
+    (gdouble) (G_GINT64_CONSTANT (1) << 30));
+DEFINE_LEVEL_CALCULATOR (gint8, gint32, guint64,
+    (gdouble) (G_GINT64_CONSTANT (1) << 14));
 
-/* we would need stride to deinterleave also
-static void inline
-gst_level_calculate_gdouble (gpointer data, guint num, guint channels,
-                            gdouble *NCS, gdouble *NPS)
-{
-  orc_level_squaresum_f64(NCS,(gdouble *)data,num);
-  *NPS = 0.0;
-}
-*/
+DEFINE_LEVEL_CALCULATOR (gfloat, gdouble, gdouble, 1.0);
+DEFINE_LEVEL_CALCULATOR (gdouble, gdouble, gdouble, 1.0);
 
 static void
 gst_level_recalc_interval_frames (GstLevel * level)
@@ -603,7 +608,6 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
   GstMapInfo map;
   guint8 *in_data;
   gsize in_size;
-  gdouble CS;
   guint i;
   guint num_frames;
   guint num_int_samples = 0;    /* number of interleaved samples
@@ -644,17 +648,20 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
     block_size = MIN (block_size, num_frames);
     block_int_size = block_size * channels;
 
-    for (i = 0; i < channels; ++i) {
-      if (!GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_GAP)) {
-        filter->process (in_data + (bps * i), block_int_size, channels, &CS,
-            &filter->peak[i]);
-        GST_LOG_OBJECT (filter,
-            "[%d]: cumulative squares %lf, over %d samples/%d channels",
-            i, CS, block_int_size, channels);
-        filter->CS[i] += CS;
-      } else {
+    if (!GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_GAP)) {
+      filter->process (in_data, block_int_size, channels, filter->CS,
+          filter->peak);
+      GST_LOG_OBJECT (filter,
+          "cumulative squares over %d samples/%d channels", block_int_size,
+          channels);
+    } else {
+      for (i = 0; i < channels; ++i)
         filter->peak[i] = 0.0;
-      }
+    }
+
+    for (i = 0; i < channels; ++i) {
+      GST_LOG_OBJECT (filter, "[%d]: cumulative squares %lf", i,
+          filter->CS[i]);
 
       filter->decay_peak_age[i] += GST_FRAMES_TO_CLOCK_TIME (num_frames, rate);
       GST_LOG_OBJECT (filter,
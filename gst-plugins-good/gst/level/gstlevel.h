@@ -76,6 +76,7 @@ struct _GstLevel {
   gdouble *decay_peak_base;     /* value of last peak we are decaying from */
   GstClockTime *decay_peak_age; /* age of last peak */
 
+  /* accumulates into CS and sets peak for all channels of a block */
   void (*process)(gpointer, guint, guint, gdouble*, gdouble*);
 };
 
@@ -57,6 +57,7 @@ gst_ebml_write_init (GstEbmlWrite * ebml)
   ebml->last_pos = G_MAXUINT64; /* force segment event */
 
   ebml->cache = NULL;
+  ebml->buffer_list = NULL;
   ebml->streamheader = NULL;
   ebml->streamheader_pos = 0;
   ebml->writing_streamheader = FALSE;
@@ -75,6 +76,11 @@ gst_ebml_write_finalize (GObject * object)
     ebml->cache = NULL;
   }
 
+  if (ebml->buffer_list) {
+    gst_buffer_list_unref (ebml->buffer_list);
+    ebml->buffer_list = NULL;
+  }
+
   if (ebml->streamheader) {
     gst_byte_writer_free (ebml->streamheader);
     ebml->streamheader = NULL;
@@ -129,11 +135,17 @@ gst_ebml_write_reset (GstEbmlWrite * ebml)
     ebml->cache = NULL;
   }
 
+  if (ebml->buffer_list) {
+    gst_buffer_list_unref (ebml->buffer_list);
+    ebml->buffer_list = NULL;
+  }
+
   if (ebml->caps) {
     gst_caps_unref (ebml->caps);
     ebml->caps = NULL;
   }
 
+  ebml->use_buffer_list = FALSE;
   ebml->last_write_result = GST_FLOW_OK;
   ebml->timestamp = GST_CLOCK_TIME_NONE;
 }
@@ -207,6 +219,41 @@ gst_ebml_write_set_cache (GstEbmlWrite * ebml, guint size)
   ebml->cache_pos = ebml->pos;
 }
 
+/* pushes @buf, or queues it if a buffer list is being collected */
+static void
+gst_ebml_write_push (GstEbmlWrite * ebml, GstBuffer * buf)
+{
+  if (ebml->use_buffer_list) {
+    if (!ebml->buffer_list)
+      ebml->buffer_list = gst_buffer_list_new ();
+    gst_buffer_list_add (ebml->buffer_list, buf);
+  } else {
+    ebml->last_write_result = gst_pad_push (ebml->srcpad, buf);
+  }
+}
+
+/**
+ * gst_ebml_write_flush_buffer_list:
+ * @ebml: a #GstEbmlWrite.
+ *
+ * Push the buffers collected so far as one buffer list.
+ */
+void
+gst_ebml_write_flush_buffer_list (GstEbmlWrite * ebml)
+{
+  GstBufferList *list = ebml->buffer_list;
+
+  if (!list)
+    return;
+
+  ebml->buffer_list = NULL;
+  GST_LOG ("Pushing buffer list of %u buffers", gst_buffer_list_length (list));
+  if (ebml->last_write_result == GST_FLOW_OK)
+    ebml->last_write_result = gst_pad_push_list (ebml->srcpad, list);
+  else
+    gst_buffer_list_unref (list);
+}
+
 static gboolean
 gst_ebml_writer_send_segment_event (GstEbmlWrite * ebml, guint64 new_pos)
 {
@@ -215,6 +262,9 @@ gst_ebml_writer_send_segment_event (GstEbmlWrite * ebml, guint64 new_pos)
 
   GST_INFO ("seeking to %" G_GUINT64_FORMAT, new_pos);
 
+  /* queued data precedes the new position */
+  gst_ebml_write_flush_buffer_list (ebml);
+
   gst_segment_init (&segment,
       ebml->streamable ? GST_FORMAT_TIME : GST_FORMAT_BYTES);
   segment.start = new_pos;
@@ -268,7 +318,7 @@ gst_ebml_write_flush_cache (GstEbmlWrite * ebml, gboolean is_keyframe,
       GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
     }
     ebml->last_pos = ebml->pos;
-    ebml->last_write_result = gst_pad_push (ebml->srcpad, buffer);
+    gst_ebml_write_push (ebml, buffer);
   } else {
     gst_buffer_unref (buffer);
   }
@@ -474,7 +524,7 @@ gst_ebml_write_element_push (GstEbmlWrite * ebml, GstBuffer * buf,
       GST_BUFFER_FLAG_UNSET (buf, GST_BUFFER_FLAG_DISCONT);
     }
     ebml->last_pos = ebml->pos;
-    ebml->last_write_result = gst_pad_push (ebml->srcpad, buf);
+    gst_ebml_write_push (ebml, buf);
   } else {
     gst_buffer_unref (buf);
   }
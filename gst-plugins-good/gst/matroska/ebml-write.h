@@ -55,6 +55,10 @@ typedef struct _GstEbmlWrite {
 
   GstFlowReturn last_write_result;
 
+  /* if set, output is collected in buffer_list until it is flushed */
+  gboolean use_buffer_list;
+  GstBufferList *buffer_list;
+
   gboolean writing_streamheader;
   GstByteWriter *streamheader;
   guint64 streamheader_pos;
@@ -89,6 +93,12 @@ void    gst_ebml_write_flush_cache   (GstEbmlWrite *ebml,
                                       gboolean is_keyframe,
                                       GstClockTime timestamp);
 
+/*
+ * Collecting many buffers, e.g. one cluster, into a single buffer list,
+ * it is pushed with the next flush or seek.
+ */
+void    gst_ebml_write_flush_buffer_list (GstEbmlWrite *ebml);
+
 /*
  * Seeking.
  */
@@ -122,6 +122,8 @@ static GstStaticPadTemplate subtitle_src_templ =
 
 static GstFlowReturn gst_matroska_demux_parse_id (GstMatroskaDemux * demux,
     guint32 id, guint64 length, guint needed);
+static GstFlowReturn gst_matroska_demux_page_in_cues (GstMatroskaDemux *
+    demux, GstClockTime time);
 
 /* element functions */
 static void gst_matroska_demux_loop (GstPad * pad);
@@ -294,6 +296,11 @@ gst_matroska_demux_reset (GstElement * element)
     demux->clusters = NULL;
   }
 
+  if (demux->cluster_index) {
+    g_array_free (demux->cluster_index, TRUE);
+    demux->cluster_index = NULL;
+  }
+
   g_list_foreach (demux->seek_parsed,
       (GFunc) gst_matroska_read_common_free_parsed_el, NULL);
   g_list_free (demux->seek_parsed);
@@ -307,6 +314,10 @@ gst_matroska_demux_reset (GstElement * element)
   demux->cluster_offset = 0;
   demux->next_cluster_offset = 0;
   demux->index_offset = 0;
+  demux->cues_offset = 0;
+  demux->cues_end = 0;
+  demux->cues_time = GST_CLOCK_TIME_NONE;
+  demux->cues_unsorted = FALSE;
   demux->seekable = FALSE;
   demux->need_segment = FALSE;
   demux->segment_seqnum = 0;
@@ -1650,6 +1661,47 @@ gst_matroska_cluster_compare (gint64 * i1, gint64 * i2)
     return 0;
 }
 
+/* minimum time between two entries of the sparse cluster index */
+#define CLUSTER_INDEX_INTERVAL (GST_SECOND)
+
+/* remembers the cluster at @offset starting at @time, for files without Cues,
+ * so later seeks need not bisect and scan the file again */
+static void
+gst_matroska_demux_add_cluster_index_entry (GstMatroskaDemux * demux,
+    GstClockTime time, guint64 offset)
+{
+  GstMatroskaIndex entry = { 0, };
+  GstMatroskaIndex *prev;
+  guint i = 0;
+
+  if (demux->streaming || demux->common.index || demux->cues_offset)
+    return;
+
+  if (G_UNLIKELY (!demux->cluster_index))
+    demux->cluster_index =
+        g_array_sized_new (FALSE, FALSE, sizeof (GstMatroskaIndex), 128);
+
+  prev = gst_util_array_binary_search (demux->cluster_index->data,
+      demux->cluster_index->len, sizeof (GstMatroskaIndex),
+      (GCompareDataFunc) gst_matroska_index_seek_find, GST_SEARCH_MODE_BEFORE,
+      &time, NULL);
+  if (prev) {
+    if (time - prev->time < CLUSTER_INDEX_INTERVAL)
+      return;
+    i = prev - (GstMatroskaIndex *) demux->cluster_index->data + 1;
+  }
+  if (i < demux->cluster_index->len &&
+      g_array_index (demux->cluster_index, GstMatroskaIndex, i).time - time <
+      CLUSTER_INDEX_INTERVAL)
+    return;
+
+  entry.time = time;
+  entry.pos = offset - demux->common.ebml_segment_start;
+  GST_LOG_OBJECT (demux, "cluster index entry %" GST_TIME_FORMAT " -> %"
+      G_GUINT64_FORMAT, GST_TIME_ARGS (time), offset);
+  g_array_insert_val (demux->cluster_index, i, entry);
+}
+
 /* searches for a cluster start from @pos,
  * return GST_FLOW_OK and cluster position in @pos if found */
 static GstFlowReturn
@@ -1796,7 +1848,7 @@ exit:
 static GstMatroskaIndex *
 gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
 {
-  GstMatroskaIndex *entry = NULL;
+  GstMatroskaIndex *entry = NULL, *known = NULL;
   GstMatroskaReadState current_state;
   GstClockTime otime, prev_cluster_time, current_cluster_time, cluster_time;
   gint64 opos, newpos, startpos = 0, current_offset;
@@ -1836,6 +1888,29 @@ gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
   if (otime <= demux->stream_start_time)
     otime = time;
 
+  /* clusters seen before either enclose the target, so the scan can start
+   * right at the one before it, or at least give a better estimate */
+  if (demux->cluster_index) {
+    GArray *index = demux->cluster_index;
+
+    known = gst_util_array_binary_search (index->data, index->len,
+        sizeof (GstMatroskaIndex),
+        (GCompareDataFunc) gst_matroska_index_seek_find,
+        GST_SEARCH_MODE_BEFORE, &time, NULL);
+    if (known && known != &g_array_index (index, GstMatroskaIndex,
+            index->len - 1)) {
+      newpos = startpos = known->pos + demux->common.ebml_segment_start;
+      GST_DEBUG_OBJECT (demux, "starting scan at indexed cluster %"
+          G_GINT64_FORMAT " (%" GST_TIME_FORMAT ")", newpos,
+          GST_TIME_ARGS (known->time));
+      goto scan;
+    }
+    if (known && known->time > otime) {
+      opos = known->pos + demux->common.ebml_segment_start;
+      otime = known->time;
+    }
+  }
+
 retry:
   GST_LOG_OBJECT (demux,
       "opos: %" G_GUINT64_FORMAT ", otime: %" GST_TIME_FORMAT ", %"
@@ -1889,6 +1964,7 @@ retry:
 
   /* then start scanning and parsing for cluster time,
    * re-estimate if overshoot, otherwise next cluster and so on */
+scan:
   demux->common.offset = newpos;
   demux->cluster_time = cluster_time = GST_CLOCK_TIME_NONE;
   while (1) {
@@ -2025,7 +2101,8 @@ gst_matroska_demux_handle_seek_event (GstMatroskaDemux * demux,
    * we might be playing a file that's still being recorded
    * so, invalidate our current duration, which is only a moving target,
    * and should not be used to clamp anything */
-  if (!demux->streaming && !demux->common.index && demux->invalid_duration) {
+  if (!demux->streaming && !demux->common.index && !demux->cues_offset &&
+      demux->invalid_duration) {
     seeksegment.duration = GST_CLOCK_TIME_NONE;
   }
 
@@ -2086,7 +2163,7 @@ gst_matroska_demux_handle_seek_event (GstMatroskaDemux * demux,
       GST_DEBUG_OBJECT (demux, "No matching seek entry in index");
       GST_OBJECT_UNLOCK (demux);
       return FALSE;
-    } else if (rate < 0.0) {
+    } else if (rate < 0.0 && !demux->cues_offset) {
       /* FIXME: We should build an index during playback or when scanning
        * that can be used here. The reverse playback code requires seek_index
        * and seek_entry to be set!
@@ -2136,6 +2213,31 @@ next:
   GST_PAD_STREAM_LOCK (demux->common.sinkpad);
   pad_locked = TRUE;
 
+  /* the Cues may not have been paged in up to the target yet */
+  if (!demux->streaming && demux->cues_offset) {
+    if (flush) {
+      GstEvent *flush_event = gst_event_new_flush_stop (TRUE);
+      gst_event_set_seqnum (flush_event, seqnum);
+      gst_pad_push_event (demux->common.sinkpad, flush_event);
+    }
+    gst_matroska_demux_page_in_cues (demux, seeksegment.position);
+    GST_OBJECT_LOCK (demux);
+    entry = gst_matroska_read_common_do_index_seek (&demux->common, track,
+        seeksegment.position, &demux->seek_index, &demux->seek_entry,
+        snap_dir);
+    GST_OBJECT_UNLOCK (demux);
+    if (!entry && rate < 0.0) {
+      GST_DEBUG_OBJECT (demux,
+          "No matching seek entry in index, needed for reverse playback");
+      if (flush) {
+        GstEvent *flush_event = gst_event_new_flush_stop (TRUE);
+        gst_event_set_seqnum (flush_event, seqnum);
+        gst_matroska_demux_send_event (demux, flush_event);
+      }
+      goto seek_error;
+    }
+  }
+
   /* pull mode without index can do some scanning */
   if (!demux->streaming && !entry) {
     GstEvent *flush_event;
@@ -4224,6 +4326,102 @@ exit:
   return ret;
 }
 
+/* minimum amount of Cues to parse at a time */
+#define CUES_PAGE_SIZE (64 * 1024)
+
+/* parses further CuePoints of the deferred Cues, up to and including the
+ * page with the first one past @time, or all of them if @time is NONE.
+ * CuePoints are normally stored in time order; if they are not, the rest
+ * is parsed in one go and the index sorted afterwards.
+ * Called with the stream lock held. */
+static GstFlowReturn
+gst_matroska_demux_page_in_cues (GstMatroskaDemux * demux, GstClockTime time)
+{
+  GstEbmlRead ebml = { 0, };
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint64 orig_offset, page_start, length;
+  guint32 id;
+  guint needed;
+
+  if (!demux->cues_offset)
+    return GST_FLOW_OK;
+
+  orig_offset = demux->common.offset;
+  demux->common.offset = page_start = demux->cues_offset;
+
+  while (demux->common.offset < demux->cues_end) {
+    if (!demux->cues_unsorted && GST_CLOCK_TIME_IS_VALID (time) &&
+        GST_CLOCK_TIME_IS_VALID (demux->cues_time) &&
+        demux->cues_time > time &&
+        demux->common.offset - page_start >= CUES_PAGE_SIZE)
+      break;
+
+    ret = gst_matroska_read_common_peek_id_length_pull (&demux->common,
+        GST_ELEMENT_CAST (demux), &id, &length, &needed);
+    if (ret != GST_FLOW_OK)
+      break;
+
+    if (id == GST_MATROSKA_ID_POINTENTRY) {
+      guint i, first;
+
+      ret = gst_matroska_demux_take (demux, length + needed, &ebml);
+      if (ret == GST_FLOW_OVERFLOW) {
+        ret = GST_FLOW_OK;
+        continue;
+      } else if (ret != GST_FLOW_OK) {
+        break;
+      }
+
+      GST_OBJECT_LOCK (demux);
+      first = demux->common.index ? demux->common.index->len : 0;
+      ret = gst_matroska_read_common_parse_index_cuepoint (&demux->common,
+          &ebml);
+      for (i = first; i < demux->common.index->len; i++) {
+        GstMatroskaIndex *idx =
+            &g_array_index (demux->common.index, GstMatroskaIndex, i);
+
+        if (GST_CLOCK_TIME_IS_VALID (demux->cues_time) &&
+            idx->time < demux->cues_time) {
+          if (!demux->cues_unsorted)
+            GST_DEBUG_OBJECT (demux, "Cues not in time order");
+          demux->cues_unsorted = TRUE;
+        } else {
+          demux->cues_time = idx->time;
+        }
+      }
+      GST_OBJECT_UNLOCK (demux);
+      gst_ebml_read_clear (&ebml);
+      if (ret != GST_FLOW_OK)
+        break;
+    } else {
+      demux->common.offset += length + needed;
+    }
+  }
+
+  demux->cues_offset = demux->common.offset;
+  if (ret != GST_FLOW_OK || demux->cues_offset >= demux->cues_end) {
+    GST_DEBUG_OBJECT (demux, "done parsing Cues: %s", gst_flow_get_name (ret));
+    GST_OBJECT_LOCK (demux);
+    if (demux->cues_unsorted)
+      gst_matroska_read_common_sort_index (&demux->common);
+    /* sanity check; empty index normalizes to no index */
+    if (demux->common.index && demux->common.index->len == 0) {
+      g_array_free (demux->common.index, TRUE);
+      demux->common.index = NULL;
+    }
+    GST_OBJECT_UNLOCK (demux);
+    demux->common.index_parsed = TRUE;
+    demux->cues_offset = 0;
+  } else {
+    GST_DEBUG_OBJECT (demux, "paged in Cues up to %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (demux->cues_time));
+  }
+
+  demux->common.offset = orig_offset;
+
+  return ret;
+}
+
 static void
 gst_matroska_demux_check_seekability (GstMatroskaDemux * demux)
 {
@@ -4449,6 +4647,8 @@ gst_matroska_demux_parse_id (GstMatroskaDemux * demux, guint32 id,
             goto parse_failed;
           GST_DEBUG_OBJECT (demux, "ClusterTimeCode: %" G_GUINT64_FORMAT, num);
           demux->cluster_time = num;
+          gst_matroska_demux_add_cluster_index_entry (demux,
+              num * demux->common.time_scale, demux->cluster_offset);
 #if 0
           if (demux->common.element_index) {
             if (demux->common.element_index_writer_id == -1)
@@ -4523,7 +4723,17 @@ gst_matroska_demux_parse_id (GstMatroskaDemux * demux, guint32 id,
           ret = gst_matroska_demux_parse_contents (demux, &ebml);
           break;
         case GST_MATROSKA_ID_CUES:
-          if (demux->common.index_parsed) {
+          if (demux->common.index_parsed || demux->cues_offset) {
+            GST_READ_CHECK (gst_matroska_demux_flush (demux, read));
+            break;
+          }
+          /* in pull mode, the (possibly huge) index is only paged in as
+           * far as seeking needs it */
+          if (!demux->streaming && length != G_MAXUINT64) {
+            GST_DEBUG_OBJECT (demux, "Cues located at offset %"
+                G_GUINT64_FORMAT ", deferring parsing", demux->common.offset);
+            demux->cues_offset = demux->common.offset + needed;
+            demux->cues_end = demux->common.offset + read;
             GST_READ_CHECK (gst_matroska_demux_flush (demux, read));
             break;
           }
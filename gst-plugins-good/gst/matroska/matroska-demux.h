@@ -93,6 +93,13 @@ typedef struct _GstMatroskaDemux {
   gboolean                 seekable;
   gboolean                 building_index;
   guint64                  index_offset;
+  /* pull mode: Cues not parsed yet, paged in from cues_offset on */
+  guint64                  cues_offset;
+  guint64                  cues_end;
+  GstClockTime             cues_time;
+  gboolean                 cues_unsorted;
+  /* sparse index of clusters seen so far, for files without Cues */
+  GArray                  *cluster_index;
   GstEvent                *seek_event;
   gboolean                 need_segment;
   guint32                  segment_seqnum;
@@ -54,6 +54,7 @@
 #include <gst/riff/riff-media.h>
 #include <gst/tag/tag.h>
 #include <gst/pbutils/codec-utils.h>
+#include <glib/gstdio.h>
 
 #include "matroska-mux.h"
 #include "matroska-ids.h"
@@ -70,7 +71,9 @@ enum
   PROP_DOCTYPE_VERSION,
   PROP_MIN_INDEX_INTERVAL,
   PROP_STREAMABLE,
-  PROP_TIMECODESCALE
+  PROP_TIMECODESCALE,
+  PROP_INDEX_TEMP_FILE,
+  PROP_WAIT_FOR_SPARSE_STREAMS
 };
 
 #define  DEFAULT_DOCTYPE_VERSION         2
@@ -78,6 +81,11 @@ enum
 #define  DEFAULT_MIN_INDEX_INTERVAL      0
 #define  DEFAULT_STREAMABLE              FALSE
 #define  DEFAULT_TIMECODESCALE           GST_MSECOND
+#define  DEFAULT_INDEX_TEMP_FILE         NULL
+#define  DEFAULT_WAIT_FOR_SPARSE_STREAMS TRUE
+
+/* number of index entries kept in memory when using a temporary file */
+#define INDEX_SPILL_ENTRIES 1024
 
 /* WAVEFORMATEX is gst_riff_strf_auds + an extra guint16 extension size */
 #define WAVEFORMATEX_SIZE  (2 + sizeof (gst_riff_strf_auds))
@@ -342,6 +350,37 @@ gst_matroska_mux_class_init (GstMatroskaMuxClass * klass)
           "TimecodeScale used to calculate the Raw Timecode of a Block", 1,
           GST_SECOND, DEFAULT_TIMECODESCALE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstMatroskaMux:index-temp-file:
+   *
+   * File the index entries are moved to while recording, so they don't
+   * accumulate in memory. The Cues are written from it at the end and
+   * the file is removed afterwards.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_INDEX_TEMP_FILE,
+      g_param_spec_string ("index-temp-file", "Index temporary file",
+          "File to keep the index in while recording instead of memory "
+          "(NULL = keep in memory)", DEFAULT_INDEX_TEMP_FILE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstMatroskaMux:wait-for-sparse-streams:
+   *
+   * Whether subtitle streams hold back the other streams until they have
+   * data or send a GAP event. Live sources rarely send GAP events for
+   * subtitles, so set this to %FALSE to mux them whenever they have data.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_WAIT_FOR_SPARSE_STREAMS,
+      g_param_spec_boolean ("wait-for-sparse-streams",
+          "Wait for sparse streams",
+          "Wait for data on sparse (subtitle) streams before muxing the "
+          "other streams", DEFAULT_WAIT_FOR_SPARSE_STREAMS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_matroska_mux_change_state);
@@ -470,6 +509,8 @@ gst_matroska_mux_init (GstMatroskaMux * mux, gpointer g_class)
   mux->min_index_interval = DEFAULT_MIN_INDEX_INTERVAL;
   mux->ebml_write->streamable = DEFAULT_STREAMABLE;
   mux->time_scale = DEFAULT_TIMECODESCALE;
+  mux->index_temp_file_path = g_strdup (DEFAULT_INDEX_TEMP_FILE);
+  mux->wait_for_sparse_streams = DEFAULT_WAIT_FOR_SPARSE_STREAMS;
 
   /* initialize internal variables */
   mux->index = NULL;
@@ -502,6 +543,7 @@ gst_matroska_mux_finalize (GObject * object)
   gst_object_unref (mux->collect);
   gst_object_unref (mux->ebml_write);
   g_free (mux->writing_app);
+  g_free (mux->index_temp_file_path);
 
   g_array_free (mux->used_uids, TRUE);
 
@@ -610,6 +652,7 @@ gst_matroska_pad_reset (GstMatroskaPad * collect_pad, gboolean full)
     collect_pad->track = context;
     collect_pad->start_ts = GST_CLOCK_TIME_NONE;
     collect_pad->end_ts = GST_CLOCK_TIME_NONE;
+    collect_pad->last_index_ts = GST_CLOCK_TIME_NONE;
     collect_pad->tags = gst_tag_list_new_empty ();
     gst_tag_list_set_scope (collect_pad->tags, GST_TAG_SCOPE_STREAM);
   }
@@ -661,6 +704,12 @@ gst_matroska_mux_reset (GstElement * element)
   mux->num_indexes = 0;
   g_free (mux->index);
   mux->index = NULL;
+  if (mux->index_temp_file) {
+    fclose (mux->index_temp_file);
+    mux->index_temp_file = NULL;
+    g_remove (mux->index_temp_file_path);
+  }
+  mux->num_spilled_indexes = 0;
 
   /* reset timers */
   mux->max_cluster_duration = G_MAXINT16 * mux->time_scale;
@@ -2266,6 +2315,30 @@ exit:
 }
 
 
+/* Subtitle pads are added unlocked so that GAP events can take them out of
+ * the waiting set. Unless we should wait for them, lock them non-waiting
+ * so a live subtitle stream without GAP events can't stall the others. */
+static void
+gst_matroska_mux_update_sparse_waiting (GstMatroskaMux * mux,
+    GstMatroskaPad * pad)
+{
+  GstCollectData *cdata = (GstCollectData *) pad;
+
+  if (pad->track->type != GST_MATROSKA_TRACK_TYPE_SUBTITLE)
+    return;
+
+  GST_DEBUG_OBJECT (mux, "pad %s:%s waits for data: %d",
+      GST_DEBUG_PAD_NAME (cdata->pad), mux->wait_for_sparse_streams);
+
+  GST_COLLECT_PADS_STREAM_LOCK (mux->collect);
+  GST_COLLECT_PADS_STATE_UNSET (cdata, GST_COLLECT_PADS_STATE_LOCKED);
+  if (!mux->wait_for_sparse_streams) {
+    gst_collect_pads_set_waiting (mux->collect, cdata, FALSE);
+    GST_COLLECT_PADS_STATE_SET (cdata, GST_COLLECT_PADS_STATE_LOCKED);
+  }
+  GST_COLLECT_PADS_STREAM_UNLOCK (mux->collect);
+}
+
 /**
  * gst_matroska_mux_request_new_pad:
  * @element: #GstMatroskaMux.
@@ -2356,6 +2429,7 @@ gst_matroska_mux_request_new_pad (GstElement * element,
   gst_matroska_pad_reset (collect_pad, FALSE);
   collect_pad->track->codec_id = id;
   collect_pad->track->dts_only = FALSE;
+  gst_matroska_mux_update_sparse_waiting (mux, collect_pad);
 
   collect_pad->capsfunc = capsfunc;
   gst_pad_set_active (GST_PAD (newpad), TRUE);
@@ -2751,6 +2825,14 @@ gst_matroska_mux_start (GstMatroskaMux * mux)
     gst_query_unref (query);
   }
 
+  if (!mux->ebml_write->streamable && mux->index_temp_file_path) {
+    mux->index_temp_file = g_fopen (mux->index_temp_file_path, "wb+");
+    if (!mux->index_temp_file)
+      GST_ELEMENT_WARNING (mux, RESOURCE, OPEN_READ_WRITE,
+          (("Could not open temporary file \"%s\""),
+              mux->index_temp_file_path), GST_ERROR_SYSTEM);
+  }
+
   /* stream-start (FIXME: create id based on input ids) */
   g_snprintf (s_id, sizeof (s_id), "matroskamux-%08x", g_random_int ());
   gst_pad_push_event (mux->srcpad, gst_event_new_stream_start (s_id));
@@ -3149,6 +3231,57 @@ gst_matroska_mux_write_toc_entry_tags (GstMatroskaMux * mux,
 }
 #endif
 
+/* writes @num entries of the index as CuePoints */
+static void
+gst_matroska_mux_write_cue_points (GstMatroskaMux * mux,
+    GstMatroskaIndex * index, guint num)
+{
+  GstEbmlWrite *ebml = mux->ebml_write;
+  guint64 pointentry_master, trackpos_master;
+  guint n;
+
+  for (n = 0; n < num; n++) {
+    GstMatroskaIndex *idx = &index[n];
+
+    pointentry_master = gst_ebml_write_master_start (ebml,
+        GST_MATROSKA_ID_POINTENTRY);
+    gst_ebml_write_uint (ebml, GST_MATROSKA_ID_CUETIME,
+        idx->time / mux->time_scale);
+    trackpos_master = gst_ebml_write_master_start (ebml,
+        GST_MATROSKA_ID_CUETRACKPOSITIONS);
+    gst_ebml_write_uint (ebml, GST_MATROSKA_ID_CUETRACK, idx->track);
+    gst_ebml_write_uint (ebml, GST_MATROSKA_ID_CUECLUSTERPOSITION,
+        idx->pos - mux->segment_master);
+    gst_ebml_write_master_finish (ebml, trackpos_master);
+    gst_ebml_write_master_finish (ebml, pointentry_master);
+  }
+}
+
+/* moves the index entries from memory to the temporary file */
+static gboolean
+gst_matroska_mux_spill_index (GstMatroskaMux * mux)
+{
+  GST_LOG_OBJECT (mux, "moving %u index entries to temporary file",
+      mux->num_indexes);
+
+  if (fwrite (mux->index, sizeof (GstMatroskaIndex), mux->num_indexes,
+          mux->index_temp_file) != mux->num_indexes)
+    goto write_error;
+
+  mux->num_spilled_indexes += mux->num_indexes;
+  mux->num_indexes = 0;
+
+  return TRUE;
+
+  /* ERRORS */
+write_error:
+  {
+    GST_ELEMENT_ERROR (mux, RESOURCE, WRITE,
+        ("Failed to write to temporary file"), GST_ERROR_SYSTEM);
+    return FALSE;
+  }
+}
+
 /**
  * gst_matroska_mux_finish:
  * @mux: #GstMatroskaMux
@@ -3172,28 +3305,32 @@ gst_matroska_mux_finish (GstMatroskaMux * mux)
 
   /* cues */
   if (mux->index != NULL) {
-    guint n;
-    guint64 master, pointentry_master, trackpos_master;
+    guint64 master;
 
     mux->cues_pos = ebml->pos;
-    gst_ebml_write_set_cache (ebml, 12 + 41 * mux->num_indexes);
+    gst_ebml_write_set_cache (ebml, 12 + 41 * MIN (mux->num_indexes +
+            mux->num_spilled_indexes, INDEX_SPILL_ENTRIES));
     master = gst_ebml_write_master_start (ebml, GST_MATROSKA_ID_CUES);
 
-    for (n = 0; n < mux->num_indexes; n++) {
-      GstMatroskaIndex *idx = &mux->index[n];
-
-      pointentry_master = gst_ebml_write_master_start (ebml,
-          GST_MATROSKA_ID_POINTENTRY);
-      gst_ebml_write_uint (ebml, GST_MATROSKA_ID_CUETIME,
-          idx->time / mux->time_scale);
-      trackpos_master = gst_ebml_write_master_start (ebml,
-          GST_MATROSKA_ID_CUETRACKPOSITIONS);
-      gst_ebml_write_uint (ebml, GST_MATROSKA_ID_CUETRACK, idx->track);
-      gst_ebml_write_uint (ebml, GST_MATROSKA_ID_CUECLUSTERPOSITION,
-          idx->pos - mux->segment_master);
-      gst_ebml_write_master_finish (ebml, trackpos_master);
-      gst_ebml_write_master_finish (ebml, pointentry_master);
+    /* the entries moved to the temporary file come first */
+    if (mux->num_spilled_indexes > 0) {
+      GstMatroskaIndex *entries = g_new (GstMatroskaIndex,
+          INDEX_SPILL_ENTRIES);
+      size_t n;
+
+      rewind (mux->index_temp_file);
+      while ((n = fread (entries, sizeof (GstMatroskaIndex),
+                  INDEX_SPILL_ENTRIES, mux->index_temp_file)) > 0) {
+        gst_matroska_mux_write_cue_points (mux, entries, n);
+        gst_ebml_write_flush_cache (ebml, FALSE, GST_CLOCK_TIME_NONE);
+        gst_ebml_write_set_cache (ebml, 41 * INDEX_SPILL_ENTRIES);
+      }
+      if (ferror (mux->index_temp_file))
+        GST_ELEMENT_WARNING (mux, RESOURCE, READ,
+            ("Failed to read temporary file"), GST_ERROR_SYSTEM);
+      g_free (entries);
     }
+    gst_matroska_mux_write_cue_points (mux, mux->index, mux->num_indexes);
 
     gst_ebml_write_master_finish (ebml, master);
     gst_ebml_write_flush_cache (ebml, FALSE, GST_CLOCK_TIME_NONE);
@@ -3605,6 +3742,7 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
         || is_video_keyframe || mux->force_key_unit_event) {
       if (!mux->ebml_write->streamable)
         gst_ebml_write_master_finish (ebml, mux->cluster);
+      gst_ebml_write_flush_buffer_list (ebml);
 
       /* Forward the GstForceKeyUnit event after finishing the cluster */
       if (mux->force_key_unit_event) {
@@ -3650,17 +3788,9 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
       (is_video_keyframe ||
           ((collect_pad->track->type == GST_MATROSKA_TRACK_TYPE_AUDIO) &&
               (mux->num_streams == 1)))) {
-    gint last_idx = -1;
-
-    if (mux->min_index_interval != 0) {
-      for (last_idx = mux->num_indexes - 1; last_idx >= 0; last_idx--) {
-        if (mux->index[last_idx].track == collect_pad->track->num)
-          break;
-      }
-    }
-
-    if (last_idx < 0 || mux->min_index_interval == 0 ||
-        (GST_CLOCK_DIFF (mux->index[last_idx].time, buffer_timestamp)
+    if (!GST_CLOCK_TIME_IS_VALID (collect_pad->last_index_ts) ||
+        mux->min_index_interval == 0 ||
+        (GST_CLOCK_DIFF (collect_pad->last_index_ts, buffer_timestamp)
             >= mux->min_index_interval)) {
       GstMatroskaIndex *idx;
 
@@ -3673,6 +3803,13 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
       idx->pos = mux->cluster_pos;
       idx->time = buffer_timestamp;
       idx->track = collect_pad->track->num;
+      collect_pad->last_index_ts = buffer_timestamp;
+
+      if (mux->index_temp_file && mux->num_indexes >= INDEX_SPILL_ENTRIES &&
+          !gst_matroska_mux_spill_index (mux)) {
+        gst_buffer_unref (buf);
+        return GST_FLOW_ERROR;
+      }
     }
   }
 
@@ -3799,6 +3936,9 @@ gst_matroska_mux_handle_buffer (GstCollectPads * pads, GstCollectData * data,
     gst_matroska_mux_start (mux);
     gst_matroska_mux_stop_streamheader (mux);
     mux->state = GST_MATROSKA_MUX_STATE_DATA;
+    /* push one buffer list per cluster rather than every element, only
+     * when not streaming so no latency is added */
+    ebml->use_buffer_list = !ebml->streamable;
   }
 
   /* provided with stream to write from */
@@ -3812,6 +3952,7 @@ gst_matroska_mux_handle_buffer (GstCollectPads * pads, GstCollectData * data,
     } else {
       GST_DEBUG_OBJECT (mux, "... but streamable, nothing to finish");
     }
+    gst_ebml_write_flush_buffer_list (ebml);
     gst_pad_push_event (mux->srcpad, gst_event_new_eos ());
     ret = GST_FLOW_EOS;
     goto exit;
@@ -3872,9 +4013,15 @@ gst_matroska_mux_change_state (GstElement * element, GstStateChange transition)
   switch (transition) {
     case GST_STATE_CHANGE_NULL_TO_READY:
       break;
-    case GST_STATE_CHANGE_READY_TO_PAUSED:
+    case GST_STATE_CHANGE_READY_TO_PAUSED:{
+      GSList *walk;
+
+      for (walk = mux->collect->data; walk; walk = g_slist_next (walk))
+        gst_matroska_mux_update_sparse_waiting (mux,
+            (GstMatroskaPad *) walk->data);
       gst_collect_pads_start (mux->collect);
       break;
+    }
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
@@ -3931,6 +4078,13 @@ gst_matroska_mux_set_property (GObject * object,
     case PROP_TIMECODESCALE:
       mux->time_scale = g_value_get_int64 (value);
       break;
+    case PROP_INDEX_TEMP_FILE:
+      g_free (mux->index_temp_file_path);
+      mux->index_temp_file_path = g_value_dup_string (value);
+      break;
+    case PROP_WAIT_FOR_SPARSE_STREAMS:
+      mux->wait_for_sparse_streams = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3962,6 +4116,12 @@ gst_matroska_mux_get_property (GObject * object,
     case PROP_TIMECODESCALE:
       g_value_set_int64 (value, mux->time_scale);
       break;
+    case PROP_INDEX_TEMP_FILE:
+      g_value_set_string (value, mux->index_temp_file_path);
+      break;
+    case PROP_WAIT_FOR_SPARSE_STREAMS:
+      g_value_set_boolean (value, mux->wait_for_sparse_streams);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -23,6 +23,8 @@
 #ifndef __GST_MATROSKA_MUX_H__
 #define __GST_MATROSKA_MUX_H__
 
+#include <stdio.h>
+
 #include <gst/gst.h>
 #include <gst/base/gstcollectpads.h>
 
@@ -70,6 +72,7 @@ typedef struct
 
   GstClockTime start_ts;
   GstClockTime end_ts;    /* last timestamp + (if available) duration */
+  GstClockTime last_index_ts;   /* timestamp of the last index entry */
   guint64 default_duration_scaled;
 }
 GstMatroskaPad;
@@ -104,6 +107,13 @@ struct _GstMatroskaMux {
   GstMatroskaIndex *index;
   guint          num_indexes;
   GstClockTimeDiff min_index_interval;
+  /* index entries moved out of memory, while recording */
+  gchar         *index_temp_file_path;
+  FILE          *index_temp_file;
+  guint          num_spilled_indexes;
+
+  /* whether subtitle streams hold back the other streams */
+  gboolean       wait_for_sparse_streams;
  
   /* timescale in the file */
   guint64        time_scale;
@@ -1551,48 +1551,15 @@ gst_matroska_read_common_stream_from_num (GstMatroskaReadCommon * common,
   return -1;
 }
 
-GstFlowReturn
-gst_matroska_read_common_parse_index (GstMatroskaReadCommon * common,
-    GstEbmlRead * ebml)
+/* copies the index entries from @first on into the index tables of their
+ * tracks */
+static void
+gst_matroska_read_common_add_track_index_entries (GstMatroskaReadCommon *
+    common, guint first)
 {
-  guint32 id;
-  GstFlowReturn ret = GST_FLOW_OK;
   guint i;
 
-  if (common->index)
-    g_array_free (common->index, TRUE);
-  common->index =
-      g_array_sized_new (FALSE, FALSE, sizeof (GstMatroskaIndex), 128);
-
-  DEBUG_ELEMENT_START (common, ebml, "Cues");
-
-  if ((ret = gst_ebml_read_master (ebml, &id)) != GST_FLOW_OK) {
-    DEBUG_ELEMENT_STOP (common, ebml, "Cues", ret);
-    return ret;
-  }
-
-  while (ret == GST_FLOW_OK && gst_ebml_read_has_remaining (ebml, 1, TRUE)) {
-    if ((ret = gst_ebml_peek_id (ebml, &id)) != GST_FLOW_OK)
-      break;
-
-    switch (id) {
-        /* one single index entry ('point') */
-      case GST_MATROSKA_ID_POINTENTRY:
-        ret = gst_matroska_read_common_parse_index_pointentry (common, ebml);
-        break;
-
-      default:
-        ret = gst_matroska_read_common_parse_skip (common, ebml, "Cues", id);
-        break;
-    }
-  }
-  DEBUG_ELEMENT_STOP (common, ebml, "Cues", ret);
-
-  /* Sort index by time, smallest time first, for easier searching */
-  g_array_sort (common->index, (GCompareFunc) gst_matroska_index_compare);
-
-  /* Now sort the track specific index entries into their own arrays */
-  for (i = 0; i < common->index->len; i++) {
+  for (i = first; i < common->index->len; i++) {
     GstMatroskaIndex *idx = &g_array_index (common->index, GstMatroskaIndex,
         i);
     gint track_num;
@@ -1643,6 +1610,49 @@ gst_matroska_read_common_parse_index (GstMatroskaReadCommon * common,
 
     g_array_append_vals (ctx->index_table, idx, 1);
   }
+}
+
+GstFlowReturn
+gst_matroska_read_common_parse_index (GstMatroskaReadCommon * common,
+    GstEbmlRead * ebml)
+{
+  guint32 id;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (common->index)
+    g_array_free (common->index, TRUE);
+  common->index =
+      g_array_sized_new (FALSE, FALSE, sizeof (GstMatroskaIndex), 128);
+
+  DEBUG_ELEMENT_START (common, ebml, "Cues");
+
+  if ((ret = gst_ebml_read_master (ebml, &id)) != GST_FLOW_OK) {
+    DEBUG_ELEMENT_STOP (common, ebml, "Cues", ret);
+    return ret;
+  }
+
+  while (ret == GST_FLOW_OK && gst_ebml_read_has_remaining (ebml, 1, TRUE)) {
+    if ((ret = gst_ebml_peek_id (ebml, &id)) != GST_FLOW_OK)
+      break;
+
+    switch (id) {
+        /* one single index entry ('point') */
+      case GST_MATROSKA_ID_POINTENTRY:
+        ret = gst_matroska_read_common_parse_index_pointentry (common, ebml);
+        break;
+
+      default:
+        ret = gst_matroska_read_common_parse_skip (common, ebml, "Cues", id);
+        break;
+    }
+  }
+  DEBUG_ELEMENT_STOP (common, ebml, "Cues", ret);
+
+  /* Sort index by time, smallest time first, for easier searching */
+  g_array_sort (common->index, (GCompareFunc) gst_matroska_index_compare);
+
+  /* Now sort the track specific index entries into their own arrays */
+  gst_matroska_read_common_add_track_index_entries (common, 0);
 
   common->index_parsed = TRUE;
 
@@ -1655,6 +1665,46 @@ gst_matroska_read_common_parse_index (GstMatroskaReadCommon * common,
   return ret;
 }
 
+/* parses a single CuePoint, for reading the Cues in pages rather than at
+ * once; the entries are appended unsorted to the global and track indexes */
+GstFlowReturn
+gst_matroska_read_common_parse_index_cuepoint (GstMatroskaReadCommon *
+    common, GstEbmlRead * ebml)
+{
+  GstFlowReturn ret;
+  guint first;
+
+  if (!common->index)
+    common->index =
+        g_array_sized_new (FALSE, FALSE, sizeof (GstMatroskaIndex), 128);
+
+  first = common->index->len;
+  ret = gst_matroska_read_common_parse_index_pointentry (common, ebml);
+  gst_matroska_read_common_add_track_index_entries (common, first);
+
+  return ret;
+}
+
+/* sorts an index read in pages that turned out not to be in time order */
+void
+gst_matroska_read_common_sort_index (GstMatroskaReadCommon * common)
+{
+  guint i;
+
+  if (!common->index)
+    return;
+
+  g_array_sort (common->index, (GCompareFunc) gst_matroska_index_compare);
+
+  for (i = 0; i < common->src->len; i++) {
+    GstMatroskaTrackContext *ctx = g_ptr_array_index (common->src, i);
+
+    if (ctx->index_table)
+      g_array_set_size (ctx->index_table, 0);
+  }
+  gst_matroska_read_common_add_track_index_entries (common, 0);
+}
+
 GstFlowReturn
 gst_matroska_read_common_parse_info (GstMatroskaReadCommon * common,
     GstElement * el, GstEbmlRead * ebml)
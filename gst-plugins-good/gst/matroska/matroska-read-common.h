@@ -123,6 +123,9 @@ GstMatroskaTrackContext * gst_matroska_read_common_get_seek_track (
     GstMatroskaReadCommon * common, GstMatroskaTrackContext * track);
 GstFlowReturn gst_matroska_read_common_parse_index (GstMatroskaReadCommon *
     common, GstEbmlRead * ebml);
+GstFlowReturn gst_matroska_read_common_parse_index_cuepoint (
+    GstMatroskaReadCommon * common, GstEbmlRead * ebml);
+void gst_matroska_read_common_sort_index (GstMatroskaReadCommon * common);
 GstFlowReturn gst_matroska_read_common_parse_info (GstMatroskaReadCommon *
     common, GstElement * el, GstEbmlRead * ebml);
 GstFlowReturn gst_matroska_read_common_parse_attachments (
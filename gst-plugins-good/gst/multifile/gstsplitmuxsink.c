@@ -30,6 +30,12 @@
  * By default, it uses mp4mux and filesink, but they can be changed via
  * the 'muxer' and 'sink' properties.
  *
+ * With #GstSplitMuxSink:async-finalize enabled, a finished file is
+ * closed in the background while a new muxer and sink created from
+ * #GstSplitMuxSink:muxer-factory and #GstSplitMuxSink:sink-factory
+ * already take the next fragment, so the input is not held up while
+ * the muxer writes out its headers.
+ *
  * The minimum file size is 1 GOP, however - so limits may be overrun if the
  * distance between any 2 keyframes is larger than the limits.
  *
@@ -74,7 +80,12 @@ enum
   PROP_MAX_FILES,
   PROP_MUXER_OVERHEAD,
   PROP_MUXER,
-  PROP_SINK
+  PROP_SINK,
+  PROP_ASYNC_FINALIZE,
+  PROP_MUXER_FACTORY,
+  PROP_MUXER_PROPERTIES,
+  PROP_SINK_FACTORY,
+  PROP_SINK_PROPERTIES
 };
 
 #define DEFAULT_MAX_SIZE_TIME       0
@@ -83,6 +94,7 @@ enum
 #define DEFAULT_MUXER_OVERHEAD      0.02
 #define DEFAULT_MUXER "mp4mux"
 #define DEFAULT_SINK "filesink"
+#define DEFAULT_ASYNC_FINALIZE FALSE
 
 enum
 {
@@ -143,6 +155,8 @@ static void check_queue_length (GstSplitMuxSink * splitmux, MqStreamCtx * ctx);
 static void mq_stream_ctx_unref (MqStreamCtx * ctx);
 
 static void gst_splitmux_sink_ensure_max_files (GstSplitMuxSink * splitmux);
+static void splitmux_finalizing_fragment_free (SplitMuxFinalizingFragment *
+    frag);
 
 static MqStreamBuf *
 mq_stream_buf_new (void)
@@ -224,6 +238,70 @@ gst_splitmux_sink_class_init (GstSplitMuxSinkClass * klass)
           "The sink element (or element chain) to use (NULL = default filesink)",
           GST_TYPE_ELEMENT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSplitMuxSink:async-finalize:
+   *
+   * When enabled, each finished file is closed asynchronously: the muxer
+   * and sink of the old fragment are finished in the background while a
+   * new muxer and sink take over at the keyframe. This needs a new pair
+   * of elements per fragment, so they are created from
+   * #GstSplitMuxSink:muxer-factory and #GstSplitMuxSink:sink-factory and
+   * the #GstSplitMuxSink:muxer and #GstSplitMuxSink:sink properties are
+   * ignored.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_ASYNC_FINALIZE,
+      g_param_spec_boolean ("async-finalize",
+          "Finalize fragments asynchronously",
+          "Finalize each fragment asynchronously and start a new one",
+          DEFAULT_ASYNC_FINALIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstSplitMuxSink:muxer-factory:
+   *
+   * Name of the muxer factory used in async-finalize mode.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MUXER_FACTORY,
+      g_param_spec_string ("muxer-factory", "Muxer factory",
+          "The muxer element factory to use (NULL = default mp4mux)",
+          NULL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstSplitMuxSink:muxer-properties:
+   *
+   * Properties to set on each muxer created in async-finalize mode.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MUXER_PROPERTIES,
+      g_param_spec_boxed ("muxer-properties", "Muxer properties",
+          "The muxer element properties to use",
+          GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstSplitMuxSink:sink-factory:
+   *
+   * Name of the sink factory used in async-finalize mode.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SINK_FACTORY,
+      g_param_spec_string ("sink-factory", "Sink factory",
+          "The sink element factory to use (NULL = default filesink)",
+          NULL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstSplitMuxSink:sink-properties:
+   *
+   * Properties to set on each sink created in async-finalize mode.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SINK_PROPERTIES,
+      g_param_spec_boxed ("sink-properties", "Sink properties",
+          "The sink element properties to use",
+          GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstSplitMuxSink::format-location:
    * @splitmux: the #GstSplitMuxSink
@@ -246,6 +324,7 @@ gst_splitmux_sink_init (GstSplitMuxSink * splitmux)
   splitmux->threshold_time = DEFAULT_MAX_SIZE_TIME;
   splitmux->threshold_bytes = DEFAULT_MAX_SIZE_BYTES;
   splitmux->max_files = DEFAULT_MAX_FILES;
+  splitmux->async_finalize = DEFAULT_ASYNC_FINALIZE;
 
   GST_OBJECT_FLAG_SET (splitmux, GST_ELEMENT_FLAG_SINK);
   g_object_set (splitmux, "async-handling", TRUE, NULL);
@@ -261,6 +340,20 @@ gst_splitmux_reset (GstSplitMuxSink * splitmux)
   if (splitmux->active_sink)
     gst_bin_remove (GST_BIN (splitmux), splitmux->active_sink);
 
+  while (splitmux->finalizing_fragments) {
+    SplitMuxFinalizingFragment *frag = splitmux->finalizing_fragments->data;
+
+    splitmux->finalizing_fragments =
+        g_list_delete_link (splitmux->finalizing_fragments,
+        splitmux->finalizing_fragments);
+
+    gst_element_set_state (frag->sink, GST_STATE_NULL);
+    gst_element_set_state (frag->muxer, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (splitmux), frag->muxer);
+    gst_bin_remove (GST_BIN (splitmux), frag->sink);
+    splitmux_finalizing_fragment_free (frag);
+  }
+
   splitmux->sink = splitmux->active_sink = splitmux->muxer = splitmux->mq =
       NULL;
 }
@@ -289,6 +382,15 @@ gst_splitmux_sink_finalize (GObject * object)
     gst_object_unref (splitmux->provided_muxer);
 
   g_free (splitmux->location);
+  g_free (splitmux->muxer_factory);
+  g_free (splitmux->sink_factory);
+  if (splitmux->muxer_properties)
+    gst_structure_free (splitmux->muxer_properties);
+  if (splitmux->sink_properties)
+    gst_structure_free (splitmux->sink_properties);
+
+  g_list_free_full (splitmux->finalizing_fragments,
+      (GDestroyNotify) splitmux_finalizing_fragment_free);
 
   /* Make sure to free any un-released contexts */
   g_list_foreach (splitmux->contexts, (GFunc) mq_stream_ctx_unref, NULL);
@@ -345,6 +447,37 @@ gst_splitmux_sink_set_property (GObject * object, guint prop_id,
       splitmux->provided_muxer = g_value_dup_object (value);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_ASYNC_FINALIZE:
+      GST_OBJECT_LOCK (splitmux);
+      splitmux->async_finalize = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_MUXER_FACTORY:
+      GST_OBJECT_LOCK (splitmux);
+      g_free (splitmux->muxer_factory);
+      splitmux->muxer_factory = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_MUXER_PROPERTIES:
+      GST_OBJECT_LOCK (splitmux);
+      if (splitmux->muxer_properties)
+        gst_structure_free (splitmux->muxer_properties);
+      splitmux->muxer_properties = g_value_dup_boxed (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_SINK_FACTORY:
+      GST_OBJECT_LOCK (splitmux);
+      g_free (splitmux->sink_factory);
+      splitmux->sink_factory = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_SINK_PROPERTIES:
+      GST_OBJECT_LOCK (splitmux);
+      if (splitmux->sink_properties)
+        gst_structure_free (splitmux->sink_properties);
+      splitmux->sink_properties = g_value_dup_boxed (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -393,6 +526,31 @@ gst_splitmux_sink_get_property (GObject * object, guint prop_id,
       g_value_set_object (value, splitmux->provided_muxer);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_ASYNC_FINALIZE:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_boolean (value, splitmux->async_finalize);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_MUXER_FACTORY:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_string (value, splitmux->muxer_factory);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_MUXER_PROPERTIES:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_boxed (value, splitmux->muxer_properties);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_SINK_FACTORY:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_string (value, splitmux->sink_factory);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_SINK_PROPERTIES:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_boxed (value, splitmux->sink_properties);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -495,25 +653,71 @@ _pad_block_destroy_src_notify (MqStreamCtx * ctx)
 }
 
 static void
-send_fragment_opened_closed_msg (GstSplitMuxSink * splitmux, gboolean opened)
+post_fragment_msg (GstSplitMuxSink * splitmux, gboolean opened,
+    const gchar * location, GstClockTime running_time)
 {
-  gchar *location = NULL;
   GstMessage *msg;
   const gchar *msg_name = opened ?
       "splitmuxsink-fragment-opened" : "splitmuxsink-fragment-closed";
 
-  g_object_get (splitmux->sink, "location", &location, NULL);
-
   msg = gst_message_new_element (GST_OBJECT (splitmux),
       gst_structure_new (msg_name,
           "location", G_TYPE_STRING, location,
-          "running-time", GST_TYPE_CLOCK_TIME,
-          splitmux->reference_ctx->out_running_time, NULL));
+          "running-time", GST_TYPE_CLOCK_TIME, running_time, NULL));
   gst_element_post_message (GST_ELEMENT_CAST (splitmux), msg);
+}
+
+static void
+send_fragment_opened_closed_msg (GstSplitMuxSink * splitmux, gboolean opened)
+{
+  gchar *location = NULL;
 
+  g_object_get (splitmux->sink, "location", &location, NULL);
+  post_fragment_msg (splitmux, opened, location,
+      splitmux->reference_ctx->out_running_time);
   g_free (location);
 }
 
+static void
+splitmux_finalizing_fragment_free (SplitMuxFinalizingFragment * frag)
+{
+  gst_object_unref (frag->muxer);
+  gst_object_unref (frag->sink);
+  g_free (frag->location);
+  g_slice_free (SplitMuxFinalizingFragment, frag);
+}
+
+static SplitMuxFinalizingFragment *
+find_finalizing_fragment (GstSplitMuxSink * splitmux, GstObject * sink)
+{
+  GList *cur;
+
+  for (cur = splitmux->finalizing_fragments; cur != NULL;
+      cur = g_list_next (cur)) {
+    SplitMuxFinalizingFragment *frag = cur->data;
+
+    if (GST_OBJECT_CAST (frag->sink) == sink)
+      return frag;
+  }
+
+  return NULL;
+}
+
+static gboolean
+all_contexts_are_eos (GstSplitMuxSink * splitmux)
+{
+  GList *cur;
+
+  for (cur = splitmux->contexts; cur != NULL; cur = g_list_next (cur)) {
+    MqStreamCtx *ctx = (MqStreamCtx *) (cur->data);
+
+    if (!ctx->out_eos)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
 /* Called with lock held, drops the lock to send EOS to the
  * pad
  */
@@ -561,7 +765,16 @@ complete_or_wait_on_out (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
 
     if (splitmux->state == SPLITMUX_STATE_ENDING_FILE) {
       if (ctx->out_eos == FALSE) {
-        send_eos (splitmux, ctx);
+        if (splitmux->async_finalize) {
+          /* Nothing more goes to the current muxer. Once all streams are
+           * at the split point, the muxer and sink are swapped for a new
+           * pair and the old one gets its EOS from another thread */
+          ctx->out_eos = TRUE;
+          if (all_contexts_are_eos (splitmux))
+            splitmux->state = SPLITMUX_STATE_START_NEXT_FRAGMENT;
+        } else {
+          send_eos (splitmux, ctx);
+        }
         continue;
       }
     } else if (splitmux->state == SPLITMUX_STATE_START_NEXT_FRAGMENT) {
@@ -748,6 +961,142 @@ restart_context (MqStreamCtx * ctx, GstSplitMuxSink * splitmux)
   gst_object_unref (peer);
 }
 
+static void
+send_eos_to_pads (GstElement * element, GList * pads)
+{
+  GList *cur;
+
+  for (cur = pads; cur != NULL; cur = g_list_next (cur)) {
+    GstPad *pad = GST_PAD_CAST (cur->data);
+
+    GST_INFO_OBJECT (element, "Sending EOS on %" GST_PTR_FORMAT, pad);
+    gst_pad_send_event (pad, gst_event_new_eos ());
+  }
+}
+
+static void
+unref_pads (GList * pads)
+{
+  g_list_free_full (pads, gst_object_unref);
+}
+
+/* Called with lock held in async-finalize mode, once all
+ * contexts reached the end of the current fragment. Links
+ * a new muxer and sink in place of the current ones and
+ * sends EOS to those from another thread, so that the muxer
+ * can finish the file without holding up the streams
+ */
+static gboolean
+swap_fragment_elements (GstSplitMuxSink * splitmux)
+{
+  SplitMuxFinalizingFragment *frag;
+  GList *cur, *old_pads = NULL;
+
+  frag = g_slice_new0 (SplitMuxFinalizingFragment);
+  frag->muxer = gst_object_ref (splitmux->muxer);
+  frag->sink = gst_object_ref (splitmux->active_sink);
+  g_object_get (splitmux->sink, "location", &frag->location, NULL);
+  frag->running_time = splitmux->reference_ctx->out_running_time;
+  splitmux->finalizing_fragments =
+      g_list_prepend (splitmux->finalizing_fragments, frag);
+
+  GST_DEBUG_OBJECT (splitmux, "Finalizing fragment %s in the background",
+      frag->location);
+
+  splitmux->muxer = splitmux->active_sink = splitmux->sink = NULL;
+  if (!create_elements (splitmux) || !create_sink (splitmux))
+    goto create_failed;
+
+  for (cur = splitmux->contexts; cur != NULL; cur = g_list_next (cur)) {
+    MqStreamCtx *ctx = (MqStreamCtx *) (cur->data);
+    GstPadTemplate *templ;
+    GstPad *old_pad, *new_pad;
+
+    old_pad = gst_pad_get_peer (ctx->srcpad);
+    if (old_pad == NULL)
+      continue;
+
+    gst_pad_unlink (ctx->srcpad, old_pad);
+    old_pads = g_list_prepend (old_pads, old_pad);
+
+    /* The new muxer comes from the same factory, so request the
+     * same pad again */
+    templ = gst_element_class_get_pad_template (GST_ELEMENT_GET_CLASS
+        (splitmux->muxer),
+        GST_PAD_TEMPLATE_NAME_TEMPLATE (GST_PAD_PAD_TEMPLATE (old_pad)));
+    if (templ == NULL)
+      goto link_failed;
+
+    new_pad = gst_element_request_pad (splitmux->muxer, templ,
+        GST_PAD_NAME (old_pad), NULL);
+    if (new_pad == NULL)
+      goto link_failed;
+
+    if (gst_pad_link_full (ctx->srcpad, new_pad,
+            GST_PAD_LINK_CHECK_DEFAULT | GST_PAD_LINK_CHECK_NO_RECONFIGURE)
+        != GST_PAD_LINK_OK) {
+      gst_element_release_request_pad (splitmux->muxer, new_pad);
+      gst_object_unref (new_pad);
+      goto link_failed;
+    }
+    gst_object_unref (new_pad);
+
+    /* The sticky events are sent to the new peer along with the next
+     * buffer, but a stream that already ended won't push anything
+     * anymore and needs its EOS resent right away */
+    ctx->out_eos = GST_PAD_IS_EOS (ctx->srcpad);
+    if (ctx->out_eos)
+      restart_context (ctx, splitmux);
+  }
+
+  set_next_filename (splitmux);
+
+  gst_element_set_state (splitmux->active_sink, GST_STATE_TARGET (splitmux));
+  gst_element_set_state (splitmux->muxer, GST_STATE_TARGET (splitmux));
+
+  gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+      (GstElementCallAsyncFunc) send_eos_to_pads, old_pads,
+      (GDestroyNotify) unref_pads);
+
+  return TRUE;
+
+  /* ERRORS */
+create_failed:
+  {
+    GST_ELEMENT_ERROR (splitmux, CORE, FAILED, (NULL),
+        ("Could not create muxer and sink for the next fragment"));
+    return FALSE;
+  }
+link_failed:
+  {
+    GST_ELEMENT_ERROR (splitmux, CORE, NEGOTIATION, (NULL),
+        ("Could not link the new muxer for the next fragment"));
+    /* Still let the old muxer finish what it has */
+    gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+        (GstElementCallAsyncFunc) send_eos_to_pads, old_pads,
+        (GDestroyNotify) unref_pads);
+    return FALSE;
+  }
+}
+
+/* Called when the sink of a fragment finalized in the background
+ * posted its EOS */
+static void
+remove_finalized_fragment (GstElement * element,
+    SplitMuxFinalizingFragment * frag)
+{
+  GST_DEBUG_OBJECT (element, "Fragment %s finalized, removing its elements",
+      frag->location);
+
+  gst_element_set_locked_state (frag->muxer, TRUE);
+  gst_element_set_locked_state (frag->sink, TRUE);
+  gst_element_set_state (frag->sink, GST_STATE_NULL);
+  gst_element_set_state (frag->muxer, GST_STATE_NULL);
+
+  gst_bin_remove (GST_BIN_CAST (element), frag->muxer);
+  gst_bin_remove (GST_BIN_CAST (element), frag->sink);
+}
+
 /* Called with lock held when a fragment
  * reaches EOS and it is time to restart
  * a new fragment
@@ -755,20 +1104,29 @@ restart_context (MqStreamCtx * ctx, GstSplitMuxSink * splitmux)
 static void
 start_next_fragment (GstSplitMuxSink * splitmux)
 {
-  /* 1 change to new file */
-  gst_element_set_locked_state (splitmux->muxer, TRUE);
-  gst_element_set_locked_state (splitmux->active_sink, TRUE);
-  gst_element_set_state (splitmux->muxer, GST_STATE_NULL);
-  gst_element_set_state (splitmux->active_sink, GST_STATE_NULL);
+  if (splitmux->async_finalize) {
+    if (!swap_fragment_elements (splitmux)) {
+      splitmux->state = SPLITMUX_STATE_STOPPED;
+      GST_SPLITMUX_BROADCAST (splitmux);
+      return;
+    }
+  } else {
+    /* 1 change to new file */
+    gst_element_set_locked_state (splitmux->muxer, TRUE);
+    gst_element_set_locked_state (splitmux->active_sink, TRUE);
+    gst_element_set_state (splitmux->muxer, GST_STATE_NULL);
+    gst_element_set_state (splitmux->active_sink, GST_STATE_NULL);
 
-  set_next_filename (splitmux);
+    set_next_filename (splitmux);
 
-  gst_element_set_state (splitmux->active_sink, GST_STATE_TARGET (splitmux));
-  gst_element_set_state (splitmux->muxer, GST_STATE_TARGET (splitmux));
-  gst_element_set_locked_state (splitmux->muxer, FALSE);
-  gst_element_set_locked_state (splitmux->active_sink, FALSE);
+    gst_element_set_state (splitmux->active_sink,
+        GST_STATE_TARGET (splitmux));
+    gst_element_set_state (splitmux->muxer, GST_STATE_TARGET (splitmux));
+    gst_element_set_locked_state (splitmux->muxer, FALSE);
+    gst_element_set_locked_state (splitmux->active_sink, FALSE);
 
-  g_list_foreach (splitmux->contexts, (GFunc) restart_context, splitmux);
+    g_list_foreach (splitmux->contexts, (GFunc) restart_context, splitmux);
+  }
 
   /* Switch state and go back to processing */
   if (!splitmux->reference_ctx->in_eos) {
@@ -801,10 +1159,29 @@ bus_handler (GstBin * bin, GstMessage * message)
   GstSplitMuxSink *splitmux = GST_SPLITMUX_SINK (bin);
 
   switch (GST_MESSAGE_TYPE (message)) {
-    case GST_MESSAGE_EOS:
-      /* If the state is draining out the current file, drop this EOS */
+    case GST_MESSAGE_EOS:{
+      SplitMuxFinalizingFragment *frag;
+
       GST_SPLITMUX_LOCK (splitmux);
 
+      frag = find_finalizing_fragment (splitmux, GST_MESSAGE_SRC (message));
+      if (frag != NULL) {
+        /* A fragment finalized in the background is complete. The EOS
+         * is still passed on for the bin's EOS tracking until the
+         * elements are removed */
+        post_fragment_msg (splitmux, FALSE, frag->location,
+            frag->running_time);
+        splitmux->finalizing_fragments =
+            g_list_remove (splitmux->finalizing_fragments, frag);
+        GST_SPLITMUX_UNLOCK (splitmux);
+
+        gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+            (GstElementCallAsyncFunc) remove_finalized_fragment, frag,
+            (GDestroyNotify) splitmux_finalizing_fragment_free);
+        break;
+      }
+
+      /* If the state is draining out the current file, drop this EOS */
       send_fragment_opened_closed_msg (splitmux, FALSE);
 
       if (splitmux->state == SPLITMUX_STATE_ENDING_FILE &&
@@ -819,6 +1196,7 @@ bus_handler (GstBin * bin, GstMessage * message)
       }
       GST_SPLITMUX_UNLOCK (splitmux);
       break;
+    }
     default:
       break;
   }
@@ -1419,6 +1797,34 @@ create_element (GstSplitMuxSink * splitmux,
   return ret;
 }
 
+static gboolean
+_set_property_from_structure (GQuark field_id, const GValue * value,
+    gpointer user_data)
+{
+  const gchar *property = g_quark_to_string (field_id);
+  GObject *element = G_OBJECT (user_data);
+
+  g_object_set_property (element, property, value);
+
+  return TRUE;
+}
+
+/* New muxers and sinks are added for each fragment in
+ * async-finalize mode, so they don't get fixed names there */
+static GstElement *
+create_element_from_factory (GstSplitMuxSink * splitmux,
+    const gchar * factory, const gchar * name, const GstStructure * props)
+{
+  GstElement *ret;
+
+  ret = create_element (splitmux, factory,
+      splitmux->async_finalize ? NULL : name);
+  if (ret != NULL && props != NULL)
+    gst_structure_foreach (props, _set_property_from_structure, ret);
+
+  return ret;
+}
+
 static gboolean
 create_elements (GstSplitMuxSink * splitmux)
 {
@@ -1438,13 +1844,14 @@ create_elements (GstSplitMuxSink * splitmux)
     GstElement *provided_muxer = NULL;
 
     GST_OBJECT_LOCK (splitmux);
-    if (splitmux->provided_muxer != NULL)
+    if (splitmux->provided_muxer != NULL && !splitmux->async_finalize)
       provided_muxer = gst_object_ref (splitmux->provided_muxer);
     GST_OBJECT_UNLOCK (splitmux);
 
     if (provided_muxer == NULL) {
-      if ((splitmux->muxer =
-              create_element (splitmux, "mp4mux", "muxer")) == NULL)
+      if ((splitmux->muxer = create_element_from_factory (splitmux,
+                  splitmux->muxer_factory ? splitmux->muxer_factory :
+                  DEFAULT_MUXER, "muxer", splitmux->muxer_properties)) == NULL)
         goto fail;
     } else {
       if (!gst_bin_add (GST_BIN (splitmux), provided_muxer)) {
@@ -1513,15 +1920,23 @@ create_sink (GstSplitMuxSink * splitmux)
   if (splitmux->active_sink == NULL) {
 
     GST_OBJECT_LOCK (splitmux);
-    if (splitmux->provided_sink != NULL)
+    if (splitmux->provided_sink != NULL && !splitmux->async_finalize)
       provided_sink = gst_object_ref (splitmux->provided_sink);
     GST_OBJECT_UNLOCK (splitmux);
 
     if (provided_sink == NULL) {
-      if ((splitmux->sink =
-              create_element (splitmux, DEFAULT_SINK, "sink")) == NULL)
+      if ((splitmux->active_sink = create_element_from_factory (splitmux,
+                  splitmux->sink_factory ? splitmux->sink_factory :
+                  DEFAULT_SINK, "sink", splitmux->sink_properties)) == NULL)
         goto fail;
-      splitmux->active_sink = splitmux->sink;
+
+      /* A sink from a factory can still be a bin */
+      splitmux->sink = find_sink (splitmux->active_sink);
+      if (splitmux->sink == NULL) {
+        g_warning
+            ("Could not locate sink element in sink - splitmuxsink will not work");
+        goto fail;
+      }
     } else {
       if (!gst_bin_add (GST_BIN (splitmux), provided_sink)) {
         g_warning ("Could not add sink elements - splitmuxsink will not work");
@@ -52,6 +52,17 @@ typedef struct _MqStreamBuf
   gsize buf_size;
 } MqStreamBuf;
 
+/* A closed fragment whose muxer and sink are still being finalized in
+ * the background in async-finalize mode */
+typedef struct _SplitMuxFinalizingFragment
+{
+  GstElement *muxer;
+  GstElement *sink;
+
+  gchar *location;
+  GstClockTime running_time;
+} SplitMuxFinalizingFragment;
+
 typedef struct _MqStreamCtx
 {
   gint refcount;
@@ -125,6 +136,14 @@ struct _GstSplitMuxSink {
   gsize mux_start_bytes;
 
   gboolean opening_first_fragment;
+
+  gboolean async_finalize;
+  gchar *muxer_factory;
+  gchar *sink_factory;
+  GstStructure *muxer_properties;
+  GstStructure *sink_properties;
+
+  GList *finalizing_fragments;
 };
 
 struct _GstSplitMuxSinkClass {
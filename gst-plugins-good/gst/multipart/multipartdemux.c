@@ -400,17 +400,15 @@ get_mime_len (const guint8 * data, guint maxlen)
 }
 
 static gint
-multipart_parse_header (GstMultipartDemux * multipart)
+multipart_parse_header_range (GstMultipartDemux * multipart, gint datalen)
 {
   const guint8 *data;
   const guint8 *dataend;
   gchar *boundary;
   int boundary_len;
-  int datalen;
   guint8 *pos;
   guint8 *end, *next;
 
-  datalen = gst_adapter_available (multipart->adapter);
   data = gst_adapter_map (multipart->adapter, datalen);
   dataend = data + datalen;
 
@@ -511,28 +509,69 @@ eos:
   }
 }
 
+/* the header is usually only a few hundred bytes, only map as much as is
+ * needed to parse it instead of merging the whole part that follows */
+#define MULTIPART_HEADER_MAP_SIZE 1024
+
+static gint
+multipart_parse_header (GstMultipartDemux * multipart)
+{
+  gint available, maplen, ret;
+
+  available = gst_adapter_available (multipart->adapter);
+  maplen = MIN (available, MULTIPART_HEADER_MAP_SIZE);
+
+  while (TRUE) {
+    ret = multipart_parse_header_range (multipart, maplen);
+    if (ret != MULTIPART_NEED_MORE_DATA || maplen == available)
+      return ret;
+    maplen = MIN (available, maplen * 2);
+  }
+}
+
+/* check if the boundary is at @offset in the adapter, the "--" and the first
+ * bytes of the boundary are already known to match */
+static gboolean
+multipart_boundary_matches (GstMultipartDemux * multipart, gint offset,
+    guint checked)
+{
+  guint8 tmp[64];
+
+  while (checked < multipart->boundary_len) {
+    guint n = MIN (sizeof (tmp), multipart->boundary_len - checked);
+
+    gst_adapter_copy (multipart->adapter, tmp, offset + 2 + checked, n);
+    if (memcmp (tmp, multipart->boundary + checked, n) != 0)
+      return FALSE;
+    checked += n;
+  }
+
+  return TRUE;
+}
+
 static gint
 multipart_find_boundary (GstMultipartDemux * multipart, gint * datalen)
 {
   /* Adaptor is positioned at the start of the data */
-  const guint8 *data, *pos;
-  const guint8 *dataend;
-  gint len;
+  guint32 pattern, mask;
+  guint8 prev[2];
+  gint len, pos, checked;
 
   if (multipart->content_length >= 0) {
     /* fast path, known content length :) */
     len = multipart->content_length;
     if (gst_adapter_available (multipart->adapter) >= len + 2) {
+      guint8 c;
+
       *datalen = len;
-      data = gst_adapter_map (multipart->adapter, len + 1);
+      gst_adapter_copy (multipart->adapter, &c, len, 1);
 
       /* If data[len] contains \r then assume a newline is \r\n */
-      if (data[len] == '\r')
+      if (c == '\r')
         len += 2;
-      else if (data[len] == '\n')
+      else if (c == '\n')
         len += 1;
 
-      gst_adapter_unmap (multipart->adapter);
       /* Don't check if boundary is actually there, but let the header parsing
        * bail out if it isn't */
       return len;
@@ -542,32 +581,57 @@ multipart_find_boundary (GstMultipartDemux * multipart, gint * datalen)
     }
   }
 
+  /* scan the adapter for "--" followed by the first bytes of the boundary,
+   * without merging the buffers in the adapter, and only compare the rest
+   * of the boundary at the candidate positions */
+  pattern = ('-' << 24) | ('-' << 16) | ((guint8) multipart->boundary[0] << 8);
+  mask = 0xffffff00;
+  checked = 1;
+  if (multipart->boundary_len > 1) {
+    pattern |= (guint8) multipart->boundary[1];
+    mask = 0xffffffff;
+    checked = 2;
+  }
+
   len = gst_adapter_available (multipart->adapter);
-  if (len == 0)
-    return MULTIPART_NEED_MORE_DATA;
-  data = gst_adapter_map (multipart->adapter, len);
-  dataend = data + len;
-
-  for (pos = data + multipart->scanpos;
-      pos <= dataend - multipart->boundary_len - 2; pos++) {
-    if (*pos == '-' && pos[1] == '-' &&
-        !strncmp ((gchar *) pos + 2,
-            multipart->boundary, multipart->boundary_len)) {
-      /* Found the boundary! Check if there was a newline before the boundary */
-      len = pos - data;
-      if (pos - 2 > data && pos[-2] == '\r')
+  while (len - multipart->scanpos >= 4) {
+    pos = gst_adapter_masked_scan_uint32 (multipart->adapter, mask, pattern,
+        multipart->scanpos, len - multipart->scanpos);
+    if (pos < 0) {
+      /* the last 3 bytes can still be the start of a boundary */
+      multipart->scanpos = len - 3;
+      break;
+    }
+
+    if (pos + 2 + multipart->boundary_len > len) {
+      multipart->scanpos = pos;
+      break;
+    }
+
+    if (!multipart_boundary_matches (multipart, pos, checked)) {
+      multipart->scanpos = pos + 1;
+      continue;
+    }
+
+    /* Found the boundary! Check if there was a newline before the boundary */
+    len = pos;
+    if (pos > 2) {
+      gst_adapter_copy (multipart->adapter, prev, pos - 2, 2);
+      if (prev[0] == '\r')
         len -= 2;
-      else if (pos - 1 > data && pos[-1] == '\n')
+      else if (prev[1] == '\n')
+        len -= 1;
+    } else if (pos > 1) {
+      gst_adapter_copy (multipart->adapter, prev, pos - 1, 1);
+      if (prev[0] == '\n')
         len -= 1;
-      *datalen = len;
-
-      gst_adapter_unmap (multipart->adapter);
-      multipart->scanpos = 0;
-      return pos - data;
     }
+    *datalen = len;
+
+    multipart->scanpos = 0;
+    return pos;
   }
-  gst_adapter_unmap (multipart->adapter);
-  multipart->scanpos = pos - data;
+
   return MULTIPART_NEED_MORE_DATA;
 }
 
@@ -593,6 +657,7 @@ gst_multipart_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       srcpad->discont = TRUE;
     }
     gst_adapter_clear (adapter);
+    multipart->scanpos = 0;
   }
   gst_adapter_push (adapter, buf);
 
@@ -632,7 +697,8 @@ gst_multipart_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
           multipart->mime_type, &created);
 
       ts = gst_adapter_prev_pts (adapter, NULL);
-      outbuf = gst_adapter_take_buffer (adapter, datalen);
+      /* the part can span several input buffers, don't merge them */
+      outbuf = gst_adapter_take_buffer_fast (adapter, datalen);
       gst_adapter_flush (adapter, size - datalen);
 
       if (created) {
@@ -38,6 +38,11 @@
 #define IDR_TYPE_ID  5
 #define SPS_TYPE_ID  7
 #define PPS_TYPE_ID  8
+#define STAP_A_TYPE_ID 24
+
+/* each NAL unit adds a length and a payload memory to a STAP-A packet, keep
+ * below the maximum number of memories of a buffer so nothing gets merged */
+#define STAP_A_MAX_NALS 7
 
 GST_DEBUG_CATEGORY_STATIC (rtph264pay_debug);
 #define GST_CAT_DEFAULT (rtph264pay_debug)
@@ -69,14 +74,36 @@ GST_STATIC_PAD_TEMPLATE ("src",
 
 #define DEFAULT_SPROP_PARAMETER_SETS    NULL
 #define DEFAULT_CONFIG_INTERVAL		      0
+#define DEFAULT_AGGREGATE_MODE          GST_RTP_H264_AGGREGATE_NONE
 
 enum
 {
   PROP_0,
   PROP_SPROP_PARAMETER_SETS,
-  PROP_CONFIG_INTERVAL
+  PROP_CONFIG_INTERVAL,
+  PROP_AGGREGATE_MODE
 };
 
+#define GST_TYPE_RTP_H264_AGGREGATE_MODE \
+  (gst_rtp_h264_aggregate_mode_get_type ())
+static GType
+gst_rtp_h264_aggregate_mode_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue values[] = {
+    {GST_RTP_H264_AGGREGATE_NONE, "Do not aggregate NAL units", "none"},
+    {GST_RTP_H264_AGGREGATE_ZERO_LATENCY,
+        "Aggregate NAL units of the same input buffer into STAP-A packets",
+        "zero-latency"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstRtpH264AggregateMode", values);
+  }
+  return type;
+}
+
 #define IS_ACCESS_UNIT(x) (((x) > 0x00) && ((x) < 0x06))
 
 static void gst_rtp_h264_pay_finalize (GObject * object);
@@ -133,6 +160,24 @@ gst_rtp_h264_pay_class_init (GstRtpH264PayClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
       );
 
+  /**
+   * GstRtpH264Pay:aggregate-mode:
+   *
+   * Bundle the NAL units that fit in one packet into STAP-A packets. NAL
+   * units are never held back beyond the input buffer they came in, so
+   * this adds no latency.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      PROP_AGGREGATE_MODE,
+      g_param_spec_enum ("aggregate-mode",
+          "Attempt to use aggregate packets",
+          "Bundle NAL units that fit in one packet into STAP-A packets",
+          GST_TYPE_RTP_H264_AGGREGATE_MODE, DEFAULT_AGGREGATE_MODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+      );
+
   gobject_class->finalize = gst_rtp_h264_pay_finalize;
 
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -170,10 +215,25 @@ gst_rtp_h264_pay_init (GstRtpH264Pay * rtph264pay)
   rtph264pay->spspps_interval = DEFAULT_CONFIG_INTERVAL;
   rtph264pay->delta_unit = FALSE;
   rtph264pay->discont = FALSE;
+  rtph264pay->aggregate_mode = DEFAULT_AGGREGATE_MODE;
 
   rtph264pay->adapter = gst_adapter_new ();
 }
 
+/* drop the packets of the current input buffer that were not pushed yet */
+static void
+gst_rtp_h264_pay_reset_packets (GstRtpH264Pay * rtph264pay)
+{
+  if (rtph264pay->bundle) {
+    gst_buffer_list_unref (rtph264pay->bundle);
+    rtph264pay->bundle = NULL;
+  }
+  if (rtph264pay->packets) {
+    gst_buffer_list_unref (rtph264pay->packets);
+    rtph264pay->packets = NULL;
+  }
+}
+
 static void
 gst_rtp_h264_pay_clear_sps_pps (GstRtpH264Pay * rtph264pay)
 {
@@ -197,6 +257,8 @@ gst_rtp_h264_pay_finalize (GObject * object)
 
   g_object_unref (rtph264pay->adapter);
 
+  gst_rtp_h264_pay_reset_packets (rtph264pay);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -763,6 +825,198 @@ gst_rtp_h264_pay_send_sps_pps (GstRTPBasePayload * basepayload,
   return ret;
 }
 
+/* queue @outbuf, the packets are pushed as one list once the input buffer
+ * was handled */
+static void
+gst_rtp_h264_pay_queue_packet (GstRtpH264Pay * rtph264pay, GstBuffer * outbuf)
+{
+  if (rtph264pay->packets == NULL)
+    rtph264pay->packets = gst_buffer_list_new ();
+  gst_buffer_list_add (rtph264pay->packets, outbuf);
+}
+
+static void
+gst_rtp_h264_pay_set_packet_flags (GstBuffer * outbuf, gboolean * delta_unit,
+    gboolean * discont)
+{
+  if (!*delta_unit)
+    /* Only the first packet sent should not have the flag */
+    *delta_unit = TRUE;
+  else
+    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  if (*discont) {
+    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
+    /* Only the first packet sent should have the flag */
+    *discont = FALSE;
+  }
+}
+
+/* put @paybuf in a single NAL unit packet */
+static void
+gst_rtp_h264_pay_payload_nal_single (GstRtpH264Pay * rtph264pay,
+    GstBuffer * paybuf, GstClockTime dts, GstClockTime pts, gboolean marker,
+    gboolean delta_unit, gboolean discont)
+{
+  GstBuffer *outbuf;
+  GstRTPBuffer rtp = { NULL };
+
+  /* create buffer without payload containing only the RTP header
+   * (memory block at index 0) */
+  outbuf = gst_rtp_buffer_new_allocate (0, 0, 0);
+
+  gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
+  /* only set the marker bit on packets containing access units */
+  if (marker)
+    gst_rtp_buffer_set_marker (&rtp, 1);
+  gst_rtp_buffer_unmap (&rtp);
+
+  /* timestamp the outbuffer */
+  GST_BUFFER_PTS (outbuf) = pts;
+  GST_BUFFER_DTS (outbuf) = dts;
+
+  gst_rtp_h264_pay_set_packet_flags (outbuf, &delta_unit, &discont);
+
+  /* insert payload memory block */
+  gst_rtp_copy_meta (GST_ELEMENT_CAST (rtph264pay), outbuf, paybuf,
+      g_quark_from_static_string (GST_META_TAG_VIDEO_STR));
+  outbuf = gst_buffer_append (outbuf, paybuf);
+
+  gst_rtp_h264_pay_queue_packet (rtph264pay, outbuf);
+}
+
+/* send the bundled NAL units, in a STAP-A packet if there is more than one */
+static void
+gst_rtp_h264_pay_send_bundle (GstRtpH264Pay * rtph264pay)
+{
+  GstBufferList *bundle = rtph264pay->bundle;
+  GstBuffer *outbuf;
+  GstRTPBuffer rtp = { NULL };
+  guint8 *payload;
+  guint8 stap_header = 0;
+  guint i, n;
+
+  if (bundle == NULL)
+    return;
+  rtph264pay->bundle = NULL;
+
+  n = gst_buffer_list_length (bundle);
+  GST_DEBUG_OBJECT (rtph264pay, "sending bundle of %u NAL units", n);
+
+  if (n == 1) {
+    gst_rtp_h264_pay_payload_nal_single (rtph264pay,
+        gst_buffer_ref (gst_buffer_list_get (bundle, 0)),
+        rtph264pay->bundle_dts, rtph264pay->bundle_pts,
+        rtph264pay->bundle_marker, rtph264pay->bundle_delta_unit,
+        rtph264pay->bundle_discont);
+    gst_buffer_list_unref (bundle);
+    return;
+  }
+
+  /* the F bit is set if any NAL unit has it, the NRI is the highest one */
+  for (i = 0; i < n; i++) {
+    guint8 nal_header;
+
+    gst_buffer_extract (gst_buffer_list_get (bundle, i), 0, &nal_header, 1);
+    stap_header |= nal_header & 0x80;
+    if ((nal_header & 0x60) > (stap_header & 0x60))
+      stap_header = (stap_header & 0x80) | (nal_header & 0x60);
+  }
+
+  /* RTP header and STAP-A NAL unit header */
+  outbuf = gst_rtp_buffer_new_allocate (1, 0, 0);
+
+  gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
+  if (rtph264pay->bundle_marker)
+    gst_rtp_buffer_set_marker (&rtp, 1);
+  payload = gst_rtp_buffer_get_payload (&rtp);
+  payload[0] = stap_header | STAP_A_TYPE_ID;
+  gst_rtp_buffer_unmap (&rtp);
+
+  GST_BUFFER_PTS (outbuf) = rtph264pay->bundle_pts;
+  GST_BUFFER_DTS (outbuf) = rtph264pay->bundle_dts;
+
+  gst_rtp_h264_pay_set_packet_flags (outbuf, &rtph264pay->bundle_delta_unit,
+      &rtph264pay->bundle_discont);
+
+  /* then the NAL unit size followed by the NAL unit, which is not copied */
+  for (i = 0; i < n; i++) {
+    GstBuffer *nal = gst_buffer_list_get (bundle, i);
+    GstMemory *mem;
+    GstMapInfo map;
+
+    mem = gst_allocator_alloc (NULL, 2, NULL);
+    gst_memory_map (mem, &map, GST_MAP_WRITE);
+    GST_WRITE_UINT16_BE (map.data, gst_buffer_get_size (nal));
+    gst_memory_unmap (mem, &map);
+    gst_buffer_append_memory (outbuf, mem);
+
+    gst_rtp_copy_meta (GST_ELEMENT_CAST (rtph264pay), outbuf, nal,
+        g_quark_from_static_string (GST_META_TAG_VIDEO_STR));
+    gst_buffer_copy_into (outbuf, nal, GST_BUFFER_COPY_MEMORY, 0, -1);
+  }
+  gst_buffer_list_unref (bundle);
+
+  gst_rtp_h264_pay_queue_packet (rtph264pay, outbuf);
+}
+
+/* add @paybuf to the NAL units to aggregate, when it fits in the packet */
+static void
+gst_rtp_h264_pay_bundle_nal (GstRtpH264Pay * rtph264pay, GstBuffer * paybuf,
+    GstClockTime dts, GstClockTime pts, gboolean marker, gboolean delta_unit,
+    gboolean discont)
+{
+  guint mtu = GST_RTP_BASE_PAYLOAD_MTU (rtph264pay);
+  guint size = gst_buffer_get_size (paybuf);
+
+  if (rtph264pay->bundle) {
+    guint bundle_size = rtph264pay->bundle_size + 2 + size;
+
+    /* a discont starts a new packet, and so does a different timestamp */
+    if (gst_rtp_buffer_calc_packet_len (bundle_size, 0, 0) >= mtu ||
+        gst_buffer_list_length (rtph264pay->bundle) >= STAP_A_MAX_NALS ||
+        discont || pts != rtph264pay->bundle_pts)
+      gst_rtp_h264_pay_send_bundle (rtph264pay);
+  }
+
+  if (rtph264pay->bundle == NULL) {
+    rtph264pay->bundle = gst_buffer_list_new ();
+    /* STAP-A NAL unit header */
+    rtph264pay->bundle_size = 1;
+    rtph264pay->bundle_dts = dts;
+    rtph264pay->bundle_pts = pts;
+    rtph264pay->bundle_delta_unit = delta_unit;
+    rtph264pay->bundle_discont = discont;
+  }
+
+  gst_buffer_list_add (rtph264pay->bundle, paybuf);
+  rtph264pay->bundle_size += 2 + size;
+  rtph264pay->bundle_marker = marker;
+  /* the packet is a delta unit only if all its NAL units are */
+  rtph264pay->bundle_delta_unit &= delta_unit;
+
+  /* nothing can be added after the end of the access unit */
+  if (marker)
+    gst_rtp_h264_pay_send_bundle (rtph264pay);
+}
+
+/* push the packets created from the current input buffer */
+static GstFlowReturn
+gst_rtp_h264_pay_push_packets (GstRTPBasePayload * basepayload)
+{
+  GstRtpH264Pay *rtph264pay = GST_RTP_H264_PAY (basepayload);
+  GstBufferList *list;
+
+  gst_rtp_h264_pay_send_bundle (rtph264pay);
+
+  list = rtph264pay->packets;
+  rtph264pay->packets = NULL;
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  return gst_rtp_base_payload_push_list (basepayload, list);
+}
+
 /* @delta_unit: if %FALSE the first packet sent won't have the
  * GST_BUFFER_FLAG_DELTA_UNIT flag.
  * @discont: if %TRUE the first packet sent will have the
@@ -780,7 +1034,6 @@ gst_rtp_h264_pay_payload_nal (GstRTPBasePayload * basepayload,
   guint packet_len, payload_len, mtu;
   GstBuffer *outbuf;
   guint8 *payload;
-  GstBufferList *list = NULL;
   gboolean send_spspps;
   GstRTPBuffer rtp = { NULL };
   guint size = gst_buffer_get_size (paybuf);
@@ -854,42 +1107,13 @@ gst_rtp_h264_pay_payload_nal (GstRTPBasePayload * basepayload,
     GST_DEBUG_OBJECT (basepayload,
         "NAL Unit fit in one packet datasize=%d mtu=%d", size, mtu);
 
-    /* create buffer without payload containing only the RTP header
-     * (memory block at index 0) */
-    outbuf = gst_rtp_buffer_new_allocate (0, 0, 0);
-
-    gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
-
-    /* only set the marker bit on packets containing access units */
-    if (IS_ACCESS_UNIT (nalType) && end_of_au) {
-      gst_rtp_buffer_set_marker (&rtp, 1);
-    }
-
-    /* timestamp the outbuffer */
-    GST_BUFFER_PTS (outbuf) = pts;
-    GST_BUFFER_DTS (outbuf) = dts;
-
-    if (!delta_unit)
-      /* Only the first packet sent should not have the flag */
-      delta_unit = TRUE;
+    if (rtph264pay->aggregate_mode != GST_RTP_H264_AGGREGATE_NONE)
+      gst_rtp_h264_pay_bundle_nal (rtph264pay, paybuf, dts, pts,
+          IS_ACCESS_UNIT (nalType) && end_of_au, delta_unit, discont);
     else
-      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DELTA_UNIT);
-
-    if (discont) {
-      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
-      /* Only the first packet sent should have the flag */
-      discont = FALSE;
-    }
-
-    gst_rtp_buffer_unmap (&rtp);
-
-    /* insert payload memory block */
-    gst_rtp_copy_meta (GST_ELEMENT_CAST (rtph264pay), outbuf, paybuf,
-        g_quark_from_static_string (GST_META_TAG_VIDEO_STR));
-    outbuf = gst_buffer_append (outbuf, paybuf);
-
-    /* push the buffer to the next element */
-    ret = gst_rtp_base_payload_push (basepayload, outbuf);
+      gst_rtp_h264_pay_payload_nal_single (rtph264pay, paybuf, dts, pts,
+          IS_ACCESS_UNIT (nalType) && end_of_au, delta_unit, discont);
+    ret = GST_FLOW_OK;
   } else {
     /* fragmentation Units FU-A */
     guint limitedSize;
@@ -906,11 +1130,12 @@ gst_rtp_h264_pay_payload_nal (GstRTPBasePayload * basepayload,
     GST_DEBUG_OBJECT (basepayload, "Using FU-A fragmentation for data size=%d",
         size);
 
+    /* anything bundled so far goes first */
+    gst_rtp_h264_pay_send_bundle (rtph264pay);
+
     /* We keep 2 bytes for FU indicator and FU Header */
     payload_len = gst_rtp_buffer_calc_payload_len (mtu - 2, 0, 0);
 
-    list = gst_buffer_list_new_sized ((size / payload_len) + 1);
-
     while (end == 0) {
       limitedSize = size < payload_len ? size : payload_len;
       GST_DEBUG_OBJECT (basepayload,
@@ -950,20 +1175,10 @@ gst_rtp_h264_pay_payload_nal (GstRTPBasePayload * basepayload,
       gst_buffer_copy_into (outbuf, paybuf, GST_BUFFER_COPY_MEMORY, pos,
           limitedSize);
 
-      if (!delta_unit)
-        /* Only the first packet sent should not have the flag */
-        delta_unit = TRUE;
-      else
-        GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DELTA_UNIT);
-
-      if (discont) {
-        GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
-        /* Only the first packet sent should have the flag */
-        discont = FALSE;
-      }
+      gst_rtp_h264_pay_set_packet_flags (outbuf, &delta_unit, &discont);
 
       /* add the buffer to the buffer list */
-      gst_buffer_list_add (list, outbuf);
+      gst_rtp_h264_pay_queue_packet (rtph264pay, outbuf);
 
 
       size -= limitedSize;
@@ -972,7 +1187,6 @@ gst_rtp_h264_pay_payload_nal (GstRTPBasePayload * basepayload,
       start = 0;
     }
 
-    ret = gst_rtp_base_payload_push_list (basepayload, list);
     gst_buffer_unref (paybuf);
   }
   return ret;
@@ -1281,6 +1495,12 @@ done:
     gst_adapter_unmap (rtph264pay->adapter);
   }
 
+  /* everything made from this buffer goes out as one list */
+  if (ret == GST_FLOW_OK)
+    ret = gst_rtp_h264_pay_push_packets (basepayload);
+  else
+    gst_rtp_h264_pay_reset_packets (rtph264pay);
+
   return ret;
 
 caps_rejected:
@@ -1302,6 +1522,7 @@ gst_rtp_h264_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_FLUSH_STOP:
       gst_adapter_clear (rtph264pay->adapter);
+      gst_rtp_h264_pay_reset_packets (rtph264pay);
       break;
     case GST_EVENT_CUSTOM_DOWNSTREAM:
       s = gst_event_get_structure (event);
@@ -1344,6 +1565,7 @@ gst_rtp_h264_pay_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       rtph264pay->send_spspps = FALSE;
       gst_adapter_clear (rtph264pay->adapter);
+      gst_rtp_h264_pay_reset_packets (rtph264pay);
       break;
     default:
       break;
@@ -1380,6 +1602,9 @@ gst_rtp_h264_pay_set_property (GObject * object, guint prop_id,
     case PROP_CONFIG_INTERVAL:
       rtph264pay->spspps_interval = g_value_get_int (value);
       break;
+    case PROP_AGGREGATE_MODE:
+      rtph264pay->aggregate_mode = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1401,6 +1626,9 @@ gst_rtp_h264_pay_get_property (GObject * object, guint prop_id,
     case PROP_CONFIG_INTERVAL:
       g_value_set_int (value, rtph264pay->spspps_interval);
       break;
+    case PROP_AGGREGATE_MODE:
+      g_value_set_enum (value, rtph264pay->aggregate_mode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -54,6 +54,12 @@ typedef enum
   GST_H264_ALIGNMENT_AU
 } GstH264Alignment;
 
+typedef enum
+{
+  GST_RTP_H264_AGGREGATE_NONE,
+  GST_RTP_H264_AGGREGATE_ZERO_LATENCY
+} GstRTPH264AggregateMode;
+
 struct _GstRtpH264Pay
 {
   GstRTPBasePayload payload;
@@ -79,6 +85,19 @@ struct _GstRtpH264Pay
   gboolean delta_unit;
   /* TRUE if the next NALU processed should have the DISCONT flag */
   gboolean discont;
+
+  GstRTPH264AggregateMode aggregate_mode;
+
+  /* packets of the current input buffer, pushed as one list */
+  GstBufferList *packets;
+
+  /* NAL units waiting to be sent together in a STAP-A packet */
+  GstBufferList *bundle;
+  guint bundle_size;
+  gboolean bundle_marker;
+  gboolean bundle_delta_unit;
+  gboolean bundle_discont;
+  GstClockTime bundle_dts, bundle_pts;
 };
 
 struct _GstRtpH264PayClass
@@ -38,6 +38,13 @@
 GST_DEBUG_CATEGORY_STATIC (rtph265pay_debug);
 #define GST_CAT_DEFAULT (rtph265pay_debug)
 
+#define AP_TYPE_ID 48
+#define FU_TYPE_ID 49
+
+/* each NAL unit adds a length and a payload memory to an aggregation packet,
+ * keep below the maximum number of memories of a buffer */
+#define AP_MAX_NALS 7
+
 /* references:
  *
  * Internet Draft RTP Payload Format for High Efficiency Video Coding
@@ -104,14 +111,36 @@ GST_STATIC_PAD_TEMPLATE ("src",
 
 #define DEFAULT_SPROP_PARAMETER_SETS    NULL
 #define DEFAULT_CONFIG_INTERVAL		      0
+#define DEFAULT_AGGREGATE_MODE          GST_RTP_H265_AGGREGATE_NONE
 
 enum
 {
   PROP_0,
   PROP_SPROP_PARAMETER_SETS,
-  PROP_CONFIG_INTERVAL
+  PROP_CONFIG_INTERVAL,
+  PROP_AGGREGATE_MODE
 };
 
+#define GST_TYPE_RTP_H265_AGGREGATE_MODE \
+  (gst_rtp_h265_aggregate_mode_get_type ())
+static GType
+gst_rtp_h265_aggregate_mode_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue values[] = {
+    {GST_RTP_H265_AGGREGATE_NONE, "Do not aggregate NAL units", "none"},
+    {GST_RTP_H265_AGGREGATE_ZERO_LATENCY,
+        "Aggregate NAL units of the same input buffer into aggregation packets",
+        "zero-latency"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstRtpH265AggregateMode", values);
+  }
+  return type;
+}
+
 #define IS_ACCESS_UNIT(x) (((x) > 0x00) && ((x) < 0x06))
 
 static void gst_rtp_h265_pay_finalize (GObject * object);
@@ -168,6 +197,24 @@ gst_rtp_h265_pay_class_init (GstRtpH265PayClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
       );
 
+  /**
+   * GstRtpH265Pay:aggregate-mode:
+   *
+   * Bundle the NAL units that fit in one packet into aggregation packets.
+   * NAL units are never held back beyond the input buffer they came in, so
+   * this adds no latency.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      PROP_AGGREGATE_MODE,
+      g_param_spec_enum ("aggregate-mode",
+          "Attempt to use aggregate packets",
+          "Bundle NAL units that fit in one packet into aggregation packets",
+          GST_TYPE_RTP_H265_AGGREGATE_MODE, DEFAULT_AGGREGATE_MODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+      );
+
   gobject_class->finalize = gst_rtp_h265_pay_finalize;
 
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -205,10 +252,25 @@ gst_rtp_h265_pay_init (GstRtpH265Pay * rtph265pay)
       (GDestroyNotify) gst_buffer_unref);
   rtph265pay->last_vps_sps_pps = -1;
   rtph265pay->vps_sps_pps_interval = DEFAULT_CONFIG_INTERVAL;
+  rtph265pay->aggregate_mode = DEFAULT_AGGREGATE_MODE;
 
   rtph265pay->adapter = gst_adapter_new ();
 }
 
+/* drop the packets of the current input buffer that were not pushed yet */
+static void
+gst_rtp_h265_pay_reset_packets (GstRtpH265Pay * rtph265pay)
+{
+  if (rtph265pay->bundle) {
+    gst_buffer_list_unref (rtph265pay->bundle);
+    rtph265pay->bundle = NULL;
+  }
+  if (rtph265pay->packets) {
+    gst_buffer_list_unref (rtph265pay->packets);
+    rtph265pay->packets = NULL;
+  }
+}
+
 static void
 gst_rtp_h265_pay_clear_vps_sps_pps (GstRtpH265Pay * rtph265pay)
 {
@@ -234,6 +296,8 @@ gst_rtp_h265_pay_finalize (GObject * object)
 
   g_object_unref (rtph265pay->adapter);
 
+  gst_rtp_h265_pay_reset_packets (rtph265pay);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -914,6 +978,166 @@ gst_rtp_h265_pay_send_vps_sps_pps (GstRTPBasePayload * basepayload,
   return ret;
 }
 
+/* queue @outbuf, the packets are pushed as one list once the input buffer
+ * was handled */
+static void
+gst_rtp_h265_pay_queue_packet (GstRtpH265Pay * rtph265pay, GstBuffer * outbuf)
+{
+  if (rtph265pay->packets == NULL)
+    rtph265pay->packets = gst_buffer_list_new ();
+  gst_buffer_list_add (rtph265pay->packets, outbuf);
+}
+
+/* put @paybuf in a single NAL unit packet */
+static void
+gst_rtp_h265_pay_payload_nal_single (GstRtpH265Pay * rtph265pay,
+    GstBuffer * paybuf, GstClockTime dts, GstClockTime pts)
+{
+  GstBuffer *outbuf;
+
+  /* create buffer without payload containing only the RTP header
+   * (memory block at index 0) */
+  outbuf = gst_rtp_buffer_new_allocate (0, 0, 0);
+
+  /* FIXME : only set the marker bit on packets containing access units */
+
+  /* timestamp the outbuffer */
+  GST_BUFFER_PTS (outbuf) = pts;
+  GST_BUFFER_DTS (outbuf) = dts;
+
+  /* insert payload memory block */
+  gst_rtp_copy_meta (GST_ELEMENT_CAST (rtph265pay), outbuf, paybuf,
+      g_quark_from_static_string (GST_META_TAG_VIDEO_STR));
+  outbuf = gst_buffer_append (outbuf, paybuf);
+
+  gst_rtp_h265_pay_queue_packet (rtph265pay, outbuf);
+}
+
+/* send the bundled NAL units, in an aggregation packet if there is more than
+ * one */
+static void
+gst_rtp_h265_pay_send_bundle (GstRtpH265Pay * rtph265pay)
+{
+  GstBufferList *bundle = rtph265pay->bundle;
+  GstBuffer *outbuf;
+  GstRTPBuffer rtp = { NULL };
+  guint8 *payload;
+  guint8 f_bit = 0, layer_id = 0x3f, tid = 0x7;
+  guint i, n;
+
+  if (bundle == NULL)
+    return;
+  rtph265pay->bundle = NULL;
+
+  n = gst_buffer_list_length (bundle);
+  GST_DEBUG_OBJECT (rtph265pay, "sending bundle of %u NAL units", n);
+
+  if (n == 1) {
+    gst_rtp_h265_pay_payload_nal_single (rtph265pay,
+        gst_buffer_ref (gst_buffer_list_get (bundle, 0)),
+        rtph265pay->bundle_dts, rtph265pay->bundle_pts);
+    gst_buffer_list_unref (bundle);
+    return;
+  }
+
+  /* the F bit is set if any NAL unit has it, LayerId and TID are the lowest
+   * ones of the aggregated NAL units */
+  for (i = 0; i < n; i++) {
+    guint8 nal_header[2];
+    guint8 nal_layer_id, nal_tid;
+
+    gst_buffer_extract (gst_buffer_list_get (bundle, i), 0, nal_header, 2);
+    f_bit |= nal_header[0] & 0x80;
+    nal_layer_id = ((nal_header[0] & 0x01) << 5) | (nal_header[1] >> 3);
+    nal_tid = nal_header[1] & 0x07;
+    layer_id = MIN (layer_id, nal_layer_id);
+    tid = MIN (tid, nal_tid);
+  }
+
+  /* RTP header and PayloadHdr */
+  outbuf = gst_rtp_buffer_new_allocate (2, 0, 0);
+
+  gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
+  payload = gst_rtp_buffer_get_payload (&rtp);
+  payload[0] = f_bit | (AP_TYPE_ID << 1) | (layer_id >> 5);
+  payload[1] = ((layer_id & 0x1f) << 3) | tid;
+  gst_rtp_buffer_unmap (&rtp);
+
+  GST_BUFFER_PTS (outbuf) = rtph265pay->bundle_pts;
+  GST_BUFFER_DTS (outbuf) = rtph265pay->bundle_dts;
+
+  /* then the NAL unit size followed by the NAL unit, which is not copied */
+  for (i = 0; i < n; i++) {
+    GstBuffer *nal = gst_buffer_list_get (bundle, i);
+    GstMemory *mem;
+    GstMapInfo map;
+
+    mem = gst_allocator_alloc (NULL, 2, NULL);
+    gst_memory_map (mem, &map, GST_MAP_WRITE);
+    GST_WRITE_UINT16_BE (map.data, gst_buffer_get_size (nal));
+    gst_memory_unmap (mem, &map);
+    gst_buffer_append_memory (outbuf, mem);
+
+    gst_rtp_copy_meta (GST_ELEMENT_CAST (rtph265pay), outbuf, nal,
+        g_quark_from_static_string (GST_META_TAG_VIDEO_STR));
+    gst_buffer_copy_into (outbuf, nal, GST_BUFFER_COPY_MEMORY, 0, -1);
+  }
+  gst_buffer_list_unref (bundle);
+
+  gst_rtp_h265_pay_queue_packet (rtph265pay, outbuf);
+}
+
+/* add @paybuf to the NAL units to aggregate, when it fits in the packet */
+static void
+gst_rtp_h265_pay_bundle_nal (GstRtpH265Pay * rtph265pay, GstBuffer * paybuf,
+    GstClockTime dts, GstClockTime pts, gboolean end_of_au)
+{
+  guint mtu = GST_RTP_BASE_PAYLOAD_MTU (rtph265pay);
+  guint size = gst_buffer_get_size (paybuf);
+
+  if (rtph265pay->bundle) {
+    guint bundle_size = rtph265pay->bundle_size + 2 + size;
+
+    /* a different timestamp starts a new packet */
+    if (gst_rtp_buffer_calc_packet_len (bundle_size, 0, 0) >= mtu ||
+        gst_buffer_list_length (rtph265pay->bundle) >= AP_MAX_NALS ||
+        pts != rtph265pay->bundle_pts)
+      gst_rtp_h265_pay_send_bundle (rtph265pay);
+  }
+
+  if (rtph265pay->bundle == NULL) {
+    rtph265pay->bundle = gst_buffer_list_new ();
+    /* PayloadHdr */
+    rtph265pay->bundle_size = 2;
+    rtph265pay->bundle_dts = dts;
+    rtph265pay->bundle_pts = pts;
+  }
+
+  gst_buffer_list_add (rtph265pay->bundle, paybuf);
+  rtph265pay->bundle_size += 2 + size;
+
+  /* nothing can be added after the end of the access unit */
+  if (end_of_au)
+    gst_rtp_h265_pay_send_bundle (rtph265pay);
+}
+
+/* push the packets created from the current input buffer */
+static GstFlowReturn
+gst_rtp_h265_pay_push_packets (GstRTPBasePayload * basepayload)
+{
+  GstRtpH265Pay *rtph265pay = GST_RTP_H265_PAY (basepayload);
+  GstBufferList *list;
+
+  gst_rtp_h265_pay_send_bundle (rtph265pay);
+
+  list = rtph265pay->packets;
+  rtph265pay->packets = NULL;
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  return gst_rtp_base_payload_push_list (basepayload, list);
+}
+
 static GstFlowReturn
 gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
     GstBuffer * paybuf, GstClockTime dts, GstClockTime pts, gboolean end_of_au)
@@ -925,7 +1149,6 @@ gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
   guint packet_len, payload_len, mtu;
   GstBuffer *outbuf;
   guint8 *payload;
-  GstBufferList *list = NULL;
   gboolean send_vps_sps_pps;
   GstRTPBuffer rtp = { NULL };
   guint size = gst_buffer_get_size (paybuf);
@@ -1017,36 +1240,11 @@ gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
         "NAL Unit fit in one packet datasize=%d mtu=%d", size, mtu);
     /* will fit in one packet */
 
-    /* use buffer lists
-     * create buffer without payload containing only the RTP header
-     * (memory block at index 0) */
-    outbuf = gst_rtp_buffer_new_allocate (0, 0, 0);
-
-    gst_rtp_buffer_map (outbuf, GST_MAP_WRITE, &rtp);
-
-    /* FIXME : only set the marker bit on packets containing access units */
-    /* if (IS_ACCESS_UNIT (nalType) && end_of_au) {
-       gst_rtp_buffer_set_marker (&rtp, 1);
-       } */
-
-    /* timestamp the outbuffer */
-    GST_BUFFER_PTS (outbuf) = pts;
-    GST_BUFFER_DTS (outbuf) = dts;
-
-    /* insert payload memory block */
-    gst_rtp_copy_meta (GST_ELEMENT_CAST (rtph265pay), outbuf, paybuf,
-        g_quark_from_static_string (GST_META_TAG_VIDEO_STR));
-    outbuf = gst_buffer_append (outbuf, paybuf);
-
-    list = gst_buffer_list_new ();
-
-    /* add the buffer to the buffer list */
-    gst_buffer_list_add (list, outbuf);
-
-    gst_rtp_buffer_unmap (&rtp);
-
-    /* push the list to the next element in the pipe */
-    ret = gst_rtp_base_payload_push_list (basepayload, list);
+    if (rtph265pay->aggregate_mode != GST_RTP_H265_AGGREGATE_NONE)
+      gst_rtp_h265_pay_bundle_nal (rtph265pay, paybuf, dts, pts, end_of_au);
+    else
+      gst_rtp_h265_pay_payload_nal_single (rtph265pay, paybuf, dts, pts);
+    ret = GST_FLOW_OK;
   } else {
     /* fragmentation Units */
     guint limitedSize;
@@ -1061,10 +1259,13 @@ gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
     GST_DEBUG_OBJECT (basepayload, "Using FU fragmentation for data size=%d",
         size);
 
+    /* anything bundled so far goes first */
+    gst_rtp_h265_pay_send_bundle (rtph265pay);
+
     /* We keep 3 bytes for PayloadHdr and FU Header */
     payload_len = gst_rtp_buffer_calc_payload_len (mtu - 3, 0, 0);
 
-    list = gst_buffer_list_new ();
+    ret = GST_FLOW_OK;
 
     while (end == 0) {
       limitedSize = size < payload_len ? size : payload_len;
@@ -1089,7 +1290,7 @@ gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
       }
 
       /* PayloadHdr (type = 49) */
-      payload[0] = (nalHeader[0] & 0x81) | (49 << 1);
+      payload[0] = (nalHeader[0] & 0x81) | (FU_TYPE_ID << 1);
       payload[1] = nalHeader[1];
 
       /* FIXME - set RTP marker bit appropriately */
@@ -1108,7 +1309,7 @@ gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
       gst_buffer_copy_into (outbuf, paybuf, GST_BUFFER_COPY_MEMORY, pos,
           limitedSize);
       /* add the buffer to the buffer list */
-      gst_buffer_list_add (list, outbuf);
+      gst_rtp_h265_pay_queue_packet (rtph265pay, outbuf);
 
       size -= limitedSize;
       pos += limitedSize;
@@ -1116,7 +1317,6 @@ gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
       start = 0;
     }
 
-    ret = gst_rtp_base_payload_push_list (basepayload, list);
     gst_buffer_unref (paybuf);
   }
   return ret;
@@ -1374,6 +1574,12 @@ done:
     gst_adapter_unmap (rtph265pay->adapter);
   }
 
+  /* everything made from this buffer goes out as one list */
+  if (ret == GST_FLOW_OK)
+    ret = gst_rtp_h265_pay_push_packets (basepayload);
+  else
+    gst_rtp_h265_pay_reset_packets (rtph265pay);
+
   return ret;
 
 caps_rejected:
@@ -1395,6 +1601,7 @@ gst_rtp_h265_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_FLUSH_STOP:
       gst_adapter_clear (rtph265pay->adapter);
+      gst_rtp_h265_pay_reset_packets (rtph265pay);
       break;
     case GST_EVENT_CUSTOM_DOWNSTREAM:
       s = gst_event_get_structure (event);
@@ -1438,6 +1645,7 @@ gst_rtp_h265_pay_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       rtph265pay->send_vps_sps_pps = FALSE;
       gst_adapter_clear (rtph265pay->adapter);
+      gst_rtp_h265_pay_reset_packets (rtph265pay);
       break;
     default:
       break;
@@ -1474,6 +1682,9 @@ gst_rtp_h265_pay_set_property (GObject * object, guint prop_id,
     case PROP_CONFIG_INTERVAL:
       rtph265pay->vps_sps_pps_interval = g_value_get_int (value);
       break;
+    case PROP_AGGREGATE_MODE:
+      rtph265pay->aggregate_mode = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1495,6 +1706,9 @@ gst_rtp_h265_pay_get_property (GObject * object, guint prop_id,
     case PROP_CONFIG_INTERVAL:
       g_value_set_int (value, rtph265pay->vps_sps_pps_interval);
       break;
+    case PROP_AGGREGATE_MODE:
+      g_value_set_enum (value, rtph265pay->aggregate_mode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
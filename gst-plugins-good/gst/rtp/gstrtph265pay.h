@@ -47,6 +47,12 @@ typedef enum
   GST_H265_ALIGNMENT_AU
 } GstH265Alignment;
 
+typedef enum
+{
+  GST_RTP_H265_AGGREGATE_NONE,
+  GST_RTP_H265_AGGREGATE_ZERO_LATENCY
+} GstRTPH265AggregateMode;
+
 struct _GstRtpH265Pay
 {
   GstRTPBasePayload payload;
@@ -67,6 +73,16 @@ struct _GstRtpH265Pay
   gint vps_sps_pps_interval;
   gboolean send_vps_sps_pps;
   GstClockTime last_vps_sps_pps;
+
+  GstRTPH265AggregateMode aggregate_mode;
+
+  /* packets of the current input buffer, pushed as one list */
+  GstBufferList *packets;
+
+  /* NAL units waiting to be sent together in an aggregation packet */
+  GstBufferList *bundle;
+  guint bundle_size;
+  GstClockTime bundle_dts, bundle_pts;
 };
 
 struct _GstRtpH265PayClass
@@ -74,6 +74,7 @@ struct _GstRtpBin {
   guint32         max_dropout_time;
   guint32         max_misorder_time;
   gboolean        rfc7273_sync;
+  gboolean        shared_rtcp_thread;
 
   /* a list of session */
   GSList         *sessions;
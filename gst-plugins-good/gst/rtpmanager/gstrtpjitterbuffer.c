@@ -298,6 +298,12 @@ struct _GstRtpJitterBufferPrivate
   guint32 next_in_seqnum;
 
   GArray *timers;
+  /* (type, seqnum) -> index + 1 of a timer in timers */
+  GHashTable *timer_index;
+  /* timers that share their key with an indexed one */
+  guint num_unindexed_timers;
+  /* LOST timers for more than one packet */
+  guint num_multi_lost_timers;
 
   /* start and stop ranges */
   GstClockTime npt_start;
@@ -891,6 +897,7 @@ gst_rtp_jitter_buffer_init (GstRtpJitterBuffer * jitterbuffer)
   priv->last_rtptime = -1;
   priv->avg_jitter = 0;
   priv->timers = g_array_new (FALSE, TRUE, sizeof (TimerData));
+  priv->timer_index = g_hash_table_new (NULL, NULL);
   priv->jbuf = rtp_jitter_buffer_new ();
   g_mutex_init (&priv->jbuf_lock);
   g_cond_init (&priv->jbuf_timer);
@@ -993,6 +1000,7 @@ gst_rtp_jitter_buffer_finalize (GObject * object)
   priv = jitterbuffer->priv;
 
   g_array_free (priv->timers, TRUE);
+  g_hash_table_destroy (priv->timer_index);
   g_mutex_clear (&priv->jbuf_lock);
   g_cond_clear (&priv->jbuf_timer);
   g_cond_clear (&priv->jbuf_event);
@@ -1893,22 +1901,71 @@ apply_offset (GstRtpJitterBuffer * jitterbuffer, GstClockTime timestamp)
   return timestamp;
 }
 
+#define TIMER_KEY(type,seqnum) GUINT_TO_POINTER (((type) << 16) | (seqnum))
+
+/* must be called whenever a timer gets added or its type or seqnum are
+ * about to change */
+static void
+timer_index_add (GstRtpJitterBufferPrivate * priv, TimerData * timer)
+{
+  gpointer key = TIMER_KEY (timer->type, timer->seqnum);
+
+  if (g_hash_table_contains (priv->timer_index, key))
+    priv->num_unindexed_timers++;
+  else
+    g_hash_table_insert (priv->timer_index, key,
+        GUINT_TO_POINTER (timer->idx + 1));
+
+  if (timer->type == TIMER_TYPE_LOST && timer->num > 1)
+    priv->num_multi_lost_timers++;
+}
+
+static void
+timer_index_remove (GstRtpJitterBufferPrivate * priv, TimerData * timer)
+{
+  gpointer key = TIMER_KEY (timer->type, timer->seqnum);
+
+  if (timer->type == TIMER_TYPE_LOST && timer->num > 1)
+    priv->num_multi_lost_timers--;
+
+  if (GPOINTER_TO_UINT (g_hash_table_lookup (priv->timer_index, key)) !=
+      timer->idx + 1) {
+    priv->num_unindexed_timers--;
+    return;
+  }
+
+  g_hash_table_remove (priv->timer_index, key);
+
+  /* index one of the timers that share this key, if any */
+  if (priv->num_unindexed_timers > 0) {
+    gint i, len;
+
+    len = priv->timers->len;
+    for (i = 0; i < len; i++) {
+      TimerData *test = &g_array_index (priv->timers, TimerData, i);
+
+      if (test != timer && test->seqnum == timer->seqnum &&
+          test->type == timer->type) {
+        g_hash_table_insert (priv->timer_index, key, GUINT_TO_POINTER (i + 1));
+        priv->num_unindexed_timers--;
+        break;
+      }
+    }
+  }
+}
+
 static TimerData *
 find_timer (GstRtpJitterBuffer * jitterbuffer, TimerType type, guint16 seqnum)
 {
   GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
-  TimerData *timer = NULL;
-  gint i, len;
+  guint idx;
 
-  len = priv->timers->len;
-  for (i = 0; i < len; i++) {
-    TimerData *test = &g_array_index (priv->timers, TimerData, i);
-    if (test->seqnum == seqnum && test->type == type) {
-      timer = test;
-      break;
-    }
-  }
-  return timer;
+  idx = GPOINTER_TO_UINT (g_hash_table_lookup (priv->timer_index,
+          TIMER_KEY (type, seqnum)));
+  if (idx == 0)
+    return NULL;
+
+  return &g_array_index (priv->timers, TimerData, idx - 1);
 }
 
 static void
@@ -1985,6 +2042,7 @@ add_timer (GstRtpJitterBuffer * jitterbuffer, TimerType type,
     timer->rtx_retry = 0;
   }
   timer->num_rtx_retry = 0;
+  timer_index_add (priv, timer);
   recalculate_timer (jitterbuffer, timer);
   JBUF_SIGNAL_TIMER (priv);
 
@@ -2012,7 +2070,11 @@ reschedule_timer (GstRtpJitterBuffer * jitterbuffer, TimerData * timer,
       oldseq, seqnum, GST_TIME_ARGS (timeout + delay));
 
   timer->timeout = timeout + delay;
-  timer->seqnum = seqnum;
+  if (seqchange) {
+    timer_index_remove (priv, timer);
+    timer->seqnum = seqnum;
+    timer_index_add (priv, timer);
+  }
   if (reset) {
     timer->rtx_base = timeout;
     timer->rtx_delay = delay;
@@ -2060,8 +2122,18 @@ remove_timer (GstRtpJitterBuffer * jitterbuffer, TimerData * timer)
 
   idx = timer->idx;
   GST_DEBUG_OBJECT (jitterbuffer, "removed index %d", idx);
+  timer_index_remove (priv, timer);
   g_array_remove_index_fast (priv->timers, idx);
   timer->idx = idx;
+
+  /* the last timer was moved in place of the removed one */
+  if (idx < priv->timers->len) {
+    gpointer key = TIMER_KEY (timer->type, timer->seqnum);
+
+    if (GPOINTER_TO_UINT (g_hash_table_lookup (priv->timer_index, key)) ==
+        priv->timers->len + 1)
+      g_hash_table_insert (priv->timer_index, key, GUINT_TO_POINTER (idx + 1));
+  }
 }
 
 static void
@@ -2070,6 +2142,9 @@ remove_all_timers (GstRtpJitterBuffer * jitterbuffer)
   GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
   GST_DEBUG_OBJECT (jitterbuffer, "removed all timers");
   g_array_set_size (priv->timers, 0);
+  g_hash_table_remove_all (priv->timer_index);
+  priv->num_unindexed_timers = 0;
+  priv->num_multi_lost_timers = 0;
   unschedule_current_timer (jitterbuffer);
 }
 
@@ -2104,6 +2179,9 @@ already_lost (GstRtpJitterBuffer * jitterbuffer, guint16 seqnum)
   GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
   gint i, len;
 
+  if (priv->num_multi_lost_timers == 0)
+    return FALSE;
+
   len = priv->timers->len;
   for (i = 0; i < len; i++) {
     TimerData *test = &g_array_index (priv->timers, TimerData, i);
@@ -2138,31 +2216,40 @@ update_timers (GstRtpJitterBuffer * jitterbuffer, guint16 seqnum,
   TimerData *timer = NULL;
   gint i, len;
 
-  /* go through all timers and unschedule the ones with a large gap, also find
-   * the timer for the seqnum */
-  len = priv->timers->len;
-  for (i = 0; i < len; i++) {
-    TimerData *test = &g_array_index (priv->timers, TimerData, i);
-    gint gap;
-
-    gap = gst_rtp_buffer_compare_seqnum (test->seqnum, seqnum);
+  if (!priv->do_retransmission) {
+    TimerType type;
 
-    GST_DEBUG_OBJECT (jitterbuffer, "%d, %d, #%d<->#%d gap %d", i,
-        test->type, test->seqnum, seqnum, gap);
+    /* without retransmission we only need to find the timer for the current
+     * seqnum, look it up in the index */
+    for (type = TIMER_TYPE_EXPECTED; type <= TIMER_TYPE_EOS; type++) {
+      TimerData *test = find_timer (jitterbuffer, type, seqnum);
 
-    if (gap == 0) {
-      GST_DEBUG ("found timer for current seqnum");
-      /* the timer for the current seqnum */
-      timer = test;
-      /* when no retransmission, we can stop now, we only need to find the
-       * timer for the current seqnum */
-      if (!priv->do_retransmission)
-        break;
-    } else if (gap > priv->rtx_delay_reorder) {
-      /* max gap, we exceeded the max reorder distance and we don't expect the
-       * missing packet to be this reordered */
-      if (test->num_rtx_retry == 0 && test->type == TIMER_TYPE_EXPECTED)
-        reschedule_timer (jitterbuffer, test, test->seqnum, -1, 0, FALSE);
+      if (test && (timer == NULL || test->idx < timer->idx))
+        timer = test;
+    }
+  } else {
+    /* go through all timers and unschedule the ones with a large gap, also
+     * find the timer for the seqnum */
+    len = priv->timers->len;
+    for (i = 0; i < len; i++) {
+      TimerData *test = &g_array_index (priv->timers, TimerData, i);
+      gint gap;
+
+      gap = gst_rtp_buffer_compare_seqnum (test->seqnum, seqnum);
+
+      GST_DEBUG_OBJECT (jitterbuffer, "%d, %d, #%d<->#%d gap %d", i,
+          test->type, test->seqnum, seqnum, gap);
+
+      if (gap == 0) {
+        GST_DEBUG ("found timer for current seqnum");
+        /* the timer for the current seqnum */
+        timer = test;
+      } else if (gap > priv->rtx_delay_reorder) {
+        /* max gap, we exceeded the max reorder distance and we don't expect
+         * the missing packet to be this reordered */
+        if (test->num_rtx_retry == 0 && test->type == TIMER_TYPE_EXPECTED)
+          reschedule_timer (jitterbuffer, test, test->seqnum, -1, 0, FALSE);
+      }
     }
   }
 
@@ -3402,7 +3489,9 @@ do_expected_timeout (GstRtpJitterBuffer * jitterbuffer, TimerData * timer,
     GST_DEBUG_OBJECT (jitterbuffer, "reschedule as LOST timer");
     /* too many retransmission request, we now convert the timer
      * to a lost timer, leave the num_rtx_retry as it is for stats */
+    timer_index_remove (priv, timer);
     timer->type = TIMER_TYPE_LOST;
+    timer_index_add (priv, timer);
     timer->rtx_delay = 0;
     timer->rtx_retry = 0;
   }
@@ -105,17 +105,14 @@ G_DEFINE_TYPE (GstRtpRtxSend, gst_rtp_rtx_send, GST_TYPE_ELEMENT);
 
 typedef struct
 {
-  guint16 seqnum;
   guint32 timestamp;
-  GstBuffer *buffer;
+  GstBuffer *buffer;            /* NULL for seqnums we never saw */
 } BufferQueueItem;
 
-static void
-buffer_queue_item_free (BufferQueueItem * item)
-{
-  gst_buffer_unref (item->buffer);
-  g_slice_free (BufferQueueItem, item);
-}
+/* initial and maximum number of slots in the history ring, the window
+ * must stay below half the seqnum space to be unambiguous */
+#define HISTORY_MIN_SIZE 64
+#define HISTORY_MAX_SIZE 32768
 
 typedef struct
 {
@@ -123,8 +120,12 @@ typedef struct
   guint16 seqnum_base, next_seqnum;
   gint clock_rate;
 
-  /* history of rtp packets */
-  GSequence *queue;
+  /* history of rtp packets, a ring indexed by seqnum covering the
+   * window [first_seqnum, first_seqnum + history_len) */
+  BufferQueueItem *history;
+  guint history_size;           /* power of two */
+  guint history_len;
+  guint16 first_seqnum;
 } SSRCRtxData;
 
 static SSRCRtxData *
@@ -134,15 +135,68 @@ ssrc_rtx_data_new (guint32 rtx_ssrc)
 
   data->rtx_ssrc = rtx_ssrc;
   data->next_seqnum = data->seqnum_base = g_random_int_range (0, G_MAXUINT16);
-  data->queue = g_sequence_new ((GDestroyNotify) buffer_queue_item_free);
+  data->history_size = HISTORY_MIN_SIZE;
+  data->history = g_new0 (BufferQueueItem, data->history_size);
 
   return data;
 }
 
+static inline BufferQueueItem *
+ssrc_rtx_data_get_item (SSRCRtxData * data, guint16 seqnum)
+{
+  return &data->history[seqnum & (data->history_size - 1)];
+}
+
+/* removes the oldest packet and any hole that follows it */
+static void
+ssrc_rtx_data_pop_oldest (SSRCRtxData * data)
+{
+  do {
+    BufferQueueItem *item = ssrc_rtx_data_get_item (data, data->first_seqnum);
+
+    if (item->buffer) {
+      gst_buffer_unref (item->buffer);
+      item->buffer = NULL;
+    }
+    data->first_seqnum++;
+    data->history_len--;
+  } while (data->history_len > 0
+      && !ssrc_rtx_data_get_item (data, data->first_seqnum)->buffer);
+}
+
+static void
+ssrc_rtx_data_clear_history (SSRCRtxData * data)
+{
+  while (data->history_len > 0)
+    ssrc_rtx_data_pop_oldest (data);
+}
+
+static void
+ssrc_rtx_data_grow_history (SSRCRtxData * data, guint min_size)
+{
+  BufferQueueItem *history;
+  guint size, i;
+
+  size = data->history_size;
+  while (size < min_size)
+    size <<= 1;
+
+  history = g_new0 (BufferQueueItem, size);
+  for (i = 0; i < data->history_len; i++) {
+    guint16 seqnum = data->first_seqnum + i;
+
+    history[seqnum & (size - 1)] = *ssrc_rtx_data_get_item (data, seqnum);
+  }
+  g_free (data->history);
+  data->history = history;
+  data->history_size = size;
+}
+
 static void
 ssrc_rtx_data_free (SSRCRtxData * data)
 {
-  g_sequence_free (data->queue);
+  ssrc_rtx_data_clear_history (data);
+  g_free (data->history);
   g_slice_free (SSRCRtxData, data);
 }
 
@@ -433,16 +487,6 @@ gst_rtp_rtx_buffer_new (GstRtpRtxSend * rtx, GstBuffer * buffer)
   return new_buffer;
 }
 
-static gint
-buffer_queue_items_cmp (BufferQueueItem * a, BufferQueueItem * b,
-    gpointer user_data)
-{
-  /* gst_rtp_buffer_compare_seqnum returns the opposite of what we want,
-   * it returns negative when seqnum1 > seqnum2 and we want negative
-   * when b > a, i.e. a is smaller, so it comes first in the sequence */
-  return gst_rtp_buffer_compare_seqnum (b->seqnum, a->seqnum);
-}
-
 static gboolean
 gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -476,21 +520,21 @@ gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         /* check if request is for us */
         if (g_hash_table_contains (rtx->ssrc_data, GUINT_TO_POINTER (ssrc))) {
           SSRCRtxData *data;
-          GSequenceIter *iter;
-          BufferQueueItem search_item;
+          guint16 offset;
 
           /* update statistics */
           ++rtx->num_rtx_requests;
 
           data = gst_rtp_rtx_send_get_ssrc_data (rtx, ssrc);
 
-          search_item.seqnum = seqnum;
-          iter = g_sequence_lookup (data->queue, &search_item,
-              (GCompareDataFunc) buffer_queue_items_cmp, NULL);
-          if (iter) {
-            BufferQueueItem *item = g_sequence_get (iter);
-            GST_DEBUG_OBJECT (rtx, "found %" G_GUINT16_FORMAT, item->seqnum);
-            rtx_buf = gst_rtp_rtx_buffer_new (rtx, item->buffer);
+          offset = (guint16) (seqnum - data->first_seqnum);
+          if (offset < data->history_len) {
+            BufferQueueItem *item = ssrc_rtx_data_get_item (data, seqnum);
+
+            if (item->buffer) {
+              GST_DEBUG_OBJECT (rtx, "found %u", seqnum);
+              rtx_buf = gst_rtp_rtx_buffer_new (rtx, item->buffer);
+            }
           }
         }
         GST_OBJECT_UNLOCK (rtx);
@@ -653,14 +697,13 @@ gst_rtp_rtx_send_get_ts_diff (SSRCRtxData * data)
   BufferQueueItem *high_buf, *low_buf;
   guint32 result;
 
-  high_buf =
-      g_sequence_get (g_sequence_iter_prev (g_sequence_get_end_iter
-          (data->queue)));
-  low_buf = g_sequence_get (g_sequence_get_begin_iter (data->queue));
-
-  if (!high_buf || !low_buf || high_buf == low_buf)
+  if (data->history_len < 2)
     return 0;
 
+  high_buf = ssrc_rtx_data_get_item (data,
+      data->first_seqnum + data->history_len - 1);
+  low_buf = ssrc_rtx_data_get_item (data, data->first_seqnum);
+
   high_ts = high_buf->timestamp;
   low_ts = low_buf->timestamp;
 
@@ -682,6 +725,7 @@ process_buffer (GstRtpRtxSend * rtx, GstBuffer * buffer)
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
   BufferQueueItem *item;
   SSRCRtxData *data;
+  guint len;
   guint16 seqnum;
   guint8 payload_type;
   guint32 ssrc, rtptime;
@@ -703,20 +747,54 @@ process_buffer (GstRtpRtxSend * rtx, GstBuffer * buffer)
     data = gst_rtp_rtx_send_get_ssrc_data (rtx, ssrc);
 
     /* add current rtp buffer to queue history */
-    item = g_slice_new0 (BufferQueueItem);
-    item->seqnum = seqnum;
+    if (data->history_len == 0) {
+      data->first_seqnum = seqnum;
+    } else {
+      guint16 offset = (guint16) (seqnum - data->first_seqnum);
+
+      if (offset >= HISTORY_MAX_SIZE) {
+        guint16 last_seqnum = data->first_seqnum + data->history_len - 1;
+
+        if ((gint16) (seqnum - last_seqnum) > 0) {
+          /* moving forward, make room by dropping the oldest packets */
+          while (data->history_len > 0
+              && (guint16) (seqnum - data->first_seqnum) >= HISTORY_MAX_SIZE)
+            ssrc_rtx_data_pop_oldest (data);
+        } else if ((guint16) (data->first_seqnum - seqnum) <=
+            data->history_len) {
+          GST_LOG_OBJECT (rtx, "seqnum %" G_GUINT16_FORMAT " is older than "
+              "the history, not storing it", seqnum);
+          return;
+        } else {
+          GST_DEBUG_OBJECT (rtx, "seqnum went back from %" G_GUINT16_FORMAT
+              " to %" G_GUINT16_FORMAT ", clearing history", last_seqnum,
+              seqnum);
+          ssrc_rtx_data_clear_history (data);
+        }
+        if (data->history_len == 0)
+          data->first_seqnum = seqnum;
+      }
+    }
+
+    len = MAX ((guint16) (seqnum - data->first_seqnum) + 1, data->history_len);
+    if (len > data->history_size)
+      ssrc_rtx_data_grow_history (data, len);
+
+    item = ssrc_rtx_data_get_item (data, seqnum);
+    if (item->buffer)
+      gst_buffer_unref (item->buffer);
     item->timestamp = rtptime;
     item->buffer = gst_buffer_ref (buffer);
-    g_sequence_append (data->queue, item);
+    data->history_len = len;
 
     /* remove oldest packets from history if they are too many */
     if (rtx->max_size_packets) {
-      while (g_sequence_get_length (data->queue) > rtx->max_size_packets)
-        g_sequence_remove (g_sequence_get_begin_iter (data->queue));
+      while (data->history_len > rtx->max_size_packets)
+        ssrc_rtx_data_pop_oldest (data);
     }
     if (rtx->max_size_time) {
       while (gst_rtp_rtx_send_get_ts_diff (data) > rtx->max_size_time)
-        g_sequence_remove (g_sequence_get_begin_iter (data->queue));
+        ssrc_rtx_data_pop_oldest (data);
     }
   }
 }
@@ -228,6 +228,7 @@ enum
 #define DEFAULT_RTP_PROFILE          GST_RTP_PROFILE_AVP
 #define DEFAULT_NTP_TIME_SOURCE      GST_RTP_NTP_TIME_SOURCE_NTP
 #define DEFAULT_RTCP_SYNC_SEND_TIME  TRUE
+#define DEFAULT_SHARED_RTCP_THREAD   FALSE
 
 enum
 {
@@ -248,7 +249,8 @@ enum
   PROP_STATS,
   PROP_RTP_PROFILE,
   PROP_NTP_TIME_SOURCE,
-  PROP_RTCP_SYNC_SEND_TIME
+  PROP_RTCP_SYNC_SEND_TIME,
+  PROP_SHARED_RTCP_THREAD
 };
 
 #define GST_RTP_SESSION_GET_PRIVATE(obj)  \
@@ -275,6 +277,11 @@ struct _GstRtpSessionPrivate
   gboolean thread_stopped;
   gboolean wait_send;
 
+  /* when using the shared RTCP thread */
+  gboolean shared_rtcp_thread;
+  GSequenceIter *sched_iter;
+  GstClockTime sched_deadline;
+
   /* caps mapping */
   GHashTable *ptmap;
 
@@ -763,6 +770,23 @@ gst_rtp_session_class_init (GstRtpSessionClass * klass)
           DEFAULT_RTCP_SYNC_SEND_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpSession:shared-rtcp-thread:
+   *
+   * Don't start a thread for sending RTCP in this session but let a single
+   * thread, shared by all sessions with this property enabled, handle the
+   * RTCP timeouts of all of them. This reduces the number of threads and
+   * wakeups when many sessions are used in the same process.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARED_RTCP_THREAD,
+      g_param_spec_boolean ("shared-rtcp-thread", "Shared RTCP thread",
+          "Use a thread shared with other sessions for sending RTCP",
+          DEFAULT_SHARED_RTCP_THREAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_rtp_session_change_state);
   gstelement_class->request_new_pad =
@@ -808,6 +832,7 @@ gst_rtp_session_init (GstRtpSession * rtpsession)
   rtpsession->priv->session = rtp_session_new ();
   rtpsession->priv->use_pipeline_clock = DEFAULT_USE_PIPELINE_CLOCK;
   rtpsession->priv->rtcp_sync_send_time = DEFAULT_RTCP_SYNC_SEND_TIME;
+  rtpsession->priv->shared_rtcp_thread = DEFAULT_SHARED_RTCP_THREAD;
 
   /* configure callbacks */
   rtp_session_set_callbacks (rtpsession->priv->session, &callbacks, rtpsession);
@@ -920,6 +945,9 @@ gst_rtp_session_set_property (GObject * object, guint prop_id,
     case PROP_RTCP_SYNC_SEND_TIME:
       priv->rtcp_sync_send_time = g_value_get_boolean (value);
       break;
+    case PROP_SHARED_RTCP_THREAD:
+      priv->shared_rtcp_thread = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -994,6 +1022,9 @@ gst_rtp_session_get_property (GObject * object, guint prop_id,
     case PROP_RTCP_SYNC_SEND_TIME:
       g_value_set_boolean (value, priv->rtcp_sync_send_time);
       break;
+    case PROP_SHARED_RTCP_THREAD:
+      g_value_set_boolean (value, priv->shared_rtcp_thread);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1153,12 +1184,289 @@ rtcp_thread (GstRtpSession * rtpsession)
   GST_DEBUG_OBJECT (rtpsession, "leaving RTCP thread");
 }
 
+/* The shared RTCP thread. It keeps the sessions that use it sorted on the
+ * time of their next RTCP timeout and waits for the earliest one. The thread
+ * is started when the first session needs it and stays around after that. */
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  GstClock *sysclock;
+  GThread *thread;
+
+  /* GstRtpSession sorted on sched_deadline */
+  GSequence *sessions;
+  GstClockID id;
+  /* session we are doing the timeout for */
+  GstRtpSession *running;
+} RtcpScheduler;
+
+static RtcpScheduler *
+rtcp_scheduler_get (void)
+{
+  static gsize scheduler = 0;
+
+  if (g_once_init_enter (&scheduler)) {
+    RtcpScheduler *sched;
+
+    sched = g_new0 (RtcpScheduler, 1);
+    g_mutex_init (&sched->lock);
+    g_cond_init (&sched->cond);
+    sched->sysclock = gst_system_clock_obtain ();
+    sched->sessions = g_sequence_new (NULL);
+
+    g_once_init_leave (&scheduler, (gsize) sched);
+  }
+  return (RtcpScheduler *) scheduler;
+}
+
+static gint
+compare_rtcp_deadline (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  GstClockTime ta = GST_RTP_SESSION_CAST (a)->priv->sched_deadline;
+  GstClockTime tb = GST_RTP_SESSION_CAST (b)->priv->sched_deadline;
+
+  if (ta < tb)
+    return -1;
+  if (ta > tb)
+    return 1;
+  return 0;
+}
+
+/* called with the scheduler lock. Queue the session for a timeout at
+ * @deadline or remove it when @deadline is GST_CLOCK_TIME_NONE */
+static void
+rtcp_scheduler_queue (RtcpScheduler * sched, GstRtpSession * rtpsession,
+    GstClockTime deadline)
+{
+  GstRtpSessionPrivate *priv = rtpsession->priv;
+
+  if (priv->sched_iter) {
+    g_sequence_remove (priv->sched_iter);
+    priv->sched_iter = NULL;
+  }
+  if (deadline == GST_CLOCK_TIME_NONE)
+    return;
+
+  priv->sched_deadline = deadline;
+  priv->sched_iter = g_sequence_insert_sorted (sched->sessions, rtpsession,
+      compare_rtcp_deadline, NULL);
+
+  /* wake up the thread when we are the new earliest timeout */
+  if (g_sequence_iter_is_begin (priv->sched_iter)) {
+    if (sched->id)
+      gst_clock_id_unschedule (sched->id);
+    g_cond_broadcast (&sched->cond);
+  }
+}
+
+/* called with the session lock */
+static void
+rtcp_scheduler_update (GstRtpSession * rtpsession, GstClockTime current_time)
+{
+  RtcpScheduler *sched = rtcp_scheduler_get ();
+  GstClockTime next_timeout;
+
+  next_timeout = rtp_session_next_timeout (rtpsession->priv->session,
+      current_time);
+
+  GST_DEBUG_OBJECT (rtpsession, "next check time %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (next_timeout));
+
+  /* no more timeouts, the session ended */
+  if (next_timeout == GST_CLOCK_TIME_NONE)
+    rtpsession->priv->thread_stopped = TRUE;
+
+  g_mutex_lock (&sched->lock);
+  rtcp_scheduler_queue (sched, rtpsession, next_timeout);
+  g_mutex_unlock (&sched->lock);
+}
+
+/* called with the session lock, what rtcp_thread() does when it starts */
+static void
+rtcp_scheduler_begin (GstRtpSession * rtpsession)
+{
+  GstClockTime current_time;
+
+  current_time = gst_clock_get_time (rtpsession->priv->sysclock);
+
+  GST_DEBUG_OBJECT (rtpsession, "starting at %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (current_time));
+  rtpsession->priv->session->start_time = current_time;
+
+  rtcp_scheduler_update (rtpsession, current_time);
+}
+
+static void
+rtcp_scheduler_do_timeout (GstRtpSession * rtpsession)
+{
+  GstRtpSessionPrivate *priv = rtpsession->priv;
+  GstClockTime current_time;
+  GstClockTime running_time;
+  guint64 ntpnstime;
+
+  GST_RTP_SESSION_LOCK (rtpsession);
+  if (priv->stop_thread)
+    goto done;
+
+  current_time = gst_clock_get_time (priv->sysclock);
+  get_current_times (rtpsession, &running_time, &ntpnstime);
+
+  GST_DEBUG_OBJECT (rtpsession, "timeout, current %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (current_time));
+
+  /* perform actions, we ignore result. Release lock because it might push. */
+  GST_RTP_SESSION_UNLOCK (rtpsession);
+  rtp_session_on_timeout (priv->session, current_time, ntpnstime,
+      running_time);
+  GST_RTP_SESSION_LOCK (rtpsession);
+
+  if (!priv->stop_thread)
+    rtcp_scheduler_update (rtpsession, current_time);
+
+done:
+  GST_RTP_SESSION_UNLOCK (rtpsession);
+}
+
+static gpointer
+rtcp_scheduler_thread (RtcpScheduler * sched)
+{
+  GST_DEBUG ("entering shared RTCP thread");
+
+  g_mutex_lock (&sched->lock);
+  while (TRUE) {
+    GSequenceIter *first;
+    GstRtpSession *rtpsession;
+    GstClockTime deadline;
+
+    first = g_sequence_get_begin_iter (sched->sessions);
+    if (g_sequence_iter_is_end (first)) {
+      g_cond_wait (&sched->cond, &sched->lock);
+      continue;
+    }
+
+    rtpsession = g_sequence_get (first);
+    deadline = rtpsession->priv->sched_deadline;
+
+    if (deadline > gst_clock_get_time (sched->sysclock)) {
+      GstClockID id;
+
+      id = sched->id = gst_clock_new_single_shot_id (sched->sysclock, deadline);
+      g_mutex_unlock (&sched->lock);
+
+      gst_clock_id_wait (id, NULL);
+
+      g_mutex_lock (&sched->lock);
+      gst_clock_id_unref (id);
+      sched->id = NULL;
+      /* the earliest timeout might have changed */
+      continue;
+    }
+
+    g_sequence_remove (first);
+    rtpsession->priv->sched_iter = NULL;
+    sched->running = gst_object_ref (rtpsession);
+    g_mutex_unlock (&sched->lock);
+
+    rtcp_scheduler_do_timeout (rtpsession);
+
+    g_mutex_lock (&sched->lock);
+    sched->running = NULL;
+    g_cond_broadcast (&sched->cond);
+    g_mutex_unlock (&sched->lock);
+
+    gst_object_unref (rtpsession);
+
+    g_mutex_lock (&sched->lock);
+  }
+  g_mutex_unlock (&sched->lock);
+
+  return NULL;
+}
+
+static gboolean
+rtcp_scheduler_start (GstRtpSession * rtpsession, GError ** error)
+{
+  RtcpScheduler *sched = rtcp_scheduler_get ();
+  gboolean res;
+
+  g_mutex_lock (&sched->lock);
+  if (sched->thread == NULL)
+    sched->thread = g_thread_try_new ("rtpsession-shared-rtcp-thread",
+        (GThreadFunc) rtcp_scheduler_thread, sched, error);
+  res = sched->thread != NULL;
+  g_mutex_unlock (&sched->lock);
+
+  if (!res)
+    return FALSE;
+
+  GST_RTP_SESSION_LOCK (rtpsession);
+  rtpsession->priv->stop_thread = FALSE;
+  if (rtpsession->priv->thread_stopped) {
+    rtpsession->priv->thread_stopped = FALSE;
+    /* else we start when the first packet is sent or received */
+    if (!rtpsession->priv->wait_send)
+      rtcp_scheduler_begin (rtpsession);
+  }
+  GST_RTP_SESSION_UNLOCK (rtpsession);
+
+  return TRUE;
+}
+
+/* called with the session lock */
+static void
+rtcp_scheduler_stop (GstRtpSession * rtpsession)
+{
+  RtcpScheduler *sched = rtcp_scheduler_get ();
+
+  g_mutex_lock (&sched->lock);
+  rtcp_scheduler_queue (sched, rtpsession, GST_CLOCK_TIME_NONE);
+  g_mutex_unlock (&sched->lock);
+
+  rtpsession->priv->thread_stopped = TRUE;
+}
+
+/* wait until the shared thread is not doing a timeout for the session
+ * anymore */
+static void
+rtcp_scheduler_join (GstRtpSession * rtpsession)
+{
+  RtcpScheduler *sched = rtcp_scheduler_get ();
+
+  g_mutex_lock (&sched->lock);
+  while (sched->running == rtpsession)
+    g_cond_wait (&sched->cond, &sched->lock);
+  g_mutex_unlock (&sched->lock);
+}
+
+/* called with the session lock, the first packet was sent or received */
+static void
+signal_rtcp_thread (GstRtpSession * rtpsession)
+{
+  if (!rtpsession->priv->wait_send)
+    return;
+
+  GST_LOG_OBJECT (rtpsession, "signal RTCP thread");
+  rtpsession->priv->wait_send = FALSE;
+  GST_RTP_SESSION_SIGNAL (rtpsession);
+
+  if (rtpsession->priv->shared_rtcp_thread && !rtpsession->priv->stop_thread
+      && !rtpsession->priv->thread_stopped)
+    rtcp_scheduler_begin (rtpsession);
+}
+
 static gboolean
 start_rtcp_thread (GstRtpSession * rtpsession)
 {
   GError *error = NULL;
   gboolean res;
 
+  if (rtpsession->priv->shared_rtcp_thread) {
+    GST_DEBUG_OBJECT (rtpsession, "using shared RTCP thread");
+    rtcp_scheduler_start (rtpsession, &error);
+    goto done;
+  }
+
   GST_DEBUG_OBJECT (rtpsession, "starting RTCP thread");
 
   GST_RTP_SESSION_LOCK (rtpsession);
@@ -1177,6 +1485,7 @@ start_rtcp_thread (GstRtpSession * rtpsession)
   }
   GST_RTP_SESSION_UNLOCK (rtpsession);
 
+done:
   if (error != NULL) {
     res = FALSE;
     GST_DEBUG_OBJECT (rtpsession, "failed to start thread, %s", error->message);
@@ -1198,12 +1507,19 @@ stop_rtcp_thread (GstRtpSession * rtpsession)
   GST_RTP_SESSION_SIGNAL (rtpsession);
   if (rtpsession->priv->id)
     gst_clock_id_unschedule (rtpsession->priv->id);
+  if (rtpsession->priv->shared_rtcp_thread)
+    rtcp_scheduler_stop (rtpsession);
   GST_RTP_SESSION_UNLOCK (rtpsession);
 }
 
 static void
 join_rtcp_thread (GstRtpSession * rtpsession)
 {
+  if (rtpsession->priv->shared_rtcp_thread) {
+    rtcp_scheduler_join (rtpsession);
+    return;
+  }
+
   GST_RTP_SESSION_LOCK (rtpsession);
   /* don't try to join when we have no thread */
   if (rtpsession->priv->thread != NULL) {
@@ -1333,11 +1649,7 @@ gst_rtp_session_send_rtp (RTPSession * sess, RTPSource * src,
   GST_RTP_SESSION_LOCK (rtpsession);
   if ((rtp_src = rtpsession->send_rtp_src))
     gst_object_ref (rtp_src);
-  if (rtpsession->priv->wait_send) {
-    GST_LOG_OBJECT (rtpsession, "signal RTCP thread");
-    rtpsession->priv->wait_send = FALSE;
-    GST_RTP_SESSION_SIGNAL (rtpsession);
-  }
+  signal_rtcp_thread (rtpsession);
   GST_RTP_SESSION_UNLOCK (rtpsession);
 
   if (rtp_src) {
@@ -1633,6 +1945,16 @@ gst_rtp_session_reconsider (RTPSession * sess, gpointer user_data)
   GST_DEBUG_OBJECT (rtpsession, "unlock timer for reconsideration");
   if (rtpsession->priv->id)
     gst_clock_id_unschedule (rtpsession->priv->id);
+  if (rtpsession->priv->shared_rtcp_thread) {
+    RtcpScheduler *sched = rtcp_scheduler_get ();
+
+    /* do the timeout now, it will calculate a new one. When it is running
+     * already it will be queued again when done. */
+    g_mutex_lock (&sched->lock);
+    if (rtpsession->priv->sched_iter)
+      rtcp_scheduler_queue (sched, rtpsession, 0);
+    g_mutex_unlock (&sched->lock);
+  }
   GST_RTP_SESSION_UNLOCK (rtpsession);
 }
 
@@ -1901,11 +2223,7 @@ gst_rtp_session_chain_recv_rtp (GstPad * pad, GstObject * parent,
   GST_LOG_OBJECT (rtpsession, "received RTP packet");
 
   GST_RTP_SESSION_LOCK (rtpsession);
-  if (rtpsession->priv->wait_send) {
-    GST_LOG_OBJECT (rtpsession, "signal RTCP thread");
-    rtpsession->priv->wait_send = FALSE;
-    GST_RTP_SESSION_SIGNAL (rtpsession);
-  }
+  signal_rtcp_thread (rtpsession);
   GST_RTP_SESSION_UNLOCK (rtpsession);
 
   /* get NTP time when this packet was captured, this depends on the timestamp. */
@@ -1990,11 +2308,7 @@ gst_rtp_session_chain_recv_rtcp (GstPad * pad, GstObject * parent,
   GST_LOG_OBJECT (rtpsession, "received RTCP packet");
 
   GST_RTP_SESSION_LOCK (rtpsession);
-  if (rtpsession->priv->wait_send) {
-    GST_LOG_OBJECT (rtpsession, "signal RTCP thread");
-    rtpsession->priv->wait_send = FALSE;
-    GST_RTP_SESSION_SIGNAL (rtpsession);
-  }
+  signal_rtcp_thread (rtpsession);
   GST_RTP_SESSION_UNLOCK (rtpsession);
 
   current_time = gst_clock_get_time (priv->sysclock);
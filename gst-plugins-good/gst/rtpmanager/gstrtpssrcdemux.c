@@ -115,6 +115,8 @@ static void gst_rtp_ssrc_demux_clear_ssrc (GstRtpSsrcDemux * demux,
 /* sinkpad stuff */
 static GstFlowReturn gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buf);
+static GstFlowReturn gst_rtp_ssrc_demux_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static gboolean gst_rtp_ssrc_demux_sink_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
 
@@ -152,15 +154,7 @@ struct _GstRtpSsrcDemuxPad
 static GstRtpSsrcDemuxPad *
 find_demux_pad_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc)
 {
-  GSList *walk;
-
-  for (walk = demux->srcpads; walk; walk = g_slist_next (walk)) {
-    GstRtpSsrcDemuxPad *pad = (GstRtpSsrcDemuxPad *) walk->data;
-
-    if (pad->ssrc == ssrc)
-      return pad;
-  }
-  return NULL;
+  return g_hash_table_lookup (demux->ssrc_pads, GUINT_TO_POINTER (ssrc));
 }
 
 static GstEvent *
@@ -298,6 +292,7 @@ find_or_create_demux_pad_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc,
   gst_pad_set_element_private (rtcp_pad, demuxpad);
 
   demux->srcpads = g_slist_prepend (demux->srcpads, demuxpad);
+  g_hash_table_insert (demux->ssrc_pads, GUINT_TO_POINTER (ssrc), demuxpad);
 
   gst_pad_set_query_function (rtp_pad, gst_rtp_ssrc_demux_src_query);
   gst_pad_set_iterate_internal_links_function (rtp_pad,
@@ -448,6 +443,8 @@ gst_rtp_ssrc_demux_init (GstRtpSsrcDemux * demux)
       gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
           "sink"), "sink");
   gst_pad_set_chain_function (demux->rtp_sink, gst_rtp_ssrc_demux_chain);
+  gst_pad_set_chain_list_function (demux->rtp_sink,
+      gst_rtp_ssrc_demux_chain_list);
   gst_pad_set_event_function (demux->rtp_sink, gst_rtp_ssrc_demux_sink_event);
   gst_pad_set_iterate_internal_links_function (demux->rtp_sink,
       gst_rtp_ssrc_demux_iterate_internal_links_sink);
@@ -463,6 +460,7 @@ gst_rtp_ssrc_demux_init (GstRtpSsrcDemux * demux)
   gst_element_add_pad (GST_ELEMENT_CAST (demux), demux->rtcp_sink);
 
   g_rec_mutex_init (&demux->padlock);
+  demux->ssrc_pads = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 static void
@@ -482,6 +480,7 @@ gst_rtp_ssrc_demux_reset (GstRtpSsrcDemux * demux)
   }
   g_slist_free (demux->srcpads);
   demux->srcpads = NULL;
+  g_hash_table_remove_all (demux->ssrc_pads);
 }
 
 static void
@@ -503,6 +502,7 @@ gst_rtp_ssrc_demux_finalize (GObject * object)
 
   demux = GST_RTP_SSRC_DEMUX (object);
   g_rec_mutex_clear (&demux->padlock);
+  g_hash_table_unref (demux->ssrc_pads);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -522,6 +522,7 @@ gst_rtp_ssrc_demux_clear_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc)
   GST_DEBUG_OBJECT (demux, "clearing pad for SSRC %08x", ssrc);
 
   demux->srcpads = g_slist_remove (demux->srcpads, dpad);
+  g_hash_table_remove (demux->ssrc_pads, GUINT_TO_POINTER (ssrc));
   GST_PAD_UNLOCK (demux);
 
   gst_pad_set_active (dpad->rtp_pad, FALSE);
@@ -604,32 +605,24 @@ gst_rtp_ssrc_demux_sink_event (GstPad * pad, GstObject * parent,
   return fdata.res;
 }
 
+/* push @data, a buffer or a buffer list, on the RTP pad of @ssrc */
 static GstFlowReturn
-gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+gst_rtp_ssrc_demux_push_rtp (GstRtpSsrcDemux * demux, guint32 ssrc,
+    gpointer data, gboolean is_list)
 {
   GstFlowReturn ret;
-  GstRtpSsrcDemux *demux;
-  guint32 ssrc;
-  GstRTPBuffer rtp = { NULL };
   GstPad *srcpad;
   GstRtpSsrcDemuxPad *dpad;
 
-  demux = GST_RTP_SSRC_DEMUX (parent);
-
-  if (!gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp))
-    goto invalid_payload;
-
-  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
-  gst_rtp_buffer_unmap (&rtp);
-
-  GST_DEBUG_OBJECT (demux, "received buffer of SSRC %08x", ssrc);
-
   srcpad = find_or_create_demux_pad_for_ssrc (demux, ssrc, RTP_PAD);
   if (srcpad == NULL)
     goto create_failed;
 
   /* push to srcpad */
-  ret = gst_pad_push (srcpad, buf);
+  if (is_list)
+    ret = gst_pad_push_list (srcpad, GST_BUFFER_LIST_CAST (data));
+  else
+    ret = gst_pad_push (srcpad, GST_BUFFER_CAST (data));
 
   if (ret != GST_FLOW_OK) {
     /* check if the ssrc still there, may have been removed */
@@ -646,6 +639,35 @@ gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 
   return ret;
 
+  /* ERRORS */
+create_failed:
+  {
+    GST_ELEMENT_ERROR (demux, STREAM, DECODE, (NULL),
+        ("Could not create new pad"));
+    gst_mini_object_unref (GST_MINI_OBJECT_CAST (data));
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  GstRtpSsrcDemux *demux;
+  guint32 ssrc;
+  GstRTPBuffer rtp = { NULL };
+
+  demux = GST_RTP_SSRC_DEMUX (parent);
+
+  if (!gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp))
+    goto invalid_payload;
+
+  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
+  gst_rtp_buffer_unmap (&rtp);
+
+  GST_DEBUG_OBJECT (demux, "received buffer of SSRC %08x", ssrc);
+
+  return gst_rtp_ssrc_demux_push_rtp (demux, ssrc, buf, FALSE);
+
   /* ERRORS */
 invalid_payload:
   {
@@ -655,11 +677,68 @@ invalid_payload:
     gst_buffer_unref (buf);
     return GST_FLOW_ERROR;
   }
-create_failed:
+}
+
+/* consecutive buffers of the same SSRC are pushed as one list, so the pad
+ * lookup is done once per run instead of once per packet */
+static GstFlowReturn
+gst_rtp_ssrc_demux_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstRtpSsrcDemux *demux;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBufferList *run = NULL;
+  guint32 ssrc, run_ssrc = 0;
+  guint i, len;
+
+  demux = GST_RTP_SSRC_DEMUX (parent);
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len; i++) {
+    GstBuffer *buf = gst_buffer_list_get (list, i);
+    GstRTPBuffer rtp = { NULL };
+
+    if (!gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp))
+      goto invalid_payload;
+
+    ssrc = gst_rtp_buffer_get_ssrc (&rtp);
+    gst_rtp_buffer_unmap (&rtp);
+
+    if (run && ssrc != run_ssrc) {
+      GST_DEBUG_OBJECT (demux, "received %u buffers of SSRC %08x",
+          gst_buffer_list_length (run), run_ssrc);
+      ret = gst_rtp_ssrc_demux_push_rtp (demux, run_ssrc, run, TRUE);
+      run = NULL;
+      if (ret != GST_FLOW_OK)
+        goto done;
+    }
+    if (run == NULL) {
+      run = gst_buffer_list_new_sized (len - i);
+      run_ssrc = ssrc;
+    }
+    gst_buffer_list_add (run, gst_buffer_ref (buf));
+  }
+
+  if (run) {
+    GST_DEBUG_OBJECT (demux, "received %u buffers of SSRC %08x",
+        gst_buffer_list_length (run), run_ssrc);
+    ret = gst_rtp_ssrc_demux_push_rtp (demux, run_ssrc, run, TRUE);
+  }
+
+done:
+  gst_buffer_list_unref (list);
+
+  return ret;
+
+  /* ERRORS */
+invalid_payload:
   {
+    /* this is fatal and should be filtered earlier */
     GST_ELEMENT_ERROR (demux, STREAM, DECODE, (NULL),
-        ("Could not create new pad"));
-    gst_buffer_unref (buf);
+        ("Dropping invalid RTP payload"));
+    if (run)
+      gst_buffer_list_unref (run);
+    gst_buffer_list_unref (list);
     return GST_FLOW_ERROR;
   }
 }
@@ -41,6 +41,8 @@ struct _GstRtpSsrcDemux
 
   GRecMutex padlock;
   GSList *srcpads;
+  /* GstRtpSsrcDemuxPad of srcpads hashed by SSRC */
+  GHashTable *ssrc_pads;
 };
 
 struct _GstRtpSsrcDemuxClass
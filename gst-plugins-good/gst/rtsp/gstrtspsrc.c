@@ -228,6 +228,7 @@ gst_rtsp_src_ntp_time_source_get_type (void)
 #define DEFAULT_USER_AGENT       "GStreamer/" PACKAGE_VERSION
 #define DEFAULT_MAX_RTCP_RTP_TIME_DIFF 1000
 #define DEFAULT_RFC7273_SYNC         FALSE
+#define DEFAULT_FAST_START           FALSE
 
 enum
 {
@@ -267,7 +268,8 @@ enum
   PROP_NTP_TIME_SOURCE,
   PROP_USER_AGENT,
   PROP_MAX_RTCP_RTP_TIME_DIFF,
-  PROP_RFC7273_SYNC
+  PROP_RFC7273_SYNC,
+  PROP_FAST_START
 };
 
 #define GST_TYPE_RTSP_NAT_METHOD (gst_rtsp_nat_method_get_type())
@@ -740,6 +742,23 @@ gst_rtspsrc_class_init (GstRTSPSrcClass * klass)
           "(requires clock and offset to be provided)", DEFAULT_RFC7273_SYNC,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPSrc:fast-start:
+   *
+   * Reduce the number of round-trips needed before the first frame arrives.
+   * The OPTIONS request is skipped, assuming the server supports the usual
+   * methods, and after the transport of the first stream has been negotiated
+   * the SETUP requests of all the other streams are sent without waiting for
+   * the individual responses. Streams whose pipelined SETUP fails are set up
+   * again the regular way.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_FAST_START,
+      g_param_spec_boolean ("fast-start", "Fast Start",
+          "Skip OPTIONS and pipeline the SETUP requests of all streams",
+          DEFAULT_FAST_START, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstRTSPSrc::handle-request:
    * @rtspsrc: a #GstRTSPSrc
@@ -888,6 +907,7 @@ gst_rtspsrc_init (GstRTSPSrc * src)
   src->user_agent = g_strdup (DEFAULT_USER_AGENT);
   src->max_rtcp_rtp_time_diff = DEFAULT_MAX_RTCP_RTP_TIME_DIFF;
   src->rfc7273_sync = DEFAULT_RFC7273_SYNC;
+  src->fast_start = DEFAULT_FAST_START;
 
   /* get a list of all extensions */
   src->extensions = gst_rtsp_ext_list_get ();
@@ -1170,6 +1190,9 @@ gst_rtspsrc_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_RFC7273_SYNC:
       rtspsrc->rfc7273_sync = g_value_get_boolean (value);
       break;
+    case PROP_FAST_START:
+      rtspsrc->fast_start = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1319,6 +1342,9 @@ gst_rtspsrc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_RFC7273_SYNC:
       g_value_set_boolean (value, rtspsrc->rfc7273_sync);
       break;
+    case PROP_FAST_START:
+      g_value_set_boolean (value, rtspsrc->fast_start);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -6008,6 +6034,382 @@ gst_rtspsrc_stream_make_keymgmt (GstRTSPSrc * src, GstRTSPStream * stream)
   return result;
 }
 
+/* Check if @stream needs a SETUP. The select-stream signal is only emitted
+ * the first time this is called for a stream. */
+static gboolean
+gst_rtspsrc_stream_is_selected (GstRTSPSrc * src, GstRTSPStream * stream)
+{
+  gboolean selected;
+  GstCaps *caps;
+
+  if (stream->selected)
+    return !stream->skipped;
+
+  caps = stream_get_caps_for_pt (stream, stream->default_pt);
+  if (caps == NULL) {
+    GST_DEBUG_OBJECT (src, "skipping stream %p, no caps", stream);
+    return FALSE;
+  }
+
+  if (stream->skipped) {
+    GST_DEBUG_OBJECT (src, "skipping stream %p", stream);
+    return FALSE;
+  }
+
+  /* see if we need to configure this stream */
+  if (!gst_rtsp_ext_list_configure_stream (src->extensions, caps)) {
+    GST_DEBUG_OBJECT (src, "skipping stream %p, disabled by extension",
+        stream);
+    return FALSE;
+  }
+
+  g_signal_emit (src, gst_rtspsrc_signals[SIGNAL_SELECT_STREAM], 0,
+      stream->id, caps, &selected);
+  if (!selected) {
+    GST_DEBUG_OBJECT (src, "skipping stream %p, disabled by signal", stream);
+    return FALSE;
+  }
+
+  /* merge/overwrite global caps */
+  if (caps) {
+    guint j, num;
+    GstStructure *s;
+
+    s = gst_caps_get_structure (caps, 0);
+
+    num = gst_structure_n_fields (src->props);
+    for (j = 0; j < num; j++) {
+      const gchar *name;
+      const GValue *val;
+
+      name = gst_structure_nth_field_name (src->props, j);
+      val = gst_structure_get_value (src->props, name);
+      gst_structure_set_value (s, name, val);
+
+      GST_DEBUG_OBJECT (src, "copied %s", name);
+    }
+  }
+
+  /* skip setup if we have no URL for it */
+  if (stream->conninfo.location == NULL) {
+    GST_DEBUG_OBJECT (src, "skipping stream %p, no setup", stream);
+    return FALSE;
+  }
+
+  stream->selected = TRUE;
+
+  return TRUE;
+}
+
+/* Configure @stream with the transport of the SETUP @response. @protocols is
+ * narrowed down to the selected lower transport. Returns FALSE when the
+ * server did not select any transport. */
+static gboolean
+gst_rtspsrc_stream_setup_response (GstRTSPSrc * src, GstRTSPStream * stream,
+    GList * walk, GstRTSPMessage * response, GstRTSPLowerTrans * protocols,
+    gint retry, gint * rtpport, gint * rtcpport)
+{
+  gchar *resptrans = NULL;
+  GstRTSPTransport transport = { 0 };
+  GList *skip;
+
+  gst_rtsp_message_get_header (response, GST_RTSP_HDR_TRANSPORT,
+      &resptrans, 0);
+  if (!resptrans) {
+    gst_rtspsrc_stream_free_udp (stream);
+    return FALSE;
+  }
+
+  /* parse transport, go to next stream on parse error */
+  if (gst_rtsp_transport_parse (resptrans, &transport) != GST_RTSP_OK) {
+    GST_WARNING_OBJECT (src, "failed to parse transport %s", resptrans);
+    goto done;
+  }
+
+  /* update allowed transports for other streams. once the transport of
+   * one stream has been determined, we make sure that all other streams
+   * are configured in the same way */
+  switch (transport.lower_transport) {
+    case GST_RTSP_LOWER_TRANS_TCP:
+      GST_DEBUG_OBJECT (src, "stream %p as TCP interleaved", stream);
+      *protocols = GST_RTSP_LOWER_TRANS_TCP;
+      src->interleaved = TRUE;
+      /* update free channels */
+      src->free_channel = MAX (transport.interleaved.min, src->free_channel);
+      src->free_channel = MAX (transport.interleaved.max, src->free_channel);
+      src->free_channel++;
+      break;
+    case GST_RTSP_LOWER_TRANS_UDP_MCAST:
+      /* only allow multicast for other streams */
+      GST_DEBUG_OBJECT (src, "stream %p as UDP multicast", stream);
+      *protocols = GST_RTSP_LOWER_TRANS_UDP_MCAST;
+      /* if the server selected our ports, increment our counters so that
+       * we select a new port later */
+      if (src->next_port_num == transport.port.min &&
+          src->next_port_num + 1 == transport.port.max) {
+        src->next_port_num += 2;
+      }
+      break;
+    case GST_RTSP_LOWER_TRANS_UDP:
+      /* only allow unicast for other streams */
+      GST_DEBUG_OBJECT (src, "stream %p as UDP unicast", stream);
+      *protocols = GST_RTSP_LOWER_TRANS_UDP;
+      break;
+    default:
+      GST_DEBUG_OBJECT (src, "stream %p unknown transport %d", stream,
+          transport.lower_transport);
+      break;
+  }
+
+  if (!src->interleaved || !retry) {
+    /* now configure the stream with the selected transport */
+    if (!gst_rtspsrc_stream_configure_transport (stream, &transport)) {
+      GST_DEBUG_OBJECT (src,
+          "could not configure stream %p transport, skipping stream", stream);
+      goto done;
+    } else if (stream->udpsrc[0] && stream->udpsrc[1]) {
+      /* retain the first allocated UDP port pair */
+      g_object_get (G_OBJECT (stream->udpsrc[0]), "port", rtpport, NULL);
+      g_object_get (G_OBJECT (stream->udpsrc[1]), "port", rtcpport, NULL);
+    }
+  }
+  /* we need to activate at least one streams when we detect activity */
+  src->need_activate = TRUE;
+
+  /* stream is setup now */
+  stream->setup = TRUE;
+
+  for (skip = g_list_next (walk); skip; skip = g_list_next (skip)) {
+    GstRTSPStream *sskip = (GstRTSPStream *) skip->data;
+
+    /* skip all streams with the same control url */
+    if (g_str_equal (stream->conninfo.location, sskip->conninfo.location)) {
+      GST_DEBUG_OBJECT (src, "found stream %p with same control %s",
+          sskip, sskip->conninfo.location);
+      sskip->skipped = TRUE;
+    }
+  }
+
+done:
+  /* clean up our transport struct */
+  gst_rtsp_transport_init (&transport);
+
+  return TRUE;
+}
+
+/* Builds a SETUP request for @stream offering the @protocols transport. */
+static GstRTSPResult
+gst_rtspsrc_stream_make_setup (GstRTSPSrc * src, GstRTSPStream * stream,
+    GstRTSPLowerTrans protocols, gint rtpport, gint rtcpport,
+    GstRTSPMessage * request)
+{
+  GstRTSPResult res;
+  gchar *transports = NULL;
+  gchar *hval;
+
+  res = gst_rtspsrc_create_transports_string (src, protocols, stream->profile,
+      &transports);
+  if (res < 0 || transports == NULL || strlen (transports) == 0) {
+    g_free (transports);
+    return GST_RTSP_ERROR;
+  }
+
+  /* replace placeholders with real values, this function will optionally
+   * allocate UDP ports and other info needed to execute the setup request */
+  res = gst_rtspsrc_prepare_transports (stream, &transports, rtpport,
+      rtcpport);
+  if (res < 0) {
+    g_free (transports);
+    return res;
+  }
+
+  res = gst_rtspsrc_init_request (src, request, GST_RTSP_SETUP,
+      stream->conninfo.location);
+  if (res < 0) {
+    g_free (transports);
+    return res;
+  }
+
+  gst_rtsp_message_take_header (request, GST_RTSP_HDR_TRANSPORT, transports);
+
+  /* set up keys */
+  if (stream->profile == GST_RTSP_PROFILE_SAVP ||
+      stream->profile == GST_RTSP_PROFILE_SAVPF) {
+    hval = gst_rtspsrc_stream_make_keymgmt (src, stream);
+    gst_rtsp_message_take_header (request, GST_RTSP_HDR_KEYMGMT, hval);
+  }
+
+  /* if the user wants a non default RTP packet size we add the blocksize
+   * parameter */
+  if (src->rtp_blocksize > 0) {
+    hval = g_strdup_printf ("%d", src->rtp_blocksize);
+    gst_rtsp_message_take_header (request, GST_RTSP_HDR_BLOCKSIZE, hval);
+  }
+
+  return GST_RTSP_OK;
+}
+
+typedef struct
+{
+  GstRTSPStream *stream;
+  GList *walk;
+  GstRTSPMessage request;
+  gint cseq;
+} GstRTSPPendingSetup;
+
+/* Sends the SETUP requests of all remaining streams after @walk at once and
+ * then collects the responses, instead of waiting a round-trip per stream.
+ * The transport is known from the first SETUP by now. Streams that could not
+ * be set up this way are left for the regular sequential SETUP, which also
+ * handles authentication and transport fallbacks. */
+static GstRTSPResult
+gst_rtspsrc_setup_streams_pipelined (GstRTSPSrc * src, GList * walk,
+    GstRTSPConnection * conn, GstRTSPLowerTrans * protocols, gint * rtpport,
+    gint * rtcpport)
+{
+  GstRTSPResult res = GST_RTSP_OK;
+  GArray *pending;
+  GList *l;
+  guint i, n_received = 0;
+
+  pending = g_array_new (FALSE, TRUE, sizeof (GstRTSPPendingSetup));
+
+  for (l = g_list_next (walk); l; l = g_list_next (l)) {
+    GstRTSPStream *stream = (GstRTSPStream *) l->data;
+    GstRTSPPendingSetup setup = { 0, };
+    GstRTSPLowerTrans trans = *protocols;
+    gchar *hval = NULL;
+    gboolean dup = FALSE;
+    guint mask = 0;
+
+    if (stream->setup || !gst_rtspsrc_stream_is_selected (src, stream))
+      continue;
+
+    /* streams with the same control url are set up only once */
+    for (i = 0; i < pending->len; i++) {
+      GstRTSPPendingSetup *p = &g_array_index (pending, GstRTSPPendingSetup, i);
+
+      if (g_str_equal (p->stream->conninfo.location,
+              stream->conninfo.location))
+        dup = TRUE;
+    }
+    if (dup)
+      continue;
+
+    if (stream->is_multicast)
+      trans &= GST_RTSP_LOWER_TRANS_UDP_MCAST;
+
+    /* first selectable protocol */
+    while (protocol_masks[mask] && !(trans & protocol_masks[mask]))
+      mask++;
+    if (!protocol_masks[mask])
+      continue;
+
+    if (gst_rtspsrc_stream_make_setup (src, stream, protocol_masks[mask], 0, 0,
+            &setup.request) < 0) {
+      gst_rtsp_message_unset (&setup.request);
+      gst_rtspsrc_stream_free_udp (stream);
+      continue;
+    }
+
+    if (!src->short_header)
+      gst_rtsp_ext_list_before_send (src->extensions, &setup.request);
+
+    GST_DEBUG_OBJECT (src, "sending pipelined setup of stream %p with %s",
+        stream, stream->conninfo.location);
+
+    if (src->debug)
+      gst_rtsp_message_dump (&setup.request);
+
+    res = gst_rtspsrc_connection_send (src, conn, &setup.request,
+        src->ptcp_timeout);
+    if (res < 0) {
+      gst_rtsp_message_unset (&setup.request);
+      gst_rtspsrc_stream_free_udp (stream);
+      goto done;
+    }
+
+    /* the connection filled in the CSeq, keep it to match the response */
+    gst_rtsp_message_get_header (&setup.request, GST_RTSP_HDR_CSEQ, &hval, 0);
+    setup.cseq = hval ? atoi (hval) : -1;
+    setup.stream = stream;
+    setup.walk = l;
+    g_array_append_val (pending, setup);
+  }
+
+  if (pending->len > 0)
+    GST_DEBUG_OBJECT (src, "waiting for %u pipelined setups", pending->len);
+
+  /* responses come in the order of the requests */
+  while (n_received < pending->len) {
+    GstRTSPPendingSetup *setup;
+    GstRTSPMessage response = { 0 };
+    gchar *hval = NULL;
+
+    res = gst_rtspsrc_connection_receive (src, conn, &response,
+        src->ptcp_timeout);
+    if (res < 0)
+      goto done;
+
+    if (src->debug)
+      gst_rtsp_message_dump (&response);
+
+    switch (response.type) {
+      case GST_RTSP_MESSAGE_REQUEST:
+        res = gst_rtspsrc_handle_request (src, conn, &response);
+        gst_rtsp_message_unset (&response);
+        if (res < 0)
+          goto done;
+        continue;
+      case GST_RTSP_MESSAGE_RESPONSE:
+        break;
+      case GST_RTSP_MESSAGE_DATA:
+        gst_rtspsrc_handle_data (src, &response);
+        continue;
+      default:
+        GST_WARNING_OBJECT (src, "ignoring unknown message type %d",
+            response.type);
+        gst_rtsp_message_unset (&response);
+        continue;
+    }
+
+    setup = &g_array_index (pending, GstRTSPPendingSetup, n_received++);
+
+    gst_rtsp_message_get_header (&response, GST_RTSP_HDR_CSEQ, &hval, 0);
+    if (hval == NULL || atoi (hval) != setup->cseq) {
+      GST_WARNING_OBJECT (src, "unexpected response CSeq %s, expected %d",
+          GST_STR_NULL (hval), setup->cseq);
+      gst_rtspsrc_stream_free_udp (setup->stream);
+    } else if (response.type_data.response.code != GST_RTSP_STS_OK) {
+      GST_DEBUG_OBJECT (src, "pipelined setup of stream %p failed: %d",
+          setup->stream, response.type_data.response.code);
+      gst_rtspsrc_stream_free_udp (setup->stream);
+    } else {
+      gst_rtsp_ext_list_after_send (src->extensions, &setup->request,
+          &response);
+      if (!gst_rtspsrc_stream_setup_response (src, setup->stream,
+              setup->walk, &response, protocols, 0, rtpport, rtcpport))
+        GST_WARNING_OBJECT (src, "server did not select transport for "
+            "stream %p", setup->stream);
+    }
+    gst_rtsp_message_unset (&response);
+  }
+
+done:
+  for (i = 0; i < pending->len; i++) {
+    GstRTSPPendingSetup *setup = &g_array_index (pending, GstRTSPPendingSetup,
+        i);
+
+    /* no response, let the sequential setup try again */
+    if (i >= n_received)
+      gst_rtspsrc_stream_free_udp (setup->stream);
+    gst_rtsp_message_unset (&setup->request);
+  }
+  g_array_free (pending, TRUE);
+
+  return res;
+}
+
 /* Perform the SETUP request for all the streams.
  *
  * We ask the server for a specific transport, which initially includes all the
@@ -6031,6 +6433,7 @@ gst_rtspsrc_setup_streams (GstRTSPSrc * src, gboolean async)
   GstRTSPLowerTrans protocols;
   GstRTSPStatusCode code;
   gboolean unsupported_real = FALSE;
+  gboolean pipelined = FALSE;
   gint rtpport, rtcpport;
   GstRTSPUrl *url;
   gchar *hval;
@@ -6064,61 +6467,15 @@ gst_rtspsrc_setup_streams (GstRTSPSrc * src, gboolean async)
     gchar *transports;
     gint retry = 0;
     guint mask = 0;
-    gboolean selected;
-    GstCaps *caps;
 
     stream = (GstRTSPStream *) walk->data;
 
-    caps = stream_get_caps_for_pt (stream, stream->default_pt);
-    if (caps == NULL) {
-      GST_DEBUG_OBJECT (src, "skipping stream %p, no caps", stream);
-      continue;
-    }
-
-    if (stream->skipped) {
-      GST_DEBUG_OBJECT (src, "skipping stream %p", stream);
+    /* already done together with a previous stream */
+    if (stream->setup)
       continue;
-    }
 
-    /* see if we need to configure this stream */
-    if (!gst_rtsp_ext_list_configure_stream (src->extensions, caps)) {
-      GST_DEBUG_OBJECT (src, "skipping stream %p, disabled by extension",
-          stream);
+    if (!gst_rtspsrc_stream_is_selected (src, stream))
       continue;
-    }
-
-    g_signal_emit (src, gst_rtspsrc_signals[SIGNAL_SELECT_STREAM], 0,
-        stream->id, caps, &selected);
-    if (!selected) {
-      GST_DEBUG_OBJECT (src, "skipping stream %p, disabled by signal", stream);
-      continue;
-    }
-
-    /* merge/overwrite global caps */
-    if (caps) {
-      guint j, num;
-      GstStructure *s;
-
-      s = gst_caps_get_structure (caps, 0);
-
-      num = gst_structure_n_fields (src->props);
-      for (j = 0; j < num; j++) {
-        const gchar *name;
-        const GValue *val;
-
-        name = gst_structure_nth_field_name (src->props, j);
-        val = gst_structure_get_value (src->props, name);
-        gst_structure_set_value (s, name, val);
-
-        GST_DEBUG_OBJECT (src, "copied %s", name);
-      }
-    }
-
-    /* skip setup if we have no URL for it */
-    if (stream->conninfo.location == NULL) {
-      GST_DEBUG_OBJECT (src, "skipping stream %p, no setup", stream);
-      continue;
-    }
 
     if (src->conninfo.connection == NULL) {
       if (!gst_rtsp_conninfo_connect (src, &stream->conninfo, async)) {
@@ -6245,104 +6602,23 @@ gst_rtspsrc_setup_streams (GstRTSPSrc * src, gboolean async)
     }
 
     /* parse response transport */
-    {
-      gchar *resptrans = NULL;
-      GstRTSPTransport transport = { 0 };
+    if (!gst_rtspsrc_stream_setup_response (src, stream, walk, &response,
+            &protocols, retry, &rtpport, &rtcpport))
+      goto no_transport;
 
-      gst_rtsp_message_get_header (&response, GST_RTSP_HDR_TRANSPORT,
-          &resptrans, 0);
-      if (!resptrans) {
-        gst_rtspsrc_stream_free_udp (stream);
-        goto no_transport;
-      }
-
-      /* parse transport, go to next stream on parse error */
-      if (gst_rtsp_transport_parse (resptrans, &transport) != GST_RTSP_OK) {
-        GST_WARNING_OBJECT (src, "failed to parse transport %s", resptrans);
-        goto next;
-      }
-
-      /* update allowed transports for other streams. once the transport of
-       * one stream has been determined, we make sure that all other streams
-       * are configured in the same way */
-      switch (transport.lower_transport) {
-        case GST_RTSP_LOWER_TRANS_TCP:
-          GST_DEBUG_OBJECT (src, "stream %p as TCP interleaved", stream);
-          protocols = GST_RTSP_LOWER_TRANS_TCP;
-          src->interleaved = TRUE;
-          /* update free channels */
-          src->free_channel =
-              MAX (transport.interleaved.min, src->free_channel);
-          src->free_channel =
-              MAX (transport.interleaved.max, src->free_channel);
-          src->free_channel++;
-          break;
-        case GST_RTSP_LOWER_TRANS_UDP_MCAST:
-          /* only allow multicast for other streams */
-          GST_DEBUG_OBJECT (src, "stream %p as UDP multicast", stream);
-          protocols = GST_RTSP_LOWER_TRANS_UDP_MCAST;
-          /* if the server selected our ports, increment our counters so that
-           * we select a new port later */
-          if (src->next_port_num == transport.port.min &&
-              src->next_port_num + 1 == transport.port.max) {
-            src->next_port_num += 2;
-          }
-          break;
-        case GST_RTSP_LOWER_TRANS_UDP:
-          /* only allow unicast for other streams */
-          GST_DEBUG_OBJECT (src, "stream %p as UDP unicast", stream);
-          protocols = GST_RTSP_LOWER_TRANS_UDP;
-          break;
-        default:
-          GST_DEBUG_OBJECT (src, "stream %p unknown transport %d", stream,
-              transport.lower_transport);
-          break;
-      }
-
-      if (!src->interleaved || !retry) {
-        /* now configure the stream with the selected transport */
-        if (!gst_rtspsrc_stream_configure_transport (stream, &transport)) {
-          GST_DEBUG_OBJECT (src,
-              "could not configure stream %p transport, skipping stream",
-              stream);
-          goto next;
-        } else if (stream->udpsrc[0] && stream->udpsrc[1]) {
-          /* retain the first allocated UDP port pair */
-          g_object_get (G_OBJECT (stream->udpsrc[0]), "port", &rtpport, NULL);
-          g_object_get (G_OBJECT (stream->udpsrc[1]), "port", &rtcpport, NULL);
-        }
-      }
-      /* we need to activate at least one streams when we detect activity */
-      src->need_activate = TRUE;
-
-      /* stream is setup now */
-      stream->setup = TRUE;
-      {
-        GList *skip = walk;
-
-        while (TRUE) {
-          GstRTSPStream *sskip;
-
-          skip = g_list_next (skip);
-          if (skip == NULL)
-            break;
-
-          sskip = (GstRTSPStream *) skip->data;
+    /* clean up used RTSP messages */
+    gst_rtsp_message_unset (&request);
+    gst_rtsp_message_unset (&response);
 
-          /* skip all streams with the same control url */
-          if (g_str_equal (stream->conninfo.location, sskip->conninfo.location)) {
-            GST_DEBUG_OBJECT (src, "found stream %p with same control %s",
-                sskip, sskip->conninfo.location);
-            sskip->skipped = TRUE;
-          }
-        }
-      }
-    next:
-      /* clean up our transport struct */
-      gst_rtsp_transport_init (&transport);
-      /* clean up used RTSP messages */
-      gst_rtsp_message_unset (&request);
-      gst_rtsp_message_unset (&response);
+    /* with the transport and session known, send the SETUP of all the other
+     * streams in one go */
+    if (src->fast_start && stream->setup && !pipelined &&
+        conn == src->conninfo.connection) {
+      pipelined = TRUE;
+      res = gst_rtspsrc_setup_streams_pipelined (src, walk, conn, &protocols,
+          &rtpport, &rtcpport);
+      if (res < 0)
+        goto send_error;
     }
   }
 
@@ -6709,6 +6985,16 @@ restart:
   if ((res = gst_rtsp_conninfo_connect (src, &src->conninfo, async)) < 0)
     goto connect_failed;
 
+  if (src->fast_start) {
+    /* save a round-trip, DESCRIBE fails anyway when the server is not
+     * usable */
+    GST_DEBUG_OBJECT (src, "fast start, not sending options");
+    src->methods = GST_RTSP_DESCRIBE | GST_RTSP_SETUP | GST_RTSP_PLAY |
+        GST_RTSP_PAUSE | GST_RTSP_TEARDOWN;
+    src->seekable = TRUE;
+    goto describe;
+  }
+
   /* create OPTIONS */
   GST_DEBUG_OBJECT (src, "create options...");
   res =
@@ -6732,6 +7018,7 @@ restart:
   if (!gst_rtspsrc_parse_methods (src, &response))
     goto methods_error;
 
+describe:
   /* create DESCRIBE */
   GST_DEBUG_OBJECT (src, "create describe...");
   res =
@@ -101,6 +101,7 @@ struct _GstRTSPStream {
   gboolean      added;
   gboolean      setup;
   gboolean      skipped;
+  gboolean      selected;
   gboolean      eos;
   gboolean      discont;
   gboolean      need_caps;
@@ -244,6 +245,7 @@ struct _GstRTSPSrc {
   gchar            *user_agent;
   GstClockTime      max_rtcp_rtp_time_diff;
   gboolean          rfc7273_sync;
+  gboolean          fast_start;
 
   /* state */
   GstRTSPState       state;
@@ -41,7 +41,9 @@
 
 #ifndef G_OS_WIN32
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #endif
+#include <time.h>
 
 #include "gst/glib-compat-private.h"
 
@@ -50,6 +52,13 @@ GST_DEBUG_CATEGORY_STATIC (multiudpsink_debug);
 
 #define UDP_MAX_SIZE 65507
 
+/* maximum number of segments the kernel accepts in one GSO send */
+#define UDP_MAX_SEGMENTS 64
+
+#if defined (UDP_SEGMENT) || (defined (SO_TXTIME) && defined (SCM_TXTIME))
+#define HAVE_UDP_CONTROL_MESSAGE
+#endif
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -90,6 +99,8 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_GSO                FALSE
+#define DEFAULT_PACING             FALSE
 
 enum
 {
@@ -112,7 +123,9 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_GSO,
+  PROP_PACING
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -349,6 +362,34 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
       g_param_spec_int ("bind-port", "Bind Port",
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstMultiUDPSink:gso:
+   *
+   * Send runs of equally sized packets of a buffer list as one UDP
+   * segmentation offload (UDP_SEGMENT) send, which the kernel or the network
+   * card splits into the individual datagrams again. Ignored when not
+   * supported by the system.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO,
+      g_param_spec_boolean ("gso", "GSO",
+          "Use UDP segmentation offload for equally sized packets",
+          DEFAULT_GSO, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstMultiUDPSink:pacing:
+   *
+   * Give every packet a transmit time (SO_TXTIME) derived from its buffer
+   * timestamp, so that a pacing queueing discipline such as fq spreads the
+   * packets according to their timestamps instead of sending them in bursts.
+   * Ignored when not supported by the system.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PACING,
+      g_param_spec_boolean ("pacing", "Pacing",
+          "Let the kernel send packets at the time of their timestamps",
+          DEFAULT_PACING, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
@@ -418,6 +459,8 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
+  sink->gso = DEFAULT_GSO;
+  sink->pacing = DEFAULT_PACING;
 
   gst_multiudpsink_create_cancellable (sink);
 
@@ -553,6 +596,8 @@ gst_multiudpsink_finalize (GObject * object)
   sink->maps = NULL;
   g_free (sink->messages);
   sink->messages = NULL;
+  g_free (sink->ctrl_msgs);
+  sink->ctrl_msgs = NULL;
 
   g_free (sink->bind_address);
   sink->bind_address = NULL;
@@ -601,6 +646,127 @@ gst_socket_send_messages (GSocket * socket, GstOutputMessage * messages,
 }
 #endif /* HAVE_G_SOCKET_SEND_MESSAGES */
 
+#ifdef HAVE_UDP_CONTROL_MESSAGE
+/* minimal control message carrying a UDP_SEGMENT or SCM_TXTIME value, GIO
+ * only provides control messages for credentials and file descriptors */
+#define GST_TYPE_UDP_CONTROL_MESSAGE (gst_udp_control_message_get_type ())
+#define GST_UDP_CONTROL_MESSAGE(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_UDP_CONTROL_MESSAGE, \
+      GstUDPControlMessage))
+
+typedef struct
+{
+  GSocketControlMessage parent;
+
+  gint level;
+  gint type;
+  gsize size;
+  union
+  {
+    guint16 gso_size;
+    guint64 txtime;
+  } data;
+} GstUDPControlMessage;
+
+typedef struct
+{
+  GSocketControlMessageClass parent_class;
+} GstUDPControlMessageClass;
+
+static GType gst_udp_control_message_get_type (void);
+
+G_DEFINE_TYPE (GstUDPControlMessage, gst_udp_control_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_control_message_get_size (GSocketControlMessage * message)
+{
+  return GST_UDP_CONTROL_MESSAGE (message)->size;
+}
+
+static gint
+gst_udp_control_message_get_level (GSocketControlMessage * message)
+{
+  return GST_UDP_CONTROL_MESSAGE (message)->level;
+}
+
+static gint
+gst_udp_control_message_get_msg_type (GSocketControlMessage * message)
+{
+  return GST_UDP_CONTROL_MESSAGE (message)->type;
+}
+
+static void
+gst_udp_control_message_serialize (GSocketControlMessage * message,
+    gpointer data)
+{
+  GstUDPControlMessage *msg = GST_UDP_CONTROL_MESSAGE (message);
+
+  memcpy (data, &msg->data, msg->size);
+}
+
+/* we only send these, never parse received ones */
+static GSocketControlMessage *
+gst_udp_control_message_deserialize (gint level, gint type, gsize size,
+    gpointer data)
+{
+  return NULL;
+}
+
+static void
+gst_udp_control_message_class_init (GstUDPControlMessageClass * klass)
+{
+  GSocketControlMessageClass *scm_class = (GSocketControlMessageClass *) klass;
+
+  scm_class->get_size = gst_udp_control_message_get_size;
+  scm_class->get_level = gst_udp_control_message_get_level;
+  scm_class->get_type = gst_udp_control_message_get_msg_type;
+  scm_class->serialize = gst_udp_control_message_serialize;
+  scm_class->deserialize = gst_udp_control_message_deserialize;
+}
+
+static void
+gst_udp_control_message_init (GstUDPControlMessage * msg)
+{
+}
+#endif /* HAVE_UDP_CONTROL_MESSAGE */
+
+static void
+gst_multiudpsink_clear_control_messages (GstMultiUDPSink * sink)
+{
+  guint i;
+
+  for (i = 0; i < sink->n_ctrl_msgs_used; ++i)
+    g_object_unref (sink->ctrl_msgs[i]);
+  sink->n_ctrl_msgs_used = 0;
+}
+
+#if defined (SO_TXTIME) && defined (SCM_TXTIME)
+/* offset to add to a running time to get the CLOCK_MONOTONIC time at which
+ * it should go out, returns FALSE if there is no clock */
+static gboolean
+gst_multiudpsink_get_txtime_offset (GstMultiUDPSink * sink, gint64 * offset)
+{
+  GstBaseSink *bsink = GST_BASE_SINK_CAST (sink);
+  GstClock *clock;
+  GstClockTime now;
+
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (sink));
+  if (clock == NULL)
+    return FALSE;
+  now = gst_clock_get_time (clock);
+  gst_object_unref (clock);
+
+  *offset = g_get_monotonic_time () * GST_USECOND - (gint64) now +
+      gst_element_get_base_time (GST_ELEMENT_CAST (sink)) +
+      gst_base_sink_get_latency (bsink) +
+      gst_base_sink_get_render_delay (bsink) +
+      gst_base_sink_get_ts_offset (bsink);
+
+  return TRUE;
+}
+#endif
+
 static gsize
 fill_vectors (GOutputVector * vecs, GstMapInfo * maps, guint n, GstBuffer * buf)
 {
@@ -638,6 +804,120 @@ gst_udp_calc_message_size (GstOutputMessage * msg)
   return size;
 }
 
+/* Merges runs of equally sized packets of the first @num_buffers messages into
+ * GSO sends and attaches the transmit times, as far as enabled. Returns the
+ * number of messages left. */
+static guint
+gst_multiudpsink_prepare_messages (GstMultiUDPSink * sink,
+    GstBuffer ** buffers, GstOutputMessage * msgs, guint num_buffers)
+{
+  guint64 *txtimes = NULL;
+  guint i, k, n;
+
+  if (!sink->gso_active && !sink->txtime_active)
+    return num_buffers;
+
+#if defined (SO_TXTIME) && defined (SCM_TXTIME)
+  if (sink->txtime_active) {
+    GstSegment *segment = &GST_BASE_SINK_CAST (sink)->segment;
+    guint64 now = g_get_monotonic_time () * GST_USECOND;
+    gint64 offset;
+
+    if (segment->format == GST_FORMAT_TIME &&
+        gst_multiudpsink_get_txtime_offset (sink, &offset)) {
+      guint64 txtime = 0;
+
+      txtimes = g_newa (guint64, num_buffers);
+      for (i = 0; i < num_buffers; ++i) {
+        GstClockTime ts = GST_BUFFER_DTS_OR_PTS (buffers[i]);
+
+        /* buffers without timestamp go out together with the previous one */
+        if (GST_CLOCK_TIME_IS_VALID (ts)) {
+          ts = gst_segment_to_running_time (segment, GST_FORMAT_TIME, ts);
+          if (GST_CLOCK_TIME_IS_VALID (ts) && (gint64) ts + offset > 0)
+            txtime = ts + offset;
+        }
+        /* anything in the past is sent right away */
+        txtimes[i] = txtime > now ? txtime : 0;
+      }
+    }
+  }
+#endif
+
+  if (sink->n_ctrl_msgs < 2 * num_buffers) {
+    sink->n_ctrl_msgs = GST_ROUND_UP_16 (2 * num_buffers);
+    g_free (sink->ctrl_msgs);
+    sink->ctrl_msgs = g_new (GSocketControlMessage *, sink->n_ctrl_msgs);
+  }
+
+  for (i = 0, n = 0; i < num_buffers; i = k, ++n) {
+    GstOutputMessage *msg = &msgs[n];
+    GSocketControlMessage **ctrl_msgs;
+    gsize seg_size, total;
+
+    seg_size = total = gst_udp_calc_message_size (&msgs[i]);
+    *msg = msgs[i];
+
+    /* the vectors of consecutive messages are consecutive as well, so the
+     * segments of a run only need to be appended to the first message */
+    for (k = i + 1; sink->gso_active && seg_size > 0 && k < num_buffers &&
+        k - i < UDP_MAX_SEGMENTS; ++k) {
+      gsize size = gst_udp_calc_message_size (&msgs[k]);
+
+      if (size == 0 || size > seg_size || total + size > UDP_MAX_SIZE)
+        break;
+      if (txtimes != NULL && txtimes[k] != txtimes[i])
+        break;
+
+      msg->num_vectors += msgs[k].num_vectors;
+      total += size;
+
+      /* only the last segment can be shorter */
+      if (size < seg_size) {
+        ++k;
+        break;
+      }
+    }
+
+    ctrl_msgs = &sink->ctrl_msgs[sink->n_ctrl_msgs_used];
+    msg->num_control_messages = 0;
+
+#ifdef UDP_SEGMENT
+    if (k - i > 1) {
+      GstUDPControlMessage *cmsg;
+
+      cmsg = g_object_new (GST_TYPE_UDP_CONTROL_MESSAGE, NULL);
+      cmsg->level = IPPROTO_UDP;
+      cmsg->type = UDP_SEGMENT;
+      cmsg->size = sizeof (guint16);
+      cmsg->data.gso_size = seg_size;
+      ctrl_msgs[msg->num_control_messages++] = G_SOCKET_CONTROL_MESSAGE (cmsg);
+    }
+#endif
+#if defined (SO_TXTIME) && defined (SCM_TXTIME)
+    if (txtimes != NULL && txtimes[i] != 0) {
+      GstUDPControlMessage *cmsg;
+
+      cmsg = g_object_new (GST_TYPE_UDP_CONTROL_MESSAGE, NULL);
+      cmsg->level = SOL_SOCKET;
+      cmsg->type = SCM_TXTIME;
+      cmsg->size = sizeof (guint64);
+      cmsg->data.txtime = txtimes[i];
+      ctrl_msgs[msg->num_control_messages++] = G_SOCKET_CONTROL_MESSAGE (cmsg);
+    }
+#endif
+
+    sink->n_ctrl_msgs_used += msg->num_control_messages;
+    msg->control_messages =
+        msg->num_control_messages > 0 ? ctrl_msgs : NULL;
+  }
+
+  if (n < num_buffers)
+    GST_LOG_OBJECT (sink, "merged %u packets into %u sends", num_buffers, n);
+
+  return n;
+}
+
 static gint
 gst_udp_messsages_find_first_not_sent (GstOutputMessage * messages,
     guint num_messages)
@@ -705,6 +985,12 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
           gst_udp_address_get_string (msg->address, astr, sizeof (astr)),
           err->message);
 
+      /* e.g. a segment size above the path MTU, don't try again */
+      if (sink->gso_active && msg->num_control_messages > 0) {
+        GST_WARNING_OBJECT (sink, "GSO send failed, disabling GSO");
+        sink->gso_active = FALSE;
+      }
+
       skip = 1;
       if (msg_size > UDP_MAX_SIZE) {
         if (!sent_max_size_warning) {
@@ -752,7 +1038,7 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   GstMapInfo *map_infos;
   GstFlowReturn flow_ret;
   guint num_addr_v4, num_addr_v6;
-  guint num_addr, num_msgs;
+  guint num_addr, num_msgs, num_packets;
   GError *err = NULL;
   guint i, j, mem;
   gsize size = 0;
@@ -826,12 +1112,16 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   /* FIXME: how about some locking? (there wasn't any before either, but..) */
   sink->bytes_to_serve += size;
 
-  /* now copy the pre-filled num_buffer messages over to the next num_buffer
+  num_packets = gst_multiudpsink_prepare_messages (sink, buffers, msgs,
+      num_buffers);
+  num_msgs = num_addr * num_packets;
+
+  /* now copy the pre-filled num_packets messages over to the next num_packets
    * messages for the next client, where we also change the target adddress */
   for (i = 1; i < num_addr; ++i) {
-    for (j = 0; j < num_buffers; ++j) {
-      msgs[i * num_buffers + j] = msgs[j];
-      msgs[i * num_buffers + j].address = clients[i]->addr;
+    for (j = 0; j < num_packets; ++j) {
+      msgs[i * num_packets + j] = msgs[j];
+      msgs[i * num_packets + j].address = clients[i]->addr;
     }
   }
 
@@ -844,8 +1134,8 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
       ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
           msgs, num_msgs);
     } else {
-      guint num_msgs_v4 = num_buffers * num_addr_v4;
-      guint num_msgs_v6 = num_buffers * num_addr_v6;
+      guint num_msgs_v4 = num_packets * num_addr_v4;
+      guint num_msgs_v6 = num_packets * num_addr_v6;
 
       /* our client list is sorted with IPv4 clients first and IPv6 ones last */
       ret = gst_multiudpsink_send_messages (sink, sink->used_socket,
@@ -870,15 +1160,15 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   for (i = 0; i < num_addr; ++i) {
     GstUDPClient *client = clients[i];
 
-    for (j = 0; j < num_buffers; ++j) {
+    for (j = 0; j < num_packets; ++j) {
       gsize bytes_sent;
 
-      bytes_sent = msgs[i * num_buffers + j].bytes_sent;
+      bytes_sent = msgs[i * num_packets + j].bytes_sent;
 
       client->bytes_sent += bytes_sent;
-      client->packets_sent++;
       sink->bytes_served += bytes_sent;
     }
+    client->packets_sent += num_buffers;
     gst_udp_client_unref (client);
   }
 
@@ -886,6 +1176,8 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
 
 out:
 
+  gst_multiudpsink_clear_control_messages (sink);
+
   for (i = 0; i < mem; ++i)
     gst_memory_unmap (map_infos[i].memory, &map_infos[i]);
 
@@ -1025,6 +1317,56 @@ gst_multiudpsink_get_clients_string (GstMultiUDPSink * sink)
   return g_string_free (str, FALSE);
 }
 
+/* check that the socket can do UDP_SEGMENT and SO_TXTIME as requested, clears
+ * gso_active and txtime_active otherwise */
+static void
+gst_multiudpsink_setup_offloads (GstMultiUDPSink * sink, GSocket * socket)
+{
+  gint fd G_GNUC_UNUSED;
+
+  if (socket == NULL)
+    return;
+
+  fd = g_socket_get_fd (socket);
+
+  if (sink->gso_active) {
+#ifdef UDP_SEGMENT
+    gint val = 0;
+    socklen_t len = sizeof (val);
+
+    if (getsockopt (fd, IPPROTO_UDP, UDP_SEGMENT, &val, &len) < 0) {
+      GST_WARNING_OBJECT (sink, "UDP segmentation offload not supported: %s",
+          g_strerror (errno));
+      sink->gso_active = FALSE;
+    }
+#else
+    GST_WARNING_OBJECT (sink, "UDP segmentation offload not supported");
+    sink->gso_active = FALSE;
+#endif
+  }
+
+  if (sink->txtime_active) {
+#if defined (SO_TXTIME) && defined (SCM_TXTIME)
+    /* same layout as struct sock_txtime */
+    struct
+    {
+      clockid_t clockid;
+      guint32 flags;
+    } txtime = {
+    CLOCK_MONOTONIC, 0};
+
+    if (setsockopt (fd, SOL_SOCKET, SO_TXTIME, &txtime, sizeof (txtime)) < 0) {
+      GST_WARNING_OBJECT (sink, "could not set SO_TXTIME: %s",
+          g_strerror (errno));
+      sink->txtime_active = FALSE;
+    }
+#else
+    GST_WARNING_OBJECT (sink, "SO_TXTIME not supported");
+    sink->txtime_active = FALSE;
+#endif
+  }
+}
+
 static void
 gst_multiudpsink_setup_qos_dscp (GstMultiUDPSink * sink, GSocket * socket)
 {
@@ -1148,6 +1490,12 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_GSO:
+      udpsink->gso = g_value_get_boolean (value);
+      break;
+    case PROP_PACING:
+      udpsink->pacing = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1221,6 +1569,12 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_GSO:
+      g_value_set_boolean (value, udpsink->gso);
+      break;
+    case PROP_PACING:
+      g_value_set_boolean (value, udpsink->pacing);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1486,6 +1840,11 @@ gst_multiudpsink_start (GstBaseSink * bsink)
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket);
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket_v6);
 
+  sink->gso_active = sink->gso;
+  sink->txtime_active = sink->pacing;
+  gst_multiudpsink_setup_offloads (sink, sink->used_socket);
+  gst_multiudpsink_setup_offloads (sink, sink->used_socket_v6);
+
   /* look for multicast clients and join multicast groups appropriately
      set also ttl and multicast loopback delivery appropriately  */
   for (clients = sink->clients; clients; clients = g_list_next (clients)) {
@@ -101,6 +101,13 @@ struct _GstMultiUDPSink {
   guint             n_maps;
   GstOutputMessage *messages;
   guint             n_messages;
+  GSocketControlMessage **ctrl_msgs;
+  guint             n_ctrl_msgs;
+  guint             n_ctrl_msgs_used;
+
+  /* whether UDP_SEGMENT and SO_TXTIME are usable on the sockets */
+  gboolean       gso_active;
+  gboolean       txtime_active;
 
   /* properties */
   guint64        bytes_to_serve;
@@ -122,6 +129,8 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+  gboolean       gso;
+  gboolean       pacing;
 };
 
 struct _GstMultiUDPSinkClass {
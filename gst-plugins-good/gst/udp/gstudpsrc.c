@@ -140,6 +140,9 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_REUSE              TRUE
 #define UDP_DEFAULT_LOOP               TRUE
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
+#define UDP_DEFAULT_BATCH_SIZE         1
+
+#define UDP_MAX_BATCH_SIZE             64
 
 enum
 {
@@ -160,7 +163,8 @@ enum
   PROP_REUSE,
   PROP_ADDRESS,
   PROP_LOOP,
-  PROP_RETRIEVE_SENDER_ADDRESS
+  PROP_RETRIEVE_SENDER_ADDRESS,
+  PROP_BATCH_SIZE
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -291,6 +295,25 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           "meta. Disabling this might result in minor performance improvements "
           "in certain scenarios", UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstUDPSrc::batch-size:
+   *
+   * Maximum number of packets to read from the socket with one system call.
+   * When more than one packet is available they are pushed downstream
+   * together as a #GstBufferList. This considerably reduces the per-packet
+   * overhead for high packet rates.
+   *
+   * Batching is only done on sockets created by udpsrc itself, a socket
+   * provided with the #GstUDPSrc:socket property is always read one packet
+   * at a time. It also requires GLib 2.48 or newer.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch Size",
+          "Maximum number of packets to receive with one system call and "
+          "push as a buffer list (1 = no batching)", 1, UDP_MAX_BATCH_SIZE,
+          UDP_DEFAULT_BATCH_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
@@ -331,6 +354,7 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->reuse = UDP_DEFAULT_REUSE;
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
 
   /* configure basesrc to be a live source */
   gst_base_src_set_live (GST_BASE_SRC (udpsrc), TRUE);
@@ -398,6 +422,29 @@ gst_udpsrc_getcaps (GstBaseSrc * src, GstCaps * filter)
   return result;
 }
 
+static void
+gst_udpsrc_free_packets (GstUDPSrc * src)
+{
+  guint i;
+
+  for (i = 0; i < src->n_packets; i++) {
+    GstUDPSrcPacket *packet = &src->packets[i];
+
+    if (packet->mem != NULL) {
+      gst_memory_unmap (packet->mem, &packet->map);
+      gst_memory_unref (packet->mem);
+    }
+    if (packet->mem_max != NULL) {
+      gst_memory_unmap (packet->mem_max, &packet->map_max);
+      gst_memory_unref (packet->mem_max);
+    }
+    if (packet->saddr != NULL)
+      g_object_unref (packet->saddr);
+  }
+  if (src->packets != NULL)
+    memset (src->packets, 0, src->n_packets * sizeof (GstUDPSrcPacket));
+}
+
 static void
 gst_udpsrc_reset_memory_allocator (GstUDPSrc * src)
 {
@@ -417,6 +464,8 @@ gst_udpsrc_reset_memory_allocator (GstUDPSrc * src)
   src->vec[1].buffer = NULL;
   src->vec[1].size = 0;
 
+  gst_udpsrc_free_packets (src);
+
   if (src->allocator != NULL) {
     gst_object_unref (src->allocator);
     src->allocator = NULL;
@@ -504,6 +553,41 @@ gst_udpsrc_ensure_mem (GstUDPSrc * src)
   return TRUE;
 }
 
+#if GLIB_CHECK_VERSION(2,48,0)
+/* make sure all receive slots have memory, only the slots that were used
+ * for the previous batch need new memory */
+static gboolean
+gst_udpsrc_ensure_packets_mem (GstUDPSrc * src)
+{
+  gsize mem_size = 1500;        /* typical max. MTU */
+  guint i;
+
+  if (src->max_size > 0 && src->max_size < mem_size)
+    mem_size = src->max_size;
+
+  for (i = 0; i < src->n_packets; i++) {
+    GstUDPSrcPacket *packet = &src->packets[i];
+
+    if (packet->mem == NULL) {
+      if (!gst_udpsrc_alloc_mem (src, &packet->mem, &packet->map, mem_size))
+        return FALSE;
+
+      packet->vec[0].buffer = packet->map.data;
+      packet->vec[0].size = packet->map.size;
+    }
+    if (packet->mem_max == NULL) {
+      if (!gst_udpsrc_alloc_mem (src, &packet->mem_max, &packet->map_max,
+              MAX_IPV4_UDP_PACKET_SIZE))
+        return FALSE;
+
+      packet->vec[1].buffer = packet->map_max.data;
+      packet->vec[1].size = packet->map_max.size;
+    }
+  }
+  return TRUE;
+}
+#endif
+
 static void
 gst_udpsrc_create_cancellable (GstUDPSrc * src)
 {
@@ -524,28 +608,12 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   src->cancellable = NULL;
 }
 
+/* wait until the socket is readable */
 static GstFlowReturn
-gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf)
+gst_udpsrc_wait (GstUDPSrc * udpsrc)
 {
-  GstUDPSrc *udpsrc;
-  GstBuffer *outbuf = NULL;
-  GSocketAddress *saddr = NULL;
-  GSocketAddress **p_saddr;
-  gint flags = G_SOCKET_MSG_NONE;
   gboolean try_again;
   GError *err = NULL;
-  gssize res;
-  gsize offset;
-
-  udpsrc = GST_UDPSRC_CAST (psrc);
-
-  if (!gst_udpsrc_ensure_mem (udpsrc))
-    goto memory_alloc_error;
-
-  /* Retrieve sender address unless we've been configured not to do so */
-  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
-
-retry:
 
   do {
     gint64 timeout;
@@ -579,6 +647,230 @@ retry:
     }
   } while (G_UNLIKELY (try_again));
 
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+select_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
+  }
+}
+
+static gboolean
+gst_udpsrc_ignore_receive_error (GError * err)
+{
+  /* G_IO_ERROR_HOST_UNREACHABLE for a UDP socket means that a packet sent
+   * with udpsink generated a "port unreachable" ICMP response. We ignore
+   * that and try again.
+   * On Windows we get G_IO_ERROR_CONNECTION_CLOSED instead */
+#if GLIB_CHECK_VERSION(2,44,0)
+  return g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+      g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED);
+#else
+  return g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE);
+#endif
+}
+
+#if GLIB_CHECK_VERSION(2,48,0)
+/* turn the received datagram in @packet into a buffer, the packet memory is
+ * taken and will be reallocated for the next batch */
+static GstBuffer *
+gst_udpsrc_packet_to_buffer (GstUDPSrc * udpsrc, GstUDPSrcPacket * packet,
+    gsize size)
+{
+  GstBuffer *outbuf;
+  gsize offset;
+
+  outbuf = gst_buffer_new ();
+
+  gst_buffer_append_memory (outbuf, packet->mem);
+  if (size > packet->map.size) {
+    gst_buffer_append_memory (outbuf, packet->mem_max);
+    gst_memory_unmap (packet->mem_max, &packet->map_max);
+    packet->vec[1].buffer = NULL;
+    packet->vec[1].size = 0;
+    packet->mem_max = NULL;
+  }
+  gst_memory_unmap (packet->mem, &packet->map);
+  packet->vec[0].buffer = NULL;
+  packet->vec[0].size = 0;
+  packet->mem = NULL;
+
+  offset = udpsrc->skip_first_bytes;
+  if (G_UNLIKELY (offset > 0 && size < offset)) {
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
+  gst_buffer_resize (outbuf, offset, size - offset);
+
+  if (packet->saddr) {
+    gst_buffer_add_net_address_meta (outbuf, packet->saddr);
+    g_object_unref (packet->saddr);
+    packet->saddr = NULL;
+  }
+  return outbuf;
+}
+
+static GstFlowReturn
+gst_udpsrc_create_batch (GstUDPSrc * udpsrc, GstBuffer ** buf)
+{
+  GstBufferList *list;
+  GstBuffer *outbuf;
+  GstClock *clock;
+  GstClockTime dts = GST_CLOCK_TIME_NONE;
+  GError *err = NULL;
+  GstFlowReturn ret;
+  gint i, res;
+
+  if (!gst_udpsrc_ensure_packets_mem (udpsrc))
+    goto memory_alloc_error;
+
+retry:
+  ret = gst_udpsrc_wait (udpsrc);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  for (i = 0; i < udpsrc->n_packets; i++) {
+    GstUDPSrcPacket *packet = &udpsrc->packets[i];
+    GInputMessage *msg = &udpsrc->messages[i];
+
+    msg->address = udpsrc->retrieve_sender_address ? &packet->saddr : NULL;
+    msg->vectors = packet->vec;
+    msg->num_vectors = 2;
+    msg->bytes_received = 0;
+    msg->flags = G_SOCKET_MSG_NONE;
+    msg->control_messages = NULL;
+    msg->num_control_messages = NULL;
+  }
+
+  /* the socket is non-blocking, this returns whatever is queued */
+  res = g_socket_receive_messages (udpsrc->used_socket, udpsrc->messages,
+      udpsrc->n_packets, G_SOCKET_MSG_NONE, udpsrc->cancellable, &err);
+
+  if (G_UNLIKELY (res <= 0)) {
+    if (res == 0 || gst_udpsrc_ignore_receive_error (err) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+      g_clear_error (&err);
+      goto retry;
+    }
+    goto receive_error;
+  }
+
+  /* all packets of the batch arrived before the system call returned, give
+   * them all the capture time basesrc would give to the first one */
+  if (gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (udpsrc)) &&
+      (clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc)))) {
+    dts = gst_clock_get_time (clock) -
+        gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+    gst_object_unref (clock);
+  }
+
+  list = gst_buffer_list_new_sized (res);
+  for (i = 0; i < res; i++) {
+    gsize size = udpsrc->messages[i].bytes_received;
+
+    if (size > udpsrc->max_size)
+      udpsrc->max_size = size;
+
+    outbuf = gst_udpsrc_packet_to_buffer (udpsrc, &udpsrc->packets[i], size);
+    if (outbuf == NULL)
+      goto skip_error;
+
+    GST_BUFFER_DTS (outbuf) = dts;
+    gst_buffer_list_add (list, outbuf);
+
+    GST_LOG_OBJECT (udpsrc, "read packet of %" G_GSIZE_FORMAT " bytes", size);
+  }
+
+  if (res == 1) {
+    *buf = gst_buffer_ref (gst_buffer_list_get (list, 0));
+    gst_buffer_list_unref (list);
+  } else {
+    GST_LOG_OBJECT (udpsrc, "pushing list of %d packets", res);
+    gst_base_src_submit_buffer_list (GST_BASE_SRC_CAST (udpsrc), list);
+    *buf = NULL;
+  }
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+memory_alloc_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to allocate or map memory"));
+    return GST_FLOW_ERROR;
+  }
+receive_error:
+  {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      g_clear_error (&err);
+      return GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("receive error %d: %s", res, err->message));
+      g_clear_error (&err);
+      return GST_FLOW_ERROR;
+    }
+  }
+skip_error:
+  {
+    /* drop the sender addresses of the packets we did not get to */
+    for (; i < res; i++) {
+      if (udpsrc->packets[i].saddr) {
+        g_object_unref (udpsrc->packets[i].saddr);
+        udpsrc->packets[i].saddr = NULL;
+      }
+    }
+    gst_buffer_list_unref (list);
+
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    return GST_FLOW_ERROR;
+  }
+}
+#endif
+
+static GstFlowReturn
+gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc;
+  GstBuffer *outbuf = NULL;
+  GSocketAddress *saddr = NULL;
+  GSocketAddress **p_saddr;
+  gint flags = G_SOCKET_MSG_NONE;
+  GError *err = NULL;
+  GstFlowReturn ret;
+  gssize res;
+  gsize offset;
+
+  udpsrc = GST_UDPSRC_CAST (psrc);
+
+#if GLIB_CHECK_VERSION(2,48,0)
+  if (udpsrc->n_packets > 1)
+    return gst_udpsrc_create_batch (udpsrc, buf);
+#endif
+
+  if (!gst_udpsrc_ensure_mem (udpsrc))
+    goto memory_alloc_error;
+
+  /* Retrieve sender address unless we've been configured not to do so */
+  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
+
+retry:
+  ret = gst_udpsrc_wait (udpsrc);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
   if (saddr != NULL) {
     g_object_unref (saddr);
     saddr = NULL;
@@ -589,16 +881,7 @@ retry:
       NULL, NULL, &flags, udpsrc->cancellable, &err);
 
   if (G_UNLIKELY (res < 0)) {
-    /* G_IO_ERROR_HOST_UNREACHABLE for a UDP socket means that a packet sent
-     * with udpsink generated a "port unreachable" ICMP response. We ignore
-     * that and try again.
-     * On Windows we get G_IO_ERROR_CONNECTION_CLOSED instead */
-#if GLIB_CHECK_VERSION(2,44,0)
-    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
-        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED)) {
-#else
-    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE)) {
-#endif
+    if (gst_udpsrc_ignore_receive_error (err)) {
       g_clear_error (&err);
       goto retry;
     }
@@ -657,19 +940,6 @@ memory_alloc_error:
         ("Failed to allocate or map memory"));
     return GST_FLOW_ERROR;
   }
-select_error:
-  {
-    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
-        ("select error: %s", err->message));
-    g_clear_error (&err);
-    return GST_FLOW_ERROR;
-  }
-stopped:
-  {
-    GST_DEBUG ("stop called");
-    g_clear_error (&err);
-    return GST_FLOW_FLUSHING;
-  }
 receive_error:
   {
     if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
@@ -827,6 +1097,9 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_RETRIEVE_SENDER_ADDRESS:
       udpsrc->retrieve_sender_address = g_value_get_boolean (value);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
     default:
       break;
   }
@@ -887,6 +1160,9 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_RETRIEVE_SENDER_ADDRESS:
       g_value_set_boolean (value, udpsrc->retrieve_sender_address);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1097,6 +1373,24 @@ gst_udpsrc_open (GstUDPSrc * src)
 
   src->max_size = 0;
 
+  src->n_packets = 1;
+#if GLIB_CHECK_VERSION(2,48,0)
+  if (src->batch_size > 1) {
+    if (src->external_socket) {
+      GST_WARNING_OBJECT (src, "not batching on an externally provided socket");
+    } else {
+      src->n_packets = src->batch_size;
+      src->packets = g_new0 (GstUDPSrcPacket, src->n_packets);
+      src->messages = g_new0 (GInputMessage, src->n_packets);
+      /* we wait for the socket to become readable, after that we want to
+       * read as many packets as are queued without blocking */
+      g_socket_set_blocking (src->used_socket, FALSE);
+      GST_DEBUG_OBJECT (src, "receiving up to %u packets at once",
+          src->n_packets);
+    }
+  }
+#endif
+
   return TRUE;
 
   /* ERRORS */
@@ -1206,6 +1500,14 @@ gst_udpsrc_close (GstUDPSrc * src)
 
   gst_udpsrc_reset_memory_allocator (src);
 
+  g_free (src->packets);
+  src->packets = NULL;
+#if GLIB_CHECK_VERSION(2,48,0)
+  g_free (src->messages);
+  src->messages = NULL;
+#endif
+  src->n_packets = 0;
+
   gst_udpsrc_free_cancellable (src);
 
   return TRUE;
@@ -44,6 +44,16 @@ G_BEGIN_DECLS
 typedef struct _GstUDPSrc GstUDPSrc;
 typedef struct _GstUDPSrcClass GstUDPSrcClass;
 
+/* receive slot for one datagram in batched receive mode */
+typedef struct {
+  GstMemory    *mem;
+  GstMapInfo    map;
+  GstMemory    *mem_max;
+  GstMapInfo    map_max;
+  GInputVector  vec[2];
+  GSocketAddress *saddr;
+} GstUDPSrcPacket;
+
 struct _GstUDPSrc {
   GstPushSrc parent;
 
@@ -62,6 +72,7 @@ struct _GstUDPSrc {
   gboolean   reuse;
   gboolean   loop;
   gboolean   retrieve_sender_address;
+  guint      batch_size;
 
   /* stats */
   guint      max_size;
@@ -84,6 +95,13 @@ struct _GstUDPSrc {
   GstMapInfo   map_max;
   GInputVector vec[2];
 
+  /* batched receive */
+  guint            n_packets;
+  GstUDPSrcPacket *packets;
+#if GLIB_CHECK_VERSION(2,48,0)
+  GInputMessage   *messages;
+#endif
+
   gchar     *uri;
 };
 
@@ -33,6 +33,10 @@
  *
  * If there is nothing to crop, the element will operate in pass-through mode.
  *
+ * If downstream supports #GstVideoCropMeta and #GstVideoMeta, the input
+ * buffers are not copied at all. Instead a crop meta describing the cropped
+ * region is attached to them and they are pushed downstream as they are.
+ *
  * Note that no special efforts are made to handle chroma-subsampled formats
  * in the case of odd-valued cropping and compensate for sub-unit chroma plane
  * shifts for such formats in the case where the #GstVideoCrop:left or
@@ -113,6 +117,10 @@ static gboolean gst_video_crop_set_info (GstVideoFilter * vfilter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info);
 static GstFlowReturn gst_video_crop_transform_frame (GstVideoFilter * vfilter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static gboolean gst_video_crop_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query);
+static GstFlowReturn gst_video_crop_transform_ip (GstBaseTransform * trans,
+    GstBuffer * buf);
 
 static gboolean
 gst_video_crop_src_event (GstBaseTransform * trans, GstEvent * event)
@@ -204,6 +212,10 @@ gst_video_crop_class_init (GstVideoCropClass * klass)
   basetransform_class->transform_caps =
       GST_DEBUG_FUNCPTR (gst_video_crop_transform_caps);
   basetransform_class->src_event = GST_DEBUG_FUNCPTR (gst_video_crop_src_event);
+  basetransform_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_crop_decide_allocation);
+  basetransform_class->transform_ip =
+      GST_DEBUG_FUNCPTR (gst_video_crop_transform_ip);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_crop_set_info);
   vfilter_class->transform_frame =
@@ -430,6 +442,54 @@ gst_video_crop_transform_frame (GstVideoFilter * vfilter,
   return GST_FLOW_OK;
 }
 
+/* only used when downstream can handle the crop meta, the buffer is passed on
+ * untouched with the region to show described by the meta */
+static GstFlowReturn
+gst_video_crop_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+{
+  GstVideoCrop *vcrop = GST_VIDEO_CROP (trans);
+  GstVideoMeta *vmeta;
+  GstVideoCropMeta *cmeta;
+  GstVideoInfo *info;
+
+  if (G_UNLIKELY (vcrop->need_update)) {
+    if (!gst_video_crop_set_info (GST_VIDEO_FILTER (vcrop), NULL,
+            &vcrop->in_info, NULL, &vcrop->out_info)) {
+      return GST_FLOW_ERROR;
+    }
+  }
+
+  info = &vcrop->in_info;
+
+  /* the caps now describe the cropped size, so the full size of the buffer
+   * has to be in the video meta */
+  vmeta = gst_buffer_get_video_meta (buf);
+  if (vmeta == NULL) {
+    vmeta = gst_buffer_add_video_meta_full (buf, GST_VIDEO_FRAME_FLAG_NONE,
+        GST_VIDEO_INFO_FORMAT (info), GST_VIDEO_INFO_WIDTH (info),
+        GST_VIDEO_INFO_HEIGHT (info), GST_VIDEO_INFO_N_PLANES (info),
+        info->offset, info->stride);
+  }
+
+  /* crop relative to whatever upstream already cropped */
+  cmeta = gst_buffer_get_video_crop_meta (buf);
+  if (cmeta == NULL) {
+    cmeta = gst_buffer_add_video_crop_meta (buf);
+    cmeta->x = 0;
+    cmeta->y = 0;
+  }
+  cmeta->x += vcrop->crop_left;
+  cmeta->y += vcrop->crop_top;
+  cmeta->width = GST_VIDEO_INFO_WIDTH (&vcrop->out_info);
+  cmeta->height = GST_VIDEO_INFO_HEIGHT (&vcrop->out_info);
+
+  GST_LOG_OBJECT (vcrop, "cropping %ux%u buffer to %ux%u at %u,%u",
+      vmeta->width, vmeta->height, cmeta->width, cmeta->height, cmeta->x,
+      cmeta->y);
+
+  return GST_FLOW_OK;
+}
+
 static gint
 gst_video_crop_transform_dimension (gint val, gint delta)
 {
@@ -618,6 +678,11 @@ gst_video_crop_set_info (GstVideoFilter * vfilter, GstCaps * in,
   crop->crop_bottom = crop->prop_bottom;
   GST_OBJECT_UNLOCK (crop);
 
+  /* decide_allocation switches to in-place cropping again if downstream
+   * supports the crop meta for the new caps */
+  if (in && out)
+    gst_base_transform_set_in_place (GST_BASE_TRANSFORM (crop), FALSE);
+
   dx = GST_VIDEO_INFO_WIDTH (in_info) - GST_VIDEO_INFO_WIDTH (out_info);
   dy = GST_VIDEO_INFO_HEIGHT (in_info) - GST_VIDEO_INFO_HEIGHT (out_info);
 
@@ -717,6 +782,28 @@ unknown_format:
   }
 }
 
+static gboolean
+gst_video_crop_decide_allocation (GstBaseTransform * trans, GstQuery * query)
+{
+  GstVideoCrop *crop = GST_VIDEO_CROP (trans);
+
+  /* the buffer keeps its full size, so downstream needs the video meta as
+   * well to find the cropped region in it */
+  if (gst_query_find_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE,
+          NULL)
+      && gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE,
+          NULL)) {
+    GST_DEBUG_OBJECT (crop, "downstream supports crop meta, not copying");
+    gst_base_transform_set_in_place (trans, TRUE);
+  } else {
+    GST_DEBUG_OBJECT (crop, "downstream does not support crop meta, copying");
+    gst_base_transform_set_in_place (trans, FALSE);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
 /* called with object lock */
 static inline void
 gst_video_crop_set_crop (GstVideoCrop * vcrop, gint new_value, gint * prop)
@@ -47,6 +47,7 @@
 #include <string.h>
 #include <gst/gst.h>
 #include <gst/video/video.h>
+#include <gst/video/gstvideoaffinetransformationmeta.h>
 
 /* GstVideoFlip properties */
 enum
@@ -182,11 +183,93 @@ gst_video_flip_transform_caps (GstBaseTransform * trans,
   return ret;
 }
 
+/* Rotations and transpositions read the source column-wise, which for big
+ * frames means touching a new cache line for every single pixel. They are
+ * done in square tiles instead so that the source rows of a tile stay in
+ * the cache while the tile is written out. */
+#define FLIP_TILE_SIZE 32
+
+/* the pixel size is a constant in the common cases so that the copies
+ * become simple loads and stores the compiler can vectorize */
+#define ROTATE_TILE(psize) G_STMT_START {                        \
+  for (y = ty; y < ty_end; y++) {                               \
+    guint8 *dp = d + y * dest_stride + tx * (psize);             \
+    const guint8 *sp = s + y * y_step + tx * x_step;            \
+                                                                \
+    for (x = tx; x < tx_end; x++) {                             \
+      memcpy (dp, sp, (psize));                                 \
+      dp += (psize);                                            \
+      sp += x_step;                                             \
+    }                                                           \
+  }                                                             \
+} G_STMT_END
+
+static void
+gst_video_flip_rotate_plane (GstVideoFlipMethod method, guint8 * d,
+    gint dest_stride, gint dw, gint dh, const guint8 * s, gint src_stride,
+    gint sw, gint sh, gint pstride)
+{
+  gint x, y, tx, ty, tx_end, ty_end;
+  gint x_step, y_step;
+
+  /* the source pixel of destination pixel (x, y) is at
+   * s + x * x_step + y * y_step */
+  switch (method) {
+    case GST_VIDEO_FLIP_METHOD_90R:
+      s += (sh - 1) * src_stride;
+      x_step = -src_stride;
+      y_step = pstride;
+      break;
+    case GST_VIDEO_FLIP_METHOD_90L:
+      s += (sw - 1) * pstride;
+      x_step = src_stride;
+      y_step = -pstride;
+      break;
+    case GST_VIDEO_FLIP_METHOD_TRANS:
+      x_step = src_stride;
+      y_step = pstride;
+      break;
+    case GST_VIDEO_FLIP_METHOD_OTHER:
+      s += (sh - 1) * src_stride + (sw - 1) * pstride;
+      x_step = -src_stride;
+      y_step = -pstride;
+      break;
+    default:
+      g_assert_not_reached ();
+      return;
+  }
+
+  for (ty = 0; ty < dh; ty += FLIP_TILE_SIZE) {
+    ty_end = MIN (ty + FLIP_TILE_SIZE, dh);
+
+    for (tx = 0; tx < dw; tx += FLIP_TILE_SIZE) {
+      tx_end = MIN (tx + FLIP_TILE_SIZE, dw);
+
+      switch (pstride) {
+        case 1:
+          ROTATE_TILE (1);
+          break;
+        case 2:
+          ROTATE_TILE (2);
+          break;
+        case 4:
+          ROTATE_TILE (4);
+          break;
+        default:
+          ROTATE_TILE (pstride);
+          break;
+      }
+    }
+  }
+}
+
+#undef ROTATE_TILE
+
 static void
 gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
     const GstVideoFrame * src)
 {
-  gint x, y;
+  gint x, y, i;
   guint8 const *s;
   guint8 *d;
   gint src_y_stride, src_u_stride, src_v_stride;
@@ -222,61 +305,19 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_FLIP_METHOD_90R:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + y];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] =
-              s[(src_u_height - 1 - x) * src_u_stride + y];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
-        for (x = 0; x < dest_v_width; x++) {
-          d[y * dest_v_stride + x] =
-              s[(src_v_height - 1 - x) * src_v_stride + y];
-        }
-      }
-      break;
     case GST_VIDEO_FLIP_METHOD_90L:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[x * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] =
-              s[x * src_u_stride + (src_u_width - 1 - y)];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
-        for (x = 0; x < dest_v_width; x++) {
-          d[y * dest_v_stride + x] =
-              s[x * src_v_stride + (src_v_width - 1 - y)];
-        }
+    case GST_VIDEO_FLIP_METHOD_TRANS:
+    case GST_VIDEO_FLIP_METHOD_OTHER:
+      for (i = 0; i < 3; i++) {
+        gst_video_flip_rotate_plane (videoflip->active_method,
+            GST_VIDEO_FRAME_PLANE_DATA (dest, i),
+            GST_VIDEO_FRAME_PLANE_STRIDE (dest, i),
+            GST_VIDEO_FRAME_COMP_WIDTH (dest, i),
+            GST_VIDEO_FRAME_COMP_HEIGHT (dest, i),
+            GST_VIDEO_FRAME_PLANE_DATA (src, i),
+            GST_VIDEO_FRAME_PLANE_STRIDE (src, i),
+            GST_VIDEO_FRAME_COMP_WIDTH (src, i),
+            GST_VIDEO_FRAME_COMP_HEIGHT (src, i), 1);
       }
       break;
     case GST_VIDEO_FLIP_METHOD_180:
@@ -366,61 +407,6 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
         }
       }
       break;
-    case GST_VIDEO_FLIP_METHOD_TRANS:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] = s[x * src_y_stride + y];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] = s[x * src_u_stride + y];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_v_stride + x] = s[x * src_v_stride + y];
-        }
-      }
-      break;
-    case GST_VIDEO_FLIP_METHOD_OTHER:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip U */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
-        for (x = 0; x < dest_u_width; x++) {
-          d[y * dest_u_stride + x] =
-              s[(src_u_height - 1 - x) * src_u_stride + (src_u_width - 1 - y)];
-        }
-      }
-      /* Flip V */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
-        for (x = 0; x < dest_v_width; x++) {
-          d[y * dest_v_stride + x] =
-              s[(src_v_height - 1 - x) * src_v_stride + (src_v_width - 1 - y)];
-        }
-      }
-      break;
     case GST_VIDEO_FLIP_METHOD_IDENTITY:
       g_assert_not_reached ();
       break;
@@ -466,48 +452,19 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_FLIP_METHOD_90R:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + y];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = (src_uv_height - 1 - x) * src_uv_stride + y * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
-      break;
     case GST_VIDEO_FLIP_METHOD_90L:
+    case GST_VIDEO_FLIP_METHOD_TRANS:
+    case GST_VIDEO_FLIP_METHOD_OTHER:
       /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[x * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = x * src_uv_stride + (src_uv_width - 1 - y) * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
+      gst_video_flip_rotate_plane (videoflip->active_method,
+          GST_VIDEO_FRAME_PLANE_DATA (dest, 0), dest_y_stride, dest_y_width,
+          dest_y_height, GST_VIDEO_FRAME_PLANE_DATA (src, 0), src_y_stride,
+          src_y_width, src_y_height, 1);
+      /* Flip UV, the interleaved chroma samples move as one 2 byte pixel */
+      gst_video_flip_rotate_plane (videoflip->active_method,
+          GST_VIDEO_FRAME_PLANE_DATA (dest, 1), dest_uv_stride, dest_uv_width,
+          dest_uv_height, GST_VIDEO_FRAME_PLANE_DATA (src, 1), src_uv_stride,
+          src_uv_width, src_uv_height, 2);
       break;
     case GST_VIDEO_FLIP_METHOD_180:
       /* Flip Y */
@@ -576,50 +533,6 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
         }
       }
       break;
-    case GST_VIDEO_FLIP_METHOD_TRANS:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] = s[x * src_y_stride + y];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = x * src_uv_stride + y * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
-      break;
-    case GST_VIDEO_FLIP_METHOD_OTHER:
-      /* Flip Y */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
-        for (x = 0; x < dest_y_width; x++) {
-          d[y * dest_y_stride + x] =
-              s[(src_y_height - 1 - x) * src_y_stride + (src_y_width - 1 - y)];
-        }
-      }
-      /* Flip UV */
-      s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
-      d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
-        for (x = 0; x < dest_uv_width; x++) {
-          d_off = y * dest_uv_stride + x * 2;
-          s_off = (src_uv_height - 1 - x) * src_uv_stride + (src_uv_width - 1 -
-              y) * 2;
-          d[d_off] = s[s_off];
-          d[d_off + 1] = s[s_off + 1];
-        }
-      }
-      break;
     case GST_VIDEO_FLIP_METHOD_IDENTITY:
       g_assert_not_reached ();
       break;
@@ -653,24 +566,11 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_FLIP_METHOD_90R:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] =
-                s[(sh - 1 - x) * src_stride + y * bpp + z];
-          }
-        }
-      }
-      break;
     case GST_VIDEO_FLIP_METHOD_90L:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] =
-                s[x * src_stride + (sw - 1 - y) * bpp + z];
-          }
-        }
-      }
+    case GST_VIDEO_FLIP_METHOD_TRANS:
+    case GST_VIDEO_FLIP_METHOD_OTHER:
+      gst_video_flip_rotate_plane (videoflip->active_method, d, dest_stride,
+          dw, dh, s, src_stride, sw, sh, bpp);
       break;
     case GST_VIDEO_FLIP_METHOD_180:
       for (y = 0; y < dh; y++) {
@@ -702,25 +602,6 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
         }
       }
       break;
-    case GST_VIDEO_FLIP_METHOD_TRANS:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] = s[x * src_stride + y * bpp + z];
-          }
-        }
-      }
-      break;
-    case GST_VIDEO_FLIP_METHOD_OTHER:
-      for (y = 0; y < dh; y++) {
-        for (x = 0; x < dw; x++) {
-          for (z = 0; z < bpp; z++) {
-            d[y * dest_stride + x * bpp + z] =
-                s[(sh - 1 - x) * src_stride + (sw - 1 - y) * bpp + z];
-          }
-        }
-      }
-      break;
     case GST_VIDEO_FLIP_METHOD_IDENTITY:
       g_assert_not_reached ();
       break;
@@ -1092,6 +973,107 @@ gst_video_flip_before_transform (GstBaseTransform * trans, GstBuffer * in)
     gst_object_sync_values (GST_OBJECT (videoflip), stream_time);
 }
 
+/* Flips that keep the frame size can be done by downstream for free while
+ * rendering if it supports the affine transformation meta. The matrices
+ * are column-major and operate around the center of the frame. */
+static const gfloat *
+gst_video_flip_get_affine_matrix (GstVideoFlipMethod method)
+{
+  static const gfloat matrix_180[16] = {
+    -1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+  };
+  static const gfloat matrix_horiz[16] = {
+    -1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+  };
+  static const gfloat matrix_vert[16] = {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+  };
+
+  switch (method) {
+    case GST_VIDEO_FLIP_METHOD_180:
+      return matrix_180;
+    case GST_VIDEO_FLIP_METHOD_HORIZ:
+      return matrix_horiz;
+    case GST_VIDEO_FLIP_METHOD_VERT:
+      return matrix_vert;
+    default:
+      /* rotations change the frame size and need to be done here */
+      return NULL;
+  }
+}
+
+static gboolean
+gst_video_flip_decide_allocation (GstBaseTransform * trans, GstQuery * query)
+{
+  GstVideoFlip *videoflip = GST_VIDEO_FLIP (trans);
+
+  videoflip->downstream_affine_meta = gst_query_find_allocation_meta (query,
+      GST_VIDEO_AFFINE_TRANSFORMATION_META_API_TYPE, NULL);
+
+  GST_DEBUG_OBJECT (videoflip, "downstream %s affine transformation meta",
+      videoflip->downstream_affine_meta ? "supports" : "doesn't support");
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
+static GstFlowReturn
+gst_video_flip_prepare_output_buffer (GstBaseTransform * trans,
+    GstBuffer * inbuf, GstBuffer ** outbuf)
+{
+  GstVideoFlip *videoflip = GST_VIDEO_FLIP (trans);
+  GstVideoAffineTransformationMeta *meta;
+  const gfloat *matrix = NULL;
+
+  if (videoflip->downstream_affine_meta) {
+    GST_OBJECT_LOCK (videoflip);
+    matrix = gst_video_flip_get_affine_matrix (videoflip->active_method);
+    GST_OBJECT_UNLOCK (videoflip);
+  }
+
+  videoflip->meta_only = (matrix != NULL);
+  if (!videoflip->meta_only)
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->prepare_output_buffer
+        (trans, inbuf, outbuf);
+
+  /* the output shares the memory of the input, a transformation that is
+   * already on the buffer is combined with ours */
+  *outbuf = gst_buffer_copy (inbuf);
+
+  meta = gst_buffer_get_video_affine_transformation_meta (*outbuf);
+  if (!meta)
+    meta = gst_buffer_add_video_affine_transformation_meta (*outbuf);
+  gst_video_affine_transformation_meta_apply_matrix (meta, matrix);
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_video_flip_transform (GstBaseTransform * trans, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  GstVideoFlip *videoflip = GST_VIDEO_FLIP (trans);
+
+  /* mapping the shared memory for writing would copy it */
+  if (videoflip->meta_only) {
+    GST_LOG_OBJECT (videoflip, "flipping (%s) with transformation meta",
+        video_flip_methods[videoflip->active_method].value_nick);
+    return GST_FLOW_OK;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->transform (trans, inbuf,
+      outbuf);
+}
+
 static GstFlowReturn
 gst_video_flip_transform_frame (GstVideoFilter * vfilter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
@@ -1293,6 +1275,11 @@ gst_video_flip_class_init (GstVideoFlipClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_flip_transform_caps);
   trans_class->before_transform =
       GST_DEBUG_FUNCPTR (gst_video_flip_before_transform);
+  trans_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_flip_decide_allocation);
+  trans_class->prepare_output_buffer =
+      GST_DEBUG_FUNCPTR (gst_video_flip_prepare_output_buffer);
+  trans_class->transform = GST_DEBUG_FUNCPTR (gst_video_flip_transform);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_flip_src_event);
   trans_class->sink_event = GST_DEBUG_FUNCPTR (gst_video_flip_sink_event);
 
@@ -79,6 +79,11 @@ struct _GstVideoFlip {
   GstVideoFlipMethod tag_method;
   GstVideoFlipMethod active_method;
   void (*process) (GstVideoFlip *videoflip, GstVideoFrame *dest, const GstVideoFrame *src);
+
+  /* downstream applies GstVideoAffineTransformationMeta itself */
+  gboolean downstream_affine_meta;
+  /* the current output buffer only got a transformation meta */
+  gboolean meta_only;
 };
 
 struct _GstVideoFlipClass {
@@ -899,6 +899,10 @@ gst_v4l2_allocator_alloc_dmabuf (GstV4l2Allocator * allocator,
     gst_mini_object_set_qdata (GST_MINI_OBJECT (dma_mem),
         GST_V4L2_MEMORY_QUARK, mem, (GDestroyNotify) gst_memory_unref);
 
+    /* V4L2 buffers are always linear */
+    gst_dmabuf_memory_set_drm_modifier (dma_mem,
+        GST_DMABUF_DRM_MODIFIER_LINEAR);
+
     group->mem[i] = dma_mem;
     group->mems_allocated++;
   }
@@ -1076,10 +1080,18 @@ gst_v4l2_allocator_import_dmabuf (GstV4l2Allocator * allocator,
   for (i = 0; i < group->n_mem; i++) {
     gint dmafd;
     gsize size, offset, maxsize;
+    guint64 modifier;
 
     if (!gst_is_dmabuf_memory (dma_mem[i]))
       goto not_dmabuf;
 
+    modifier = gst_dmabuf_memory_get_drm_modifier (dma_mem[i]);
+    if (modifier != GST_DMABUF_DRM_MODIFIER_LINEAR &&
+        modifier != GST_DMABUF_DRM_MODIFIER_INVALID)
+      GST_WARNING_OBJECT (allocator, "DMABUF plane %d has modifier 0x%016"
+          G_GINT64_MODIFIER "x, but the device expects a linear layout",
+          i, modifier);
+
     size = gst_memory_get_sizes (dma_mem[i], &offset, &maxsize);
 
     if ((dmafd = dup (gst_dmabuf_memory_get_fd (dma_mem[i]))) < 0)
@@ -810,6 +810,7 @@ gst_v4l2_buffer_pool_start (GstBufferPool * bpool)
   pool->max_latency = max_latency;
   pool->min_latency = min_latency;
   pool->num_queued = 0;
+  pool->num_underflows = 0;
 
   if (max_buffers != 0 && max_buffers < min_buffers)
     max_buffers = min_buffers;
@@ -1133,6 +1134,17 @@ queue_failed:
   }
 }
 
+/* Whether a buffer can be dequeued without blocking */
+static gboolean
+gst_v4l2_buffer_pool_has_pending_dqbuf (GstV4l2BufferPool * pool)
+{
+  /* without polling, dequeuing always blocks */
+  if (!pool->can_poll_device)
+    return FALSE;
+
+  return gst_poll_wait (pool->poll, 0) > 0;
+}
+
 static GstFlowReturn
 gst_v4l2_buffer_pool_dqbuf (GstV4l2BufferPool * pool, GstBuffer ** buffer)
 {
@@ -1737,25 +1749,28 @@ gst_v4l2_buffer_pool_process (GstV4l2BufferPool * pool, GstBuffer ** buf)
             GST_TRACE_OBJECT (pool, "Only %i buffer left in the capture queue.",
                 num_queued);
 
-            /* If we have no more buffer, and can allocate it time to do so */
-            if (num_queued == 0) {
-              if (GST_V4L2_ALLOCATOR_CAN_ALLOCATE (pool->vallocator, MMAP)) {
-                ret = gst_v4l2_buffer_pool_resurect_buffer (pool);
-                if (ret == GST_FLOW_OK)
-                  goto done;
+            /* If downstream holds on to too many buffers and we can allocate,
+             * grow the pool with CREATE_BUFS instead of copying. Once the
+             * pool can't grow anymore the driver will drop frames until
+             * buffers come back, which is reported as lost frames by the
+             * element, but copies are never made. */
+            if (GST_V4L2_ALLOCATOR_CAN_ALLOCATE (pool->vallocator, MMAP)) {
+              if (num_queued < pool->min_latency &&
+                  gst_v4l2_buffer_pool_resurect_buffer (pool) != GST_FLOW_OK) {
+                pool->num_underflows++;
+                GST_CAT_INFO_OBJECT (CAT_PERFORMANCE, pool,
+                    "pool exhausted with %u buffer queued (%u underflows)",
+                    num_queued, pool->num_underflows);
               }
+
+              ret = GST_FLOW_OK;
+              goto done;
             }
 
             /* start copying buffers when we are running low on buffers */
             if (num_queued < pool->copy_threshold) {
               GstBuffer *copy;
 
-              if (GST_V4L2_ALLOCATOR_CAN_ALLOCATE (pool->vallocator, MMAP)) {
-                ret = gst_v4l2_buffer_pool_resurect_buffer (pool);
-                if (ret == GST_FLOW_OK)
-                  goto done;
-              }
-
               /* copy the buffer */
               copy = gst_buffer_copy_region (*buf,
                   GST_BUFFER_COPY_ALL | GST_BUFFER_COPY_DEEP, 0, -1);
@@ -1914,12 +1929,24 @@ gst_v4l2_buffer_pool_process (GstV4l2BufferPool * pool, GstBuffer ** buf)
            * otherwise the pool will think it is outstanding and will refuse to stop. */
           gst_buffer_unref (to_queue);
 
-          if (g_atomic_int_get (&pool->num_queued) >= pool->min_latency) {
+          /* Keep as many buffers queued as the pool allows, so that devices
+           * consuming small buffers quickly (e.g. m2m decoders fed with
+           * small NALs) always have work queued. Only block for the device
+           * when all buffers are queued, otherwise just reclaim the buffers
+           * that were already consumed. */
+          while (g_atomic_int_get (&pool->num_queued) >= pool->min_latency) {
             GstBuffer *out;
-            /* all buffers are queued, try to dequeue one and release it back
-             * into the pool so that _acquire can get to it again. */
+
+            if (g_atomic_int_get (&pool->num_queued) < pool->max_latency &&
+                !gst_v4l2_buffer_pool_has_pending_dqbuf (pool))
+              break;
+
+            /* try to dequeue one and release it back into the pool so that
+             * _acquire can get to it again. */
             ret = gst_v4l2_buffer_pool_dqbuf (pool, &out);
-            if (ret == GST_FLOW_OK && out->pool == NULL)
+            if (ret != GST_FLOW_OK)
+              break;
+            if (out->pool == NULL)
               /* release the rendered buffer back into the pool. This wakes up any
                * thread waiting for a buffer in _acquire(). */
               gst_v4l2_buffer_pool_release_buffer (bpool, out);
@@ -81,6 +81,7 @@ struct _GstV4l2BufferPool
   guint max_latency;         /* number of buffers we can hold */
   guint num_queued;          /* number of buffers queued in the driver */
   guint copy_threshold;      /* when our pool runs lower, start handing out copies */
+  guint num_underflows;      /* times the pool could not grow to refill the driver */
 
   gboolean streaming;
   gboolean flushing;
@@ -2830,6 +2830,52 @@ error:
   return ret;
 }
 
+/* Check whether the driver can export its capture buffers as DMABUF, using
+ * a single temporary buffer. Exported buffers can then be passed downstream
+ * without copies, while still being mappable like MMAP buffers. */
+static gboolean
+gst_v4l2_object_can_export_dmabuf (GstV4l2Object * v4l2object)
+{
+  struct v4l2_requestbuffers breq = { 0 };
+  struct v4l2_exportbuffer expbuf = { 0 };
+  gboolean ret = FALSE;
+
+  if (V4L2_TYPE_IS_OUTPUT (v4l2object->type))
+    return FALSE;
+
+  /* libv4l2 converted formats are not what the driver would export */
+  if (v4l2object->fmtdesc
+      && (v4l2object->fmtdesc->flags & V4L2_FMT_FLAG_EMULATED))
+    return FALSE;
+
+  breq.type = v4l2object->type;
+  breq.memory = V4L2_MEMORY_MMAP;
+  breq.count = 1;
+
+  if (v4l2_ioctl (v4l2object->video_fd, VIDIOC_REQBUFS, &breq) < 0)
+    return FALSE;
+
+  if (breq.count > 0) {
+    expbuf.type = v4l2object->type;
+    expbuf.index = 0;
+    expbuf.plane = 0;
+    expbuf.flags = O_CLOEXEC | O_RDWR;
+
+    if (v4l2_ioctl (v4l2object->video_fd, VIDIOC_EXPBUF, &expbuf) == 0) {
+      close (expbuf.fd);
+      ret = TRUE;
+    }
+  }
+
+  breq.count = 0;
+  v4l2_ioctl (v4l2object->video_fd, VIDIOC_REQBUFS, &breq);
+
+  GST_DEBUG_OBJECT (v4l2object->element, "driver %s export DMABUF",
+      ret ? "can" : "can't");
+
+  return ret;
+}
+
 static gboolean
 gst_v4l2_object_setup_pool (GstV4l2Object * v4l2object, GstCaps * caps)
 {
@@ -2851,8 +2897,14 @@ gst_v4l2_object_setup_pool (GstV4l2Object * v4l2object, GstCaps * caps)
     goto method_not_supported;
 
   if (v4l2object->vcap.capabilities & V4L2_CAP_STREAMING) {
-    if (v4l2object->req_mode == GST_V4L2_IO_AUTO)
-      mode = GST_V4L2_IO_MMAP;
+    if (v4l2object->req_mode == GST_V4L2_IO_AUTO) {
+      /* prefer exporting the capture buffers, so that importing elements
+       * downstream never need a copy */
+      if (gst_v4l2_object_can_export_dmabuf (v4l2object))
+        mode = GST_V4L2_IO_DMABUF;
+      else
+        mode = GST_V4L2_IO_MMAP;
+    }
   } else if (v4l2object->req_mode == GST_V4L2_IO_MMAP)
     goto method_not_supported;
 
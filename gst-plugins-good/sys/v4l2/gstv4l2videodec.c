@@ -38,6 +38,11 @@
 GST_DEBUG_CATEGORY_STATIC (gst_v4l2_video_dec_debug);
 #define GST_CAT_DEFAULT gst_v4l2_video_dec_debug
 
+/* Number of compressed buffers on the OUTPUT queue. With more than the
+ * minimum the hardware keeps decoding while the next frames are queued,
+ * which matters for streams made of many small NALs. */
+#define GST_V4L2_VIDEO_DEC_OUTPUT_BUFFERS 4
+
 static gboolean gst_v4l2_video_dec_flush (GstVideoDecoder * decoder);
 
 typedef struct
@@ -486,8 +491,11 @@ gst_v4l2_video_dec_handle_frame (GstVideoDecoder * decoder,
     /* Ensure input internal pool is active */
     if (!gst_buffer_pool_is_active (pool)) {
       GstStructure *config = gst_buffer_pool_get_config (pool);
+      guint n_buffers = MAX (GST_V4L2_VIDEO_DEC_OUTPUT_BUFFERS,
+          self->v4l2output->min_buffers);
+
       gst_buffer_pool_config_set_params (config, self->input_state->caps,
-          self->v4l2output->info.size, 2, 2);
+          self->v4l2output->info.size, n_buffers, n_buffers);
 
       /* There is no reason to refuse this config */
       if (!gst_buffer_pool_set_config (pool, config))
@@ -273,6 +273,125 @@ GST_START_TEST (test_interleave_2ch)
 
 GST_END_TEST;
 
+static GstFlowReturn
+non_interleaved_chain_func (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstMapInfo map;
+  gfloat *outdata;
+  gint i;
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  outdata = (gfloat *) map.data;
+  fail_unless_equals_int (map.size, 48000 * 2 * sizeof (gfloat));
+
+  /* one plane per channel */
+  for (i = 0; i < 48000; i++) {
+    fail_unless_equals_float (outdata[i], input[0]);
+    fail_unless_equals_float (outdata[48000 + i], input[1]);
+  }
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  have_data++;
+
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_interleave_2ch_non_interleaved_output)
+{
+  GstElement *queue;
+  GstPad *sink0, *sink1, *src, *tmp;
+  GstCaps *caps, *srccaps;
+  GstBuffer *inbuf;
+  GstMapInfo map;
+  gfloat *indata;
+  gint i, j;
+
+  mysrcpads = g_new0 (GstPad *, 2);
+  have_data = 0;
+
+  interleave = gst_element_factory_make ("interleave", NULL);
+  fail_unless (interleave != NULL);
+  g_object_set (interleave, "non-interleaved", TRUE, NULL);
+
+  /* the first input goes through a queue so that pushing on it does not
+   * block until the second input has data too */
+  queue = gst_element_factory_make ("queue", "queue");
+  fail_unless (queue != NULL);
+
+  sink0 = gst_element_get_request_pad (interleave, "sink_%u");
+  sink1 = gst_element_get_request_pad (interleave, "sink_%u");
+  tmp = gst_element_get_static_pad (queue, "src");
+  fail_unless (gst_pad_link (tmp, sink0) == GST_PAD_LINK_OK);
+  gst_object_unref (tmp);
+
+  mysinkpad = gst_pad_new_from_static_template (&sinktemplate, "sink");
+  gst_pad_set_chain_function (mysinkpad, non_interleaved_chain_func);
+  gst_pad_set_active (mysinkpad, TRUE);
+  src = gst_element_get_static_pad (interleave, "src");
+  fail_unless (gst_pad_link (src, mysinkpad) == GST_PAD_LINK_OK);
+
+  fail_unless (gst_element_set_state (interleave,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_from_string (CAPS_48khz);
+  for (i = 0; i < 2; i++) {
+    gchar stream_id[2] = { '0' + i, '\0' };
+
+    mysrcpads[i] = gst_pad_new_from_static_template (&srctemplate, "src");
+    gst_pad_set_active (mysrcpads[i], TRUE);
+    tmp = i == 0 ? gst_element_get_static_pad (queue, "sink") :
+        gst_object_ref (sink1);
+    fail_unless (gst_pad_link (mysrcpads[i], tmp) == GST_PAD_LINK_OK);
+    gst_object_unref (tmp);
+    gst_check_setup_events_interleave (mysrcpads[i], interleave, caps,
+        GST_FORMAT_TIME, stream_id);
+  }
+  gst_caps_unref (caps);
+
+  srccaps = gst_pad_get_current_caps (src);
+  fail_unless (srccaps != NULL);
+  fail_unless_equals_string (gst_structure_get_string
+      (gst_caps_get_structure (srccaps, 0), "layout"), "non-interleaved");
+  gst_caps_unref (srccaps);
+  gst_object_unref (src);
+
+  input[0] = -1.0;
+  input[1] = 1.0;
+  for (i = 0; i < 2; i++) {
+    inbuf = gst_buffer_new_and_alloc (48000 * sizeof (gfloat));
+    gst_buffer_map (inbuf, &map, GST_MAP_WRITE);
+    indata = (gfloat *) map.data;
+    for (j = 0; j < 48000; j++)
+      indata[j] = input[i];
+    gst_buffer_unmap (inbuf, &map);
+    fail_unless (gst_pad_push (mysrcpads[i], inbuf) == GST_FLOW_OK);
+  }
+
+  fail_unless (have_data == 1);
+
+  gst_element_set_state (interleave, GST_STATE_NULL);
+  gst_element_set_state (queue, GST_STATE_NULL);
+
+  gst_object_unref (mysrcpads[0]);
+  gst_object_unref (mysrcpads[1]);
+  gst_object_unref (mysinkpad);
+
+  gst_element_release_request_pad (interleave, sink0);
+  gst_object_unref (sink0);
+  gst_element_release_request_pad (interleave, sink1);
+  gst_object_unref (sink1);
+
+  gst_object_unref (interleave);
+  gst_object_unref (queue);
+  g_free (mysrcpads);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_interleave_2ch_1eos)
 {
   GstElement *queue;
@@ -812,6 +931,7 @@ interleave_suite (void)
   tcase_add_test (tc_chain, test_create_and_unref);
   tcase_add_test (tc_chain, test_request_pads);
   tcase_add_test (tc_chain, test_interleave_2ch);
+  tcase_add_test (tc_chain, test_interleave_2ch_non_interleaved_output);
   tcase_add_test (tc_chain, test_interleave_2ch_1eos);
   tcase_add_test (tc_chain, test_interleave_2ch_pipeline_interleaved);
   tcase_add_test (tc_chain, test_interleave_2ch_pipeline_non_interleaved);
@@ -28,6 +28,8 @@
 #include <unistd.h>
 #endif
 
+#include <string.h>
+
 #include <glib/gstdio.h>
 
 #include <gst/check/gstcheck.h>
@@ -542,6 +544,102 @@ GST_START_TEST (test_audio_pad_frag_asc_streamable)
 
 GST_END_TEST;
 
+static gboolean
+buffer_contains_fourcc (GstBuffer * buffer, const gchar * fourcc)
+{
+  GstMapInfo map;
+  gboolean found = FALSE;
+  gsize i;
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  for (i = 0; i + 4 <= map.size && !found; i++)
+    found = memcmp (map.data + i, fourcc, 4) == 0;
+  gst_buffer_unmap (buffer, &map);
+
+  return found;
+}
+
+GST_START_TEST (test_video_pad_frag_chunked)
+{
+  GstElement *qtmux;
+  GstBuffer *inbuffer, *outbuffer;
+  GstCaps *caps;
+  GstSegment segment;
+  int num_buffers;
+  int i;
+
+  qtmux = setup_qtmux (&srcvideotemplate, "video_%u", FALSE);
+  g_object_set (qtmux, "fragment-duration", 2000, "chunk-frames", 2,
+      "streamable", TRUE, NULL);
+  fail_unless (gst_element_set_state (qtmux,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+
+  caps = gst_pad_get_pad_template_caps (mysrcpad);
+  gst_pad_set_caps (mysrcpad, caps);
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* one keyframe and three delta frames, all well within one fragment */
+  for (i = 0; i < 4; i++) {
+    inbuffer = gst_buffer_new_and_alloc (1);
+    gst_buffer_memset (inbuffer, 0, 0, 1);
+    GST_BUFFER_TIMESTAMP (inbuffer) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (inbuffer) = 40 * GST_MSECOND;
+    if (i > 0)
+      GST_BUFFER_FLAG_SET (inbuffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()) == TRUE);
+
+  /* ftyp, moov, then two chunks of moof, mdat header and two samples */
+  num_buffers = g_list_length (buffers);
+  fail_unless_equals_int (num_buffers, 10);
+
+  cleanup_qtmux (qtmux, "video_%u");
+
+  for (i = 0; i < num_buffers; ++i) {
+    outbuffer = GST_BUFFER (buffers->data);
+    fail_if (outbuffer == NULL);
+    buffers = g_list_remove (buffers, outbuffer);
+
+    switch (i) {
+      case 2:                  /* moof starting the fragment */
+      case 6:                  /* moof continuing it */
+        fail_unless (gst_buffer_memcmp (outbuffer, 4, "moof", 4) == 0);
+        fail_unless (buffer_contains_fourcc (outbuffer, "tfdt"));
+        fail_unless_equals_int (!!GST_BUFFER_FLAG_IS_SET (outbuffer,
+                GST_BUFFER_FLAG_DELTA_UNIT), i == 6);
+        break;
+      case 3:
+      case 7:                  /* mdat header */
+        fail_unless_equals_int (gst_buffer_get_size (outbuffer), 8);
+        fail_unless (gst_buffer_memcmp (outbuffer, 4, "mdat", 4) == 0);
+        break;
+      case 4:
+      case 5:
+      case 8:
+      case 9:                  /* buffers we put in */
+        fail_unless_equals_int (gst_buffer_get_size (outbuffer), 1);
+        break;
+      default:
+        break;
+    }
+
+    gst_buffer_unref (outbuffer);
+  }
+
+  g_list_free (buffers);
+  buffers = NULL;
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_reuse)
 {
   GstElement *qtmux = setup_qtmux (&srcvideotemplate, "video_%u", TRUE);
@@ -1608,6 +1706,7 @@ qtmux_suite (void)
   tcase_add_test (tc_chain, test_audio_pad_frag_asc);
   tcase_add_test (tc_chain, test_video_pad_frag_asc_streamable);
   tcase_add_test (tc_chain, test_audio_pad_frag_asc_streamable);
+  tcase_add_test (tc_chain, test_video_pad_frag_chunked);
 
   tcase_add_test (tc_chain, test_average_bitrate);
 
@@ -1449,6 +1449,83 @@ GST_START_TEST (test_rtxsender_max_size_time)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtxsender_seqnum_wrap)
+{
+  const guint ssrc = 1234567;
+  GstStructure *pt_map;
+  GstElement *rtxsend;
+  GstPad *srcpad, *sinkpad;
+  GstCaps *caps;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  guint num_rtx_requests, num_rtx_packets;
+  gint i;
+
+  rtxsend = gst_check_setup_element ("rtprtxsend");
+  pt_map = gst_structure_new ("application/x-rtp-pt-map",
+      "96", G_TYPE_UINT, 99, NULL);
+  g_object_set (rtxsend, "max-size-packets", 100, "payload-type-map", pt_map,
+      NULL);
+  gst_structure_free (pt_map);
+
+  srcpad = gst_check_setup_src_pad (rtxsend, &srctemplate);
+  fail_unless_equals_int (gst_pad_set_active (srcpad, TRUE), TRUE);
+  sinkpad = gst_check_setup_sink_pad (rtxsend, &sinktemplate);
+  fail_unless_equals_int (gst_pad_set_active (sinkpad, TRUE), TRUE);
+
+  ASSERT_SET_STATE (rtxsend, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_from_string ("application/x-rtp, "
+      "media = (string)video, payload = (int)96, "
+      "ssrc = (uint)1234567, clock-rate = (int)90000, "
+      "encoding-name = (string)RAW");
+  gst_check_setup_events (srcpad, rtxsend, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  /* the history has to follow the seqnum across the wraparound */
+  for (i = 0; i < 12; i++) {
+    GstBuffer *buffer = gst_rtp_buffer_new_allocate (4, 0, 0);
+
+    gst_rtp_buffer_map (buffer, GST_MAP_WRITE, &rtp);
+    gst_rtp_buffer_set_ssrc (&rtp, ssrc);
+    gst_rtp_buffer_set_payload_type (&rtp, 96);
+    gst_rtp_buffer_set_seq (&rtp, (guint16) (65530 + i));
+    gst_rtp_buffer_set_timestamp (&rtp, i * 3000);
+    gst_rtp_buffer_unmap (&rtp);
+
+    fail_unless_equals_int (gst_pad_push (srcpad, buffer), GST_FLOW_OK);
+  }
+
+  /* 65529 and 6 were never sent */
+  fail_unless (gst_pad_push_event (sinkpad, create_rtx_event (65529, ssrc,
+              96)));
+  fail_unless (gst_pad_push_event (sinkpad, create_rtx_event (65530, ssrc,
+              96)));
+  fail_unless (gst_pad_push_event (sinkpad, create_rtx_event (0, ssrc, 96)));
+  fail_unless (gst_pad_push_event (sinkpad, create_rtx_event (5, ssrc, 96)));
+  fail_unless (gst_pad_push_event (sinkpad, create_rtx_event (6, ssrc, 96)));
+
+  /* wait for the retransmissions to be pushed out */
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 12 + 3) {
+    guint64 end_time = g_get_monotonic_time () + G_TIME_SPAN_SECOND;
+
+    fail_unless (g_cond_wait_until (&check_cond, &check_mutex, end_time));
+  }
+  g_mutex_unlock (&check_mutex);
+
+  g_object_get (rtxsend, "num-rtx-requests", &num_rtx_requests,
+      "num-rtx-packets", &num_rtx_packets, NULL);
+  fail_unless_equals_int (num_rtx_requests, 5);
+  fail_unless_equals_int (num_rtx_packets, 3);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_src_pad (rtxsend);
+  gst_check_teardown_sink_pad (rtxsend);
+  gst_check_teardown_element (rtxsend);
+}
+
+GST_END_TEST;
+
 static void
 compare_rtp_packets (GstBuffer * a, GstBuffer * b)
 {
@@ -1590,6 +1667,7 @@ rtprtx_suite (void)
   tcase_add_test (tc_chain, test_drop_multiple_sender);
   tcase_add_test (tc_chain, test_rtxsender_max_size_packets);
   tcase_add_test (tc_chain, test_rtxsender_max_size_time);
+  tcase_add_test (tc_chain, test_rtxsender_seqnum_wrap);
   tcase_add_test (tc_chain, test_rtxreceive_data_reconstruction);
 
   return s;
@@ -19,6 +19,7 @@
  */
 #include <gst/check/gstcheck.h>
 #include <gst/base/gstbasesink.h>
+#include <gio/gio.h>
 #include <stdlib.h>
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
@@ -155,6 +156,65 @@ GST_START_TEST (test_udpsink_bufferlist)
 
 GST_END_TEST;
 
+/* with GSO the packets are merged before sending, they still have to arrive
+ * as separate datagrams */
+GST_START_TEST (test_udpsink_gso)
+{
+  GSocketAddress *addr;
+  GInetAddress *inet_addr;
+  GSocket *socket;
+  GstSegment segment;
+  GstElement *udpsink;
+  GstPad *srcpad;
+  GstBufferList *list;
+  guint data_size;
+  gchar data[2 * (RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE)];
+  gint port, i;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, NULL);
+  fail_unless (socket != NULL);
+  inet_addr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (inet_addr, 0);
+  fail_unless (g_socket_bind (socket, addr, FALSE, NULL));
+  g_object_unref (addr);
+  g_object_unref (inet_addr);
+  addr = g_socket_get_local_address (socket, NULL);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (addr));
+  g_object_unref (addr);
+  g_socket_set_timeout (socket, 5);
+
+  list = create_buffer_list (&data_size);
+
+  udpsink = gst_check_setup_element ("udpsink");
+  g_object_set (udpsink, "host", "127.0.0.1", "port", port, "gso", TRUE,
+      NULL);
+
+  srcpad = gst_check_setup_src_pad_by_name (udpsink, &srctemplate, "sink");
+
+  gst_element_set_state (udpsink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+  for (i = 0; i < 2; i++) {
+    fail_unless_equals_int (g_socket_receive (socket, data, sizeof (data),
+            NULL, NULL), RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE);
+  }
+
+  gst_check_teardown_pad_by_name (udpsink, "sink");
+  gst_check_teardown_element (udpsink);
+
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_udpsink_client_add_remove)
 {
   GstElement *udpsink;
@@ -214,6 +274,7 @@ udpsink_suite (void)
 
   tcase_add_test (tc_chain, test_udpsink);
   tcase_add_test (tc_chain, test_udpsink_bufferlist);
+  tcase_add_test (tc_chain, test_udpsink_gso);
   tcase_add_test (tc_chain, test_udpsink_client_add_remove);
 
   return s;
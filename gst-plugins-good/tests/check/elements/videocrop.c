@@ -533,6 +533,87 @@ GST_START_TEST (test_passthrough)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+allocation_probe_cb (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  GstQuery *query = GST_PAD_PROBE_INFO_QUERY (info);
+
+  if (GST_QUERY_TYPE (query) == GST_QUERY_ALLOCATION) {
+    gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+    gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE, NULL);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_crop_meta)
+{
+  GstStateChangeReturn state_ret;
+  GstVideoCropTestContext ctx;
+  GstPad *pad;
+  GstCaps *caps;
+  GstBuffer *gen_buf = NULL;    /* buffer generated by videotestsrc */
+  GstVideoMeta *vmeta;
+  GstVideoCropMeta *cmeta;
+
+  videocrop_test_cropping_init_context (&ctx);
+
+  g_object_set (ctx.src, "num-buffers", 1, NULL);
+
+  pad = gst_element_get_static_pad (ctx.src, "src");
+  fail_unless (pad != NULL);
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, buffer_probe_cb,
+      &gen_buf, NULL);
+  gst_object_unref (pad);
+
+  /* make downstream claim support for the crop meta */
+  pad = gst_element_get_static_pad (ctx.sink, "sink");
+  fail_unless (pad != NULL);
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM,
+      allocation_probe_cb, NULL, NULL);
+  gst_object_unref (pad);
+
+  caps = gst_caps_from_string ("video/x-raw, format=(string)I420, "
+      "width=(int)320, height=(int)240, framerate=(fraction)1/1");
+  g_object_set (ctx.filter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  g_object_set (ctx.crop, "left", 8, "right", 8, "top", 4, "bottom", 6, NULL);
+
+  state_ret = gst_element_set_state (ctx.pipeline, GST_STATE_PAUSED);
+  fail_unless (state_ret != GST_STATE_CHANGE_FAILURE,
+      "couldn't set pipeline to PAUSED state");
+
+  state_ret = gst_element_get_state (ctx.pipeline, NULL, NULL, -1);
+  fail_unless (state_ret == GST_STATE_CHANGE_SUCCESS,
+      "pipeline failed to go to PAUSED state");
+
+  fail_unless (gen_buf != NULL);
+  fail_unless (ctx.last_buf != NULL);
+
+  /* the pixels should not have been copied */
+  fail_unless (gst_buffer_peek_memory (ctx.last_buf, 0) ==
+      gst_buffer_peek_memory (gen_buf, 0));
+
+  vmeta = gst_buffer_get_video_meta (ctx.last_buf);
+  fail_unless (vmeta != NULL);
+  fail_unless_equals_int (vmeta->width, 320);
+  fail_unless_equals_int (vmeta->height, 240);
+
+  cmeta = gst_buffer_get_video_crop_meta (ctx.last_buf);
+  fail_unless (cmeta != NULL);
+  fail_unless_equals_int (cmeta->x, 8);
+  fail_unless_equals_int (cmeta->y, 4);
+  fail_unless_equals_int (cmeta->width, 304);
+  fail_unless_equals_int (cmeta->height, 230);
+
+  videocrop_test_cropping_deinit_context (&ctx);
+
+  gst_buffer_unref (gen_buf);
+}
+
+GST_END_TEST;
+
 static gint
 notgst_value_list_get_nth_int (const GValue * list_val, guint n)
 {
@@ -810,6 +891,7 @@ videocrop_suite (void)
   tcase_add_test (tc_chain, test_crop_to_1x1);
   tcase_add_test (tc_chain, test_caps_transform);
   tcase_add_test (tc_chain, test_passthrough);
+  tcase_add_test (tc_chain, test_crop_meta);
   tcase_add_test (tc_chain, test_unit_sizes);
   tcase_add_loop_test (tc_chain, test_cropping, 0, 25);
 
@@ -853,7 +853,8 @@ gst_x264_enc_class_init (GstX264EncClass * klass)
       g_param_spec_uint ("threads", "Threads",
           "Number of threads used by the codec (0 for automatic)",
           0, G_MAXINT, ARG_THREADS_DEFAULT,
-          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
   /* NOTE: this first string append doesn't require the ':' delimiter but the
    * rest do */
   g_string_append_printf (x264enc_defaults, "threads=%d", ARG_THREADS_DEFAULT);
@@ -861,14 +862,16 @@ gst_x264_enc_class_init (GstX264EncClass * klass)
       g_param_spec_boolean ("sliced-threads", "Sliced Threads",
           "Low latency but lower efficiency threading",
           ARG_SLICED_THREADS_DEFAULT,
-          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
   g_string_append_printf (x264enc_defaults, ":sliced-threads=%d",
       ARG_SLICED_THREADS_DEFAULT);
   g_object_class_install_property (gobject_class, ARG_SYNC_LOOKAHEAD,
       g_param_spec_int ("sync-lookahead", "Sync Lookahead",
           "Number of buffer frames for threaded lookahead (-1 for automatic)",
           -1, 250, ARG_SYNC_LOOKAHEAD_DEFAULT,
-          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
   g_string_append_printf (x264enc_defaults, ":sync-lookahead=%d",
       ARG_SYNC_LOOKAHEAD_DEFAULT);
   g_object_class_install_property (gobject_class, ARG_MULTIPASS_CACHE_FILE,
@@ -1010,7 +1013,8 @@ gst_x264_enc_class_init (GstX264EncClass * klass)
       g_param_spec_int ("rc-lookahead", "Rate Control Lookahead",
           "Number of frames for frametype lookahead", 0, 250,
           ARG_RC_LOOKAHEAD_DEFAULT,
-          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
   g_string_append_printf (x264enc_defaults, ":rc-lookahead=%d",
       ARG_RC_LOOKAHEAD_DEFAULT);
   g_object_class_install_property (gobject_class, ARG_NR,
@@ -1129,67 +1133,6 @@ gst_x264_enc_init (GstX264Enc * encoder)
   encoder->x264param.i_log_level = X264_LOG_DEBUG;
 }
 
-typedef struct
-{
-  GstVideoCodecFrame *frame;
-  GstVideoFrame vframe;
-} FrameData;
-
-static FrameData *
-gst_x264_enc_queue_frame (GstX264Enc * enc, GstVideoCodecFrame * frame,
-    GstVideoInfo * info)
-{
-  GstVideoFrame vframe;
-  FrameData *fdata;
-
-  if (!gst_video_frame_map (&vframe, info, frame->input_buffer, GST_MAP_READ))
-    return NULL;
-
-  fdata = g_slice_new (FrameData);
-  fdata->frame = gst_video_codec_frame_ref (frame);
-  fdata->vframe = vframe;
-
-  enc->pending_frames = g_list_prepend (enc->pending_frames, fdata);
-
-  return fdata;
-}
-
-static void
-gst_x264_enc_dequeue_frame (GstX264Enc * enc, GstVideoCodecFrame * frame)
-{
-  GList *l;
-
-  for (l = enc->pending_frames; l; l = l->next) {
-    FrameData *fdata = l->data;
-
-    if (fdata->frame != frame)
-      continue;
-
-    gst_video_frame_unmap (&fdata->vframe);
-    gst_video_codec_frame_unref (fdata->frame);
-    g_slice_free (FrameData, fdata);
-
-    enc->pending_frames = g_list_delete_link (enc->pending_frames, l);
-    return;
-  }
-}
-
-static void
-gst_x264_enc_dequeue_all_frames (GstX264Enc * enc)
-{
-  GList *l;
-
-  for (l = enc->pending_frames; l; l = l->next) {
-    FrameData *fdata = l->data;
-
-    gst_video_frame_unmap (&fdata->vframe);
-    gst_video_codec_frame_unref (fdata->frame);
-    g_slice_free (FrameData, fdata);
-  }
-  g_list_free (enc->pending_frames);
-  enc->pending_frames = NULL;
-}
-
 static gboolean
 gst_x264_enc_start (GstVideoEncoder * encoder)
 {
@@ -1211,7 +1154,6 @@ gst_x264_enc_stop (GstVideoEncoder * encoder)
 
   gst_x264_enc_flush_frames (x264enc, FALSE);
   gst_x264_enc_close_encoder (x264enc);
-  gst_x264_enc_dequeue_all_frames (x264enc);
 
   if (x264enc->input_state)
     gst_video_codec_state_unref (x264enc->input_state);
@@ -1228,7 +1170,6 @@ gst_x264_enc_flush (GstVideoEncoder * encoder)
 
   gst_x264_enc_flush_frames (x264enc, FALSE);
   gst_x264_enc_close_encoder (x264enc);
-  gst_x264_enc_dequeue_all_frames (x264enc);
 
   gst_x264_enc_init_encoder (x264enc);
 
@@ -1576,6 +1517,7 @@ gst_x264_enc_init_encoder (GstX264Enc * encoder)
       encoder->x264param.i_frame_packing);
 
   encoder->reconfig = FALSE;
+  encoder->restart = FALSE;
 
   GST_OBJECT_UNLOCK (encoder);
 
@@ -2063,7 +2005,6 @@ gst_x264_enc_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
 {
   GstX264Enc *self = GST_X264_ENC (encoder);
   GstVideoInfo *info;
-  guint num_buffers;
 
   gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
 
@@ -2071,14 +2012,41 @@ gst_x264_enc_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
     return FALSE;
 
   info = &self->input_state->info;
-  num_buffers = x264_encoder_maximum_delayed_frames (self->x264enc) + 1;
 
-  gst_query_add_allocation_pool (query, NULL, info->size, num_buffers, 0);
+  /* x264 copies the input pictures into its own lookahead, the input
+   * buffers are released as soon as they were passed to the encoder */
+  gst_query_add_allocation_pool (query, NULL, info->size, 1, 0);
 
   return GST_VIDEO_ENCODER_CLASS (parent_class)->propose_allocation (encoder,
       query);
 }
 
+/* Restarts the encoder with the current properties. This is needed for
+ * the threading and lookahead settings, x264_encoder_reconfig() can't
+ * change them */
+static gboolean
+gst_x264_enc_restart_encoder (GstX264Enc * encoder)
+{
+  GST_INFO_OBJECT (encoder, "restarting encoder");
+
+  gst_x264_enc_flush_frames (encoder, TRUE);
+  gst_x264_enc_close_encoder (encoder);
+
+  encoder->sps_id++;
+
+  if (!gst_x264_enc_init_encoder (encoder))
+    return FALSE;
+
+  if (!gst_x264_enc_set_src_caps (encoder, encoder->input_state->caps)) {
+    gst_x264_enc_close_encoder (encoder);
+    return FALSE;
+  }
+
+  gst_x264_enc_set_latency (encoder);
+
+  return TRUE;
+}
+
 /* chain function
  * this function does the actual processing
  */
@@ -2090,38 +2058,58 @@ gst_x264_enc_handle_frame (GstVideoEncoder * video_enc,
   GstVideoInfo *info = &encoder->input_state->info;
   GstFlowReturn ret;
   x264_picture_t pic_in;
+  GstVideoFrame vframe;
+  GstBuffer *metadata;
+  gboolean restart;
   gint i_nal, i;
-  FrameData *fdata;
   gint nplanes = 0;
 
   if (G_UNLIKELY (encoder->x264enc == NULL))
     goto not_inited;
 
+  GST_OBJECT_LOCK (encoder);
+  restart = encoder->restart;
+  encoder->restart = FALSE;
+  GST_OBJECT_UNLOCK (encoder);
+
+  if (G_UNLIKELY (restart) && !gst_x264_enc_restart_encoder (encoder))
+    goto restart_failed;
+
   /* create x264_picture_t from the buffer */
   /* mostly taken from mplayer (file ve_x264.c) */
 
   /* set up input picture */
   memset (&pic_in, 0, sizeof (pic_in));
 
-  fdata = gst_x264_enc_queue_frame (encoder, frame, info);
-  if (!fdata)
+  if (!gst_video_frame_map (&vframe, info, frame->input_buffer, GST_MAP_READ))
     goto invalid_frame;
 
   pic_in.img.i_csp =
       gst_x264_enc_gst_to_x264_video_format (info->finfo->format, &nplanes);
   pic_in.img.i_plane = nplanes;
   for (i = 0; i < nplanes; i++) {
-    pic_in.img.plane[i] = GST_VIDEO_FRAME_COMP_DATA (&fdata->vframe, i);
-    pic_in.img.i_stride[i] = GST_VIDEO_FRAME_COMP_STRIDE (&fdata->vframe, i);
+    pic_in.img.plane[i] = GST_VIDEO_FRAME_COMP_DATA (&vframe, i);
+    pic_in.img.i_stride[i] = GST_VIDEO_FRAME_COMP_STRIDE (&vframe, i);
   }
 
   pic_in.i_type = X264_TYPE_AUTO;
   pic_in.i_pts = frame->pts;
   pic_in.opaque = GINT_TO_POINTER (frame->system_frame_number);
 
+  /* x264 copies the picture into its own frame when encoding, so the input
+   * buffer doesn't have to stay around while the frame is in the lookahead.
+   * Only keep the metadata so it can still be copied to the output, and give
+   * the memory back to upstream right away */
+  metadata = gst_buffer_new ();
+  gst_buffer_copy_into (metadata, frame->input_buffer,
+      GST_BUFFER_COPY_METADATA, 0, -1);
+  gst_buffer_unref (frame->input_buffer);
+  frame->input_buffer = metadata;
+
   ret = gst_x264_enc_encode_frame (encoder, &pic_in, frame, &i_nal, TRUE);
 
-  /* input buffer is released later on */
+  gst_video_frame_unmap (&vframe);
+
   return ret;
 
 /* ERRORS */
@@ -2130,6 +2118,12 @@ not_inited:
     GST_WARNING_OBJECT (encoder, "Got buffer before set_caps was called");
     return GST_FLOW_NOT_NEGOTIATED;
   }
+restart_failed:
+  {
+    GST_ELEMENT_ERROR (encoder, STREAM, ENCODE,
+        ("Can not restart x264 encoder."), (NULL));
+    return GST_FLOW_ERROR;
+  }
 invalid_frame:
   {
     GST_ERROR_OBJECT (encoder, "Failed to map frame");
@@ -2233,7 +2227,6 @@ gst_x264_enc_encode_frame (GstX264Enc * encoder, x264_picture_t * pic_in,
 
 out:
   if (frame) {
-    gst_x264_enc_dequeue_frame (encoder, frame);
     ret = gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (encoder), frame);
   }
 
@@ -2333,16 +2326,19 @@ gst_x264_enc_set_property (GObject * object, guint prop_id,
       encoder->threads = g_value_get_uint (value);
       g_string_append_printf (encoder->option_string, ":threads=%d",
           encoder->threads);
+      encoder->restart = TRUE;
       break;
     case ARG_SLICED_THREADS:
       encoder->sliced_threads = g_value_get_boolean (value);
       g_string_append_printf (encoder->option_string, ":sliced-threads=%d",
           encoder->sliced_threads);
+      encoder->restart = TRUE;
       break;
     case ARG_SYNC_LOOKAHEAD:
       encoder->sync_lookahead = g_value_get_int (value);
       g_string_append_printf (encoder->option_string, ":sync-lookahead=%d",
           encoder->sync_lookahead);
+      encoder->restart = TRUE;
       break;
     case ARG_MULTIPASS_CACHE_FILE:
       g_free (encoder->mp_cache_file);
@@ -2467,6 +2463,7 @@ gst_x264_enc_set_property (GObject * object, guint prop_id,
       encoder->rc_lookahead = g_value_get_int (value);
       g_string_append_printf (encoder->option_string, ":rc-lookahead=%d",
           encoder->rc_lookahead);
+      encoder->restart = TRUE;
       break;
     case ARG_NR:
       encoder->noise_reduction = g_value_get_uint (value);
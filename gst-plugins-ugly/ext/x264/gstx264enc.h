@@ -52,10 +52,6 @@ struct _GstX264Enc
   x264_param_t x264param;
   gint current_byte_stream;
 
-  /* List of frame/buffer mapping structs for
-   * pending frames */
-  GList *pending_frames;
-
   /* properties */
   guint threads;
   gboolean sliced_threads;
@@ -103,6 +99,8 @@ struct _GstX264Enc
 
   /* configuration changed  while playing */
   gboolean reconfig;
+  /* threading or lookahead changed while playing, needs a new encoder */
+  gboolean restart;
 
   /* from the downstream caps */
   const gchar *peer_profile;
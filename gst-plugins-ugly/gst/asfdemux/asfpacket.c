@@ -90,6 +90,33 @@ asf_packet_create_payload_buffer (AsfPacket * packet, const guint8 ** p_data,
       payload_len);
 }
 
+/* Turns a media object that was assembled from chained sub-buffers into a
+ * single buffer of the full media object size, so that fragments arriving
+ * out of order can be filled in at their offset */
+static void
+asf_payload_make_full_size (AsfPayload * payload)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  gsize size;
+
+  size = gst_buffer_get_size (payload->buf);
+  if (size >= payload->mo_size)
+    return;
+
+  buf = gst_buffer_new_allocate (NULL, payload->mo_size, NULL);
+  gst_buffer_copy_into (buf, payload->buf,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
+      GST_BUFFER_COPY_META, 0, -1);
+
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  gst_buffer_extract (payload->buf, 0, map.data, size);
+  gst_buffer_unmap (buf, &map);
+
+  gst_buffer_unref (payload->buf);
+  payload->buf = buf;
+}
+
 static AsfPayload *
 asf_payload_search_payloads_queue (AsfPayload * payload, GArray * payload_list)
 {
@@ -514,6 +541,7 @@ gst_asf_demux_parse_payload (GstASFDemux * demux, AsfPacket * packet,
       *p_size -= payload_len;
     } else {
       const guint8 *payload_data = *p_data;
+      guint payload_size = payload_len;
 
       g_assert (payload_len <= *p_size);
 
@@ -528,17 +556,24 @@ gst_asf_demux_parse_payload (GstASFDemux * demux, AsfPacket * packet,
                 asf_payload_find_previous_fragment (demux, &payload, stream))) {
           if (prev->buf == NULL || (payload.mo_size > 0
                   && payload.mo_size != prev->mo_size)
-              || payload.mo_offset >= gst_buffer_get_size (prev->buf)
-              || payload.mo_offset + payload_len >
-              gst_buffer_get_size (prev->buf)) {
+              || payload.mo_offset >= prev->mo_size
+              || payload.mo_offset + payload_len > prev->mo_size) {
             GST_WARNING_OBJECT (demux, "Offset doesn't match previous data?!");
+          } else if (payload.mo_offset == prev->buf_filled &&
+              gst_buffer_get_size (prev->buf) == prev->buf_filled) {
+            /* the usual case: fragments are payloaded with increasing
+             * mo_offset, so just chain a sub-buffer of this packet */
+            prev->buf = gst_buffer_append (prev->buf,
+                asf_packet_create_payload_buffer (packet, &payload_data,
+                    &payload_size, payload_len));
+            prev->buf_filled += payload_len;
+            GST_LOG_OBJECT (demux, "Merged media object fragments, size now %u",
+                prev->buf_filled);
           } else {
-            /* we assume fragments are payloaded with increasing mo_offset */
-            if (payload.mo_offset != prev->buf_filled) {
-              GST_WARNING_OBJECT (demux, "media object payload discontinuity: "
-                  "offset=%u vs buf_filled=%u", payload.mo_offset,
-                  prev->buf_filled);
-            }
+            GST_WARNING_OBJECT (demux, "media object payload discontinuity: "
+                "offset=%u vs buf_filled=%u", payload.mo_offset,
+                prev->buf_filled);
+            asf_payload_make_full_size (prev);
             gst_buffer_fill (prev->buf, payload.mo_offset,
                 payload_data, payload_len);
             prev->buf_filled =
@@ -551,10 +586,10 @@ gst_asf_demux_parse_payload (GstASFDemux * demux, AsfPacket * packet,
               "any previous fragment, ignoring payload");
         }
       } else {
-        GST_LOG_OBJECT (demux, "allocating buffer of size %u for fragmented "
-            "media object", payload.mo_size);
-        payload.buf = gst_buffer_new_allocate (NULL, payload.mo_size, NULL);
-        gst_buffer_fill (payload.buf, 0, payload_data, payload_len);
+        GST_LOG_OBJECT (demux, "first fragment of size %u of a fragmented "
+            "media object of size %u", payload_len, payload.mo_size);
+        payload.buf = asf_packet_create_payload_buffer (packet, &payload_data,
+            &payload_size, payload_len);
         payload.buf_filled = payload_len;
 
         gst_asf_payload_queue_for_stream (demux, &payload, stream);
@@ -616,6 +651,63 @@ gst_asf_demux_parse_payload (GstASFDemux * demux, AsfPacket * packet,
   return TRUE;
 }
 
+/* Only parses the packet header up to the send time, which is all that is
+ * needed to bisect the data object for a seek position */
+gboolean
+gst_asf_demux_parse_packet_send_time (GstASFDemux * demux, GstBuffer * buf,
+    GstClockTime * p_send_time)
+{
+  GstMapInfo map;
+  const guint8 *data;
+  guint8 ec_flags, flags1;
+  guint size;
+  gboolean ret = FALSE;
+
+  gst_buffer_map (buf, &map, GST_MAP_READ);
+  data = map.data;
+  size = map.size;
+
+  if (G_UNLIKELY (size < 2 + 4 + 2))
+    goto done;
+
+  ec_flags = GST_READ_UINT8 (data);
+  if ((ec_flags & 0x80) != 0) {
+    guint ec_len;
+
+    if (((ec_flags & 0x60) >> 5) == 0)
+      ec_len = ec_flags & 0x0f;
+    else
+      ec_len = 2;
+
+    if (size <= (1 + ec_len) + 2 + 4 + 2)
+      goto done;
+
+    data += 1 + ec_len;
+    size -= 1 + ec_len;
+  }
+
+  flags1 = GST_READ_UINT8 (data);
+  data += 2;
+  size -= 2;
+
+  /* packet length, sequence and padding */
+  if (asf_packet_read_varlen_int (flags1, 5, &data, &size) < 0 ||
+      asf_packet_read_varlen_int (flags1, 1, &data, &size) < 0 ||
+      asf_packet_read_varlen_int (flags1, 3, &data, &size) < 0 || size < 4)
+    goto done;
+
+  *p_send_time = GST_READ_UINT32_LE (data) * GST_MSECOND;
+  ret = TRUE;
+
+done:
+  gst_buffer_unmap (buf, &map);
+
+  if (!ret)
+    GST_DEBUG_OBJECT (demux, "could not parse packet send time");
+
+  return ret;
+}
+
 GstAsfDemuxParsePacketError
 gst_asf_demux_parse_packet (GstASFDemux * demux, GstBuffer * buf)
 {
@@ -65,6 +65,8 @@ typedef enum {
 
 GstAsfDemuxParsePacketError gst_asf_demux_parse_packet (GstASFDemux * demux, GstBuffer * buf);
 
+gboolean gst_asf_demux_parse_packet_send_time (GstASFDemux * demux, GstBuffer * buf, GstClockTime * p_send_time);
+
 #define gst_asf_payload_is_complete(payload) \
     ((payload)->buf_filled >= (payload)->mo_size)
 
@@ -101,6 +101,8 @@ static void
 gst_asf_demux_process_queued_extended_stream_objects (GstASFDemux * demux);
 static gboolean gst_asf_demux_pull_headers (GstASFDemux * demux,
     GstFlowReturn * pflow);
+static gboolean gst_asf_demux_pull_data (GstASFDemux * demux,
+    guint64 offset, guint size, GstBuffer ** p_buf, GstFlowReturn * p_flow);
 static void gst_asf_demux_pull_indices (GstASFDemux * demux);
 static void gst_asf_demux_reset_stream_state_after_discont (GstASFDemux * asf);
 static gboolean
@@ -629,6 +631,55 @@ gst_asf_demux_handle_seek_push (GstASFDemux * demux, GstEvent * event)
   return res;
 }
 
+/* Bisects the data object on the packet send times to find the last packet
+ * that was sent before @seek_time. Only works in pull mode; used when there
+ * is no simple index to look the position up in. */
+static gboolean
+gst_asf_demux_seek_bisect_packets (GstASFDemux * demux, guint * packet,
+    GstClockTime seek_time)
+{
+  GstClockTime target, send_time;
+  GstBuffer *buf;
+  guint lo, hi, mid;
+
+  if (G_UNLIKELY (demux->num_packets == 0 || demux->packet_size == 0))
+    return FALSE;
+
+  /* send times include the preroll */
+  target = seek_time + demux->preroll;
+
+  lo = 0;
+  hi = demux->num_packets - 1;
+
+  while (lo < hi) {
+    gboolean ok;
+
+    mid = lo + (hi - lo + 1) / 2;
+
+    if (!gst_asf_demux_pull_data (demux,
+            demux->data_offset + (guint64) mid * demux->packet_size,
+            demux->packet_size, &buf, NULL))
+      return FALSE;
+
+    ok = gst_asf_demux_parse_packet_send_time (demux, buf, &send_time);
+    gst_buffer_unref (buf);
+    if (!ok)
+      return FALSE;
+
+    if (send_time <= target)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+
+  GST_DEBUG_OBJECT (demux, "%" GST_TIME_FORMAT " => packet %u (bisected)",
+      GST_TIME_ARGS (seek_time), lo);
+
+  *packet = lo;
+
+  return TRUE;
+}
+
 static gboolean
 gst_asf_demux_handle_seek_event (GstASFDemux * demux, GstEvent * event)
 {
@@ -793,11 +844,13 @@ gst_asf_demux_handle_seek_event (GstASFDemux * demux, GstEvent * event)
           seek_time = 0;
       }
 
-      packet = (guint) gst_util_uint64_scale (demux->num_packets,
-          seek_time, demux->play_time);
+      if (!gst_asf_demux_seek_bisect_packets (demux, &packet, seek_time)) {
+        packet = (guint) gst_util_uint64_scale (demux->num_packets,
+            seek_time, demux->play_time);
 
-      if (packet > demux->num_packets)
-        packet = demux->num_packets;
+        if (packet > demux->num_packets)
+          packet = demux->num_packets;
+      }
     }
   } else {
     if (G_LIKELY (demux->keyunit_sync && !demux->accurate)) {
@@ -89,6 +89,12 @@ struct _GstRTSPClientPrivate
   guint sessions_cookie;
 
   gboolean drop_backlog;
+
+  /* interleaved data waiting to be written from the watch context */
+  gboolean batch_send;
+  GByteArray *batch;            /* protected by send_lock */
+  GSource *batch_source;        /* protected by send_lock */
+  GCond batch_cond;
 };
 
 static GMutex tunnels_lock;
@@ -98,9 +104,13 @@ static GHashTable *tunnels;     /* protected by tunnels_lock */
  * be superceeded by a cache object later */
 #define WATCH_BACKLOG_SIZE              100
 
+/* max amount of interleaved data collected before it is written */
+#define BATCH_MAX_SIZE                  (64 * 1024)
+
 #define DEFAULT_SESSION_POOL            NULL
 #define DEFAULT_MOUNT_POINTS            NULL
 #define DEFAULT_DROP_BACKLOG            TRUE
+#define DEFAULT_BATCH_SEND              FALSE
 
 enum
 {
@@ -108,6 +118,7 @@ enum
   PROP_SESSION_POOL,
   PROP_MOUNT_POINTS,
   PROP_DROP_BACKLOG,
+  PROP_BATCH_SEND,
   PROP_LAST
 };
 
@@ -157,6 +168,8 @@ static gchar *default_make_path_from_uri (GstRTSPClient * client,
     const GstRTSPUrl * uri);
 static void client_session_removed (GstRTSPSessionPool * pool,
     GstRTSPSession * session, GstRTSPClient * client);
+static GstRTSPResult do_send_message (GstRTSPClient * client,
+    GstRTSPMessage * message, gboolean close, gpointer user_data);
 
 G_DEFINE_TYPE (GstRTSPClient, gst_rtsp_client, G_TYPE_OBJECT);
 
@@ -198,6 +211,22 @@ gst_rtsp_client_class_init (GstRTSPClientClass * klass)
           "Drop data when the backlog queue is full",
           DEFAULT_DROP_BACKLOG, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPClient::batch-send:
+   *
+   * Don't write interleaved RTP and RTCP data from the streaming thread
+   * but collect it and write it in batches from the #GMainContext the client
+   * is attached to. With a #GstRTSPThreadPool that uses multiple threads,
+   * this spreads the writes for many TCP clients over those threads and
+   * reduces the number of writes per client.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SEND,
+      g_param_spec_boolean ("batch-send", "Batch Send",
+          "Write interleaved data in batches from the client context",
+          DEFAULT_BATCH_SEND, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_client_signals[SIGNAL_CLOSED] =
       g_signal_new ("closed", G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
       G_STRUCT_OFFSET (GstRTSPClientClass, closed), NULL, NULL,
@@ -323,6 +352,8 @@ gst_rtsp_client_init (GstRTSPClient * client)
   g_mutex_init (&priv->watch_lock);
   priv->close_seq = 0;
   priv->drop_backlog = DEFAULT_DROP_BACKLOG;
+  priv->batch_send = DEFAULT_BATCH_SEND;
+  g_cond_init (&priv->batch_cond);
   priv->transports =
       g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
       g_object_unref);
@@ -498,6 +529,7 @@ gst_rtsp_client_finalize (GObject * obj)
   g_mutex_clear (&priv->lock);
   g_mutex_clear (&priv->send_lock);
   g_mutex_clear (&priv->watch_lock);
+  g_cond_clear (&priv->batch_cond);
 
   G_OBJECT_CLASS (gst_rtsp_client_parent_class)->finalize (obj);
 }
@@ -519,6 +551,9 @@ gst_rtsp_client_get_property (GObject * object, guint propid,
     case PROP_DROP_BACKLOG:
       g_value_set_boolean (value, priv->drop_backlog);
       break;
+    case PROP_BATCH_SEND:
+      g_value_set_boolean (value, priv->batch_send);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -543,6 +578,11 @@ gst_rtsp_client_set_property (GObject * object, guint propid,
       priv->drop_backlog = g_value_get_boolean (value);
       g_mutex_unlock (&priv->lock);
       break;
+    case PROP_BATCH_SEND:
+      g_mutex_lock (&priv->lock);
+      priv->batch_send = g_value_get_boolean (value);
+      g_mutex_unlock (&priv->lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -770,6 +810,120 @@ no_prepare:
   }
 }
 
+/* called from the watch context */
+static gboolean
+write_batch (GstRTSPClient * client)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+  GByteArray *batch;
+
+  g_mutex_lock (&priv->send_lock);
+  if (priv->batch_source != g_main_current_source ())
+    goto done;
+
+  g_source_unref (priv->batch_source);
+  priv->batch_source = NULL;
+  batch = priv->batch;
+  priv->batch = NULL;
+  g_cond_broadcast (&priv->batch_cond);
+
+  if (batch != NULL) {
+    GstRTSPResult res;
+    guint size = batch->len;
+
+    /* takes ownership of the data */
+    res = gst_rtsp_watch_write_data (priv->send_data,
+        g_byte_array_free (batch, FALSE), size, NULL);
+    if (res == GST_RTSP_ENOMEM)
+      GST_WARNING_OBJECT (client, "backlog full, dropped %u bytes", size);
+  }
+
+done:
+  g_mutex_unlock (&priv->send_lock);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* called with the send_lock */
+static GstRTSPResult
+batch_send_data (GstRTSPClient * client, GstBuffer * buffer, guint8 channel)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+  gsize size;
+  guint8 *data;
+  guint len;
+
+  size = gst_buffer_get_size (buffer);
+  if (size > G_MAXUINT16)
+    goto too_big;
+
+  while (priv->batch && priv->batch->len > 0 &&
+      priv->batch->len + 4 + size > BATCH_MAX_SIZE) {
+    if (priv->drop_backlog) {
+      GST_DEBUG_OBJECT (client, "batch full, dropping data");
+      return GST_RTSP_ENOMEM;
+    }
+    GST_DEBUG_OBJECT (client, "waiting for batch to be written");
+    g_cond_wait_until (&priv->batch_cond, &priv->send_lock,
+        g_get_monotonic_time () + G_TIME_SPAN_SECOND);
+    if (priv->send_func != do_send_message)
+      return GST_RTSP_EINTR;
+  }
+
+  if (priv->batch == NULL)
+    priv->batch = g_byte_array_sized_new (BATCH_MAX_SIZE);
+
+  /* frame the data like gst_rtsp_message_init_data() messages */
+  len = priv->batch->len;
+  g_byte_array_set_size (priv->batch, len + 4 + size);
+  data = priv->batch->data + len;
+  data[0] = '$';
+  data[1] = channel;
+  GST_WRITE_UINT16_BE (data + 2, size);
+  gst_buffer_extract (buffer, 0, data + 4, size);
+
+  if (priv->batch_source == NULL) {
+    priv->batch_source = g_idle_source_new ();
+    g_source_set_callback (priv->batch_source, (GSourceFunc) write_batch,
+        g_object_ref (client), g_object_unref);
+    g_source_attach (priv->batch_source, priv->watch_context);
+  }
+  return GST_RTSP_OK;
+
+  /* ERRORS */
+too_big:
+  {
+    GST_WARNING_OBJECT (client, "packet of %" G_GSIZE_FORMAT " bytes too big "
+        "for interleaved data", size);
+    return GST_RTSP_EINVAL;
+  }
+}
+
+/* called with the send_lock, queues @buffer on our own watch by reference
+ * instead of serializing it into a message */
+static GstRTSPResult
+watch_send_data (GstRTSPClient * client, GstBuffer * buffer, guint8 channel)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+  GstRTSPResult ret;
+  GTimeVal time;
+
+  time.tv_sec = 1;
+  time.tv_usec = 0;
+
+  do {
+    ret = gst_rtsp_watch_write_buffer (priv->watch, channel, buffer, NULL);
+    if (ret != GST_RTSP_ENOMEM || priv->drop_backlog)
+      break;
+
+    /* queue was full, wait for more space */
+    GST_DEBUG_OBJECT (client, "waiting for backlog");
+    ret = gst_rtsp_watch_wait_backlog (priv->watch, &time);
+  } while (ret != GST_RTSP_EINTR);
+
+  return ret;
+}
+
 static gboolean
 do_send_data (GstBuffer * buffer, guint8 channel, GstRTSPClient * client)
 {
@@ -780,6 +934,19 @@ do_send_data (GstBuffer * buffer, guint8 channel, GstRTSPClient * client)
   guint8 *data;
   guint usize;
 
+  g_mutex_lock (&priv->send_lock);
+  /* when we send on our own watch, the data doesn't need to be copied into
+   * a message */
+  if (priv->send_func == do_send_message) {
+    if (priv->batch_send)
+      res = batch_send_data (client, buffer, channel);
+    else
+      res = watch_send_data (client, buffer, channel);
+    g_mutex_unlock (&priv->send_lock);
+    return res == GST_RTSP_OK;
+  }
+  g_mutex_unlock (&priv->send_lock);
+
   gst_rtsp_message_init_data (&message, channel);
 
   /* FIXME, need some sort of iovec RTSPMessage here */
@@ -3454,6 +3621,8 @@ gst_rtsp_client_set_send_func (GstRTSPClient * client,
   GstRTSPClientPrivate *priv;
   GDestroyNotify old_notify;
   gpointer old_data;
+  GSource *batch_source;
+  GByteArray *batch;
 
   g_return_if_fail (GST_IS_RTSP_CLIENT (client));
 
@@ -3465,8 +3634,21 @@ gst_rtsp_client_set_send_func (GstRTSPClient * client,
   old_data = priv->send_data;
   priv->send_notify = notify;
   priv->send_data = user_data;
+  /* pending batched data was for the old send func */
+  batch_source = priv->batch_source;
+  priv->batch_source = NULL;
+  batch = priv->batch;
+  priv->batch = NULL;
+  g_cond_broadcast (&priv->batch_cond);
   g_mutex_unlock (&priv->send_lock);
 
+  if (batch_source) {
+    g_source_destroy (batch_source);
+    g_source_unref (batch_source);
+  }
+  if (batch)
+    g_byte_array_free (batch, TRUE);
+
   if (old_notify)
     old_notify (old_data);
 }
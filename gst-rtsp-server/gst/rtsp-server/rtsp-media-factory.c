@@ -35,10 +35,20 @@
  * gst_rtsp_media_factory_construct() will return the same #GstRTSPMedia when
  * the url matches.
  *
+ * Media from a factory that is not shared can be constructed and prepared
+ * ahead of time by configuring a pool size with
+ * gst_rtsp_media_factory_set_pool_size(). After the first request for the
+ * factory, the pool is filled in the background for the most recently
+ * requested url and gst_rtsp_media_factory_construct() hands out an already
+ * prepared #GstRTSPMedia. The reset_media vmethod decides if a pooled media
+ * can be used for a url and can re-point it.
+ *
  * Last reviewed on 2013-07-11 (1.0.0)
  */
 
 #include "rtsp-media-factory.h"
+#include "rtsp-client.h"
+#include "rtsp-server-internal.h"
 
 #define GST_RTSP_MEDIA_FACTORY_GET_PRIVATE(obj)  \
        (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_RTSP_MEDIA_FACTORY, GstRTSPMediaFactoryPrivate))
@@ -69,6 +79,15 @@ struct _GstRTSPMediaFactoryPrivate
   GMutex medias_lock;
   GHashTable *medias;           /* protected by medias_lock */
 
+  /* pool of prepared media, all protected by medias_lock */
+  guint pool_size;
+  GQueue pooled;
+  guint pool_pending;
+  guint pool_generation;
+  GstRTSPUrl *pool_url;
+  gchar *pool_key;
+  GstRTSPThreadPool *pool_thread_pool;
+
   GType media_gtype;
 
   GstClock *clock;
@@ -87,6 +106,7 @@ struct _GstRTSPMediaFactoryPrivate
 #define DEFAULT_LATENCY         200
 #define DEFAULT_TRANSPORT_MODE  GST_RTSP_TRANSPORT_MODE_PLAY
 #define DEFAULT_STOP_ON_DISCONNECT TRUE
+#define DEFAULT_POOL_SIZE       0
 
 enum
 {
@@ -102,6 +122,7 @@ enum
   PROP_TRANSPORT_MODE,
   PROP_STOP_ON_DISCONNECT,
   PROP_CLOCK,
+  PROP_POOL_SIZE,
   PROP_LAST
 };
 
@@ -133,6 +154,12 @@ static void default_configure (GstRTSPMediaFactory * factory,
     GstRTSPMedia * media);
 static GstElement *default_create_pipeline (GstRTSPMediaFactory * factory,
     GstRTSPMedia * media);
+static gboolean default_reset_media (GstRTSPMediaFactory * factory,
+    GstRTSPMedia * media, const GstRTSPUrl * url);
+
+static void flush_pool (GstRTSPMediaFactory * factory);
+
+static GQuark pool_key_quark;
 
 G_DEFINE_TYPE (GstRTSPMediaFactory, gst_rtsp_media_factory, G_TYPE_OBJECT);
 
@@ -224,6 +251,21 @@ gst_rtsp_media_factory_class_init (GstRTSPMediaFactoryClass * klass)
           "medias of this factory", GST_TYPE_CLOCK,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPMediaFactory::pool-size:
+   *
+   * The amount of prepared media to keep ready for new clients when the
+   * media of this factory is not shared. See
+   * gst_rtsp_media_factory_set_pool_size().
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_POOL_SIZE,
+      g_param_spec_uint ("pool-size", "Pool Size",
+          "The amount of prepared media to keep ready for new clients",
+          0, G_MAXUINT, DEFAULT_POOL_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED] =
       g_signal_new ("media-constructed", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GstRTSPMediaFactoryClass,
@@ -241,6 +283,9 @@ gst_rtsp_media_factory_class_init (GstRTSPMediaFactoryClass * klass)
   klass->construct = default_construct;
   klass->configure = default_configure;
   klass->create_pipeline = default_create_pipeline;
+  klass->reset_media = default_reset_media;
+
+  pool_key_quark = g_quark_from_static_string ("GstRTSPMediaFactory.pool-key");
 
   GST_DEBUG_CATEGORY_INIT (rtsp_media_debug, "rtspmediafactory", 0,
       "GstRTSPMediaFactory");
@@ -270,6 +315,16 @@ gst_rtsp_media_factory_init (GstRTSPMediaFactory * factory)
   priv->medias = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, g_object_unref);
   priv->media_gtype = GST_TYPE_RTSP_MEDIA;
+  priv->pool_size = DEFAULT_POOL_SIZE;
+  g_queue_init (&priv->pooled);
+}
+
+static void
+discard_pooled_media (GstRTSPMedia * media)
+{
+  GST_DEBUG ("discard pooled media %p", media);
+  gst_rtsp_media_unprepare (media);
+  g_object_unref (media);
 }
 
 static void
@@ -280,6 +335,14 @@ gst_rtsp_media_factory_finalize (GObject * obj)
 
   if (priv->permissions)
     gst_rtsp_permissions_unref (priv->permissions);
+  /* refills hold a ref to the factory so none of them can be running */
+  g_queue_foreach (&priv->pooled, (GFunc) discard_pooled_media, NULL);
+  g_queue_clear (&priv->pooled);
+  if (priv->pool_url)
+    gst_rtsp_url_free (priv->pool_url);
+  g_free (priv->pool_key);
+  if (priv->pool_thread_pool)
+    g_object_unref (priv->pool_thread_pool);
   g_hash_table_unref (priv->medias);
   g_mutex_clear (&priv->medias_lock);
   g_free (priv->launch);
@@ -336,6 +399,9 @@ gst_rtsp_media_factory_get_property (GObject * object, guint propid,
     case PROP_CLOCK:
       g_value_take_object (value, gst_rtsp_media_factory_get_clock (factory));
       break;
+    case PROP_POOL_SIZE:
+      g_value_set_uint (value, gst_rtsp_media_factory_get_pool_size (factory));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -386,6 +452,9 @@ gst_rtsp_media_factory_set_property (GObject * object, guint propid,
     case PROP_CLOCK:
       gst_rtsp_media_factory_set_clock (factory, g_value_get_object (value));
       break;
+    case PROP_POOL_SIZE:
+      gst_rtsp_media_factory_set_pool_size (factory, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -525,6 +594,9 @@ gst_rtsp_media_factory_set_launch (GstRTSPMediaFactory * factory,
   g_free (priv->launch);
   priv->launch = g_strdup (launch);
   GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  /* pooled media was made with the old launch line */
+  flush_pool (factory);
 }
 
 /**
@@ -1107,6 +1179,79 @@ gst_rtsp_media_factory_get_latency (GstRTSPMediaFactory * factory)
   return res;
 }
 
+static void refill_pool (GstRTSPMediaFactory * factory);
+
+/**
+ * gst_rtsp_media_factory_set_pool_size:
+ * @factory: a #GstRTSPMediaFactory
+ * @size: the amount of prepared media to keep
+ *
+ * Configure the amount of media that @factory constructs and prepares ahead
+ * of time when its media is not shared. This moves the construction of the
+ * pipeline and its preroll out of the DESCRIBE request of new clients.
+ *
+ * The pool is filled in the background for the url of the most recent call
+ * to gst_rtsp_media_factory_construct() and refilled every time media is
+ * taken from it. The media-constructed and media-configure signals for
+ * pooled media are emitted from the thread that fills the pool. The pooled
+ * media is configured with the settings of @factory at the time it was
+ * constructed; changing the launch line discards it.
+ *
+ * A @size of 0 disables the pool and discards all pooled media.
+ *
+ * Since: 1.10
+ */
+void
+gst_rtsp_media_factory_set_pool_size (GstRTSPMediaFactory * factory,
+    guint size)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  GQueue excess = G_QUEUE_INIT;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_DEBUG_OBJECT (factory, "pool size %u", size);
+
+  g_mutex_lock (&priv->medias_lock);
+  priv->pool_size = size;
+  while (g_queue_get_length (&priv->pooled) > size)
+    g_queue_push_tail (&excess, g_queue_pop_tail (&priv->pooled));
+  refill_pool (factory);
+  g_mutex_unlock (&priv->medias_lock);
+
+  g_queue_foreach (&excess, (GFunc) discard_pooled_media, NULL);
+  g_queue_clear (&excess);
+}
+
+/**
+ * gst_rtsp_media_factory_get_pool_size:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Get the amount of media that @factory prepares ahead of time.
+ *
+ * Returns: the pool size.
+ *
+ * Since: 1.10
+ */
+guint
+gst_rtsp_media_factory_get_pool_size (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  guint res;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), 0);
+
+  priv = factory->priv;
+
+  g_mutex_lock (&priv->medias_lock);
+  res = priv->pool_size;
+  g_mutex_unlock (&priv->medias_lock);
+
+  return res;
+}
+
 static gboolean
 compare_media (gpointer key, GstRTSPMedia * media1, GstRTSPMedia * media2)
 {
@@ -1147,6 +1292,208 @@ weak_ref_free (GWeakRef * ref)
   g_slice_free (GWeakRef, ref);
 }
 
+/* construct and configure a new media for @url */
+static GstRTSPMedia *
+construct_media (GstRTSPMediaFactory * factory, const GstRTSPUrl * url)
+{
+  GstRTSPMediaFactoryClass *klass;
+  GstRTSPMedia *media;
+
+  klass = GST_RTSP_MEDIA_FACTORY_GET_CLASS (factory);
+
+  if (klass->construct) {
+    media = klass->construct (factory, url);
+    if (media)
+      g_signal_emit (factory,
+          gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED], 0, media,
+          NULL);
+  } else
+    media = NULL;
+
+  if (media) {
+    /* configure the media */
+    if (klass->configure)
+      klass->configure (factory, media);
+
+    g_signal_emit (factory,
+        gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONFIGURE], 0, media,
+        NULL);
+  }
+  return media;
+}
+
+static void
+flush_pool (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GQueue pooled;
+
+  g_mutex_lock (&priv->medias_lock);
+  /* refills that are running now will not add their media */
+  priv->pool_generation++;
+  pooled = priv->pooled;
+  g_queue_init (&priv->pooled);
+  g_mutex_unlock (&priv->medias_lock);
+
+  g_queue_foreach (&pooled, (GFunc) discard_pooled_media, NULL);
+  g_queue_clear (&pooled);
+}
+
+static void
+do_refill (GstRTSPMediaFactory * factory, gpointer user_data)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GstRTSPUrl *url;
+  gchar *key;
+  GstRTSPThreadPool *thread_pool;
+  GstRTSPThread *thread;
+  GstRTSPMedia *media;
+  guint generation;
+
+  g_mutex_lock (&priv->medias_lock);
+  url = gst_rtsp_url_copy (priv->pool_url);
+  key = g_strdup (priv->pool_key);
+  thread_pool = g_object_ref (priv->pool_thread_pool);
+  generation = priv->pool_generation;
+  g_mutex_unlock (&priv->medias_lock);
+
+  GST_DEBUG_OBJECT (factory, "refilling pool for url %s", url->abspath);
+
+  if (!(media = construct_media (factory, url)))
+    goto no_media;
+
+  if (gst_rtsp_media_is_shared (media))
+    goto is_shared;
+
+  thread = gst_rtsp_thread_pool_get_thread (thread_pool,
+      GST_RTSP_THREAD_TYPE_MEDIA, NULL);
+  if (thread == NULL)
+    goto no_thread;
+
+  if (!gst_rtsp_media_prepare (media, thread))
+    goto no_prepare;
+
+  g_object_set_qdata_full (G_OBJECT (media), pool_key_quark, key, g_free);
+  key = NULL;
+
+  g_mutex_lock (&priv->medias_lock);
+  if (generation == priv->pool_generation &&
+      g_queue_get_length (&priv->pooled) < priv->pool_size) {
+    GST_DEBUG_OBJECT (factory, "pooled media %p", media);
+    g_queue_push_tail (&priv->pooled, media);
+    media = NULL;
+  }
+  priv->pool_pending--;
+  g_mutex_unlock (&priv->medias_lock);
+
+  if (media)
+    discard_pooled_media (media);
+
+done:
+  g_free (key);
+  gst_rtsp_url_free (url);
+  g_object_unref (thread_pool);
+  g_object_unref (factory);
+  return;
+
+  /* ERRORS */
+no_media:
+  {
+    GST_WARNING_OBJECT (factory, "could not construct media for pool");
+    goto failed;
+  }
+is_shared:
+  {
+    GST_WARNING_OBJECT (factory, "not pooling shared media %p", media);
+    g_object_unref (media);
+    goto failed;
+  }
+no_thread:
+  {
+    GST_WARNING_OBJECT (factory, "could not get thread for pooled media");
+    g_object_unref (media);
+    goto failed;
+  }
+no_prepare:
+  {
+    GST_WARNING_OBJECT (factory, "could not prepare pooled media %p", media);
+    g_object_unref (media);
+    goto failed;
+  }
+failed:
+  {
+    g_mutex_lock (&priv->medias_lock);
+    priv->pool_pending--;
+    g_mutex_unlock (&priv->medias_lock);
+    goto done;
+  }
+}
+
+static gpointer
+create_refill_threads (gpointer data)
+{
+  return g_thread_pool_new ((GFunc) do_refill, NULL,
+      g_get_num_processors (), FALSE, NULL);
+}
+
+/* start constructing the media missing from the pool, must be called with
+ * medias_lock */
+static void
+refill_pool (GstRTSPMediaFactory * factory)
+{
+  static GOnce refill_once = G_ONCE_INIT;
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GThreadPool *refill_threads;
+
+  /* nothing requested yet */
+  if (priv->pool_url == NULL)
+    return;
+
+  refill_threads = g_once (&refill_once, create_refill_threads, NULL);
+
+  while (g_queue_get_length (&priv->pooled) + priv->pool_pending <
+      priv->pool_size) {
+    priv->pool_pending++;
+    g_thread_pool_push (refill_threads, g_object_ref (factory), NULL);
+  }
+}
+
+/* take a prepared media for @url from the pool */
+static GstRTSPMedia *
+take_pooled_media (GstRTSPMediaFactory * factory, const GstRTSPUrl * url)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GstRTSPMediaFactoryClass *klass;
+  GstRTSPMedia *media;
+
+  klass = GST_RTSP_MEDIA_FACTORY_GET_CLASS (factory);
+
+  while (TRUE) {
+    g_mutex_lock (&priv->medias_lock);
+    media = g_queue_pop_head (&priv->pooled);
+    g_mutex_unlock (&priv->medias_lock);
+
+    if (media == NULL)
+      break;
+
+    /* it could have hit an error or EOS while waiting in the pool */
+    if (gst_rtsp_media_get_status (media) != GST_RTSP_MEDIA_STATUS_PREPARED) {
+      discard_pooled_media (media);
+      continue;
+    }
+    if (klass->reset_media && !klass->reset_media (factory, media, url)) {
+      discard_pooled_media (media);
+      continue;
+    }
+    g_object_set_qdata (G_OBJECT (media), pool_key_quark, NULL);
+
+    /* the prepare of the caller takes over from here */
+    gst_rtsp_media_release_prepare (media);
+    break;
+  }
+  return media;
+}
+
 /**
  * gst_rtsp_media_factory_construct:
  * @factory: a #GstRTSPMediaFactory
@@ -1162,6 +1509,9 @@ weak_ref_free (GWeakRef * ref)
  * After the media is constructed, it can be configured and then prepared
  * with gst_rtsp_media_prepare ().
  *
+ * When a pool size is configured, the returned media can be taken from the
+ * pool and is then already prepared.
+ *
  * Returns: (transfer full): a new #GstRTSPMedia if the media could be prepared.
  */
 GstRTSPMedia *
@@ -1172,6 +1522,7 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
   gchar *key;
   GstRTSPMedia *media;
   GstRTSPMediaFactoryClass *klass;
+  gboolean use_pool;
 
   g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), NULL);
   g_return_val_if_fail (url != NULL, NULL);
@@ -1186,6 +1537,38 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
   else
     key = NULL;
 
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  use_pool = !priv->shared;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  g_mutex_lock (&priv->medias_lock);
+  use_pool = use_pool && priv->pool_size > 0;
+  if (use_pool) {
+    /* refill the pool for the url that was requested last */
+    if (priv->pool_url == NULL || g_strcmp0 (priv->pool_key, key) != 0) {
+      if (priv->pool_url)
+        gst_rtsp_url_free (priv->pool_url);
+      priv->pool_url = gst_rtsp_url_copy (url);
+      g_free (priv->pool_key);
+      priv->pool_key = g_strdup (key);
+    }
+    if (priv->pool_thread_pool == NULL) {
+      GstRTSPContext *ctx = gst_rtsp_context_get_current ();
+
+      /* prepare in the threads of the client when we can */
+      if (ctx && ctx->client)
+        priv->pool_thread_pool = gst_rtsp_client_get_thread_pool (ctx->client);
+      if (priv->pool_thread_pool == NULL)
+        priv->pool_thread_pool = gst_rtsp_thread_pool_new ();
+    }
+  }
+  g_mutex_unlock (&priv->medias_lock);
+
+  if (use_pool && (media = take_pooled_media (factory, url))) {
+    GST_INFO ("took pooled media %p for url %s", media, url->abspath);
+    goto done;
+  }
+
   g_mutex_lock (&priv->medias_lock);
   if (key) {
     /* we have a key, see if we find a cached media */
@@ -1197,24 +1580,9 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
 
   if (media == NULL) {
     /* nothing cached found, try to create one */
-    if (klass->construct) {
-      media = klass->construct (factory, url);
-      if (media)
-        g_signal_emit (factory,
-            gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED], 0, media,
-            NULL);
-    } else
-      media = NULL;
+    media = construct_media (factory, url);
 
     if (media) {
-      /* configure the media */
-      if (klass->configure)
-        klass->configure (factory, media);
-
-      g_signal_emit (factory,
-          gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONFIGURE], 0, media,
-          NULL);
-
       /* check if we can cache this media */
       if (gst_rtsp_media_is_shared (media)) {
         /* insert in the hashtable, takes ownership of the key */
@@ -1233,6 +1601,13 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
   }
   g_mutex_unlock (&priv->medias_lock);
 
+done:
+  if (use_pool) {
+    g_mutex_lock (&priv->medias_lock);
+    refill_pool (factory);
+    g_mutex_unlock (&priv->medias_lock);
+  }
+
   if (key)
     g_free (key);
 
@@ -1512,6 +1887,33 @@ default_create_pipeline (GstRTSPMediaFactory * factory, GstRTSPMedia * media)
   return pipeline;
 }
 
+static gboolean
+default_reset_media (GstRTSPMediaFactory * factory, GstRTSPMedia * media,
+    const GstRTSPUrl * url)
+{
+  GstRTSPMediaFactoryClass *klass;
+  const gchar *pool_key;
+  gchar *key;
+  gboolean res;
+
+  klass = GST_RTSP_MEDIA_FACTORY_GET_CLASS (factory);
+
+  /* the launch line does not depend on the url */
+  if (klass->construct == default_construct &&
+      klass->create_element == default_create_element)
+    return TRUE;
+
+  pool_key = g_object_get_qdata (G_OBJECT (media), pool_key_quark);
+  key = klass->gen_key ? klass->gen_key (factory, url) : NULL;
+  res = g_strcmp0 (key, pool_key) == 0;
+  g_free (key);
+
+  GST_DEBUG_OBJECT (factory, "pooled media %p for %s: %d", media,
+      url->abspath, res);
+
+  return res;
+}
+
 static void
 default_configure (GstRTSPMediaFactory * factory, GstRTSPMedia * media)
 {
@@ -76,6 +76,12 @@ struct _GstRTSPMediaFactory {
  *       implementation will configure the 'shared' property of the media.
  * @media_constructed: signal emited when a media was constructed
  * @media_configure: signal emited when a media should be configured
+ * @reset_media: check if @media, taken from the pool of prepared media, can be
+ *       used for @url and re-point it when needed. Return %FALSE to discard
+ *       @media and construct a new one. The default implementation accepts
+ *       @media when the default @construct and @create_element are used or
+ *       when @url has the same key as the url the pool was filled for.
+ *       Since: 1.10
  *
  * The #GstRTSPMediaFactory class structure.
  */
@@ -93,8 +99,11 @@ struct _GstRTSPMediaFactoryClass {
   void            (*media_constructed)  (GstRTSPMediaFactory *factory, GstRTSPMedia *media);
   void            (*media_configure)    (GstRTSPMediaFactory *factory, GstRTSPMedia *media);
 
+  gboolean        (*reset_media)        (GstRTSPMediaFactory *factory, GstRTSPMedia *media,
+                                         const GstRTSPUrl *url);
+
   /*< private >*/
-  gpointer         _gst_reserved[GST_PADDING_LARGE];
+  gpointer         _gst_reserved[GST_PADDING_LARGE-1];
 };
 
 GType                 gst_rtsp_media_factory_get_type     (void);
@@ -171,6 +180,10 @@ GstClock *            gst_rtsp_media_factory_get_clock        (GstRTSPMediaFacto
 void                    gst_rtsp_media_factory_set_publish_clock_mode (GstRTSPMediaFactory * factory, GstRTSPPublishClockMode mode);
 GstRTSPPublishClockMode gst_rtsp_media_factory_get_publish_clock_mode (GstRTSPMediaFactory * factory);
 
+void                  gst_rtsp_media_factory_set_pool_size    (GstRTSPMediaFactory * factory,
+                                                               guint                 size);
+guint                 gst_rtsp_media_factory_get_pool_size    (GstRTSPMediaFactory * factory);
+
 /* creating the media from the factory and a url */
 GstRTSPMedia *        gst_rtsp_media_factory_construct        (GstRTSPMediaFactory *factory,
                                                                const GstRTSPUrl *url);
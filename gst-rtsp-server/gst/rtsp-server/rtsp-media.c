@@ -80,6 +80,7 @@
 #define HMAC_80_KEY_LEN 10
 
 #include "rtsp-media.h"
+#include "rtsp-server-internal.h"
 
 #define GST_RTSP_MEDIA_GET_PRIVATE(obj)  \
      (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_RTSP_MEDIA, GstRTSPMediaPrivate))
@@ -3188,6 +3189,23 @@ is_busy:
   }
 }
 
+/* Drop the prepare count taken by the factory when it prepared @media ahead
+ * of time. The media stays prepared so that the next gst_rtsp_media_prepare()
+ * takes over the count and the matching gst_rtsp_media_unprepare() really
+ * unprepares it. */
+void
+gst_rtsp_media_release_prepare (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv = media->priv;
+
+  g_rec_mutex_lock (&priv->state_lock);
+  if (priv->prepare_count > 0)
+    priv->prepare_count--;
+  GST_INFO ("media %p released, prepared %d times", media,
+      priv->prepare_count);
+  g_rec_mutex_unlock (&priv->state_lock);
+}
+
 /* should be called with state-lock */
 static GstClock *
 get_clock_unlocked (GstRTSPMedia * media)
@@ -50,11 +50,18 @@
  * The server uses the configured #GstRTSPThreadPool object to handle the
  * remainder of the communication with this client.
  *
+ * With gst_rtsp_server_set_reuse_port() enabled, gst_rtsp_server_create_source()
+ * can be called multiple times to get several sources listening on the same
+ * port. When each of them is attached to a #GMainContext that runs in its own
+ * thread, the kernel spreads the incoming connections over these threads.
+ *
  * Last reviewed on 2013-07-11 (1.0.0)
  */
 #include <stdlib.h>
 #include <string.h>
 
+#include <gio/gnetworking.h>
+
 #include "rtsp-server.h"
 #include "rtsp-client.h"
 
@@ -73,8 +80,10 @@ struct _GstRTSPServerPrivate
   gchar *address;
   gchar *service;
   gint backlog;
+  gboolean reuse_port;
 
   GSocket *socket;
+  guint n_sources;
 
   /* sessions on this server */
   GstRTSPSessionPool *session_pool;
@@ -98,6 +107,7 @@ struct _GstRTSPServerPrivate
 /* #define DEFAULT_ADDRESS         "::0" */
 #define DEFAULT_SERVICE         "8554"
 #define DEFAULT_BACKLOG         5
+#define DEFAULT_REUSE_PORT      FALSE
 
 /* Define to use the SO_LINGER option so that the server sockets can be resused
  * sooner. Disabled for now because it is not very well implemented by various
@@ -111,6 +121,7 @@ enum
   PROP_SERVICE,
   PROP_BOUND_PORT,
   PROP_BACKLOG,
+  PROP_REUSE_PORT,
 
   PROP_SESSION_POOL,
   PROP_MOUNT_POINTS,
@@ -199,6 +210,19 @@ gst_rtsp_server_class_init (GstRTSPServerClass * klass)
           "The maximum length to which the queue "
           "of pending connections may grow", 0, G_MAXINT, DEFAULT_BACKLOG,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstRTSPServer::reuse-port:
+   *
+   * Allow multiple sockets to listen on the same port so that connections
+   * can be accepted from multiple threads. See
+   * gst_rtsp_server_set_reuse_port().
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_REUSE_PORT,
+      g_param_spec_boolean ("reuse-port", "Reuse port",
+          "Allow multiple server sockets to listen on the same port",
+          DEFAULT_REUSE_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   /**
    * GstRTSPServer::session-pool:
    *
@@ -246,6 +270,7 @@ gst_rtsp_server_init (GstRTSPServer * server)
   priv->service = g_strdup (DEFAULT_SERVICE);
   priv->socket = NULL;
   priv->backlog = DEFAULT_BACKLOG;
+  priv->reuse_port = DEFAULT_REUSE_PORT;
   priv->session_pool = gst_rtsp_session_pool_new ();
   priv->mount_points = gst_rtsp_mount_points_new ();
   priv->thread_pool = gst_rtsp_thread_pool_new ();
@@ -485,6 +510,63 @@ gst_rtsp_server_get_backlog (GstRTSPServer * server)
   return result;
 }
 
+/**
+ * gst_rtsp_server_set_reuse_port:
+ * @server: a #GstRTSPServer
+ * @reuse_port: %TRUE to allow multiple sockets on the same port
+ *
+ * Configure if the server sockets are created with the SO_REUSEPORT option.
+ * This makes it possible to create multiple sources for @server with
+ * gst_rtsp_server_create_source() that all listen on the same port and
+ * attach them to different #GMainContext to accept connections from multiple
+ * threads.
+ *
+ * This function must be called before the server is bound. It has no effect
+ * on systems without SO_REUSEPORT.
+ *
+ * Since: 1.10
+ */
+void
+gst_rtsp_server_set_reuse_port (GstRTSPServer * server, gboolean reuse_port)
+{
+  GstRTSPServerPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_SERVER (server));
+
+  priv = server->priv;
+
+  GST_RTSP_SERVER_LOCK (server);
+  priv->reuse_port = reuse_port;
+  GST_RTSP_SERVER_UNLOCK (server);
+}
+
+/**
+ * gst_rtsp_server_get_reuse_port:
+ * @server: a #GstRTSPServer
+ *
+ * Check if the server sockets are created with the SO_REUSEPORT option.
+ *
+ * Returns: %TRUE if multiple sockets can listen on the same port.
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_rtsp_server_get_reuse_port (GstRTSPServer * server)
+{
+  GstRTSPServerPrivate *priv;
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_RTSP_SERVER (server), FALSE);
+
+  priv = server->priv;
+
+  GST_RTSP_SERVER_LOCK (server);
+  result = priv->reuse_port;
+  GST_RTSP_SERVER_UNLOCK (server);
+
+  return result;
+}
+
 /**
  * gst_rtsp_server_set_session_pool:
  * @server: a #GstRTSPServer
@@ -733,6 +815,9 @@ gst_rtsp_server_get_property (GObject * object, guint propid,
     case PROP_BACKLOG:
       g_value_set_int (value, gst_rtsp_server_get_backlog (server));
       break;
+    case PROP_REUSE_PORT:
+      g_value_set_boolean (value, gst_rtsp_server_get_reuse_port (server));
+      break;
     case PROP_SESSION_POOL:
       g_value_take_object (value, gst_rtsp_server_get_session_pool (server));
       break;
@@ -760,6 +845,9 @@ gst_rtsp_server_set_property (GObject * object, guint propid,
     case PROP_BACKLOG:
       gst_rtsp_server_set_backlog (server, g_value_get_int (value));
       break;
+    case PROP_REUSE_PORT:
+      gst_rtsp_server_set_reuse_port (server, g_value_get_boolean (value));
+      break;
     case PROP_SESSION_POOL:
       gst_rtsp_server_set_session_pool (server, g_value_get_object (value));
       break;
@@ -845,6 +933,21 @@ gst_rtsp_server_create_socket (GstRTSPServer * server,
       continue;
     }
 
+    if (priv->reuse_port) {
+#ifdef SO_REUSEPORT
+      GError *opt_error = NULL;
+
+      if (!g_socket_set_option (socket, SOL_SOCKET, SO_REUSEPORT, TRUE,
+              &opt_error)) {
+        GST_WARNING_OBJECT (server, "failed to set SO_REUSEPORT: %s",
+            opt_error->message);
+        g_clear_error (&opt_error);
+      }
+#else
+      GST_WARNING_OBJECT (server, "SO_REUSEPORT is not supported");
+#endif
+    }
+
     if (g_socket_bind (socket, sockaddr, TRUE, bind_error ? NULL : &bind_error)) {
       /* ask what port the socket has been bound to */
       if (port == 0 || !strcmp (priv->service, "0")) {
@@ -1230,8 +1333,13 @@ watch_destroyed (GstRTSPServer * server)
 
   GST_DEBUG_OBJECT (server, "source destroyed");
 
-  g_object_unref (priv->socket);
-  priv->socket = NULL;
+  GST_RTSP_SERVER_LOCK (server);
+  /* keep the socket around as long as one of the sources listens */
+  if (--priv->n_sources == 0 && priv->socket) {
+    g_object_unref (priv->socket);
+    priv->socket = NULL;
+  }
+  GST_RTSP_SERVER_UNLOCK (server);
   g_object_unref (server);
 }
 
@@ -1273,6 +1381,7 @@ gst_rtsp_server_create_source (GstRTSPServer * server,
   GST_RTSP_SERVER_LOCK (server);
   old = priv->socket;
   priv->socket = g_object_ref (socket);
+  priv->n_sources++;
   GST_RTSP_SERVER_UNLOCK (server);
 
   if (old)
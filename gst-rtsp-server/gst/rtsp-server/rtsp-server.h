@@ -106,6 +106,9 @@ gchar *               gst_rtsp_server_get_service          (GstRTSPServer *serve
 void                  gst_rtsp_server_set_backlog          (GstRTSPServer *server, gint backlog);
 gint                  gst_rtsp_server_get_backlog          (GstRTSPServer *server);
 
+void                  gst_rtsp_server_set_reuse_port       (GstRTSPServer *server, gboolean reuse_port);
+gboolean              gst_rtsp_server_get_reuse_port       (GstRTSPServer *server);
+
 int                   gst_rtsp_server_get_bound_port       (GstRTSPServer *server);
 
 void                  gst_rtsp_server_set_session_pool     (GstRTSPServer *server, GstRTSPSessionPool *pool);
@@ -37,6 +37,10 @@
  * or use gst_rtsp_session_pool_create_watch() to be notified when session
  * cleanup should be performed.
  *
+ * The sessions are kept ordered by the time they will expire so that cleanup
+ * only has to look at the sessions that are due. Touching a session does not
+ * reorder it; its deadline is brought up to date when it comes due.
+ *
  * Last reviewed on 2013-07-11 (1.0.0)
  */
 
@@ -45,12 +49,25 @@
 #define GST_RTSP_SESSION_POOL_GET_PRIVATE(obj)  \
          (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_RTSP_SESSION_POOL, GstRTSPSessionPoolPrivate))
 
+typedef struct
+{
+  GstRTSPSession *session;
+  gint64 deadline;              /* monotonic time of the expiry in usec */
+  guint index;                  /* position in the expiry heap */
+  gulong notify_id;
+} SessionEntry;
+
 struct _GstRTSPSessionPoolPrivate
 {
   GMutex lock;                  /* protects everything in this struct */
   guint max_sessions;
-  GHashTable *sessions;
+  GHashTable *sessions;         /* session id -> SessionEntry */
   guint sessions_cookie;
+
+  /* binary min-heap of SessionEntry ordered by deadline. A deadline can be
+   * earlier than the real expiry time of the session when it was touched
+   * since. */
+  GPtrArray *expiry;
 };
 
 #define DEFAULT_MAX_SESSIONS 0
@@ -90,6 +107,7 @@ static void gst_rtsp_session_pool_finalize (GObject * object);
 static gchar *create_session_id (GstRTSPSessionPool * pool);
 static GstRTSPSession *create_session (GstRTSPSessionPool * pool,
     const gchar * id);
+static void session_entry_free (SessionEntry * entry);
 
 G_DEFINE_TYPE (GstRTSPSessionPool, gst_rtsp_session_pool, G_TYPE_OBJECT);
 
@@ -134,10 +152,169 @@ gst_rtsp_session_pool_init (GstRTSPSessionPool * pool)
 
   g_mutex_init (&priv->lock);
   priv->sessions = g_hash_table_new_full (g_str_hash, g_str_equal,
-      NULL, g_object_unref);
+      NULL, (GDestroyNotify) session_entry_free);
+  priv->expiry = g_ptr_array_new ();
   priv->max_sessions = DEFAULT_MAX_SESSIONS;
 }
 
+#define HEAP_ENTRY(priv,i) ((SessionEntry *) g_ptr_array_index ((priv)->expiry, (i)))
+
+static void
+heap_set (GstRTSPSessionPoolPrivate * priv, guint index, SessionEntry * entry)
+{
+  g_ptr_array_index (priv->expiry, index) = entry;
+  entry->index = index;
+}
+
+static void
+heap_sift_up (GstRTSPSessionPoolPrivate * priv, guint index)
+{
+  SessionEntry *entry = HEAP_ENTRY (priv, index);
+
+  while (index > 0) {
+    guint parent = (index - 1) / 2;
+
+    if (HEAP_ENTRY (priv, parent)->deadline <= entry->deadline)
+      break;
+    heap_set (priv, index, HEAP_ENTRY (priv, parent));
+    index = parent;
+  }
+  heap_set (priv, index, entry);
+}
+
+static void
+heap_sift_down (GstRTSPSessionPoolPrivate * priv, guint index)
+{
+  SessionEntry *entry = HEAP_ENTRY (priv, index);
+  guint len = priv->expiry->len;
+
+  while (TRUE) {
+    guint child = 2 * index + 1;
+
+    if (child >= len)
+      break;
+    if (child + 1 < len &&
+        HEAP_ENTRY (priv, child + 1)->deadline < HEAP_ENTRY (priv,
+            child)->deadline)
+      child++;
+    if (entry->deadline <= HEAP_ENTRY (priv, child)->deadline)
+      break;
+    heap_set (priv, index, HEAP_ENTRY (priv, child));
+    index = child;
+  }
+  heap_set (priv, index, entry);
+}
+
+static void
+heap_insert (GstRTSPSessionPoolPrivate * priv, SessionEntry * entry)
+{
+  g_ptr_array_add (priv->expiry, entry);
+  entry->index = priv->expiry->len - 1;
+  heap_sift_up (priv, entry->index);
+}
+
+static void
+heap_remove (GstRTSPSessionPoolPrivate * priv, SessionEntry * entry)
+{
+  guint index = entry->index;
+  SessionEntry *last;
+
+  last = g_ptr_array_remove_index_fast (priv->expiry, priv->expiry->len - 1);
+  if (last == entry)
+    return;
+
+  /* move the last entry in the hole and restore the heap order */
+  heap_set (priv, index, last);
+  heap_sift_up (priv, index);
+  heap_sift_down (priv, last->index);
+}
+
+/* recalculate the deadline of @entry, must be called with the lock */
+static void
+update_deadline (GstRTSPSessionPoolPrivate * priv, SessionEntry * entry,
+    gint64 now)
+{
+  gint timeout;
+
+  timeout = gst_rtsp_session_next_timeout_usec (entry->session, now);
+  entry->deadline = now + timeout * G_GINT64_CONSTANT (1000);
+
+  heap_sift_up (priv, entry->index);
+  heap_sift_down (priv, entry->index);
+}
+
+/* Bring the first entry of the heap up to date and return it. When the
+ * deadline of the returned entry is not after @now, the session expired.
+ * Must be called with the lock. */
+static SessionEntry *
+update_first_entry (GstRTSPSessionPoolPrivate * priv, gint64 now)
+{
+  while (priv->expiry->len > 0) {
+    SessionEntry *entry = HEAP_ENTRY (priv, 0);
+    gint timeout;
+
+    if (entry->deadline > now)
+      return entry;
+
+    timeout = gst_rtsp_session_next_timeout_usec (entry->session, now);
+    if (timeout == 0)
+      return entry;
+
+    /* touched since we last looked, move it back */
+    entry->deadline = now + timeout * G_GINT64_CONSTANT (1000);
+    heap_sift_down (priv, 0);
+  }
+  return NULL;
+}
+
+static void
+session_timeout_changed (GstRTSPSession * session, GParamSpec * pspec,
+    GstRTSPSessionPool * pool)
+{
+  GstRTSPSessionPoolPrivate *priv = pool->priv;
+  SessionEntry *entry;
+
+  g_mutex_lock (&priv->lock);
+  entry = g_hash_table_lookup (priv->sessions,
+      gst_rtsp_session_get_sessionid (session));
+  /* a lower timeout can make the session expire before its deadline */
+  if (entry && entry->session == session)
+    update_deadline (priv, entry, g_get_monotonic_time ());
+  g_mutex_unlock (&priv->lock);
+}
+
+static SessionEntry *
+session_entry_new (GstRTSPSessionPool * pool, GstRTSPSession * session)
+{
+  SessionEntry *entry;
+
+  entry = g_slice_new (SessionEntry);
+  entry->session = session;
+  entry->deadline = 0;
+  entry->index = 0;
+  entry->notify_id = g_signal_connect (session, "notify::timeout",
+      (GCallback) session_timeout_changed, pool);
+
+  return entry;
+}
+
+static void
+session_entry_free (SessionEntry * entry)
+{
+  g_signal_handler_disconnect (entry->session, entry->notify_id);
+  g_object_unref (entry->session);
+  g_slice_free (SessionEntry, entry);
+}
+
+/* remove @entry from the pool, must be called with the lock */
+static void
+remove_entry (GstRTSPSessionPoolPrivate * priv, SessionEntry * entry)
+{
+  heap_remove (priv, entry);
+  g_hash_table_remove (priv->sessions,
+      gst_rtsp_session_get_sessionid (entry->session));
+}
+
 static GstRTSPFilterResult
 remove_sessions_func (GstRTSPSessionPool * pool, GstRTSPSession * session,
     gpointer user_data)
@@ -153,6 +330,7 @@ gst_rtsp_session_pool_finalize (GObject * object)
 
   gst_rtsp_session_pool_filter (pool, remove_sessions_func, NULL);
   g_hash_table_unref (priv->sessions);
+  g_ptr_array_unref (priv->expiry);
   g_mutex_clear (&priv->lock);
 
   G_OBJECT_CLASS (gst_rtsp_session_pool_parent_class)->finalize (object);
@@ -296,7 +474,8 @@ GstRTSPSession *
 gst_rtsp_session_pool_find (GstRTSPSessionPool * pool, const gchar * sessionid)
 {
   GstRTSPSessionPoolPrivate *priv;
-  GstRTSPSession *result;
+  SessionEntry *entry;
+  GstRTSPSession *result = NULL;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), NULL);
   g_return_val_if_fail (sessionid != NULL, NULL);
@@ -304,9 +483,10 @@ gst_rtsp_session_pool_find (GstRTSPSessionPool * pool, const gchar * sessionid)
   priv = pool->priv;
 
   g_mutex_lock (&priv->lock);
-  result = g_hash_table_lookup (priv->sessions, sessionid);
-  if (result) {
-    g_object_ref (result);
+  entry = g_hash_table_lookup (priv->sessions, sessionid);
+  if (entry) {
+    result = g_object_ref (entry->session);
+    /* the deadline is updated when it comes due */
     gst_rtsp_session_touch (result);
   }
   g_mutex_unlock (&priv->lock);
@@ -377,23 +557,25 @@ gst_rtsp_session_pool_create (GstRTSPSessionPool * pool)
         goto too_many_sessions;
     }
     /* check if the sessionid existed */
-    result = g_hash_table_lookup (priv->sessions, id);
-    if (result) {
+    if (g_hash_table_contains (priv->sessions, id)) {
       /* found, retry with a different session id */
-      result = NULL;
       retry++;
       if (retry > 100)
         goto collision;
     } else {
+      SessionEntry *entry;
+
       /* not found, create session and insert it in the pool */
       if (klass->create_session)
         result = create_session (pool, id);
       if (result == NULL)
         goto too_many_sessions;
       /* take additional ref for the pool */
-      g_object_ref (result);
+      entry = session_entry_new (pool, g_object_ref (result));
       g_hash_table_insert (priv->sessions,
-          (gchar *) gst_rtsp_session_get_sessionid (result), result);
+          (gchar *) gst_rtsp_session_get_sessionid (result), entry);
+      heap_insert (priv, entry);
+      update_deadline (priv, entry, g_get_monotonic_time ());
       priv->sessions_cookie++;
     }
     g_mutex_unlock (&priv->lock);
@@ -443,6 +625,7 @@ gboolean
 gst_rtsp_session_pool_remove (GstRTSPSessionPool * pool, GstRTSPSession * sess)
 {
   GstRTSPSessionPoolPrivate *priv;
+  SessionEntry *entry;
   gboolean found;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), FALSE);
@@ -452,11 +635,13 @@ gst_rtsp_session_pool_remove (GstRTSPSessionPool * pool, GstRTSPSession * sess)
 
   g_mutex_lock (&priv->lock);
   g_object_ref (sess);
-  found =
-      g_hash_table_remove (priv->sessions,
+  entry = g_hash_table_lookup (priv->sessions,
       gst_rtsp_session_get_sessionid (sess));
-  if (found)
+  found = (entry != NULL);
+  if (found) {
+    remove_entry (priv, entry);
     priv->sessions_cookie++;
+  }
   g_mutex_unlock (&priv->lock);
 
   if (found)
@@ -468,34 +653,12 @@ gst_rtsp_session_pool_remove (GstRTSPSessionPool * pool, GstRTSPSession * sess)
   return found;
 }
 
-typedef struct
-{
-  gint64 now_monotonic_time;
-  GstRTSPSessionPool *pool;
-  GList *removed;
-} CleanupData;
-
-static gboolean
-cleanup_func (gchar * sessionid, GstRTSPSession * sess, CleanupData * data)
-{
-  gboolean expired;
-
-  expired = gst_rtsp_session_is_expired_usec (sess, data->now_monotonic_time);
-
-  if (expired) {
-    GST_DEBUG ("session expired");
-    data->removed = g_list_prepend (data->removed, g_object_ref (sess));
-  }
-
-  return expired;
-}
-
 /**
  * gst_rtsp_session_pool_cleanup:
  * @pool: a #GstRTSPSessionPool
  *
- * Inspect all the sessions in @pool and remove the sessions that are inactive
- * for more than their timeout.
+ * Inspect the sessions in @pool that are due and remove the sessions that
+ * are inactive for more than their timeout.
  *
  * Returns: the amount of sessions that got removed.
  */
@@ -503,28 +666,29 @@ guint
 gst_rtsp_session_pool_cleanup (GstRTSPSessionPool * pool)
 {
   GstRTSPSessionPoolPrivate *priv;
-  guint result;
-  CleanupData data;
-  GList *walk;
+  guint result = 0;
+  gint64 now;
+  SessionEntry *entry;
+  GList *removed = NULL, *walk;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), 0);
 
   priv = pool->priv;
 
-  data.now_monotonic_time = g_get_monotonic_time ();
-
-  data.pool = pool;
-  data.removed = NULL;
+  now = g_get_monotonic_time ();
 
   g_mutex_lock (&priv->lock);
-  result =
-      g_hash_table_foreach_remove (priv->sessions, (GHRFunc) cleanup_func,
-      &data);
+  while ((entry = update_first_entry (priv, now)) && entry->deadline <= now) {
+    GST_DEBUG ("session expired");
+    removed = g_list_prepend (removed, g_object_ref (entry->session));
+    remove_entry (priv, entry);
+    result++;
+  }
   if (result > 0)
     priv->sessions_cookie++;
   g_mutex_unlock (&priv->lock);
 
-  for (walk = data.removed; walk; walk = walk->next) {
+  for (walk = removed; walk; walk = walk->next) {
     GstRTSPSession *sess = walk->data;
 
     g_signal_emit (pool,
@@ -532,7 +696,7 @@ gst_rtsp_session_pool_cleanup (GstRTSPSessionPool * pool)
 
     g_object_unref (sess);
   }
-  g_list_free (data.removed);
+  g_list_free (removed);
 
   return result;
 }
@@ -587,7 +751,8 @@ restart:
   g_hash_table_iter_init (&iter, priv->sessions);
   cookie = priv->sessions_cookie;
   while (g_hash_table_iter_next (&iter, &key, &value)) {
-    GstRTSPSession *session = value;
+    SessionEntry *entry = value;
+    GstRTSPSession *session = entry->session;
     GstRTSPFilterResult res;
     gboolean changed;
 
@@ -612,11 +777,16 @@ restart:
       {
         gboolean removed = TRUE;
 
-        if (changed)
+        if (changed) {
           /* something changed, check if we still have the session */
-          removed = g_hash_table_remove (priv->sessions, key);
-        else
+          entry = g_hash_table_lookup (priv->sessions, key);
+          removed = (entry != NULL && entry->session == session);
+          if (removed)
+            remove_entry (priv, entry);
+        } else {
+          heap_remove (priv, entry);
           g_hash_table_iter_remove (&iter);
+        }
 
         if (removed) {
           /* if we managed to remove the session, update the cookie and
@@ -660,34 +830,30 @@ typedef struct
   gint timeout;
 } GstPoolSource;
 
-static void
-collect_timeout (gchar * sessionid, GstRTSPSession * sess, GstPoolSource * psrc)
-{
-  gint timeout;
-  gint64 now_monotonic_time;
-
-  now_monotonic_time = g_get_monotonic_time ();
-
-  timeout = gst_rtsp_session_next_timeout_usec (sess, now_monotonic_time);
-
-  GST_INFO ("%p: next timeout: %d", sess, timeout);
-  if (psrc->timeout == -1 || timeout < psrc->timeout)
-    psrc->timeout = timeout;
-}
-
 static gboolean
 gst_pool_source_prepare (GSource * source, gint * timeout)
 {
   GstRTSPSessionPoolPrivate *priv;
   GstPoolSource *psrc;
+  SessionEntry *entry;
   gboolean result;
+  gint64 now;
 
   psrc = (GstPoolSource *) source;
   psrc->timeout = -1;
   priv = psrc->pool->priv;
 
+  now = g_get_monotonic_time ();
+
+  /* only the first session in the heap can be the next to expire */
   g_mutex_lock (&priv->lock);
-  g_hash_table_foreach (priv->sessions, (GHFunc) collect_timeout, psrc);
+  if ((entry = update_first_entry (priv, now))) {
+    if (entry->deadline <= now)
+      psrc->timeout = 0;
+    else
+      psrc->timeout = MIN ((entry->deadline - now + 999) / 1000, G_MAXINT);
+    GST_INFO ("%p: next timeout: %d", entry->session, psrc->timeout);
+  }
   g_mutex_unlock (&priv->lock);
 
   if (timeout)
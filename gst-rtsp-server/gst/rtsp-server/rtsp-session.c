@@ -508,14 +508,20 @@ void
 gst_rtsp_session_set_timeout (GstRTSPSession * session, guint timeout)
 {
   GstRTSPSessionPrivate *priv;
+  gboolean changed;
 
   g_return_if_fail (GST_IS_RTSP_SESSION (session));
 
   priv = session->priv;
 
   g_mutex_lock (&priv->lock);
+  changed = (priv->timeout != timeout);
   priv->timeout = timeout;
   g_mutex_unlock (&priv->lock);
+
+  /* lets a session pool reschedule the expiry of the session */
+  if (changed)
+    g_object_notify (G_OBJECT (session), "timeout");
 }
 
 /**
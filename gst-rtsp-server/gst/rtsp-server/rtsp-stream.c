@@ -161,6 +161,13 @@ struct _GstRTSPStreamPrivate
   guint tr_cache_cookie_rtp;
   guint tr_cache_cookie_rtcp;
 
+  /* RTP packets shared by the TCP transports, only used from the streaming
+   * thread */
+  guint ring_size;
+  GstBuffer **ring;
+  guint64 ring_head;            /* number of packets queued so far */
+  GHashTable *ring_cursors;     /* GstRTSPStreamTransport -> guint64 */
+
 
   gint dscp_qos;
 
@@ -319,6 +326,16 @@ gst_rtsp_stream_finalize (GObject * obj)
   g_hash_table_unref (priv->keys);
   g_hash_table_destroy (priv->ptmap);
 
+  if (priv->ring) {
+    guint i;
+
+    for (i = 0; i < priv->ring_size; i++)
+      gst_buffer_replace (&priv->ring[i], NULL);
+    g_free (priv->ring);
+  }
+  if (priv->ring_cursors)
+    g_hash_table_unref (priv->ring_cursors);
+
   /* We expect all udpsrcs to be cleaned up by this point. */
   if (g_hash_table_size (priv->udpsrcs) > 0)
     g_critical ("Unreffing udpsrcs hash table that contains elements.");
@@ -675,6 +692,102 @@ gst_rtsp_stream_get_dscp_qos (GstRTSPStream * stream)
   return priv->dscp_qos;
 }
 
+static void
+free_ring_cursor (guint64 * cursor)
+{
+  g_slice_free (guint64, cursor);
+}
+
+/**
+ * gst_rtsp_stream_set_tcp_ring_size:
+ * @stream: a #GstRTSPStream
+ * @size: the number of RTP packets to keep, 0 to disable
+ *
+ * Keep the last @size RTP packets of @stream in a ring that is shared by all
+ * TCP transports. Each TCP transport sends from its own position in the ring.
+ * When a packet can't be sent to a transport, for example because its
+ * backlog is full, it is retried when the next packet arrives instead of
+ * being dropped. A transport that falls more than @size packets behind
+ * continues with the most recent key unit in the ring.
+ *
+ * This function must be called before @stream is joined to a bin.
+ *
+ * Since: 1.10
+ */
+void
+gst_rtsp_stream_set_tcp_ring_size (GstRTSPStream * stream, guint size)
+{
+  GstRTSPStreamPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->lock);
+  if (priv->is_joined)
+    goto was_joined;
+
+  if (priv->ring) {
+    guint i;
+
+    for (i = 0; i < priv->ring_size; i++)
+      gst_buffer_replace (&priv->ring[i], NULL);
+    g_free (priv->ring);
+    priv->ring = NULL;
+  }
+  if (priv->ring_cursors) {
+    g_hash_table_unref (priv->ring_cursors);
+    priv->ring_cursors = NULL;
+  }
+
+  priv->ring_size = size;
+  priv->ring_head = 0;
+  if (size > 0) {
+    priv->ring = g_new0 (GstBuffer *, size);
+    priv->ring_cursors = g_hash_table_new_full (NULL, NULL, NULL,
+        (GDestroyNotify) free_ring_cursor);
+  }
+  g_mutex_unlock (&priv->lock);
+
+  return;
+
+  /* ERRORS */
+was_joined:
+  {
+    GST_WARNING_OBJECT (stream, "can't change the ring size when joined");
+    g_mutex_unlock (&priv->lock);
+    return;
+  }
+}
+
+/**
+ * gst_rtsp_stream_get_tcp_ring_size:
+ * @stream: a #GstRTSPStream
+ *
+ * Get the number of RTP packets that are kept for the TCP transports of
+ * @stream.
+ *
+ * Returns: the size of the ring, or 0 when disabled.
+ *
+ * Since: 1.10
+ */
+guint
+gst_rtsp_stream_get_tcp_ring_size (GstRTSPStream * stream)
+{
+  GstRTSPStreamPrivate *priv;
+  guint result;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), 0);
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->lock);
+  result = priv->ring_size;
+  g_mutex_unlock (&priv->lock);
+
+  return result;
+}
+
 /**
  * gst_rtsp_stream_is_transport_supported:
  * @stream: a #GstRTSPStream
@@ -2062,6 +2175,91 @@ clear_tr_cache (GstRTSPStreamPrivate * priv, gboolean is_rtp)
   }
 }
 
+/* find where a transport that lost packets should continue in the ring: the
+ * most recent packet that starts a key unit */
+static guint64
+ring_catch_up (GstRTSPStreamPrivate * priv, guint64 oldest, guint64 head)
+{
+  guint64 pos;
+
+  for (pos = head; pos > oldest; pos--) {
+    GstBuffer *buf = priv->ring[(pos - 1) % priv->ring_size];
+
+    if (!GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT))
+      return pos - 1;
+  }
+  return head - 1;
+}
+
+/* called from the streaming thread */
+static void
+send_rtp_ring (GstRTSPStream * stream, GstBuffer * buffer)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  guint64 head, oldest;
+  GList *walk;
+
+  /* queue the packet, this drops the oldest one */
+  gst_buffer_replace (&priv->ring[priv->ring_head % priv->ring_size], buffer);
+  head = ++priv->ring_head;
+  oldest = head > priv->ring_size ? head - priv->ring_size : 0;
+
+  for (walk = priv->tr_cache_rtp; walk; walk = g_list_next (walk)) {
+    GstRTSPStreamTransport *tr = (GstRTSPStreamTransport *) walk->data;
+    const GstRTSPTransport *t = gst_rtsp_stream_transport_get_transport (tr);
+    guint64 *cursor;
+
+    if (t->lower_transport != GST_RTSP_LOWER_TRANS_TCP) {
+      gst_rtsp_stream_transport_send_rtp (tr, buffer);
+      continue;
+    }
+
+    cursor = g_hash_table_lookup (priv->ring_cursors, tr);
+    if (cursor == NULL) {
+      /* new transports start with the current packet */
+      cursor = g_slice_new (guint64);
+      *cursor = head - 1;
+      g_hash_table_insert (priv->ring_cursors, tr, cursor);
+    } else if (*cursor < oldest) {
+      guint64 pos = ring_catch_up (priv, oldest, head);
+
+      GST_DEBUG_OBJECT (stream, "transport %p lost %" G_GUINT64_FORMAT
+          " packets", tr, pos - *cursor);
+      *cursor = pos;
+    }
+
+    while (*cursor < head) {
+      GstBuffer *buf = priv->ring[*cursor % priv->ring_size];
+
+      if (!gst_rtsp_stream_transport_send_rtp (tr, buf))
+        break;
+      (*cursor)++;
+    }
+  }
+}
+
+/* called with the lock, keep the ring cursors of the current transports */
+static void
+update_ring_cursors (GstRTSPStreamPrivate * priv)
+{
+  GHashTable *cursors;
+  GList *walk;
+
+  cursors = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) free_ring_cursor);
+  for (walk = priv->transports; walk; walk = g_list_next (walk)) {
+    gpointer cursor;
+
+    if (g_hash_table_lookup_extended (priv->ring_cursors, walk->data, NULL,
+            &cursor)) {
+      g_hash_table_steal (priv->ring_cursors, walk->data);
+      g_hash_table_insert (cursors, walk->data, cursor);
+    }
+  }
+  g_hash_table_unref (priv->ring_cursors);
+  priv->ring_cursors = cursors;
+}
+
 static GstFlowReturn
 handle_new_sample (GstAppSink * sink, gpointer user_data)
 {
@@ -2091,6 +2289,8 @@ handle_new_sample (GstAppSink * sink, gpointer user_data)
         priv->tr_cache_rtp =
             g_list_prepend (priv->tr_cache_rtp, g_object_ref (tr));
       }
+      if (priv->ring_cursors)
+        update_ring_cursors (priv);
       priv->tr_cache_cookie_rtp = priv->transports_cookie;
     }
   } else {
@@ -2106,7 +2306,9 @@ handle_new_sample (GstAppSink * sink, gpointer user_data)
   }
   g_mutex_unlock (&priv->lock);
 
-  if (is_rtp) {
+  if (is_rtp && priv->ring) {
+    send_rtp_ring (stream, buffer);
+  } else if (is_rtp) {
     for (walk = priv->tr_cache_rtp; walk; walk = g_list_next (walk)) {
       GstRTSPStreamTransport *tr = (GstRTSPStreamTransport *) walk->data;
       gst_rtsp_stream_transport_send_rtp (tr, buffer);
@@ -84,6 +84,9 @@ guint             gst_rtsp_stream_get_mtu          (GstRTSPStream *stream);
 void              gst_rtsp_stream_set_dscp_qos     (GstRTSPStream *stream, gint dscp_qos);
 gint              gst_rtsp_stream_get_dscp_qos     (GstRTSPStream *stream);
 
+void              gst_rtsp_stream_set_tcp_ring_size (GstRTSPStream *stream, guint size);
+guint             gst_rtsp_stream_get_tcp_ring_size (GstRTSPStream *stream);
+
 gboolean          gst_rtsp_stream_is_transport_supported  (GstRTSPStream *stream,
                                                            GstRTSPTransport *transport);
 
@@ -314,6 +314,67 @@ GST_START_TEST (test_reset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pool)
+{
+  GstRTSPMediaFactory *factory;
+  GstRTSPMedia *media;
+  GstRTSPThreadPool *pool;
+  GstRTSPThread *thread;
+  GstRTSPUrl *url;
+  gint i;
+
+  factory = gst_rtsp_media_factory_new ();
+  fail_if (gst_rtsp_media_factory_is_shared (factory));
+  fail_unless (gst_rtsp_media_factory_get_pool_size (factory) == 0);
+  fail_unless (gst_rtsp_url_parse ("rtsp://localhost:8554/test",
+          &url) == GST_RTSP_OK);
+
+  gst_rtsp_media_factory_set_launch (factory,
+      "( videotestsrc ! rtpvrawpay pt=96 name=pay0 )");
+  gst_rtsp_media_factory_set_pool_size (factory, 1);
+  fail_unless (gst_rtsp_media_factory_get_pool_size (factory) == 1);
+
+  /* the first media is constructed on request and starts filling the pool */
+  media = gst_rtsp_media_factory_construct (factory, url);
+  fail_unless (GST_IS_RTSP_MEDIA (media));
+  fail_unless (gst_rtsp_media_get_status (media) ==
+      GST_RTSP_MEDIA_STATUS_UNPREPARED);
+  g_object_unref (media);
+
+  /* wait for a prepared media to come out of the pool */
+  for (i = 0; i < 500; i++) {
+    media = gst_rtsp_media_factory_construct (factory, url);
+    fail_unless (GST_IS_RTSP_MEDIA (media));
+    if (gst_rtsp_media_get_status (media) == GST_RTSP_MEDIA_STATUS_PREPARED)
+      break;
+    g_object_unref (media);
+    media = NULL;
+    g_usleep (10 * G_USEC_PER_SEC / 1000);
+  }
+  fail_unless (media != NULL);
+
+  /* preparing and unpreparing once must really unprepare it */
+  pool = gst_rtsp_thread_pool_new ();
+  thread = gst_rtsp_thread_pool_get_thread (pool,
+      GST_RTSP_THREAD_TYPE_MEDIA, NULL);
+  fail_unless (gst_rtsp_media_prepare (media, thread));
+  fail_unless (gst_rtsp_media_unprepare (media));
+  fail_unless (gst_rtsp_media_get_status (media) ==
+      GST_RTSP_MEDIA_STATUS_UNPREPARED);
+  g_object_unref (media);
+
+  /* disabling the pool discards the pooled media */
+  gst_rtsp_media_factory_set_pool_size (factory, 0);
+
+  gst_rtsp_url_free (url);
+  g_object_unref (factory);
+  g_object_unref (pool);
+
+  gst_rtsp_thread_pool_cleanup ();
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspmediafactory_suite (void)
 {
@@ -329,6 +390,7 @@ rtspmediafactory_suite (void)
   tcase_add_test (tc, test_addresspool);
   tcase_add_test (tc, test_permissions);
   tcase_add_test (tc, test_reset);
+  tcase_add_test (tc, test_pool);
 
   return s;
 }
@@ -118,7 +118,7 @@ context_ensure_surfaces (GstVaapiContext * context)
 
   for (i = context->surfaces->len; i < num_surfaces; i++) {
     surface = gst_vaapi_surface_new (GST_VAAPI_OBJECT_DISPLAY (context),
-        cip->chroma_type, cip->width, cip->height);
+        cip->chroma_type, context->surfaces_width, context->surfaces_height);
     if (!surface)
       return FALSE;
     gst_vaapi_surface_set_parent_context (surface, context);
@@ -140,6 +140,16 @@ context_create_surfaces (GstVaapiContext * context)
   if (!gst_vaapi_context_overlay_reset (context))
     return FALSE;
 
+  /* Decoders keep the largest size seen so far, so that switching back
+     to a smaller resolution can reuse the surfaces */
+  if (cip->usage == GST_VAAPI_CONTEXT_USAGE_DECODE) {
+    context->surfaces_width = MAX (context->surfaces_width, cip->width);
+    context->surfaces_height = MAX (context->surfaces_height, cip->height);
+  } else {
+    context->surfaces_width = cip->width;
+    context->surfaces_height = cip->height;
+  }
+
   num_surfaces = cip->ref_frames + SCRATCH_SURFACES_COUNT;
   if (!context->surfaces) {
     context->surfaces = g_ptr_array_new_full (num_surfaces,
@@ -151,7 +161,7 @@ context_create_surfaces (GstVaapiContext * context)
   if (!context->surfaces_pool) {
     context->surfaces_pool =
         gst_vaapi_surface_pool_new_with_chroma_type (display, cip->chroma_type,
-        cip->width, cip->height);
+        context->surfaces_width, context->surfaces_height);
 
     if (!context->surfaces_pool)
       return FALSE;
@@ -323,6 +333,8 @@ gst_vaapi_context_init (GstVaapiContext * context,
     cip->chroma_type = DEFAULT_CHROMA_TYPE;
 
   context->va_config = VA_INVALID_ID;
+  context->surfaces_width = 0;
+  context->surfaces_height = 0;
   gst_vaapi_context_overlay_init (context);
 }
 
@@ -389,7 +401,7 @@ gst_vaapi_context_reset (GstVaapiContext * context,
 {
   GstVaapiContextInfo *const cip = &context->info;
   gboolean reset_surfaces = FALSE, reset_config = FALSE;
-  gboolean grow_surfaces = FALSE;
+  gboolean grow_surfaces = FALSE, size_changed = FALSE;
   GstVaapiChromaType chroma_type;
 
   chroma_type = new_cip->chroma_type ? new_cip->chroma_type :
@@ -402,7 +414,14 @@ gst_vaapi_context_reset (GstVaapiContext * context,
   if (cip->width != new_cip->width || cip->height != new_cip->height) {
     cip->width = new_cip->width;
     cip->height = new_cip->height;
-    reset_surfaces = TRUE;
+    size_changed = TRUE;
+
+    /* Decoded pictures that fit into the current surfaces are cropped
+       on output, only the VA context needs to be recreated for them */
+    if (new_cip->usage != GST_VAAPI_CONTEXT_USAGE_DECODE ||
+        cip->width > context->surfaces_width ||
+        cip->height > context->surfaces_height)
+      reset_surfaces = TRUE;
   }
 
   if (cip->profile != new_cip->profile ||
@@ -425,7 +444,7 @@ gst_vaapi_context_reset (GstVaapiContext * context,
     if (context_update_config_encoder (context, &new_cip->config.encoder))
       reset_config = TRUE;
   } else if (new_cip->usage == GST_VAAPI_CONTEXT_USAGE_DECODE) {
-    if (reset_surfaces || grow_surfaces)
+    if (reset_surfaces || grow_surfaces || size_changed)
       reset_config = TRUE;
   }
 
@@ -106,6 +106,8 @@ struct _GstVaapiContext
   VAConfigID va_config;
   GPtrArray *surfaces;
   GstVaapiVideoPool *surfaces_pool;
+  guint surfaces_width;
+  guint surfaces_height;
   GPtrArray *overlays[2];
   guint overlay_id;
 };
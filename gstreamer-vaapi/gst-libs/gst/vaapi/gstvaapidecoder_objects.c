@@ -142,6 +142,9 @@ gst_vaapi_picture_create (GstVaapiPicture * picture,
       picture->crop_rect = parent_picture->crop_rect;
     }
   } else {
+    const GstVaapiContextInfo *const cip = &GET_CONTEXT (picture)->info;
+    guint width, height;
+
     picture->type = GST_VAAPI_PICTURE_TYPE_NONE;
     picture->pts = GST_CLOCK_TIME_NONE;
 
@@ -150,6 +153,15 @@ gst_vaapi_picture_create (GstVaapiPicture * picture,
     if (!picture->proxy)
       return FALSE;
 
+    /* The context keeps surfaces from a larger resolution around, so
+       crop to the actual picture size unless the codec sets its own */
+    gst_vaapi_surface_get_size (GST_VAAPI_SURFACE_PROXY_SURFACE
+        (picture->proxy), &width, &height);
+    if (width > cip->width || height > cip->height) {
+      GstVaapiRectangle crop_rect = { 0, 0, cip->width, cip->height };
+      gst_vaapi_picture_set_crop_rect (picture, &crop_rect);
+    }
+
     picture->structure = GST_VAAPI_PICTURE_STRUCTURE_FRAME;
     GST_VAAPI_PICTURE_FLAG_SET (picture, GST_VAAPI_PICTURE_FLAG_FF);
   }
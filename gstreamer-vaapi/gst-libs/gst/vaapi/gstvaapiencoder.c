@@ -169,6 +169,23 @@ gst_vaapi_encoder_properties_get_default (const GstVaapiEncoderClass * klass)
           cdata->encoder_tune_get_type (), cdata->default_encoder_tune,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVaapiEncoder:frames-in-flight:
+   *
+   * The maximum number of frames submitted to the hardware before
+   * the encoder waits for their coded buffers to be consumed. Coded
+   * buffers are synced from the output thread, so a deeper queue
+   * keeps the encode engine busy while earlier frames are pushed
+   * downstream, e.g. when several encoders share one device.
+   */
+  GST_VAAPI_ENCODER_PROPERTIES_APPEND (props,
+      GST_VAAPI_ENCODER_PROP_FRAMES_IN_FLIGHT,
+      g_param_spec_uint ("frames-in-flight",
+          "Frames in flight",
+          "Maximum number of frames submitted to the hardware before "
+          "waiting for their coded buffers", 1, 32, 5,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   return props;
 }
 
@@ -676,7 +693,7 @@ gst_vaapi_encoder_reconfigure_internal (GstVaapiEncoder * encoder)
     pool = gst_vaapi_coded_buffer_pool_new (encoder, encoder->codedbuf_size);
     if (!pool)
       goto error_alloc_codedbuf_pool;
-    gst_vaapi_video_pool_set_capacity (pool, 5);
+    gst_vaapi_video_pool_set_capacity (pool, encoder->frames_in_flight);
     gst_vaapi_video_pool_replace (&encoder->codedbuf_pool, pool);
     gst_vaapi_video_pool_unref (pool);
   }
@@ -790,6 +807,10 @@ set_property (GstVaapiEncoder * encoder, gint prop_id, const GValue * value)
     case GST_VAAPI_ENCODER_PROP_TUNE:
       status = gst_vaapi_encoder_set_tuning (encoder, g_value_get_enum (value));
       break;
+    case GST_VAAPI_ENCODER_PROP_FRAMES_IN_FLIGHT:
+      status = gst_vaapi_encoder_set_frames_in_flight (encoder,
+          g_value_get_uint (value));
+      break;
   }
   return status;
 
@@ -1014,6 +1035,49 @@ error_operation_failed:
   }
 }
 
+/**
+ * gst_vaapi_encoder_set_frames_in_flight:
+ * @encoder: a #GstVaapiEncoder
+ * @frames_in_flight: the maximum number of frames being encoded
+ *
+ * Notifies the @encoder to allow up to @frames_in_flight frames to be
+ * submitted to the hardware before gst_vaapi_encoder_put_frame()
+ * blocks waiting for a coded buffer to be released.
+ *
+ * Note: currently, this can only be specified before the last call to
+ * gst_vaapi_encoder_set_codec_state(), which shall occur before the
+ * first frame is encoded. Afterwards, any change to this parameter
+ * causes gst_vaapi_encoder_set_frames_in_flight() to return
+ * @GST_VAAPI_ENCODER_STATUS_ERROR_OPERATION_FAILED.
+ *
+ * Return value: a #GstVaapiEncoderStatus
+ */
+GstVaapiEncoderStatus
+gst_vaapi_encoder_set_frames_in_flight (GstVaapiEncoder * encoder,
+    guint frames_in_flight)
+{
+  g_return_val_if_fail (encoder != NULL, 0);
+  g_return_val_if_fail (frames_in_flight > 0,
+      GST_VAAPI_ENCODER_STATUS_ERROR_INVALID_PARAMETER);
+
+  if (encoder->frames_in_flight != frames_in_flight
+      && encoder->num_codedbuf_queued > 0)
+    goto error_operation_failed;
+
+  encoder->frames_in_flight = frames_in_flight;
+  if (encoder->codedbuf_pool)
+    gst_vaapi_video_pool_set_capacity (encoder->codedbuf_pool,
+        frames_in_flight);
+  return GST_VAAPI_ENCODER_STATUS_SUCCESS;
+
+  /* ERRORS */
+error_operation_failed:
+  {
+    GST_ERROR ("could not change frames in flight after encoding started");
+    return GST_VAAPI_ENCODER_STATUS_ERROR_OPERATION_FAILED;
+  }
+}
+
 /* Initialize default values for configurable properties */
 static gboolean
 gst_vaapi_encoder_init_properties (GstVaapiEncoder * encoder)
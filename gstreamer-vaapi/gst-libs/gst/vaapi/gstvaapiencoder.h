@@ -100,6 +100,9 @@ typedef enum {
  * @GST_VAAPI_ENCODER_PROP_KEYFRAME_PERIOD: The maximal distance
  *   between two keyframes (uint).
  * @GST_VAAPI_ENCODER_PROP_TUNE: The tuning options (#GstVaapiEncoderTune).
+ * @GST_VAAPI_ENCODER_PROP_FRAMES_IN_FLIGHT: The maximum number of
+ *   frames submitted to the hardware before waiting for their coded
+ *   buffers (uint).
  *
  * The set of configurable properties for the encoder.
  */
@@ -108,6 +111,7 @@ typedef enum {
   GST_VAAPI_ENCODER_PROP_BITRATE,
   GST_VAAPI_ENCODER_PROP_KEYFRAME_PERIOD,
   GST_VAAPI_ENCODER_PROP_TUNE,
+  GST_VAAPI_ENCODER_PROP_FRAMES_IN_FLIGHT,
 } GstVaapiEncoderProp;
 
 /**
@@ -166,6 +170,10 @@ GstVaapiEncoderStatus
 gst_vaapi_encoder_set_tuning (GstVaapiEncoder * encoder,
     GstVaapiEncoderTune tuning);
 
+GstVaapiEncoderStatus
+gst_vaapi_encoder_set_frames_in_flight (GstVaapiEncoder * encoder,
+    guint frames_in_flight);
+
 GstVaapiEncoderStatus
 gst_vaapi_encoder_get_buffer_with_timeout (GstVaapiEncoder * encoder,
     GstVaapiCodedBufferProxy ** out_codedbuf_proxy_ptr, guint64 timeout);
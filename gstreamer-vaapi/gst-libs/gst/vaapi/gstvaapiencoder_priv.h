@@ -221,6 +221,7 @@ struct _GstVaapiEncoder
   GCond surface_free;
   GCond codedbuf_free;
   guint codedbuf_size;
+  guint frames_in_flight;
   GstVaapiVideoPool *codedbuf_pool;
   GAsyncQueue *codedbuf_queue;
   guint32 num_codedbuf_queued;
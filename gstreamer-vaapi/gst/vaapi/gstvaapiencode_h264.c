@@ -58,6 +58,8 @@ GST_DEBUG_CATEGORY_STATIC (gst_vaapi_h264_encode_debug);
 static const char gst_vaapiencode_h264_sink_caps_str[] =
   GST_VAAPI_MAKE_SURFACE_CAPS ", "
   GST_CAPS_INTERLACED_FALSE "; "
+  GST_VAAPI_MAKE_DMABUF_CAPS ", "
+  GST_CAPS_INTERLACED_FALSE "; "
   GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL) ", "
   GST_CAPS_INTERLACED_FALSE;
 /* *INDENT-ON* */
@@ -402,10 +402,9 @@ gst_vaapi_plugin_base_ensure_display (GstVaapiPluginBase * plugin)
 }
 
 /* Checks whether the supplied pad peer element supports DMABUF sharing */
-/* XXX: this is a workaround to the absence of any proposer way to
-   specify DMABUF memory capsfeatures or bufferpool option to downstream */
 static gboolean
-has_dmabuf_capable_peer (GstVaapiPluginBase * plugin, GstPad * pad)
+has_dmabuf_capable_peer (GstVaapiPluginBase * plugin, GstPad * pad,
+    GstCaps * caps)
 {
   GstPad *other_pad = NULL;
   GstElement *element = NULL;
@@ -413,6 +412,12 @@ has_dmabuf_capable_peer (GstVaapiPluginBase * plugin, GstPad * pad)
   gboolean is_dmabuf_capable = FALSE;
   gint v;
 
+  /* upstream negotiated DMABuf memory */
+  if (caps && gst_caps_has_dmabuf (caps))
+    return TRUE;
+
+  /* XXX: this is a workaround for peers that don't announce the DMABuf
+     memory caps feature */
   gst_object_ref (pad);
 
   for (;;) {
@@ -595,7 +600,7 @@ gst_vaapi_plugin_base_propose_allocation (GstVaapiPluginBase * plugin,
     gst_query_add_allocation_pool (query, plugin->sinkpad_buffer_pool,
         plugin->sinkpad_buffer_size, 0, 0);
 
-    if (has_dmabuf_capable_peer (plugin, plugin->sinkpad)) {
+    if (has_dmabuf_capable_peer (plugin, plugin->sinkpad, caps)) {
       GstStructure *const config =
           gst_buffer_pool_get_config (plugin->sinkpad_buffer_pool);
 
@@ -651,6 +651,15 @@ gst_caps_has_vaapi_surface (GstCaps * caps)
   return _gst_caps_has_feature (caps, GST_CAPS_FEATURE_MEMORY_VAAPI_SURFACE);
 }
 
+/* Checks whether the supplied caps contain DMABuf memory */
+gboolean
+gst_caps_has_dmabuf (GstCaps * caps)
+{
+  g_return_val_if_fail (caps != NULL, FALSE);
+
+  return _gst_caps_has_feature (caps, GST_CAPS_FEATURE_MEMORY_DMABUF);
+}
+
 void
 gst_video_info_change_format (GstVideoInfo * vip, GstVideoFormat format,
     guint width, guint height)
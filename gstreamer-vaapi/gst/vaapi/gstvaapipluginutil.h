@@ -110,6 +110,10 @@ gst_vaapi_caps_feature_contains (const GstCaps * caps,
     GST_VIDEO_CAPS_MAKE_WITH_FEATURES(					\
         GST_CAPS_FEATURE_META_GST_VIDEO_GL_TEXTURE_UPLOAD_META, "{ RGBA, BGRA }")
 
+#define GST_VAAPI_MAKE_DMABUF_CAPS					\
+    GST_VIDEO_CAPS_MAKE_WITH_FEATURES(					\
+        GST_CAPS_FEATURE_MEMORY_DMABUF, "{ NV12, I420, YV12 }")
+
 G_GNUC_INTERNAL
 gboolean
 gst_caps_set_interlaced (GstCaps * caps, GstVideoInfo * vip);
@@ -118,6 +122,10 @@ G_GNUC_INTERNAL
 gboolean
 gst_caps_has_vaapi_surface (GstCaps * caps);
 
+G_GNUC_INTERNAL
+gboolean
+gst_caps_has_dmabuf (GstCaps * caps);
+
 G_GNUC_INTERNAL
 void
 gst_video_info_change_format (GstVideoInfo * vip, GstVideoFormat format,
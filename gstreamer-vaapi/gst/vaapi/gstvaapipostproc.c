@@ -33,6 +33,21 @@
  * gst-launch-1.0 videotestsrc ! vaapipostproc ! video/x-raw width=1920, height=1080 ! vaapisink
  * ]|
  * </refsect2>
+ *
+ * Additional VA surface outputs can be requested through the src_%u pads,
+ * e.g. to produce several renditions of a decoded stream. Each of them is
+ * scaled and converted to its own caps from the same input surface, using
+ * the same VA context as the main output.
+ *
+ * <refsect2>
+ * <title>Example launch line</title>
+ * |[
+ * gst-launch-1.0 filesrc location=input.mp4 ! qtdemux ! vaapidecode ! vaapipostproc name=pp \
+ *     pp.src ! video/x-raw(memory:VASurface), width=1920, height=1080 ! vaapih264enc ! fakesink \
+ *     pp.src_0 ! video/x-raw(memory:VASurface), width=1280, height=720 ! vaapih264enc ! fakesink \
+ *     pp.src_1 ! video/x-raw(memory:VASurface), width=640, height=360 ! vaapih264enc ! fakesink
+ * ]|
+ * </refsect2>
  */
 
 #include "gstcompat.h"
@@ -56,6 +71,8 @@ GST_DEBUG_CATEGORY_STATIC (gst_debug_vaapipostproc);
 static const char gst_vaapipostproc_sink_caps_str[] =
   GST_VAAPI_MAKE_SURFACE_CAPS ", "
   GST_CAPS_INTERLACED_MODES "; "
+  GST_VAAPI_MAKE_DMABUF_CAPS ", "
+  GST_CAPS_INTERLACED_MODES "; "
   GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL) ", "
    GST_CAPS_INTERLACED_MODES;
 /* *INDENT-ON* */
@@ -87,6 +104,39 @@ static GstStaticPadTemplate gst_vaapipostproc_src_factory =
     GST_STATIC_CAPS (gst_vaapipostproc_src_caps_str));
 /* *INDENT-ON* */
 
+/* *INDENT-OFF* */
+static GstStaticPadTemplate gst_vaapipostproc_aux_src_factory =
+  GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (GST_VAAPI_MAKE_SURFACE_CAPS ", "
+        GST_CAPS_INTERLACED_FALSE));
+/* *INDENT-ON* */
+
+/*
+ * GstVaapiPostprocOutput:
+ * @pad: the request source pad
+ * @info: the negotiated video info
+ * @surface_pool: the pool of VA surfaces rendered to
+ * @buffer_pool: the pool of output buffers
+ * @synced: flag: the stream-start and segment events were pushed
+ * @reconfigure: flag: the caps need to be negotiated again
+ *
+ * State of an additional output. Only the streaming thread uses the
+ * pools, the structure itself is reference counted so that the pad can
+ * be released while a buffer is being processed.
+ */
+typedef struct
+{
+  gint ref_count;
+  GstPad *pad;
+  GstVideoInfo info;
+  GstVaapiVideoPool *surface_pool;
+  GstBufferPool *buffer_pool;
+  guint synced:1;
+  guint reconfigure:1;
+} GstVaapiPostprocOutput;
+
 static void gst_vaapipostproc_colorbalance_init (gpointer iface, gpointer data);
 
 G_DEFINE_TYPE_WITH_CODE (GstVaapiPostproc, gst_vaapipostproc,
@@ -282,6 +332,67 @@ gst_vaapipostproc_destroy_filter (GstVaapiPostproc * postproc)
   gst_vaapi_video_pool_replace (&postproc->filter_pool, NULL);
 }
 
+static GstVaapiPostprocOutput *
+output_ref (GstVaapiPostprocOutput * out)
+{
+  g_atomic_int_inc (&out->ref_count);
+  return out;
+}
+
+static void
+output_reset (GstVaapiPostprocOutput * out)
+{
+  if (out->buffer_pool) {
+    gst_buffer_pool_set_active (out->buffer_pool, FALSE);
+    gst_object_replace ((GstObject **) & out->buffer_pool, NULL);
+  }
+  gst_vaapi_video_pool_replace (&out->surface_pool, NULL);
+  gst_video_info_init (&out->info);
+  out->reconfigure = TRUE;
+}
+
+static void
+output_unref (GstVaapiPostprocOutput * out)
+{
+  if (!g_atomic_int_dec_and_test (&out->ref_count))
+    return;
+
+  output_reset (out);
+  gst_object_unref (out->pad);
+  g_slice_free (GstVaapiPostprocOutput, out);
+}
+
+/* returns a referenced copy of the list of additional outputs */
+static GList *
+gst_vaapipostproc_get_outputs (GstVaapiPostproc * postproc)
+{
+  GList *outputs;
+
+  GST_OBJECT_LOCK (postproc);
+  outputs = g_list_copy_deep (postproc->outputs, (GCopyFunc) output_ref, NULL);
+  GST_OBJECT_UNLOCK (postproc);
+  return outputs;
+}
+
+static void
+gst_vaapipostproc_reset_outputs (GstVaapiPostproc * postproc,
+    gboolean reset_stream)
+{
+  GList *l;
+
+  /* the pools are only touched by the streaming thread, which is
+   * stopped or in set_caps when this is called */
+  GST_OBJECT_LOCK (postproc);
+  for (l = postproc->outputs; l; l = l->next) {
+    GstVaapiPostprocOutput *const out = l->data;
+
+    output_reset (out);
+    if (reset_stream)
+      out->synced = FALSE;
+  }
+  GST_OBJECT_UNLOCK (postproc);
+}
+
 static void
 gst_vaapipostproc_destroy (GstVaapiPostproc * postproc)
 {
@@ -312,6 +423,7 @@ gst_vaapipostproc_stop (GstBaseTransform * trans)
   GstVaapiPostproc *const postproc = GST_VAAPIPOSTPROC (trans);
 
   ds_reset (&postproc->deinterlace_state);
+  gst_vaapipostproc_reset_outputs (postproc, TRUE);
   gst_vaapi_plugin_base_close (GST_VAAPI_PLUGIN_BASE (postproc));
 
   postproc->field_duration = GST_CLOCK_TIME_NONE;
@@ -830,6 +942,257 @@ error_invalid_buffer:
   }
 }
 
+static gboolean
+gst_vaapipostproc_negotiate_output (GstVaapiPostproc * postproc,
+    GstVaapiPostprocOutput * out)
+{
+  GstVaapiDisplay *const display = GST_VAAPI_PLUGIN_BASE_DISPLAY (postproc);
+  GstPad *const sinkpad = GST_BASE_TRANSFORM_SINK_PAD (postproc);
+  GstCaps *templ, *peer_caps, *base_caps, *caps;
+  GstStructure *structure, *config;
+  GstVaapiVideoPool *surface_pool;
+  GstBufferPool *buffer_pool;
+  GstEvent *event;
+  GstVideoInfo vi;
+
+  output_reset (out);
+
+  /* keep the framerate and let downstream pick size and format */
+  base_caps = gst_video_info_to_caps (&postproc->sinkpad_info);
+  structure = gst_caps_get_structure (base_caps, 0);
+  gst_structure_remove_fields (structure, "width", "height",
+      "pixel-aspect-ratio", "format", "interlace-mode", "field-order",
+      "colorimetry", "chroma-site", NULL);
+  gst_caps_set_features (base_caps, 0,
+      gst_caps_features_new (GST_CAPS_FEATURE_MEMORY_VAAPI_SURFACE, NULL));
+
+  templ = gst_pad_get_pad_template_caps (out->pad);
+  peer_caps = gst_pad_peer_query_caps (out->pad, templ);
+  gst_caps_unref (templ);
+  caps = gst_caps_intersect (peer_caps, base_caps);
+  gst_caps_unref (peer_caps);
+  gst_caps_unref (base_caps);
+  if (gst_caps_is_empty (caps))
+    goto error_no_caps;
+
+  caps = gst_caps_fixate (caps);
+  if (!gst_video_info_from_caps (&vi, caps))
+    goto error_invalid_caps;
+
+  GST_INFO_OBJECT (out->pad, "new caps = %" GST_PTR_FORMAT, caps);
+
+  if (GST_VIDEO_INFO_FORMAT (&vi) == GST_VIDEO_FORMAT_ENCODED)
+    gst_video_info_change_format (&vi, GST_VIDEO_FORMAT_NV12,
+        GST_VIDEO_INFO_WIDTH (&vi), GST_VIDEO_INFO_HEIGHT (&vi));
+
+  surface_pool = gst_vaapi_surface_pool_new_full (display, &vi, 0);
+  if (!surface_pool)
+    goto error_create_pool;
+  gst_vaapi_video_pool_replace (&out->surface_pool, surface_pool);
+  gst_vaapi_video_pool_unref (surface_pool);
+
+  buffer_pool = gst_vaapi_video_buffer_pool_new (display);
+  if (!buffer_pool)
+    goto error_create_pool;
+  out->buffer_pool = buffer_pool;
+
+  config = gst_buffer_pool_get_config (buffer_pool);
+  gst_buffer_pool_config_set_params (config, caps, vi.size, 0, 0);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VAAPI_VIDEO_META);
+  gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  if (!gst_buffer_pool_set_config (buffer_pool, config))
+    goto error_create_pool;
+  if (!gst_buffer_pool_set_active (buffer_pool, TRUE))
+    goto error_create_pool;
+
+  /* STREAM_START, CAPS and SEGMENT must be pushed in this order */
+  if (!out->synced) {
+    event = gst_pad_get_sticky_event (sinkpad, GST_EVENT_STREAM_START, 0);
+    if (event)
+      gst_pad_push_event (out->pad, event);
+  }
+  gst_pad_push_event (out->pad, gst_event_new_caps (caps));
+  if (!out->synced) {
+    event = gst_pad_get_sticky_event (sinkpad, GST_EVENT_SEGMENT, 0);
+    if (event)
+      gst_pad_push_event (out->pad, event);
+    out->synced = TRUE;
+  }
+  gst_caps_unref (caps);
+
+  out->info = vi;
+  out->reconfigure = FALSE;
+  return TRUE;
+
+  /* ERRORS */
+error_no_caps:
+  {
+    GST_ERROR_OBJECT (out->pad, "failed to negotiate caps");
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+error_invalid_caps:
+  {
+    GST_ERROR_OBJECT (out->pad, "invalid caps %" GST_PTR_FORMAT, caps);
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+error_create_pool:
+  {
+    GST_ERROR_OBJECT (out->pad, "failed to create output pools");
+    gst_caps_unref (caps);
+    output_reset (out);
+    return FALSE;
+  }
+}
+
+/* disable the filters applied by the main output, so that the additional
+ * outputs only scale and convert the already processed surface */
+static void
+reset_filter_operations (GstVaapiPostproc * postproc)
+{
+  static const GstVaapiFilterOp ops[] = {
+    GST_VAAPI_FILTER_OP_DENOISE, GST_VAAPI_FILTER_OP_SHARPEN,
+    GST_VAAPI_FILTER_OP_HUE, GST_VAAPI_FILTER_OP_SATURATION,
+    GST_VAAPI_FILTER_OP_BRIGHTNESS, GST_VAAPI_FILTER_OP_CONTRAST,
+    GST_VAAPI_FILTER_OP_DEINTERLACING, GST_VAAPI_FILTER_OP_SKINTONE,
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (ops); i++) {
+    if (postproc->flags & (1 << ops[i]))
+      gst_vaapi_filter_set_operation (postproc->filter, ops[i], NULL);
+  }
+}
+
+static GstFlowReturn
+gst_vaapipostproc_process_output (GstVaapiPostproc * postproc,
+    GstVaapiPostprocOutput * out, GstBuffer * inbuf, GstBuffer * srcbuf,
+    const GstVaapiRectangle * crop_rect)
+{
+  GstVaapiVideoMeta *src_meta, *meta;
+  GstVaapiSurfaceProxy *proxy;
+  GstVaapiFilterStatus status;
+  GstBuffer *buf = NULL;
+  GstFlowReturn ret;
+
+  if (gst_pad_check_reconfigure (out->pad) || out->reconfigure) {
+    if (!gst_vaapipostproc_negotiate_output (postproc, out))
+      return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  ret = gst_buffer_pool_acquire_buffer (out->buffer_pool, &buf, NULL);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  meta = gst_buffer_get_vaapi_video_meta (buf);
+  if (!meta)
+    goto error_create_meta;
+
+  proxy = gst_vaapi_surface_proxy_new_from_pool (GST_VAAPI_SURFACE_POOL
+      (out->surface_pool));
+  if (!proxy)
+    goto error_create_proxy;
+  gst_vaapi_video_meta_set_surface_proxy (meta, proxy);
+  gst_vaapi_surface_proxy_unref (proxy);
+
+  src_meta = gst_buffer_get_vaapi_video_meta (srcbuf);
+  gst_vaapi_filter_set_cropping_rectangle (postproc->filter, crop_rect);
+  status = gst_vaapi_filter_process (postproc->filter,
+      gst_vaapi_video_meta_get_surface (src_meta),
+      gst_vaapi_video_meta_get_surface (meta),
+      gst_vaapi_video_meta_get_render_flags (src_meta) &
+      ~GST_VAAPI_PICTURE_STRUCTURE_MASK);
+  if (status != GST_VAAPI_FILTER_STATUS_SUCCESS)
+    goto error_process_vpp;
+
+  gst_buffer_copy_into (buf, inbuf,
+      GST_BUFFER_COPY_TIMESTAMPS | GST_BUFFER_COPY_FLAGS, 0, -1);
+  return gst_pad_push (out->pad, buf);
+
+  /* ERRORS */
+error_create_meta:
+  {
+    GST_ERROR_OBJECT (out->pad, "failed to create new output buffer meta");
+    gst_buffer_unref (buf);
+    return GST_FLOW_ERROR;
+  }
+error_create_proxy:
+  {
+    GST_ERROR_OBJECT (out->pad, "failed to create surface proxy from pool");
+    gst_buffer_unref (buf);
+    return GST_FLOW_ERROR;
+  }
+error_process_vpp:
+  {
+    GST_ERROR_OBJECT (out->pad, "failed to apply VPP filters (error %d)",
+        status);
+    gst_buffer_unref (buf);
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* render @inbuf into all the additional outputs. If the main output was
+ * deinterlaced or filtered, its surface in @outbuf is used as source so
+ * that this only happens once per input surface */
+static GstFlowReturn
+gst_vaapipostproc_process_outputs (GstVaapiPostproc * postproc,
+    GstBuffer * inbuf, GstBuffer * outbuf)
+{
+  const guint scale_flags = GST_VAAPI_POSTPROC_FLAG_FORMAT |
+      GST_VAAPI_POSTPROC_FLAG_SIZE | GST_VAAPI_POSTPROC_FLAG_SCALE;
+  const GstVideoCropMeta *crop_meta;
+  GstVaapiRectangle crop_rect, *crop_rect_ptr = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *srcbuf;
+  GList *outputs, *l;
+
+  outputs = gst_vaapipostproc_get_outputs (postproc);
+  if (!outputs)
+    return GST_FLOW_OK;
+
+  if (!postproc->has_vpp)
+    goto error_no_vpp;
+
+  if (postproc->use_vpp && (postproc->flags & ~scale_flags)) {
+    srcbuf = outbuf;
+    reset_filter_operations (postproc);
+  } else {
+    srcbuf = inbuf;
+    crop_meta = gst_buffer_get_video_crop_meta (inbuf);
+    if (crop_meta) {
+      crop_rect.x = crop_meta->x;
+      crop_rect.y = crop_meta->y;
+      crop_rect.width = crop_meta->width;
+      crop_rect.height = crop_meta->height;
+      crop_rect_ptr = &crop_rect;
+    }
+  }
+
+  for (l = outputs; l; l = l->next) {
+    ret = gst_vaapipostproc_process_output (postproc, l->data, inbuf, srcbuf,
+        crop_rect_ptr);
+    if (ret == GST_FLOW_NOT_LINKED)
+      ret = GST_FLOW_OK;
+    else if (ret != GST_FLOW_OK)
+      break;
+  }
+
+done:
+  g_list_free_full (outputs, (GDestroyNotify) output_unref);
+  return ret;
+
+  /* ERRORS */
+error_no_vpp:
+  {
+    GST_ELEMENT_ERROR (postproc, STREAM, NOT_IMPLEMENTED, (NULL),
+        ("additional outputs require VA/VPP support"));
+    ret = GST_FLOW_NOT_SUPPORTED;
+    goto done;
+  }
+}
+
 static gboolean
 video_info_changed (GstVideoInfo * old_vip, GstVideoInfo * new_vip)
 {
@@ -1120,6 +1483,8 @@ gst_vaapipostproc_transform (GstBaseTransform * trans, GstBuffer * inbuf,
   ret = gst_vaapipostproc_passthrough (trans, buf, outbuf);
 
 done:
+  if (ret == GST_FLOW_OK)
+    ret = gst_vaapipostproc_process_outputs (postproc, buf, outbuf);
   gst_buffer_unref (buf);
   return ret;
 }
@@ -1206,9 +1571,121 @@ gst_vaapipostproc_set_caps (GstBaseTransform * trans, GstCaps * caps,
 
   if (!ensure_srcpad_buffer_pool (postproc, out_caps))
     return FALSE;
+
+  /* additional outputs follow the new input */
+  gst_vaapipostproc_reset_outputs (postproc, FALSE);
   return TRUE;
 }
 
+static gboolean
+gst_vaapipostproc_sink_event (GstBaseTransform * trans, GstEvent * event)
+{
+  GstVaapiPostproc *const postproc = GST_VAAPIPOSTPROC (trans);
+  GList *outputs, *l;
+
+  /* caps are negotiated separately, see set_caps() */
+  if (GST_EVENT_TYPE (event) != GST_EVENT_CAPS) {
+    outputs = gst_vaapipostproc_get_outputs (postproc);
+    for (l = outputs; l; l = l->next) {
+      GstVaapiPostprocOutput *const out = l->data;
+
+      if (out->synced)
+        gst_pad_push_event (out->pad, gst_event_ref (event));
+    }
+    g_list_free_full (outputs, (GDestroyNotify) output_unref);
+  }
+
+  return
+      GST_BASE_TRANSFORM_CLASS (gst_vaapipostproc_parent_class)->sink_event
+      (trans, event);
+}
+
+static gboolean
+gst_vaapipostproc_output_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstVaapiPostproc *const postproc = GST_VAAPIPOSTPROC (parent);
+
+  if (GST_QUERY_TYPE (query) == GST_QUERY_CONTEXT) {
+    if (gst_vaapi_handle_context_query (query,
+            GST_VAAPI_PLUGIN_BASE_DISPLAY (postproc))) {
+      GST_DEBUG_OBJECT (pad, "sharing display %p",
+          GST_VAAPI_PLUGIN_BASE_DISPLAY (postproc));
+      return TRUE;
+    }
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+static GstPad *
+gst_vaapipostproc_request_new_pad (GstElement * element, GstPadTemplate * templ,
+    const gchar * name, const GstCaps * caps)
+{
+  GstVaapiPostproc *const postproc = GST_VAAPIPOSTPROC (element);
+  GstVaapiPostprocOutput *out;
+  GstPad *pad;
+  gchar *pad_name;
+
+  GST_OBJECT_LOCK (postproc);
+  pad_name = g_strdup_printf ("src_%u", postproc->next_output_id++);
+  GST_OBJECT_UNLOCK (postproc);
+
+  pad = gst_pad_new_from_template (templ, pad_name);
+  g_free (pad_name);
+  gst_pad_set_query_function (pad, gst_vaapipostproc_output_query);
+  gst_pad_use_fixed_caps (pad);
+
+  out = g_slice_new0 (GstVaapiPostprocOutput);
+  out->ref_count = 1;
+  out->pad = gst_object_ref (pad);
+  output_reset (out);
+
+  GST_OBJECT_LOCK (postproc);
+  postproc->outputs = g_list_append (postproc->outputs, out);
+  GST_OBJECT_UNLOCK (postproc);
+
+  if (!gst_element_add_pad (element, pad))
+    goto error_add_pad;
+  return pad;
+
+  /* ERRORS */
+error_add_pad:
+  {
+    GST_ERROR_OBJECT (postproc, "failed to add pad %s:%s",
+        GST_DEBUG_PAD_NAME (pad));
+    GST_OBJECT_LOCK (postproc);
+    postproc->outputs = g_list_remove (postproc->outputs, out);
+    GST_OBJECT_UNLOCK (postproc);
+    output_unref (out);
+    return NULL;
+  }
+}
+
+static void
+gst_vaapipostproc_release_pad (GstElement * element, GstPad * pad)
+{
+  GstVaapiPostproc *const postproc = GST_VAAPIPOSTPROC (element);
+  GstVaapiPostprocOutput *out = NULL;
+  GList *l;
+
+  GST_OBJECT_LOCK (postproc);
+  for (l = postproc->outputs; l; l = l->next) {
+    GstVaapiPostprocOutput *const o = l->data;
+    if (o->pad == pad) {
+      out = o;
+      postproc->outputs = g_list_delete_link (postproc->outputs, l);
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (postproc);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (element, pad);
+  if (out)
+    output_unref (out);
+}
+
 static gboolean
 gst_vaapipostproc_query (GstBaseTransform * trans,
     GstPadDirection direction, GstQuery * query)
@@ -1283,6 +1760,8 @@ gst_vaapipostproc_finalize (GObject * object)
   GstVaapiPostproc *const postproc = GST_VAAPIPOSTPROC (object);
 
   gst_vaapipostproc_destroy (postproc);
+  g_list_free_full (postproc->outputs, (GDestroyNotify) output_unref);
+  postproc->outputs = NULL;
 
   gst_vaapi_plugin_base_finalize (GST_VAAPI_PLUGIN_BASE (postproc));
   G_OBJECT_CLASS (gst_vaapipostproc_parent_class)->finalize (object);
@@ -1434,10 +1913,13 @@ gst_vaapipostproc_class_init (GstVaapiPostprocClass * klass)
   trans_class->query = gst_vaapipostproc_query;
   trans_class->propose_allocation = gst_vaapipostproc_propose_allocation;
   trans_class->decide_allocation = gst_vaapipostproc_decide_allocation;
+  trans_class->sink_event = gst_vaapipostproc_sink_event;
 
   trans_class->prepare_output_buffer = gst_vaapipostproc_prepare_output_buffer;
 
   element_class->set_context = gst_vaapi_base_set_context;
+  element_class->request_new_pad = gst_vaapipostproc_request_new_pad;
+  element_class->release_pad = gst_vaapipostproc_release_pad;
   gst_element_class_set_static_metadata (element_class,
       "VA-API video postprocessing",
       "Filter/Converter/Video;Filter/Converter/Video/Scaler;"
@@ -1452,6 +1934,11 @@ gst_vaapipostproc_class_init (GstVaapiPostprocClass * klass)
   pad_template = gst_static_pad_template_get (&gst_vaapipostproc_src_factory);
   gst_element_class_add_pad_template (element_class, pad_template);
 
+  /* additional src pads */
+  pad_template =
+      gst_static_pad_template_get (&gst_vaapipostproc_aux_src_factory);
+  gst_element_class_add_pad_template (element_class, pad_template);
+
   /**
    * GstVaapiPostproc:deinterlace-mode:
    *
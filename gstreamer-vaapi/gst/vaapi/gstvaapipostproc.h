@@ -175,6 +175,10 @@ struct _GstVaapiPostproc
 
   /* color balance's channel list */
   GList *cb_channels;
+
+  /* additional outputs (request pads), protected by the object lock */
+  GList *outputs;
+  guint next_output_id;
 };
 
 struct _GstVaapiPostprocClass
@@ -849,6 +849,10 @@ gst_vaapi_dmabuf_memory_new (GstAllocator * allocator, GstVaapiVideoMeta * meta)
   gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (mem),
       GST_VAAPI_BUFFER_PROXY_QUARK, dmabuf_proxy,
       (GDestroyNotify) gst_vaapi_buffer_proxy_unref);
+
+  /* the layout of other surfaces is not reported by the driver */
+  if (flags & GST_VAAPI_SURFACE_ALLOC_FLAG_LINEAR_STORAGE)
+    gst_dmabuf_memory_set_drm_modifier (mem, GST_DMABUF_DRM_MODIFIER_LINEAR);
   return mem;
 
   /* ERRORS */
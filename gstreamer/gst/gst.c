@@ -697,6 +697,7 @@ init_post (GOptionContext * context, GOptionGroup * group, gpointer data,
 
   g_type_class_ref (gst_param_spec_fraction_get_type ());
   gst_parse_context_get_type ();
+  gst_parse_template_get_type ();
 
   _priv_gst_plugin_initialize ();
 
@@ -1131,6 +1132,10 @@ gst_deinit (void)
 
   gst_deinitialized = TRUE;
   GST_INFO ("deinitialized GStreamer");
+
+#ifndef GST_DISABLE_GST_DEBUG
+  _priv_gst_debug_cleanup ();
+#endif
 }
 
 /**
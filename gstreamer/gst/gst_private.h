@@ -131,6 +131,7 @@ G_GNUC_INTERNAL  void  _priv_gst_date_time_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_allocator_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_caps_features_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_caps_cleanup (void);
+G_GNUC_INTERNAL  void  _priv_gst_debug_cleanup (void);
 
 /* Private registry functions */
 G_GNUC_INTERNAL
@@ -398,6 +399,7 @@ struct _GstTypeFindFactory {
   GstTypeFindFunction           function;
   gchar **                      extensions;
   GstCaps *                     caps;
+  const gchar *                 caps_str;       /* from the registry cache, parsed on first use */
 
   gpointer                      user_data;
   GDestroyNotify                user_data_notify;
@@ -439,6 +441,7 @@ struct _GstElementFactory {
   GType                 type;                   /* unique GType of element or 0 if not loaded */
 
   gpointer              metadata;
+  const gchar *         metadata_str;           /* from the registry cache, parsed on first use */
 
   GList *               staticpadtemplates;     /* GstStaticPadTemplate list */
   guint                 numpadtemplates;
@@ -44,6 +44,11 @@
 #include "gst_private.h"
 #include "gstmemory.h"
 
+#ifdef HAVE_MMAP
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (gst_allocator_debug);
 #define GST_CAT_DEFAULT gst_allocator_debug
 
@@ -346,11 +351,22 @@ typedef struct
 
   gpointer user_data;
   GDestroyNotify notify;
+
+  /* separate mapping holding the data, for big blocks */
+  gpointer map_data;
+  gsize map_size;
 } GstMemorySystem;
 
+/* size of a huge page, blocks of at least this size get their own mapping
+ * in the large allocator */
+#define LARGE_PAGE_SIZE (2 * 1024 * 1024)
+
 typedef struct
 {
   GstAllocator parent;
+
+  /* allocate big blocks on huge pages */
+  gboolean large;
 } GstAllocatorSysmem;
 
 typedef struct
@@ -375,6 +391,8 @@ _sysmem_init (GstMemorySystem * mem, GstMemoryFlags flags,
   mem->data = data;
   mem->user_data = user_data;
   mem->notify = notify;
+  mem->map_data = NULL;
+  mem->map_size = 0;
 }
 
 /* create a new memory block that manages the given memory */
@@ -437,6 +455,68 @@ _sysmem_new_block (GstMemoryFlags flags,
   return mem;
 }
 
+#if defined(HAVE_MMAP) && defined(MAP_ANONYMOUS)
+/* allocate a big block in its own anonymous mapping, aligned to and sized in
+ * huge pages so that it can be backed by transparent huge pages. The pages
+ * are faulted in here, so that with the default first-touch policy they are
+ * placed on the NUMA node of the allocating thread. */
+static GstMemorySystem *
+_sysmem_new_block_large (GstAllocator * allocator, GstMemoryFlags flags,
+    gsize maxsize, gsize align, gsize offset, gsize size)
+{
+  GstMemorySystem *mem;
+  guint8 *base, *data;
+  gsize map_size, head, i;
+
+  align |= gst_memory_alignment;
+  /* the mapping is aligned to a huge page */
+  if (align >= LARGE_PAGE_SIZE)
+    return NULL;
+
+  map_size = GST_ROUND_UP_N (maxsize, LARGE_PAGE_SIZE);
+
+  /* map an extra huge page and trim the mapping to an aligned address */
+  base = mmap (NULL, map_size + LARGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    GST_CAT_WARNING (GST_CAT_MEMORY, "mmap of %" G_GSIZE_FORMAT " bytes "
+        "failed: %s", map_size, g_strerror (errno));
+    return NULL;
+  }
+  data = (guint8 *) GST_ROUND_UP_N ((guintptr) base, LARGE_PAGE_SIZE);
+  head = data - base;
+  if (head > 0)
+    munmap (base, head);
+  munmap (data + map_size, LARGE_PAGE_SIZE - head);
+
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+  if (madvise (data, map_size, MADV_HUGEPAGE) != 0)
+    GST_CAT_DEBUG (GST_CAT_MEMORY, "no transparent huge pages: %s",
+        g_strerror (errno));
+#endif
+
+  /* anonymous memory is zeroed already, write to make the kernel allocate
+   * the pages now */
+  for (i = 0; i < map_size; i += 4096)
+    data[i] = 0;
+
+  mem = g_slice_new (GstMemorySystem);
+  gst_memory_init (GST_MEMORY_CAST (mem), flags, allocator, NULL, maxsize,
+      align, offset, size);
+  mem->slice_size = sizeof (GstMemorySystem);
+  mem->data = data;
+  mem->user_data = NULL;
+  mem->notify = NULL;
+  mem->map_data = data;
+  mem->map_size = map_size;
+
+  GST_CAT_DEBUG (GST_CAT_MEMORY, "allocated %" G_GSIZE_FORMAT " bytes in "
+      "huge page mapping %p", map_size, data);
+
+  return mem;
+}
+#endif
+
 static gpointer
 _sysmem_map (GstMemorySystem * mem, gsize maxsize, GstMapFlags flags)
 {
@@ -510,6 +590,17 @@ default_alloc (GstAllocator * allocator, gsize size,
 {
   gsize maxsize = size + params->prefix + params->padding;
 
+#if defined(HAVE_MMAP) && defined(MAP_ANONYMOUS)
+  if (((GstAllocatorSysmem *) allocator)->large && maxsize >= LARGE_PAGE_SIZE) {
+    GstMemorySystem *mem;
+
+    mem = _sysmem_new_block_large (allocator, params->flags,
+        maxsize, params->align, params->prefix, size);
+    if (mem)
+      return (GstMemory *) mem;
+  }
+#endif
+
   return (GstMemory *) _sysmem_new_block (params->flags,
       maxsize, params->align, params->prefix, size);
 }
@@ -525,6 +616,11 @@ default_free (GstAllocator * allocator, GstMemory * mem)
 
   slice_size = dmem->slice_size;
 
+#ifdef HAVE_MMAP
+  if (dmem->map_data)
+    munmap (dmem->map_data, dmem->map_size);
+#endif
+
 #ifdef USE_POISONING
   /* just poison the structs, not all the data */
   memset (mem, 0xff, sizeof (GstMemorySystem));
@@ -576,6 +672,8 @@ gst_allocator_sysmem_init (GstAllocatorSysmem * allocator)
 void
 _priv_gst_allocator_initialize (void)
 {
+  GstAllocator *large;
+
   g_rw_lock_init (&lock);
   allocators = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
       gst_object_unref);
@@ -595,6 +693,10 @@ _priv_gst_allocator_initialize (void)
       gst_object_ref (_sysmem_allocator));
 
   _default_allocator = gst_object_ref (_sysmem_allocator);
+
+  large = g_object_new (gst_allocator_sysmem_get_type (), NULL);
+  ((GstAllocatorSysmem *) large)->large = TRUE;
+  gst_allocator_register (GST_ALLOCATOR_SYSMEM_LARGE, large);
 }
 
 void
@@ -59,6 +59,22 @@ GST_EXPORT gsize gst_memory_alignment;
  */
 #define GST_ALLOCATOR_SYSMEM   "SystemMemory"
 
+/**
+ * GST_ALLOCATOR_SYSMEM_LARGE:
+ *
+ * The allocator name for a system memory allocator meant for big blocks
+ * such as raw video frames. Blocks of 2MB and more get their own mapping,
+ * backed by transparent huge pages where the system supports them, and are
+ * faulted in by the allocating thread so that they are placed on its NUMA
+ * node. Smaller blocks are allocated like with #GST_ALLOCATOR_SYSMEM.
+ *
+ * Combine it with a #GstTaskPool pinned to a NUMA node to keep the frames
+ * produced by a streaming thread on the node it runs on.
+ *
+ * Since: 1.10
+ */
+#define GST_ALLOCATOR_SYSMEM_LARGE "SystemMemoryLarge"
+
 /**
  * GstAllocationParams:
  * @flags: flags to control allocation
@@ -164,6 +164,7 @@
 
 #include "gstutils.h"
 #include "gstchildproxy.h"
+#include "gsttaskpool.h"
 
 GST_DEBUG_CATEGORY_STATIC (bin_debug);
 #define GST_CAT_DEFAULT bin_debug
@@ -197,6 +198,9 @@ struct _GstBinPrivate
 
   gboolean posted_eos;
   gboolean posted_playing;
+
+  /* change the state of independent children concurrently */
+  gboolean parallel_state_changes;
 };
 
 typedef struct
@@ -265,12 +269,14 @@ enum
 
 #define DEFAULT_ASYNC_HANDLING	FALSE
 #define DEFAULT_MESSAGE_FORWARD	FALSE
+#define DEFAULT_PARALLEL_STATE_CHANGES	FALSE
 
 enum
 {
   PROP_0,
   PROP_ASYNC_HANDLING,
   PROP_MESSAGE_FORWARD,
+  PROP_PARALLEL_STATE_CHANGES,
   PROP_LAST
 };
 
@@ -439,6 +445,28 @@ gst_bin_class_init (GstBinClass * klass)
           "Forwards all children messages",
           DEFAULT_MESSAGE_FORWARD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBin:parallel-state-changes:
+   *
+   * Change the state of the children that don't depend on each other
+   * concurrently. The children are grouped in levels, starting with the sinks,
+   * where each level only contains elements whose downstream peers are all in
+   * earlier levels. All the children of a level change their state from a
+   * thread pool and the next level is only started when they are all done.
+   *
+   * This can speed up state changes of bins with many elements that take a
+   * long time to open their resources, like network sources. The state
+   * change functions of the children of such a bin must not depend on being
+   * called from the application thread.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_PARALLEL_STATE_CHANGES,
+      g_param_spec_boolean ("parallel-state-changes", "Parallel State Changes",
+          "Change the state of independent children concurrently",
+          DEFAULT_PARALLEL_STATE_CHANGES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_bin_dispose;
 
   gst_element_class_set_static_metadata (gstelement_class, "Generic bin",
@@ -494,6 +522,7 @@ gst_bin_init (GstBin * bin)
   bin->priv->asynchandling = DEFAULT_ASYNC_HANDLING;
   bin->priv->structure_cookie = 0;
   bin->priv->message_forward = DEFAULT_MESSAGE_FORWARD;
+  bin->priv->parallel_state_changes = DEFAULT_PARALLEL_STATE_CHANGES;
 }
 
 static void
@@ -557,6 +586,11 @@ gst_bin_set_property (GObject * object, guint prop_id,
       gstbin->priv->message_forward = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_PARALLEL_STATE_CHANGES:
+      GST_OBJECT_LOCK (gstbin);
+      gstbin->priv->parallel_state_changes = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -582,6 +616,11 @@ gst_bin_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, gstbin->priv->message_forward);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_PARALLEL_STATE_CHANGES:
+      GST_OBJECT_LOCK (gstbin);
+      g_value_set_boolean (value, gstbin->priv->parallel_state_changes);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2632,6 +2671,306 @@ reset_state (const GValue * data, gpointer user_data)
         gst_element_state_get_name (state));
 }
 
+/* check the result of a state change of @child, returns %FALSE when the
+ * state change of the bin failed */
+static gboolean
+gst_bin_handle_child_state_return (GstBin * bin, GstElement * child,
+    GstState next, GstStateChangeReturn ret, gboolean * have_async,
+    gboolean * have_no_preroll)
+{
+  GstElement *element = GST_ELEMENT_CAST (bin);
+
+  switch (ret) {
+    case GST_STATE_CHANGE_SUCCESS:
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
+          "child '%s' changed state to %d(%s) successfully",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+      break;
+    case GST_STATE_CHANGE_ASYNC:
+    {
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
+          "child '%s' is changing state asynchronously to %s",
+          GST_ELEMENT_NAME (child), gst_element_state_get_name (next));
+      *have_async = TRUE;
+      break;
+    }
+    case GST_STATE_CHANGE_FAILURE:{
+      GstObject *parent;
+
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
+          "child '%s' failed to go to state %d(%s)",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+
+      /* Only fail if the child is still inside
+       * this bin. It might've been removed already
+       * because of the error by the bin subclass
+       * to ignore the error.  */
+      parent = gst_object_get_parent (GST_OBJECT_CAST (child));
+      if (parent == GST_OBJECT_CAST (element)) {
+        /* element is still in bin, really error now */
+        gst_object_unref (parent);
+        return FALSE;
+      }
+      /* child removed from bin, let the resync code redo the state
+       * change */
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
+          "child '%s' was removed from the bin", GST_ELEMENT_NAME (child));
+
+      if (parent)
+        gst_object_unref (parent);
+
+      break;
+    }
+    case GST_STATE_CHANGE_NO_PREROLL:
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
+          "child '%s' changed state to %d(%s) successfully without preroll",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+      *have_no_preroll = TRUE;
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  return TRUE;
+}
+
+/***********************************************
+ * Parallel state changes
+ *
+ * The children are split in levels like the topologically sorted iterator
+ * does: the first level contains the elements without downstream peers in
+ * the bin, every next level the elements whose downstream peers are all in
+ * the previous levels. The elements in one level don't depend on each other
+ * and change their state concurrently.
+ */
+typedef struct
+{
+  gint degree;                  /* downstream peers not in a level yet */
+  GList *upstream;              /* elements linked to our sinkpads */
+} BinLevelNode;
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  guint pending;
+} BinLevelWait;
+
+typedef struct
+{
+  GstBin *bin;
+  GstElement *element;
+  GstClockTime base_time;
+  GstClockTime start_time;
+  GstState current;
+  GstState next;
+  GstStateChangeReturn ret;
+  BinLevelWait *wait;
+} BinStateChangeJob;
+
+static void
+bin_level_node_free (BinLevelNode * node)
+{
+  g_list_free (node->upstream);
+  g_slice_free (BinLevelNode, node);
+}
+
+static void
+bin_levels_free (GList * levels)
+{
+  GList *l;
+
+  for (l = levels; l; l = l->next)
+    g_list_free_full (l->data, gst_object_unref);
+  g_list_free (levels);
+}
+
+/* split the children in levels, each one a list of reffed elements. Returns
+ * %FALSE when there is a loop in the graph. Should be called with the bin
+ * LOCK held */
+static gboolean
+gst_bin_sort_levels (GstBin * bin, GList ** levels)
+{
+  GHashTable *nodes;
+  GList *children, *level, *l, *u;
+  guint remaining;
+
+  nodes = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) bin_level_node_free);
+
+  for (children = bin->children; children; children = children->next)
+    g_hash_table_insert (nodes, children->data, g_slice_new0 (BinLevelNode));
+
+  for (children = bin->children; children; children = children->next) {
+    GstElement *element = children->data;
+    GList *pads;
+
+    GST_OBJECT_LOCK (element);
+    for (pads = element->sinkpads; pads; pads = g_list_next (pads)) {
+      GstPad *peer;
+      GstElement *peer_element;
+      BinLevelNode *node;
+
+      if (!(peer = gst_pad_get_peer (GST_PAD_CAST (pads->data))))
+        continue;
+
+      if ((peer_element = gst_pad_get_parent_element (peer))) {
+        /* the hash table only contains our children */
+        if ((node = g_hash_table_lookup (nodes, peer_element))) {
+          BinLevelNode *element_node = g_hash_table_lookup (nodes, element);
+
+          element_node->upstream =
+              g_list_prepend (element_node->upstream, peer_element);
+          node->degree++;
+        }
+        gst_object_unref (peer_element);
+      }
+      gst_object_unref (peer);
+    }
+    GST_OBJECT_UNLOCK (element);
+  }
+
+  *levels = NULL;
+  level = NULL;
+  remaining = bin->numchildren;
+
+  for (children = bin->children; children; children = children->next) {
+    BinLevelNode *node = g_hash_table_lookup (nodes, children->data);
+
+    if (node->degree == 0)
+      level = g_list_prepend (level, gst_object_ref (children->data));
+  }
+
+  while (level) {
+    GList *next_level = NULL;
+
+    *levels = g_list_prepend (*levels, level);
+    remaining -= g_list_length (level);
+
+    for (l = level; l; l = l->next) {
+      BinLevelNode *node = g_hash_table_lookup (nodes, l->data);
+
+      for (u = node->upstream; u; u = u->next) {
+        BinLevelNode *upstream = g_hash_table_lookup (nodes, u->data);
+
+        if (--upstream->degree == 0)
+          next_level = g_list_prepend (next_level, gst_object_ref (u->data));
+      }
+    }
+    level = next_level;
+  }
+  *levels = g_list_reverse (*levels);
+
+  g_hash_table_destroy (nodes);
+
+  if (remaining > 0) {
+    GST_DEBUG_OBJECT (bin, "loop in the graph, can't sort in levels");
+    bin_levels_free (*levels);
+    *levels = NULL;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static GstTaskPool *
+gst_bin_get_state_change_pool (void)
+{
+  static gsize pool = 0;
+
+  if (g_once_init_enter (&pool)) {
+    GstTaskPool *p = gst_task_pool_new ();
+
+    gst_task_pool_prepare (p, NULL);
+    g_once_init_leave (&pool, (gsize) p);
+  }
+
+  return (GstTaskPool *) pool;
+}
+
+static void
+bin_state_change_job_func (BinStateChangeJob * job)
+{
+  job->ret = gst_bin_element_set_state (job->bin, job->element,
+      job->base_time, job->start_time, job->current, job->next);
+
+  g_mutex_lock (&job->wait->lock);
+  if (--job->wait->pending == 0)
+    g_cond_signal (&job->wait->cond);
+  g_mutex_unlock (&job->wait->lock);
+}
+
+/* change the state of all elements of @level concurrently and wait for them,
+ * returns %FALSE when the state change of the bin failed */
+static gboolean
+gst_bin_change_level_state (GstBin * bin, GList * level,
+    GstClockTime base_time, GstClockTime start_time, GstState current,
+    GstState next, gboolean * have_async, gboolean * have_no_preroll)
+{
+  GstTaskPool *pool = gst_bin_get_state_change_pool ();
+  BinStateChangeJob *jobs;
+  BinLevelWait wait;
+  GList *l;
+  guint i, n_jobs;
+  gboolean res = TRUE;
+
+  n_jobs = g_list_length (level);
+  jobs = g_new0 (BinStateChangeJob, n_jobs);
+
+  g_mutex_init (&wait.lock);
+  g_cond_init (&wait.cond);
+  wait.pending = n_jobs;
+
+  for (l = level, i = 0; l; l = l->next, i++) {
+    BinStateChangeJob *job = &jobs[i];
+
+    job->bin = bin;
+    job->element = l->data;
+    job->base_time = base_time;
+    job->start_time = start_time;
+    job->current = current;
+    job->next = next;
+    job->wait = &wait;
+
+    /* the last one is done from this thread while the others run */
+    if (l->next != NULL) {
+      GError *error = NULL;
+
+      GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, bin,
+          "changing state of child '%s' from the pool",
+          GST_ELEMENT_NAME (job->element));
+      gst_task_pool_push (pool, (GstTaskPoolFunction) bin_state_change_job_func,
+          job, &error);
+      if (error == NULL)
+        continue;
+
+      GST_CAT_WARNING_OBJECT (GST_CAT_STATES, bin,
+          "failed to push state change: %s", error->message);
+      g_clear_error (&error);
+    }
+    bin_state_change_job_func (job);
+  }
+
+  g_mutex_lock (&wait.lock);
+  while (wait.pending > 0)
+    g_cond_wait (&wait.cond, &wait.lock);
+  g_mutex_unlock (&wait.lock);
+
+  g_cond_clear (&wait.cond);
+  g_mutex_clear (&wait.lock);
+
+  /* handle the results in the order of the level so that the outcome doesn't
+   * depend on which child finished first */
+  for (i = 0; i < n_jobs && res; i++) {
+    res = gst_bin_handle_child_state_return (bin, jobs[i].element, next,
+        jobs[i].ret, have_async, have_no_preroll);
+  }
+  g_free (jobs);
+
+  return res;
+}
+
 static GstStateChangeReturn
 gst_bin_change_state_func (GstElement * element, GstStateChange transition)
 {
@@ -2643,6 +2982,7 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
   GstClockTime base_time, start_time;
   GstIterator *it;
   gboolean done;
+  gboolean parallel;
   GValue data = { 0, };
 
   /* we don't need to take the STATE_LOCK, it is already taken */
@@ -2715,6 +3055,7 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
    * don't want them to interfere with this state change */
   GST_OBJECT_LOCK (bin);
   bin->polling = TRUE;
+  parallel = bin->priv->parallel_state_changes;
   GST_OBJECT_UNLOCK (bin);
 
   /* iterate in state change order */
@@ -2726,6 +3067,45 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
    * even after a resync when the async element is gone */
   have_async = FALSE;
 
+  while (parallel) {
+    GList *levels, *l;
+    guint32 cookie;
+
+    base_time = gst_element_get_base_time (element);
+    start_time = gst_element_get_start_time (element);
+
+    have_no_preroll = FALSE;
+
+    GST_OBJECT_LOCK (bin);
+    cookie = bin->priv->structure_cookie;
+    if (!gst_bin_sort_levels (bin, &levels)) {
+      GST_OBJECT_UNLOCK (bin);
+      /* the sorted iterator handles loops */
+      parallel = FALSE;
+      break;
+    }
+    GST_OBJECT_UNLOCK (bin);
+
+    for (l = levels; l; l = l->next) {
+      if (!gst_bin_change_level_state (bin, l->data, base_time, start_time,
+              current, next, &have_async, &have_no_preroll)) {
+        bin_levels_free (levels);
+        goto undo;
+      }
+    }
+    bin_levels_free (levels);
+
+    /* like the resync of the iterator, do it again when the graph changed.
+     * Children that already changed state will be skipped */
+    GST_OBJECT_LOCK (bin);
+    if (cookie == bin->priv->structure_cookie) {
+      GST_OBJECT_UNLOCK (bin);
+      goto children_done;
+    }
+    GST_OBJECT_UNLOCK (bin);
+    GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, element, "graph changed, restart");
+  }
+
 restart:
   /* take base_time */
   base_time = gst_element_get_base_time (element);
@@ -2746,61 +3126,10 @@ restart:
         ret = gst_bin_element_set_state (bin, child, base_time, start_time,
             current, next);
 
-        switch (ret) {
-          case GST_STATE_CHANGE_SUCCESS:
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' changed state to %d(%s) successfully",
-                GST_ELEMENT_NAME (child), next,
-                gst_element_state_get_name (next));
-            break;
-          case GST_STATE_CHANGE_ASYNC:
-          {
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' is changing state asynchronously to %s",
-                GST_ELEMENT_NAME (child), gst_element_state_get_name (next));
-            have_async = TRUE;
-            break;
-          }
-          case GST_STATE_CHANGE_FAILURE:{
-            GstObject *parent;
-
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' failed to go to state %d(%s)",
-                GST_ELEMENT_NAME (child),
-                next, gst_element_state_get_name (next));
-
-            /* Only fail if the child is still inside
-             * this bin. It might've been removed already
-             * because of the error by the bin subclass
-             * to ignore the error.  */
-            parent = gst_object_get_parent (GST_OBJECT_CAST (child));
-            if (parent == GST_OBJECT_CAST (element)) {
-              /* element is still in bin, really error now */
-              gst_object_unref (parent);
-              goto undo;
-            }
-            /* child removed from bin, let the resync code redo the state
-             * change */
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' was removed from the bin",
-                GST_ELEMENT_NAME (child));
-
-            if (parent)
-              gst_object_unref (parent);
+        if (!gst_bin_handle_child_state_return (bin, child, next, ret,
+                &have_async, &have_no_preroll))
+          goto undo;
 
-            break;
-          }
-          case GST_STATE_CHANGE_NO_PREROLL:
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' changed state to %d(%s) successfully without preroll",
-                GST_ELEMENT_NAME (child), next,
-                gst_element_state_get_name (next));
-            have_no_preroll = TRUE;
-            break;
-          default:
-            g_assert_not_reached ();
-            break;
-        }
         g_value_reset (&data);
         break;
       }
@@ -2816,6 +3145,7 @@ restart:
     }
   }
 
+children_done:
   ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
   if (G_UNLIKELY (ret == GST_STATE_CHANGE_FAILURE))
     goto done;
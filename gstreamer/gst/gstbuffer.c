@@ -126,6 +126,7 @@
 
 #include "gstbuffer.h"
 #include "gstbufferpool.h"
+#include "gstatomicqueue.h"
 #include "gstinfo.h"
 #include "gstutils.h"
 #include "gstversion.h"
@@ -142,6 +143,8 @@ struct _GstMetaItem
 #define ITEM_SIZE(info) ((info)->size + sizeof (GstMetaItem))
 
 #define GST_BUFFER_MEM_MAX         16
+#define GST_BUFFER_META_INDEX_MAX  4
+#define GST_BUFFER_META_INLINE     256
 
 #define GST_BUFFER_SLICE_SIZE(b)   (((GstBufferImpl *)(b))->slice_size)
 #define GST_BUFFER_MEM_LEN(b)      (((GstBufferImpl *)(b))->len)
@@ -149,6 +152,9 @@ struct _GstMetaItem
 #define GST_BUFFER_MEM_PTR(b,i)    (((GstBufferImpl *)(b))->mem[i])
 #define GST_BUFFER_BUFMEM(b)       (((GstBufferImpl *)(b))->bufmem)
 #define GST_BUFFER_META(b)         (((GstBufferImpl *)(b))->item)
+#define GST_BUFFER_META_API(b,i)   (((GstBufferImpl *)(b))->meta_api[i])
+#define GST_BUFFER_META_INDEX(b,i) (((GstBufferImpl *)(b))->meta_index[i])
+#define GST_BUFFER_META_ALL(b) (((GstBufferImpl *)(b))->meta_index_complete)
 
 typedef struct
 {
@@ -163,11 +169,166 @@ typedef struct
   /* memory of the buffer when allocated from 1 chunk */
   GstMemory *bufmem;
 
-  /* FIXME, make metadata allocation more efficient by using part of the
-   * GstBufferImpl */
   GstMetaItem *item;
+
+  /* the most recently added meta of up to GST_BUFFER_META_INDEX_MAX API
+   * types, complete when all metas of the buffer are in the index */
+  GType meta_api[GST_BUFFER_META_INDEX_MAX];
+  GstMeta *meta_index[GST_BUFFER_META_INDEX_MAX];
+  gboolean meta_index_complete;
+
+  /* the first metas are allocated from here, the space is reused once all
+   * items in it are freed */
+  gsize meta_inline_used;
+  guint meta_inline_items;
+  union
+  {
+    guint8 data[GST_BUFFER_META_INLINE];
+    gint64 align_int;
+    gdouble align_double;
+    gpointer align_pointer;
+  } meta_inline;
 } GstBufferImpl;
 
+/* Buffer headers and meta items can be recycled through lock-free caches
+ * instead of going back to the slice allocator. This is enabled by setting
+ * GST_BUFFER_CACHE to the number of objects to keep per cache. Meta items
+ * are rounded up to a few size classes so that they can be shared between
+ * metas of a similar size. */
+#define META_CACHE_CLASS_SIZE      64
+#define META_CACHE_CLASSES         4
+
+static guint cache_max = 0;
+static GstAtomicQueue *header_cache = NULL;
+static GstAtomicQueue *meta_cache[META_CACHE_CLASSES];
+
+static inline gpointer
+_cache_alloc (GstAtomicQueue * cache, gsize size)
+{
+  gpointer mem = NULL;
+
+  if (cache)
+    mem = gst_atomic_queue_pop (cache);
+  if (mem == NULL)
+    mem = g_slice_alloc (size);
+
+  return mem;
+}
+
+static inline void
+_cache_free (GstAtomicQueue * cache, gsize size, gpointer mem)
+{
+  if (cache && gst_atomic_queue_length (cache) < cache_max)
+    gst_atomic_queue_push (cache, mem);
+  else
+    g_slice_free1 (size, mem);
+}
+
+/* returns the cache for meta items of @info and updates @size to the size
+ * of the items in it */
+static inline GstAtomicQueue *
+_meta_item_cache (const GstMetaInfo * info, gsize * size)
+{
+  guint idx;
+
+  *size = ITEM_SIZE (info);
+  if (cache_max == 0 || *size > META_CACHE_CLASS_SIZE * META_CACHE_CLASSES)
+    return NULL;
+
+  idx = (*size - 1) / META_CACHE_CLASS_SIZE;
+  *size = (idx + 1) * META_CACHE_CLASS_SIZE;
+
+  return meta_cache[idx];
+}
+
+static GstMetaItem *
+_meta_item_alloc (GstBuffer * buffer, const GstMetaInfo * info)
+{
+  GstBufferImpl *impl = (GstBufferImpl *) buffer;
+  GstAtomicQueue *cache;
+  GstMetaItem *item;
+  gsize size;
+
+  size = GST_ROUND_UP_8 (ITEM_SIZE (info));
+  if (impl->meta_inline_used + size <= GST_BUFFER_META_INLINE) {
+    item = (GstMetaItem *) (impl->meta_inline.data + impl->meta_inline_used);
+    impl->meta_inline_used += size;
+    impl->meta_inline_items++;
+  } else {
+    cache = _meta_item_cache (info, &size);
+    item = _cache_alloc (cache, size);
+  }
+
+  return item;
+}
+
+static void
+_meta_item_free (GstBuffer * buffer, const GstMetaInfo * info,
+    GstMetaItem * item)
+{
+  GstBufferImpl *impl = (GstBufferImpl *) buffer;
+  GstAtomicQueue *cache;
+  gsize size;
+
+  if ((guint8 *) item >= impl->meta_inline.data &&
+      (guint8 *) item < impl->meta_inline.data + GST_BUFFER_META_INLINE) {
+    if (--impl->meta_inline_items == 0)
+      impl->meta_inline_used = 0;
+    return;
+  }
+
+  cache = _meta_item_cache (info, &size);
+  _cache_free (cache, size, item);
+}
+
+/* makes @meta the one returned for its API type, must be called with the
+ * most recently added meta last */
+static void
+_meta_index_add (GstBuffer * buffer, GstMeta * meta)
+{
+  GType api = meta->info->api;
+  guint i;
+
+  for (i = 0; i < GST_BUFFER_META_INDEX_MAX; i++) {
+    if (GST_BUFFER_META_API (buffer, i) == api
+        || GST_BUFFER_META_API (buffer, i) == 0) {
+      GST_BUFFER_META_API (buffer, i) = api;
+      GST_BUFFER_META_INDEX (buffer, i) = meta;
+      return;
+    }
+  }
+  GST_BUFFER_META_ALL (buffer) = FALSE;
+}
+
+static void
+_meta_index_rebuild (GstBuffer * buffer)
+{
+  GstMetaItem *walk;
+  GType api;
+  guint i;
+
+  for (i = 0; i < GST_BUFFER_META_INDEX_MAX; i++)
+    GST_BUFFER_META_API (buffer, i) = 0;
+  GST_BUFFER_META_ALL (buffer) = TRUE;
+
+  /* the list has the most recent metas first, only index the first meta of
+   * each API type */
+  for (walk = GST_BUFFER_META (buffer); walk; walk = walk->next) {
+    api = walk->meta.info->api;
+    for (i = 0; i < GST_BUFFER_META_INDEX_MAX; i++) {
+      if (GST_BUFFER_META_API (buffer, i) == api)
+        break;
+      if (GST_BUFFER_META_API (buffer, i) == 0) {
+        GST_BUFFER_META_API (buffer, i) = api;
+        GST_BUFFER_META_INDEX (buffer, i) = &walk->meta;
+        break;
+      }
+    }
+    if (i == GST_BUFFER_META_INDEX_MAX)
+      GST_BUFFER_META_ALL (buffer) = FALSE;
+  }
+}
+
 
 static gboolean
 _is_span (GstMemory ** mem, gsize len, gsize * poffset, GstMemory ** parent)
@@ -372,7 +533,23 @@ GST_DEFINE_MINI_OBJECT_TYPE (GstBuffer, gst_buffer);
 void
 _priv_gst_buffer_initialize (void)
 {
+  const gchar *env;
+
   _gst_buffer_type = gst_buffer_get_type ();
+
+  env = g_getenv ("GST_BUFFER_CACHE");
+  if (env != NULL && *env != '\0') {
+    guint i;
+
+    cache_max = strtoul (env, NULL, 10);
+    if (cache_max > 0) {
+      GST_CAT_INFO (GST_CAT_BUFFER, "caching up to %u buffer headers and "
+          "meta items", cache_max);
+      header_cache = gst_atomic_queue_new (cache_max);
+      for (i = 0; i < META_CACHE_CLASSES; i++)
+        meta_cache[i] = gst_atomic_queue_new (cache_max);
+    }
+  }
 }
 
 /**
@@ -663,7 +840,7 @@ _gst_buffer_free (GstBuffer * buffer)
 
     next = walk->next;
     /* and free the slice */
-    g_slice_free1 (ITEM_SIZE (info), walk);
+    _meta_item_free (buffer, info, walk);
   }
 
   /* get the size, when unreffing the memory, we could also unref the buffer
@@ -682,7 +859,10 @@ _gst_buffer_free (GstBuffer * buffer)
 #ifdef USE_POISONING
     memset (buffer, 0xff, msize);
 #endif
-    g_slice_free1 (msize, buffer);
+    if (msize == sizeof (GstBufferImpl))
+      _cache_free (header_cache, msize, buffer);
+    else
+      g_slice_free1 (msize, buffer);
   } else {
     gst_memory_unref (GST_BUFFER_BUFMEM (buffer));
   }
@@ -707,6 +887,10 @@ gst_buffer_init (GstBufferImpl * buffer, gsize size)
 
   GST_BUFFER_MEM_LEN (buffer) = 0;
   GST_BUFFER_META (buffer) = NULL;
+  memset (buffer->meta_api, 0, sizeof (buffer->meta_api));
+  buffer->meta_index_complete = TRUE;
+  buffer->meta_inline_used = 0;
+  buffer->meta_inline_items = 0;
 }
 
 /**
@@ -723,7 +907,7 @@ gst_buffer_new (void)
 {
   GstBufferImpl *newbuf;
 
-  newbuf = g_slice_new (GstBufferImpl);
+  newbuf = _cache_alloc (header_cache, sizeof (GstBufferImpl));
   GST_CAT_LOG (GST_CAT_BUFFER, "new %p", newbuf);
 
   gst_buffer_init (newbuf, sizeof (GstBufferImpl));
@@ -2052,10 +2236,18 @@ gst_buffer_get_meta (GstBuffer * buffer, GType api)
 {
   GstMetaItem *item;
   GstMeta *result = NULL;
+  guint i;
 
   g_return_val_if_fail (buffer != NULL, NULL);
   g_return_val_if_fail (api != 0, NULL);
 
+  for (i = 0; i < GST_BUFFER_META_INDEX_MAX; i++) {
+    if (GST_BUFFER_META_API (buffer, i) == api)
+      return GST_BUFFER_META_INDEX (buffer, i);
+  }
+  if (GST_BUFFER_META_ALL (buffer))
+    return NULL;
+
   /* find GstMeta of the requested API */
   for (item = GST_BUFFER_META (buffer); item; item = item->next) {
     GstMeta *meta = &item->meta;
@@ -2083,22 +2275,19 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
 {
   GstMetaItem *item;
   GstMeta *result = NULL;
-  gsize size;
 
   g_return_val_if_fail (buffer != NULL, NULL);
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (gst_buffer_is_writable (buffer), NULL);
 
   /* create a new slice */
-  size = ITEM_SIZE (info);
+  item = _meta_item_alloc (buffer, info);
   /* We warn in gst_meta_register() about metas without
    * init function but let's play safe here and prevent
    * uninitialized memory
    */
   if (!info->init_func)
-    item = g_slice_alloc0 (size);
-  else
-    item = g_slice_alloc (size);
+    memset (item, 0, ITEM_SIZE (info));
   result = &item->meta;
   result->info = info;
   result->flags = GST_META_FLAG_NONE;
@@ -2115,12 +2304,13 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
   /* and add to the list of metadata */
   item->next = GST_BUFFER_META (buffer);
   GST_BUFFER_META (buffer) = item;
+  _meta_index_add (buffer, result);
 
   return result;
 
 init_failed:
   {
-    g_slice_free1 (size, item);
+    _meta_item_free (buffer, info, item);
     return NULL;
   }
 }
@@ -2163,7 +2353,8 @@ gst_buffer_remove_meta (GstBuffer * buffer, GstMeta * meta)
         info->free_func (m, buffer);
 
       /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      _meta_item_free (buffer, info, walk);
+      _meta_index_rebuild (buffer);
       break;
     }
     prev = walk;
@@ -2225,7 +2416,7 @@ gst_buffer_foreach_meta (GstBuffer * buffer, GstBufferForeachMetaFunc func,
     gpointer user_data)
 {
   GstMetaItem *walk, *prev, *next;
-  gboolean res = TRUE;
+  gboolean res = TRUE, removed = FALSE;
 
   g_return_val_if_fail (buffer != NULL, FALSE);
   g_return_val_if_fail (func != NULL, FALSE);
@@ -2261,11 +2452,15 @@ gst_buffer_foreach_meta (GstBuffer * buffer, GstBufferForeachMetaFunc func,
         info->free_func (m, buffer);
 
       /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      _meta_item_free (buffer, info, walk);
+      removed = TRUE;
     }
     if (!res)
       break;
   }
+  if (removed)
+    _meta_index_rebuild (buffer);
+
   return res;
 }
 
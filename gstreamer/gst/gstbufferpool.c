@@ -89,6 +89,30 @@ GST_DEBUG_CATEGORY_STATIC (gst_buffer_pool_debug);
 #define GST_BUFFER_POOL_LOCK(pool)   (g_rec_mutex_lock(&pool->priv->rec_lock))
 #define GST_BUFFER_POOL_UNLOCK(pool) (g_rec_mutex_unlock(&pool->priv->rec_lock))
 
+/* size of the per-thread caches and how many buffers we move from the shared
+ * queue when one runs empty */
+#define MAGAZINE_SIZE   8
+#define MAGAZINE_REFILL (MAGAZINE_SIZE / 2)
+
+/* A cache of free buffers of one pool for one thread. It is referenced by the
+ * thread and by the pool, whoever goes away first clears its side. The lock
+ * is normally only taken by the owning thread and only contended when the
+ * pool is stopped or finalized. */
+typedef struct
+{
+  gint refcount;
+  GMutex lock;
+  GstBufferPool *pool;          /* NULL when the pool was finalized */
+  guint n_buffers;
+  GstBuffer *buffers[MAGAZINE_SIZE];
+} GstBufferPoolMagazine;
+
+static void magazine_detach (GstBufferPoolMagazine * mag);
+static void thread_magazines_free (gpointer data);
+
+/* GSList of the magazines of the current thread */
+static GPrivate thread_magazines = G_PRIVATE_INIT (thread_magazines_free);
+
 struct _GstBufferPoolPrivate
 {
   GstAtomicQueue *queue;
@@ -109,6 +133,9 @@ struct _GstBufferPoolPrivate
   guint cur_buffers;
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  gboolean thread_cache;
+  GList *magazines;             /* protected by the lock */
 };
 
 static void gst_buffer_pool_finalize (GObject * object);
@@ -190,6 +217,7 @@ gst_buffer_pool_finalize (GObject * object)
   GST_DEBUG_OBJECT (pool, "%p finalize", pool);
 
   gst_buffer_pool_set_active (pool, FALSE);
+  g_list_free_full (priv->magazines, (GDestroyNotify) magazine_detach);
   gst_atomic_queue_unref (priv->queue);
   gst_poll_free (priv->poll);
   gst_structure_free (priv->config);
@@ -200,6 +228,170 @@ gst_buffer_pool_finalize (GObject * object)
   G_OBJECT_CLASS (gst_buffer_pool_parent_class)->finalize (object);
 }
 
+static void
+magazine_unref (GstBufferPoolMagazine * mag)
+{
+  if (g_atomic_int_dec_and_test (&mag->refcount)) {
+    g_mutex_clear (&mag->lock);
+    g_slice_free (GstBufferPoolMagazine, mag);
+  }
+}
+
+/* must be called with the pool lock */
+static void
+magazine_flush (GstBufferPoolMagazine * mag)
+{
+  GstBufferPoolPrivate *priv = mag->pool->priv;
+
+  g_mutex_lock (&mag->lock);
+  while (mag->n_buffers > 0) {
+    gst_atomic_queue_push (priv->queue, mag->buffers[--mag->n_buffers]);
+    gst_poll_write_control (priv->poll);
+  }
+  g_mutex_unlock (&mag->lock);
+}
+
+/* called when the pool is finalized, the magazine was flushed when stopping
+ * so it does not contain any buffers anymore */
+static void
+magazine_detach (GstBufferPoolMagazine * mag)
+{
+  g_mutex_lock (&mag->lock);
+  g_warn_if_fail (mag->n_buffers == 0);
+  mag->pool = NULL;
+  g_mutex_unlock (&mag->lock);
+
+  magazine_unref (mag);
+}
+
+/* called when a thread exits, give the cached buffers back to the pool */
+static void
+thread_magazines_free (gpointer data)
+{
+  GSList *walk;
+
+  for (walk = data; walk; walk = walk->next) {
+    GstBufferPoolMagazine *mag = walk->data;
+
+    g_mutex_lock (&mag->lock);
+    if (mag->pool) {
+      GstBufferPoolPrivate *priv = mag->pool->priv;
+
+      while (mag->n_buffers > 0) {
+        gst_atomic_queue_push (priv->queue, mag->buffers[--mag->n_buffers]);
+        gst_poll_write_control (priv->poll);
+      }
+    }
+    g_mutex_unlock (&mag->lock);
+
+    magazine_unref (mag);
+  }
+  g_slist_free (data);
+}
+
+/* get the magazine of the current thread for @pool, optionally creating
+ * it. The pool is alive so the magazine can't be detached while we look. */
+static GstBufferPoolMagazine *
+get_thread_magazine (GstBufferPool * pool, gboolean create)
+{
+  GstBufferPoolMagazine *mag;
+  GSList *list, *walk;
+
+  list = g_private_get (&thread_magazines);
+  for (walk = list; walk; walk = walk->next) {
+    mag = walk->data;
+    if (mag->pool == pool)
+      return mag;
+  }
+
+  if (!create)
+    return NULL;
+
+  /* drop the magazines of pools that are gone */
+  for (walk = list; walk;) {
+    GSList *next = walk->next;
+    gboolean detached;
+
+    mag = walk->data;
+    g_mutex_lock (&mag->lock);
+    detached = (mag->pool == NULL);
+    g_mutex_unlock (&mag->lock);
+
+    if (detached) {
+      list = g_slist_delete_link (list, walk);
+      magazine_unref (mag);
+    }
+    walk = next;
+  }
+
+  mag = g_slice_new0 (GstBufferPoolMagazine);
+  g_mutex_init (&mag->lock);
+  mag->pool = pool;
+  /* one ref for the thread and one for the pool */
+  mag->refcount = 2;
+
+  GST_BUFFER_POOL_LOCK (pool);
+  pool->priv->magazines = g_list_prepend (pool->priv->magazines, mag);
+  GST_BUFFER_POOL_UNLOCK (pool);
+
+  /* set, not replace, the list is reused and must not be freed */
+  g_private_set (&thread_magazines, g_slist_prepend (list, mag));
+
+  GST_LOG_OBJECT (pool, "created buffer cache %p for thread %p", mag,
+      g_thread_self ());
+
+  return mag;
+}
+
+/* take a buffer from the cache of the current thread, refill it from the
+ * shared queue when it is empty */
+static GstBuffer *
+magazine_pop (GstBufferPool * pool)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+  GstBufferPoolMagazine *mag;
+  GstBuffer *buffer = NULL;
+
+  mag = get_thread_magazine (pool, TRUE);
+
+  g_mutex_lock (&mag->lock);
+  while (mag->n_buffers < MAGAZINE_REFILL) {
+    GstBuffer *b;
+
+    if (!(b = gst_atomic_queue_pop (priv->queue)))
+      break;
+    gst_poll_read_control (priv->poll);
+    mag->buffers[mag->n_buffers++] = b;
+  }
+  if (mag->n_buffers > 0)
+    buffer = mag->buffers[--mag->n_buffers];
+  g_mutex_unlock (&mag->lock);
+
+  return buffer;
+}
+
+/* put @buffer in the cache of the current thread if it has one with room */
+static gboolean
+magazine_push (GstBufferPool * pool, GstBuffer * buffer)
+{
+  GstBufferPoolMagazine *mag;
+  gboolean res = FALSE;
+
+  /* threads that only release buffers don't get a cache, they would only
+   * keep buffers away from the threads that acquire them */
+  if (!(mag = get_thread_magazine (pool, FALSE)))
+    return FALSE;
+
+  g_mutex_lock (&mag->lock);
+  if (mag->n_buffers < MAGAZINE_SIZE) {
+    mag->buffers[mag->n_buffers++] = buffer;
+    res = TRUE;
+  }
+  g_mutex_unlock (&mag->lock);
+
+  return res;
+}
+
 /**
  * gst_buffer_pool_new:
  *
@@ -387,6 +579,11 @@ default_stop (GstBufferPool * pool)
 {
   GstBufferPoolPrivate *priv = pool->priv;
   GstBuffer *buffer;
+  GList *walk;
+
+  /* move the buffers cached by threads back to the queue */
+  for (walk = priv->magazines; walk; walk = walk->next)
+    magazine_flush (walk->data);
 
   /* clear the pool */
   while ((buffer = gst_atomic_queue_pop (priv->queue))) {
@@ -585,6 +782,11 @@ default_set_config (GstBufferPool * pool, GstStructure * config)
   priv->max_buffers = max_buffers;
   priv->cur_buffers = 0;
 
+  /* with a maximum, buffers in the caches could make other threads wait */
+  priv->thread_cache = max_buffers == 0 &&
+      gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_THREAD_CACHE);
+
   if (priv->allocator)
     gst_object_unref (priv->allocator);
   if ((priv->allocator = allocator))
@@ -1077,6 +1279,15 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
     if (G_UNLIKELY (GST_BUFFER_POOL_IS_FLUSHING (pool)))
       goto flushing;
 
+    if (priv->thread_cache) {
+      *buffer = magazine_pop (pool);
+      if (G_LIKELY (*buffer)) {
+        result = GST_FLOW_OK;
+        GST_LOG_OBJECT (pool, "acquired cached buffer %p", *buffer);
+        break;
+      }
+    }
+
     /* try to get a buffer from the queue */
     *buffer = gst_atomic_queue_pop (priv->queue);
     if (G_LIKELY (*buffer)) {
@@ -1160,6 +1371,16 @@ default_reset_buffer (GstBufferPool * pool, GstBuffer * buffer)
   GST_BUFFER_OFFSET (buffer) = GST_BUFFER_OFFSET_NONE;
   GST_BUFFER_OFFSET_END (buffer) = GST_BUFFER_OFFSET_NONE;
 
+  /* if the memory is intact, undo a resize (e.g. after a short read) so the
+   * buffer can be recycled instead of being discarded on release */
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_TAG_MEMORY)) {
+    gsize size, offset, maxsize;
+
+    size = gst_buffer_get_sizes (buffer, &offset, &maxsize);
+    if (size != pool->priv->size && maxsize - offset >= pool->priv->size)
+      gst_buffer_resize (buffer, 0, pool->priv->size);
+  }
+
   /* remove all metadata without the POOLED flag */
   gst_buffer_foreach_meta (buffer, remove_meta_unpooled, pool);
 }
@@ -1230,6 +1451,9 @@ default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
   if (G_UNLIKELY (!gst_buffer_is_all_memory_writable (buffer)))
     goto not_writable;
 
+  if (pool->priv->thread_cache && magazine_push (pool, buffer))
+    return;
+
   /* keep it around in our queue */
   gst_atomic_queue_push (pool->priv->queue, buffer);
   gst_poll_write_control (pool->priv->poll);
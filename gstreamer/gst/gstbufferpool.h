@@ -96,6 +96,22 @@ struct _GstBufferPoolAcquireParams {
  */
 #define GST_BUFFER_POOL_IS_FLUSHING(pool)  (g_atomic_int_get (&pool->flushing))
 
+/**
+ * GST_BUFFER_POOL_OPTION_THREAD_CACHE:
+ *
+ * An option that makes the default implementation keep a small cache of free
+ * buffers per streaming thread. A thread that acquires buffers from the pool
+ * then takes and returns them from its own cache, refilled in batches from
+ * the shared queue, instead of touching the shared queue for every buffer.
+ *
+ * The cache is only used for pools without a maximum number of buffers so
+ * that buffers kept in a thread's cache can never starve other threads
+ * waiting in gst_buffer_pool_acquire_buffer().
+ *
+ * Since: 1.10
+ */
+#define GST_BUFFER_POOL_OPTION_THREAD_CACHE "GstBufferPoolOptionThreadCache"
+
 /**
  * GstBufferPool:
  *
@@ -135,7 +151,8 @@ struct _GstBufferPool {
  *        not be removed from the buffer in @reset_buffer. The buffer should
  *        have the GST_BUFFER_FLAG_TAG_MEMORY cleared.
  * @reset_buffer: reset the buffer to its state when it was freshly allocated.
- *        The default implementation will clear the flags, timestamps and
+ *        The default implementation will clear the flags, timestamps, restore
+ *        the configured size of a resized buffer if its memory is untouched and
  *        will remove the metadata without the #GST_META_FLAG_POOLED flag (even
  *        the metadata with #GST_META_FLAG_LOCKED). If the
  *        #GST_BUFFER_FLAG_TAG_MEMORY was set, this function can also try to
@@ -75,6 +75,7 @@
 #include "gstatomicqueue.h"
 #include "gstinfo.h"
 #include "gstpoll.h"
+#include "gstsystemclock.h"
 
 #include "gstbus.h"
 #include "glib-compat-private.h"
@@ -99,6 +100,7 @@ enum
 
 static void gst_bus_dispose (GObject * object);
 static void gst_bus_finalize (GObject * object);
+static void gst_bus_coalesce_clear_unlocked (GstBus * bus);
 
 static guint gst_bus_signals[LAST_SIGNAL] = { 0 };
 
@@ -119,8 +121,25 @@ struct _GstBusPrivate
   gboolean enable_async;
   GstPoll *poll;
   GPollFD pollfd;
+
+  /* coalescing of messages, protected with the object lock */
+  GstMessageType coalesce_types;
+  GstClockTime coalesce_interval;
+  GstClockTime coalesce_last;
+  /* CoalesceKey -> link in coalesce_queue */
+  GHashTable *coalesce_pending;
+  GQueue coalesce_queue;
+  GstClock *coalesce_clock;
+  GstClockID coalesce_id;
 };
 
+typedef struct
+{
+  GstObject *src;
+  GstMessageType type;
+  GQuark name;
+} CoalesceKey;
+
 #define gst_bus_parent_class parent_class
 G_DEFINE_TYPE (GstBus, gst_bus, GST_TYPE_OBJECT);
 
@@ -219,6 +238,8 @@ gst_bus_init (GstBus * bus)
   bus->priv->enable_async = DEFAULT_ENABLE_ASYNC;
   g_mutex_init (&bus->priv->queue_lock);
   bus->priv->queue = gst_atomic_queue_new (32);
+  g_queue_init (&bus->priv->coalesce_queue);
+  bus->priv->coalesce_last = GST_CLOCK_TIME_NONE;
 
   /* clear floating flag */
   gst_object_ref_sink (bus);
@@ -231,6 +252,18 @@ gst_bus_dispose (GObject * object)
 {
   GstBus *bus = GST_BUS (object);
 
+  GST_OBJECT_LOCK (bus);
+  gst_bus_coalesce_clear_unlocked (bus);
+  if (bus->priv->coalesce_pending) {
+    g_hash_table_unref (bus->priv->coalesce_pending);
+    bus->priv->coalesce_pending = NULL;
+  }
+  if (bus->priv->coalesce_clock) {
+    gst_object_unref (bus->priv->coalesce_clock);
+    bus->priv->coalesce_clock = NULL;
+  }
+  GST_OBJECT_UNLOCK (bus);
+
   if (bus->priv->queue) {
     GstMessage *message;
 
@@ -282,6 +315,172 @@ gst_bus_new (void)
   return result;
 }
 
+static guint
+coalesce_key_hash (gconstpointer data)
+{
+  const CoalesceKey *key = data;
+
+  return g_direct_hash (key->src) ^ (key->type * 31) ^ key->name;
+}
+
+static gboolean
+coalesce_key_equal (gconstpointer a, gconstpointer b)
+{
+  const CoalesceKey *ka = a, *kb = b;
+
+  return ka->src == kb->src && ka->type == kb->type && ka->name == kb->name;
+}
+
+static void
+coalesce_key_free (gpointer data)
+{
+  g_slice_free (CoalesceKey, data);
+}
+
+/* move all pending coalesced messages to the queue, with the object lock */
+static void
+gst_bus_coalesce_flush_unlocked (GstBus * bus, GstClockTime now)
+{
+  GstMessage *message;
+
+  while ((message = g_queue_pop_head (&bus->priv->coalesce_queue))) {
+    GST_DEBUG_OBJECT (bus, "[msg %p] pushing coalesced message", message);
+    gst_atomic_queue_push (bus->priv->queue, message);
+    gst_poll_write_control (bus->priv->poll);
+  }
+  g_hash_table_remove_all (bus->priv->coalesce_pending);
+  bus->priv->coalesce_last = now;
+}
+
+/* drop all pending coalesced messages, with the object lock */
+static void
+gst_bus_coalesce_clear_unlocked (GstBus * bus)
+{
+  GstMessage *message;
+
+  if (bus->priv->coalesce_id) {
+    gst_clock_id_unschedule (bus->priv->coalesce_id);
+    gst_clock_id_unref (bus->priv->coalesce_id);
+    bus->priv->coalesce_id = NULL;
+  }
+  while ((message = g_queue_pop_head (&bus->priv->coalesce_queue)))
+    gst_message_unref (message);
+  if (bus->priv->coalesce_pending)
+    g_hash_table_remove_all (bus->priv->coalesce_pending);
+}
+
+static gboolean
+gst_bus_coalesce_timeout (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstBus *bus = user_data;
+
+  GST_OBJECT_LOCK (bus);
+  if (bus->priv->coalesce_id == id) {
+    gst_clock_id_unref (bus->priv->coalesce_id);
+    bus->priv->coalesce_id = NULL;
+    gst_bus_coalesce_flush_unlocked (bus, gst_clock_get_time (clock));
+  }
+  GST_OBJECT_UNLOCK (bus);
+
+  return TRUE;
+}
+
+/* Keep @message as the pending message for its source and type, replacing
+ * an older one that was not delivered yet. Pending messages are delivered
+ * at most once per coalesce interval. Called with the object lock, takes
+ * ownership of @message. */
+static void
+gst_bus_coalesce_unlocked (GstBus * bus, GstMessage * message)
+{
+  GstBusPrivate *priv = bus->priv;
+  const GstStructure *s;
+  CoalesceKey key, *new_key;
+  GstClockTime now;
+  GList *link;
+
+  key.src = GST_MESSAGE_SRC (message);
+  key.type = GST_MESSAGE_TYPE (message);
+  s = gst_message_get_structure (message);
+  key.name = s ? gst_structure_get_name_id (s) : 0;
+
+  link = g_hash_table_lookup (priv->coalesce_pending, &key);
+  if (link) {
+    GST_DEBUG_OBJECT (bus, "[msg %p] replaces pending message %p", message,
+        link->data);
+    gst_message_unref (link->data);
+    link->data = message;
+  } else {
+    g_queue_push_tail (&priv->coalesce_queue, message);
+    new_key = g_slice_new (CoalesceKey);
+    *new_key = key;
+    g_hash_table_insert (priv->coalesce_pending, new_key,
+        priv->coalesce_queue.tail);
+  }
+
+  /* a flush is already scheduled */
+  if (priv->coalesce_id)
+    return;
+
+  now = gst_clock_get_time (priv->coalesce_clock);
+  if (!GST_CLOCK_TIME_IS_VALID (priv->coalesce_last)
+      || now >= priv->coalesce_last + priv->coalesce_interval) {
+    gst_bus_coalesce_flush_unlocked (bus, now);
+  } else {
+    priv->coalesce_id = gst_clock_new_single_shot_id (priv->coalesce_clock,
+        priv->coalesce_last + priv->coalesce_interval);
+    gst_clock_id_wait_async (priv->coalesce_id, gst_bus_coalesce_timeout,
+        gst_object_ref (bus), (GDestroyNotify) gst_object_unref);
+  }
+}
+
+/**
+ * gst_bus_set_coalescing:
+ * @bus: a #GstBus
+ * @types: the message types to coalesce, 0 to disable coalescing
+ * @interval: the minimum time between deliveries of coalesced messages
+ *
+ * Make the bus coalesce messages of @types that are passed to the
+ * asynchronous queue. For each combination of message source, type and
+ * structure name only the most recent message is kept, and the kept
+ * messages are added to the queue together at most once every @interval.
+ *
+ * This is useful for high-frequency informational messages like the
+ * element messages of the level or spectrum elements, QoS or buffering
+ * messages, which otherwise flood the application main loop. The
+ * synchronous handlers still see every message, and coalesced messages can
+ * be delivered after other messages that were posted later.
+ *
+ * Since: 1.10
+ */
+void
+gst_bus_set_coalescing (GstBus * bus, GstMessageType types,
+    GstClockTime interval)
+{
+  g_return_if_fail (GST_IS_BUS (bus));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (interval));
+
+  GST_OBJECT_LOCK (bus);
+  if (bus->priv->coalesce_types != 0 && bus->priv->poll)
+    gst_bus_coalesce_flush_unlocked (bus, GST_CLOCK_TIME_NONE);
+  if (bus->priv->coalesce_id) {
+    gst_clock_id_unschedule (bus->priv->coalesce_id);
+    gst_clock_id_unref (bus->priv->coalesce_id);
+    bus->priv->coalesce_id = NULL;
+  }
+
+  if (types != 0) {
+    if (bus->priv->coalesce_pending == NULL)
+      bus->priv->coalesce_pending = g_hash_table_new_full (coalesce_key_hash,
+          coalesce_key_equal, coalesce_key_free, NULL);
+    if (bus->priv->coalesce_clock == NULL)
+      bus->priv->coalesce_clock = gst_system_clock_obtain ();
+  }
+  bus->priv->coalesce_types = types;
+  bus->priv->coalesce_interval = interval;
+  GST_OBJECT_UNLOCK (bus);
+}
+
 /**
  * gst_bus_post:
  * @bus: a #GstBus to post on
@@ -344,6 +543,17 @@ gst_bus_post (GstBus * bus, GstMessage * message)
       GST_DEBUG_OBJECT (bus, "[msg %p] dropped", message);
       break;
     case GST_BUS_PASS:
+      if (G_UNLIKELY (bus->priv->coalesce_types != 0)) {
+        GST_OBJECT_LOCK (bus);
+        if ((GST_MESSAGE_TYPE (message) & bus->priv->coalesce_types) != 0
+            && !GST_MESSAGE_TYPE_IS_EXTENDED (message)
+            && !GST_OBJECT_FLAG_IS_SET (bus, GST_BUS_FLUSHING)) {
+          gst_bus_coalesce_unlocked (bus, message);
+          GST_OBJECT_UNLOCK (bus);
+          break;
+        }
+        GST_OBJECT_UNLOCK (bus);
+      }
       /* pass the message to the async queue, refcount passed in the queue */
       GST_DEBUG_OBJECT (bus, "[msg %p] pushing on async queue", message);
       gst_atomic_queue_push (bus->priv->queue, message);
@@ -457,6 +667,7 @@ gst_bus_set_flushing (GstBus * bus, gboolean flushing)
 
     GST_DEBUG_OBJECT (bus, "set bus flushing");
 
+    gst_bus_coalesce_clear_unlocked (bus);
     while ((message = gst_bus_pop (bus)))
       message_list = g_list_prepend (message_list, message);
   } else {
@@ -81,9 +81,11 @@ typedef struct _GstCapsImpl
   GstCaps caps;
 
   GArray *array;
+  gboolean interned;
 } GstCapsImpl;
 
 #define GST_CAPS_ARRAY(c) (((GstCapsImpl *)(c))->array)
+#define GST_CAPS_INTERNED(c) (((GstCapsImpl *)(c))->interned)
 
 #define GST_CAPS_LEN(c)   (GST_CAPS_ARRAY(c)->len)
 
@@ -122,6 +124,14 @@ typedef struct _GstCapsImpl
 /* lock to protect multiple invocations of static caps to caps conversion */
 G_LOCK_DEFINE_STATIC (static_caps_lock);
 
+/* table of interned fixed caps, hash -> GList of GstCaps. The table owns a
+ * ref to each caps, which keeps them from ever being writable. Caps only
+ * referenced by the table are dropped when it grows too big. */
+#define INTERNED_CAPS_PRUNE_SIZE 1024
+G_LOCK_DEFINE_STATIC (interned_caps_lock);
+static GHashTable *interned_caps = NULL;
+static guint n_interned_caps = 0;
+
 static void gst_caps_transform_to_string (const GValue * src_value,
     GValue * dest_value);
 static gboolean gst_caps_from_string_inplace (GstCaps * caps,
@@ -145,9 +155,19 @@ _priv_gst_caps_initialize (void)
       G_TYPE_STRING, gst_caps_transform_to_string);
 }
 
+static void gst_caps_intern_prune_unlocked (gboolean all);
+
 void
 _priv_gst_caps_cleanup (void)
 {
+  G_LOCK (interned_caps_lock);
+  if (interned_caps) {
+    gst_caps_intern_prune_unlocked (TRUE);
+    g_hash_table_unref (interned_caps);
+    interned_caps = NULL;
+  }
+  G_UNLOCK (interned_caps_lock);
+
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
@@ -232,6 +252,7 @@ gst_caps_init (GstCaps * caps)
    */
   GST_CAPS_ARRAY (caps) =
       g_array_new (FALSE, TRUE, sizeof (GstCapsArrayElement));
+  GST_CAPS_INTERNED (caps) = FALSE;
 }
 
 /**
@@ -1163,6 +1184,13 @@ gst_caps_is_equal_fixed (const GstCaps * caps1, const GstCaps * caps2)
   g_return_val_if_fail (gst_caps_is_fixed (caps1), FALSE);
   g_return_val_if_fail (gst_caps_is_fixed (caps2), FALSE);
 
+  if (G_UNLIKELY (caps1 == caps2))
+    return TRUE;
+
+  /* there is only one interned instance of each fixed caps */
+  if (GST_CAPS_INTERNED (caps1) && GST_CAPS_INTERNED (caps2))
+    return FALSE;
+
   struct1 = gst_caps_get_structure_unchecked (caps1, 0);
   features1 = gst_caps_get_features_unchecked (caps1, 0);
   if (!features1)
@@ -1216,6 +1244,9 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   g_return_val_if_fail (subset != NULL, FALSE);
   g_return_val_if_fail (superset != NULL, FALSE);
 
+  if (G_UNLIKELY (subset == superset))
+    return TRUE;
+
   if (CAPS_IS_EMPTY (subset) || CAPS_IS_ANY (superset))
     return TRUE;
   if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
@@ -1352,6 +1383,9 @@ gst_caps_is_equal (const GstCaps * caps1, const GstCaps * caps2)
   if (G_UNLIKELY (caps1 == caps2))
     return TRUE;
 
+  if (GST_CAPS_INTERNED (caps1) && GST_CAPS_INTERNED (caps2))
+    return FALSE;
+
   if (G_UNLIKELY (gst_caps_is_fixed (caps1) && gst_caps_is_fixed (caps2)))
     return gst_caps_is_equal_fixed (caps1, caps2);
 
@@ -1380,6 +1414,9 @@ gst_caps_is_strictly_equal (const GstCaps * caps1, const GstCaps * caps2)
   if (G_UNLIKELY (caps1 == caps2))
     return TRUE;
 
+  if (GST_CAPS_INTERNED (caps1) && GST_CAPS_INTERNED (caps2))
+    return FALSE;
+
   if (GST_CAPS_LEN (caps1) != GST_CAPS_LEN (caps2))
     return FALSE;
 
@@ -2162,6 +2199,171 @@ gst_caps_fixate (GstCaps * caps)
   return caps;
 }
 
+static gboolean
+gst_caps_intern_hash_field (GQuark field_id, const GValue * value,
+    gpointer user_data)
+{
+  guint *hash = user_data;
+  guint h;
+
+  h = field_id * 31 + (guint) G_VALUE_TYPE (value);
+
+  /* only hash values for which equality means identical content, all other
+   * values are left to the full comparison */
+  switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (value))) {
+    case G_TYPE_BOOLEAN:
+      h = h * 31 + g_value_get_boolean (value);
+      break;
+    case G_TYPE_INT:
+      h = h * 31 + g_value_get_int (value);
+      break;
+    case G_TYPE_UINT:
+      h = h * 31 + g_value_get_uint (value);
+      break;
+    case G_TYPE_INT64:
+      h = h * 31 + (guint) g_value_get_int64 (value);
+      break;
+    case G_TYPE_UINT64:
+      h = h * 31 + (guint) g_value_get_uint64 (value);
+      break;
+    case G_TYPE_ENUM:
+      h = h * 31 + g_value_get_enum (value);
+      break;
+    case G_TYPE_STRING:
+      if (g_value_get_string (value))
+        h = h * 31 + g_str_hash (g_value_get_string (value));
+      break;
+    default:
+      break;
+  }
+
+  /* fields are unordered, so combine them with a commutative operation */
+  *hash += h;
+
+  return TRUE;
+}
+
+static guint
+gst_caps_intern_hash (const GstCaps * caps)
+{
+  GstStructure *s;
+  GstCapsFeatures *f;
+  guint i, n, hash;
+
+  s = gst_caps_get_structure_unchecked (caps, 0);
+  f = gst_caps_get_features_unchecked (caps, 0);
+  if (!f)
+    f = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
+
+  hash = gst_structure_get_name_id (s);
+  n = gst_caps_features_get_size (f);
+  for (i = 0; i < n; i++)
+    hash += g_str_hash (gst_caps_features_get_nth (f, i));
+  gst_structure_foreach (s, gst_caps_intern_hash_field, &hash);
+
+  return hash;
+}
+
+/* Removes the caps that are only referenced by the table, or all of them if
+ * @all is %TRUE. Must be called with the interned caps lock */
+static void
+gst_caps_intern_prune_unlocked (gboolean all)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init (&iter, interned_caps);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GList *bucket = value, *l, *next;
+
+    for (l = bucket; l; l = next) {
+      GstCaps *caps = l->data;
+
+      next = l->next;
+      if (!all && GST_CAPS_REFCOUNT_VALUE (caps) > 1)
+        continue;
+
+      GST_CAPS_INTERNED (caps) = FALSE;
+      gst_caps_unref (caps);
+      bucket = g_list_delete_link (bucket, l);
+      n_interned_caps--;
+    }
+
+    if (bucket)
+      g_hash_table_iter_replace (&iter, bucket);
+    else
+      g_hash_table_iter_remove (&iter);
+  }
+}
+
+/**
+ * gst_caps_intern:
+ * @caps: (transfer full): a #GstCaps
+ *
+ * Returns the canonical instance of the fixed @caps, which is shared by
+ * every caller interning equal caps. This makes gst_caps_is_equal() and
+ * friends on interned caps a pointer comparison, and makes the fast paths
+ * for identical caps hit in gst_caps_is_subset(), gst_caps_intersect() and
+ * gst_caps_can_intersect().
+ *
+ * Interned caps are never writable, use gst_caps_make_writable() to get a
+ * modifiable copy. Caps that are not fixed are returned unchanged.
+ *
+ * This function takes ownership of @caps.
+ *
+ * Returns: (transfer full): the interned caps
+ *
+ * Since: 1.10
+ */
+GstCaps *
+gst_caps_intern (GstCaps * caps)
+{
+  GstCaps *interned = NULL;
+  GList *bucket, *l;
+  guint hash;
+
+  g_return_val_if_fail (GST_IS_CAPS (caps), NULL);
+
+  if (GST_CAPS_INTERNED (caps) || !gst_caps_is_fixed (caps))
+    return caps;
+
+  hash = gst_caps_intern_hash (caps);
+
+  G_LOCK (interned_caps_lock);
+  if (!interned_caps)
+    interned_caps = g_hash_table_new (NULL, NULL);
+
+  bucket = g_hash_table_lookup (interned_caps, GUINT_TO_POINTER (hash));
+  for (l = bucket; l; l = l->next) {
+    if (gst_caps_is_equal_fixed (l->data, caps)) {
+      interned = gst_caps_ref (l->data);
+      break;
+    }
+  }
+
+  if (!interned) {
+    if (n_interned_caps >= INTERNED_CAPS_PRUNE_SIZE) {
+      gst_caps_intern_prune_unlocked (FALSE);
+      bucket = g_hash_table_lookup (interned_caps, GUINT_TO_POINTER (hash));
+    }
+
+    GST_CAPS_INTERNED (caps) = TRUE;
+    bucket = g_list_prepend (bucket, gst_caps_ref (caps));
+    g_hash_table_insert (interned_caps, GUINT_TO_POINTER (hash), bucket);
+    n_interned_caps++;
+    G_UNLOCK (interned_caps_lock);
+
+    GST_CAT_TRACE (GST_CAT_CAPS, "interned caps %" GST_PTR_FORMAT, caps);
+
+    return caps;
+  }
+  G_UNLOCK (interned_caps_lock);
+
+  gst_caps_unref (caps);
+
+  return interned;
+}
+
 /* utility */
 
 /**
@@ -497,6 +497,8 @@ GstCaps *         gst_caps_simplify                (GstCaps *caps) G_GNUC_WARN_U
 
 GstCaps *         gst_caps_fixate                  (GstCaps *caps) G_GNUC_WARN_UNUSED_RESULT;
 
+GstCaps *         gst_caps_intern                  (GstCaps *caps) G_GNUC_WARN_UNUSED_RESULT;
+
 /* utility */
 gchar *           gst_caps_to_string               (const GstCaps *caps) G_GNUC_MALLOC;
 GstCaps *         gst_caps_from_string             (const gchar   *string) G_GNUC_WARN_UNUSED_RESULT;
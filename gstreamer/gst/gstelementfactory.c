@@ -153,6 +153,7 @@ gst_element_factory_cleanup (GstElementFactory * factory)
     gst_structure_free ((GstStructure *) factory->metadata);
     factory->metadata = NULL;
   }
+  factory->metadata_str = NULL;
   if (factory->type) {
     factory->type = G_TYPE_INVALID;
   }
@@ -496,6 +497,30 @@ gst_element_factory_get_element_type (GstElementFactory * factory)
   return factory->type;
 }
 
+/* Factories loaded from the registry cache only deserialize their metadata
+ * when it is first needed */
+static GstStructure *
+gst_element_factory_ensure_metadata (GstElementFactory * factory)
+{
+  GstStructure *metadata;
+
+  metadata = g_atomic_pointer_get (&factory->metadata);
+  if (G_UNLIKELY (metadata == NULL && factory->metadata_str != NULL)) {
+    metadata = gst_structure_from_string (factory->metadata_str, NULL);
+    if (metadata == NULL) {
+      GST_WARNING_OBJECT (factory, "Error when trying to deserialize "
+          "structure for metadata '%s'", factory->metadata_str);
+      return NULL;
+    }
+    if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+            metadata)) {
+      gst_structure_free (metadata);
+      metadata = g_atomic_pointer_get (&factory->metadata);
+    }
+  }
+  return metadata;
+}
+
 /**
  * gst_element_factory_get_metadata:
  * @factory: a #GstElementFactory
@@ -510,7 +535,8 @@ const gchar *
 gst_element_factory_get_metadata (GstElementFactory * factory,
     const gchar * key)
 {
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  return gst_structure_get_string (gst_element_factory_ensure_metadata
+      (factory), key);
 }
 
 /**
@@ -532,7 +558,7 @@ gst_element_factory_get_metadata_keys (GstElementFactory * factory)
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_element_factory_ensure_metadata (factory);
   if (metadata == NULL)
     return NULL;
 
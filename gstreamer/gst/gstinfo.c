@@ -217,6 +217,7 @@ dladdr (void *address, Dl_info * dl)
 
 static void gst_debug_reset_threshold (gpointer category, gpointer unused);
 static void gst_debug_reset_all_thresholds (void);
+static gboolean gst_debug_ring_start (FILE * log_file);
 
 struct _GstDebugMessage
 {
@@ -316,7 +317,8 @@ _priv_gst_debug_init (void)
       log_file = stderr;
     }
 
-    gst_debug_add_log_function (gst_debug_log_default, log_file, NULL);
+    if (!gst_debug_ring_start (log_file))
+      gst_debug_add_log_function (gst_debug_log_default, log_file, NULL);
   }
 
   __gst_printf_pointer_extension_set_func
@@ -1123,6 +1125,332 @@ gst_debug_log_default (GstDebugCategory * category, GstDebugLevel level,
     g_free (obj);
 }
 
+/* Ring buffer logging, enabled by setting GST_DEBUG_RING_BUFFER to the size
+ * in kilobytes of the per-thread rings.
+ *
+ * Each thread that logs gets its own single-producer/single-consumer ring.
+ * The logging thread only appends a binary record (header with the level,
+ * category, timestamp, file, function and line, followed by the object and
+ * message strings) and publishes it by moving the head index. A background
+ * thread polls all rings, turns the records into the usual text format and
+ * writes them out, so streaming threads never contend on the output stream.
+ * When a ring is full the record is dropped and counted instead of blocking
+ * the logging thread. */
+typedef struct
+{
+  /* size of the record including this header, 0 marks a wrap to offset 0 */
+  guint32 size;
+  guint32 level;
+  gint line;
+  GstClockTime elapsed;
+  GstDebugCategory *category;
+  const gchar *file;
+  const gchar *function;
+  guint32 obj_len;
+  /* followed by the NUL terminated object and message strings */
+} GstDebugRingRecord;
+
+typedef struct
+{
+  guint8 *data;
+  guint size;
+  guint mask;
+  /* free running indices, head is only written by the owning thread and
+   * tail only by the flusher */
+  volatile gint head;
+  volatile gint tail;
+  volatile guint dropped;
+  gboolean dead;
+  gpointer thread;
+} GstDebugRing;
+
+#define RING_FLUSH_INTERVAL (20 * G_TIME_SPAN_MILLISECOND)
+
+static void gst_debug_ring_thread_exit (gpointer data);
+
+static GPrivate ring_key = G_PRIVATE_INIT (gst_debug_ring_thread_exit);
+static GMutex ring_lock;
+static GCond ring_cond;
+static GSList *ring_list = NULL;
+static GThread *ring_flusher = NULL;
+static volatile gint ring_running = FALSE;
+static guint ring_size = 0;
+static FILE *ring_file = NULL;
+
+static void
+gst_debug_ring_free (GstDebugRing * ring)
+{
+  g_free (ring->data);
+  g_slice_free (GstDebugRing, ring);
+}
+
+static void
+gst_debug_ring_thread_exit (gpointer data)
+{
+  GstDebugRing *ring = data;
+
+  g_mutex_lock (&ring_lock);
+  if (ring_flusher != NULL) {
+    /* let the flusher write out what is left and free the ring */
+    ring->dead = TRUE;
+    ring = NULL;
+  } else {
+    ring_list = g_slist_remove (ring_list, ring);
+  }
+  g_mutex_unlock (&ring_lock);
+
+  if (ring)
+    gst_debug_ring_free (ring);
+}
+
+static GstDebugRing *
+gst_debug_ring_get (void)
+{
+  GstDebugRing *ring;
+
+  ring = g_private_get (&ring_key);
+  if (G_UNLIKELY (ring == NULL)) {
+    ring = g_slice_new0 (GstDebugRing);
+    ring->data = g_malloc (ring_size);
+    ring->size = ring_size;
+    ring->mask = ring_size - 1;
+    ring->thread = g_thread_self ();
+
+    g_mutex_lock (&ring_lock);
+    ring_list = g_slist_prepend (ring_list, ring);
+    g_mutex_unlock (&ring_lock);
+
+    g_private_set (&ring_key, ring);
+  }
+  return ring;
+}
+
+/* called with ring_lock, returns TRUE when records were written */
+static gboolean
+gst_debug_ring_drain (GstDebugRing * ring, gint pid)
+{
+  guint head, tail;
+  guint dropped;
+  gboolean res = FALSE;
+
+  head = g_atomic_int_get (&ring->head);
+  tail = ring->tail;
+
+  while (tail != head) {
+    GstDebugRingRecord *rec;
+    guint offset = tail & ring->mask;
+    const gchar *obj, *msg;
+
+    rec = (GstDebugRingRecord *) (ring->data + offset);
+    if (rec->size == 0) {
+      tail += ring->size - offset;
+      continue;
+    }
+    obj = (const gchar *) (rec + 1);
+    msg = obj + rec->obj_len + 1;
+
+#define PRINT_FMT " "PID_FMT" "PTR_FMT" %s "CAT_FMT" %s\n"
+    fprintf (ring_file, "%" GST_TIME_FORMAT PRINT_FMT,
+        GST_TIME_ARGS (rec->elapsed), pid, ring->thread,
+        gst_debug_level_get_name (rec->level),
+        gst_debug_category_get_name (rec->category), rec->file, rec->line,
+        rec->function, obj, msg);
+#undef PRINT_FMT
+    tail += rec->size;
+    res = TRUE;
+  }
+  /* give the space back to the producer */
+  g_atomic_int_set (&ring->tail, tail);
+
+  dropped = g_atomic_int_and (&ring->dropped, 0);
+  if (dropped > 0) {
+    fprintf (ring_file, "%" GST_TIME_FORMAT " " PID_FMT " " PTR_FMT
+        " dropped %u debug messages, ring buffer full\n",
+        GST_TIME_ARGS (GST_CLOCK_DIFF (_priv_gst_start_time,
+                gst_util_get_timestamp ())), pid, ring->thread, dropped);
+    res = TRUE;
+  }
+  return res;
+}
+
+/* called with ring_lock */
+static void
+gst_debug_ring_drain_all (void)
+{
+  GSList *walk, *next;
+  gboolean written = FALSE;
+  gint pid = getpid ();
+
+  for (walk = ring_list; walk; walk = next) {
+    GstDebugRing *ring = walk->data;
+
+    next = walk->next;
+    written |= gst_debug_ring_drain (ring, pid);
+    if (ring->dead) {
+      ring_list = g_slist_delete_link (ring_list, walk);
+      gst_debug_ring_free (ring);
+    }
+  }
+  if (written)
+    fflush (ring_file);
+}
+
+static gpointer
+gst_debug_ring_flusher_func (gpointer data)
+{
+  g_mutex_lock (&ring_lock);
+  while (g_atomic_int_get (&ring_running)) {
+    gst_debug_ring_drain_all ();
+    g_cond_wait_until (&ring_cond, &ring_lock,
+        g_get_monotonic_time () + RING_FLUSH_INTERVAL);
+  }
+  g_mutex_unlock (&ring_lock);
+
+  return NULL;
+}
+
+static void
+gst_debug_log_ring (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line,
+    GObject * object, GstDebugMessage * message, gpointer user_data)
+{
+  GstDebugRing *ring;
+  GstDebugRingRecord *rec;
+  const gchar *msg;
+  gchar *obj = NULL;
+  gsize obj_len = 0, msg_len, len;
+  guint head, tail, offset, pad = 0;
+  gchar c;
+
+  if (G_UNLIKELY (!g_atomic_int_get (&ring_running))) {
+    gst_debug_log_default (category, level, file, function, line, object,
+        message, user_data);
+    return;
+  }
+
+  ring = gst_debug_ring_get ();
+
+  c = file[0];
+  if (c == '.' || c == '/' || c == '\\' || (c != '\0' && file[1] == ':')) {
+    file = gst_path_basename (file);
+  }
+
+  if (object) {
+    obj = gst_debug_print_object (object);
+    obj_len = strlen (obj);
+  }
+
+  msg = gst_debug_message_get (message);
+  msg_len = strlen (msg);
+
+  /* don't let a single huge message take more than a quarter of the ring */
+  len = sizeof (GstDebugRingRecord) + obj_len + 1;
+  if (len + msg_len + 1 > ring->size / 4) {
+    if (len >= ring->size / 4)
+      goto dropped;
+    msg_len = ring->size / 4 - len - 1;
+  }
+  len = GST_ROUND_UP_8 (len + msg_len + 1);
+
+  head = ring->head;
+  tail = g_atomic_int_get (&ring->tail);
+  offset = head & ring->mask;
+
+  /* records are never split, skip the end of the ring if it's too small */
+  if (offset + len > ring->size)
+    pad = ring->size - offset;
+
+  if (pad + len > ring->size - (head - tail))
+    goto dropped;
+
+  if (pad) {
+    ((GstDebugRingRecord *) (ring->data + offset))->size = 0;
+    offset = 0;
+  }
+
+  rec = (GstDebugRingRecord *) (ring->data + offset);
+  rec->size = len;
+  rec->level = level;
+  rec->line = line;
+  rec->elapsed =
+      GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  rec->category = category;
+  rec->file = file;
+  rec->function = function;
+  rec->obj_len = obj_len;
+  if (obj_len)
+    memcpy (rec + 1, obj, obj_len);
+  ((gchar *) (rec + 1))[obj_len] = '\0';
+  memcpy ((gchar *) (rec + 1) + obj_len + 1, msg, msg_len);
+  ((gchar *) (rec + 1))[obj_len + 1 + msg_len] = '\0';
+
+  /* publish the record, this is a full barrier */
+  g_atomic_int_set (&ring->head, head + pad + len);
+
+  /* make sure errors reach the output quickly */
+  if (level == GST_LEVEL_ERROR)
+    g_cond_signal (&ring_cond);
+
+done:
+  g_free (obj);
+  return;
+
+dropped:
+  g_atomic_int_inc (&ring->dropped);
+  goto done;
+}
+
+static gboolean
+gst_debug_ring_start (FILE * log_file)
+{
+  const gchar *env;
+  guint64 kbytes;
+
+  env = g_getenv ("GST_DEBUG_RING_BUFFER");
+  if (env == NULL || *env == '\0')
+    return FALSE;
+
+  kbytes = g_ascii_strtoull (env, NULL, 10);
+  if (kbytes == 0)
+    return FALSE;
+
+  /* power of two between 4kB and 1GB so indices can wrap freely */
+  kbytes = CLAMP (kbytes, 4, 1024 * 1024);
+  ring_size = 1U << g_bit_storage ((guint) (kbytes * 1024 - 1));
+  ring_file = log_file;
+
+  g_atomic_int_set (&ring_running, TRUE);
+  ring_flusher = g_thread_new ("gst-debug-ring", gst_debug_ring_flusher_func,
+      NULL);
+
+  gst_debug_add_log_function (gst_debug_log_ring, log_file, NULL);
+
+  return TRUE;
+}
+
+void
+_priv_gst_debug_cleanup (void)
+{
+  GThread *flusher;
+
+  g_mutex_lock (&ring_lock);
+  flusher = ring_flusher;
+  g_atomic_int_set (&ring_running, FALSE);
+  g_cond_signal (&ring_cond);
+  g_mutex_unlock (&ring_lock);
+
+  if (flusher == NULL)
+    return;
+
+  /* messages logged from now on go straight to the log file */
+  g_thread_join (flusher);
+
+  g_mutex_lock (&ring_lock);
+  ring_flusher = NULL;
+  gst_debug_ring_drain_all ();
+  g_mutex_unlock (&ring_lock);
+}
+
 /**
  * gst_debug_level_get_name:
  * @level: the level to get the name for
@@ -139,7 +139,12 @@ struct _GstPadPrivate
   guint events_cookie;
   GArray *events;
   guint last_cookie;
+  /* all sticky events before this index were received, pushing the pending
+   * ones can start here instead of walking over the complete array */
+  guint events_pending;
 
+  /* number of threads pushing or pulling through the pad, updated atomically
+   * because gst_pad_push_data() decrements it without the object lock */
   gint using;
   guint probe_list_cookie;
   guint probe_cookie;
@@ -416,6 +421,7 @@ gst_pad_init (GstPad * pad)
   pad->priv->events = g_array_sized_new (FALSE, TRUE, sizeof (PadEvent), 16);
   pad->priv->events_cookie = 0;
   pad->priv->last_cookie = -1;
+  pad->priv->events_pending = 0;
   pad->ABI.abi.last_flowret = GST_FLOW_FLUSHING;
 }
 
@@ -446,6 +452,7 @@ remove_events (GstPad * pad)
   GST_OBJECT_FLAG_UNSET (pad, GST_PAD_FLAG_PENDING_EVENTS);
   g_array_set_size (events, 0);
   pad->priv->events_cookie++;
+  pad->priv->events_pending = 0;
 
   if (notify) {
     GST_OBJECT_UNLOCK (pad);
@@ -457,6 +464,24 @@ remove_events (GstPad * pad)
   }
 }
 
+/* the event at @idx was inserted or is not received anymore. Should be called
+ * with object lock */
+static inline void
+mark_event_pending (GstPad * pad, guint idx)
+{
+  if (idx < pad->priv->events_pending)
+    pad->priv->events_pending = idx;
+}
+
+/* the event at @idx was removed. Should be called with object lock */
+static inline void
+remove_event_index (GstPad * pad, guint idx)
+{
+  g_array_remove_index (pad->priv->events, idx);
+  if (idx < pad->priv->events_pending)
+    pad->priv->events_pending--;
+}
+
 /* should be called with object lock */
 static PadEvent *
 find_event_by_type (GstPad * pad, GstEventType type, guint idx)
@@ -532,7 +557,7 @@ remove_event_by_type (GstPad * pad, GstEventType type)
       goto next;
 
     gst_event_unref (ev->event);
-    g_array_remove_index (events, i);
+    remove_event_index (pad, i);
     len--;
     pad->priv->events_cookie++;
     continue;
@@ -564,6 +589,7 @@ schedule_events (GstPad * srcpad, GstPad * sinkpad)
 
     if (sinkpad == NULL || !find_event (sinkpad, ev->event)) {
       ev->received = FALSE;
+      mark_event_pending (srcpad, i);
       pending = TRUE;
     }
   }
@@ -574,9 +600,11 @@ schedule_events (GstPad * srcpad, GstPad * sinkpad)
 typedef gboolean (*PadEventFunction) (GstPad * pad, PadEvent * ev,
     gpointer user_data);
 
-/* should be called with pad LOCK */
+/* should be called with pad LOCK. With @pending_only, the events that were
+ * received already are skipped without calling @func */
 static void
-events_foreach (GstPad * pad, PadEventFunction func, gpointer user_data)
+events_foreach_full (GstPad * pad, gboolean pending_only,
+    PadEventFunction func, gpointer user_data)
 {
   guint i, len;
   GArray *events;
@@ -587,14 +615,24 @@ events_foreach (GstPad * pad, PadEventFunction func, gpointer user_data)
 
 restart:
   cookie = pad->priv->events_cookie;
-  i = 0;
   len = events->len;
+  if (pending_only) {
+    /* skip the events at the start that don't need to be checked anymore */
+    while (pad->priv->events_pending < len &&
+        g_array_index (events, PadEvent, pad->priv->events_pending).received)
+      pad->priv->events_pending++;
+    i = pad->priv->events_pending;
+  } else {
+    i = 0;
+  }
   while (i < len) {
     PadEvent *ev, ev_ret;
 
     ev = &g_array_index (events, PadEvent, i);
     if (G_UNLIKELY (ev->event == NULL))
       goto next;
+    if (pending_only && ev->received)
+      goto next;
 
     /* take aditional ref, func might release the lock */
     ev_ret.event = gst_event_ref (ev->event);
@@ -612,13 +650,15 @@ restart:
 
     /* store the received state */
     ev->received = ev_ret.received;
+    if (!ev->received)
+      mark_event_pending (pad, i);
 
     /* if the event changed, we need to do something */
     if (G_UNLIKELY (ev->event != ev_ret.event)) {
       if (G_UNLIKELY (ev_ret.event == NULL)) {
         /* function unreffed and set the event to NULL, remove it */
         gst_event_unref (ev->event);
-        g_array_remove_index (events, i);
+        remove_event_index (pad, i);
         len--;
         cookie = ++pad->priv->events_cookie;
         continue;
@@ -637,6 +677,12 @@ restart:
   }
 }
 
+static inline void
+events_foreach (GstPad * pad, PadEventFunction func, gpointer user_data)
+{
+  events_foreach_full (pad, FALSE, func, user_data);
+}
+
 /* should be called with LOCK */
 static GstEvent *
 _apply_pad_offset (GstPad * pad, GstEvent * event, gboolean upstream)
@@ -1332,7 +1378,7 @@ cleanup_hook (GstPad * pad, GHook * hook)
     }
   }
   g_hook_destroy_link (&pad->probes, hook);
-  pad->num_probes--;
+  g_atomic_int_add (&pad->num_probes, -1);
 }
 
 /**
@@ -1396,7 +1442,9 @@ gst_pad_add_probe (GstPad * pad, GstPadProbeType mask,
 
   /* add the probe */
   g_hook_append (&pad->probes, hook);
-  pad->num_probes++;
+  /* atomic to pair with the unlocked check in gst_pad_push_data(), a pushing
+   * thread either sees our probe or we see it still using the pad */
+  g_atomic_int_inc (&pad->num_probes);
   /* incremenent cookie so that the new hook get's called */
   pad->priv->probe_list_cookie++;
 
@@ -1419,7 +1467,7 @@ gst_pad_add_probe (GstPad * pad, GstPadProbeType mask,
 
   /* call the callback if we need to be called for idle callbacks */
   if ((mask & GST_PAD_PROBE_TYPE_IDLE) && (callback != NULL)) {
-    if (pad->priv->using > 0) {
+    if (g_atomic_int_get (&pad->priv->using) > 0) {
       /* the pad is in use, we can't signal the idle callback yet. Since we set the
        * flag above, the last thread to leave the push will do the callback. New
        * threads going into the push will block. */
@@ -3850,8 +3898,8 @@ check_sticky (GstPad * pad, GstEvent * event)
   if (G_UNLIKELY (GST_PAD_HAS_PENDING_EVENTS (pad))) {
     GST_OBJECT_FLAG_UNSET (pad, GST_PAD_FLAG_PENDING_EVENTS);
 
-    GST_DEBUG_OBJECT (pad, "pushing all sticky events");
-    events_foreach (pad, push_sticky, &data);
+    GST_DEBUG_OBJECT (pad, "pushing all pending sticky events");
+    events_foreach_full (pad, TRUE, push_sticky, &data);
 
     /* If there's an EOS event we must push it downstream
      * even if sending a previous sticky event failed.
@@ -4441,7 +4489,7 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
 
   /* take ref to peer pad before releasing the lock */
   gst_object_ref (peer);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   ret = gst_pad_chain_data_unchecked (peer, type, data);
@@ -4449,15 +4497,20 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
 
   gst_object_unref (peer);
 
-  GST_OBJECT_LOCK (pad);
-  pad->ABI.abi.last_flowret = ret;
-  pad->priv->using--;
-  if (pad->priv->using == 0) {
-    /* pad is not active anymore, trigger idle callbacks */
-    PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
-        probe_stopped, ret);
+  /* In the steady state there are no probes and nobody else is using the
+   * pad, so there is nothing to do under the lock anymore. Only take it
+   * again when idle probes might need to be called. */
+  g_atomic_int_set ((gint *) & pad->ABI.abi.last_flowret, ret);
+  if (g_atomic_int_dec_and_test (&pad->priv->using) &&
+      G_UNLIKELY (g_atomic_int_get (&pad->num_probes) > 0)) {
+    GST_OBJECT_LOCK (pad);
+    if (pad->priv->using == 0) {
+      /* pad is not active anymore, trigger idle callbacks */
+      PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
+          probe_stopped, ret);
+    }
+    GST_OBJECT_UNLOCK (pad);
   }
-  GST_OBJECT_UNLOCK (pad);
 
   return ret;
 
@@ -4891,7 +4944,7 @@ gst_pad_pull_range (GstPad * pad, guint64 offset, guint size,
     goto not_linked;
 
   gst_object_ref (peer);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   ret = gst_pad_get_range_unchecked (peer, offset, size, &res_buf);
@@ -4899,7 +4952,7 @@ gst_pad_pull_range (GstPad * pad, guint64 offset, guint size,
   gst_object_unref (peer);
 
   GST_OBJECT_LOCK (pad);
-  pad->priv->using--;
+  g_atomic_int_add (&pad->priv->using, -1);
   pad->ABI.abi.last_flowret = ret;
   if (pad->priv->using == 0) {
     /* pad is not active anymore, trigger idle callbacks */
@@ -5051,8 +5104,10 @@ store_sticky_event (GstPad * pad, GstEvent * event)
         continue;
 
       /* overwrite */
-      if ((res = gst_event_replace (&ev->event, event)))
+      if ((res = gst_event_replace (&ev->event, event))) {
         ev->received = FALSE;
+        mark_event_pending (pad, i);
+      }
 
       insert = FALSE;
       break;
@@ -5077,6 +5132,7 @@ store_sticky_event (GstPad * pad, GstEvent * event)
     ev.event = gst_event_ref (event);
     ev.received = FALSE;
     g_array_insert_val (events, i, ev);
+    mark_event_pending (pad, i);
     res = TRUE;
   }
 
@@ -5234,7 +5290,7 @@ gst_pad_push_event_unchecked (GstPad * pad, GstEvent * event,
 
     /* Push all sticky events before our current one
      * that have changed */
-    events_foreach (pad, sticky_changed, &data);
+    events_foreach_full (pad, TRUE, sticky_changed, &data);
   }
 
   /* now check the peer pad */
@@ -5243,7 +5299,7 @@ gst_pad_push_event_unchecked (GstPad * pad, GstEvent * event,
     goto not_linked;
 
   gst_object_ref (peerpad);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   GST_LOG_OBJECT (pad, "sending event %p (%s) to peerpad %" GST_PTR_FORMAT,
@@ -5260,7 +5316,7 @@ gst_pad_push_event_unchecked (GstPad * pad, GstEvent * event,
   gst_object_unref (peerpad);
 
   GST_OBJECT_LOCK (pad);
-  pad->priv->using--;
+  g_atomic_int_add (&pad->priv->using, -1);
   if (pad->priv->using == 0) {
     /* pad is not active anymore, trigger idle callbacks */
     PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
@@ -5951,6 +6007,26 @@ pad_leave_thread (GstTask * task, GThread * thread, gpointer user_data)
       thread, task);
 }
 
+/* use the pool from the task pool context of the element, if any */
+static void
+pad_task_configure_pool (GstPad * pad, GstElement * parent, GstTask * task)
+{
+  GstContext *context;
+  GstTaskPool *pool = NULL;
+
+  context = gst_element_get_context (parent, GST_TASK_POOL_CONTEXT_TYPE);
+  if (context == NULL)
+    return;
+
+  if (gst_structure_get (gst_context_get_structure (context), "task-pool",
+          GST_TYPE_TASK_POOL, &pool, NULL) && pool != NULL) {
+    GST_INFO_OBJECT (pad, "using task pool %" GST_PTR_FORMAT, pool);
+    gst_task_set_pool (task, pool);
+    gst_object_unref (pool);
+  }
+  gst_context_unref (context);
+}
+
 /**
  * gst_pad_start_task:
  * @pad: the #GstPad to start the task of
@@ -5970,6 +6046,7 @@ gst_pad_start_task (GstPad * pad, GstTaskFunction func, gpointer user_data,
     GDestroyNotify notify)
 {
   GstTask *task;
+  GstObject *parent;
   gboolean res;
 
   g_return_val_if_fail (GST_IS_PAD (pad), FALSE);
@@ -5987,9 +6064,19 @@ gst_pad_start_task (GstPad * pad, GstTaskFunction func, gpointer user_data,
     GST_INFO_OBJECT (pad, "created task %p", task);
     GST_PAD_TASK (pad) = task;
     gst_object_ref (task);
+    parent = GST_OBJECT_PARENT (pad);
+    if (parent != NULL && GST_IS_ELEMENT (parent))
+      gst_object_ref (parent);
+    else
+      parent = NULL;
     /* release lock to post the message */
     GST_OBJECT_UNLOCK (pad);
 
+    if (parent) {
+      pad_task_configure_pool (pad, GST_ELEMENT_CAST (parent), task);
+      gst_object_unref (parent);
+    }
+
     do_stream_status (pad, GST_STREAM_STATUS_TYPE_CREATE, NULL, task);
 
     gst_object_unref (task);
@@ -68,6 +68,10 @@ G_DEFINE_BOXED_TYPE (GstParseContext, gst_parse_context,
     (GBoxedCopyFunc) gst_parse_context_copy,
     (GBoxedFreeFunc) gst_parse_context_free);
 
+G_DEFINE_BOXED_TYPE (GstParseTemplate, gst_parse_template,
+    (GBoxedCopyFunc) gst_parse_template_ref,
+    (GBoxedFreeFunc) gst_parse_template_unref);
+
 /**
  * gst_parse_error_quark:
  *
@@ -351,3 +355,143 @@ gst_parse_launch_full (const gchar * pipeline_description,
   return NULL;
 #endif
 }
+
+/**
+ * gst_parse_compile:
+ * @pipeline_description: the command line describing the pipeline
+ * @context: (allow-none): a parse context allocated with
+ *      gst_parse_context_new(), or %NULL
+ * @flags: parsing options, or #GST_PARSE_FLAG_NONE
+ * @error: the error message in case of an erroneous pipeline.
+ *
+ * Parses @pipeline_description once and compiles it into a template from
+ * which any number of identical pipelines can be created with
+ * gst_parse_template_instantiate(). The element factories, the deserialized
+ * property values and the links are resolved here, so creating an instance
+ * does not need to go through the parser again.
+ *
+ * Unlike gst_parse_launch_full(), any parsing error is fatal and no
+ * template is returned in that case.
+ *
+ * Returns: (transfer full) (nullable): a new #GstParseTemplate, or %NULL on
+ *     failure. Free with gst_parse_template_unref().
+ *
+ * Since: 1.10
+ */
+GstParseTemplate *
+gst_parse_compile (const gchar * pipeline_description,
+    GstParseContext * context, GstParseFlags flags, GError ** error)
+{
+#ifndef GST_DISABLE_PARSE
+  g_return_val_if_fail (pipeline_description != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  GST_CAT_INFO (GST_CAT_PIPELINE, "compiling pipeline description '%s'",
+      pipeline_description);
+
+  return priv_gst_parse_compile (pipeline_description, error, context, flags);
+#else
+  gchar *msg;
+
+  GST_WARNING ("Disabled API called");
+
+  msg = gst_error_get_message (GST_CORE_ERROR, GST_CORE_ERROR_DISABLED);
+  g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_DISABLED, "%s", msg);
+  g_free (msg);
+
+  return NULL;
+#endif
+}
+
+/**
+ * gst_parse_template_instantiate:
+ * @tmpl: a #GstParseTemplate
+ * @error: the error message in case the pipeline could not be created.
+ *
+ * Creates a new pipeline from @tmpl, as if the description it was compiled
+ * from was passed to gst_parse_launch_full() with the same flags. This
+ * function can be called from multiple threads at the same time.
+ *
+ * Returns: (transfer floating) (nullable): a new element on success, %NULL
+ *     on failure.
+ *
+ * Since: 1.10
+ */
+GstElement *
+gst_parse_template_instantiate (GstParseTemplate * tmpl, GError ** error)
+{
+#ifndef GST_DISABLE_PARSE
+  GstElement *element;
+  GError *myerror = NULL;
+
+  g_return_val_if_fail (tmpl != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  element = priv_gst_parse_template_instantiate (tmpl, &myerror);
+
+  /* don't return partially constructed pipeline if FATAL_ERRORS was given */
+  if (G_UNLIKELY (myerror != NULL && element != NULL)) {
+    if ((tmpl->flags & GST_PARSE_FLAG_FATAL_ERRORS)) {
+      gst_object_unref (element);
+      element = NULL;
+    }
+  }
+
+  if (myerror)
+    g_propagate_error (error, myerror);
+
+  return element;
+#else
+  gchar *msg;
+
+  GST_WARNING ("Disabled API called");
+
+  msg = gst_error_get_message (GST_CORE_ERROR, GST_CORE_ERROR_DISABLED);
+  g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_DISABLED, "%s", msg);
+  g_free (msg);
+
+  return NULL;
+#endif
+}
+
+/**
+ * gst_parse_template_ref:
+ * @tmpl: a #GstParseTemplate
+ *
+ * Increases the refcount of @tmpl.
+ *
+ * Returns: (transfer full): @tmpl
+ *
+ * Since: 1.10
+ */
+GstParseTemplate *
+gst_parse_template_ref (GstParseTemplate * tmpl)
+{
+  g_return_val_if_fail (tmpl != NULL, NULL);
+
+#ifndef GST_DISABLE_PARSE
+  g_atomic_int_inc (&tmpl->refcount);
+#endif
+
+  return tmpl;
+}
+
+/**
+ * gst_parse_template_unref:
+ * @tmpl: (transfer full): a #GstParseTemplate
+ *
+ * Decreases the refcount of @tmpl and frees it when the last reference is
+ * dropped.
+ *
+ * Since: 1.10
+ */
+void
+gst_parse_template_unref (GstParseTemplate * tmpl)
+{
+  g_return_if_fail (tmpl != NULL);
+
+#ifndef GST_DISABLE_PARSE
+  if (g_atomic_int_dec_and_test (&tmpl->refcount))
+    priv_gst_parse_template_free (tmpl);
+#endif
+}
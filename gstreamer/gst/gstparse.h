@@ -93,6 +93,18 @@ typedef enum
  */
 typedef struct _GstParseContext GstParseContext;
 
+#define GST_TYPE_PARSE_TEMPLATE (gst_parse_template_get_type())
+
+/**
+ * GstParseTemplate:
+ *
+ * Opaque structure holding a compiled pipeline description, see
+ * gst_parse_compile().
+ *
+ * Since: 1.10
+ */
+typedef struct _GstParseTemplate GstParseTemplate;
+
 /* create, process and free a parse context */
 
 GType             gst_parse_context_get_type (void);
@@ -121,8 +133,25 @@ GstElement      * gst_parse_launchv_full (const gchar     ** argv,
                                           GstParseFlags      flags,
                                           GError          ** error) G_GNUC_MALLOC;
 
+/* compiled descriptions */
+
+GType              gst_parse_template_get_type    (void);
+
+GstParseTemplate * gst_parse_compile              (const gchar      * pipeline_description,
+                                                   GstParseContext  * context,
+                                                   GstParseFlags      flags,
+                                                   GError          ** error) G_GNUC_MALLOC;
+
+GstElement       * gst_parse_template_instantiate (GstParseTemplate * tmpl,
+                                                   GError          ** error) G_GNUC_MALLOC;
+
+GstParseTemplate * gst_parse_template_ref         (GstParseTemplate * tmpl);
+
+void               gst_parse_template_unref       (GstParseTemplate * tmpl);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstParseContext, gst_parse_context_free)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstParseTemplate, gst_parse_template_unref)
 #endif
 
 G_END_DECLS
@@ -872,7 +872,7 @@ handle_rx_packet (GstPluginLoader * l,
       if (payload_len > 0) {
         GstPlugin *newplugin = NULL;
         if (!_priv_gst_registry_chunks_load_plugin (l->registry, &tmp,
-                tmp + payload_len, &newplugin)) {
+                tmp + payload_len, &newplugin, FALSE)) {
           /* Got garbage from the child, so fail and trigger replay of plugins */
           GST_ERROR_OBJECT (l->registry,
               "Problems loading plugin details with tag %u from scanner", tag);
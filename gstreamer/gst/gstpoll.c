@@ -50,6 +50,10 @@
  * descriptor, and gst_poll_fd_can_write() to see if it is possible to
  * write to it.
  *
+ * On Linux, sets that are not timers keep their file descriptors registered
+ * with epoll, so the cost of a wait depends on the number of ready file
+ * descriptors instead of the total number in the set.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -82,6 +86,9 @@
 #endif
 #include <sys/time.h>
 #include <sys/socket.h>
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #endif
 
 /* OS/X needs this because of bad headers */
@@ -117,6 +124,7 @@ typedef enum
   GST_POLL_MODE_PSELECT,
   GST_POLL_MODE_POLL,
   GST_POLL_MODE_PPOLL,
+  GST_POLL_MODE_EPOLL,
   GST_POLL_MODE_WINDOWS
 } GstPollMode;
 
@@ -136,6 +144,16 @@ struct _GstPoll
   gchar buf[1];
   GstPollFD control_read_fd;
   GstPollFD control_write_fd;
+#ifdef HAVE_SYS_EPOLL_H
+  /* persistent registrations of all fds */
+  gint epoll_fd;
+  volatile gint use_epoll;
+  /* revents of the last wait, indexed by fd number */
+  GArray *epoll_revents;
+  /* fds with revents set by the last wait */
+  GArray *epoll_ready;
+  GArray *epoll_events;
+#endif
 #else
   GArray *active_fds_ignored;
   GArray *events;
@@ -268,6 +286,119 @@ find_index (GArray * array, GstPollFD * fd)
   return fd->idx;
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+#define USE_EPOLL(s)        (g_atomic_int_get(&(s)->use_epoll))
+
+/* stop using epoll, the next wait will rebuild the pollfd array.
+ * Called with the lock or before the set is used */
+static void
+epoll_disable (GstPoll * set)
+{
+  if (!USE_EPOLL (set))
+    return;
+
+  GST_DEBUG ("%p: not using epoll", set);
+  g_atomic_int_set (&set->use_epoll, FALSE);
+  MARK_REBUILD (set);
+
+  /* a waiter in epoll_wait() needs to restart with poll */
+  if (set->controllable && GET_WAITING (set) > 0)
+    raise_wakeup (set);
+}
+
+/* update the registration of @pfd, called with the lock */
+static void
+epoll_update (GstPoll * set, struct pollfd *pfd, gint op)
+{
+  struct epoll_event ev = { 0, };
+
+  if (!USE_EPOLL (set))
+    return;
+
+  /* errors and hangups are always reported */
+  if (pfd->events & (POLLIN | POLLPRI))
+    ev.events |= EPOLLIN | EPOLLPRI;
+  if (pfd->events & POLLOUT)
+    ev.events |= EPOLLOUT;
+  ev.data.fd = pfd->fd;
+
+  if (epoll_ctl (set->epoll_fd, op, pfd->fd, &ev) < 0) {
+    if (op == EPOLL_CTL_DEL) {
+      /* the fd was probably closed already, which removes it */
+      GST_LOG ("%p: removing fd %d failed: %s", set, pfd->fd,
+          g_strerror (errno));
+    } else {
+      /* for example regular files that don't work with epoll */
+      GST_INFO ("%p: can't use epoll for fd %d: %s", set, pfd->fd,
+          g_strerror (errno));
+      epoll_disable (set);
+    }
+  }
+}
+
+/* store the results of epoll_wait(), called with the lock */
+static void
+epoll_collect (GstPoll * set, struct epoll_event *events, gint n_events)
+{
+  guint i;
+
+  /* clear the results of the previous wait */
+  for (i = 0; i < set->epoll_ready->len; i++) {
+    gint fd = g_array_index (set->epoll_ready, gint, i);
+
+    if (fd < set->epoll_revents->len)
+      g_array_index (set->epoll_revents, gushort, fd) = 0;
+  }
+  g_array_set_size (set->epoll_ready, 0);
+
+  for (i = 0; i < n_events; i++) {
+    gint fd = events[i].data.fd;
+    guint ev = events[i].events;
+    gushort revents = 0;
+
+    if (ev & EPOLLIN)
+      revents |= POLLIN;
+    if (ev & EPOLLPRI)
+      revents |= POLLPRI;
+    if (ev & EPOLLOUT)
+      revents |= POLLOUT;
+    if (ev & EPOLLERR)
+      revents |= POLLERR;
+    if (ev & EPOLLHUP)
+      revents |= POLLHUP;
+
+    if (fd >= set->epoll_revents->len)
+      g_array_set_size (set->epoll_revents, fd + 1);
+    g_array_index (set->epoll_revents, gushort, fd) = revents;
+    g_array_append_val (set->epoll_ready, fd);
+  }
+}
+#endif
+
+#ifndef G_OS_WIN32
+/* get the revents of @fd after the last wait or -1 when it was not polled,
+ * called with the lock */
+static gint
+get_revents (const GstPoll * set, GstPollFD * fd)
+{
+  gint idx;
+
+#ifdef HAVE_SYS_EPOLL_H
+  if (USE_EPOLL (set)) {
+    if (fd->fd < set->epoll_revents->len)
+      return g_array_index (set->epoll_revents, gushort, fd->fd);
+    return 0;
+  }
+#endif
+
+  idx = find_index (set->active_fds, fd);
+  if (idx < 0)
+    return -1;
+
+  return g_array_index (set->active_fds, struct pollfd, idx).revents;
+}
+#endif
+
 #if !defined(HAVE_PPOLL) && defined(HAVE_POLL)
 /* check if all file descriptors will fit in an fd_set */
 static gboolean
@@ -315,6 +446,11 @@ choose_mode (GstPoll * set, GstClockTime timeout)
 {
   GstPollMode mode;
 
+#ifdef HAVE_SYS_EPOLL_H
+  if (USE_EPOLL (set))
+    return GST_POLL_MODE_EPOLL;
+#endif
+
   if (set->mode == GST_POLL_MODE_AUTO) {
 #ifdef HAVE_PPOLL
     mode = GST_POLL_MODE_PPOLL;
@@ -562,6 +698,13 @@ gst_poll_new (gboolean controllable)
   nset->active_fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
   nset->control_read_fd.fd = -1;
   nset->control_write_fd.fd = -1;
+#ifdef HAVE_SYS_EPOLL_H
+  nset->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+  nset->use_epoll = nset->epoll_fd >= 0;
+  nset->epoll_revents = g_array_new (FALSE, TRUE, sizeof (gushort));
+  nset->epoll_ready = g_array_new (FALSE, FALSE, sizeof (gint));
+  nset->epoll_events = g_array_new (FALSE, FALSE, sizeof (struct epoll_event));
+#endif
   {
     gint control_sock[2];
 
@@ -632,6 +775,12 @@ gst_poll_new_timer (void)
   /* we are a timer */
   poll->timer = TRUE;
 
+#ifdef HAVE_SYS_EPOLL_H
+  /* timers can be waited on from multiple threads and only have the control
+   * socket, there is nothing to gain from epoll */
+  epoll_disable (poll);
+#endif
+
 done:
   return poll;
 }
@@ -654,6 +803,13 @@ gst_poll_free (GstPoll * set)
     close (set->control_write_fd.fd);
   if (set->control_read_fd.fd >= 0)
     close (set->control_read_fd.fd);
+#ifdef HAVE_SYS_EPOLL_H
+  if (set->epoll_fd >= 0)
+    close (set->epoll_fd);
+  g_array_free (set->epoll_revents, TRUE);
+  g_array_free (set->epoll_ready, TRUE);
+  g_array_free (set->epoll_events, TRUE);
+#endif
 #else
   CloseHandle (set->wakeup_event);
 
@@ -737,6 +893,9 @@ gst_poll_add_fd_unlocked (GstPoll * set, GstPollFD * fd)
     g_array_append_val (set->fds, nfd);
 
     fd->idx = set->fds->len - 1;
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update (set, &nfd, EPOLL_CTL_ADD);
+#endif
 #else
     WinsockFd wfd;
     HANDLE event;
@@ -816,6 +975,11 @@ gst_poll_remove_fd (GstPoll * set, GstPollFD * fd)
 #ifdef G_OS_WIN32
     gst_poll_free_winsock_event (set, idx);
     g_array_remove_index_fast (set->events, idx);
+#elif defined (HAVE_SYS_EPOLL_H)
+    epoll_update (set, &g_array_index (set->fds, struct pollfd, idx),
+        EPOLL_CTL_DEL);
+    if (fd->fd < set->epoll_revents->len)
+      g_array_index (set->epoll_revents, gushort, fd->fd) = 0;
 #endif
 
     /* remove the fd at index, we use _remove_index_fast, which copies the last
@@ -870,6 +1034,9 @@ gst_poll_fd_ctl_write (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events &= ~POLLOUT;
 
     GST_LOG ("%p: pfd->events now %d (POLLOUT:%d)", set, pfd->events, POLLOUT);
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update (set, pfd, EPOLL_CTL_MOD);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_WRITE | FD_CONNECT,
         active);
@@ -902,6 +1069,9 @@ gst_poll_fd_ctl_read_unlocked (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= (POLLIN | POLLPRI);
     else
       pfd->events &= ~(POLLIN | POLLPRI);
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update (set, pfd, EPOLL_CTL_MOD);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_READ | FD_ACCEPT, active);
 #endif
@@ -993,7 +1163,11 @@ gboolean
 gst_poll_fd_has_closed (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gint revents;
+#else
   gint idx;
+#endif
 
   g_return_val_if_fail (set != NULL, FALSE);
   g_return_val_if_fail (fd != NULL, FALSE);
@@ -1001,13 +1175,13 @@ gst_poll_fd_has_closed (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & POLLHUP) != 0;
+  revents = get_revents (set, fd);
+  if (revents >= 0) {
+    res = (revents & POLLHUP) != 0;
 #else
+  idx = find_index (set->active_fds, fd);
+  if (idx >= 0) {
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & FD_CLOSE) != 0;
@@ -1035,7 +1209,11 @@ gboolean
 gst_poll_fd_has_error (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gint revents;
+#else
   gint idx;
+#endif
 
   g_return_val_if_fail (set != NULL, FALSE);
   g_return_val_if_fail (fd != NULL, FALSE);
@@ -1043,13 +1221,13 @@ gst_poll_fd_has_error (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & (POLLERR | POLLNVAL)) != 0;
+  revents = get_revents (set, fd);
+  if (revents >= 0) {
+    res = (revents & (POLLERR | POLLNVAL)) != 0;
 #else
+  idx = find_index (set->active_fds, fd);
+  if (idx >= 0) {
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.iErrorCode[FD_CLOSE_BIT] != 0) ||
@@ -1072,15 +1250,19 @@ static gboolean
 gst_poll_fd_can_read_unlocked (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gint revents;
+#else
   gint idx;
+#endif
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & (POLLIN | POLLPRI)) != 0;
+  revents = get_revents (set, fd);
+  if (revents >= 0) {
+    res = (revents & (POLLIN | POLLPRI)) != 0;
 #else
+  idx = find_index (set->active_fds, fd);
+  if (idx >= 0) {
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & (FD_READ | FD_ACCEPT)) != 0;
@@ -1133,7 +1315,11 @@ gboolean
 gst_poll_fd_can_write (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gint revents;
+#else
   gint idx;
+#endif
 
   g_return_val_if_fail (set != NULL, FALSE);
   g_return_val_if_fail (fd != NULL, FALSE);
@@ -1141,13 +1327,13 @@ gst_poll_fd_can_write (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & POLLOUT) != 0;
+  revents = get_revents (set, fd);
+  if (revents >= 0) {
+    res = (revents & POLLOUT) != 0;
 #else
+  idx = find_index (set->active_fds, fd);
+  if (idx >= 0) {
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & FD_WRITE) != 0;
@@ -1215,7 +1401,8 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 
     mode = choose_mode (set, timeout);
 
-    if (TEST_REBUILD (set)) {
+    /* with epoll the registrations are updated right away */
+    if (TEST_REBUILD (set) && mode != GST_POLL_MODE_EPOLL) {
       g_mutex_lock (&set->lock);
 #ifndef G_OS_WIN32
       g_array_set_size (set->active_fds, set->fds->len);
@@ -1271,6 +1458,40 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 #else
         g_assert_not_reached ();
         errno = ENOSYS;
+#endif
+        break;
+      }
+      case GST_POLL_MODE_EPOLL:
+      {
+#ifdef HAVE_SYS_EPOLL_H
+        struct epoll_event *events;
+        guint n_events;
+        gint t;
+
+        if (timeout != GST_CLOCK_TIME_NONE) {
+          /* round up, epoll only has millisecond precision */
+          t = MIN ((timeout + GST_MSECOND - 1) / GST_MSECOND, G_MAXINT);
+        } else {
+          t = -1;
+        }
+
+        /* room for a reasonable share of the fds to be ready at once */
+        g_mutex_lock (&set->lock);
+        n_events = CLAMP (set->fds->len, 16, 1024);
+        g_mutex_unlock (&set->lock);
+        g_array_set_size (set->epoll_events, n_events);
+        events = (struct epoll_event *) set->epoll_events->data;
+
+        res = epoll_wait (set->epoll_fd, events, n_events, t);
+
+        if (res >= 0) {
+          g_mutex_lock (&set->lock);
+          epoll_collect (set, events, res);
+          g_mutex_unlock (&set->lock);
+        }
+#else
+        g_assert_not_reached ();
+        errno = ENOSYS;
 #endif
         break;
       }
@@ -1101,11 +1101,17 @@ typedef enum
   REGISTRY_SCAN_HELPER_RUNNING
 } GstRegistryScanHelperState;
 
+/* maximum number of scan-helpers loading plugins in parallel */
+#define REGISTRY_SCAN_MAX_HELPERS 16
+
 typedef struct
 {
   GstRegistry *registry;
   GstRegistryScanHelperState helper_state;
-  GstPluginLoader *helper;
+  GstPluginLoader *helpers[REGISTRY_SCAN_MAX_HELPERS];
+  guint n_helpers;
+  guint max_helpers;
+  guint next_helper;
   gboolean changed;
 } GstRegistryScanContext;
 
@@ -1113,6 +1119,7 @@ static void
 init_scan_context (GstRegistryScanContext * context, GstRegistry * registry)
 {
   gboolean do_fork;
+  const gchar *helpers_env;
 
   context->registry = registry;
 
@@ -1133,17 +1140,37 @@ init_scan_context (GstRegistryScanContext * context, GstRegistry * registry)
   else
     context->helper_state = REGISTRY_SCAN_HELPER_DISABLED;
 
-  context->helper = NULL;
+  /* one scan-helper per processor by default, each one loads the plugin
+   * files it gets handed while the others are busy with theirs */
+  context->max_helpers =
+      MIN (g_get_num_processors (), REGISTRY_SCAN_MAX_HELPERS);
+  if ((helpers_env = g_getenv ("GST_REGISTRY_SCANNERS"))) {
+    guint64 n_helpers = g_ascii_strtoull (helpers_env, NULL, 10);
+
+    context->max_helpers = CLAMP (n_helpers, 1, REGISTRY_SCAN_MAX_HELPERS);
+  }
+#ifndef GST_DISABLE_REGISTRY
+  if (!__registry_reuse_plugin_scanner)
+    context->max_helpers = 1;
+#endif
+
+  context->n_helpers = 0;
+  context->next_helper = 0;
   context->changed = FALSE;
 }
 
 static void
 clear_scan_context (GstRegistryScanContext * context)
 {
-  if (context->helper) {
-    context->changed |= _priv_gst_plugin_loader_funcs.destroy (context->helper);
-    context->helper = NULL;
+  guint i;
+
+  for (i = 0; i < context->n_helpers; i++) {
+    context->changed |=
+        _priv_gst_plugin_loader_funcs.destroy (context->helpers[i]);
+    context->helpers[i] = NULL;
   }
+  context->n_helpers = 0;
+  context->next_helper = 0;
 }
 
 static gboolean
@@ -1159,21 +1186,36 @@ gst_registry_scan_plugin_file (GstRegistryScanContext * context,
 #endif
 
 
-  /* Have a plugin to load - see if the scan-helper needs starting */
-  if (context->helper_state == REGISTRY_SCAN_HELPER_NOT_STARTED) {
-    GST_DEBUG ("Starting plugin scanner for file %s", filename);
-    context->helper = _priv_gst_plugin_loader_funcs.create (context->registry);
-    if (context->helper != NULL)
+  /* Have a plugin to load - see if another scan-helper needs starting */
+  if (context->helper_state != REGISTRY_SCAN_HELPER_DISABLED &&
+      context->n_helpers < context->max_helpers) {
+    GstPluginLoader *helper;
+
+    GST_DEBUG ("Starting plugin scanner %u for file %s", context->n_helpers,
+        filename);
+    helper = _priv_gst_plugin_loader_funcs.create (context->registry);
+    if (helper != NULL) {
+      context->helpers[context->n_helpers++] = helper;
       context->helper_state = REGISTRY_SCAN_HELPER_RUNNING;
-    else {
+    } else if (context->n_helpers == 0) {
       GST_WARNING ("Failed starting plugin scanner. Scanning in-process");
       context->helper_state = REGISTRY_SCAN_HELPER_DISABLED;
+    } else {
+      /* make do with the ones already running */
+      context->max_helpers = context->n_helpers;
     }
   }
 
   if (context->helper_state == REGISTRY_SCAN_HELPER_RUNNING) {
+    GstPluginLoader *helper;
+
+    /* The helpers only get sent the file here, the results are collected
+     * while sending them more files and when they are destroyed, so handing
+     * out the files in turn keeps all of them busy */
+    helper = context->helpers[context->next_helper++ % context->n_helpers];
+
     GST_DEBUG ("Using scan-helper to load plugin %s", filename);
-    if (!_priv_gst_plugin_loader_funcs.load (context->helper,
+    if (!_priv_gst_plugin_loader_funcs.load (helper,
             filename, file_size, file_mtime)) {
       g_warning ("External plugin loader failed. This most likely means that "
           "the plugin loader helper binary was not found or could not be run. "
@@ -518,6 +518,7 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
   gboolean res = FALSE;
   guint32 filter_env_hash = 0;
   gint check_magic_result;
+  gboolean lazy = FALSE;
 #ifndef GST_DISABLE_GST_DEBUG
   GTimer *timer = NULL;
   gdouble seconds;
@@ -555,6 +556,12 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
     /* This can't fail if g_mapped_file_new() succeeded */
     contents = g_mapped_file_get_contents (mapped);
     size = g_mapped_file_get_length (mapped);
+#ifndef G_OS_WIN32
+    /* let the features parse their details from the mapped file on first
+     * use. Windows can't replace a file that is still mapped, so the whole
+     * cache is parsed upfront there */
+    lazy = TRUE;
+#endif
   }
 
   /* in is a cursor pointer, we initialize it with the begin of registry and is updated on each read */
@@ -602,7 +609,8 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
       GST_DEBUG ("reading binary registry %" G_GSIZE_FORMAT "(%x)/%"
           G_GSIZE_FORMAT, (gsize) in - (gsize) contents,
           (guint) ((gsize) in - (gsize) contents), size);
-      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, NULL)) {
+      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, NULL,
+              lazy)) {
         GST_ERROR ("Problem while reading binary registry %s", location);
         goto Error;
       }
@@ -619,13 +627,18 @@ done:
   GST_INFO ("loaded %s in %lf seconds", location, seconds);
 
   res = TRUE;
-  /* TODO: once we re-use the pointers to registry contents, return here */
 
 Error:
 #ifndef GST_DISABLE_GST_DEBUG
   g_timer_destroy (timer);
 #endif
-  if (mapped) {
+  if (lazy) {
+    /* the features point into the mapped file, so keep it around as long as
+     * the registry. The cache is only read once and updates replace the file
+     * instead of rewriting it */
+    g_object_set_data_full (G_OBJECT (registry), "gst-registry-cache",
+        mapped, (GDestroyNotify) g_mapped_file_unref);
+  } else if (mapped) {
     g_mapped_file_unref (mapped);
   } else {
     g_free (contents);
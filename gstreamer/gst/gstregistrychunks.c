@@ -286,9 +286,13 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       }
     }
 
-    /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    /* pack element metadata strings, which might not be parsed yet */
+    if (factory->metadata)
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
+    else
+      gst_registry_chunks_save_const_string (list,
+          factory->metadata_str ? factory->metadata_str : "");
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
     GstTypeFindFactory *factory = GST_TYPE_FIND_FACTORY (feature);
@@ -321,6 +325,8 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       gst_caps_unref (fcaps);
 
       gst_registry_chunks_save_string (list, str);
+    } else if (factory->caps_str) {
+      gst_registry_chunks_save_const_string (list, factory->caps_str);
     } else {
       gst_registry_chunks_save_const_string (list, "");
     }
@@ -529,13 +535,15 @@ fail:
 /*
  * gst_registry_chunks_load_feature:
  *
- * Make a new GstPluginFeature from current binary plugin feature structure
+ * Make a new GstPluginFeature from current binary plugin feature structure.
+ * If @lazy is %TRUE the data stays valid for the lifetime of the process and
+ * the feature can refer to it to parse its details on first use.
  *
  * Returns: new GstPluginFeature
  */
 static gboolean
 gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin * plugin)
+    gchar * end, GstPlugin * plugin, gboolean lazy)
 {
   GstRegistryChunkPluginFeature *pf = NULL;
   GstPluginFeature *feature = NULL;
@@ -594,12 +602,16 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
     if (meta_data_str && *meta_data_str) {
-      factory->metadata = gst_structure_from_string (meta_data_str, NULL);
-      if (!factory->metadata) {
-        GST_ERROR
-            ("Error when trying to deserialize structure for metadata '%s'",
-            meta_data_str);
-        goto fail;
+      if (lazy) {
+        factory->metadata_str = meta_data_str;
+      } else {
+        factory->metadata = gst_structure_from_string (meta_data_str, NULL);
+        if (!factory->metadata) {
+          GST_ERROR
+              ("Error when trying to deserialize structure for metadata '%s'",
+              meta_data_str);
+          goto fail;
+        }
       }
     }
     n = ef->npadtemplates;
@@ -650,10 +662,14 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* load typefinder caps */
     unpack_string_nocopy (*in, const_str, end, fail);
-    if (const_str != NULL && *const_str != '\0')
-      factory->caps = gst_caps_from_string (const_str);
-    else
+    if (const_str != NULL && *const_str != '\0') {
+      if (lazy)
+        factory->caps_str = const_str;
+      else
+        factory->caps = gst_caps_from_string (const_str);
+    } else {
       factory->caps = NULL;
+    }
 
     /* load extensions */
     if (tff->nextensions) {
@@ -794,10 +810,12 @@ fail:
  * Make a new GstPlugin from current GstRegistryChunkPluginElement structure
  * and add it to the GstRegistry. Return an offset to the next
  * GstRegistryChunkPluginElement structure.
+ * Pass %TRUE for @lazy if the data is never freed, so that the features only
+ * parse their details when they are used.
  */
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin ** out_plugin)
+    gchar * end, GstPlugin ** out_plugin, gboolean lazy)
 {
 #ifndef GST_DISABLE_GST_DEBUG
   gchar *start = *in;
@@ -864,7 +882,7 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   /* Load plugin features */
   for (i = 0; i < n; i++) {
     if (G_UNLIKELY (!gst_registry_chunks_load_feature (registry, in, end,
-                plugin))) {
+                plugin, lazy))) {
       GST_ERROR ("Error while loading binary feature for plugin '%s'",
           GST_STR_NULL (plugin->desc.name));
       gst_registry_remove_plugin (registry, plugin);
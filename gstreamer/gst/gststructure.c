@@ -89,14 +89,30 @@ typedef struct
   /* owned by parent structure, NULL if no parent */
   gint *parent_refcount;
 
-  GArray *fields;
+  guint fields_len;
+  guint fields_alloc;
+  /* points to arr as long as the fields fit in there */
+  GstStructureField *fields;
+  /* quark to index + 1, only for structures with many fields */
+  GHashTable *fields_index;
+
+  /* inline storage, allocated along with the structure */
+  GstStructureField arr[1];
 } GstStructureImpl;
 
 #define GST_STRUCTURE_REFCOUNT(s) (((GstStructureImpl*)(s))->parent_refcount)
+#define GST_STRUCTURE_LEN(s) (((GstStructureImpl*)(s))->fields_len)
+#define GST_STRUCTURE_ALLOC(s) (((GstStructureImpl*)(s))->fields_alloc)
 #define GST_STRUCTURE_FIELDS(s) (((GstStructureImpl*)(s))->fields)
+#define GST_STRUCTURE_INDEX(s) (((GstStructureImpl*)(s))->fields_index)
+#define GST_STRUCTURE_INLINE(s) (&((GstStructureImpl*)(s))->arr[0])
 
 #define GST_STRUCTURE_FIELD(structure, index) \
-    &g_array_index(GST_STRUCTURE_FIELDS(structure), GstStructureField, (index))
+    (&GST_STRUCTURE_FIELDS(structure)[(index)])
+
+/* structures with at least this many fields get a hash index for lookups,
+ * below that a linear scan over the fields is faster */
+#define STRUCTURE_INDEX_THRESHOLD 16
 
 #define IS_MUTABLE(structure) \
     (!GST_STRUCTURE_REFCOUNT(structure) || \
@@ -141,19 +157,113 @@ static GstStructure *
 gst_structure_new_id_empty_with_size (GQuark quark, guint prealloc)
 {
   GstStructureImpl *structure;
+  guint n_alloc;
+
+  /* the fields of small structures are allocated along with the structure,
+   * bigger ones get their own allocation */
+  n_alloc = MIN (GST_ROUND_UP_4 (MAX (prealloc, 1)), STRUCTURE_INDEX_THRESHOLD);
 
-  structure = g_slice_new (GstStructureImpl);
+  structure = g_malloc (sizeof (GstStructureImpl) +
+      (n_alloc - 1) * sizeof (GstStructureField));
   ((GstStructure *) structure)->type = _gst_structure_type;
   ((GstStructure *) structure)->name = quark;
   GST_STRUCTURE_REFCOUNT (structure) = NULL;
-  GST_STRUCTURE_FIELDS (structure) =
-      g_array_sized_new (FALSE, FALSE, sizeof (GstStructureField), prealloc);
+  GST_STRUCTURE_LEN (structure) = 0;
+  GST_STRUCTURE_FIELDS (structure) = GST_STRUCTURE_INLINE (structure);
+  GST_STRUCTURE_ALLOC (structure) = n_alloc;
+  GST_STRUCTURE_INDEX (structure) = NULL;
+
+  if (prealloc > n_alloc) {
+    GST_STRUCTURE_FIELDS (structure) = g_new (GstStructureField, prealloc);
+    GST_STRUCTURE_ALLOC (structure) = prealloc;
+  }
 
   GST_TRACE ("created structure %p", structure);
 
   return GST_STRUCTURE_CAST (structure);
 }
 
+static void
+_structure_index_field (GstStructure * s, guint i)
+{
+  g_hash_table_insert (GST_STRUCTURE_INDEX (s),
+      GUINT_TO_POINTER (GST_STRUCTURE_FIELD (s, i)->name),
+      GUINT_TO_POINTER (i + 1));
+}
+
+/* (re)creates the lookup index if the structure is big enough for it */
+static void
+_structure_update_index (GstStructure * s)
+{
+  guint i, len = GST_STRUCTURE_LEN (s);
+
+  if (len < STRUCTURE_INDEX_THRESHOLD) {
+    if (GST_STRUCTURE_INDEX (s)) {
+      g_hash_table_unref (GST_STRUCTURE_INDEX (s));
+      GST_STRUCTURE_INDEX (s) = NULL;
+    }
+    return;
+  }
+
+  if (GST_STRUCTURE_INDEX (s))
+    return;
+
+  GST_STRUCTURE_INDEX (s) = g_hash_table_new (NULL, NULL);
+  for (i = 0; i < len; i++)
+    _structure_index_field (s, i);
+}
+
+/* takes ownership of the value in @field */
+static void
+_structure_append_field (GstStructure * s, const GstStructureField * field)
+{
+  guint len = GST_STRUCTURE_LEN (s);
+
+  if (G_UNLIKELY (len >= GST_STRUCTURE_ALLOC (s))) {
+    guint want_alloc;
+
+    if (G_UNLIKELY (len >= G_MAXUINT / 2))
+      g_error ("growing structure would result in overflow");
+
+    want_alloc = MAX (GST_ROUND_UP_8 (len + 1), GST_STRUCTURE_ALLOC (s) * 2);
+    if (GST_STRUCTURE_FIELDS (s) == GST_STRUCTURE_INLINE (s)) {
+      GST_STRUCTURE_FIELDS (s) = g_new (GstStructureField, want_alloc);
+      memcpy (GST_STRUCTURE_FIELDS (s), GST_STRUCTURE_INLINE (s),
+          len * sizeof (GstStructureField));
+    } else {
+      GST_STRUCTURE_FIELDS (s) =
+          g_renew (GstStructureField, GST_STRUCTURE_FIELDS (s), want_alloc);
+    }
+    GST_STRUCTURE_ALLOC (s) = want_alloc;
+  }
+
+  GST_STRUCTURE_FIELDS (s)[len] = *field;
+  GST_STRUCTURE_LEN (s) = len + 1;
+
+  if (GST_STRUCTURE_INDEX (s))
+    _structure_index_field (s, len);
+  else if (G_UNLIKELY (len + 1 == STRUCTURE_INDEX_THRESHOLD))
+    _structure_update_index (s);
+}
+
+/* the value of the field must have been unset already. The lookup index is
+ * dropped, call _structure_update_index() when done removing fields */
+static void
+_structure_remove_index (GstStructure * s, guint i)
+{
+  guint len = GST_STRUCTURE_LEN (s);
+
+  if (i + 1 < len)
+    memmove (GST_STRUCTURE_FIELD (s, i), GST_STRUCTURE_FIELD (s, i + 1),
+        (len - i - 1) * sizeof (GstStructureField));
+  GST_STRUCTURE_LEN (s) = len - 1;
+
+  if (GST_STRUCTURE_INDEX (s)) {
+    g_hash_table_unref (GST_STRUCTURE_INDEX (s));
+    GST_STRUCTURE_INDEX (s) = NULL;
+  }
+}
+
 /**
  * gst_structure_new_id_empty:
  * @quark: name of new structure
@@ -341,7 +451,7 @@ gst_structure_copy (const GstStructure * structure)
 
   g_return_val_if_fail (structure != NULL, NULL);
 
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  len = GST_STRUCTURE_LEN (structure);
   new_structure = gst_structure_new_id_empty_with_size (structure->name, len);
 
   for (i = 0; i < len; i++) {
@@ -351,7 +461,7 @@ gst_structure_copy (const GstStructure * structure)
 
     new_field.name = field->name;
     gst_value_init_and_copy (&new_field.value, &field->value);
-    g_array_append_val (GST_STRUCTURE_FIELDS (new_structure), new_field);
+    _structure_append_field (new_structure, &new_field);
   }
   GST_CAT_TRACE (GST_CAT_PERFORMANCE, "doing copy %p -> %p",
       structure, new_structure);
@@ -375,7 +485,7 @@ gst_structure_free (GstStructure * structure)
   g_return_if_fail (structure != NULL);
   g_return_if_fail (GST_STRUCTURE_REFCOUNT (structure) == NULL);
 
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  len = GST_STRUCTURE_LEN (structure);
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
 
@@ -383,13 +493,16 @@ gst_structure_free (GstStructure * structure)
       g_value_unset (&field->value);
     }
   }
-  g_array_free (GST_STRUCTURE_FIELDS (structure), TRUE);
+  if (GST_STRUCTURE_FIELDS (structure) != GST_STRUCTURE_INLINE (structure))
+    g_free (GST_STRUCTURE_FIELDS (structure));
+  if (GST_STRUCTURE_INDEX (structure))
+    g_hash_table_unref (GST_STRUCTURE_INDEX (structure));
 #ifdef USE_POISONING
   memset (structure, 0xff, sizeof (GstStructure));
 #endif
   GST_TRACE ("free structure %p", structure);
 
-  g_slice_free1 (sizeof (GstStructureImpl), structure);
+  g_free (structure);
 }
 
 /**
@@ -771,9 +884,6 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
 {
   GstStructureField *f;
   GType field_value_type;
-  guint i, len;
-
-  len = GST_STRUCTURE_FIELDS (structure)->len;
 
   field_value_type = G_VALUE_TYPE (&field->value);
   if (field_value_type == G_TYPE_STRING) {
@@ -824,17 +934,14 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
     }
   }
 
-  for (i = 0; i < len; i++) {
-    f = GST_STRUCTURE_FIELD (structure, i);
-
-    if (G_UNLIKELY (f->name == field->name)) {
-      g_value_unset (&f->value);
-      memcpy (f, field, sizeof (GstStructureField));
-      return;
-    }
+  f = gst_structure_id_get_field (structure, field->name);
+  if (G_UNLIKELY (f != NULL)) {
+    g_value_unset (&f->value);
+    memcpy (f, field, sizeof (GstStructureField));
+    return;
   }
 
-  g_array_append_val (GST_STRUCTURE_FIELDS (structure), *field);
+  _structure_append_field (structure, field);
 }
 
 /* If there is no field with the given ID, NULL is returned.
@@ -845,7 +952,14 @@ gst_structure_id_get_field (const GstStructure * structure, GQuark field_id)
   GstStructureField *field;
   guint i, len;
 
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  if (GST_STRUCTURE_INDEX (structure)) {
+    i = GPOINTER_TO_UINT (g_hash_table_lookup (GST_STRUCTURE_INDEX (structure),
+            GUINT_TO_POINTER (field_id)));
+
+    return i ? GST_STRUCTURE_FIELD (structure, i - 1) : NULL;
+  }
+
+  len = GST_STRUCTURE_LEN (structure);
 
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
@@ -939,7 +1053,7 @@ gst_structure_remove_field (GstStructure * structure, const gchar * fieldname)
   g_return_if_fail (IS_MUTABLE (structure));
 
   id = g_quark_from_string (fieldname);
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  len = GST_STRUCTURE_LEN (structure);
 
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
@@ -948,8 +1062,8 @@ gst_structure_remove_field (GstStructure * structure, const gchar * fieldname)
       if (G_IS_VALUE (&field->value)) {
         g_value_unset (&field->value);
       }
-      GST_STRUCTURE_FIELDS (structure) =
-          g_array_remove_index (GST_STRUCTURE_FIELDS (structure), i);
+      _structure_remove_index (structure, i);
+      _structure_update_index (structure);
       return;
     }
   }
@@ -1018,14 +1132,13 @@ gst_structure_remove_all_fields (GstStructure * structure)
   g_return_if_fail (structure != NULL);
   g_return_if_fail (IS_MUTABLE (structure));
 
-  for (i = GST_STRUCTURE_FIELDS (structure)->len - 1; i >= 0; i--) {
+  for (i = GST_STRUCTURE_LEN (structure) - 1; i >= 0; i--) {
     field = GST_STRUCTURE_FIELD (structure, i);
 
     if (G_IS_VALUE (&field->value)) {
       g_value_unset (&field->value);
     }
-    GST_STRUCTURE_FIELDS (structure) =
-        g_array_remove_index (GST_STRUCTURE_FIELDS (structure), i);
+    _structure_remove_index (structure, i);
   }
 }
 
@@ -1069,7 +1182,7 @@ gst_structure_n_fields (const GstStructure * structure)
 {
   g_return_val_if_fail (structure != NULL, 0);
 
-  return GST_STRUCTURE_FIELDS (structure)->len;
+  return GST_STRUCTURE_LEN (structure);
 }
 
 /**
@@ -1087,7 +1200,7 @@ gst_structure_nth_field_name (const GstStructure * structure, guint index)
   GstStructureField *field;
 
   g_return_val_if_fail (structure != NULL, NULL);
-  g_return_val_if_fail (index < GST_STRUCTURE_FIELDS (structure)->len, NULL);
+  g_return_val_if_fail (index < GST_STRUCTURE_LEN (structure), NULL);
 
   field = GST_STRUCTURE_FIELD (structure, index);
 
@@ -1118,7 +1231,7 @@ gst_structure_foreach (const GstStructure * structure,
   g_return_val_if_fail (structure != NULL, FALSE);
   g_return_val_if_fail (func != NULL, FALSE);
 
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  len = GST_STRUCTURE_LEN (structure);
 
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
@@ -1155,7 +1268,7 @@ gst_structure_map_in_place (GstStructure * structure,
   g_return_val_if_fail (structure != NULL, FALSE);
   g_return_val_if_fail (IS_MUTABLE (structure), FALSE);
   g_return_val_if_fail (func != NULL, FALSE);
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  len = GST_STRUCTURE_LEN (structure);
 
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
@@ -1193,7 +1306,7 @@ gst_structure_filter_and_map_in_place (GstStructure * structure,
   g_return_if_fail (structure != NULL);
   g_return_if_fail (IS_MUTABLE (structure));
   g_return_if_fail (func != NULL);
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  len = GST_STRUCTURE_LEN (structure);
 
   for (i = 0; i < len;) {
     field = GST_STRUCTURE_FIELD (structure, i);
@@ -1204,13 +1317,14 @@ gst_structure_filter_and_map_in_place (GstStructure * structure,
       if (G_IS_VALUE (&field->value)) {
         g_value_unset (&field->value);
       }
-      GST_STRUCTURE_FIELDS (structure) =
-          g_array_remove_index (GST_STRUCTURE_FIELDS (structure), i);
-      len = GST_STRUCTURE_FIELDS (structure)->len;
+      _structure_remove_index (structure, i);
+      len = GST_STRUCTURE_LEN (structure);
     } else {
       i++;
     }
   }
+
+  _structure_update_index (structure);
 }
 
 /**
@@ -1911,7 +2025,7 @@ priv_gst_structure_append_to_gstring (const GstStructure * structure,
 
   g_return_val_if_fail (s != NULL, FALSE);
 
-  len = GST_STRUCTURE_FIELDS (structure)->len;
+  len = GST_STRUCTURE_LEN (structure);
   for (i = 0; i < len; i++) {
     char *t;
     GType type;
@@ -3246,8 +3360,7 @@ gst_structure_is_equal (const GstStructure * structure1,
   if (structure1->name != structure2->name) {
     return FALSE;
   }
-  if (GST_STRUCTURE_FIELDS (structure1)->len !=
-      GST_STRUCTURE_FIELDS (structure2)->len) {
+  if (GST_STRUCTURE_LEN (structure1) != GST_STRUCTURE_LEN (structure2)) {
     return FALSE;
   }
 
@@ -77,8 +77,9 @@ struct _GstSystemClockPrivate
   GThread *thread;              /* thread for async notify */
   gboolean stopping;
 
-  GList *entries;
+  GSequence *entries;           /* sorted async entries */
   GCond entries_changed;
+  GstClockTime slack;           /* time async entries may fire late */
 
   GstClockType clock_type;
   GstPoll *timer;
@@ -112,9 +113,12 @@ enum
 {
   PROP_0,
   PROP_CLOCK_TYPE,
+  PROP_SLACK,
   /* FILL ME */
 };
 
+#define DEFAULT_SLACK 0
+
 /* the one instance of the systemclock */
 static GstClock *_the_system_clock = NULL;
 static gboolean _external_default_clock = FALSE;
@@ -131,7 +135,7 @@ static GstClockReturn gst_system_clock_id_wait_jitter (GstClock * clock,
     GstClockEntry * entry, GstClockTimeDiff * jitter);
 static GstClockReturn gst_system_clock_id_wait_jitter_unlocked
     (GstClock * clock, GstClockEntry * entry, GstClockTimeDiff * jitter,
-    gboolean restart);
+    gboolean restart, GstClockTime delay);
 static GstClockReturn gst_system_clock_id_wait_async (GstClock * clock,
     GstClockEntry * entry);
 static void gst_system_clock_id_unschedule (GstClock * clock,
@@ -168,6 +172,21 @@ gst_system_clock_class_init (GstSystemClockClass * klass)
           GST_TYPE_CLOCK_TYPE, DEFAULT_CLOCK_TYPE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSystemClock:slack:
+   *
+   * The maximum amount of time async callbacks are allowed to be delayed so
+   * that they can be fired together with the callbacks of later entries in
+   * a single wakeup of the async thread.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SLACK,
+      g_param_spec_uint64 ("slack", "Slack",
+          "Maximum delay of async callbacks to coalesce wakeups (in ns)",
+          0, G_MAXUINT64, DEFAULT_SLACK,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstclock_class->get_internal_time = gst_system_clock_get_internal_time;
   gstclock_class->get_resolution = gst_system_clock_get_resolution;
   gstclock_class->wait = gst_system_clock_id_wait_jitter;
@@ -191,8 +210,9 @@ gst_system_clock_init (GstSystemClock * clock)
   priv->clock_type = DEFAULT_CLOCK_TYPE;
   priv->timer = gst_poll_new_timer ();
 
-  priv->entries = NULL;
+  priv->entries = g_sequence_new (NULL);
   g_cond_init (&priv->entries_changed);
+  priv->slack = DEFAULT_SLACK;
 
 #ifdef G_OS_WIN32
   QueryPerformanceFrequency (&priv->frequency);
@@ -220,14 +240,15 @@ gst_system_clock_dispose (GObject * object)
   GstClock *clock = (GstClock *) object;
   GstSystemClock *sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   GstSystemClockPrivate *priv = sysclock->priv;
-  GList *entries;
+  GSequenceIter *iter;
 
   /* else we have to stop the thread */
   GST_OBJECT_LOCK (clock);
   priv->stopping = TRUE;
   /* unschedule all entries */
-  for (entries = priv->entries; entries; entries = g_list_next (entries)) {
-    GstClockEntry *entry = (GstClockEntry *) entries->data;
+  for (iter = g_sequence_get_begin_iter (priv->entries);
+      !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter)) {
+    GstClockEntry *entry = (GstClockEntry *) g_sequence_get (iter);
 
     GST_CAT_DEBUG (GST_CAT_CLOCK, "unscheduling entry %p", entry);
     SET_ENTRY_STATUS (entry, GST_CLOCK_UNSCHEDULED);
@@ -241,8 +262,8 @@ gst_system_clock_dispose (GObject * object)
   priv->thread = NULL;
   GST_CAT_DEBUG (GST_CAT_CLOCK, "joined thread");
 
-  g_list_foreach (priv->entries, (GFunc) gst_clock_id_unref, NULL);
-  g_list_free (priv->entries);
+  g_sequence_foreach (priv->entries, (GFunc) gst_clock_id_unref, NULL);
+  g_sequence_free (priv->entries);
   priv->entries = NULL;
 
   gst_poll_free (priv->timer);
@@ -268,6 +289,11 @@ gst_system_clock_set_property (GObject * object, guint prop_id,
       GST_CAT_DEBUG (GST_CAT_CLOCK, "clock-type set to %d",
           sysclock->priv->clock_type);
       break;
+    case PROP_SLACK:
+      GST_OBJECT_LOCK (sysclock);
+      sysclock->priv->slack = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (sysclock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -284,6 +310,11 @@ gst_system_clock_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_CLOCK_TYPE:
       g_value_set_enum (value, sysclock->priv->clock_type);
       break;
+    case PROP_SLACK:
+      GST_OBJECT_LOCK (sysclock);
+      g_value_set_uint64 (value, sysclock->priv->slack);
+      GST_OBJECT_UNLOCK (sysclock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -418,6 +449,43 @@ gst_system_clock_wait_wakeup (GstSystemClock * sysclock)
   }
 }
 
+static gint
+gst_system_clock_compare_entries (gconstpointer a, gconstpointer b,
+    gpointer user_data)
+{
+  return gst_clock_id_compare_func (a, b);
+}
+
+/* Returns how much later than @entry we wait so that the entries after it
+ * that are due within the slack fire in the same wakeup. Must be called with
+ * the object lock */
+static GstClockTime
+gst_system_clock_get_coalesce_delay (GstSystemClock * sysclock,
+    GSequenceIter * iter)
+{
+  GstClockEntry *entry, *next;
+  GstClockTime limit, last;
+
+  if (sysclock->priv->slack == 0)
+    return 0;
+
+  entry = g_sequence_get (iter);
+  last = GST_CLOCK_ENTRY_TIME (entry);
+  limit = last + sysclock->priv->slack;
+
+  for (iter = g_sequence_iter_next (iter); !g_sequence_iter_is_end (iter);
+      iter = g_sequence_iter_next (iter)) {
+    next = g_sequence_get (iter);
+
+    if (GST_CLOCK_ENTRY_TIME (next) > limit)
+      break;
+    if (GET_ENTRY_STATUS (next) != GST_CLOCK_UNSCHEDULED)
+      last = GST_CLOCK_ENTRY_TIME (next);
+  }
+
+  return last - GST_CLOCK_ENTRY_TIME (entry);
+}
+
 /* this thread reads the sorted clock entries from the queue.
  *
  * It waits on each of them and fires the callback when the timeout occurs.
@@ -444,11 +512,12 @@ gst_system_clock_async_thread (GstClock * clock)
   /* now enter our (almost) infinite loop */
   while (!priv->stopping) {
     GstClockEntry *entry;
-    GstClockTime requested;
+    GSequenceIter *iter;
+    GstClockTime requested, delay;
     GstClockReturn res;
 
     /* check if something to be done */
-    while (priv->entries == NULL) {
+    while (g_sequence_get_length (priv->entries) == 0) {
       GST_CAT_DEBUG (GST_CAT_CLOCK, "no clock entries, waiting..");
       /* wait for work to do */
       GST_SYSTEM_CLOCK_WAIT (clock);
@@ -467,7 +536,8 @@ gst_system_clock_async_thread (GstClock * clock)
     }
 
     /* pick the next entry */
-    entry = priv->entries->data;
+    iter = g_sequence_get_begin_iter (priv->entries);
+    entry = g_sequence_get (iter);
 
     /* set entry status to busy before we release the clock lock */
     do {
@@ -489,6 +559,8 @@ gst_system_clock_async_thread (GstClock * clock)
        * statuses */
     } while (G_UNLIKELY (!CAS_ENTRY_STATUS (entry, status, GST_CLOCK_BUSY)));
 
+    delay = gst_system_clock_get_coalesce_delay (sysclock, iter);
+
     GST_OBJECT_UNLOCK (clock);
 
     requested = entry->time;
@@ -496,7 +568,7 @@ gst_system_clock_async_thread (GstClock * clock)
     /* now wait for the entry */
     res =
         gst_system_clock_id_wait_jitter_unlocked (clock, (GstClockID) entry,
-        NULL, FALSE);
+        NULL, FALSE, delay);
 
     GST_OBJECT_LOCK (clock);
 
@@ -522,9 +594,9 @@ gst_system_clock_async_thread (GstClock * clock)
           GST_CAT_DEBUG (GST_CAT_CLOCK, "updating periodic entry %p", entry);
           /* adjust time now */
           entry->time = requested + entry->interval;
-          /* and resort the list now */
-          priv->entries =
-              g_list_sort (priv->entries, gst_clock_id_compare_func);
+          /* and move it to its new place */
+          g_sequence_sort_changed (iter, gst_system_clock_compare_entries,
+              NULL);
           /* and restart */
           continue;
         } else {
@@ -553,7 +625,7 @@ gst_system_clock_async_thread (GstClock * clock)
     }
   next_entry:
     /* we remove the current entry and unref it */
-    priv->entries = g_list_remove (priv->entries, entry);
+    g_sequence_remove (iter);
     gst_clock_id_unref ((GstClockID) entry);
   }
 exit:
@@ -694,7 +766,8 @@ gst_system_clock_cleanup_unscheduled (GstSystemClock * sysclock,
  */
 static GstClockReturn
 gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
-    GstClockEntry * entry, GstClockTimeDiff * jitter, gboolean restart)
+    GstClockEntry * entry, GstClockTimeDiff * jitter, gboolean restart,
+    GstClockTime delay)
 {
   GstSystemClock *sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   GstClockTime entryt, now;
@@ -711,8 +784,9 @@ gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
    * of the clock, whatever the subclass uses as a clock. */
   now = gst_clock_get_time (clock);
 
-  /* get the time of the entry */
-  entryt = GST_CLOCK_ENTRY_TIME (entry);
+  /* get the time of the entry, async entries might be delayed to fire
+   * together with later entries */
+  entryt = GST_CLOCK_ENTRY_TIME (entry) + delay;
 
   /* the diff of the entry with the clock is the amount of time we have to
    * wait */
@@ -878,7 +952,8 @@ gst_system_clock_id_wait_jitter (GstClock * clock, GstClockEntry * entry,
      * statuses */
   } while (G_UNLIKELY (!CAS_ENTRY_STATUS (entry, status, GST_CLOCK_BUSY)));
 
-  return gst_system_clock_id_wait_jitter_unlocked (clock, entry, jitter, TRUE);
+  return gst_system_clock_id_wait_jitter_unlocked (clock, entry, jitter, TRUE,
+      0);
 }
 
 /* Start the async clock thread. Must be called with the object lock
@@ -925,6 +1000,7 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
   GstSystemClock *sysclock;
   GstSystemClockPrivate *priv;
   GstClockEntry *head;
+  GSequenceIter *iter;
 
   sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   priv = sysclock->priv;
@@ -939,21 +1015,22 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
   if (G_UNLIKELY (GET_ENTRY_STATUS (entry) == GST_CLOCK_UNSCHEDULED))
     goto was_unscheduled;
 
-  if (priv->entries)
-    head = priv->entries->data;
+  iter = g_sequence_get_begin_iter (priv->entries);
+  if (!g_sequence_iter_is_end (iter))
+    head = g_sequence_get (iter);
   else
     head = NULL;
 
   /* need to take a ref */
   gst_clock_id_ref ((GstClockID) entry);
   /* insert the entry in sorted order */
-  priv->entries = g_list_insert_sorted (priv->entries, entry,
-      gst_clock_id_compare_func);
+  iter = g_sequence_insert_sorted (priv->entries, entry,
+      gst_system_clock_compare_entries, NULL);
 
   /* only need to send the signal if the entry was added to the
    * front, else the thread is just waiting for another entry and
    * will get to this entry automatically. */
-  if (priv->entries->data == entry) {
+  if (g_sequence_iter_is_begin (iter)) {
     GST_CAT_DEBUG (GST_CAT_CLOCK, "async entry added to head %p", head);
     if (head == NULL) {
       /* the list was empty before, signal the cond so that the async thread can
@@ -28,6 +28,17 @@
  * implementation uses a regular GThreadPool to start tasks.
  *
  * Subclasses can be made to create custom threads.
+ *
+ * The default implementation can pin its threads to a set of CPUs with the
+ * #GstTaskPool:cpu-affinity or #GstTaskPool:numa-node properties and run
+ * them with the SCHED_FIFO policy with #GstTaskPool:realtime-priority. The
+ * settings are applied by the thread each time it starts running a task.
+ *
+ * To make all streaming threads of an element or of a whole pipeline use
+ * such a pool, set a #GstContext of type #GST_TASK_POOL_CONTEXT_TYPE with
+ * the pool in its "task-pool" field on the element or pipeline. Pads pick up
+ * the pool when they create their task, before the
+ * %GST_STREAM_STATUS_TYPE_CREATE message is posted.
  */
 
 #include "gst_private.h"
@@ -35,12 +46,44 @@
 #include "gstinfo.h"
 #include "gsttaskpool.h"
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (taskpool_debug);
 #define GST_CAT_DEFAULT (taskpool_debug)
 
-#ifndef GST_DISABLE_GST_DEBUG
+#define GST_TASK_POOL_GET_PRIVATE(obj)  \
+   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_TASK_POOL, GstTaskPoolPrivate))
+
+struct _GstTaskPoolPrivate
+{
+  gchar *cpu_affinity;
+  gint numa_node;
+  gint realtime_priority;
+
+  /* CPUs from cpu-affinity or numa-node */
+  GArray *cpus;
+};
+
+#define DEFAULT_CPU_AFFINITY      NULL
+#define DEFAULT_NUMA_NODE         -1
+#define DEFAULT_REALTIME_PRIORITY 0
+
+enum
+{
+  PROP_0,
+  PROP_CPU_AFFINITY,
+  PROP_NUMA_NODE,
+  PROP_REALTIME_PRIORITY
+};
+
 static void gst_task_pool_finalize (GObject * object);
-#endif
+static void gst_task_pool_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_task_pool_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 #define _do_init \
 { \
@@ -55,6 +98,146 @@ typedef struct
   gpointer user_data;
 } TaskData;
 
+/* parse a list like "0-3,6" and append the CPUs to @cpus */
+static gboolean
+parse_cpu_list (const gchar * str, GArray * cpus)
+{
+  gchar *end;
+
+  while (*str != '\0') {
+    guint64 first, last;
+
+    while (g_ascii_isspace (*str))
+      str++;
+    if (*str == '\0')
+      break;
+
+    first = g_ascii_strtoull (str, &end, 10);
+    if (end == str)
+      return FALSE;
+    last = first;
+    str = end;
+
+    if (*str == '-') {
+      str++;
+      last = g_ascii_strtoull (str, &end, 10);
+      if (end == str || last < first)
+        return FALSE;
+      str = end;
+    }
+    if (last >= 1024)
+      return FALSE;
+
+    for (; first <= last; first++) {
+      guint cpu = first;
+      g_array_append_val (cpus, cpu);
+    }
+
+    while (g_ascii_isspace (*str))
+      str++;
+    if (*str == ',')
+      str++;
+    else if (*str != '\0')
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/* call with the object lock */
+static void
+update_cpus (GstTaskPool * pool)
+{
+  GstTaskPoolPrivate *priv = GST_TASK_POOL_GET_PRIVATE (pool);
+  GArray *cpus;
+
+  cpus = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  if (priv->cpu_affinity) {
+    if (!parse_cpu_list (priv->cpu_affinity, cpus))
+      goto invalid_list;
+  } else if (priv->numa_node >= 0) {
+    gchar *path, *contents = NULL;
+
+    path = g_strdup_printf ("/sys/devices/system/node/node%d/cpulist",
+        priv->numa_node);
+    if (!g_file_get_contents (path, &contents, NULL, NULL) ||
+        !parse_cpu_list (contents, cpus)) {
+      GST_WARNING_OBJECT (pool, "could not get CPUs of NUMA node %d",
+          priv->numa_node);
+      g_array_set_size (cpus, 0);
+    }
+    g_free (contents);
+    g_free (path);
+  }
+
+done:
+  if (priv->cpus)
+    g_array_unref (priv->cpus);
+  if (cpus->len > 0) {
+    priv->cpus = cpus;
+  } else {
+    priv->cpus = NULL;
+    g_array_unref (cpus);
+  }
+  return;
+
+  /* ERRORS */
+invalid_list:
+  {
+    GST_WARNING_OBJECT (pool, "invalid CPU list '%s'", priv->cpu_affinity);
+    g_array_set_size (cpus, 0);
+    goto done;
+  }
+}
+
+/* apply the scheduling settings of @pool to the current thread */
+static void
+configure_thread (GstTaskPool * pool)
+{
+  GstTaskPoolPrivate *priv = GST_TASK_POOL_GET_PRIVATE (pool);
+  GArray *cpus;
+  gint priority;
+
+  GST_OBJECT_LOCK (pool);
+  cpus = priv->cpus ? g_array_ref (priv->cpus) : NULL;
+  priority = priv->realtime_priority;
+  GST_OBJECT_UNLOCK (pool);
+
+  if (cpus) {
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    cpu_set_t set;
+    guint i;
+
+    CPU_ZERO (&set);
+    for (i = 0; i < cpus->len; i++) {
+      guint cpu = g_array_index (cpus, guint, i);
+
+      if (cpu < CPU_SETSIZE)
+        CPU_SET (cpu, &set);
+    }
+    if (pthread_setaffinity_np (pthread_self (), sizeof (set), &set) != 0)
+      GST_WARNING_OBJECT (pool, "failed to set CPU affinity of thread %p",
+          g_thread_self ());
+#else
+    GST_WARNING_OBJECT (pool, "setting the CPU affinity is not supported");
+#endif
+    g_array_unref (cpus);
+  }
+
+  if (priority > 0) {
+#ifdef HAVE_PTHREAD
+    struct sched_param param = { 0, };
+
+    param.sched_priority = priority;
+    if (pthread_setschedparam (pthread_self (), SCHED_FIFO, &param) != 0)
+      GST_WARNING_OBJECT (pool, "failed to set SCHED_FIFO priority %d for "
+          "thread %p, missing permissions?", priority, g_thread_self ());
+#else
+    GST_WARNING_OBJECT (pool, "realtime scheduling is not supported");
+#endif
+  }
+}
+
 static void
 default_func (TaskData * tdata, GstTaskPool * pool)
 {
@@ -65,6 +248,8 @@ default_func (TaskData * tdata, GstTaskPool * pool)
   user_data = tdata->user_data;
   g_slice_free (TaskData, tdata);
 
+  configure_thread (pool);
+
   func (user_data);
 }
 
@@ -126,9 +311,54 @@ gst_task_pool_class_init (GstTaskPoolClass * klass)
   gobject_class = (GObjectClass *) klass;
   gsttaskpool_class = (GstTaskPoolClass *) klass;
 
-#ifndef GST_DISABLE_GST_DEBUG
+  g_type_class_add_private (klass, sizeof (GstTaskPoolPrivate));
+
   gobject_class->finalize = gst_task_pool_finalize;
-#endif
+  gobject_class->set_property = gst_task_pool_set_property;
+  gobject_class->get_property = gst_task_pool_get_property;
+
+  /**
+   * GstTaskPool:cpu-affinity:
+   *
+   * Comma separated list of CPUs or CPU ranges, like "0-3,6", that the
+   * threads of the pool are pinned to. Only used by the default
+   * implementation on platforms that support it.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_CPU_AFFINITY,
+      g_param_spec_string ("cpu-affinity", "CPU affinity",
+          "List of CPUs to run the threads on, like \"0-3,6\"",
+          DEFAULT_CPU_AFFINITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTaskPool:numa-node:
+   *
+   * Pin the threads of the pool to the CPUs of this NUMA node when
+   * #GstTaskPool:cpu-affinity is not set, -1 to not use a node.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_NUMA_NODE,
+      g_param_spec_int ("numa-node", "NUMA node",
+          "Run the threads on the CPUs of this NUMA node (-1 = any)",
+          -1, G_MAXINT, DEFAULT_NUMA_NODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTaskPool:realtime-priority:
+   *
+   * Run the threads of the pool with the SCHED_FIFO policy and this
+   * priority, 0 keeps the default policy. This usually needs extra
+   * permissions, a warning is logged when the policy can't be changed.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_REALTIME_PRIORITY,
+      g_param_spec_int ("realtime-priority", "Realtime priority",
+          "SCHED_FIFO priority of the threads (0 = default policy)",
+          0, 99, DEFAULT_REALTIME_PRIORITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gsttaskpool_class->prepare = default_prepare;
   gsttaskpool_class->cleanup = default_cleanup;
@@ -139,19 +369,91 @@ gst_task_pool_class_init (GstTaskPoolClass * klass)
 static void
 gst_task_pool_init (GstTaskPool * pool)
 {
+  GstTaskPoolPrivate *priv = GST_TASK_POOL_GET_PRIVATE (pool);
+
+  priv->cpu_affinity = g_strdup (DEFAULT_CPU_AFFINITY);
+  priv->numa_node = DEFAULT_NUMA_NODE;
+  priv->realtime_priority = DEFAULT_REALTIME_PRIORITY;
+
   /* clear floating flag */
   gst_object_ref_sink (pool);
 }
 
-#ifndef GST_DISABLE_GST_DEBUG
 static void
 gst_task_pool_finalize (GObject * object)
 {
+  GstTaskPoolPrivate *priv = GST_TASK_POOL_GET_PRIVATE (object);
+
   GST_DEBUG ("taskpool %p finalize", object);
 
+  g_free (priv->cpu_affinity);
+  if (priv->cpus)
+    g_array_unref (priv->cpus);
+
   G_OBJECT_CLASS (gst_task_pool_parent_class)->finalize (object);
 }
-#endif
+
+static void
+gst_task_pool_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstTaskPool *pool = GST_TASK_POOL (object);
+  GstTaskPoolPrivate *priv = GST_TASK_POOL_GET_PRIVATE (pool);
+
+  switch (prop_id) {
+    case PROP_CPU_AFFINITY:
+      GST_OBJECT_LOCK (pool);
+      g_free (priv->cpu_affinity);
+      priv->cpu_affinity = g_value_dup_string (value);
+      update_cpus (pool);
+      GST_OBJECT_UNLOCK (pool);
+      break;
+    case PROP_NUMA_NODE:
+      GST_OBJECT_LOCK (pool);
+      priv->numa_node = g_value_get_int (value);
+      update_cpus (pool);
+      GST_OBJECT_UNLOCK (pool);
+      break;
+    case PROP_REALTIME_PRIORITY:
+      GST_OBJECT_LOCK (pool);
+      priv->realtime_priority = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (pool);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_task_pool_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstTaskPool *pool = GST_TASK_POOL (object);
+  GstTaskPoolPrivate *priv = GST_TASK_POOL_GET_PRIVATE (pool);
+
+  switch (prop_id) {
+    case PROP_CPU_AFFINITY:
+      GST_OBJECT_LOCK (pool);
+      g_value_set_string (value, priv->cpu_affinity);
+      GST_OBJECT_UNLOCK (pool);
+      break;
+    case PROP_NUMA_NODE:
+      GST_OBJECT_LOCK (pool);
+      g_value_set_int (value, priv->numa_node);
+      GST_OBJECT_UNLOCK (pool);
+      break;
+    case PROP_REALTIME_PRIORITY:
+      GST_OBJECT_LOCK (pool);
+      g_value_set_int (value, priv->realtime_priority);
+      GST_OBJECT_UNLOCK (pool);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 /**
  * gst_task_pool_new:
  *
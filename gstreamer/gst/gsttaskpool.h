@@ -37,6 +37,18 @@ G_BEGIN_DECLS
 
 typedef struct _GstTaskPool GstTaskPool;
 typedef struct _GstTaskPoolClass GstTaskPoolClass;
+typedef struct _GstTaskPoolPrivate GstTaskPoolPrivate;
+
+/**
+ * GST_TASK_POOL_CONTEXT_TYPE:
+ *
+ * The #GstContext type used to configure the #GstTaskPool for the streaming
+ * threads of an element or of all elements in a bin. The pool is stored in
+ * the "task-pool" field of the context structure.
+ *
+ * Since: 1.10
+ */
+#define GST_TASK_POOL_CONTEXT_TYPE "gst.task-pool"
 
 /**
  * GstTaskPoolFunction:
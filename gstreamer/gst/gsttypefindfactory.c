@@ -165,6 +165,17 @@ gst_type_find_factory_get_caps (GstTypeFindFactory * factory)
 {
   g_return_val_if_fail (GST_IS_TYPE_FIND_FACTORY (factory), NULL);
 
+  /* factories loaded from the registry cache only parse their caps when
+   * they are first needed */
+  if (G_UNLIKELY (g_atomic_pointer_get (&factory->caps) == NULL
+          && factory->caps_str != NULL)) {
+    GstCaps *caps = gst_caps_from_string (factory->caps_str);
+
+    if (caps && !g_atomic_pointer_compare_and_exchange (&factory->caps, NULL,
+            caps))
+      gst_caps_unref (caps);
+  }
+
   return factory->caps;
 }
 
@@ -366,50 +366,102 @@ error:
   goto out;
 }
 
-static void gst_parse_element_set (gchar *value, GstElement *element, graph_t *graph)
+/* records an element in the template being compiled, if any */
+static void gst_parse_template_add_element (graph_t *graph, GstElement *element,
+    GstURIType uri_type, const gchar *uri)
 {
-  GParamSpec *pspec = NULL;
-  gchar *pos = value;
-  GValue v = { 0, };
-  GObject *target = NULL;
-  GType value_type;
+  element_template_t et = { NULL, };
 
-  /* do nothing if assignment is for missing element */
-  if (element == NULL)
-    goto out;
+  if (graph->tmpl == NULL || element == NULL)
+    return;
 
-  /* parse the string, so the property name is null-terminated and pos points
-     to the beginning of the value */
-  while (!g_ascii_isspace (*pos) && (*pos != '=')) pos++;
-  if (*pos == '=') {
-    *pos = '\0';
+  if (uri) {
+    et.uri_type = uri_type;
+    et.uri = g_strdup (uri);
   } else {
-    *pos = '\0';
-    pos++;
-    while (g_ascii_isspace (*pos)) pos++;
+    et.factory = gst_object_ref (gst_element_get_factory (element));
   }
-  pos++;
-  while (g_ascii_isspace (*pos)) pos++;
-  /* truncate a string if it is delimited with double quotes */
-  if (*pos == '"' && pos[strlen (pos) - 1] == '"') {
-    pos++;
-    pos[strlen (pos) - 1] = '\0';
+  et.parent = -1;
+  et.props = g_array_new (FALSE, TRUE, sizeof (prop_template_t));
+  g_array_append_val (graph->tmpl->elements, et);
+  g_hash_table_insert (graph->tmpl_index, element,
+      GUINT_TO_POINTER (graph->tmpl->elements->len));
+}
+
+static gint gst_parse_template_lookup (graph_t *graph, GstElement *element)
+{
+  return GPOINTER_TO_INT (g_hash_table_lookup (graph->tmpl_index, element)) - 1;
+}
+
+static void gst_parse_template_add_prop (graph_t *graph, GstElement *element,
+    const gchar *name, const GValue *value, const gchar *value_str)
+{
+  prop_template_t pt = { NULL, G_VALUE_INIT, NULL };
+  element_template_t *et;
+  gint idx;
+
+  if (graph->tmpl == NULL || (idx = gst_parse_template_lookup (graph, element)) < 0)
+    return;
+
+  et = &g_array_index (graph->tmpl->elements, element_template_t, idx);
+  pt.name = g_strdup (name);
+  if (value) {
+    g_value_init (&pt.value, G_VALUE_TYPE (value));
+    g_value_copy (value, &pt.value);
+  } else {
+    pt.value_str = g_strdup (value_str);
   }
-  gst_parse_unescape (pos);
+  g_array_append_val (et->props, pt);
+}
+
+static void gst_parse_template_add_link (graph_t *graph, link_t *link)
+{
+  link_template_t *lt;
+  gint src, sink;
+  GSList *walk;
+
+  src = gst_parse_template_lookup (graph, link->src.element);
+  sink = gst_parse_template_lookup (graph, link->sink.element);
+  if (src < 0 || sink < 0)
+    return;
+
+  lt = g_slice_new0 (link_template_t);
+  lt->src = src;
+  lt->sink = sink;
+  for (walk = link->src.pads; walk; walk = walk->next)
+    lt->src_pads = g_slist_append (lt->src_pads, g_strdup (walk->data));
+  for (walk = link->sink.pads; walk; walk = walk->next)
+    lt->sink_pads = g_slist_append (lt->sink_pads, g_strdup (walk->data));
+  lt->caps = link->caps ? gst_caps_ref (link->caps) : NULL;
+  graph->tmpl->links = g_slist_append (graph->tmpl->links, lt);
+}
+
+/* sets the property @name of @element from the unescaped string @pos */
+static void gst_parse_element_set_value (GstElement *element, const gchar *name,
+    const gchar *pos, graph_t *graph)
+{
+  GParamSpec *pspec = NULL;
+  GValue v = { 0, };
+  GObject *target = NULL;
+  GType value_type;
+  gboolean direct = FALSE;
 
   if (GST_IS_CHILD_PROXY (element)) {
-    if (!gst_child_proxy_lookup (GST_CHILD_PROXY (element), value, &target, &pspec)) {
+    if (!gst_child_proxy_lookup (GST_CHILD_PROXY (element), name, &target, &pspec)) {
       /* do a delayed set */
-      gst_parse_add_delayed_set (element, value, pos);
+      gst_parse_add_delayed_set (element, (gchar *) name, (gchar *) pos);
+    } else {
+      direct = (target == G_OBJECT (element));
     }
   } else {
-    pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element), value);
+    pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element), name);
     if (pspec != NULL) {
       target = g_object_ref (element);
-      GST_CAT_LOG_OBJECT (GST_CAT_PIPELINE, target, "found %s property", value);
+      direct = TRUE;
+      GST_CAT_LOG_OBJECT (GST_CAT_PIPELINE, target, "found %s property", name);
     } else {
       SET_ERROR (graph->error, GST_PARSE_ERROR_NO_SUCH_PROPERTY, \
-          _("no property \"%s\" in element \"%s\""), value, \
+          _("no property \"%s\" in element \"%s\""), name, \
           GST_ELEMENT_NAME (element));
     }
   }
@@ -434,14 +486,19 @@ static void gst_parse_element_set (gchar *value, GstElement *element, graph_t *g
          g_value_set_object (&v, bin);
          got_value = TRUE;
        }
+       /* every instance needs its own bin */
+       direct = FALSE;
     }
     if (!got_value)
       goto error;
     g_object_set_property (target, pspec->name, &v);
   }
 
+  /* remember deserialized values, everything else is parsed again when
+   * instantiating a template */
+  gst_parse_template_add_prop (graph, element, name, direct ? &v : NULL, pos);
+
 out:
-  gst_parse_strfree (value);
   if (G_IS_VALUE (&v))
     g_value_unset (&v);
   if (target)
@@ -451,10 +508,43 @@ out:
 error:
   SET_ERROR (graph->error, GST_PARSE_ERROR_COULD_NOT_SET_PROPERTY,
          _("could not set property \"%s\" in element \"%s\" to \"%s\""),
-	 value, GST_ELEMENT_NAME (element), pos);
+	 name, GST_ELEMENT_NAME (element), pos);
   goto out;
 }
 
+static void gst_parse_element_set (gchar *value, GstElement *element, graph_t *graph)
+{
+  gchar *pos = value;
+
+  /* do nothing if assignment is for missing element */
+  if (element == NULL)
+    goto out;
+
+  /* parse the string, so the property name is null-terminated and pos points
+     to the beginning of the value */
+  while (!g_ascii_isspace (*pos) && (*pos != '=')) pos++;
+  if (*pos == '=') {
+    *pos = '\0';
+  } else {
+    *pos = '\0';
+    pos++;
+    while (g_ascii_isspace (*pos)) pos++;
+  }
+  pos++;
+  while (g_ascii_isspace (*pos)) pos++;
+  /* truncate a string if it is delimited with double quotes */
+  if (*pos == '"' && pos[strlen (pos) - 1] == '"') {
+    pos++;
+    pos[strlen (pos) - 1] = '\0';
+  }
+  gst_parse_unescape (pos);
+
+  gst_parse_element_set_value (element, value, pos, graph);
+
+out:
+  gst_parse_strfree (value);
+}
+
 static void gst_parse_free_reference (reference_t *rr)
 {
   if(rr->element) gst_object_unref(rr->element);
@@ -715,6 +805,7 @@ element:	IDENTIFIER     		      { $$ = gst_element_factory_make ($1, NULL);
 						  add_missing_element(graph, $1);
 						  SET_ERROR (graph->error, GST_PARSE_ERROR_NO_SUCH_ELEMENT, _("no element \"%s\""), $1);
 						}
+						gst_parse_template_add_element (graph, $$, GST_URI_UNKNOWN, NULL);
 						gst_parse_strfree ($1);
                                               }
 	|	element ASSIGNMENT	      { gst_parse_element_set ($2, $1, graph);
@@ -849,6 +940,7 @@ chain:	openchain link PARSE_URL	      { GstElement *element =
 						  SET_ERROR (graph->error, GST_PARSE_ERROR_NO_SUCH_ELEMENT,
 							  _("no sink element for URI \"%s\""), $3);
 						}
+						gst_parse_template_add_element (graph, element, GST_URI_SINK, $3);
 						$$ = $1;
 						$2->sink.element = element?gst_object_ref(element):NULL;
 						$2->src = $1->last;
@@ -868,6 +960,7 @@ openchain:
 						  SET_ERROR (graph->error, GST_PARSE_ERROR_NO_SUCH_ELEMENT,
 						    _("no source element for URI \"%s\""), $1);
 						}
+						gst_parse_template_add_element (graph, element, GST_URI_SRC, $1);
 						$$ = gst_parse_chain_new ();
 						/* g_print ("@%p: CHAINing srcURL\n", $$); */
 						$$->first.element = NULL;
@@ -995,8 +1088,17 @@ bin:	binopener assignments chainlist ')'   {
 						  g_slist_free ($2);
 						  $2 = NULL;
 						} else {
-						  for (walk = chain->elements; walk; walk = walk->next )
+						  gst_parse_template_add_element (graph, GST_ELEMENT (bin), GST_URI_UNKNOWN, NULL);
+						  for (walk = chain->elements; walk; walk = walk->next ) {
+						    if (graph->tmpl) {
+						      gint idx = gst_parse_template_lookup (graph, GST_ELEMENT (walk->data));
+
+						      if (idx >= 0)
+						        g_array_index (graph->tmpl->elements, element_template_t, idx).parent =
+						            graph->tmpl->elements->len - 1;
+						    }
 						    gst_bin_add (bin, GST_ELEMENT (walk->data));
+						  }
 						  g_slist_free (chain->elements);
 						  chain->elements = g_slist_prepend (NULL, bin);
 						}
@@ -1037,9 +1139,9 @@ yyerror (void *scanner, graph_t *graph, const char *s)
 }
 
 
-GstElement *
-priv_gst_parse_launch (const gchar *str, GError **error, GstParseContext *ctx,
-    GstParseFlags flags)
+static GstElement *
+gst_parse_launch_internal (const gchar *str, GError **error, GstParseContext *ctx,
+    GstParseFlags flags, GstParseTemplate *tmpl)
 {
   graph_t g;
   gchar *dstr;
@@ -1056,6 +1158,8 @@ priv_gst_parse_launch (const gchar *str, GError **error, GstParseContext *ctx,
   g.error = error;
   g.ctx = ctx;
   g.flags = flags;
+  g.tmpl = tmpl;
+  g.tmpl_index = tmpl ? g_hash_table_new (NULL, NULL) : NULL;
 
 #ifdef __GST_PARSE_TRACE
   GST_CAT_DEBUG (GST_CAT_PIPELINE, "TRACE: tracing enabled");
@@ -1107,11 +1211,16 @@ priv_gst_parse_launch (const gchar *str, GError **error, GstParseContext *ctx,
 
   /* put all elements in our bin if necessary */
   if(g.chain->elements->next){
+    const gchar *bin_factory;
+
     if (flags & GST_PARSE_FLAG_PLACE_IN_BIN)
-      bin = GST_BIN (gst_element_factory_make ("bin", NULL));
+      bin_factory = "bin";
     else
-      bin = GST_BIN (gst_element_factory_make ("pipeline", NULL));
+      bin_factory = "pipeline";
+    bin = GST_BIN (gst_element_factory_make (bin_factory, NULL));
     g_assert (bin);
+    if (tmpl)
+      tmpl->bin_factory = bin_factory;
 
     for (walk = g.chain->elements; walk; walk = walk->next) {
       if (walk->data != NULL)
@@ -1161,6 +1270,8 @@ priv_gst_parse_launch (const gchar *str, GError **error, GstParseContext *ctx,
        gst_parse_free_link (l);
        continue;
     }
+    if (tmpl)
+      gst_parse_template_add_link (&g, l);
     gst_parse_perform_link (l, &g);
   }
   g_slist_free (g.links);
@@ -1176,6 +1287,9 @@ out:
   }
 #endif /* __GST_PARSE_TRACE */
 
+  if (g.tmpl_index)
+    g_hash_table_destroy (g.tmpl_index);
+
   return ret;
 
 error1:
@@ -1193,3 +1307,189 @@ error1:
 
   goto out;
 }
+
+GstElement *
+priv_gst_parse_launch (const gchar *str, GError **error, GstParseContext *ctx,
+    GstParseFlags flags)
+{
+  return gst_parse_launch_internal (str, error, ctx, flags, NULL);
+}
+
+void
+priv_gst_parse_template_free (GstParseTemplate *tmpl)
+{
+  GSList *walk;
+  guint i, j;
+
+  for (i = 0; i < tmpl->elements->len; i++) {
+    element_template_t *et =
+        &g_array_index (tmpl->elements, element_template_t, i);
+
+    if (et->factory)
+      gst_object_unref (et->factory);
+    g_free (et->uri);
+    for (j = 0; j < et->props->len; j++) {
+      prop_template_t *pt = &g_array_index (et->props, prop_template_t, j);
+
+      g_free (pt->name);
+      if (G_IS_VALUE (&pt->value))
+        g_value_unset (&pt->value);
+      g_free (pt->value_str);
+    }
+    g_array_free (et->props, TRUE);
+  }
+  g_array_free (tmpl->elements, TRUE);
+
+  for (walk = tmpl->links; walk; walk = walk->next) {
+    link_template_t *lt = walk->data;
+
+    g_slist_free_full (lt->src_pads, g_free);
+    g_slist_free_full (lt->sink_pads, g_free);
+    if (lt->caps)
+      gst_caps_unref (lt->caps);
+    g_slice_free (link_template_t, lt);
+  }
+  g_slist_free (tmpl->links);
+
+  g_slice_free (GstParseTemplate, tmpl);
+}
+
+/* parses @str once, recording the element factories, the deserialized
+ * property values and the resolved links, so that instances can be created
+ * without going through the parser again */
+GstParseTemplate *
+priv_gst_parse_compile (const gchar *str, GError **error, GstParseContext *ctx,
+    GstParseFlags flags)
+{
+  GstParseTemplate *tmpl;
+  GError *err = NULL;
+  GstElement *element;
+
+  g_return_val_if_fail (str != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  tmpl = g_slice_new0 (GstParseTemplate);
+  tmpl->refcount = 1;
+  tmpl->flags = flags;
+  tmpl->elements = g_array_new (FALSE, TRUE, sizeof (element_template_t));
+
+  element = gst_parse_launch_internal (str, &err, ctx, flags, tmpl);
+
+  /* the prototype was only needed to resolve the description */
+  if (element)
+    gst_object_unref (gst_object_ref_sink (element));
+
+  /* a template must not replay a partially failed description */
+  if (err != NULL || element == NULL) {
+    if (err)
+      g_propagate_error (error, err);
+    priv_gst_parse_template_free (tmpl);
+    return NULL;
+  }
+
+  GST_CAT_DEBUG (GST_CAT_PIPELINE, "compiled \"%s\" to %u elements and %u links",
+      str, tmpl->elements->len, g_slist_length (tmpl->links));
+
+  return tmpl;
+}
+
+GstElement *
+priv_gst_parse_template_instantiate (GstParseTemplate *tmpl, GError **error)
+{
+  graph_t g = { NULL, };
+  GstElement **elements, *ret = NULL;
+  GSList *walk;
+  guint i, j, n;
+
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  g.error = error;
+  g.flags = tmpl->flags;
+
+  n = tmpl->elements->len;
+  elements = g_new0 (GstElement *, n);
+
+  for (i = 0; i < n; i++) {
+    element_template_t *et =
+        &g_array_index (tmpl->elements, element_template_t, i);
+    GstElement *element;
+
+    if (et->uri)
+      element = gst_element_make_from_uri (et->uri_type, et->uri, NULL, NULL);
+    else
+      element = gst_element_factory_create (et->factory, NULL);
+
+    if (element == NULL) {
+      SET_ERROR (error, GST_PARSE_ERROR_NO_SUCH_ELEMENT,
+          _("could not create element \"%s\""),
+          et->uri ? et->uri : GST_OBJECT_NAME (et->factory));
+      goto error;
+    }
+    elements[i] = element;
+
+    /* children were created first, add them before the properties of the
+     * bin are set, like the parser does */
+    for (j = 0; j < i; j++) {
+      if (g_array_index (tmpl->elements, element_template_t, j).parent == (gint) i)
+        gst_bin_add (GST_BIN (element), elements[j]);
+    }
+
+    for (j = 0; j < et->props->len; j++) {
+      prop_template_t *pt = &g_array_index (et->props, prop_template_t, j);
+
+      if (pt->value_str)
+        gst_parse_element_set_value (element, pt->name, pt->value_str, &g);
+      else
+        g_object_set_property (G_OBJECT (element), pt->name, &pt->value);
+    }
+  }
+
+  if (tmpl->bin_factory) {
+    ret = gst_element_factory_make (tmpl->bin_factory, NULL);
+    g_assert (ret);
+    for (i = 0; i < n; i++) {
+      if (g_array_index (tmpl->elements, element_template_t, i).parent < 0)
+        gst_bin_add (GST_BIN (ret), elements[i]);
+    }
+  } else {
+    for (i = 0; i < n && ret == NULL; i++) {
+      if (g_array_index (tmpl->elements, element_template_t, i).parent < 0)
+        ret = elements[i];
+    }
+  }
+
+  for (walk = tmpl->links; walk; walk = walk->next) {
+    link_template_t *lt = walk->data;
+    link_t *l = gst_parse_link_new ();
+    GSList *pads;
+
+    l->src.element = gst_object_ref (elements[lt->src]);
+    l->src.name = NULL;
+    l->src.pads = NULL;
+    for (pads = lt->src_pads; pads; pads = pads->next)
+      l->src.pads = g_slist_append (l->src.pads, gst_parse_strdup (pads->data));
+    l->sink.element = gst_object_ref (elements[lt->sink]);
+    l->sink.name = NULL;
+    l->sink.pads = NULL;
+    for (pads = lt->sink_pads; pads; pads = pads->next)
+      l->sink.pads = g_slist_append (l->sink.pads, gst_parse_strdup (pads->data));
+    l->caps = lt->caps ? gst_caps_ref (lt->caps) : NULL;
+    gst_parse_perform_link (l, &g);
+  }
+
+  g_free (elements);
+
+  return ret;
+
+error:
+  /* only unref the elements that are not owned by a bin yet */
+  for (i = 0; i < n; i++) {
+    gint parent = g_array_index (tmpl->elements, element_template_t, i).parent;
+
+    if (elements[i] && (parent < 0 || elements[parent] == NULL))
+      gst_object_unref (elements[i]);
+  }
+  g_free (elements);
+
+  return NULL;
+}
@@ -23,6 +23,43 @@ typedef struct {
   reference_t last;
 } chain_t;
 
+/* a property assignment of a compiled element. Values that can be
+ * deserialized directly are stored in value, the others (child proxy
+ * properties, element-typed properties) are kept as string in value_str
+ * and parsed again for each instance */
+typedef struct {
+  gchar *name;
+  GValue value;
+  gchar *value_str;
+} prop_template_t;
+
+typedef struct {
+  GstElementFactory *factory; /* NULL for elements created from an URI */
+  GstURIType uri_type;
+  gchar *uri;
+  gint parent; /* index of the containing bin, -1 for toplevel elements */
+  GArray *props; /* prop_template_t in assignment order */
+} element_template_t;
+
+typedef struct {
+  guint src;
+  guint sink;
+  GSList *src_pads;
+  GSList *sink_pads;
+  GstCaps *caps;
+} link_template_t;
+
+struct _GstParseTemplate {
+  gint refcount;
+  GstParseFlags flags;
+  /* element_template_t in creation order, children come before their bin */
+  GArray *elements;
+  GSList *links; /* link_template_t */
+  /* factory of the bin holding the toplevel elements, NULL if there is only
+   * one toplevel element */
+  const gchar *bin_factory;
+};
+
 typedef struct _graph_t graph_t;
 struct _graph_t {
   chain_t *chain; /* links are supposed to be done now */
@@ -30,6 +67,8 @@ struct _graph_t {
   GError **error;
   GstParseContext *ctx; /* may be NULL */
   GstParseFlags flags;
+  GstParseTemplate *tmpl; /* only set when compiling */
+  GHashTable *tmpl_index; /* element -> index in tmpl->elements + 1 */
 };
 
 
@@ -106,4 +145,14 @@ G_GNUC_INTERNAL GstElement *priv_gst_parse_launch (const gchar      * str,
                                                    GstParseContext  * ctx,
                                                    GstParseFlags      flags);
 
+G_GNUC_INTERNAL GstParseTemplate *priv_gst_parse_compile (const gchar      * str,
+                                                          GError          ** err,
+                                                          GstParseContext  * ctx,
+                                                          GstParseFlags      flags);
+
+G_GNUC_INTERNAL GstElement *priv_gst_parse_template_instantiate (GstParseTemplate * tmpl,
+                                                                 GError          ** err);
+
+G_GNUC_INTERNAL void priv_gst_parse_template_free (GstParseTemplate * tmpl);
+
 #endif /* __GST_PARSE_TYPES_H__ */
@@ -148,6 +148,9 @@ struct _GstAdapter
   GSList *scan_entry;
 
   GstMapInfo info;
+
+  /* GstMapInfo of the memories mapped with gst_adapter_map_chunks() */
+  GArray *chunk_infos;
 };
 
 struct _GstAdapterClass
@@ -199,6 +202,8 @@ gst_adapter_finalize (GObject * object)
   GstAdapter *adapter = GST_ADAPTER (object);
 
   g_free (adapter->assembled_data);
+  if (adapter->chunk_infos)
+    g_array_free (adapter->chunk_infos, TRUE);
 
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
 }
@@ -229,6 +234,7 @@ gst_adapter_clear (GstAdapter * adapter)
 
   if (adapter->info.memory)
     gst_adapter_unmap (adapter);
+  gst_adapter_unmap_chunks (adapter);
 
   g_slist_foreach (adapter->buflist, (GFunc) gst_mini_object_unref, NULL);
   g_slist_free (adapter->buflist);
@@ -526,6 +532,141 @@ gst_adapter_unmap (GstAdapter * adapter)
   }
 }
 
+/**
+ * gst_adapter_map_chunks:
+ * @adapter: a #GstAdapter
+ * @offset: the bytes offset in the adapter to start from
+ * @size: the number of bytes to map
+ * @data: (out caller-allocates) (array length=n_chunks): array that receives
+ *     the start of each chunk
+ * @sizes: (out caller-allocates) (array length=n_chunks): array that receives
+ *     the size of each chunk
+ * @n_chunks: the number of elements in @data and @sizes
+ *
+ * Maps @size bytes starting at @offset without merging them. Each chunk is
+ * a contiguous range of one of the #GstMemory in the adapter, so parsers
+ * that can deal with discontiguous data avoid the copy gst_adapter_map()
+ * has to make when the range spans several memories.
+ *
+ * The chunks remain valid until gst_adapter_unmap_chunks() is called, which
+ * must happen before the adapter is modified again.
+ *
+ * Returns: the number of chunks, or -1 when @size bytes are not available,
+ *     the range spans more than @n_chunks memories or mapping failed.
+ *
+ * Since: 1.10
+ */
+gint
+gst_adapter_map_chunks (GstAdapter * adapter, gsize offset, gsize size,
+    const guint8 ** data, gsize * sizes, guint n_chunks)
+{
+  GSList *g;
+  GstBuffer *buf;
+  GstMemory *mem;
+  GstMapInfo info;
+  gsize skip, bsize, left, msize;
+  guint i, n_mem, n = 0;
+
+  g_return_val_if_fail (GST_IS_ADAPTER (adapter), -1);
+  g_return_val_if_fail (size > 0, -1);
+  g_return_val_if_fail (data != NULL && sizes != NULL, -1);
+  g_return_val_if_fail (adapter->chunk_infos == NULL ||
+      adapter->chunk_infos->len == 0, -1);
+
+  if (offset + size > adapter->size)
+    return -1;
+
+  if (adapter->chunk_infos == NULL)
+    adapter->chunk_infos = g_array_new (FALSE, FALSE, sizeof (GstMapInfo));
+
+  /* position on the first buffer */
+  skip = offset + adapter->skip;
+  g = adapter->buflist;
+  buf = g->data;
+  bsize = gst_buffer_get_size (buf);
+  while (skip >= bsize) {
+    skip -= bsize;
+    g = g_slist_next (g);
+    buf = g->data;
+    bsize = gst_buffer_get_size (buf);
+  }
+
+  left = size;
+  while (left > 0) {
+    n_mem = gst_buffer_n_memory (buf);
+    for (i = 0; i < n_mem && left > 0; i++) {
+      mem = gst_buffer_peek_memory (buf, i);
+      if (skip >= mem->size) {
+        skip -= mem->size;
+        continue;
+      }
+
+      if (n == n_chunks)
+        goto too_many_chunks;
+      if (!gst_memory_map (mem, &info, GST_MAP_READ))
+        goto map_failed;
+      g_array_append_val (adapter->chunk_infos, info);
+
+      msize = MIN (info.size - skip, left);
+      data[n] = info.data + skip;
+      sizes[n] = msize;
+      n++;
+
+      left -= msize;
+      skip = 0;
+    }
+    if (left > 0) {
+      g = g_slist_next (g);
+      buf = g->data;
+    }
+  }
+
+  GST_LOG_OBJECT (adapter, "mapped %" G_GSIZE_FORMAT " bytes at offset %"
+      G_GSIZE_FORMAT " in %u chunks", size, offset, n);
+
+  return n;
+
+  /* ERRORS */
+too_many_chunks:
+  {
+    GST_LOG_OBJECT (adapter, "range spans more than %u chunks", n_chunks);
+    gst_adapter_unmap_chunks (adapter);
+    return -1;
+  }
+map_failed:
+  {
+    GST_WARNING_OBJECT (adapter, "failed to map memory %p", mem);
+    gst_adapter_unmap_chunks (adapter);
+    return -1;
+  }
+}
+
+/**
+ * gst_adapter_unmap_chunks:
+ * @adapter: a #GstAdapter
+ *
+ * Releases the memory mapped with the last gst_adapter_map_chunks().
+ *
+ * Since: 1.10
+ */
+void
+gst_adapter_unmap_chunks (GstAdapter * adapter)
+{
+  guint i;
+
+  g_return_if_fail (GST_IS_ADAPTER (adapter));
+
+  if (adapter->chunk_infos == NULL)
+    return;
+
+  for (i = 0; i < adapter->chunk_infos->len; i++) {
+    GstMapInfo *info = &g_array_index (adapter->chunk_infos, GstMapInfo, i);
+
+    gst_memory_unmap (info->memory, info);
+  }
+  g_array_set_size (adapter->chunk_infos, 0);
+}
+
 /**
  * gst_adapter_copy: (skip)
  * @adapter: a #GstAdapter
@@ -1461,6 +1602,52 @@ gst_adapter_prev_dts_at_offset (GstAdapter * adapter, gsize offset,
   return dts;
 }
 
+/* Finds a byte of @pattern that has to match exactly, preferably a non-zero
+ * one as zeroes are very common in media data. Returns its position from the
+ * start of the pattern or -1 */
+static gint
+gst_adapter_scan_key_pos (guint32 mask, guint32 pattern, guint8 * key)
+{
+  gint i, pos = -1;
+
+  for (i = 0; i < 4; i++) {
+    guint shift = 24 - 8 * i;
+
+    if (((mask >> shift) & 0xff) != 0xff)
+      continue;
+
+    if (pos == -1 || ((pattern >> shift) & 0xff) != 0) {
+      pos = i;
+      *key = (pattern >> shift) & 0xff;
+      if (*key != 0)
+        break;
+    }
+  }
+  return pos;
+}
+
+/* Returns the position of the first match that lies completely in @data.
+ * Candidates are found with memchr(), which is vectorized in the C library,
+ * instead of shifting every byte through the state */
+static gssize
+gst_adapter_scan_chunk (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern, gint key_pos, guint8 key)
+{
+  const guint8 *p, *end;
+
+  p = data + key_pos;
+  end = data + size - 3 + key_pos;
+  while (p < end) {
+    p = memchr (p, key, end - p);
+    if (p == NULL)
+      break;
+    if ((GST_READ_UINT32_BE (p - key_pos) & mask) == pattern)
+      return p - key_pos - data;
+    p++;
+  }
+  return -1;
+}
+
 /**
  * gst_adapter_masked_scan_uint32_peek:
  * @adapter: a #GstAdapter
@@ -1489,11 +1676,14 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
     guint32 pattern, gsize offset, gsize size, guint32 * value)
 {
   GSList *g;
-  gsize skip, bsize, i;
+  gsize skip, bsize, i, limit;
+  gssize found;
   guint32 state;
   GstMapInfo info;
   guint8 *bdata;
   GstBuffer *buf;
+  gint key_pos;
+  guint8 key = 0;
 
   g_return_val_if_fail (size > 0, -1);
   g_return_val_if_fail (offset + size <= adapter->size, -1);
@@ -1536,10 +1726,19 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
   /* set the state to something that does not match */
   state = ~pattern;
 
+  key_pos = gst_adapter_scan_key_pos (mask, pattern, &key);
+
   /* now find data */
   do {
     bsize = MIN (bsize, size);
-    for (i = 0; i < bsize; i++) {
+    /* with a key byte, only the matches that start in the previous buffer
+     * are checked bytewise */
+    if (key_pos >= 0 && bsize >= 4)
+      limit = 3;
+    else
+      limit = bsize;
+
+    for (i = 0; i < limit; i++) {
       state = ((state << 8) | bdata[i]);
       if (G_UNLIKELY ((state & mask) == pattern)) {
         /* we have a match but we need to have skipped at
@@ -1552,6 +1751,17 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
         }
       }
     }
+    if (limit < bsize) {
+      found =
+          gst_adapter_scan_chunk (bdata, bsize, mask, pattern, key_pos, key);
+      if (found != -1) {
+        if (G_LIKELY (value))
+          *value = GST_READ_UINT32_BE (bdata + found);
+        gst_buffer_unmap (buf, &info);
+        return offset + skip + found;
+      }
+      state = GST_READ_UINT32_BE (bdata + bsize - 4);
+    }
     size -= bsize;
     if (size == 0)
       break;
@@ -54,6 +54,10 @@ void                    gst_adapter_clear               (GstAdapter *adapter);
 void                    gst_adapter_push                (GstAdapter *adapter, GstBuffer* buf);
 gconstpointer           gst_adapter_map                 (GstAdapter *adapter, gsize size);
 void                    gst_adapter_unmap               (GstAdapter *adapter);
+gint                    gst_adapter_map_chunks          (GstAdapter *adapter, gsize offset,
+                                                         gsize size, const guint8 **data,
+                                                         gsize *sizes, guint n_chunks);
+void                    gst_adapter_unmap_chunks        (GstAdapter *adapter);
 void                    gst_adapter_copy                (GstAdapter *adapter, gpointer dest,
                                                          gsize offset, gsize size);
 GBytes *                gst_adapter_copy_bytes          (GstAdapter *adapter,
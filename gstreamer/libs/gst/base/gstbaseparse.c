@@ -206,6 +206,7 @@
 #include <string.h>
 
 #include <gst/base/gstadapter.h>
+#include <gst/base/gstbytewriter.h>
 
 #include "gstbaseparse.h"
 
@@ -306,6 +307,8 @@ struct _GstBaseParsePrivate
   gint index_id;
   gboolean own_index;
   GMutex index_lock;
+  /* index from gst_base_parse_import_index(), added to each new index */
+  GstBuffer *imported_index;
 
   /* seek table entries only maintained if upstream is BYTE seekable */
   gboolean upstream_seekable;
@@ -543,6 +546,7 @@ gst_base_parse_finalize (GObject * object)
     gst_object_unref (parse->priv->index);
     parse->priv->index = NULL;
   }
+  gst_buffer_replace (&parse->priv->imported_index, NULL);
   g_mutex_clear (&parse->priv->index_lock);
 
   gst_base_parse_clear_queues (parse);
@@ -1956,6 +1960,173 @@ exit:
   return ret;
 }
 
+/* serialized index: magic, version, then big-endian time/offset pairs */
+#define INDEX_MAGIC        GST_MAKE_FOURCC ('B', 'P', 'I', 'X')
+#define INDEX_VERSION      1
+#define INDEX_HEADER_SIZE  8
+#define INDEX_ENTRY_SIZE   16
+
+static gboolean
+gst_base_parse_export_entry (gpointer key, gpointer value, gpointer user_data)
+{
+  GstIndexEntry *entry = value;
+  GstByteWriter *bw = user_data;
+  gint64 ts, offset;
+
+  if (!(GST_INDEX_ASSOC_FLAGS (entry) & GST_INDEX_ASSOCIATION_FLAG_KEY_UNIT))
+    return FALSE;
+
+  if (gst_index_entry_assoc_map (entry, GST_FORMAT_TIME, &ts) &&
+      gst_index_entry_assoc_map (entry, GST_FORMAT_BYTES, &offset)) {
+    gst_byte_writer_put_uint64_be (bw, ts);
+    gst_byte_writer_put_uint64_be (bw, offset);
+  }
+  return FALSE;
+}
+
+/**
+ * gst_base_parse_export_index:
+ * @parse: a #GstBaseParse
+ *
+ * Serializes the keyframe entries of the seek index that @parse built so far
+ * into a compact, sorted table. Applications can store it together with the
+ * media file and pass it to gst_base_parse_import_index() when the file is
+ * opened again, so that seeking in streams without a seek table, like raw
+ * elementary streams, doesn't need to scan the data.
+ *
+ * The format of the data is private to #GstBaseParse but stable across
+ * versions that can read it.
+ *
+ * Returns: (transfer full) (nullable): a #GstBuffer with the index, or
+ *     %NULL if @parse has no index.
+ *
+ * Since: 1.10
+ */
+GstBuffer *
+gst_base_parse_export_index (GstBaseParse * parse)
+{
+  GstMemIndexFormatIndex *format_index = NULL;
+  GstMemIndexId *id_index = NULL;
+  GstByteWriter bw;
+  GstFormat format = GST_FORMAT_TIME;
+
+  g_return_val_if_fail (GST_IS_BASE_PARSE (parse), NULL);
+
+  GST_BASE_PARSE_INDEX_LOCK (parse);
+  if (parse->priv->index == NULL)
+    goto no_index;
+
+  id_index = g_hash_table_lookup (GST_MEM_INDEX (parse->priv->index)->id_index,
+      &parse->priv->index_id);
+  if (id_index)
+    format_index = g_hash_table_lookup (id_index->format_index, &format);
+
+  gst_byte_writer_init (&bw);
+  gst_byte_writer_put_uint32_be (&bw, INDEX_MAGIC);
+  gst_byte_writer_put_uint32_be (&bw, INDEX_VERSION);
+  /* the tree is sorted by time */
+  if (format_index)
+    g_tree_foreach (format_index->tree, gst_base_parse_export_entry, &bw);
+  GST_BASE_PARSE_INDEX_UNLOCK (parse);
+
+  GST_DEBUG_OBJECT (parse, "exported %u index entries",
+      (gst_byte_writer_get_size (&bw) - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE);
+
+  return gst_byte_writer_reset_and_get_buffer (&bw);
+
+  /* ERRORS */
+no_index:
+  {
+    GST_BASE_PARSE_INDEX_UNLOCK (parse);
+    GST_DEBUG_OBJECT (parse, "no index to export");
+    return NULL;
+  }
+}
+
+/* call with the index lock */
+static void
+gst_base_parse_add_imported_index (GstBaseParse * parse)
+{
+  GstIndexAssociation associations[2];
+  GstMapInfo map;
+  gsize i;
+
+  if (parse->priv->imported_index == NULL || parse->priv->index == NULL)
+    return;
+
+  gst_buffer_map (parse->priv->imported_index, &map, GST_MAP_READ);
+  for (i = INDEX_HEADER_SIZE; i + INDEX_ENTRY_SIZE <= map.size;
+      i += INDEX_ENTRY_SIZE) {
+    associations[0].format = GST_FORMAT_TIME;
+    associations[0].value = GST_READ_UINT64_BE (map.data + i);
+    associations[1].format = GST_FORMAT_BYTES;
+    associations[1].value = GST_READ_UINT64_BE (map.data + i + 8);
+
+    gst_index_add_associationv (parse->priv->index, parse->priv->index_id,
+        GST_INDEX_ASSOCIATION_FLAG_KEY_UNIT, 2,
+        (const GstIndexAssociation *) &associations);
+  }
+  GST_DEBUG_OBJECT (parse, "imported %" G_GSIZE_FORMAT " index entries",
+      (map.size - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE);
+  gst_buffer_unmap (parse->priv->imported_index, &map);
+
+  /* entries added while streaming need to be checked against the imported
+   * ones, like after a seek */
+  parse->priv->index_last_valid = FALSE;
+  parse->priv->index_last_offset = 0;
+  parse->priv->index_last_ts = 0;
+}
+
+/**
+ * gst_base_parse_import_index:
+ * @parse: a #GstBaseParse
+ * @index: (allow-none): an index from gst_base_parse_export_index(), or
+ *     %NULL to forget a previously imported index
+ *
+ * Seeds the seek index of @parse with the entries of @index, which was
+ * exported earlier for the same stream. The entries are added right away
+ * when @parse is PAUSED or PLAYING, and to the new index created on every
+ * READY to PAUSED state change until a different index is imported.
+ *
+ * It is up to the application to only import indexes that belong to the
+ * stream that is being parsed.
+ *
+ * Returns: %TRUE if @index could be parsed.
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_base_parse_import_index (GstBaseParse * parse, GstBuffer * index)
+{
+  guint8 header[INDEX_HEADER_SIZE];
+
+  g_return_val_if_fail (GST_IS_BASE_PARSE (parse), FALSE);
+  g_return_val_if_fail (index == NULL || GST_IS_BUFFER (index), FALSE);
+
+  if (index) {
+    if (gst_buffer_extract (index, 0, header,
+            INDEX_HEADER_SIZE) != INDEX_HEADER_SIZE)
+      goto invalid_index;
+    if (GST_READ_UINT32_BE (header) != INDEX_MAGIC ||
+        GST_READ_UINT32_BE (header + 4) != INDEX_VERSION)
+      goto invalid_index;
+  }
+
+  GST_BASE_PARSE_INDEX_LOCK (parse);
+  gst_buffer_replace (&parse->priv->imported_index, index);
+  gst_base_parse_add_imported_index (parse);
+  GST_BASE_PARSE_INDEX_UNLOCK (parse);
+
+  return TRUE;
+
+  /* ERRORS */
+invalid_index:
+  {
+    GST_WARNING_OBJECT (parse, "invalid index data");
+    return FALSE;
+  }
+}
+
 /* check for seekable upstream, above and beyond a mere query */
 static void
 gst_base_parse_check_seekability (GstBaseParse * parse)
@@ -4804,6 +4975,7 @@ gst_base_parse_change_state (GstElement * element, GstStateChange transition)
         gst_index_get_writer_id (parse->priv->index, GST_OBJECT (parse),
             &parse->priv->index_id);
         parse->priv->own_index = TRUE;
+        gst_base_parse_add_imported_index (parse);
       }
       GST_BASE_PARSE_INDEX_UNLOCK (parse);
       break;
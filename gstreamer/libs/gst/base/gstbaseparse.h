@@ -342,6 +342,11 @@ gboolean        gst_base_parse_add_index_entry (GstBaseParse * parse,
                                                 gboolean       key,
                                                 gboolean       force);
 
+GstBuffer *     gst_base_parse_export_index    (GstBaseParse * parse);
+
+gboolean        gst_base_parse_import_index    (GstBaseParse * parse,
+                                                GstBuffer    * index);
+
 void            gst_base_parse_set_ts_at_offset (GstBaseParse *parse,
                                                  gsize offset);
 
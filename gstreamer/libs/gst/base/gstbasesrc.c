@@ -269,6 +269,9 @@ struct _GstBaseSrcPrivate
   GstAllocationParams params;
 
   GCond async_cond;
+
+  /* buffer list submitted from the create function (with LIVE_LOCK) */
+  GstBufferList *pending_bufferlist;
 };
 
 static GstElementClass *parent_class = NULL;
@@ -2397,6 +2400,45 @@ unexpected_length:
   }
 }
 
+static void
+gst_base_src_clear_pending_list (GstBaseSrc * src)
+{
+  if (src->priv->pending_bufferlist != NULL) {
+    gst_buffer_list_unref (src->priv->pending_bufferlist);
+    src->priv->pending_bufferlist = NULL;
+  }
+}
+
+/* returns the first buffer of the pending buffer list, made writable. The
+ * list keeps the reference. */
+static GstBuffer *
+gst_base_src_pending_list_get_first (GstBaseSrc * src)
+{
+  GstBufferList *list;
+  GstBuffer *buf;
+
+  list = gst_buffer_list_make_writable (src->priv->pending_bufferlist);
+  src->priv->pending_bufferlist = list;
+
+  buf = gst_buffer_list_get (list, 0);
+  if (!gst_buffer_is_writable (buf)) {
+    buf = gst_buffer_copy (buf);
+    gst_buffer_list_remove (list, 0, 1);
+    gst_buffer_list_insert (list, 0, buf);
+  }
+  return buf;
+}
+
+/* get rid of the result of the create function */
+static void
+gst_base_src_drop_result (GstBaseSrc * src, GstBuffer * res_buf)
+{
+  if (src->priv->pending_bufferlist != NULL)
+    gst_base_src_clear_pending_list (src);
+  else
+    gst_buffer_unref (res_buf);
+}
+
 /* must be called with LIVE_LOCK */
 static GstFlowReturn
 gst_base_src_get_range (GstBaseSrc * src, guint64 offset, guint length,
@@ -2458,20 +2500,31 @@ again:
 
   ret = bclass->create (src, offset, length, &res_buf);
 
+  /* If the buffer is NULL but a buffer list was submitted, the first buffer
+   * of the list is used for the timestamping and syncing below */
+  if (ret == GST_FLOW_OK && res_buf == NULL
+      && src->priv->pending_bufferlist != NULL) {
+    if (G_UNLIKELY (in_buf != NULL))
+      goto list_in_pull_mode;
+    res_buf = gst_base_src_pending_list_get_first (src);
+  }
+
   /* The create function could be unlocked because we have a pending EOS. It's
    * possible that we have a valid buffer from create that we need to
    * discard when the create function returned _OK. */
   if (G_UNLIKELY (g_atomic_int_get (&src->priv->has_pending_eos))) {
     if (ret == GST_FLOW_OK) {
       if (*buf == NULL)
-        gst_buffer_unref (res_buf);
+        gst_base_src_drop_result (src, res_buf);
     }
     src->priv->forced_eos = TRUE;
     goto eos;
   }
 
-  if (G_UNLIKELY (ret != GST_FLOW_OK))
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    gst_base_src_clear_pending_list (src);
     goto not_ok;
+  }
 
   /* fallback in case the create function didn't fill a provided buffer */
   if (in_buf != NULL && res_buf != in_buf) {
@@ -2498,7 +2551,10 @@ again:
   if (offset == 0 && src->segment.time == 0
       && GST_BUFFER_DTS (res_buf) == -1 && !src->is_live) {
     GST_DEBUG_OBJECT (src, "setting first timestamp to 0");
-    res_buf = gst_buffer_make_writable (res_buf);
+    if (src->priv->pending_bufferlist != NULL)
+      res_buf = gst_base_src_pending_list_get_first (src);
+    else
+      res_buf = gst_buffer_make_writable (res_buf);
     GST_BUFFER_DTS (res_buf) = 0;
   }
 
@@ -2523,7 +2579,7 @@ again:
        * it got unlocked because we did a state change. In any case, get rid of
        * the buffer. */
       if (*buf == NULL)
-        gst_buffer_unref (res_buf);
+        gst_base_src_drop_result (src, res_buf);
 
       if (!src->live_running) {
         /* We return FLUSHING when we are not running to stop the dataflow also
@@ -2545,7 +2601,7 @@ again:
           (_("Internal clock error.")),
           ("clock returned unexpected return value %d", status));
       if (*buf == NULL)
-        gst_buffer_unref (res_buf);
+        gst_base_src_drop_result (src, res_buf);
       ret = GST_FLOW_ERROR;
       break;
   }
@@ -2573,7 +2629,14 @@ map_failed:
         (_("Failed to map buffer.")),
         ("failed to map result buffer in WRITE mode"));
     if (*buf == NULL)
-      gst_buffer_unref (res_buf);
+      gst_base_src_drop_result (src, res_buf);
+    return GST_FLOW_ERROR;
+  }
+list_in_pull_mode:
+  {
+    GST_ELEMENT_ERROR (src, CORE, FAILED, (NULL),
+        ("Subclass submitted a buffer list in pull mode"));
+    gst_base_src_clear_pending_list (src);
     return GST_FLOW_ERROR;
   }
 not_started:
@@ -2601,7 +2664,7 @@ flushing:
   {
     GST_DEBUG_OBJECT (src, "we are flushing");
     if (*buf == NULL)
-      gst_buffer_unref (res_buf);
+      gst_base_src_drop_result (src, res_buf);
     return GST_FLOW_FLUSHING;
   }
 eos:
@@ -2668,6 +2731,7 @@ gst_base_src_loop (GstPad * pad)
 {
   GstBaseSrc *src;
   GstBuffer *buf = NULL;
+  GstBufferList *buffer_list;
   GstFlowReturn ret;
   gint64 position;
   gboolean eos;
@@ -2777,6 +2841,14 @@ gst_base_src_loop (GstPad * pad)
     {
       guint bufsize = gst_buffer_get_size (buf);
 
+      if (src->priv->pending_bufferlist != NULL) {
+        GstBufferList *list = src->priv->pending_bufferlist;
+        guint i, len = gst_buffer_list_length (list);
+
+        for (i = 1; i < len; i++)
+          bufsize += gst_buffer_get_size (gst_buffer_list_get (list, i));
+      }
+
       /* we subtracted above for negative rates */
       if (src->segment.rate >= 0.0)
         position += bufsize;
@@ -2840,13 +2912,21 @@ gst_base_src_loop (GstPad * pad)
 
   if (G_UNLIKELY (src->priv->discont)) {
     GST_INFO_OBJECT (src, "marking pending DISCONT");
-    buf = gst_buffer_make_writable (buf);
+    if (src->priv->pending_bufferlist != NULL)
+      buf = gst_base_src_pending_list_get_first (src);
+    else
+      buf = gst_buffer_make_writable (buf);
     GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
     src->priv->discont = FALSE;
   }
+  buffer_list = src->priv->pending_bufferlist;
+  src->priv->pending_bufferlist = NULL;
   GST_LIVE_UNLOCK (src);
 
-  ret = gst_pad_push (pad, buf);
+  if (buffer_list != NULL)
+    ret = gst_pad_push_list (pad, buffer_list);
+  else
+    ret = gst_pad_push (pad, buf);
   if (G_UNLIKELY (ret != GST_FLOW_OK)) {
     if (ret == GST_FLOW_NOT_NEGOTIATED) {
       goto not_negotiated;
@@ -3554,6 +3634,9 @@ gst_base_src_stop (GstBaseSrc * basesrc)
 
   gst_base_src_set_allocation (basesrc, NULL, NULL, NULL);
 
+  /* the streaming thread is stopped, nothing will push this anymore */
+  gst_base_src_clear_pending_list (basesrc);
+
   return result;
 
 was_stopped:
@@ -3906,3 +3989,41 @@ gst_base_src_get_allocator (GstBaseSrc * src,
   if (params)
     *params = src->priv->params;
 }
+
+/**
+ * gst_base_src_submit_buffer_list:
+ * @src: a #GstBaseSrc
+ * @buffer_list: (transfer full): a #GstBufferList
+ *
+ * Subclasses can call this from their create virtual method implementation
+ * to submit a buffer list to be pushed out later. This is useful in
+ * cases where the create function wants to produce multiple buffers to be
+ * pushed out in one go in form of a #GstBufferList, which can reduce overhead
+ * drastically, especially for packetised inputs (for data streams where
+ * the packetisation/chunking is not important it is usually more efficient
+ * to return larger buffers instead).
+ *
+ * Subclasses that use this function from their create function must return
+ * %GST_FLOW_OK and no buffer from their create virtual method implementation.
+ * If a buffer is returned after a buffer list has also been submitted via this
+ * function the behaviour is undefined.
+ *
+ * Subclasses must only call this function once per create function call and
+ * subclasses must only call this function when the source operates in push
+ * mode.
+ *
+ * Since: 1.10
+ */
+void
+gst_base_src_submit_buffer_list (GstBaseSrc * src, GstBufferList * buffer_list)
+{
+  g_return_if_fail (GST_IS_BASE_SRC (src));
+  g_return_if_fail (GST_IS_BUFFER_LIST (buffer_list));
+  g_return_if_fail (gst_buffer_list_length (buffer_list) > 0);
+  g_return_if_fail (src->priv->pending_bufferlist == NULL);
+
+  src->priv->pending_bufferlist = buffer_list;
+
+  GST_LOG_OBJECT (src, "%u buffers submitted in buffer list",
+      gst_buffer_list_length (buffer_list));
+}
@@ -341,6 +341,8 @@ static GstFlowReturn gst_base_transform_getrange (GstPad * pad,
     GstObject * parent, guint64 offset, guint length, GstBuffer ** buffer);
 static GstFlowReturn gst_base_transform_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer);
+static GstFlowReturn gst_base_transform_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static GstCaps *gst_base_transform_default_transform_caps (GstBaseTransform *
     trans, GstPadDirection direction, GstCaps * caps, GstCaps * filter);
 static GstCaps *gst_base_transform_default_fixate_caps (GstBaseTransform *
@@ -452,6 +454,8 @@ gst_base_transform_init (GstBaseTransform * trans,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_event));
   gst_pad_set_chain_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_chain));
+  gst_pad_set_chain_list_function (trans->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_base_transform_chain_list));
   gst_pad_set_activatemode_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_activate_mode));
   gst_pad_set_query_function (trans->sinkpad,
@@ -2385,6 +2389,151 @@ done:
   return ret;
 }
 
+static gboolean
+gst_base_transform_list_prepare_func (GstBuffer ** buffer, guint idx,
+    gpointer user_data)
+{
+  GstBaseTransform *trans = user_data;
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+
+  if (klass->before_transform)
+    klass->before_transform (trans, *buffer);
+
+  if (GST_BUFFER_IS_DISCONT (*buffer)) {
+    GST_DEBUG_OBJECT (trans, "got DISCONT buffer %p", *buffer);
+    trans->priv->discont = TRUE;
+  }
+
+  if (!trans->priv->passthrough)
+    *buffer = gst_buffer_make_writable (*buffer);
+
+  return TRUE;
+}
+
+/* Handles a whole buffer list when nothing has to be done per buffer in
+ * between, which is the case for passthrough and for in-place transforms
+ * that implement transform_ip_list. Otherwise the list is split and each
+ * buffer goes through the normal chain function. */
+static GstFlowReturn
+gst_base_transform_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM (parent);
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstClockTime position = GST_CLOCK_TIME_NONE;
+  GstBuffer *buffer;
+  gboolean qos_active, transform;
+  guint i, len;
+
+  if (klass->submit_input_buffer != default_submit_input_buffer ||
+      klass->generate_output != default_generate_output ||
+      klass->prepare_output_buffer != default_prepare_output_buffer)
+    goto split;
+
+  if (G_UNLIKELY (!gst_base_transform_reconfigure (trans)))
+    goto not_negotiated;
+
+  if (!priv->negotiated && !priv->passthrough && (klass->set_caps != NULL))
+    goto not_negotiated;
+
+  GST_OBJECT_LOCK (trans);
+  qos_active = priv->qos_enabled && priv->earliest_time != -1;
+  GST_OBJECT_UNLOCK (trans);
+  if (qos_active && trans->segment.format == GST_FORMAT_TIME)
+    goto split;
+
+  if (priv->passthrough) {
+    transform = klass->transform_ip_on_passthrough && klass->transform_ip;
+    if (transform && !klass->transform_ip_list)
+      goto split;
+  } else {
+    if (!klass->transform_ip_list || !klass->transform_ip ||
+        !priv->always_in_place || priv->pool)
+      goto split;
+    transform = TRUE;
+  }
+
+  len = gst_buffer_list_length (list);
+  if (len == 0) {
+    gst_buffer_list_unref (list);
+    return GST_FLOW_OK;
+  }
+
+  GST_LOG_OBJECT (trans, "handling list %p of %u buffers", list, len);
+
+  list = gst_buffer_list_make_writable (list);
+  gst_buffer_list_foreach (list, gst_base_transform_list_prepare_func, trans);
+
+  if (transform) {
+    ret = klass->transform_ip_list (trans, list);
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_list_unref (list);
+      goto done;
+    }
+    len = gst_buffer_list_length (list);
+    if (len == 0) {
+      gst_buffer_list_unref (list);
+      goto done;
+    }
+  }
+
+  /* the last buffer gives the position */
+  buffer = gst_buffer_list_get (list, len - 1);
+  if (GST_BUFFER_TIMESTAMP_IS_VALID (buffer)) {
+    position = GST_BUFFER_TIMESTAMP (buffer);
+    if (GST_BUFFER_DURATION_IS_VALID (buffer))
+      position += GST_BUFFER_DURATION (buffer);
+  }
+  if (position != GST_CLOCK_TIME_NONE &&
+      trans->segment.format == GST_FORMAT_TIME) {
+    trans->segment.position = position;
+    priv->position_out = position;
+  }
+
+  if (priv->discont) {
+    buffer = gst_buffer_list_get (list, 0);
+    if (!GST_BUFFER_IS_DISCONT (buffer)) {
+      GST_DEBUG_OBJECT (trans, "marking DISCONT on first buffer of list");
+      buffer = gst_buffer_make_writable (gst_buffer_ref (buffer));
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+      gst_buffer_list_remove (list, 0, 1);
+      gst_buffer_list_insert (list, 0, buffer);
+    }
+    priv->discont = FALSE;
+  }
+  priv->processed += len;
+
+  return gst_pad_push_list (trans->srcpad, list);
+
+split:
+  {
+    len = gst_buffer_list_length (list);
+    for (i = 0; i < len && ret == GST_FLOW_OK; i++) {
+      buffer = gst_buffer_ref (gst_buffer_list_get (list, i));
+      ret = gst_base_transform_chain (pad, parent, buffer);
+    }
+    gst_buffer_list_unref (list);
+    return ret;
+  }
+not_negotiated:
+  {
+    gst_buffer_list_unref (list);
+    if (GST_PAD_IS_FLUSHING (trans->srcpad))
+      return GST_FLOW_FLUSHING;
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+done:
+  /* convert internal flow to OK and mark discont for the next buffer. */
+  if (ret == GST_BASE_TRANSFORM_FLOW_DROPPED) {
+    GST_DEBUG_OBJECT (trans, "dropped a buffer list, marking DISCONT");
+    priv->discont = TRUE;
+    ret = GST_FLOW_OK;
+  }
+  return ret;
+}
+
 static void
 gst_base_transform_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -208,7 +208,17 @@ struct _GstBaseTransform {
  *                   do 1-to-1 transformations on input to output buffers can either
  *                   return GST_BASE_TRANSFORM_FLOW_DROPPED or simply not generate
  *                   an output buffer until they are ready to do so. (Since 1.6)
- *                   
+ * @transform_ip_list: Optional. Transform all buffers of an incoming
+ *                   #GstBufferList in-place. It is used instead of calling
+ *                   @transform_ip for each buffer when the element operates
+ *                   in-place without a buffer pool, or in passthrough mode
+ *                   with @transform_ip_on_passthrough, and the default
+ *                   @submit_input_buffer, @generate_output and
+ *                   @prepare_output_buffer are used. The buffers in the list
+ *                   are writable unless the element is in passthrough mode.
+ *                   Lists are split into buffers again while QoS is dropping
+ *                   late buffers. (Since 1.10)
+ *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum either @transform or @transform_ip need to be overridden.
  * If the element can overwrite the input data with the results (data is of the
@@ -280,8 +290,10 @@ struct _GstBaseTransformClass {
   GstFlowReturn (*submit_input_buffer) (GstBaseTransform *trans, gboolean is_discont, GstBuffer *input);
   GstFlowReturn (*generate_output) (GstBaseTransform *trans, GstBuffer **outbuf);
 
+  GstFlowReturn (*transform_ip_list) (GstBaseTransform *trans, GstBufferList *list);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE - 2];
+  gpointer       _gst_reserved[GST_PADDING_LARGE - 3];
 };
 
 GType           gst_base_transform_get_type         (void);
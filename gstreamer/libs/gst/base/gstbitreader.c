@@ -293,3 +293,108 @@ GST_BIT_READER_READ_BITS (8);
 GST_BIT_READER_READ_BITS (16);
 GST_BIT_READER_READ_BITS (32);
 GST_BIT_READER_READ_BITS (64);
+
+static inline guint
+_gst_bit_reader_clz64 (guint64 word)
+{
+#if defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
+  return __builtin_clzll (word);
+#else
+  if (word >> 32)
+    return 31 - g_bit_nth_msf ((gulong) (word >> 32), -1);
+  return 63 - g_bit_nth_msf ((gulong) (word & G_MAXUINT32), -1);
+#endif
+}
+
+/**
+ * gst_bit_reader_get_ue:
+ * @reader: a #GstBitReader instance
+ * @val: (out): Pointer to a #guint32 to store the result
+ *
+ * Read an unsigned Exp-Golomb code, as used by H.264 and H.265 for
+ * ue(v) syntax elements, into @val and update the current position.
+ * The position is not changed if the code could not be read.
+ *
+ * Returns: %TRUE if successful, %FALSE otherwise.
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_bit_reader_get_ue (GstBitReader * reader, guint32 * val)
+{
+  guint remaining, nbits, leading;
+  guint64 word, value;
+
+  g_return_val_if_fail (reader != NULL, FALSE);
+  g_return_val_if_fail (val != NULL, FALSE);
+
+  remaining = _gst_bit_reader_get_remaining_unchecked (reader);
+  if (remaining == 0)
+    return FALSE;
+
+  /* the prefix, the marker bit and usually the suffix are all in here */
+  nbits = MIN (remaining, 64);
+  word = _gst_bit_reader_peek_word_unchecked (reader, nbits) << (64 - nbits);
+  if (word == 0)
+    return FALSE;
+
+  leading = _gst_bit_reader_clz64 (word);
+  if (leading > 32 || 2 * leading + 1 > remaining)
+    return FALSE;
+
+  if (leading < 32) {
+    value = (word >> (63 - 2 * leading)) - 1;
+  } else {
+    GstBitReader tmp = *reader;
+
+    gst_bit_reader_skip_unchecked (&tmp, leading + 1);
+    value = G_MAXUINT32 + gst_bit_reader_peek_bits_uint64_unchecked (&tmp,
+        leading);
+    if (value > G_MAXUINT32)
+      return FALSE;
+  }
+
+  gst_bit_reader_skip_unchecked (reader, 2 * leading + 1);
+  *val = (guint32) value;
+
+  return TRUE;
+}
+
+/**
+ * gst_bit_reader_get_se:
+ * @reader: a #GstBitReader instance
+ * @val: (out): Pointer to a #gint32 to store the result
+ *
+ * Read a signed Exp-Golomb code, as used by H.264 and H.265 for
+ * se(v) syntax elements, into @val and update the current position.
+ * The position is not changed if the code could not be read.
+ *
+ * Returns: %TRUE if successful, %FALSE otherwise.
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_bit_reader_get_se (GstBitReader * reader, gint32 * val)
+{
+  GstBitReader tmp;
+  guint32 value;
+
+  g_return_val_if_fail (reader != NULL, FALSE);
+  g_return_val_if_fail (val != NULL, FALSE);
+
+  tmp = *reader;
+  if (!gst_bit_reader_get_ue (&tmp, &value))
+    return FALSE;
+
+  /* 2^31 is not representable */
+  if (G_UNLIKELY (value == G_MAXUINT32))
+    return FALSE;
+
+  *reader = tmp;
+  if (value % 2)
+    *val = (gint32) (value / 2) + 1;
+  else
+    *val = -(gint32) (value / 2);
+
+  return TRUE;
+}
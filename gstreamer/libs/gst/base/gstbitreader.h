@@ -75,6 +75,9 @@ gboolean        gst_bit_reader_peek_bits_uint16 (const GstBitReader *reader, gui
 gboolean        gst_bit_reader_peek_bits_uint32 (const GstBitReader *reader, guint32 *val, guint nbits);
 gboolean        gst_bit_reader_peek_bits_uint64 (const GstBitReader *reader, guint64 *val, guint nbits);
 
+gboolean        gst_bit_reader_get_ue           (GstBitReader *reader, guint32 *val);
+gboolean        gst_bit_reader_get_se           (GstBitReader *reader, gint32 *val);
+
 /**
  * GST_BIT_READER_INIT:
  * @data: Data from which the #GstBitReader should read
@@ -106,33 +109,45 @@ gst_bit_reader_skip_to_byte_unchecked (GstBitReader * reader)
   }
 }
 
+/* Returns the next @nbits (at most 64) bits right-aligned, using one
+ * unaligned big-endian 64-bit load instead of a per-byte loop. Up to 8
+ * following bytes are loaded, the ninth one is only needed when the read
+ * spans it, which implies that it is within the data. */
+static inline guint64
+_gst_bit_reader_peek_word_unchecked (const GstBitReader * reader, guint nbits)
+{
+  const guint8 *data;
+  guint avail;
+  guint64 word;
+
+  if (G_UNLIKELY (nbits == 0))
+    return 0;
+
+  data = reader->data + reader->byte;
+  avail = reader->size - reader->byte;
+
+  if (G_LIKELY (avail >= 8)) {
+    word = GST_READ_UINT64_BE (data);
+  } else {
+    guint i;
+
+    word = 0;
+    for (i = 0; i < avail; i++)
+      word |= ((guint64) data[i]) << (56 - 8 * i);
+  }
+
+  word <<= reader->bit;
+  if (reader->bit + nbits > 64)
+    word |= data[8] >> (8 - reader->bit);
+
+  return word >> (64 - nbits);
+}
+
 #define __GST_BIT_READER_READ_BITS_UNCHECKED(bits) \
 static inline guint##bits \
 gst_bit_reader_peek_bits_uint##bits##_unchecked (const GstBitReader *reader, guint nbits) \
 { \
-  guint##bits ret = 0; \
-  const guint8 *data; \
-  guint byte, bit; \
-  \
-  data = reader->data; \
-  byte = reader->byte; \
-  bit = reader->bit; \
-  \
-  while (nbits > 0) { \
-    guint toread = MIN (nbits, 8 - bit); \
-    \
-    ret <<= toread; \
-    ret |= (data[byte] & (0xff >> bit)) >> (8 - toread - bit); \
-    \
-    bit += toread; \
-    if (bit >= 8) { \
-      byte++; \
-      bit = 0; \
-    } \
-    nbits -= toread; \
-  } \
-  \
-  return ret; \
+  return (guint##bits) _gst_bit_reader_peek_word_unchecked (reader, nbits); \
 } \
 \
 static inline guint##bits \
@@ -265,7 +265,8 @@ helper_find_get_length (gpointer data)
  *
  * When @extension is not %NULL, this function will first try the typefind
  * functions for the given extension, which might speed up the typefinding
- * in many cases.
+ * in many cases. If one of those is nearly certain about the type, the
+ * remaining typefind functions are not tried.
  *
  * Free-function: gst_caps_unref
  *
@@ -355,6 +356,14 @@ gst_type_find_helper_get_range (GstObject * obj, GstObject * parent,
     gst_type_find_factory_call_function (helper.factory, &find);
     if (helper.best_probability >= GST_TYPE_FIND_MAXIMUM)
       break;
+
+    /* the data agrees with the extension, running all the other typefind
+     * functions over it would mostly pull more data for nothing */
+    if (--pos == 0 && helper.best_probability >= GST_TYPE_FIND_NEARLY_CERTAIN) {
+      GST_LOG_OBJECT (obj, "extension %s confirmed by the data, stopping",
+          extension);
+      break;
+    }
   }
   gst_plugin_feature_list_free (type_list);
 
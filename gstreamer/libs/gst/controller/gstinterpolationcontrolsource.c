@@ -68,37 +68,68 @@ _get_nearest_control_points (GstTimedValueControlSource * self,
   return FALSE;
 }
 
-static inline void
-_get_nearest_control_points2 (GstTimedValueControlSource * self,
-    GstClockTime ts, GstControlPoint ** cp1, GstControlPoint ** cp2,
-    GstClockTime * next_ts)
+/* Fills @values with @n_values values for the timestamps starting at
+ * @timestamp. Instead of searching the control point list for every sample,
+ * a cursor is advanced over the list and each run of samples between two
+ * control points is handed to @fill at once, which can then evaluate the
+ * segment in a tight loop */
+typedef void (*FillSegmentFunc) (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values);
+
+static gboolean
+_get_value_array (GstTimedValueControlSource * self, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values,
+    FillSegmentFunc fill)
 {
-  GSequenceIter *iter1, *iter2 = NULL;
+  gboolean ret = FALSE;
+  guint i = 0, j, n;
+  GstClockTime ts = timestamp;
+  GSequenceIter *iter1, *iter2;
+  GstControlPoint *cp1, *cp2;
+
+  g_mutex_lock (&self->lock);
 
-  *cp1 = *cp2 = NULL;
   iter1 = gst_timed_value_control_source_find_control_point_iter (self, ts);
-  if (iter1) {
-    *cp1 = g_sequence_get (iter1);
+  if (iter1)
     iter2 = g_sequence_iter_next (iter1);
-  } else {
-    if (G_LIKELY (self->values)) {
-      /* all values in the control point list come after the given timestamp */
-      iter2 = g_sequence_get_begin_iter (self->values);
-      /* why this? if !cp1 we don't interpolate anyway
-       * if we can eliminate this, we can also use _get_nearest_control_points()
-       * here, is this just to set next_ts? */
-    } else {
-      /* no values */
-      iter2 = NULL;
+  else if (G_LIKELY (self->values))
+    iter2 = g_sequence_get_begin_iter (self->values);
+  else
+    iter2 = NULL;
+
+  while (i < n_values) {
+    /* move the cursor to the segment containing ts */
+    while (iter2 && !g_sequence_iter_is_end (iter2) &&
+        ((GstControlPoint *) g_sequence_get (iter2))->timestamp <= ts) {
+      iter1 = iter2;
+      iter2 = g_sequence_iter_next (iter2);
     }
-  }
+    cp1 = iter1 ? g_sequence_get (iter1) : NULL;
+    cp2 = (iter2 && !g_sequence_iter_is_end (iter2)) ?
+        g_sequence_get (iter2) : NULL;
 
-  if (iter2 && !g_sequence_iter_is_end (iter2)) {
-    *cp2 = g_sequence_get (iter2);
-    *next_ts = (*cp2)->timestamp;
-  } else {
-    *next_ts = GST_CLOCK_TIME_NONE;
+    /* number of samples before the next control point */
+    n = n_values - i;
+    if (cp2 && interval > 0)
+      n = MIN (n, (cp2->timestamp - ts + interval - 1) / interval);
+
+    GST_LOG ("values[%3d..%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%"
+        GST_TIME_FORMAT, i, i + n - 1, GST_TIME_ARGS (ts),
+        GST_TIME_ARGS (cp2 ? cp2->timestamp : GST_CLOCK_TIME_NONE));
+
+    if (cp1) {
+      fill (self, cp1, cp2, ts, interval, n, values + i);
+      ret = TRUE;
+    } else {
+      for (j = 0; j < n; j++)
+        values[i + j] = NAN;
+    }
+    i += n;
+    ts += n * interval;
   }
+  g_mutex_unlock (&self->lock);
+  return ret;
 }
 
 
@@ -131,38 +162,25 @@ interpolate_none_get (GstTimedValueControlSource * self, GstClockTime timestamp,
   return ret;
 }
 
+static void
+_interpolate_none_fill (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  gdouble value = _interpolate_none (self, cp1);
+  guint i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = value;
+}
+
 static gboolean
 interpolate_none_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_none (self, cp1);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_none_fill);
 }
 
 
@@ -203,40 +221,38 @@ interpolate_linear_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+/* offsets are exact integers as doubles, so this gives the same results as
+ * _interpolate_linear() while the loop has no dependencies between samples */
+static void
+_interpolate_linear_fill (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  gdouble value1 = cp1->value, slope, offset, step;
+  guint i;
+
+  if (!cp2) {
+    for (i = 0; i < n_values; i++)
+      values[i] = value1;
+    return;
+  }
+
+  slope = (cp2->value - value1) /
+      gst_guint64_to_gdouble (cp2->timestamp - cp1->timestamp);
+  offset = gst_guint64_to_gdouble (timestamp - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n_values; i++)
+    values[i] = value1 + (offset + i * step) * slope;
+}
+
 static gboolean
 interpolate_linear_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_linear (cp1->timestamp, cp1->value,
-          (cp2 ? cp2->timestamp : GST_CLOCK_TIME_NONE),
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_linear_fill);
 }
 
 
@@ -388,43 +404,55 @@ interpolate_cubic_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_cubic_fill (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  gdouble h, z1, z2, c1, c2, offset, span, step;
+  guint i;
+
+  if (!self->valid_cache) {
+    _interpolate_cubic_update_cache (self);
+    self->valid_cache = TRUE;
+  }
+
+  if (!cp2) {
+    for (i = 0; i < n_values; i++)
+      values[i] = cp1->value;
+    return;
+  }
+
+  /* same terms as in _interpolate_cubic(), hoisted out of the loop */
+  h = cp1->cache.cubic.h;
+  z1 = cp1->cache.cubic.z;
+  z2 = cp2->cache.cubic.z;
+  c1 = cp1->value / h - h * z1;
+  c2 = cp2->value / h - h * z2;
+  offset = gst_guint64_to_gdouble (timestamp - cp1->timestamp);
+  span = gst_guint64_to_gdouble (cp2->timestamp - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n_values; i++) {
+    gdouble diff1 = offset + i * step;
+    gdouble diff2 = span - diff1;
+
+    values[i] = (z2 * diff1 * diff1 * diff1 + z1 * diff2 * diff2 * diff2) / h +
+        c2 * diff1 + c1 * diff2;
+  }
+}
+
 static gboolean
 interpolate_cubic_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
   if (self->nvalues <= 2)
     return interpolate_linear_get_value_array (self, timestamp, interval,
         n_values, values);
 
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_cubic (self, cp1, cp1->value, cp2,
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_cubic_fill);
 }
 
 
@@ -557,43 +585,50 @@ interpolate_cubic_monotonic_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_cubic_monotonic_fill (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  gdouble value1 = cp1->value, c1s, c2s, c3s, offset, step;
+  guint i;
+
+  if (!self->valid_cache) {
+    _interpolate_cubic_monotonic_update_cache (self);
+    self->valid_cache = TRUE;
+  }
+
+  if (!cp2) {
+    for (i = 0; i < n_values; i++)
+      values[i] = value1;
+    return;
+  }
+
+  c1s = cp1->cache.cubic_monotonic.c1s;
+  c2s = cp1->cache.cubic_monotonic.c2s;
+  c3s = cp1->cache.cubic_monotonic.c3s;
+  offset = gst_guint64_to_gdouble (timestamp - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n_values; i++) {
+    gdouble diff = offset + i * step;
+    gdouble diff2 = diff * diff;
+
+    values[i] = value1 + c1s * diff + c2s * diff2 + c3s * diff * diff2;
+  }
+}
+
 static gboolean
 interpolate_cubic_monotonic_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
   if (self->nvalues <= 2)
     return interpolate_linear_get_value_array (self, timestamp, interval,
         n_values, values);
 
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_cubic_monotonic (self, cp1, cp1->value, cp2,
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_cubic_monotonic_fill);
 }
 
 
@@ -118,14 +118,24 @@ interpolate_trigger_get_value_array (GstTimedValueControlSource * self,
   for (i = 0; i < n_values; i++) {
     val = NAN;
     if (ts >= next_ts) {
-      iter1 = gst_timed_value_control_source_find_control_point_iter (self, ts);
-      if (!iter1) {
-        if (G_LIKELY (self->values))
-          iter2 = g_sequence_get_begin_iter (self->values);
-        else
-          iter2 = NULL;
+      if (iter1) {
+        /* advance the cursor instead of searching the list again */
+        do {
+          iter1 = iter2;
+          iter2 = g_sequence_iter_next (iter2);
+        } while (!g_sequence_iter_is_end (iter2) &&
+            ((GstControlPoint *) g_sequence_get (iter2))->timestamp <= ts);
       } else {
-        iter2 = g_sequence_iter_next (iter1);
+        iter1 =
+            gst_timed_value_control_source_find_control_point_iter (self, ts);
+        if (!iter1) {
+          if (G_LIKELY (self->values))
+            iter2 = g_sequence_get_begin_iter (self->values);
+          else
+            iter2 = NULL;
+        } else {
+          iter2 = g_sequence_iter_next (iter1);
+        }
       }
 
       if (iter2 && !g_sequence_iter_is_end (iter2)) {
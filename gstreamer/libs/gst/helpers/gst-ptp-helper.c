@@ -38,9 +38,17 @@
 #include <errno.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/time.h>
 #include <net/if.h>
 #include <netinet/in.h>
 #include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#endif
 
 #ifdef HAVE_GETIFADDRS_AF_LINK
 #include <ifaddrs.h>
@@ -66,6 +74,15 @@
 #define PTP_EVENT_PORT   319
 #define PTP_GENERAL_PORT 320
 
+/* Send timestamps of event messages are read back from the socket error
+ * queue and matched to the message by the counter the kernel assigns to
+ * each sent packet */
+#if defined(SO_TIMESTAMPING) && defined(SOF_TIMESTAMPING_OPT_ID) && defined(SO_EE_ORIGIN_TIMESTAMPING)
+#define HAVE_TX_TIMESTAMPING 1
+#define TX_MESSAGES_SIZE 16
+#define TX_MESSAGE_MAX_SIZE 64
+#endif
+
 static gchar **ifaces = NULL;
 static gboolean verbose = FALSE;
 static guint64 clock_id = (guint64) - 1;
@@ -85,32 +102,40 @@ static GSocketAddress *event_saddr, *general_saddr;
 static GSocket *socket_event, *socket_general;
 static GIOChannel *stdin_channel, *stdout_channel;
 
-static gboolean
-have_socket_data_cb (GSocket * socket, GIOCondition condition,
-    gpointer user_data)
+#ifdef HAVE_TX_TIMESTAMPING
+typedef struct
 {
-  gchar buffer[8192];
-  gssize read;
-  gsize written;
+  guint32 id;
+  gsize size;
+  guint8 data[TX_MESSAGE_MAX_SIZE];
+} TxMessage;
+
+static gboolean tx_timestamping = FALSE;
+static guint32 tx_message_id = 0;
+static TxMessage tx_messages[TX_MESSAGES_SIZE];
+#endif
+
+static void
+write_stdout_message (guint8 type, GstClockTime timestamp, const gchar * data,
+    gsize size)
+{
+  gchar buffer[sizeof (StdIOHeader) + STDIO_MESSAGE_TIMESTAMP_SIZE + 8192];
+  StdIOHeader header = { 0, };
+  gsize written, total;
   GError *err = NULL;
   GIOStatus status;
-  StdIOHeader header = { 0, };
 
-  read = g_socket_receive (socket, buffer, sizeof (buffer), NULL, &err);
-  if (read == -1)
-    g_error ("Failed to read from socket: %s", err->message);
-  g_clear_error (&err);
+  g_assert (size <= 8192);
 
-  if (verbose)
-    g_message ("Received %" G_GSSIZE_FORMAT " bytes from %s socket", read,
-        (socket == socket_event ? "event" : "general"));
-
-  header.size = read;
-  header.type = (socket == socket_event) ? TYPE_EVENT : TYPE_GENERAL;
+  header.size = STDIO_MESSAGE_TIMESTAMP_SIZE + size;
+  header.type = type;
+  memcpy (buffer, &header, sizeof (header));
+  GST_WRITE_UINT64_BE (buffer + sizeof (header), timestamp);
+  memcpy (buffer + sizeof (header) + STDIO_MESSAGE_TIMESTAMP_SIZE, data, size);
+  total = sizeof (header) + header.size;
 
   status =
-      g_io_channel_write_chars (stdout_channel, (gchar *) & header,
-      sizeof (header), &written, &err);
+      g_io_channel_write_chars (stdout_channel, buffer, total, &written, &err);
   if (status == G_IO_STATUS_ERROR) {
     g_error ("Failed to write to stdout: %s", err->message);
     g_clear_error (&err);
@@ -119,23 +144,209 @@ have_socket_data_cb (GSocket * socket, GIOCondition condition,
     exit (0);
   } else if (status != G_IO_STATUS_NORMAL) {
     g_error ("Unexpected stdout write status: %d", status);
-  } else if (written != sizeof (header)) {
+  } else if (written != total) {
     g_error ("Unexpected write size: %" G_GSIZE_FORMAT, written);
   }
+}
 
-  status =
-      g_io_channel_write_chars (stdout_channel, buffer, read, &written, &err);
-  if (status == G_IO_STATUS_ERROR) {
-    g_error ("Failed to write to stdout: %s", err->message);
-    g_clear_error (&err);
-  } else if (status == G_IO_STATUS_EOF) {
-    g_message ("EOF on stdout");
-    exit (0);
-  } else if (status != G_IO_STATUS_NORMAL) {
-    g_error ("Unexpected stdout write status: %d", status);
-  } else if (written != read) {
-    g_error ("Unexpected write size: %" G_GSIZE_FORMAT, written);
+/* Returns the kernel timestamp carried in @cmsg, or GST_CLOCK_TIME_NONE */
+static GstClockTime
+parse_timestamp_cmsg (struct cmsghdr *cmsg)
+{
+  if (cmsg->cmsg_level != SOL_SOCKET)
+    return GST_CLOCK_TIME_NONE;
+
+#ifdef SO_TIMESTAMPING
+  if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+    struct timespec ts[3];
+
+    /* The first one is the software timestamp, the others are hardware
+     * timestamps in the time of the NIC's own clock */
+    memcpy (ts, CMSG_DATA (cmsg), sizeof (ts));
+    if (ts[0].tv_sec != 0 || ts[0].tv_nsec != 0)
+      return GST_TIMESPEC_TO_TIME (ts[0]);
+  }
+#endif
+#ifdef SO_TIMESTAMPNS
+  if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+    struct timespec ts;
+
+    memcpy (&ts, CMSG_DATA (cmsg), sizeof (ts));
+    return GST_TIMESPEC_TO_TIME (ts);
   }
+#endif
+#ifdef SO_TIMESTAMP
+  if (cmsg->cmsg_type == SCM_TIMESTAMP) {
+    struct timeval tv;
+
+    memcpy (&tv, CMSG_DATA (cmsg), sizeof (tv));
+    return GST_TIMEVAL_TO_TIME (tv);
+  }
+#endif
+
+  return GST_CLOCK_TIME_NONE;
+}
+
+static void
+setup_timestamping (GSocket * socket, gboolean tx)
+{
+  gint fd = g_socket_get_fd (socket);
+  gint on = 1;
+
+#ifdef SO_TIMESTAMPING
+  {
+    guint flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+#ifdef HAVE_TX_TIMESTAMPING
+    if (tx)
+      flags |= SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_OPT_ID;
+#endif
+
+    if (setsockopt (fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+            sizeof (flags)) == 0) {
+#ifdef HAVE_TX_TIMESTAMPING
+      if (tx)
+        tx_timestamping = TRUE;
+#endif
+      return;
+    }
+  }
+#endif
+
+#if defined(SO_TIMESTAMPNS)
+  if (setsockopt (fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof (on)) == 0)
+    return;
+#endif
+#if defined(SO_TIMESTAMP)
+  if (setsockopt (fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof (on)) == 0)
+    return;
+#endif
+
+  if (verbose)
+    g_message ("No kernel timestamps available, using receive times");
+}
+
+#ifdef HAVE_TX_TIMESTAMPING
+static void
+read_tx_timestamps (GSocket * socket)
+{
+  gint fd = g_socket_get_fd (socket);
+
+  for (;;) {
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    union
+    {
+      struct cmsghdr align;
+      gchar buf[512];
+    } control;
+    gchar buffer[256];
+    GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+    gboolean have_id = FALSE;
+    guint32 id = 0;
+    TxMessage *tx_message;
+
+    memset (&msg, 0, sizeof (msg));
+    iov.iov_base = buffer;
+    iov.iov_len = sizeof (buffer);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof (control.buf);
+
+    if (recvmsg (fd, &msg, MSG_ERRQUEUE) == -1) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+
+    for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+      if (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) {
+        struct sock_extended_err serr;
+
+        memcpy (&serr, CMSG_DATA (cmsg), sizeof (serr));
+        if (serr.ee_errno == ENOMSG
+            && serr.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+          id = serr.ee_data;
+          have_id = TRUE;
+        }
+      } else if (!GST_CLOCK_TIME_IS_VALID (timestamp)) {
+        timestamp = parse_timestamp_cmsg (cmsg);
+      }
+    }
+
+    if (!have_id || !GST_CLOCK_TIME_IS_VALID (timestamp))
+      continue;
+
+    tx_message = &tx_messages[id % TX_MESSAGES_SIZE];
+    if (tx_message->size == 0 || tx_message->id != id)
+      continue;
+
+    if (verbose)
+      g_message ("Got send timestamp for event message %u", id);
+
+    write_stdout_message (TYPE_EVENT_TX_TIMESTAMP, timestamp,
+        (const gchar *) tx_message->data, tx_message->size);
+    tx_message->size = 0;
+  }
+}
+#endif
+
+static gboolean
+have_socket_data_cb (GSocket * socket, GIOCondition condition,
+    gpointer user_data)
+{
+  gchar buffer[8192];
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  union
+  {
+    struct cmsghdr align;
+    gchar buf[512];
+  } control;
+  GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+  gssize read;
+
+#ifdef HAVE_TX_TIMESTAMPING
+  if ((condition & G_IO_ERR) && tx_timestamping)
+    read_tx_timestamps (socket);
+#endif
+
+  if (!(condition & (G_IO_IN | G_IO_PRI)))
+    return G_SOURCE_CONTINUE;
+
+  /* GSocket drops control messages it does not know about, so the kernel
+   * timestamps have to be received with plain recvmsg() */
+  memset (&msg, 0, sizeof (msg));
+  iov.iov_base = buffer;
+  iov.iov_len = sizeof (buffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+  do {
+    read = recvmsg (g_socket_get_fd (socket), &msg, 0);
+  } while (read == -1 && errno == EINTR);
+
+  if (read == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return G_SOURCE_CONTINUE;
+    g_error ("Failed to read from socket: %s", g_strerror (errno));
+  }
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg && !GST_CLOCK_TIME_IS_VALID (timestamp);
+      cmsg = CMSG_NXTHDR (&msg, cmsg))
+    timestamp = parse_timestamp_cmsg (cmsg);
+
+  if (verbose)
+    g_message ("Received %" G_GSSIZE_FORMAT " bytes from %s socket", read,
+        (socket == socket_event ? "event" : "general"));
+
+  write_stdout_message ((socket == socket_event) ? TYPE_EVENT : TYPE_GENERAL,
+      timestamp, buffer, read);
 
   return G_SOURCE_CONTINUE;
 }
@@ -199,6 +410,20 @@ have_stdin_data_cb (GIOChannel * channel, GIOCondition condition,
       else if (written != header.size)
         g_error ("Unexpected write size: %" G_GSSIZE_FORMAT, written);
       g_clear_error (&err);
+#ifdef HAVE_TX_TIMESTAMPING
+      if (header.type == TYPE_EVENT && tx_timestamping) {
+        TxMessage *tx_message =
+            &tx_messages[tx_message_id % TX_MESSAGES_SIZE];
+
+        tx_message->id = tx_message_id++;
+        if (header.size <= TX_MESSAGE_MAX_SIZE) {
+          memcpy (tx_message->data, buffer, header.size);
+          tx_message->size = header.size;
+        } else {
+          tx_message->size = 0;
+        }
+      }
+#endif
       if (verbose)
         g_message ("Sent %" G_GSSIZE_FORMAT " bytes to %s socket", read,
             (header.type == TYPE_EVENT ? "event" : "general"));
@@ -227,6 +452,7 @@ setup_sockets (void)
     g_error ("Couldn't create event socket: %s", err->message);
   g_clear_error (&err);
   g_socket_set_multicast_loopback (socket_event, FALSE);
+  setup_timestamping (socket_event, TRUE);
 
   socket_general =
       g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
@@ -235,6 +461,7 @@ setup_sockets (void)
     g_error ("Couldn't create general socket: %s", err->message);
   g_clear_error (&err);
   g_socket_set_multicast_loopback (socket_general, FALSE);
+  setup_timestamping (socket_general, FALSE);
 
   /* Bind sockets */
   bind_addr = g_inet_address_new_any (G_SOCKET_FAMILY_IPV4);
@@ -490,8 +717,10 @@ setup_sockets (void)
   general_saddr = g_inet_socket_address_new (mcast_addr, PTP_GENERAL_PORT);
 
   /* Create socket sources */
+  /* G_IO_ERR signals pending send timestamps on the error queue */
   socket_event_source =
-      g_socket_create_source (socket_event, G_IO_IN | G_IO_PRI, NULL);
+      g_socket_create_source (socket_event, G_IO_IN | G_IO_PRI | G_IO_ERR,
+      NULL);
   g_source_set_priority (socket_event_source, G_PRIORITY_HIGH);
   g_source_set_callback (socket_event_source, (GSourceFunc) have_socket_data_cb,
       NULL, NULL);
@@ -60,6 +60,7 @@
 #include "gstnettimepacket.h"
 #include "gstntppacket.h"
 #include "gstnetclientclock.h"
+#include "gstnetsocketutils.h"
 
 #include <gio/gio.h>
 
@@ -706,16 +707,37 @@ gst_net_client_internal_clock_thread (gpointer data)
       }
       g_clear_error (&err);
     } else {
-      GstClockTime new_local;
+      GstClockTime new_local, timestamp, age;
+      guint8 buffer[GST_NTP_PACKET_SIZE];
+      gsize packet_size;
+      gssize ret;
 
       /* got packet */
+      packet_size =
+          self->is_ntp ? GST_NTP_PACKET_SIZE : GST_NET_TIME_PACKET_SIZE;
+      ret = gst_net_socket_receive_timestamped (socket, buffer, packet_size,
+          NULL, &timestamp, &err);
 
       new_local = gst_clock_get_internal_time (GST_CLOCK_CAST (self));
 
+      /* take the time the packet arrived at instead of the time we got
+       * to read it, which leaves scheduling jitter out of the round trip */
+      age = gst_net_socket_timestamp_get_age (timestamp);
+      if (GST_CLOCK_TIME_IS_VALID (age) && new_local > age)
+        new_local -= age;
+
+      if (ret >= 0 && ret < packet_size) {
+        GST_DEBUG_OBJECT (self, "someone sent us a short packet (%"
+            G_GSSIZE_FORMAT " < %" G_GSIZE_FORMAT ")", ret, packet_size);
+        g_set_error (&err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+            "short time packet (%d < %d)", (int) ret, (int) packet_size);
+      }
+
       if (self->is_ntp) {
-        GstNtpPacket *packet;
+        GstNtpPacket *packet = NULL;
 
-        packet = gst_ntp_packet_receive (socket, NULL, &err);
+        if (err == NULL)
+          packet = gst_ntp_packet_new (buffer, &err);
 
         if (packet != NULL) {
           GST_LOG_OBJECT (self, "got packet back");
@@ -768,9 +790,10 @@ gst_net_client_internal_clock_thread (gpointer data)
           g_clear_error (&err);
         }
       } else {
-        GstNetTimePacket *packet;
+        GstNetTimePacket *packet = NULL;
 
-        packet = gst_net_time_packet_receive (socket, NULL, &err);
+        if (err == NULL)
+          packet = gst_net_time_packet_new (buffer);
 
         if (packet != NULL) {
           GST_LOG_OBJECT (self, "got packet back");
@@ -867,6 +890,8 @@ gst_net_client_internal_clock_start (GstNetClientInternalClock * self)
 
   g_object_unref (myaddr);
 
+  gst_net_socket_enable_timestamps (socket);
+
   self->cancel = g_cancellable_new ();
   self->made_cancel_fd =
       g_cancellable_make_pollfd (self->cancel, &dummy_pollfd);
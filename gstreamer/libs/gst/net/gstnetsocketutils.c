@@ -0,0 +1,200 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Helpers for receiving packets together with the time the kernel received
+ * them. The timestamps are in CLOCK_REALTIME and are only used to find out
+ * how long a packet was waiting before it was read, which is then subtracted
+ * from the time of the clock the packet is observed against. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstnetsocketutils.h"
+
+#include <string.h>
+
+#ifndef G_OS_WIN32
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <time.h>
+#endif
+
+/* Timestamps older than this are assumed to be bogus, e.g. because the
+ * wall clock was stepped since the packet was received */
+#define MAX_TIMESTAMP_AGE GST_SECOND
+
+/* Enables kernel receive timestamps on @socket if supported */
+gboolean
+gst_net_socket_enable_timestamps (GSocket * socket)
+{
+#ifndef G_OS_WIN32
+  gint fd = g_socket_get_fd (socket);
+  gint on = 1;
+
+#ifdef SO_TIMESTAMPNS
+  if (setsockopt (fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof (on)) == 0)
+    return TRUE;
+#endif
+#ifdef SO_TIMESTAMP
+  if (setsockopt (fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof (on)) == 0)
+    return TRUE;
+#endif
+#endif
+
+  GST_DEBUG ("kernel receive timestamps not supported");
+  return FALSE;
+}
+
+#ifndef G_OS_WIN32
+/* Returns the kernel receive timestamp of @msg, or GST_CLOCK_TIME_NONE */
+GstClockTime
+gst_net_socket_parse_timestamp (struct msghdr * msg)
+{
+  struct cmsghdr *cmsg;
+
+  for (cmsg = CMSG_FIRSTHDR (msg); cmsg; cmsg = CMSG_NXTHDR (msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET)
+      continue;
+
+#ifdef SO_TIMESTAMPNS
+    if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+      struct timespec ts;
+
+      memcpy (&ts, CMSG_DATA (cmsg), sizeof (ts));
+      return GST_TIMESPEC_TO_TIME (ts);
+    }
+#endif
+#ifdef SO_TIMESTAMP
+    if (cmsg->cmsg_type == SCM_TIMESTAMP) {
+      struct timeval tv;
+
+      memcpy (&tv, CMSG_DATA (cmsg), sizeof (tv));
+      return GST_TIMEVAL_TO_TIME (tv);
+    }
+#endif
+  }
+
+  return GST_CLOCK_TIME_NONE;
+}
+#endif
+
+/* Like g_socket_receive_from(), but also returns the
+ * kernel receive timestamp of the packet in @timestamp, or
+ * GST_CLOCK_TIME_NONE if there is none */
+gssize
+gst_net_socket_receive_timestamped (GSocket * socket, guint8 * buffer,
+    gsize size, GSocketAddress ** src_address, GstClockTime * timestamp,
+    GError ** error)
+{
+#ifndef G_OS_WIN32
+  struct sockaddr_storage addr;
+  struct msghdr msg;
+  struct iovec iov;
+  union
+  {
+    struct cmsghdr align;
+    gchar buf[256];
+  } control;
+  gssize ret;
+
+  *timestamp = GST_CLOCK_TIME_NONE;
+
+  memset (&msg, 0, sizeof (msg));
+  iov.iov_base = buffer;
+  iov.iov_len = size;
+  msg.msg_name = &addr;
+  msg.msg_namelen = sizeof (addr);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+  while ((ret = recvmsg (g_socket_get_fd (socket), &msg, 0)) < 0) {
+    gint errsv = errno;
+
+    if (errsv == EINTR)
+      continue;
+
+    /* GSocket fds are always non-blocking, wait like GSocket does */
+    if ((errsv == EAGAIN || errsv == EWOULDBLOCK)
+        && g_socket_get_blocking (socket)) {
+      if (!g_socket_condition_wait (socket, G_IO_IN, NULL, error))
+        return -1;
+      continue;
+    }
+
+
+    g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+        "Error receiving message: %s", g_strerror (errsv));
+    return -1;
+  }
+
+  if (src_address)
+    *src_address = g_socket_address_new_from_native (&addr, msg.msg_namelen);
+
+  *timestamp = gst_net_socket_parse_timestamp (&msg);
+
+  return ret;
+#else
+  GError *err = NULL;
+  gssize ret;
+
+  *timestamp = GST_CLOCK_TIME_NONE;
+
+  do {
+    g_clear_error (&err);
+    ret = g_socket_receive_from (socket, src_address, (gchar *) buffer, size,
+        NULL, &err);
+  } while (ret < 0 && err->code == G_IO_ERROR_WOULD_BLOCK);
+
+  if (ret < 0)
+    g_propagate_error (error, err);
+
+  return ret;
+#endif
+}
+
+/* Returns how long ago the kernel received a packet with the given
+ * @timestamp, or GST_CLOCK_TIME_NONE if it can't be used */
+GstClockTime
+gst_net_socket_timestamp_get_age (GstClockTime timestamp)
+{
+  GstClockTime now;
+
+  if (!GST_CLOCK_TIME_IS_VALID (timestamp))
+    return GST_CLOCK_TIME_NONE;
+
+#ifdef HAVE_CLOCK_GETTIME
+  {
+    struct timespec ts;
+
+    clock_gettime (CLOCK_REALTIME, &ts);
+    now = GST_TIMESPEC_TO_TIME (ts);
+  }
+#else
+  now = g_get_real_time () * GST_USECOND;
+#endif
+
+  if (timestamp > now || now - timestamp > MAX_TIMESTAMP_AGE)
+    return GST_CLOCK_TIME_NONE;
+
+  return now - timestamp;
+}
@@ -0,0 +1,48 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_NET_SOCKET_UTILS_H__
+#define __GST_NET_SOCKET_UTILS_H__
+
+#include <gst/gst.h>
+#include <gio/gio.h>
+
+#ifndef G_OS_WIN32
+#include <sys/socket.h>
+#endif
+
+G_BEGIN_DECLS
+
+gboolean       gst_net_socket_enable_timestamps   (GSocket         * socket) G_GNUC_INTERNAL;
+
+gssize         gst_net_socket_receive_timestamped (GSocket         * socket,
+                                                   guint8          * buffer,
+                                                   gsize             size,
+                                                   GSocketAddress ** src_address,
+                                                   GstClockTime    * timestamp,
+                                                   GError         ** error) G_GNUC_INTERNAL;
+
+#ifndef G_OS_WIN32
+GstClockTime   gst_net_socket_parse_timestamp     (struct msghdr   * msg) G_GNUC_INTERNAL;
+#endif
+
+GstClockTime   gst_net_socket_timestamp_get_age   (GstClockTime      timestamp) G_GNUC_INTERNAL;
+
+G_END_DECLS
+
+#endif /* __GST_NET_SOCKET_UTILS_H__ */
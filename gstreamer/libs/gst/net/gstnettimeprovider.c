@@ -37,8 +37,21 @@
 #include "config.h"
 #endif
 
+#if defined(HAVE_RECVMMSG) && defined(HAVE_SENDMMSG) && !defined(G_OS_WIN32)
+#define _GNU_SOURCE 1
+#define USE_MMSG 1
+#endif
+
 #include "gstnettimeprovider.h"
 #include "gstnettimepacket.h"
+#include "gstnetsocketutils.h"
+
+#ifdef USE_MMSG
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 GST_DEBUG_CATEGORY_STATIC (ntp_debug);
 #define GST_CAT_DEFAULT (ntp_debug)
@@ -46,6 +59,9 @@ GST_DEBUG_CATEGORY_STATIC (ntp_debug);
 #define DEFAULT_ADDRESS         "0.0.0.0"
 #define DEFAULT_PORT            5637
 
+/* Maximum number of requests received and answered with one system call */
+#define BATCH_SIZE              64
+
 #define IS_ACTIVE(self) (g_atomic_int_get (&((self)->priv->active)))
 
 enum
@@ -163,20 +179,152 @@ gst_net_time_provider_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+/* Fills in the remote time of the request in @data, which was received by
+ * the kernel at @timestamp. The time is placed in the middle of the time the
+ * request spent waiting in the socket queue and in here, so that queueing on
+ * a busy provider does not make the answers asymmetric for the clients */
+static void
+gst_net_time_provider_answer (GstNetTimeProvider * self, guint8 * data,
+    GstClockTime timestamp)
+{
+  GstClockTime remote_time, age;
+
+  remote_time = gst_clock_get_time (self->priv->clock);
+  age = gst_net_socket_timestamp_get_age (timestamp);
+  if (GST_CLOCK_TIME_IS_VALID (age) && remote_time > age / 2)
+    remote_time -= age / 2;
+
+  /* remote_time follows the local_time in the packet */
+  GST_WRITE_UINT64_BE (data + 8, remote_time);
+}
+
+#ifdef USE_MMSG
+/* Receives and answers up to BATCH_SIZE pending requests. Returns FALSE if
+ * there was nothing to receive */
+static gboolean
+gst_net_time_provider_handle_batch (GstNetTimeProvider * self)
+{
+  gint fd = g_socket_get_fd (self->priv->socket);
+  struct mmsghdr msgs[BATCH_SIZE];
+  struct iovec iovs[BATCH_SIZE];
+  struct sockaddr_storage addrs[BATCH_SIZE];
+  guint8 buffers[BATCH_SIZE][GST_NET_TIME_PACKET_SIZE];
+  union
+  {
+    struct cmsghdr align;
+    gchar buf[64];
+  } controls[BATCH_SIZE];
+  gint i, n_received, n_answers, n_sent;
+
+  memset (msgs, 0, sizeof (msgs));
+  for (i = 0; i < BATCH_SIZE; i++) {
+    iovs[i].iov_base = buffers[i];
+    iovs[i].iov_len = GST_NET_TIME_PACKET_SIZE;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof (addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_control = controls[i].buf;
+    msgs[i].msg_hdr.msg_controllen = sizeof (controls[i].buf);
+  }
+
+  do {
+    n_received = recvmmsg (fd, msgs, BATCH_SIZE, MSG_DONTWAIT, NULL);
+  } while (n_received < 0 && errno == EINTR);
+
+  if (n_received <= 0) {
+    if (n_received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+      GST_DEBUG_OBJECT (self, "receive error: %s", g_strerror (errno));
+    return FALSE;
+  }
+
+  GST_LOG_OBJECT (self, "received %d requests", n_received);
+
+  if (!IS_ACTIVE (self))
+    return TRUE;
+
+  /* Answer all complete requests in place, compacting them at the start of
+   * the array for sending them back in one go */
+  n_answers = 0;
+  for (i = 0; i < n_received; i++) {
+    if (msgs[i].msg_len < GST_NET_TIME_PACKET_SIZE) {
+      GST_DEBUG_OBJECT (self, "someone sent us a short packet (%u < %d)",
+          msgs[i].msg_len, GST_NET_TIME_PACKET_SIZE);
+      continue;
+    }
+
+    gst_net_time_provider_answer (self, buffers[i],
+        gst_net_socket_parse_timestamp (&msgs[i].msg_hdr));
+
+    if (n_answers != i)
+      msgs[n_answers] = msgs[i];
+    msgs[n_answers].msg_hdr.msg_control = NULL;
+    msgs[n_answers].msg_hdr.msg_controllen = 0;
+    msgs[n_answers].msg_hdr.msg_flags = 0;
+    n_answers++;
+  }
+
+  /* ignore errors */
+  n_sent = 0;
+  while (n_sent < n_answers) {
+    gint ret = sendmmsg (fd, msgs + n_sent, n_answers - n_sent, 0);
+
+    if (ret < 0) {
+      if (errno == EINTR)
+        continue;
+      GST_DEBUG_OBJECT (self, "send error: %s", g_strerror (errno));
+      break;
+    }
+    n_sent += ret;
+  }
+
+  return TRUE;
+}
+#else
+static void
+gst_net_time_provider_handle_request (GstNetTimeProvider * self)
+{
+  guint8 buffer[GST_NET_TIME_PACKET_SIZE];
+  GSocketAddress *sender_addr = NULL;
+  GstClockTime timestamp;
+  GError *err = NULL;
+  gssize ret;
+
+  ret = gst_net_socket_receive_timestamped (self->priv->socket, buffer,
+      GST_NET_TIME_PACKET_SIZE, &sender_addr, &timestamp, &err);
+
+  if (ret < 0) {
+    GST_DEBUG_OBJECT (self, "receive error: %s", err->message);
+    g_usleep (G_USEC_PER_SEC / 10);
+    g_error_free (err);
+    return;
+  } else if (ret < GST_NET_TIME_PACKET_SIZE) {
+    GST_DEBUG_OBJECT (self, "someone sent us a short packet (%"
+        G_GSSIZE_FORMAT " < %d)", ret, GST_NET_TIME_PACKET_SIZE);
+  } else if (IS_ACTIVE (self)) {
+    /* do what we were asked to and send the packet back */
+    gst_net_time_provider_answer (self, buffer, timestamp);
+
+    /* ignore errors */
+    g_socket_send_to (self->priv->socket, sender_addr, (const gchar *) buffer,
+        GST_NET_TIME_PACKET_SIZE, NULL, NULL);
+  }
+
+  g_clear_object (&sender_addr);
+}
+#endif
+
 static gpointer
 gst_net_time_provider_thread (gpointer data)
 {
   GstNetTimeProvider *self = data;
   GCancellable *cancel = self->priv->cancel;
   GSocket *socket = self->priv->socket;
-  GstNetTimePacket *packet;
   GError *err = NULL;
 
   GST_INFO_OBJECT (self, "time provider thread is running");
 
   while (TRUE) {
-    GSocketAddress *sender_addr = NULL;
-
     GST_LOG_OBJECT (self, "waiting on socket");
     if (!g_socket_condition_wait (socket, G_IO_IN, cancel, &err)) {
       GST_INFO_OBJECT (self, "socket error: %s", err->message);
@@ -192,25 +340,13 @@ gst_net_time_provider_thread (gpointer data)
     }
 
     /* got data in */
-    packet = gst_net_time_packet_receive (socket, &sender_addr, &err);
-
-    if (err != NULL) {
-      GST_DEBUG_OBJECT (self, "receive error: %s", err->message);
-      g_usleep (G_USEC_PER_SEC / 10);
-      g_error_free (err);
-      err = NULL;
-      continue;
-    }
-
-    if (IS_ACTIVE (self)) {
-      /* do what we were asked to and send the packet back */
-      packet->remote_time = gst_clock_get_time (self->priv->clock);
-
-      /* ignore errors */
-      gst_net_time_packet_send (packet, socket, sender_addr, NULL);
-      g_object_unref (sender_addr);
-      g_free (packet);
-    }
+#ifdef USE_MMSG
+    /* drain the socket before waiting again */
+    while (!g_cancellable_is_cancelled (cancel)
+        && gst_net_time_provider_handle_batch (self));
+#else
+    gst_net_time_provider_handle_request (self);
+#endif
   }
 
   g_error_free (err);
@@ -338,6 +474,8 @@ gst_net_time_provider_start (GstNetTimeProvider * self, GError ** error)
       self->priv->address, port);
   g_object_unref (bound_addr);
 
+  gst_net_socket_enable_timestamps (socket);
+
   self->priv->socket = socket;
   self->priv->cancel = g_cancellable_new ();
   self->priv->made_cancel_fd =
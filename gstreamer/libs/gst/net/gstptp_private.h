@@ -3,11 +3,20 @@
 
 #include <glib.h>
 
+/* Messages from the helper of type TYPE_EVENT and TYPE_GENERAL are prefixed
+ * with the kernel receive timestamp of the packet, and TYPE_EVENT_TX_TIMESTAMP
+ * messages with the kernel send timestamp of the event message they carry.
+ * These timestamps are big-endian 64 bit nanoseconds in CLOCK_REALTIME, or
+ * GST_CLOCK_TIME_NONE if the kernel did not provide any. Messages to the
+ * helper carry no timestamp. */
+#define STDIO_MESSAGE_TIMESTAMP_SIZE 8
+
 enum
 {
   TYPE_EVENT,
   TYPE_GENERAL,
-  TYPE_CLOCK_ID
+  TYPE_CLOCK_ID,
+  TYPE_EVENT_TX_TIMESTAMP
 };
 
 typedef struct
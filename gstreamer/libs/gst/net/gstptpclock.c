@@ -247,6 +247,7 @@ static GMainLoop *main_loop;
 static GIOChannel *stdin_channel, *stdout_channel;
 static GRand *delay_req_rand;
 static GstClock *observation_system_clock;
+static GstClock *observation_realtime_clock;
 static PtpClockIdentity ptp_clock_id = { GST_PTP_CLOCK_ID_NONE, 0 };
 
 typedef struct
@@ -1735,6 +1736,73 @@ handle_ptp_message (PtpMessage * msg, GstClockTime receive_time)
   }
 }
 
+/* Converts a CLOCK_REALTIME kernel timestamp of a packet to the observation
+ * clock by going back from the current time by as much as the packet spent
+ * in the socket queues, the helper process and the pipe */
+static GstClockTime
+kernel_timestamp_to_observation_time (GstClockTime timestamp)
+{
+  GstClockTime now, now_realtime;
+
+  now = gst_clock_get_time (observation_system_clock);
+  if (!GST_CLOCK_TIME_IS_VALID (timestamp))
+    return now;
+
+  now_realtime = gst_clock_get_time (observation_realtime_clock);
+
+  /* The wall clock was stepped in the meantime or the packet is stale */
+  if (timestamp > now_realtime || now_realtime - timestamp > GST_SECOND
+      || now_realtime - timestamp > now) {
+    GST_DEBUG ("Ignoring bogus kernel timestamp %" GST_TIME_FORMAT
+        " at %" GST_TIME_FORMAT, GST_TIME_ARGS (timestamp),
+        GST_TIME_ARGS (now_realtime));
+    return now;
+  }
+
+  return now - (now_realtime - timestamp);
+}
+
+static void
+handle_event_tx_timestamp (PtpMessage * msg, GstClockTime send_time)
+{
+  GList *l;
+  PtpDomainData *domain = NULL;
+
+  if (msg->message_type != PTP_MESSAGE_TYPE_DELAY_REQ)
+    return;
+
+  for (l = domain_data; l; l = l->next) {
+    PtpDomainData *tmp = l->data;
+
+    if (msg->domain_number == tmp->domain) {
+      domain = tmp;
+      break;
+    }
+  }
+
+  if (!domain)
+    return;
+
+  for (l = domain->pending_syncs.head; l; l = l->next) {
+    PtpPendingSync *sync = l->data;
+
+    if (sync->delay_req_seqnum != msg->sequence_id)
+      continue;
+
+    /* Only replace the time taken before handing the DELAY_REQ to the
+     * helper, and only as long as the DELAY_RESP was not handled yet */
+    if (sync->delay_req_recv_time_remote == GST_CLOCK_TIME_NONE
+        && sync->delay_req_send_time_local != GST_CLOCK_TIME_NONE
+        && send_time >= sync->delay_req_send_time_local) {
+      GST_TRACE ("Kernel send time for DELAY_REQ %u in domain %u is %"
+          GST_TIME_FORMAT " later", msg->sequence_id, domain->domain,
+          GST_TIME_ARGS (send_time - sync->delay_req_send_time_local));
+      sync->delay_req_send_time_local = send_time;
+    }
+    break;
+  }
+}
+
 static gboolean
 have_stdin_data_cb (GIOChannel * channel, GIOCondition condition,
     gpointer user_data)
@@ -1799,13 +1867,30 @@ have_stdin_data_cb (GIOChannel * channel, GIOCondition condition,
 
   switch (header.type) {
     case TYPE_EVENT:
-    case TYPE_GENERAL:{
-      GstClockTime receive_time = gst_clock_get_time (observation_system_clock);
+    case TYPE_GENERAL:
+    case TYPE_EVENT_TX_TIMESTAMP:{
+      GstClockTime timestamp;
       PtpMessage msg;
 
-      if (parse_ptp_message (&msg, (const guint8 *) buffer, header.size)) {
-        dump_ptp_message (&msg);
-        handle_ptp_message (&msg, receive_time);
+      if (header.size < STDIO_MESSAGE_TIMESTAMP_SIZE) {
+        GST_ERROR ("Unexpected message size (%u < %u)", header.size,
+            STDIO_MESSAGE_TIMESTAMP_SIZE);
+        g_main_loop_quit (main_loop);
+        return G_SOURCE_REMOVE;
+      }
+
+      timestamp =
+          kernel_timestamp_to_observation_time (GST_READ_UINT64_BE (buffer));
+
+      if (parse_ptp_message (&msg,
+              (const guint8 *) buffer + STDIO_MESSAGE_TIMESTAMP_SIZE,
+              header.size - STDIO_MESSAGE_TIMESTAMP_SIZE)) {
+        if (header.type == TYPE_EVENT_TX_TIMESTAMP) {
+          handle_event_tx_timestamp (&msg, timestamp);
+        } else {
+          dump_ptp_message (&msg);
+          handle_ptp_message (&msg, timestamp);
+        }
       }
       break;
     }
@@ -2112,6 +2197,11 @@ gst_ptp_init (guint64 clock_id, gchar ** interfaces)
   observation_system_clock =
       g_object_new (GST_TYPE_SYSTEM_CLOCK, "name", "ptp-observation-clock",
       NULL);
+  /* The helper reports kernel packet timestamps in wall clock time */
+  observation_realtime_clock =
+      g_object_new (GST_TYPE_SYSTEM_CLOCK, "name",
+      "ptp-observation-realtime-clock", "clock-type", GST_CLOCK_TYPE_REALTIME,
+      NULL);
 
   initted = TRUE;
 
@@ -2172,6 +2262,10 @@ done:
     if (observation_system_clock)
       gst_object_unref (observation_system_clock);
     observation_system_clock = NULL;
+
+    if (observation_realtime_clock)
+      gst_object_unref (observation_realtime_clock);
+    observation_realtime_clock = NULL;
   }
 
   g_mutex_unlock (&ptp_lock);
@@ -2235,6 +2329,9 @@ gst_ptp_deinit (void)
   if (observation_system_clock)
     gst_object_unref (observation_system_clock);
   observation_system_clock = NULL;
+  if (observation_realtime_clock)
+    gst_object_unref (observation_realtime_clock);
+  observation_realtime_clock = NULL;
 
   for (l = domain_data; l; l = l->next) {
     PtpDomainData *domain = l->data;
@@ -1189,14 +1189,13 @@ gst_download_buffer_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     gsize start, stop;
 
     /* we have everything up to the end, find a region to fill */
-    if (gst_sparse_file_get_range_after (dlbuf->file, 0, &start, &stop)) {
-      if (stop < dlbuf->upstream_size) {
-        /* a hole to fill, seek to its end */
-        perform_seek_to_offset (dlbuf, stop);
-      } else {
-        /* we filled all the holes, we are done */
-        goto completed;
-      }
+    gst_sparse_file_get_missing_range (dlbuf->file, 0, &start, &stop);
+    if (start < dlbuf->upstream_size) {
+      /* a hole to fill, seek to its start */
+      perform_seek_to_offset (dlbuf, start);
+    } else {
+      /* we filled all the holes, we are done */
+      goto completed;
     }
   } else {
     /* see if we need to skip this region or just read it again. The idea
@@ -112,6 +112,7 @@ GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define DEFAULT_BUFFER_MODE 	GST_FILE_SINK_BUFFER_MODE_DEFAULT
 #define DEFAULT_BUFFER_SIZE 	64 * 1024
 #define DEFAULT_APPEND		FALSE
+#define DEFAULT_MAX_PENDING_WRITES	0
 
 enum
 {
@@ -120,6 +121,7 @@ enum
   PROP_BUFFER_MODE,
   PROP_BUFFER_SIZE,
   PROP_APPEND,
+  PROP_MAX_PENDING_WRITES,
   PROP_LAST
 };
 
@@ -162,6 +164,7 @@ gst_fopen (const gchar * filename, const gchar * mode)
 }
 
 static void gst_file_sink_dispose (GObject * object);
+static void gst_file_sink_finalize (GObject * object);
 
 static void gst_file_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -174,6 +177,8 @@ static void gst_file_sink_close_file (GstFileSink * sink);
 static gboolean gst_file_sink_start (GstBaseSink * sink);
 static gboolean gst_file_sink_stop (GstBaseSink * sink);
 static gboolean gst_file_sink_event (GstBaseSink * sink, GstEvent * event);
+static gboolean gst_file_sink_unlock (GstBaseSink * sink);
+static gboolean gst_file_sink_unlock_stop (GstBaseSink * sink);
 static GstFlowReturn gst_file_sink_render (GstBaseSink * sink,
     GstBuffer * buffer);
 static GstFlowReturn gst_file_sink_render_list (GstBaseSink * sink,
@@ -186,6 +191,11 @@ static gboolean gst_file_sink_get_current_offset (GstFileSink * filesink,
 
 static gboolean gst_file_sink_query (GstBaseSink * bsink, GstQuery * query);
 
+static gboolean gst_file_sink_start_writer (GstFileSink * sink);
+static void gst_file_sink_stop_writer (GstFileSink * sink);
+static GstFlowReturn gst_file_sink_wait_writer (GstFileSink * sink,
+    gboolean discard);
+
 static void gst_file_sink_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
 
@@ -204,6 +214,7 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
   GstBaseSinkClass *gstbasesink_class = GST_BASE_SINK_CLASS (klass);
 
   gobject_class->dispose = gst_file_sink_dispose;
+  gobject_class->finalize = gst_file_sink_finalize;
 
   gobject_class->set_property = gst_file_sink_set_property;
   gobject_class->get_property = gst_file_sink_get_property;
@@ -234,6 +245,27 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
           "Append to an already existing file", DEFAULT_APPEND,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstFileSink:max-pending-writes:
+   *
+   * When not 0, buffers are written to the file from a separate thread so
+   * that the streaming thread doesn't block on slow storage. The streaming
+   * thread only blocks when this many buffers or buffer lists are still
+   * waiting to be written. Write errors are returned from the next render
+   * call. Buffers with the %GST_BUFFER_FLAG_SYNC_AFTER flag are synced to
+   * disk by the writer thread after they were written.
+   *
+   * The property is only used when the file is opened.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PENDING_WRITES,
+      g_param_spec_uint ("max-pending-writes", "Max pending writes",
+          "Maximum number of buffers queued for writing from a separate "
+          "thread (0 = write from the streaming thread)", 0, G_MAXUINT,
+          DEFAULT_MAX_PENDING_WRITES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "File Sink",
       "Sink/File", "Write stream to a file",
@@ -247,6 +279,9 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
   gstbasesink_class->render_list =
       GST_DEBUG_FUNCPTR (gst_file_sink_render_list);
   gstbasesink_class->event = GST_DEBUG_FUNCPTR (gst_file_sink_event);
+  gstbasesink_class->unlock = GST_DEBUG_FUNCPTR (gst_file_sink_unlock);
+  gstbasesink_class->unlock_stop =
+      GST_DEBUG_FUNCPTR (gst_file_sink_unlock_stop);
 
   if (sizeof (off_t) < 8) {
     GST_LOG ("No large file support, sizeof (off_t) = %" G_GSIZE_FORMAT "!",
@@ -264,6 +299,10 @@ gst_file_sink_init (GstFileSink * filesink)
   filesink->buffer_size = DEFAULT_BUFFER_SIZE;
   filesink->buffer = NULL;
   filesink->append = FALSE;
+  filesink->max_pending_writes = DEFAULT_MAX_PENDING_WRITES;
+  g_mutex_init (&filesink->writer_lock);
+  g_cond_init (&filesink->writer_cond);
+  g_queue_init (&filesink->writer_queue);
 
   gst_base_sink_set_sync (GST_BASE_SINK (filesink), FALSE);
 }
@@ -284,6 +323,17 @@ gst_file_sink_dispose (GObject * object)
   sink->buffer_size = 0;
 }
 
+static void
+gst_file_sink_finalize (GObject * object)
+{
+  GstFileSink *sink = GST_FILE_SINK (object);
+
+  g_mutex_clear (&sink->writer_lock);
+  g_cond_clear (&sink->writer_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static gboolean
 gst_file_sink_set_location (GstFileSink * sink, const gchar * location,
     GError ** error)
@@ -338,6 +388,9 @@ gst_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_APPEND:
       sink->append = g_value_get_boolean (value);
       break;
+    case PROP_MAX_PENDING_WRITES:
+      sink->max_pending_writes = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -363,6 +416,9 @@ gst_file_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_APPEND:
       g_value_set_boolean (value, sink->append);
       break;
+    case PROP_MAX_PENDING_WRITES:
+      g_value_set_uint (value, sink->max_pending_writes);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -422,6 +478,14 @@ gst_file_sink_open_file (GstFileSink * sink)
   GST_DEBUG_OBJECT (sink, "opened file %s, seekable %d",
       sink->filename, sink->seekable);
 
+  if (sink->max_pending_writes > 0 && !gst_file_sink_start_writer (sink)) {
+    fclose (sink->file);
+    sink->file = NULL;
+    g_free (sink->buffer);
+    sink->buffer = NULL;
+    return FALSE;
+  }
+
   return TRUE;
 
   /* ERRORS */
@@ -444,6 +508,8 @@ static void
 gst_file_sink_close_file (GstFileSink * sink)
 {
   if (sink->file) {
+    gst_file_sink_stop_writer (sink);
+
     if (fclose (sink->file) != 0)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), GST_ERROR_SYSTEM);
@@ -578,6 +644,8 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
         /* only try to seek and fail when we are going to a different
          * position */
         if (filesink->current_pos != segment->start) {
+          if (gst_file_sink_wait_writer (filesink, FALSE) != GST_FLOW_OK)
+            goto wait_failed;
           /* FIXME, the seek should be performed on the pos field, start/stop are
            * just boundaries for valid bytes offsets. We should also fill the file
            * with zeroes if the new position extends the current EOF (sparse streams
@@ -595,6 +663,9 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
       break;
     }
     case GST_EVENT_FLUSH_STOP:
+      /* the data is thrown away below anyway */
+      gst_file_sink_wait_writer (filesink, TRUE);
+      filesink->writer_flow = GST_FLOW_OK;
       if (filesink->current_pos != 0 && filesink->seekable) {
         gst_file_sink_do_seek (filesink, 0);
         if (ftruncate (fileno (filesink->file), 0))
@@ -602,6 +673,8 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
       }
       break;
     case GST_EVENT_EOS:
+      if (gst_file_sink_wait_writer (filesink, FALSE) != GST_FLOW_OK)
+        goto wait_failed;
       if (fflush (filesink->file))
         goto flush_failed;
       break;
@@ -628,6 +701,13 @@ flush_failed:
     gst_event_unref (event);
     return FALSE;
   }
+wait_failed:
+  {
+    /* the writer thread posted the error already */
+    GST_DEBUG_OBJECT (filesink, "pending writes failed");
+    gst_event_unref (event);
+    return FALSE;
+  }
 }
 
 static gboolean
@@ -655,29 +735,40 @@ gst_file_sink_get_current_offset (GstFileSink * filesink, guint64 * p_pos)
 
 static GstFlowReturn
 gst_file_sink_render_buffers (GstFileSink * sink, GstBuffer ** buffers,
-    guint num_buffers, guint8 * mem_nums, guint total_mems)
+    guint num_buffers, guint8 * mem_nums, guint total_mems,
+    gboolean sync_after, guint64 * cur_pos)
 {
+  GstFlowReturn flow;
+
   GST_DEBUG_OBJECT (sink,
       "writing %u buffers (%u memories) at position %" G_GUINT64_FORMAT,
       num_buffers, total_mems, sink->current_pos);
 
-  return gst_writev_buffers (GST_OBJECT_CAST (sink), fileno (sink->file), NULL,
-      buffers, num_buffers, mem_nums, total_mems, NULL, &sink->current_pos);
+  flow = gst_writev_buffers (GST_OBJECT_CAST (sink), fileno (sink->file), NULL,
+      buffers, num_buffers, mem_nums, total_mems, NULL, cur_pos);
+
+  if (flow == GST_FLOW_OK && sync_after) {
+    if (fflush (sink->file) || fsync (fileno (sink->file))) {
+      GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+          (_("Error while writing to file \"%s\"."), sink->filename),
+          ("%s", g_strerror (errno)));
+      flow = GST_FLOW_ERROR;
+    }
+  }
+
+  return flow;
 }
 
 static GstFlowReturn
-gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
+gst_file_sink_write_list (GstFileSink * sink, GstBufferList * buffer_list,
+    guint64 * cur_pos)
 {
-  GstFlowReturn flow;
   GstBuffer **buffers;
-  GstFileSink *sink;
   guint8 *mem_nums;
   guint total_mems;
   guint i, num_buffers;
   gboolean sync_after = FALSE;
 
-  sink = GST_FILE_SINK_CAST (bsink);
-
   num_buffers = gst_buffer_list_length (buffer_list);
   if (num_buffers == 0)
     goto no_data;
@@ -693,55 +784,241 @@ gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
       sync_after = TRUE;
   }
 
-  flow =
-      gst_file_sink_render_buffers (sink, buffers, num_buffers, mem_nums,
-      total_mems);
+  return gst_file_sink_render_buffers (sink, buffers, num_buffers, mem_nums,
+      total_mems, sync_after, cur_pos);
 
-  if (flow == GST_FLOW_OK && sync_after) {
-    if (fflush (sink->file) || fsync (fileno (sink->file))) {
-      GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
-          (_("Error while writing to file \"%s\"."), sink->filename),
-          ("%s", g_strerror (errno)));
-      flow = GST_FLOW_ERROR;
+no_data:
+  {
+    GST_LOG_OBJECT (sink, "empty buffer list");
+    return GST_FLOW_OK;
+  }
+}
+
+static GstFlowReturn
+gst_file_sink_write_buffer (GstFileSink * sink, GstBuffer * buffer,
+    guint64 * cur_pos)
+{
+  gboolean sync_after;
+  guint8 n_mem;
+
+  n_mem = gst_buffer_n_memory (buffer);
+  sync_after = GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_SYNC_AFTER);
+
+  if (n_mem == 0 && !sync_after)
+    return GST_FLOW_OK;
+
+  return gst_file_sink_render_buffers (sink, &buffer, 1, &n_mem, n_mem,
+      sync_after, cur_pos);
+}
+
+static gpointer
+gst_file_sink_writer_func (GstFileSink * sink)
+{
+  GstMiniObject *obj;
+  GstFlowReturn flow;
+
+  GST_DEBUG_OBJECT (sink, "writer thread started");
+
+  g_mutex_lock (&sink->writer_lock);
+  while (TRUE) {
+    obj = g_queue_pop_head (&sink->writer_queue);
+    if (obj == NULL) {
+      if (sink->writer_stop)
+        break;
+      g_cond_wait (&sink->writer_cond, &sink->writer_lock);
+      continue;
     }
+    sink->writer_busy = TRUE;
+    g_mutex_unlock (&sink->writer_lock);
+
+    /* the position was already updated when queueing */
+    if (GST_IS_BUFFER (obj))
+      flow = gst_file_sink_write_buffer (sink, GST_BUFFER_CAST (obj), NULL);
+    else
+      flow = gst_file_sink_write_list (sink, GST_BUFFER_LIST_CAST (obj), NULL);
+    gst_mini_object_unref (obj);
+
+    g_mutex_lock (&sink->writer_lock);
+    sink->writer_busy = FALSE;
+    if (flow != GST_FLOW_OK && sink->writer_flow == GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (sink, "write failed: %s", gst_flow_get_name (flow));
+      sink->writer_flow = flow;
+    }
+    g_cond_broadcast (&sink->writer_cond);
   }
+  g_mutex_unlock (&sink->writer_lock);
 
-  return flow;
+  GST_DEBUG_OBJECT (sink, "writer thread stopped");
 
-no_data:
+  return NULL;
+}
+
+static gboolean
+gst_file_sink_start_writer (GstFileSink * sink)
+{
+  GError *err = NULL;
+
+  sink->writer_stop = FALSE;
+  sink->writer_flow = GST_FLOW_OK;
+  sink->writer = g_thread_try_new ("filesink-writer",
+      (GThreadFunc) gst_file_sink_writer_func, sink, &err);
+  if (sink->writer == NULL)
+    goto no_thread;
+
+  return TRUE;
+
+  /* ERRORS */
+no_thread:
   {
-    GST_LOG_OBJECT (sink, "empty buffer list");
+    GST_ELEMENT_ERROR (sink, RESOURCE, FAILED, (NULL),
+        ("Could not create writer thread: %s", err->message));
+    g_error_free (err);
+    return FALSE;
+  }
+}
+
+static void
+gst_file_sink_stop_writer (GstFileSink * sink)
+{
+  if (sink->writer == NULL)
+    return;
+
+  /* the writer writes out everything still queued before it stops */
+  g_mutex_lock (&sink->writer_lock);
+  sink->writer_stop = TRUE;
+  g_cond_broadcast (&sink->writer_cond);
+  g_mutex_unlock (&sink->writer_lock);
+
+  g_thread_join (sink->writer);
+  sink->writer = NULL;
+}
+
+/* waits until the writer thread wrote, or with @discard dropped, all queued
+ * buffers and returns the result of the writes */
+static GstFlowReturn
+gst_file_sink_wait_writer (GstFileSink * sink, gboolean discard)
+{
+  GstFlowReturn flow;
+
+  if (sink->writer == NULL)
     return GST_FLOW_OK;
+
+  g_mutex_lock (&sink->writer_lock);
+  if (discard) {
+    g_queue_foreach (&sink->writer_queue, (GFunc) gst_mini_object_unref, NULL);
+    g_queue_clear (&sink->writer_queue);
+  }
+  while (sink->writer_busy || !g_queue_is_empty (&sink->writer_queue))
+    g_cond_wait (&sink->writer_cond, &sink->writer_lock);
+  flow = sink->writer_flow;
+  g_mutex_unlock (&sink->writer_lock);
+
+  return flow;
+}
+
+/* takes ownership of @obj */
+static GstFlowReturn
+gst_file_sink_queue_write (GstFileSink * sink, GstMiniObject * obj,
+    gsize size)
+{
+  GstFlowReturn flow;
+
+  g_mutex_lock (&sink->writer_lock);
+  while ((flow = sink->writer_flow) == GST_FLOW_OK && !sink->flushing &&
+      sink->writer_queue.length >= sink->max_pending_writes) {
+    GST_LOG_OBJECT (sink, "waiting for %u pending writes",
+        sink->writer_queue.length);
+    g_cond_wait (&sink->writer_cond, &sink->writer_lock);
+  }
+  if (flow != GST_FLOW_OK)
+    goto write_failed;
+  if (sink->flushing)
+    goto flushing;
+
+  g_queue_push_tail (&sink->writer_queue, obj);
+  g_cond_broadcast (&sink->writer_cond);
+  g_mutex_unlock (&sink->writer_lock);
+
+  sink->current_pos += size;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+write_failed:
+  {
+    /* the writer thread posted the error already */
+    g_mutex_unlock (&sink->writer_lock);
+    gst_mini_object_unref (obj);
+    return flow;
+  }
+flushing:
+  {
+    GST_DEBUG_OBJECT (sink, "we are flushing");
+    g_mutex_unlock (&sink->writer_lock);
+    gst_mini_object_unref (obj);
+    return GST_FLOW_FLUSHING;
   }
 }
 
+static GstFlowReturn
+gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
+{
+  GstFileSink *sink;
+  gsize size = 0;
+  guint i, num_buffers;
+
+  sink = GST_FILE_SINK_CAST (bsink);
+
+  if (sink->writer == NULL)
+    return gst_file_sink_write_list (sink, buffer_list, &sink->current_pos);
+
+  num_buffers = gst_buffer_list_length (buffer_list);
+  for (i = 0; i < num_buffers; ++i)
+    size += gst_buffer_get_size (gst_buffer_list_get (buffer_list, i));
+
+  return gst_file_sink_queue_write (sink,
+      GST_MINI_OBJECT_CAST (gst_buffer_list_ref (buffer_list)), size);
+}
+
 static GstFlowReturn
 gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
 {
   GstFileSink *filesink;
-  GstFlowReturn flow;
-  guint8 n_mem;
 
   filesink = GST_FILE_SINK_CAST (sink);
 
-  n_mem = gst_buffer_n_memory (buffer);
+  if (filesink->writer == NULL)
+    return gst_file_sink_write_buffer (filesink, buffer,
+        &filesink->current_pos);
 
-  if (n_mem > 0)
-    flow = gst_file_sink_render_buffers (filesink, &buffer, 1, &n_mem, n_mem);
-  else
-    flow = GST_FLOW_OK;
+  return gst_file_sink_queue_write (filesink,
+      GST_MINI_OBJECT_CAST (gst_buffer_ref (buffer)),
+      gst_buffer_get_size (buffer));
+}
 
-  if (flow == GST_FLOW_OK &&
-      GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_SYNC_AFTER)) {
-    if (fflush (filesink->file) || fsync (fileno (filesink->file))) {
-      GST_ELEMENT_ERROR (filesink, RESOURCE, WRITE,
-          (_("Error while writing to file \"%s\"."), filesink->filename),
-          ("%s", g_strerror (errno)));
-      flow = GST_FLOW_ERROR;
-    }
-  }
+static gboolean
+gst_file_sink_unlock (GstBaseSink * basesink)
+{
+  GstFileSink *sink = GST_FILE_SINK_CAST (basesink);
 
-  return flow;
+  g_mutex_lock (&sink->writer_lock);
+  sink->flushing = TRUE;
+  g_cond_broadcast (&sink->writer_cond);
+  g_mutex_unlock (&sink->writer_lock);
+
+  return TRUE;
+}
+
+static gboolean
+gst_file_sink_unlock_stop (GstBaseSink * basesink)
+{
+  GstFileSink *sink = GST_FILE_SINK_CAST (basesink);
+
+  g_mutex_lock (&sink->writer_lock);
+  sink->flushing = FALSE;
+  g_mutex_unlock (&sink->writer_lock);
+
+  return TRUE;
 }
 
 static gboolean
@@ -83,6 +83,17 @@ struct _GstFileSink {
   gchar  *buffer;
 
   gboolean append;
+
+  /* writer thread, when max-pending-writes is not 0 */
+  guint    max_pending_writes;
+  GThread *writer;
+  GMutex   writer_lock;
+  GCond    writer_cond;
+  GQueue   writer_queue;
+  gboolean writer_busy;
+  gboolean writer_stop;
+  gboolean flushing;
+  GstFlowReturn writer_flow;
 };
 
 struct _GstFileSinkClass {
@@ -64,6 +64,9 @@
 #ifdef HAVE_UNISTD_H
 #  include <unistd.h>
 #endif
+#ifdef HAVE_MMAP
+#  include <sys/mman.h>
+#endif
 
 #ifdef __BIONIC__               /* Android */
 #undef lseek
@@ -138,11 +141,13 @@ enum
 };
 
 #define DEFAULT_BLOCKSIZE       4*1024
+#define DEFAULT_USE_MMAP        FALSE
 
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_USE_MMAP
 };
 
 static void gst_file_src_finalize (GObject * object);
@@ -159,6 +164,8 @@ static gboolean gst_file_src_is_seekable (GstBaseSrc * src);
 static gboolean gst_file_src_get_size (GstBaseSrc * src, guint64 * size);
 static GstFlowReturn gst_file_src_fill (GstBaseSrc * src, guint64 offset,
     guint length, GstBuffer * buf);
+static GstFlowReturn gst_file_src_create (GstBaseSrc * src, guint64 offset,
+    guint length, GstBuffer ** buf);
 
 static void gst_file_src_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
@@ -189,6 +196,26 @@ gst_file_src_class_init (GstFileSrcClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstFileSrc:use-mmap:
+   *
+   * Map regular files into memory and push read-only buffers that point
+   * into the mapping instead of reading into newly allocated buffers. This
+   * avoids copying the data from the page cache.
+   *
+   * The file must not be truncated while it is mapped, accessing the
+   * removed part of the mapping crashes the process. Data appended to the
+   * file after it was opened is read normally. The property only has an
+   * effect on systems that support mmap().
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Push buffers that point into the memory mapped file",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->finalize = gst_file_src_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -203,6 +230,7 @@ gst_file_src_class_init (GstFileSrcClass * klass)
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_file_src_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_file_src_get_size);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_file_src_fill);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_file_src_create);
 
   if (sizeof (off_t) < 8) {
     GST_LOG ("No large file support, sizeof (off_t) = %" G_GSIZE_FORMAT "!",
@@ -218,6 +246,7 @@ gst_file_src_init (GstFileSrc * src)
   src->uri = NULL;
 
   src->is_regular = FALSE;
+  src->use_mmap = DEFAULT_USE_MMAP;
 
   gst_base_src_set_blocksize (GST_BASE_SRC (src), DEFAULT_BLOCKSIZE);
 }
@@ -291,6 +320,9 @@ gst_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       gst_file_src_set_location (src, g_value_get_string (value));
       break;
+    case PROP_USE_MMAP:
+      src->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -311,6 +343,9 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LOCATION:
       g_value_set_string (value, src->filename);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, src->use_mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -416,6 +451,52 @@ buffer_write_fail:
   }
 }
 
+static GstFlowReturn
+gst_file_src_create (GstBaseSrc * basesrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstFileSrc *src = GST_FILE_SRC_CAST (basesrc);
+  GstBuffer *buf;
+
+  /* read data appended after mapping the file like without mmap */
+  if (src->mapping == NULL || offset == -1 || offset >= src->mapping_size)
+    return GST_BASE_SRC_CLASS (parent_class)->create (basesrc, offset, length,
+        buffer);
+
+  if (offset + length > src->mapping_size)
+    length = src->mapping_size - offset;
+
+#ifdef HAVE_MADVISE
+  /* ask for the next block to be read ahead while this one is processed */
+  if (offset + length < src->mapping_size) {
+    GstMapInfo info;
+    guint64 start, end;
+    gint pagesize = getpagesize ();
+
+    start = (offset + length) & ~((guint64) pagesize - 1);
+    end = MIN (offset + 2 * (guint64) length, src->mapping_size);
+    gst_memory_map (src->mapping, &info, GST_MAP_READ);
+    if (madvise (info.data + start, end - start, MADV_WILLNEED) < 0)
+      GST_LOG_OBJECT (src, "madvise failed: %s", g_strerror (errno));
+    gst_memory_unmap (src->mapping, &info);
+  }
+#endif
+
+  GST_LOG_OBJECT (src, "Mapping %u bytes at offset 0x%" G_GINT64_MODIFIER "x",
+      length, offset);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf, gst_memory_share (src->mapping, offset,
+          length));
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + length;
+
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+}
+
 static gboolean
 gst_file_src_is_seekable (GstBaseSrc * basesrc)
 {
@@ -452,6 +533,70 @@ could_not_stat:
   }
 }
 
+#ifdef HAVE_MMAP
+typedef struct
+{
+  gpointer data;
+  gsize size;
+} GstFileSrcMapping;
+
+static void
+gst_file_src_mapping_free (GstFileSrcMapping * mapping)
+{
+  munmap (mapping->data, mapping->size);
+  g_slice_free (GstFileSrcMapping, mapping);
+}
+#endif
+
+/* the mapping stays alive until the last buffer pointing into it is freed */
+static void
+gst_file_src_map_file (GstFileSrc * src, guint64 size)
+{
+#ifdef HAVE_MMAP
+  GstFileSrcMapping *mapping;
+  gpointer data;
+
+  if (size == 0 || size > G_MAXSIZE)
+    goto no_mmap;
+
+  data = mmap (NULL, size, PROT_READ, MAP_SHARED, src->fd, 0);
+  if (data == MAP_FAILED)
+    goto mmap_failed;
+
+#ifdef HAVE_MADVISE
+  if (madvise (data, size, MADV_SEQUENTIAL) < 0)
+    GST_LOG_OBJECT (src, "madvise failed: %s", g_strerror (errno));
+#endif
+
+  mapping = g_slice_new (GstFileSrcMapping);
+  mapping->data = data;
+  mapping->size = size;
+
+  src->mapping = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, data, size,
+      0, size, mapping, (GDestroyNotify) gst_file_src_mapping_free);
+  src->mapping_size = size;
+
+  GST_DEBUG_OBJECT (src, "mapped %" G_GUINT64_FORMAT " bytes", size);
+  return;
+
+  /* ERROR */
+no_mmap:
+  {
+    GST_DEBUG_OBJECT (src, "not mapping file of size %" G_GUINT64_FORMAT,
+        size);
+    return;
+  }
+mmap_failed:
+  {
+    GST_WARNING_OBJECT (src, "mmap failed, reading instead: %s",
+        g_strerror (errno));
+    return;
+  }
+#else
+  GST_DEBUG_OBJECT (src, "mmap not supported, reading instead");
+#endif
+}
+
 /* open the file, necessary to go to READY state */
 static gboolean
 gst_file_src_start (GstBaseSrc * basesrc)
@@ -513,6 +658,9 @@ gst_file_src_start (GstBaseSrc * basesrc)
 
   gst_base_src_set_dynamic_size (basesrc, src->seekable);
 
+  if (src->use_mmap && src->seekable)
+    gst_file_src_map_file (src, stat_results.st_size);
+
   return TRUE;
 
   /* ERROR */
@@ -574,6 +722,12 @@ gst_file_src_stop (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
 
+  if (src->mapping) {
+    gst_memory_unref (src->mapping);
+    src->mapping = NULL;
+    src->mapping_size = 0;
+  }
+
   /* close the file */
   close (src->fd);
 
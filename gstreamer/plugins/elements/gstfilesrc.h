@@ -63,6 +63,10 @@ struct _GstFileSrc {
   gboolean seekable;                    /* whether the file is seekable */
   gboolean is_regular;                  /* whether it's a (symlink to a)
                                            regular file */
+
+  gboolean use_mmap;                    /* use-mmap property */
+  GstMemory *mapping;                   /* the mapped file, or NULL */
+  guint64 mapping_size;                 /* size of the mapped file */
 };
 
 struct _GstFileSrcClass {
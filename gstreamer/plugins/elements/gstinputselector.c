@@ -108,12 +108,14 @@ enum
   PROP_ACTIVE_PAD,
   PROP_SYNC_STREAMS,
   PROP_SYNC_MODE,
-  PROP_CACHE_BUFFERS
+  PROP_CACHE_BUFFERS,
+  PROP_CACHE_GOP
 };
 
 #define DEFAULT_SYNC_STREAMS TRUE
 #define DEFAULT_SYNC_MODE GST_INPUT_SELECTOR_SYNC_MODE_ACTIVE_SEGMENT
 #define DEFAULT_CACHE_BUFFERS FALSE
+#define DEFAULT_CACHE_GOP FALSE
 #define DEFAULT_PAD_ALWAYS_OK TRUE
 
 enum
@@ -169,6 +171,9 @@ struct _GstSelectorPad
 
   gboolean sending_cached_buffers;
   GQueue *cached_buffers;
+
+  GQueue *gop_buffers;          /* buffers since the last keyframe while
+                                 * inactive, see cache-gop */
 };
 
 struct _GstSelectorPadCachedBuffer
@@ -202,6 +207,7 @@ static GstFlowReturn gst_selector_pad_chain (GstPad * pad, GstObject * parent,
 static void gst_selector_pad_cache_buffer (GstSelectorPad * selpad,
     GstBuffer * buffer);
 static void gst_selector_pad_free_cached_buffers (GstSelectorPad * selpad);
+static void gst_selector_pad_free_gop_buffers (GstSelectorPad * selpad);
 
 G_DEFINE_TYPE (GstSelectorPad, gst_selector_pad, GST_TYPE_PAD);
 
@@ -253,6 +259,7 @@ gst_selector_pad_finalize (GObject * object)
   if (pad->tags)
     gst_tag_list_unref (pad->tags);
   gst_selector_pad_free_cached_buffers (pad);
+  gst_selector_pad_free_gop_buffers (pad);
 
   G_OBJECT_CLASS (gst_selector_pad_parent_class)->finalize (object);
 }
@@ -348,6 +355,7 @@ gst_selector_pad_reset (GstSelectorPad * pad)
   gst_segment_init (&pad->segment, GST_FORMAT_UNDEFINED);
   pad->sending_cached_buffers = FALSE;
   gst_selector_pad_free_cached_buffers (pad);
+  gst_selector_pad_free_gop_buffers (pad);
   GST_OBJECT_UNLOCK (pad);
 }
 
@@ -400,6 +408,36 @@ gst_selector_pad_free_cached_buffers (GstSelectorPad * selpad)
   selpad->cached_buffers = NULL;
 }
 
+/* must be called with the SELECTOR_LOCK */
+static void
+gst_selector_pad_cache_gop_buffer (GstSelectorPad * selpad, GstBuffer * buffer)
+{
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    GST_LOG_OBJECT (selpad, "Keyframe %p starts a new GOP", buffer);
+    gst_selector_pad_free_gop_buffers (selpad);
+    selpad->gop_buffers = g_queue_new ();
+  } else if (!selpad->gop_buffers) {
+    /* no keyframe yet, nothing to start decoding from */
+    gst_buffer_unref (buffer);
+    return;
+  }
+
+  g_queue_push_tail (selpad->gop_buffers, buffer);
+}
+
+/* must be called with the SELECTOR_LOCK */
+static void
+gst_selector_pad_free_gop_buffers (GstSelectorPad * selpad)
+{
+  if (!selpad->gop_buffers)
+    return;
+
+  GST_DEBUG_OBJECT (selpad, "Freeing %u GOP buffers",
+      g_queue_get_length (selpad->gop_buffers));
+  g_queue_free_full (selpad->gop_buffers, (GDestroyNotify) gst_buffer_unref);
+  selpad->gop_buffers = NULL;
+}
+
 /* strictly get the linked pad from the sinkpad. If the pad is active we return
  * the srcpad else we return NULL */
 static GstIterator *
@@ -564,6 +602,8 @@ gst_selector_pad_event (GstPad * pad, GstObject * parent, GstEvent * event)
     case GST_EVENT_SEGMENT:
     {
       gst_event_copy_segment (event, &selpad->segment);
+      /* the cached GOP belongs to the old segment */
+      gst_selector_pad_free_gop_buffers (selpad);
       selpad->segment_seqnum = gst_event_get_seqnum (event);
 
       GST_DEBUG_OBJECT (pad, "configured SEGMENT %" GST_SEGMENT_FORMAT,
@@ -959,6 +999,45 @@ gst_input_selector_cleanup_old_cached_buffers (GstInputSelector * sel,
 #endif
 }
 
+/* Pushes the GOP cached while @selpad was inactive before @buf, marked as
+ * decode-only so that downstream can decode @buf right away without waiting
+ * for the next keyframe and without showing the old frames. Takes ownership
+ * of @gop */
+static GstFlowReturn
+gst_input_selector_push_gop (GstInputSelector * sel, GstSelectorPad * selpad,
+    GQueue * gop, GstBuffer * buf)
+{
+  GstFlowReturn res = GST_FLOW_OK;
+  GstBuffer *cached;
+
+  /* a keyframe can be decoded on its own */
+  if (!GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    g_queue_free_full (gop, (GDestroyNotify) gst_buffer_unref);
+    return GST_FLOW_OK;
+  }
+
+  GST_DEBUG_OBJECT (selpad, "Replaying %u GOP buffers",
+      g_queue_get_length (gop));
+
+  while ((cached = g_queue_pop_head (gop))) {
+    if (res != GST_FLOW_OK) {
+      gst_buffer_unref (cached);
+      continue;
+    }
+
+    cached = gst_buffer_make_writable (cached);
+    GST_BUFFER_FLAG_SET (cached, GST_BUFFER_FLAG_DECODE_ONLY);
+    if (selpad->discont) {
+      GST_BUFFER_FLAG_SET (cached, GST_BUFFER_FLAG_DISCONT);
+      selpad->discont = FALSE;
+    }
+    res = gst_pad_push (sel->srcpad, cached);
+  }
+  g_queue_free (gop);
+
+  return res;
+}
+
 static GstFlowReturn
 gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
@@ -967,6 +1046,7 @@ gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GstPad *active_sinkpad;
   GstPad *prev_active_sinkpad = NULL;
   GstSelectorPad *selpad;
+  GQueue *gop;
 
   sel = GST_INPUT_SELECTOR (parent);
   selpad = GST_SELECTOR_PAD_CAST (pad);
@@ -1069,6 +1149,10 @@ gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   if (sel->sync_streams)
     GST_INPUT_SELECTOR_BROADCAST (sel);
 
+  /* the GOP cached while we were inactive, if we just got activated */
+  gop = selpad->gop_buffers;
+  selpad->gop_buffers = NULL;
+
   GST_INPUT_SELECTOR_UNLOCK (sel);
 
   if (prev_active_sinkpad != active_sinkpad) {
@@ -1091,6 +1175,14 @@ gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
     prev_active_sinkpad = NULL;
   }
 
+  if (G_UNLIKELY (gop)) {
+    res = gst_input_selector_push_gop (sel, selpad, gop, buf);
+    if (res != GST_FLOW_OK) {
+      gst_buffer_unref (buf);
+      goto done;
+    }
+  }
+
   if (selpad->discont) {
     buf = gst_buffer_make_writable (buf);
 
@@ -1142,8 +1234,12 @@ ignore:
     GST_DEBUG_OBJECT (pad, "Pad not active, discard buffer %p", buf);
     /* when we drop a buffer, we're creating a discont on this pad */
     selpad->discont = TRUE;
+    /* keep the GOP around so that we can switch to this pad right away */
+    if (sel->cache_gop)
+      gst_selector_pad_cache_gop_buffer (selpad, buf);
+    else
+      gst_buffer_unref (buf);
     GST_INPUT_SELECTOR_UNLOCK (sel);
-    gst_buffer_unref (buf);
 
     /* figure out what to return upstream */
     GST_OBJECT_LOCK (selpad);
@@ -1266,6 +1362,26 @@ gst_input_selector_class_init (GstInputSelectorClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstInputSelector:cache-gop
+   *
+   * If set to %TRUE, inactive pads keep the buffers since their last
+   * keyframe instead of dropping them. When switching to such a pad in the
+   * middle of a GOP, the cached buffers are pushed first with the
+   * %GST_BUFFER_FLAG_DECODE_ONLY flag set, so that a decoder downstream can
+   * continue with the new stream immediately instead of waiting for its next
+   * keyframe. This allows instant switching between redundant encoded
+   * feeds.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_GOP,
+      g_param_spec_boolean ("cache-gop", "Cache GOP",
+          "Cache the buffers since the last keyframe on inactive pads and "
+          "replay them when switching", DEFAULT_CACHE_GOP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_set_static_metadata (gstelement_class, "Input selector",
       "Generic", "N-to-1 input stream selector",
       "Julien Moutte <julien@moutte.net>, "
@@ -1420,6 +1536,11 @@ gst_input_selector_set_property (GObject * object, guint prop_id,
       sel->cache_buffers = g_value_get_boolean (value);
       GST_INPUT_SELECTOR_UNLOCK (object);
       break;
+    case PROP_CACHE_GOP:
+      GST_INPUT_SELECTOR_LOCK (object);
+      sel->cache_gop = g_value_get_boolean (value);
+      GST_INPUT_SELECTOR_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1468,6 +1589,11 @@ gst_input_selector_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, sel->cache_buffers);
       GST_INPUT_SELECTOR_UNLOCK (object);
       break;
+    case PROP_CACHE_GOP:
+      GST_INPUT_SELECTOR_LOCK (object);
+      g_value_set_boolean (value, sel->cache_gop);
+      GST_INPUT_SELECTOR_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -100,6 +100,15 @@
  *   queues is filled.
  *   Both signals are emitted from the context of the streaming thread.
  * </para>
+ * <para>
+ *   By default each source pad has its own streaming thread. When
+ *   #GstMultiQueue:max-threads is set, the queues are serviced by a shared
+ *   set of worker threads instead, which take turns pushing one item of each
+ *   queue that has data. Not-linked queues that have to wait for the other
+ *   streams are parked without keeping a thread busy. Pushes that block
+ *   downstream still hold their worker, so when all workers have been busy
+ *   for a while with queues waiting, an extra worker is started.
+ * </para>
  * </refsect2>
  */
 
@@ -179,6 +188,15 @@ struct _GstSingleQueue
 
   /* For interleave calculation */
   GThread *thread;
+
+  /* worker mode, protected by global lock */
+  gboolean started;             /* srcpad is active, the queue can be serviced */
+  gboolean scheduled;           /* in the ready queue */
+  GThread *worker;              /* thread servicing the queue or NULL */
+  gboolean woken;               /* got its turn while being serviced */
+  gint64 ready_time;            /* monotonic time the queue got scheduled */
+  GstMiniObject *parked_object; /* not-linked object waiting for its turn */
+  guint32 parked_id;
 };
 
 
@@ -258,6 +276,10 @@ enum
 #define DEFAULT_SYNC_BY_RUNNING_TIME FALSE
 #define DEFAULT_USE_INTERLEAVE FALSE
 #define DEFAULT_UNLINKED_CACHE_TIME 250 * GST_MSECOND
+#define DEFAULT_MAX_THREADS 0
+
+/* start an extra worker when a queue waited this long for one */
+#define WORKER_STARVATION_TIMEOUT (100 * GST_MSECOND)
 
 enum
 {
@@ -274,6 +296,7 @@ enum
   PROP_SYNC_BY_RUNNING_TIME,
   PROP_USE_INTERLEAVE,
   PROP_UNLINKED_CACHE_TIME,
+  PROP_MAX_THREADS,
   PROP_LAST
 };
 
@@ -323,6 +346,16 @@ static GstStateChangeReturn gst_multi_queue_change_state (GstElement *
     element, GstStateChange transition);
 
 static void gst_multi_queue_loop (GstPad * pad);
+static void gst_single_queue_signal_turn (GstMultiQueue * mq,
+    GstSingleQueue * sq);
+static void gst_single_queue_schedule (GstMultiQueue * mq, GstSingleQueue * sq,
+    gboolean turn);
+static gboolean gst_single_queue_start_task (GstMultiQueue * mq,
+    GstSingleQueue * sq);
+static gboolean gst_single_queue_pause_task (GstMultiQueue * mq,
+    GstSingleQueue * sq);
+static void gst_multi_queue_start_workers (GstMultiQueue * mq);
+static void gst_multi_queue_stop_workers (GstMultiQueue * mq);
 
 #define _do_init \
   GST_DEBUG_CATEGORY_INIT (multi_queue_debug, "multiqueue", 0, "multiqueue element");
@@ -469,6 +502,23 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiQueue:max-threads
+   *
+   * Number of worker threads that service the queues, 0 to use one
+   * streaming thread per source pad. More workers are started when queues
+   * wait too long because all workers are blocked downstream, those go away
+   * again when they become idle.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Maximum threads",
+          "Number of worker threads servicing the queues "
+          "(0 = one thread per source pad)", 0, G_MAXUINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
 
   gobject_class->finalize = gst_multi_queue_finalize;
 
@@ -507,6 +557,7 @@ gst_multi_queue_init (GstMultiQueue * mqueue)
   mqueue->sync_by_running_time = DEFAULT_SYNC_BY_RUNNING_TIME;
   mqueue->use_interleave = DEFAULT_USE_INTERLEAVE;
   mqueue->unlinked_cache_time = DEFAULT_UNLINKED_CACHE_TIME;
+  mqueue->max_threads = DEFAULT_MAX_THREADS;
 
   mqueue->counter = 1;
   mqueue->highid = -1;
@@ -514,6 +565,10 @@ gst_multi_queue_init (GstMultiQueue * mqueue)
 
   g_mutex_init (&mqueue->qlock);
   g_mutex_init (&mqueue->buffering_post_lock);
+
+  g_queue_init (&mqueue->ready);
+  g_cond_init (&mqueue->worker_cond);
+  g_cond_init (&mqueue->worker_done);
 }
 
 static void
@@ -526,9 +581,13 @@ gst_multi_queue_finalize (GObject * object)
   mqueue->queues = NULL;
   mqueue->queues_cookie++;
 
+  gst_multi_queue_stop_workers (mqueue);
+
   /* free/unref instance data */
   g_mutex_clear (&mqueue->qlock);
   g_mutex_clear (&mqueue->buffering_post_lock);
+  g_cond_clear (&mqueue->worker_cond);
+  g_cond_clear (&mqueue->worker_done);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -640,6 +699,11 @@ gst_multi_queue_set_property (GObject * object, guint prop_id,
       GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
       gst_multi_queue_post_buffering (mq);
       break;
+    case PROP_MAX_THREADS:
+      GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+      mq->max_threads = g_value_get_uint (value);
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -691,6 +755,9 @@ gst_multi_queue_get_property (GObject * object, guint prop_id,
     case PROP_UNLINKED_CACHE_TIME:
       g_value_set_uint64 (value, mq->unlinked_cache_time);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_uint (value, mq->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -832,6 +899,7 @@ gst_multi_queue_change_state (GstElement * element, GstStateChange transition)
       GST_MULTI_QUEUE_MUTEX_UNLOCK (mqueue);
       gst_multi_queue_post_buffering (mqueue);
 
+      gst_multi_queue_start_workers (mqueue);
       break;
     }
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
@@ -842,7 +910,7 @@ gst_multi_queue_change_state (GstElement * element, GstStateChange transition)
       for (tmp = mqueue->queues; tmp; tmp = g_list_next (tmp)) {
         sq = (GstSingleQueue *) tmp->data;
         sq->flushing = TRUE;
-        g_cond_signal (&sq->turn);
+        gst_single_queue_signal_turn (mqueue, sq);
 
         sq->last_query = FALSE;
         g_cond_signal (&sq->query_handled);
@@ -857,6 +925,9 @@ gst_multi_queue_change_state (GstElement * element, GstStateChange transition)
   result = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_multi_queue_stop_workers (mqueue);
+      break;
     default:
       break;
   }
@@ -883,13 +954,13 @@ gst_single_queue_flush (GstMultiQueue * mq, GstSingleQueue * sq, gboolean flush,
     /* wake up non-linked task */
     GST_LOG_OBJECT (mq, "SingleQueue %d : waking up eventually waiting task",
         sq->id);
-    g_cond_signal (&sq->turn);
+    gst_single_queue_signal_turn (mq, sq);
     sq->last_query = FALSE;
     g_cond_signal (&sq->query_handled);
     GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
 
     GST_LOG_OBJECT (mq, "SingleQueue %d : pausing task", sq->id);
-    result = gst_pad_pause_task (sq->srcpad);
+    result = gst_single_queue_pause_task (mq, sq);
     sq->sink_tainted = sq->src_tainted = TRUE;
   } else {
     gst_single_queue_flush_queue (sq, full);
@@ -919,9 +990,7 @@ gst_single_queue_flush (GstMultiQueue * mq, GstSingleQueue * sq, gboolean flush,
     GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
 
     GST_LOG_OBJECT (mq, "SingleQueue %d : starting task", sq->id);
-    result =
-        gst_pad_start_task (sq->srcpad, (GstTaskFunction) gst_multi_queue_loop,
-        sq->srcpad, NULL);
+    result = gst_single_queue_start_task (mq, sq);
   }
   return result;
 }
@@ -1570,6 +1639,33 @@ next:
   if (sq->flushing)
     goto out_flushing;
 
+  /* only set in worker mode, by the worker servicing us */
+  if (sq->parked_object) {
+    /* our turn came, resume waiting for the not-linked wakeup */
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    object = sq->parked_object;
+    newid = sq->parked_id;
+    sq->parked_object = NULL;
+    mq->numwaiting--;
+
+    is_buffer = GST_IS_BUFFER (object);
+    next_time = sq->next_time;
+
+    if (sq->flushing) {
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      goto out_flushing;
+    }
+
+    compute_high_time (mq);
+    compute_high_id (mq);
+    goto check_turn;
+  }
+
+  /* workers only service queues with data, but a flush could have emptied it
+   * in the meantime */
+  if (mq->max_threads > 0 && gst_data_queue_is_empty (sq->queue))
+    return;
+
   /* Get something from the queue, blocking until that happens, or we get
    * flushed */
   if (!(gst_data_queue_pop (sq->queue, &sitem)))
@@ -1628,6 +1724,7 @@ next:
       /* Recompute the high time */
       compute_high_time (mq);
 
+    check_turn:
       while (((mq->sync_by_running_time && GST_CLOCK_STIME_IS_VALID (next_time)
                   && (mq->high_time == GST_CLOCK_STIME_NONE
                       || next_time > mq->high_time))
@@ -1644,6 +1741,15 @@ next:
         wake_up_next_non_linked (mq);
 
         mq->numwaiting++;
+
+        if (mq->max_threads > 0) {
+          /* park the queue until its turn instead of blocking the worker */
+          sq->parked_object = object;
+          sq->parked_id = newid;
+          GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+          return;
+        }
+
         g_cond_wait (&sq->turn, &mq->qlock);
         mq->numwaiting--;
 
@@ -1730,7 +1836,7 @@ next:
           GST_LOG_OBJECT (mq, "Waking up singlequeue %d", sq2->id);
           sq2->pushed = FALSE;
           sq2->srcresult = GST_FLOW_OK;
-          g_cond_signal (&sq2->turn);
+          gst_single_queue_signal_turn (mq, sq2);
         }
       }
     }
@@ -1817,7 +1923,7 @@ out_flushing:
     gst_single_queue_flush_queue (sq, FALSE);
     single_queue_underrun_cb (sq->queue, sq);
     gst_data_queue_set_flushing (sq->queue, TRUE);
-    gst_pad_pause_task (sq->srcpad);
+    gst_single_queue_pause_task (mq, sq);
     GST_CAT_LOG_OBJECT (multi_queue_debug, mq,
         "SingleQueue[%d] task paused, reason:%s",
         sq->id, gst_flow_get_name (sq->srcresult));
@@ -1890,6 +1996,12 @@ gst_multi_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   if (!(gst_data_queue_push (sq->queue, (GstDataQueueItem *) item)))
     goto flushing;
 
+  if (mq->max_threads > 0) {
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    gst_single_queue_schedule (mq, sq, FALSE);
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+  }
+
   /* update time level, we must do this after pushing the data in the queue so
    * that we never end up filling the queue first. */
   apply_buffer (mq, sq, timestamp, duration, &sq->sink_segment);
@@ -2073,6 +2185,12 @@ gst_multi_queue_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
   if (!gst_data_queue_push (sq->queue, (GstDataQueueItem *) item))
     goto flushing;
 
+  if (mq->max_threads > 0) {
+    GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+    gst_single_queue_schedule (mq, sq, FALSE);
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+  }
+
   /* mark EOS when we received one, we must do that after putting the
    * buffer in the queue because EOS marks the buffer as filled. */
   switch (type) {
@@ -2184,6 +2302,8 @@ gst_multi_queue_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
           GST_MULTI_QUEUE_MUTEX_LOCK (mq);
           if (!res || sq->flushing)
             goto out_flushing;
+          if (mq->max_threads > 0)
+            gst_single_queue_schedule (mq, sq, FALSE);
           /* it might be that the query has been taken out of the queue
            * while we were unlocked. So, we need to check if the last
            * handled query is the same one than the one we just
@@ -2236,7 +2356,10 @@ gst_multi_queue_src_activate_mode (GstPad * pad, GstObject * parent,
       } else {
         result = gst_single_queue_flush (mq, sq, TRUE, TRUE);
         /* make sure streaming finishes */
-        result |= gst_pad_stop_task (pad);
+        if (mq->max_threads > 0)
+          result |= gst_single_queue_pause_task (mq, sq);
+        else
+          result |= gst_pad_stop_task (pad);
       }
       break;
     default:
@@ -2258,7 +2381,7 @@ gst_multi_queue_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       GST_MULTI_QUEUE_MUTEX_LOCK (mq);
       if (sq->srcresult == GST_FLOW_NOT_LINKED) {
         sq->srcresult = GST_FLOW_OK;
-        g_cond_signal (&sq->turn);
+        gst_single_queue_signal_turn (mq, sq);
       }
       GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
 
@@ -2287,6 +2410,263 @@ gst_multi_queue_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
   return res;
 }
 
+/*
+ * Worker functions
+ */
+
+typedef struct
+{
+  GstMultiQueue *mq;
+  GstTask *task;
+  GRecMutex lock;
+  gboolean active;
+} GstMultiQueueWorker;
+
+static void
+gst_multi_queue_worker_loop (GstMultiQueueWorker * worker)
+{
+  GstMultiQueue *mq = worker->mq;
+  GstSingleQueue *sq;
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  while ((sq = g_queue_pop_head (&mq->ready)) == NULL) {
+    if (!mq->workers_running) {
+      /* the task is being stopped */
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      return;
+    }
+    if (mq->n_workers > mq->max_threads) {
+      GST_DEBUG_OBJECT (mq, "pausing extra worker");
+      worker->active = FALSE;
+      mq->n_workers--;
+      gst_task_pause (worker->task);
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      return;
+    }
+    mq->n_idle++;
+    g_cond_wait (&mq->worker_cond, &mq->qlock);
+    mq->n_idle--;
+  }
+  sq->scheduled = FALSE;
+  sq->worker = g_thread_self ();
+  sq->woken = FALSE;
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  GST_LOG_OBJECT (mq, "SingleQueue %d : servicing", sq->id);
+
+  /* the pad task would hold the stream lock too */
+  GST_PAD_STREAM_LOCK (sq->srcpad);
+  gst_multi_queue_loop (sq->srcpad);
+  GST_PAD_STREAM_UNLOCK (sq->srcpad);
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  sq->worker = NULL;
+  g_cond_broadcast (&mq->worker_done);
+  /* go to the back of the line if there is more */
+  gst_single_queue_schedule (mq, sq, sq->woken);
+  sq->woken = FALSE;
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+}
+
+/* WITH LOCK TAKEN */
+static void
+gst_multi_queue_start_worker (GstMultiQueue * mq)
+{
+  GstMultiQueueWorker *worker = NULL;
+  GList *tmp;
+
+  for (tmp = mq->workers; tmp; tmp = tmp->next) {
+    if (!((GstMultiQueueWorker *) tmp->data)->active) {
+      worker = tmp->data;
+      break;
+    }
+  }
+
+  if (!worker) {
+    worker = g_slice_new0 (GstMultiQueueWorker);
+    worker->mq = mq;
+    g_rec_mutex_init (&worker->lock);
+    worker->task = gst_task_new ((GstTaskFunction) gst_multi_queue_worker_loop,
+        worker, NULL);
+    gst_task_set_lock (worker->task, &worker->lock);
+    mq->workers = g_list_prepend (mq->workers, worker);
+  }
+
+  GST_DEBUG_OBJECT (mq, "starting worker, now %u", mq->n_workers + 1);
+  worker->active = TRUE;
+  mq->n_workers++;
+  gst_task_start (worker->task);
+}
+
+static gboolean
+gst_multi_queue_watchdog (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstMultiQueue *mq = user_data;
+  GstSingleQueue *sq;
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  sq = g_queue_peek_head (&mq->ready);
+  if (mq->workers_running && sq && mq->n_idle == 0 &&
+      mq->n_workers < mq->nbqueues &&
+      g_get_monotonic_time () - sq->ready_time >
+      WORKER_STARVATION_TIMEOUT / GST_USECOND) {
+    GST_DEBUG_OBJECT (mq, "SingleQueue %d : starving, adding a worker",
+        sq->id);
+    gst_multi_queue_start_worker (mq);
+  }
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  return TRUE;
+}
+
+static void
+gst_multi_queue_start_workers (GstMultiQueue * mq)
+{
+  GstClock *clock;
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  if (mq->max_threads == 0 || mq->workers_running) {
+    GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+    return;
+  }
+  mq->workers_running = TRUE;
+
+  /* workers are started on demand, the watchdog adds more when they are all
+   * blocked for too long */
+  clock = gst_system_clock_obtain ();
+  mq->watchdog = gst_clock_new_periodic_id (clock,
+      gst_clock_get_time (clock) + WORKER_STARVATION_TIMEOUT,
+      WORKER_STARVATION_TIMEOUT);
+  gst_clock_id_wait_async (mq->watchdog, gst_multi_queue_watchdog,
+      gst_object_ref (mq), (GDestroyNotify) gst_object_unref);
+  gst_object_unref (clock);
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+}
+
+static void
+gst_multi_queue_stop_workers (GstMultiQueue * mq)
+{
+  GstClockID watchdog;
+  GList *workers, *tmp;
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  mq->workers_running = FALSE;
+  workers = mq->workers;
+  mq->workers = NULL;
+  mq->n_workers = 0;
+  watchdog = mq->watchdog;
+  mq->watchdog = NULL;
+  g_queue_clear (&mq->ready);
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  if (watchdog) {
+    gst_clock_id_unschedule (watchdog);
+    gst_clock_id_unref (watchdog);
+  }
+
+  for (tmp = workers; tmp; tmp = tmp->next)
+    gst_task_stop (((GstMultiQueueWorker *) tmp->data)->task);
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  g_cond_broadcast (&mq->worker_cond);
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  for (tmp = workers; tmp; tmp = tmp->next) {
+    GstMultiQueueWorker *worker = tmp->data;
+
+    gst_task_join (worker->task);
+    gst_object_unref (worker->task);
+    g_rec_mutex_clear (&worker->lock);
+    g_slice_free (GstMultiQueueWorker, worker);
+  }
+  g_list_free (workers);
+}
+
+/* WITH LOCK TAKEN
+ * Put the queue in line for a worker if it has something to do, @turn is
+ * set when a parked queue might be allowed to continue */
+static void
+gst_single_queue_schedule (GstMultiQueue * mq, GstSingleQueue * sq,
+    gboolean turn)
+{
+  if (!sq->started || sq->scheduled || sq->worker)
+    return;
+
+  if (sq->parked_object ? !turn : gst_data_queue_is_empty (sq->queue))
+    return;
+
+  GST_LOG_OBJECT (mq, "SingleQueue %d : scheduling", sq->id);
+  g_queue_push_tail (&mq->ready, sq);
+  sq->scheduled = TRUE;
+  sq->ready_time = g_get_monotonic_time ();
+
+  if (mq->n_idle > 0)
+    g_cond_signal (&mq->worker_cond);
+  else if (mq->workers_running && mq->n_workers < mq->max_threads)
+    gst_multi_queue_start_worker (mq);
+}
+
+/* WITH LOCK TAKEN */
+static void
+gst_single_queue_signal_turn (GstMultiQueue * mq, GstSingleQueue * sq)
+{
+  if (mq->max_threads == 0) {
+    g_cond_signal (&sq->turn);
+    return;
+  }
+
+  /* the worker reschedules it when it leaves the queue */
+  if (sq->worker)
+    sq->woken = TRUE;
+  else
+    gst_single_queue_schedule (mq, sq, TRUE);
+}
+
+static gboolean
+gst_single_queue_start_task (GstMultiQueue * mq, GstSingleQueue * sq)
+{
+  if (mq->max_threads == 0)
+    return gst_pad_start_task (sq->srcpad,
+        (GstTaskFunction) gst_multi_queue_loop, sq->srcpad, NULL);
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  sq->started = TRUE;
+  gst_single_queue_schedule (mq, sq, FALSE);
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  return TRUE;
+}
+
+/* waits for the worker to leave the queue, unless called from it */
+static gboolean
+gst_single_queue_pause_task (GstMultiQueue * mq, GstSingleQueue * sq)
+{
+  if (mq->max_threads == 0)
+    return gst_pad_pause_task (sq->srcpad);
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  sq->started = FALSE;
+  if (sq->scheduled) {
+    g_queue_remove (&mq->ready, sq);
+    sq->scheduled = FALSE;
+  }
+  if (sq->worker != g_thread_self ()) {
+    while (sq->worker)
+      g_cond_wait (&mq->worker_done, &mq->qlock);
+
+    if (sq->parked_object) {
+      if (!GST_IS_QUERY (sq->parked_object))
+        gst_mini_object_unref (sq->parked_object);
+      sq->parked_object = NULL;
+      mq->numwaiting--;
+    }
+  }
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  return TRUE;
+}
+
 /*
  * Next-non-linked functions
  */
@@ -2309,7 +2689,7 @@ wake_up_next_non_linked (GstMultiQueue * mq)
           && GST_CLOCK_STIME_IS_VALID (sq->next_time)
           && sq->next_time <= mq->high_time) {
         GST_LOG_OBJECT (mq, "Waking up singlequeue %d", sq->id);
-        g_cond_signal (&sq->turn);
+        gst_single_queue_signal_turn (mq, sq);
       }
     }
   } else {
@@ -2319,7 +2699,7 @@ wake_up_next_non_linked (GstMultiQueue * mq)
       if (sq->srcresult == GST_FLOW_NOT_LINKED &&
           sq->nextid != 0 && sq->nextid <= mq->highid) {
         GST_LOG_OBJECT (mq, "Waking up singlequeue %d", sq->id);
-        g_cond_signal (&sq->turn);
+        gst_single_queue_signal_turn (mq, sq);
       }
     }
   }
@@ -2628,6 +3008,8 @@ gst_single_queue_free (GstSingleQueue * sq)
   /* DRAIN QUEUE */
   gst_data_queue_flush (sq->queue);
   g_object_unref (sq->queue);
+  if (sq->parked_object && !GST_IS_QUERY (sq->parked_object))
+    gst_mini_object_unref (sq->parked_object);
   g_cond_clear (&sq->turn);
   g_cond_clear (&sq->query_handled);
   g_free (sq);
@@ -83,6 +83,17 @@ struct _GstMultiQueue {
   GstClockTimeDiff last_interleave_update;
 
   GstClockTime unlinked_cache_time;
+
+  /* worker mode, protected by qlock */
+  guint max_threads;
+  gboolean workers_running;
+  GQueue ready;                 /* GstSingleQueue waiting for a worker */
+  GList *workers;
+  guint n_workers;              /* number of active workers */
+  guint n_idle;                 /* number of workers waiting for a queue */
+  GCond worker_cond;            /* signaled when a queue becomes ready */
+  GCond worker_done;            /* signaled when a worker leaves a queue */
+  GstClockID watchdog;
 };
 
 struct _GstMultiQueueClass {
@@ -120,13 +120,15 @@ enum
   PROP_MIN_THRESHOLD_TIME,
   PROP_LEAKY,
   PROP_SILENT,
-  PROP_FLUSH_ON_EOS
+  PROP_FLUSH_ON_EOS,
+  PROP_SPIN_TIME
 };
 
 /* default property values */
 #define DEFAULT_MAX_SIZE_BUFFERS  200   /* 200 buffers */
 #define DEFAULT_MAX_SIZE_BYTES    (10 * 1024 * 1024)    /* 10 MB       */
 #define DEFAULT_MAX_SIZE_TIME     GST_SECOND    /* 1 second    */
+#define DEFAULT_SPIN_TIME         0     /* always block */
 
 #define GST_QUEUE_MUTEX_LOCK(q) G_STMT_START {                          \
   g_mutex_lock (&q->qlock);                                              \
@@ -144,9 +146,11 @@ enum
 
 #define GST_QUEUE_WAIT_DEL_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->sinkpad, "wait for DEL");                               \
-  q->waiting_del = TRUE;                                                \
-  g_cond_wait (&q->item_del, &q->qlock);                                  \
-  q->waiting_del = FALSE;                                               \
+  if (q->spin_time == 0 || !gst_queue_spin_wait (q, &q->del_seq)) {     \
+    q->waiting_del = TRUE;                                              \
+    g_cond_wait (&q->item_del, &q->qlock);                              \
+    q->waiting_del = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received DEL wakeup");                       \
     goto label;                                                         \
@@ -156,9 +160,11 @@ enum
 
 #define GST_QUEUE_WAIT_ADD_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->srcpad, "wait for ADD");                                \
-  q->waiting_add = TRUE;                                                \
-  g_cond_wait (&q->item_add, &q->qlock);                                  \
-  q->waiting_add = FALSE;                                               \
+  if (q->spin_time == 0 || !gst_queue_spin_wait (q, &q->add_seq)) {     \
+    q->waiting_add = TRUE;                                              \
+    g_cond_wait (&q->item_add, &q->qlock);                              \
+    q->waiting_add = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received ADD wakeup");                       \
     goto label;                                                         \
@@ -167,6 +173,8 @@ enum
 } G_STMT_END
 
 #define GST_QUEUE_SIGNAL_DEL(q) G_STMT_START {                          \
+  if (q->spin_time)                                                     \
+    g_atomic_int_inc (&q->del_seq);                                     \
   if (q->waiting_del) {                                                 \
     STATUS (q, q->srcpad, "signal DEL");                                \
     g_cond_signal (&q->item_del);                                        \
@@ -174,12 +182,47 @@ enum
 } G_STMT_END
 
 #define GST_QUEUE_SIGNAL_ADD(q) G_STMT_START {                          \
+  if (q->spin_time)                                                     \
+    g_atomic_int_inc (&q->add_seq);                                     \
   if (q->waiting_add) {                                                 \
     STATUS (q, q->sinkpad, "signal ADD");                               \
     g_cond_signal (&q->item_add);                                        \
   }                                                                     \
 } G_STMT_END
 
+/* Called with the lock when the queue is empty or full. Release the lock
+ * and busy-wait up to spin-time for the other side to signal @seq, which
+ * avoids going to sleep on the condition and a wakeup from the other thread
+ * when it's only slightly behind. Returns with the lock taken and TRUE when
+ * the other side signalled. */
+static gboolean
+gst_queue_spin_wait (GstQueue * q, volatile gint * seq)
+{
+  gint old = g_atomic_int_get (seq);
+  gint64 end;
+  guint i = 0;
+  gboolean res = FALSE;
+
+  end = g_get_monotonic_time () + q->spin_time / 1000;
+
+  GST_QUEUE_MUTEX_UNLOCK (q);
+  do {
+    if (g_atomic_int_get (seq) != old) {
+      res = TRUE;
+      break;
+    }
+    /* don't read the time too often */
+  } while ((++i & 0x3f) != 0 || g_get_monotonic_time () < end);
+  GST_QUEUE_MUTEX_LOCK (q);
+
+  /* the other side could have signalled while we took the lock again, it
+   * will only wake us up from now on as we have the lock */
+  if (!res)
+    res = g_atomic_int_get (seq) != old;
+
+  return res;
+}
+
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (queue_debug, "queue", 0, "queue element"); \
     GST_DEBUG_CATEGORY_INIT (queue_dataflow, "queue_dataflow", 0, \
@@ -402,6 +445,24 @@ gst_queue_class_init (GstQueueClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstQueue:spin-time
+   *
+   * Busy-wait up to this amount of time for the other side when the queue
+   * is empty or full, before blocking. When the upstream and downstream
+   * threads run at a similar pace on different cores, this avoids putting a
+   * thread to sleep and waking it up again for every buffer, at the cost
+   * of burning CPU while waiting. A few microseconds is usually enough.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_SPIN_TIME,
+      g_param_spec_uint64 ("spin-time", "Spin time",
+          "Time to busy-wait for the other side before blocking (in ns)",
+          0, G_MAXUINT64, DEFAULT_SPIN_TIME,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -455,6 +516,7 @@ gst_queue_init (GstQueue * queue)
 
   queue->leaky = GST_QUEUE_NO_LEAK;
   queue->srcresult = GST_FLOW_FLUSHING;
+  queue->spin_time = DEFAULT_SPIN_TIME;
 
   g_mutex_init (&queue->qlock);
   g_cond_init (&queue->item_add);
@@ -1807,6 +1869,9 @@ gst_queue_set_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       queue->flush_on_eos = g_value_get_boolean (value);
       break;
+    case PROP_SPIN_TIME:
+      queue->spin_time = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1860,6 +1925,9 @@ gst_queue_get_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       g_value_set_boolean (value, queue->flush_on_eos);
       break;
+    case PROP_SPIN_TIME:
+      g_value_set_uint64 (value, queue->spin_time);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
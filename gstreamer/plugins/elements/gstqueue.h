@@ -137,6 +137,10 @@ struct _GstQueue {
   gboolean last_query;
 
   gboolean flush_on_eos; /* flush on EOS */
+
+  guint64 spin_time;     /* busy-wait before blocking */
+  volatile gint add_seq; /* bumped on ADD/DEL signals while spinning is on */
+  volatile gint del_seq;
 };
 
 struct _GstQueueClass {
@@ -48,6 +48,11 @@
  *
  * The temp-location property will be used to notify the application of the
  * allocated filename.
+ *
+ * When both temp-template and ring-buffer-max-size are set, the temp file is
+ * used as a ring buffer of the given size. Where supported, the file is then
+ * allocated with its full size and memory mapped, so that data is copied
+ * into and out of the file without a system call per read and write.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -62,6 +67,7 @@
 #include "gst/glib-compat-private.h"
 
 #include <string.h>
+#include <math.h>
 
 #ifdef G_OS_WIN32
 #include <io.h>                 /* lseek, open, close, read */
@@ -73,6 +79,13 @@
 #include <unistd.h>
 #endif
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_POSIX_FALLOCATE
+#include <fcntl.h>
+#endif
+
 #ifdef __BIONIC__               /* Android */
 #undef lseek
 #define lseek lseek64
@@ -105,6 +118,8 @@ enum
 #define QUEUE_IS_USING_TEMP_FILE(queue) ((queue)->temp_template != NULL)
 #define QUEUE_IS_USING_RING_BUFFER(queue) ((queue)->ring_buffer_max_size != 0)  /* for consistency with the above macro */
 #define QUEUE_IS_USING_QUEUE(queue) (!QUEUE_IS_USING_TEMP_FILE(queue) && !QUEUE_IS_USING_RING_BUFFER (queue))
+/* whether data is read and written with stdio, a mapped temp file is not */
+#define QUEUE_IS_USING_FILE_IO(queue) (QUEUE_IS_USING_TEMP_FILE(queue) && !(queue)->ring_buffer_mapped)
 
 #define QUEUE_MAX_BYTES(queue) MIN((queue)->max_level.bytes, (queue)->ring_buffer_max_size)
 
@@ -115,6 +130,7 @@ enum
 #define DEFAULT_USE_BUFFERING      FALSE
 #define DEFAULT_USE_TAGS_BITRATE   FALSE
 #define DEFAULT_USE_RATE_ESTIMATE  TRUE
+#define DEFAULT_USE_BITRATE_ESTIMATE FALSE
 #define DEFAULT_LOW_PERCENT        10
 #define DEFAULT_HIGH_PERCENT       99
 #define DEFAULT_TEMP_REMOVE        TRUE
@@ -139,6 +155,7 @@ enum
   PROP_TEMP_REMOVE,
   PROP_RING_BUFFER_MAX_SIZE,
   PROP_AVG_IN_RATE,
+  PROP_USE_BITRATE_ESTIMATE,
   PROP_LAST
 };
 
@@ -351,6 +368,24 @@ gst_queue2_class_init (GstQueue2Class * klass)
           "Estimate the bitrate of the stream to calculate time level",
           DEFAULT_USE_RATE_ESTIMATE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstQueue2:use-bitrate-estimate
+   *
+   * Express the buffering level in playback time, using the bitrate from
+   * upstream tags (if use-tags-bitrate is enabled) or the measured rate at
+   * which the data is consumed downstream. The buffering target is then
+   * max-size-time for low and high bitrate streams alike, max-size-bytes is
+   * only used as a hard limit. The low watermark is raised above low-percent
+   * when the consumption rate fluctuates.
+   *
+   * Since: 1.10
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_BITRATE_ESTIMATE,
+      g_param_spec_boolean ("use-bitrate-estimate", "Use Bitrate Estimate",
+          "Use the estimated stream bitrate to express the buffering level in "
+          "time and adapt the low watermark to the consumption jitter",
+          DEFAULT_USE_BITRATE_ESTIMATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_LOW_PERCENT,
       g_param_spec_int ("low-percent", "Low percent",
           "Low threshold for buffering to start. Only used if use-buffering is True",
@@ -462,6 +497,7 @@ gst_queue2_init (GstQueue2 * queue)
   queue->max_level.rate_time = DEFAULT_MAX_SIZE_TIME;
   queue->use_buffering = DEFAULT_USE_BUFFERING;
   queue->use_rate_estimate = DEFAULT_USE_RATE_ESTIMATE;
+  queue->use_bitrate_estimate = DEFAULT_USE_BITRATE_ESTIMATE;
   queue->low_percent = DEFAULT_LOW_PERCENT;
   queue->high_percent = DEFAULT_HIGH_PERCENT;
 
@@ -896,6 +932,42 @@ get_percent (guint64 cur_level, guint64 max_level, guint64 alt_max)
   return MIN (p, 100);
 }
 
+/* the rate in bytes per second at which the stream is played back, 0.0 when
+ * not known yet */
+static gdouble
+get_stream_byte_rate (GstQueue2 * queue)
+{
+  if (queue->use_tags_bitrate && queue->src_tags_bitrate)
+    return queue->src_tags_bitrate / 8.0;
+
+  return queue->byte_out_rate;
+}
+
+/* whether the buffering level is expressed in playback time */
+static gboolean
+use_stream_time_level (GstQueue2 * queue)
+{
+  return queue->use_bitrate_estimate && queue->max_level.rate_time > 0
+      && get_stream_byte_rate (queue) > 0.0;
+}
+
+/* the low watermark, raised when the consumption rate fluctuates so that
+ * buffering starts before the jitter can drain the queue */
+static gint
+get_low_percent (GstQueue2 * queue)
+{
+  gdouble cv, low;
+
+  if (!use_stream_time_level (queue) || queue->byte_out_rate <= 0.0)
+    return queue->low_percent;
+
+  /* coefficient of variation of the output rate */
+  cv = sqrt (queue->byte_out_rate_var) / queue->byte_out_rate;
+  low = queue->low_percent * (1.0 + cv);
+
+  return (gint) MIN (low, (queue->low_percent + 100) / 2.0);
+}
+
 static gboolean
 get_buffering_percent (GstQueue2 * queue, gboolean * is_buffering,
     gint * percent)
@@ -931,6 +1003,12 @@ get_buffering_percent (GstQueue2 * queue, gboolean * is_buffering,
       perc = GET_PERCENT (bytes, rb_size);
     }
 
+    /* when the level is measured in time, the byte limit only counts once it
+     * is reached, otherwise low bitrate streams would buffer too much and
+     * high bitrate streams too little */
+    if (use_stream_time_level (queue) && perc < 100)
+      perc = 0;
+
     perc2 = GET_PERCENT (time, 0);
     perc = MAX (perc, perc2);
 
@@ -938,7 +1016,7 @@ get_buffering_percent (GstQueue2 * queue, gboolean * is_buffering,
     perc = MAX (perc, perc2);
 
     /* also apply the rate estimate when we need to */
-    if (queue->use_rate_estimate) {
+    if (queue->use_rate_estimate || queue->use_bitrate_estimate) {
       perc2 = GET_PERCENT (rate_time, 0);
       perc = MAX (perc, perc2);
     }
@@ -990,7 +1068,7 @@ get_buffering_stats (GstQueue2 * queue, gint percent, GstBufferingMode * mode,
   if (buffering_left) {
     *buffering_left = (percent == 100 ? 0 : -1);
 
-    if (queue->use_rate_estimate) {
+    if (queue->use_rate_estimate || queue->use_bitrate_estimate) {
       guint64 max, cur;
 
       max = queue->max_level.rate_time;
@@ -1050,7 +1128,7 @@ update_buffering (GstQueue2 * queue)
   } else {
     /* we were not buffering, check if we need to start buffering if we drop
      * below the low threshold */
-    if (percent < queue->low_percent) {
+    if (percent < get_low_percent (queue)) {
       queue->is_buffering = TRUE;
       SET_PERCENT (queue, percent);
     }
@@ -1065,6 +1143,7 @@ reset_rate_timer (GstQueue2 * queue)
   queue->byte_in_rate = 0.0;
   queue->byte_in_period = 0;
   queue->byte_out_rate = 0.0;
+  queue->byte_out_rate_var = 0.0;
   queue->last_update_in_rates_elapsed = 0.0;
   queue->last_in_elapsed = 0.0;
   queue->last_out_elapsed = 0.0;
@@ -1084,6 +1163,25 @@ reset_rate_timer (GstQueue2 * queue)
 #define AVG_IN(avg,val,w1,w2)  ((avg) * (w1) + (val) * (w2)) / ((w1) + (w2))
 #define AVG_OUT(avg,val) ((avg) * 3.0 + (val)) / 4.0
 
+/* update the rate based time level. Normally this is the time needed to
+ * download the queued data again, with use-bitrate-estimate it is the time
+ * it takes to play it back */
+static void
+update_rate_time (GstQueue2 * queue)
+{
+  gdouble rate = queue->byte_in_rate;
+
+  if (queue->use_bitrate_estimate) {
+    gdouble stream_rate = get_stream_byte_rate (queue);
+
+    if (stream_rate > 0.0)
+      rate = stream_rate;
+  }
+
+  if (rate > 0.0)
+    queue->cur_level.rate_time = queue->cur_level.bytes / rate * GST_SECOND;
+}
+
 static void
 update_in_rates (GstQueue2 * queue)
 {
@@ -1124,10 +1222,7 @@ update_in_rates (GstQueue2 * queue)
     queue->bytes_in = 0;
   }
 
-  if (queue->byte_in_rate > 0.0) {
-    queue->cur_level.rate_time =
-        queue->cur_level.bytes / queue->byte_in_rate * GST_SECOND;
-  }
+  update_rate_time (queue);
   GST_DEBUG_OBJECT (queue, "rates: in %f, time %" GST_TIME_FORMAT,
       queue->byte_in_rate, GST_TIME_ARGS (queue->cur_level.rate_time));
 }
@@ -1155,19 +1250,22 @@ update_out_rates (GstQueue2 * queue)
 
     byte_out_rate = queue->bytes_out / period;
 
-    if (queue->byte_out_rate == 0.0)
+    if (queue->byte_out_rate == 0.0) {
       queue->byte_out_rate = byte_out_rate;
-    else
+    } else {
+      gdouble diff = byte_out_rate - queue->byte_out_rate;
+
+      queue->byte_out_rate_var =
+          AVG_OUT (queue->byte_out_rate_var, diff * diff);
       queue->byte_out_rate = AVG_OUT (queue->byte_out_rate, byte_out_rate);
+    }
 
     /* reset the values to calculate rate over the next interval */
     queue->last_out_elapsed = elapsed;
     queue->bytes_out = 0;
   }
-  if (queue->byte_in_rate > 0.0) {
-    queue->cur_level.rate_time =
-        queue->cur_level.bytes / queue->byte_in_rate * GST_SECOND;
-  }
+
+  update_rate_time (queue);
   GST_DEBUG_OBJECT (queue, "rates: out %f, time %" GST_TIME_FORMAT,
       queue->byte_out_rate, GST_TIME_ARGS (queue->cur_level.rate_time));
 }
@@ -1314,13 +1412,13 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
 
   ring_buffer = queue->ring_buffer;
 
-  if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, offset))
+  if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, offset))
     goto seek_failed;
 
   /* this should not block */
   GST_LOG_OBJECT (queue, "Reading %d bytes from offset %" G_GUINT64_FORMAT,
       length, offset);
-  if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+  if (QUEUE_IS_USING_FILE_IO (queue)) {
     res = fread (dst, 1, length, queue->temp_file);
   } else {
     memcpy (dst, ring_buffer + offset, length);
@@ -1330,7 +1428,7 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
   GST_LOG_OBJECT (queue, "read %" G_GSIZE_FORMAT " bytes", res);
 
   if (G_UNLIKELY (res < length)) {
-    if (!QUEUE_IS_USING_TEMP_FILE (queue))
+    if (!QUEUE_IS_USING_FILE_IO (queue))
       goto could_not_read;
     /* check for errors or EOF */
     if (ferror (queue->temp_file))
@@ -1580,6 +1678,72 @@ gst_queue2_read_item_from_file (GstQueue2 * queue)
   return item;
 }
 
+/* allocate the ring buffer in the temp file and map it. When that fails we
+ * read and write the file with stdio instead */
+static void
+gst_queue2_map_temp_file (GstQueue2 * queue)
+{
+#ifdef HAVE_MMAP
+  guint64 size = queue->ring_buffer_max_size;
+  gint fd = fileno (queue->temp_file);
+  gpointer data;
+
+  if (size > G_MAXSIZE)
+    goto too_big;
+
+#ifdef HAVE_POSIX_FALLOCATE
+  if (posix_fallocate (fd, 0, (off_t) size) != 0)
+    goto allocate_failed;
+#else
+  if (ftruncate (fd, (off_t) size) < 0)
+    goto allocate_failed;
+#endif
+
+  data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+    goto mmap_failed;
+
+  queue->ring_buffer = data;
+  queue->ring_buffer_mapped = TRUE;
+
+  GST_DEBUG_OBJECT (queue, "mapped %" G_GUINT64_FORMAT " bytes of temp file",
+      size);
+  return;
+
+  /* ERRORS */
+too_big:
+  {
+    GST_DEBUG_OBJECT (queue, "ring buffer too big to map");
+    return;
+  }
+allocate_failed:
+  {
+    GST_WARNING_OBJECT (queue, "could not allocate temp file: %s",
+        g_strerror (errno));
+    return;
+  }
+mmap_failed:
+  {
+    GST_WARNING_OBJECT (queue, "could not map temp file: %s",
+        g_strerror (errno));
+    return;
+  }
+#endif
+}
+
+static void
+gst_queue2_unmap_temp_file (GstQueue2 * queue)
+{
+#ifdef HAVE_MMAP
+  if (!queue->ring_buffer_mapped)
+    return;
+
+  munmap (queue->ring_buffer, queue->ring_buffer_max_size);
+  queue->ring_buffer = NULL;
+  queue->ring_buffer_mapped = FALSE;
+#endif
+}
+
 /* must be called with MUTEX_LOCK. Will briefly release the lock when notifying
  * the temp filename. */
 static gboolean
@@ -1620,6 +1784,9 @@ gst_queue2_open_temp_location_file (GstQueue2 * queue)
   g_free (queue->temp_location);
   queue->temp_location = name;
 
+  if (QUEUE_IS_USING_RING_BUFFER (queue))
+    gst_queue2_map_temp_file (queue);
+
   GST_QUEUE2_MUTEX_UNLOCK (queue);
 
   /* we can't emit the notify with the lock */
@@ -1671,6 +1838,7 @@ gst_queue2_close_temp_location_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "closing temp file");
 
+  gst_queue2_unmap_temp_file (queue);
   fflush (queue->temp_file);
   fclose (queue->temp_file);
 
@@ -1691,6 +1859,10 @@ gst_queue2_flush_temp_file (GstQueue2 * queue)
   if (queue->temp_file == NULL)
     return;
 
+  /* the ranges are reset, old data in the mapping will be overwritten */
+  if (queue->ring_buffer_mapped)
+    return;
+
   GST_DEBUG_OBJECT (queue, "flushing temp file");
 
   queue->temp_file = g_freopen (queue->temp_location, "wb+", queue->temp_file);
@@ -1928,7 +2100,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       new_writing_pos = writing_pos + to_write;
     }
 
-    if (QUEUE_IS_USING_TEMP_FILE (queue)
+    if (QUEUE_IS_USING_FILE_IO (queue)
         && FSEEK_FILE (queue->temp_file, writing_pos))
       goto seek_failed;
 
@@ -1938,7 +2110,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
           "] (rb wpos %" G_GUINT64_FORMAT ")", to_write, queue->current->offset,
           queue->current->writing_pos, queue->current->rb_writing_pos);
       /* either not using ring buffer or no wrapping, just write */
-      if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+      if (QUEUE_IS_USING_FILE_IO (queue)) {
         if (fwrite (data, to_write, 1, queue->temp_file) != 1)
           goto handle_error;
       } else {
@@ -1983,7 +2155,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       if (block_one > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_one);
         /* write data to end of ring buffer */
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data, block_one, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -1991,12 +2163,12 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
         }
       }
 
-      if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, 0))
+      if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, 0))
         goto seek_failed;
 
       if (block_two > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_two);
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data + block_one, block_two, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -2646,7 +2818,7 @@ gst_queue2_is_filled (GstQueue2 * queue)
 
   /* if we need to, use the rate estimate to check against the max time we are
    * allowed to queue */
-  if (queue->use_rate_estimate)
+  if (queue->use_rate_estimate || queue->use_bitrate_estimate)
     res |= CHECK_FILLED (rate_time, 0);
 
 #undef CHECK_FILLED
@@ -3667,6 +3839,9 @@ gst_queue2_set_property (GObject * object,
     case PROP_USE_RATE_ESTIMATE:
       queue->use_rate_estimate = g_value_get_boolean (value);
       break;
+    case PROP_USE_BITRATE_ESTIMATE:
+      queue->use_bitrate_estimate = g_value_get_boolean (value);
+      break;
     case PROP_LOW_PERCENT:
       queue->low_percent = g_value_get_int (value);
       break;
@@ -3727,6 +3902,9 @@ gst_queue2_get_property (GObject * object,
     case PROP_USE_RATE_ESTIMATE:
       g_value_set_boolean (value, queue->use_rate_estimate);
       break;
+    case PROP_USE_BITRATE_ESTIMATE:
+      g_value_set_boolean (value, queue->use_bitrate_estimate);
+      break;
     case PROP_LOW_PERCENT:
       g_value_set_int (value, queue->low_percent);
       break;
@@ -108,6 +108,7 @@ struct _GstQueue2
   gboolean use_buffering;
   gboolean use_tags_bitrate;
   gboolean use_rate_estimate;
+  gboolean use_bitrate_estimate;
   GstClockTime buffering_interval;
   gint low_percent;             /* low/high watermarks for buffering */
   gint high_percent;
@@ -130,6 +131,7 @@ struct _GstQueue2
   gdouble last_out_elapsed;
   guint64 bytes_out;
   gdouble byte_out_rate;
+  gdouble byte_out_rate_var;    /* variance of the output rate samples */
 
   GMutex qlock;                /* lock for queue (vs object lock) */
   gboolean waiting_add;
@@ -156,6 +158,8 @@ struct _GstQueue2
 
   guint64 ring_buffer_max_size;
   guint8 * ring_buffer;
+  /* ring_buffer is the mapped temp file */
+  gboolean ring_buffer_mapped;
 
   volatile gint downstream_may_block;
 
@@ -61,7 +61,7 @@ typedef struct _GstSparseRange GstSparseRange;
 
 struct _GstSparseRange
 {
-  GstSparseRange *next;
+  GSequenceIter *iter;
 
   gsize start;
   gsize stop;
@@ -75,49 +75,70 @@ struct _GstSparseFile
   FILE *file;
   gsize current_pos;
 
-  GstSparseRange *ranges;
-  guint n_ranges;
+  /* disjoint ranges sorted by start, adjacent ranges are merged */
+  GSequence *ranges;
 
   GstSparseRange *write_range;
   GstSparseRange *read_range;
 };
 
+static void
+range_free (GstSparseRange * range)
+{
+  g_slice_free (GstSparseRange, range);
+}
+
+/* never returns 0 so that the search ends after all ranges starting at or
+ * before the offset */
+static gint
+range_compare_offset (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const GstSparseRange *range = a;
+  const gsize *offset = b;
+
+  return range->start <= *offset ? -1 : 1;
+}
+
+/* first range that starts after @offset, or the end iter */
+static GSequenceIter *
+find_range_after (GstSparseFile * file, gsize offset)
+{
+  return g_sequence_search (file->ranges, &offset, range_compare_offset, NULL);
+}
+
+/* last range that starts at or before @offset, or NULL */
+static GstSparseRange *
+find_range_before (GstSparseFile * file, gsize offset)
+{
+  GSequenceIter *iter;
+
+  iter = find_range_after (file, offset);
+  if (g_sequence_iter_is_begin (iter))
+    return NULL;
+
+  return g_sequence_get (g_sequence_iter_prev (iter));
+}
+
 static GstSparseRange *
 get_write_range (GstSparseFile * file, gsize offset)
 {
-  GstSparseRange *next, *prev, *result = NULL;
+  GstSparseRange *result;
+  GSequenceIter *next;
 
   if (file->write_range && file->write_range->stop == offset)
     return file->write_range;
 
-  prev = NULL;
-  next = file->ranges;
-  while (next) {
-    if (next->start > offset)
-      break;
+  result = find_range_before (file, offset);
+  if (result == NULL || result->stop < offset) {
+    next = find_range_after (file, offset);
 
-    if (next->stop >= offset) {
-      result = next;
-      break;
-    }
-    prev = next;
-    next = next->next;
-  }
-  if (result == NULL) {
     result = g_slice_new0 (GstSparseRange);
     result->start = offset;
     result->stop = offset;
-
-    result->next = next;
-    if (prev)
-      prev->next = result;
-    else
-      file->ranges = result;
+    result->iter = g_sequence_insert_before (next, result);
 
     file->write_range = result;
     file->read_range = NULL;
-
-    file->n_ranges++;
   }
   return result;
 }
@@ -125,21 +146,16 @@ get_write_range (GstSparseFile * file, gsize offset)
 static GstSparseRange *
 get_read_range (GstSparseFile * file, gsize offset, gsize count)
 {
-  GstSparseRange *walk, *result = NULL;
+  GstSparseRange *result;
 
   if (file->read_range && RANGE_CONTAINS (file->read_range, offset))
     return file->read_range;
 
-  for (walk = file->ranges; walk; walk = walk->next) {
-    if (walk->start > offset)
-      break;
+  result = find_range_before (file, offset);
+  if (result && result->stop >= offset + count)
+    return result;
 
-    if (walk->stop >= offset + count) {
-      result = walk;
-      break;
-    }
-  }
-  return result;
+  return NULL;
 }
 
 /**
@@ -158,8 +174,7 @@ gst_sparse_file_new (void)
 
   result = g_slice_new0 (GstSparseFile);
   result->current_pos = 0;
-  result->ranges = NULL;
-  result->n_ranges = 0;
+  result->ranges = g_sequence_new ((GDestroyNotify) range_free);
 
   return result;
 }
@@ -202,10 +217,11 @@ gst_sparse_file_clear (GstSparseFile * file)
     fclose (file->file);
     file->file = fdopen (file->fd, "wb+");
   }
-  g_slice_free_chain (GstSparseRange, file->ranges, next);
+  g_sequence_remove_range (g_sequence_get_begin_iter (file->ranges),
+      g_sequence_get_end_iter (file->ranges));
   file->current_pos = 0;
-  file->ranges = NULL;
-  file->n_ranges = 0;
+  file->write_range = NULL;
+  file->read_range = NULL;
 }
 
 /**
@@ -225,7 +241,7 @@ gst_sparse_file_free (GstSparseFile * file)
     fflush (file->file);
     fclose (file->file);
   }
-  g_slice_free_chain (GstSparseRange, file->ranges, next);
+  g_sequence_free (file->ranges);
   g_slice_free (GstSparseFile, file);
 }
 
@@ -252,6 +268,7 @@ gst_sparse_file_write (GstSparseFile * file, gsize offset, gconstpointer data,
     gsize count, gsize * available, GError ** error)
 {
   GstSparseRange *range, *next;
+  GSequenceIter *iter;
   gsize stop;
 
   g_return_val_if_fail (file != NULL, 0);
@@ -275,7 +292,8 @@ gst_sparse_file_write (GstSparseFile * file, gsize offset, gconstpointer data,
   range->stop = MAX (range->stop, stop);
 
   /* see if we can merge with next region */
-  while ((next = range->next)) {
+  while (!g_sequence_iter_is_end (iter = g_sequence_iter_next (range->iter))) {
+    next = g_sequence_get (iter);
     if (next->start > range->stop)
       break;
 
@@ -284,14 +302,12 @@ gst_sparse_file_write (GstSparseFile * file, gsize offset, gconstpointer data,
         next->start, next->stop);
 
     range->stop = MAX (next->stop, range->stop);
-    range->next = next->next;
 
     if (file->write_range == next)
       file->write_range = NULL;
     if (file->read_range == next)
       file->read_range = NULL;
-    g_slice_free (GstSparseRange, next);
-    file->n_ranges--;
+    g_sequence_remove (iter);
   }
   if (available)
     *available = range->stop - stop;
@@ -396,7 +412,7 @@ gst_sparse_file_n_ranges (GstSparseFile * file)
 {
   g_return_val_if_fail (file != NULL, 0);
 
-  return file->n_ranges;
+  return g_sequence_get_length (file->ranges);
 }
 
 /**
@@ -417,20 +433,11 @@ gboolean
 gst_sparse_file_get_range_before (GstSparseFile * file, gsize offset,
     gsize * start, gsize * stop)
 {
-  GstSparseRange *walk, *result = NULL;
+  GstSparseRange *result;
 
   g_return_val_if_fail (file != NULL, FALSE);
 
-  for (walk = file->ranges; walk; walk = walk->next) {
-    GST_DEBUG ("start %" G_GSIZE_FORMAT " > %" G_GSIZE_FORMAT,
-        walk->stop, offset);
-    if (walk->start > offset)
-      break;
-
-    if (walk->start <= offset)
-      result = walk;
-  }
-
+  result = find_range_before (file, offset);
   if (result) {
     if (start)
       *start = result->start;
@@ -458,17 +465,15 @@ gboolean
 gst_sparse_file_get_range_after (GstSparseFile * file, gsize offset,
     gsize * start, gsize * stop)
 {
-  GstSparseRange *walk, *result = NULL;
+  GstSparseRange *result;
+  GSequenceIter *iter;
 
   g_return_val_if_fail (file != NULL, FALSE);
 
-  for (walk = file->ranges; walk; walk = walk->next) {
-    GST_DEBUG ("stop %" G_GSIZE_FORMAT " > %" G_GSIZE_FORMAT,
-        walk->stop, offset);
-    if (walk->stop > offset) {
-      result = walk;
-      break;
-    }
+  result = find_range_before (file, offset);
+  if (result == NULL || result->stop <= offset) {
+    iter = find_range_after (file, offset);
+    result = g_sequence_iter_is_end (iter) ? NULL : g_sequence_get (iter);
   }
   if (result) {
     if (start)
@@ -479,6 +484,46 @@ gst_sparse_file_get_range_after (GstSparseFile * file, gsize offset,
   return result != NULL;
 }
 
+/**
+ * gst_sparse_file_get_missing_range:
+ * @file: a #GstSparseFile
+ * @offset: the range offset
+ * @start: result start
+ * @stop: result stop
+ *
+ * Get the start and stop offset of the first range without data at or after
+ * @offset. When no data was written after the missing range, @stop is set to
+ * %G_MAXSIZE.
+ *
+ * Returns: %TRUE if there is a range with data after the missing range.
+ *
+ * Since: 1.10
+ */
+gboolean
+gst_sparse_file_get_missing_range (GstSparseFile * file, gsize offset,
+    gsize * start, gsize * stop)
+{
+  GstSparseRange *range;
+  GSequenceIter *iter;
+
+  g_return_val_if_fail (file != NULL, FALSE);
+
+  /* ranges are merged, so the data before us ends at a missing range */
+  range = find_range_before (file, offset);
+  if (range && range->stop > offset)
+    offset = range->stop;
+
+  iter = find_range_after (file, offset);
+
+  if (start)
+    *start = offset;
+  if (stop)
+    *stop = g_sequence_iter_is_end (iter) ? G_MAXSIZE :
+        ((GstSparseRange *) g_sequence_get (iter))->start;
+
+  return !g_sequence_iter_is_end (iter);
+}
+
 /* we don't want to rely on libgio just for g_io_error_from_errno() */
 static GstSparseFileIOErrorEnum
 gst_sparse_file_io_error_from_errno (gint err_no)
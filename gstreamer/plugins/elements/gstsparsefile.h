@@ -103,6 +103,9 @@ gboolean        gst_sparse_file_get_range_before (GstSparseFile *file, gsize off
 gboolean        gst_sparse_file_get_range_after  (GstSparseFile *file, gsize offset,
                                                   gsize *start, gsize *stop);
 
+gboolean        gst_sparse_file_get_missing_range (GstSparseFile *file, gsize offset,
+                                                   gsize *start, gsize *stop);
+
 G_END_DECLS
 
 #endif /* __GST_SPARSE_FILE_H__ */
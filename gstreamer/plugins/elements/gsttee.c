@@ -34,6 +34,13 @@
  * provide separate threads for each branch. Otherwise a blocked dataflow in one
  * branch would stall the other branches.
  *
+ * ALLOCATION queries are answered by combining the answers of all branches.
+ * A pool or allocator proposed by a single branch is kept as long as the
+ * other branches accept any memory, so that one branch that can't do
+ * zero-copy doesn't force plain memory onto all of them. With the
+ * #GstTee:alloc-pad property the branch whose pool and allocator win can be
+ * chosen explicitly.
+ *
  * <refsect2>
  * <title>Example launch line</title>
  * |[
@@ -262,7 +269,7 @@ gst_tee_class_init (GstTeeClass * klass)
           DEFAULT_PULL_MODE,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   pspec_alloc_pad = g_param_spec_object ("alloc-pad", "Allocation Src Pad",
-      "The pad ALLOCATION queries will be proxied to (unused)", GST_TYPE_PAD,
+      "The pad whose pool and allocator are preferred in ALLOCATION queries", GST_TYPE_PAD,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
   g_object_class_install_property (gobject_class, PROP_ALLOC_PAD,
       pspec_alloc_pad);
@@ -563,12 +570,198 @@ gst_tee_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
   return res;
 }
 
+typedef struct
+{
+  GstTee *tee;
+  GstCaps *caps;
+  gboolean need_pool;
+  GstPad *allocpad;
+  gboolean allocpad_answered;
+
+  /* answers of the branches, the one of allocpad first if it answered */
+  GPtrArray *answers;
+} AllocQueryCtx;
+
+static gboolean
+gst_tee_query_allocation_forward (GstPad * pad, AllocQueryCtx * ctx)
+{
+  GstQuery *query;
+
+  query = gst_query_new_allocation (ctx->caps, ctx->need_pool);
+  if (!gst_pad_peer_query (pad, query)) {
+    /* unlinked or failing branches don't constrain the allocation */
+    GST_DEBUG_OBJECT (ctx->tee, "allocation query on pad %s:%s failed",
+        GST_DEBUG_PAD_NAME (pad));
+    gst_query_unref (query);
+    return FALSE;
+  }
+
+  if (pad == ctx->allocpad) {
+    g_ptr_array_insert (ctx->answers, 0, query);
+    ctx->allocpad_answered = TRUE;
+  } else {
+    g_ptr_array_add (ctx->answers, query);
+  }
+
+  return FALSE;
+}
+
+/* Returns the object (allocator or pool) to propose upstream: the one of the
+ * preferred branch if it has one, otherwise the one of the only branch
+ * that proposes one. Branches without an object accept any memory. */
+static gpointer
+gst_tee_pick_alloc_object (GstTee * tee, GPtrArray * objects,
+    gboolean have_allocpad)
+{
+  gpointer obj = NULL;
+  guint i;
+
+  for (i = 0; i < objects->len; i++) {
+    gpointer o = g_ptr_array_index (objects, i);
+
+    if (o == NULL)
+      continue;
+    if (i == 0 && have_allocpad)
+      return o;
+    if (obj && obj != o) {
+      GST_DEBUG_OBJECT (tee, "branches propose different %" GST_PTR_FORMAT
+          " and %" GST_PTR_FORMAT, obj, o);
+      return NULL;
+    }
+    obj = o;
+  }
+  return obj;
+}
+
+/* Aggregates the allocation queries of all branches. Instead of falling
+ * back to plain system memory as soon as the branches differ, the pool
+ * and allocator of a branch that proposes one are kept when the other
+ * branches accept any memory, or the ones of the alloc-pad branch if set.
+ * All branches receive the same buffers, so the minimum number of buffers
+ * is the sum of all branches and only metas all branches support are
+ * kept. */
+static gboolean
+gst_tee_query_allocation (GstTee * tee, GstQuery * query)
+{
+  AllocQueryCtx ctx;
+  GPtrArray *allocators, *pools;
+  GstAllocationParams params, aparams;
+  GstAllocator *allocator;
+  GstBufferPool *pool;
+  GstQuery *first;
+  guint i, j, n, size = 0, min = 0, max = 0, psize, pmin, pmax;
+  gboolean unlimited = FALSE, have_pool = FALSE;
+
+  gst_query_parse_allocation (query, &ctx.caps, &ctx.need_pool);
+  ctx.tee = tee;
+  ctx.allocpad_answered = FALSE;
+  ctx.answers = g_ptr_array_new_with_free_func (
+      (GDestroyNotify) gst_mini_object_unref);
+
+  GST_OBJECT_LOCK (tee);
+  ctx.allocpad = tee->allocpad ? gst_object_ref (tee->allocpad) : NULL;
+  GST_OBJECT_UNLOCK (tee);
+
+  gst_pad_forward (tee->sinkpad,
+      (GstPadForwardFunction) gst_tee_query_allocation_forward, &ctx);
+
+  if (ctx.answers->len == 0) {
+    GST_DEBUG_OBJECT (tee, "no branch answered the allocation query");
+    g_ptr_array_unref (ctx.answers);
+    if (ctx.allocpad)
+      gst_object_unref (ctx.allocpad);
+    return FALSE;
+  }
+
+  allocators = g_ptr_array_new ();
+  pools = g_ptr_array_new ();
+  gst_allocation_params_init (&params);
+
+  for (i = 0; i < ctx.answers->len; i++) {
+    GstQuery *q = g_ptr_array_index (ctx.answers, i);
+
+    allocator = NULL;
+    if (gst_query_get_n_allocation_params (q) > 0) {
+      gst_query_parse_nth_allocation_param (q, 0, &allocator, &aparams);
+      params.flags |= aparams.flags;
+      params.align = MAX (params.align, aparams.align);
+      params.prefix = MAX (params.prefix, aparams.prefix);
+      params.padding = MAX (params.padding, aparams.padding);
+    }
+    g_ptr_array_add (allocators, allocator);
+
+    pool = NULL;
+    if (gst_query_get_n_allocation_pools (q) > 0) {
+      gst_query_parse_nth_allocation_pool (q, 0, &pool, &psize, &pmin, &pmax);
+      size = MAX (size, psize);
+      min += pmin;
+      if (pmax == 0)
+        unlimited = TRUE;
+      max += pmax;
+      have_pool = TRUE;
+    }
+    g_ptr_array_add (pools, pool);
+  }
+
+  allocator = gst_tee_pick_alloc_object (tee, allocators,
+      ctx.allocpad_answered);
+  pool = gst_tee_pick_alloc_object (tee, pools, ctx.allocpad_answered);
+
+  GST_DEBUG_OBJECT (tee, "%u branches answered, using allocator %"
+      GST_PTR_FORMAT " and pool %" GST_PTR_FORMAT, ctx.answers->len,
+      allocator, pool);
+
+  gst_query_add_allocation_param (query, allocator, &params);
+  if (have_pool)
+    gst_query_add_allocation_pool (query, pool, size, min,
+        unlimited ? 0 : max);
+
+  /* keep the metas all branches support */
+  first = g_ptr_array_index (ctx.answers, 0);
+  n = gst_query_get_n_allocation_metas (first);
+  for (i = 0; i < n; i++) {
+    const GstStructure *mparams;
+    GType api;
+
+    api = gst_query_parse_nth_allocation_meta (first, i, &mparams);
+
+    for (j = 1; j < ctx.answers->len; j++) {
+      if (!gst_query_find_allocation_meta (g_ptr_array_index (ctx.answers,
+                  j), api, NULL))
+        break;
+    }
+    if (j == ctx.answers->len)
+      gst_query_add_allocation_meta (query, api, mparams);
+    else
+      GST_DEBUG_OBJECT (tee, "not all branches support %s",
+          g_type_name (api));
+  }
+
+  for (i = 0; i < allocators->len; i++) {
+    if (g_ptr_array_index (allocators, i))
+      gst_object_unref (g_ptr_array_index (allocators, i));
+    if (g_ptr_array_index (pools, i))
+      gst_object_unref (g_ptr_array_index (pools, i));
+  }
+  g_ptr_array_unref (allocators);
+  g_ptr_array_unref (pools);
+  g_ptr_array_unref (ctx.answers);
+  if (ctx.allocpad)
+    gst_object_unref (ctx.allocpad);
+
+  return TRUE;
+}
+
 static gboolean
 gst_tee_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
 {
+  GstTee *tee = GST_TEE_CAST (parent);
   gboolean res;
 
   switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_ALLOCATION:
+      res = gst_tee_query_allocation (tee, query);
+      break;
     default:
       res = gst_pad_query_default (pad, parent, query);
       break;
@@ -79,6 +79,8 @@
 #include <gst/gstutils.h>
 #include <gst/gsterror.h>
 
+#include <glib/gstdio.h>
+
 GST_DEBUG_CATEGORY_STATIC (gst_type_find_element_debug);
 #define GST_CAT_DEFAULT gst_type_find_element_debug
 
@@ -793,12 +795,10 @@ gst_type_find_element_setcaps (GstTypeFindElement * typefind, GstCaps * caps)
 }
 
 static gchar *
-gst_type_find_get_extension (GstTypeFindElement * typefind, GstPad * pad)
+gst_type_find_get_uri (GstTypeFindElement * typefind, GstPad * pad)
 {
   GstQuery *query;
-  gchar *uri, *result;
-  size_t len;
-  gint find;
+  gchar *uri;
 
   query = gst_query_new_uri ();
 
@@ -810,6 +810,33 @@ gst_type_find_get_extension (GstTypeFindElement * typefind, GstPad * pad)
   if (uri == NULL)
     goto no_uri;
 
+  gst_query_unref (query);
+
+  return uri;
+
+  /* ERRORS */
+peer_query_failed:
+  {
+    GST_WARNING_OBJECT (typefind, "failed to query peer uri");
+    gst_query_unref (query);
+    return NULL;
+  }
+no_uri:
+  {
+    GST_WARNING_OBJECT (typefind, "could not parse the peer uri");
+    gst_query_unref (query);
+    return NULL;
+  }
+}
+
+static gchar *
+gst_type_find_extension_from_uri (GstTypeFindElement * typefind,
+    const gchar * uri)
+{
+  gchar *result;
+  size_t len;
+  gint find;
+
   GST_DEBUG_OBJECT (typefind, "finding extension of %s", uri);
 
   /* find the extension on the uri, this is everything after a '.' */
@@ -827,31 +854,111 @@ gst_type_find_get_extension (GstTypeFindElement * typefind, GstPad * pad)
   result = g_strdup (&uri[find + 1]);
 
   GST_DEBUG_OBJECT (typefind, "found extension %s", result);
-  gst_query_unref (query);
-  g_free (uri);
 
   return result;
 
   /* ERRORS */
-peer_query_failed:
+no_extension:
   {
-    GST_WARNING_OBJECT (typefind, "failed to query peer uri");
-    gst_query_unref (query);
+    GST_WARNING_OBJECT (typefind, "could not find uri extension in %s", uri);
     return NULL;
   }
-no_uri:
-  {
-    GST_WARNING_OBJECT (typefind, "could not parse the peer uri");
-    gst_query_unref (query);
+}
+
+static gchar *
+gst_type_find_get_extension (GstTypeFindElement * typefind, GstPad * pad)
+{
+  gchar *uri, *result;
+
+  uri = gst_type_find_get_uri (typefind, pad);
+  if (uri == NULL)
     return NULL;
-  }
-no_extension:
-  {
-    GST_WARNING_OBJECT (typefind, "could not find uri extension in %s", uri);
-    gst_query_unref (query);
-    g_free (uri);
+
+  result = gst_type_find_extension_from_uri (typefind, uri);
+  g_free (uri);
+
+  return result;
+}
+
+/* Results of pull mode typefinding of local files, keyed on the URI, size
+ * and modification time of the file, so that opening the same file again
+ * doesn't run all the typefind functions over it another time */
+#define TYPE_FIND_CACHE_MAX_ENTRIES 256
+
+typedef struct
+{
+  GstCaps *caps;
+  GstTypeFindProbability probability;
+} GstTypeFindCacheEntry;
+
+static GHashTable *type_find_cache = NULL;
+G_LOCK_DEFINE_STATIC (type_find_cache);
+
+static void
+gst_type_find_cache_entry_free (GstTypeFindCacheEntry * entry)
+{
+  gst_caps_unref (entry->caps);
+  g_slice_free (GstTypeFindCacheEntry, entry);
+}
+
+static gchar *
+gst_type_find_cache_key (const gchar * uri, gint64 size)
+{
+  gchar *filename, *key = NULL;
+  GStatBuf st;
+
+  filename = g_filename_from_uri (uri, NULL, NULL);
+  if (filename == NULL)
     return NULL;
+
+  if (g_stat (filename, &st) == 0)
+    key = g_strdup_printf ("%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT ":%s",
+        size, (gint64) st.st_mtime, uri);
+  g_free (filename);
+
+  return key;
+}
+
+static GstCaps *
+gst_type_find_cache_lookup (const gchar * key,
+    GstTypeFindProbability * probability)
+{
+  GstTypeFindCacheEntry *entry;
+  GstCaps *caps = NULL;
+
+  G_LOCK (type_find_cache);
+  if (type_find_cache
+      && (entry = g_hash_table_lookup (type_find_cache, key))) {
+    caps = gst_caps_ref (entry->caps);
+    *probability = entry->probability;
   }
+  G_UNLOCK (type_find_cache);
+
+  return caps;
+}
+
+static void
+gst_type_find_cache_store (const gchar * key, GstCaps * caps,
+    GstTypeFindProbability probability)
+{
+  GstTypeFindCacheEntry *entry;
+
+  entry = g_slice_new (GstTypeFindCacheEntry);
+  entry->caps = gst_caps_ref (caps);
+  entry->probability = probability;
+
+  G_LOCK (type_find_cache);
+  if (type_find_cache == NULL) {
+    type_find_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) gst_type_find_cache_entry_free);
+  } else if (g_hash_table_size (type_find_cache) >=
+      TYPE_FIND_CACHE_MAX_ENTRIES) {
+    /* no need for anything smarter, the files of a library get opened in
+     * batches */
+    g_hash_table_remove_all (type_find_cache);
+  }
+  g_hash_table_replace (type_find_cache, g_strdup (key), entry);
+  G_UNLOCK (type_find_cache);
 }
 
 static GstCaps *
@@ -1107,7 +1214,7 @@ gst_type_find_element_loop (GstPad * pad)
       peer = gst_pad_get_peer (pad);
       if (peer) {
         gint64 size;
-        gchar *ext;
+        gchar *uri, *ext = NULL, *cache_key = NULL;
 
         if (!gst_pad_query_duration (peer, GST_FORMAT_BYTES, &size)) {
           GST_WARNING_OBJECT (typefind, "Could not query upstream length!");
@@ -1126,16 +1233,33 @@ gst_type_find_element_loop (GstPad * pad)
           ret = GST_FLOW_ERROR;
           goto pause;
         }
-        ext = gst_type_find_get_extension (typefind, pad);
+        uri = gst_type_find_get_uri (typefind, pad);
+        if (uri) {
+          ext = gst_type_find_extension_from_uri (typefind, uri);
+          cache_key = gst_type_find_cache_key (uri, size);
+          g_free (uri);
+        }
 
-        found_caps =
-            gst_type_find_helper_get_range (GST_OBJECT_CAST (peer),
-            GST_OBJECT_PARENT (peer),
-            (GstTypeFindHelperGetRangeFunction) (GST_PAD_GETRANGEFUNC (peer)),
-            (guint64) size, ext, &probability);
-        g_free (ext);
+        if (cache_key)
+          found_caps = gst_type_find_cache_lookup (cache_key, &probability);
+
+        if (found_caps) {
+          GST_DEBUG ("Found cached caps %" GST_PTR_FORMAT, found_caps);
+        } else {
+          found_caps =
+              gst_type_find_helper_get_range (GST_OBJECT_CAST (peer),
+              GST_OBJECT_PARENT (peer),
+              (GstTypeFindHelperGetRangeFunction) (GST_PAD_GETRANGEFUNC
+                  (peer)), (guint64) size, ext, &probability);
+
+          GST_DEBUG ("Found caps %" GST_PTR_FORMAT, found_caps);
 
-        GST_DEBUG ("Found caps %" GST_PTR_FORMAT, found_caps);
+          if (found_caps && cache_key
+              && probability >= typefind->min_probability)
+            gst_type_find_cache_store (cache_key, found_caps, probability);
+        }
+        g_free (ext);
+        g_free (cache_key);
 
         gst_object_unref (peer);
       }
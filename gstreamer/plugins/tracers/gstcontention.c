@@ -0,0 +1,548 @@
+/* GStreamer
+ * Copyright (C) 2016 The GStreamer developers
+ *
+ * gstcontention.c: tracing module that logs where streaming threads block
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:gstcontention
+ * @short_description: log where streaming threads block
+ *
+ * A tracing module that helps finding the bottleneck of a pipeline. When the
+ * tracer is shut down it logs:
+ *
+ * - for each streaming thread, the time spent pushing data downstream, the
+ *   time spent blocked on a full queue, queue2 or multiqueue and the time
+ *   spent outside of any push (waiting for input or producing data in a
+ *   source).
+ * - for each queue and queue2, a histogram of the fill level sampled each
+ *   time a buffer goes in or out.
+ * - for each pad, the number of pushes and the mean, 50th, 90th and 99th
+ *   percentile and maximum time a push took. The percentiles are approximate,
+ *   with a resolution of a power of two.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstcontention.h"
+
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (gst_contention_debug);
+#define GST_CAT_DEFAULT gst_contention_debug
+
+static GQuark pad_data_quark;
+static GQuark queue_data_quark;
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_contention_debug, "contention", 0, "contention tracer"); \
+    pad_data_quark = g_quark_from_static_string ("gstcontention:pad-data"); \
+    queue_data_quark = g_quark_from_static_string ("gstcontention:queue-data");
+#define gst_contention_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstContentionTracer, gst_contention_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static GstTracerRecord *tr_thread;
+static GstTracerRecord *tr_queue;
+static GstTracerRecord *tr_pad;
+
+/* buckets i holds durations in [2^(i-1), 2^i) ns, the last one 2^46 ns and
+ * more, which is almost a day */
+#define N_TIME_BUCKETS 48
+/* fill level in steps of 10% */
+#define N_FILL_BUCKETS 10
+
+typedef struct
+{
+  GstContentionTracer *tracer;
+  guint64 thread_id;
+  GstClockTime first_ts;
+  GstClockTime last_ts;
+  /* nesting of pushes, only the outermost one counts */
+  guint depth;
+  GstClockTime push_ts;
+  /* time spent in pushes, including the blocked time */
+  GstClockTime tpush;
+  /* time spent in pushes into a queue */
+  GstClockTime tblocked;
+} GstThreadStats;
+
+typedef struct
+{
+  gchar *name;
+  GstClockTime last_ts;
+  /* the peer is a queue, the push blocks if it is full */
+  gboolean into_queue;
+  guint64 count;
+  GstClockTime total;
+  GstClockTime max;
+  guint64 hist[N_TIME_BUCKETS];
+} GstPadStats;
+
+typedef struct
+{
+  gchar *name;
+  /* queue and queue2 expose their level, multiqueue doesn't */
+  gboolean has_level;
+  guint64 samples;
+  guint64 sum;
+  guint max;
+  guint64 hist[N_FILL_BUCKETS];
+} GstQueueStats;
+
+static GPrivate thread_stats_key;
+
+/* a non-queue element */
+static GstQueueStats no_queue_stats;
+
+/* data helpers */
+
+/* see gstlatency.c */
+static GstElement *
+get_real_pad_parent (GstPad * pad)
+{
+  GstObject *parent;
+
+  if (!pad)
+    return NULL;
+
+  parent = GST_OBJECT_PARENT (pad);
+
+  /* if parent of pad is a ghost-pad, then pad is a proxy_pad */
+  if (parent && GST_IS_GHOST_PAD (parent)) {
+    pad = GST_PAD_CAST (parent);
+    parent = GST_OBJECT_PARENT (pad);
+  }
+  return GST_ELEMENT_CAST (parent);
+}
+
+static GstThreadStats *
+get_thread_stats (GstContentionTracer * self, guint64 ts)
+{
+  GstThreadStats *stats = g_private_get (&thread_stats_key);
+
+  if (G_LIKELY (stats && stats->tracer == self))
+    return stats;
+
+  stats = g_slice_new0 (GstThreadStats);
+  stats->tracer = self;
+  stats->thread_id = (guint64) (guintptr) g_thread_self ();
+  stats->first_ts = ts;
+
+  g_mutex_lock (&self->lock);
+  g_hash_table_insert (self->threads, &stats->thread_id, stats);
+  g_mutex_unlock (&self->lock);
+
+  g_private_set (&thread_stats_key, stats);
+  return stats;
+}
+
+static void
+free_thread_stats (gpointer data)
+{
+  g_slice_free (GstThreadStats, data);
+}
+
+/* returns NULL if the element is not a queue */
+static GstQueueStats *
+get_queue_stats (GstContentionTracer * self, GstElement * element)
+{
+  GstQueueStats *stats;
+  const gchar *type_name;
+
+  if (!element || GST_IS_BIN (element))
+    return NULL;
+
+  if ((stats = g_object_get_qdata ((GObject *) element, queue_data_quark)))
+    return stats != &no_queue_stats ? stats : NULL;
+
+  g_mutex_lock (&self->lock);
+  if (!(stats = g_object_get_qdata ((GObject *) element, queue_data_quark))) {
+    type_name = G_OBJECT_TYPE_NAME (element);
+    if (!strcmp (type_name, "GstQueue") || !strcmp (type_name, "GstQueue2")) {
+      stats = g_slice_new0 (GstQueueStats);
+      stats->has_level = TRUE;
+    } else if (!strcmp (type_name, "GstMultiQueue")) {
+      stats = g_slice_new0 (GstQueueStats);
+    } else {
+      stats = &no_queue_stats;
+    }
+    if (stats != &no_queue_stats) {
+      stats->name = g_strdup (GST_OBJECT_NAME (element));
+      self->queues = g_list_prepend (self->queues, stats);
+    }
+    g_object_set_qdata ((GObject *) element, queue_data_quark, stats);
+  }
+  g_mutex_unlock (&self->lock);
+
+  return stats != &no_queue_stats ? stats : NULL;
+}
+
+static void
+free_queue_stats (gpointer data)
+{
+  GstQueueStats *stats = data;
+
+  g_free (stats->name);
+  g_slice_free (GstQueueStats, stats);
+}
+
+static GstPadStats *
+get_pad_stats (GstContentionTracer * self, GstPad * pad)
+{
+  GstPadStats *stats;
+
+  if ((stats = g_object_get_qdata ((GObject *) pad, pad_data_quark)))
+    return stats;
+
+  stats = g_slice_new0 (GstPadStats);
+  stats->name = g_strdup_printf ("%s_%s", GST_DEBUG_PAD_NAME (pad));
+  stats->into_queue =
+      get_queue_stats (self, get_real_pad_parent (GST_PAD_PEER (pad))) != NULL;
+
+  g_mutex_lock (&self->lock);
+  self->pads = g_list_prepend (self->pads, stats);
+  g_mutex_unlock (&self->lock);
+
+  g_object_set_qdata ((GObject *) pad, pad_data_quark, stats);
+  return stats;
+}
+
+static void
+free_pad_stats (gpointer data)
+{
+  GstPadStats *stats = data;
+
+  g_free (stats->name);
+  g_slice_free (GstPadStats, stats);
+}
+
+static guint
+get_fill_level (guint64 cur, guint64 max)
+{
+  if (max == 0)
+    return 0;
+  return (guint) MIN (cur * 100 / max, 100);
+}
+
+static void
+sample_queue_level (GstContentionTracer * self, GstElement * queue,
+    GstQueueStats * stats)
+{
+  guint cur_buffers, cur_bytes, max_buffers, max_bytes;
+  guint64 cur_time, max_time;
+  guint level;
+
+  if (!stats->has_level)
+    return;
+
+  g_object_get (queue,
+      "current-level-buffers", &cur_buffers,
+      "current-level-bytes", &cur_bytes,
+      "current-level-time", &cur_time,
+      "max-size-buffers", &max_buffers,
+      "max-size-bytes", &max_bytes, "max-size-time", &max_time, NULL);
+
+  /* the queue is full as soon as one of the limits is reached */
+  level = get_fill_level (cur_buffers, max_buffers);
+  level = MAX (level, get_fill_level (cur_bytes, max_bytes));
+  level = MAX (level, get_fill_level (cur_time, max_time));
+
+  g_mutex_lock (&self->lock);
+  stats->samples++;
+  stats->sum += level;
+  stats->max = MAX (stats->max, level);
+  stats->hist[MIN (level / 10, N_FILL_BUCKETS - 1)]++;
+  g_mutex_unlock (&self->lock);
+}
+
+static GstClockTime
+get_percentile (GstPadStats * stats, guint percent)
+{
+  guint64 target = (stats->count * percent + 99) / 100;
+  guint64 n = 0;
+  guint i;
+
+  for (i = 0; i < N_TIME_BUCKETS; i++) {
+    n += stats->hist[i];
+    if (n >= target)
+      break;
+  }
+  if (i == 0)
+    return 0;
+  if (i >= N_TIME_BUCKETS - 1)
+    return stats->max;
+
+  return MIN ((G_GUINT64_CONSTANT (1) << i) - 1, stats->max);
+}
+
+/* hooks */
+
+static void
+do_push_buffer_pre (GstTracer * tracer, guint64 ts, GstPad * pad)
+{
+  GstContentionTracer *self = GST_CONTENTION_TRACER_CAST (tracer);
+  GstThreadStats *thread = get_thread_stats (self, ts);
+  GstPadStats *stats = get_pad_stats (self, pad);
+  GstElement *parent = get_real_pad_parent (pad);
+  GstQueueStats *queue;
+
+  /* a buffer leaves a queue */
+  if ((queue = get_queue_stats (self, parent)))
+    sample_queue_level (self, parent, queue);
+
+  if (thread->depth++ == 0)
+    thread->push_ts = ts;
+  stats->last_ts = ts;
+}
+
+static void
+do_push_buffer_post (GstTracer * tracer, guint64 ts, GstPad * pad)
+{
+  GstContentionTracer *self = GST_CONTENTION_TRACER_CAST (tracer);
+  GstThreadStats *thread = get_thread_stats (self, ts);
+  GstPadStats *stats = get_pad_stats (self, pad);
+  GstClockTime elapsed = GST_CLOCK_DIFF (stats->last_ts, ts);
+
+  stats->count++;
+  stats->total += elapsed;
+  stats->max = MAX (stats->max, elapsed);
+  stats->hist[MIN (g_bit_storage (elapsed), N_TIME_BUCKETS - 1)]++;
+
+  if (stats->into_queue) {
+    GstElement *peer_parent = get_real_pad_parent (GST_PAD_PEER (pad));
+    GstQueueStats *queue;
+
+    thread->tblocked += elapsed;
+
+    /* a buffer entered a queue */
+    if ((queue = get_queue_stats (self, peer_parent)))
+      sample_queue_level (self, peer_parent, queue);
+  }
+
+  if (thread->depth > 0 && --thread->depth == 0)
+    thread->tpush += GST_CLOCK_DIFF (thread->push_ts, ts);
+  thread->last_ts = ts;
+}
+
+/* reporting */
+
+static void
+log_thread_stats (gpointer key, gpointer value, gpointer user_data)
+{
+  GstThreadStats *stats = value;
+  GstClockTime total = GST_CLOCK_DIFF (stats->first_ts, stats->last_ts);
+  GstClockTime tblocked = MIN (stats->tblocked, stats->tpush);
+
+  gst_tracer_record_log (tr_thread, stats->thread_id,
+      stats->tpush - tblocked, tblocked, total - MIN (stats->tpush, total));
+}
+
+static void
+log_queue_stats (GstQueueStats * stats)
+{
+  GString *hist;
+  guint i;
+
+  if (!stats->has_level)
+    return;
+
+  hist = g_string_new (NULL);
+  for (i = 0; i < N_FILL_BUCKETS; i++)
+    g_string_append_printf (hist, "%s%" G_GUINT64_FORMAT, i ? "," : "",
+        stats->hist[i]);
+
+  gst_tracer_record_log (tr_queue, stats->name, stats->samples,
+      stats->samples ? (guint) (stats->sum / stats->samples) : 0, stats->max,
+      hist->str);
+  g_string_free (hist, TRUE);
+}
+
+static void
+log_pad_stats (GstPadStats * stats)
+{
+  if (!stats->count)
+    return;
+
+  gst_tracer_record_log (tr_pad, stats->name, stats->count,
+      stats->total / stats->count, get_percentile (stats, 50),
+      get_percentile (stats, 90), get_percentile (stats, 99), stats->max);
+}
+
+/* tracer class */
+
+static void
+gst_contention_tracer_finalize (GObject * obj)
+{
+  GstContentionTracer *self = GST_CONTENTION_TRACER (obj);
+
+  /* final report */
+  g_hash_table_foreach (self->threads, log_thread_stats, NULL);
+  g_list_foreach (self->queues, (GFunc) log_queue_stats, NULL);
+  g_list_foreach (self->pads, (GFunc) log_pad_stats, NULL);
+
+  g_hash_table_destroy (self->threads);
+  g_list_free_full (self->queues, free_queue_stats);
+  g_list_free_full (self->pads, free_pad_stats);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (obj);
+}
+
+static void
+gst_contention_tracer_class_init (GstContentionTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_contention_tracer_finalize;
+
+  /* announce trace formats */
+  /* *INDENT-OFF* */
+  tr_thread = gst_tracer_record_new ("thread-contention.class",
+      "thread-id", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_THREAD,
+          NULL),
+      "working", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time spent pushing data downstream in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "blocked", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time spent pushing into queues in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "outside", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time spent outside of pushes, waiting for or producing data in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+  tr_queue = gst_tracer_record_new ("queue-level.class",
+      "element", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "samples", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of level samples",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "mean", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "mean fill level in percent",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT, 0,
+          "max", G_TYPE_UINT, 100,
+          NULL),
+      "max", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "maximum fill level in percent",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT, 0,
+          "max", G_TYPE_UINT, 100,
+          NULL),
+      "histogram", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING,
+              "comma separated number of samples per 10% of fill level",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          NULL),
+      NULL);
+  tr_pad = gst_tracer_record_new ("pad-push-time.class",
+      "pad", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PAD,
+          NULL),
+      "count", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of pushes",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "mean", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "mean time of a push in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "p50", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "median time of a push in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "p90", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "90th percentile time of a push in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "p99", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "99th percentile time of a push in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "max", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "maximum time of a push in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+}
+
+static void
+gst_contention_tracer_init (GstContentionTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  g_mutex_init (&self->lock);
+  self->threads = g_hash_table_new_full (g_int64_hash, g_int64_equal, NULL,
+      free_thread_stats);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_buffer_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_buffer_post));
+}
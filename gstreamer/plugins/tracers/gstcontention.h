@@ -0,0 +1,70 @@
+/* GStreamer
+ * Copyright (C) 2016 The GStreamer developers
+ *
+ * gstcontention.h: tracing module that logs where streaming threads block
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_CONTENTION_TRACER_H__
+#define __GST_CONTENTION_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_CONTENTION_TRACER \
+  (gst_contention_tracer_get_type())
+#define GST_CONTENTION_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_CONTENTION_TRACER,GstContentionTracer))
+#define GST_CONTENTION_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_CONTENTION_TRACER,GstContentionTracerClass))
+#define GST_IS_CONTENTION_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_CONTENTION_TRACER))
+#define GST_IS_CONTENTION_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_CONTENTION_TRACER))
+#define GST_CONTENTION_TRACER_CAST(obj) ((GstContentionTracer *)(obj))
+
+typedef struct _GstContentionTracer GstContentionTracer;
+typedef struct _GstContentionTracerClass GstContentionTracerClass;
+
+/**
+ * GstContentionTracer:
+ *
+ * Opaque #GstContentionTracer data structure
+ */
+struct _GstContentionTracer {
+  GstTracer 	 parent;
+
+  /*< private >*/
+  GMutex lock;
+  GHashTable *threads;          /* guint64 thread-id -> stats */
+  GList *pads;                  /* pad stats, they outlive the pads */
+  GList *queues;                /* queue stats, they outlive the queues */
+};
+
+struct _GstContentionTracerClass {
+  GstTracerClass parent_class;
+
+  /* signals */
+};
+
+G_GNUC_INTERNAL GType gst_contention_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_CONTENTION_TRACER_H__ */
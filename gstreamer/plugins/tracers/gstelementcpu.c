@@ -0,0 +1,373 @@
+/* GStreamer
+ * Copyright (C) 2016 The GStreamer developers
+ *
+ * gstelementcpu.c: tracing module that logs the CPU time used per element
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:gstelementcpu
+ * @short_description: log the CPU time used per element
+ *
+ * A tracing module that attributes the CPU time of the streaming threads to
+ * the elements. It samples the CPU time of the current thread each time data
+ * is pushed or pulled between pads:
+ *
+ * - the time spent inside a push is accounted to the element receiving the
+ *   data, the time spent inside a pull to the element providing it.
+ * - the time a thread spends outside of any push is accounted to the element
+ *   doing the next push, usually a source or a queue producing data.
+ *
+ * The inclusive time of an element contains the time spent in the elements
+ * it pushes to in the same thread, the exclusive time does not. The totals
+ * are logged every second and when the tracer is shut down.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstelementcpu.h"
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+GST_DEBUG_CATEGORY_STATIC (gst_element_cpu_debug);
+#define GST_CAT_DEFAULT gst_element_cpu_debug
+
+static GQuark element_data_quark;
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_element_cpu_debug, "elementcpu", 0, "element cpu tracer"); \
+    element_data_quark = g_quark_from_static_string ("gstelementcpu:element-data");
+#define gst_element_cpu_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstElementCpuTracer, gst_element_cpu_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static GstTracerRecord *tr_element;
+
+/* interval between two logs of the totals */
+#define LOG_INTERVAL GST_SECOND
+
+typedef struct
+{
+  gchar *name;
+  guint64 calls;
+  GstClockTime inclusive;
+  GstClockTime exclusive;
+} GstElementStats;
+
+typedef struct
+{
+  GstElementStats *stats;
+  /* thread CPU time when entering the element */
+  GstClockTime start;
+  /* CPU time spent in the elements called from this one */
+  GstClockTime children;
+} GstElementFrame;
+
+typedef struct
+{
+  GstElementCpuTracer *tracer;
+  GArray *frames;
+  /* thread CPU time when leaving the outermost element */
+  GstClockTime outside_start;
+} GstThreadStats;
+
+static void free_thread_stats (gpointer data);
+static GPrivate thread_stats_key = G_PRIVATE_INIT (free_thread_stats);
+
+/* data helpers */
+
+/* see gstlatency.c */
+static GstElement *
+get_real_pad_parent (GstPad * pad)
+{
+  GstObject *parent;
+
+  if (!pad)
+    return NULL;
+
+  parent = GST_OBJECT_PARENT (pad);
+
+  /* if parent of pad is a ghost-pad, then pad is a proxy_pad */
+  if (parent && GST_IS_GHOST_PAD (parent)) {
+    pad = GST_PAD_CAST (parent);
+    parent = GST_OBJECT_PARENT (pad);
+  }
+  return GST_ELEMENT_CAST (parent);
+}
+
+static GstClockTime
+get_thread_cpu_time (void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+  struct timespec now;
+
+  if (!clock_gettime (CLOCK_THREAD_CPUTIME_ID, &now))
+    return GST_TIMESPEC_TO_TIME (now);
+
+  GST_WARNING ("clock_gettime (CLOCK_THREAD_CPUTIME_ID,...) failed: %s",
+      g_strerror (errno));
+#endif
+  return 0;
+}
+
+static void
+free_thread_stats (gpointer data)
+{
+  GstThreadStats *stats = data;
+
+  g_array_free (stats->frames, TRUE);
+  g_slice_free (GstThreadStats, stats);
+}
+
+static GstThreadStats *
+get_thread_stats (GstElementCpuTracer * self)
+{
+  GstThreadStats *stats = g_private_get (&thread_stats_key);
+
+  if (G_LIKELY (stats && stats->tracer == self))
+    return stats;
+
+  stats = g_slice_new0 (GstThreadStats);
+  stats->tracer = self;
+  stats->frames = g_array_new (FALSE, FALSE, sizeof (GstElementFrame));
+  stats->outside_start = GST_CLOCK_TIME_NONE;
+
+  /* frees the stats of a previous tracer instance */
+  g_private_replace (&thread_stats_key, stats);
+  return stats;
+}
+
+static GstElementStats *
+get_element_stats (GstElementCpuTracer * self, GstElement * element)
+{
+  GstElementStats *stats;
+
+  if (!element)
+    return NULL;
+
+  if ((stats = g_object_get_qdata ((GObject *) element, element_data_quark)))
+    return stats;
+
+  g_mutex_lock (&self->lock);
+  if (!(stats = g_object_get_qdata ((GObject *) element, element_data_quark))) {
+    stats = g_slice_new0 (GstElementStats);
+    stats->name = g_strdup (GST_OBJECT_NAME (element));
+    self->elements = g_list_prepend (self->elements, stats);
+    g_object_set_qdata ((GObject *) element, element_data_quark, stats);
+  }
+  g_mutex_unlock (&self->lock);
+
+  return stats;
+}
+
+static void
+free_element_stats (gpointer data)
+{
+  GstElementStats *stats = data;
+
+  g_free (stats->name);
+  g_slice_free (GstElementStats, stats);
+}
+
+/* reporting */
+
+static void
+log_element_stats (GstElementStats * stats, guint64 * ts)
+{
+  if (!stats->calls)
+    return;
+
+  gst_tracer_record_log (tr_element, stats->name, *ts, stats->calls,
+      stats->inclusive, stats->exclusive);
+}
+
+/* called with the lock */
+static void
+log_all_stats (GstElementCpuTracer * self, guint64 ts)
+{
+  g_list_foreach (self->elements, (GFunc) log_element_stats, &ts);
+  self->last_log_ts = ts;
+}
+
+/* hooks */
+
+static void
+enter_element (GstElementCpuTracer * self, GstElement * caller,
+    GstElement * callee)
+{
+  GstThreadStats *thread = get_thread_stats (self);
+  GstClockTime now = get_thread_cpu_time ();
+  GstElementFrame frame;
+
+  /* the thread was producing data in the caller, e.g. a source */
+  if (thread->frames->len == 0 &&
+      GST_CLOCK_TIME_IS_VALID (thread->outside_start)) {
+    GstElementStats *stats = get_element_stats (self, caller);
+
+    if (stats && now > thread->outside_start) {
+      g_mutex_lock (&self->lock);
+      stats->inclusive += now - thread->outside_start;
+      stats->exclusive += now - thread->outside_start;
+      g_mutex_unlock (&self->lock);
+    }
+  }
+
+  frame.stats = get_element_stats (self, callee);
+  frame.start = now;
+  frame.children = 0;
+  g_array_append_val (thread->frames, frame);
+}
+
+static void
+leave_element (GstElementCpuTracer * self, guint64 ts)
+{
+  GstThreadStats *thread = get_thread_stats (self);
+  GstClockTime now = get_thread_cpu_time (), inclusive;
+  GstElementFrame *frame;
+
+  /* the tracer was installed while the thread was already pushing */
+  if (thread->frames->len == 0)
+    return;
+
+  frame = &g_array_index (thread->frames, GstElementFrame,
+      thread->frames->len - 1);
+  inclusive = now > frame->start ? now - frame->start : 0;
+
+  g_mutex_lock (&self->lock);
+  if (frame->stats) {
+    frame->stats->calls++;
+    frame->stats->inclusive += inclusive;
+    frame->stats->exclusive += inclusive - MIN (frame->children, inclusive);
+  }
+  if (GST_CLOCK_DIFF (self->last_log_ts, ts) >= LOG_INTERVAL)
+    log_all_stats (self, ts);
+  g_mutex_unlock (&self->lock);
+
+  g_array_set_size (thread->frames, thread->frames->len - 1);
+  if (thread->frames->len > 0) {
+    frame = &g_array_index (thread->frames, GstElementFrame,
+        thread->frames->len - 1);
+    frame->children += inclusive;
+  } else {
+    thread->outside_start = now;
+  }
+}
+
+static void
+do_push_pre (GstTracer * tracer, guint64 ts, GstPad * pad)
+{
+  enter_element (GST_ELEMENT_CPU_TRACER_CAST (tracer),
+      get_real_pad_parent (pad), get_real_pad_parent (GST_PAD_PEER (pad)));
+}
+
+static void
+do_pull_range_pre (GstTracer * tracer, guint64 ts, GstPad * pad)
+{
+  /* the pulling element calls into the upstream one */
+  enter_element (GST_ELEMENT_CPU_TRACER_CAST (tracer),
+      get_real_pad_parent (pad), get_real_pad_parent (GST_PAD_PEER (pad)));
+}
+
+static void
+do_post (GstTracer * tracer, guint64 ts, GstPad * pad)
+{
+  leave_element (GST_ELEMENT_CPU_TRACER_CAST (tracer), ts);
+}
+
+/* tracer class */
+
+static void
+gst_element_cpu_tracer_finalize (GObject * obj)
+{
+  GstElementCpuTracer *self = GST_ELEMENT_CPU_TRACER (obj);
+
+  /* final report */
+  log_all_stats (self, gst_util_get_timestamp ());
+
+  g_list_free_full (self->elements, free_element_stats);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (obj);
+}
+
+static void
+gst_element_cpu_tracer_class_init (GstElementCpuTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_element_cpu_tracer_finalize;
+
+  /* announce trace formats */
+  /* *INDENT-OFF* */
+  tr_element = gst_tracer_record_new ("element-cpu.class",
+      "element", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "event ts",
+          NULL),
+      "calls", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "number of pushes to and pulls from the element",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "inclusive", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "CPU time spent in the element and the elements it calls in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "exclusive", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "CPU time spent in the element itself in ns",
+          "flags", GST_TYPE_TRACER_VALUE_FLAGS, GST_TRACER_VALUE_FLAGS_AGGREGATED,
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+}
+
+static void
+gst_element_cpu_tracer_init (GstElementCpuTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  g_mutex_init (&self->lock);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre", G_CALLBACK (do_push_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post", G_CALLBACK (do_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (do_post));
+}
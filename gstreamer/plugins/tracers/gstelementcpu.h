@@ -0,0 +1,69 @@
+/* GStreamer
+ * Copyright (C) 2016 The GStreamer developers
+ *
+ * gstelementcpu.h: tracing module that logs the CPU time used per element
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_ELEMENT_CPU_TRACER_H__
+#define __GST_ELEMENT_CPU_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_ELEMENT_CPU_TRACER \
+  (gst_element_cpu_tracer_get_type())
+#define GST_ELEMENT_CPU_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_ELEMENT_CPU_TRACER,GstElementCpuTracer))
+#define GST_ELEMENT_CPU_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_ELEMENT_CPU_TRACER,GstElementCpuTracerClass))
+#define GST_IS_ELEMENT_CPU_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_ELEMENT_CPU_TRACER))
+#define GST_IS_ELEMENT_CPU_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_ELEMENT_CPU_TRACER))
+#define GST_ELEMENT_CPU_TRACER_CAST(obj) ((GstElementCpuTracer *)(obj))
+
+typedef struct _GstElementCpuTracer GstElementCpuTracer;
+typedef struct _GstElementCpuTracerClass GstElementCpuTracerClass;
+
+/**
+ * GstElementCpuTracer:
+ *
+ * Opaque #GstElementCpuTracer data structure
+ */
+struct _GstElementCpuTracer {
+  GstTracer 	 parent;
+
+  /*< private >*/
+  GMutex lock;
+  GList *elements;              /* element stats, they outlive the elements */
+  GstClockTime last_log_ts;
+};
+
+struct _GstElementCpuTracerClass {
+  GstTracerClass parent_class;
+
+  /* signals */
+};
+
+G_GNUC_INTERNAL GType gst_element_cpu_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_ELEMENT_CPU_TRACER_H__ */
@@ -24,6 +24,8 @@
 #endif
 
 #include <gst/gst.h>
+#include "gstcontention.h"
+#include "gstelementcpu.h"
 #include "gstlatency.h"
 #include "gstlog.h"
 #include "gstrusage.h"
@@ -32,6 +34,14 @@
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
+  if (!gst_tracer_register (plugin, "contention",
+          gst_contention_tracer_get_type ()))
+    return FALSE;
+#ifdef HAVE_CLOCK_GETTIME
+  if (!gst_tracer_register (plugin, "elementcpu",
+          gst_element_cpu_tracer_get_type ()))
+    return FALSE;
+#endif
   if (!gst_tracer_register (plugin, "latency", gst_latency_tracer_get_type ()))
     return FALSE;
 #ifndef GST_DISABLE_GST_DEBUG
@@ -0,0 +1,315 @@
+/* GStreamer
+ *
+ * streaming.c: end-to-end buffer throughput and latency benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Pushes buffers through a matrix of topologies, number of branches and
+ * buffer sizes and prints one CSV line per combination with the throughput
+ * and the source to sink latency of the buffers:
+ *
+ *  queue:      fakesrc ! queue ! ... (N queues) ! fakesink
+ *  tee:        fakesrc ! tee ! N x (queue ! fakesink)
+ *  multiqueue: N x fakesrc ! multiqueue ! N x fakesink
+ *  funnel:     N x (fakesrc ! queue) ! funnel ! fakesink
+ *
+ * The latency is measured by stamping each buffer with the monotonic time
+ * when it leaves its source, and comparing when it reaches a sink.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <gst/gst.h>
+
+#define DEFAULT_TOPOLOGIES "queue,tee,multiqueue,funnel"
+#define DEFAULT_BRANCHES "1,2,4,8"
+#define DEFAULT_SIZES "64,4096,65536"
+#define DEFAULT_NUM_BUFFERS 100000
+
+typedef struct
+{
+  guint64 *latencies;
+  volatile gint n_latencies;
+  gint max_latencies;
+} Latencies;
+
+static GstPadProbeReturn
+stamp_buffer (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buffer;
+
+  buffer = gst_buffer_make_writable (GST_PAD_PROBE_INFO_BUFFER (info));
+
+  GST_BUFFER_DTS (buffer) = g_get_monotonic_time () * GST_USECOND;
+  GST_PAD_PROBE_INFO_DATA (info) = buffer;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+measure_buffer (GstPad * pad, GstPadProbeInfo * info, Latencies * lat)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime now = g_get_monotonic_time () * GST_USECOND;
+  gint idx;
+
+  /* Don't serialize the sinks, that would skew the measurements */
+  idx = g_atomic_int_add (&lat->n_latencies, 1);
+  if (idx < lat->max_latencies)
+    lat->latencies[idx] = now - GST_BUFFER_DTS (buffer);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstElement *
+make_source (GstElement * pipeline, guint64 num_buffers, guint size)
+{
+  GstElement *src = gst_element_factory_make ("fakesrc", NULL);
+  GstPad *pad;
+
+  /* sizetype 2 is fixed size buffers, filltype 1 leaves them uninitialized */
+  g_object_set (src, "num-buffers", (gint) num_buffers, "sizetype", 2,
+      "sizemax", size, "filltype", 1, "silent", TRUE, NULL);
+  gst_bin_add (GST_BIN (pipeline), src);
+
+  pad = gst_element_get_static_pad (src, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, stamp_buffer, NULL, NULL);
+  gst_object_unref (pad);
+
+  return src;
+}
+
+static GstElement *
+make_sink (GstElement * pipeline, Latencies * lat)
+{
+  GstElement *sink = gst_element_factory_make ("fakesink", NULL);
+  GstPad *pad;
+
+  g_object_set (sink, "sync", FALSE, "silent", TRUE, NULL);
+  gst_bin_add (GST_BIN (pipeline), sink);
+
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) measure_buffer, lat, NULL);
+  gst_object_unref (pad);
+
+  return sink;
+}
+
+static GstElement *
+make_element (GstElement * pipeline, const gchar * factory)
+{
+  GstElement *element = gst_element_factory_make (factory, NULL);
+
+  gst_bin_add (GST_BIN (pipeline), element);
+
+  return element;
+}
+
+/* Returns the number of buffers expected at the sinks, or 0 if the
+ * topology is not known */
+static guint64
+build_pipeline (GstElement * pipeline, const gchar * topology,
+    guint branches, guint size, guint64 num_buffers, Latencies * lat)
+{
+  GstElement *src, *sink, *prev, *elem;
+  guint i;
+
+  if (!strcmp (topology, "queue")) {
+    prev = make_source (pipeline, num_buffers, size);
+    for (i = 0; i < branches; i++) {
+      elem = make_element (pipeline, "queue");
+      gst_element_link (prev, elem);
+      prev = elem;
+    }
+    sink = make_sink (pipeline, lat);
+    gst_element_link (prev, sink);
+
+    return num_buffers;
+  } else if (!strcmp (topology, "tee")) {
+    src = make_source (pipeline, num_buffers, size);
+    prev = make_element (pipeline, "tee");
+    gst_element_link (src, prev);
+    for (i = 0; i < branches; i++) {
+      elem = make_element (pipeline, "queue");
+      sink = make_sink (pipeline, lat);
+      gst_element_link_many (prev, elem, sink, NULL);
+    }
+
+    return num_buffers * branches;
+  } else if (!strcmp (topology, "multiqueue")) {
+    elem = make_element (pipeline, "multiqueue");
+    for (i = 0; i < branches; i++) {
+      src = make_source (pipeline, num_buffers, size);
+      sink = make_sink (pipeline, lat);
+      gst_element_link_many (src, elem, sink, NULL);
+    }
+
+    return num_buffers * branches;
+  } else if (!strcmp (topology, "funnel")) {
+    elem = make_element (pipeline, "funnel");
+    for (i = 0; i < branches; i++) {
+      src = make_source (pipeline, num_buffers, size);
+      prev = make_element (pipeline, "queue");
+      gst_element_link_many (src, prev, elem, NULL);
+    }
+    sink = make_sink (pipeline, lat);
+    gst_element_link (elem, sink);
+
+    return num_buffers * branches;
+  }
+
+  return 0;
+}
+
+static gint
+compare_latencies (gconstpointer a, gconstpointer b)
+{
+  guint64 la = *(const guint64 *) a, lb = *(const guint64 *) b;
+
+  return la < lb ? -1 : (la > lb ? 1 : 0);
+}
+
+static gboolean
+run (const gchar * topology, guint branches, guint size, guint64 num_buffers)
+{
+  GstElement *pipeline;
+  GstMessage *msg;
+  GstClockTime start, end, total;
+  Latencies lat;
+  guint64 expected;
+  gboolean ret = FALSE;
+
+  pipeline = gst_pipeline_new (NULL);
+  lat.n_latencies = 0;
+  lat.max_latencies = num_buffers * branches;
+  lat.latencies = g_new (guint64, lat.max_latencies);
+
+  expected = build_pipeline (pipeline, topology, branches, size, num_buffers,
+      &lat);
+  if (expected == 0) {
+    g_printerr ("Unknown topology %s\n", topology);
+    goto done;
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  end = gst_util_get_timestamp ();
+  total = GST_CLOCK_DIFF (start, end);
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    g_printerr ("Error running %s with %u branches\n", topology, branches);
+  } else if (lat.n_latencies == 0) {
+    g_printerr ("No buffer reached the sinks\n");
+  } else {
+    lat.n_latencies = MIN (lat.n_latencies, lat.max_latencies);
+    qsort (lat.latencies, lat.n_latencies, sizeof (guint64),
+        compare_latencies);
+
+    g_print ("%s,%u,%u,%d,%" G_GUINT64_FORMAT ",%.0f,%" G_GUINT64_FORMAT
+        ",%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT "\n", topology, branches,
+        size, lat.n_latencies, total,
+        lat.n_latencies / ((gdouble) total / GST_SECOND),
+        total / lat.n_latencies, lat.latencies[lat.n_latencies / 2],
+        lat.latencies[(guint64) lat.n_latencies * 99 / 100]);
+    ret = (guint64) lat.n_latencies == expected;
+  }
+  gst_message_unref (msg);
+
+done:
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  g_free (lat.latencies);
+
+  return ret;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gchar *topologies_str = NULL, *branches_str = NULL, *sizes_str = NULL;
+  gchar **topologies, **branches, **sizes;
+  gint64 num_buffers = DEFAULT_NUM_BUFFERS;
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gint i, j, k, ret = 0;
+  GOptionEntry options[] = {
+    {"topologies", 't', 0, G_OPTION_ARG_STRING, &topologies_str,
+        "Comma separated topologies (default: " DEFAULT_TOPOLOGIES ")", NULL},
+    {"branches", 'b', 0, G_OPTION_ARG_STRING, &branches_str,
+        "Comma separated number of queues or branches (default: "
+          DEFAULT_BRANCHES ")", NULL},
+    {"sizes", 's', 0, G_OPTION_ARG_STRING, &sizes_str,
+        "Comma separated buffer sizes (default: " DEFAULT_SIZES ")", NULL},
+    {"num-buffers", 'n', 0, G_OPTION_ARG_INT64, &num_buffers,
+        "Number of buffers per source", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    exit (-1);
+  }
+  g_option_context_free (ctx);
+
+  if (num_buffers <= 0 || num_buffers > G_MAXINT) {
+    g_print ("number of buffers must be greater than 0\n");
+    exit (-3);
+  }
+
+  topologies = g_strsplit (topologies_str ? topologies_str :
+      DEFAULT_TOPOLOGIES, ",", -1);
+  branches = g_strsplit (branches_str ? branches_str : DEFAULT_BRANCHES, ",",
+      -1);
+  sizes = g_strsplit (sizes_str ? sizes_str : DEFAULT_SIZES, ",", -1);
+
+  g_print ("topology,branches,buffer-size,buffers,total-ns,buffers-per-s,"
+      "ns-per-buffer,latency-p50-ns,latency-p99-ns\n");
+
+  for (i = 0; topologies[i]; i++) {
+    for (j = 0; branches[j]; j++) {
+      for (k = 0; sizes[k]; k++) {
+        guint n = atoi (branches[j]), size = atoi (sizes[k]);
+
+        if (n == 0 || size == 0)
+          continue;
+
+        if (!run (topologies[i], n, size, num_buffers))
+          ret = 1;
+      }
+    }
+  }
+
+  g_strfreev (topologies);
+  g_strfreev (branches);
+  g_strfreev (sizes);
+  g_free (topologies_str);
+  g_free (branches_str);
+  g_free (sizes_str);
+
+  return ret;
+}
@@ -370,6 +370,63 @@ GST_START_TEST (test_flush)
 
 GST_END_TEST;
 
+GST_START_TEST (test_max_pending_writes)
+{
+  GstElement *filesink;
+  gchar *tmp_fn;
+  GstSegment segment;
+  guint i;
+
+  tmp_fn = create_temporary_file ();
+  if (tmp_fn == NULL)
+    return;
+  filesink = setup_filesink ();
+
+  GST_LOG ("using temp file '%s'", tmp_fn);
+  g_object_set (filesink, "location", tmp_fn, "max-pending-writes", 2, NULL);
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_stream_start ("test")));
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* the position includes the data that is still queued */
+  for (i = 0; i < 10; i++)
+    PUSH_BYTES (100);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 1000);
+  PUSH_BUFFER_LIST (3, 10);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 1030);
+
+  /* seeking waits for the pending writes */
+  segment.start = 900;
+  if (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment))) {
+    CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 900);
+    PUSH_BYTES (200);
+    CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 1100);
+  } else {
+    GST_INFO ("seeking not supported for tempfile?!");
+  }
+
+  /* EOS waits for the pending writes too */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  CHECK_WRITTEN_BYTES (900, 200, 1100);
+  CHECK_WRITTEN_BYTES (800, 100, 1100);
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  cleanup_filesink (filesink);
+
+  g_remove (tmp_fn);
+  g_free (tmp_fn);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_coverage)
 {
   GstElement *filesink;
@@ -485,6 +542,7 @@ filesink_suite (void)
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_flush);
+  tcase_add_test (tc_chain, test_max_pending_writes);
 
   return s;
 }
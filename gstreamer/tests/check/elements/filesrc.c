@@ -299,6 +299,73 @@ GST_START_TEST (test_pull)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_mmap)
+{
+  GstElement *src;
+  gboolean res;
+  gint64 stop;
+  GstPad *pad;
+  GstFlowReturn ret;
+  GstBuffer *buffer, *buffer2;
+  gchar *contents;
+  gsize length;
+
+  fail_unless (g_file_get_contents (TESTFILE, &contents, &length, NULL));
+
+  src = setup_filesrc ();
+
+  g_object_set (G_OBJECT (src), "location", TESTFILE, "use-mmap", TRUE, NULL);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (pad != NULL);
+
+  res = gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE);
+  fail_unless (res == TRUE);
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to paused");
+
+  fail_unless (gst_pad_query_duration (pad, GST_FORMAT_BYTES, &stop));
+  fail_unless_equals_int (stop, length);
+
+  buffer = NULL;
+  ret = gst_pad_get_range (pad, 50, 100, &buffer);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless (buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 100);
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents + 50, 100) == 0);
+  gst_buffer_unref (buffer);
+
+  /* short read at the end */
+  buffer = NULL;
+  ret = gst_pad_get_range (pad, stop - 10, 20, &buffer);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless (buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 10);
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents + stop - 10, 10) == 0);
+
+  buffer2 = NULL;
+  ret = gst_pad_get_range (pad, stop, 10, &buffer2);
+  fail_unless (ret == GST_FLOW_EOS);
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  /* buffers stay valid after the file was closed */
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents + stop - 10, 10) == 0);
+  gst_buffer_unref (buffer);
+
+  gst_object_unref (pad);
+  cleanup_filesrc (src);
+  g_free (contents);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_coverage)
 {
   GstElement *src;
@@ -531,6 +598,7 @@ filesrc_suite (void)
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_pull);
+  tcase_add_test (tc_chain, test_pull_mmap);
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_uri_query);
@@ -126,6 +126,46 @@ GST_START_TEST (test_simple_pipeline)
 
 GST_END_TEST;
 
+/* more streams than workers, the sinks block the workers in preroll */
+GST_START_TEST (test_worker_threads)
+{
+  GstElement *pipe, *mq;
+  GstElement *inputs[4];
+  GstElement *outputs[4];
+  GstMessage *msg;
+  gint i;
+
+  pipe = gst_pipeline_new ("pipeline");
+
+  for (i = 0; i < 4; i++) {
+    inputs[i] = gst_element_factory_make ("fakesrc", NULL);
+    fail_unless (inputs[i] != NULL, "failed to create 'fakesrc' element");
+    g_object_set (inputs[i], "num-buffers", 256, NULL);
+
+    outputs[i] = gst_element_factory_make ("fakesink", NULL);
+    fail_unless (outputs[i] != NULL, "failed to create 'fakesink' element");
+  }
+
+  mq = setup_multiqueue (pipe, inputs, outputs, 4);
+  g_object_set (mq, "max-threads", 1, NULL);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+
+  msg = gst_bus_poll (GST_ELEMENT_BUS (pipe),
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+
+  fail_if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR,
+      "Expected EOS message, got ERROR message");
+  gst_message_unref (msg);
+
+  GST_LOG ("Got EOS, cleaning up");
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_simple_shutdown_while_running)
 {
   GstElement *pipe;
@@ -1495,6 +1535,7 @@ multiqueue_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_simple_create_destroy);
   tcase_add_test (tc_chain, test_simple_pipeline);
+  tcase_add_test (tc_chain, test_worker_threads);
   tcase_add_test (tc_chain, test_simple_shutdown_while_running);
 
   tcase_add_test (tc_chain, test_request_pads);
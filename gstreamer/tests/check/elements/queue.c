@@ -1146,6 +1146,49 @@ GST_START_TEST (test_initial_events_nodelay)
 
 GST_END_TEST;
 
+/* push buffers through a small queue with spinning enabled and check
+ * that all of them come out in order */
+GST_START_TEST (test_spin_time)
+{
+  GstSegment segment;
+  GList *l;
+  guint i;
+
+  g_object_set (G_OBJECT (queue), "max-size-buffers", 2,
+      "spin-time", 100 * GST_USECOND, NULL);
+
+  mysinkpad = gst_check_setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < 100; i++) {
+    GstBuffer *buffer = gst_buffer_new ();
+
+    GST_BUFFER_OFFSET (buffer) = i;
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buffer), GST_FLOW_OK);
+  }
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 100)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  for (l = buffers, i = 0; l; l = l->next, i++)
+    fail_unless_equals_int (GST_BUFFER_OFFSET (l->data), i);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+}
+
+GST_END_TEST;
+
 static Suite *
 queue_suite (void)
 {
@@ -1168,6 +1211,7 @@ queue_suite (void)
   tcase_add_test (tc_chain, test_sticky_not_linked);
   tcase_add_test (tc_chain, test_time_level_buffer_list);
   tcase_add_test (tc_chain, test_initial_events_nodelay);
+  tcase_add_test (tc_chain, test_spin_time);
 
   return s;
 }
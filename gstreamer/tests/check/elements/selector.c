@@ -624,6 +624,59 @@ GST_START_TEST (test_input_selector_switch_to_eos_stream)
 GST_END_TEST;
 
 
+GST_START_TEST (test_input_selector_cache_gop)
+{
+  GstBuffer *gop[3], *buf;
+  GList *l;
+  gint i;
+
+  setup_input_selector_with_2_streams (2);
+  g_object_set (selector, "cache-gop", TRUE, NULL);
+
+  /* a delta unit before any keyframe is not cached */
+  buf = gst_buffer_new ();
+  GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+  fail_unless (gst_pad_push (stream1_pad, buf) == GST_FLOW_OK);
+
+  /* keyframe and delta units on the inactive stream are cached */
+  for (i = 0; i < 3; i++) {
+    gop[i] = gst_buffer_new ();
+    if (i > 0)
+      GST_BUFFER_FLAG_SET (gop[i], GST_BUFFER_FLAG_DELTA_UNIT);
+    fail_unless (gst_pad_push (stream1_pad, gop[i]) == GST_FLOW_OK);
+  }
+  fail_unless (buffers == NULL);
+
+  g_object_set (selector, "active-pad", GST_PAD_PEER (stream1_pad), NULL);
+
+  /* the next delta unit gets the cached GOP pushed before it */
+  buf = gst_buffer_new ();
+  GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+  fail_unless (gst_pad_push (stream1_pad, gst_buffer_ref (buf)) ==
+      GST_FLOW_OK);
+
+  fail_unless_equals_int (g_list_length (buffers), 4);
+  for (i = 0, l = buffers; i < 3; i++, l = l->next) {
+    fail_unless (GST_BUFFER_FLAG_IS_SET (l->data,
+            GST_BUFFER_FLAG_DECODE_ONLY));
+    fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (l->data,
+            GST_BUFFER_FLAG_DELTA_UNIT), i > 0);
+  }
+  fail_unless (l->data == buf);
+  fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DECODE_ONLY));
+  gst_buffer_unref (buf);
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  /* and is only replayed once */
+  input_selector_push_buffer (1, INPUT_SELECTOR_FORWARD);
+
+  teardown_input_selector_with_2_streams ();
+}
+
+GST_END_TEST;
+
+
 GST_START_TEST (test_output_selector_no_srcpad_negotiation)
 {
   GstElement *sel;
@@ -835,6 +888,7 @@ selector_suite (void)
   tcase_add_test (tc_chain, test_input_selector_empty_stream);
   tcase_add_test (tc_chain, test_input_selector_shorter_stream);
   tcase_add_test (tc_chain, test_input_selector_switch_to_eos_stream);
+  tcase_add_test (tc_chain, test_input_selector_cache_gop);
   tcase_add_test (tc_chain, test_output_selector_no_srcpad_negotiation);
 
   tc_chain = tcase_create ("output-selector-negotiation");
@@ -698,6 +698,112 @@ GST_START_TEST (test_allow_not_linked)
 
 GST_END_TEST;
 
+static gboolean
+alloc_query_branch1 (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GstBufferPool *pool;
+
+  if (GST_QUERY_TYPE (query) != GST_QUERY_ALLOCATION)
+    return gst_pad_query_default (pad, parent, query);
+
+  pool = g_object_get_data (G_OBJECT (pad), "pool");
+  gst_query_add_allocation_pool (query, pool, 100, 2, 0);
+  gst_query_add_allocation_meta (query, GST_PARENT_BUFFER_META_API_TYPE,
+      NULL);
+  gst_query_add_allocation_meta (query, GST_PROTECTION_META_API_TYPE, NULL);
+
+  return TRUE;
+}
+
+static gboolean
+alloc_query_branch2 (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GstAllocationParams params;
+
+  if (GST_QUERY_TYPE (query) != GST_QUERY_ALLOCATION)
+    return gst_pad_query_default (pad, parent, query);
+
+  gst_allocation_params_init (&params);
+  params.align = 15;
+  gst_query_add_allocation_param (query, NULL, &params);
+  gst_query_add_allocation_pool (query, NULL, 50, 1, 4);
+  gst_query_add_allocation_meta (query, GST_PARENT_BUFFER_META_API_TYPE,
+      NULL);
+
+  return TRUE;
+}
+
+GST_START_TEST (test_allocation_query)
+{
+  GstElement *tee;
+  GstPad *src1, *src2, *sink1, *sink2, *sinkpad;
+  GstBufferPool *pool, *qpool;
+  GstAllocationParams params;
+  GstCaps *caps;
+  GstQuery *query;
+  guint size, min, max;
+
+  tee = gst_check_setup_element ("tee");
+  sinkpad = gst_element_get_static_pad (tee, "sink");
+
+  src1 = gst_element_get_request_pad (tee, "src_%u");
+  src2 = gst_element_get_request_pad (tee, "src_%u");
+  sink1 = gst_pad_new ("sink1", GST_PAD_SINK);
+  sink2 = gst_pad_new ("sink2", GST_PAD_SINK);
+  gst_pad_set_query_function (sink1, alloc_query_branch1);
+  gst_pad_set_query_function (sink2, alloc_query_branch2);
+  pool = gst_buffer_pool_new ();
+  g_object_set_data_full (G_OBJECT (sink1), "pool", pool, gst_object_unref);
+  fail_unless (gst_pad_link (src1, sink1) == GST_PAD_LINK_OK);
+  fail_unless (gst_pad_link (src2, sink2) == GST_PAD_LINK_OK);
+  gst_pad_set_active (sink1, TRUE);
+  gst_pad_set_active (sink2, TRUE);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  /* the pool of the only branch proposing one is kept, the buffer counts
+   * and params are merged and only the common metas are kept */
+  caps = gst_caps_new_empty_simple ("test/test");
+  query = gst_query_new_allocation (caps, TRUE);
+  fail_unless (gst_pad_query (sinkpad, query));
+
+  fail_unless_equals_int (gst_query_get_n_allocation_pools (query), 1);
+  gst_query_parse_nth_allocation_pool (query, 0, &qpool, &size, &min, &max);
+  fail_unless (qpool == pool);
+  fail_unless_equals_int (size, 100);
+  fail_unless_equals_int (min, 3);
+  fail_unless_equals_int (max, 0);
+  gst_object_unref (qpool);
+
+  fail_unless_equals_int (gst_query_get_n_allocation_params (query), 1);
+  gst_query_parse_nth_allocation_param (query, 0, NULL, &params);
+  fail_unless_equals_int (params.align, 15);
+
+  fail_unless_equals_int (gst_query_get_n_allocation_metas (query), 1);
+  fail_unless (gst_query_find_allocation_meta (query,
+          GST_PARENT_BUFFER_META_API_TYPE, NULL));
+  gst_query_unref (query);
+  gst_caps_unref (caps);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_pad_set_active (sink1, FALSE);
+  gst_pad_set_active (sink2, FALSE);
+  gst_pad_unlink (src1, sink1);
+  gst_pad_unlink (src2, sink2);
+  gst_object_unref (sink1);
+  gst_object_unref (sink2);
+  gst_element_release_request_pad (tee, src1);
+  gst_element_release_request_pad (tee, src2);
+  gst_object_unref (src1);
+  gst_object_unref (src2);
+  gst_object_unref (sinkpad);
+  gst_check_teardown_element (tee);
+}
+
+GST_END_TEST;
+
 static Suite *
 tee_suite (void)
 {
@@ -716,6 +822,7 @@ tee_suite (void)
   tcase_add_test (tc_chain, test_flow_aggregation);
   tcase_add_test (tc_chain, test_request_pads);
   tcase_add_test (tc_chain, test_allow_not_linked);
+  tcase_add_test (tc_chain, test_allocation_query);
 
   return s;
 }
@@ -1421,6 +1421,69 @@ GST_START_TEST (test_state_change_skip)
 
 GST_END_TEST;
 
+GST_START_TEST (test_parallel_state_changes)
+{
+  GstElement *pipeline, *src, *identity, *sink;
+  GstElement *sinks[4];
+  GstStateChangeReturn ret;
+  GstState current, pending;
+  GstIterator *it;
+  GValue item = { 0, };
+  gint i;
+
+  pipeline = gst_pipeline_new (NULL);
+  fail_unless (pipeline != NULL, "Could not create pipeline");
+  g_object_set (pipeline, "parallel-state-changes", TRUE, NULL);
+
+  /* independent chains, the elements of each one are in different levels */
+  for (i = 0; i < G_N_ELEMENTS (sinks); i++) {
+    src = gst_element_factory_make ("fakesrc", NULL);
+    fail_if (src == NULL, "Could not create fakesrc");
+    identity = gst_element_factory_make ("identity", NULL);
+    fail_if (identity == NULL, "Could not create identity");
+    sink = gst_element_factory_make ("fakesink", NULL);
+    fail_if (sink == NULL, "Could not create fakesink");
+
+    gst_bin_add_many (GST_BIN (pipeline), src, identity, sink, NULL);
+    fail_unless (gst_element_link_many (src, identity, sink, NULL));
+    sinks[i] = sink;
+  }
+
+  ret = gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  fail_if (ret != GST_STATE_CHANGE_ASYNC, "State change to PLAYING not ASYNC");
+  ret =
+      gst_element_get_state (pipeline, &current, &pending, GST_CLOCK_TIME_NONE);
+  fail_if (ret != GST_STATE_CHANGE_SUCCESS, "State change to PLAYING failed");
+  fail_if (current != GST_STATE_PLAYING, "State change to PLAYING failed");
+  fail_if (pending != GST_STATE_VOID_PENDING, "State change to PLAYING failed");
+
+  it = gst_bin_iterate_elements (GST_BIN (pipeline));
+  while (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElement *child = g_value_get_object (&item);
+
+    fail_unless_equals_int (GST_STATE (child), GST_STATE_PLAYING);
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  ret = gst_element_set_state (pipeline, GST_STATE_NULL);
+  fail_if (ret != GST_STATE_CHANGE_SUCCESS, "State change to NULL failed");
+
+  /* a failing child makes the whole state change fail */
+  g_object_set (sinks[2], "state-error", 1, NULL);
+  ret = gst_element_set_state (pipeline, GST_STATE_READY);
+  fail_if (ret != GST_STATE_CHANGE_FAILURE, "State change to READY succeeded");
+
+  g_object_set (sinks[2], "state-error", 0, NULL);
+  ret = gst_element_set_state (pipeline, GST_STATE_NULL);
+  fail_if (ret != GST_STATE_CHANGE_SUCCESS, "State change to NULL failed");
+
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_duration_is_max)
 {
   GstElement *bin, *src[3], *sink[3];
@@ -1574,6 +1637,7 @@ gst_bin_suite (void)
   tcase_add_test (tc_chain, test_state_failure_remove);
   tcase_add_test (tc_chain, test_state_failure_unref);
   tcase_add_test (tc_chain, test_state_change_skip);
+  tcase_add_test (tc_chain, test_parallel_state_changes);
   tcase_add_test (tc_chain, test_duration_is_max);
   tcase_add_test (tc_chain, test_duration_unknown_overrides);
 
@@ -226,6 +226,33 @@ GST_START_TEST (test_buffer_modify_discard)
 
 GST_END_TEST;
 
+GST_START_TEST (test_buffer_shrink_is_recycled)
+{
+  GstBufferPool *pool = create_pool (10, 0, 0);
+  GstBuffer *buf = NULL, *prev;
+  gint dcount = 0;
+
+  gst_buffer_pool_set_active (pool, TRUE);
+  gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  prev = buf;
+  buffer_track_destroy (buf, &dcount);
+  /* shrink as after a short read, the full size is restored on release */
+  gst_buffer_resize (buf, 0, 4);
+  gst_buffer_unref (buf);
+
+  fail_unless_equals_int (dcount, 0);
+
+  gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  fail_unless (buf == prev, "got a fresh buffer instead of previous");
+  fail_unless_equals_int (gst_buffer_get_size (buf), 10);
+  gst_buffer_unref (buf);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_pool_activation_and_config)
 {
   GstBufferPool *pool = gst_buffer_pool_new ();
@@ -300,6 +327,66 @@ GST_START_TEST (test_flushing_pool_returns_flushing)
 
 GST_END_TEST;
 
+static GstBufferPool *
+create_cached_pool (guint size)
+{
+  GstBufferPool *pool = gst_buffer_pool_new ();
+  GstStructure *conf = gst_buffer_pool_get_config (pool);
+  GstCaps *caps = gst_caps_new_empty_simple ("test/data");
+
+  gst_buffer_pool_config_set_params (conf, caps, size, 0, 0);
+  gst_buffer_pool_config_add_option (conf,
+      GST_BUFFER_POOL_OPTION_THREAD_CACHE);
+  gst_buffer_pool_set_config (pool, conf);
+  gst_caps_unref (caps);
+
+  return pool;
+}
+
+static gpointer
+unref_buffer_func (gpointer data)
+{
+  gst_buffer_unref (GST_BUFFER_CAST (data));
+  return NULL;
+}
+
+GST_START_TEST (test_thread_cache)
+{
+  GstBufferPool *pool = create_cached_pool (10);
+  GstBuffer *buf1 = NULL, *buf2 = NULL, *buf;
+  GThread *thread;
+  gint dcount = 0;
+
+  gst_buffer_pool_set_active (pool, TRUE);
+  gst_buffer_pool_acquire_buffer (pool, &buf1, NULL);
+  gst_buffer_pool_acquire_buffer (pool, &buf2, NULL);
+  buffer_track_destroy (buf1, &dcount);
+  buffer_track_destroy (buf2, &dcount);
+
+  /* released from our thread, goes to our cache and is reused */
+  gst_buffer_unref (buf1);
+  gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  fail_unless (buf == buf1, "got a fresh buffer instead of cached one");
+
+  /* released from another thread, must be available to us as well */
+  thread = g_thread_new ("release", unref_buffer_func, buf2);
+  g_thread_join (thread);
+  gst_buffer_pool_acquire_buffer (pool, &buf1, NULL);
+  fail_unless (buf1 == buf2, "buffer released by other thread not reused");
+
+  gst_buffer_unref (buf);
+  gst_buffer_unref (buf1);
+  fail_unless (dcount == 0);
+
+  /* cached buffers are freed when deactivating */
+  gst_buffer_pool_set_active (pool, FALSE);
+  fail_unless (dcount == 2);
+
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_buffer_pool_suite (void)
 {
@@ -315,9 +402,11 @@ gst_buffer_pool_suite (void)
   tcase_add_test (tc_chain, test_pool_config_buffer_size);
   tcase_add_test (tc_chain, test_inactive_pool_returns_flushing);
   tcase_add_test (tc_chain, test_buffer_modify_discard);
+  tcase_add_test (tc_chain, test_buffer_shrink_is_recycled);
   tcase_add_test (tc_chain, test_pool_activation_and_config);
   tcase_add_test (tc_chain, test_pool_config_validate);
   tcase_add_test (tc_chain, test_flushing_pool_returns_flushing);
+  tcase_add_test (tc_chain, test_thread_cache);
 
   return s;
 }
@@ -809,6 +809,57 @@ GST_START_TEST (test_async_message)
 
 GST_END_TEST;
 
+/* test that messages of the same source and type are coalesced */
+GST_START_TEST (test_coalescing)
+{
+  GstMessage *msg;
+  GstObject *src;
+  guint i;
+
+  test_bus = gst_bus_new ();
+  src = gst_object_ref_sink (gst_bin_new ("src"));
+
+  gst_bus_set_coalescing (test_bus, GST_MESSAGE_ELEMENT,
+      200 * GST_MSECOND);
+
+  /* the first message is delivered right away */
+  gst_bus_post (test_bus, gst_message_new_element (src,
+          gst_structure_new ("level", "i", G_TYPE_INT, 0, NULL)));
+  msg = gst_bus_pop (test_bus);
+  fail_unless (msg != NULL);
+  gst_message_unref (msg);
+
+  /* the next ones are kept until the interval passed */
+  for (i = 1; i <= 10; i++) {
+    gst_bus_post (test_bus, gst_message_new_element (src,
+            gst_structure_new ("level", "i", G_TYPE_INT, i, NULL)));
+  }
+  gst_bus_post (test_bus, gst_message_new_application (src,
+          gst_structure_new_empty ("app")));
+
+  /* not coalesced */
+  msg = gst_bus_pop (test_bus);
+  fail_unless (msg != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_APPLICATION);
+  gst_message_unref (msg);
+  fail_if (gst_bus_have_pending (test_bus));
+
+  /* only the last element message is delivered */
+  msg = gst_bus_timed_pop (test_bus, 5 * GST_SECOND);
+  fail_unless (msg != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_ELEMENT);
+  fail_unless (gst_structure_get_int (gst_message_get_structure (msg), "i",
+          (gint *) & i));
+  fail_unless_equals_int (i, 10);
+  gst_message_unref (msg);
+  fail_if (gst_bus_have_pending (test_bus));
+
+  gst_object_unref (test_bus);
+  gst_object_unref (src);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_bus_suite (void)
 {
@@ -830,6 +881,7 @@ gst_bus_suite (void)
   tcase_add_test (tc_chain, test_timed_pop_filtered_with_timeout);
   tcase_add_test (tc_chain, test_custom_main_context);
   tcase_add_test (tc_chain, test_async_message);
+  tcase_add_test (tc_chain, test_coalescing);
   return s;
 }
 
@@ -1385,6 +1385,42 @@ GST_START_TEST (test_filter_and_map_in_place)
 
 GST_END_TEST;
 
+GST_START_TEST (test_intern)
+{
+  GstCaps *caps1, *caps2, *caps3;
+
+  caps1 = gst_caps_intern (gst_caps_from_string
+      ("video/x-raw, format=I420, width=320, height=240"));
+  /* same caps with the fields in a different order */
+  caps2 = gst_caps_intern (gst_caps_from_string
+      ("video/x-raw, height=240, width=320, format=I420"));
+  caps3 = gst_caps_intern (gst_caps_from_string
+      ("video/x-raw, format=I420, width=640, height=240"));
+
+  fail_unless (caps1 == caps2);
+  fail_if (caps1 == caps3);
+  fail_unless (gst_caps_is_equal (caps1, caps2));
+  fail_if (gst_caps_is_equal (caps1, caps3));
+  fail_if (gst_caps_is_writable (caps1));
+
+  gst_caps_unref (caps2);
+  caps2 = gst_caps_make_writable (gst_caps_ref (caps1));
+  fail_if (caps1 == caps2);
+  fail_unless (gst_caps_is_equal (caps1, caps2));
+  gst_caps_unref (caps2);
+
+  /* non-fixed caps are left alone */
+  caps2 = gst_caps_from_string ("video/x-raw, width=[1, 10]");
+  fail_unless (gst_caps_intern (caps2) == caps2);
+  fail_unless (gst_caps_is_writable (caps2));
+  gst_caps_unref (caps2);
+
+  gst_caps_unref (caps1);
+  gst_caps_unref (caps3);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_caps_suite (void)
 {
@@ -1419,6 +1455,7 @@ gst_caps_suite (void)
   tcase_add_test (tc_chain, test_foreach);
   tcase_add_test (tc_chain, test_map_in_place);
   tcase_add_test (tc_chain, test_filter_and_map_in_place);
+  tcase_add_test (tc_chain, test_intern);
 
   return s;
 }
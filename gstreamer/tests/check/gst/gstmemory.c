@@ -598,6 +598,51 @@ GST_START_TEST (test_lock)
 
 GST_END_TEST;
 
+GST_START_TEST (test_large_allocator)
+{
+  GstAllocationParams params;
+  GstAllocator *alloc;
+  GstMemory *mem, *copy, *sub;
+  GstMapInfo info;
+  gsize size;
+
+  alloc = gst_allocator_find (GST_ALLOCATOR_SYSMEM_LARGE);
+  fail_unless (alloc != NULL);
+
+  /* small blocks and big blocks with prefix and padding */
+  for (size = 1024; size <= 8 * 1024 * 1024; size *= 8) {
+    gst_allocation_params_init (&params);
+    params.align = 63;
+    params.prefix = 16;
+    params.padding = 32;
+    params.flags = GST_MEMORY_FLAG_ZERO_PREFIXED | GST_MEMORY_FLAG_ZERO_PADDED;
+
+    mem = gst_allocator_alloc (alloc, size, &params);
+    fail_unless (mem != NULL);
+    fail_unless (gst_memory_is_type (mem, GST_ALLOCATOR_SYSMEM));
+    fail_unless_equals_int (mem->size, size);
+    fail_unless_equals_int (mem->offset, 16);
+
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+    fail_unless (((guintptr) info.data & 63) == 16);
+    memset (info.data, 0xaa, info.size);
+    gst_memory_unmap (mem, &info);
+
+    copy = gst_memory_copy (mem, 1, -1);
+    fail_unless_equals_int (copy->size, size - 1);
+    sub = gst_memory_share (mem, 1, 1);
+    fail_unless_equals_int (sub->size, 1);
+
+    gst_memory_unref (mem);
+    gst_memory_unref (copy);
+    gst_memory_unref (sub);
+  }
+
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_memory_suite (void)
 {
@@ -617,6 +662,7 @@ gst_memory_suite (void)
   tcase_add_test (tc_chain, test_map_resize);
   tcase_add_test (tc_chain, test_alloc_params);
   tcase_add_test (tc_chain, test_lock);
+  tcase_add_test (tc_chain, test_large_allocator);
 
   return s;
 }
@@ -2534,6 +2534,80 @@ GST_START_TEST (test_sticky_events)
 
 GST_END_TEST;
 
+static GList *received_sticky;
+
+static gboolean
+test_sticky_update_handler (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  received_sticky = g_list_append (received_sticky, event);
+
+  return TRUE;
+}
+
+GST_START_TEST (test_sticky_events_update)
+{
+  GstPad *srcpad, *sinkpad;
+  GstCaps *caps;
+  GstSegment seg;
+  GstEvent *event;
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  gst_pad_set_active (srcpad, TRUE);
+
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  fail_unless (sinkpad != NULL);
+  gst_pad_set_event_function (sinkpad, test_sticky_update_handler);
+  gst_pad_set_chain_function (sinkpad, test_sticky_chain);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK);
+
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("test")));
+  caps = gst_caps_new_empty_simple ("foo/bar");
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_caps (caps)));
+  gst_caps_unref (caps);
+  gst_segment_init (&seg, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_segment (&seg)));
+  fail_unless (gst_pad_push (srcpad, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (received_sticky), 3);
+  g_list_free_full (received_sticky, (GDestroyNotify) gst_event_unref);
+  received_sticky = NULL;
+
+  /* store an updated custom sticky event without pushing it, only that one
+   * should be sent with the next buffer */
+  event = gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM_STICKY,
+      gst_structure_new ("test", "i", G_TYPE_INT, 1, NULL));
+  fail_unless (gst_pad_store_sticky_event (srcpad, event) == GST_FLOW_OK);
+  gst_event_unref (event);
+  fail_unless (gst_pad_push (srcpad, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (received_sticky), 1);
+  fail_unless (received_sticky->data == event);
+  g_list_free_full (received_sticky, (GDestroyNotify) gst_event_unref);
+  received_sticky = NULL;
+
+  /* nothing changed, nothing sent */
+  fail_unless (gst_pad_push (srcpad, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless (received_sticky == NULL);
+
+  /* changing the offset sends all of them again, in order */
+  gst_pad_set_offset (srcpad, GST_SECOND);
+  fail_unless (gst_pad_push (srcpad, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (received_sticky), 4);
+  fail_unless_equals_int (GST_EVENT_TYPE (received_sticky->data),
+      GST_EVENT_STREAM_START);
+  fail_unless_equals_int (GST_EVENT_TYPE (g_list_last (received_sticky)->data),
+      GST_EVENT_CUSTOM_DOWNSTREAM_STICKY);
+  g_list_free_full (received_sticky, (GDestroyNotify) gst_event_unref);
+  received_sticky = NULL;
+
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
 static GstFlowReturn next_return;
 
 static GstFlowReturn
@@ -3016,6 +3090,7 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_block_async_full_destroy_dispose);
   tcase_add_test (tc_chain, test_block_async_replace_callback_no_flush);
   tcase_add_test (tc_chain, test_sticky_events);
+  tcase_add_test (tc_chain, test_sticky_events_update);
   tcase_add_test (tc_chain, test_last_flow_return_push);
   tcase_add_test (tc_chain, test_last_flow_return_pull);
   tcase_add_test (tc_chain, test_flush_stop_inactive);
@@ -1041,6 +1041,54 @@ GST_START_TEST (test_take_buffer_fast)
 
 GST_END_TEST;
 
+GST_START_TEST (test_map_chunks)
+{
+  GstAdapter *adapter;
+  GstBuffer *buffer;
+  const guint8 *data[4];
+  gsize sizes[4];
+  guint8 *mem;
+  gint i, n;
+
+  adapter = gst_adapter_new ();
+
+  /* 3 buffers of 10 bytes, the middle one made of two memories */
+  for (i = 0; i < 3; i++) {
+    buffer = gst_buffer_new ();
+    mem = g_malloc (5);
+    memset (mem, i * 2, 5);
+    gst_buffer_append_memory (buffer, gst_memory_new_wrapped (0, mem, 5, 0,
+            5, mem, g_free));
+    mem = g_malloc (5);
+    memset (mem, i * 2 + 1, 5);
+    gst_buffer_append_memory (buffer, gst_memory_new_wrapped (0, mem, 5, 0,
+            5, mem, g_free));
+    gst_adapter_push (adapter, buffer);
+  }
+
+  n = gst_adapter_map_chunks (adapter, 3, 17, data, sizes, 4);
+  fail_unless_equals_int (n, 4);
+  fail_unless_equals_int (sizes[0], 2);
+  fail_unless_equals_int (sizes[1], 5);
+  fail_unless_equals_int (sizes[2], 5);
+  fail_unless_equals_int (sizes[3], 5);
+  for (i = 0; i < 4; i++)
+    fail_unless_equals_int (data[i][0], i);
+  gst_adapter_unmap_chunks (adapter);
+
+  /* too many chunks */
+  n = gst_adapter_map_chunks (adapter, 0, 30, data, sizes, 4);
+  fail_unless_equals_int (n, -1);
+
+  /* not enough data */
+  n = gst_adapter_map_chunks (adapter, 10, 21, data, sizes, 4);
+  fail_unless_equals_int (n, -1);
+
+  g_object_unref (adapter);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_adapter_suite (void)
 {
@@ -1064,6 +1112,7 @@ gst_adapter_suite (void)
   tcase_add_test (tc_chain, test_get_buffer_list);
   tcase_add_test (tc_chain, test_merge);
   tcase_add_test (tc_chain, test_take_buffer_fast);
+  tcase_add_test (tc_chain, test_map_chunks);
 
   return s;
 }
@@ -197,6 +197,53 @@ GST_END_TEST;
 #undef GET_CHECK_FAIL
 #undef PEEK_CHECK_FAIL
 
+GST_START_TEST (test_exp_golomb)
+{
+  /* ue: 0, 1, 2, 3, 4, se: -1, 1, -3, then four times ue 0 */
+  guint8 data[] = { 0xa6, 0x42, 0xb4, 0x7f };
+  /* 32 leading zeros, only a zero suffix fits into 32 bits */
+  guint8 max[] = { 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00 };
+  guint8 overflow[] = { 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x80 };
+  guint8 zeros[] = { 0x00, 0x00, 0x00 };
+  GstBitReader reader = GST_BIT_READER_INIT (data, 4);
+  guint32 u;
+  gint32 s;
+  guint i;
+
+  for (i = 0; i < 5; i++) {
+    fail_unless (gst_bit_reader_get_ue (&reader, &u));
+    fail_unless_equals_int (u, i);
+  }
+  fail_unless (gst_bit_reader_get_se (&reader, &s));
+  fail_unless_equals_int (s, -1);
+  fail_unless (gst_bit_reader_get_se (&reader, &s));
+  fail_unless_equals_int (s, 1);
+  fail_unless (gst_bit_reader_get_se (&reader, &s));
+  fail_unless_equals_int (s, -3);
+  for (i = 0; i < 4; i++) {
+    fail_unless (gst_bit_reader_get_ue (&reader, &u));
+    fail_unless_equals_int (u, 0);
+  }
+  fail_if (gst_bit_reader_get_ue (&reader, &u));
+
+  gst_bit_reader_init (&reader, max, sizeof (max));
+  fail_unless (gst_bit_reader_get_ue (&reader, &u));
+  fail_unless_equals_uint64 (u, G_MAXUINT32);
+  fail_unless_equals_int (gst_bit_reader_get_pos (&reader), 65);
+
+  gst_bit_reader_init (&reader, overflow, sizeof (overflow));
+  fail_if (gst_bit_reader_get_ue (&reader, &u));
+  fail_unless_equals_int (gst_bit_reader_get_pos (&reader), 0);
+
+  gst_bit_reader_init (&reader, zeros, sizeof (zeros));
+  fail_unless (gst_bit_reader_skip (&reader, 3));
+  fail_if (gst_bit_reader_get_ue (&reader, &u));
+  fail_if (gst_bit_reader_get_se (&reader, &s));
+  fail_unless_equals_int (gst_bit_reader_get_pos (&reader), 3);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_position_tracking)
 {
   guint8 data[] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
@@ -246,6 +293,7 @@ gst_bit_reader_suite (void)
   tcase_add_test (tc_chain, test_initialization);
   tcase_add_test (tc_chain, test_get_bits);
   tcase_add_test (tc_chain, test_position_tracking);
+  tcase_add_test (tc_chain, test_exp_golomb);
 
   return s;
 }
@@ -24,6 +24,8 @@
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <math.h>
+
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
@@ -728,6 +730,52 @@ GST_START_TEST (controller_interpolation_linear_value_array)
 
 GST_END_TEST;
 
+/* test that get_value_array() matches get_value() across control points */
+GST_START_TEST (controller_interpolation_value_array_segments)
+{
+  GstControlSource *cs;
+  GstTimedValueControlSource *tvcs;
+  GstInterpolationMode modes[] = { GST_INTERPOLATION_MODE_NONE,
+    GST_INTERPOLATION_MODE_LINEAR, GST_INTERPOLATION_MODE_CUBIC,
+    GST_INTERPOLATION_MODE_CUBIC_MONOTONIC
+  };
+  gdouble values[40], value;
+  GstClockTime ts;
+  guint i, m;
+
+  cs = gst_interpolation_control_source_new ();
+  tvcs = (GstTimedValueControlSource *) cs;
+
+  /* some control points are closer than the sampling interval */
+  fail_unless (gst_timed_value_control_source_set (tvcs, 1 * GST_SECOND, 0.0));
+  fail_unless (gst_timed_value_control_source_set (tvcs, 2 * GST_SECOND, 0.5));
+  fail_unless (gst_timed_value_control_source_set (tvcs,
+          2 * GST_SECOND + GST_MSECOND, 0.3));
+  fail_unless (gst_timed_value_control_source_set (tvcs,
+          2 * GST_SECOND + 2 * GST_MSECOND, 0.6));
+  fail_unless (gst_timed_value_control_source_set (tvcs, 4 * GST_SECOND, 0.2));
+  fail_unless (gst_timed_value_control_source_set (tvcs, 5 * GST_SECOND, 0.8));
+
+  for (m = 0; m < G_N_ELEMENTS (modes); m++) {
+    g_object_set (cs, "mode", modes[m], NULL);
+
+    fail_unless (gst_control_source_get_value_array (cs, 0,
+            GST_SECOND / 7, G_N_ELEMENTS (values), values));
+    for (i = 0, ts = 0; i < G_N_ELEMENTS (values); i++, ts += GST_SECOND / 7) {
+      if (ts < GST_SECOND) {
+        fail_unless (isnan (values[i]));
+      } else {
+        fail_unless (gst_control_source_get_value (cs, ts, &value));
+        fail_unless_equals_float (values[i], value);
+      }
+    }
+  }
+
+  gst_object_unref (cs);
+}
+
+GST_END_TEST;
+
 /* test if values below minimum and above maximum are clipped */
 GST_START_TEST (controller_interpolation_linear_invalid_values)
 {
@@ -1545,6 +1593,7 @@ gst_controller_suite (void)
   tcase_add_test (tc, controller_interpolation_unset_all);
   tcase_add_test (tc, controller_interpolation_linear_absolute_value_array);
   tcase_add_test (tc, controller_interpolation_linear_value_array);
+  tcase_add_test (tc, controller_interpolation_value_array_segments);
   tcase_add_test (tc, controller_interpolation_linear_invalid_values);
   tcase_add_test (tc, controller_interpolation_linear_default_values);
   tcase_add_test (tc, controller_interpolation_linear_disabled);
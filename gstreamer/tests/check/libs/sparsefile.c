@@ -211,6 +211,62 @@ GST_START_TEST (test_write_merge)
 
 GST_END_TEST;
 
+static void
+expect_missing_range (GstSparseFile * file, gsize offset, gsize start,
+    gsize stop, gboolean bounded)
+{
+  gsize tstart, tstop;
+
+  fail_unless (gst_sparse_file_get_missing_range (file, offset, &tstart,
+          &tstop) == bounded);
+  fail_unless (tstart == start);
+  fail_unless (tstop == stop);
+}
+
+GST_START_TEST (test_missing_range)
+{
+  GstSparseFile *file;
+  gint fd;
+  gchar *name;
+
+  name = g_strdup ("cachefile-testXXXXXX");
+  fd = g_mkstemp (name);
+  fail_if (fd == -1);
+
+  file = gst_sparse_file_new ();
+  gst_sparse_file_set_fd (file, fd);
+
+  /* everything is missing */
+  expect_missing_range (file, 0, 0, G_MAXSIZE, FALSE);
+
+  /* write out of order so we get [50-100] [200-300] [400-500] */
+  fail_unless (expect_write (file, 400, 100, 100, 0));
+  fail_unless (expect_write (file, 50, 50, 50, 0));
+  fail_unless (expect_write (file, 200, 100, 100, 0));
+  fail_unless (gst_sparse_file_n_ranges (file) == 3);
+
+  expect_missing_range (file, 0, 0, 50, TRUE);
+  expect_missing_range (file, 50, 100, 200, TRUE);
+  expect_missing_range (file, 99, 100, 200, TRUE);
+  expect_missing_range (file, 150, 150, 200, TRUE);
+  expect_missing_range (file, 200, 300, 400, TRUE);
+  expect_missing_range (file, 450, 500, G_MAXSIZE, FALSE);
+  expect_range_after (file, 150, 200, 300);
+  expect_range_before (file, 350, 200, 300);
+
+  /* fill the first hole, this merges the first two ranges */
+  fail_unless (expect_write (file, 100, 100, 100, 100));
+  fail_unless (gst_sparse_file_n_ranges (file) == 2);
+  expect_missing_range (file, 50, 300, 400, TRUE);
+  expect_range_before (file, 250, 50, 300);
+
+  g_unlink (name);
+  gst_sparse_file_free (file);
+  g_free (name);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_cachefile_suite (void)
 {
@@ -220,6 +276,7 @@ gst_cachefile_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_write_read);
   tcase_add_test (tc_chain, test_write_merge);
+  tcase_add_test (tc_chain, test_missing_range);
 
   return s;
 }
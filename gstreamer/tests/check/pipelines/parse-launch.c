@@ -710,6 +710,55 @@ GST_START_TEST (test_parsing)
 
 GST_END_TEST;
 
+GST_START_TEST (test_compile)
+{
+  GstParseTemplate *tmpl;
+  GstElement *pipeline, *src, *id;
+  GError *err = NULL;
+  gint i, num_buffers;
+
+  tmpl = gst_parse_compile ("fakesrc num-buffers=4 name=src ! "
+      "( identity silent=true name=id ) ! fakesink silent=true", NULL, 0,
+      &err);
+  fail_unless (err == NULL);
+  fail_unless (tmpl != NULL);
+
+  for (i = 0; i < 2; i++) {
+    pipeline = gst_parse_template_instantiate (tmpl, &err);
+    fail_unless (err == NULL);
+    fail_unless (GST_IS_PIPELINE (pipeline));
+    fail_unless (g_object_is_floating (pipeline));
+
+    src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+    fail_unless (src != NULL);
+    g_object_get (src, "num-buffers", &num_buffers, NULL);
+    fail_unless_equals_int (num_buffers, 4);
+    gst_object_unref (src);
+
+    id = gst_bin_get_by_name (GST_BIN (pipeline), "id");
+    fail_unless (id != NULL);
+    fail_unless (GST_IS_BIN (GST_OBJECT_PARENT (id)));
+    fail_if (GST_OBJECT_PARENT (id) == GST_OBJECT_CAST (pipeline));
+    gst_object_unref (id);
+
+    check_pipeline_runs (pipeline);
+    gst_object_unref (pipeline);
+  }
+  gst_parse_template_unref (tmpl);
+
+  /* any error makes compilation fail */
+#ifndef GST_DISABLE_GST_DEBUG
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+#endif
+  tmpl = gst_parse_compile ("fakesrc ! coffeesink", NULL, 0, &err);
+  fail_unless (tmpl == NULL);
+  fail_unless (err != NULL);
+  fail_unless_equals_int (err->code, GST_PARSE_ERROR_NO_SUCH_ELEMENT);
+  g_error_free (err);
+}
+
+GST_END_TEST;
+
 static Suite *
 parse_suite (void)
 {
@@ -728,6 +777,7 @@ parse_suite (void)
   tcase_add_test (tc_chain, test_flags);
   tcase_add_test (tc_chain, test_missing_elements);
   tcase_add_test (tc_chain, test_parsing);
+  tcase_add_test (tc_chain, test_compile);
   return s;
 }
 